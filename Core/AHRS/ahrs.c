@@ -7,7 +7,7 @@
 **
 **  Autor: Ramon Rico
 **  Fecha de creacion: 06/10/2020
-**  Fecha de modificacion: 06/10/2020
+**  Fecha de modificacion: 17/10/2026
 **
 **  El proyecto URpilot NO es libre. No se puede distribuir y/o modificar este fichero
 **  bajo ningun concepto.
@@ -29,6 +29,7 @@
 #include <string.h>
 
 #include "ahrs.h"
+#include "navegacion.h"
 #include "GP/gp_ahrs.h"
 #include "Comun/util.h"
 #include "Drivers/tiempo.h"
@@ -38,12 +39,19 @@
 #include "Sensores/Barometro/barometro.h"
 #include "Sensores/GPS/gps.h"
 #include "Comun/matematicas.h"
+#include "Comun/matematicas_rapidas.h"
 #include "Filtros/filtro_pasa_bajo.h"
 
 
 /***************************************************************************************
 ** AREA DE PREPROCESADOR                                                              **
 ****************************************************************************************/
+// Funciones de la actitud y de la altitud. Solo atan2 y asin son mas rapidas que las de la
+// libreria (error acotado en matematicas_rapidas.h). Seno, coseno y pow siguen con la libreria
+#define ATAN2_AHRS(y, x)             atan2Rapido(y, x)
+#define ASIN_AHRS(x)                 asinRapido(x)
+#define SEN_COS_AHRS(x, s, c)        do { *(s) = sinf(x); *(c) = cosf(x); } while (0)
+#define POW_AHRS(x, y)               powf(x, y)
 
 
 /***************************************************************************************
@@ -58,6 +66,13 @@ static ahrs_t ahrs;
 static tablaFnAHRS_t *tablaFnAHRS;
 static filtroPasaBajo2P_t filtroAcelAng[3];
 static float velAngularAnt[3];
+static navegacion_t navegacion;
+static float presionAnterior;
+#ifdef USAR_GPS
+static localizacion_t origenGPS;
+static bool origenGPSvalido;
+static uint32_t ultimaMedidaGPS;
+#endif
 
 
 /***************************************************************************************
@@ -68,6 +83,9 @@ void actualizarActitudYawAHRS(float k, float *m, float *w, float *euler);
 void calcularVelAngularBiasAHRS(float *w, float *bias);
 void calcularEulerAHRS(float *q, float *euler);
 float calcularAltitudBaroAHRS(float pBase, float p);
+#ifdef USAR_GPS
+void fusionarGPSahrs(void);
+#endif
 
 
 /***************************************************************************************
@@ -103,6 +121,13 @@ void iniciarAHRS(void)
     }
 
     tablaFnAHRS->iniciarAHRS();
+
+    iniciarNavegacion(&navegacion, &configAHRS()->navegacion);
+    presionAnterior = 0;
+#ifdef USAR_GPS
+    origenGPSvalido = false;
+    ultimaMedidaGPS = 0;
+#endif
 }
 
 
@@ -174,6 +199,7 @@ void actualizarActitudYawAHRS(float k, float *m, float *w, float *euler)
 {
     float mag[3];
     float roll, pitch;
+    float senRoll, cosRoll, senPitch, cosPitch;
 
     static uint32_t tiempoAnterior = 0;
     uint32_t tiempoActual = micros();
@@ -191,9 +217,12 @@ void actualizarActitudYawAHRS(float k, float *m, float *w, float *euler)
     roll = radianes(-euler[0]);
     pitch = radianes(-euler[1]);
 
-    xh = mag[0] * cosf(pitch) + mag[1] * sinf(roll) * sinf(pitch) + mag[2] * cosf(roll) * sinf(pitch);
-    yh = mag[1] * cosf(roll)  - mag[2] * sinf(roll);
-    yawMag = grados(atan2f(-yh, xh));
+    SEN_COS_AHRS(roll, &senRoll, &cosRoll);
+    SEN_COS_AHRS(pitch, &senPitch, &cosPitch);
+
+    xh = mag[0] * cosPitch + mag[1] * senRoll * senPitch + mag[2] * cosRoll * senPitch;
+    yh = mag[1] * cosRoll  - mag[2] * senRoll;
+    yawMag = grados(ATAN2_AHRS(-yh, xh));
 
     // Se convierte el angulo de -180 a 180 a 0 360
     if (yawMag < 0)
@@ -257,9 +286,9 @@ void calcularVelAngularBiasAHRS(float *w, float *bias)
 void calcularEulerAHRS(float *q, float *euler)
 {
     // Ecuaciones sacadas de Madgwick con el conjugado implicito en las formulas
-    euler[0] = atan2f(2 * q[2] * q[3] + 2 * q[0] * q[1], 2 * q[0] * q[0] + 2 * q[3] * q[3] - 1);
-    euler[1] = -asinf(2 * (q[1] * q[3] - q[0] * q[2]));
-    euler[2] = atan2f(2 * q[1] * q[2] + 2 * q[0] * q[3], 2 * q[0] * q[0] + 2 * q[1] * q[1] - 1);
+    euler[0] = ATAN2_AHRS(2 * q[2] * q[3] + 2 * q[0] * q[1], 2 * q[0] * q[0] + 2 * q[3] * q[3] - 1);
+    euler[1] = -ASIN_AHRS(2 * (q[1] * q[3] - q[0] * q[2]));
+    euler[2] = ATAN2_AHRS(2 * q[1] * q[2] + 2 * q[0] * q[3], 2 * q[0] * q[0] + 2 * q[1] * q[1] - 1);
 
     // Conversion a grados
     euler[0] = grados(euler[0]);
@@ -273,22 +302,78 @@ void calcularEulerAHRS(float *q, float *euler)
 
 
 /***************************************************************************************
-**  Nombre:         void actualizarPosicionesAHRS(void)
-**  Descripcion:    Actualizar el estimador de posicion
-**  Parametros:     Ninguno
+**  Nombre:         void actualizarPosicionAHRS(uint32_t tiempoActual)
+**  Descripcion:    Actualizar el estimador de posicion. Predice con la IMU y la actitud y
+**                  fusiona el barometro y el GPS cuando hay medidas nuevas
+**  Parametros:     Tiempo actual
 **  Retorno:        Ninguno
 ****************************************************************************************/
-void actualizarPosicionAHRS(void)
+void actualizarPosicionAHRS(uint32_t tiempoActual)
 {
-    if (baroGenOperativo()) {
+    if (!imuGenOperativa())
+        return;
+
+    float a[3];
+
+    acelIMU(a);
+    predecirNavegacion(&navegacion, tiempoActual, ahrs.actitud.cuerpo.qb, a);
+
+    if (baroGenOperativo() && presionBaro() != presionAnterior) {
         // Obtencion de la altitud
         float alt = calcularAltitudBaroAHRS(presionSueloBaro() , presionBaro());
 
-    	if (!(isnan(alt) || isinf(alt))) {
-    		ahrs.posicion.pos[2] = alt;
-    	}
+        presionAnterior = presionBaro();
+    	if (!(isnan(alt) || isinf(alt)))
+    	    fusionarBaroNavegacion(&navegacion, alt);
     }
+
+#ifdef USAR_GPS
+    fusionarGPSahrs();
+#endif
+
+    posicionNavegacion(&navegacion, ahrs.posicion.pos);
+    velocidadNavegacion(&navegacion, ahrs.posicion.vel);
+    ahrs.posicion.acel[0] = navegacion.acel[0];
+    ahrs.posicion.acel[1] = navegacion.acel[1];
+    ahrs.posicion.acel[2] = navegacion.acel[2];
+}
+
+
+#ifdef USAR_GPS
+/***************************************************************************************
+**  Nombre:         void fusionarGPSahrs(void)
+**  Descripcion:    Pasa la medida nueva del GPS general a NED y la fusiona. El origen es el
+**                  primer fix 3D, con la altitud ajustada a la estimada en ese momento
+**  Parametros:     Ninguno
+**  Retorno:        Ninguno
+****************************************************************************************/
+void fusionarGPSahrs(void)
+{
+    medidaGPSnav_t medida;
+    localizacion_t loc;
+
+    if (!gpsGenOperativo() || statusGPS() < GPS_OK_FIX_3D || tiempoMedidaGPS() == ultimaMedidaGPS)
+        return;
+
+    ultimaMedidaGPS = tiempoMedidaGPS();
+    localizacionGPS(&loc);
+
+    if (!origenGPSvalido) {
+        origenGPS = loc;
+        origenGPS.altitud += (int32_t)lroundf(navegacion.x[IND_POS_NAV + 2] * 100);
+        origenGPSvalido = true;
+    }
+
+    distanciaNE(origenGPS, loc, medida.pos);
+    medida.pos[2] = -(loc.altitud - origenGPS.altitud) * 0.01f;
+    velocidadGPS(medida.vel);
+    precisionGPS(&medida.precisionHorizontal, &medida.precisionVertical, &medida.precisionVel);
+    medida.tieneVelVertical = tieneVelVerticalGPS();
+    medida.tiempo = tiempoSolucionGPS() != 0 ? tiempoSolucionGPS() : ultimaMedidaGPS * 1000;
+
+    fusionarGPSnavegacion(&navegacion, &medida);
 }
+#endif
 
 
 /***************************************************************************************
@@ -302,7 +387,7 @@ float calcularAltitudBaroAHRS(float pBase, float p)
     float temp = kelvin(temperaturaSueloBaro());
     float escalado = p / pBase;
 
-    return 153.8462f * temp * (1.0f - expf(0.190259f * logf(escalado)));
+    return 153.8462f * temp * (1.0f - POW_AHRS(escalado, 0.190259f));
 }
 
 
@@ -7,7 +7,7 @@
 **
 **  Autor: Ramon Rico
 **  Fecha de creacion: 06/10/2020
-**  Fecha de modificacion: 06/10/2020
+**  Fecha de modificacion: 17/10/2026
 **
 **  El proyecto URpilot NO es libre. No se puede distribuir y/o modificar este fichero
 **  bajo ningun concepto.
@@ -65,9 +65,9 @@ typedef struct {
 } ahrsActitud_t;
 
 typedef struct {
-    float pos[3];
-    float vel[3];
-    float acel[3];
+    float pos[3];                        // NED en m. Origen en el primer fix 3D y altitud del suelo
+    float vel[3];                        // NED en m/s
+    float acel[3];                       // NED en m/s² sin gravedad
 } ahrsPosicion_t;
 
 typedef struct {
@@ -95,7 +95,7 @@ void iniciarAHRS(void);
 void ajustarFiltroAcelAngAHRS(uint16_t frec);
 void actualizarActitudAHRS(void);
 void actualizarAcelActitudAHRS(float dt);
-void actualizarPosicionAHRS(void);
+void actualizarPosicionAHRS(uint32_t tiempoActual);
 
 void actitudAHRS(float *angulo);
 void velAngularAHRS(float *vel);
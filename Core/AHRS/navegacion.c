@@ -0,0 +1,588 @@
+/***************************************************************************************
+**  navegacion.c - Filtro de Kalman extendido de navegacion. Fusiona la IMU, el GPS y el barometro
+**
+**
+**  Este fichero forma parte del proyecto URpilot.
+**  Codigo desarrollado por el grupo de investigacion ICON de la Universidad de La Rioja
+**
+**  Autor: Ramon Rico
+**  Fecha de creacion: 17/10/2026
+**  Fecha de modificacion: 17/10/2026
+**
+**  El proyecto URpilot NO es libre. No se puede distribuir y/o modificar este fichero
+**  bajo ningun concepto.
+**
+**  En caso de modificacion y/o solicitud de informacion pongase en contacto con
+**  el grupo de investigacion ICON a traves de: www.unirioja.es/urpilot
+**
+**
+**  Control de versiones del fichero
+**
+**  v1.0  Ramon Rico. Se ha liberado la primera version estable
+**
+****************************************************************************************/
+
+/***************************************************************************************
+** AREA DE INCLUDES                                                                   **
+****************************************************************************************/
+#include <math.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "navegacion.h"
+#include "Comun/util.h"
+#include "Comun/matematicas.h"
+
+
+/***************************************************************************************
+** AREA DE PREPROCESADOR                                                              **
+****************************************************************************************/
+#define MASCARA_HISTORICO_NAV            (NUM_HISTORICO_NAV - 1)
+#define DT_MAX_NAV                       0.1f        // s. Limita la prediccion si el lazo se retrasa
+
+// Covarianza inicial y al reiniciar la posicion horizontal
+#define VAR_POS_INICIAL_NAV              0.25f       // m²
+#define VAR_VEL_INICIAL_NAV              0.25f       // (m/s)²
+#define VAR_BIAS_ACEL_INICIAL_NAV        0.04f       // (m/s²)²
+#define VAR_POS_MIN_NAV                  1.0e-6f
+
+// Precision si el GPS no la informa
+#define PRECISION_HORIZONTAL_DEFECTO_NAV 2.5f        // m
+#define PRECISION_VERTICAL_DEFECTO_NAV   5.0f        // m
+#define PRECISION_VEL_DEFECTO_NAV        0.5f        // m/s
+#define PRECISION_MIN_NAV                0.1f
+
+// Medidas rechazadas seguidas para reiniciar el estado con la del sensor
+#define MAX_RECHAZOS_GPS_NAV             10
+#define MAX_RECHAZOS_BARO_NAV            100
+
+STATIC_ASSERT((NUM_HISTORICO_NAV & MASCARA_HISTORICO_NAV) == 0, historico_navegacion_potencia_de_2);
+
+
+/***************************************************************************************
+** AREA DE DEFINICION DE TIPOS                                                        **
+****************************************************************************************/
+
+
+/***************************************************************************************
+** AREA DE DECLARACION DE VARIABLES                                                   **
+****************************************************************************************/
+
+
+/***************************************************************************************
+** AREA DE PROTOTIPOS DE FUNCION                                                      **
+****************************************************************************************/
+void matrizRotacionNav(const float *q, float r[3][3]);
+void propagarCovarianzaNav(navegacion_t *nav, float r[3][3], float dt);
+void anadirHistoricoNav(navegacion_t *nav);
+const historicoNav_t *buscarHistoricoNav(const navegacion_t *nav, uint32_t tiempo);
+float varianzaInnovacionNav(const navegacion_t *nav, const float *h, float varMedida, float *PHt);
+void fusionarEscalarNav(navegacion_t *nav, const float *PHt, float innovacion, float S, float *dx);
+void reiniciarHorizontalNav(navegacion_t *nav, const medidaGPSnav_t *medida, float varPos, float varVel);
+void resetearEstadoHorizontalNav(navegacion_t *nav, uint8_t indice, float valor, float varianza);
+
+
+/***************************************************************************************
+** AREA DE DEFINICION DE FUNCIONES                                                    **
+****************************************************************************************/
+
+/***************************************************************************************
+**  Nombre:         void iniciarNavegacion(navegacion_t *nav, const configNavegacion_t *config)
+**  Descripcion:    Inicia el filtro en el origen y en reposo. La posicion horizontal no es
+**                  valida hasta la primera medida del GPS
+**  Parametros:     Filtro, configuracion
+**  Retorno:        Ninguno
+****************************************************************************************/
+void iniciarNavegacion(navegacion_t *nav, const configNavegacion_t *config)
+{
+    memset(nav, 0, sizeof(navegacion_t));
+
+    nav->retardoGPS = config->retardoGPS * 1000;
+    nav->varAcel = config->ruidoAcel * config->ruidoAcel;
+    nav->varBiasAcel = config->ruidoBiasAcel * config->ruidoBiasAcel;
+    nav->varBaro = config->ruidoBaro * config->ruidoBaro;
+    nav->varBiasBaro = config->ruidoBiasBaro * config->ruidoBiasBaro;
+    nav->umbralInnovacion2 = config->umbralInnovacion * config->umbralInnovacion;
+
+    for (uint8_t i = 0; i < 3; i++) {
+        nav->P[IND_POS_NAV + i][IND_POS_NAV + i] = VAR_POS_INICIAL_NAV;
+        nav->P[IND_VEL_NAV + i][IND_VEL_NAV + i] = VAR_VEL_INICIAL_NAV;
+        nav->P[IND_BIAS_ACEL_NAV + i][IND_BIAS_ACEL_NAV + i] = VAR_BIAS_ACEL_INICIAL_NAV;
+    }
+}
+
+
+/***************************************************************************************
+**  Nombre:         void predecirNavegacion(navegacion_t *nav, uint32_t tiempo, const float *q, const float *acel)
+**  Descripcion:    Integra la aceleracion de la IMU girada con la actitud del AHRS y propaga
+**                  la covarianza
+**  Parametros:     Filtro, tiempo actual en us, cuaternion cuerpo a NED, aceleracion en g
+**                  con el convenio de la IMU (+1 en z en reposo)
+**  Retorno:        Ninguno
+****************************************************************************************/
+void predecirNavegacion(navegacion_t *nav, uint32_t tiempo, const float *q, const float *acel)
+{
+    float r[3][3], f[3];
+
+    if (!nav->iniciado) {
+        nav->iniciado = true;
+        nav->tiempo = tiempo;
+        anadirHistoricoNav(nav);
+        return;
+    }
+
+    const float dt = MIN((tiempo - nav->tiempo) * 1.0e-6f, DT_MAX_NAV);
+    nav->tiempo = tiempo;
+
+    if (dt <= 0)
+        return;
+
+    // Aceleracion NED: a = g * e3 - R * (g * acel - bias)
+    matrizRotacionNav(q, r);
+
+    for (uint8_t i = 0; i < 3; i++)
+        f[i] = acel[i] * G_A_MSS - nav->x[IND_BIAS_ACEL_NAV + i];
+
+    for (uint8_t i = 0; i < 3; i++)
+        nav->acel[i] = -(r[i][0] * f[0] + r[i][1] * f[1] + r[i][2] * f[2]);
+
+    nav->acel[2] += G_A_MSS;
+
+    for (uint8_t i = 0; i < 3; i++) {
+        nav->x[IND_POS_NAV + i] += (nav->x[IND_VEL_NAV + i] + 0.5f * nav->acel[i] * dt) * dt;
+        nav->x[IND_VEL_NAV + i] += nav->acel[i] * dt;
+    }
+
+    propagarCovarianzaNav(nav, r, dt);
+
+    // Sin GPS se integra la IMU y la solucion deja de ser valida al pasar el timeout. Antes del
+    // primer GPS no hay referencia horizontal y se queda en el origen
+    if (nav->horizontalValido && (tiempo - nav->tiempoUltimoGPS) > TIMEOUT_GPS_NAV_US)
+        nav->horizontalValido = false;
+
+    if (!nav->conGPS) {
+        for (uint8_t i = 0; i < 2; i++) {
+            resetearEstadoHorizontalNav(nav, IND_POS_NAV + i, nav->x[IND_POS_NAV + i], VAR_POS_INICIAL_NAV);
+            resetearEstadoHorizontalNav(nav, IND_VEL_NAV + i, 0, VAR_VEL_INICIAL_NAV);
+        }
+    }
+
+    anadirHistoricoNav(nav);
+}
+
+
+/***************************************************************************************
+**  Nombre:         bool fusionarBaroNavegacion(navegacion_t *nav, float altitud)
+**  Descripcion:    Fusiona la altitud del barometro respecto al suelo. El bias del
+**                  barometro absorbe la deriva frente a la altitud del GPS
+**  Parametros:     Filtro, altitud en m
+**  Retorno:        True si se ha fusionado
+****************************************************************************************/
+bool fusionarBaroNavegacion(navegacion_t *nav, float altitud)
+{
+    float h[NUM_ESTADOS_NAV], PHt[NUM_ESTADOS_NAV];
+
+    if (!nav->iniciado)
+        return false;
+
+    // altitud = -pD + bias
+    memset(h, 0, sizeof(h));
+    h[IND_POS_NAV + 2] = -1;
+    h[IND_BIAS_BARO_NAV] = 1;
+
+    // La primera medida fija la altura
+    if (!nav->verticalIniciado) {
+        nav->verticalIniciado = true;
+        nav->x[IND_POS_NAV + 2] = nav->x[IND_BIAS_BARO_NAV] - altitud;
+        return true;
+    }
+
+    const float innovacion = altitud - (-nav->x[IND_POS_NAV + 2] + nav->x[IND_BIAS_BARO_NAV]);
+    const float S = varianzaInnovacionNav(nav, h, nav->varBaro, PHt);
+
+    if (innovacion * innovacion > nav->umbralInnovacion2 * S) {
+        nav->numRechazosBaro++;
+
+        // Un salto persistente se trata como un cambio de referencia del barometro
+        if (++nav->rechazosSeguidosBaro >= MAX_RECHAZOS_BARO_NAV) {
+            nav->x[IND_BIAS_BARO_NAV] += innovacion;
+            nav->rechazosSeguidosBaro = 0;
+        }
+
+        return false;
+    }
+
+    nav->rechazosSeguidosBaro = 0;
+    fusionarEscalarNav(nav, PHt, innovacion, S, NULL);
+    return true;
+}
+
+
+/***************************************************************************************
+**  Nombre:         bool fusionarGPSnavegacion(navegacion_t *nav, const medidaGPSnav_t *medida)
+**  Descripcion:    Fusiona la posicion y la velocidad del GPS contra el estado guardado en
+**                  el instante de la medida. La correccion se aplica al estado actual y al
+**                  historico
+**  Parametros:     Filtro, medida
+**  Retorno:        True si se ha fusionado
+****************************************************************************************/
+bool fusionarGPSnavegacion(navegacion_t *nav, const medidaGPSnav_t *medida)
+{
+    float h[NUM_ESTADOS_NAV], PHt[NUM_ESTADOS_NAV], dx[NUM_ESTADOS_NAV];
+    float var[6], innovacion[6], S[6];
+    bool posValida = true, velValida = true;
+
+    if (!nav->iniciado)
+        return false;
+
+    const float precH = medida->precisionHorizontal > 0 ? medida->precisionHorizontal : PRECISION_HORIZONTAL_DEFECTO_NAV;
+    const float precV = medida->precisionVertical > 0 ? medida->precisionVertical : PRECISION_VERTICAL_DEFECTO_NAV;
+    const float precVel = medida->precisionVel > 0 ? medida->precisionVel : PRECISION_VEL_DEFECTO_NAV;
+
+    var[0] = var[1] = powf(MAX(precH, PRECISION_MIN_NAV), 2);
+    var[2] = powf(MAX(precV, PRECISION_MIN_NAV), 2);
+    var[3] = var[4] = var[5] = powf(MAX(precVel, PRECISION_MIN_NAV), 2);
+
+    // Sin solucion horizontal se toma la del GPS adelantada hasta el instante actual
+    if (!nav->horizontalValido)
+        reiniciarHorizontalNav(nav, medida, var[0], var[3]);
+
+    nav->tiempoUltimoGPS = medida->tiempo;
+
+    const historicoNav_t *estadoMedida = buscarHistoricoNav(nav, medida->tiempo - nav->retardoGPS);
+    const uint8_t numComponentes = medida->tieneVelVertical ? 6 : 5;
+
+    // Se comprueban las innovaciones con la covarianza previa. Posicion y velocidad se aceptan por separado
+    memset(h, 0, sizeof(h));
+    for (uint8_t k = 0; k < numComponentes; k++) {
+        const uint8_t indice = k < 3 ? IND_POS_NAV + k : IND_VEL_NAV + k - 3;
+        const float estimado = k < 3 ? estadoMedida->pos[k] : estadoMedida->vel[k - 3];
+        const float z = k < 3 ? medida->pos[k] : medida->vel[k - 3];
+
+        innovacion[k] = z - estimado;
+        S[k] = nav->P[indice][indice] + var[k];
+
+        if (innovacion[k] * innovacion[k] > nav->umbralInnovacion2 * S[k]) {
+            if (k < 3)
+                posValida = false;
+            else
+                velValida = false;
+        }
+    }
+
+    if (!posValida && !velValida) {
+        nav->numRechazosGPS++;
+
+        // Si el GPS se rechaza de forma continuada se confia en el
+        if (++nav->rechazosSeguidosGPS >= MAX_RECHAZOS_GPS_NAV) {
+            reiniciarHorizontalNav(nav, medida, var[0], var[3]);
+            nav->rechazosSeguidosGPS = 0;
+        }
+
+        return false;
+    }
+
+    nav->rechazosSeguidosGPS = 0;
+    nav->numFusionesGPS++;
+
+    // Fusion secuencial. Cada componente ve el estado corregido por las anteriores
+    memset(dx, 0, sizeof(dx));
+    for (uint8_t k = 0; k < numComponentes; k++) {
+        const uint8_t indice = k < 3 ? IND_POS_NAV + k : IND_VEL_NAV + k - 3;
+
+        if ((k < 3 && !posValida) || (k >= 3 && !velValida))
+            continue;
+
+        h[indice] = 1;
+        S[k] = varianzaInnovacionNav(nav, h, var[k], PHt);
+        fusionarEscalarNav(nav, PHt, innovacion[k] - dx[indice], S[k], dx);
+        h[indice] = 0;
+    }
+
+    // El historico se desplaza con la misma correccion para las siguientes medidas retrasadas
+    for (uint8_t i = 0; i < nav->numHistorico; i++) {
+        historicoNav_t *entrada = &nav->historico[(nav->indiceHistorico - i) & MASCARA_HISTORICO_NAV];
+
+        for (uint8_t j = 0; j < 3; j++) {
+            entrada->pos[j] += dx[IND_POS_NAV + j];
+            entrada->vel[j] += dx[IND_VEL_NAV + j];
+        }
+    }
+
+    return true;
+}
+
+
+/***************************************************************************************
+**  Nombre:         void matrizRotacionNav(const float *q, float r[3][3])
+**  Descripcion:    Matriz de rotacion del cuerpo a NED
+**  Parametros:     Cuaternion, matriz
+**  Retorno:        Ninguno
+****************************************************************************************/
+void matrizRotacionNav(const float *q, float r[3][3])
+{
+    const float q0q0 = q[0] * q[0], q1q1 = q[1] * q[1], q2q2 = q[2] * q[2], q3q3 = q[3] * q[3];
+    const float q0q1 = q[0] * q[1], q0q2 = q[0] * q[2], q0q3 = q[0] * q[3];
+    const float q1q2 = q[1] * q[2], q1q3 = q[1] * q[3], q2q3 = q[2] * q[3];
+
+    r[0][0] = q0q0 + q1q1 - q2q2 - q3q3;
+    r[0][1] = 2 * (q1q2 - q0q3);
+    r[0][2] = 2 * (q1q3 + q0q2);
+    r[1][0] = 2 * (q1q2 + q0q3);
+    r[1][1] = q0q0 - q1q1 + q2q2 - q3q3;
+    r[1][2] = 2 * (q2q3 - q0q1);
+    r[2][0] = 2 * (q1q3 - q0q2);
+    r[2][1] = 2 * (q2q3 + q0q1);
+    r[2][2] = q0q0 - q1q1 - q2q2 + q3q3;
+}
+
+
+/***************************************************************************************
+**  Nombre:         void propagarCovarianzaNav(navegacion_t *nav, float r[3][3], float dt)
+**  Descripcion:    P = F * P * F' + Q aprovechando la estructura de F. Solo son distintos de
+**                  la identidad los bloques dp/dv = I * dt y dv/dbias = R * dt
+**  Parametros:     Filtro, matriz de rotacion, incremento de tiempo
+**  Retorno:        Ninguno
+****************************************************************************************/
+void propagarCovarianzaNav(navegacion_t *nav, float r[3][3], float dt)
+{
+    float (*P)[NUM_ESTADOS_NAV] = nav->P;
+
+    // F * P por filas. La fila de posicion usa la de velocidad antes de actualizarla
+    for (uint8_t j = 0; j < NUM_ESTADOS_NAV; j++) {
+        for (uint8_t i = 0; i < 3; i++)
+            P[IND_POS_NAV + i][j] += dt * P[IND_VEL_NAV + i][j];
+
+        for (uint8_t i = 0; i < 3; i++)
+            P[IND_VEL_NAV + i][j] += dt * (r[i][0] * P[IND_BIAS_ACEL_NAV][j] + r[i][1] * P[IND_BIAS_ACEL_NAV + 1][j] +
+                                           r[i][2] * P[IND_BIAS_ACEL_NAV + 2][j]);
+    }
+
+    // (F * P) * F' por columnas
+    for (uint8_t i = 0; i < NUM_ESTADOS_NAV; i++) {
+        for (uint8_t j = 0; j < 3; j++)
+            P[i][IND_POS_NAV + j] += dt * P[i][IND_VEL_NAV + j];
+
+        for (uint8_t j = 0; j < 3; j++)
+            P[i][IND_VEL_NAV + j] += dt * (r[j][0] * P[i][IND_BIAS_ACEL_NAV] + r[j][1] * P[i][IND_BIAS_ACEL_NAV + 1] +
+                                           r[j][2] * P[i][IND_BIAS_ACEL_NAV + 2]);
+    }
+
+    // Ruido de proceso
+    for (uint8_t i = 0; i < 3; i++) {
+        P[IND_POS_NAV + i][IND_POS_NAV + i] += 0.25f * nav->varAcel * dt * dt * dt * dt;
+        P[IND_VEL_NAV + i][IND_VEL_NAV + i] += nav->varAcel * dt * dt;
+        P[IND_BIAS_ACEL_NAV + i][IND_BIAS_ACEL_NAV + i] += nav->varBiasAcel * dt;
+    }
+
+    P[IND_BIAS_BARO_NAV][IND_BIAS_BARO_NAV] += nav->varBiasBaro * dt;
+
+    // Se fuerza la simetria para que no se acumule el error de redondeo
+    for (uint8_t i = 0; i < NUM_ESTADOS_NAV; i++) {
+        for (uint8_t j = i + 1; j < NUM_ESTADOS_NAV; j++) {
+            const float media = 0.5f * (P[i][j] + P[j][i]);
+
+            P[i][j] = media;
+            P[j][i] = media;
+        }
+    }
+}
+
+
+/***************************************************************************************
+**  Nombre:         void anadirHistoricoNav(navegacion_t *nav)
+**  Descripcion:    Guarda la posicion y la velocidad actuales en el historico
+**  Parametros:     Filtro
+**  Retorno:        Ninguno
+****************************************************************************************/
+void anadirHistoricoNav(navegacion_t *nav)
+{
+    nav->indiceHistorico = (nav->indiceHistorico + 1) & MASCARA_HISTORICO_NAV;
+
+    historicoNav_t *entrada = &nav->historico[nav->indiceHistorico];
+
+    entrada->tiempo = nav->tiempo;
+    memcpy(entrada->pos, &nav->x[IND_POS_NAV], sizeof(entrada->pos));
+    memcpy(entrada->vel, &nav->x[IND_VEL_NAV], sizeof(entrada->vel));
+
+    if (nav->numHistorico < NUM_HISTORICO_NAV)
+        nav->numHistorico++;
+}
+
+
+/***************************************************************************************
+**  Nombre:         const historicoNav_t *buscarHistoricoNav(const navegacion_t *nav, uint32_t tiempo)
+**  Descripcion:    Busca la entrada del historico mas cercana a un instante. Si el instante
+**                  es anterior al historico se devuelve la entrada mas antigua
+**  Parametros:     Filtro, instante en us
+**  Retorno:        Entrada del historico
+****************************************************************************************/
+const historicoNav_t *buscarHistoricoNav(const navegacion_t *nav, uint32_t tiempo)
+{
+    const historicoNav_t *entrada = &nav->historico[nav->indiceHistorico];
+
+    // Se recorre hacia atras mientras la entrada anterior este mas cerca
+    for (uint8_t i = 1; i < nav->numHistorico; i++) {
+        const historicoNav_t *anterior = &nav->historico[(nav->indiceHistorico - i) & MASCARA_HISTORICO_NAV];
+
+        if (abs((int32_t)(anterior->tiempo - tiempo)) >= abs((int32_t)(entrada->tiempo - tiempo)))
+            break;
+
+        entrada = anterior;
+    }
+
+    return entrada;
+}
+
+
+/***************************************************************************************
+**  Nombre:         float varianzaInnovacionNav(const navegacion_t *nav, const float *h, float varMedida,
+**                                              float *PHt)
+**  Descripcion:    Calcula P * h' y la varianza de la innovacion de una medida escalar
+**  Parametros:     Filtro, fila de la matriz de observacion, varianza de la medida, P * h'
+**  Retorno:        Varianza de la innovacion
+****************************************************************************************/
+float varianzaInnovacionNav(const navegacion_t *nav, const float *h, float varMedida, float *PHt)
+{
+    float S = varMedida;
+
+    for (uint8_t i = 0; i < NUM_ESTADOS_NAV; i++) {
+        float suma = 0;
+
+        for (uint8_t j = 0; j < NUM_ESTADOS_NAV; j++)
+            suma += nav->P[i][j] * h[j];
+
+        PHt[i] = suma;
+        S += h[i] * suma;
+    }
+
+    return S;
+}
+
+
+/***************************************************************************************
+**  Nombre:         void fusionarEscalarNav(navegacion_t *nav, const float *PHt, float innovacion, float S,
+**                                          float *dx)
+**  Descripcion:    Actualizacion de Kalman de una medida escalar: K = P * h' / S, x += K * y,
+**                  P -= K * h * P
+**  Parametros:     Filtro, P * h', innovacion, varianza de la innovacion, correccion acumulada
+**                  (puede ser NULL)
+**  Retorno:        Ninguno
+****************************************************************************************/
+void fusionarEscalarNav(navegacion_t *nav, const float *PHt, float innovacion, float S, float *dx)
+{
+    const float invS = 1.0f / S;
+
+    for (uint8_t i = 0; i < NUM_ESTADOS_NAV; i++) {
+        const float K = PHt[i] * invS;
+
+        nav->x[i] += K * innovacion;
+        if (dx != NULL)
+            dx[i] += K * innovacion;
+
+        for (uint8_t j = 0; j < NUM_ESTADOS_NAV; j++)
+            nav->P[i][j] -= K * PHt[j];
+    }
+
+    // La diagonal no puede quedar negativa por redondeo
+    for (uint8_t i = 0; i < NUM_ESTADOS_NAV; i++) {
+        if (nav->P[i][i] < VAR_POS_MIN_NAV)
+            nav->P[i][i] = VAR_POS_MIN_NAV;
+    }
+}
+
+
+/***************************************************************************************
+**  Nombre:         void reiniciarHorizontalNav(navegacion_t *nav, const medidaGPSnav_t *medida, float varPos,
+**                                              float varVel)
+**  Descripcion:    Toma la posicion y la velocidad horizontales del GPS. El historico se
+**                  rellena con la medida para que la fusion siguiente sea coherente
+**  Parametros:     Filtro, medida, varianzas de la posicion y la velocidad
+**  Retorno:        Ninguno
+****************************************************************************************/
+void reiniciarHorizontalNav(navegacion_t *nav, const medidaGPSnav_t *medida, float varPos, float varVel)
+{
+    const uint32_t tiempoMedida = medida->tiempo - nav->retardoGPS;
+
+    for (uint8_t i = 0; i < nav->numHistorico; i++) {
+        historicoNav_t *entrada = &nav->historico[(nav->indiceHistorico - i) & MASCARA_HISTORICO_NAV];
+        const float dt = (int32_t)(entrada->tiempo - tiempoMedida) * 1.0e-6f;
+
+        for (uint8_t j = 0; j < 2; j++) {
+            entrada->pos[j] = medida->pos[j] + medida->vel[j] * dt;
+            entrada->vel[j] = medida->vel[j];
+        }
+    }
+
+    const float dt = (int32_t)(nav->tiempo - tiempoMedida) * 1.0e-6f;
+
+    for (uint8_t i = 0; i < 2; i++) {
+        resetearEstadoHorizontalNav(nav, IND_POS_NAV + i, medida->pos[i] + medida->vel[i] * dt, varPos);
+        resetearEstadoHorizontalNav(nav, IND_VEL_NAV + i, medida->vel[i], varVel);
+    }
+
+    nav->conGPS = true;
+    nav->horizontalValido = true;
+}
+
+
+/***************************************************************************************
+**  Nombre:         void resetearEstadoHorizontalNav(navegacion_t *nav, uint8_t indice, float valor, float varianza)
+**  Descripcion:    Fija un estado y lo descorrela del resto
+**  Parametros:     Filtro, indice del estado, valor, varianza
+**  Retorno:        Ninguno
+****************************************************************************************/
+void resetearEstadoHorizontalNav(navegacion_t *nav, uint8_t indice, float valor, float varianza)
+{
+    nav->x[indice] = valor;
+
+    for (uint8_t i = 0; i < NUM_ESTADOS_NAV; i++) {
+        nav->P[indice][i] = 0;
+        nav->P[i][indice] = 0;
+    }
+
+    nav->P[indice][indice] = varianza;
+}
+
+
+/***************************************************************************************
+**  Nombre:         void posicionNavegacion(const navegacion_t *nav, float *pos)
+**  Descripcion:    Devuelve la posicion estimada
+**  Parametros:     Filtro, posicion NED en m
+**  Retorno:        Ninguno
+****************************************************************************************/
+void posicionNavegacion(const navegacion_t *nav, float *pos)
+{
+    pos[0] = nav->x[IND_POS_NAV];
+    pos[1] = nav->x[IND_POS_NAV + 1];
+    pos[2] = nav->x[IND_POS_NAV + 2];
+}
+
+
+/***************************************************************************************
+**  Nombre:         void velocidadNavegacion(const navegacion_t *nav, float *vel)
+**  Descripcion:    Devuelve la velocidad estimada
+**  Parametros:     Filtro, velocidad NED en m/s
+**  Retorno:        Ninguno
+****************************************************************************************/
+void velocidadNavegacion(const navegacion_t *nav, float *vel)
+{
+    vel[0] = nav->x[IND_VEL_NAV];
+    vel[1] = nav->x[IND_VEL_NAV + 1];
+    vel[2] = nav->x[IND_VEL_NAV + 2];
+}
+
+
+/***************************************************************************************
+**  Nombre:         void desviacionNavegacion(const navegacion_t *nav, float *desvPos, float *desvVel)
+**  Descripcion:    Devuelve la desviacion tipica de la posicion y la velocidad
+**  Parametros:     Filtro, desviacion de la posicion en m, desviacion de la velocidad en m/s
+**  Retorno:        Ninguno
+****************************************************************************************/
+void desviacionNavegacion(const navegacion_t *nav, float *desvPos, float *desvVel)
+{
+    for (uint8_t i = 0; i < 3; i++) {
+        desvPos[i] = sqrtf(nav->P[IND_POS_NAV + i][IND_POS_NAV + i]);
+        desvVel[i] = sqrtf(nav->P[IND_VEL_NAV + i][IND_VEL_NAV + i]);
+    }
+}
@@ -0,0 +1,121 @@
+/***************************************************************************************
+**  navegacion.h - Filtro de Kalman extendido de navegacion. Fusiona la IMU, el GPS y el barometro
+**
+**
+**  Este fichero forma parte del proyecto URpilot.
+**  Codigo desarrollado por el grupo de investigacion ICON de la Universidad de La Rioja
+**
+**  Autor: Ramon Rico
+**  Fecha de creacion: 17/10/2026
+**  Fecha de modificacion: 17/10/2026
+**
+**  El proyecto URpilot NO es libre. No se puede distribuir y/o modificar este fichero
+**  bajo ningun concepto.
+**
+**  En caso de modificacion y/o solicitud de informacion pongase en contacto con
+**  el grupo de investigacion ICON a traves de: www.unirioja.es/urpilot
+**
+**
+**  Control de versiones del fichero
+**
+**  v1.0  Ramon Rico. Se ha liberado la primera version estable
+**
+****************************************************************************************/
+
+#ifndef __NAVEGACION_H
+#define __NAVEGACION_H
+
+/***************************************************************************************
+** AREA DE INCLUDES                                                                   **
+****************************************************************************************/
+#include <stdint.h>
+#include <stdbool.h>
+
+#include "GP/gp_ahrs.h"
+
+
+/***************************************************************************************
+** AREA DE PREPROCESADOR                                                              **
+****************************************************************************************/
+// Estado: posicion y velocidad NED, bias del acelerometro en ejes cuerpo y bias del barometro
+#define NUM_ESTADOS_NAV              10
+#define IND_POS_NAV                  0
+#define IND_VEL_NAV                  3
+#define IND_BIAS_ACEL_NAV            6
+#define IND_BIAS_BARO_NAV            9
+
+// Historico de la posicion y la velocidad para fusionar el GPS en el instante de la medida
+#define NUM_HISTORICO_NAV            32          // Potencia de 2. Cubre el retardo a la frecuencia del lazo
+#define TIMEOUT_GPS_NAV_US           5000000     // Sin GPS la posicion horizontal deja de ser valida
+
+
+/***************************************************************************************
+** AREA DE DEFINICION DE TIPOS                                                        **
+****************************************************************************************/
+typedef struct {
+    uint32_t tiempo;                     // us
+    float pos[3];
+    float vel[3];
+} historicoNav_t;
+
+typedef struct {
+    uint32_t tiempo;                     // us de llegada. El instante de la medida se obtiene con el retardo
+    float pos[3];                        // NED en m
+    float vel[3];                        // NED en m/s
+    float precisionHorizontal;           // m
+    float precisionVertical;             // m
+    float precisionVel;                  // m/s
+    bool tieneVelVertical;
+} medidaGPSnav_t;
+
+typedef struct {
+    bool iniciado;
+    bool verticalIniciado;               // La altura parte de la primera medida del barometro
+    bool conGPS;                         // Hasta el primer GPS la posicion horizontal se queda en el origen
+    bool horizontalValido;               // Hay GPS reciente. Sin el se sigue integrando la IMU
+    uint32_t tiempo;                     // us de la ultima prediccion
+    uint32_t tiempoUltimoGPS;
+
+    float x[NUM_ESTADOS_NAV];
+    float P[NUM_ESTADOS_NAV][NUM_ESTADOS_NAV];
+    float acel[3];                       // NED en m/s² sin gravedad ni bias
+
+    historicoNav_t historico[NUM_HISTORICO_NAV];
+    uint8_t indiceHistorico;
+    uint8_t numHistorico;
+
+    // Parametros
+    uint32_t retardoGPS;                 // us
+    float varAcel;
+    float varBiasAcel;
+    float varBaro;
+    float varBiasBaro;
+    float umbralInnovacion2;
+
+    // Estadisticas
+    uint32_t numFusionesGPS;
+    uint32_t numRechazosGPS;
+    uint8_t rechazosSeguidosGPS;
+    uint32_t numRechazosBaro;
+    uint8_t rechazosSeguidosBaro;
+} navegacion_t;
+
+
+/***************************************************************************************
+** AREA DE DECLARACION DE VARIABLES                                                   **
+****************************************************************************************/
+
+
+/***************************************************************************************
+** AREA DE PROTOTIPOS DE FUNCION                                                      **
+****************************************************************************************/
+void iniciarNavegacion(navegacion_t *nav, const configNavegacion_t *config);
+void predecirNavegacion(navegacion_t *nav, uint32_t tiempo, const float *q, const float *acel);
+bool fusionarBaroNavegacion(navegacion_t *nav, float altitud);
+bool fusionarGPSnavegacion(navegacion_t *nav, const medidaGPSnav_t *medida);
+
+void posicionNavegacion(const navegacion_t *nav, float *pos);
+void velocidadNavegacion(const navegacion_t *nav, float *vel);
+void desviacionNavegacion(const navegacion_t *nav, float *desvPos, float *desvVel);
+
+#endif // __NAVEGACION_H
@@ -7,7 +7,7 @@
 **
 **  Autor: Ramon Rico
 **  Fecha de creacion: 14/05/2020
-**  Fecha de modificacion: 21/09/2020
+**  Fecha de modificacion: 17/10/2026
 **
 **  El proyecto URpilot NO es libre. No se puede distribuir y/o modificar este fichero
 **  bajo ningun concepto.
@@ -31,6 +31,7 @@
 
 #ifdef USAR_BLACKBOX
 #include "blackbox_sd.h"
+#include "codificacion_blackbox.h"
 #include "GP/gp_blackbox.h"
 #include "Drivers/tiempo.h"
 #include "Drivers/rtc.h"
@@ -40,7 +41,9 @@
 #include "Sensores/Magnetometro/magnetometro.h"
 #include "Sensores/IMU/imu.h"
 #include "Sensores/GPS/gps.h"
+#include "FC/mixer.h"
 #include "Comun/util.h"
+#include "Comun/matematicas.h"
 #include "sd.h"
 #include "asyncfatfs/asyncfatfs.h"
 
@@ -50,6 +53,13 @@
 ****************************************************************************************/
 #define TIMEOUT_APAGAR_MS_BLACKBOX   200
 
+// Cada cuantas tramas predichas se escribe una intra para poder recuperar el log si se corrompe
+#define NUM_TRAMAS_ENTRE_INTRA_BLACKBOX         32
+
+#define NUM_MAX_COLUMNAS_RAPIDAS_BLACKBOX       (2 + 6 * NUM_MAX_IMU + 3 * NUM_MAX_MAG + 2 * NUM_MAX_BARO + 8 + 8)
+#define NUM_MAX_COLUMNAS_LENTAS_BLACKBOX        (3 * NUM_MAX_IMU + 6 * NUM_MAX_GPS)
+#define NUM_MAX_BYTES_TRAMA_BLACKBOX            (1 + NUM_MAX_COLUMNAS_RAPIDAS_BLACKBOX * (NUM_MAX_BYTES_VAR_INT_BLACKBOX + 1))
+
 
 /***************************************************************************************
 ** AREA DE DEFINICION DE TIPOS                                                        **
@@ -74,17 +84,46 @@ typedef enum {
     BLACKBOX_NUM_DRIVERS_BARO,
     BLACKBOX_NUM_DRIVERS_MAG,
     BLACKBOX_NUM_DRIVERS_GPS,
+    BLACKBOX_MOTOR_MIXER,                    // Un campo si el mixer usa el motor
 } numDriversBlackbox_e;
 
 typedef struct {
     const char *nombre;
     int8_t indiceNombreCampo;
     numDriversBlackbox_e numDrivers;
+    predictorBlackbox_e predictor;           // Solo se aplica en las tramas predichas
+    codificacionBlackbox_e codificacion;     // Solo se aplica en las tramas predichas
+    uint8_t decimales;                       // El campo se guarda como entero multiplicado por 10^decimales
 } defCabCampoBlackbox_t;
 
+// Drivers al empezar el log. La cabecera y las tramas usan siempre estos
+typedef struct {
+    uint8_t numIMUs;
+    uint8_t numBaros;
+    uint8_t numMags;
+    uint8_t numGPS;
+    uint8_t numMotores;
+} driversBlackbox_t;
+
+typedef struct {
+    uint8_t numColumnas;
+    const defCabCampoBlackbox_t *defColumna[NUM_MAX_COLUMNAS_RAPIDAS_BLACKBOX];
+    int32_t valor[NUM_MAX_COLUMNAS_RAPIDAS_BLACKBOX];
+    int32_t anterior[NUM_MAX_COLUMNAS_RAPIDAS_BLACKBOX];
+    int32_t anterior2[NUM_MAX_COLUMNAS_RAPIDAS_BLACKBOX];
+    uint8_t tramasDesdeIntra;
+    bool forzarIntra;
+} columnasRapidasBlackbox_t;
+
+typedef struct {
+    uint8_t numColumnas;
+    const defCabCampoBlackbox_t *defColumna[NUM_MAX_COLUMNAS_LENTAS_BLACKBOX];
+    int32_t valor[NUM_MAX_COLUMNAS_LENTAS_BLACKBOX];
+} columnasLentasBlackbox_t;
+
 typedef struct {
     uint32_t indiceCabecera;
-    uint8_t indiceCampo;
+    int16_t indiceCampo;                     // -1 mientras no se ha escrito el nombre de la cabecera
     uint32_t tiempoInicio;
 } datosTXblackbox_t;
 
@@ -106,66 +145,80 @@ static datosTXblackbox_t datosTXblackbox;
 static uint32_t iteradorBlackbox;
 static int32_t iteradorRapidoBlackbox = 0;
 static int32_t iteradorLentoBlackbox = 0;
+static driversBlackbox_t driversBlackbox;
+static columnasRapidasBlackbox_t columnasRapidasBlackbox;
+static columnasLentasBlackbox_t columnasLentasBlackbox;
 
 static const char cabeceraBlackbox[] =
     "C Bienvenido al grabador de datos URpilot\n"
-    "C Version Blackbox: 1\n";
+    "C Version Blackbox: " STR(VERSION_BLACKBOX) "\n";
 
 static const char* const nombresCabCampoBlackbox[] = {
     "nombre",
     "drivers",
+    "predictor",
+    "codificacion",
+    "decimales",
 };
 
+static const float potenciasDiezBlackbox[] = {1.0f, 10.0f, 100.0f, 1000.0f, 10000.0f, 100000.0f, 1000000.0f, 10000000.0f};
+
 static const defCabCampoBlackbox_t camposRapidosBlackbox[] = {
-    {"iteracion", -1,    BLACKBOX_1_DRIVER},
-    {"tiempo",    -1,    BLACKBOX_1_DRIVER},
+    {"iteracion", -1,    BLACKBOX_1_DRIVER,           PREDICTOR_LINEA_RECTA_BLACKBOX, CODIFICACION_VAR_INT_BLACKBOX,   0},
+    {"tiempo",    -1,    BLACKBOX_1_DRIVER,           PREDICTOR_LINEA_RECTA_BLACKBOX, CODIFICACION_VAR_INT_BLACKBOX,   0},
 #ifdef USAR_IMU
-    {"giro",       0,    BLACKBOX_NUM_DRIVERS_IMU},
-    {"giro",       1,    BLACKBOX_NUM_DRIVERS_IMU},
-    {"giro",       2,    BLACKBOX_NUM_DRIVERS_IMU},
-    {"acel",       0,    BLACKBOX_NUM_DRIVERS_IMU},
-    {"acel",       1,    BLACKBOX_NUM_DRIVERS_IMU},
-    {"acel",       2,    BLACKBOX_NUM_DRIVERS_IMU},
+    {"giro",       0,    BLACKBOX_NUM_DRIVERS_IMU,    PREDICTOR_MEDIA_2_BLACKBOX,     CODIFICACION_VAR_INT_BLACKBOX,   1},
+    {"giro",       1,    BLACKBOX_NUM_DRIVERS_IMU,    PREDICTOR_MEDIA_2_BLACKBOX,     CODIFICACION_VAR_INT_BLACKBOX,   1},
+    {"giro",       2,    BLACKBOX_NUM_DRIVERS_IMU,    PREDICTOR_MEDIA_2_BLACKBOX,     CODIFICACION_VAR_INT_BLACKBOX,   1},
+    {"acel",       0,    BLACKBOX_NUM_DRIVERS_IMU,    PREDICTOR_MEDIA_2_BLACKBOX,     CODIFICACION_VAR_INT_BLACKBOX,   3},
+    {"acel",       1,    BLACKBOX_NUM_DRIVERS_IMU,    PREDICTOR_MEDIA_2_BLACKBOX,     CODIFICACION_VAR_INT_BLACKBOX,   3},
+    {"acel",       2,    BLACKBOX_NUM_DRIVERS_IMU,    PREDICTOR_MEDIA_2_BLACKBOX,     CODIFICACION_VAR_INT_BLACKBOX,   3},
 #endif
 #ifdef USAR_MAG
-    {"mag",        0,    BLACKBOX_NUM_DRIVERS_MAG},
-    {"mag",        1,    BLACKBOX_NUM_DRIVERS_MAG},
-    {"mag",        2,    BLACKBOX_NUM_DRIVERS_MAG},
+    {"mag",        0,    BLACKBOX_NUM_DRIVERS_MAG,    PREDICTOR_ANTERIOR_BLACKBOX,    CODIFICACION_TAG8_8SVB_BLACKBOX, 1},
+    {"mag",        1,    BLACKBOX_NUM_DRIVERS_MAG,    PREDICTOR_ANTERIOR_BLACKBOX,    CODIFICACION_TAG8_8SVB_BLACKBOX, 1},
+    {"mag",        2,    BLACKBOX_NUM_DRIVERS_MAG,    PREDICTOR_ANTERIOR_BLACKBOX,    CODIFICACION_TAG8_8SVB_BLACKBOX, 1},
 #endif
 #ifdef USAR_BARO
-    {"BaroP",      -1,   BLACKBOX_NUM_DRIVERS_BARO},
-    {"BaroT",      -1,   BLACKBOX_NUM_DRIVERS_BARO},
+    {"BaroP",      -1,   BLACKBOX_NUM_DRIVERS_BARO,   PREDICTOR_ANTERIOR_BLACKBOX,    CODIFICACION_TAG8_8SVB_BLACKBOX, 2},
+    {"BaroT",      -1,   BLACKBOX_NUM_DRIVERS_BARO,   PREDICTOR_ANTERIOR_BLACKBOX,    CODIFICACION_TAG8_8SVB_BLACKBOX, 2},
 #endif
 #ifdef USAR_RADIO
-    {"radio",      0,    BLACKBOX_1_DRIVER},
-    {"radio",      1,    BLACKBOX_1_DRIVER},
-    {"radio",      2,    BLACKBOX_1_DRIVER},
-    {"radio",      3,    BLACKBOX_1_DRIVER},
-    {"radio",      4,    BLACKBOX_1_DRIVER},
-    {"radio",      5,    BLACKBOX_1_DRIVER},
-    {"radio",      6,    BLACKBOX_1_DRIVER},
-    {"radio",      7,    BLACKBOX_1_DRIVER},
+    {"radio",      0,    BLACKBOX_1_DRIVER,           PREDICTOR_ANTERIOR_BLACKBOX,    CODIFICACION_TAG8_8SVB_BLACKBOX, 0},
+    {"radio",      1,    BLACKBOX_1_DRIVER,           PREDICTOR_ANTERIOR_BLACKBOX,    CODIFICACION_TAG8_8SVB_BLACKBOX, 0},
+    {"radio",      2,    BLACKBOX_1_DRIVER,           PREDICTOR_ANTERIOR_BLACKBOX,    CODIFICACION_TAG8_8SVB_BLACKBOX, 0},
+    {"radio",      3,    BLACKBOX_1_DRIVER,           PREDICTOR_ANTERIOR_BLACKBOX,    CODIFICACION_TAG8_8SVB_BLACKBOX, 0},
+    {"radio",      4,    BLACKBOX_1_DRIVER,           PREDICTOR_ANTERIOR_BLACKBOX,    CODIFICACION_TAG8_8SVB_BLACKBOX, 0},
+    {"radio",      5,    BLACKBOX_1_DRIVER,           PREDICTOR_ANTERIOR_BLACKBOX,    CODIFICACION_TAG8_8SVB_BLACKBOX, 0},
+    {"radio",      6,    BLACKBOX_1_DRIVER,           PREDICTOR_ANTERIOR_BLACKBOX,    CODIFICACION_TAG8_8SVB_BLACKBOX, 0},
+    {"radio",      7,    BLACKBOX_1_DRIVER,           PREDICTOR_ANTERIOR_BLACKBOX,    CODIFICACION_TAG8_8SVB_BLACKBOX, 0},
 #endif
 #ifdef USAR_MOTORES
-    {"motor",      0,    BLACKBOX_1_DRIVER},
-    {"motor",      1,    BLACKBOX_1_DRIVER},
-    {"motor",      2,    BLACKBOX_1_DRIVER},
-    {"motor",      3,    BLACKBOX_1_DRIVER},
-    {"motor",      4,    BLACKBOX_1_DRIVER},
-    {"motor",      5,    BLACKBOX_1_DRIVER},
-    {"motor",      6,    BLACKBOX_1_DRIVER},
-    {"motor",      7,    BLACKBOX_1_DRIVER},
+    {"motor",      0,    BLACKBOX_MOTOR_MIXER,        PREDICTOR_MEDIA_2_BLACKBOX,     CODIFICACION_VAR_INT_BLACKBOX,   3},
+    {"motor",      1,    BLACKBOX_MOTOR_MIXER,        PREDICTOR_MEDIA_2_BLACKBOX,     CODIFICACION_VAR_INT_BLACKBOX,   3},
+    {"motor",      2,    BLACKBOX_MOTOR_MIXER,        PREDICTOR_MEDIA_2_BLACKBOX,     CODIFICACION_VAR_INT_BLACKBOX,   3},
+    {"motor",      3,    BLACKBOX_MOTOR_MIXER,        PREDICTOR_MEDIA_2_BLACKBOX,     CODIFICACION_VAR_INT_BLACKBOX,   3},
+    {"motor",      4,    BLACKBOX_MOTOR_MIXER,        PREDICTOR_MEDIA_2_BLACKBOX,     CODIFICACION_VAR_INT_BLACKBOX,   3},
+    {"motor",      5,    BLACKBOX_MOTOR_MIXER,        PREDICTOR_MEDIA_2_BLACKBOX,     CODIFICACION_VAR_INT_BLACKBOX,   3},
+    {"motor",      6,    BLACKBOX_MOTOR_MIXER,        PREDICTOR_MEDIA_2_BLACKBOX,     CODIFICACION_VAR_INT_BLACKBOX,   3},
+    {"motor",      7,    BLACKBOX_MOTOR_MIXER,        PREDICTOR_MEDIA_2_BLACKBOX,     CODIFICACION_VAR_INT_BLACKBOX,   3},
 #endif
 };
 
+// Las tramas lentas siempre llevan los valores absolutos
 static const defCabCampoBlackbox_t camposLentosBlackbox[] = {
+#ifdef USAR_IMU
+    {"saludIMU",  -1,    BLACKBOX_NUM_DRIVERS_IMU,    PREDICTOR_CERO_BLACKBOX,        CODIFICACION_VAR_INT_BLACKBOX,   0},
+    {"fallosIMU", -1,    BLACKBOX_NUM_DRIVERS_IMU,    PREDICTOR_CERO_BLACKBOX,        CODIFICACION_VAR_INT_BLACKBOX,   0},
+    {"pesoIMU",   -1,    BLACKBOX_NUM_DRIVERS_IMU,    PREDICTOR_CERO_BLACKBOX,        CODIFICACION_VAR_INT_BLACKBOX,   3},
+#endif
 #ifdef USAR_GPS
-    {"satelites", -1,    BLACKBOX_NUM_DRIVERS_GPS},
-    {"latitud",   -1,    BLACKBOX_NUM_DRIVERS_GPS},
-    {"longitud",  -1,    BLACKBOX_NUM_DRIVERS_GPS},
-    {"altGPS",    -1,    BLACKBOX_NUM_DRIVERS_GPS},
-    {"velGPS",    -1,    BLACKBOX_NUM_DRIVERS_GPS},
-    {"velAngGPS", -1,    BLACKBOX_NUM_DRIVERS_GPS},
+    {"satelites", -1,    BLACKBOX_NUM_DRIVERS_GPS,    PREDICTOR_CERO_BLACKBOX,        CODIFICACION_VAR_INT_BLACKBOX,   0},
+    {"latitud",   -1,    BLACKBOX_NUM_DRIVERS_GPS,    PREDICTOR_CERO_BLACKBOX,        CODIFICACION_VAR_INT_BLACKBOX,   7},
+    {"longitud",  -1,    BLACKBOX_NUM_DRIVERS_GPS,    PREDICTOR_CERO_BLACKBOX,        CODIFICACION_VAR_INT_BLACKBOX,   7},
+    {"altGPS",    -1,    BLACKBOX_NUM_DRIVERS_GPS,    PREDICTOR_CERO_BLACKBOX,        CODIFICACION_VAR_INT_BLACKBOX,   2},
+    {"velGPS",    -1,    BLACKBOX_NUM_DRIVERS_GPS,    PREDICTOR_CERO_BLACKBOX,        CODIFICACION_VAR_INT_BLACKBOX,   2},
+    {"velAngGPS", -1,    BLACKBOX_NUM_DRIVERS_GPS,    PREDICTOR_CERO_BLACKBOX,        CODIFICACION_VAR_INT_BLACKBOX,   2},
 #endif
 };
 
@@ -177,14 +230,18 @@ void ajustarEstadoBlackbox(estadoBlackbox_e estado);
 void resetearIteradoresBlackbox(void);
 void lanzarBlackbox(void);
 void actualizarIteradoresBlackbox(void);
-bool enviarDefCampoBlackbox(char identificador, const void *defCampo, const void *segundaDefcampo, uint8_t numCampos, const uint8_t *numDrivers, const uint8_t *segundoNumDrivers);
+bool enviarDefCampoBlackbox(char identificador, const defCabCampoBlackbox_t *defCampo, uint8_t numCampos);
+uint8_t prepararColumnasBlackbox(const defCabCampoBlackbox_t *defCampo, uint8_t numCampos, const defCabCampoBlackbox_t **defColumna, uint8_t numMaxColumnas);
 bool escribirInfoSistemaBlackbox(void);
 char *obtenerFechaHoraBlackbox(char *buf);
-uint8_t numDriversBlackbox(numDriversBlackbox_e numDrivers);
+uint8_t numDriversBlackbox(const defCabCampoBlackbox_t *def);
+int32_t escalarCampoBlackbox(float valor, const defCabCampoBlackbox_t *def);
 void iterarLogBlackbox(uint32_t tiempoActual);
 bool necesarioEscribirLogRapidoBlackbox(void);
 bool necesarioEscribirLogLentoBlackbox(void);
+void capturarLogRapidoBlackbox(uint32_t tiempoActual);
 void escribirLogRapidoBlackbox(uint32_t tiempoActual);
+void capturarLogLentoBlackbox(void);
 void escribirLogLentoBlackbox(void);
 
 
@@ -371,17 +428,14 @@ void actualizarBlackbox(uint32_t tiempoActual)
         case BLACKBOX_ESTADO_ENVIAR_CABECERA_CAMPO:
         	calcularBytesLibresCabBlackbox();
 
-            if (!enviarDefCampoBlackbox('R', camposRapidosBlackbox, camposRapidosBlackbox + 1, LONG_ARRAY(camposRapidosBlackbox),
-                &camposRapidosBlackbox[0].numDrivers, &camposRapidosBlackbox[1].numDrivers)) {
+            if (!enviarDefCampoBlackbox('R', camposRapidosBlackbox, LONG_ARRAY(camposRapidosBlackbox)))
             	ajustarEstadoBlackbox(BLACKBOX_ESTADO_ENVIAR_CABECERA_LENTA);
-            }
             break;
 
         case BLACKBOX_ESTADO_ENVIAR_CABECERA_LENTA:
         	calcularBytesLibresCabBlackbox();
 
-            if (!enviarDefCampoBlackbox('L', camposLentosBlackbox, camposLentosBlackbox + 1, LONG_ARRAY(camposLentosBlackbox),
-                &camposLentosBlackbox[0].numDrivers, &camposLentosBlackbox[1].numDrivers))
+            if (!enviarDefCampoBlackbox('L', camposLentosBlackbox, LONG_ARRAY(camposLentosBlackbox)))
             	ajustarEstadoBlackbox(BLACKBOX_ESTADO_ENVIAR_INFO_SISTEMA);
             break;
 
@@ -455,10 +509,46 @@ void lanzarBlackbox(void)
     }
 
     resetearIteradoresBlackbox();
+
+    // Las columnas dependen de los sensores detectados y no cambian durante el log
+    driversBlackbox.numIMUs = MIN(numIMUsConectadas(), NUM_MAX_IMU);
+    driversBlackbox.numBaros = MIN(numBarosConectados(), NUM_MAX_BARO);
+    driversBlackbox.numMags = MIN(numMagsConectados(), NUM_MAX_MAG);
+    driversBlackbox.numGPS = MIN(numGPSconectados(), NUM_MAX_GPS);
+    driversBlackbox.numMotores = MIN(numMotores(), 8);
+
+    columnasRapidasBlackbox.numColumnas = prepararColumnasBlackbox(camposRapidosBlackbox, LONG_ARRAY(camposRapidosBlackbox),
+                                                                   columnasRapidasBlackbox.defColumna, NUM_MAX_COLUMNAS_RAPIDAS_BLACKBOX);
+    columnasLentasBlackbox.numColumnas = prepararColumnasBlackbox(camposLentosBlackbox, LONG_ARRAY(camposLentosBlackbox),
+                                                                  columnasLentasBlackbox.defColumna, NUM_MAX_COLUMNAS_LENTAS_BLACKBOX);
+    columnasRapidasBlackbox.forzarIntra = true;
+
     ajustarEstadoBlackbox(BLACKBOX_ESTADO_PREPARAR_FICHERO_LOG);
 }
 
 
+/***************************************************************************************
+**  Nombre:         uint8_t prepararColumnasBlackbox(const defCabCampoBlackbox_t *defCampo, uint8_t numCampos,
+**                                                   const defCabCampoBlackbox_t **defColumna, uint8_t numMaxColumnas)
+**  Descripcion:    Expande los campos en columnas, una por driver, en el orden de la cabecera
+**  Parametros:     Definicion de los campos, numero de campos, definicion de cada columna, maximo de columnas
+**  Retorno:        Numero de columnas
+****************************************************************************************/
+uint8_t prepararColumnasBlackbox(const defCabCampoBlackbox_t *defCampo, uint8_t numCampos, const defCabCampoBlackbox_t **defColumna, uint8_t numMaxColumnas)
+{
+    uint8_t numColumnas = 0;
+
+    for (uint8_t i = 0; i < numCampos; i++) {
+        const uint8_t drivers = numDriversBlackbox(&defCampo[i]);
+
+        for (uint8_t j = 0; j < drivers && numColumnas < numMaxColumnas; j++)
+            defColumna[numColumnas++] = &defCampo[i];
+    }
+
+    return numColumnas;
+}
+
+
 /***************************************************************************************
 **  Nombre:         void actualizarIteradoresBlackbox(void)
 **  Descripcion:    Actualiza los iteradores
@@ -474,19 +564,16 @@ void actualizarIteradoresBlackbox(void)
 
 
 /***************************************************************************************
-**  Nombre:         bool enviarDefCampoBlackbox(char identificador, const void *defCampo, const void *segundaDefcampo, uint8_t numCampos, const uint8_t *numDrivers, const uint8_t *segundoNumDrivers)
-**  Descripcion:    Envia la definicion del campo de este estilo: C campo R nombre: a,b,c // C campo R drivers: 2,3,1
-**  Parametros:     Letra identificador, definicion de campo, segunda definicion de campo, numero de campos, numero de drivers, segundo numero de drivers
+**  Nombre:         bool enviarDefCampoBlackbox(char identificador, const defCabCampoBlackbox_t *defCampo, uint8_t numCampos)
+**  Descripcion:    Envia la definicion del campo de este estilo: C Campo R nombre: a,b,c // C Campo R drivers: 2,3,1
+**  Parametros:     Letra identificador, definicion de los campos, numero de campos
 **  Retorno:        True si todavia queda una cabecera por transmitir
 ****************************************************************************************/
-bool enviarDefCampoBlackbox(char identificador, const void *defCampo, const void *segundaDefcampo, uint8_t numCampos, const uint8_t *numDrivers, const uint8_t *segundoNumDrivers)
+bool enviarDefCampoBlackbox(char identificador, const defCabCampoBlackbox_t *defCampo, uint8_t numCampos)
 {
-    char stringEscritura[20];
     const defCabCampoBlackbox_t *def;
     static bool necesitaComa = false;
     uint8_t numCabeceras = LONG_ARRAY(nombresCabCampoBlackbox);
-    size_t pasoDefCampo = (char*) segundaDefcampo - (char*) defCampo;
-    size_t pasoNumDrivers = (char*) numDrivers - (char*) segundoNumDrivers;
     uint8_t drivers;
 
     // Troceamos la cabecera para no exceder el ratio de transmision. Por eso es necesario llamar la funcion varias veces
@@ -501,16 +588,15 @@ bool enviarDefCampoBlackbox(char identificador, const void *defCampo, const void
         if (!comprobarEspacioBlackbox(charsParaEscribir))
             return true;   // Se intentara otra vez
 
-        bytesLibresCabBlackbox = printfBlackbox("C Campo %c %s:", identificador, nombresCabCampoBlackbox[datosTXblackbox.indiceCabecera]);
-        bytesLibresCabBlackbox -= escribirStringBlackbox(stringEscritura);
+        bytesLibresCabBlackbox -= printfBlackbox("C Campo %c %s:", identificador, nombresCabCampoBlackbox[datosTXblackbox.indiceCabecera]);
 
         datosTXblackbox.indiceCampo++;
         necesitaComa = false;
     }
 
     for (; datosTXblackbox.indiceCampo < numCampos; datosTXblackbox.indiceCampo++) {
-        def = (const defCabCampoBlackbox_t*) ((const char*)defCampo + pasoDefCampo * datosTXblackbox.indiceCampo);
-        drivers = numDriversBlackbox(numDrivers[pasoNumDrivers * datosTXblackbox.indiceCampo]);
+        def = &defCampo[datosTXblackbox.indiceCampo];
+        drivers = numDriversBlackbox(def);
 
         if (drivers != 0) {
             int32_t bytesParaEscribir = 1; // Para la coma
@@ -531,15 +617,31 @@ bool enviarDefCampoBlackbox(char identificador, const void *defCampo, const void
             else
                 necesitaComa = true;
 
-            if (datosTXblackbox.indiceCabecera == 0) {
-            	escribirStringBlackbox(def->nombre);
+            switch (datosTXblackbox.indiceCabecera) {
+                case 0:
+                    escribirStringBlackbox(def->nombre);
+
+                    // Comprobamos si se necesita pintar el indice entre corchetes
+                    if (def->indiceNombreCampo != -1)
+                        printfBlackbox("[%d]", def->indiceNombreCampo);
+                    break;
+
+                case 1:
+                    printfBlackbox("%d", drivers);
+                    break;
 
-                // Comprobamos si se necesita pintar el indice entre corchetes
-                if (def->indiceNombreCampo != -1)
-                	printfBlackbox("[%d]", def->indiceNombreCampo);
+                case 2:
+                    printfBlackbox("%d", def->predictor);
+                    break;
+
+                case 3:
+                    printfBlackbox("%d", def->codificacion);
+                    break;
+
+                default:
+                    printfBlackbox("%d", def->decimales);
+                    break;
             }
-            else
-            	printfBlackbox("%d", drivers);
         }
     }
 
@@ -605,32 +707,36 @@ char *obtenerFechaHoraBlackbox(char *buf)
 
 
 /***************************************************************************************
-**  Nombre:         uint8_t numDriversBlackbox(numDriversBlackbox_e numDrivers)
+**  Nombre:         uint8_t numDriversBlackbox(const defCabCampoBlackbox_t *def)
 **  Descripcion:    Comprueba el numero de elementos a escribir en la Blackbox
-**  Parametros:     Enumeracion del numero de elementos dependiendo del driver
+**  Parametros:     Definicion del campo
 **  Retorno:        Numero de elemntos
 ****************************************************************************************/
-uint8_t numDriversBlackbox(numDriversBlackbox_e numDrivers)
+uint8_t numDriversBlackbox(const defCabCampoBlackbox_t *def)
 {
-    switch (numDrivers) {
+    switch (def->numDrivers) {
         case BLACKBOX_1_DRIVER:
             return 1;
             break;
 
         case BLACKBOX_NUM_DRIVERS_IMU:
-            return numIMUsConectadas();
+            return driversBlackbox.numIMUs;
             break;
 
         case BLACKBOX_NUM_DRIVERS_BARO:
-            return numBarosConectados();
+            return driversBlackbox.numBaros;
             break;
 
         case BLACKBOX_NUM_DRIVERS_MAG:
-            return numMagsConectados();
+            return driversBlackbox.numMags;
             break;
 
         case BLACKBOX_NUM_DRIVERS_GPS:
-            return numGPSconectados();
+            return driversBlackbox.numGPS;
+            break;
+
+        case BLACKBOX_MOTOR_MIXER:
+            return def->indiceNombreCampo < driversBlackbox.numMotores ? 1 : 0;
             break;
 
         default:
@@ -640,6 +746,26 @@ uint8_t numDriversBlackbox(numDriversBlackbox_e numDrivers)
 }
 
 
+/***************************************************************************************
+**  Nombre:         int32_t escalarCampoBlackbox(float valor, const defCabCampoBlackbox_t *def)
+**  Descripcion:    Convierte un valor en el entero que se guarda en el log
+**  Parametros:     Valor, definicion del campo
+**  Retorno:        Valor por 10^decimales redondeado
+****************************************************************************************/
+int32_t escalarCampoBlackbox(float valor, const defCabCampoBlackbox_t *def)
+{
+    float escalado = valor * potenciasDiezBlackbox[def->decimales];
+
+    if (escalado >= 2147483520.0f)
+        return INT32_MAX;
+
+    if (escalado <= -2147483520.0f)
+        return INT32_MIN;
+
+    return (int32_t)(escalado + (escalado >= 0 ? 0.5f : -0.5f));
+}
+
+
 /***************************************************************************************
 **  Nombre:         void escribirLogEventoBlackbox(logEvento_e evento, logEventoDatos_u *datos)
 **  Descripcion:    Escribe un evento en la blackbox
@@ -651,32 +777,41 @@ void escribirLogEventoBlackbox(logEvento_e evento, logEventoDatos_u *datos)
     if (!(blackbox.estado == BLACKBOX_ESTADO_CORRIENDO || blackbox.estado == BLACKBOX_ESTADO_PAUSADO))
         return;
 
-    escribirBlackbox('E');
-    escribirBlackbox(evento);
+    uint8_t buf[2 + 2 * NUM_MAX_BYTES_VAR_INT_BLACKBOX];
+    uint8_t numBytes = 0;
+
+    buf[numBytes++] = TRAMA_EVENTO_BLACKBOX;
+    buf[numBytes++] = evento;
 
     switch (evento) {
         case BLACKBOX_LOG_EVENTO_DESARMAR:
-        	printfBlackbox("%f", datos->eventoDesarmar.razon);
+            numBytes += codificarVarUIntBlackbox(&buf[numBytes], datos->eventoDesarmar.razon);
             break;
 
         case BLACKBOX_LOG_EVENTO_MODO:
-        	printfBlackbox("%f", datos->eventoModo.flags);
-        	printfBlackbox("%f", datos->eventoModo.ultimosFlags);
+            numBytes += codificarVarUIntBlackbox(&buf[numBytes], datos->eventoModo.flags);
+            numBytes += codificarVarUIntBlackbox(&buf[numBytes], datos->eventoModo.ultimosFlags);
             break;
 
         case BLACKBOX_LOG_EVENTO_LOG_REANUDAR:
-        	printfBlackbox("%f", datos->eventoReanudarLog.logIteracion);
-        	printfBlackbox("%f", datos->eventoReanudarLog.horaActual);
+            numBytes += codificarVarUIntBlackbox(&buf[numBytes], datos->eventoReanudarLog.logIteracion);
+            numBytes += codificarVarUIntBlackbox(&buf[numBytes], datos->eventoReanudarLog.horaActual);
+
+            // Tras la pausa no hay historia para los predictores
+            columnasRapidasBlackbox.forzarIntra = true;
             break;
 
         case BLACKBOX_LOG_EVENTO_LOG_FIN:
+            escribirBufferBlackbox(buf, numBytes);
         	escribirStringBlackbox("Fin del log");
         	escribirBlackbox(0);
-            break;
+            return;
 
         default:
             break;
     }
+
+    escribirBufferBlackbox(buf, numBytes);
 }
 
 
@@ -731,97 +866,216 @@ bool necesarioEscribirLogLentoBlackbox(void)
 
 
 /***************************************************************************************
-**  Nombre:         void escribirLogRapidoBlackbox(uint32_t tiempoActual)
-**  Descripcion:    Escribe los datos del log rapido
+**  Nombre:         void capturarLogRapidoBlackbox(uint32_t tiempoActual)
+**  Descripcion:    Guarda los valores del log rapido como enteros en el orden de la cabecera
 **  Parametros:     Tiempo actual
 **  Retorno:        Ninguno
 ****************************************************************************************/
-void escribirLogRapidoBlackbox(uint32_t tiempoActual)
+void capturarLogRapidoBlackbox(uint32_t tiempoActual)
 {
-	escribirBlackbox('R');
+    int32_t *valor = columnasRapidasBlackbox.valor;
+    const defCabCampoBlackbox_t **def = columnasRapidasBlackbox.defColumna;
+    uint8_t col = 0;
 
-	printfBlackbox("%f", iteradorBlackbox);
-	printfBlackbox("%f", tiempoActual);
+    valor[col++] = iteradorBlackbox;
+    valor[col++] = tiempoActual;
 
 #ifdef USAR_IMU
-	uint8_t numIMUs = numIMUsConectadas();
+	uint8_t numIMUs = driversBlackbox.numIMUs;
+    float gIMU[NUM_MAX_IMU][3];
+    float aIMU[NUM_MAX_IMU][3];
+
     for (uint8_t i = 0; i < numIMUs; i++) {
-    	float gIMU[3];
-    	giroNumIMU(i, gIMU);
-        for (uint8_t j = 0; j < 3; j++)
-        	printfBlackbox("%.2f", gIMU[i]);
+        giroNumIMU(i, gIMU[i]);
+        acelNumIMU(i, aIMU[i]);
     }
 
-    for (uint8_t i = 0; i < numIMUs; i++) {
-        float aIMU[3];
-        acelNumIMU(i, aIMU);
-        for (uint8_t j = 0; j < 3; j++)
-        	printfBlackbox("%.2f", aIMU[i]);
+    for (uint8_t j = 0; j < 3; j++) {
+        for (uint8_t i = 0; i < numIMUs; i++, col++)
+            valor[col] = escalarCampoBlackbox(gIMU[i][j], def[col]);
+    }
+
+    for (uint8_t j = 0; j < 3; j++) {
+        for (uint8_t i = 0; i < numIMUs; i++, col++)
+            valor[col] = escalarCampoBlackbox(aIMU[i][j], def[col]);
     }
 #endif
 
 #ifdef USAR_MAG
-    uint8_t numMags = numMagsConectados();
-    for (uint8_t i = 0; i < numMags; i++) {
-        float cMag[3];
-        campoNumMag(i, cMag);
-        for (uint8_t j = 0; j < 3; j++)
-        	printfBlackbox("%.2f", cMag[j]);
+    uint8_t numMags = driversBlackbox.numMags;
+    float cMag[NUM_MAX_MAG][3];
+
+    for (uint8_t i = 0; i < numMags; i++)
+        campoNumMag(i, cMag[i]);
+
+    for (uint8_t j = 0; j < 3; j++) {
+        for (uint8_t i = 0; i < numMags; i++, col++)
+            valor[col] = escalarCampoBlackbox(cMag[i][j], def[col]);
     }
 #endif
+
 #ifdef USAR_BARO
-    uint8_t numBaros = numBarosConectados();
-    for (uint8_t i = 0; i < numBaros; i++) {
-    	printfBlackbox("%.2f", presionNumBaro(i));
-    	printfBlackbox("%.2f", temperaturaNumBaro(i));
-    }
+    uint8_t numBaros = driversBlackbox.numBaros;
+    for (uint8_t i = 0; i < numBaros; i++, col++)
+        valor[col] = escalarCampoBlackbox(presionNumBaro(i), def[col]);
+
+    for (uint8_t i = 0; i < numBaros; i++, col++)
+        valor[col] = escalarCampoBlackbox(temperaturaNumBaro(i), def[col]);
 #endif
+
 #ifdef USAR_RADIO
     for (uint8_t i = 0; i < 8; i++)
-    	printfBlackbox("%f", canalRadio(i));
+        valor[col++] = canalRadio(i);
+#endif
+
+#ifdef USAR_MOTORES
+    uint8_t numMotoresLog = driversBlackbox.numMotores;
+    for (uint8_t i = 0; i < numMotoresLog; i++, col++)
+        valor[col] = escalarCampoBlackbox(salidaMotorMixer(i), def[col]);
 #endif
+}
+
+
+/***************************************************************************************
+**  Nombre:         void escribirLogRapidoBlackbox(uint32_t tiempoActual)
+**  Descripcion:    Escribe los datos del log rapido. Cada NUM_TRAMAS_ENTRE_INTRA_BLACKBOX
+**                  tramas se escriben los valores absolutos y en el resto el residuo del
+**                  predictor de cada campo
+**  Parametros:     Tiempo actual
+**  Retorno:        Ninguno
+****************************************************************************************/
+void escribirLogRapidoBlackbox(uint32_t tiempoActual)
+{
+    columnasRapidasBlackbox_t *columnas = &columnasRapidasBlackbox;
+    uint8_t buf[NUM_MAX_BYTES_TRAMA_BLACKBOX];
+    uint32_t numBytes = 1;
+
+    capturarLogRapidoBlackbox(tiempoActual);
+
+    if (columnas->forzarIntra || columnas->tramasDesdeIntra >= NUM_TRAMAS_ENTRE_INTRA_BLACKBOX) {
+        buf[0] = TRAMA_INTRA_BLACKBOX;
+
+        for (uint8_t i = 0; i < columnas->numColumnas; i++)
+            numBytes += codificarVarIntBlackbox(&buf[numBytes], columnas->valor[i]);
+
+        // Tras una trama intra los dos valores anteriores son el actual
+        memcpy(columnas->anterior2, columnas->valor, sizeof(columnas->valor[0]) * columnas->numColumnas);
+        columnas->tramasDesdeIntra = 0;
+        columnas->forzarIntra = false;
+    }
+    else {
+        int32_t residuo[NUM_MAX_COLUMNAS_RAPIDAS_BLACKBOX];
+
+        buf[0] = TRAMA_PREDICHA_BLACKBOX;
+
+        for (uint8_t i = 0; i < columnas->numColumnas; i++) {
+            const int32_t prediccion = predecirBlackbox(columnas->defColumna[i]->predictor, columnas->anterior[i], columnas->anterior2[i]);
+            residuo[i] = (int32_t)((uint32_t)columnas->valor[i] - (uint32_t)prediccion);
+        }
+
+        for (uint8_t i = 0; i < columnas->numColumnas; ) {
+            if (columnas->defColumna[i]->codificacion == CODIFICACION_TAG8_8SVB_BLACKBOX) {
+                // Se agrupan las columnas seguidas con la misma codificacion
+                uint8_t numGrupo = 1;
+                while (i + numGrupo < columnas->numColumnas && numGrupo < NUM_MAX_VALORES_TAG8_8SVB_BLACKBOX &&
+                       columnas->defColumna[i + numGrupo]->codificacion == CODIFICACION_TAG8_8SVB_BLACKBOX)
+                    numGrupo++;
+
+                numBytes += codificarTag8_8SVBblackbox(&buf[numBytes], &residuo[i], numGrupo);
+                i += numGrupo;
+            }
+            else {
+                numBytes += codificarVarIntBlackbox(&buf[numBytes], residuo[i]);
+                i++;
+            }
+        }
+
+        memcpy(columnas->anterior2, columnas->anterior, sizeof(columnas->anterior[0]) * columnas->numColumnas);
+        columnas->tramasDesdeIntra++;
+    }
+
+    memcpy(columnas->anterior, columnas->valor, sizeof(columnas->valor[0]) * columnas->numColumnas);
+    escribirBufferBlackbox(buf, numBytes);
 
     blackbox.logEmpezado = true;
 }
 
 
 /***************************************************************************************
-**  Nombre:         void escribirLogLentoBlackbox(void)
-**  Descripcion:    Escribe los datos del log lento
+**  Nombre:         void capturarLogLentoBlackbox(void)
+**  Descripcion:    Guarda los valores del log lento como enteros en el orden de la cabecera
 **  Parametros:     Ninguno
 **  Retorno:        Ninguno
 ****************************************************************************************/
-void escribirLogLentoBlackbox(void)
+void capturarLogLentoBlackbox(void)
 {
-	escribirBlackbox('L');
+#if defined(USAR_IMU) || defined(USAR_GPS)
+    int32_t *valor = columnasLentasBlackbox.valor;
+    const defCabCampoBlackbox_t **def = columnasLentasBlackbox.defColumna;
+    uint8_t col = 0;
+
+#ifdef USAR_IMU
+    uint8_t numIMUs = driversBlackbox.numIMUs;
+    uint8_t fallos[NUM_MAX_IMU];
+
+    for (uint8_t i = 0; i < numIMUs; i++)
+        valor[col++] = saludNumIMU(i, &fallos[i]);
+
+    for (uint8_t i = 0; i < numIMUs; i++)
+        valor[col++] = fallos[i];
+
+    for (uint8_t i = 0; i < numIMUs; i++, col++)
+        valor[col] = escalarCampoBlackbox(pesoNumIMU(i), def[col]);
+#endif
 
 #ifdef USAR_GPS
-	uint8_t numGPS = numGPSconectados();
-    for (uint8_t i = 0; i < numGPS; i++)
-    	printfBlackbox("%f", satelitesNumGPS(i));
+	uint8_t numGPS = driversBlackbox.numGPS;
+    localizacion_t loc[NUM_MAX_GPS];
 
-    localizacion_t loc;
-    for (uint8_t i = 0; i < numGPS; i++) {
-    	localizacionNumGPS(i, &loc);
-    	printfBlackbox("%f", loc.latitud);
-    }
+    for (uint8_t i = 0; i < numGPS; i++)
+        localizacionNumGPS(i, &loc[i]);
 
-    for (uint8_t i = 0; i < numGPS; i++) {
-    	localizacionNumGPS(i, &loc);
-    	printfBlackbox("%f", loc.longitud);
-    }
+    for (uint8_t i = 0; i < numGPS; i++)
+        valor[col++] = satelitesNumGPS(i);
 
-    for (uint8_t i = 0; i < numGPS; i++) {
-    	localizacionNumGPS(i, &loc);
-    	printfBlackbox("%f", loc.altitud);
-    }
+    // La localizacion ya esta en enteros con los decimales de la cabecera
+    for (uint8_t i = 0; i < numGPS; i++)
+        valor[col++] = loc[i].latitud;
 
     for (uint8_t i = 0; i < numGPS; i++)
-    	printfBlackbox("%.2f", vel2dNumGPS(i));
+        valor[col++] = loc[i].longitud;
 
     for (uint8_t i = 0; i < numGPS; i++)
-    	printfBlackbox("%.2f", velAngularNumGPS(i));
+        valor[col++] = loc[i].altitud;
+
+    for (uint8_t i = 0; i < numGPS; i++, col++)
+        valor[col] = escalarCampoBlackbox(vel2dNumGPS(i), def[col]);
+
+    for (uint8_t i = 0; i < numGPS; i++, col++)
+        valor[col] = escalarCampoBlackbox(velAngularNumGPS(i), def[col]);
 #endif
+#endif
+}
+
+
+/***************************************************************************************
+**  Nombre:         void escribirLogLentoBlackbox(void)
+**  Descripcion:    Escribe los datos del log lento
+**  Parametros:     Ninguno
+**  Retorno:        Ninguno
+****************************************************************************************/
+void escribirLogLentoBlackbox(void)
+{
+    uint8_t buf[1 + NUM_MAX_COLUMNAS_LENTAS_BLACKBOX * NUM_MAX_BYTES_VAR_INT_BLACKBOX];
+    uint32_t numBytes = 0;
+
+    capturarLogLentoBlackbox();
+
+    buf[numBytes++] = TRAMA_LENTA_BLACKBOX;
+    for (uint8_t i = 0; i < columnasLentasBlackbox.numColumnas; i++)
+        numBytes += codificarVarIntBlackbox(&buf[numBytes], columnasLentasBlackbox.valor[i]);
+
+    escribirBufferBlackbox(buf, numBytes);
 
     blackbox.logEmpezado = true;
 }
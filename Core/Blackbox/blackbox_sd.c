@@ -7,7 +7,7 @@
 **
 **  Autor: Ramon Rico
 **  Fecha de creacion: 16/05/2020
-**  Fecha de modificacion: 03/08/2020
+**  Fecha de modificacion: 17/10/2026
 **
 **  El proyecto URpilot NO es libre. No se puede distribuir y/o modificar este fichero
 **  bajo ningun concepto.
@@ -218,6 +218,18 @@ uint32_t escribirStringBlackbox(const char *s)
 }
 
 
+/***************************************************************************************
+**  Nombre:         void escribirBufferBlackbox(const uint8_t *buf, uint32_t longitud)
+**  Descripcion:    Escribe un bloque de bytes en la blackbox
+**  Parametros:     Buffer, numero de bytes
+**  Retorno:        Ninguno
+****************************************************************************************/
+void escribirBufferBlackbox(const uint8_t *buf, uint32_t longitud)
+{
+    afatfs_fwrite(blackboxSD.ficheroLog, buf, longitud);
+}
+
+
 /***************************************************************************************
 **  Nombre:         void printfBlackbox(const char *fmt, ...)
 **  Descripcion:    Escribe un string con datos variables en la blackbox
@@ -231,7 +243,7 @@ uint32_t printfBlackbox(const char *fmt, ...)
 
     va_start(va, fmt);
 
-    sprintf(stringEscritura, fmt, va);
+    vsnprintf(stringEscritura, sizeof(stringEscritura), fmt, va);
     uint32_t bytesEscritos = escribirStringBlackbox(stringEscritura);
 
     va_end(va);
@@ -249,15 +261,17 @@ uint32_t printfBlackbox(const char *fmt, ...)
 void escribirLineaCabeceraBlackbox(const char *nombre, const char *fmt, ...)
 {
     va_list va;
+    char stringEscritura[64];
 
     escribirBlackbox('C');
     escribirBlackbox(' ');
-    escribirStringBlackbox(nombre);
+    uint32_t bytesEscritos = escribirStringBlackbox(nombre);
     escribirBlackbox(':');
 
     va_start(va, fmt);
 
-    uint32_t bytesEscritos = printfBlackbox(fmt, va);
+    vsnprintf(stringEscritura, sizeof(stringEscritura), fmt, va);
+    bytesEscritos += escribirStringBlackbox(stringEscritura);
 
     va_end(va);
 
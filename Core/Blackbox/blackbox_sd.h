@@ -65,6 +65,7 @@ bool iniciarLogBlackbox(void);
 bool finalizarLogBlackbox(bool logEmpezado);
 void escribirBlackbox(uint8_t valor);
 uint32_t escribirStringBlackbox(const char *s);
+void escribirBufferBlackbox(const uint8_t *buf, uint32_t longitud);
 uint32_t printfBlackbox(const char *fmt, ...);
 void escribirLineaCabeceraBlackbox(const char *nombre, const char *fmt, ...);
 void calcularBytesLibresCabBlackbox(void);
@@ -0,0 +1,113 @@
+/***************************************************************************************
+**  codificacion_blackbox.c - Codificacion binaria de las tramas de la blackbox
+**
+**
+**  Este fichero forma parte del proyecto URpilot.
+**  Codigo desarrollado por el grupo de investigacion ICON de la Universidad de La Rioja
+**
+**  Autor: Ramon Rico
+**  Fecha de creacion: 17/10/2026
+**  Fecha de modificacion: 17/10/2026
+**
+**  El proyecto URpilot NO es libre. No se puede distribuir y/o modificar este fichero
+**  bajo ningun concepto.
+**
+**  En caso de modificacion y/o solicitud de informacion pongase en contacto con
+**  el grupo de investigacion ICON a traves de: www.unirioja.es/urpilot
+**
+**
+**  Control de versiones del fichero
+**
+**  v1.0  Ramon Rico. Se ha liberado la primera version estable
+**
+****************************************************************************************/
+
+/***************************************************************************************
+** AREA DE INCLUDES                                                                   **
+****************************************************************************************/
+#include "codificacion_blackbox.h"
+
+
+/***************************************************************************************
+** AREA DE PREPROCESADOR                                                              **
+****************************************************************************************/
+
+
+/***************************************************************************************
+** AREA DE DEFINICION DE TIPOS                                                        **
+****************************************************************************************/
+
+
+/***************************************************************************************
+** AREA DE DECLARACION DE VARIABLES                                                   **
+****************************************************************************************/
+
+
+/***************************************************************************************
+** AREA DE PROTOTIPOS DE FUNCION                                                      **
+****************************************************************************************/
+
+
+/***************************************************************************************
+** AREA DE DEFINICION DE FUNCIONES                                                    **
+****************************************************************************************/
+
+/***************************************************************************************
+**  Nombre:         uint8_t codificarVarUIntBlackbox(uint8_t *buf, uint32_t valor)
+**  Descripcion:    Codifica un entero sin signo en grupos de 7 bits. El bit alto de cada
+**                  byte indica que sigue otro
+**  Parametros:     Buffer de salida (minimo 5 bytes), valor
+**  Retorno:        Bytes escritos
+****************************************************************************************/
+uint8_t codificarVarUIntBlackbox(uint8_t *buf, uint32_t valor)
+{
+    uint8_t numBytes = 0;
+
+    while (valor > 0x7F) {
+        buf[numBytes++] = (uint8_t)(valor | 0x80);
+        valor >>= 7;
+    }
+
+    buf[numBytes++] = (uint8_t)valor;
+    return numBytes;
+}
+
+
+/***************************************************************************************
+**  Nombre:         uint8_t codificarVarIntBlackbox(uint8_t *buf, int32_t valor)
+**  Descripcion:    Codifica un entero con signo. Los valores pequenios ocupan un byte
+**  Parametros:     Buffer de salida (minimo 5 bytes), valor
+**  Retorno:        Bytes escritos
+****************************************************************************************/
+uint8_t codificarVarIntBlackbox(uint8_t *buf, int32_t valor)
+{
+    return codificarVarUIntBlackbox(buf, zigzagBlackbox(valor));
+}
+
+
+/***************************************************************************************
+**  Nombre:         uint8_t codificarTag8_8SVBblackbox(uint8_t *buf, const int32_t *valores, uint8_t numValores)
+**  Descripcion:    Codifica hasta 8 valores con un byte de cabecera que marca los no nulos.
+**                  Solo se escriben los no nulos. Los residuos de campos que cambian poco
+**                  ocupan un byte para todo el grupo
+**  Parametros:     Buffer de salida, valores, numero de valores (maximo 8)
+**  Retorno:        Bytes escritos
+****************************************************************************************/
+uint8_t codificarTag8_8SVBblackbox(uint8_t *buf, const int32_t *valores, uint8_t numValores)
+{
+    uint8_t cabecera = 0;
+    uint8_t numBytes = 1;
+
+    if (numValores > NUM_MAX_VALORES_TAG8_8SVB_BLACKBOX)
+        numValores = NUM_MAX_VALORES_TAG8_8SVB_BLACKBOX;
+
+    for (uint8_t i = 0; i < numValores; i++) {
+        if (valores[i] != 0) {
+            cabecera |= 1 << i;
+            numBytes += codificarVarIntBlackbox(&buf[numBytes], valores[i]);
+        }
+    }
+
+    buf[0] = cabecera;
+    return numBytes;
+}
@@ -0,0 +1,127 @@
+/***************************************************************************************
+**  codificacion_blackbox.h - Codificacion binaria de las tramas de la blackbox
+**
+**
+**  Este fichero forma parte del proyecto URpilot.
+**  Codigo desarrollado por el grupo de investigacion ICON de la Universidad de La Rioja
+**
+**  Autor: Ramon Rico
+**  Fecha de creacion: 17/10/2026
+**  Fecha de modificacion: 17/10/2026
+**
+**  El proyecto URpilot NO es libre. No se puede distribuir y/o modificar este fichero
+**  bajo ningun concepto.
+**
+**  En caso de modificacion y/o solicitud de informacion pongase en contacto con
+**  el grupo de investigacion ICON a traves de: www.unirioja.es/urpilot
+**
+**
+**  Control de versiones del fichero
+**
+**  v1.0  Ramon Rico. Se ha liberado la primera version estable
+**
+****************************************************************************************/
+
+#ifndef __CODIFICACION_BLACKBOX_H
+#define __CODIFICACION_BLACKBOX_H
+
+/***************************************************************************************
+** AREA DE INCLUDES                                                                   **
+****************************************************************************************/
+#include <stdint.h>
+#include <stdbool.h>
+
+
+/***************************************************************************************
+** AREA DE PREPROCESADOR                                                              **
+****************************************************************************************/
+#define VERSION_BLACKBOX                      2
+
+// Identificadores de trama. La cabecera es texto y cada linea empieza por 'C'
+#define TRAMA_INTRA_BLACKBOX                  'I'       // Trama rapida con los valores absolutos
+#define TRAMA_PREDICHA_BLACKBOX               'P'       // Trama rapida con los residuos de los predictores
+#define TRAMA_LENTA_BLACKBOX                  'L'       // Trama lenta con los valores absolutos
+#define TRAMA_EVENTO_BLACKBOX                 'E'
+
+#define NUM_MAX_VALORES_TAG8_8SVB_BLACKBOX    8
+#define NUM_MAX_BYTES_VAR_INT_BLACKBOX        5
+
+
+/***************************************************************************************
+** AREA DE DEFINICION DE TIPOS                                                        **
+****************************************************************************************/
+typedef enum {
+    PREDICTOR_CERO_BLACKBOX = 0,             // Sin prediccion
+    PREDICTOR_ANTERIOR_BLACKBOX,             // Valor anterior
+    PREDICTOR_LINEA_RECTA_BLACKBOX,          // Extrapolacion de los dos anteriores
+    PREDICTOR_MEDIA_2_BLACKBOX,              // Media de los dos anteriores
+} predictorBlackbox_e;
+
+typedef enum {
+    CODIFICACION_VAR_INT_BLACKBOX = 0,       // Varint con zig-zag
+    CODIFICACION_TAG8_8SVB_BLACKBOX,         // Byte con los valores no nulos de hasta 8 campos seguidos y sus varint con zig-zag
+} codificacionBlackbox_e;
+
+
+/***************************************************************************************
+** AREA DE DECLARACION DE VARIABLES                                                   **
+****************************************************************************************/
+
+
+/***************************************************************************************
+** AREA DE PROTOTIPOS DE FUNCION                                                      **
+****************************************************************************************/
+uint8_t codificarVarUIntBlackbox(uint8_t *buf, uint32_t valor);
+uint8_t codificarVarIntBlackbox(uint8_t *buf, int32_t valor);
+uint8_t codificarTag8_8SVBblackbox(uint8_t *buf, const int32_t *valores, uint8_t numValores);
+
+
+/***************************************************************************************
+**  Nombre:         uint32_t zigzagBlackbox(int32_t valor)
+**  Descripcion:    Convierte un entero con signo en uno sin signo de magnitud similar
+**  Parametros:     Valor con signo
+**  Retorno:        Valor sin signo
+****************************************************************************************/
+static inline uint32_t zigzagBlackbox(int32_t valor)
+{
+    return ((uint32_t)valor << 1) ^ (uint32_t)(valor >> 31);
+}
+
+
+/***************************************************************************************
+**  Nombre:         int32_t deshacerZigzagBlackbox(uint32_t valor)
+**  Descripcion:    Operacion inversa de zigzagBlackbox
+**  Parametros:     Valor sin signo
+**  Retorno:        Valor con signo
+****************************************************************************************/
+static inline int32_t deshacerZigzagBlackbox(uint32_t valor)
+{
+    return (int32_t)(valor >> 1) ^ -(int32_t)(valor & 1);
+}
+
+
+/***************************************************************************************
+**  Nombre:         int32_t predecirBlackbox(predictorBlackbox_e predictor, int32_t anterior, int32_t anterior2)
+**  Descripcion:    Calcula la prediccion de un campo. Las operaciones desbordan igual en el
+**                  codificador y en el decodificador
+**  Parametros:     Predictor, valor anterior, valor de hace dos tramas
+**  Retorno:        Prediccion
+****************************************************************************************/
+static inline int32_t predecirBlackbox(predictorBlackbox_e predictor, int32_t anterior, int32_t anterior2)
+{
+    switch (predictor) {
+        case PREDICTOR_ANTERIOR_BLACKBOX:
+            return anterior;
+
+        case PREDICTOR_LINEA_RECTA_BLACKBOX:
+            return (int32_t)(2 * (uint32_t)anterior - (uint32_t)anterior2);
+
+        case PREDICTOR_MEDIA_2_BLACKBOX:
+            return (int32_t)(((int64_t)anterior + anterior2) / 2);
+
+        default:
+            return 0;
+    }
+}
+
+#endif // __CODIFICACION_BLACKBOX_H
@@ -34,7 +34,7 @@
 #include "Sistema/plataforma.h"
 #include "sd_estandar.h"
 #include "GP/gp.h"
-#include "drivers/bus.h"
+#include "Drivers/bus.h"
 
 
 /***************************************************************************************
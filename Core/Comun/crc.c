@@ -7,7 +7,7 @@
 **
 **  Autor: Ramon Rico
 **  Fecha de creacion: 03/05/2019
-**  Fecha de modificacion: 03/08/2020
+**  Fecha de modificacion: 17/10/2026
 **
 **  El proyecto URpilot NO es libre. No se puede distribuir y/o modificar este fichero
 **  bajo ningun concepto.
@@ -26,6 +26,7 @@
 ** AREA DE INCLUDES                                                                   **
 ****************************************************************************************/
 #include "crc.h"
+#include "Sistema/plataforma.h"
 
 
 /***************************************************************************************
@@ -41,12 +42,124 @@
 /***************************************************************************************
 ** AREA DE DECLARACION DE VARIABLES                                                   **
 ****************************************************************************************/
+// Tablas de un byte. La del CRC32 es la del polinomio reflejado 0xEDB88320
+static const uint8_t tablaCRC8[256] = {
+    0x00, 0xD5, 0x7F, 0xAA, 0xFE, 0x2B, 0x81, 0x54, 0x29, 0xFC, 0x56, 0x83, 0xD7, 0x02, 0xA8, 0x7D,
+    0x52, 0x87, 0x2D, 0xF8, 0xAC, 0x79, 0xD3, 0x06, 0x7B, 0xAE, 0x04, 0xD1, 0x85, 0x50, 0xFA, 0x2F,
+    0xA4, 0x71, 0xDB, 0x0E, 0x5A, 0x8F, 0x25, 0xF0, 0x8D, 0x58, 0xF2, 0x27, 0x73, 0xA6, 0x0C, 0xD9,
+    0xF6, 0x23, 0x89, 0x5C, 0x08, 0xDD, 0x77, 0xA2, 0xDF, 0x0A, 0xA0, 0x75, 0x21, 0xF4, 0x5E, 0x8B,
+    0x9D, 0x48, 0xE2, 0x37, 0x63, 0xB6, 0x1C, 0xC9, 0xB4, 0x61, 0xCB, 0x1E, 0x4A, 0x9F, 0x35, 0xE0,
+    0xCF, 0x1A, 0xB0, 0x65, 0x31, 0xE4, 0x4E, 0x9B, 0xE6, 0x33, 0x99, 0x4C, 0x18, 0xCD, 0x67, 0xB2,
+    0x39, 0xEC, 0x46, 0x93, 0xC7, 0x12, 0xB8, 0x6D, 0x10, 0xC5, 0x6F, 0xBA, 0xEE, 0x3B, 0x91, 0x44,
+    0x6B, 0xBE, 0x14, 0xC1, 0x95, 0x40, 0xEA, 0x3F, 0x42, 0x97, 0x3D, 0xE8, 0xBC, 0x69, 0xC3, 0x16,
+    0xEF, 0x3A, 0x90, 0x45, 0x11, 0xC4, 0x6E, 0xBB, 0xC6, 0x13, 0xB9, 0x6C, 0x38, 0xED, 0x47, 0x92,
+    0xBD, 0x68, 0xC2, 0x17, 0x43, 0x96, 0x3C, 0xE9, 0x94, 0x41, 0xEB, 0x3E, 0x6A, 0xBF, 0x15, 0xC0,
+    0x4B, 0x9E, 0x34, 0xE1, 0xB5, 0x60, 0xCA, 0x1F, 0x62, 0xB7, 0x1D, 0xC8, 0x9C, 0x49, 0xE3, 0x36,
+    0x19, 0xCC, 0x66, 0xB3, 0xE7, 0x32, 0x98, 0x4D, 0x30, 0xE5, 0x4F, 0x9A, 0xCE, 0x1B, 0xB1, 0x64,
+    0x72, 0xA7, 0x0D, 0xD8, 0x8C, 0x59, 0xF3, 0x26, 0x5B, 0x8E, 0x24, 0xF1, 0xA5, 0x70, 0xDA, 0x0F,
+    0x20, 0xF5, 0x5F, 0x8A, 0xDE, 0x0B, 0xA1, 0x74, 0x09, 0xDC, 0x76, 0xA3, 0xF7, 0x22, 0x88, 0x5D,
+    0xD6, 0x03, 0xA9, 0x7C, 0x28, 0xFD, 0x57, 0x82, 0xFF, 0x2A, 0x80, 0x55, 0x01, 0xD4, 0x7E, 0xAB,
+    0x84, 0x51, 0xFB, 0x2E, 0x7A, 0xAF, 0x05, 0xD0, 0xAD, 0x78, 0xD2, 0x07, 0x53, 0x86, 0x2C, 0xF9,
+};
+
+static const uint16_t tablaCRC16[256] = {
+    0x0000, 0x1021, 0x2042, 0x3063, 0x4084, 0x50A5, 0x60C6, 0x70E7,
+    0x8108, 0x9129, 0xA14A, 0xB16B, 0xC18C, 0xD1AD, 0xE1CE, 0xF1EF,
+    0x1231, 0x0210, 0x3273, 0x2252, 0x52B5, 0x4294, 0x72F7, 0x62D6,
+    0x9339, 0x8318, 0xB37B, 0xA35A, 0xD3BD, 0xC39C, 0xF3FF, 0xE3DE,
+    0x2462, 0x3443, 0x0420, 0x1401, 0x64E6, 0x74C7, 0x44A4, 0x5485,
+    0xA56A, 0xB54B, 0x8528, 0x9509, 0xE5EE, 0xF5CF, 0xC5AC, 0xD58D,
+    0x3653, 0x2672, 0x1611, 0x0630, 0x76D7, 0x66F6, 0x5695, 0x46B4,
+    0xB75B, 0xA77A, 0x9719, 0x8738, 0xF7DF, 0xE7FE, 0xD79D, 0xC7BC,
+    0x48C4, 0x58E5, 0x6886, 0x78A7, 0x0840, 0x1861, 0x2802, 0x3823,
+    0xC9CC, 0xD9ED, 0xE98E, 0xF9AF, 0x8948, 0x9969, 0xA90A, 0xB92B,
+    0x5AF5, 0x4AD4, 0x7AB7, 0x6A96, 0x1A71, 0x0A50, 0x3A33, 0x2A12,
+    0xDBFD, 0xCBDC, 0xFBBF, 0xEB9E, 0x9B79, 0x8B58, 0xBB3B, 0xAB1A,
+    0x6CA6, 0x7C87, 0x4CE4, 0x5CC5, 0x2C22, 0x3C03, 0x0C60, 0x1C41,
+    0xEDAE, 0xFD8F, 0xCDEC, 0xDDCD, 0xAD2A, 0xBD0B, 0x8D68, 0x9D49,
+    0x7E97, 0x6EB6, 0x5ED5, 0x4EF4, 0x3E13, 0x2E32, 0x1E51, 0x0E70,
+    0xFF9F, 0xEFBE, 0xDFDD, 0xCFFC, 0xBF1B, 0xAF3A, 0x9F59, 0x8F78,
+    0x9188, 0x81A9, 0xB1CA, 0xA1EB, 0xD10C, 0xC12D, 0xF14E, 0xE16F,
+    0x1080, 0x00A1, 0x30C2, 0x20E3, 0x5004, 0x4025, 0x7046, 0x6067,
+    0x83B9, 0x9398, 0xA3FB, 0xB3DA, 0xC33D, 0xD31C, 0xE37F, 0xF35E,
+    0x02B1, 0x1290, 0x22F3, 0x32D2, 0x4235, 0x5214, 0x6277, 0x7256,
+    0xB5EA, 0xA5CB, 0x95A8, 0x8589, 0xF56E, 0xE54F, 0xD52C, 0xC50D,
+    0x34E2, 0x24C3, 0x14A0, 0x0481, 0x7466, 0x6447, 0x5424, 0x4405,
+    0xA7DB, 0xB7FA, 0x8799, 0x97B8, 0xE75F, 0xF77E, 0xC71D, 0xD73C,
+    0x26D3, 0x36F2, 0x0691, 0x16B0, 0x6657, 0x7676, 0x4615, 0x5634,
+    0xD94C, 0xC96D, 0xF90E, 0xE92F, 0x99C8, 0x89E9, 0xB98A, 0xA9AB,
+    0x5844, 0x4865, 0x7806, 0x6827, 0x18C0, 0x08E1, 0x3882, 0x28A3,
+    0xCB7D, 0xDB5C, 0xEB3F, 0xFB1E, 0x8BF9, 0x9BD8, 0xABBB, 0xBB9A,
+    0x4A75, 0x5A54, 0x6A37, 0x7A16, 0x0AF1, 0x1AD0, 0x2AB3, 0x3A92,
+    0xFD2E, 0xED0F, 0xDD6C, 0xCD4D, 0xBDAA, 0xAD8B, 0x9DE8, 0x8DC9,
+    0x7C26, 0x6C07, 0x5C64, 0x4C45, 0x3CA2, 0x2C83, 0x1CE0, 0x0CC1,
+    0xEF1F, 0xFF3E, 0xCF5D, 0xDF7C, 0xAF9B, 0xBFBA, 0x8FD9, 0x9FF8,
+    0x6E17, 0x7E36, 0x4E55, 0x5E74, 0x2E93, 0x3EB2, 0x0ED1, 0x1EF0,
+};
+
+static const uint32_t tablaCRC32[256] = {
+    0x00000000, 0x77073096, 0xEE0E612C, 0x990951BA, 0x076DC419, 0x706AF48F,
+    0xE963A535, 0x9E6495A3, 0x0EDB8832, 0x79DCB8A4, 0xE0D5E91E, 0x97D2D988,
+    0x09B64C2B, 0x7EB17CBD, 0xE7B82D07, 0x90BF1D91, 0x1DB71064, 0x6AB020F2,
+    0xF3B97148, 0x84BE41DE, 0x1ADAD47D, 0x6DDDE4EB, 0xF4D4B551, 0x83D385C7,
+    0x136C9856, 0x646BA8C0, 0xFD62F97A, 0x8A65C9EC, 0x14015C4F, 0x63066CD9,
+    0xFA0F3D63, 0x8D080DF5, 0x3B6E20C8, 0x4C69105E, 0xD56041E4, 0xA2677172,
+    0x3C03E4D1, 0x4B04D447, 0xD20D85FD, 0xA50AB56B, 0x35B5A8FA, 0x42B2986C,
+    0xDBBBC9D6, 0xACBCF940, 0x32D86CE3, 0x45DF5C75, 0xDCD60DCF, 0xABD13D59,
+    0x26D930AC, 0x51DE003A, 0xC8D75180, 0xBFD06116, 0x21B4F4B5, 0x56B3C423,
+    0xCFBA9599, 0xB8BDA50F, 0x2802B89E, 0x5F058808, 0xC60CD9B2, 0xB10BE924,
+    0x2F6F7C87, 0x58684C11, 0xC1611DAB, 0xB6662D3D, 0x76DC4190, 0x01DB7106,
+    0x98D220BC, 0xEFD5102A, 0x71B18589, 0x06B6B51F, 0x9FBFE4A5, 0xE8B8D433,
+    0x7807C9A2, 0x0F00F934, 0x9609A88E, 0xE10E9818, 0x7F6A0DBB, 0x086D3D2D,
+    0x91646C97, 0xE6635C01, 0x6B6B51F4, 0x1C6C6162, 0x856530D8, 0xF262004E,
+    0x6C0695ED, 0x1B01A57B, 0x8208F4C1, 0xF50FC457, 0x65B0D9C6, 0x12B7E950,
+    0x8BBEB8EA, 0xFCB9887C, 0x62DD1DDF, 0x15DA2D49, 0x8CD37CF3, 0xFBD44C65,
+    0x4DB26158, 0x3AB551CE, 0xA3BC0074, 0xD4BB30E2, 0x4ADFA541, 0x3DD895D7,
+    0xA4D1C46D, 0xD3D6F4FB, 0x4369E96A, 0x346ED9FC, 0xAD678846, 0xDA60B8D0,
+    0x44042D73, 0x33031DE5, 0xAA0A4C5F, 0xDD0D7CC9, 0x5005713C, 0x270241AA,
+    0xBE0B1010, 0xC90C2086, 0x5768B525, 0x206F85B3, 0xB966D409, 0xCE61E49F,
+    0x5EDEF90E, 0x29D9C998, 0xB0D09822, 0xC7D7A8B4, 0x59B33D17, 0x2EB40D81,
+    0xB7BD5C3B, 0xC0BA6CAD, 0xEDB88320, 0x9ABFB3B6, 0x03B6E20C, 0x74B1D29A,
+    0xEAD54739, 0x9DD277AF, 0x04DB2615, 0x73DC1683, 0xE3630B12, 0x94643B84,
+    0x0D6D6A3E, 0x7A6A5AA8, 0xE40ECF0B, 0x9309FF9D, 0x0A00AE27, 0x7D079EB1,
+    0xF00F9344, 0x8708A3D2, 0x1E01F268, 0x6906C2FE, 0xF762575D, 0x806567CB,
+    0x196C3671, 0x6E6B06E7, 0xFED41B76, 0x89D32BE0, 0x10DA7A5A, 0x67DD4ACC,
+    0xF9B9DF6F, 0x8EBEEFF9, 0x17B7BE43, 0x60B08ED5, 0xD6D6A3E8, 0xA1D1937E,
+    0x38D8C2C4, 0x4FDFF252, 0xD1BB67F1, 0xA6BC5767, 0x3FB506DD, 0x48B2364B,
+    0xD80D2BDA, 0xAF0A1B4C, 0x36034AF6, 0x41047A60, 0xDF60EFC3, 0xA867DF55,
+    0x316E8EEF, 0x4669BE79, 0xCB61B38C, 0xBC66831A, 0x256FD2A0, 0x5268E236,
+    0xCC0C7795, 0xBB0B4703, 0x220216B9, 0x5505262F, 0xC5BA3BBE, 0xB2BD0B28,
+    0x2BB45A92, 0x5CB36A04, 0xC2D7FFA7, 0xB5D0CF31, 0x2CD99E8B, 0x5BDEAE1D,
+    0x9B64C2B0, 0xEC63F226, 0x756AA39C, 0x026D930A, 0x9C0906A9, 0xEB0E363F,
+    0x72076785, 0x05005713, 0x95BF4A82, 0xE2B87A14, 0x7BB12BAE, 0x0CB61B38,
+    0x92D28E9B, 0xE5D5BE0D, 0x7CDCEFB7, 0x0BDBDF21, 0x86D3D2D4, 0xF1D4E242,
+    0x68DDB3F8, 0x1FDA836E, 0x81BE16CD, 0xF6B9265B, 0x6FB077E1, 0x18B74777,
+    0x88085AE6, 0xFF0F6A70, 0x66063BCA, 0x11010B5C, 0x8F659EFF, 0xF862AE69,
+    0x616BFFD3, 0x166CCF45, 0xA00AE278, 0xD70DD2EE, 0x4E048354, 0x3903B3C2,
+    0xA7672661, 0xD06016F7, 0x4969474D, 0x3E6E77DB, 0xAED16A4A, 0xD9D65ADC,
+    0x40DF0B66, 0x37D83BF0, 0xA9BCAE53, 0xDEBB9EC5, 0x47B2CF7F, 0x30B5FFE9,
+    0xBDBDF21C, 0xCABAC28A, 0x53B39330, 0x24B4A3A6, 0xBAD03605, 0xCDD70693,
+    0x54DE5729, 0x23D967BF, 0xB3667A2E, 0xC4614AB8, 0x5D681B02, 0x2A6F2B94,
+    0xB40BBE37, 0xC30C8EA1, 0x5A05DF1B, 0x2D02EF8D,
+};
+
+#ifdef USAR_CRC_HW
+static const configCRChardware_t configCRC8hw = {POLINOMIO_CRC8, 8, false};
+static const configCRChardware_t configCRC16hw = {POLINOMIO_CRC16, 16, false};
+static const configCRChardware_t configCRC32hw = {POLINOMIO_CRC32, 32, true};
+static bool crcHardwareIniciado;
+static volatile bool crcHardwareOcupado;
+#endif
 
 
 /***************************************************************************************
 ** AREA DE PROTOTIPOS DE FUNCION                                                      **
 ****************************************************************************************/
-uint16_t actualizarCRC16(uint16_t crc, uint8_t dato);
+#ifdef USAR_CRC_HW
+bool reservarCRChardware(void);
+void liberarCRChardware(void);
+uint32_t reflejarCRC32(uint32_t valor);
+#endif
 
 
 /***************************************************************************************
@@ -84,20 +197,105 @@ uint16_t calcularCRC4(uint16_t *dato)
 
 
 /***************************************************************************************
-**  Nombre:         uint16_t actualizarCRC16(uint16_t crc, uint8_t dato)
-**  Descripcion:    Calcula el crc dado un dato
-**  Parametros:     CRC, dato
+**  Nombre:         void iniciarCRC(void)
+**  Descripcion:    Inicia la unidad CRC si se usa. Hasta entonces todo se calcula con las
+**                  tablas
+**  Parametros:     Ninguno
+**  Retorno:        Ninguno
+****************************************************************************************/
+void iniciarCRC(void)
+{
+#ifdef USAR_CRC_HW
+    iniciarCRChardware();
+    crcHardwareIniciado = true;
+#endif
+}
+
+
+#ifdef USAR_CRC_HW
+/***************************************************************************************
+**  Nombre:         bool reservarCRChardware(void)
+**  Descripcion:    Reserva la unidad CRC. Si una interrupcion la encuentra ocupada calcula con
+**                  la tabla. Como la interrupcion termina antes de devolver el control, no
+**                  hace falta que la comprobacion y la reserva sean atomicas
+**  Parametros:     Ninguno
+**  Retorno:        True si se ha reservado
+****************************************************************************************/
+bool reservarCRChardware(void)
+{
+    if (!crcHardwareIniciado || crcHardwareOcupado)
+        return false;
+
+    crcHardwareOcupado = true;
+    return true;
+}
+
+
+/***************************************************************************************
+**  Nombre:         void liberarCRChardware(void)
+**  Descripcion:    Libera la unidad CRC
+**  Parametros:     Ninguno
+**  Retorno:        Ninguno
+****************************************************************************************/
+void liberarCRChardware(void)
+{
+    crcHardwareOcupado = false;
+}
+
+
+/***************************************************************************************
+**  Nombre:         uint32_t reflejarCRC32(uint32_t valor)
+**  Descripcion:    Invierte el orden de los 32 bits. Pasa el CRC32 reflejado al registro de la
+**                  unidad CRC, que siempre desplaza hacia la izquierda
+**  Parametros:     Valor
+**  Retorno:        Valor con los bits invertidos
+****************************************************************************************/
+uint32_t reflejarCRC32(uint32_t valor)
+{
+    valor = ((valor >> 1) & 0x55555555) | ((valor & 0x55555555) << 1);
+    valor = ((valor >> 2) & 0x33333333) | ((valor & 0x33333333) << 2);
+    valor = ((valor >> 4) & 0x0F0F0F0F) | ((valor & 0x0F0F0F0F) << 4);
+    valor = ((valor >> 8) & 0x00FF00FF) | ((valor & 0x00FF00FF) << 8);
+
+    return (valor >> 16) | (valor << 16);
+}
+#endif
+
+
+/***************************************************************************************
+**  Nombre:         uint8_t iniciarCRC8(void)
+**  Descripcion:    Valor inicial del CRC8
+**  Parametros:     Ninguno
+**  Retorno:        CRC
+****************************************************************************************/
+uint8_t iniciarCRC8(void)
+{
+    return VALOR_INICIO_CRC8;
+}
+
+
+/***************************************************************************************
+**  Nombre:         uint8_t actualizarCRC8(uint8_t crc, const void *dato, uint32_t longitud)
+**  Descripcion:    Anade un bloque de datos al CRC8
+**  Parametros:     CRC, datos, longitud de los datos
 **  Retorno:        CRC
 ****************************************************************************************/
-uint16_t actualizarCRC16(uint16_t crc, uint8_t dato)
+uint8_t actualizarCRC8(uint8_t crc, const void *dato, uint32_t longitud)
 {
-    crc ^= (uint16_t)dato << 8;
+    const uint8_t *p = (const uint8_t *)dato;
+    const uint8_t *pFin = p + longitud;
 
-    for (int i = 0; i < 8; ++i) {
-        if (crc & 0x8000)
-            crc = (crc << 1) ^ 0x1021;
-        else
-            crc = crc << 1;
+#ifdef USAR_CRC_HW
+    if (longitud >= LONGITUD_MIN_CRC_HW && reservarCRChardware()) {
+        crc = calcularCRChardware(&configCRC8hw, crc, p, longitud);
+        liberarCRChardware();
+        return crc;
+    }
+#endif
+
+    while (p != pFin) {
+        crc = tablaCRC8[crc ^ *p];
+        p++;
     }
 
     return crc;
@@ -105,21 +303,152 @@ uint16_t actualizarCRC16(uint16_t crc, uint8_t dato)
 
 
 /***************************************************************************************
-**  Nombre:         uint16_t calcularCRC16(uint16_t crc, const void *dato, uint32_t longitud)
-**  Descripcion:    Actualiza el CRC
-**  Parametros:     CRC, dato a actualizar, longitud de los datos
+**  Nombre:         uint8_t finalizarCRC8(uint8_t crc)
+**  Descripcion:    Valor final del CRC8
+**  Parametros:     CRC
+**  Retorno:        CRC
+****************************************************************************************/
+uint8_t finalizarCRC8(uint8_t crc)
+{
+    return crc;
+}
+
+
+/***************************************************************************************
+**  Nombre:         uint8_t calcularCRC8(const void *dato, uint32_t longitud)
+**  Descripcion:    Calcula el CRC8 de un bloque de datos
+**  Parametros:     Datos, longitud de los datos
+**  Retorno:        CRC
+****************************************************************************************/
+uint8_t calcularCRC8(const void *dato, uint32_t longitud)
+{
+    return finalizarCRC8(actualizarCRC8(iniciarCRC8(), dato, longitud));
+}
+
+
+/***************************************************************************************
+**  Nombre:         uint16_t iniciarCRC16(void)
+**  Descripcion:    Valor inicial del CRC16
+**  Parametros:     Ninguno
+**  Retorno:        CRC
+****************************************************************************************/
+uint16_t iniciarCRC16(void)
+{
+    return VALOR_INICIO_CRC16;
+}
+
+
+/***************************************************************************************
+**  Nombre:         uint16_t actualizarCRC16(uint16_t crc, const void *dato, uint32_t longitud)
+**  Descripcion:    Anade un bloque de datos al CRC16
+**  Parametros:     CRC, datos, longitud de los datos
+**  Retorno:        CRC
+****************************************************************************************/
+uint16_t actualizarCRC16(uint16_t crc, const void *dato, uint32_t longitud)
+{
+    const uint8_t *p = (const uint8_t *)dato;
+    const uint8_t *pFin = p + longitud;
+
+#ifdef USAR_CRC_HW
+    if (longitud >= LONGITUD_MIN_CRC_HW && reservarCRChardware()) {
+        crc = calcularCRChardware(&configCRC16hw, crc, p, longitud);
+        liberarCRChardware();
+        return crc;
+    }
+#endif
+
+    while (p != pFin) {
+        crc = (crc << 8) ^ tablaCRC16[(crc >> 8) ^ *p];
+        p++;
+    }
+
+    return crc;
+}
+
+
+/***************************************************************************************
+**  Nombre:         uint16_t finalizarCRC16(uint16_t crc)
+**  Descripcion:    Valor final del CRC16
+**  Parametros:     CRC
+**  Retorno:        CRC
+****************************************************************************************/
+uint16_t finalizarCRC16(uint16_t crc)
+{
+    return crc;
+}
+
+
+/***************************************************************************************
+**  Nombre:         uint16_t calcularCRC16(const void *dato, uint32_t longitud)
+**  Descripcion:    Calcula el CRC16 de un bloque de datos
+**  Parametros:     Datos, longitud de los datos
+**  Retorno:        CRC
+****************************************************************************************/
+uint16_t calcularCRC16(const void *dato, uint32_t longitud)
+{
+    return finalizarCRC16(actualizarCRC16(iniciarCRC16(), dato, longitud));
+}
+
+
+/***************************************************************************************
+**  Nombre:         uint32_t iniciarCRC32(void)
+**  Descripcion:    Valor inicial del CRC32
+**  Parametros:     Ninguno
+**  Retorno:        CRC
+****************************************************************************************/
+uint32_t iniciarCRC32(void)
+{
+    return VALOR_INICIO_CRC32;
+}
+
+
+/***************************************************************************************
+**  Nombre:         uint32_t actualizarCRC32(uint32_t crc, const void *dato, uint32_t longitud)
+**  Descripcion:    Anade un bloque de datos al CRC32
+**  Parametros:     CRC, datos, longitud de los datos
 **  Retorno:        CRC
 ****************************************************************************************/
-uint16_t calcularCRC16(uint16_t crc, const void *dato, uint32_t longitud)
+uint32_t actualizarCRC32(uint32_t crc, const void *dato, uint32_t longitud)
 {
     const uint8_t *p = (const uint8_t *)dato;
     const uint8_t *pFin = p + longitud;
 
+#ifdef USAR_CRC_HW
+    if (longitud >= LONGITUD_MIN_CRC_HW && reservarCRChardware()) {
+        crc = calcularCRChardware(&configCRC32hw, reflejarCRC32(crc), p, longitud);
+        liberarCRChardware();
+        return crc;
+    }
+#endif
+
     while (p != pFin) {
-        crc = actualizarCRC16(crc, *p);
+        crc = (crc >> 8) ^ tablaCRC32[(crc ^ *p) & 0xFF];
         p++;
     }
 
     return crc;
 }
 
+
+/***************************************************************************************
+**  Nombre:         uint32_t finalizarCRC32(uint32_t crc)
+**  Descripcion:    Valor final del CRC32
+**  Parametros:     CRC
+**  Retorno:        CRC
+****************************************************************************************/
+uint32_t finalizarCRC32(uint32_t crc)
+{
+    return crc ^ 0xFFFFFFFF;
+}
+
+
+/***************************************************************************************
+**  Nombre:         uint32_t calcularCRC32(const void *dato, uint32_t longitud)
+**  Descripcion:    Calcula el CRC32 de un bloque de datos
+**  Parametros:     Datos, longitud de los datos
+**  Retorno:        CRC
+****************************************************************************************/
+uint32_t calcularCRC32(const void *dato, uint32_t longitud)
+{
+    return finalizarCRC32(actualizarCRC32(iniciarCRC32(), dato, longitud));
+}
@@ -7,7 +7,7 @@
 **
 **  Autor: Ramon Rico
 **  Fecha de creacion: 03/05/2019
-**  Fecha de modificacion: 03/08/2020
+**  Fecha de modificacion: 17/10/2026
 **
 **  El proyecto URpilot NO es libre. No se puede distribuir y/o modificar este fichero
 **  bajo ningun concepto.
@@ -35,11 +35,31 @@
 /***************************************************************************************
 ** AREA DE PREPROCESADOR                                                              **
 ****************************************************************************************/
+// CRC8 DVB-S2: polinomio 0xD5, sin reflejar, valor inicial 0 y sin XOR final
+#define POLINOMIO_CRC8               0xD5
+#define VALOR_INICIO_CRC8            0x00
+
+// CRC16 CCITT: polinomio 0x1021, sin reflejar, valor inicial 0xFFFF y sin XOR final
+#define POLINOMIO_CRC16              0x1021
+#define VALOR_INICIO_CRC16           0xFFFF
+
+// CRC32 IEEE 802.3 (Ethernet, zlib): polinomio 0x04C11DB7 reflejado, valor inicial y XOR final 0xFFFFFFFF
+#define POLINOMIO_CRC32              0x04C11DB7
+#define VALOR_INICIO_CRC32           0xFFFFFFFF
+
+// Con la unidad CRC (USAR_CRC_HW) los bloques mas cortos se siguen calculando con la tabla
+#define LONGITUD_MIN_CRC_HW          32
 
 
 /***************************************************************************************
 ** AREA DE DEFINICION DE TIPOS                                                        **
 ****************************************************************************************/
+// Configuracion de la unidad CRC. El valor inicial y el resultado son los de sus registros
+typedef struct {
+    uint32_t polinomio;
+    uint8_t bits;                           // 8, 16 o 32
+    bool reflejado;                         // Invierte los bits de cada byte de entrada y del resultado
+} configCRChardware_t;
 
 
 /***************************************************************************************
@@ -50,7 +70,26 @@
 /***************************************************************************************
 ** AREA DE PROTOTIPOS DE FUNCION                                                      **
 ****************************************************************************************/
+void iniciarCRC(void);
 uint16_t calcularCRC4(uint16_t *dato);
-uint16_t calcularCRC16(uint16_t crc, const void *dato, uint32_t longitud);
+
+uint8_t iniciarCRC8(void);
+uint8_t actualizarCRC8(uint8_t crc, const void *dato, uint32_t longitud);
+uint8_t finalizarCRC8(uint8_t crc);
+uint8_t calcularCRC8(const void *dato, uint32_t longitud);
+
+uint16_t iniciarCRC16(void);
+uint16_t actualizarCRC16(uint16_t crc, const void *dato, uint32_t longitud);
+uint16_t finalizarCRC16(uint16_t crc);
+uint16_t calcularCRC16(const void *dato, uint32_t longitud);
+
+uint32_t iniciarCRC32(void);
+uint32_t actualizarCRC32(uint32_t crc, const void *dato, uint32_t longitud);
+uint32_t finalizarCRC32(uint32_t crc);
+uint32_t calcularCRC32(const void *dato, uint32_t longitud);
+
+// Implementadas por el HAL (crc_hal.c) o por el simulador
+void iniciarCRChardware(void);
+uint32_t calcularCRChardware(const configCRChardware_t *config, uint32_t valorInicial, const uint8_t *dato, uint32_t longitud);
 
 #endif // __CRC_H
@@ -0,0 +1,315 @@
+/***************************************************************************************
+**  matematicas_rapidas.c - Aproximaciones polinomicas de funciones trigonometricas y
+**                          trascendentes con error acotado para el lazo de control
+**
+**
+**  Este fichero forma parte del proyecto URpilot.
+**  Codigo desarrollado por el grupo de investigacion ICON de la Universidad de La Rioja
+**
+**  Autor: Ramon Rico
+**  Fecha de creacion: 17/10/2026
+**  Fecha de modificacion: 17/10/2026
+**
+**  El proyecto URpilot NO es libre. No se puede distribuir y/o modificar este fichero
+**  bajo ningun concepto.
+**
+**  En caso de modificacion y/o solicitud de informacion pongase en contacto con
+**  el grupo de investigacion ICON a traves de: www.unirioja.es/urpilot
+**
+**
+**  Control de versiones del fichero
+**
+**  v1.0  Ramon Rico. Se ha liberado la primera version estable
+**
+****************************************************************************************/
+
+/***************************************************************************************
+** AREA DE INCLUDES                                                                   **
+****************************************************************************************/
+#include <math.h>
+
+#include "matematicas_rapidas.h"
+#include "Sistema/plataforma.h"
+
+
+/***************************************************************************************
+** AREA DE PREPROCESADOR                                                              **
+****************************************************************************************/
+#define PI_RAPIDO                    3.14159265358979f
+#define PI_MEDIO_RAPIDO              1.57079632679490f
+#define DOS_ENTRE_PI_RAPIDO          0.636619772367581f
+
+// pi / 2 y ln(2) partidos en dos para la reduccion de Cody-Waite. La parte alta es exacta al multiplicar
+// por enteros pequenios
+#define PI_MEDIO_ALTO_RAPIDO         1.5703125f
+#define PI_MEDIO_BAJO_RAPIDO         4.83826794897e-4f
+#define LN2_ALTO_RAPIDO              0.693359375f
+#define LN2_BAJO_RAPIDO              -2.12194440e-4f
+#define LN2_RAPIDO                   0.693147180559945f
+#define LOG2_E_RAPIDO                1.44269504088896f
+#define RAIZ_2_RAPIDO                1.41421356237310f
+
+
+/***************************************************************************************
+** AREA DE DEFINICION DE TIPOS                                                        **
+****************************************************************************************/
+typedef union {
+    float f;
+    uint32_t i;
+} bitsFloat_t;
+
+
+/***************************************************************************************
+** AREA DE DECLARACION DE VARIABLES                                                   **
+****************************************************************************************/
+
+
+/***************************************************************************************
+** AREA DE PROTOTIPOS DE FUNCION                                                      **
+****************************************************************************************/
+float atanUnidadRapido(float z);
+int32_t redondearRapido(float x);
+float potencia2enteraRapido(int32_t n);
+
+
+/***************************************************************************************
+** AREA DE DEFINICION DE FUNCIONES                                                    **
+****************************************************************************************/
+
+/***************************************************************************************
+**  Nombre:         int32_t redondearRapido(float x)
+**  Descripcion:    Redondeo al entero mas cercano con la conversion de la FPU, sin llamar a
+**                  la libreria
+**  Parametros:     Valor dentro del rango de int32_t
+**  Retorno:        Entero mas cercano
+****************************************************************************************/
+CODIGO_RAPIDO int32_t redondearRapido(float x)
+{
+    return (int32_t)(x >= 0.0f ? x + 0.5f : x - 0.5f);
+}
+
+
+/***************************************************************************************
+**  Nombre:         float atanUnidadRapido(float z)
+**  Descripcion:    Arcotangente en [0, 1]. Polinomio impar de grado 17 (Abramowitz y Stegun
+**                  4.4.49)
+**  Parametros:     Argumento en [0, 1]
+**  Retorno:        Arcotangente en rad
+****************************************************************************************/
+CODIGO_RAPIDO float atanUnidadRapido(float z)
+{
+    const float z2 = z * z;
+
+    return z * (1.0f + z2 * (-0.3333314528f + z2 * (0.1999355085f + z2 * (-0.1420889944f + z2 * (0.1065626393f +
+           z2 * (-0.0752896400f + z2 * (0.0429096138f + z2 * (-0.0161657367f + z2 * 0.0028662257f))))))));
+}
+
+
+/***************************************************************************************
+**  Nombre:         float atan2Rapido(float y, float x)
+**  Descripcion:    Arcotangente de y / x en los cuatro cuadrantes. Se reduce a [0, 1] con el
+**                  cociente del menor entre el mayor y se recoloca por octantes
+**  Parametros:     Coordenadas
+**  Retorno:        Angulo en rad entre -pi y pi. Cero si x = y = 0
+****************************************************************************************/
+CODIGO_RAPIDO float atan2Rapido(float y, float x)
+{
+    const float ax = fabsf(x);
+    const float ay = fabsf(y);
+    const float maximo = ax > ay ? ax : ay;
+    const float minimo = ax > ay ? ay : ax;
+
+    if (maximo == 0.0f)
+        return 0.0f;
+
+    float angulo = atanUnidadRapido(minimo / maximo);
+
+    if (ay > ax)
+        angulo = PI_MEDIO_RAPIDO - angulo;
+
+    if (x < 0.0f)
+        angulo = PI_RAPIDO - angulo;
+
+    return y < 0.0f ? -angulo : angulo;
+}
+
+
+/***************************************************************************************
+**  Nombre:         float asinRapido(float x)
+**  Descripcion:    Arcoseno: pi/2 - sqrt(1 - |x|) * P(|x|) con P de grado 7 (Abramowitz y
+**                  Stegun 4.4.46). La raiz es la instruccion de la FPU
+**  Parametros:     Argumento. Se satura a [-1, 1]
+**  Retorno:        Angulo en rad entre -pi/2 y pi/2
+****************************************************************************************/
+CODIGO_RAPIDO float asinRapido(float x)
+{
+    float ax = fabsf(x);
+
+    if (ax > 1.0f)
+        ax = 1.0f;
+
+    const float p = 1.5707963050f + ax * (-0.2145988016f + ax * (0.0889789874f + ax * (-0.0501743046f + ax * (0.0308918810f +
+                    ax * (-0.0170881256f + ax * (0.0066700901f + ax * -0.0012624911f))))));
+    const float angulo = PI_MEDIO_RAPIDO - sqrtf(1.0f - ax) * p;
+
+    return x < 0.0f ? -angulo : angulo;
+}
+
+
+/***************************************************************************************
+**  Nombre:         void senCosRapido(float x, float *seno, float *coseno)
+**  Descripcion:    Seno y coseno a la vez. Se reduce a [-pi/4, pi/4] con el cuadrante y se
+**                  evaluan los polinomios minimax de grado 7 y 8 (Cephes)
+**  Parametros:     Angulo en rad (|x| <= ARGUMENTO_MAX_SEN_COS_RAPIDO), seno, coseno
+**  Retorno:        Ninguno
+****************************************************************************************/
+CODIGO_RAPIDO void senCosRapido(float x, float *seno, float *coseno)
+{
+    const int32_t cuadrante = redondearRapido(x * DOS_ENTRE_PI_RAPIDO);
+    const float k = cuadrante;
+    const float r = (x - k * PI_MEDIO_ALTO_RAPIDO) - k * PI_MEDIO_BAJO_RAPIDO;
+    const float r2 = r * r;
+
+    const float s = r + r * r2 * (-1.6666654611e-1f + r2 * (8.3321608736e-3f + r2 * -1.9515295891e-4f));
+    const float c = 1.0f - 0.5f * r2 + r2 * r2 * (4.166664568298827e-2f + r2 * (-1.388731625493765e-3f + r2 * 2.443315711809948e-5f));
+
+    switch (cuadrante & 3) {
+        case 0:
+            *seno = s;
+            *coseno = c;
+            break;
+
+        case 1:
+            *seno = c;
+            *coseno = -s;
+            break;
+
+        case 2:
+            *seno = -s;
+            *coseno = -c;
+            break;
+
+        default:
+            *seno = -c;
+            *coseno = s;
+            break;
+    }
+}
+
+
+/***************************************************************************************
+**  Nombre:         float potencia2enteraRapido(int32_t n)
+**  Descripcion:    2^n construido en el exponente del float
+**  Parametros:     Exponente entre -126 y 127
+**  Retorno:        2^n
+****************************************************************************************/
+CODIGO_RAPIDO float potencia2enteraRapido(int32_t n)
+{
+    bitsFloat_t conv;
+
+    conv.i = (uint32_t)(n + 127) << 23;
+    return conv.f;
+}
+
+
+/***************************************************************************************
+**  Nombre:         float expRapido(float x)
+**  Descripcion:    Exponencial: x = n * ln2 + r con |r| <= ln2 / 2, e^r con el polinomio de
+**                  Taylor de grado 6 y 2^n en el exponente
+**  Parametros:     Argumento. Se satura al rango del float
+**  Retorno:        e^x
+****************************************************************************************/
+CODIGO_RAPIDO float expRapido(float x)
+{
+    if (x > ARGUMENTO_MAX_EXP_RAPIDO)
+        x = ARGUMENTO_MAX_EXP_RAPIDO;
+    else if (x < ARGUMENTO_MIN_EXP_RAPIDO)
+        x = ARGUMENTO_MIN_EXP_RAPIDO;
+
+    const int32_t n = redondearRapido(x * LOG2_E_RAPIDO);
+    const float r = (x - n * LN2_ALTO_RAPIDO) - n * LN2_BAJO_RAPIDO;
+    const float p = 1.0f + r * (1.0f + r * (0.5f + r * (1.6666667e-1f + r * (4.1666668e-2f + r * (8.3333338e-3f + r * 1.3888889e-3f)))));
+
+    return p * potencia2enteraRapido(n);
+}
+
+
+/***************************************************************************************
+**  Nombre:         float exp2Rapido(float x)
+**  Descripcion:    2^x: x = n + f con |f| <= 1/2, 2^f con el polinomio de Taylor de grado 6
+**  Parametros:     Argumento. Se satura al rango del float
+**  Retorno:        2^x
+****************************************************************************************/
+CODIGO_RAPIDO float exp2Rapido(float x)
+{
+    if (x > ARGUMENTO_MAX_EXP_RAPIDO * LOG2_E_RAPIDO)
+        x = ARGUMENTO_MAX_EXP_RAPIDO * LOG2_E_RAPIDO;
+    else if (x < ARGUMENTO_MIN_EXP_RAPIDO * LOG2_E_RAPIDO)
+        x = ARGUMENTO_MIN_EXP_RAPIDO * LOG2_E_RAPIDO;
+
+    const int32_t n = redondearRapido(x);
+    const float f = x - n;
+    const float p = 1.0f + f * (0.693147180559945f + f * (0.240226506959101f + f * (0.0555041086648216f +
+                    f * (0.00961812910762848f + f * (0.00133335581464284f + f * 0.000154035303933816f)))));
+
+    return p * potencia2enteraRapido(n);
+}
+
+
+/***************************************************************************************
+**  Nombre:         float logRapido(float x)
+**  Descripcion:    Logaritmo neperiano: x = m * 2^e con m en [sqrt(2)/2, sqrt(2)) y
+**                  ln(m) = 2 * atanh(s) con s = (m - 1) / (m + 1) hasta s^7
+**  Parametros:     Argumento normalizado positivo
+**  Retorno:        ln(x). -infinito si x <= 0
+****************************************************************************************/
+CODIGO_RAPIDO float logRapido(float x)
+{
+    bitsFloat_t conv;
+
+    if (x <= 0.0f)
+        return -INFINITY;
+
+    conv.f = x;
+    int32_t e = (int32_t)((conv.i >> 23) & 0xFF) - 127;
+    conv.i = (conv.i & 0x007FFFFF) | 0x3F800000;
+
+    float m = conv.f;
+    if (m > RAIZ_2_RAPIDO) {
+        m *= 0.5f;
+        e++;
+    }
+
+    const float s = (m - 1.0f) / (m + 1.0f);
+    const float s2 = s * s;
+    const float lnM = 2.0f * s * (1.0f + s2 * (0.333333333f + s2 * (0.2f + s2 * 0.142857143f)));
+
+    return lnM + e * LN2_RAPIDO;
+}
+
+
+/***************************************************************************************
+**  Nombre:         float log2Rapido(float x)
+**  Descripcion:    Logaritmo en base 2
+**  Parametros:     Argumento normalizado positivo
+**  Retorno:        log2(x). -infinito si x <= 0
+****************************************************************************************/
+CODIGO_RAPIDO float log2Rapido(float x)
+{
+    return logRapido(x) * LOG2_E_RAPIDO;
+}
+
+
+/***************************************************************************************
+**  Nombre:         float powRapido(float x, float y)
+**  Descripcion:    Potencia x^y = 2^(y * log2(x)) para base positiva
+**  Parametros:     Base positiva, exponente
+**  Retorno:        x^y. Cero si x <= 0
+****************************************************************************************/
+CODIGO_RAPIDO float powRapido(float x, float y)
+{
+    if (x <= 0.0f)
+        return 0.0f;
+
+    return exp2Rapido(y * log2Rapido(x));
+}
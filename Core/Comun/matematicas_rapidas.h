@@ -0,0 +1,78 @@
+/***************************************************************************************
+**  matematicas_rapidas.h - Aproximaciones polinomicas de funciones trigonometricas y
+**                          trascendentes con error acotado para el lazo de control
+**
+**
+**  Este fichero forma parte del proyecto URpilot.
+**  Codigo desarrollado por el grupo de investigacion ICON de la Universidad de La Rioja
+**
+**  Autor: Ramon Rico
+**  Fecha de creacion: 17/10/2026
+**  Fecha de modificacion: 17/10/2026
+**
+**  El proyecto URpilot NO es libre. No se puede distribuir y/o modificar este fichero
+**  bajo ningun concepto.
+**
+**  En caso de modificacion y/o solicitud de informacion pongase en contacto con
+**  el grupo de investigacion ICON a traves de: www.unirioja.es/urpilot
+**
+**
+**  Control de versiones del fichero
+**
+**  v1.0  Ramon Rico. Se ha liberado la primera version estable
+**
+****************************************************************************************/
+
+#ifndef __MATEMATICAS_RAPIDAS_H
+#define __MATEMATICAS_RAPIDAS_H
+
+/***************************************************************************************
+** AREA DE INCLUDES                                                                   **
+****************************************************************************************/
+#include <stdint.h>
+#include <stdbool.h>
+
+
+/***************************************************************************************
+** AREA DE PREPROCESADOR                                                              **
+****************************************************************************************/
+// Error maximo medido en el host barriendo todo el dominio frente a la libreria en doble precision
+// (SITL/Comun/matematicas_rapidas_sitl.c). Absoluto en radianes para los angulos y relativo para el resto
+#define ERROR_MAX_ATAN2_RAPIDO       4e-7f
+#define ERROR_MAX_ASIN_RAPIDO        4e-7f
+#define ERROR_MAX_SEN_COS_RAPIDO     2e-7f
+#define ERROR_MAX_EXP_RAPIDO         3e-7f
+#define ERROR_MAX_EXP2_RAPIDO        3e-7f
+#define ERROR_MAX_LOG_RAPIDO         1e-5f       // Absoluto. Para |x| grande es la resolucion del float
+#define ERROR_MAX_LOG2_RAPIDO        2e-5f       // Absoluto
+#define ERROR_MAX_POW_RAPIDO         1e-6f       // Con |y * log2(x)| <= 8
+
+// Dominios
+#define ARGUMENTO_MAX_SEN_COS_RAPIDO 1000.0f     // rad. Por encima se pierde precision en la reduccion
+#define ARGUMENTO_MAX_EXP_RAPIDO     88.0f       // Se satura para no desbordar
+#define ARGUMENTO_MIN_EXP_RAPIDO     -87.0f
+
+
+/***************************************************************************************
+** AREA DE DEFINICION DE TIPOS                                                        **
+****************************************************************************************/
+
+
+/***************************************************************************************
+** AREA DE DECLARACION DE VARIABLES                                                   **
+****************************************************************************************/
+
+
+/***************************************************************************************
+** AREA DE PROTOTIPOS DE FUNCION                                                      **
+****************************************************************************************/
+float atan2Rapido(float y, float x);
+float asinRapido(float x);
+void senCosRapido(float x, float *seno, float *coseno);
+float expRapido(float x);
+float exp2Rapido(float x);
+float logRapido(float x);
+float log2Rapido(float x);
+float powRapido(float x, float y);
+
+#endif // __MATEMATICAS_RAPIDAS_H
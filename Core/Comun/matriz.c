@@ -7,7 +7,7 @@
 **
 **  Autor: Ramon Rico
 **  Fecha de creacion: 30/03/2021
-**  Fecha de modificacion: 30/03/2021
+**  Fecha de modificacion: 17/10/2026
 **
 **  El proyecto URpilot NO es libre. No se puede distribuir y/o modificar este fichero
 **  bajo ningun concepto.
@@ -27,6 +27,7 @@
 /***************************************************************************************
 ** AREA DE INCLUDES                                                                   **
 ****************************************************************************************/
+#include <string.h>
 #include <math.h>
 
 #include "matriz.h"
@@ -53,6 +54,7 @@
 ****************************************************************************************/
 void intercambiarFilas(matriz_t *M, uint8_t a, uint8_t b, uint8_t dim);
 void intercambiarColumnas(matriz_t *M, uint8_t a, uint8_t b, uint8_t dim);
+void multiplicarMatFija(const float *A, const float *B, float *R, const uint8_t dim);
 
 
 /***************************************************************************************
@@ -114,6 +116,7 @@ void multiplicarMatrices(matriz_t A, matriz_t B, matriz_t *R, uint8_t dim)
 {
     for (uint8_t i = 0; i < dim; i++) {
         for (uint8_t j = 0; j < dim; j++) {
+            R->m[i][j] = 0;
             for (uint8_t k = 0; k < dim; k++)
                 R->m[i][j] += A.m[i][k] * B.m[k][j];
         }
@@ -288,3 +291,529 @@ inline void intercambiarColumnas(matriz_t *M, uint8_t a, uint8_t b, uint8_t dim)
         M->m[i][b] = tmp;
     }
 }
+
+
+/***************************************************************************************
+**  Nombre:         void sumarMat(const float *A, const float *B, float *R, uint8_t filas,
+**                                uint8_t columnas)
+**  Descripcion:    Suma dos matrices. R puede ser A o B
+**  Parametros:     Primera matriz, segunda matriz, resultado, filas, columnas
+**  Retorno:        Ninguno
+****************************************************************************************/
+void sumarMat(const float *A, const float *B, float *R, uint8_t filas, uint8_t columnas)
+{
+    const uint16_t numElementos = filas * columnas;
+
+    for (uint16_t i = 0; i < numElementos; i++)
+        R[i] = A[i] + B[i];
+}
+
+
+/***************************************************************************************
+**  Nombre:         void restarMat(const float *A, const float *B, float *R, uint8_t filas,
+**                                 uint8_t columnas)
+**  Descripcion:    Resta dos matrices. R puede ser A o B
+**  Parametros:     Primera matriz, segunda matriz, resultado, filas, columnas
+**  Retorno:        Ninguno
+****************************************************************************************/
+void restarMat(const float *A, const float *B, float *R, uint8_t filas, uint8_t columnas)
+{
+    const uint16_t numElementos = filas * columnas;
+
+    for (uint16_t i = 0; i < numElementos; i++)
+        R[i] = A[i] - B[i];
+}
+
+
+/***************************************************************************************
+**  Nombre:         void escalarMat(const float *A, float k, float *R, uint8_t filas, uint8_t columnas)
+**  Descripcion:    Multiplica una matriz por un escalar. R puede ser A
+**  Parametros:     Matriz, escalar, resultado, filas, columnas
+**  Retorno:        Ninguno
+****************************************************************************************/
+void escalarMat(const float *A, float k, float *R, uint8_t filas, uint8_t columnas)
+{
+    const uint16_t numElementos = filas * columnas;
+
+    for (uint16_t i = 0; i < numElementos; i++)
+        R[i] = A[i] * k;
+}
+
+
+/***************************************************************************************
+**  Nombre:         void multiplicarMat(const float *A, const float *B, float *R, uint8_t filasA,
+**                                      uint8_t columnasA, uint8_t columnasB)
+**  Descripcion:    R = A * B. R no puede ser A ni B
+**  Parametros:     Matriz A, matriz B, resultado, filas de A, columnas de A (filas de B),
+**                  columnas de B
+**  Retorno:        Ninguno
+****************************************************************************************/
+void multiplicarMat(const float *A, const float *B, float *R, uint8_t filasA, uint8_t columnasA, uint8_t columnasB)
+{
+    for (uint8_t i = 0; i < filasA; i++) {
+        const float *filaA = &A[i * columnasA];
+
+        for (uint8_t j = 0; j < columnasB; j++) {
+            const float *columnaB = &B[j];
+            float suma = 0;
+
+            for (uint8_t k = 0; k < columnasA; k++) {
+                suma += filaA[k] * *columnaB;
+                columnaB += columnasB;
+            }
+
+            R[i * columnasB + j] = suma;
+        }
+    }
+}
+
+
+/***************************************************************************************
+**  Nombre:         void multiplicarMatTras(const float *A, const float *B, float *R, uint8_t filasA,
+**                                          uint8_t columnasA, uint8_t filasB)
+**  Descripcion:    R = A * B'. Recorre las dos matrices por filas. R no puede ser A ni B
+**  Parametros:     Matriz A, matriz B, resultado, filas de A, columnas de A y de B, filas de B
+**  Retorno:        Ninguno
+****************************************************************************************/
+void multiplicarMatTras(const float *A, const float *B, float *R, uint8_t filasA, uint8_t columnasA, uint8_t filasB)
+{
+    for (uint8_t i = 0; i < filasA; i++) {
+        const float *filaA = &A[i * columnasA];
+
+        for (uint8_t j = 0; j < filasB; j++) {
+            const float *filaB = &B[j * columnasA];
+            float suma = 0;
+
+            for (uint8_t k = 0; k < columnasA; k++)
+                suma += filaA[k] * filaB[k];
+
+            R[i * filasB + j] = suma;
+        }
+    }
+}
+
+
+/***************************************************************************************
+**  Nombre:         void multiplicarTrasMat(const float *A, const float *B, float *R, uint8_t filasA,
+**                                          uint8_t columnasA, uint8_t columnasB)
+**  Descripcion:    R = A' * B. R no puede ser A ni B
+**  Parametros:     Matriz A, matriz B, resultado, filas de A y de B, columnas de A, columnas de B
+**  Retorno:        Ninguno
+****************************************************************************************/
+void multiplicarTrasMat(const float *A, const float *B, float *R, uint8_t filasA, uint8_t columnasA, uint8_t columnasB)
+{
+    resetearMat(R, columnasA, columnasB);
+
+    // Se acumula el producto exterior de cada fila para recorrer A y B por filas
+    for (uint8_t k = 0; k < filasA; k++) {
+        const float *filaA = &A[k * columnasA];
+        const float *filaB = &B[k * columnasB];
+
+        for (uint8_t i = 0; i < columnasA; i++) {
+            float *filaR = &R[i * columnasB];
+
+            for (uint8_t j = 0; j < columnasB; j++)
+                filaR[j] += filaA[i] * filaB[j];
+        }
+    }
+}
+
+
+/***************************************************************************************
+**  Nombre:         void multiplicarMatVector(const float *A, const float *x, float *y, uint8_t filas,
+**                                            uint8_t columnas)
+**  Descripcion:    y = A * x. y no puede ser x
+**  Parametros:     Matriz, vector de entrada, vector de salida, filas, columnas
+**  Retorno:        Ninguno
+****************************************************************************************/
+void multiplicarMatVector(const float *A, const float *x, float *y, uint8_t filas, uint8_t columnas)
+{
+    for (uint8_t i = 0; i < filas; i++) {
+        const float *filaA = &A[i * columnas];
+        float suma = 0;
+
+        for (uint8_t j = 0; j < columnas; j++)
+            suma += filaA[j] * x[j];
+
+        y[i] = suma;
+    }
+}
+
+
+/***************************************************************************************
+**  Nombre:         void trasponerMat(const float *A, float *R, uint8_t filas, uint8_t columnas)
+**  Descripcion:    Calcula la traspuesta. R no puede ser A
+**  Parametros:     Matriz, resultado (columnas x filas), filas, columnas
+**  Retorno:        Ninguno
+****************************************************************************************/
+void trasponerMat(const float *A, float *R, uint8_t filas, uint8_t columnas)
+{
+    for (uint8_t i = 0; i < filas; i++) {
+        for (uint8_t j = 0; j < columnas; j++)
+            R[j * filas + i] = A[i * columnas + j];
+    }
+}
+
+
+/***************************************************************************************
+**  Nombre:         void copiarMat(const float *A, float *R, uint8_t filas, uint8_t columnas)
+**  Descripcion:    Copia una matriz
+**  Parametros:     Matriz a copiar, matriz resultante, filas, columnas
+**  Retorno:        Ninguno
+****************************************************************************************/
+void copiarMat(const float *A, float *R, uint8_t filas, uint8_t columnas)
+{
+    memcpy(R, A, filas * columnas * sizeof(float));
+}
+
+
+/***************************************************************************************
+**  Nombre:         void resetearMat(float *M, uint8_t filas, uint8_t columnas)
+**  Descripcion:    Pone a cero una matriz
+**  Parametros:     Matriz, filas, columnas
+**  Retorno:        Ninguno
+****************************************************************************************/
+void resetearMat(float *M, uint8_t filas, uint8_t columnas)
+{
+    memset(M, 0, filas * columnas * sizeof(float));
+}
+
+
+/***************************************************************************************
+**  Nombre:         void identidadMat(float *M, uint8_t dim)
+**  Descripcion:    Asigna una matriz cuadrada como identidad
+**  Parametros:     Matriz, dimension de la matriz
+**  Retorno:        Ninguno
+****************************************************************************************/
+void identidadMat(float *M, uint8_t dim)
+{
+    resetearMat(M, dim, dim);
+
+    for (uint8_t i = 0; i < dim; i++)
+        M[i * dim + i] = 1.0f;
+}
+
+
+/***************************************************************************************
+**  Nombre:         void multiplicarMatFija(const float *A, const float *B, float *R, const uint8_t dim)
+**  Descripcion:    Producto de matrices cuadradas. Se llama con la dimension constante para que
+**                  el compilador desenrolle los bucles de cada tamanio
+**  Parametros:     Matriz A, matriz B, resultado, dimension
+**  Retorno:        Ninguno
+****************************************************************************************/
+inline __attribute__((always_inline)) void multiplicarMatFija(const float *A, const float *B, float *R, const uint8_t dim)
+{
+    for (uint8_t i = 0; i < dim; i++) {
+        for (uint8_t j = 0; j < dim; j++) {
+            float suma = 0;
+
+            for (uint8_t k = 0; k < dim; k++)
+                suma += A[i * dim + k] * B[k * dim + j];
+
+            R[i * dim + j] = suma;
+        }
+    }
+}
+
+
+/***************************************************************************************
+**  Nombre:         void multiplicarMat3(const float *A, const float *B, float *R)
+**  Descripcion:    R = A * B con matrices 3x3. R no puede ser A ni B
+**  Parametros:     Matriz A, matriz B, resultado
+**  Retorno:        Ninguno
+****************************************************************************************/
+void multiplicarMat3(const float *A, const float *B, float *R)
+{
+    multiplicarMatFija(A, B, R, 3);
+}
+
+
+/***************************************************************************************
+**  Nombre:         void multiplicarMat4(const float *A, const float *B, float *R)
+**  Descripcion:    R = A * B con matrices 4x4. R no puede ser A ni B
+**  Parametros:     Matriz A, matriz B, resultado
+**  Retorno:        Ninguno
+****************************************************************************************/
+void multiplicarMat4(const float *A, const float *B, float *R)
+{
+    multiplicarMatFija(A, B, R, 4);
+}
+
+
+/***************************************************************************************
+**  Nombre:         void multiplicarMat6(const float *A, const float *B, float *R)
+**  Descripcion:    R = A * B con matrices 6x6. R no puede ser A ni B
+**  Parametros:     Matriz A, matriz B, resultado
+**  Retorno:        Ninguno
+****************************************************************************************/
+void multiplicarMat6(const float *A, const float *B, float *R)
+{
+    multiplicarMatFija(A, B, R, 6);
+}
+
+
+/***************************************************************************************
+**  Nombre:         void multiplicarMatVector3(const float *A, const float *x, float *y)
+**  Descripcion:    y = A * x con una matriz 3x3. y no puede ser x
+**  Parametros:     Matriz, vector de entrada, vector de salida
+**  Retorno:        Ninguno
+****************************************************************************************/
+void multiplicarMatVector3(const float *A, const float *x, float *y)
+{
+    y[0] = A[0] * x[0] + A[1] * x[1] + A[2] * x[2];
+    y[1] = A[3] * x[0] + A[4] * x[1] + A[5] * x[2];
+    y[2] = A[6] * x[0] + A[7] * x[1] + A[8] * x[2];
+}
+
+
+/***************************************************************************************
+**  Nombre:         bool inversaMat3(const float *A, float *R)
+**  Descripcion:    Inversa de una matriz 3x3 por la adjunta. R puede ser A
+**  Parametros:     Matriz, matriz resultante
+**  Retorno:        True si OK
+****************************************************************************************/
+bool inversaMat3(const float *A, float *R)
+{
+    const float c00 = A[4] * A[8] - A[5] * A[7];
+    const float c01 = A[5] * A[6] - A[3] * A[8];
+    const float c02 = A[3] * A[7] - A[4] * A[6];
+    const float det = A[0] * c00 + A[1] * c01 + A[2] * c02;
+    float inv[9];
+
+    if (fabsf(det) < FLT_EPSILON)
+        return false;
+
+    const float invDet = 1.0f / det;
+
+    inv[0] = c00 * invDet;
+    inv[1] = (A[2] * A[7] - A[1] * A[8]) * invDet;
+    inv[2] = (A[1] * A[5] - A[2] * A[4]) * invDet;
+    inv[3] = c01 * invDet;
+    inv[4] = (A[0] * A[8] - A[2] * A[6]) * invDet;
+    inv[5] = (A[2] * A[3] - A[0] * A[5]) * invDet;
+    inv[6] = c02 * invDet;
+    inv[7] = (A[1] * A[6] - A[0] * A[7]) * invDet;
+    inv[8] = (A[0] * A[4] - A[1] * A[3]) * invDet;
+
+    for (uint8_t i = 0; i < 9; i++) {
+        if (!isfinite(inv[i]))
+            return false;
+    }
+
+    memcpy(R, inv, sizeof(inv));
+    return true;
+}
+
+
+/***************************************************************************************
+**  Nombre:         bool factorizarCholeskyMat(float *A, uint8_t dim)
+**  Descripcion:    Factorizacion de Cholesky A = L * L' de una matriz simetrica definida
+**                  positiva. L queda en el triangulo inferior de A y solo se lee ese triangulo.
+**                  El triangulo superior no se modifica
+**  Parametros:     Matriz, dimension de la matriz
+**  Retorno:        True si OK. False si la matriz no es definida positiva
+****************************************************************************************/
+bool factorizarCholeskyMat(float *A, uint8_t dim)
+{
+    for (uint8_t j = 0; j < dim; j++) {
+        float *filaJ = &A[j * dim];
+        float diagonal = filaJ[j];
+
+        for (uint8_t k = 0; k < j; k++)
+            diagonal -= filaJ[k] * filaJ[k];
+
+        if (!(diagonal > 0.0f) || !isfinite(diagonal))
+            return false;
+
+        filaJ[j] = sqrtf(diagonal);
+        const float invDiagonal = 1.0f / filaJ[j];
+
+        for (uint8_t i = j + 1; i < dim; i++) {
+            float *filaI = &A[i * dim];
+            float suma = filaI[j];
+
+            for (uint8_t k = 0; k < j; k++)
+                suma -= filaI[k] * filaJ[k];
+
+            filaI[j] = suma * invDiagonal;
+        }
+    }
+
+    return true;
+}
+
+
+/***************************************************************************************
+**  Nombre:         void resolverCholeskyMat(const float *L, float *B, uint8_t dim, uint8_t columnasB)
+**  Descripcion:    Resuelve A * X = B con la factorizacion de Cholesky de A. X se escribe en B
+**  Parametros:     Factorizacion de factorizarCholeskyMat, terminos independientes (dim x columnasB),
+**                  dimension de la matriz, columnas de B
+**  Retorno:        Ninguno
+****************************************************************************************/
+void resolverCholeskyMat(const float *L, float *B, uint8_t dim, uint8_t columnasB)
+{
+    for (uint8_t c = 0; c < columnasB; c++) {
+        // L * y = b
+        for (uint8_t i = 0; i < dim; i++) {
+            float suma = B[i * columnasB + c];
+
+            for (uint8_t k = 0; k < i; k++)
+                suma -= L[i * dim + k] * B[k * columnasB + c];
+
+            B[i * columnasB + c] = suma / L[i * dim + i];
+        }
+
+        // L' * x = y
+        for (int8_t i = dim - 1; i >= 0; i--) {
+            float suma = B[i * columnasB + c];
+
+            for (uint8_t k = i + 1; k < dim; k++)
+                suma -= L[k * dim + i] * B[k * columnasB + c];
+
+            B[i * columnasB + c] = suma / L[i * dim + i];
+        }
+    }
+}
+
+
+/***************************************************************************************
+**  Nombre:         bool inversaCholeskyMat(float *A, uint8_t dim)
+**  Descripcion:    Inversa en el sitio de una matriz simetrica definida positiva: se factoriza,
+**                  se invierte L y se forma inv(L)' * inv(L) sin memoria auxiliar
+**  Parametros:     Matriz, dimension de la matriz
+**  Retorno:        True si OK. Si falla, A queda modificada
+****************************************************************************************/
+bool inversaCholeskyMat(float *A, uint8_t dim)
+{
+    if (!factorizarCholeskyMat(A, dim))
+        return false;
+
+    // inv(L) por columnas. Cada columna solo necesita las columnas siguientes de L, aun sin tocar
+    for (uint8_t j = 0; j < dim; j++) {
+        A[j * dim + j] = 1.0f / A[j * dim + j];
+
+        for (uint8_t i = j + 1; i < dim; i++) {
+            float suma = 0;
+
+            for (uint8_t k = j; k < i; k++)
+                suma -= A[i * dim + k] * A[k * dim + j];
+
+            A[i * dim + j] = suma / A[i * dim + i];
+        }
+    }
+
+    // inv(A) = inv(L)' * inv(L). El elemento (i, j) solo usa filas k >= i de inv(L)
+    for (uint8_t i = 0; i < dim; i++) {
+        for (uint8_t j = 0; j <= i; j++) {
+            float suma = 0;
+
+            for (uint8_t k = i; k < dim; k++)
+                suma += A[k * dim + i] * A[k * dim + j];
+
+            A[i * dim + j] = suma;
+        }
+    }
+
+    for (uint8_t i = 0; i < dim; i++) {
+        for (uint8_t j = i + 1; j < dim; j++)
+            A[i * dim + j] = A[j * dim + i];
+    }
+
+    for (uint16_t i = 0; i < dim * dim; i++) {
+        if (!isfinite(A[i]))
+            return false;
+    }
+
+    return true;
+}
+
+
+/***************************************************************************************
+**  Nombre:         bool factorizarLUmat(float *A, uint8_t *pivotes, uint8_t dim)
+**  Descripcion:    Factorizacion P * A = L * U con pivotado parcial. U queda en el triangulo
+**                  superior de A y L, con diagonal unidad, en el inferior
+**  Parametros:     Matriz, fila intercambiada en cada paso (dim elementos), dimension de la matriz
+**  Retorno:        True si OK. False si la matriz es singular
+****************************************************************************************/
+bool factorizarLUmat(float *A, uint8_t *pivotes, uint8_t dim)
+{
+    for (uint8_t j = 0; j < dim; j++) {
+        uint8_t pivote = j;
+        float maximo = fabsf(A[j * dim + j]);
+
+        for (uint8_t i = j + 1; i < dim; i++) {
+            if (fabsf(A[i * dim + j]) > maximo) {
+                maximo = fabsf(A[i * dim + j]);
+                pivote = i;
+            }
+        }
+
+        if (maximo < FLT_EPSILON || !isfinite(maximo))
+            return false;
+
+        pivotes[j] = pivote;
+        if (pivote != j) {
+            for (uint8_t k = 0; k < dim; k++) {
+                const float tmp = A[j * dim + k];
+                A[j * dim + k] = A[pivote * dim + k];
+                A[pivote * dim + k] = tmp;
+            }
+        }
+
+        const float invPivote = 1.0f / A[j * dim + j];
+
+        for (uint8_t i = j + 1; i < dim; i++) {
+            const float factor = A[i * dim + j] * invPivote;
+
+            A[i * dim + j] = factor;
+            for (uint8_t k = j + 1; k < dim; k++)
+                A[i * dim + k] -= factor * A[j * dim + k];
+        }
+    }
+
+    return true;
+}
+
+
+/***************************************************************************************
+**  Nombre:         void resolverLUmat(const float *LU, const uint8_t *pivotes, float *B, uint8_t dim,
+**                                     uint8_t columnasB)
+**  Descripcion:    Resuelve A * X = B con la factorizacion LU de A. X se escribe en B
+**  Parametros:     Factorizacion de factorizarLUmat, pivotes, terminos independientes
+**                  (dim x columnasB), dimension de la matriz, columnas de B
+**  Retorno:        Ninguno
+****************************************************************************************/
+void resolverLUmat(const float *LU, const uint8_t *pivotes, float *B, uint8_t dim, uint8_t columnasB)
+{
+    for (uint8_t j = 0; j < dim; j++) {
+        if (pivotes[j] != j) {
+            for (uint8_t c = 0; c < columnasB; c++) {
+                const float tmp = B[j * columnasB + c];
+                B[j * columnasB + c] = B[pivotes[j] * columnasB + c];
+                B[pivotes[j] * columnasB + c] = tmp;
+            }
+        }
+    }
+
+    for (uint8_t c = 0; c < columnasB; c++) {
+        // L * y = P * b
+        for (uint8_t i = 1; i < dim; i++) {
+            float suma = B[i * columnasB + c];
+
+            for (uint8_t k = 0; k < i; k++)
+                suma -= LU[i * dim + k] * B[k * columnasB + c];
+
+            B[i * columnasB + c] = suma;
+        }
+
+        // U * x = y
+        for (int8_t i = dim - 1; i >= 0; i--) {
+            float suma = B[i * columnasB + c];
+
+            for (uint8_t k = i + 1; k < dim; k++)
+                suma -= LU[i * dim + k] * B[k * columnasB + c];
+
+            B[i * columnasB + c] = suma / LU[i * dim + i];
+        }
+    }
+}
@@ -7,7 +7,7 @@
 **
 **  Autor: Ramon Rico
 **  Fecha de creacion: 30/03/2021
-**  Fecha de modificacion: 30/03/2021
+**  Fecha de modificacion: 17/10/2026
 **
 **  El proyecto URpilot NO es libre. No se puede distribuir y/o modificar este fichero
 **  bajo ningun concepto.
@@ -38,6 +38,9 @@
 ****************************************************************************************/
 #define NUM_MAX_DIM_MATRIZ     10
 
+// Las funciones terminadas en Mat trabajan sobre memoria del usuario: matrices float por filas
+// (M[i * columnas + j]) con las dimensiones explicitas. Se pasan como &M[0][0]
+
 
 /***************************************************************************************
 ** AREA DE DEFINICION DE TIPOS                                                        **
@@ -65,4 +68,28 @@ void copiarMatriz(matriz_t A, matriz_t *B, uint8_t dim);
 void resetearMatriz(matriz_t *M, uint8_t dim);
 void asignarIdentidadMatriz(matriz_t *M, uint8_t dim);
 
+void sumarMat(const float *A, const float *B, float *R, uint8_t filas, uint8_t columnas);
+void restarMat(const float *A, const float *B, float *R, uint8_t filas, uint8_t columnas);
+void escalarMat(const float *A, float k, float *R, uint8_t filas, uint8_t columnas);
+void multiplicarMat(const float *A, const float *B, float *R, uint8_t filasA, uint8_t columnasA, uint8_t columnasB);
+void multiplicarMatTras(const float *A, const float *B, float *R, uint8_t filasA, uint8_t columnasA, uint8_t filasB);
+void multiplicarTrasMat(const float *A, const float *B, float *R, uint8_t filasA, uint8_t columnasA, uint8_t columnasB);
+void multiplicarMatVector(const float *A, const float *x, float *y, uint8_t filas, uint8_t columnas);
+void trasponerMat(const float *A, float *R, uint8_t filas, uint8_t columnas);
+void copiarMat(const float *A, float *R, uint8_t filas, uint8_t columnas);
+void resetearMat(float *M, uint8_t filas, uint8_t columnas);
+void identidadMat(float *M, uint8_t dim);
+
+void multiplicarMat3(const float *A, const float *B, float *R);
+void multiplicarMat4(const float *A, const float *B, float *R);
+void multiplicarMat6(const float *A, const float *B, float *R);
+void multiplicarMatVector3(const float *A, const float *x, float *y);
+bool inversaMat3(const float *A, float *R);
+
+bool factorizarCholeskyMat(float *A, uint8_t dim);
+void resolverCholeskyMat(const float *L, float *B, uint8_t dim, uint8_t columnasB);
+bool inversaCholeskyMat(float *A, uint8_t dim);
+bool factorizarLUmat(float *A, uint8_t *pivotes, uint8_t dim);
+void resolverLUmat(const float *LU, const uint8_t *pivotes, float *B, uint8_t dim, uint8_t columnasB);
+
 #endif // __MATRIZ_H
@@ -7,7 +7,7 @@
 **
 **  Autor: Ramon Rico
 **  Fecha de creacion: 11/05/2019
-**  Fecha de modificacion: 15/09/2020
+**  Fecha de modificacion: 17/10/2026
 **
 **  El proyecto URpilot NO es libre. No se puede distribuir y/o modificar este fichero
 **  bajo ningun concepto.
@@ -50,6 +50,7 @@
 #include "AHRS/ahrs.h"
 #include "FC/mixer.h"
 #include "Drivers/usb.h"
+#include "Comun/crc.h"
 
 
 /***************************************************************************************
@@ -93,6 +94,9 @@ void iniciarPlaca(void)
 
 
     // Configuracion -------------------------------------------------------------
+    // La unidad CRC se usa al comprobar la configuracion
+    iniciarCRC();
+
     // Se inicia la configuracion de la flash
     iniciarConfigFlash();
 
@@ -134,6 +138,14 @@ void iniciarPlaca(void)
 
 
     // Perifericos --------------------------------------------------------------
+    // Motores. Van los primeros para que el DSHOT se quede con los streams DMA de sus timers y
+    // los buses que los comparten (SPI, UART) pasen a trabajar por interrupcion
+#ifdef USAR_MOTORES
+    if (!iniciarMotores()) {
+        falloSistema(FALLO_INICIAR_MOTORES);
+    }
+#endif
+
     // Power Module
 #ifdef USAR_POWER_MODULE
     if (!iniciarPowerModule())
@@ -167,13 +179,6 @@ void iniciarPlaca(void)
         falloSistema(FALLO_INICIAR_RADIO);
 #endif
 
-    // Motores
-#ifdef USAR_MOTORES
-    if (!iniciarMotores()) {
-        falloSistema(FALLO_INICIAR_MOTORES);
-    }
-#endif
-
     estadoSistema |= ESTADO_SIS_PERIFERICOS_READY;
 
 
@@ -25,7 +25,7 @@
 /***************************************************************************************
 ** AREA DE INCLUDES                                                                   **
 ****************************************************************************************/
-#include "sistema/plataforma.h"
+#include "Sistema/plataforma.h"
 #include "inicializacion.h"
 #include "Scheduler/scheduler.h"
 
@@ -7,7 +7,7 @@
 **
 **  Autor: Ramon Rico
 **  Fecha de creacion: 11/05/2019
-**  Fecha de modificacion: 03/08/2020
+**  Fecha de modificacion: 17/10/2026
 **
 **  El proyecto URpilot NO es libre. No se puede distribuir y/o modificar este fichero
 **  bajo ningun concepto.
@@ -178,7 +178,8 @@ bool iniciarDriverADC(numADC_e numADC)
             return false;
     }
 
-    iniciarDMA(identificadorDMA(driver->hal.hdma.Instance));
+    if (!iniciarDMA(identificadorDMA(driver->hal.hdma.Instance), DMA_PROPIETARIO_ADC, numADC))
+        return false;
 
     driver->hal.hdma.Init.Direction = DMA_PERIPH_TO_MEMORY;
     driver->hal.hdma.Init.PeriphInc = DMA_PINC_DISABLE;
@@ -7,7 +7,7 @@
 **
 **  Autor: Ramon Rico
 **  Fecha de creacion: 12/05/2019
-**  Fecha de modificacion: 03/08/2020
+**  Fecha de modificacion: 17/10/2026
 **
 **  El proyecto URpilot NO es libre. No se puede distribuir y/o modificar este fichero
 **  bajo ningun concepto.
@@ -144,9 +144,7 @@ CODIGO_RAPIDO bool escribirBufferRegistroBus(const bus_t *bus, uint8_t reg, uint
     UNUSED(datoTx);
     UNUSED(longitud);
 #endif
-    if (busOcupado(bus))
-        return false;
-
+    // Las transferencias se encolan detras de las pendientes del bus
     switch (bus->tipo) {
 #ifdef USAR_SPI
         case BUS_SPI:
@@ -196,9 +194,7 @@ CODIGO_RAPIDO bool leerBufferRegistroBus(const bus_t *bus, uint8_t reg, uint8_t
     UNUSED(longitud);
 #endif
 
-    if (busOcupado(bus))
-        return false;
-
+    // Las transferencias se encolan detras de las pendientes del bus
     switch (bus->tipo) {
 #ifdef USAR_SPI
         case BUS_SPI:
@@ -215,4 +211,201 @@ CODIGO_RAPIDO bool leerBufferRegistroBus(const bus_t *bus, uint8_t reg, uint8_t
     }
 }
 
+
+/***************************************************************************************
+**  Nombre:         bool prepararLecturaRegistroBus(const bus_t *bus, transaccionSPI_t *transaccion, uint8_t reg,
+**                                                  uint8_t *buffer, uint16_t longitud, callbackTransaccionSPI callback,
+**                                                  void *paramUsuario)
+**  Descripcion:    Prepara una lectura asincrona sin encolarla, para montar cadenas de transacciones
+**  Parametros:     Bus, transaccion, registro, buffer de longitud + 1 bytes, longitud de los datos,
+**                  callback de fin y parametro del callback
+**  Retorno:        True si el bus admite transferencias asincronas
+****************************************************************************************/
+bool prepararLecturaRegistroBus(const bus_t *bus, transaccionSPI_t *transaccion, uint8_t reg, uint8_t *buffer, uint16_t longitud,
+		                        callbackTransaccionSPI callback, void *paramUsuario)
+{
+    switch (bus->tipo) {
+#ifdef USAR_SPI
+        case BUS_SPI:
+            prepararLecturaRegistroBusSPI(bus, transaccion, reg, buffer, longitud, callback, paramUsuario);
+            return true;
+#endif
+        default:
+            UNUSED(transaccion);
+            UNUSED(reg);
+            UNUSED(buffer);
+            UNUSED(longitud);
+            UNUSED(callback);
+            UNUSED(paramUsuario);
+            return false;
+    }
+}
+
+
+/***************************************************************************************
+**  Nombre:         bool prepararEscrituraRegistroBus(const bus_t *bus, transaccionSPI_t *transaccion, uint8_t reg,
+**                                                    uint8_t *buffer, uint16_t longitud, callbackTransaccionSPI callback,
+**                                                    void *paramUsuario)
+**  Descripcion:    Prepara una escritura asincrona sin encolarla. Los datos van a partir de buffer[1]
+**  Parametros:     Bus, transaccion, registro, buffer de longitud + 1 bytes, longitud de los datos,
+**                  callback de fin y parametro del callback
+**  Retorno:        True si el bus admite transferencias asincronas
+****************************************************************************************/
+bool prepararEscrituraRegistroBus(const bus_t *bus, transaccionSPI_t *transaccion, uint8_t reg, uint8_t *buffer, uint16_t longitud,
+		                          callbackTransaccionSPI callback, void *paramUsuario)
+{
+    switch (bus->tipo) {
+#ifdef USAR_SPI
+        case BUS_SPI:
+            prepararTransaccionRegistroBusSPI(bus, transaccion, reg, buffer, longitud, callback, paramUsuario);
+            return true;
+#endif
+        default:
+            UNUSED(transaccion);
+            UNUSED(reg);
+            UNUSED(buffer);
+            UNUSED(longitud);
+            UNUSED(callback);
+            UNUSED(paramUsuario);
+            return false;
+    }
+}
+
+
+/***************************************************************************************
+**  Nombre:         bool leerBufferRegistroAsincronoBus(const bus_t *bus, transaccionSPI_t *transaccion, uint8_t reg,
+**                                                      uint8_t *buffer, uint16_t longitud, callbackTransaccionSPI callback,
+**                                                      void *paramUsuario)
+**  Descripcion:    Encola la lectura de un registro. Los datos quedan a partir de buffer[1]
+**  Parametros:     Bus, transaccion, registro, buffer de longitud + 1 bytes, longitud de los datos,
+**                  callback de fin y parametro del callback
+**  Retorno:        True si se ha encolado
+****************************************************************************************/
+CODIGO_RAPIDO bool leerBufferRegistroAsincronoBus(const bus_t *bus, transaccionSPI_t *transaccion, uint8_t reg, uint8_t *buffer, uint16_t longitud,
+		                                          callbackTransaccionSPI callback, void *paramUsuario)
+{
+    if (!prepararLecturaRegistroBus(bus, transaccion, reg, buffer, longitud, callback, paramUsuario))
+        return false;
+
+    return encolarTransaccionSPI(transaccion);
+}
+
+
+/***************************************************************************************
+**  Nombre:         bool escribirBufferRegistroAsincronoBus(const bus_t *bus, transaccionSPI_t *transaccion, uint8_t reg,
+**                                                          uint8_t *buffer, uint16_t longitud, callbackTransaccionSPI callback,
+**                                                          void *paramUsuario)
+**  Descripcion:    Encola la escritura de un registro. Los datos van a partir de buffer[1]
+**  Parametros:     Bus, transaccion, registro, buffer de longitud + 1 bytes, longitud de los datos,
+**                  callback de fin y parametro del callback
+**  Retorno:        True si se ha encolado
+****************************************************************************************/
+CODIGO_RAPIDO bool escribirBufferRegistroAsincronoBus(const bus_t *bus, transaccionSPI_t *transaccion, uint8_t reg, uint8_t *buffer, uint16_t longitud,
+		                                              callbackTransaccionSPI callback, void *paramUsuario)
+{
+    if (!prepararEscrituraRegistroBus(bus, transaccion, reg, buffer, longitud, callback, paramUsuario))
+        return false;
+
+    return encolarTransaccionSPI(transaccion);
+}
+
+
+/***************************************************************************************
+**  Nombre:         bool prepararLecturaRegistroBusI2C(const bus_t *bus, transaccionI2C_t *transaccion, uint8_t reg,
+**                                                     uint8_t *buffer, uint16_t longitud, callbackTransaccionI2C callback,
+**                                                     void *paramUsuario)
+**  Descripcion:    Prepara una lectura asincrona de un bus I2C sin encolarla
+**  Parametros:     Bus, transaccion, registro, buffer de longitud + 1 bytes, longitud de los datos,
+**                  callback de fin y parametro del callback
+**  Retorno:        True si el bus es I2C
+****************************************************************************************/
+bool prepararLecturaRegistroBusI2C(const bus_t *bus, transaccionI2C_t *transaccion, uint8_t reg, uint8_t *buffer, uint16_t longitud,
+		                           callbackTransaccionI2C callback, void *paramUsuario)
+{
+    switch (bus->tipo) {
+#ifdef USAR_I2C
+        case BUS_I2C:
+            prepararTransaccionRegistroBusI2C(bus, transaccion, reg, true, buffer, longitud, callback, paramUsuario);
+            return true;
+#endif
+        default:
+            UNUSED(transaccion);
+            UNUSED(reg);
+            UNUSED(buffer);
+            UNUSED(longitud);
+            UNUSED(callback);
+            UNUSED(paramUsuario);
+            return false;
+    }
+}
+
+
+/***************************************************************************************
+**  Nombre:         bool prepararEscrituraRegistroBusI2C(const bus_t *bus, transaccionI2C_t *transaccion, uint8_t reg,
+**                                                       uint8_t *buffer, uint16_t longitud, callbackTransaccionI2C callback,
+**                                                       void *paramUsuario)
+**  Descripcion:    Prepara una escritura asincrona de un bus I2C sin encolarla. Los datos van a
+**                  partir de buffer[1]
+**  Parametros:     Bus, transaccion, registro, buffer de longitud + 1 bytes, longitud de los datos,
+**                  callback de fin y parametro del callback
+**  Retorno:        True si el bus es I2C
+****************************************************************************************/
+bool prepararEscrituraRegistroBusI2C(const bus_t *bus, transaccionI2C_t *transaccion, uint8_t reg, uint8_t *buffer, uint16_t longitud,
+		                             callbackTransaccionI2C callback, void *paramUsuario)
+{
+    switch (bus->tipo) {
+#ifdef USAR_I2C
+        case BUS_I2C:
+            prepararTransaccionRegistroBusI2C(bus, transaccion, reg, false, buffer, longitud, callback, paramUsuario);
+            return true;
+#endif
+        default:
+            UNUSED(transaccion);
+            UNUSED(reg);
+            UNUSED(buffer);
+            UNUSED(longitud);
+            UNUSED(callback);
+            UNUSED(paramUsuario);
+            return false;
+    }
+}
+
+
+/***************************************************************************************
+**  Nombre:         bool leerBufferRegistroAsincronoBusI2C(const bus_t *bus, transaccionI2C_t *transaccion, uint8_t reg,
+**                                                         uint8_t *buffer, uint16_t longitud, callbackTransaccionI2C callback,
+**                                                         void *paramUsuario)
+**  Descripcion:    Encola la lectura de un registro de un bus I2C. Los datos quedan a partir de buffer[1]
+**  Parametros:     Bus, transaccion, registro, buffer de longitud + 1 bytes, longitud de los datos,
+**                  callback de fin y parametro del callback
+**  Retorno:        True si se ha encolado
+****************************************************************************************/
+bool leerBufferRegistroAsincronoBusI2C(const bus_t *bus, transaccionI2C_t *transaccion, uint8_t reg, uint8_t *buffer, uint16_t longitud,
+		                               callbackTransaccionI2C callback, void *paramUsuario)
+{
+    if (!prepararLecturaRegistroBusI2C(bus, transaccion, reg, buffer, longitud, callback, paramUsuario))
+        return false;
+
+    return encolarTransaccionI2C(transaccion);
+}
+
+
+/***************************************************************************************
+**  Nombre:         bool escribirBufferRegistroAsincronoBusI2C(const bus_t *bus, transaccionI2C_t *transaccion, uint8_t reg,
+**                                                             uint8_t *buffer, uint16_t longitud, callbackTransaccionI2C callback,
+**                                                             void *paramUsuario)
+**  Descripcion:    Encola la escritura de un registro de un bus I2C. Los datos van a partir de buffer[1]
+**  Parametros:     Bus, transaccion, registro, buffer de longitud + 1 bytes, longitud de los datos,
+**                  callback de fin y parametro del callback
+**  Retorno:        True si se ha encolado
+****************************************************************************************/
+bool escribirBufferRegistroAsincronoBusI2C(const bus_t *bus, transaccionI2C_t *transaccion, uint8_t reg, uint8_t *buffer, uint16_t longitud,
+		                                   callbackTransaccionI2C callback, void *paramUsuario)
+{
+    if (!prepararEscrituraRegistroBusI2C(bus, transaccion, reg, buffer, longitud, callback, paramUsuario))
+        return false;
+
+    return encolarTransaccionI2C(transaccion);
+}
+
 #endif
@@ -7,7 +7,7 @@
 **
 **  Autor: Ramon Rico
 **  Fecha de creacion: 12/05/2019
-**  Fecha de modificacion: 03/08/2020
+**  Fecha de modificacion: 17/10/2026
 **
 **  El proyecto URpilot NO es libre. No se puede distribuir y/o modificar este fichero
 **  bajo ningun concepto.
@@ -33,7 +33,9 @@
 
 #include "Sistema/plataforma.h"
 #include "spi.h"
+#include "spi_cola.h"
 #include "i2c.h"
+#include "i2c_cola.h"
 
 
 /***************************************************************************************
@@ -80,4 +82,25 @@ bool escribirBufferRegistroBus(const bus_t *bus, uint8_t reg, uint8_t *datoTx, u
 bool leerRegistroBus(const bus_t *bus, uint8_t reg, uint8_t *byteRx);
 bool leerBufferRegistroBus(const bus_t *bus, uint8_t reg, uint8_t *datoRx, uint8_t longitud);
 
+// Transferencias asincronas. El buffer tiene longitud + 1 bytes: el primero es el registro y el
+// resto los datos. Solo disponibles en los buses SPI
+bool prepararLecturaRegistroBus(const bus_t *bus, transaccionSPI_t *transaccion, uint8_t reg, uint8_t *buffer, uint16_t longitud,
+		                        callbackTransaccionSPI callback, void *paramUsuario);
+bool prepararEscrituraRegistroBus(const bus_t *bus, transaccionSPI_t *transaccion, uint8_t reg, uint8_t *buffer, uint16_t longitud,
+		                          callbackTransaccionSPI callback, void *paramUsuario);
+bool leerBufferRegistroAsincronoBus(const bus_t *bus, transaccionSPI_t *transaccion, uint8_t reg, uint8_t *buffer, uint16_t longitud,
+		                            callbackTransaccionSPI callback, void *paramUsuario);
+bool escribirBufferRegistroAsincronoBus(const bus_t *bus, transaccionSPI_t *transaccion, uint8_t reg, uint8_t *buffer, uint16_t longitud,
+		                                callbackTransaccionSPI callback, void *paramUsuario);
+
+// Equivalentes en los buses I2C sobre la cola del I2C. El buffer tiene el mismo formato
+bool prepararLecturaRegistroBusI2C(const bus_t *bus, transaccionI2C_t *transaccion, uint8_t reg, uint8_t *buffer, uint16_t longitud,
+		                           callbackTransaccionI2C callback, void *paramUsuario);
+bool prepararEscrituraRegistroBusI2C(const bus_t *bus, transaccionI2C_t *transaccion, uint8_t reg, uint8_t *buffer, uint16_t longitud,
+		                             callbackTransaccionI2C callback, void *paramUsuario);
+bool leerBufferRegistroAsincronoBusI2C(const bus_t *bus, transaccionI2C_t *transaccion, uint8_t reg, uint8_t *buffer, uint16_t longitud,
+		                               callbackTransaccionI2C callback, void *paramUsuario);
+bool escribirBufferRegistroAsincronoBusI2C(const bus_t *bus, transaccionI2C_t *transaccion, uint8_t reg, uint8_t *buffer, uint16_t longitud,
+		                                   callbackTransaccionI2C callback, void *paramUsuario);
+
 #endif // __BUS_H
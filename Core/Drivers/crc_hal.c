@@ -0,0 +1,132 @@
+/***************************************************************************************
+**  crc_hal.c - Unidad CRC del STM32F7
+**
+**
+**  Este fichero forma parte del proyecto URpilot.
+**  Codigo desarrollado por el grupo de investigacion ICON de la Universidad de La Rioja
+**
+**  Autor: Ramon Rico
+**  Fecha de creacion: 17/10/2026
+**  Fecha de modificacion: 17/10/2026
+**
+**  El proyecto URpilot NO es libre. No se puede distribuir y/o modificar este fichero
+**  bajo ningun concepto.
+**
+**  En caso de modificacion y/o solicitud de informacion pongase en contacto con
+**  el grupo de investigacion ICON a traves de: www.unirioja.es/urpilot
+**
+**
+**  Control de versiones del fichero
+**
+**  v1.0  Ramon Rico. Se ha liberado la primera version estable
+**
+****************************************************************************************/
+
+/***************************************************************************************
+** AREA DE INCLUDES                                                                   **
+****************************************************************************************/
+#include <string.h>
+
+#include "Comun/crc.h"
+#include "Sistema/plataforma.h"
+
+#ifdef USAR_CRC_HW
+
+
+/***************************************************************************************
+** AREA DE PREPROCESADOR                                                              **
+****************************************************************************************/
+
+
+/***************************************************************************************
+** AREA DE DEFINICION DE TIPOS                                                        **
+****************************************************************************************/
+
+
+/***************************************************************************************
+** AREA DE DECLARACION DE VARIABLES                                                   **
+****************************************************************************************/
+
+
+/***************************************************************************************
+** AREA DE PROTOTIPOS DE FUNCION                                                      **
+****************************************************************************************/
+
+
+/***************************************************************************************
+** AREA DE DEFINICION DE FUNCIONES                                                    **
+****************************************************************************************/
+
+/***************************************************************************************
+**  Nombre:         void iniciarCRChardware(void)
+**  Descripcion:    Habilita el reloj de la unidad CRC
+**  Parametros:     Ninguno
+**  Retorno:        Ninguno
+****************************************************************************************/
+void iniciarCRChardware(void)
+{
+    __HAL_RCC_CRC_CLK_ENABLE();
+}
+
+
+/***************************************************************************************
+**  Nombre:         uint32_t calcularCRChardware(const configCRChardware_t *config, uint32_t valorInicial,
+**                                               const uint8_t *dato, uint32_t longitud)
+**  Descripcion:    Calcula el CRC de un bloque con la unidad CRC. Se escriben palabras de 32
+**                  bits y los bytes sueltos del final. La unidad desplaza siempre hacia la
+**                  izquierda: las palabras se giran para que el primer byte entre primero
+**  Parametros:     Configuracion, valor inicial del registro, datos, longitud
+**  Retorno:        Registro de datos de la unidad
+****************************************************************************************/
+CODIGO_RAPIDO uint32_t calcularCRChardware(const configCRChardware_t *config, uint32_t valorInicial, const uint8_t *dato, uint32_t longitud)
+{
+    uint32_t cr, mascara;
+
+    switch (config->bits) {
+        case 8:
+            cr = CRC_CR_POLYSIZE_1;
+            mascara = 0xFF;
+            break;
+
+        case 16:
+            cr = CRC_CR_POLYSIZE_0;
+            mascara = 0xFFFF;
+            break;
+
+        default:
+            cr = 0;
+            mascara = 0xFFFFFFFF;
+            break;
+    }
+
+    // Reflejado: se invierten los bits de la palabra entera para que el bit 0 del primer byte
+    // quede arriba. En los bytes sueltos se invierte byte a byte
+    if (config->reflejado)
+        cr |= CRC_CR_REV_IN_0 | CRC_CR_REV_IN_1 | CRC_CR_REV_OUT;
+
+    CRC->POL = config->polinomio;
+    CRC->INIT = valorInicial;
+    CRC->CR = cr | CRC_CR_RESET;
+
+    while (longitud >= 4) {
+        uint32_t palabra;
+
+        memcpy(&palabra, dato, sizeof(palabra));
+        CRC->DR = config->reflejado ? palabra : __REV(palabra);
+        dato += 4;
+        longitud -= 4;
+    }
+
+    if (config->reflejado)
+        CRC->CR = (cr & ~CRC_CR_REV_IN) | CRC_CR_REV_IN_0;
+
+    while (longitud > 0) {
+        *(__IO uint8_t *)&CRC->DR = *dato;
+        dato++;
+        longitud--;
+    }
+
+    return CRC->DR & mascara;
+}
+
+#endif
@@ -7,7 +7,7 @@
 **
 **  Autor: Ramon Rico
 **  Fecha de creacion: 10/05/2019
-**  Fecha de modificacion: 03/08/2020
+**  Fecha de modificacion: 17/10/2026
 **
 **  El proyecto URpilot NO es libre. No se puede distribuir y/o modificar este fichero
 **  bajo ningun concepto.
@@ -93,34 +93,83 @@ void habilitarRelojDMA(uint8_t indice);
 ****************************************************************************************/
 
 /***************************************************************************************
-**  Nombre:         void iniciarDMA(identificadorDMA_e identificador)
-**  Descripcion:    Inicia el DMA
-**  Parametros:     Identificador
-**  Retorno:        Ninguno
+**  Nombre:         bool iniciarDMA(identificadorDMA_e identificador, propietarioDMA_e propietario, uint8_t indicePropietario)
+**  Descripcion:    Reserva el stream para un propietario e inicia el DMA. Los motores, los
+**                  buses y las UART comparten streams segun el mapa de peticiones del micro
+**  Parametros:     Identificador, tipo de propietario, indice del propietario (numero de UART, motor...)
+**  Retorno:        False si el stream no existe o lo usa otro propietario
 ****************************************************************************************/
-void iniciarDMA(identificadorDMA_e identificador)
+bool iniciarDMA(identificadorDMA_e identificador, propietarioDMA_e propietario, uint8_t indicePropietario)
 {
+    if (identificador == DMA_NINGUNO || identificador > DMA_ULTIMO_HANDLER)
+        return false;
+
     const uint8_t indice = IDENTIFICADOR_A_INDICE_DMA(identificador);
+    descriptorCanalDMA_t *descriptor = &descriptorDMA[indice];
+
+    if (descriptor->propietario != DMA_PROPIETARIO_LIBRE &&
+        (descriptor->propietario != propietario || descriptor->indicePropietario != indicePropietario))
+        return false;
+
+    descriptor->propietario = propietario;
+    descriptor->indicePropietario = indicePropietario;
     habilitarRelojDMA(indice);
+
+    return true;
 }
 
 
 /***************************************************************************************
-**  Nombre:         void ajustarHandlerDMA(identificadorDMA_e identificador, callbackHandlerFuncPtrDMA callback, uint32_t prioridad, uint32_t parametros)
-**  Descripcion:    Ajusta el handler del DMA
-**  Parametros:     Identificador, callback, prioridad, parametros
+**  Nombre:         void liberarDMA(identificadorDMA_e identificador)
+**  Descripcion:    Libera el stream y quita su handler
+**  Parametros:     Identificador
 **  Retorno:        Ninguno
 ****************************************************************************************/
-void ajustarHandlerDMA(identificadorDMA_e identificador, callbackHandlerFuncPtrDMA callback, uint32_t prioridad, uint32_t parametros)
+void liberarDMA(identificadorDMA_e identificador)
 {
+    if (identificador == DMA_NINGUNO || identificador > DMA_ULTIMO_HANDLER)
+        return;
+
+    descriptorCanalDMA_t *descriptor = &descriptorDMA[IDENTIFICADOR_A_INDICE_DMA(identificador)];
+
+    HAL_NVIC_DisableIRQ(descriptor->irqN);
+    descriptor->irqHandlerCallback = NULL;
+    descriptor->paramUsuario = 0;
+    descriptor->propietario = DMA_PROPIETARIO_LIBRE;
+    descriptor->indicePropietario = 0;
+}
+
+
+/***************************************************************************************
+**  Nombre:         bool ajustarHandlerDMA(identificadorDMA_e identificador, callbackHandlerFuncPtrDMA callback, uint32_t prioridad, uint32_t parametros)
+**  Descripcion:    Ajusta el handler del DMA. El stream tiene que estar reservado con iniciarDMA
+**                  y no se sobreescribe el handler que haya puesto otro driver
+**  Parametros:     Identificador, callback, prioridad, parametros
+**  Retorno:        False si el stream no esta reservado o ya tiene otro handler
+****************************************************************************************/
+bool ajustarHandlerDMA(identificadorDMA_e identificador, callbackHandlerFuncPtrDMA callback, uint32_t prioridad, uint32_t parametros)
+{
+    if (identificador == DMA_NINGUNO || identificador > DMA_ULTIMO_HANDLER)
+        return false;
+
     const uint8_t indice = IDENTIFICADOR_A_INDICE_DMA(identificador);
+    descriptorCanalDMA_t *descriptor = &descriptorDMA[indice];
+
+    if (descriptor->propietario == DMA_PROPIETARIO_LIBRE)
+        return false;
+
+    if (descriptor->irqHandlerCallback != NULL &&
+        (descriptor->irqHandlerCallback != callback || descriptor->paramUsuario != parametros))
+        return false;
 
     habilitarRelojDMA(indice);
-    descriptorDMA[indice].irqHandlerCallback = callback;
-    descriptorDMA[indice].paramUsuario = parametros;
+    descriptor->irqHandlerCallback = callback;
+    descriptor->paramUsuario = parametros;
+
+    HAL_NVIC_SetPriority(descriptor->irqN, PRIORIDAD_BASE_NVIC(prioridad), PRIORIDAD_SUB_NVIC(prioridad));
+    HAL_NVIC_EnableIRQ(descriptor->irqN);
 
-    HAL_NVIC_SetPriority(descriptorDMA[indice].irqN, PRIORIDAD_BASE_NVIC(prioridad), PRIORIDAD_SUB_NVIC(prioridad));
-    HAL_NVIC_EnableIRQ(descriptorDMA[indice].irqN);
+    return true;
 }
 
 
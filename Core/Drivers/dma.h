@@ -7,7 +7,7 @@
 **
 **  Autor: Ramon Rico
 **  Fecha de creacion: 10/05/2019
-**  Fecha de modificacion: 03/08/2020
+**  Fecha de modificacion: 17/10/2026
 **
 **  El proyecto URpilot NO es libre. No se puede distribuir y/o modificar este fichero
 **  bajo ningun concepto.
@@ -47,6 +47,8 @@
     .flagsShift = f,                    \
     .irqN = d ## _Stream ## s ## _IRQn, \
     .paramUsuario = 0,                  \
+    .propietario = DMA_PROPIETARIO_LIBRE, \
+    .indicePropietario = 0,             \
     }
 
 #define DEFINIR_IRQ_HANDLER_DMA(d, s, i) void DMA ## d ## _Stream ## s ## _IRQHandler(void) { \
@@ -68,6 +70,19 @@
 /***************************************************************************************
 ** AREA DE DEFINICION DE TIPOS                                                        **
 ****************************************************************************************/
+// Cada stream solo puede tener un propietario. El que llega despues no lo puede usar
+typedef enum {
+    DMA_PROPIETARIO_LIBRE = 0,
+    DMA_PROPIETARIO_MOTOR,
+    DMA_PROPIETARIO_SPI_TX,
+    DMA_PROPIETARIO_SPI_RX,
+    DMA_PROPIETARIO_UART_TX,
+    DMA_PROPIETARIO_UART_RX,
+    DMA_PROPIETARIO_ADC,
+    DMA_PROPIETARIO_SDMMC_TX,
+    DMA_PROPIETARIO_SDMMC_RX,
+} propietarioDMA_e;
+
 struct descriptorCanalDMA_s;
 typedef void (*callbackHandlerFuncPtrDMA)(struct descriptorCanalDMA_s *descriptorCanal);
 
@@ -80,6 +95,8 @@ typedef struct descriptorCanalDMA_s{
     IRQn_Type irqN;
     uint32_t paramUsuario;
     uint32_t completeFlag;
+    propietarioDMA_e propietario;
+    uint8_t indicePropietario;
 } descriptorCanalDMA_t;
 
 typedef enum {
@@ -117,8 +134,9 @@ typedef struct {
 /***************************************************************************************
 ** AREA DE PROTOTIPOS DE FUNCION                                                      **
 ****************************************************************************************/
-void iniciarDMA(identificadorDMA_e identificador);
-void ajustarHandlerDMA(identificadorDMA_e identifier, callbackHandlerFuncPtrDMA callback, uint32_t prioridad, uint32_t parametros);
+bool iniciarDMA(identificadorDMA_e identificador, propietarioDMA_e propietario, uint8_t indicePropietario);
+void liberarDMA(identificadorDMA_e identificador);
+bool ajustarHandlerDMA(identificadorDMA_e identificador, callbackHandlerFuncPtrDMA callback, uint32_t prioridad, uint32_t parametros);
 identificadorDMA_e identificadorDMA(const DMA_Stream_TypeDef* stream);
 
 #endif // __DMA_H
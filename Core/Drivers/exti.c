@@ -0,0 +1,250 @@
+/***************************************************************************************
+**  exti.c - Gestion de las interrupciones externas de los pines
+**
+**
+**  Este fichero forma parte del proyecto URpilot.
+**  Codigo desarrollado por el grupo de investigacion ICON de la Universidad de La Rioja
+**
+**  Autor: Ramon Rico
+**  Fecha de creacion: 17/10/2026
+**  Fecha de modificacion: 17/10/2026
+**
+**  El proyecto URpilot NO es libre. No se puede distribuir y/o modificar este fichero
+**  bajo ningun concepto.
+**
+**  En caso de modificacion y/o solicitud de informacion pongase en contacto con
+**  el grupo de investigacion ICON a traves de: www.unirioja.es/urpilot
+**
+**
+**  Control de versiones del fichero
+**
+**  v1.0  Ramon Rico. Se ha liberado la primera version estable
+**
+****************************************************************************************/
+
+/***************************************************************************************
+** AREA DE INCLUDES                                                                   **
+****************************************************************************************/
+#include "exti.h"
+
+#ifdef USAR_EXTI
+#include "io.h"
+#include "nvic.h"
+
+
+/***************************************************************************************
+** AREA DE PREPROCESADOR                                                              **
+****************************************************************************************/
+#define LINEA_EXTI(tag)          ((tag) & 0x0F)
+#define PUERTO_EXTI(tag)         ((((tag) & 0xF0) >> 4) - 1)
+
+
+/***************************************************************************************
+** AREA DE DEFINICION DE TIPOS                                                        **
+****************************************************************************************/
+typedef struct {
+    callbackEXTI callback;
+    uint32_t paramUsuario;
+    uint8_t tag;
+} lineaEXTI_t;
+
+
+/***************************************************************************************
+** AREA DE DECLARACION DE VARIABLES                                                   **
+****************************************************************************************/
+static lineaEXTI_t lineaEXTI[NUM_LINEAS_EXTI];
+
+static const IRQn_Type irqLineaEXTI[NUM_LINEAS_EXTI] = {
+    EXTI0_IRQn, EXTI1_IRQn, EXTI2_IRQn, EXTI3_IRQn, EXTI4_IRQn,
+    EXTI9_5_IRQn, EXTI9_5_IRQn, EXTI9_5_IRQn, EXTI9_5_IRQn, EXTI9_5_IRQn,
+    EXTI15_10_IRQn, EXTI15_10_IRQn, EXTI15_10_IRQn, EXTI15_10_IRQn, EXTI15_10_IRQn, EXTI15_10_IRQn,
+};
+
+
+/***************************************************************************************
+** AREA DE PROTOTIPOS DE FUNCION                                                      **
+****************************************************************************************/
+void handlerIrqEXTI(uint32_t mascara);
+
+
+/***************************************************************************************
+** AREA DE DEFINICION DE FUNCIONES                                                    **
+****************************************************************************************/
+
+/***************************************************************************************
+**  Nombre:         bool configurarEXTI(uint8_t tag, flancoEXTI_e flanco, uint32_t prioridad, callbackEXTI callback, uint32_t paramUsuario)
+**  Descripcion:    Configura el pin como entrada y asigna el callback a su linea EXTI. La
+**                  interrupcion queda deshabilitada hasta llamar a habilitarEXTI
+**  Parametros:     Tag del pin, flanco de disparo, prioridad, callback, parametro del callback
+**  Retorno:        True si ok
+****************************************************************************************/
+bool configurarEXTI(uint8_t tag, flancoEXTI_e flanco, uint32_t prioridad, callbackEXTI callback, uint32_t paramUsuario)
+{
+    if (TAG_VACIO(tag) || callback == NULL)
+        return false;
+
+    const uint8_t linea = LINEA_EXTI(tag);
+    const uint32_t mascara = 1 << linea;
+
+    // Cada linea solo puede estar conectada a un puerto
+    if (lineaEXTI[linea].callback != NULL && lineaEXTI[linea].tag != tag)
+        return false;
+
+    configurarIO(tag, CONFIG_IO(GPIO_MODE_INPUT, GPIO_SPEED_FREQ_LOW, GPIO_NOPULL), 0);
+
+    EXTI->IMR &= ~mascara;
+    lineaEXTI[linea].callback = callback;
+    lineaEXTI[linea].paramUsuario = paramUsuario;
+    lineaEXTI[linea].tag = tag;
+
+    // Conexion del puerto a la linea
+    __HAL_RCC_SYSCFG_CLK_ENABLE();
+    MODIFY_REG(SYSCFG->EXTICR[linea >> 2], 0x0F << (4 * (linea & 0x03)), PUERTO_EXTI(tag) << (4 * (linea & 0x03)));
+
+    if (flanco == FLANCO_SUBIDA_EXTI || flanco == FLANCO_AMBOS_EXTI)
+        EXTI->RTSR |= mascara;
+    else
+        EXTI->RTSR &= ~mascara;
+
+    if (flanco == FLANCO_BAJADA_EXTI || flanco == FLANCO_AMBOS_EXTI)
+        EXTI->FTSR |= mascara;
+    else
+        EXTI->FTSR &= ~mascara;
+
+    EXTI->PR = mascara;
+
+    HAL_NVIC_SetPriority(irqLineaEXTI[linea], PRIORIDAD_BASE_NVIC(prioridad), PRIORIDAD_SUB_NVIC(prioridad));
+    HAL_NVIC_EnableIRQ(irqLineaEXTI[linea]);
+
+    return true;
+}
+
+
+/***************************************************************************************
+**  Nombre:         void habilitarEXTI(uint8_t tag, bool habilitar)
+**  Descripcion:    Habilita o deshabilita la interrupcion de un pin
+**  Parametros:     Tag del pin, habilitacion
+**  Retorno:        Ninguno
+****************************************************************************************/
+void habilitarEXTI(uint8_t tag, bool habilitar)
+{
+    if (TAG_VACIO(tag))
+        return;
+
+    const uint32_t mascara = 1 << LINEA_EXTI(tag);
+
+    if (habilitar) {
+        EXTI->PR = mascara;
+        EXTI->IMR |= mascara;
+    }
+    else
+        EXTI->IMR &= ~mascara;
+}
+
+
+/***************************************************************************************
+**  Nombre:         void handlerIrqEXTI(uint32_t mascara)
+**  Descripcion:    Atiende las lineas pendientes de un vector de interrupcion
+**  Parametros:     Mascara de las lineas del vector
+**  Retorno:        Ninguno
+****************************************************************************************/
+CODIGO_RAPIDO void handlerIrqEXTI(uint32_t mascara)
+{
+    uint32_t pendientes = EXTI->PR & EXTI->IMR & mascara;
+
+    EXTI->PR = pendientes;
+
+    while (pendientes) {
+        const uint8_t linea = __builtin_ctz(pendientes);
+
+        pendientes &= ~(1 << linea);
+        if (lineaEXTI[linea].callback != NULL)
+            lineaEXTI[linea].callback(lineaEXTI[linea].paramUsuario);
+    }
+}
+
+
+/***************************************************************************************
+**  Nombre:         void EXTI0_IRQHandler(void)
+**  Descripcion:    Interrupcion de la linea EXTI 0
+**  Parametros:     Ninguno
+**  Retorno:        Ninguno
+****************************************************************************************/
+CODIGO_RAPIDO void EXTI0_IRQHandler(void)
+{
+    handlerIrqEXTI(0x0001);
+}
+
+
+/***************************************************************************************
+**  Nombre:         void EXTI1_IRQHandler(void)
+**  Descripcion:    Interrupcion de la linea EXTI 1
+**  Parametros:     Ninguno
+**  Retorno:        Ninguno
+****************************************************************************************/
+CODIGO_RAPIDO void EXTI1_IRQHandler(void)
+{
+    handlerIrqEXTI(0x0002);
+}
+
+
+/***************************************************************************************
+**  Nombre:         void EXTI2_IRQHandler(void)
+**  Descripcion:    Interrupcion de la linea EXTI 2
+**  Parametros:     Ninguno
+**  Retorno:        Ninguno
+****************************************************************************************/
+CODIGO_RAPIDO void EXTI2_IRQHandler(void)
+{
+    handlerIrqEXTI(0x0004);
+}
+
+
+/***************************************************************************************
+**  Nombre:         void EXTI3_IRQHandler(void)
+**  Descripcion:    Interrupcion de la linea EXTI 3
+**  Parametros:     Ninguno
+**  Retorno:        Ninguno
+****************************************************************************************/
+CODIGO_RAPIDO void EXTI3_IRQHandler(void)
+{
+    handlerIrqEXTI(0x0008);
+}
+
+
+/***************************************************************************************
+**  Nombre:         void EXTI4_IRQHandler(void)
+**  Descripcion:    Interrupcion de la linea EXTI 4
+**  Parametros:     Ninguno
+**  Retorno:        Ninguno
+****************************************************************************************/
+CODIGO_RAPIDO void EXTI4_IRQHandler(void)
+{
+    handlerIrqEXTI(0x0010);
+}
+
+
+/***************************************************************************************
+**  Nombre:         void EXTI9_5_IRQHandler(void)
+**  Descripcion:    Interrupcion de las lineas EXTI 5 a 9
+**  Parametros:     Ninguno
+**  Retorno:        Ninguno
+****************************************************************************************/
+CODIGO_RAPIDO void EXTI9_5_IRQHandler(void)
+{
+    handlerIrqEXTI(0x03E0);
+}
+
+
+/***************************************************************************************
+**  Nombre:         void EXTI15_10_IRQHandler(void)
+**  Descripcion:    Interrupcion de las lineas EXTI 10 a 15
+**  Parametros:     Ninguno
+**  Retorno:        Ninguno
+****************************************************************************************/
+CODIGO_RAPIDO void EXTI15_10_IRQHandler(void)
+{
+    handlerIrqEXTI(0xFC00);
+}
+
+#endif
@@ -0,0 +1,66 @@
+/***************************************************************************************
+**  exti.h - Gestion de las interrupciones externas de los pines
+**
+**
+**  Este fichero forma parte del proyecto URpilot.
+**  Codigo desarrollado por el grupo de investigacion ICON de la Universidad de La Rioja
+**
+**  Autor: Ramon Rico
+**  Fecha de creacion: 17/10/2026
+**  Fecha de modificacion: 17/10/2026
+**
+**  El proyecto URpilot NO es libre. No se puede distribuir y/o modificar este fichero
+**  bajo ningun concepto.
+**
+**  En caso de modificacion y/o solicitud de informacion pongase en contacto con
+**  el grupo de investigacion ICON a traves de: www.unirioja.es/urpilot
+**
+**
+**  Control de versiones del fichero
+**
+**  v1.0  Ramon Rico. Se ha liberado la primera version estable
+**
+****************************************************************************************/
+
+#ifndef __EXTI_H
+#define __EXTI_H
+
+/***************************************************************************************
+** AREA DE INCLUDES                                                                   **
+****************************************************************************************/
+#include <stdint.h>
+#include <stdbool.h>
+
+#include "Sistema/plataforma.h"
+
+
+/***************************************************************************************
+** AREA DE PREPROCESADOR                                                              **
+****************************************************************************************/
+#define NUM_LINEAS_EXTI          16
+
+
+/***************************************************************************************
+** AREA DE DEFINICION DE TIPOS                                                        **
+****************************************************************************************/
+typedef enum {
+    FLANCO_SUBIDA_EXTI = 0,
+    FLANCO_BAJADA_EXTI,
+    FLANCO_AMBOS_EXTI,
+} flancoEXTI_e;
+
+typedef void (*callbackEXTI)(uint32_t paramUsuario);
+
+
+/***************************************************************************************
+** AREA DE DECLARACION DE VARIABLES                                                   **
+****************************************************************************************/
+
+
+/***************************************************************************************
+** AREA DE PROTOTIPOS DE FUNCION                                                      **
+****************************************************************************************/
+bool configurarEXTI(uint8_t tag, flancoEXTI_e flanco, uint32_t prioridad, callbackEXTI callback, uint32_t paramUsuario);
+void habilitarEXTI(uint8_t tag, bool habilitar);
+
+#endif // __EXTI_H
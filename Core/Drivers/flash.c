@@ -1,6 +1,6 @@
 /***************************************************************************************
-**  flash.c - Funciones para la gestion de la flash y en concreto las funciones para
-**            grabar la configuracion en la flash
+**  flash.c - Funciones para la gestion de la flash: borrado de sectores y programacion
+**            por words
 **
 **
 **  Este fichero forma parte del proyecto URpilot.
@@ -8,7 +8,7 @@
 **
 **  Autor: Ramon Rico
 **  Fecha de creacion: 08/05/2019
-**  Fecha de modificacion: 03/08/2020
+**  Fecha de modificacion: 17/10/2026
 **
 **  El proyecto URpilot NO es libre. No se puede distribuir y/o modificar este fichero
 **  bajo ningun concepto.
@@ -30,7 +30,6 @@
 #include <string.h>
 
 #include "flash.h"
-#include "Core/fallo_sistema.h"
 
 
 /***************************************************************************************
@@ -46,6 +45,9 @@
   #endif
 #endif
 
+#define SECTOR_INVALIDO_FLASH               0xFFFFFFFF
+#define TAM_LINEA_CACHE_FLASH               32
+
 
 /***************************************************************************************
 ** AREA DE DEFINICION DE TIPOS                                                        **
@@ -55,14 +57,13 @@
 /***************************************************************************************
 ** AREA DE DECLARACION DE VARIABLES                                                   **
 ****************************************************************************************/
-extern uint8_t inicioRegionConfig;       // Definido en el Linker
 
 
 /***************************************************************************************
 ** AREA DE PROTOTIPOS DE FUNCION                                                      **
 ****************************************************************************************/
-uint32_t sectorParaConfigGrabadorFlash(void);
-int32_t escribirWordGrabadorFlash(grabadorFlash_t *grabador, uint32_t valor);
+uint32_t sectorFlash(uintptr_t dir);
+void invalidarCacheFlash(uintptr_t dir, uint32_t tam);
 
 
 /***************************************************************************************
@@ -70,98 +71,82 @@ int32_t escribirWordGrabadorFlash(grabadorFlash_t *grabador, uint32_t valor);
 ****************************************************************************************/
 
 /***************************************************************************************
-**  Nombre:         void resetearGrabadorFlash(grabadorFlash_t *grabador)
-**  Descripcion:    Resetea el grabador
-**  Parametros:     Grabador
-**  Retorno:        Ninguno
+**  Nombre:         bool borrarFlash(uintptr_t dir, uint32_t tam)
+**  Descripcion:    Borra los sectores que contienen el rango. Los sectores grandes se
+**                  recorren en pasos de pagina y solo se borran una vez
+**  Parametros:     Direccion de inicio, tamanio en bytes
+**  Retorno:        True si ok
 ****************************************************************************************/
-void resetearGrabadorFlash(grabadorFlash_t *grabador)
+bool borrarFlash(uintptr_t dir, uint32_t tam)
 {
-    memset(grabador, 0, sizeof(*grabador));
-}
+    FLASH_EraseInitTypeDef inicioBorrado = {
+        .TypeErase = FLASH_TYPEERASE_SECTORS,
+        .VoltageRange = FLASH_VOLTAGE_RANGE_3,     // 2.7-3.6V
+        .NbSectors = 1
+    };
+    uint32_t sectorAnterior = SECTOR_INVALIDO_FLASH;
+    bool estado = true;
 
+    HAL_FLASH_Unlock();
 
-/***************************************************************************************
-**  Nombre:         int32_t estadoGrabadorFlash(grabadorFlash_t *grabador)
-**  Descripcion:    Devuelve el estado del grabador
-**  Parametros:     grabador
-**  Retorno:        Codigo de error: 0 no error, -1 fallo en el borrado, -2 Fallo al grabar
-****************************************************************************************/
-int32_t estadoGrabadorFlash(grabadorFlash_t *grabador)
-{
-    return grabador->err;
-}
-
+    for (uintptr_t pagina = dir - dir % FLASH_PAGE_SIZE; pagina < dir + tam && estado; pagina += FLASH_PAGE_SIZE) {
+        const uint32_t sector = sectorFlash(pagina);
+        if (sector == sectorAnterior)
+            continue;
 
-/***************************************************************************************
-**  Nombre:         void desbloquearGrabadorFlash(grabadorFlash_t *grabador, uintptr_t base, int32_t tam)
-**  Descripcion:    Inicia el grabador ajustando la direccion y el tamanio
-**  Parametros:     Grabador, direccion base, tamanio
-**  Retorno:        Ninguno
-****************************************************************************************/
-void desbloquearGrabadorFlash(grabadorFlash_t *grabador, uintptr_t base, int32_t tam)
-{
-    grabador->dir = base;
-    grabador->tam = tam;
-    if (!grabador->desbloqueado) {
-        HAL_FLASH_Unlock();
-        grabador->desbloqueado = true;
+        uint32_t errorSector;
+        inicioBorrado.Sector = sector;
+        estado = sector != SECTOR_INVALIDO_FLASH && HAL_FLASHEx_Erase(&inicioBorrado, &errorSector) == HAL_OK;
+        sectorAnterior = sector;
     }
 
-    grabador->err = 0;
+    HAL_FLASH_Lock();
+    invalidarCacheFlash(dir, tam);
+    return estado;
 }
 
 
 /***************************************************************************************
-**  Nombre:         int32_t bloquearGrabadorFlash(grabadorFlash_t *grabador)
-**  Descripcion:    Bloquea el grabador y la flash
-**  Parametros:     grabador
-**  Retorno:        Codigo de error: 0 no error, -1 fallo en el borrado, -2 Fallo al grabar
+**  Nombre:         bool programarFlash(uintptr_t dir, const void *datos, uint32_t tam)
+**  Descripcion:    Programa un buffer word a word. Solo se pueden pasar bits de 1 a 0
+**  Parametros:     Direccion de inicio y tamanio, ambos multiplos de 4, datos
+**  Retorno:        True si ok
 ****************************************************************************************/
-int32_t bloquearGrabadorFlash(grabadorFlash_t *grabador)
+bool programarFlash(uintptr_t dir, const void *datos, uint32_t tam)
 {
-    if (grabador->desbloqueado) {
-        HAL_FLASH_Lock();
-        grabador->desbloqueado = false;
-    }
-    return grabador->err;
-}
+    const uint8_t *p = datos;
+    bool estado = true;
 
+    if (dir % sizeof(uint32_t) != 0 || tam % sizeof(uint32_t) != 0)
+        return false;
 
-/***************************************************************************************
-**  Nombre:         int32_t escribirGrabadorFlash(grabadorFlash_t *grabador, const uint8_t *p, uint32_t tam)
-**  Descripcion:    Graba un buffer en la flash
-**  Parametros:     grabador, buffer a grabar, numero de datos
-**  Retorno:        Codigo de error: 0 no error, -1 fallo en el borrado, -2 Fallo al grabar
-****************************************************************************************/
-int32_t escribirGrabadorFlash(grabadorFlash_t *grabador, const uint8_t *p, uint32_t tam)
-{
-    for (const uint8_t *pat = p; pat != (uint8_t*)p + tam; pat++) {
-        grabador->buffer.b[grabador->at++] = *pat;
+    HAL_FLASH_Unlock();
 
-        if (grabador->at == sizeof(grabador->buffer)) {
-            grabador->err = escribirWordGrabadorFlash(grabador, grabador->buffer.w);
-            grabador->at = 0;
-        }
+    for (uint32_t i = 0; i < tam && estado; i += sizeof(uint32_t)) {
+        uint32_t valor;
+
+        memcpy(&valor, &p[i], sizeof(valor));
+        estado = HAL_FLASH_Program(FLASH_TYPEPROGRAM_WORD, dir + i, valor) == HAL_OK;
     }
-    return grabador->err;
+
+    HAL_FLASH_Lock();
+    invalidarCacheFlash(dir, tam);
+    return estado;
 }
 
 
 /***************************************************************************************
-**  Nombre:         int32_t flushGrabadorFlash(grabadorFlash_t *grabador)
-**  Descripcion:    Hace un flush en la flash
-**  Parametros:     grabador
-**  Retorno:        Codigo de error: 0 no error, -1 fallo en el borrado, -2 Fallo al grabar
+**  Nombre:         void invalidarCacheFlash(uintptr_t dir, uint32_t tam)
+**  Descripcion:    Invalida las lineas de la cache de datos del rango modificado para que
+**                  las lecturas posteriores vean la flash
+**  Parametros:     Direccion de inicio, tamanio en bytes
+**  Retorno:        Ninguno
 ****************************************************************************************/
-int32_t flushGrabadorFlash(grabadorFlash_t *grabador)
+void invalidarCacheFlash(uintptr_t dir, uint32_t tam)
 {
-    if (grabador->at != 0) {
-        memset(grabador->buffer.b + grabador->at, 0, sizeof(grabador->buffer) - grabador->at);
-        grabador->err = escribirWordGrabadorFlash(grabador, grabador->buffer.w);
-        grabador->at = 0;
-    }
-    return grabador-> err;
+    const uintptr_t inicio = dir & ~(uintptr_t)(TAM_LINEA_CACHE_FLASH - 1);
+
+    SCB_InvalidateDCache_by_Addr((uint32_t *)inicio, (int32_t)(tam + (dir - inicio)));
 }
 
 
@@ -183,43 +168,39 @@ Sector 10   0x08180000 - 0x081BFFFF 256 Kbytes
 Sector 11   0x081C0000 - 0x081FFFFF 256 Kbytes
 */
 /***************************************************************************************
-**  Nombre:         uint32_t sectorParaConfigGrabadorFlash(void)
-**  Descripcion:    Obtiene el sector de la flash
-**  Parametros:     Ninguno
-**  Retorno:        Sector de la flash
+**  Nombre:         uint32_t sectorFlash(uintptr_t dir)
+**  Descripcion:    Obtiene el sector de la flash que contiene una direccion
+**  Parametros:     Direccion
+**  Retorno:        Sector de la flash o SECTOR_INVALIDO_FLASH
 ****************************************************************************************/
-uint32_t sectorParaConfigGrabadorFlash(void)
+uint32_t sectorFlash(uintptr_t dir)
 {
-    if ((uint32_t)&inicioRegionConfig <= 0x08007FFF)
+    if (dir <= 0x08007FFF)
         return FLASH_SECTOR_0;
-    if ((uint32_t)&inicioRegionConfig <= 0x0800FFFF)
+    if (dir <= 0x0800FFFF)
         return FLASH_SECTOR_1;
-    if ((uint32_t)&inicioRegionConfig <= 0x08017FFF)
+    if (dir <= 0x08017FFF)
         return FLASH_SECTOR_2;
-    if ((uint32_t)&inicioRegionConfig <= 0x0801FFFF)
+    if (dir <= 0x0801FFFF)
         return FLASH_SECTOR_3;
-    if ((uint32_t)&inicioRegionConfig <= 0x0803FFFF)
+    if (dir <= 0x0803FFFF)
         return FLASH_SECTOR_4;
-    if ((uint32_t)&inicioRegionConfig <= 0x0807FFFF)
+    if (dir <= 0x0807FFFF)
         return FLASH_SECTOR_5;
-    if ((uint32_t)&inicioRegionConfig <= 0x080BFFFF)
+    if (dir <= 0x080BFFFF)
         return FLASH_SECTOR_6;
-    if ((uint32_t)&inicioRegionConfig <= 0x080FFFFF)
+    if (dir <= 0x080FFFFF)
         return FLASH_SECTOR_7;
-    if ((uint32_t)&inicioRegionConfig <= 0x0813FFFF)
+    if (dir <= 0x0813FFFF)
         return FLASH_SECTOR_8;
-    if ((uint32_t)&inicioRegionConfig <= 0x0817FFFF)
+    if (dir <= 0x0817FFFF)
         return FLASH_SECTOR_9;
-    if ((uint32_t)&inicioRegionConfig <= 0x081BFFFF)
+    if (dir <= 0x081BFFFF)
         return FLASH_SECTOR_10;
-    if ((uint32_t)&inicioRegionConfig <= 0x081FFFFF)
+    if (dir <= 0x081FFFFF)
         return FLASH_SECTOR_11;
 
-
-    while (1)
-        falloSistema(FALLO_ESCRITURA_FLASH);
-
-    return FLASH_SECTOR_0;
+    return SECTOR_INVALIDO_FLASH;
 }
 #elif defined(STM32F722xx)
 /*
@@ -233,69 +214,30 @@ Sector 6    0x08040000 - 0x0805FFFF 128 Kbytes
 Sector 7    0x08060000 - 0x0807FFFF 128 Kbytes
 */
 /***************************************************************************************
-**  Nombre:         uint32_t sectorParaConfigGrabadorFlash(void)
-**  Descripcion:    Obtiene el sector de la flash
-**  Parametros:     Ninguno
-**  Retorno:        Sector de la flash
+**  Nombre:         uint32_t sectorFlash(uintptr_t dir)
+**  Descripcion:    Obtiene el sector de la flash que contiene una direccion
+**  Parametros:     Direccion
+**  Retorno:        Sector de la flash o SECTOR_INVALIDO_FLASH
 ****************************************************************************************/
-uint32_t sectorParaConfigGrabadorFlash(void)
+uint32_t sectorFlash(uintptr_t dir)
 {
-    if ((uint32_t)&inicioRegionConfig <= 0x08003FFF)
+    if (dir <= 0x08003FFF)
         return FLASH_SECTOR_0;
-    if ((uint32_t)&inicioRegionConfig <= 0x08007FFF)
+    if (dir <= 0x08007FFF)
         return FLASH_SECTOR_1;
-    if ((uint32_t)&inicioRegionConfig <= 0x0800BFFF)
+    if (dir <= 0x0800BFFF)
         return FLASH_SECTOR_2;
-    if ((uint32_t)&inicioRegionConfig <= 0x0800FFFF)
+    if (dir <= 0x0800FFFF)
         return FLASH_SECTOR_3;
-    if ((uint32_t)&inicioRegionConfig <= 0x0801FFFF)
+    if (dir <= 0x0801FFFF)
         return FLASH_SECTOR_4;
-    if ((uint32_t)&inicioRegionConfig <= 0x0803FFFF)
+    if (dir <= 0x0803FFFF)
         return FLASH_SECTOR_5;
-    if ((uint32_t)&inicioRegionConfig <= 0x0805FFFF)
+    if (dir <= 0x0805FFFF)
         return FLASH_SECTOR_6;
-    if ((uint32_t)&inicioRegionConfig <= 0x0807FFFF)
+    if (dir <= 0x0807FFFF)
         return FLASH_SECTOR_7;
 
-
-    while (1)
-        falloSistema(FALLO_ESCRITURA_FLASH);
-
-    return FLASH_SECTOR_0;
+    return SECTOR_INVALIDO_FLASH;
 }
 #endif
-
-
-/***************************************************************************************
-**  Nombre:         int32_t escribirWordGrabadorFlash(grabadorFlash_t *grabador, uint32_t valor)
-**  Descripcion:    Escribe una word en la flash
-**  Parametros:     grabador, valor a grabar
-**  Retorno:        Codigo de error: 0 no error, -1 fallo en el borrado, -2 Fallo al grabar
-****************************************************************************************/
-int32_t escribirWordGrabadorFlash(grabadorFlash_t *grabador, uint32_t valor)
-{
-    if (grabador->err != 0)
-        return grabador->err;
-
-    if (grabador->dir % FLASH_PAGE_SIZE == 0) {
-        FLASH_EraseInitTypeDef inicioBorrado = {
-            .TypeErase = FLASH_TYPEERASE_SECTORS,
-            .VoltageRange = FLASH_VOLTAGE_RANGE_3,     // 2.7-3.6V
-            .NbSectors = 1
-        };
-        inicioBorrado.Sector = sectorParaConfigGrabadorFlash();
-
-        uint32_t errorSector;
-        const HAL_StatusTypeDef estado = HAL_FLASHEx_Erase(&inicioBorrado, &errorSector);
-        if (estado != HAL_OK)
-            return -1;
-    }
-
-    const HAL_StatusTypeDef estado = HAL_FLASH_Program(FLASH_TYPEPROGRAM_WORD, grabador->dir, valor);
-    if (estado != HAL_OK)
-        return -2;
-
-    grabador->dir += sizeof(valor);
-    return 0;
-}
-
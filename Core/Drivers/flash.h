@@ -1,6 +1,6 @@
 /***************************************************************************************
-**  flash.h - Funciones para la gestion de la flash y en concreto las funciones para
-**            grabar la configuracion en la flash
+**  flash.h - Funciones para la gestion de la flash: borrado de sectores y programacion
+**            por words
 **
 **
 **  Este fichero forma parte del proyecto URpilot.
@@ -8,7 +8,7 @@
 **
 **  Autor: Ramon Rico
 **  Fecha de creacion: 08/05/2019
-**  Fecha de modificacion: 03/08/2020
+**  Fecha de modificacion: 17/10/2026
 **
 **  El proyecto URpilot NO es libre. No se puede distribuir y/o modificar este fichero
 **  bajo ningun concepto.
@@ -38,21 +38,12 @@
 /***************************************************************************************
 ** AREA DE PREPROCESADOR                                                              **
 ****************************************************************************************/
+#define VALOR_BORRADO_FLASH             0xFFFFFFFF
+
 
 /***************************************************************************************
 ** AREA DE DEFINICION DE TIPOS                                                        **
 ****************************************************************************************/
-typedef struct {
-    uintptr_t dir;
-    int32_t tam;
-    union {
-        uint8_t b[4];
-        uint32_t w;
-    } buffer;
-    int32_t at;
-    int32_t err;
-    bool desbloqueado;
-} grabadorFlash_t;
 
 
 /***************************************************************************************
@@ -63,11 +54,7 @@ typedef struct {
 /***************************************************************************************
 ** AREA DE PROTOTIPOS DE FUNCION                                                      **
 ****************************************************************************************/
-void resetearGrabadorFlash(grabadorFlash_t *grabador);
-int32_t estadoGrabadorFlash(grabadorFlash_t *grabador);
-void desbloquearGrabadorFlash(grabadorFlash_t *grabador, uintptr_t base, int32_t tam);
-int32_t bloquearGrabadorFlash(grabadorFlash_t *grabador);
-int32_t escribirGrabadorFlash(grabadorFlash_t *grabador, const uint8_t *p, uint32_t tam);
-int32_t flushGrabadorFlash(grabadorFlash_t *grabador);
+bool borrarFlash(uintptr_t dir, uint32_t tam);
+bool programarFlash(uintptr_t dir, const void *datos, uint32_t tam);
 
 #endif // __FLASH_H
@@ -7,7 +7,7 @@
 **
 **  Autor: Ramon Rico
 **  Fecha de creacion: 12/05/2019
-**  Fecha de modificacion: 03/08/2020
+**  Fecha de modificacion: 17/10/2026
 **
 **  El proyecto URpilot NO es libre. No se puede distribuir y/o modificar este fichero
 **  bajo ningun concepto.
@@ -32,6 +32,7 @@
 
 #ifdef USAR_I2C
 #include "io.h"
+#include "i2c_cola.h"
 
 
 /***************************************************************************************
@@ -90,6 +91,7 @@ bool iniciarI2C(numI2C_e numI2C)
 
 	memset(driver, 0, sizeof(*driver));
     resetearContadorErrorI2C(numI2C);
+    iniciarColaI2C(numI2C);
 	driver->iniciado = false;
 
     if (iniciarDriverI2C(numI2C)) {
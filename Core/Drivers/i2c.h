@@ -7,7 +7,7 @@
 **
 **  Autor: Ramon Rico
 **  Fecha de creacion: 12/05/2019
-**  Fecha de modificacion: 03/08/2020
+**  Fecha de modificacion: 17/10/2026
 **
 **  El proyecto URpilot NO es libre. No se puede distribuir y/o modificar este fichero
 **  bajo ningun concepto.
@@ -62,6 +62,9 @@ typedef enum {
 typedef struct {
     bool asignado;
     I2C_HandleTypeDef hi2c;
+    uint8_t IRQev;
+    uint8_t IRQer;
+    uint8_t prioridadIRQ;
     pin_t pinSCL;
     pin_t pinSDA;
 } halI2C_t;
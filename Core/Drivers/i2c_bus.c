@@ -7,7 +7,7 @@
 **
 **  Autor: Ramon Rico
 **  Fecha de creacion: 12/05/2019
-**  Fecha de modificacion: 03/08/2020
+**  Fecha de modificacion: 17/10/2026
 **
 **  El proyecto URpilot NO es libre. No se puede distribuir y/o modificar este fichero
 **  bajo ningun concepto.
@@ -150,4 +150,32 @@ bool leerBufferRegistroBusI2C(const bus_t *bus, uint8_t reg, uint8_t *datoRx, ui
     return leerBufferMemI2C(bus->bus_u.i2c.numI2C, bus->bus_u.i2c.dir, reg, datoRx, longitud);
 }
 
+
+/***************************************************************************************
+**  Nombre:         void prepararTransaccionRegistroBusI2C(const bus_t *bus, transaccionI2C_t *transaccion, uint8_t reg,
+**                                                         bool lectura, uint8_t *buffer, uint16_t longitud,
+**                                                         callbackTransaccionI2C callback, void *paramUsuario)
+**  Descripcion:    Rellena una transaccion asincrona sobre un registro. El registro se guarda
+**                  en buffer[0] como en el SPI y los datos van a partir de buffer[1]
+**  Parametros:     Bus, transaccion, registro, si es lectura, buffer de longitud + 1 bytes,
+**                  longitud de los datos, callback de fin y parametro del callback
+**  Retorno:        Ninguno
+****************************************************************************************/
+void prepararTransaccionRegistroBusI2C(const bus_t *bus, transaccionI2C_t *transaccion, uint8_t reg, bool lectura, uint8_t *buffer,
+		                               uint16_t longitud, callbackTransaccionI2C callback, void *paramUsuario)
+{
+    buffer[0] = reg;
+
+    transaccion->numI2C = bus->bus_u.i2c.numI2C;
+    transaccion->dir = bus->bus_u.i2c.dir;
+    transaccion->conRegistro = true;
+    transaccion->reg = reg;
+    transaccion->lectura = lectura;
+    transaccion->dato = &buffer[1];
+    transaccion->longitud = longitud;
+    transaccion->timeout = TIMEOUT_DEFECTO_TRANSACCION_I2C;
+    transaccion->callback = callback;
+    transaccion->paramUsuario = paramUsuario;
+}
+
 #endif
@@ -7,7 +7,7 @@
 **
 **  Autor: Ramon Rico
 **  Fecha de creacion: 12/05/2019
-**  Fecha de modificacion: 03/08/2020
+**  Fecha de modificacion: 17/10/2026
 **
 **  El proyecto URpilot NO es libre. No se puede distribuir y/o modificar este fichero
 **  bajo ningun concepto.
@@ -59,5 +59,7 @@ bool escribirBufferRegistroBusI2C(const bus_t *bus, uint8_t reg, uint8_t *datoTx
 bool leerBusI2C(const bus_t *bus, uint8_t *byteRx);
 bool leerRegistroBusI2C(const bus_t *bus, uint8_t reg, uint8_t *byteRx);
 bool leerBufferRegistroBusI2C(const bus_t *bus, uint8_t reg, uint8_t *datoRx, uint16_t longitud);
+void prepararTransaccionRegistroBusI2C(const bus_t *bus, transaccionI2C_t *transaccion, uint8_t reg, bool lectura, uint8_t *buffer,
+		                               uint16_t longitud, callbackTransaccionI2C callback, void *paramUsuario);
 
 #endif // __I2C_BUS_H
@@ -0,0 +1,466 @@
+/***************************************************************************************
+**  i2c_cola.c - Cola de transacciones asincronas del I2C
+**
+**
+**  Este fichero forma parte del proyecto URpilot.
+**  Codigo desarrollado por el grupo de investigacion ICON de la Universidad de La Rioja
+**
+**  Autor: Ramon Rico
+**  Fecha de creacion: 17/10/2026
+**  Fecha de modificacion: 17/10/2026
+**
+**  El proyecto URpilot NO es libre. No se puede distribuir y/o modificar este fichero
+**  bajo ningun concepto.
+**
+**  En caso de modificacion y/o solicitud de informacion pongase en contacto con
+**  el grupo de investigacion ICON a traves de: www.unirioja.es/urpilot
+**
+**
+**  Control de versiones del fichero
+**
+**  v1.0  Ramon Rico. Se ha liberado la primera version estable
+**
+****************************************************************************************/
+
+/***************************************************************************************
+** AREA DE INCLUDES                                                                   **
+****************************************************************************************/
+#include <string.h>
+
+#include "i2c_cola.h"
+
+#ifdef USAR_I2C
+#include "tiempo.h"
+#ifndef SITL
+#include "atomico.h"
+#include "nvic.h"
+#endif
+
+
+/***************************************************************************************
+** AREA DE PREPROCESADOR                                                              **
+****************************************************************************************/
+// La cola se modifica desde el bucle principal y desde las interrupciones del I2C
+#ifdef SITL
+  #define BLOQUE_ATOMICO_COLA_I2C
+#else
+  #define BLOQUE_ATOMICO_COLA_I2C   BLOQUE_ATOMICO(NVIC_PRIO_I2C)
+#endif
+
+
+/***************************************************************************************
+** AREA DE DEFINICION DE TIPOS                                                        **
+****************************************************************************************/
+typedef struct {
+    transaccionI2C_t *actual;               // Transaccion en el bus
+    transaccionI2C_t *primera;              // Transacciones pendientes
+    transaccionI2C_t *ultima;
+    uint8_t longitud;
+    bool recuperacionPendiente;             // El bus ha quedado bloqueado tras un error
+    estadisticasColaI2C_t estadisticas;
+    uint8_t numDispositivos;
+    estadisticasDispositivoI2C_t dispositivo[NUM_MAX_DISPOSITIVOS_I2C];
+} colaI2C_t;
+
+
+/***************************************************************************************
+** AREA DE DECLARACION DE VARIABLES                                                   **
+****************************************************************************************/
+static colaI2C_t colaI2C[NUM_MAX_I2C];
+
+
+/***************************************************************************************
+** AREA DE PROTOTIPOS DE FUNCION                                                      **
+****************************************************************************************/
+void anadirTransaccionColaI2C(colaI2C_t *cola, transaccionI2C_t *transaccion);
+void arrancarSiguienteTransaccionI2C(numI2C_e numI2C);
+void terminarTransaccionI2C(numI2C_e numI2C, estadoTransaccionI2C_e estado);
+void recuperarBusColaI2C(numI2C_e numI2C);
+estadisticasDispositivoI2C_t *dispositivoColaI2C(colaI2C_t *cola, uint8_t dir);
+
+
+/***************************************************************************************
+** AREA DE DEFINICION DE FUNCIONES                                                    **
+****************************************************************************************/
+
+/***************************************************************************************
+**  Nombre:         void iniciarColaI2C(numI2C_e numI2C)
+**  Descripcion:    Vacia la cola de un bus y borra sus estadisticas
+**  Parametros:     Numero del I2C
+**  Retorno:        Ninguno
+****************************************************************************************/
+void iniciarColaI2C(numI2C_e numI2C)
+{
+    if (numI2C == I2C_NINGUNO)
+        return;
+
+    memset(&colaI2C[numI2C], 0, sizeof(colaI2C[numI2C]));
+}
+
+
+/***************************************************************************************
+**  Nombre:         bool encolarTransaccionI2C(transaccionI2C_t *transaccion)
+**  Descripcion:    Anade una transaccion al final de la cola de su bus. Si el bus esta
+**                  libre la transferencia empieza en el momento
+**  Parametros:     Transaccion
+**  Retorno:        False si la transaccion no es valida o todavia no ha terminado
+****************************************************************************************/
+bool encolarTransaccionI2C(transaccionI2C_t *transaccion)
+{
+    return encolarCadenaTransaccionesI2C(transaccion, 1);
+}
+
+
+/***************************************************************************************
+**  Nombre:         bool encolarCadenaTransaccionesI2C(transaccionI2C_t *transaccion, uint8_t numTransacciones)
+**  Descripcion:    Anade varias transacciones seguidas. Se ejecutan en orden sin que se
+**                  intercale ninguna otra del mismo bus encolada despues
+**  Parametros:     Array de transacciones, numero de transacciones
+**  Retorno:        False si alguna transaccion no es valida. En ese caso no se encola ninguna
+****************************************************************************************/
+bool encolarCadenaTransaccionesI2C(transaccionI2C_t *transaccion, uint8_t numTransacciones)
+{
+    for (uint8_t i = 0; i < numTransacciones; i++) {
+        const transaccionI2C_t *t = &transaccion[i];
+
+        if (t->numI2C == I2C_NINGUNO || t->numI2C >= NUM_MAX_I2C || (t->longitud == 0 && (t->lectura || !t->conRegistro)) ||
+            t->estado == TRANSACCION_I2C_EN_COLA || t->estado == TRANSACCION_I2C_EN_CURSO)
+            return false;
+    }
+
+    if (numTransacciones == 0)
+        return true;
+
+    // Una transferencia colgada o un bus bloqueado no deben parar las nuevas
+    comprobarTimeoutColaI2C(transaccion[0].numI2C, micros());
+
+    BLOQUE_ATOMICO_COLA_I2C {
+        for (uint8_t i = 0; i < numTransacciones; i++) {
+            transaccion[i].numReintentos = 0;
+            anadirTransaccionColaI2C(&colaI2C[transaccion[i].numI2C], &transaccion[i]);
+        }
+
+        for (uint8_t i = 0; i < numTransacciones; i++)
+            arrancarSiguienteTransaccionI2C(transaccion[i].numI2C);
+    }
+
+    return true;
+}
+
+
+/***************************************************************************************
+**  Nombre:         void anadirTransaccionColaI2C(colaI2C_t *cola, transaccionI2C_t *transaccion)
+**  Descripcion:    Anade una transaccion al final de la lista de pendientes
+**  Parametros:     Cola, transaccion
+**  Retorno:        Ninguno
+****************************************************************************************/
+void anadirTransaccionColaI2C(colaI2C_t *cola, transaccionI2C_t *transaccion)
+{
+    transaccion->siguiente = NULL;
+    transaccion->estado = TRANSACCION_I2C_EN_COLA;
+
+    if (cola->ultima != NULL)
+        cola->ultima->siguiente = transaccion;
+    else
+        cola->primera = transaccion;
+
+    cola->ultima = transaccion;
+    cola->longitud++;
+
+    if (cola->longitud > cola->estadisticas.longitudMaxCola)
+        cola->estadisticas.longitudMaxCola = cola->longitud;
+}
+
+
+/***************************************************************************************
+**  Nombre:         void arrancarSiguienteTransaccionI2C(numI2C_e numI2C)
+**  Descripcion:    Si el bus esta libre lanza la transferencia de la primera transaccion
+**                  pendiente. Se llama con la cola bloqueada o desde la interrupcion
+**  Parametros:     Numero del I2C
+**  Retorno:        Ninguno
+****************************************************************************************/
+void arrancarSiguienteTransaccionI2C(numI2C_e numI2C)
+{
+    colaI2C_t *cola = &colaI2C[numI2C];
+
+    // Con el bus bloqueado se espera a la recuperacion, que se hace fuera de la interrupcion
+    while (!cola->recuperacionPendiente && cola->actual == NULL && cola->primera != NULL) {
+        transaccionI2C_t *transaccion = cola->primera;
+
+        cola->primera = transaccion->siguiente;
+        if (cola->primera == NULL)
+            cola->ultima = NULL;
+
+        cola->longitud--;
+        cola->actual = transaccion;
+
+        transaccion->estado = TRANSACCION_I2C_EN_CURSO;
+        transaccion->tiempoInicio = micros();
+
+        // Si el HAL no acepta la transferencia el bus esta ocupado por un esclavo o el
+        // periferico ha perdido el estado
+        if (!iniciarTransferenciaAsincronaI2C(numI2C, transaccion)) {
+            cola->recuperacionPendiente = true;
+            terminarTransaccionI2C(numI2C, TRANSACCION_I2C_ERROR);
+        }
+    }
+}
+
+
+/***************************************************************************************
+**  Nombre:         estadisticasDispositivoI2C_t *dispositivoColaI2C(colaI2C_t *cola, uint8_t dir)
+**  Descripcion:    Busca las estadisticas de un dispositivo. Si es nuevo le asigna una entrada
+**  Parametros:     Cola, direccion del dispositivo
+**  Retorno:        Estadisticas o NULL si la tabla esta llena
+****************************************************************************************/
+estadisticasDispositivoI2C_t *dispositivoColaI2C(colaI2C_t *cola, uint8_t dir)
+{
+    for (uint8_t i = 0; i < cola->numDispositivos; i++) {
+        if (cola->dispositivo[i].dir == dir)
+            return &cola->dispositivo[i];
+    }
+
+    if (cola->numDispositivos >= NUM_MAX_DISPOSITIVOS_I2C)
+        return NULL;
+
+    estadisticasDispositivoI2C_t *dispositivo = &cola->dispositivo[cola->numDispositivos++];
+    dispositivo->dir = dir;
+    return dispositivo;
+}
+
+
+/***************************************************************************************
+**  Nombre:         void terminarTransaccionI2C(numI2C_e numI2C, estadoTransaccionI2C_e estado)
+**  Descripcion:    Marca la transaccion actual como terminada, apunta el resultado en las
+**                  estadisticas y avisa al usuario. No arranca la siguiente
+**  Parametros:     Numero del I2C, estado final
+**  Retorno:        Ninguno
+****************************************************************************************/
+void terminarTransaccionI2C(numI2C_e numI2C, estadoTransaccionI2C_e estado)
+{
+    colaI2C_t *cola = &colaI2C[numI2C];
+    transaccionI2C_t *transaccion = cola->actual;
+
+    if (transaccion == NULL)
+        return;
+
+    cola->actual = NULL;
+    cola->estadisticas.numTransacciones++;
+
+    estadisticasDispositivoI2C_t *dispositivo = dispositivoColaI2C(cola, transaccion->dir);
+    if (dispositivo != NULL)
+        dispositivo->numTransacciones++;
+
+    switch (estado) {
+        case TRANSACCION_I2C_NACK:
+            if (dispositivo != NULL)
+                dispositivo->numNACK++;
+            break;
+
+        case TRANSACCION_I2C_ERROR:
+            cola->estadisticas.numErrores++;
+            if (dispositivo != NULL)
+                dispositivo->numErrores++;
+            break;
+
+        case TRANSACCION_I2C_TIMEOUT:
+            cola->estadisticas.numTimeouts++;
+            if (dispositivo != NULL)
+                dispositivo->numTimeouts++;
+            break;
+
+        default:
+            break;
+    }
+
+    transaccion->estado = estado;
+
+    // El callback puede encolar mas transacciones
+    if (transaccion->callback != NULL)
+        transaccion->callback(transaccion);
+}
+
+
+/***************************************************************************************
+**  Nombre:         void finalizarTransferenciaColaI2C(numI2C_e numI2C, resultadoTransferenciaI2C_e resultado)
+**  Descripcion:    Fin de la transferencia en curso. La llama el HAL desde la interrupcion.
+**                  Si se pierde el arbitraje la transaccion vuelve a la cabeza de la cola
+**                  y tras un error de bus se deja la recuperacion pendiente
+**  Parametros:     Numero del I2C, resultado de la transferencia
+**  Retorno:        Ninguno
+****************************************************************************************/
+void finalizarTransferenciaColaI2C(numI2C_e numI2C, resultadoTransferenciaI2C_e resultado)
+{
+    colaI2C_t *cola = &colaI2C[numI2C];
+    transaccionI2C_t *transaccion = cola->actual;
+
+    if (transaccion == NULL)
+        return;
+
+    switch (resultado) {
+        case RESULTADO_I2C_OK:
+            terminarTransaccionI2C(numI2C, TRANSACCION_I2C_COMPLETADA);
+            break;
+
+        case RESULTADO_I2C_NACK:
+            terminarTransaccionI2C(numI2C, TRANSACCION_I2C_NACK);
+            break;
+
+        case RESULTADO_I2C_ARBITRAJE: {
+            estadisticasDispositivoI2C_t *dispositivo = dispositivoColaI2C(cola, transaccion->dir);
+            if (dispositivo != NULL)
+                dispositivo->numArbitrajes++;
+
+            if (transaccion->numReintentos < NUM_MAX_REINTENTOS_ARBITRAJE_I2C) {
+                transaccion->numReintentos++;
+                transaccion->estado = TRANSACCION_I2C_EN_COLA;
+                transaccion->siguiente = cola->primera;
+                cola->primera = transaccion;
+                if (cola->ultima == NULL)
+                    cola->ultima = transaccion;
+
+                cola->longitud++;
+                cola->actual = NULL;
+            }
+            else
+                terminarTransaccionI2C(numI2C, TRANSACCION_I2C_ERROR);
+
+            break;
+        }
+
+        default:
+            cola->recuperacionPendiente = true;
+            terminarTransaccionI2C(numI2C, TRANSACCION_I2C_ERROR);
+            break;
+    }
+
+    arrancarSiguienteTransaccionI2C(numI2C);
+}
+
+
+/***************************************************************************************
+**  Nombre:         void recuperarBusColaI2C(numI2C_e numI2C)
+**  Descripcion:    Libera el bus con pulsos de reloj y reinicia el periferico
+**  Parametros:     Numero del I2C
+**  Retorno:        Ninguno
+****************************************************************************************/
+void recuperarBusColaI2C(numI2C_e numI2C)
+{
+    colaI2C_t *cola = &colaI2C[numI2C];
+
+    recuperarBusI2C(numI2C);
+    cola->recuperacionPendiente = false;
+    cola->estadisticas.numRecuperaciones++;
+}
+
+
+/***************************************************************************************
+**  Nombre:         void comprobarTimeoutColaI2C(numI2C_e numI2C, uint32_t tiempoActual)
+**  Descripcion:    Aborta la transferencia en curso si ha superado su timeout y recupera
+**                  el bus si ha quedado bloqueado
+**  Parametros:     Numero del I2C, tiempo actual en us
+**  Retorno:        Ninguno
+****************************************************************************************/
+void comprobarTimeoutColaI2C(numI2C_e numI2C, uint32_t tiempoActual)
+{
+    if (numI2C == I2C_NINGUNO)
+        return;
+
+    colaI2C_t *cola = &colaI2C[numI2C];
+
+    BLOQUE_ATOMICO_COLA_I2C {
+        transaccionI2C_t *transaccion = cola->actual;
+
+        if (transaccion != NULL && tiempoActual - transaccion->tiempoInicio > transaccion->timeout) {
+            // Un esclavo que retiene SDA es la causa tipica del timeout
+            abortarTransferenciaAsincronaI2C(numI2C);
+            terminarTransaccionI2C(numI2C, TRANSACCION_I2C_TIMEOUT);
+            cola->recuperacionPendiente = true;
+        }
+
+        if (cola->recuperacionPendiente && cola->actual == NULL) {
+            recuperarBusColaI2C(numI2C);
+            arrancarSiguienteTransaccionI2C(numI2C);
+        }
+    }
+}
+
+
+/***************************************************************************************
+**  Nombre:         bool transaccionI2Cterminada(transaccionI2C_t *transaccion)
+**  Descripcion:    Comprueba si una transaccion ha terminado. Sirve para recoger los
+**                  resultados sin callback
+**  Parametros:     Transaccion
+**  Retorno:        True si ha terminado, bien o mal. Ver el estado
+****************************************************************************************/
+bool transaccionI2Cterminada(transaccionI2C_t *transaccion)
+{
+    if (transaccion->estado == TRANSACCION_I2C_EN_CURSO || transaccion->estado == TRANSACCION_I2C_EN_COLA)
+        comprobarTimeoutColaI2C(transaccion->numI2C, micros());
+
+    return transaccion->estado != TRANSACCION_I2C_EN_COLA && transaccion->estado != TRANSACCION_I2C_EN_CURSO;
+}
+
+
+/***************************************************************************************
+**  Nombre:         bool cadenaTransaccionesI2Cterminada(transaccionI2C_t *transaccion, uint8_t numTransacciones)
+**  Descripcion:    Comprueba si han terminado todas las transacciones de una cadena
+**  Parametros:     Array de transacciones, numero de transacciones
+**  Retorno:        True si han terminado todas
+****************************************************************************************/
+bool cadenaTransaccionesI2Cterminada(transaccionI2C_t *transaccion, uint8_t numTransacciones)
+{
+    for (uint8_t i = 0; i < numTransacciones; i++) {
+        if (!transaccionI2Cterminada(&transaccion[i]))
+            return false;
+    }
+
+    return true;
+}
+
+
+/***************************************************************************************
+**  Nombre:         bool colaI2Cocupada(numI2C_e numI2C)
+**  Descripcion:    Comprueba si la cola tiene transacciones en curso o pendientes
+**  Parametros:     Numero del I2C
+**  Retorno:        True si ocupada
+****************************************************************************************/
+bool colaI2Cocupada(numI2C_e numI2C)
+{
+    return colaI2C[numI2C].actual != NULL || colaI2C[numI2C].primera != NULL;
+}
+
+
+/***************************************************************************************
+**  Nombre:         void estadisticasColaI2C(numI2C_e numI2C, estadisticasColaI2C_t *estadisticas)
+**  Descripcion:    Devuelve las estadisticas de la cola
+**  Parametros:     Numero del I2C, estadisticas
+**  Retorno:        Ninguno
+****************************************************************************************/
+void estadisticasColaI2C(numI2C_e numI2C, estadisticasColaI2C_t *estadisticas)
+{
+    *estadisticas = colaI2C[numI2C].estadisticas;
+}
+
+
+/***************************************************************************************
+**  Nombre:         bool estadisticasDispositivoI2C(numI2C_e numI2C, uint8_t dir, estadisticasDispositivoI2C_t *estadisticas)
+**  Descripcion:    Devuelve las estadisticas de un dispositivo del bus
+**  Parametros:     Numero del I2C, direccion del dispositivo, estadisticas
+**  Retorno:        False si el dispositivo no ha tenido transacciones
+****************************************************************************************/
+bool estadisticasDispositivoI2C(numI2C_e numI2C, uint8_t dir, estadisticasDispositivoI2C_t *estadisticas)
+{
+    const colaI2C_t *cola = &colaI2C[numI2C];
+
+    for (uint8_t i = 0; i < cola->numDispositivos; i++) {
+        if (cola->dispositivo[i].dir == dir) {
+            *estadisticas = cola->dispositivo[i];
+            return true;
+        }
+    }
+
+    return false;
+}
+
+#endif
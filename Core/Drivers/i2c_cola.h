@@ -0,0 +1,129 @@
+/***************************************************************************************
+**  i2c_cola.h - Cola de transacciones asincronas del I2C
+**
+**
+**  Este fichero forma parte del proyecto URpilot.
+**  Codigo desarrollado por el grupo de investigacion ICON de la Universidad de La Rioja
+**
+**  Autor: Ramon Rico
+**  Fecha de creacion: 17/10/2026
+**  Fecha de modificacion: 17/10/2026
+**
+**  El proyecto URpilot NO es libre. No se puede distribuir y/o modificar este fichero
+**  bajo ningun concepto.
+**
+**  En caso de modificacion y/o solicitud de informacion pongase en contacto con
+**  el grupo de investigacion ICON a traves de: www.unirioja.es/urpilot
+**
+**
+**  Control de versiones del fichero
+**
+**  v1.0  Ramon Rico. Se ha liberado la primera version estable
+**
+****************************************************************************************/
+
+#ifndef __I2C_COLA_H
+#define __I2C_COLA_H
+
+/***************************************************************************************
+** AREA DE INCLUDES                                                                   **
+****************************************************************************************/
+#include <stdint.h>
+#include <stdbool.h>
+
+#include "i2c.h"
+
+
+/***************************************************************************************
+** AREA DE PREPROCESADOR                                                              **
+****************************************************************************************/
+#define TIMEOUT_DEFECTO_TRANSACCION_I2C     5000        // us. Una lectura de 8 bytes a 100 KHz tarda ~1 ms
+#define NUM_MAX_REINTENTOS_ARBITRAJE_I2C    3
+#define NUM_MAX_DISPOSITIVOS_I2C            8           // Dispositivos con estadisticas en cada bus
+
+
+/***************************************************************************************
+** AREA DE DEFINICION DE TIPOS                                                        **
+****************************************************************************************/
+typedef enum {
+    TRANSACCION_I2C_LIBRE = 0,
+    TRANSACCION_I2C_EN_COLA,
+    TRANSACCION_I2C_EN_CURSO,
+    TRANSACCION_I2C_COMPLETADA,
+    TRANSACCION_I2C_NACK,
+    TRANSACCION_I2C_ERROR,
+    TRANSACCION_I2C_TIMEOUT,
+} estadoTransaccionI2C_e;
+
+// Resultado de una transferencia que notifica el HAL
+typedef enum {
+    RESULTADO_I2C_OK = 0,
+    RESULTADO_I2C_NACK,
+    RESULTADO_I2C_ARBITRAJE,
+    RESULTADO_I2C_ERROR,                    // Error de bus o sobrecarga. Hay que recuperar el bus
+} resultadoTransferenciaI2C_e;
+
+struct transaccionI2C_s;
+typedef void (*callbackTransaccionI2C)(struct transaccionI2C_s *transaccion);
+
+// La memoria de la transaccion y de su buffer es del usuario y no se puede tocar hasta que termine
+typedef struct transaccionI2C_s {
+    numI2C_e numI2C;
+    uint8_t dir;                            // Direccion de 7 bits
+    bool conRegistro;                       // Se envia el registro antes de los datos
+    uint8_t reg;
+    bool lectura;
+    uint8_t *dato;
+    uint16_t longitud;
+    uint32_t timeout;                       // us
+    callbackTransaccionI2C callback;        // Se llama en la interrupcion de fin de transferencia. Puede ser NULL
+    void *paramUsuario;
+    volatile estadoTransaccionI2C_e estado;
+    uint32_t tiempoInicio;
+    uint8_t numReintentos;
+    struct transaccionI2C_s *siguiente;
+} transaccionI2C_t;
+
+typedef struct {
+    uint8_t dir;
+    uint32_t numTransacciones;
+    uint16_t numNACK;
+    uint16_t numArbitrajes;
+    uint16_t numErrores;
+    uint16_t numTimeouts;
+} estadisticasDispositivoI2C_t;
+
+typedef struct {
+    uint32_t numTransacciones;
+    uint16_t numErrores;
+    uint16_t numTimeouts;
+    uint16_t numRecuperaciones;
+    uint8_t longitudMaxCola;
+} estadisticasColaI2C_t;
+
+
+/***************************************************************************************
+** AREA DE DECLARACION DE VARIABLES                                                   **
+****************************************************************************************/
+
+
+/***************************************************************************************
+** AREA DE PROTOTIPOS DE FUNCION                                                      **
+****************************************************************************************/
+void iniciarColaI2C(numI2C_e numI2C);
+bool encolarTransaccionI2C(transaccionI2C_t *transaccion);
+bool encolarCadenaTransaccionesI2C(transaccionI2C_t *transaccion, uint8_t numTransacciones);
+bool transaccionI2Cterminada(transaccionI2C_t *transaccion);
+bool cadenaTransaccionesI2Cterminada(transaccionI2C_t *transaccion, uint8_t numTransacciones);
+bool colaI2Cocupada(numI2C_e numI2C);
+void finalizarTransferenciaColaI2C(numI2C_e numI2C, resultadoTransferenciaI2C_e resultado);
+void comprobarTimeoutColaI2C(numI2C_e numI2C, uint32_t tiempoActual);
+void estadisticasColaI2C(numI2C_e numI2C, estadisticasColaI2C_t *estadisticas);
+bool estadisticasDispositivoI2C(numI2C_e numI2C, uint8_t dir, estadisticasDispositivoI2C_t *estadisticas);
+
+// Implementadas por el HAL (i2c_hal.c) o por el simulador
+bool iniciarTransferenciaAsincronaI2C(numI2C_e numI2C, const transaccionI2C_t *transaccion);
+void abortarTransferenciaAsincronaI2C(numI2C_e numI2C);
+bool recuperarBusI2C(numI2C_e numI2C);
+
+#endif // __I2C_COLA_H
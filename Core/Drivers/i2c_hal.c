@@ -7,7 +7,7 @@
 **
 **  Autor: Ramon Rico
 **  Fecha de creacion: 12/05/2019
-**  Fecha de modificacion: 03/08/2020
+**  Fecha de modificacion: 17/10/2026
 **
 **  El proyecto URpilot NO es libre. No se puede distribuir y/o modificar este fichero
 **  bajo ningun concepto.
@@ -22,37 +22,56 @@
 **
 ****************************************************************************************/
 
+
 /***************************************************************************************
 ** AREA DE INCLUDES                                                                   **
 ****************************************************************************************/
+#include <string.h>
+
 #include "i2c.h"
 
 #ifdef USAR_I2C
 #include "GP/gp_i2c.h"
 #include "io.h"
+#include "nvic.h"
+#include "tiempo.h"
+#include "i2c_cola.h"
 
 
 /***************************************************************************************
 ** AREA DE PREPROCESADOR                                                              **
 ****************************************************************************************/
-#define TIMEOUT_DEFECTO_I2C   10
-#define TIMING_MASK_I2C       0xF0FFFFFFU  // Valor cogido de stm32f7xx_hal_i2c.c
+#define TIMEOUT_DEFECTO_I2C              10          // ms
+#define TIMING_MASK_I2C                  0xF0FFFFFFU  // Valor cogido de stm32f7xx_hal_i2c.c
+#define LONGITUD_MAX_ESCRITURA_I2C       16          // Escrituras en registro que no esperan a la fase del registro
+#define NUM_PULSOS_RECUPERACION_I2C      9           // Pulsos para que un esclavo termine el byte en curso
+#define SEMIPERIODO_RECUPERACION_I2C     5           // us. 100 KHz
 
 
 /***************************************************************************************
 ** AREA DE DEFINICION DE TIPOS                                                        **
 ****************************************************************************************/
+typedef struct {
+    const transaccionI2C_t *transaccion;    // Transaccion de la cola en el periferico
+    bool faseRegistro;                      // Se esta enviando el registro de una lectura
+    uint8_t bufferTx[LONGITUD_MAX_ESCRITURA_I2C + 1];
+} transferenciaI2C_t;
 
 
 /***************************************************************************************
 ** AREA DE DECLARACION DE VARIABLES                                                   **
 ****************************************************************************************/
+static transferenciaI2C_t transferenciaI2C[NUM_MAX_I2C];
 
 
 /***************************************************************************************
 ** AREA DE PROTOTIPOS DE FUNCION                                                      **
 ****************************************************************************************/
 void habilitarRelojI2C(numI2C_e numI2C);
+void configurarPinesI2C(numI2C_e numI2C);
+bool configurarPerifericoI2C(numI2C_e numI2C);
+bool transferirSincronoI2C(numI2C_e numI2C, uint8_t dir, bool conRegistro, uint8_t reg, bool lectura, uint8_t *dato, uint16_t longitud);
+numI2C_e numI2Chandler(I2C_HandleTypeDef *hi2c);
 
 
 /***************************************************************************************
@@ -74,15 +93,51 @@ bool iniciarDriverI2C(numI2C_e numI2C)
 	        return false;
 	    else {
 	        habilitarRelojI2C(numI2C);
-
-	        // Configura los pines
-	        configurarIO(driver->hal.pinSCL.pin, configI2C(numI2C)->pullup ? CONFIG_IO(GPIO_MODE_AF_OD, GPIO_SPEED_FREQ_VERY_HIGH, GPIO_PULLUP) : CONFIG_IO(GPIO_MODE_AF_OD, GPIO_SPEED_FREQ_VERY_HIGH, GPIO_NOPULL), driver->hal.pinSCL.af);
-	        configurarIO(driver->hal.pinSDA.pin, configI2C(numI2C)->pullup ? CONFIG_IO(GPIO_MODE_AF_OD, GPIO_SPEED_FREQ_VERY_HIGH, GPIO_PULLUP) : CONFIG_IO(GPIO_MODE_AF_OD, GPIO_SPEED_FREQ_VERY_HIGH, GPIO_NOPULL), driver->hal.pinSDA.af);
-
+	        configurarPinesI2C(numI2C);
             driver->hal.asignado = true;
 	    }
 	}
 
+    memset(&transferenciaI2C[numI2C], 0, sizeof(transferenciaI2C[numI2C]));
+
+    if (!configurarPerifericoI2C(numI2C))
+        return false;
+
+    // Las transferencias de la cola terminan en las interrupciones de evento y de error
+    HAL_NVIC_SetPriority(driver->hal.IRQev, PRIORIDAD_BASE_NVIC(driver->hal.prioridadIRQ), PRIORIDAD_SUB_NVIC(driver->hal.prioridadIRQ));
+    HAL_NVIC_EnableIRQ(driver->hal.IRQev);
+    HAL_NVIC_SetPriority(driver->hal.IRQer, PRIORIDAD_BASE_NVIC(driver->hal.prioridadIRQ), PRIORIDAD_SUB_NVIC(driver->hal.prioridadIRQ));
+    HAL_NVIC_EnableIRQ(driver->hal.IRQer);
+
+    return true;
+}
+
+
+/***************************************************************************************
+**  Nombre:         void configurarPinesI2C(numI2C_e numI2C)
+**  Descripcion:    Configura los pines en su funcion alternativa
+**  Parametros:     Dispositivo
+**  Retorno:        Ninguno
+****************************************************************************************/
+void configurarPinesI2C(numI2C_e numI2C)
+{
+    i2c_t *driver = punteroI2C(numI2C);
+
+    configurarIO(driver->hal.pinSCL.pin, configI2C(numI2C)->pullup ? CONFIG_IO(GPIO_MODE_AF_OD, GPIO_SPEED_FREQ_VERY_HIGH, GPIO_PULLUP) : CONFIG_IO(GPIO_MODE_AF_OD, GPIO_SPEED_FREQ_VERY_HIGH, GPIO_NOPULL), driver->hal.pinSCL.af);
+    configurarIO(driver->hal.pinSDA.pin, configI2C(numI2C)->pullup ? CONFIG_IO(GPIO_MODE_AF_OD, GPIO_SPEED_FREQ_VERY_HIGH, GPIO_PULLUP) : CONFIG_IO(GPIO_MODE_AF_OD, GPIO_SPEED_FREQ_VERY_HIGH, GPIO_NOPULL), driver->hal.pinSDA.af);
+}
+
+
+/***************************************************************************************
+**  Nombre:         bool configurarPerifericoI2C(numI2C_e numI2C)
+**  Descripcion:    Resetea y configura el periferico
+**  Parametros:     Dispositivo
+**  Retorno:        True si ok
+****************************************************************************************/
+bool configurarPerifericoI2C(numI2C_e numI2C)
+{
+    i2c_t *driver = punteroI2C(numI2C);
+
     // Resetea el dispositivo
     HAL_I2C_DeInit(&driver->hal.hi2c);
 
@@ -108,6 +163,39 @@ bool iniciarDriverI2C(numI2C_e numI2C)
 }
 
 
+/***************************************************************************************
+**  Nombre:         bool transferirSincronoI2C(numI2C_e numI2C, uint8_t dir, bool conRegistro, uint8_t reg, bool lectura,
+**                                             uint8_t *dato, uint16_t longitud)
+**  Descripcion:    Encola una transaccion y espera a que termine. Las funciones bloqueantes
+**                  pasan por la cola para no pisar a las transferencias asincronas
+**  Parametros:     Dispositivo, direccion I2C, si se envia registro, registro, si es lectura,
+**                  buffer, longitud del buffer
+**  Retorno:        True si ok
+****************************************************************************************/
+bool transferirSincronoI2C(numI2C_e numI2C, uint8_t dir, bool conRegistro, uint8_t reg, bool lectura, uint8_t *dato, uint16_t longitud)
+{
+    transaccionI2C_t transaccion = {
+        .numI2C = numI2C,
+        .dir = dir,
+        .conRegistro = conRegistro,
+        .reg = reg,
+        .lectura = lectura,
+        .dato = dato,
+        .longitud = longitud,
+        .timeout = TIMEOUT_DEFECTO_I2C * 1000,
+    };
+
+    if (!encolarTransaccionI2C(&transaccion))
+        return false;
+
+    // El timeout de la cola garantiza la salida
+    while (!transaccionI2Cterminada(&transaccion))
+        ;
+
+    return transaccion.estado == TRANSACCION_I2C_COMPLETADA;
+}
+
+
 /***************************************************************************************
 **  Nombre:         bool escribirMemI2C(numI2C_e numI2C, uint8_t dir, uint8_t reg, uint8_t byteTx)
 **  Descripcion:    Escribe un dato en un registro
@@ -128,14 +216,7 @@ CODIGO_RAPIDO bool escribirMemI2C(numI2C_e numI2C, uint8_t dir, uint8_t reg, uin
 ****************************************************************************************/
 CODIGO_RAPIDO bool escribirBufferMemI2C(numI2C_e numI2C, uint8_t dir, uint8_t reg, uint8_t *datoTx, uint16_t longitud)
 {
-    I2C_HandleTypeDef *hi2c = &punteroI2C(numI2C)->hal.hi2c;
-
-    if (HAL_I2C_Mem_Write(hi2c, dir << 1, reg, I2C_MEMADD_SIZE_8BIT, datoTx, longitud, TIMEOUT_DEFECTO_I2C) != HAL_OK) {
-        errorCallbackI2C(numI2C);
-        return false;
-    }
-
-    return true;
+    return transferirSincronoI2C(numI2C, dir, true, reg, false, datoTx, longitud);
 }
 
 
@@ -159,14 +240,7 @@ CODIGO_RAPIDO bool escribirI2C(numI2C_e numI2C, uint8_t dir, uint8_t byteTx)
 ****************************************************************************************/
 CODIGO_RAPIDO bool escribirBufferI2C(numI2C_e numI2C, uint8_t dir, uint8_t *datoTx, uint16_t longitud)
 {
-    I2C_HandleTypeDef *hi2c = &punteroI2C(numI2C)->hal.hi2c;
-
-    if (HAL_I2C_Master_Transmit(hi2c, dir << 1, datoTx, longitud, TIMEOUT_DEFECTO_I2C) != HAL_OK) {
-        errorCallbackI2C(numI2C);
-        return false;
-    }
-
-    return true;
+    return transferirSincronoI2C(numI2C, dir, false, 0, false, datoTx, longitud);
 }
 
 
@@ -190,14 +264,7 @@ CODIGO_RAPIDO bool leerMemI2C(numI2C_e numI2C, uint8_t dir, uint8_t reg, uint8_t
 ****************************************************************************************/
 CODIGO_RAPIDO bool leerBufferMemI2C(numI2C_e numI2C, uint8_t dir, uint8_t reg, uint8_t *datoRx, uint16_t longitud)
 {
-    I2C_HandleTypeDef *hi2c = &punteroI2C(numI2C)->hal.hi2c;
-
-    if (HAL_I2C_Mem_Read(hi2c, dir << 1, reg, I2C_MEMADD_SIZE_8BIT, datoRx, longitud, TIMEOUT_DEFECTO_I2C) != HAL_OK) {
-        errorCallbackI2C(numI2C);
-        return false;
-    }
-
-    return true;
+    return transferirSincronoI2C(numI2C, dir, true, reg, true, datoRx, longitud);
 }
 
 
@@ -220,10 +287,49 @@ CODIGO_RAPIDO bool leerI2C(numI2C_e numI2C, uint8_t dir, uint8_t *byteRx)
 **  Retorno:        True si ok
 ****************************************************************************************/
 CODIGO_RAPIDO bool leerBufferI2C(numI2C_e numI2C, uint8_t dir, uint8_t *datoRx, uint16_t longitud)
+{
+    return transferirSincronoI2C(numI2C, dir, false, 0, true, datoRx, longitud);
+}
+
+
+/***************************************************************************************
+**  Nombre:         bool iniciarTransferenciaAsincronaI2C(numI2C_e numI2C, const transaccionI2C_t *transaccion)
+**  Descripcion:    Lanza una transferencia sin esperar a que termine. En las lecturas de
+**                  registro primero se envia el registro y la lectura sigue con un start
+**                  repetido desde la interrupcion. Las escrituras de registro se mandan en
+**                  un solo bloque
+**  Parametros:     Dispositivo, transaccion
+**  Retorno:        True si la transferencia ha empezado
+****************************************************************************************/
+CODIGO_RAPIDO bool iniciarTransferenciaAsincronaI2C(numI2C_e numI2C, const transaccionI2C_t *transaccion)
 {
     I2C_HandleTypeDef *hi2c = &punteroI2C(numI2C)->hal.hi2c;
+    transferenciaI2C_t *transferencia = &transferenciaI2C[numI2C];
+    const uint16_t dir = transaccion->dir << 1;
+    HAL_StatusTypeDef estado;
+
+    transferencia->transaccion = transaccion;
+    transferencia->faseRegistro = false;
 
-    if (HAL_I2C_Master_Receive(hi2c ,dir << 1, datoRx, longitud, TIMEOUT_DEFECTO_I2C) != HAL_OK) {
+    if (transaccion->conRegistro && transaccion->lectura) {
+        transferencia->faseRegistro = true;
+        transferencia->bufferTx[0] = transaccion->reg;
+        estado = HAL_I2C_Master_Seq_Transmit_IT(hi2c, dir, transferencia->bufferTx, 1, I2C_FIRST_FRAME);
+    }
+    else if (transaccion->conRegistro && transaccion->longitud <= LONGITUD_MAX_ESCRITURA_I2C) {
+        transferencia->bufferTx[0] = transaccion->reg;
+        memcpy(&transferencia->bufferTx[1], transaccion->dato, transaccion->longitud);
+        estado = HAL_I2C_Master_Transmit_IT(hi2c, dir, transferencia->bufferTx, transaccion->longitud + 1);
+    }
+    else if (transaccion->conRegistro)      // El HAL espera a que salga el registro
+        estado = HAL_I2C_Mem_Write_IT(hi2c, dir, transaccion->reg, I2C_MEMADD_SIZE_8BIT, transaccion->dato, transaccion->longitud);
+    else if (transaccion->lectura)
+        estado = HAL_I2C_Master_Receive_IT(hi2c, dir, transaccion->dato, transaccion->longitud);
+    else
+        estado = HAL_I2C_Master_Transmit_IT(hi2c, dir, transaccion->dato, transaccion->longitud);
+
+    if (estado != HAL_OK) {
+        transferencia->transaccion = NULL;
         errorCallbackI2C(numI2C);
         return false;
     }
@@ -232,6 +338,81 @@ CODIGO_RAPIDO bool leerBufferI2C(numI2C_e numI2C, uint8_t dir, uint8_t *datoRx,
 }
 
 
+/***************************************************************************************
+**  Nombre:         void abortarTransferenciaAsincronaI2C(numI2C_e numI2C)
+**  Descripcion:    Aborta la transferencia en curso. Al deshabilitar el periferico se
+**                  resetea su maquina de estados
+**  Parametros:     Dispositivo
+**  Retorno:        Ninguno
+****************************************************************************************/
+void abortarTransferenciaAsincronaI2C(numI2C_e numI2C)
+{
+    I2C_HandleTypeDef *hi2c = &punteroI2C(numI2C)->hal.hi2c;
+
+    __HAL_I2C_DISABLE_IT(hi2c, I2C_IT_ERRI | I2C_IT_TCI | I2C_IT_STOPI | I2C_IT_NACKI | I2C_IT_ADDRI | I2C_IT_RXI | I2C_IT_TXI);
+    __HAL_I2C_DISABLE(hi2c);
+
+    hi2c->State = HAL_I2C_STATE_READY;
+    hi2c->Mode = HAL_I2C_MODE_NONE;
+    hi2c->XferISR = NULL;
+    __HAL_UNLOCK(hi2c);
+
+    __HAL_I2C_ENABLE(hi2c);
+
+    transferenciaI2C[numI2C].transaccion = NULL;
+    errorCallbackI2C(numI2C);
+}
+
+
+/***************************************************************************************
+**  Nombre:         bool recuperarBusI2C(numI2C_e numI2C)
+**  Descripcion:    Libera un bus bloqueado por un esclavo que retiene SDA. Se dan pulsos
+**                  de reloj por GPIO hasta que SDA queda libre, se genera un STOP y se
+**                  reinicia el periferico
+**  Parametros:     Dispositivo
+**  Retorno:        True si SDA ha quedado libre
+****************************************************************************************/
+bool recuperarBusI2C(numI2C_e numI2C)
+{
+    i2c_t *driver = punteroI2C(numI2C);
+    const uint8_t pinSCL = driver->hal.pinSCL.pin;
+    const uint8_t pinSDA = driver->hal.pinSDA.pin;
+    const uint16_t configSalida = configI2C(numI2C)->pullup ? CONFIG_IO(GPIO_MODE_OUTPUT_OD, GPIO_SPEED_FREQ_VERY_HIGH, GPIO_PULLUP) : CONFIG_IO(GPIO_MODE_OUTPUT_OD, GPIO_SPEED_FREQ_VERY_HIGH, GPIO_NOPULL);
+
+    HAL_I2C_DeInit(&driver->hal.hi2c);
+    transferenciaI2C[numI2C].transaccion = NULL;
+
+    escribirIO(pinSCL, true);
+    escribirIO(pinSDA, true);
+    configurarIO(pinSCL, configSalida, 0);
+    configurarIO(pinSDA, configSalida, 0);
+    delayMicroseconds(SEMIPERIODO_RECUPERACION_I2C);
+
+    // Con SDA en alto el pin en open drain lee el nivel que deja el esclavo
+    for (uint8_t i = 0; i < NUM_PULSOS_RECUPERACION_I2C && !leerIO(pinSDA); i++) {
+        escribirIO(pinSCL, false);
+        delayMicroseconds(SEMIPERIODO_RECUPERACION_I2C);
+        escribirIO(pinSCL, true);
+        delayMicroseconds(SEMIPERIODO_RECUPERACION_I2C);
+    }
+
+    // STOP: SDA sube con SCL en alto
+    escribirIO(pinSCL, false);
+    delayMicroseconds(SEMIPERIODO_RECUPERACION_I2C);
+    escribirIO(pinSDA, false);
+    delayMicroseconds(SEMIPERIODO_RECUPERACION_I2C);
+    escribirIO(pinSCL, true);
+    delayMicroseconds(SEMIPERIODO_RECUPERACION_I2C);
+    escribirIO(pinSDA, true);
+    delayMicroseconds(SEMIPERIODO_RECUPERACION_I2C);
+
+    const bool sdaLibre = leerIO(pinSDA);
+
+    configurarPinesI2C(numI2C);
+    return configurarPerifericoI2C(numI2C) && sdaLibre;
+}
+
+
 /***************************************************************************************
 **  Nombre:         void drenarBufferRecepcionI2C(numI2C_e numI2C)
 **  Descripcion:    Drena el buffer de recepcion
@@ -250,18 +431,13 @@ CODIGO_RAPIDO void drenarBufferRecepcionI2C(numI2C_e numI2C)
 
 /***************************************************************************************
 **  Nombre:         bool ocupadoI2C(numI2C_e numI2C)
-**  Descripcion:    Comprueba si el I2C esta ocupado
+**  Descripcion:    Comprueba si el I2C tiene transacciones en curso o pendientes
 **  Parametros:     Dispositivo
 **  Retorno:        True si ocupado
 ****************************************************************************************/
 CODIGO_RAPIDO bool ocupadoI2C(numI2C_e numI2C)
 {
-    i2c_t *driver = punteroI2C(numI2C);
-
-    if (HAL_I2C_GetState(&driver->hal.hi2c) == HAL_I2C_STATE_BUSY || HAL_I2C_GetState(&driver->hal.hi2c) == HAL_I2C_STATE_BUSY_TX || HAL_I2C_GetState(&driver->hal.hi2c) == HAL_I2C_STATE_BUSY_RX)
-        return true;
-    else
-        return false;
+    return colaI2Cocupada(numI2C);
 }
 
 
@@ -313,4 +489,221 @@ void habilitarRelojI2C(numI2C_e numI2C)
     }
 }
 
+
+
+/***************************************************************************************
+**  Nombre:         numI2C_e numI2Chandler(I2C_HandleTypeDef *hi2c)
+**  Descripcion:    Devuelve el numero de I2C de un handler del HAL
+**  Parametros:     Handler del I2C
+**  Retorno:        Numero del I2C
+****************************************************************************************/
+CODIGO_RAPIDO numI2C_e numI2Chandler(I2C_HandleTypeDef *hi2c)
+{
+    for (uint8_t i = 0; i < NUM_MAX_I2C; i++) {
+        if (&punteroI2C(i)->hal.hi2c == hi2c)
+            return i;
+    }
+
+    return I2C_NINGUNO;
+}
+
+
+/***************************************************************************************
+**  Nombre:         void HAL_I2C_MasterTxCpltCallback(I2C_HandleTypeDef *hi2c)
+**  Descripcion:    Callback de fin de envio. En las lecturas de registro lanza la fase de
+**                  lectura con un start repetido
+**  Parametros:     Handler del I2C
+**  Retorno:        Ninguno
+****************************************************************************************/
+CODIGO_RAPIDO void HAL_I2C_MasterTxCpltCallback(I2C_HandleTypeDef *hi2c)
+{
+    const numI2C_e numI2C = numI2Chandler(hi2c);
+
+    if (numI2C == I2C_NINGUNO)
+        return;
+
+    transferenciaI2C_t *transferencia = &transferenciaI2C[numI2C];
+    const transaccionI2C_t *transaccion = transferencia->transaccion;
+
+    if (transaccion != NULL && transferencia->faseRegistro) {
+        transferencia->faseRegistro = false;
+
+        if (HAL_I2C_Master_Seq_Receive_IT(hi2c, transaccion->dir << 1, transaccion->dato, transaccion->longitud, I2C_LAST_FRAME) == HAL_OK)
+            return;
+
+        errorCallbackI2C(numI2C);
+        transferencia->transaccion = NULL;
+        finalizarTransferenciaColaI2C(numI2C, RESULTADO_I2C_ERROR);
+        return;
+    }
+
+    transferencia->transaccion = NULL;
+    finalizarTransferenciaColaI2C(numI2C, RESULTADO_I2C_OK);
+}
+
+
+/***************************************************************************************
+**  Nombre:         void HAL_I2C_MasterRxCpltCallback(I2C_HandleTypeDef *hi2c)
+**  Descripcion:    Callback de fin de lectura
+**  Parametros:     Handler del I2C
+**  Retorno:        Ninguno
+****************************************************************************************/
+CODIGO_RAPIDO void HAL_I2C_MasterRxCpltCallback(I2C_HandleTypeDef *hi2c)
+{
+    const numI2C_e numI2C = numI2Chandler(hi2c);
+
+    if (numI2C == I2C_NINGUNO)
+        return;
+
+    transferenciaI2C[numI2C].transaccion = NULL;
+    finalizarTransferenciaColaI2C(numI2C, RESULTADO_I2C_OK);
+}
+
+
+/***************************************************************************************
+**  Nombre:         void HAL_I2C_MemTxCpltCallback(I2C_HandleTypeDef *hi2c)
+**  Descripcion:    Callback de fin de las escrituras largas en registro
+**  Parametros:     Handler del I2C
+**  Retorno:        Ninguno
+****************************************************************************************/
+CODIGO_RAPIDO void HAL_I2C_MemTxCpltCallback(I2C_HandleTypeDef *hi2c)
+{
+    const numI2C_e numI2C = numI2Chandler(hi2c);
+
+    if (numI2C == I2C_NINGUNO)
+        return;
+
+    transferenciaI2C[numI2C].transaccion = NULL;
+    finalizarTransferenciaColaI2C(numI2C, RESULTADO_I2C_OK);
+}
+
+
+/***************************************************************************************
+**  Nombre:         void HAL_I2C_ErrorCallback(I2C_HandleTypeDef *hi2c)
+**  Descripcion:    Callback de error. Distingue el NACK y la perdida de arbitraje de los
+**                  errores que dejan el bus bloqueado
+**  Parametros:     Handler del I2C
+**  Retorno:        Ninguno
+****************************************************************************************/
+void HAL_I2C_ErrorCallback(I2C_HandleTypeDef *hi2c)
+{
+    const numI2C_e numI2C = numI2Chandler(hi2c);
+    const uint32_t error = HAL_I2C_GetError(hi2c);
+    resultadoTransferenciaI2C_e resultado;
+
+    if (numI2C == I2C_NINGUNO)
+        return;
+
+    if (error & (HAL_I2C_ERROR_BERR | HAL_I2C_ERROR_OVR | HAL_I2C_ERROR_TIMEOUT))
+        resultado = RESULTADO_I2C_ERROR;
+    else if (error & HAL_I2C_ERROR_ARLO)
+        resultado = RESULTADO_I2C_ARBITRAJE;
+    else if (error & HAL_I2C_ERROR_AF)
+        resultado = RESULTADO_I2C_NACK;
+    else
+        resultado = RESULTADO_I2C_ERROR;
+
+    errorCallbackI2C(numI2C);
+    transferenciaI2C[numI2C].transaccion = NULL;
+    finalizarTransferenciaColaI2C(numI2C, resultado);
+}
+
+
+/***************************************************************************************
+**  Nombre:         void I2C1_EV_IRQHandler(void)
+**  Descripcion:    Interrupcion de eventos del I2C 1
+**  Parametros:     Ninguno
+**  Retorno:        Ninguno
+****************************************************************************************/
+CODIGO_RAPIDO void I2C1_EV_IRQHandler(void)
+{
+    HAL_I2C_EV_IRQHandler(&punteroI2C(I2C_1)->hal.hi2c);
+}
+
+
+/***************************************************************************************
+**  Nombre:         void I2C1_ER_IRQHandler(void)
+**  Descripcion:    Interrupcion de errores del I2C 1
+**  Parametros:     Ninguno
+**  Retorno:        Ninguno
+****************************************************************************************/
+CODIGO_RAPIDO void I2C1_ER_IRQHandler(void)
+{
+    HAL_I2C_ER_IRQHandler(&punteroI2C(I2C_1)->hal.hi2c);
+}
+
+
+/***************************************************************************************
+**  Nombre:         void I2C2_EV_IRQHandler(void)
+**  Descripcion:    Interrupcion de eventos del I2C 2
+**  Parametros:     Ninguno
+**  Retorno:        Ninguno
+****************************************************************************************/
+CODIGO_RAPIDO void I2C2_EV_IRQHandler(void)
+{
+    HAL_I2C_EV_IRQHandler(&punteroI2C(I2C_2)->hal.hi2c);
+}
+
+
+/***************************************************************************************
+**  Nombre:         void I2C2_ER_IRQHandler(void)
+**  Descripcion:    Interrupcion de errores del I2C 2
+**  Parametros:     Ninguno
+**  Retorno:        Ninguno
+****************************************************************************************/
+CODIGO_RAPIDO void I2C2_ER_IRQHandler(void)
+{
+    HAL_I2C_ER_IRQHandler(&punteroI2C(I2C_2)->hal.hi2c);
+}
+
+
+/***************************************************************************************
+**  Nombre:         void I2C3_EV_IRQHandler(void)
+**  Descripcion:    Interrupcion de eventos del I2C 3
+**  Parametros:     Ninguno
+**  Retorno:        Ninguno
+****************************************************************************************/
+CODIGO_RAPIDO void I2C3_EV_IRQHandler(void)
+{
+    HAL_I2C_EV_IRQHandler(&punteroI2C(I2C_3)->hal.hi2c);
+}
+
+
+/***************************************************************************************
+**  Nombre:         void I2C3_ER_IRQHandler(void)
+**  Descripcion:    Interrupcion de errores del I2C 3
+**  Parametros:     Ninguno
+**  Retorno:        Ninguno
+****************************************************************************************/
+CODIGO_RAPIDO void I2C3_ER_IRQHandler(void)
+{
+    HAL_I2C_ER_IRQHandler(&punteroI2C(I2C_3)->hal.hi2c);
+}
+
+
+#ifndef STM32F722xx
+/***************************************************************************************
+**  Nombre:         void I2C4_EV_IRQHandler(void)
+**  Descripcion:    Interrupcion de eventos del I2C 4
+**  Parametros:     Ninguno
+**  Retorno:        Ninguno
+****************************************************************************************/
+CODIGO_RAPIDO void I2C4_EV_IRQHandler(void)
+{
+    HAL_I2C_EV_IRQHandler(&punteroI2C(I2C_4)->hal.hi2c);
+}
+
+
+/***************************************************************************************
+**  Nombre:         void I2C4_ER_IRQHandler(void)
+**  Descripcion:    Interrupcion de errores del I2C 4
+**  Parametros:     Ninguno
+**  Retorno:        Ninguno
+****************************************************************************************/
+CODIGO_RAPIDO void I2C4_ER_IRQHandler(void)
+{
+    HAL_I2C_ER_IRQHandler(&punteroI2C(I2C_4)->hal.hi2c);
+}
+#endif
+
 #endif
@@ -7,7 +7,7 @@
 **
 **  Autor: Ramon Rico
 **  Fecha de creacion: 25/07/2020
-**  Fecha de modificacion: 03/08/2020
+**  Fecha de modificacion: 17/10/2026
 **
 **  El proyecto URpilot NO es libre. No se puede distribuir y/o modificar este fichero
 **  bajo ningun concepto.
@@ -30,6 +30,7 @@
 #ifdef USAR_I2C
 #include "GP/gp_i2c.h"
 #include "io.h"
+#include "nvic.h"
 
 
 /***************************************************************************************
@@ -44,6 +45,9 @@
 typedef struct {
     numI2C_e numI2C;
     I2C_TypeDef *reg;
+    uint8_t IRQev;
+    uint8_t IRQer;
+    uint8_t prioridadIRQ;
     pin_t pinSCL[NUM_MAX_PIN_SEL_I2C];
     pin_t pinSDA[NUM_MAX_PIN_SEL_I2C];
 } hardwareI2C_t;
@@ -56,6 +60,9 @@ static const hardwareI2C_t hardwareI2C[] = {
     {
         .numI2C = I2C_1,
         .reg = I2C1,
+        .IRQev = I2C1_EV_IRQn,
+        .IRQer = I2C1_ER_IRQn,
+        .prioridadIRQ = NVIC_PRIO_I2C,
         .pinSCL = {
             { DEFIO_TAG(PB6), GPIO_AF4_I2C1  },
             { DEFIO_TAG(PB8), GPIO_AF4_I2C1  },
@@ -68,6 +75,9 @@ static const hardwareI2C_t hardwareI2C[] = {
     {
         .numI2C = I2C_2,
         .reg = I2C2,
+        .IRQev = I2C2_EV_IRQn,
+        .IRQer = I2C2_ER_IRQn,
+        .prioridadIRQ = NVIC_PRIO_I2C,
         .pinSCL = {
             { DEFIO_TAG(PB10), GPIO_AF4_I2C2  },
             { DEFIO_TAG(PF1),  GPIO_AF4_I2C2  },
@@ -80,6 +90,9 @@ static const hardwareI2C_t hardwareI2C[] = {
     {
         .numI2C = I2C_3,
         .reg = I2C3,
+        .IRQev = I2C3_EV_IRQn,
+        .IRQer = I2C3_ER_IRQn,
+        .prioridadIRQ = NVIC_PRIO_I2C,
         .pinSCL = {
             { DEFIO_TAG(PA8),  GPIO_AF4_I2C3  },
         },
@@ -91,6 +104,9 @@ static const hardwareI2C_t hardwareI2C[] = {
     {
         .numI2C = I2C_4,
         .reg = I2C4,
+        .IRQev = I2C4_EV_IRQn,
+        .IRQer = I2C4_ER_IRQn,
+        .prioridadIRQ = NVIC_PRIO_I2C,
         .pinSCL = {
             { DEFIO_TAG(PB6),  GPIO_AF11_I2C4 },
             { DEFIO_TAG(PB8),  GPIO_AF1_I2C4  },
@@ -135,6 +151,11 @@ bool asignarHALi2c(numI2C_e numI2C)
 
     // Asignamos la instancia
     driver->hal.hi2c.Instance = hardwareI2C[numI2C].reg;
+
+    // Asignamos las interrupciones
+    driver->hal.IRQev = hardwareI2C[numI2C].IRQev;
+    driver->hal.IRQer = hardwareI2C[numI2C].IRQer;
+    driver->hal.prioridadIRQ = hardwareI2C[numI2C].prioridadIRQ;
     return true;
 }
 
@@ -7,7 +7,7 @@
 **
 **  Autor: Ramon Rico
 **  Fecha de creacion: 06/05/2019
-**  Fecha de modificacion: 03/12/2020
+**  Fecha de modificacion: 17/10/2026
 **
 **  El proyecto URpilot NO es libre. No se puede distribuir y/o modificar este fichero
 **  bajo ningun concepto.
@@ -51,6 +51,9 @@
 #define NVIC_PRIO_SERIALUART8              CONSTRUIR_PRIORIDAD_NVIC(1, 2)
 #define NVIC_PRIO_SDMMC1                   CONSTRUIR_PRIORIDAD_NVIC(1, 0)
 #define NVIC_PRIO_SDMMC2                   CONSTRUIR_PRIORIDAD_NVIC(1, 0)
+#define NVIC_PRIO_SPI                      CONSTRUIR_PRIORIDAD_NVIC(1, 1)
+#define NVIC_PRIO_EXTI                     CONSTRUIR_PRIORIDAD_NVIC(1, 1)    // Igual que el SPI: el DRDY encola transacciones
+#define NVIC_PRIO_I2C                      CONSTRUIR_PRIORIDAD_NVIC(2, 0)
 
 // Macros para generar o partir la prioridad
 #define CONSTRUIR_PRIORIDAD_NVIC(base,sub)      (((((base) << (__NVIC_PRIO_BITS - (7 - (NVIC_PRIORITYGROUP_2)))) | ((sub) & (0x0F >> (7 - (NVIC_PRIORITYGROUP_2))))) << __NVIC_PRIO_BITS) & 0xf0)
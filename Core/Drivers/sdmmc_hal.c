@@ -7,7 +7,7 @@
 **
 **  Autor: Ramon Rico
 **  Fecha de creacion: 02/05/2020
-**  Fecha de modificacion: 03/08/2020
+**  Fecha de modificacion: 17/10/2026
 **
 **  El proyecto URpilot NO es libre. No se puede distribuir y/o modificar este fichero
 **  bajo ningun concepto.
@@ -113,7 +113,8 @@ bool iniciarDriverSDMMC(void)
 
 #ifdef USAR_DMA_SDMMC
     // Configuracion del DMA para el envio
-    iniciarDMA(identificadorDMA(driver->hal.hdmaTx.Instance));
+    if (!iniciarDMA(identificadorDMA(driver->hal.hdmaTx.Instance), DMA_PROPIETARIO_SDMMC_TX, 0))
+        return false;
 
     driver->hal.hdmaTx.Init.Direction = DMA_MEMORY_TO_PERIPH;
     driver->hal.hdmaTx.Init.PeriphInc = DMA_PINC_DISABLE;
@@ -133,7 +134,8 @@ bool iniciarDriverSDMMC(void)
     __HAL_LINKDMA(&driver->hal.hsdmmc, hdmatx, driver->hal.hdmaTx);
 
     // Configuracion del DMA para la recepcion
-    iniciarDMA(identificadorDMA(driver->hal.hdmaRx.Instance));
+    if (!iniciarDMA(identificadorDMA(driver->hal.hdmaRx.Instance), DMA_PROPIETARIO_SDMMC_RX, 0))
+        return false;
 
     driver->hal.hdmaRx.Init.Direction = DMA_PERIPH_TO_MEMORY;
     driver->hal.hdmaRx.Init.PeriphInc = DMA_PINC_DISABLE;
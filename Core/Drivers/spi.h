@@ -7,7 +7,7 @@
 **
 **  Autor: Ramon Rico
 **  Fecha de creacion: 12/05/2019
-**  Fecha de modificacion: 03/08/2020
+**  Fecha de modificacion: 17/10/2026
 **
 **  El proyecto URpilot NO es libre. No se puede distribuir y/o modificar este fichero
 **  bajo ningun concepto.
@@ -65,6 +65,13 @@ typedef enum {
 typedef struct {
     bool asignado;
 	SPI_HandleTypeDef hspi;
+#ifdef USAR_DMA_SPI
+    DMA_HandleTypeDef hdmaTx;
+    DMA_HandleTypeDef hdmaRx;
+#endif
+    bool usarDMA;
+    uint8_t IRQ;
+    uint8_t prioridadIRQ;
     pin_t pinSCK;
     pin_t pinMISO;
     pin_t pinMOSI;
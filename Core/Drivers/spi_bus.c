@@ -7,7 +7,7 @@
 **
 **  Autor: Ramon Rico
 **  Fecha de creacion: 12/05/2019
-**  Fecha de modificacion: 03/08/2020
+**  Fecha de modificacion: 17/10/2026
 **
 **  El proyecto URpilot NO es libre. No se puede distribuir y/o modificar este fichero
 **  bajo ningun concepto.
@@ -25,16 +25,21 @@
 /***************************************************************************************
 ** AREA DE INCLUDES                                                                   **
 ****************************************************************************************/
+#include <string.h>
+
 #include "spi.h"
 
 #if defined(USAR_SPI)
 #include "bus.h"
+#include "spi_bus.h"
 #include "io.h"
+#include "spi_cola.h"
 
 
 /***************************************************************************************
 ** AREA DE PREPROCESADOR                                                              **
 ****************************************************************************************/
+#define TAM_BUFFER_SINCRONO_BUS_SPI     288         // Registro y 255 datos redondeado a lineas de cache de 32 bytes
 
 
 /***************************************************************************************
@@ -50,6 +55,7 @@
 /***************************************************************************************
 ** AREA DE PROTOTIPOS DE FUNCION                                                      **
 ****************************************************************************************/
+bool transferirSincronoBusSPI(const bus_t *bus, uint8_t *buffer, uint16_t longitud);
 
 
 /***************************************************************************************
@@ -80,6 +86,37 @@ void drenarRecepcionBusSPI(const bus_t *bus)
 }
 
 
+/***************************************************************************************
+**  Nombre:         bool transferirSincronoBusSPI(const bus_t *bus, uint8_t *buffer, uint16_t longitud)
+**  Descripcion:    Encola una transaccion y espera a que termine. Las funciones bloqueantes
+**                  que manejan el CS pasan por la cola para no pisar a las transferencias
+**                  asincronas. No se puede llamar desde el callback de una transaccion
+**  Parametros:     Bus, buffer alineado a 32 bytes que se envia y donde queda la respuesta,
+**                  longitud del buffer
+**  Retorno:        True si ok
+****************************************************************************************/
+bool transferirSincronoBusSPI(const bus_t *bus, uint8_t *buffer, uint16_t longitud)
+{
+    transaccionSPI_t transaccion = {
+        .numSPI = bus->bus_u.spi.numSPI,
+        .pinCS = bus->bus_u.spi.pinCS,
+        .datoTx = buffer,
+        .datoRx = buffer,
+        .longitud = longitud,
+        .timeout = TIMEOUT_DEFECTO_TRANSACCION_SPI,
+    };
+
+    if (!encolarTransaccionSPI(&transaccion))
+        return false;
+
+    // El timeout de la cola garantiza la salida
+    while (!transaccionSPIterminada(&transaccion))
+        ;
+
+    return transaccion.estado == TRANSACCION_SPI_COMPLETADA;
+}
+
+
 /***************************************************************************************
 **  Nombre:         bool escribirRawBusSPI(const bus_t *bus, uint8_t byteTx)
 **  Descripcion:    Escribe un dato por el SPI sin gestionar el pin CS
@@ -94,18 +131,13 @@ bool escribirRawBusSPI(const bus_t *bus, uint8_t byteTx)
 
 /***************************************************************************************
 **  Nombre:         bool escribirBusSPI(const bus_t *bus, uint8_t byteTx)
-**  Descripcion:    Escribe un dato por el SPI
+**  Descripcion:    Escribe un dato por el SPI. Pasa por la cola
 **  Parametros:     Bus, dato a escribir
 **  Retorno:        True si ok
 ****************************************************************************************/
 bool escribirBusSPI(const bus_t *bus, uint8_t byteTx)
 {
-    bool estado;
-
-    escribirIO(bus->bus_u.spi.pinCS, false);
-    estado = escribirRawBusSPI(bus, byteTx);
-    escribirIO(bus->bus_u.spi.pinCS, true);
-    return estado;
+    return transferirBufferBusSPI(bus, &byteTx, NULL, 1);
 }
 
 
@@ -131,18 +163,13 @@ bool escribirRawRegistroBusSPI(const bus_t *bus, uint8_t reg, uint8_t byteTx)
 
 /***************************************************************************************
 **  Nombre:         bool escribirRegistroBusSPI(const bus_t *bus, uint8_t reg, uint8_t byteTx)
-**  Descripcion:    Escribe un dato en un registro por el SPI
+**  Descripcion:    Escribe un dato en un registro por el SPI. Pasa por la cola
 **  Parametros:     Bus, registro, dato a escribir
 **  Retorno:        True si ok
 ****************************************************************************************/
 bool escribirRegistroBusSPI(const bus_t *bus, uint8_t reg, uint8_t byteTx)
 {
-    bool estado;
-
-    escribirIO(bus->bus_u.spi.pinCS, false);
-    estado = escribirRawRegistroBusSPI(bus, reg, byteTx);
-    escribirIO(bus->bus_u.spi.pinCS, true);
-    return estado;
+    return escribirBufferRegistroBusSPI(bus, reg, &byteTx, 1);
 }
 
 
@@ -168,18 +195,20 @@ bool escribirRawBufferRegistroBusSPI(const bus_t *bus, uint8_t reg, uint8_t *dat
 
 /***************************************************************************************
 **  Nombre:         bool escribirBufferRegistroBusSPI(const bus_t *bus, uint8_t reg, uint8_t *datoTx, uint16_t longitud)
-**  Descripcion:    Escribe un buffer en un registro por el SPI
+**  Descripcion:    Escribe un buffer en un registro por el SPI. Pasa por la cola
 **  Parametros:     Bus, registro, buffer a escribir, longitud del buffer
 **  Retorno:        True si ok
 ****************************************************************************************/
 bool escribirBufferRegistroBusSPI(const bus_t *bus, uint8_t reg, uint8_t *datoTx, uint16_t longitud)
 {
-    bool estado;
+    uint8_t buffer[TAM_BUFFER_SINCRONO_BUS_SPI] __attribute__ ((aligned(32)));
 
-    escribirIO(bus->bus_u.spi.pinCS, false);
-    estado = escribirRawBufferRegistroBusSPI(bus, reg, datoTx, longitud);
-    escribirIO(bus->bus_u.spi.pinCS, true);
-    return estado;
+    if (longitud >= TAM_BUFFER_SINCRONO_BUS_SPI)
+        return false;
+
+    buffer[0] = reg;
+    memcpy(&buffer[1], datoTx, longitud);
+    return transferirSincronoBusSPI(bus, buffer, longitud + 1);
 }
 
 
@@ -197,18 +226,13 @@ bool transferirRawBusSPI(const bus_t *bus, uint8_t byteTx, uint8_t *byteRx)
 
 /***************************************************************************************
 **  Nombre:         bool transferirBusSPI(const bus_t *bus, uint8_t byteTx, uint8_t *byteRx)
-**  Descripcion:    Lee y escribe un dato por el SPI
+**  Descripcion:    Lee y escribe un dato por el SPI. Pasa por la cola
 **  Parametros:     Bus, dato a escribir, dato leido
 **  Retorno:        True si ok
 ****************************************************************************************/
 bool transferirBusSPI(const bus_t *bus, uint8_t byteTx, uint8_t *byteRx)
 {
-    bool estado;
-
-    escribirIO(bus->bus_u.spi.pinCS, false);
-    estado = transferirRawBusSPI(bus, byteTx, byteRx);
-    escribirIO(bus->bus_u.spi.pinCS, true);
-    return estado;
+    return transferirBufferBusSPI(bus, &byteTx, byteRx, 1);
 }
 
 
@@ -226,18 +250,29 @@ bool transferirRawBufferBusSPI(const bus_t *bus, uint8_t *datoTx, uint8_t *datoR
 
 /***************************************************************************************
 **  Nombre:         bool transferirBufferBusSPI(const bus_t *bus, uint8_t *datoTx, uint8_t *datoRx, uint16_t longitud)
-**  Descripcion:    Lee y escribe un buffer por el SPI
+**  Descripcion:    Lee y escribe un buffer por el SPI. Pasa por la cola
 **  Parametros:     Bus, buffer a escribir, buffer de lectura, longitud de los buffer
 **  Retorno:        True si ok
 ****************************************************************************************/
 bool transferirBufferBusSPI(const bus_t *bus, uint8_t *datoTx, uint8_t *datoRx, uint16_t longitud)
 {
-    bool estado;
+    uint8_t buffer[TAM_BUFFER_SINCRONO_BUS_SPI] __attribute__ ((aligned(32)));
+
+    if (longitud > TAM_BUFFER_SINCRONO_BUS_SPI)
+        return false;
+
+    if (datoTx != NULL)
+        memcpy(buffer, datoTx, longitud);
+    else
+        memset(buffer, 0xFF, longitud);
+
+    if (!transferirSincronoBusSPI(bus, buffer, longitud))
+        return false;
+
+    if (datoRx != NULL)
+        memcpy(datoRx, buffer, longitud);
 
-    escribirIO(bus->bus_u.spi.pinCS, false);
-    estado = transferirRawBufferBusSPI(bus, datoTx, datoRx, longitud);
-    escribirIO(bus->bus_u.spi.pinCS, true);
-    return estado;
+    return true;
 }
 
 
@@ -255,18 +290,13 @@ bool leerRawRegistroBusSPI(const bus_t *bus, uint8_t reg, uint8_t *byteRx)
 
 /***************************************************************************************
 **  Nombre:         bool leerRegistroBusSPI(const bus_t *bus, uint8_t reg, uint8_t *byteRx)
-**  Descripcion:    Lee un registro por el SPI
+**  Descripcion:    Lee un registro por el SPI. Pasa por la cola
 **  Parametros:     Bus, registro, dato leido
 **  Retorno:        True si ok
 ****************************************************************************************/
 bool leerRegistroBusSPI(const bus_t *bus, uint8_t reg, uint8_t *byteRx)
 {
-    bool estado;
-
-    escribirIO(bus->bus_u.spi.pinCS, false);
-    estado = leerRawRegistroBusSPI(bus, reg, byteRx);
-    escribirIO(bus->bus_u.spi.pinCS, true);
-    return estado;
+    return leerBufferRegistroBusSPI(bus, reg, byteRx, 1);
 }
 
 
@@ -292,18 +322,67 @@ bool leerRawBufferRegistroBusSPI(const bus_t *bus, uint8_t reg, uint8_t *datoRx,
 
 /***************************************************************************************
 **  Nombre:         bool leerBufferRegistroBusSPI(const bus_t *bus, uint8_t reg, uint8_t *datoRx, uint16_t longitud)
-**  Descripcion:    Lee un buffer de un registro por el SPI
+**  Descripcion:    Lee un buffer de un registro por el SPI. Pasa por la cola
 **  Parametros:     Bus, registro, bufer de lectura, longitud del buffer
 **  Retorno:        True si ok
 ****************************************************************************************/
 bool leerBufferRegistroBusSPI(const bus_t *bus, uint8_t reg, uint8_t *datoRx, uint16_t longitud)
 {
-    bool estado;
+    uint8_t buffer[TAM_BUFFER_SINCRONO_BUS_SPI] __attribute__ ((aligned(32)));
 
-    escribirIO(bus->bus_u.spi.pinCS, false);
-    estado = leerRawBufferRegistroBusSPI(bus, reg, datoRx, longitud);
-    escribirIO(bus->bus_u.spi.pinCS, true);
-    return estado;
+    if (longitud >= TAM_BUFFER_SINCRONO_BUS_SPI)
+        return false;
+
+    buffer[0] = reg;
+    memset(&buffer[1], 0xFF, longitud);
+    if (!transferirSincronoBusSPI(bus, buffer, longitud + 1))
+        return false;
+
+    memcpy(datoRx, &buffer[1], longitud);
+    return true;
+}
+
+
+/***************************************************************************************
+**  Nombre:         void prepararTransaccionRegistroBusSPI(const bus_t *bus, transaccionSPI_t *transaccion, uint8_t reg,
+**                                                         uint8_t *buffer, uint16_t longitud, callbackTransaccionSPI callback,
+**                                                         void *paramUsuario)
+**  Descripcion:    Rellena una transaccion asincrona sobre un registro. Se envia el buffer entero
+**                  y la respuesta se guarda en el mismo buffer
+**  Parametros:     Bus, transaccion, registro, buffer de longitud + 1 bytes, longitud de los datos,
+**                  callback de fin y parametro del callback
+**  Retorno:        Ninguno
+****************************************************************************************/
+void prepararTransaccionRegistroBusSPI(const bus_t *bus, transaccionSPI_t *transaccion, uint8_t reg, uint8_t *buffer, uint16_t longitud,
+		                               callbackTransaccionSPI callback, void *paramUsuario)
+{
+    buffer[0] = reg;
+
+    transaccion->numSPI = bus->bus_u.spi.numSPI;
+    transaccion->pinCS = bus->bus_u.spi.pinCS;
+    transaccion->datoTx = buffer;
+    transaccion->datoRx = buffer;
+    transaccion->longitud = longitud + 1;
+    transaccion->timeout = TIMEOUT_DEFECTO_TRANSACCION_SPI;
+    transaccion->callback = callback;
+    transaccion->paramUsuario = paramUsuario;
+}
+
+
+/***************************************************************************************
+**  Nombre:         void prepararLecturaRegistroBusSPI(const bus_t *bus, transaccionSPI_t *transaccion, uint8_t reg,
+**                                                     uint8_t *buffer, uint16_t longitud, callbackTransaccionSPI callback,
+**                                                     void *paramUsuario)
+**  Descripcion:    Rellena una transaccion asincrona de lectura de un registro
+**  Parametros:     Bus, transaccion, registro, buffer de longitud + 1 bytes, longitud de los datos,
+**                  callback de fin y parametro del callback
+**  Retorno:        Ninguno
+****************************************************************************************/
+void prepararLecturaRegistroBusSPI(const bus_t *bus, transaccionSPI_t *transaccion, uint8_t reg, uint8_t *buffer, uint16_t longitud,
+		                           callbackTransaccionSPI callback, void *paramUsuario)
+{
+    memset(&buffer[1], 0xFF, longitud);
+    prepararTransaccionRegistroBusSPI(bus, transaccion, reg, buffer, longitud, callback, paramUsuario);
 }
 
 #endif
@@ -7,7 +7,7 @@
 **
 **  Autor: Ramon Rico
 **  Fecha de creacion: 12/05/2019
-**  Fecha de modificacion: 03/08/2020
+**  Fecha de modificacion: 17/10/2026
 **
 **  El proyecto URpilot NO es libre. No se puede distribuir y/o modificar este fichero
 **  bajo ningun concepto.
@@ -70,4 +70,9 @@ bool leerRegistroBusSPI(const bus_t *bus, uint8_t reg, uint8_t *byteRx);
 bool leerRawBufferRegistroBusSPI(const bus_t *bus, uint8_t reg, uint8_t *datoRx, uint16_t longitud);
 bool leerBufferRegistroBusSPI(const bus_t *bus, uint8_t reg, uint8_t *datoRx, uint16_t longitud);
 
+void prepararTransaccionRegistroBusSPI(const bus_t *bus, transaccionSPI_t *transaccion, uint8_t reg, uint8_t *buffer, uint16_t longitud,
+		                               callbackTransaccionSPI callback, void *paramUsuario);
+void prepararLecturaRegistroBusSPI(const bus_t *bus, transaccionSPI_t *transaccion, uint8_t reg, uint8_t *buffer, uint16_t longitud,
+		                           callbackTransaccionSPI callback, void *paramUsuario);
+
 #endif // __SPI_BUS_H
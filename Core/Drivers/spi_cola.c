@@ -0,0 +1,338 @@
+/***************************************************************************************
+**  spi_cola.c - Cola de transacciones asincronas del SPI. Cada bus tiene su cola. Las
+**               transferencias las lanza el HAL por DMA y el fin de cada una sube el CS
+**               y arranca la siguiente desde la propia interrupcion
+**
+**
+**  Este fichero forma parte del proyecto URpilot.
+**  Codigo desarrollado por el grupo de investigacion ICON de la Universidad de La Rioja
+**
+**  Autor: Ramon Rico
+**  Fecha de creacion: 17/10/2026
+**  Fecha de modificacion: 17/10/2026
+**
+**  El proyecto URpilot NO es libre. No se puede distribuir y/o modificar este fichero
+**  bajo ningun concepto.
+**
+**  En caso de modificacion y/o solicitud de informacion pongase en contacto con
+**  el grupo de investigacion ICON a traves de: www.unirioja.es/urpilot
+**
+**
+**  Control de versiones del fichero
+**
+**  v1.0  Ramon Rico. Se ha liberado la primera version estable
+**
+****************************************************************************************/
+
+/***************************************************************************************
+** AREA DE INCLUDES                                                                   **
+****************************************************************************************/
+#include <string.h>
+
+#include "spi_cola.h"
+
+#ifdef USAR_SPI
+#include "io.h"
+#include "tiempo.h"
+#ifndef SITL
+#include "atomico.h"
+#include "nvic.h"
+#endif
+
+
+/***************************************************************************************
+** AREA DE PREPROCESADOR                                                              **
+****************************************************************************************/
+// La cola se modifica desde el bucle principal y desde la interrupcion de fin de transferencia
+#ifdef SITL
+  #define BLOQUE_ATOMICO_COLA_SPI
+#else
+  #define BLOQUE_ATOMICO_COLA_SPI   BLOQUE_ATOMICO(NVIC_PRIO_SPI)
+#endif
+
+
+/***************************************************************************************
+** AREA DE DEFINICION DE TIPOS                                                        **
+****************************************************************************************/
+typedef struct {
+    transaccionSPI_t *actual;               // Transaccion en el bus
+    transaccionSPI_t *primera;              // Transacciones pendientes
+    transaccionSPI_t *ultima;
+    uint8_t longitud;
+    estadisticasColaSPI_t estadisticas;
+} colaSPI_t;
+
+
+/***************************************************************************************
+** AREA DE DECLARACION DE VARIABLES                                                   **
+****************************************************************************************/
+static colaSPI_t colaSPI[NUM_MAX_SPI];
+
+
+/***************************************************************************************
+** AREA DE PROTOTIPOS DE FUNCION                                                      **
+****************************************************************************************/
+void anadirTransaccionColaSPI(colaSPI_t *cola, transaccionSPI_t *transaccion);
+void arrancarSiguienteTransaccionSPI(numSPI_e numSPI);
+void terminarTransaccionSPI(numSPI_e numSPI, estadoTransaccionSPI_e estado);
+
+
+/***************************************************************************************
+** AREA DE DEFINICION DE FUNCIONES                                                    **
+****************************************************************************************/
+
+/***************************************************************************************
+**  Nombre:         void iniciarColaSPI(numSPI_e numSPI)
+**  Descripcion:    Vacia la cola de un bus
+**  Parametros:     Numero del SPI
+**  Retorno:        Ninguno
+****************************************************************************************/
+void iniciarColaSPI(numSPI_e numSPI)
+{
+    if (numSPI == SPI_NINGUNO)
+        return;
+
+    memset(&colaSPI[numSPI], 0, sizeof(colaSPI[numSPI]));
+}
+
+
+/***************************************************************************************
+**  Nombre:         bool encolarTransaccionSPI(transaccionSPI_t *transaccion)
+**  Descripcion:    Anade una transaccion al final de la cola de su bus. Si el bus esta
+**                  libre la transferencia empieza en el momento
+**  Parametros:     Transaccion
+**  Retorno:        False si la transaccion no es valida o todavia no ha terminado
+****************************************************************************************/
+bool encolarTransaccionSPI(transaccionSPI_t *transaccion)
+{
+    return encolarCadenaTransaccionesSPI(transaccion, 1);
+}
+
+
+/***************************************************************************************
+**  Nombre:         bool encolarCadenaTransaccionesSPI(transaccionSPI_t *transaccion, uint8_t numTransacciones)
+**  Descripcion:    Anade varias transacciones seguidas. Se ejecutan en orden sin que se
+**                  intercale ninguna otra del mismo bus encolada despues
+**  Parametros:     Array de transacciones, numero de transacciones
+**  Retorno:        False si alguna transaccion no es valida. En ese caso no se encola ninguna
+****************************************************************************************/
+bool encolarCadenaTransaccionesSPI(transaccionSPI_t *transaccion, uint8_t numTransacciones)
+{
+    for (uint8_t i = 0; i < numTransacciones; i++) {
+        const transaccionSPI_t *t = &transaccion[i];
+
+        if (t->numSPI == SPI_NINGUNO || t->numSPI >= NUM_MAX_SPI || t->longitud == 0 ||
+            t->estado == TRANSACCION_SPI_EN_COLA || t->estado == TRANSACCION_SPI_EN_CURSO)
+            return false;
+    }
+
+    if (numTransacciones == 0)
+        return true;
+
+    // Una transferencia colgada no debe bloquear las nuevas
+    comprobarTimeoutColaSPI(transaccion[0].numSPI, micros());
+
+    BLOQUE_ATOMICO_COLA_SPI {
+        for (uint8_t i = 0; i < numTransacciones; i++)
+            anadirTransaccionColaSPI(&colaSPI[transaccion[i].numSPI], &transaccion[i]);
+
+        for (uint8_t i = 0; i < numTransacciones; i++)
+            arrancarSiguienteTransaccionSPI(transaccion[i].numSPI);
+    }
+
+    return true;
+}
+
+
+/***************************************************************************************
+**  Nombre:         void anadirTransaccionColaSPI(colaSPI_t *cola, transaccionSPI_t *transaccion)
+**  Descripcion:    Anade una transaccion al final de la lista de pendientes
+**  Parametros:     Cola, transaccion
+**  Retorno:        Ninguno
+****************************************************************************************/
+void anadirTransaccionColaSPI(colaSPI_t *cola, transaccionSPI_t *transaccion)
+{
+    transaccion->siguiente = NULL;
+    transaccion->estado = TRANSACCION_SPI_EN_COLA;
+
+    if (cola->ultima != NULL)
+        cola->ultima->siguiente = transaccion;
+    else
+        cola->primera = transaccion;
+
+    cola->ultima = transaccion;
+    cola->longitud++;
+
+    if (cola->longitud > cola->estadisticas.longitudMaxCola)
+        cola->estadisticas.longitudMaxCola = cola->longitud;
+}
+
+
+/***************************************************************************************
+**  Nombre:         void arrancarSiguienteTransaccionSPI(numSPI_e numSPI)
+**  Descripcion:    Si el bus esta libre baja el CS de la primera transaccion pendiente y
+**                  lanza su transferencia. Si el periferico sigue ocupado con una transferencia
+**                  sin cola el arranque se aplaza, sin tocar el CS. Se llama con la cola
+**                  bloqueada o desde la interrupcion
+**  Parametros:     Numero del SPI
+**  Retorno:        Ninguno
+****************************************************************************************/
+void arrancarSiguienteTransaccionSPI(numSPI_e numSPI)
+{
+    colaSPI_t *cola = &colaSPI[numSPI];
+
+    while (cola->actual == NULL && cola->primera != NULL) {
+        // El CS solo se baja si el HAL va a aceptar la transferencia
+        if (perifericoOcupadoSPI(numSPI))
+            return;
+
+        transaccionSPI_t *transaccion = cola->primera;
+
+        cola->primera = transaccion->siguiente;
+        if (cola->primera == NULL)
+            cola->ultima = NULL;
+
+        cola->longitud--;
+        cola->actual = transaccion;
+
+        transaccion->estado = TRANSACCION_SPI_EN_CURSO;
+        transaccion->tiempoInicio = micros();
+        escribirIO(transaccion->pinCS, false);
+
+        // Si el HAL no acepta la transferencia se pasa a la siguiente
+        if (!iniciarTransferenciaAsincronaSPI(numSPI, transaccion->datoTx, transaccion->datoRx, transaccion->longitud))
+            terminarTransaccionSPI(numSPI, TRANSACCION_SPI_ERROR);
+    }
+}
+
+
+/***************************************************************************************
+**  Nombre:         void terminarTransaccionSPI(numSPI_e numSPI, estadoTransaccionSPI_e estado)
+**  Descripcion:    Sube el CS de la transaccion actual, la marca como terminada y avisa al
+**                  usuario. No arranca la siguiente
+**  Parametros:     Numero del SPI, estado final
+**  Retorno:        Ninguno
+****************************************************************************************/
+void terminarTransaccionSPI(numSPI_e numSPI, estadoTransaccionSPI_e estado)
+{
+    colaSPI_t *cola = &colaSPI[numSPI];
+    transaccionSPI_t *transaccion = cola->actual;
+
+    if (transaccion == NULL)
+        return;
+
+    escribirIO(transaccion->pinCS, true);
+
+    cola->actual = NULL;
+    cola->estadisticas.numTransacciones++;
+
+    if (estado == TRANSACCION_SPI_ERROR)
+        cola->estadisticas.numErrores++;
+    else if (estado == TRANSACCION_SPI_TIMEOUT)
+        cola->estadisticas.numTimeouts++;
+
+    transaccion->estado = estado;
+
+    // El callback puede encolar mas transacciones
+    if (transaccion->callback != NULL)
+        transaccion->callback(transaccion);
+}
+
+
+/***************************************************************************************
+**  Nombre:         void finalizarTransferenciaColaSPI(numSPI_e numSPI, bool ok)
+**  Descripcion:    Fin de la transferencia en curso. La llama el HAL desde la interrupcion
+**  Parametros:     Numero del SPI, si la transferencia ha ido bien
+**  Retorno:        Ninguno
+****************************************************************************************/
+void finalizarTransferenciaColaSPI(numSPI_e numSPI, bool ok)
+{
+    terminarTransaccionSPI(numSPI, ok ? TRANSACCION_SPI_COMPLETADA : TRANSACCION_SPI_ERROR);
+    arrancarSiguienteTransaccionSPI(numSPI);
+}
+
+
+/***************************************************************************************
+**  Nombre:         void comprobarTimeoutColaSPI(numSPI_e numSPI, uint32_t tiempoActual)
+**  Descripcion:    Aborta la transferencia en curso si ha superado su timeout y arranca la
+**                  siguiente si su arranque estaba aplazado
+**  Parametros:     Numero del SPI, tiempo actual en us
+**  Retorno:        Ninguno
+****************************************************************************************/
+void comprobarTimeoutColaSPI(numSPI_e numSPI, uint32_t tiempoActual)
+{
+    if (numSPI == SPI_NINGUNO)
+        return;
+
+    colaSPI_t *cola = &colaSPI[numSPI];
+
+    BLOQUE_ATOMICO_COLA_SPI {
+        transaccionSPI_t *transaccion = cola->actual;
+
+        if (transaccion != NULL && tiempoActual - transaccion->tiempoInicio > transaccion->timeout) {
+            abortarTransferenciaAsincronaSPI(numSPI);
+            terminarTransaccionSPI(numSPI, TRANSACCION_SPI_TIMEOUT);
+        }
+
+        arrancarSiguienteTransaccionSPI(numSPI);
+    }
+}
+
+
+/***************************************************************************************
+**  Nombre:         bool transaccionSPIterminada(transaccionSPI_t *transaccion)
+**  Descripcion:    Comprueba si una transaccion ha terminado. Sirve para recoger los
+**                  resultados sin callback
+**  Parametros:     Transaccion
+**  Retorno:        True si ha terminado, bien o mal. Ver el estado
+****************************************************************************************/
+bool transaccionSPIterminada(transaccionSPI_t *transaccion)
+{
+    if (transaccion->estado == TRANSACCION_SPI_EN_COLA || transaccion->estado == TRANSACCION_SPI_EN_CURSO)
+        comprobarTimeoutColaSPI(transaccion->numSPI, micros());
+
+    return transaccion->estado != TRANSACCION_SPI_EN_COLA && transaccion->estado != TRANSACCION_SPI_EN_CURSO;
+}
+
+
+/***************************************************************************************
+**  Nombre:         bool cadenaTransaccionesSPIterminada(transaccionSPI_t *transaccion, uint8_t numTransacciones)
+**  Descripcion:    Comprueba si han terminado todas las transacciones de una cadena
+**  Parametros:     Array de transacciones, numero de transacciones
+**  Retorno:        True si han terminado todas
+****************************************************************************************/
+bool cadenaTransaccionesSPIterminada(transaccionSPI_t *transaccion, uint8_t numTransacciones)
+{
+    for (uint8_t i = 0; i < numTransacciones; i++) {
+        if (!transaccionSPIterminada(&transaccion[i]))
+            return false;
+    }
+
+    return true;
+}
+
+
+/***************************************************************************************
+**  Nombre:         bool colaSPIocupada(numSPI_e numSPI)
+**  Descripcion:    Comprueba si la cola tiene transacciones en curso o pendientes
+**  Parametros:     Numero del SPI
+**  Retorno:        True si ocupada
+****************************************************************************************/
+bool colaSPIocupada(numSPI_e numSPI)
+{
+    return colaSPI[numSPI].actual != NULL || colaSPI[numSPI].primera != NULL;
+}
+
+
+/***************************************************************************************
+**  Nombre:         void estadisticasColaSPI(numSPI_e numSPI, estadisticasColaSPI_t *estadisticas)
+**  Descripcion:    Devuelve las estadisticas de la cola
+**  Parametros:     Numero del SPI, estadisticas
+**  Retorno:        Ninguno
+****************************************************************************************/
+void estadisticasColaSPI(numSPI_e numSPI, estadisticasColaSPI_t *estadisticas)
+{
+    *estadisticas = colaSPI[numSPI].estadisticas;
+}
+
+#endif
@@ -0,0 +1,105 @@
+/***************************************************************************************
+**  spi_cola.h - Cola de transacciones asincronas del SPI
+**
+**
+**  Este fichero forma parte del proyecto URpilot.
+**  Codigo desarrollado por el grupo de investigacion ICON de la Universidad de La Rioja
+**
+**  Autor: Ramon Rico
+**  Fecha de creacion: 17/10/2026
+**  Fecha de modificacion: 17/10/2026
+**
+**  El proyecto URpilot NO es libre. No se puede distribuir y/o modificar este fichero
+**  bajo ningun concepto.
+**
+**  En caso de modificacion y/o solicitud de informacion pongase en contacto con
+**  el grupo de investigacion ICON a traves de: www.unirioja.es/urpilot
+**
+**
+**  Control de versiones del fichero
+**
+**  v1.0  Ramon Rico. Se ha liberado la primera version estable
+**
+****************************************************************************************/
+
+#ifndef __SPI_COLA_H
+#define __SPI_COLA_H
+
+/***************************************************************************************
+** AREA DE INCLUDES                                                                   **
+****************************************************************************************/
+#include <stdint.h>
+#include <stdbool.h>
+
+#include "spi.h"
+
+
+/***************************************************************************************
+** AREA DE PREPROCESADOR                                                              **
+****************************************************************************************/
+#define TIMEOUT_DEFECTO_TRANSACCION_SPI     1000        // us
+
+
+/***************************************************************************************
+** AREA DE DEFINICION DE TIPOS                                                        **
+****************************************************************************************/
+typedef enum {
+    TRANSACCION_SPI_LIBRE = 0,
+    TRANSACCION_SPI_EN_COLA,
+    TRANSACCION_SPI_EN_CURSO,
+    TRANSACCION_SPI_COMPLETADA,
+    TRANSACCION_SPI_ERROR,
+    TRANSACCION_SPI_TIMEOUT,
+} estadoTransaccionSPI_e;
+
+struct transaccionSPI_s;
+typedef void (*callbackTransaccionSPI)(struct transaccionSPI_s *transaccion);
+
+// La memoria de la transaccion y de sus buffers es del usuario y no se puede tocar hasta que termine.
+// Con DMA los buffers deben estar alineados a 32 bytes por la cache de datos
+typedef struct transaccionSPI_s {
+    numSPI_e numSPI;
+    uint8_t pinCS;
+    uint8_t *datoTx;
+    uint8_t *datoRx;                        // Puede ser el mismo buffer que datoTx
+    uint16_t longitud;
+    uint32_t timeout;                       // us
+    callbackTransaccionSPI callback;        // Se llama en la interrupcion de fin de transferencia. Puede ser NULL
+    void *paramUsuario;
+    volatile estadoTransaccionSPI_e estado;
+    uint32_t tiempoInicio;
+    struct transaccionSPI_s *siguiente;
+} transaccionSPI_t;
+
+typedef struct {
+    uint32_t numTransacciones;
+    uint16_t numErrores;
+    uint16_t numTimeouts;
+    uint8_t longitudMaxCola;
+} estadisticasColaSPI_t;
+
+
+/***************************************************************************************
+** AREA DE DECLARACION DE VARIABLES                                                   **
+****************************************************************************************/
+
+
+/***************************************************************************************
+** AREA DE PROTOTIPOS DE FUNCION                                                      **
+****************************************************************************************/
+void iniciarColaSPI(numSPI_e numSPI);
+bool encolarTransaccionSPI(transaccionSPI_t *transaccion);
+bool encolarCadenaTransaccionesSPI(transaccionSPI_t *transaccion, uint8_t numTransacciones);
+bool transaccionSPIterminada(transaccionSPI_t *transaccion);
+bool cadenaTransaccionesSPIterminada(transaccionSPI_t *transaccion, uint8_t numTransacciones);
+bool colaSPIocupada(numSPI_e numSPI);
+void finalizarTransferenciaColaSPI(numSPI_e numSPI, bool ok);
+void comprobarTimeoutColaSPI(numSPI_e numSPI, uint32_t tiempoActual);
+void estadisticasColaSPI(numSPI_e numSPI, estadisticasColaSPI_t *estadisticas);
+
+// Implementadas por el HAL (spi_hal.c) o por el simulador
+bool perifericoOcupadoSPI(numSPI_e numSPI);
+bool iniciarTransferenciaAsincronaSPI(numSPI_e numSPI, uint8_t *datoTx, uint8_t *datoRx, uint16_t longitud);
+void abortarTransferenciaAsincronaSPI(numSPI_e numSPI);
+
+#endif // __SPI_COLA_H
@@ -7,7 +7,7 @@
 **
 **  Autor: Ramon Rico
 **  Fecha de creacion: 12/05/2019
-**  Fecha de modificacion: 03/08/2020
+**  Fecha de modificacion: 17/10/2026
 **
 **  El proyecto URpilot NO es libre. No se puede distribuir y/o modificar este fichero
 **  bajo ningun concepto.
@@ -32,6 +32,9 @@
 #ifdef USAR_SPI
 #include "GP/gp_spi.h"
 #include "io.h"
+#include "dma.h"
+#include "nvic.h"
+#include "spi_cola.h"
 #include "Comun/matematicas.h"
 
 
@@ -57,6 +60,10 @@
 void ajustarPrescalerBaudrateSPI(SPI_TypeDef *SPIx, uint32_t BaudRate);
 uint32_t nivelFifoTxSPI(SPI_TypeDef *SPIx);
 void habilitarRelojSPI(numSPI_e numSPI);
+bool iniciarDMAspi(numSPI_e numSPI);
+void handlerIrqDMAspi(descriptorCanalDMA_t *descriptor);
+numSPI_e numSPIhandler(SPI_HandleTypeDef *hspi);
+void handlerIrqSPI(numSPI_e numSPI);
 
 
 /***************************************************************************************
@@ -111,7 +118,80 @@ bool iniciarDriverSPI(numSPI_e numSPI)
     if (HAL_SPI_Init(&driver->hal.hspi) != HAL_OK)
         return false;
 
+    // La cola de transacciones usa el DMA si esta asignado y si no la interrupcion del SPI
+    if (driver->hal.usarDMA && !iniciarDMAspi(numSPI))
+        driver->hal.usarDMA = false;
+
+    HAL_NVIC_SetPriority(driver->hal.IRQ, PRIORIDAD_BASE_NVIC(driver->hal.prioridadIRQ), PRIORIDAD_SUB_NVIC(driver->hal.prioridadIRQ));
+    HAL_NVIC_EnableIRQ(driver->hal.IRQ);
+
+    return true;
+}
+
+
+/***************************************************************************************
+**  Nombre:         bool iniciarDMAspi(numSPI_e numSPI)
+**  Descripcion:    Configura los streams de DMA de envio y recepcion
+**  Parametros:     Dispositivo
+**  Retorno:        True si ok
+****************************************************************************************/
+bool iniciarDMAspi(numSPI_e numSPI)
+{
+#ifdef USAR_DMA_SPI
+    spi_t *driver = punteroSPI(numSPI);
+
+    // Configuracion del DMA para el envio. Si otro driver tiene alguno de los streams el bus va por interrupcion
+    const identificadorDMA_e dmaTx = identificadorDMA(driver->hal.hdmaTx.Instance);
+    const identificadorDMA_e dmaRx = identificadorDMA(driver->hal.hdmaRx.Instance);
+
+    if (!iniciarDMA(dmaTx, DMA_PROPIETARIO_SPI_TX, numSPI))
+        return false;
+
+    if (!iniciarDMA(dmaRx, DMA_PROPIETARIO_SPI_RX, numSPI)) {
+        liberarDMA(dmaTx);
+        return false;
+    }
+
+    driver->hal.hdmaTx.Init.Direction = DMA_MEMORY_TO_PERIPH;
+    driver->hal.hdmaTx.Init.PeriphInc = DMA_PINC_DISABLE;
+    driver->hal.hdmaTx.Init.MemInc = DMA_MINC_ENABLE;
+    driver->hal.hdmaTx.Init.PeriphDataAlignment = DMA_PDATAALIGN_BYTE;
+    driver->hal.hdmaTx.Init.MemDataAlignment = DMA_MDATAALIGN_BYTE;
+    driver->hal.hdmaTx.Init.Mode = DMA_NORMAL;
+    driver->hal.hdmaTx.Init.Priority = DMA_PRIORITY_HIGH;
+    driver->hal.hdmaTx.Init.FIFOMode = DMA_FIFOMODE_DISABLE;
+
+    if (HAL_DMA_Init(&driver->hal.hdmaTx) != HAL_OK)
+        return false;
+
+    __HAL_LINKDMA(&driver->hal.hspi, hdmatx, driver->hal.hdmaTx);
+
+    // Configuracion del DMA para la recepcion
+    driver->hal.hdmaRx.Init.Direction = DMA_PERIPH_TO_MEMORY;
+    driver->hal.hdmaRx.Init.PeriphInc = DMA_PINC_DISABLE;
+    driver->hal.hdmaRx.Init.MemInc = DMA_MINC_ENABLE;
+    driver->hal.hdmaRx.Init.PeriphDataAlignment = DMA_PDATAALIGN_BYTE;
+    driver->hal.hdmaRx.Init.MemDataAlignment = DMA_MDATAALIGN_BYTE;
+    driver->hal.hdmaRx.Init.Mode = DMA_NORMAL;
+    driver->hal.hdmaRx.Init.Priority = DMA_PRIORITY_HIGH;
+    driver->hal.hdmaRx.Init.FIFOMode = DMA_FIFOMODE_DISABLE;
+
+    if (HAL_DMA_Init(&driver->hal.hdmaRx) != HAL_OK)
+        return false;
+
+    __HAL_LINKDMA(&driver->hal.hspi, hdmarx, driver->hal.hdmaRx);
+
+    if (!ajustarHandlerDMA(dmaTx, handlerIrqDMAspi, NVIC_PRIO_SPI, numSPI) || !ajustarHandlerDMA(dmaRx, handlerIrqDMAspi, NVIC_PRIO_SPI, numSPI)) {
+        liberarDMA(dmaTx);
+        liberarDMA(dmaRx);
+        return false;
+    }
+
     return true;
+#else
+    UNUSED(numSPI);
+    return false;
+#endif
 }
 
 
@@ -208,6 +288,55 @@ CODIGO_RAPIDO bool transferirBufferSPI(numSPI_e numSPI, uint8_t *datoTx, uint8_t
 }
 
 
+/***************************************************************************************
+**  Nombre:         bool iniciarTransferenciaAsincronaSPI(numSPI_e numSPI, uint8_t *datoTx, uint8_t *datoRx, uint16_t longitud)
+**  Descripcion:    Lanza una transferencia sin esperar a que termine. El fin lo notifica
+**                  HAL_SPI_TxRxCpltCallback o HAL_SPI_ErrorCallback a la cola
+**  Parametros:     Dispositivo, buffer a enviar, buffer a recibir, longitud de los buffer
+**  Retorno:        True si la transferencia ha empezado
+****************************************************************************************/
+CODIGO_RAPIDO bool iniciarTransferenciaAsincronaSPI(numSPI_e numSPI, uint8_t *datoTx, uint8_t *datoRx, uint16_t longitud)
+{
+    spi_t *driver = punteroSPI(numSPI);
+    HAL_StatusTypeDef estado;
+
+#ifdef USAR_DMA_SPI
+    if (driver->hal.usarDMA) {
+        // El DMA no pasa por la cache de datos
+        uint32_t dirAlineada = (uint32_t)datoTx & ~0x1F;
+        SCB_CleanDCache_by_Addr((uint32_t *)dirAlineada, longitud + ((uint32_t)datoTx - dirAlineada));
+
+        dirAlineada = (uint32_t)datoRx & ~0x1F;
+        SCB_CleanInvalidateDCache_by_Addr((uint32_t *)dirAlineada, longitud + ((uint32_t)datoRx - dirAlineada));
+
+        estado = HAL_SPI_TransmitReceive_DMA(&driver->hal.hspi, datoTx, datoRx, longitud);
+    }
+    else
+#endif
+        estado = HAL_SPI_TransmitReceive_IT(&driver->hal.hspi, datoTx, datoRx, longitud);
+
+    if (estado != HAL_OK) {
+        errorCallbackSPI(numSPI);
+        return false;
+    }
+
+    return true;
+}
+
+
+/***************************************************************************************
+**  Nombre:         void abortarTransferenciaAsincronaSPI(numSPI_e numSPI)
+**  Descripcion:    Aborta la transferencia en curso
+**  Parametros:     Dispositivo
+**  Retorno:        Ninguno
+****************************************************************************************/
+void abortarTransferenciaAsincronaSPI(numSPI_e numSPI)
+{
+    HAL_SPI_Abort(&punteroSPI(numSPI)->hal.hspi);
+    errorCallbackSPI(numSPI);
+}
+
+
 /***************************************************************************************
 **  Nombre:         void drenarBufferRecepcionSPI(numSPI_e numSPI)
 **  Descripcion:    Drena el buffer de recepcion
@@ -231,6 +360,23 @@ CODIGO_RAPIDO void drenarBufferRecepcionSPI(numSPI_e numSPI)
 **  Retorno:        True si ocupado
 ****************************************************************************************/
 CODIGO_RAPIDO bool ocupadoSPI(numSPI_e numSPI)
+{
+    // Las transferencias sincronas no se pueden meter entre las de la cola
+    if (colaSPIocupada(numSPI))
+        return true;
+
+    return perifericoOcupadoSPI(numSPI);
+}
+
+
+/***************************************************************************************
+**  Nombre:         bool perifericoOcupadoSPI(numSPI_e numSPI)
+**  Descripcion:    Comprueba si el periferico tiene una transferencia en marcha, sin mirar
+**                  la cola. Con el periferico libre el HAL acepta la siguiente transferencia
+**  Parametros:     Dispositivo
+**  Retorno:        True si ocupado
+****************************************************************************************/
+CODIGO_RAPIDO bool perifericoOcupadoSPI(numSPI_e numSPI)
 {
 	spi_t *driver = punteroSPI(numSPI);
 
@@ -328,4 +474,171 @@ void habilitarRelojSPI(numSPI_e numSPI)
     }
 }
 
+
+/***************************************************************************************
+**  Nombre:         numSPI_e numSPIhandler(SPI_HandleTypeDef *hspi)
+**  Descripcion:    Devuelve el numero de SPI de un handler del HAL
+**  Parametros:     Handler del SPI
+**  Retorno:        Numero del SPI
+****************************************************************************************/
+CODIGO_RAPIDO numSPI_e numSPIhandler(SPI_HandleTypeDef *hspi)
+{
+    for (uint8_t i = 0; i < NUM_MAX_SPI; i++) {
+        if (&punteroSPI(i)->hal.hspi == hspi)
+            return i;
+    }
+
+    return SPI_NINGUNO;
+}
+
+
+/***************************************************************************************
+**  Nombre:         void HAL_SPI_TxRxCpltCallback(SPI_HandleTypeDef *hspi)
+**  Descripcion:    Callback de la transferencia completa. Sube el CS y arranca la
+**                  siguiente transaccion de la cola
+**  Parametros:     Handler del SPI
+**  Retorno:        Ninguno
+****************************************************************************************/
+CODIGO_RAPIDO void HAL_SPI_TxRxCpltCallback(SPI_HandleTypeDef *hspi)
+{
+    const numSPI_e numSPI = numSPIhandler(hspi);
+
+    if (numSPI == SPI_NINGUNO)
+        return;
+
+#ifdef USAR_DMA_SPI
+    if (punteroSPI(numSPI)->hal.usarDMA) {
+        uint32_t dirAlineada = (uint32_t)hspi->pRxBuffPtr & ~0x1F;
+        SCB_InvalidateDCache_by_Addr((uint32_t *)dirAlineada, hspi->RxXferSize + ((uint32_t)hspi->pRxBuffPtr - dirAlineada));
+    }
+#endif
+
+    finalizarTransferenciaColaSPI(numSPI, true);
+}
+
+
+/***************************************************************************************
+**  Nombre:         void HAL_SPI_ErrorCallback(SPI_HandleTypeDef *hspi)
+**  Descripcion:    Callback de error en la transferencia
+**  Parametros:     Handler del SPI
+**  Retorno:        Ninguno
+****************************************************************************************/
+void HAL_SPI_ErrorCallback(SPI_HandleTypeDef *hspi)
+{
+    const numSPI_e numSPI = numSPIhandler(hspi);
+
+    if (numSPI == SPI_NINGUNO)
+        return;
+
+    errorCallbackSPI(numSPI);
+    finalizarTransferenciaColaSPI(numSPI, false);
+}
+
+
+/***************************************************************************************
+**  Nombre:         void handlerIrqDMAspi(descriptorCanalDMA_t *descriptor)
+**  Descripcion:    Interrupcion de los streams de DMA del SPI
+**  Parametros:     Descriptor del canal
+**  Retorno:        Ninguno
+****************************************************************************************/
+CODIGO_RAPIDO void handlerIrqDMAspi(descriptorCanalDMA_t *descriptor)
+{
+#ifdef USAR_DMA_SPI
+    spi_t *driver = punteroSPI(descriptor->paramUsuario);
+
+    if (descriptor->ref == driver->hal.hdmaRx.Instance)
+        HAL_DMA_IRQHandler(&driver->hal.hdmaRx);
+    else
+        HAL_DMA_IRQHandler(&driver->hal.hdmaTx);
+#else
+    UNUSED(descriptor);
+#endif
+}
+
+
+/***************************************************************************************
+**  Nombre:         void handlerIrqSPI(numSPI_e numSPI)
+**  Descripcion:    Interrupcion general del SPI
+**  Parametros:     Dispositivo
+**  Retorno:        Ninguno
+****************************************************************************************/
+CODIGO_RAPIDO void handlerIrqSPI(numSPI_e numSPI)
+{
+    HAL_SPI_IRQHandler(&punteroSPI(numSPI)->hal.hspi);
+}
+
+
+/***************************************************************************************
+**  Nombre:         void SPI1_IRQHandler(void)
+**  Descripcion:    Interrupcion general del SPI 1
+**  Parametros:     Ninguno
+**  Retorno:        Ninguno
+****************************************************************************************/
+CODIGO_RAPIDO void SPI1_IRQHandler(void)
+{
+    handlerIrqSPI(SPI_1);
+}
+
+
+/***************************************************************************************
+**  Nombre:         void SPI2_IRQHandler(void)
+**  Descripcion:    Interrupcion general del SPI 2
+**  Parametros:     Ninguno
+**  Retorno:        Ninguno
+****************************************************************************************/
+CODIGO_RAPIDO void SPI2_IRQHandler(void)
+{
+    handlerIrqSPI(SPI_2);
+}
+
+
+/***************************************************************************************
+**  Nombre:         void SPI3_IRQHandler(void)
+**  Descripcion:    Interrupcion general del SPI 3
+**  Parametros:     Ninguno
+**  Retorno:        Ninguno
+****************************************************************************************/
+CODIGO_RAPIDO void SPI3_IRQHandler(void)
+{
+    handlerIrqSPI(SPI_3);
+}
+
+
+#if defined(STM32F767xx)
+/***************************************************************************************
+**  Nombre:         void SPI4_IRQHandler(void)
+**  Descripcion:    Interrupcion general del SPI 4
+**  Parametros:     Ninguno
+**  Retorno:        Ninguno
+****************************************************************************************/
+CODIGO_RAPIDO void SPI4_IRQHandler(void)
+{
+    handlerIrqSPI(SPI_4);
+}
+
+
+/***************************************************************************************
+**  Nombre:         void SPI5_IRQHandler(void)
+**  Descripcion:    Interrupcion general del SPI 5
+**  Parametros:     Ninguno
+**  Retorno:        Ninguno
+****************************************************************************************/
+CODIGO_RAPIDO void SPI5_IRQHandler(void)
+{
+    handlerIrqSPI(SPI_5);
+}
+
+
+/***************************************************************************************
+**  Nombre:         void SPI6_IRQHandler(void)
+**  Descripcion:    Interrupcion general del SPI 6
+**  Parametros:     Ninguno
+**  Retorno:        Ninguno
+****************************************************************************************/
+CODIGO_RAPIDO void SPI6_IRQHandler(void)
+{
+    handlerIrqSPI(SPI_6);
+}
+#endif
+
 #endif
@@ -7,7 +7,7 @@
 **
 **  Autor: Ramon Rico
 **  Fecha de creacion: 25/07/2020
-**  Fecha de modificacion: 03/08/2020
+**  Fecha de modificacion: 17/10/2026
 **
 **  El proyecto URpilot NO es libre. No se puede distribuir y/o modificar este fichero
 **  bajo ningun concepto.
@@ -30,12 +30,15 @@
 #ifdef USAR_SPI
 #include "GP/gp_spi.h"
 #include "io.h"
+#include "dma.h"
+#include "nvic.h"
 
 
 /***************************************************************************************
 ** AREA DE PREPROCESADOR                                                              **
 ****************************************************************************************/
 #define NUM_MAX_PIN_SEL_SPI     5
+#define NUM_STREAMS_DMA_SPI     2
 
 
 /***************************************************************************************
@@ -47,6 +50,10 @@ typedef struct {
     pin_t pinSCK[NUM_MAX_PIN_SEL_SPI];
     pin_t pinMISO[NUM_MAX_PIN_SEL_SPI];
     pin_t pinMOSI[NUM_MAX_PIN_SEL_SPI];
+    canalStreamDMA_t dmaTx[NUM_STREAMS_DMA_SPI];
+    canalStreamDMA_t dmaRx[NUM_STREAMS_DMA_SPI];
+    uint8_t IRQ;
+    uint8_t prioridadIRQ;
 } hardwareSPI_t;
 
 
@@ -72,6 +79,16 @@ static const hardwareSPI_t hardwareSPI[] = {
             { DEFIO_TAG(PB5), GPIO_AF5_SPI1 },
             { DEFIO_TAG(PD7), GPIO_AF5_SPI1 },
         },
+        .dmaTx = {
+            { DMA2_Stream3, DMA_CHANNEL_3 },
+            { DMA2_Stream5, DMA_CHANNEL_3 },
+        },
+        .dmaRx = {
+            { DMA2_Stream0, DMA_CHANNEL_3 },
+            { DMA2_Stream2, DMA_CHANNEL_3 },
+        },
+        .IRQ = SPI1_IRQn,
+        .prioridadIRQ = NVIC_PRIO_SPI,
     },
     {
         .numSPI = SPI_2,
@@ -92,6 +109,14 @@ static const hardwareSPI_t hardwareSPI[] = {
             { DEFIO_TAG(PC1), GPIO_AF5_SPI2  },
             { DEFIO_TAG(PC3), GPIO_AF5_SPI2  },
         },
+        .dmaTx = {
+            { DMA1_Stream4, DMA_CHANNEL_0 },
+        },
+        .dmaRx = {
+            { DMA1_Stream3, DMA_CHANNEL_0 },
+        },
+        .IRQ = SPI2_IRQn,
+        .prioridadIRQ = NVIC_PRIO_SPI,
     },
     {
         .numSPI = SPI_3,
@@ -110,6 +135,16 @@ static const hardwareSPI_t hardwareSPI[] = {
             { DEFIO_TAG(PC12), GPIO_AF6_SPI3 },
             { DEFIO_TAG(PD6), GPIO_AF5_SPI3  },
         },
+        .dmaTx = {
+            { DMA1_Stream5, DMA_CHANNEL_0 },
+            { DMA1_Stream7, DMA_CHANNEL_0 },
+        },
+        .dmaRx = {
+            { DMA1_Stream0, DMA_CHANNEL_0 },
+            { DMA1_Stream2, DMA_CHANNEL_0 },
+        },
+        .IRQ = SPI3_IRQn,
+        .prioridadIRQ = NVIC_PRIO_SPI,
     },
 #if defined(STM32F767xx)
     {
@@ -127,6 +162,16 @@ static const hardwareSPI_t hardwareSPI[] = {
             { DEFIO_TAG(PE6), GPIO_AF5_SPI4  },
             { DEFIO_TAG(PE14), GPIO_AF5_SPI4 },
         },
+        .dmaTx = {
+            { DMA2_Stream1, DMA_CHANNEL_4 },
+            { DMA2_Stream4, DMA_CHANNEL_5 },
+        },
+        .dmaRx = {
+            { DMA2_Stream0, DMA_CHANNEL_4 },
+            { DMA2_Stream3, DMA_CHANNEL_5 },
+        },
+        .IRQ = SPI4_IRQn,
+        .prioridadIRQ = NVIC_PRIO_SPI,
     },
     {
         .numSPI = SPI_5,
@@ -141,6 +186,16 @@ static const hardwareSPI_t hardwareSPI[] = {
             { DEFIO_TAG(PF9), GPIO_AF5_SPI5  },
             { DEFIO_TAG(PF11), GPIO_AF5_SPI5 },
         },
+        .dmaTx = {
+            { DMA2_Stream4, DMA_CHANNEL_2 },
+            { DMA2_Stream6, DMA_CHANNEL_7 },
+        },
+        .dmaRx = {
+            { DMA2_Stream3, DMA_CHANNEL_2 },
+            { DMA2_Stream5, DMA_CHANNEL_7 },
+        },
+        .IRQ = SPI5_IRQn,
+        .prioridadIRQ = NVIC_PRIO_SPI,
     },
     {
         .numSPI = SPI_6,
@@ -160,6 +215,14 @@ static const hardwareSPI_t hardwareSPI[] = {
             { DEFIO_TAG(PB5), GPIO_AF8_SPI6  },
             { DEFIO_TAG(PG14), GPIO_AF5_SPI6 },
         },
+        .dmaTx = {
+            { DMA2_Stream5, DMA_CHANNEL_1 },
+        },
+        .dmaRx = {
+            { DMA2_Stream6, DMA_CHANNEL_1 },
+        },
+        .IRQ = SPI6_IRQn,
+        .prioridadIRQ = NVIC_PRIO_SPI,
     },
 #endif
 };
@@ -169,6 +232,7 @@ static const hardwareSPI_t hardwareSPI[] = {
 ** AREA DE PROTOTIPOS DE FUNCION                                                      **
 ****************************************************************************************/
 bool pinSPI(numSPI_e numSPI, uint8_t pinBusqueda, pin_t *pinDriver);
+bool canalStreamDMAspi(const canalStreamDMA_t *dma, DMA_Stream_TypeDef *DMAy_Streamx, uint32_t *canal);
 
 
 /***************************************************************************************
@@ -197,6 +261,26 @@ bool asignarHALspi(numSPI_e numSPI)
 
     // Asignamos la instancia
     driver->hal.hspi.Instance = hardwareSPI[numSPI].reg;
+
+    // Sin los dos streams validos las transacciones de la cola van por interrupcion
+    driver->hal.usarDMA = false;
+#ifdef USAR_DMA_SPI
+    uint32_t canalTx, canalRx;
+
+    if (canalStreamDMAspi(hardwareSPI[numSPI].dmaTx, configSPI(numSPI)->dmaTx, &canalTx) &&
+        canalStreamDMAspi(hardwareSPI[numSPI].dmaRx, configSPI(numSPI)->dmaRx, &canalRx)) {
+        driver->hal.hdmaTx.Instance = configSPI(numSPI)->dmaTx;
+        driver->hal.hdmaTx.Init.Channel = canalTx;
+        driver->hal.hdmaRx.Instance = configSPI(numSPI)->dmaRx;
+        driver->hal.hdmaRx.Init.Channel = canalRx;
+        driver->hal.usarDMA = true;
+    }
+#endif
+
+    // Asignamos las interrupciones
+    driver->hal.IRQ = hardwareSPI[numSPI].IRQ;
+    driver->hal.prioridadIRQ = hardwareSPI[numSPI].prioridadIRQ;
+
     return true;
 }
 
@@ -232,4 +316,26 @@ bool pinSPI(numSPI_e numSPI, uint8_t pinBusqueda, pin_t *pinDriver)
     return false;
 }
 
+
+/***************************************************************************************
+**  Nombre:         bool canalStreamDMAspi(const canalStreamDMA_t *dma, DMA_Stream_TypeDef *DMAy_Streamx, uint32_t *canal)
+**  Descripcion:    Busca el stream configurado en la tabla de hardware
+**  Parametros:     Streams posibles, stream configurado, canal del stream
+**  Retorno:        True si el stream es valido
+****************************************************************************************/
+bool canalStreamDMAspi(const canalStreamDMA_t *dma, DMA_Stream_TypeDef *DMAy_Streamx, uint32_t *canal)
+{
+    if (DMAy_Streamx == NULL)
+        return false;
+
+    for (uint8_t i = 0; i < NUM_STREAMS_DMA_SPI; i++) {
+        if (DMAy_Streamx == dma[i].DMAy_Streamx) {
+            *canal = dma[i].canal;
+            return true;
+        }
+    }
+
+    return false;
+}
+
 #endif // USAR_SPI
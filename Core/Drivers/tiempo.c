@@ -7,7 +7,7 @@
 **
 **  Autor: Ramon Rico
 **  Fecha de creacion: 03/12/2020
-**  Fecha de modificacion: 03/12/2020
+**  Fecha de modificacion: 17/10/2026
 **
 **  El proyecto URpilot NO es libre. No se puede distribuir y/o modificar este fichero
 **  bajo ningun concepto.
@@ -61,13 +61,32 @@ volatile int32_t sysTickPendiente = 0;
 /***************************************************************************************
 **  Nombre:         void iniciarContadorCiclos(void)
 **  Descripcion:    Inicia la variable que dicta los ciclos por microsegundo. Variable
-**                  utilizada en las funciones de tiempo
+**                  utilizada en las funciones de tiempo. Arranca tambien el contador de
+**                  ciclos del DWT
 **  Parametros:     Ninguno
 **  Retorno:        Ninguno
 ****************************************************************************************/
 void iniciarContadorCiclos(void)
 {
     usTicks = HAL_RCC_GetSysClockFreq() / 1000000;
+
+    // En el Cortex-M7 hay que desbloquear el DWT antes de habilitar el contador
+    CoreDebug->DEMCR |= CoreDebug_DEMCR_TRCENA_Msk;
+    DWT->LAR = 0xC5ACCE55;
+    DWT->CYCCNT = 0;
+    DWT->CTRL |= DWT_CTRL_CYCCNTENA_Msk;
+}
+
+
+/***************************************************************************************
+**  Nombre:         uint32_t ciclosPorMicro(void)
+**  Descripcion:    Retorna los ciclos de CPU por microsegundo
+**  Parametros:     Ninguno
+**  Retorno:        Ciclos por microsegundo
+****************************************************************************************/
+uint32_t ciclosPorMicro(void)
+{
+    return usTicks;
 }
 
 
@@ -7,7 +7,7 @@
 **
 **  Autor: Ramon Rico
 **  Fecha de creacion: 03/12/2020
-**  Fecha de modificacion: 03/12/2020
+**  Fecha de modificacion: 17/10/2026
 **
 **  El proyecto URpilot NO es libre. No se puede distribuir y/o modificar este fichero
 **  bajo ningun concepto.
@@ -61,5 +61,21 @@ uint32_t micros(void);
 uint32_t millis(void);
 void delayMicroseconds(uint32_t us);
 void delay(uint32_t ms);
+uint32_t ciclosPorMicro(void);                   // Ciclos del contador de ciclosCPU() por microsegundo
+
+#if !defined(SITL)
+/***************************************************************************************
+**  Nombre:         uint32_t ciclosCPU(void)
+**  Descripcion:    Retorna el contador de ciclos del DWT. Desborda cada ~20 s a 216 MHz
+**  Parametros:     Ninguno
+**  Retorno:        Ciclos de CPU
+****************************************************************************************/
+static inline uint32_t ciclosCPU(void)
+{
+    return DWT->CYCCNT;
+}
+#else
+uint32_t ciclosCPU(void);                        // En el SITL cuenta nanosegundos del reloj del host
+#endif
 
 #endif // __TIEMPO_H
@@ -7,7 +7,7 @@
 **
 **  Autor: Ramon Rico
 **  Fecha de creacion: 11/05/2019
-**  Fecha de modificacion: 03/08/2020
+**  Fecha de modificacion: 17/10/2026
 **
 **  El proyecto URpilot NO es libre. No se puede distribuir y/o modificar este fichero
 **  bajo ningun concepto.
@@ -31,6 +31,7 @@
 #include "uart.h"
 
 #ifdef USAR_UART
+#include "Comun/matematicas.h"
 
 
 /***************************************************************************************
@@ -53,6 +54,7 @@ static configIniUART_t configuracionUART[NUM_MAX_UART];
 /***************************************************************************************
 ** AREA DE PROTOTIPOS DE FUNCION                                                      **
 ****************************************************************************************/
+bool iniciarUARTcallbacks(numUART_e numUART, configIniUART_t configInicial, uartRxCallback rxCall, uartRxBloqueCallback rxBloqueCall);
 
 
 /***************************************************************************************
@@ -78,6 +80,34 @@ uart_t *punteroUART(numUART_e numUART)
 **  Retorno:        True si ok
 ****************************************************************************************/
 bool iniciarUART(numUART_e numUART, configIniUART_t configInicial, uartRxCallback rxCall)
+{
+    return iniciarUARTcallbacks(numUART, configInicial, rxCall, NULL);
+}
+
+
+/***************************************************************************************
+**  Nombre:         bool iniciarUARTbloques(numUART_e numUART, configIniUART_t configInicial,
+**                                          uartRxBloqueCallback rxBloqueCall)
+**  Descripcion:    Inicia la UART entregando los datos recibidos por bloques. Con DMA el
+**                  callback se llama con la linea en reposo y a mitad y final del buffer
+**  Parametros:     Dispositivo a iniciar, configuracion de la UART, callback de recepcion
+**  Retorno:        True si ok
+****************************************************************************************/
+bool iniciarUARTbloques(numUART_e numUART, configIniUART_t configInicial, uartRxBloqueCallback rxBloqueCall)
+{
+    return iniciarUARTcallbacks(numUART, configInicial, NULL, rxBloqueCall);
+}
+
+
+/***************************************************************************************
+**  Nombre:         bool iniciarUARTcallbacks(numUART_e numUART, configIniUART_t configInicial,
+**                                            uartRxCallback rxCall, uartRxBloqueCallback rxBloqueCall)
+**  Descripcion:    Inicia la UART con los callbacks de recepcion
+**  Parametros:     Dispositivo a iniciar, configuracion de la UART, callback por byte,
+**                  callback por bloques
+**  Retorno:        True si ok
+****************************************************************************************/
+bool iniciarUARTcallbacks(numUART_e numUART, configIniUART_t configInicial, uartRxCallback rxCall, uartRxBloqueCallback rxBloqueCall)
 {
     if (numUART == UART_NINGUNO) {
 #ifdef DEBUG
@@ -92,6 +122,7 @@ bool iniciarUART(numUART_e numUART, configIniUART_t configInicial, uartRxCallbac
     resetearContadorErrorUART(numUART);
     driver->iniciado = false;
     driver->rxCallback = rxCall;
+    driver->rxBloqueCallback = rxBloqueCall;
 
     // Cargamos la configuracion inicial
     configuracionUART[numUART] = configInicial;
@@ -177,4 +208,231 @@ void resetearContadorErrorUART(numUART_e numUART)
     uart[numUART].numErrores = 0;
 }
 
+
+/***************************************************************************************
+**  Nombre:         void procesarRxUART(numUART_e numUART, uint16_t cabeza)
+**  Descripcion:    Actualiza la cabeza del buffer de recepcion y entrega los datos nuevos a
+**                  los callbacks. Los datos que cruzan el final del buffer se entregan en dos
+**                  bloques contiguos. Sin callbacks los datos se quedan para leerUART
+**  Parametros:     Dispositivo, nueva cabeza del buffer
+**  Retorno:        Ninguno
+****************************************************************************************/
+CODIGO_RAPIDO void procesarRxUART(numUART_e numUART, uint16_t cabeza)
+{
+    uart_t *driver = &uart[numUART];
+
+    if (cabeza >= TAMANIO_BUFFER_RX_UART)
+        cabeza = 0;
+
+    driver->cabezaRxBuffer = cabeza;
+
+    if (driver->rxBloqueCallback == NULL && driver->rxCallback == NULL)
+        return;
+
+    uint16_t cola = driver->colaRxBuffer;
+
+    while (cola != cabeza) {
+        const uint16_t fin = cabeza > cola ? cabeza : TAMANIO_BUFFER_RX_UART;
+        const uint8_t *datos = (const uint8_t *)&driver->rxBuffer[cola];
+        const uint16_t longitud = fin - cola;
+
+        if (driver->rxBloqueCallback != NULL)
+            driver->rxBloqueCallback(datos, longitud);
+        else {
+            for (uint16_t i = 0; i < longitud; i++)
+                driver->rxCallback(datos[i]);
+        }
+
+        cola = fin >= TAMANIO_BUFFER_RX_UART ? 0 : fin;
+    }
+
+    driver->colaRxBuffer = cola;
+}
+
+
+/***************************************************************************************
+**  Nombre:         void escribirUART(numUART_e numUART, uint8_t byteTx)
+**  Descripcion:    Escribe un byte en la UART
+**  Parametros:     Dispositivo, dato
+**  Retorno:        Ninguno
+****************************************************************************************/
+CODIGO_RAPIDO void escribirUART(numUART_e numUART, uint8_t byteTx)
+{
+    escribirBufferUART(numUART, &byteTx, 1);
+}
+
+
+/***************************************************************************************
+**  Nombre:         uint16_t escribirBufferUART(numUART_e numUART, const uint8_t *datoTx, uint16_t longitud)
+**  Descripcion:    Copia un buffer en el buffer de transmision y arranca el envio. Lo que no
+**                  cabe se descarta
+**  Parametros:     Dispositivo, buffer, longitud del buffer
+**  Retorno:        Bytes escritos
+****************************************************************************************/
+CODIGO_RAPIDO uint16_t escribirBufferUART(numUART_e numUART, const uint8_t *datoTx, uint16_t longitud)
+{
+    uint16_t escritos = 0;
+
+    // Como mucho son dos copias: hasta el final del buffer y desde el principio
+    while (escritos < longitud) {
+        uint8_t *datos;
+        const uint16_t libres = MIN(reservarTxUART(numUART, &datos), longitud - escritos);
+
+        if (libres == 0)
+            break;
+
+        memcpy(datos, &datoTx[escritos], libres);
+        escritos += libres;
+        __sync_synchronize();
+        uart[numUART].cabezaTxBuffer = (uart[numUART].cabezaTxBuffer + libres) % TAMANIO_BUFFER_TX_UART;
+    }
+
+    if (escritos > 0)
+        iniciarTxUART(numUART);
+
+    return escritos;
+}
+
+
+/***************************************************************************************
+**  Nombre:         uint16_t reservarTxUART(numUART_e numUART, uint8_t **datos)
+**  Descripcion:    Reserva el bloque contiguo libre del buffer de transmision para escribir
+**                  sin copias. Los datos se envian al llamar a confirmarTxUART
+**  Parametros:     Dispositivo, puntero al bloque reservado
+**  Retorno:        Bytes disponibles en el bloque
+****************************************************************************************/
+CODIGO_RAPIDO uint16_t reservarTxUART(numUART_e numUART, uint8_t **datos)
+{
+    uart_t *driver = &uart[numUART];
+    const uint16_t cabeza = driver->cabezaTxBuffer;
+    const uint16_t cola = driver->colaTxBuffer;
+
+    *datos = &driver->txBuffer[cabeza];
+
+    // Se deja siempre un byte libre para distinguir el buffer lleno del vacio
+    if (cabeza >= cola)
+        return TAMANIO_BUFFER_TX_UART - cabeza - (cola == 0 ? 1 : 0);
+    else
+        return cola - cabeza - 1;
+}
+
+
+/***************************************************************************************
+**  Nombre:         void confirmarTxUART(numUART_e numUART, uint16_t longitud)
+**  Descripcion:    Confirma los bytes escritos en el bloque reservado y arranca el envio
+**  Parametros:     Dispositivo, bytes escritos (no mas de los reservados)
+**  Retorno:        Ninguno
+****************************************************************************************/
+CODIGO_RAPIDO void confirmarTxUART(numUART_e numUART, uint16_t longitud)
+{
+    if (longitud == 0)
+        return;
+
+    __sync_synchronize();
+    uart[numUART].cabezaTxBuffer = (uart[numUART].cabezaTxBuffer + longitud) % TAMANIO_BUFFER_TX_UART;
+    iniciarTxUART(numUART);
+}
+
+
+/***************************************************************************************
+**  Nombre:         uint16_t bloqueTxUART(numUART_e numUART, uint8_t **datos)
+**  Descripcion:    Devuelve el bloque contiguo pendiente de enviar. Si los datos cruzan el
+**                  final del buffer el bloque termina en el final
+**  Parametros:     Dispositivo, puntero al bloque
+**  Retorno:        Bytes del bloque
+****************************************************************************************/
+CODIGO_RAPIDO uint16_t bloqueTxUART(numUART_e numUART, uint8_t **datos)
+{
+    uart_t *driver = &uart[numUART];
+    const uint16_t cabeza = driver->cabezaTxBuffer;
+    const uint16_t cola = driver->colaTxBuffer;
+
+    *datos = &driver->txBuffer[cola];
+
+    if (cabeza >= cola)
+        return cabeza - cola;
+    else
+        return TAMANIO_BUFFER_TX_UART - cola;
+}
+
+
+/***************************************************************************************
+**  Nombre:         void liberarTxUART(numUART_e numUART, uint16_t longitud)
+**  Descripcion:    Libera los bytes enviados del buffer de transmision
+**  Parametros:     Dispositivo, bytes enviados
+**  Retorno:        Ninguno
+****************************************************************************************/
+CODIGO_RAPIDO void liberarTxUART(numUART_e numUART, uint16_t longitud)
+{
+    uart[numUART].colaTxBuffer = (uart[numUART].colaTxBuffer + longitud) % TAMANIO_BUFFER_TX_UART;
+}
+
+
+/***************************************************************************************
+**  Nombre:         uint16_t bloqueRxUART(numUART_e numUART, const uint8_t **datos)
+**  Descripcion:    Devuelve el bloque contiguo de datos recibidos para leerlos sin copias. Si
+**                  los datos cruzan el final del buffer el bloque termina en el final. Los
+**                  datos se quedan en el buffer hasta llamar a liberarRxUART
+**  Parametros:     Dispositivo, puntero al bloque
+**  Retorno:        Bytes del bloque
+****************************************************************************************/
+CODIGO_RAPIDO uint16_t bloqueRxUART(numUART_e numUART, const uint8_t **datos)
+{
+    uart_t *driver = &uart[numUART];
+
+    // Actualiza la cabeza con la posicion del DMA
+    bytesRecibidosUART(numUART);
+
+    const uint16_t cabeza = driver->cabezaRxBuffer;
+    const uint16_t cola = driver->colaRxBuffer;
+
+    *datos = (const uint8_t *)&driver->rxBuffer[cola];
+
+    if (cabeza >= cola)
+        return cabeza - cola;
+    else
+        return TAMANIO_BUFFER_RX_UART - cola;
+}
+
+
+/***************************************************************************************
+**  Nombre:         void liberarRxUART(numUART_e numUART, uint16_t longitud)
+**  Descripcion:    Libera los bytes leidos del buffer de recepcion
+**  Parametros:     Dispositivo, bytes leidos (no mas de los del bloque)
+**  Retorno:        Ninguno
+****************************************************************************************/
+CODIGO_RAPIDO void liberarRxUART(numUART_e numUART, uint16_t longitud)
+{
+    uart[numUART].colaRxBuffer = (uart[numUART].colaRxBuffer + longitud) % TAMANIO_BUFFER_RX_UART;
+}
+
+
+/***************************************************************************************
+**  Nombre:         bool bufferTxVacioUART(numUART_e numUART)
+**  Descripcion:    Comprueba si el buffer de transmision esta vacio
+**  Parametros:     Dispositivo
+**  Retorno:        True si vacio
+****************************************************************************************/
+CODIGO_RAPIDO bool bufferTxVacioUART(numUART_e numUART)
+{
+    return uart[numUART].colaTxBuffer == uart[numUART].cabezaTxBuffer;
+}
+
+
+/***************************************************************************************
+**  Nombre:         uint16_t bytesLibresBufferTxUART(numUART_e numUART)
+**  Descripcion:    Retorna el numero de bytes libres en el buffer de transmision
+**  Parametros:     Dispositivo
+**  Retorno:        Numero de bytes libres
+****************************************************************************************/
+CODIGO_RAPIDO uint16_t bytesLibresBufferTxUART(numUART_e numUART)
+{
+    uart_t *driver = &uart[numUART];
+
+    if (driver->cabezaTxBuffer >= driver->colaTxBuffer)
+        return TAMANIO_BUFFER_TX_UART - 1 - driver->cabezaTxBuffer + driver->colaTxBuffer;
+
+    return driver->colaTxBuffer - driver->cabezaTxBuffer - 1;
+}
+
 #endif
@@ -7,7 +7,7 @@
 **
 **  Autor: Ramon Rico
 **  Fecha de creacion: 11/05/2019
-**  Fecha de modificacion: 03/08/2020
+**  Fecha de modificacion: 17/10/2026
 **
 **  El proyecto URpilot NO es libre. No se puede distribuir y/o modificar este fichero
 **  bajo ningun concepto.
@@ -105,17 +105,25 @@ typedef struct {
 } halUART_t;
 
 typedef void (*uartRxCallback)(uint8_t dato);
+typedef void (*uartRxBloqueCallback)(const uint8_t *datos, uint16_t longitud);
 
 typedef struct {
+    // En modo DMA el buffer de recepcion lo escribe el DMA de forma circular. Va el primero y alineado
+    // a 32 bytes para poder invalidar la cache de datos sin tocar otros campos
+    volatile uint8_t rxBuffer[TAMANIO_BUFFER_RX_UART] __attribute__((aligned(32)));
+    // El buffer de transmision lo lee el DMA por bloques contiguos
+    uint8_t txBuffer[TAMANIO_BUFFER_TX_UART] __attribute__((aligned(32)));
 	bool iniciado;
+    bool rxDMA;
+    bool txDMA;
     halUART_t hal;
     uartRxCallback rxCallback;
-    volatile uint16_t rxBuffer[TAMANIO_BUFFER_RX_UART];
-    volatile uint16_t txBuffer[TAMANIO_BUFFER_TX_UART];
+    uartRxBloqueCallback rxBloqueCallback;
     volatile uint16_t cabezaRxBuffer;
     volatile uint16_t colaRxBuffer;
     volatile uint16_t cabezaTxBuffer;
     volatile uint16_t colaTxBuffer;
+    volatile uint16_t longitudTxDMA;                // Bytes de la transferencia en curso
     volatile uint16_t numErrores;
 } uart_t;
 
@@ -131,16 +139,25 @@ typedef struct {
 uart_t *punteroUART(numUART_e numUART);
 bool asignarHALuart(numUART_e numUART);
 bool iniciarUART(numUART_e numUART, configIniUART_t configInicial, uartRxCallback rxCall);
+bool iniciarUARTbloques(numUART_e numUART, configIniUART_t configInicial, uartRxBloqueCallback rxBloqueCall);
 bool uartIniciada(numUART_e numUART);
 bool iniciarDriverUART(numUART_e numUART, configIniUART_t configInicial);
 bool ajustarBaudRateUART(numUART_e numUART, uint32_t baudrate);
 void errorCallbackUART(numUART_e numUART);
 uint16_t contadorErrorUART(numUART_e numUART);
 void resetearContadorErrorUART(numUART_e numUART);
+void procesarRxUART(numUART_e numUART, uint16_t cabeza);
 
 void escribirUART(numUART_e numUART, uint8_t byteTx);
-void escribirBufferUART(numUART_e numUART, uint8_t *datoTx, uint16_t longitud);
+uint16_t escribirBufferUART(numUART_e numUART, const uint8_t *datoTx, uint16_t longitud);
+uint16_t reservarTxUART(numUART_e numUART, uint8_t **datos);
+void confirmarTxUART(numUART_e numUART, uint16_t longitud);
+uint16_t bloqueTxUART(numUART_e numUART, uint8_t **datos);
+void liberarTxUART(numUART_e numUART, uint16_t longitud);
+void iniciarTxUART(numUART_e numUART);
 int16_t leerUART(numUART_e numUART);
+uint16_t bloqueRxUART(numUART_e numUART, const uint8_t **datos);
+void liberarRxUART(numUART_e numUART, uint16_t longitud);
 void leerBufferUART(numUART_e numUART, int16_t *datoRx, uint16_t longitud);
 uint16_t bytesRecibidosUART(numUART_e numUART);
 bool bufferTxVacioUART(numUART_e numUART);
@@ -7,7 +7,7 @@
 **
 **  Autor: Ramon Rico
 **  Fecha de creacion: 11/05/2019
-**  Fecha de modificacion: 03/08/2020
+**  Fecha de modificacion: 17/10/2026
 **
 **  El proyecto URpilot NO es libre. No se puede distribuir y/o modificar este fichero
 **  bajo ningun concepto.
@@ -30,6 +30,8 @@
 #ifdef USAR_UART
 #include "io.h"
 #include "nvic.h"
+#include "dma.h"
+#include "atomico.h"
 #include "GP/gp_uart.h"
 
 
@@ -53,6 +55,13 @@
 ****************************************************************************************/
 void handlerIrqUART(numUART_e numUART);
 void habilitarRelojUART(numUART_e numUART);
+bool iniciarRxDMAuart(numUART_e numUART);
+void handlerIrqDMAuart(descriptorCanalDMA_t *descriptor);
+uint16_t cabezaRxDMAuart(numUART_e numUART);
+bool iniciarTxDMAuart(numUART_e numUART);
+void txDMAcompletadaUART(DMA_HandleTypeDef *hdma);
+void txDMAerrorUART(DMA_HandleTypeDef *hdma);
+numUART_e numUARTdmaTx(DMA_HandleTypeDef *hdma);
 
 
 /***************************************************************************************
@@ -128,6 +137,18 @@ bool iniciarDriverUART(numUART_e numUART, configIniUART_t configInicial)
     // Habilitamos la interrupcion por error de: (Frame error, noise error, overrun error)
     __HAL_UART_ENABLE_IT(&driver->hal.huart, UART_IT_ERR);
 
+    // Si el stream lo tiene otro driver (p.e. los motores en DSHOT) el puerto sigue por interrupcion
+    if (driver->txDMA && !iniciarTxDMAuart(numUART))
+        driver->txDMA = false;
+
+    // Con DMA la recepcion no genera interrupciones por byte
+    if (driver->rxDMA) {
+        if (iniciarRxDMAuart(numUART))
+            return true;
+
+        driver->rxDMA = false;
+    }
+
     // Habilitamos la interrupcion de registro de datos recibidos no vacio
     __HAL_UART_ENABLE_IT(&driver->hal.huart, UART_IT_RXNE);
 
@@ -136,51 +157,294 @@ bool iniciarDriverUART(numUART_e numUART, configIniUART_t configInicial)
 
 
 /***************************************************************************************
-**  Nombre:         void flushUART(numUART_e numUART)
-**  Descripcion:    Borra el Buffer de recepcion de la UART
+**  Nombre:         bool iniciarRxDMAuart(numUART_e numUART)
+**  Descripcion:    Arranca la recepcion por DMA circular sobre el buffer de recepcion. Si hay
+**                  callbacks se habilitan las interrupciones de linea en reposo y de mitad y
+**                  final del buffer. Si no, el buffer se lee por polling con leerUART
 **  Parametros:     Dispositivo
-**  Retorno:        Ninguno
+**  Retorno:        True si ok
 ****************************************************************************************/
-CODIGO_RAPIDO void flushUART(numUART_e numUART)
+bool iniciarRxDMAuart(numUART_e numUART)
 {
+#ifdef USAR_DMA_UART
     uart_t *driver = punteroUART(numUART);
 
-    driver->colaRxBuffer = 0;
+    // Al cambiar el baudrate el stream ya esta en marcha
+    if (driver->hal.hdmaRx.State == HAL_DMA_STATE_BUSY)
+        HAL_DMA_Abort(&driver->hal.hdmaRx);
+
+    const identificadorDMA_e dmaRx = identificadorDMA(driver->hal.hdmaRx.Instance);
+    if (!iniciarDMA(dmaRx, DMA_PROPIETARIO_UART_RX, numUART))
+        return false;
+
+    driver->hal.hdmaRx.Init.Direction = DMA_PERIPH_TO_MEMORY;
+    driver->hal.hdmaRx.Init.PeriphInc = DMA_PINC_DISABLE;
+    driver->hal.hdmaRx.Init.MemInc = DMA_MINC_ENABLE;
+    driver->hal.hdmaRx.Init.PeriphDataAlignment = DMA_PDATAALIGN_BYTE;
+    driver->hal.hdmaRx.Init.MemDataAlignment = DMA_MDATAALIGN_BYTE;
+    driver->hal.hdmaRx.Init.Mode = DMA_CIRCULAR;
+    driver->hal.hdmaRx.Init.Priority = DMA_PRIORITY_MEDIUM;
+    driver->hal.hdmaRx.Init.FIFOMode = DMA_FIFOMODE_DISABLE;
+
+    if (HAL_DMA_Init(&driver->hal.hdmaRx) != HAL_OK) {
+        liberarDMA(dmaRx);
+        return false;
+    }
+
+    __HAL_LINKDMA(&driver->hal.huart, hdmarx, driver->hal.hdmaRx);
+
     driver->cabezaRxBuffer = 0;
+    driver->colaRxBuffer = 0;
+    SCB_InvalidateDCache_by_Addr((uint32_t *)driver->rxBuffer, TAMANIO_BUFFER_RX_UART);
 
-    for (uint16_t i = 0; i < TAMANIO_BUFFER_RX_UART; i++)
-    	driver->rxBuffer[i] = 0;
+    if (driver->rxCallback != NULL || driver->rxBloqueCallback != NULL) {
+        if (!ajustarHandlerDMA(dmaRx, handlerIrqDMAuart, driver->hal.prioridadIRQ, numUART)) {
+            liberarDMA(dmaRx);
+            return false;
+        }
+    }
+
+    if (HAL_DMA_Start(&driver->hal.hdmaRx, (uint32_t)&driver->hal.huart.Instance->RDR, (uint32_t)driver->rxBuffer, TAMANIO_BUFFER_RX_UART) != HAL_OK) {
+        liberarDMA(dmaRx);
+        return false;
+    }
+
+    if (driver->rxCallback != NULL || driver->rxBloqueCallback != NULL) {
+        __HAL_DMA_ENABLE_IT(&driver->hal.hdmaRx, DMA_IT_HT | DMA_IT_TC | DMA_IT_TE);
+
+        __HAL_UART_CLEAR_IT(&driver->hal.huart, UART_CLEAR_IDLEF);
+        __HAL_UART_ENABLE_IT(&driver->hal.huart, UART_IT_IDLE);
+    }
+
+    SET_BIT(driver->hal.huart.Instance->CR3, USART_CR3_DMAR);
+
+    return true;
+#else
+    UNUSED(numUART);
+    return false;
+#endif
+}
+
+
+/***************************************************************************************
+**  Nombre:         bool iniciarTxDMAuart(numUART_e numUART)
+**  Descripcion:    Configura el stream de DMA de transmision. Descarta lo pendiente de enviar
+**  Parametros:     Dispositivo
+**  Retorno:        True si ok
+****************************************************************************************/
+bool iniciarTxDMAuart(numUART_e numUART)
+{
+#ifdef USAR_DMA_UART
+    uart_t *driver = punteroUART(numUART);
+
+    // Al cambiar el baudrate puede haber una transferencia en marcha
+    if (driver->hal.hdmaTx.State == HAL_DMA_STATE_BUSY)
+        HAL_DMA_Abort(&driver->hal.hdmaTx);
+
+    driver->longitudTxDMA = 0;
+    driver->cabezaTxBuffer = 0;
+    driver->colaTxBuffer = 0;
+
+    const identificadorDMA_e dmaTx = identificadorDMA(driver->hal.hdmaTx.Instance);
+    if (!iniciarDMA(dmaTx, DMA_PROPIETARIO_UART_TX, numUART))
+        return false;
+
+    driver->hal.hdmaTx.Init.Direction = DMA_MEMORY_TO_PERIPH;
+    driver->hal.hdmaTx.Init.PeriphInc = DMA_PINC_DISABLE;
+    driver->hal.hdmaTx.Init.MemInc = DMA_MINC_ENABLE;
+    driver->hal.hdmaTx.Init.PeriphDataAlignment = DMA_PDATAALIGN_BYTE;
+    driver->hal.hdmaTx.Init.MemDataAlignment = DMA_MDATAALIGN_BYTE;
+    driver->hal.hdmaTx.Init.Mode = DMA_NORMAL;
+    driver->hal.hdmaTx.Init.Priority = DMA_PRIORITY_LOW;
+    driver->hal.hdmaTx.Init.FIFOMode = DMA_FIFOMODE_DISABLE;
+
+    if (HAL_DMA_Init(&driver->hal.hdmaTx) != HAL_OK) {
+        liberarDMA(dmaTx);
+        return false;
+    }
+
+    __HAL_LINKDMA(&driver->hal.huart, hdmatx, driver->hal.hdmaTx);
+    driver->hal.hdmaTx.XferCpltCallback = txDMAcompletadaUART;
+    driver->hal.hdmaTx.XferErrorCallback = txDMAerrorUART;
+
+    if (!ajustarHandlerDMA(dmaTx, handlerIrqDMAuart, driver->hal.prioridadIRQ, numUART)) {
+        liberarDMA(dmaTx);
+        return false;
+    }
+
+    SET_BIT(driver->hal.huart.Instance->CR3, USART_CR3_DMAT);
+
+    return true;
+#else
+    UNUSED(numUART);
+    return false;
+#endif
 }
 
 
 /***************************************************************************************
-**  Nombre:         void escribirUART(numUART_e numUART, uint8_t byteTx)
-**  Descripcion:    Escribe un byte en la UART
-**  Parametros:     Dispositivo, dato
+**  Nombre:         void iniciarTxUART(numUART_e numUART)
+**  Descripcion:    Arranca el envio de lo pendiente. Con DMA se envia el bloque contiguo en
+**                  una sola transferencia si no hay otra en marcha
+**  Parametros:     Dispositivo
 **  Retorno:        Ninguno
 ****************************************************************************************/
-CODIGO_RAPIDO void escribirUART(numUART_e numUART, uint8_t byteTx)
+CODIGO_RAPIDO void iniciarTxUART(numUART_e numUART)
 {
     uart_t *driver = punteroUART(numUART);
 
-    driver->txBuffer[driver->cabezaTxBuffer] = byteTx;
-    driver->cabezaTxBuffer = (driver->cabezaTxBuffer + 1) % TAMANIO_BUFFER_TX_UART;
+    if (!driver->txDMA) {
+        // Habilitamos la interrupcion par registro de datos de transmision vacio
+        __HAL_UART_ENABLE_IT(&driver->hal.huart, UART_IT_TXE);
+        return;
+    }
+
+#ifdef USAR_DMA_UART
+    BLOQUE_ATOMICO(driver->hal.prioridadIRQ) {
+        uint8_t *datos;
+        const uint16_t longitud = driver->longitudTxDMA == 0 ? bloqueTxUART(numUART, &datos) : 0;
+
+        if (longitud > 0) {
+            const uint32_t dirAlineada = (uint32_t)datos & ~0x1F;
+            SCB_CleanDCache_by_Addr((uint32_t *)dirAlineada, longitud + ((uint32_t)datos - dirAlineada));
 
-    // Habilitamos la interrupcion par registro de datos de transmision vacio
-    __HAL_UART_ENABLE_IT(&driver->hal.huart, UART_IT_TXE);
+            driver->longitudTxDMA = longitud;
+            if (HAL_DMA_Start_IT(&driver->hal.hdmaTx, (uint32_t)datos, (uint32_t)&driver->hal.huart.Instance->TDR, longitud) != HAL_OK)
+                driver->longitudTxDMA = 0;
+        }
+    }
+#endif
 }
 
 
 /***************************************************************************************
-**  Nombre:         void escribirBufferUART(numUART_e numUART, uint8_t *datoTx, uint16_t longitud)
-**  Descripcion:    Escribe un buffer en la UART
-**  Parametros:     Dispositivo, buffer, longitud del buffer
+**  Nombre:         void txDMAcompletadaUART(DMA_HandleTypeDef *hdma)
+**  Descripcion:    Libera el bloque enviado y arranca el siguiente. Si los datos cruzaban el
+**                  final del buffer el siguiente es el segundo bloque
+**  Parametros:     Handler del DMA
 **  Retorno:        Ninguno
 ****************************************************************************************/
-CODIGO_RAPIDO void escribirBufferUART(numUART_e numUART, uint8_t *datoTx, uint16_t longitud)
+CODIGO_RAPIDO void txDMAcompletadaUART(DMA_HandleTypeDef *hdma)
 {
-    for (uint16_t i = 0; i < longitud; i++)
-        escribirUART(numUART, datoTx[i]);
+    const numUART_e numUART = numUARTdmaTx(hdma);
+    uart_t *driver = punteroUART(numUART);
+
+    liberarTxUART(numUART, driver->longitudTxDMA);
+    driver->longitudTxDMA = 0;
+    iniciarTxUART(numUART);
+}
+
+
+/***************************************************************************************
+**  Nombre:         void txDMAerrorUART(DMA_HandleTypeDef *hdma)
+**  Descripcion:    Cuenta el error. Si la transferencia se ha abortado por error de
+**                  transferencia se descarta el bloque y se sigue con el siguiente
+**  Parametros:     Handler del DMA
+**  Retorno:        Ninguno
+****************************************************************************************/
+void txDMAerrorUART(DMA_HandleTypeDef *hdma)
+{
+    errorCallbackUART(numUARTdmaTx(hdma));
+
+    if (hdma->ErrorCode & HAL_DMA_ERROR_TE)
+        txDMAcompletadaUART(hdma);
+}
+
+
+/***************************************************************************************
+**  Nombre:         numUART_e numUARTdmaTx(DMA_HandleTypeDef *hdma)
+**  Descripcion:    Busca la UART a la que pertenece un handler de DMA de transmision
+**  Parametros:     Handler del DMA
+**  Retorno:        Numero de UART
+****************************************************************************************/
+CODIGO_RAPIDO numUART_e numUARTdmaTx(DMA_HandleTypeDef *hdma)
+{
+#ifdef USAR_DMA_UART
+    for (uint8_t i = 0; i < NUM_MAX_UART; i++) {
+        if (&punteroUART(i)->hal.hdmaTx == hdma)
+            return i;
+    }
+#else
+    UNUSED(hdma);
+#endif
+
+    return UART_1;
+}
+
+
+/***************************************************************************************
+**  Nombre:         uint16_t cabezaRxDMAuart(numUART_e numUART)
+**  Descripcion:    Calcula la posicion de escritura del DMA en el buffer de recepcion e
+**                  invalida la cache del buffer. La CPU nunca escribe en el en modo DMA
+**  Parametros:     Dispositivo
+**  Retorno:        Cabeza del buffer
+****************************************************************************************/
+CODIGO_RAPIDO uint16_t cabezaRxDMAuart(numUART_e numUART)
+{
+#ifdef USAR_DMA_UART
+    uart_t *driver = punteroUART(numUART);
+
+    SCB_InvalidateDCache_by_Addr((uint32_t *)driver->rxBuffer, TAMANIO_BUFFER_RX_UART);
+    return TAMANIO_BUFFER_RX_UART - __HAL_DMA_GET_COUNTER(&driver->hal.hdmaRx);
+#else
+    UNUSED(numUART);
+    return 0;
+#endif
+}
+
+
+/***************************************************************************************
+**  Nombre:         void handlerIrqDMAuart(descriptorCanalDMA_t *descriptor)
+**  Descripcion:    Interrupcion de los streams de DMA de la UART: fin de transmision y
+**                  mitad y final del buffer de recepcion
+**  Parametros:     Descriptor del canal
+**  Retorno:        Ninguno
+****************************************************************************************/
+CODIGO_RAPIDO void handlerIrqDMAuart(descriptorCanalDMA_t *descriptor)
+{
+    const numUART_e numUART = descriptor->paramUsuario;
+
+#ifdef USAR_DMA_UART
+    uart_t *driver = punteroUART(numUART);
+
+    if (descriptor->ref == driver->hal.hdmaTx.Instance) {
+        HAL_DMA_IRQHandler(&driver->hal.hdmaTx);
+        return;
+    }
+#endif
+
+    if (OBTENER_FLAG_STATUS_DMA(descriptor, DMA_IT_TEIF)) {
+        LIMPIAR_FLAG_DMA(descriptor, DMA_IT_TEIF);
+        errorCallbackUART(numUART);
+    }
+
+    LIMPIAR_FLAG_DMA(descriptor, DMA_IT_HTIF | DMA_IT_TCIF);
+    procesarRxUART(numUART, cabezaRxDMAuart(numUART));
+}
+
+
+/***************************************************************************************
+**  Nombre:         void flushUART(numUART_e numUART)
+**  Descripcion:    Borra el Buffer de recepcion de la UART
+**  Parametros:     Dispositivo
+**  Retorno:        Ninguno
+****************************************************************************************/
+CODIGO_RAPIDO void flushUART(numUART_e numUART)
+{
+    uart_t *driver = punteroUART(numUART);
+
+    // En modo DMA se descarta lo recibido sin tocar el buffer, que es del DMA
+    if (driver->rxDMA) {
+        driver->cabezaRxBuffer = cabezaRxDMAuart(numUART) % TAMANIO_BUFFER_RX_UART;
+        driver->colaRxBuffer = driver->cabezaRxBuffer;
+        return;
+    }
+
+    driver->colaRxBuffer = 0;
+    driver->cabezaRxBuffer = 0;
+
+    for (uint16_t i = 0; i < TAMANIO_BUFFER_RX_UART; i++)
+    	driver->rxBuffer[i] = 0;
 }
 
 
@@ -195,6 +459,9 @@ CODIGO_RAPIDO int16_t leerUART(numUART_e numUART)
     int16_t byteRx;
     uart_t *driver = punteroUART(numUART);
 
+    if (driver->rxDMA && driver->cabezaRxBuffer == driver->colaRxBuffer)
+        driver->cabezaRxBuffer = cabezaRxDMAuart(numUART) % TAMANIO_BUFFER_RX_UART;
+
     if (driver->cabezaRxBuffer != driver->colaRxBuffer) {
         byteRx = driver->rxBuffer[driver->colaRxBuffer];
 
@@ -233,6 +500,9 @@ CODIGO_RAPIDO uint16_t bytesRecibidosUART(numUART_e numUART)
 {
     uart_t *driver = punteroUART(numUART);
 
+    if (driver->rxDMA)
+        driver->cabezaRxBuffer = cabezaRxDMAuart(numUART) % TAMANIO_BUFFER_RX_UART;
+
     if (driver->cabezaRxBuffer >= driver->colaRxBuffer)
         return driver->cabezaRxBuffer - driver->colaRxBuffer;
     else
@@ -240,36 +510,6 @@ CODIGO_RAPIDO uint16_t bytesRecibidosUART(numUART_e numUART)
 }
 
 
-/***************************************************************************************
-**  Nombre:         bool bufferTxVacioUART(numUART_e numUART)
-**  Descripcion:    Comprueba si el buffer de transmision esta vacio
-**  Parametros:     Dispositivo
-**  Retorno:        True si vacio
-****************************************************************************************/
-CODIGO_RAPIDO bool bufferTxVacioUART(numUART_e numUART)
-{
-    uart_t *driver = punteroUART(numUART);
-    return driver->colaTxBuffer == driver->cabezaTxBuffer;
-}
-
-
-/***************************************************************************************
-**  Nombre:         uint16_t bytesLibresBufferTxUART(numUART_e numUART)
-**  Descripcion:    Retorna el numero de bytes libres en el buffer de transmision
-**  Parametros:     Dispositivo
-**  Retorno:        Numero de bytes libres
-****************************************************************************************/
-CODIGO_RAPIDO uint16_t bytesLibresBufferTxUART(numUART_e numUART)
-{
-    uart_t *driver = punteroUART(numUART);
-
-    if (driver->cabezaTxBuffer >= driver->colaTxBuffer)
-        return TAMANIO_BUFFER_TX_UART - 1 - driver->cabezaTxBuffer + driver->colaTxBuffer;
-
-    return driver->colaTxBuffer - driver->cabezaTxBuffer - 1;
-}
-
-
 /***************************************************************************************
 **  Nombre:         void handlerIrqUART(numUART_e numUART)
 **  Descripcion:    Interrupcion que maneja el envio y la recepcion
@@ -281,10 +521,12 @@ CODIGO_RAPIDO void handlerIrqUART(numUART_e numUART)
     uart_t *driver = punteroUART(numUART);
 
     // UART en modo recepcion ----------------------------------------------------------
-    if ((__HAL_UART_GET_IT(&driver->hal.huart, UART_IT_RXNE) != RESET)) {
+    if (!driver->rxDMA && (__HAL_UART_GET_IT(&driver->hal.huart, UART_IT_RXNE) != RESET)) {
         uint8_t rxByte = (uint8_t)(driver->hal.huart.Instance->RDR & (uint8_t) 0xff);
 
-        if (driver->rxCallback)
+        if (driver->rxBloqueCallback)
+            driver->rxBloqueCallback(&rxByte, 1);
+        else if (driver->rxCallback)
             driver->rxCallback(rxByte);
         else {
             driver->rxBuffer[driver->cabezaRxBuffer] = rxByte;
@@ -297,6 +539,12 @@ CODIGO_RAPIDO void handlerIrqUART(numUART_e numUART)
         __HAL_UART_SEND_REQ(&driver->hal.huart, UART_RXDATA_FLUSH_REQUEST);
     }
 
+    // Linea en reposo: fin de trama en recepcion por DMA ---------------------------------
+    if (driver->rxDMA && (__HAL_UART_GET_IT(&driver->hal.huart, UART_IT_IDLE) != RESET)) {
+        __HAL_UART_CLEAR_IT(&driver->hal.huart, UART_CLEAR_IDLEF);
+        procesarRxUART(numUART, cabezaRxDMAuart(numUART));
+    }
+
     // Error de paridad ------------------------------------------------------------------
     if ((__HAL_UART_GET_IT(&driver->hal.huart, UART_IT_PE) != RESET)) {
         __HAL_UART_CLEAR_IT(&driver->hal.huart, UART_CLEAR_PEF);
@@ -322,7 +570,7 @@ CODIGO_RAPIDO void handlerIrqUART(numUART_e numUART)
     }
 
     // UART en modo transmision ----------------------------------------------------------
-    if (__HAL_UART_GET_IT(&driver->hal.huart, UART_IT_TXE) != RESET) {
+    if (!driver->txDMA && __HAL_UART_GET_IT(&driver->hal.huart, UART_IT_TXE) != RESET) {
 
         if (driver->colaTxBuffer == driver->cabezaTxBuffer) {
         	driver->hal.huart.TxXferCount = 0;
@@ -333,12 +581,8 @@ CODIGO_RAPIDO void handlerIrqUART(numUART_e numUART)
             __HAL_UART_ENABLE_IT(&driver->hal.huart, UART_IT_TC);
         }
         else {
-            if ((driver->hal.huart.Init.WordLength == UART_WORDLENGTH_9B) && (driver->hal.huart.Init.Parity == UART_PARITY_NONE))
-            	driver->hal.huart.Instance->TDR = (((uint16_t) driver->txBuffer[driver->colaTxBuffer]) & (uint16_t) 0x01FFU);
-            else
-            	driver->hal.huart.Instance->TDR = (uint8_t)(driver->txBuffer[driver->colaTxBuffer]);
-
-            driver->colaTxBuffer = (driver->colaTxBuffer + 1) % TAMANIO_BUFFER_TX_UART;
+            driver->hal.huart.Instance->TDR = driver->txBuffer[driver->colaTxBuffer];
+            liberarTxUART(numUART, 1);
         }
     }
 
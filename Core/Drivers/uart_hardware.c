@@ -7,7 +7,7 @@
 **
 **  Autor: Ramon Rico
 **  Fecha de creacion: 30/06/2020
-**  Fecha de modificacion: 03/08/2020
+**  Fecha de modificacion: 17/10/2026
 **
 **  El proyecto URpilot NO es libre. No se puede distribuir y/o modificar este fichero
 **  bajo ningun concepto.
@@ -271,6 +271,7 @@ bool comprobarConfigHardwareUART(numUART_e numUART);
 bool comprobarPinUART(numUART_e numUART, uint8_t pin);
 bool comprobarStreamDMAuart(numUART_e numUART, DMA_Stream_TypeDef *DMAy_Streamx);
 bool pinUART(numUART_e numUART, uint8_t pinBusqueda, pin_t *pinDriver);
+bool canalStreamDMAuart(const canalStreamDMA_t *dma, DMA_Stream_TypeDef *DMAy_Streamx, uint32_t *canal);
 
 
 /***************************************************************************************
@@ -300,6 +301,24 @@ bool asignarHALuart(numUART_e numUART)
     // Asignamos la instancia
     driver->hal.huart.Instance = hardwareUART[numUART].reg;
 
+    // Con un stream valido la recepcion se hace por DMA circular y el envio por bloques. Si no,
+    // por interrupcion
+#ifdef USAR_DMA_UART
+    uint32_t canalRx, canalTx;
+
+    if (configUART(numUART)->usarDMA && canalStreamDMAuart(hardwareUART[numUART].dmaRx, configUART(numUART)->dmaRx, &canalRx)) {
+        driver->hal.hdmaRx.Instance = configUART(numUART)->dmaRx;
+        driver->hal.hdmaRx.Init.Channel = canalRx;
+        driver->rxDMA = true;
+    }
+
+    if (configUART(numUART)->usarDMA && canalStreamDMAuart(hardwareUART[numUART].dmaTx, configUART(numUART)->dmaTx, &canalTx)) {
+        driver->hal.hdmaTx.Instance = configUART(numUART)->dmaTx;
+        driver->hal.hdmaTx.Init.Channel = canalTx;
+        driver->txDMA = true;
+    }
+#endif
+
     // Asignamos las interrupciones
     driver->hal.IRQ = hardwareUART[numUART].IRQ;
     driver->hal.prioridadIRQ = hardwareUART[numUART].prioridadIRQ;
@@ -396,4 +415,26 @@ bool pinUART(numUART_e numUART, uint8_t pinBusqueda, pin_t *pinDriver)
 }
 
 
+/***************************************************************************************
+**  Nombre:         bool canalStreamDMAuart(const canalStreamDMA_t *dma, DMA_Stream_TypeDef *DMAy_Streamx, uint32_t *canal)
+**  Descripcion:    Busca el stream configurado en la tabla de hardware
+**  Parametros:     Streams posibles, stream configurado, canal del stream
+**  Retorno:        True si el stream es valido
+****************************************************************************************/
+bool canalStreamDMAuart(const canalStreamDMA_t *dma, DMA_Stream_TypeDef *DMAy_Streamx, uint32_t *canal)
+{
+    if (DMAy_Streamx == NULL)
+        return false;
+
+    for (uint8_t i = 0; i < NUM_STREAMS_DMA_UART; i++) {
+        if (DMAy_Streamx == dma[i].DMAy_Streamx) {
+            *canal = dma[i].canal;
+            return true;
+        }
+    }
+
+    return false;
+}
+
+
 #endif // USAR_UART
@@ -7,7 +7,7 @@
 **
 **  Autor: Ramon Rico
 **  Fecha de creacion: 07/02/2021
-**  Fecha de modificacion: 07/02/2021
+**  Fecha de modificacion: 17/10/2026
 **
 **  El proyecto URpilot NO es libre. No se puede distribuir y/o modificar este fichero
 **  bajo ningun concepto.
@@ -35,6 +35,7 @@
 #include "GP/gp_control.h"
 #include "GP/gp_fc.h"
 #include "mixer.h"
+#include "Comun/matematicas.h"
 
 /***************************************************************************************
 ** AREA DE PREPROCESADOR                                                              **
@@ -68,27 +69,40 @@ static uint32_t tiempoAntAct;
 
 /***************************************************************************************
 **  Nombre:         void iniciarControladores(void)
-**  Descripcion:    Inicia los controladores
+**  Descripcion:    Inicia los controladores. Las ganancias se leen del GP en cada ciclo, pero
+**                  solo se pueden escribir con los motores parados
 **  Parametros:     Ninguno
 **  Retorno:        Ninguno
 ****************************************************************************************/
 void iniciarControladores(void)
 {
     for (uint8_t i = 0; i < 3; i++) {
-        //iniciarPID(&pidVelAng[i],  configPID()->pVelAng[i].kp, configPID()->pVelAng[i].ki, configPID()->pVelAng[i].kd,
-        		                   //configPID()->pVelAng[i].kff, configPID()->pVelAng[i].limIntegral, configPID()->pVelAng[i].limSalida);
+        iniciarPID(&pidVelAng[i], &configPID()->pVelAng[i], configFC()->frecLazoVelAngular);
+        iniciarPID(&pidActitud[i], &configPID()->pActitud[i], configFC()->frecLazoActitud);
+    }
 
-        iniciarPID(&pidVelAng[0],  0.000425, 0.0005, 0.00002,  0.0, 0.5, 1);
-        iniciarPID(&pidVelAng[1],  0.00119,  0.0014, 0.000056, 0.0, 0.5, 1);
+    tiempoAntVelAng = micros();
+    tiempoAntAct = tiempoAntVelAng;
 
-        //iniciarPID(&pidActitud[i], configPID()->pActitud[i].kp, configPID()->pActitud[i].ki, configPID()->pActitud[i].kd,
-        		                   //configPID()->pActitud[i].kff, configPID()->pActitud[i].limIntegral, configPID()->pActitud[i].limSalida);
+    ajustarFiltroAcelAngAHRS(configFC()->frecLazoVelAngular);
+}
 
-        iniciarPID(&pidActitud[0], 5, 0, 0.0, 0.0, 2000, 2000);
-        iniciarPID(&pidActitud[1], 4, 0.0, 0.0, 0.0, 2000, 2000);
-    }
 
-    ajustarFiltroAcelAngAHRS(configFC()->frecLazoVelAngular);
+/***************************************************************************************
+**  Nombre:         float factorTPAcontrol(float acelerador)
+**  Descripcion:    Calcula la escala de kp y kd del lazo de velocidad angular. Por encima del
+**                  umbral se atenua linealmente hasta la atenuacion con el acelerador al maximo
+**  Parametros:     Acelerador entre 0 y 1
+**  Retorno:        Escala de las ganancias
+****************************************************************************************/
+float factorTPAcontrol(float acelerador)
+{
+    const float umbral = configPID()->umbralTPA;
+
+    if (acelerador <= umbral || umbral >= 1.0f)
+        return 1.0f;
+
+    return 1.0f - configPID()->atenuacionTPA * (limitarFloat(acelerador, 0.0f, 1.0f) - umbral) / (1.0f - umbral);
 }
 
 
@@ -102,54 +116,55 @@ CODIGO_RAPIDO void actualizarControlVelAngular(void)
 {
     float velAngular[3], acelAngular[3];
     uint32_t tiempoAct = micros();
-    float dt = (tiempoAct - tiempoAntVelAng) / 1000000.0;
+    float dt = (tiempoAct - tiempoAntVelAng) / 1000000.0f;
     tiempoAntVelAng = tiempoAct;
 
     giroIMU(velAngular);
     acelAngularAHRS(acelAngular);
 
-    //for (uint8_t i = 0; i < 3; i++)
-    	//uPID[i] = actualizarPID(&pidVelAng[i], uActPID[i], velAngular[i], acelAng[i], dt, 1);
-    uPID[0] = actualizarPID(&pidVelAng[0], uActPID[0], velAngular[0], acelAngular[0], dt, !ordenPararMotores);
-    uPID[1] = actualizarPID(&pidVelAng[1], uActPID[1], velAngular[1], acelAngular[1], dt, !ordenPararMotores);
+    const float escala = factorTPAcontrol(aceleradorMixer());
 
-    if (ordenPararMotores) {
-        resetearIntegralPID(&pidVelAng[0]);
-        resetearIntegralPID(&pidVelAng[1]);
+    for (uint8_t i = 0; i < 3; i++) {
+        escalarGananciasPID(&pidVelAng[i], escala);
+        uPID[i] = actualizarPID(&pidVelAng[i], uActPID[i], velAngular[i], acelAngular[i], dt, !ordenPararMotores);
+
+        // Con los motores parados se resetea todo para que al armar no salte el feed-forward
+        if (ordenPararMotores) {
+            resetearPID(&pidVelAng[i]);
+            ajustarFiltrosPID(&pidVelAng[i]);
+        }
     }
 }
 
-float ref[3];
-float euler[3];
-float velAngular[3];
 
 /***************************************************************************************
 **  Nombre:         void actualizarControlActitud(void)
-**  Descripcion:    Actualiza el control de actitud
+**  Descripcion:    Actualiza el control de actitud. La referencia de yaw de la radio es de
+**                  velocidad angular y pasa directamente al lazo de velocidad
 **  Parametros:     Ninguno
 **  Retorno:        Ninguno
 ****************************************************************************************/
 void actualizarControlActitud(void)
 {
+    float ref[3], euler[3], velAngular[3];
     uint32_t tiempoAct = micros();
-    float dt = (tiempoAct - tiempoAntAct) / 1000000.0;
+    float dt = (tiempoAct - tiempoAntAct) / 1000000.0f;
     tiempoAntAct = tiempoAct;
 
-
-
     refAngulosRC(ref);
     giroIMU(velAngular);
     actitudAHRS(euler);
 
-    //for (uint8_t i = 0; i < 3; i++)
-    	//uActPID[i] = actualizarPID(&pidActitud[i], ref[i], euler[i], velAngular[i], dt, 1);
-    uActPID[0] = actualizarPID(&pidActitud[0], ref[0], euler[0], velAngular[0], dt, !ordenPararMotores);
-    uActPID[1] = actualizarPID(&pidActitud[1], ref[1], euler[1], velAngular[1], dt, !ordenPararMotores);
+    for (uint8_t i = 0; i < 2; i++) {
+        uActPID[i] = actualizarPID(&pidActitud[i], ref[i], euler[i], velAngular[i], dt, !ordenPararMotores);
 
-    if (ordenPararMotores) {
-        resetearIntegralPID(&pidActitud[0]);
-        resetearIntegralPID(&pidActitud[1]);
+        if (ordenPararMotores) {
+            resetearPID(&pidActitud[i]);
+            ajustarFiltrosPID(&pidActitud[i]);
+        }
     }
+
+    uActPID[YAW] = ref[YAW];
 }
 
 
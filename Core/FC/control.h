@@ -7,7 +7,7 @@
 **
 **  Autor: Ramon Rico
 **  Fecha de creacion: 07/02/2021
-**  Fecha de modificacion: 07/02/2021
+**  Fecha de modificacion: 17/10/2026
 **
 **  El proyecto URpilot NO es libre. No se puede distribuir y/o modificar este fichero
 **  bajo ningun concepto.
@@ -59,6 +59,7 @@ typedef enum {
 ** AREA DE PROTOTIPOS DE FUNCION                                                      **
 ****************************************************************************************/
 void iniciarControladores(void);
+float factorTPAcontrol(float acelerador);
 void actualizarControlVelAngular(void);
 void actualizarControlActitud(void);
 void resetearIntegradoresControl(void);
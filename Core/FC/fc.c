@@ -7,7 +7,7 @@
 **
 **  Autor: Ramon Rico
 **  Fecha de creacion: 07/09/2019
-**  Fecha de modificacion: 19/09/2020
+**  Fecha de modificacion: 17/10/2026
 **
 **  El proyecto URpilot NO es libre. No se puede distribuir y/o modificar este fichero
 **  bajo ningun concepto.
@@ -32,6 +32,8 @@
 #include "control.h"
 #include "mixer.h"
 #include "Scheduler/scheduler.h"
+#include "Radio/radio.h"
+#include "Drivers/tiempo.h"
 
 
 /***************************************************************************************
@@ -76,7 +78,7 @@ bool iniciarFC(void)
     return true;
 }
 
-#include "Drivers/tiempo.h"
+
 /***************************************************************************************
 **  Nombre:         void actualizarLazoVelAngularFC(uint32_t tiempoActual)
 **  Descripcion:    Actualiza el bucle del control de velocidad angular
@@ -85,26 +87,15 @@ bool iniciarFC(void)
 ****************************************************************************************/
 CODIGO_RAPIDO void actualizarLazoVelAngularFC(uint32_t tiempoActual)
 {
-
-
-
-
 //#ifndef LEER_IMU_SCHEDULER
 	//leerIMU(tiempoActual);
 //#endif
 	actualizarControlVelAngular();
     actualizarMixer();
-}
 
-extern reaction_t reaction;
-extern reaction_t reaction;
-extern uint32_t numReaction;
-extern bool cambiarID;
-extern bool iniR;
-
-extern uint32_t rTimeMax;
-extern uint32_t rTimeMin;
-extern uint32_t rTime1;
+    // Cierra la medida de latencia si el mixer ha usado una nueva entrada de la radio
+    registrarSalidaMixerRadio(micros());
+}
 
 /***************************************************************************************
 **  Nombre:         void actualizarLazoActitudFC(uint32_t tiempoActual)
@@ -118,13 +109,6 @@ void actualizarLazoActitudFC(uint32_t tiempoActual)
 
     actualizarActitudAHRS();
     actualizarControlActitud();
-
-
-
-
-    if (reaction.id == 'A' && iniR) {
-    	reaction.id = 'B';
-    }
 }
 
 
@@ -136,9 +120,7 @@ void actualizarLazoActitudFC(uint32_t tiempoActual)
 ****************************************************************************************/
 void actualizarLazoPosicionFC(uint32_t tiempoActual)
 {
-    UNUSED(tiempoActual);
-
-    actualizarPosicionAHRS();
+    actualizarPosicionAHRS(tiempoActual);
 }
 
 
@@ -7,7 +7,7 @@
 **
 **  Autor: Ramon Rico
 **  Fecha de creacion: 30/08/2019
-**  Fecha de modificacion: 21/09/2020
+**  Fecha de modificacion: 17/10/2026
 **
 **  El proyecto URpilot NO es libre. No se puede distribuir y/o modificar este fichero
 **  bajo ningun concepto.
@@ -26,12 +26,14 @@
 ** AREA DE INCLUDES                                                                   **
 ****************************************************************************************/
 #include <math.h>
+#include <string.h>
 
 #include "mixer.h"
 #include "control.h"
 #include "rc.h"
 #include "Motores/motor.h"
 #include "GP/gp_mixer.h"
+#include "GP/gp_motor.h"
 #include "Drivers/tiempo.h"
 #include "Comun/matematicas.h"
 
@@ -39,6 +41,7 @@
 /***************************************************************************************
 ** AREA DE PREPROCESADOR                                                              **
 ****************************************************************************************/
+#define ACELERADOR_FIJO_MIXER      0.3f        // El lazo de altura todavia no da el acelerador
 
 
 /***************************************************************************************
@@ -56,12 +59,33 @@ typedef struct {
     const motorMixer_t *motor;
 } mixer_t;
 
+// Matriz de asignacion por ejes. El acelerador es 1 en todas las geometrias
+typedef struct {
+    float roll[NUM_MAX_MOTORES];
+    float pitch[NUM_MAX_MOTORES];
+    float yaw[NUM_MAX_MOTORES];
+} matrizMixer_t;
+
+// Configuracion de la salida precalculada para no leer el GP en cada motor
+typedef struct {
+    float valorMinimo;
+    float rango;
+    float curva;
+    float unoMenosCurva;
+    float unoMenosCurva2;
+    float cuatroCurva;
+    float medioInvCurva;
+} salidaMixer_t;
+
 
 /***************************************************************************************
 ** AREA DE DECLARACION DE VARIABLES                                                   **
 ****************************************************************************************/
 static uint8_t cntMotores;
-static motorMixer_t mixer[NUM_MAX_MOTORES];
+static matrizMixer_t matrizMixer __attribute__ ((aligned(8)));
+static salidaMixer_t salidaMixer;
+static estadisticasMixer_t estadisticasMixer;
+static float empujeMix[NUM_MAX_MOTORES];
 static float motorMix[NUM_MAX_MOTORES];
 bool ordenPararMotores = true;
 
@@ -190,7 +214,8 @@ const mixer_t tablaMixer[] = {
 ** AREA DE PROTOTIPOS DE FUNCION                                                      **
 ****************************************************************************************/
 void calcularTablaMixer(void);
-float escalarMixer(float pwm);
+void ajustarSalidaMixer(void);
+bool limitarYawMixer(const float *rollPitch, const float *yaw, float *empuje, uint8_t numMotores, float *minimo, float *maximo);
 void pararMotores(void);
 
 
@@ -206,19 +231,54 @@ void pararMotores(void);
 ****************************************************************************************/
 void iniciarMixer(void)
 {
-	cntMotores = 0;
-	cntMotores = tablaMixer[configMixer()->tipoDrone].numMotores;
+    ajustarGeometriaMixer(configMixer()->tipoDrone);
+    ajustarSalidaMixer();
+
+    habilitarMotores();
+    apagarMotoresMixer();
+}
+
+
+/***************************************************************************************
+**  Nombre:         uint8_t ajustarGeometriaMixer(tipoDrone_e tipoDrone)
+**  Descripcion:    Precalcula la matriz de asignacion de la geometria
+**  Parametros:     Tipo de drone
+**  Retorno:        Numero de motores
+****************************************************************************************/
+uint8_t ajustarGeometriaMixer(tipoDrone_e tipoDrone)
+{
+    const mixer_t *geometria = &tablaMixer[tipoDrone];
 
-    if (cntMotores > NUM_MAX_MOTORES)
-    	cntMotores = NUM_MAX_MOTORES;
+    cntMotores = MIN(geometria->numMotores, NUM_MAX_MOTORES);
+    memset(&matrizMixer, 0, sizeof(matrizMixer));
 
-    if (tablaMixer[configMixer()->tipoDrone].motor) {
-        for (uint8_t i = 0; i < cntMotores; i++)
-            mixer[i] = tablaMixer[configMixer()->tipoDrone].motor[i];
+    for (uint8_t i = 0; i < cntMotores; i++) {
+        matrizMixer.roll[i] = geometria->motor[i].roll;
+        matrizMixer.pitch[i] = geometria->motor[i].pitch;
+        matrizMixer.yaw[i] = geometria->motor[i].yaw;
     }
 
-    habilitarMotores();
-    apagarMotoresMixer();
+    return cntMotores;
+}
+
+
+/***************************************************************************************
+**  Nombre:         void ajustarSalidaMixer(void)
+**  Descripcion:    Precalcula la curva de empuje y el rango de salida de los motores
+**  Parametros:     Ninguno
+**  Retorno:        Ninguno
+****************************************************************************************/
+void ajustarSalidaMixer(void)
+{
+    const float curva = configMixer()->curvaPWM;
+
+    salidaMixer.valorMinimo = configMixer()->valorMinimo;
+    salidaMixer.rango = configMixer()->valorMaximo - configMixer()->valorMinimo;
+    salidaMixer.curva = curva;
+    salidaMixer.unoMenosCurva = 1.0f - curva;
+    salidaMixer.unoMenosCurva2 = salidaMixer.unoMenosCurva * salidaMixer.unoMenosCurva;
+    salidaMixer.cuatroCurva = 4.0f * curva;
+    salidaMixer.medioInvCurva = (curva > 0.0f) ? 0.5f / curva : 0.0f;
 }
 
 
@@ -270,30 +330,146 @@ CODIGO_RAPIDO void actualizarMixer(void)
 ****************************************************************************************/
 CODIGO_RAPIDO void calcularTablaMixer(void)
 {
+    float u[4];
 
-    for (uint8_t i = 0; i < cntMotores; i++) {
-    	motorMix[i] = /*uAltPID() * mixer[i].throttle + */ 0.3 + uRollPID() * mixer[i].roll + uPitchPID() * mixer[i].pitch /*+ uYawPID() * mixer[i].yaw*/;
-    	motorMix[i] = limitarFloat(motorMix[i], 0.0, 1.0);
-        motorMix[i] = configMixer()->valorMinimo + (configMixer()->valorMaximo - configMixer()->valorMinimo) * escalarMixer(motorMix[i]);
+    uTotalPID(u);
+    u[ALT] = ACELERADOR_FIJO_MIXER;
+    mezclarMixer(u, empujeMix, motorMix);
+}
+
+
+/***************************************************************************************
+**  Nombre:         void mezclarMixer(const float *u, float *empuje, float *salida)
+**  Descripcion:    Asigna las acciones de control a los motores sin salirse de [0, 1]. Roll y
+**                  pitch tienen prioridad: si no caben se escalan manteniendo la direccion.
+**                  Despues se recorta el yaw lo justo para que quepa y por ultimo se mueve
+**                  el acelerador
+**  Parametros:     Acciones de control (roll, pitch, yaw, acelerador), empuje de cada motor
+**                  entre 0 y 1, salida de cada motor
+**  Retorno:        Ninguno
+****************************************************************************************/
+CODIGO_RAPIDO void mezclarMixer(const float *u, float *empuje, float *salida)
+{
+    const uint8_t numMotores = cntMotores;
+    float rollPitch[NUM_MAX_MOTORES], yaw[NUM_MAX_MOTORES];
+    float minimo = 0.0f, maximo = 0.0f;
+
+    for (uint8_t i = 0; i < numMotores; i++) {
+        rollPitch[i] = u[ROLL] * matrizMixer.roll[i] + u[PITCH] * matrizMixer.pitch[i];
+        yaw[i] = u[YAW] * matrizMixer.yaw[i];
+        empuje[i] = rollPitch[i] + yaw[i];
+        minimo = (i == 0 || empuje[i] < minimo) ? empuje[i] : minimo;
+        maximo = (i == 0 || empuje[i] > maximo) ? empuje[i] : maximo;
     }
 
+    float acelerador;
+
+    if (maximo - minimo > 1.0f && !limitarYawMixer(rollPitch, yaw, empuje, numMotores, &minimo, &maximo)) {
+        // Roll y pitch no caben con ningun yaw: se escalan al rango de los motores sin yaw ni acelerador
+        const float escala = 1.0f / (maximo - minimo);
+
+        for (uint8_t i = 0; i < numMotores; i++)
+            empuje[i] = (empuje[i] - minimo) * escala;
+
+        acelerador = 0.0f;
+        estadisticasMixer.numEscaladoRollPitch++;
+    }
+    else {
+        // El acelerador mas cercano al pedido que deja todos los motores dentro
+        acelerador = limitarFloat(u[ALT], -minimo, 1.0f - maximo);
+        if (acelerador != u[ALT])
+            estadisticasMixer.numAjusteAcelerador++;
+    }
+
+    // Curva de empuje y rango de los motores
+    if (salidaMixer.curva == 0.0f) {
+        for (uint8_t i = 0; i < numMotores; i++) {
+            empuje[i] = MIN(MAX(empuje[i] + acelerador, 0.0f), 1.0f);
+            salida[i] = salidaMixer.valorMinimo + salidaMixer.rango * empuje[i];
+        }
+    }
+    else {
+        for (uint8_t i = 0; i < numMotores; i++) {
+            empuje[i] = MIN(MAX(empuje[i] + acelerador, 0.0f), 1.0f);
+
+            // La raiz es la instruccion VSQRT de la FPU
+            const float pwm = (sqrtf(salidaMixer.unoMenosCurva2 + salidaMixer.cuatroCurva * empuje[i]) - salidaMixer.unoMenosCurva) *
+                              salidaMixer.medioInvCurva;
+            salida[i] = salidaMixer.valorMinimo + salidaMixer.rango * MIN(MAX(pwm, 0.0f), 1.0f);
+        }
+    }
+
+    estadisticasMixer.numCiclos++;
 }
 
 
 /***************************************************************************************
-**  Nombre:         float escalarMixer(void pwm)
-**  Descripcion:    Escala el valor del PWM con el modelo: thrust = (1 - curvaPWM) * PWM + curvaPWM * PWM ^ 2
-**  Parametros:     Valor de PWM
-**  Retorno:        Valor de PWM escalado
+**  Nombre:         bool limitarYawMixer(const float *rollPitch, const float *yaw, float *empuje, uint8_t numMotores,
+**                                       float *minimo, float *maximo)
+**  Descripcion:    Busca la mayor fraccion del yaw entre 0 y 1 con la que caben roll y pitch.
+**                  Cada par de motores acota la fraccion para que su diferencia no pase de 1.
+**                  Si no hay ninguna deja en el empuje solo roll y pitch. Solo se llama con
+**                  los motores saturados
+**  Parametros:     Parte de roll y pitch de cada motor, parte de yaw de cada motor, empuje de
+**                  cada motor, numero de motores, empuje minimo y maximo
+**  Retorno:        Roll y pitch caben
 ****************************************************************************************/
-CODIGO_RAPIDO float escalarMixer(float pwm)
+bool limitarYawMixer(const float *rollPitch, const float *yaw, float *empuje, uint8_t numMotores, float *minimo, float *maximo)
 {
-    if (configMixer()->curvaPWM == 0)
-    	return pwm;
-    else {
-    	float pwmEscalado = ((configMixer()->curvaPWM - 1.0f) + sqrtf((1.0f - configMixer()->curvaPWM) * (1.0f - configMixer()->curvaPWM) + 4.0f * configMixer()->curvaPWM * pwm)) / (2.0f * configMixer()->curvaPWM);
-    	return limitarFloat(pwmEscalado, 0.0, 1.0);
+    float fraccionMin = 0.0f, fraccionMax = 1.0f;
+
+    for (uint8_t i = 0; i < numMotores; i++) {
+        for (uint8_t j = 0; j < numMotores; j++) {
+            const float difRollPitch = rollPitch[i] - rollPitch[j];
+            const float difYaw = yaw[i] - yaw[j];
+
+            if (difYaw > 0.0f)
+                fraccionMax = MIN(fraccionMax, (1.0f - difRollPitch) / difYaw);
+            else if (difYaw < 0.0f)
+                fraccionMin = MAX(fraccionMin, (1.0f - difRollPitch) / difYaw);
+            else if (difRollPitch > 1.0f)
+                fraccionMax = -1.0f;
+        }
     }
+
+    const bool caben = fraccionMax >= fraccionMin;
+    const float fraccion = caben ? fraccionMax : 0.0f;
+
+    *minimo = *maximo = rollPitch[0] + fraccion * yaw[0];
+    for (uint8_t i = 0; i < numMotores; i++) {
+        empuje[i] = rollPitch[i] + fraccion * yaw[i];
+        *minimo = MIN(*minimo, empuje[i]);
+        *maximo = MAX(*maximo, empuje[i]);
+    }
+
+    if (caben)
+        estadisticasMixer.numRecorteYaw++;
+
+    return caben;
+}
+
+
+/***************************************************************************************
+**  Nombre:         void leerEstadisticasMixer(estadisticasMixer_t *estadisticas)
+**  Descripcion:    Devuelve cuantas veces se ha saturado el mixer
+**  Parametros:     Estadisticas
+**  Retorno:        Ninguno
+****************************************************************************************/
+void leerEstadisticasMixer(estadisticasMixer_t *estadisticas)
+{
+    *estadisticas = estadisticasMixer;
+}
+
+
+/***************************************************************************************
+**  Nombre:         float aceleradorMixer(void)
+**  Descripcion:    Devuelve el acelerador comun de los motores
+**  Parametros:     Ninguno
+**  Retorno:        Acelerador entre 0 y 1
+****************************************************************************************/
+float aceleradorMixer(void)
+{
+    return ACELERADOR_FIJO_MIXER;
 }
 
 
@@ -309,6 +485,21 @@ uint8_t numMotores(void)
 }
 
 
+/***************************************************************************************
+**  Nombre:         float salidaMotorMixer(uint8_t numMotor)
+**  Descripcion:    Devuelve la ultima salida del mixer para un motor
+**  Parametros:     Numero de motor
+**  Retorno:        Salida entre 0 y 1
+****************************************************************************************/
+float salidaMotorMixer(uint8_t numMotor)
+{
+    if (numMotor >= cntMotores)
+        return 0;
+
+    return motorMix[numMotor];
+}
+
+
 /***************************************************************************************
 **  Nombre:         void pararMotores(void)
 **  Descripcion:    Para los motores
@@ -336,14 +527,24 @@ void apagarMotoresMixer(void)
 
 /***************************************************************************************
 **  Nombre:         void encenderMotoresMixer(void)
-**  Descripcion:    Desactiva la orden para parar los motores
+**  Descripcion:    Desactiva la orden para parar los motores y aplica la geometria y la
+**                  salida configuradas
 **  Parametros:     Ninguno
 **  Retorno:        Ninguno
 ****************************************************************************************/
 void encenderMotoresMixer(void)
 {
-    if (ordenPararMotores)
+    // La geometria y la salida solo se pueden cambiar con los motores apagados. Una geometria
+    // con mas motores de los iniciados se queda sin aplicar hasta reiniciar
+    if (ordenPararMotores) {
+        const tipoDrone_e tipoDrone = configMixer()->tipoDrone;
+
+        if (tablaMixer[tipoDrone].numMotores <= configMotor()->numMotores)
+            ajustarGeometriaMixer(tipoDrone);
+
+        ajustarSalidaMixer();
         ordenPararMotores = false;
+    }
 }
 
 
@@ -7,7 +7,7 @@
 **
 **  Autor: Ramon Rico
 **  Fecha de creacion: 30/08/2019
-**  Fecha de modificacion: 21/09/2020
+**  Fecha de modificacion: 17/10/2026
 **
 **  El proyecto URpilot NO es libre. No se puede distribuir y/o modificar este fichero
 **  bajo ningun concepto.
@@ -54,6 +54,13 @@ typedef enum {
 	DRON_HEXACOPTER_2H,
 } tipoDrone_e;
 
+typedef struct {
+    uint32_t numCiclos;
+    uint32_t numEscaladoRollPitch;                  // Roll y pitch no caben y se escalan
+    uint32_t numRecorteYaw;                         // Se recorta el yaw para mantener roll y pitch
+    uint32_t numAjusteAcelerador;                   // El acelerador se mueve para no saturar
+} estadisticasMixer_t;
+
 
 /***************************************************************************************
 ** AREA DE DECLARACION DE VARIABLES                                                   **
@@ -66,7 +73,12 @@ extern bool ordenPararMotores;
 ****************************************************************************************/
 void iniciarMixer(void);
 void actualizarMixer(void);
+uint8_t ajustarGeometriaMixer(tipoDrone_e tipoDrone);
+void mezclarMixer(const float *u, float *empuje, float *salida);
+void leerEstadisticasMixer(estadisticasMixer_t *estadisticas);
 uint8_t numMotores(void);
+float aceleradorMixer(void);
+float salidaMotorMixer(uint8_t numMotor);
 void encenderMotoresMixer(void);
 void apagarMotoresMixer(void);
 bool motoresEncendidosMixer(void);
@@ -7,7 +7,7 @@
 **
 **  Autor: Ramon Rico
 **  Fecha de creacion: 10/08/2020
-**  Fecha de modificacion: 21/09/2020
+**  Fecha de modificacion: 17/10/2026
 **
 **  El proyecto URpilot NO es libre. No se puede distribuir y/o modificar este fichero
 **  bajo ningun concepto.
@@ -124,14 +124,6 @@ void iniciarRC(void)
     ajustarSecuenciaRC(&secuenciaCalibracion, 1000);
 }
 
-#include "Sensores/IMU/imu.h"
-#include "Drivers/tiempo.h"
-extern reaction_t reaction;
-extern uint32_t rTimeMax;
-extern uint32_t rTimeMin;
-extern uint32_t rTime1;
-extern bool cambiarID;
-extern bool iniR;
 /***************************************************************************************
 **  Nombre:         void actualizarRC(uint32_t tiempoActual)
 **  Descripcion:    Actualiza las referencias de los PID y los modos del sistema
@@ -142,10 +134,6 @@ void actualizarRC(uint32_t tiempoActual)
 {
     UNUSED(tiempoActual);
 
-    if (reaction.id == 'B' && iniR) {
-    	reaction.id = 'C';
-    }
-
     // Si hay problemas con la radio se resetean las referencias
     if (!radioOperativa()) {
         rc.roll = 0;
@@ -172,6 +160,9 @@ void actualizarRC(uint32_t tiempoActual)
             generarRefAltRC();
     	}
     //}
+
+    // Las referencias ya dependen de los canales actuales
+    registrarUsoRadio();
 }
 
 
@@ -7,7 +7,7 @@
 **
 **  Autor: Ramon Rico
 **  Fecha de creacion: 23/05/2020
-**  Fecha de modificacion: 03/08/2020
+**  Fecha de modificacion: 17/10/2026
 **
 **  El proyecto URpilot NO es libre. No se puede distribuir y/o modificar este fichero
 **  bajo ningun concepto.
@@ -25,6 +25,8 @@
 /***************************************************************************************
 ** AREA DE INCLUDES                                                                   **
 ****************************************************************************************/
+#include <string.h>
+
 #include "filtro_media_movil.h"
 
 
@@ -46,6 +48,7 @@
 /***************************************************************************************
 ** AREA DE PROTOTIPOS DE FUNCION                                                      **
 ****************************************************************************************/
+static float sumarMuestrasMediaMovil(const float *muestras, uint16_t numMuestras);
 
 
 /***************************************************************************************
@@ -60,9 +63,12 @@
 ****************************************************************************************/
 void ajustarFiltroMediaMovil(filtroMediaMovil_t *filtro, uint8_t tamFiltro)
 {
+    if (tamFiltro == 0)
+        tamFiltro = 1;
+    else if (tamFiltro > TAM_MAX_FILTRO_MEDIA_MOVIL)
+        tamFiltro = TAM_MAX_FILTRO_MEDIA_MOVIL;
+
     filtro->tamFiltro = tamFiltro;
-    filtro->indiceMuestra = 0;
-    filtro->numMuestras = 0;
     resetearFiltroMediaMovil(filtro);
 }
 
@@ -78,34 +84,126 @@ void resetearFiltroMediaMovil(filtroMediaMovil_t *filtro)
     for (uint8_t i = 0; i < TAM_MAX_FILTRO_MEDIA_MOVIL; i++)
         filtro->muestras[i] = 0;
 
+    filtro->suma = 0;
     filtro->indiceMuestra = 0;
     filtro->numMuestras = 0;
+    filtro->numVueltas = 0;
 }
 
 
 /***************************************************************************************
 **  Nombre:         float actualizarFiltroMediaMovil(filtroMediaMovil_t *filtro, float muestra)
-**  Descripcion:    Actualiza el filtro
+**  Descripcion:    Actualiza el filtro. La suma se mantiene al sustituir la muestra mas antigua
+**                  y se rehace completa cada VUELTAS_RESUMAR_MEDIA_MOVIL vueltas de la ventana
 **  Parametros:     Puntero al filtro, muestra
 **  Retorno:        Valor filtrado
 ****************************************************************************************/
 float actualizarFiltroMediaMovil(filtroMediaMovil_t *filtro, float muestra)
 {
-    float sumValores = 0;
-
-    // Anadimos una muestra al array
+    // Sustituimos la muestra mas antigua
+    filtro->suma += muestra - filtro->muestras[filtro->indiceMuestra];
     filtro->muestras[filtro->indiceMuestra] = muestra;
+
     filtro->indiceMuestra++;
-    if (filtro->indiceMuestra >= filtro->tamFiltro)
+    if (filtro->indiceMuestra >= filtro->tamFiltro) {
         filtro->indiceMuestra = 0;
 
-    filtro->numMuestras++;
-    if (filtro->numMuestras >= filtro->tamFiltro)
-        filtro->numMuestras = filtro->tamFiltro;
+        filtro->numVueltas++;
+        if (filtro->numVueltas >= VUELTAS_RESUMAR_MEDIA_MOVIL) {
+            filtro->numVueltas = 0;
+            filtro->suma = sumarMuestrasMediaMovil(filtro->muestras, filtro->tamFiltro);
+        }
+    }
+
+    if (filtro->numMuestras < filtro->tamFiltro)
+        filtro->numMuestras++;
+
+    return filtro->suma / filtro->numMuestras;
+}
+
+
+/***************************************************************************************
+**  Nombre:         bool ajustarFiltroMediaMovilPot2(filtroMediaMovilPot2_t *filtro, float *muestras,
+**                                                   uint8_t log2Tam)
+**  Descripcion:    Ajusta el filtro con ventana potencia de 2
+**  Parametros:     Puntero al filtro, buffer de TAM_FILTRO_MEDIA_MOVIL_POT2(log2Tam) muestras,
+**                  log2 del tamanio de la ventana
+**  Retorno:        True si ok
+****************************************************************************************/
+bool ajustarFiltroMediaMovilPot2(filtroMediaMovilPot2_t *filtro, float *muestras, uint8_t log2Tam)
+{
+    if (muestras == NULL || log2Tam > LOG2_TAM_MAX_FILTRO_MEDIA_MOVIL_POT2)
+        return false;
+
+    filtro->muestras = muestras;
+    filtro->log2Tam = log2Tam;
+    filtro->mascara = TAM_FILTRO_MEDIA_MOVIL_POT2(log2Tam) - 1;
+    filtro->invTam = 1.0f / TAM_FILTRO_MEDIA_MOVIL_POT2(log2Tam);
+    resetearFiltroMediaMovilPot2(filtro);
+
+    return true;
+}
+
+
+/***************************************************************************************
+**  Nombre:         void resetearFiltroMediaMovilPot2(filtroMediaMovilPot2_t *filtro)
+**  Descripcion:    Resetea el filtro con ventana potencia de 2
+**  Parametros:     Puntero al filtro
+**  Retorno:        Ninguno
+****************************************************************************************/
+void resetearFiltroMediaMovilPot2(filtroMediaMovilPot2_t *filtro)
+{
+    memset(filtro->muestras, 0, TAM_FILTRO_MEDIA_MOVIL_POT2(filtro->log2Tam) * sizeof(float));
+
+    filtro->suma = 0;
+    filtro->indiceMuestra = 0;
+    filtro->numMuestras = 0;
+    filtro->numVueltas = 0;
+}
+
+
+/***************************************************************************************
+**  Nombre:         float actualizarFiltroMediaMovilPot2(filtroMediaMovilPot2_t *filtro, float muestra)
+**  Descripcion:    Actualiza el filtro con ventana potencia de 2. El indice se enmascara y con la
+**                  ventana llena la division es un producto exacto
+**  Parametros:     Puntero al filtro, muestra
+**  Retorno:        Valor filtrado
+****************************************************************************************/
+float actualizarFiltroMediaMovilPot2(filtroMediaMovilPot2_t *filtro, float muestra)
+{
+    filtro->suma += muestra - filtro->muestras[filtro->indiceMuestra];
+    filtro->muestras[filtro->indiceMuestra] = muestra;
+    filtro->indiceMuestra = (filtro->indiceMuestra + 1) & filtro->mascara;
+
+    if (filtro->indiceMuestra == 0) {
+        filtro->numVueltas++;
+        if (filtro->numVueltas >= VUELTAS_RESUMAR_MEDIA_MOVIL) {
+            filtro->numVueltas = 0;
+            filtro->suma = sumarMuestrasMediaMovil(filtro->muestras, filtro->mascara + 1);
+        }
+    }
+
+    if (filtro->numMuestras <= filtro->mascara) {
+        filtro->numMuestras++;
+        return filtro->suma / filtro->numMuestras;
+    }
+
+    return filtro->suma * filtro->invTam;
+}
+
+
+/***************************************************************************************
+**  Nombre:         float sumarMuestrasMediaMovil(const float *muestras, uint16_t numMuestras)
+**  Descripcion:    Suma completa de la ventana
+**  Parametros:     Muestras, numero de muestras
+**  Retorno:        Suma
+****************************************************************************************/
+static float sumarMuestrasMediaMovil(const float *muestras, uint16_t numMuestras)
+{
+    float suma = 0;
 
-    // Calculo del valor filtrado
-    for (uint8_t i = 0; i < filtro->tamFiltro; i++)
-        sumValores += filtro->muestras[i];
+    for (uint16_t i = 0; i < numMuestras; i++)
+        suma += muestras[i];
 
-    return sumValores / filtro->numMuestras;
+    return suma;
 }
@@ -7,7 +7,7 @@
 **
 **  Autor: Ramon Rico
 **  Fecha de creacion: 23/05/2020
-**  Fecha de modificacion: 03/08/2020
+**  Fecha de modificacion: 17/10/2026
 **
 **  El proyecto URpilot NO es libre. No se puede distribuir y/o modificar este fichero
 **  bajo ningun concepto.
@@ -36,6 +36,11 @@
 ** AREA DE PREPROCESADOR                                                              **
 ****************************************************************************************/
 #define TAM_MAX_FILTRO_MEDIA_MOVIL       16
+#define VUELTAS_RESUMAR_MEDIA_MOVIL      16          // Vueltas de la ventana entre dos sumas completas. Acota la deriva de la suma
+
+// Variante con ventanas potencia de 2. El buffer lo dimensiona el usuario con esta macro
+#define LOG2_TAM_MAX_FILTRO_MEDIA_MOVIL_POT2    12
+#define TAM_FILTRO_MEDIA_MOVIL_POT2(log2Tam)    (1U << (log2Tam))
 
 
 /***************************************************************************************
@@ -43,11 +48,24 @@
 ****************************************************************************************/
 typedef struct {
     float muestras[TAM_MAX_FILTRO_MEDIA_MOVIL];
+    float suma;
     uint8_t tamFiltro;
     uint8_t numMuestras;
     uint8_t indiceMuestra;
+    uint8_t numVueltas;
 } filtroMediaMovil_t;
 
+typedef struct {
+    float *muestras;
+    float suma;
+    float invTam;
+    uint16_t mascara;
+    uint16_t numMuestras;
+    uint16_t indiceMuestra;
+    uint8_t log2Tam;
+    uint8_t numVueltas;
+} filtroMediaMovilPot2_t;
+
 
 /***************************************************************************************
 ** AREA DE DECLARACION DE VARIABLES                                                   **
@@ -61,4 +79,8 @@ void ajustarFiltroMediaMovil(filtroMediaMovil_t *filtro, uint8_t tamFiltro);
 void resetearFiltroMediaMovil (filtroMediaMovil_t *filtro);
 float actualizarFiltroMediaMovil(filtroMediaMovil_t *filtro, float muestra);
 
+bool ajustarFiltroMediaMovilPot2(filtroMediaMovilPot2_t *filtro, float *muestras, uint8_t log2Tam);
+void resetearFiltroMediaMovilPot2(filtroMediaMovilPot2_t *filtro);
+float actualizarFiltroMediaMovilPot2(filtroMediaMovilPot2_t *filtro, float muestra);
+
 #endif // __FILTRO_MEDIA_MOVIL_H
@@ -7,7 +7,7 @@
 **
 **  Autor: Ramon Rico
 **  Fecha de creacion: 26/05/2020
-**  Fecha de modificacion: 03/08/2020
+**  Fecha de modificacion: 17/10/2026
 **
 **  El proyecto URpilot NO es libre. No se puede distribuir y/o modificar este fichero
 **  bajo ningun concepto.
@@ -35,6 +35,12 @@
 /***************************************************************************************
 ** AREA DE PREPROCESADOR                                                              **
 ****************************************************************************************/
+// Los notch dinamico y por RPM se reajustan en el lazo. Las aproximaciones de exp y seno/coseno
+// no mejoran a las de la libreria, asi que se usan estas
+#define EXP_NOTCH(x)                 expf(x)
+#define SEN_COS_NOTCH(x, s, c)       do { *(s) = sinf(x); *(c) = cosf(x); } while (0)
+
+#define LN10_ENTRE_40_NOTCH          0.0575646273f       // 10^(-dB / 40) = e^(-dB * ln(10) / 40)
 
 
 /***************************************************************************************
@@ -51,7 +57,6 @@
 ** AREA DE PROTOTIPOS DE FUNCION                                                      **
 ****************************************************************************************/
 void calcularAQfiltroNotch(float frecCentral, float anchoBandaHz, float atenuacionDB, float *A, float *Q);
-void ajustarFiltroNotchConAQ(filtroNotch_t *filtro, float frecMuestreo, float frecCentral, float A, float Q);
 
 
 /***************************************************************************************
@@ -101,10 +106,11 @@ void actualizarFrecFiltroNotch(filtroNotch_t *filtro, float frecCentral)
 ****************************************************************************************/
 void calcularAQfiltroNotch(float frecCentral, float anchoBandaHz, float atenuacionDB, float *A, float *Q)
 {
-    *A = powf(10, -atenuacionDB / 40.0f);
+    *A = EXP_NOTCH(-atenuacionDB * LN10_ENTRE_40_NOTCH);
     if (frecCentral > 0.5 * anchoBandaHz) {
-        const float octavas = log2f(frecCentral / (frecCentral - anchoBandaHz / 2.0f)) * 2.0f;
-        *Q = sqrtf(powf(2, octavas)) / (powf(2, octavas) - 1.0f);
+        // Con N = 2 * log2(r) octavas, Q = sqrt(2^N) / (2^N - 1) = r / (r^2 - 1)
+        const float r = frecCentral / (frecCentral - anchoBandaHz / 2.0f);
+        *Q = r / (r * r - 1.0f);
     }
     else
         *Q = 0.0f;
@@ -121,9 +127,11 @@ void ajustarFiltroNotchConAQ(filtroNotch_t *filtro, float frecMuestreo, float fr
 {
     if ((frecCentral > 0.0) && (frecCentral < 0.5f * frecMuestreo) && (Q > 0.0f)) {
         float omega = 2.0 * PI * frecCentral / frecMuestreo;
-        float alpha = sinf(omega) / (2 * Q);
+        float senOmega, cosOmega;
+        SEN_COS_NOTCH(omega, &senOmega, &cosOmega);
+        float alpha = senOmega / (2 * Q);
         filtro->b0 =  1.0 + alpha * A * A;
-        filtro->b1 = -2.0 * cosf(omega);
+        filtro->b1 = -2.0 * cosOmega;
         filtro->b2 =  1.0 - alpha * A * A;
         filtro->a0Inv =  1.0 / (1.0 + alpha);
         filtro->a1 = filtro->b1;
@@ -200,17 +208,19 @@ void ajustarFiltroNotchArmonicos(filtroNotchArmonicos_t *filtro, float frecCentr
     calcularAQfiltroNotch(filtro->frecCentral, filtro->anchoBandaHz, filtro->atenuacionDB, &filtro->A, &filtro->Q);
 
     filtro->filtrosHabilitados = 0;
-    // Inicializamos todos los filtros
+    // Inicializamos todos los filtros. Los que superan Nyquist quedan reservados por si baja la frecuencia
     for (uint8_t i = 0, filt = 0; i < NUM_MAX_ARMONICOS_FILTRO_NOTCH && filt < NUM_MAX_ARMONICOS_FILTRO_NOTCH; i++) {
         const float centroNotch = filtro->frecCentral * (i + 1);
 
         if ((1U << i) & filtro->armonicos) {
             // Solo se habilita el filtro si la frecuencia central es inferior al limete de Nyquist
-            if (centroNotch < limiteNyquist) {
+            if (centroNotch < limiteNyquist)
                 ajustarFiltroNotchConAQ(&filtro->filtros[filt], filtro->frecMuestreo, centroNotch, filtro->A, filtro->Q);
-                filtro->filtrosHabilitados++;
-            }
+            else
+                filtro->filtros[filt].operativo = false;
+
             filt++;
+            filtro->filtrosHabilitados++;
         }
     }
 
@@ -252,6 +262,8 @@ void actualizarFrecFiltroNotchArmonicos(filtroNotchArmonicos_t *filtro, float fr
             // Solo se habilita el filtro si la frecuencia central es inferior al limete de Nyquist
             if (centroNotch < limiteNyquist)
                 ajustarFiltroNotchConAQ(&filtro->filtros[filt], filtro->frecMuestreo, centroNotch, filtro->A, filtro->Q);
+            else
+                filtro->filtros[filt].operativo = false;
 
             filt++;
         }
@@ -7,7 +7,7 @@
 **
 **  Autor: Ramon Rico
 **  Fecha de creacion: 26/05/2020
-**  Fecha de modificacion: 03/08/2020
+**  Fecha de modificacion: 17/10/2026
 **
 **  El proyecto URpilot NO es libre. No se puede distribuir y/o modificar este fichero
 **  bajo ningun concepto.
@@ -75,6 +75,7 @@ typedef struct {
 ** AREA DE PROTOTIPOS DE FUNCION                                                      **
 ****************************************************************************************/
 void ajustarFiltroNotch(filtroNotch_t *filtro, float frecCentral, float frecMuestreo, float anchoBandaHz, float atenuacionDB);
+void ajustarFiltroNotchConAQ(filtroNotch_t *filtro, float frecMuestreo, float frecCentral, float A, float Q);
 void actualizarFrecFiltroNotch(filtroNotch_t *filtro, float frecCentral);
 void resetearFiltroNotch(filtroNotch_t *filtro);
 float actualizarFiltroNotch(filtroNotch_t *filtro, float muestra);
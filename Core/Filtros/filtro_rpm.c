@@ -0,0 +1,163 @@
+/***************************************************************************************
+**  filtro_rpm.c - Banco de filtros notch en la frecuencia de giro de cada motor y
+**                 sus armonicos a partir de la telemetria de los ESC
+**
+**
+**  Este fichero forma parte del proyecto URpilot.
+**  Codigo desarrollado por el grupo de investigacion ICON de la Universidad de La Rioja
+**
+**  Autor: Ramon Rico
+**  Fecha de creacion: 17/10/2026
+**  Fecha de modificacion: 17/10/2026
+**
+**  El proyecto URpilot NO es libre. No se puede distribuir y/o modificar este fichero
+**  bajo ningun concepto.
+**
+**  En caso de modificacion y/o solicitud de informacion pongase en contacto con
+**  el grupo de investigacion ICON a traves de: www.unirioja.es/urpilot
+**
+**
+**  Control de versiones del fichero
+**
+**  v1.0  Ramon Rico. Se ha liberado la primera version estable
+**
+****************************************************************************************/
+
+/***************************************************************************************
+** AREA DE INCLUDES                                                                   **
+****************************************************************************************/
+#include <string.h>
+
+#include "filtro_rpm.h"
+#include "Comun/util.h"
+#include "Comun/matematicas.h"
+
+
+/***************************************************************************************
+** AREA DE PREPROCESADOR                                                              **
+****************************************************************************************/
+
+
+/***************************************************************************************
+** AREA DE DEFINICION DE TIPOS                                                        **
+****************************************************************************************/
+
+
+/***************************************************************************************
+** AREA DE DECLARACION DE VARIABLES                                                   **
+****************************************************************************************/
+
+
+/***************************************************************************************
+** AREA DE PROTOTIPOS DE FUNCION                                                      **
+****************************************************************************************/
+void copiarCoeficientesFiltroRPM(filtroNotchArmonicos_t *destino, const filtroNotchArmonicos_t *origen);
+
+
+/***************************************************************************************
+** AREA DE DEFINICION DE FUNCIONES                                                    **
+****************************************************************************************/
+
+/***************************************************************************************
+**  Nombre:         void ajustarFiltroRPM(filtroRPM_t *filtro, float frecMuestreo, float frecActualizar, uint8_t numMotores,
+**                                        uint8_t armonicos, float frecMin, float anchoBandaHz, float atenuacionDB)
+**  Descripcion:    Ajusta los notch de todos los motores en la frecuencia minima. El ancho de banda se
+**                  da en la frecuencia minima y se mantiene proporcional a la frecuencia al reajustar
+**  Parametros:     Puntero al filtro, frecuencia de muestreo, frecuencia de actualizacion de las frecuencias,
+**                  numero de motores, mascara de armonicos, frecuencia minima, ancho de banda, atenuacion
+**  Retorno:        Ninguno
+****************************************************************************************/
+void ajustarFiltroRPM(filtroRPM_t *filtro, float frecMuestreo, float frecActualizar, uint8_t numMotores, uint8_t armonicos,
+                      float frecMin, float anchoBandaHz, float atenuacionDB)
+{
+    memset(filtro, 0, sizeof(*filtro));
+
+    if (frecMuestreo <= 0 || frecActualizar <= 0 || numMotores == 0 || armonicos == 0)
+        return;
+
+    filtro->numMotores = numMotores < NUM_MAX_MOTORES_FILTRO_RPM ? numMotores : NUM_MAX_MOTORES_FILTRO_RPM;
+    filtro->frecMin = frecMin;
+
+    // Cada motor se reajusta una vez cada numMotores actualizaciones, pero su frecuencia se filtra en todas
+    const float dt = 1.0f / frecActualizar;
+    const float rc = 1.0f / (2.0f * PI * FREC_SUAVIZADO_FILTRO_RPM);
+    filtro->alfaSuavizado = dt / (rc + dt);
+
+    for (uint8_t i = 0; i < filtro->numMotores; i++) {
+        filtro->frecMotor[i] = frecMin;
+
+        for (uint8_t j = 0; j < 3; j++)
+            ajustarFiltroNotchArmonicos(&filtro->notch[j][i], frecMin, frecMuestreo, anchoBandaHz, atenuacionDB, armonicos);
+    }
+
+    filtro->operativo = true;
+}
+
+
+/***************************************************************************************
+**  Nombre:         void actualizarFrecFiltroRPM(filtroRPM_t *filtro, const float *frecMotor)
+**  Descripcion:    Filtra la frecuencia de giro de los motores y reajusta los notch de uno de ellos.
+**                  Los coeficientes se calculan en el primer eje y se copian al resto
+**  Parametros:     Puntero al filtro, frecuencia de giro de cada motor en Hz (0 si no hay telemetria)
+**  Retorno:        Ninguno
+****************************************************************************************/
+void actualizarFrecFiltroRPM(filtroRPM_t *filtro, const float *frecMotor)
+{
+    if (!filtro->operativo)
+        return;
+
+    for (uint8_t i = 0; i < filtro->numMotores; i++) {
+        const float frec = frecMotor[i] > filtro->frecMin ? frecMotor[i] : filtro->frecMin;
+        filtro->frecMotor[i] += filtro->alfaSuavizado * (frec - filtro->frecMotor[i]);
+    }
+
+    const uint8_t motor = filtro->motorActual;
+
+    actualizarFrecFiltroNotchArmonicos(&filtro->notch[0][motor], filtro->frecMotor[motor]);
+    copiarCoeficientesFiltroRPM(&filtro->notch[1][motor], &filtro->notch[0][motor]);
+    copiarCoeficientesFiltroRPM(&filtro->notch[2][motor], &filtro->notch[0][motor]);
+
+    filtro->motorActual = (motor + 1) % filtro->numMotores;
+}
+
+
+/***************************************************************************************
+**  Nombre:         void copiarCoeficientesFiltroRPM(filtroNotchArmonicos_t *destino, const filtroNotchArmonicos_t *origen)
+**  Descripcion:    Copia los coeficientes de los notch de un eje a otro sin tocar su estado
+**  Parametros:     Filtro destino, filtro origen
+**  Retorno:        Ninguno
+****************************************************************************************/
+void copiarCoeficientesFiltroRPM(filtroNotchArmonicos_t *destino, const filtroNotchArmonicos_t *origen)
+{
+    for (uint8_t i = 0; i < origen->filtrosHabilitados; i++) {
+        filtroNotch_t *dst = &destino->filtros[i];
+        const filtroNotch_t *org = &origen->filtros[i];
+
+        dst->operativo = org->operativo;
+        dst->frecCentral = org->frecCentral;
+        dst->b0 = org->b0;
+        dst->b1 = org->b1;
+        dst->b2 = org->b2;
+        dst->a1 = org->a1;
+        dst->a2 = org->a2;
+        dst->a0Inv = org->a0Inv;
+    }
+}
+
+
+/***************************************************************************************
+**  Nombre:         float actualizarFiltroRPM(filtroRPM_t *filtro, uint8_t eje, float muestra)
+**  Descripcion:    Pasa una muestra de un eje por los notch de todos los motores
+**  Parametros:     Puntero al filtro, eje, muestra
+**  Retorno:        Valor filtrado
+****************************************************************************************/
+float actualizarFiltroRPM(filtroRPM_t *filtro, uint8_t eje, float muestra)
+{
+    if (!filtro->operativo)
+        return muestra;
+
+    for (uint8_t i = 0; i < filtro->numMotores; i++)
+        muestra = actualizarFiltroNotchArmonicos(&filtro->notch[eje][i], muestra);
+
+    return muestra;
+}
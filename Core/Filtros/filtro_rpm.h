@@ -0,0 +1,72 @@
+/***************************************************************************************
+**  filtro_rpm.h - Banco de filtros notch en la frecuencia de giro de cada motor y
+**                 sus armonicos a partir de la telemetria de los ESC
+**
+**
+**  Este fichero forma parte del proyecto URpilot.
+**  Codigo desarrollado por el grupo de investigacion ICON de la Universidad de La Rioja
+**
+**  Autor: Ramon Rico
+**  Fecha de creacion: 17/10/2026
+**  Fecha de modificacion: 17/10/2026
+**
+**  El proyecto URpilot NO es libre. No se puede distribuir y/o modificar este fichero
+**  bajo ningun concepto.
+**
+**  En caso de modificacion y/o solicitud de informacion pongase en contacto con
+**  el grupo de investigacion ICON a traves de: www.unirioja.es/urpilot
+**
+**
+**  Control de versiones del fichero
+**
+**  v1.0  Ramon Rico. Se ha liberado la primera version estable
+**
+****************************************************************************************/
+
+#ifndef __FILTRO_RPM_H
+#define __FILTRO_RPM_H
+
+/***************************************************************************************
+** AREA DE INCLUDES                                                                   **
+****************************************************************************************/
+#include <stdint.h>
+#include <stdbool.h>
+
+#include "filtro_notch.h"
+
+
+/***************************************************************************************
+** AREA DE PREPROCESADOR                                                              **
+****************************************************************************************/
+#define NUM_MAX_MOTORES_FILTRO_RPM            8
+#define FREC_SUAVIZADO_FILTRO_RPM             150.0f      // Hz. Frecuencia de corte del filtrado de la frecuencia de cada motor
+
+
+/***************************************************************************************
+** AREA DE DEFINICION DE TIPOS                                                        **
+****************************************************************************************/
+typedef struct {
+    bool operativo;
+    uint8_t numMotores;
+    uint8_t motorActual;                                                // Motor que se reajusta en la siguiente actualizacion
+    float frecMin;
+    float alfaSuavizado;
+    float frecMotor[NUM_MAX_MOTORES_FILTRO_RPM];
+    filtroNotchArmonicos_t notch[3][NUM_MAX_MOTORES_FILTRO_RPM];
+} filtroRPM_t;
+
+
+/***************************************************************************************
+** AREA DE DECLARACION DE VARIABLES                                                   **
+****************************************************************************************/
+
+
+/***************************************************************************************
+** AREA DE PROTOTIPOS DE FUNCION                                                      **
+****************************************************************************************/
+void ajustarFiltroRPM(filtroRPM_t *filtro, float frecMuestreo, float frecActualizar, uint8_t numMotores, uint8_t armonicos,
+                      float frecMin, float anchoBandaHz, float atenuacionDB);
+void actualizarFrecFiltroRPM(filtroRPM_t *filtro, const float *frecMotor);
+float actualizarFiltroRPM(filtroRPM_t *filtro, uint8_t eje, float muestra);
+
+#endif // __FILTRO_RPM_H
@@ -0,0 +1,434 @@
+/***************************************************************************************
+**  notch_dinamico.c - Filtro notch dinamico. Se localizan los picos del espectro con una
+**                     FFT repartida en varios ciclos del scheduler
+**
+**
+**  Este fichero forma parte del proyecto URpilot.
+**  Codigo desarrollado por el grupo de investigacion ICON de la Universidad de La Rioja
+**
+**  Autor: Ramon Rico
+**  Fecha de creacion: 17/10/2026
+**  Fecha de modificacion: 17/10/2026
+**
+**  El proyecto URpilot NO es libre. No se puede distribuir y/o modificar este fichero
+**  bajo ningun concepto.
+**
+**  En caso de modificacion y/o solicitud de informacion pongase en contacto con
+**  el grupo de investigacion ICON a traves de: www.unirioja.es/urpilot
+**
+**
+**  Control de versiones del fichero
+**
+**  v1.0  Ramon Rico. Se ha liberado la primera version estable
+**
+****************************************************************************************/
+
+/***************************************************************************************
+** AREA DE INCLUDES                                                                   **
+****************************************************************************************/
+#include <string.h>
+#include <math.h>
+
+#include "notch_dinamico.h"
+#include "Comun/util.h"
+#include "Comun/matematicas.h"
+
+
+/***************************************************************************************
+** AREA DE PREPROCESADOR                                                              **
+****************************************************************************************/
+#define MITAD_FFT_NOTCH_DINAMICO              (TAM_FFT_NOTCH_DINAMICO / 2)
+#define UMBRAL_PICO_NOTCH_DINAMICO            3.0f        // Veces sobre el ruido de fondo en el rango de busqueda
+#define FREC_SUAVIZADO_NOTCH_DINAMICO         10.0f       // Hz. Frecuencia de corte del filtrado de la frecuencia de los picos
+
+
+/***************************************************************************************
+** AREA DE DEFINICION DE TIPOS                                                        **
+****************************************************************************************/
+
+
+/***************************************************************************************
+** AREA DE DECLARACION DE VARIABLES                                                   **
+****************************************************************************************/
+
+
+/***************************************************************************************
+** AREA DE PROTOTIPOS DE FUNCION                                                      **
+****************************************************************************************/
+void aplicarVentanaNotchDinamico(analizadorNotchDinamico_t *analizador);
+void etapaFFTnotchDinamico(analizadorNotchDinamico_t *analizador, uint8_t etapa);
+void calcularEspectroNotchDinamico(analizadorNotchDinamico_t *analizador);
+bool buscarPicosNotchDinamico(analizadorNotchDinamico_t *analizador);
+
+
+/***************************************************************************************
+** AREA DE DEFINICION DE FUNCIONES                                                    **
+****************************************************************************************/
+
+/***************************************************************************************
+**  Nombre:         bool iniciarAnalizadorNotchDinamico(analizadorNotchDinamico_t *analizador, float frecMuestreo, float frecActualizar,
+**                                                      uint8_t numPicos, float frecMin, float frecMax)
+**  Descripcion:    Inicia el analizador del espectro. Los picos parten repartidos por el rango de busqueda
+**  Parametros:     Puntero al analizador, frecuencia de las muestras, frecuencia de llamada al analizador, numero de picos,
+**                  frecuencia minima y maxima de busqueda
+**  Retorno:        True si ok
+****************************************************************************************/
+bool iniciarAnalizadorNotchDinamico(analizadorNotchDinamico_t *analizador, float frecMuestreo, float frecActualizar, uint8_t numPicos,
+                                    float frecMin, float frecMax)
+{
+    memset(analizador, 0, sizeof(analizadorNotchDinamico_t));
+
+    if (frecMuestreo <= 0 || frecActualizar <= 0 || numPicos == 0)
+        return false;
+
+    // Se diezma con la media de las muestras hasta la frecuencia de analisis
+    analizador->diezmado = limitarFloat(ceilf(frecMuestreo / FREC_MAX_ANALISIS_NOTCH_DINAMICO), 1, 255);
+    analizador->invDiezmado = 1.0f / analizador->diezmado;
+    analizador->frecAnalisis = frecMuestreo / analizador->diezmado;
+
+    const float resolucion = analizador->frecAnalisis / TAM_FFT_NOTCH_DINAMICO;
+    analizador->numPicos = MIN(numPicos, NUM_MAX_PICOS_NOTCH_DINAMICO);
+    analizador->frecMin = MAX(frecMin, resolucion);
+    analizador->frecMax = MIN(frecMax, 0.48f * analizador->frecAnalisis);
+    if (analizador->frecMin >= analizador->frecMax)
+        return false;
+
+    analizador->binMin = MAX(1, (uint8_t)(analizador->frecMin / resolucion));
+    analizador->binMax = MIN(MITAD_FFT_NOTCH_DINAMICO - 1, (uint8_t)ceilf(analizador->frecMax / resolucion));
+
+    // Cada eje se analiza una vez cada 3 * NUM_PASOS_NOTCH_DINAMICO llamadas
+    const float dt = 3.0f * NUM_PASOS_NOTCH_DINAMICO / frecActualizar;
+    const float rc = 1.0f / (2.0f * PI * FREC_SUAVIZADO_NOTCH_DINAMICO);
+    analizador->alfaSuavizado = dt / (rc + dt);
+
+    // Tablas de la ventana de Hann, de los factores de giro y del orden de bits inverso
+    for (uint8_t i = 0; i < TAM_FFT_NOTCH_DINAMICO; i++)
+        analizador->hann[i] = 0.5f * (1.0f - cosf(2.0f * PI * i / TAM_FFT_NOTCH_DINAMICO));
+
+    for (uint8_t i = 0; i <= MITAD_FFT_NOTCH_DINAMICO; i++) {
+        analizador->cosW[i] = cosf(2.0f * PI * i / TAM_FFT_NOTCH_DINAMICO);
+        analizador->senW[i] = sinf(2.0f * PI * i / TAM_FFT_NOTCH_DINAMICO);
+    }
+
+    for (uint8_t i = 0; i < MITAD_FFT_NOTCH_DINAMICO; i++) {
+        uint8_t inverso = 0;
+        for (uint8_t j = 0; j < NUM_ETAPAS_FFT_NOTCH_DINAMICO; j++) {
+            if (i & (1 << j))
+                inverso |= 1 << (NUM_ETAPAS_FFT_NOTCH_DINAMICO - 1 - j);
+        }
+        analizador->bitInverso[i] = inverso;
+    }
+
+    for (uint8_t i = 0; i < 3; i++) {
+        for (uint8_t j = 0; j < analizador->numPicos; j++)
+            analizador->frecPico[i][j] = analizador->frecMin + (j + 1) * (analizador->frecMax - analizador->frecMin) / (analizador->numPicos + 1);
+    }
+
+    analizador->operativo = true;
+    return true;
+}
+
+
+/***************************************************************************************
+**  Nombre:         void anadirMuestraNotchDinamico(analizadorNotchDinamico_t *analizador, const float *muestra)
+**  Descripcion:    Anade una muestra de los tres ejes a la ventana del analizador
+**  Parametros:     Puntero al analizador, muestra
+**  Retorno:        Ninguno
+****************************************************************************************/
+void anadirMuestraNotchDinamico(analizadorNotchDinamico_t *analizador, const float *muestra)
+{
+    if (!analizador->operativo)
+        return;
+
+    for (uint8_t i = 0; i < 3; i++)
+        analizador->acumDiezmado[i] += muestra[i];
+
+    if (++analizador->cntDiezmado < analizador->diezmado)
+        return;
+
+    for (uint8_t i = 0; i < 3; i++) {
+        analizador->muestras[i][analizador->indiceMuestra] = analizador->acumDiezmado[i] * analizador->invDiezmado;
+        analizador->acumDiezmado[i] = 0;
+    }
+
+    analizador->cntDiezmado = 0;
+    analizador->indiceMuestra = (analizador->indiceMuestra + 1) & (TAM_FFT_NOTCH_DINAMICO - 1);
+    if (analizador->indiceMuestra == 0)
+        analizador->ventanaLlena = true;
+}
+
+
+/***************************************************************************************
+**  Nombre:         bool actualizarAnalizadorNotchDinamico(analizadorNotchDinamico_t *analizador, uint8_t *eje)
+**  Descripcion:    Ejecuta un paso del analisis. Cada paso tiene un coste acotado y los ejes se analizan por turnos
+**  Parametros:     Puntero al analizador, eje con nuevas frecuencias
+**  Retorno:        True si se han actualizado las frecuencias de un eje
+****************************************************************************************/
+bool actualizarAnalizadorNotchDinamico(analizadorNotchDinamico_t *analizador, uint8_t *eje)
+{
+    if (!analizador->operativo || !analizador->ventanaLlena)
+        return false;
+
+    switch (analizador->paso) {
+        case PASO_NOTCH_DINAMICO_VENTANA:
+            aplicarVentanaNotchDinamico(analizador);
+            analizador->etapaFFT = 0;
+            analizador->paso = PASO_NOTCH_DINAMICO_FFT;
+            break;
+
+        case PASO_NOTCH_DINAMICO_FFT:
+            etapaFFTnotchDinamico(analizador, analizador->etapaFFT);
+            if (++analizador->etapaFFT == NUM_ETAPAS_FFT_NOTCH_DINAMICO)
+                analizador->paso = PASO_NOTCH_DINAMICO_ESPECTRO;
+            break;
+
+        case PASO_NOTCH_DINAMICO_ESPECTRO:
+            calcularEspectroNotchDinamico(analizador);
+            analizador->paso = PASO_NOTCH_DINAMICO_PICOS;
+            break;
+
+        case PASO_NOTCH_DINAMICO_PICOS: {
+            const bool actualizado = buscarPicosNotchDinamico(analizador);
+
+            *eje = analizador->eje;
+            analizador->eje = (analizador->eje + 1) % 3;
+            analizador->numAnalisis++;
+            analizador->paso = PASO_NOTCH_DINAMICO_VENTANA;
+            return actualizado;
+        }
+
+        default:
+            analizador->paso = PASO_NOTCH_DINAMICO_VENTANA;
+            break;
+    }
+
+    return false;
+}
+
+
+/***************************************************************************************
+**  Nombre:         void aplicarVentanaNotchDinamico(analizadorNotchDinamico_t *analizador)
+**  Descripcion:    Copia la ventana del eje sin la media y con la ventana de Hann. Las muestras pares e impares
+**                  forman la parte real e imaginaria de una FFT compleja de la mitad de puntos en orden de bits inverso
+**  Parametros:     Puntero al analizador
+**  Retorno:        Ninguno
+****************************************************************************************/
+void aplicarVentanaNotchDinamico(analizadorNotchDinamico_t *analizador)
+{
+    const float *muestras = analizador->muestras[analizador->eje];
+    const uint8_t inicio = analizador->indiceMuestra;
+    float media = 0;
+
+    for (uint8_t i = 0; i < TAM_FFT_NOTCH_DINAMICO; i++)
+        media += muestras[i];
+
+    media /= TAM_FFT_NOTCH_DINAMICO;
+
+    for (uint8_t i = 0; i < MITAD_FFT_NOTCH_DINAMICO; i++) {
+        const uint8_t par = (inicio + 2 * i) & (TAM_FFT_NOTCH_DINAMICO - 1);
+        const uint8_t impar = (par + 1) & (TAM_FFT_NOTCH_DINAMICO - 1);
+        const uint8_t destino = analizador->bitInverso[i];
+
+        analizador->re[destino] = (muestras[par] - media) * analizador->hann[2 * i];
+        analizador->im[destino] = (muestras[impar] - media) * analizador->hann[2 * i + 1];
+    }
+}
+
+
+/***************************************************************************************
+**  Nombre:         void etapaFFTnotchDinamico(analizadorNotchDinamico_t *analizador, uint8_t etapa)
+**  Descripcion:    Ejecuta una etapa de la FFT radix 2 en el sitio
+**  Parametros:     Puntero al analizador, etapa
+**  Retorno:        Ninguno
+****************************************************************************************/
+void etapaFFTnotchDinamico(analizadorNotchDinamico_t *analizador, uint8_t etapa)
+{
+    const uint8_t mitad = 1 << etapa;
+    const uint8_t salto = TAM_FFT_NOTCH_DINAMICO / (2 * mitad);
+    float *re = analizador->re;
+    float *im = analizador->im;
+
+    for (uint8_t inicio = 0; inicio < MITAD_FFT_NOTCH_DINAMICO; inicio += 2 * mitad) {
+        for (uint8_t j = 0; j < mitad; j++) {
+            const float wr = analizador->cosW[j * salto];
+            const float wi = -analizador->senW[j * salto];
+            const uint8_t p = inicio + j;
+            const uint8_t q = p + mitad;
+
+            const float tr = wr * re[q] - wi * im[q];
+            const float ti = wr * im[q] + wi * re[q];
+            re[q] = re[p] - tr;
+            im[q] = im[p] - ti;
+            re[p] += tr;
+            im[p] += ti;
+        }
+    }
+}
+
+
+/***************************************************************************************
+**  Nombre:         void calcularEspectroNotchDinamico(analizadorNotchDinamico_t *analizador)
+**  Descripcion:    Separa la FFT compleja en el espectro de la senal real y calcula su modulo en el rango de busqueda
+**  Parametros:     Puntero al analizador
+**  Retorno:        Ninguno
+****************************************************************************************/
+void calcularEspectroNotchDinamico(analizadorNotchDinamico_t *analizador)
+{
+    for (uint8_t k = analizador->binMin - 1; k <= analizador->binMax + 1; k++) {
+        const uint8_t a = k & (MITAD_FFT_NOTCH_DINAMICO - 1);
+        const uint8_t b = (MITAD_FFT_NOTCH_DINAMICO - k) & (MITAD_FFT_NOTCH_DINAMICO - 1);
+
+        // Parte par e impar: Fp = (Z[k] + Z*[N-k]) / 2, Fi = (Z[k] - Z*[N-k]) / 2j
+        const float parRe = 0.5f * (analizador->re[a] + analizador->re[b]);
+        const float parIm = 0.5f * (analizador->im[a] - analizador->im[b]);
+        const float imparRe = 0.5f * (analizador->im[a] + analizador->im[b]);
+        const float imparIm = -0.5f * (analizador->re[a] - analizador->re[b]);
+
+        // X[k] = Fp + W^k * Fi
+        const float c = analizador->cosW[k];
+        const float s = analizador->senW[k];
+        const float xRe = parRe + c * imparRe + s * imparIm;
+        const float xIm = parIm + c * imparIm - s * imparRe;
+
+        analizador->espectro[k] = sqrtf(xRe * xRe + xIm * xIm);
+    }
+}
+
+
+/***************************************************************************************
+**  Nombre:         bool buscarPicosNotchDinamico(analizadorNotchDinamico_t *analizador)
+**  Descripcion:    Busca los maximos locales mayores del espectro, interpola su frecuencia y la asigna al notch
+**                  mas cercano. La frecuencia de cada notch se filtra para que los cambios sean suaves
+**  Parametros:     Puntero al analizador
+**  Retorno:        True si se ha encontrado algun pico
+****************************************************************************************/
+bool buscarPicosNotchDinamico(analizadorNotchDinamico_t *analizador)
+{
+    const float *espectro = analizador->espectro;
+    uint8_t binPico[NUM_MAX_PICOS_NOTCH_DINAMICO];
+    uint8_t numPicos = 0;
+    float media = 0, ruido = 0;
+    uint8_t numRuido = 0;
+
+    // Ruido de fondo: media de los bins que no superan la media, para que los picos no la inflen
+    for (uint8_t k = analizador->binMin; k <= analizador->binMax; k++)
+        media += espectro[k];
+
+    media /= analizador->binMax - analizador->binMin + 1;
+
+    for (uint8_t k = analizador->binMin; k <= analizador->binMax; k++) {
+        if (espectro[k] <= media) {
+            ruido += espectro[k];
+            numRuido++;
+        }
+    }
+
+    const float umbral = UMBRAL_PICO_NOTCH_DINAMICO * ruido / MAX(numRuido, 1);
+
+    // Maximos locales ordenados de mayor a menor
+    for (uint8_t k = analizador->binMin; k <= analizador->binMax; k++) {
+        if (espectro[k] <= umbral || espectro[k] <= espectro[k - 1] || espectro[k] < espectro[k + 1])
+            continue;
+
+        uint8_t pos = numPicos;
+        while (pos > 0 && espectro[binPico[pos - 1]] < espectro[k]) {
+            if (pos < analizador->numPicos)
+                binPico[pos] = binPico[pos - 1];
+            pos--;
+        }
+
+        if (pos < analizador->numPicos) {
+            binPico[pos] = k;
+            if (numPicos < analizador->numPicos)
+                numPicos++;
+        }
+    }
+
+    if (numPicos == 0)
+        return false;
+
+    float *frecPico = analizador->frecPico[analizador->eje];
+    const float resolucion = analizador->frecAnalisis / TAM_FFT_NOTCH_DINAMICO;
+    uint8_t notchAsignados = 0;
+
+    for (uint8_t i = 0; i < numPicos; i++) {
+        // Interpolacion parabolica con los bins vecinos
+        const uint8_t k = binPico[i];
+        const float y0 = espectro[k - 1];
+        const float y1 = espectro[k];
+        const float y2 = espectro[k + 1];
+        const float denominador = y0 - 2.0f * y1 + y2;
+        const float desplazamiento = denominador != 0.0f ? 0.5f * (y0 - y2) / denominador : 0.0f;
+        const float frec = limitarFloat((k + desplazamiento) * resolucion, analizador->frecMin, analizador->frecMax);
+
+        // Los picos mas grandes eligen antes su notch
+        uint8_t notch = 0;
+        float distanciaMin = 1e9f;
+        for (uint8_t j = 0; j < analizador->numPicos; j++) {
+            const float distancia = fabsf(frecPico[j] - frec);
+            if (!(notchAsignados & (1 << j)) && distancia < distanciaMin) {
+                distanciaMin = distancia;
+                notch = j;
+            }
+        }
+
+        notchAsignados |= 1 << notch;
+        frecPico[notch] += analizador->alfaSuavizado * (frec - frecPico[notch]);
+    }
+
+    return true;
+}
+
+
+/***************************************************************************************
+**  Nombre:         void ajustarBancoNotchDinamico(bancoNotchDinamico_t *banco, float frecMuestreo, uint8_t numNotch,
+**                                                 const float *frecCentral, float Q)
+**  Descripcion:    Ajusta un banco de notch en serie de atenuacion completa
+**  Parametros:     Puntero al banco, frecuencia de muestreo, numero de notch, frecuencias centrales, factor de calidad
+**  Retorno:        Ninguno
+****************************************************************************************/
+void ajustarBancoNotchDinamico(bancoNotchDinamico_t *banco, float frecMuestreo, uint8_t numNotch, const float *frecCentral, float Q)
+{
+    banco->numNotch = MIN(numNotch, NUM_MAX_PICOS_NOTCH_DINAMICO);
+    banco->frecMuestreo = frecMuestreo;
+    banco->Q = Q;
+
+    for (uint8_t i = 0; i < banco->numNotch; i++) {
+        filtroNotch_t *notch = &banco->notch[i];
+
+        resetearFiltroNotch(notch);
+        notch->frecMuestreo = frecMuestreo;
+        notch->frecCentral = frecCentral[i];
+        ajustarFiltroNotchConAQ(notch, frecMuestreo, frecCentral[i], 0.0f, Q);
+    }
+}
+
+
+/***************************************************************************************
+**  Nombre:         void actualizarFrecBancoNotchDinamico(bancoNotchDinamico_t *banco, const float *frecCentral)
+**  Descripcion:    Cambia las frecuencias centrales sin resetear el estado de los filtros
+**  Parametros:     Puntero al banco, frecuencias centrales
+**  Retorno:        Ninguno
+****************************************************************************************/
+void actualizarFrecBancoNotchDinamico(bancoNotchDinamico_t *banco, const float *frecCentral)
+{
+    for (uint8_t i = 0; i < banco->numNotch; i++) {
+        banco->notch[i].frecCentral = frecCentral[i];
+        ajustarFiltroNotchConAQ(&banco->notch[i], banco->frecMuestreo, frecCentral[i], 0.0f, banco->Q);
+    }
+}
+
+
+/***************************************************************************************
+**  Nombre:         float actualizarBancoNotchDinamico(bancoNotchDinamico_t *banco, float muestra)
+**  Descripcion:    Filtra una muestra con todos los notch del banco
+**  Parametros:     Puntero al banco, muestra
+**  Retorno:        Valor filtrado
+****************************************************************************************/
+float actualizarBancoNotchDinamico(bancoNotchDinamico_t *banco, float muestra)
+{
+    for (uint8_t i = 0; i < banco->numNotch; i++)
+        muestra = actualizarFiltroNotch(&banco->notch[i], muestra);
+
+    return muestra;
+}
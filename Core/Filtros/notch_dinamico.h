@@ -0,0 +1,122 @@
+/***************************************************************************************
+**  notch_dinamico.h - Filtro notch dinamico. Se localizan los picos del espectro con una
+**                     FFT repartida en varios ciclos del scheduler
+**
+**
+**  Este fichero forma parte del proyecto URpilot.
+**  Codigo desarrollado por el grupo de investigacion ICON de la Universidad de La Rioja
+**
+**  Autor: Ramon Rico
+**  Fecha de creacion: 17/10/2026
+**  Fecha de modificacion: 17/10/2026
+**
+**  El proyecto URpilot NO es libre. No se puede distribuir y/o modificar este fichero
+**  bajo ningun concepto.
+**
+**  En caso de modificacion y/o solicitud de informacion pongase en contacto con
+**  el grupo de investigacion ICON a traves de: www.unirioja.es/urpilot
+**
+**
+**  Control de versiones del fichero
+**
+**  v1.0  Ramon Rico. Se ha liberado la primera version estable
+**
+****************************************************************************************/
+
+#ifndef __NOTCH_DINAMICO_H
+#define __NOTCH_DINAMICO_H
+
+/***************************************************************************************
+** AREA DE INCLUDES                                                                   **
+****************************************************************************************/
+#include <stdint.h>
+#include <stdbool.h>
+
+#include "filtro_notch.h"
+
+
+/***************************************************************************************
+** AREA DE PREPROCESADOR                                                              **
+****************************************************************************************/
+#define TAM_FFT_NOTCH_DINAMICO                64          // Muestras reales de la ventana. Potencia de 2
+#define NUM_ETAPAS_FFT_NOTCH_DINAMICO         5           // log2(TAM_FFT_NOTCH_DINAMICO / 2)
+#define NUM_MAX_PICOS_NOTCH_DINAMICO          3
+#define FREC_MAX_ANALISIS_NOTCH_DINAMICO      1000        // Hz. Las muestras se diezman hasta esta frecuencia
+
+// Un analisis por eje: ventana, etapas de la FFT, espectro y picos
+#define NUM_PASOS_NOTCH_DINAMICO              (NUM_ETAPAS_FFT_NOTCH_DINAMICO + 3)
+
+
+/***************************************************************************************
+** AREA DE DEFINICION DE TIPOS                                                        **
+****************************************************************************************/
+typedef enum {
+    PASO_NOTCH_DINAMICO_VENTANA = 0,
+    PASO_NOTCH_DINAMICO_FFT,
+    PASO_NOTCH_DINAMICO_ESPECTRO,
+    PASO_NOTCH_DINAMICO_PICOS,
+} pasoNotchDinamico_e;
+
+typedef struct {
+    bool operativo;
+    uint8_t numPicos;
+    float frecMin;
+    float frecMax;
+    float frecAnalisis;                                                 // Frecuencia de las muestras tras el diezmado
+    float alfaSuavizado;
+
+    // Diezmado y ventana circular de cada eje
+    uint8_t diezmado;
+    uint8_t cntDiezmado;
+    float invDiezmado;
+    float acumDiezmado[3];
+    float muestras[3][TAM_FFT_NOTCH_DINAMICO];
+    uint8_t indiceMuestra;
+    bool ventanaLlena;
+
+    // Analisis en curso. Se trabaja sobre una copia de la ventana
+    pasoNotchDinamico_e paso;
+    uint8_t etapaFFT;
+    uint8_t eje;
+    uint8_t binMin, binMax;
+    float re[TAM_FFT_NOTCH_DINAMICO / 2];
+    float im[TAM_FFT_NOTCH_DINAMICO / 2];
+    float espectro[TAM_FFT_NOTCH_DINAMICO / 2 + 1];
+
+    // Tablas
+    float hann[TAM_FFT_NOTCH_DINAMICO];
+    float cosW[TAM_FFT_NOTCH_DINAMICO / 2 + 1];
+    float senW[TAM_FFT_NOTCH_DINAMICO / 2 + 1];
+    uint8_t bitInverso[TAM_FFT_NOTCH_DINAMICO / 2];
+
+    // Resultado
+    float frecPico[3][NUM_MAX_PICOS_NOTCH_DINAMICO];
+    uint32_t numAnalisis;
+} analizadorNotchDinamico_t;
+
+typedef struct {
+    uint8_t numNotch;
+    float frecMuestreo;
+    float Q;
+    filtroNotch_t notch[NUM_MAX_PICOS_NOTCH_DINAMICO];
+} bancoNotchDinamico_t;
+
+
+/***************************************************************************************
+** AREA DE DECLARACION DE VARIABLES                                                   **
+****************************************************************************************/
+
+
+/***************************************************************************************
+** AREA DE PROTOTIPOS DE FUNCION                                                      **
+****************************************************************************************/
+bool iniciarAnalizadorNotchDinamico(analizadorNotchDinamico_t *analizador, float frecMuestreo, float frecActualizar, uint8_t numPicos,
+                                    float frecMin, float frecMax);
+void anadirMuestraNotchDinamico(analizadorNotchDinamico_t *analizador, const float *muestra);
+bool actualizarAnalizadorNotchDinamico(analizadorNotchDinamico_t *analizador, uint8_t *eje);
+
+void ajustarBancoNotchDinamico(bancoNotchDinamico_t *banco, float frecMuestreo, uint8_t numNotch, const float *frecCentral, float Q);
+void actualizarFrecBancoNotchDinamico(bancoNotchDinamico_t *banco, const float *frecCentral);
+float actualizarBancoNotchDinamico(bancoNotchDinamico_t *banco, float muestra);
+
+#endif // __NOTCH_DINAMICO_H
@@ -1,5 +1,6 @@
 /***************************************************************************************
-**  config_flash.c - Funciones de gestion la zona flash para los GP
+**  config_flash.c - Funciones de gestion la zona flash para los GP. Los GP se guardan
+**                   como un log de registros en dos bancos que se compactan al llenarse
 **
 **
 **  Este fichero forma parte del proyecto URpilot.
@@ -7,7 +8,7 @@
 **
 **  Autor: Ramon Rico
 **  Fecha de creacion: 07/05/2019
-**  Fecha de modificacion: 03/08/2020
+**  Fecha de modificacion: 17/10/2026
 **
 **  El proyecto URpilot NO es libre. No se puede distribuir y/o modificar este fichero
 **  bajo ningun concepto.
@@ -23,9 +24,12 @@
 ****************************************************************************************/
 
 
+
 /***************************************************************************************
 ** AREA DE INCLUDES                                                                   **
 ****************************************************************************************/
+#include <string.h>
+
 #include "config_flash.h"
 #include "gp.h"
 #include "Comun/util.h"
@@ -38,30 +42,33 @@
 ** AREA DE PREPROCESADOR                                                              **
 ****************************************************************************************/
 #define MASCARA_CLASIFICACION_CR_CONFIG_FLASH  0x03
-#define VALOR_INICIO_CRC_CONFIG_FLASH          0xFFFF
-#define VALOR_CHEQUEO_CRC_CONFIG_FLASH         0x1D0F   // Valor pre-calculado del CRC que lo incluye a si mismo
+#define NUM_BANCOS_CONFIG_FLASH                2            // Cada banco ocupa sectores completos de la flash
+#define MAGICO_BANCO_CONFIG_FLASH              0x46524355   // "URCF" en memoria
+#define NUM_INTENTOS_CONFIG_FLASH              3
+#define ALINEAR_CONFIG_FLASH(tam)              (((tam) + sizeof(uint32_t) - 1) & ~(sizeof(uint32_t) - 1))
 
 
 /***************************************************************************************
 ** AREA DE DEFINICION DE TIPOS                                                        **
 ****************************************************************************************/
-typedef struct {                         // Cabecera de la zona de configuracion
+typedef struct {                         // Cabecera de cada banco. Se escribe la ultima al compactar
+    uint32_t magico;
+    uint32_t generacion;                 // El banco valido con la generacion mas alta es el activo
     uint8_t versionFlashConfig;
-    uint8_t magicoBE;                    // Numero magico, debe ser 0xBE
-} PACKED cabeceraConfig_t;
+    uint8_t reservado;
+    uint16_t crc;                        // De los campos anteriores
+} PACKED cabeceraBancoConfig_t;
 
-typedef struct {                         // Cabecera de cada GP
-    uint16_t tam;
+typedef struct {                         // Cabecera de cada registro del log. Los registros se alinean a word
     uint16_t gpn;
+    uint16_t tam;                        // Cabecera y datos, sin el relleno
+    uint32_t secuencia;                  // Crece con cada registro escrito. El mas alto de cada GP es el valido
     uint8_t version;
     uint8_t flags;                       // Los 2 bits mas bajos indican el sistema o el numero del perfil, ver MASCARA_CLASIFICACION_CR_CONFIG_FLASH
+    uint16_t crc;                        // De la cabecera hasta aqui y de los datos
     uint8_t gp[];
 } PACKED configRegistro_t;
 
-typedef struct {                         // Terminacion de la zona de configuracion
-    uint16_t terminador;
-} PACKED terminacionConfig_t;            // El checksum se aplica despues de esto, no se incluye el terminador en el calculo
-
 typedef struct {
     uint8_t byte;
     uint32_t word;
@@ -76,18 +83,33 @@ typedef enum {
 /***************************************************************************************
 ** AREA DE DECLARACION DE VARIABLES                                                   **
 ****************************************************************************************/
-extern uint8_t inicioRegionConfig;       // Variables del Linker
-extern uint8_t finRegionConfig;
-static uint16_t tamConfigFlash;
+extern uint8_t inicioRegionConfig[];     // Variables del Linker
+extern uint8_t finRegionConfig[];
+
+static const uint8_t *bancoActivo;       // NULL si ningun banco es valido
+static uint32_t posicionLibre;           // Offset del siguiente registro en el banco activo
+static uint32_t secuenciaRegistro;       // Secuencia del siguiente registro
+static bool bancoLleno;                  // Hay que compactar antes de anadir registros
+static estadisticasConfigFlash_t estadisticasFlashConfig;
 
 
 /***************************************************************************************
 ** AREA DE PROTOTIPOS DE FUNCION                                                      **
 ****************************************************************************************/
 void escribirConfigEnFlash(void);
-bool escribirAjustesEnFlash(void);
-bool estructuraFlashConfigValida(void);
+bool compactarConfigFlash(void);
+bool escanearBancosConfigFlash(void);
+void escanearRegistrosConfigFlash(void);
+bool anadirRegistroConfigFlash(const registroGP_t *reg);
+bool escribirRegistroConfigFlash(uintptr_t dir, const registroGP_t *reg, uint32_t secuencia);
+bool registroActualizadoConfigFlash(const registroGP_t *reg);
 const configRegistro_t *encontrarRegFlashConfig(const registroGP_t *reg, flagsConfigRegistro_e clasificacion);
+bool cabeceraBancoConfigValida(const cabeceraBancoConfig_t *cabecera);
+bool registroConfigValido(const configRegistro_t *registro);
+uint16_t crcRegistroConfig(const configRegistro_t *cabecera, const void *datos, uint16_t tamDatos);
+bool zonaBorradaConfigFlash(const uint8_t *p, uint32_t tam);
+const uint8_t *dirBancoConfigFlash(uint8_t banco);
+uint32_t tamBancoConfigFlash(void);
 
 
 /***************************************************************************************
@@ -96,8 +118,8 @@ const configRegistro_t *encontrarRegFlashConfig(const registroGP_t *reg, flagsCo
 
 /***************************************************************************************
 **  Nombre:         void iniciarConfigFlash(void)
-**  Descripcion:    Comprueba la estructura de la flash de los GP y testea el
-**                  tamanio de los datos
+**  Descripcion:    Comprueba la estructura de los registros, busca el banco activo y
+**                  recorre su log. Si no hay ningun banco valido se resetea la configuracion
 **  Parametros:     Ninguno
 **  Retorno:        Ninguno
 ****************************************************************************************/
@@ -107,10 +129,10 @@ void iniciarConfigFlash(void)
     STATIC_ASSERT(offsetof(packingTest_t, byte) == 0, test_byte_packing_fallido);
     STATIC_ASSERT(offsetof(packingTest_t, word) == 1, test_word_packing_fallido);
     STATIC_ASSERT(sizeof(packingTest_t) == 5, fallo_packing_general);
-    STATIC_ASSERT(sizeof(terminacionConfig_t) == 2, fallo_tamanio_terminador);
-    STATIC_ASSERT(sizeof(configRegistro_t) == 6, fallo_tamanio_registro);
+    STATIC_ASSERT(sizeof(cabeceraBancoConfig_t) == 12, fallo_tamanio_cabecera_banco);
+    STATIC_ASSERT(sizeof(configRegistro_t) == 12, fallo_tamanio_registro);
 
-    if (estructuraFlashConfigValida())
+    if (escanearBancosConfigFlash())
         return;
 
     resetearConfigFlash();
@@ -119,7 +141,8 @@ void iniciarConfigFlash(void)
 
 /***************************************************************************************
 **  Nombre:         bool cargarConfigFlash(void)
-**  Descripcion:    Inicia todos los pregistros. Se escanea uno a uno y se cargan en el programa
+**  Descripcion:    Inicia todos los pregistros. Se busca el ultimo registro valido de cada
+**                  uno y se carga en el programa
 **  Parametros:     Ninguno
 **  Retorno:        True si ok
 ****************************************************************************************/
@@ -158,14 +181,16 @@ void resetearConfigFlash(void)
 
 /***************************************************************************************
 **  Nombre:         bool versionValidaConfigFlash(void)
-**  Descripcion:    Comprueba la version de la zona de configuracion
+**  Descripcion:    Comprueba la version del banco activo
 **  Parametros:     Ninguno
 **  Retorno:        True si ok
 ****************************************************************************************/
 bool versionValidaConfigFlash(void)
 {
-    const uint8_t *p = &inicioRegionConfig;
-    const cabeceraConfig_t *cabecera = (const cabeceraConfig_t *)p;
+    if (bancoActivo == NULL)
+        return false;
+
+    const cabeceraBancoConfig_t *cabecera = (const cabeceraBancoConfig_t *)bancoActivo;
 
     if (cabecera->versionFlashConfig != VERSION_CONFIG_FLASH)
         return false;
@@ -174,9 +199,58 @@ bool versionValidaConfigFlash(void)
 }
 
 
+/***************************************************************************************
+**  Nombre:         bool guardarConfigFlash(void)
+**  Descripcion:    Anade al log los GP que han cambiado respecto a su ultimo registro. Si
+**                  no caben se compacta en el otro banco
+**  Parametros:     Ninguno
+**  Retorno:        True si ok
+****************************************************************************************/
+bool guardarConfigFlash(void)
+{
+    estadisticasFlashConfig.numGuardados++;
+
+    if (bancoLleno || !versionValidaConfigFlash())
+        return compactarConfigFlash();
+
+    POR_CADA_GP(reg) {
+        if (registroActualizadoConfigFlash(reg))
+            continue;
+
+        // Los registros ya anadidos se vuelven a escribir en la compactacion
+        if (!anadirRegistroConfigFlash(reg))
+            return compactarConfigFlash();
+    }
+
+    return true;
+}
+
+
+/***************************************************************************************
+**  Nombre:         void estadisticasConfigFlash(estadisticasConfigFlash_t *estadisticas)
+**  Descripcion:    Devuelve las estadisticas de uso de la flash de configuracion
+**  Parametros:     Estadisticas
+**  Retorno:        Ninguno
+****************************************************************************************/
+void estadisticasConfigFlash(estadisticasConfigFlash_t *estadisticas)
+{
+    estadisticasFlashConfig.generacion = 0;
+    estadisticasFlashConfig.bytesLibres = 0;
+
+    if (bancoActivo != NULL) {
+        estadisticasFlashConfig.generacion = ((const cabeceraBancoConfig_t *)bancoActivo)->generacion;
+        if (!bancoLleno)
+            estadisticasFlashConfig.bytesLibres = tamBancoConfigFlash() - posicionLibre;
+    }
+
+    *estadisticas = estadisticasFlashConfig;
+}
+
+
 /***************************************************************************************
 **  Nombre:         void escribirConfigEnFlash(void)
-**  Descripcion:    Escribe la configuracion en la flash y comprueba la version y la estructura
+**  Descripcion:    Escribe la configuracion completa en un banco nuevo y comprueba la version
+**                  y la estructura
 **  Parametros:     Ninguno
 **  Retorno:        Ninguno
 ****************************************************************************************/
@@ -184,146 +258,331 @@ void escribirConfigEnFlash(void)
 {
     bool estado = false;
 
-    for (uint8_t i = 0; i < 3 && !estado; i++) {
-        if (escribirAjustesEnFlash())
+    for (uint8_t i = 0; i < NUM_INTENTOS_CONFIG_FLASH && !estado; i++) {
+        if (compactarConfigFlash())
             estado = true;
     }
 
-    if (estado && versionValidaConfigFlash() && estructuraFlashConfigValida())
+    if (estado && versionValidaConfigFlash())
         return;
 
     // Fallo en la escritura de la Flash
     falloSistema(FALLO_ESCRITURA_FLASH);
-
 }
 
 
 /***************************************************************************************
-**  Nombre:         bool escribirAjustesEnFlash(void)
-**  Descripcion:    Escribe los ajustes en la flash
+**  Nombre:         bool compactarConfigFlash(void)
+**  Descripcion:    Borra el banco inactivo, escribe todos los GP y por ultimo la cabecera
+**                  con la siguiente generacion. Hasta que la cabecera esta completa el banco
+**                  activo sigue siendo el anterior
 **  Parametros:     Ninguno
 **  Retorno:        True si ok
 ****************************************************************************************/
-bool escribirAjustesEnFlash(void)
+bool compactarConfigFlash(void)
 {
-    grabadorFlash_t grabador;
+    const uint8_t *destino = bancoActivo == dirBancoConfigFlash(0) ? dirBancoConfigFlash(1) : dirBancoConfigFlash(0);
+    const uint32_t tamBanco = tamBancoConfigFlash();
+    uint32_t posicion = sizeof(cabeceraBancoConfig_t);
 
-    resetearGrabadorFlash(&grabador);
-    desbloquearGrabadorFlash(&grabador, (uintptr_t)&inicioRegionConfig, &finRegionConfig - &inicioRegionConfig);
-
-    cabeceraConfig_t cabecera = {
+    cabeceraBancoConfig_t cabecera = {
+        .magico = MAGICO_BANCO_CONFIG_FLASH,
+        .generacion = 1,
         .versionFlashConfig = VERSION_CONFIG_FLASH,
-        .magicoBE = 0xBE,
+        .reservado = 0,
     };
 
-    escribirGrabadorFlash(&grabador, (uint8_t *)&cabecera, sizeof(cabecera));
-    uint16_t crc = VALOR_INICIO_CRC_CONFIG_FLASH;
-    crc = calcularCRC16(crc, (uint8_t *)&cabecera, sizeof(cabecera));
-    POR_CADA_GP(reg) {
-        const uint16_t tamReg = tamanioGP(reg);
-        configRegistro_t registro = {
-            .tam = sizeof(configRegistro_t) + tamReg,
-            .gpn = numeroGP(reg),
-            .version = versionGP(reg),
-            .flags = 0
-        };
-
-        registro.flags |= SISTEMA_CLASIFICACION_CR;
-        escribirGrabadorFlash(&grabador, (uint8_t *)&registro, sizeof(registro));
-        crc = calcularCRC16(crc, (uint8_t *)&registro, sizeof(registro));
-        escribirGrabadorFlash(&grabador, reg->dir, tamReg);
-        crc = calcularCRC16(crc, reg->dir, tamReg);
-    }
+    if (bancoActivo != NULL)
+        cabecera.generacion = ((const cabeceraBancoConfig_t *)bancoActivo)->generacion + 1;
 
-    terminacionConfig_t terminador = {
-        .terminador = 0,
-    };
+    cabecera.crc = calcularCRC16(&cabecera, offsetof(cabeceraBancoConfig_t, crc));
+    estadisticasFlashConfig.numCompactaciones++;
 
-    escribirGrabadorFlash(&grabador, (uint8_t *)&terminador, sizeof(terminador));
-    crc = calcularCRC16(crc, (uint8_t *)&terminador, sizeof(terminador));
+    if (!borrarFlash((uintptr_t)destino, tamBanco))
+        return false;
 
-    // Incluye el CRC invertido en big endian
-    const uint16_t crcInvertidoBigEndian = ~(((crc & 0xFF) << 8) | (crc >> 8));
-    escribirGrabadorFlash(&grabador, (uint8_t *)&crcInvertidoBigEndian, sizeof(crc));
+    POR_CADA_GP(reg) {
+        const uint32_t tam = ALINEAR_CONFIG_FLASH(sizeof(configRegistro_t) + tamanioGP(reg));
 
-    flushGrabadorFlash(&grabador);
+        if (posicion + tam > tamBanco || !escribirRegistroConfigFlash((uintptr_t)(destino + posicion), reg, secuenciaRegistro++))
+            return false;
 
-    const bool estado = bloquearGrabadorFlash(&grabador) == 0;
-    return estado;
+        posicion += tam;
+    }
 
+    if (!programarFlash((uintptr_t)destino, &cabecera, sizeof(cabecera)))
+        return false;
+
+    return escanearBancosConfigFlash() && bancoActivo == destino;
 }
 
 
 /***************************************************************************************
-**  Nombre:         bool estructuraFlashConfigValida(void)
-**  Descripcion:    Comprueba la estructura de la zona de configuracion
+**  Nombre:         bool escanearBancosConfigFlash(void)
+**  Descripcion:    Busca el banco valido con la generacion mas alta y recorre su log
 **  Parametros:     Ninguno
-**  Retorno:        True si ok
+**  Retorno:        True si hay un banco valido
 ****************************************************************************************/
-bool estructuraFlashConfigValida(void)
+bool escanearBancosConfigFlash(void)
 {
-    const uint8_t *p = &inicioRegionConfig;
-    const cabeceraConfig_t *cabecera = (const cabeceraConfig_t *)p;
+    bancoActivo = NULL;
+
+    for (uint8_t i = 0; i < NUM_BANCOS_CONFIG_FLASH; i++) {
+        const cabeceraBancoConfig_t *cabecera = (const cabeceraBancoConfig_t *)dirBancoConfigFlash(i);
 
-    if (cabecera->magicoBE != 0xBE)
+        if (!cabeceraBancoConfigValida(cabecera))
+            continue;
+
+        if (bancoActivo == NULL || cabecera->generacion > ((const cabeceraBancoConfig_t *)bancoActivo)->generacion)
+            bancoActivo = (const uint8_t *)cabecera;
+    }
+
+    if (bancoActivo == NULL)
         return false;
 
-    uint16_t crc = VALOR_INICIO_CRC_CONFIG_FLASH;
-    crc = calcularCRC16(crc, cabecera, sizeof(*cabecera));
-    p += sizeof(*cabecera);
+    escanearRegistrosConfigFlash();
+    return true;
+}
 
-    while (1) {
-        const configRegistro_t *registro = (const configRegistro_t *)p;
+
+/***************************************************************************************
+**  Nombre:         void escanearRegistrosConfigFlash(void)
+**  Descripcion:    Recorre el log del banco activo hasta la primera word borrada. Los
+**                  registros con CRC erroneo se saltan. Un tamanio imposible es una
+**                  cabecera cortada y obliga a compactar antes del siguiente guardado
+**  Parametros:     Ninguno
+**  Retorno:        Ninguno
+****************************************************************************************/
+void escanearRegistrosConfigFlash(void)
+{
+    const uint32_t tamBanco = tamBancoConfigFlash();
+    uint32_t posicion = sizeof(cabeceraBancoConfig_t);
+
+    bancoLleno = false;
+    secuenciaRegistro = 0;
+    estadisticasFlashConfig.numRegistrosCorruptos = 0;
+
+    while (posicion + sizeof(configRegistro_t) <= tamBanco) {
+        const configRegistro_t *rec = (const configRegistro_t *)(bancoActivo + posicion);
 
         // Encontrado el fin
-        if (registro->tam == 0)
+        if (*(const uint32_t *)rec == VALOR_BORRADO_FLASH)
             break;
 
-        // Muy alto o muy pequeno
-        if (p + registro->tam >= &finRegionConfig || registro->tam < sizeof(*registro))
-            return false;
+        if (rec->tam < sizeof(*rec) || rec->tam - sizeof(*rec) > GPR_TAMANIO_MASCARA || posicion + rec->tam > tamBanco) {
+            estadisticasFlashConfig.numRegistrosCorruptos++;
+            bancoLleno = true;
+            break;
+        }
+
+        if (registroConfigValido(rec)) {
+            if (rec->secuencia >= secuenciaRegistro)
+                secuenciaRegistro = rec->secuencia + 1;
+        }
+        else
+            estadisticasFlashConfig.numRegistrosCorruptos++;
 
-        crc = calcularCRC16(crc, p, registro->tam);
-        p += registro->tam;
+        posicion += ALINEAR_CONFIG_FLASH(rec->tam);
     }
 
-    const terminacionConfig_t *terminacion = (const terminacionConfig_t *)p;
-    crc = calcularCRC16(crc, terminacion, sizeof(*terminacion));
-    p += sizeof(*terminacion);
+    posicionLibre = posicion;
+}
 
-    // Incluye el CRC guardado en el calculo
-    const uint16_t *crcGuardado = (const uint16_t *)p;
-    crc = calcularCRC16(crc, crcGuardado, sizeof(*crcGuardado));
-    p += sizeof(crcGuardado);
 
-    tamConfigFlash = p - &inicioRegionConfig;
+/***************************************************************************************
+**  Nombre:         bool anadirRegistroConfigFlash(const registroGP_t *reg)
+**  Descripcion:    Anade un registro al final del log del banco activo. La zona debe estar
+**                  borrada: lo que haya dejado una escritura cortada no se reprograma
+**  Parametros:     GP a anadir
+**  Retorno:        True si ok
+****************************************************************************************/
+bool anadirRegistroConfigFlash(const registroGP_t *reg)
+{
+    const uint32_t tam = ALINEAR_CONFIG_FLASH(sizeof(configRegistro_t) + tamanioGP(reg));
+
+    if (posicionLibre + tam > tamBancoConfigFlash() || !zonaBorradaConfigFlash(bancoActivo + posicionLibre, tam)) {
+        bancoLleno = true;
+        return false;
+    }
 
-    return crc == VALOR_CHEQUEO_CRC_CONFIG_FLASH;
+    if (!escribirRegistroConfigFlash((uintptr_t)(bancoActivo + posicionLibre), reg, secuenciaRegistro)) {
+        // El registro puede haber quedado a medias: se recorre de nuevo el log y no se anade nada mas
+        escanearRegistrosConfigFlash();
+        bancoLleno = true;
+        return false;
+    }
+
+    posicionLibre += tam;
+    secuenciaRegistro++;
+    return true;
+}
+
+
+/***************************************************************************************
+**  Nombre:         bool escribirRegistroConfigFlash(uintptr_t dir, const registroGP_t *reg,
+**                                                   uint32_t secuencia)
+**  Descripcion:    Programa la cabecera y despues los datos de un GP. Si se corta la
+**                  alimentacion el CRC descarta el registro. El relleno se deja borrado
+**  Parametros:     Direccion en la flash, GP, secuencia del registro
+**  Retorno:        True si ok
+****************************************************************************************/
+bool escribirRegistroConfigFlash(uintptr_t dir, const registroGP_t *reg, uint32_t secuencia)
+{
+    const uint16_t tamDatos = tamanioGP(reg);
+    const uint16_t tamAlineado = tamDatos & ~(sizeof(uint32_t) - 1);
+    uint32_t resto = VALOR_BORRADO_FLASH;
+
+    configRegistro_t cabecera = {
+        .gpn = numeroGP(reg),
+        .tam = sizeof(configRegistro_t) + tamDatos,
+        .secuencia = secuencia,
+        .version = versionGP(reg),
+        .flags = SISTEMA_CLASIFICACION_CR,
+    };
+
+    cabecera.crc = crcRegistroConfig(&cabecera, reg->dir, tamDatos);
+    memcpy(&resto, reg->dir + tamAlineado, tamDatos - tamAlineado);
+    estadisticasFlashConfig.numRegistrosEscritos++;
+
+    return programarFlash(dir, &cabecera, sizeof(cabecera)) &&
+           programarFlash(dir + sizeof(cabecera), reg->dir, tamAlineado) &&
+           (tamAlineado == tamDatos || programarFlash(dir + sizeof(cabecera) + tamAlineado, &resto, sizeof(resto)));
+}
+
+
+/***************************************************************************************
+**  Nombre:         bool registroActualizadoConfigFlash(const registroGP_t *reg)
+**  Descripcion:    Comprueba si el ultimo registro de un GP coincide con el de la RAM
+**  Parametros:     GP
+**  Retorno:        True si no hace falta guardarlo
+****************************************************************************************/
+bool registroActualizadoConfigFlash(const registroGP_t *reg)
+{
+    const configRegistro_t *rec = encontrarRegFlashConfig(reg, SISTEMA_CLASIFICACION_CR);
+
+    return rec != NULL && rec->version == versionGP(reg) && rec->tam - sizeof(*rec) == tamanioGP(reg) &&
+           memcmp(rec->gp, reg->dir, tamanioGP(reg)) == 0;
 }
 
 
 /***************************************************************************************
 **  Nombre:         configRegistro_t *encontrarRegFlashConfig(const registroGP_t *reg, flagsConfigRegistro_e clasificacion)
-**  Descripcion:    Encuentra un registro en la zona de configuracion
+**  Descripcion:    Encuentra el registro valido con la secuencia mas alta de un GP. Solo se
+**                  comprueba el CRC del candidato y si falla se busca el anterior. Tras un
+**                  registro cortado se reutiliza su secuencia: a igualdad gana el posterior
 **  Parametros:     Registro a encontrar, clasificacion
 **  Retorno:        Registro de configuracion
 ****************************************************************************************/
 const configRegistro_t *encontrarRegFlashConfig(const registroGP_t *reg, flagsConfigRegistro_e clasificacion)
 {
-    const uint8_t *p = &inicioRegionConfig;
+    uint32_t limiteSecuencia = UINT32_MAX;
+
+    if (bancoActivo == NULL)
+        return NULL;
 
-    p += sizeof(cabeceraConfig_t);
     while (1) {
-        const configRegistro_t *rec = (const configRegistro_t *)p;
-        if (rec->tam == 0 || p + rec->tam >= &finRegionConfig || rec->tam < sizeof(*rec))
-            break;
+        const configRegistro_t *encontrado = NULL;
+
+        // El escaneo ha comprobado los tamanios hasta la posicion libre
+        for (uint32_t posicion = sizeof(cabeceraBancoConfig_t); posicion < posicionLibre; ) {
+            const configRegistro_t *rec = (const configRegistro_t *)(bancoActivo + posicion);
+
+            if (numeroGP(reg) == rec->gpn && (rec->flags & MASCARA_CLASIFICACION_CR_CONFIG_FLASH) == clasificacion &&
+                rec->secuencia < limiteSecuencia && (encontrado == NULL || rec->secuencia >= encontrado->secuencia))
+                encontrado = rec;
+
+            posicion += ALINEAR_CONFIG_FLASH(rec->tam);
+        }
 
-        if (numeroGP(reg) == rec->gpn && (rec->flags & MASCARA_CLASIFICACION_CR_CONFIG_FLASH) == clasificacion)
-            return rec;
+        if (encontrado == NULL || registroConfigValido(encontrado))
+            return encontrado;
 
-        p += rec->tam;
+        limiteSecuencia = encontrado->secuencia;
     }
-    // Registro no encontrado
-    return NULL;
 }
 
+
+/***************************************************************************************
+**  Nombre:         bool cabeceraBancoConfigValida(const cabeceraBancoConfig_t *cabecera)
+**  Descripcion:    Comprueba el numero magico y el CRC de la cabecera de un banco
+**  Parametros:     Cabecera
+**  Retorno:        True si ok
+****************************************************************************************/
+bool cabeceraBancoConfigValida(const cabeceraBancoConfig_t *cabecera)
+{
+    return cabecera->magico == MAGICO_BANCO_CONFIG_FLASH &&
+           cabecera->crc == calcularCRC16(cabecera, offsetof(cabeceraBancoConfig_t, crc));
+}
+
+
+/***************************************************************************************
+**  Nombre:         bool registroConfigValido(const configRegistro_t *registro)
+**  Descripcion:    Comprueba el CRC de un registro con un tamanio ya verificado
+**  Parametros:     Registro
+**  Retorno:        True si ok
+****************************************************************************************/
+bool registroConfigValido(const configRegistro_t *registro)
+{
+    return registro->crc == crcRegistroConfig(registro, registro->gp, registro->tam - sizeof(*registro));
+}
+
+
+/***************************************************************************************
+**  Nombre:         uint16_t crcRegistroConfig(const configRegistro_t *cabecera, const void *datos,
+**                                             uint16_t tamDatos)
+**  Descripcion:    Calcula el CRC de la cabecera, sin el propio CRC, y de los datos
+**  Parametros:     Cabecera, datos, tamanio de los datos
+**  Retorno:        CRC
+****************************************************************************************/
+uint16_t crcRegistroConfig(const configRegistro_t *cabecera, const void *datos, uint16_t tamDatos)
+{
+    uint16_t crc = iniciarCRC16();
+
+    crc = actualizarCRC16(crc, cabecera, offsetof(configRegistro_t, crc));
+    crc = actualizarCRC16(crc, datos, tamDatos);
+    return finalizarCRC16(crc);
+}
+
+
+/***************************************************************************************
+**  Nombre:         bool zonaBorradaConfigFlash(const uint8_t *p, uint32_t tam)
+**  Descripcion:    Comprueba que una zona alineada a word esta borrada
+**  Parametros:     Inicio de la zona, tamanio
+**  Retorno:        True si esta borrada
+****************************************************************************************/
+bool zonaBorradaConfigFlash(const uint8_t *p, uint32_t tam)
+{
+    const uint32_t *word = (const uint32_t *)p;
+
+    for (uint32_t i = 0; i < tam / sizeof(uint32_t); i++) {
+        if (word[i] != VALOR_BORRADO_FLASH)
+            return false;
+    }
+
+    return true;
+}
+
+
+/***************************************************************************************
+**  Nombre:         const uint8_t *dirBancoConfigFlash(uint8_t banco)
+**  Descripcion:    Obtiene la direccion de inicio de un banco
+**  Parametros:     Numero del banco
+**  Retorno:        Direccion del banco
+****************************************************************************************/
+const uint8_t *dirBancoConfigFlash(uint8_t banco)
+{
+    return inicioRegionConfig + banco * tamBancoConfigFlash();
+}
+
+
+/***************************************************************************************
+**  Nombre:         uint32_t tamBancoConfigFlash(void)
+**  Descripcion:    Obtiene el tamanio de cada banco. La region definida en el linker debe
+**                  ocupar sectores completos y repartirse entre los bancos
+**  Parametros:     Ninguno
+**  Retorno:        Tamanio del banco en bytes
+****************************************************************************************/
+uint32_t tamBancoConfigFlash(void)
+{
+    return (uint32_t)(finRegionConfig - inicioRegionConfig) / NUM_BANCOS_CONFIG_FLASH;
+}
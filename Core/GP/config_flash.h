@@ -1,5 +1,6 @@
 /***************************************************************************************
-**  config_flash.h - Funciones de gestion la zona flash para los GP
+**  config_flash.h - Funciones de gestion la zona flash para los GP. Los GP se guardan
+**                   como un log de registros en dos bancos que se compactan al llenarse
 **
 **
 **  Este fichero forma parte del proyecto URpilot.
@@ -7,7 +8,7 @@
 **
 **  Autor: Ramon Rico
 **  Fecha de creacion: 07/05/2019
-**  Fecha de modificacion: 03/08/2020
+**  Fecha de modificacion: 17/10/2026
 **
 **  El proyecto URpilot NO es libre. No se puede distribuir y/o modificar este fichero
 **  bajo ningun concepto.
@@ -37,12 +38,20 @@
 /***************************************************************************************
 ** AREA DE PREPROCESADOR                                                              **
 ****************************************************************************************/
-#define VERSION_CONFIG_FLASH           1
+#define VERSION_CONFIG_FLASH           2
 
 
 /***************************************************************************************
 ** AREA DE DEFINICION DE TIPOS                                                        **
 ****************************************************************************************/
+typedef struct {
+    uint32_t numGuardados;
+    uint32_t numRegistrosEscritos;
+    uint32_t numCompactaciones;
+    uint32_t numRegistrosCorruptos;      // Encontrados al escanear el banco activo
+    uint32_t generacion;                 // Del banco activo
+    uint32_t bytesLibres;                // Del banco activo
+} estadisticasConfigFlash_t;
 
 
 /***************************************************************************************
@@ -57,6 +66,8 @@ void iniciarConfigFlash(void);
 bool cargarConfigFlash(void);
 void resetearConfigFlash(void);
 bool versionValidaConfigFlash(void);
+bool guardarConfigFlash(void);
+void estadisticasConfigFlash(estadisticasConfigFlash_t *estadisticas);
 
 #endif // __CONFIG_FLASH_H
 
@@ -7,7 +7,7 @@
 **
 **  Autor: Ramon Rico
 **  Fecha de creacion: 07/05/2019
-**  Fecha de modificacion: 03/08/2020
+**  Fecha de modificacion: 17/10/2026
 **
 **  El proyecto URpilot NO es libre. No se puede distribuir y/o modificar este fichero
 **  bajo ningun concepto.
@@ -30,6 +30,7 @@
 ****************************************************************************************/
 #include <stdint.h>
 #include <stdbool.h>
+#include <stddef.h>
 
 #include "Sistema/plataforma.h"
 #include "gp_ids.h"
@@ -40,11 +41,16 @@
 ****************************************************************************************/
 #define ATRIBUTOS_REGISTRO_GP         __attribute__  ((section(".registroGP"), used, aligned(4)))
 #define ATRIBUTOS_RESET_GP            __attribute__  ((section(".resetGP"), used, aligned(2)))
+#define ATRIBUTOS_DESCRIPCION_GP      __attribute__  ((section(".descripcionGP"), used, aligned(4)))
 
 // Macro para iterar todos los grupos de parametros
 #define POR_CADA_GP(nombreGP) \
     for (const registroGP_t *(nombreGP) = _sregistroGP; (nombreGP) < _eregistroGP; nombreGP++)
 
+// Macro para iterar las descripciones de los grupos de parametros
+#define POR_CADA_DESCRIPCION_GP(descripcion) \
+    for (const descripcionGP_t *(descripcion) = _sdescripcionGP; (descripcion) < _edescripcionGP; descripcion++)
+
 // Resetea la configuration a los valores por defecto
 #define RESETEAR_GP(nombreGP)                                       \
     do {                                                            \
@@ -112,6 +118,24 @@
         __VA_ARGS__                                                                \
     }
 
+// Describe un campo de un grupo de parametros. El tamanio se toma del propio campo
+#define CAMPO_GP(tipoGP, campo, tipo, min, max)                                                   \
+    { #campo, offsetof(tipoGP, campo), sizeof(((tipoGP *)0)->campo), tipo, 1, 0, min, max }      \
+
+// Describe un campo que se repite: sus elementos estan separados paso bytes a partir de campo
+#define CAMPO_ARRAY_GP(tipoGP, nombre, campo, tipo, numElementos, paso, min, max)                \
+    { nombre, offsetof(tipoGP, campo), sizeof(((tipoGP *)0)->campo), tipo, numElementos, paso, min, max } \
+
+// Publica los campos de un grupo de parametros registrado para configurarlo desde el host
+#define DESCRIBIR_GP(nombreGP, nombreDescripcion, ...)                                            \
+    static const campoGP_t nombreGP ## _Campos[] = { __VA_ARGS__ };                              \
+    const descripcionGP_t nombreGP ## _Descripcion ATRIBUTOS_DESCRIPCION_GP = {                  \
+        .registro = &nombreGP ## _Registro,                                                      \
+        .nombre = nombreDescripcion,                                                             \
+        .numCampos = sizeof(nombreGP ## _Campos) / sizeof(nombreGP ## _Campos[0]),               \
+        .campos = nombreGP ## _Campos,                                                           \
+    }
+
 
 /***************************************************************************************
 ** AREA DE DEFINICION DE TIPOS                                                        **
@@ -137,6 +161,31 @@ typedef struct {
     } reset;
 } registroGP_t;
 
+typedef enum {
+    CAMPO_NATURAL_GP = 0,  // Entero sin signo o enumerado
+    CAMPO_ENTERO_GP,       // Entero con signo
+    CAMPO_REAL_GP,         // float
+    CAMPO_BOOL_GP,
+} tipoCampoGP_e;
+
+typedef struct {
+    const char *nombre;
+    uint16_t offset;       // Posicion del primer elemento en el GP
+    uint8_t tam;           // Bytes de cada elemento
+    tipoCampoGP_e tipo;
+    uint8_t numElementos;
+    uint16_t paso;         // Bytes entre elementos consecutivos
+    float min;
+    float max;
+} campoGP_t;
+
+typedef struct {
+    const registroGP_t *registro;
+    const char *nombre;
+    uint8_t numCampos;
+    const campoGP_t *campos;
+} descripcionGP_t;
+
 
 /***************************************************************************************
 ** AREA DE DECLARACION DE VARIABLES                                                   **
@@ -145,6 +194,8 @@ extern const registroGP_t _sregistroGP[];
 extern const registroGP_t _eregistroGP[];
 extern const uint8_t _sresetGP[];
 extern const uint8_t _eresetGP[];
+extern const descripcionGP_t _sdescripcionGP[];
+extern const descripcionGP_t _edescripcionGP[];
 
 
 /***************************************************************************************
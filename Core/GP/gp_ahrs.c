@@ -7,7 +7,7 @@
 **
 **  Autor: Ramon Rico
 **  Fecha de creacion: 23/09/2020
-**  Fecha de modificacion: 06/10/2020
+**  Fecha de modificacion: 17/10/2026
 **
 **  El proyecto URpilot NO es libre. No se puede distribuir y/o modificar este fichero
 **  bajo ningun concepto.
@@ -49,6 +49,13 @@
 #define MADGWICK_BETA_MARG    0.041
 #define MADGWICK_ZETA_MARG    0.005
 
+#define NAV_RETARDO_GPS       120       // ms
+#define NAV_RUIDO_ACEL        0.35
+#define NAV_RUIDO_BIAS_ACEL   0.005
+#define NAV_RUIDO_BARO        0.5
+#define NAV_RUIDO_BIAS_BARO   0.02
+#define NAV_UMBRAL_INNOV      5.0
+
 
 /***************************************************************************************
 ** AREA DE DEFINICION DE TIPOS                                                        **
@@ -58,7 +65,7 @@
 /***************************************************************************************
 ** AREA DE DECLARACION DE VARIABLES                                                   **
 ****************************************************************************************/
-REGISTRAR_GP_CON_TEMPLATE_RESET(configAHRS_t, configAHRS, GP_CONFIGURACION_AHRS, 1);
+REGISTRAR_GP_CON_TEMPLATE_RESET(configAHRS_t, configAHRS, GP_CONFIGURACION_AHRS, 2);
 
 TEMPLATE_RESET_GP(configAHRS_t, configAHRS,
     .filtro = FILTRO_AHRS,
@@ -76,6 +83,36 @@ TEMPLATE_RESET_GP(configAHRS_t, configAHRS,
     .madgwick.zeta = MADGWICK_ZETA,
     .madgwick.betaMarg = 2 * MADGWICK_BETA_MARG,
     .madgwick.zetaMarg = MADGWICK_ZETA_MARG,
+    .navegacion.retardoGPS = NAV_RETARDO_GPS,
+    .navegacion.ruidoAcel = NAV_RUIDO_ACEL,
+    .navegacion.ruidoBiasAcel = NAV_RUIDO_BIAS_ACEL,
+    .navegacion.ruidoBaro = NAV_RUIDO_BARO,
+    .navegacion.ruidoBiasBaro = NAV_RUIDO_BIAS_BARO,
+    .navegacion.umbralInnovacion = NAV_UMBRAL_INNOV,
+);
+
+DESCRIBIR_GP(configAHRS, "ahrs",
+    CAMPO_GP(configAHRS_t, filtro, CAMPO_NATURAL_GP, MAHONY, MADGWICK),
+    CAMPO_GP(configAHRS_t, habilitarMag, CAMPO_BOOL_GP, 0, 1),
+    CAMPO_GP(configAHRS_t, fecFiltroAcelAng, CAMPO_NATURAL_GP, 1, 500),
+    CAMPO_GP(configAHRS_t, kFC, CAMPO_REAL_GP, 0, 1),
+    CAMPO_GP(configAHRS_t, mahony.kpIni, CAMPO_REAL_GP, 0, 50),
+    CAMPO_GP(configAHRS_t, mahony.kiIni, CAMPO_REAL_GP, 0, 50),
+    CAMPO_GP(configAHRS_t, mahony.kp, CAMPO_REAL_GP, 0, 50),
+    CAMPO_GP(configAHRS_t, mahony.ki, CAMPO_REAL_GP, 0, 50),
+    CAMPO_GP(configAHRS_t, mahony.kpMarg, CAMPO_REAL_GP, 0, 50),
+    CAMPO_GP(configAHRS_t, mahony.kiMarg, CAMPO_REAL_GP, 0, 50),
+    CAMPO_GP(configAHRS_t, madgwick.betaIni, CAMPO_REAL_GP, 0, 10),
+    CAMPO_GP(configAHRS_t, madgwick.beta, CAMPO_REAL_GP, 0, 10),
+    CAMPO_GP(configAHRS_t, madgwick.zeta, CAMPO_REAL_GP, 0, 1),
+    CAMPO_GP(configAHRS_t, madgwick.betaMarg, CAMPO_REAL_GP, 0, 10),
+    CAMPO_GP(configAHRS_t, madgwick.zetaMarg, CAMPO_REAL_GP, 0, 1),
+    CAMPO_GP(configAHRS_t, navegacion.retardoGPS, CAMPO_NATURAL_GP, 0, 1000),
+    CAMPO_GP(configAHRS_t, navegacion.ruidoAcel, CAMPO_REAL_GP, 0.001, 10),
+    CAMPO_GP(configAHRS_t, navegacion.ruidoBiasAcel, CAMPO_REAL_GP, 0.00001, 1),
+    CAMPO_GP(configAHRS_t, navegacion.ruidoBaro, CAMPO_REAL_GP, 0.01, 50),
+    CAMPO_GP(configAHRS_t, navegacion.ruidoBiasBaro, CAMPO_REAL_GP, 0.00001, 1),
+    CAMPO_GP(configAHRS_t, navegacion.umbralInnovacion, CAMPO_REAL_GP, 1, 100),
 );
 
 
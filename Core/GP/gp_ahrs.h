@@ -7,7 +7,7 @@
 **
 **  Autor: Ramon Rico
 **  Fecha de creacion: 23/09/2020
-**  Fecha de modificacion: 06/10/2020
+**  Fecha de modificacion: 17/10/2026
 **
 **  El proyecto URpilot NO es libre. No se puede distribuir y/o modificar este fichero
 **  bajo ningun concepto.
@@ -62,6 +62,15 @@ typedef struct {
     float zetaMarg;
 } configMadgwick_t;
 
+typedef struct {
+    uint16_t retardoGPS;        // ms desde el instante de la medida hasta que llega a la navegacion
+    float ruidoAcel;            // m/s²
+    float ruidoBiasAcel;        // m/s³
+    float ruidoBaro;            // m
+    float ruidoBiasBaro;        // m/s
+    float umbralInnovacion;     // Desviaciones tipicas para rechazar una medida
+} configNavegacion_t;
+
 typedef struct {
 	ahrs_e filtro;
 	bool habilitarMag;
@@ -69,6 +78,7 @@ typedef struct {
     float kFC;
     configMahony_t mahony;
     configMadgwick_t madgwick;
+    configNavegacion_t navegacion;
 } configAHRS_t;
 
 
@@ -7,7 +7,7 @@
 **
 **  Autor: Ramon Rico
 **  Fecha de creacion: 16/05/2020
-**  Fecha de modificacion: 12/09/2020
+**  Fecha de modificacion: 17/10/2026
 **
 **  El proyecto URpilot NO es libre. No se puede distribuir y/o modificar este fichero
 **  bajo ningun concepto.
@@ -52,6 +52,11 @@ TEMPLATE_RESET_GP(configBlackbox_t, configBlackbox,
     .ratioLento = ACTUALIZACION_LENTA_BLACKBOX_MS,
 );
 
+DESCRIBIR_GP(configBlackbox, "blackbox",
+    CAMPO_GP(configBlackbox_t, ratio, CAMPO_NATURAL_GP, 1, 1000),
+    CAMPO_GP(configBlackbox_t, ratioLento, CAMPO_NATURAL_GP, 10, 10000),
+);
+
 
 /***************************************************************************************
 ** AREA DE PROTOTIPOS DE FUNCION                                                      **
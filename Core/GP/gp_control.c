@@ -7,7 +7,7 @@
 **
 **  Autor: Ramon Rico
 **  Fecha de creacion: 07/02/2021
-**  Fecha de modificacion: 07/02/2021
+**  Fecha de modificacion: 17/10/2026
 **
 **  El proyecto URpilot NO es libre. No se puede distribuir y/o modificar este fichero
 **  bajo ningun concepto.
@@ -31,47 +31,87 @@
 /***************************************************************************************
 ** AREA DE PREPROCESADOR                                                              **
 ****************************************************************************************/
-#define KP_CONTROL_VEL_ANG_ROLL       0.15
-#define KI_CONTROL_VEL_ANG_ROLL       0.2
-#define KD_CONTROL_VEL_ANG_ROLL       0.003
-#define KFF_CONTROL_VEL_ANG_ROLL      0.0
-#define LIM_I_CONTROL_VEL_ANG_ROLL    0.3
-#define LIM_U_CONTROL_VEL_ANG_ROLL    0.5
-
-#define KP_CONTROL_VEL_ANG_PITCH      0.15
-#define KI_CONTROL_VEL_ANG_PITCH      0.2
-#define KD_CONTROL_VEL_ANG_PITCH      0.003
-#define KFF_CONTROL_VEL_ANG_PITCH     0.0
-#define LIM_I_CONTROL_VEL_ANG_PITCH   0.3
-#define LIM_U_CONTROL_VEL_ANG_PITCH   0.5
-
-#define KP_CONTROL_VEL_ANG_YAW        0.2
-#define KI_CONTROL_VEL_ANG_YAW        0.1
-#define KD_CONTROL_VEL_ANG_YAW        0.0
-#define KFF_CONTROL_VEL_ANG_YAW       0.0
-#define LIM_I_CONTROL_VEL_ANG_YAW     0.3
-#define LIM_U_CONTROL_VEL_ANG_YAW     0.5
-
-#define KP_CONTROL_ACTITUD_ROLL       6.5
-#define KI_CONTROL_ACTITUD_ROLL       0.0
-#define KD_CONTROL_ACTITUD_ROLL       0.0
-#define KFF_CONTROL_ACTITUD_ROLL      0.0
-#define LIM_I_CONTROL_ACTITUD_ROLL    0.0
-#define LIM_U_CONTROL_ACTITUD_ROLL    200.0
-
-#define KP_CONTROL_ACTITUD_PITCH      6.5
-#define KI_CONTROL_ACTITUD_PITCH      0.0
-#define KD_CONTROL_ACTITUD_PITCH      0.0
-#define KFF_CONTROL_ACTITUD_PITCH     0.0
-#define LIM_I_CONTROL_ACTITUD_PITCH   0.0
-#define LIM_U_CONTROL_ACTITUD_PITCH   200.0
-
-#define KP_CONTROL_ACTITUD_YAW        0.0
-#define KI_CONTROL_ACTITUD_YAW        0.0
-#define KD_CONTROL_ACTITUD_YAW        0.0
-#define KFF_CONTROL_ACTITUD_YAW       0.0
-#define LIM_I_CONTROL_ACTITUD_YAW     0.0
-#define LIM_U_CONTROL_ACTITUD_YAW     0.0
+#define KP_CONTROL_VEL_ANG_ROLL           0.000425
+#define KI_CONTROL_VEL_ANG_ROLL           0.0005
+#define KD_CONTROL_VEL_ANG_ROLL           0.00002
+#define KFF_CONTROL_VEL_ANG_ROLL          0.0
+#define LIM_I_CONTROL_VEL_ANG_ROLL        0.5
+#define LIM_U_CONTROL_VEL_ANG_ROLL        1.0
+#define PESO_SP_CONTROL_VEL_ANG_ROLL      1.0
+#define FREC_D_CONTROL_VEL_ANG_ROLL       100.0
+#define K_AW_CONTROL_VEL_ANG_ROLL         5.0
+
+#define KP_CONTROL_VEL_ANG_PITCH          0.00119
+#define KI_CONTROL_VEL_ANG_PITCH          0.0014
+#define KD_CONTROL_VEL_ANG_PITCH          0.000056
+#define KFF_CONTROL_VEL_ANG_PITCH         0.0
+#define LIM_I_CONTROL_VEL_ANG_PITCH       0.5
+#define LIM_U_CONTROL_VEL_ANG_PITCH       1.0
+#define PESO_SP_CONTROL_VEL_ANG_PITCH     1.0
+#define FREC_D_CONTROL_VEL_ANG_PITCH      100.0
+#define K_AW_CONTROL_VEL_ANG_PITCH        5.0
+
+#define KP_CONTROL_VEL_ANG_YAW            0.006
+#define KI_CONTROL_VEL_ANG_YAW            0.006
+#define KD_CONTROL_VEL_ANG_YAW            0.0
+#define KFF_CONTROL_VEL_ANG_YAW           0.0
+#define LIM_I_CONTROL_VEL_ANG_YAW         0.2
+#define LIM_U_CONTROL_VEL_ANG_YAW         0.3
+#define PESO_SP_CONTROL_VEL_ANG_YAW       1.0
+#define FREC_D_CONTROL_VEL_ANG_YAW        100.0
+#define K_AW_CONTROL_VEL_ANG_YAW          5.0
+
+#define KP_CONTROL_ACTITUD_ROLL           5.0
+#define KI_CONTROL_ACTITUD_ROLL           0.0
+#define KD_CONTROL_ACTITUD_ROLL           0.0
+#define KFF_CONTROL_ACTITUD_ROLL          0.0
+#define LIM_I_CONTROL_ACTITUD_ROLL        0.0
+#define LIM_U_CONTROL_ACTITUD_ROLL        200.0
+#define PESO_SP_CONTROL_ACTITUD_ROLL      1.0
+#define FREC_D_CONTROL_ACTITUD_ROLL       0.0
+#define K_AW_CONTROL_ACTITUD_ROLL         0.0
+
+#define KP_CONTROL_ACTITUD_PITCH          4.0
+#define KI_CONTROL_ACTITUD_PITCH          0.0
+#define KD_CONTROL_ACTITUD_PITCH          0.0
+#define KFF_CONTROL_ACTITUD_PITCH         0.0
+#define LIM_I_CONTROL_ACTITUD_PITCH       0.0
+#define LIM_U_CONTROL_ACTITUD_PITCH       200.0
+#define PESO_SP_CONTROL_ACTITUD_PITCH     1.0
+#define FREC_D_CONTROL_ACTITUD_PITCH      0.0
+#define K_AW_CONTROL_ACTITUD_PITCH        0.0
+
+// El lazo de actitud no actua sobre yaw: la radio da la referencia de velocidad angular
+#define KP_CONTROL_ACTITUD_YAW            0.0
+#define KI_CONTROL_ACTITUD_YAW            0.0
+#define KD_CONTROL_ACTITUD_YAW            0.0
+#define KFF_CONTROL_ACTITUD_YAW           0.0
+#define LIM_I_CONTROL_ACTITUD_YAW         0.0
+#define LIM_U_CONTROL_ACTITUD_YAW         0.0
+#define PESO_SP_CONTROL_ACTITUD_YAW       1.0
+#define FREC_D_CONTROL_ACTITUD_YAW        0.0
+#define K_AW_CONTROL_ACTITUD_YAW          0.0
+
+#define UMBRAL_TPA_CONTROL                0.5
+#define ATENUACION_TPA_CONTROL            0.3
+
+#define MAX_PARAMETRO_PID_GP          1000.0
+
+// Campos de un lazo. Cada campo tiene un elemento por eje
+#define CAMPOS_PID_GP(lazo)                                                                                                   \
+    CAMPO_ARRAY_GP(configPID_t, #lazo ".kp", lazo[0].kp, CAMPO_REAL_GP, 3, sizeof(paramPID_t), 0, MAX_PARAMETRO_PID_GP),     \
+    CAMPO_ARRAY_GP(configPID_t, #lazo ".ki", lazo[0].ki, CAMPO_REAL_GP, 3, sizeof(paramPID_t), 0, MAX_PARAMETRO_PID_GP),     \
+    CAMPO_ARRAY_GP(configPID_t, #lazo ".kd", lazo[0].kd, CAMPO_REAL_GP, 3, sizeof(paramPID_t), 0, MAX_PARAMETRO_PID_GP),     \
+    CAMPO_ARRAY_GP(configPID_t, #lazo ".kff", lazo[0].kff, CAMPO_REAL_GP, 3, sizeof(paramPID_t), 0, MAX_PARAMETRO_PID_GP),   \
+    CAMPO_ARRAY_GP(configPID_t, #lazo ".limIntegral", lazo[0].limIntegral, CAMPO_REAL_GP, 3, sizeof(paramPID_t), 0,          \
+                   MAX_PARAMETRO_PID_GP),                                                                                     \
+    CAMPO_ARRAY_GP(configPID_t, #lazo ".limSalida", lazo[0].limSalida, CAMPO_REAL_GP, 3, sizeof(paramPID_t), 0,              \
+                   MAX_PARAMETRO_PID_GP),                                                                                     \
+    CAMPO_ARRAY_GP(configPID_t, #lazo ".pesoSetpoint", lazo[0].pesoSetpoint, CAMPO_REAL_GP, 3, sizeof(paramPID_t), 0, 1),    \
+    CAMPO_ARRAY_GP(configPID_t, #lazo ".frecCorteD", lazo[0].frecCorteD, CAMPO_REAL_GP, 3, sizeof(paramPID_t), 0,            \
+                   MAX_PARAMETRO_PID_GP),                                                                                     \
+    CAMPO_ARRAY_GP(configPID_t, #lazo ".kAntiWindup", lazo[0].kAntiWindup, CAMPO_REAL_GP, 3, sizeof(paramPID_t), 0,          \
+                   MAX_PARAMETRO_PID_GP)
 
 
 /***************************************************************************************
@@ -82,7 +122,7 @@
 /***************************************************************************************
 ** AREA DE DECLARACION DE VARIABLES                                                   **
 ****************************************************************************************/
-REGISTRAR_GP_CON_TEMPLATE_RESET(configPID_t, configPID, GP_CONFIGURACION_PID, 1);
+REGISTRAR_GP_CON_TEMPLATE_RESET(configPID_t, configPID, GP_CONFIGURACION_PID, 2);
 
 TEMPLATE_RESET_GP(configPID_t, configPID,
     .pVelAng[ROLL].kp = KP_CONTROL_VEL_ANG_ROLL,
@@ -91,6 +131,9 @@ TEMPLATE_RESET_GP(configPID_t, configPID,
     .pVelAng[ROLL].kff = KFF_CONTROL_VEL_ANG_ROLL,
     .pVelAng[ROLL].limIntegral = LIM_I_CONTROL_VEL_ANG_ROLL,
     .pVelAng[ROLL].limSalida = LIM_U_CONTROL_VEL_ANG_ROLL,
+    .pVelAng[ROLL].pesoSetpoint = PESO_SP_CONTROL_VEL_ANG_ROLL,
+    .pVelAng[ROLL].frecCorteD = FREC_D_CONTROL_VEL_ANG_ROLL,
+    .pVelAng[ROLL].kAntiWindup = K_AW_CONTROL_VEL_ANG_ROLL,
 
     .pVelAng[PITCH].kp = KP_CONTROL_VEL_ANG_PITCH,
     .pVelAng[PITCH].ki = KI_CONTROL_VEL_ANG_PITCH,
@@ -98,6 +141,9 @@ TEMPLATE_RESET_GP(configPID_t, configPID,
     .pVelAng[PITCH].kff = KFF_CONTROL_VEL_ANG_PITCH,
     .pVelAng[PITCH].limIntegral = LIM_I_CONTROL_VEL_ANG_PITCH,
     .pVelAng[PITCH].limSalida = LIM_U_CONTROL_VEL_ANG_PITCH,
+    .pVelAng[PITCH].pesoSetpoint = PESO_SP_CONTROL_VEL_ANG_PITCH,
+    .pVelAng[PITCH].frecCorteD = FREC_D_CONTROL_VEL_ANG_PITCH,
+    .pVelAng[PITCH].kAntiWindup = K_AW_CONTROL_VEL_ANG_PITCH,
 
     .pVelAng[YAW].kp = KP_CONTROL_VEL_ANG_YAW,
     .pVelAng[YAW].ki = KI_CONTROL_VEL_ANG_YAW,
@@ -105,27 +151,54 @@ TEMPLATE_RESET_GP(configPID_t, configPID,
     .pVelAng[YAW].kff = KFF_CONTROL_VEL_ANG_YAW,
     .pVelAng[YAW].limIntegral = LIM_I_CONTROL_VEL_ANG_YAW,
     .pVelAng[YAW].limSalida = LIM_U_CONTROL_VEL_ANG_YAW,
+    .pVelAng[YAW].pesoSetpoint = PESO_SP_CONTROL_VEL_ANG_YAW,
+    .pVelAng[YAW].frecCorteD = FREC_D_CONTROL_VEL_ANG_YAW,
+    .pVelAng[YAW].kAntiWindup = K_AW_CONTROL_VEL_ANG_YAW,
 
     .pActitud[ROLL].kp = KP_CONTROL_ACTITUD_ROLL,
     .pActitud[ROLL].ki = KI_CONTROL_ACTITUD_ROLL,
     .pActitud[ROLL].kd = KD_CONTROL_ACTITUD_ROLL,
-	.pActitud[ROLL].kff = KFF_CONTROL_ACTITUD_ROLL,
-	.pActitud[ROLL].limIntegral = LIM_I_CONTROL_ACTITUD_ROLL,
-	.pActitud[ROLL].limSalida = LIM_U_CONTROL_ACTITUD_ROLL,
+    .pActitud[ROLL].kff = KFF_CONTROL_ACTITUD_ROLL,
+    .pActitud[ROLL].limIntegral = LIM_I_CONTROL_ACTITUD_ROLL,
+    .pActitud[ROLL].limSalida = LIM_U_CONTROL_ACTITUD_ROLL,
+    .pActitud[ROLL].pesoSetpoint = PESO_SP_CONTROL_ACTITUD_ROLL,
+    .pActitud[ROLL].frecCorteD = FREC_D_CONTROL_ACTITUD_ROLL,
+    .pActitud[ROLL].kAntiWindup = K_AW_CONTROL_ACTITUD_ROLL,
 
     .pActitud[PITCH].kp = KP_CONTROL_ACTITUD_PITCH,
     .pActitud[PITCH].ki = KI_CONTROL_ACTITUD_PITCH,
     .pActitud[PITCH].kd = KD_CONTROL_ACTITUD_PITCH,
-	.pActitud[PITCH].kff = KFF_CONTROL_ACTITUD_PITCH,
-	.pActitud[PITCH].limIntegral = LIM_I_CONTROL_ACTITUD_PITCH,
-	.pActitud[PITCH].limSalida = LIM_U_CONTROL_ACTITUD_PITCH,
+    .pActitud[PITCH].kff = KFF_CONTROL_ACTITUD_PITCH,
+    .pActitud[PITCH].limIntegral = LIM_I_CONTROL_ACTITUD_PITCH,
+    .pActitud[PITCH].limSalida = LIM_U_CONTROL_ACTITUD_PITCH,
+    .pActitud[PITCH].pesoSetpoint = PESO_SP_CONTROL_ACTITUD_PITCH,
+    .pActitud[PITCH].frecCorteD = FREC_D_CONTROL_ACTITUD_PITCH,
+    .pActitud[PITCH].kAntiWindup = K_AW_CONTROL_ACTITUD_PITCH,
 
     .pActitud[YAW].kp = KP_CONTROL_ACTITUD_YAW,
     .pActitud[YAW].ki = KI_CONTROL_ACTITUD_YAW,
     .pActitud[YAW].kd = KD_CONTROL_ACTITUD_YAW,
-	.pActitud[YAW].kff = KFF_CONTROL_ACTITUD_YAW,
-	.pActitud[YAW].limIntegral = LIM_I_CONTROL_ACTITUD_YAW,
-	.pActitud[YAW].limSalida = LIM_U_CONTROL_ACTITUD_YAW,
+    .pActitud[YAW].kff = KFF_CONTROL_ACTITUD_YAW,
+    .pActitud[YAW].limIntegral = LIM_I_CONTROL_ACTITUD_YAW,
+    .pActitud[YAW].limSalida = LIM_U_CONTROL_ACTITUD_YAW,
+    .pActitud[YAW].pesoSetpoint = PESO_SP_CONTROL_ACTITUD_YAW,
+    .pActitud[YAW].frecCorteD = FREC_D_CONTROL_ACTITUD_YAW,
+    .pActitud[YAW].kAntiWindup = K_AW_CONTROL_ACTITUD_YAW,
+
+    .pPosicion[ROLL].pesoSetpoint = 1.0,
+    .pPosicion[PITCH].pesoSetpoint = 1.0,
+    .pPosicion[YAW].pesoSetpoint = 1.0,
+
+    .umbralTPA = UMBRAL_TPA_CONTROL,
+    .atenuacionTPA = ATENUACION_TPA_CONTROL,
+);
+
+DESCRIBIR_GP(configPID, "pid",
+    CAMPOS_PID_GP(pVelAng),
+    CAMPOS_PID_GP(pActitud),
+    CAMPOS_PID_GP(pPosicion),
+    CAMPO_GP(configPID_t, umbralTPA, CAMPO_REAL_GP, 0, 1),
+    CAMPO_GP(configPID_t, atenuacionTPA, CAMPO_REAL_GP, 0, 1),
 );
 
 
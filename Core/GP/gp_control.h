@@ -7,7 +7,7 @@
 **
 **  Autor: Ramon Rico
 **  Fecha de creacion: 07/02/2020
-**  Fecha de modificacion: 07/02/2020
+**  Fecha de modificacion: 17/10/2026
 **
 **  El proyecto URpilot NO es libre. No se puede distribuir y/o modificar este fichero
 **  bajo ningun concepto.
@@ -49,6 +49,8 @@ typedef struct {
 	paramPID_t pVelAng[3];
 	paramPID_t pActitud[3];
 	paramPID_t pPosicion[3];
+    float umbralTPA;            // Acelerador (0 a 1) a partir del cual se atenuan kp y kd del lazo de velocidad angular
+    float atenuacionTPA;        // Atenuacion con el acelerador al maximo (0 a 1)
 } configPID_t;
 
 
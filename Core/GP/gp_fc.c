@@ -7,7 +7,7 @@
 **
 **  Autor: Ramon Rico
 **  Fecha de creacion: 06/02/2021
-**  Fecha de modificacion: 06/02/2021
+**  Fecha de modificacion: 17/10/2026
 **
 **  El proyecto URpilot NO es libre. No se puede distribuir y/o modificar este fichero
 **  bajo ningun concepto.
@@ -49,6 +49,12 @@ TEMPLATE_RESET_GP(configFC_t, configFC,
     .frecLazoPosicion = FREC_ACTUALIZAR_POSICION_FC_HZ
 );
 
+DESCRIBIR_GP(configFC, "fc",
+    CAMPO_GP(configFC_t, frecLazoVelAngular, CAMPO_NATURAL_GP, 100, 8000),
+    CAMPO_GP(configFC_t, frecLazoActitud, CAMPO_NATURAL_GP, 50, 4000),
+    CAMPO_GP(configFC_t, frecLazoPosicion, CAMPO_NATURAL_GP, 10, 1000),
+);
+
 
 /***************************************************************************************
 ** AREA DE PROTOTIPOS DE FUNCION                                                      **
@@ -7,7 +7,7 @@
 **
 **  Autor: Ramon Rico
 **  Fecha de creacion: 07/05/2019
-**  Fecha de modificacion: 22/09/2020
+**  Fecha de modificacion: 17/10/2026
 **
 **  El proyecto URpilot NO es libre. No se puede distribuir y/o modificar este fichero
 **  bajo ningun concepto.
@@ -64,5 +64,7 @@
 #define GP_CONFIGURACION_PID             116
 #define GP_CONFIGURACION_CAL_IMU         117
 #define GP_CONFIGURACION_CAL_MAG         118
+#define GP_CONFIGURACION_NOTCH_DINAMICO  119
+#define GP_CONFIGURACION_FILTRO_RPM      120
 
 #endif // __GP_IDS_H
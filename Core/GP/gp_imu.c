@@ -7,7 +7,7 @@
 **
 **  Autor: Ramon Rico
 **  Fecha de creacion: 17/06/2020
-**  Fecha de modificacion: 13/09/2020
+**  Fecha de modificacion: 17/10/2026
 **
 **  El proyecto URpilot NO es libre. No se puede distribuir y/o modificar este fichero
 **  bajo ningun concepto.
@@ -29,6 +29,7 @@
 
 #ifdef USAR_IMU
 #include "Drivers/io.h"
+#include "Filtros/notch_dinamico.h"
 
 
 /***************************************************************************************
@@ -37,6 +38,18 @@
 #define FREC_FILTRO_ACEL_IMU        50.0f
 #define FREC_FILTRO_GIRO_IMU        50.0f
 
+#define HABILITAR_NOTCH_DINAMICO    true
+#define NUM_PICOS_NOTCH_DINAMICO    2
+#define FREC_MIN_NOTCH_DINAMICO     80
+#define FREC_MAX_NOTCH_DINAMICO     450
+#define Q_NOTCH_DINAMICO            3.5f
+
+#define HABILITAR_FILTRO_RPM        true
+#define ARMONICOS_FILTRO_RPM        0x07
+#define FREC_MIN_FILTRO_RPM         100
+#define ANCHO_BANDA_FILTRO_RPM      20.0f
+#define ATENUACION_FILTRO_RPM       40.0f
+
 #ifndef TIPO_IMU_1
   #define TIPO_IMU_1                IMU_NINGUNO
 #endif
@@ -67,6 +80,12 @@
   #define DRDY_IMU_1                NINGUNO
 #endif
 
+#ifndef FIFO_IMU_1
+  #define USAR_FIFO_IMU_1           false
+#else
+  #define USAR_FIFO_IMU_1           true
+#endif
+
 #ifndef ROTACION_IMU_1
   #define ROTACION_IMU_1            0
 #endif
@@ -105,6 +124,12 @@
   #define DRDY_IMU_2                NINGUNO
 #endif
 
+#ifndef FIFO_IMU_2
+  #define USAR_FIFO_IMU_2           false
+#else
+  #define USAR_FIFO_IMU_2           true
+#endif
+
 #ifndef ROTACION_IMU_2
   #define ROTACION_IMU_2            0
 #endif
@@ -143,6 +168,12 @@
   #define DRDY_IMU_3                NINGUNO
 #endif
 
+#ifndef FIFO_IMU_3
+  #define USAR_FIFO_IMU_3           false
+#else
+  #define USAR_FIFO_IMU_3           true
+#endif
+
 #ifndef ROTACION_IMU_3
   #define ROTACION_IMU_3            0
 #endif
@@ -181,6 +212,12 @@
   #define DRDY_IMU_4                NINGUNO
 #endif
 
+#ifndef FIFO_IMU_4
+  #define USAR_FIFO_IMU_4           false
+#else
+  #define USAR_FIFO_IMU_4           true
+#endif
+
 #ifndef ROTACION_IMU_4
   #define ROTACION_IMU_4            0
 #endif
@@ -219,6 +256,12 @@
   #define DRDY_IMU_5                NINGUNO
 #endif
 
+#ifndef FIFO_IMU_5
+  #define USAR_FIFO_IMU_5           false
+#else
+  #define USAR_FIFO_IMU_5           true
+#endif
+
 #ifndef ROTACION_IMU_5
   #define ROTACION_IMU_5            0
 #endif
@@ -236,14 +279,57 @@
 /***************************************************************************************
 ** AREA DE DECLARACION DE VARIABLES                                                   **
 ****************************************************************************************/
-REGISTRAR_ARRAY_GP_CON_FN_RESET(configIMU_t, NUM_MAX_IMU, configIMU, GP_CONFIGURACION_IMU, 1);
+REGISTRAR_ARRAY_GP_CON_FN_RESET(configIMU_t, NUM_MAX_IMU, configIMU, GP_CONFIGURACION_IMU, 2);
+REGISTRAR_GP_CON_TEMPLATE_RESET(configNotchDinamico_t, configNotchDinamico, GP_CONFIGURACION_NOTCH_DINAMICO, 1);
+
+TEMPLATE_RESET_GP(configNotchDinamico_t, configNotchDinamico,
+    .habilitado = HABILITAR_NOTCH_DINAMICO,
+    .numPicos = NUM_PICOS_NOTCH_DINAMICO,
+    .frecMin = FREC_MIN_NOTCH_DINAMICO,
+    .frecMax = FREC_MAX_NOTCH_DINAMICO,
+    .Q = Q_NOTCH_DINAMICO,
+);
+
+REGISTRAR_GP_CON_TEMPLATE_RESET(configFiltroRPM_t, configFiltroRPM, GP_CONFIGURACION_FILTRO_RPM, 1);
+
+TEMPLATE_RESET_GP(configFiltroRPM_t, configFiltroRPM,
+    .habilitado = HABILITAR_FILTRO_RPM,
+    .armonicos = ARMONICOS_FILTRO_RPM,
+    .frecMin = FREC_MIN_FILTRO_RPM,
+    .anchoBanda = ANCHO_BANDA_FILTRO_RPM,
+    .atenuacion = ATENUACION_FILTRO_RPM,
+);
+
+DESCRIBIR_GP(configIMU, "imu",
+    CAMPO_ARRAY_GP(configIMU_t, "frecFiltroAcel", frecFiltroAcel, CAMPO_REAL_GP, NUM_MAX_IMU, sizeof(configIMU_t), 1, 1000),
+    CAMPO_ARRAY_GP(configIMU_t, "frecFiltroGiro", frecFiltroGiro, CAMPO_REAL_GP, NUM_MAX_IMU, sizeof(configIMU_t), 1, 1000),
+    CAMPO_ARRAY_GP(configIMU_t, "frecActualizar", frecActualizar, CAMPO_NATURAL_GP, NUM_MAX_IMU, sizeof(configIMU_t), 100, 8000),
+    CAMPO_ARRAY_GP(configIMU_t, "frecLeer", frecLeer, CAMPO_NATURAL_GP, NUM_MAX_IMU, sizeof(configIMU_t), 100, 8000),
+    CAMPO_ARRAY_GP(configIMU_t, "fifo", fifo, CAMPO_BOOL_GP, NUM_MAX_IMU, sizeof(configIMU_t), 0, 1),
+);
+
+DESCRIBIR_GP(configNotchDinamico, "notch",
+    CAMPO_GP(configNotchDinamico_t, habilitado, CAMPO_BOOL_GP, 0, 1),
+    CAMPO_GP(configNotchDinamico_t, numPicos, CAMPO_NATURAL_GP, 1, NUM_MAX_PICOS_NOTCH_DINAMICO),
+    CAMPO_GP(configNotchDinamico_t, frecMin, CAMPO_NATURAL_GP, 20, FREC_MAX_ANALISIS_NOTCH_DINAMICO / 2),
+    CAMPO_GP(configNotchDinamico_t, frecMax, CAMPO_NATURAL_GP, 20, FREC_MAX_ANALISIS_NOTCH_DINAMICO / 2),
+    CAMPO_GP(configNotchDinamico_t, Q, CAMPO_REAL_GP, 0.5, 20),
+);
+
+DESCRIBIR_GP(configFiltroRPM, "rpm",
+    CAMPO_GP(configFiltroRPM_t, habilitado, CAMPO_BOOL_GP, 0, 1),
+    CAMPO_GP(configFiltroRPM_t, armonicos, CAMPO_NATURAL_GP, 1, 0x07),
+    CAMPO_GP(configFiltroRPM_t, frecMin, CAMPO_NATURAL_GP, 20, 500),
+    CAMPO_GP(configFiltroRPM_t, anchoBanda, CAMPO_REAL_GP, 1, 200),
+    CAMPO_GP(configFiltroRPM_t, atenuacion, CAMPO_REAL_GP, 1, 80),
+);
 
 static const configIMU_t configIMUdefecto[] = {
-    { TIPO_IMU_1, AUX_IMU_1, TIPO_BUS_IMU_1, DISP_BUS_IMU_1, DEFIO_TAG(CS_SPI_BUS_IMU_1), DIR_I2C_BUS_IMU_1, DEFIO_TAG(DRDY_IMU_1), FREC_FILTRO_ACEL_IMU, FREC_FILTRO_GIRO_IMU, {ROTACION_IMU_1, VOLTEADO_IMU_1}, FREC_ACTUALIZAR_IMU_HZ, FREC_LEER_IMU_HZ},
-    { TIPO_IMU_2, AUX_IMU_2, TIPO_BUS_IMU_2, DISP_BUS_IMU_2, DEFIO_TAG(CS_SPI_BUS_IMU_2), DIR_I2C_BUS_IMU_2, DEFIO_TAG(DRDY_IMU_2), FREC_FILTRO_ACEL_IMU, FREC_FILTRO_GIRO_IMU, {ROTACION_IMU_2, VOLTEADO_IMU_2}, FREC_ACTUALIZAR_IMU_HZ, FREC_LEER_IMU_HZ},
-    { TIPO_IMU_3, AUX_IMU_3, TIPO_BUS_IMU_3, DISP_BUS_IMU_3, DEFIO_TAG(CS_SPI_BUS_IMU_3), DIR_I2C_BUS_IMU_3, DEFIO_TAG(DRDY_IMU_3), FREC_FILTRO_ACEL_IMU, FREC_FILTRO_GIRO_IMU, {ROTACION_IMU_3, VOLTEADO_IMU_3}, FREC_ACTUALIZAR_IMU_HZ, FREC_LEER_IMU_HZ},
-    { TIPO_IMU_4, AUX_IMU_4, TIPO_BUS_IMU_4, DISP_BUS_IMU_4, DEFIO_TAG(CS_SPI_BUS_IMU_4), DIR_I2C_BUS_IMU_4, DEFIO_TAG(DRDY_IMU_4), FREC_FILTRO_ACEL_IMU, FREC_FILTRO_GIRO_IMU, {ROTACION_IMU_4, VOLTEADO_IMU_4}, FREC_ACTUALIZAR_IMU_HZ, FREC_LEER_IMU_HZ},
-    { TIPO_IMU_5, AUX_IMU_5, TIPO_BUS_IMU_5, DISP_BUS_IMU_5, DEFIO_TAG(CS_SPI_BUS_IMU_5), DIR_I2C_BUS_IMU_5, DEFIO_TAG(DRDY_IMU_5), FREC_FILTRO_ACEL_IMU, FREC_FILTRO_GIRO_IMU, {ROTACION_IMU_5, VOLTEADO_IMU_5}, FREC_ACTUALIZAR_IMU_HZ, FREC_LEER_IMU_HZ},
+    { TIPO_IMU_1, AUX_IMU_1, TIPO_BUS_IMU_1, DISP_BUS_IMU_1, DEFIO_TAG(CS_SPI_BUS_IMU_1), DIR_I2C_BUS_IMU_1, DEFIO_TAG(DRDY_IMU_1), USAR_FIFO_IMU_1, FREC_FILTRO_ACEL_IMU, FREC_FILTRO_GIRO_IMU, {ROTACION_IMU_1, VOLTEADO_IMU_1}, FREC_ACTUALIZAR_IMU_HZ, FREC_LEER_IMU_HZ},
+    { TIPO_IMU_2, AUX_IMU_2, TIPO_BUS_IMU_2, DISP_BUS_IMU_2, DEFIO_TAG(CS_SPI_BUS_IMU_2), DIR_I2C_BUS_IMU_2, DEFIO_TAG(DRDY_IMU_2), USAR_FIFO_IMU_2, FREC_FILTRO_ACEL_IMU, FREC_FILTRO_GIRO_IMU, {ROTACION_IMU_2, VOLTEADO_IMU_2}, FREC_ACTUALIZAR_IMU_HZ, FREC_LEER_IMU_HZ},
+    { TIPO_IMU_3, AUX_IMU_3, TIPO_BUS_IMU_3, DISP_BUS_IMU_3, DEFIO_TAG(CS_SPI_BUS_IMU_3), DIR_I2C_BUS_IMU_3, DEFIO_TAG(DRDY_IMU_3), USAR_FIFO_IMU_3, FREC_FILTRO_ACEL_IMU, FREC_FILTRO_GIRO_IMU, {ROTACION_IMU_3, VOLTEADO_IMU_3}, FREC_ACTUALIZAR_IMU_HZ, FREC_LEER_IMU_HZ},
+    { TIPO_IMU_4, AUX_IMU_4, TIPO_BUS_IMU_4, DISP_BUS_IMU_4, DEFIO_TAG(CS_SPI_BUS_IMU_4), DIR_I2C_BUS_IMU_4, DEFIO_TAG(DRDY_IMU_4), USAR_FIFO_IMU_4, FREC_FILTRO_ACEL_IMU, FREC_FILTRO_GIRO_IMU, {ROTACION_IMU_4, VOLTEADO_IMU_4}, FREC_ACTUALIZAR_IMU_HZ, FREC_LEER_IMU_HZ},
+    { TIPO_IMU_5, AUX_IMU_5, TIPO_BUS_IMU_5, DISP_BUS_IMU_5, DEFIO_TAG(CS_SPI_BUS_IMU_5), DIR_I2C_BUS_IMU_5, DEFIO_TAG(DRDY_IMU_5), USAR_FIFO_IMU_5, FREC_FILTRO_ACEL_IMU, FREC_FILTRO_GIRO_IMU, {ROTACION_IMU_5, VOLTEADO_IMU_5}, FREC_ACTUALIZAR_IMU_HZ, FREC_LEER_IMU_HZ},
 };
 
 
@@ -270,6 +356,7 @@ void fnResetGP_configIMU(configIMU_t *configIMU)
         configIMU[i].auxiliar = configIMUdefecto[i].auxiliar;
         configIMU[i].dispBus = configIMUdefecto[i].dispBus;
         configIMU[i].drdy = configIMUdefecto[i].drdy;
+        configIMU[i].fifo = configIMUdefecto[i].fifo;
         configIMU[i].bus = configIMUdefecto[i].bus;
         configIMU[i].frecFiltroAcel = configIMUdefecto[i].frecFiltroAcel;
         configIMU[i].frecFiltroGiro = configIMUdefecto[i].frecFiltroGiro;
@@ -7,7 +7,7 @@
 **
 **  Autor: Ramon Rico
 **  Fecha de creacion: 17/06/2020
-**  Fecha de modificacion: 13/09/2020
+**  Fecha de modificacion: 17/10/2026
 **
 **  El proyecto URpilot NO es libre. No se puede distribuir y/o modificar este fichero
 **  bajo ningun concepto.
@@ -42,6 +42,8 @@
 ****************************************************************************************/
 #define FREC_ACTUALIZAR_IMU_HZ      1000
 #define FREC_LEER_IMU_HZ            500
+#define FREC_NOTCH_DINAMICO_HZ      1000
+#define FREC_FILTRO_RPM_HZ          1000
 #define LEER_IMU_SCHEDULER              // El sheduler se encarga de llamar a la lectura del sensor. Sino lo hace otra funcion
 
 
@@ -56,6 +58,7 @@ typedef struct {
     uint8_t csSPI;
     uint8_t dirI2C;
     uint8_t drdy;
+    bool fifo;
     float frecFiltroAcel;
     float frecFiltroGiro;
     rotacionSensor_t rotacion;
@@ -63,11 +66,29 @@ typedef struct {
     uint16_t frecLeer;
 } configIMU_t;
 
+typedef struct {
+    bool habilitado;
+    uint8_t numPicos;
+    uint16_t frecMin;
+    uint16_t frecMax;
+    float Q;
+} configNotchDinamico_t;
+
+typedef struct {
+    bool habilitado;
+    uint8_t armonicos;                      // Mascara: bit 0 la fundamental, bit 1 el segundo armonico...
+    uint16_t frecMin;
+    float anchoBanda;                       // Hz en la frecuencia minima
+    float atenuacion;                       // dB
+} configFiltroRPM_t;
+
 
 /***************************************************************************************
 ** AREA DE DECLARACION DE VARIABLES                                                   **
 ****************************************************************************************/
 DECLARAR_ARRAY_GP(configIMU_t, NUM_MAX_IMU, configIMU);
+DECLARAR_GP(configNotchDinamico_t, configNotchDinamico);
+DECLARAR_GP(configFiltroRPM_t, configFiltroRPM);
 
 
 /***************************************************************************************
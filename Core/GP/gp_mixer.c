@@ -7,7 +7,7 @@
 **
 **  Autor: Ramon Rico
 **  Fecha de creacion: 07/09/2020
-**  Fecha de modificacion: 07/09/2020
+**  Fecha de modificacion: 17/10/2026
 **
 **  El proyecto URpilot NO es libre. No se puede distribuir y/o modificar este fichero
 **  bajo ningun concepto.
@@ -53,6 +53,14 @@ static const configMixer_t configMixerDefecto = {
     TIPO_DRONE_MIXER, CURVA_PWM_MIXER, VALOR_ARMADO_MIXER, VALOR_MAXIMO_MIXER, VALOR_MINIMO_MIXER
 };
 
+DESCRIBIR_GP(configMixer, "mixer",
+    CAMPO_GP(configMixer_t, tipoDrone, CAMPO_NATURAL_GP, 0, DRON_HEXACOPTER_2H),
+    CAMPO_GP(configMixer_t, curvaPWM, CAMPO_REAL_GP, 0, 1),
+    CAMPO_GP(configMixer_t, valorArmado, CAMPO_REAL_GP, 0, 1),
+    CAMPO_GP(configMixer_t, valorMaximo, CAMPO_REAL_GP, 0, 1),
+    CAMPO_GP(configMixer_t, valorMinimo, CAMPO_REAL_GP, 0, 1),
+);
+
 
 /***************************************************************************************
 ** AREA DE PROTOTIPOS DE FUNCION                                                      **
@@ -7,7 +7,7 @@
 **
 **  Autor: Ramon Rico
 **  Fecha de creacion: 27/06/2020
-**  Fecha de modificacion: 13/09/2020
+**  Fecha de modificacion: 17/10/2026
 **
 **  El proyecto URpilot NO es libre. No se puede distribuir y/o modificar este fichero
 **  bajo ningun concepto.
@@ -37,6 +37,7 @@
 #define PROTOCOLO_MOTOR         PWM_TIPO_ESTANDAR
 #define INVERSION_MOTOR         MOTOR_SALIDA_ESTANDAR
 #define FREC_ACT_PWM_MOTOR      480
+#define POLOS_MOTOR             14
 
 #define USAR_BURST_DSHOT        false
 #define USAR_TELEM_DSHOT        false
@@ -150,7 +151,7 @@
 /***************************************************************************************
 ** AREA DE DECLARACION DE VARIABLES                                                   **
 ****************************************************************************************/
-REGISTRAR_GP_CON_TEMPLATE_RESET(configMotor_t, configMotor, GP_CONFIGURACION_MOTORES, 1);
+REGISTRAR_GP_CON_TEMPLATE_RESET(configMotor_t, configMotor, GP_CONFIGURACION_MOTORES, 2);
 
 TEMPLATE_RESET_GP(configMotor_t, configMotor,
     .protocolo = PROTOCOLO_MOTOR,
@@ -181,6 +182,7 @@ TEMPLATE_RESET_GP(configMotor_t, configMotor,
 	.pinMotor[MOTOR_11].numTimer = TIMER_MOTOR_11,
 	.pinMotor[MOTOR_12].pin = DEFIO_TAG(PIN_MOTOR_12),
 	.pinMotor[MOTOR_12].numTimer = TIMER_MOTOR_12,
+	.polosMotor = POLOS_MOTOR,
 #ifdef USAR_DSHOT
 	.usarBurstDshot = USAR_BURST_DSHOT,
 	.usarTelemetriaDshot = USAR_TELEM_DSHOT,
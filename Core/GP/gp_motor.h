@@ -7,7 +7,7 @@
 **
 **  Autor: Ramon Rico
 **  Fecha de creacion: 27/06/2020
-**  Fecha de modificacion: 13/09/2020
+**  Fecha de modificacion: 17/10/2026
 **
 **  El proyecto URpilot NO es libre. No se puede distribuir y/o modificar este fichero
 **  bajo ningun concepto.
@@ -50,9 +50,10 @@ typedef struct {
     uint16_t frecActualizacionPWM;
     tipoSalidaMotor_e inversion;
     pinConfigTimer_t pinMotor[NUM_MAX_MOTORES];
+    uint8_t polosMotor;
 #ifdef USAR_DSHOT
     bool usarBurstDshot;
-    bool usarTelemetriaDshot;
+    bool usarTelemetriaDshot;                       // Dshot bidireccional con telemetria eRPM
 #endif
 } configMotor_t;
 
@@ -7,7 +7,7 @@
 **
 **  Autor: Ramon Rico
 **  Fecha de creacion: 25/07/2020
-**  Fecha de modificacion: 03/08/2020
+**  Fecha de modificacion: 17/10/2026
 **
 **  El proyecto URpilot NO es libre. No se puede distribuir y/o modificar este fichero
 **  bajo ningun concepto.
@@ -50,6 +50,14 @@
   #define LEADING_EDGE_SPI_1    false
 #endif
 
+#ifndef DMA_TX_SPI_1
+  #define DMA_TX_SPI_1          NULL
+#endif
+
+#ifndef DMA_RX_SPI_1
+  #define DMA_RX_SPI_1          NULL
+#endif
+
 #ifndef PIN_SCK_SPI_2
   #define PIN_SCK_SPI_2         NINGUNO
 #endif
@@ -66,6 +74,14 @@
   #define LEADING_EDGE_SPI_2    false
 #endif
 
+#ifndef DMA_TX_SPI_2
+  #define DMA_TX_SPI_2          NULL
+#endif
+
+#ifndef DMA_RX_SPI_2
+  #define DMA_RX_SPI_2          NULL
+#endif
+
 #ifndef PIN_SCK_SPI_3
   #define PIN_SCK_SPI_3         NINGUNO
 #endif
@@ -82,6 +98,14 @@
   #define LEADING_EDGE_SPI_3    false
 #endif
 
+#ifndef DMA_TX_SPI_3
+  #define DMA_TX_SPI_3          NULL
+#endif
+
+#ifndef DMA_RX_SPI_3
+  #define DMA_RX_SPI_3          NULL
+#endif
+
 #ifndef PIN_SCK_SPI_4
   #define PIN_SCK_SPI_4         NINGUNO
 #endif
@@ -98,6 +122,14 @@
   #define LEADING_EDGE_SPI_4    false
 #endif
 
+#ifndef DMA_TX_SPI_4
+  #define DMA_TX_SPI_4          NULL
+#endif
+
+#ifndef DMA_RX_SPI_4
+  #define DMA_RX_SPI_4          NULL
+#endif
+
 #ifndef PIN_SCK_SPI_5
   #define PIN_SCK_SPI_5         NINGUNO
 #endif
@@ -114,6 +146,14 @@
   #define LEADING_EDGE_SPI_5    false
 #endif
 
+#ifndef DMA_TX_SPI_5
+  #define DMA_TX_SPI_5          NULL
+#endif
+
+#ifndef DMA_RX_SPI_5
+  #define DMA_RX_SPI_5          NULL
+#endif
+
 #ifndef PIN_SCK_SPI_6
   #define PIN_SCK_SPI_6         NINGUNO
 #endif
@@ -130,6 +170,14 @@
   #define LEADING_EDGE_SPI_6    false
 #endif
 
+#ifndef DMA_TX_SPI_6
+  #define DMA_TX_SPI_6          NULL
+#endif
+
+#ifndef DMA_RX_SPI_6
+  #define DMA_RX_SPI_6          NULL
+#endif
+
 
 /***************************************************************************************
 ** AREA DE DEFINICION DE TIPOS                                                        **
@@ -139,15 +187,15 @@
 /***************************************************************************************
 ** AREA DE DECLARACION DE VARIABLES                                                   **
 ****************************************************************************************/
-REGISTRAR_ARRAY_GP_CON_FN_RESET(configSPI_t, NUM_MAX_SPI, configSPI, GP_CONFIGURACION_SPI, 1);
+REGISTRAR_ARRAY_GP_CON_FN_RESET(configSPI_t, NUM_MAX_SPI, configSPI, GP_CONFIGURACION_SPI, 2);
 
 static const configSPI_t configSPIdefecto[] = {
-    { DEFIO_TAG(PIN_SCK_SPI_1), DEFIO_TAG(PIN_MISO_SPI_1), DEFIO_TAG(PIN_MOSI_SPI_1), LEADING_EDGE_SPI_1},
-    { DEFIO_TAG(PIN_SCK_SPI_2), DEFIO_TAG(PIN_MISO_SPI_2), DEFIO_TAG(PIN_MOSI_SPI_2), LEADING_EDGE_SPI_2},
-    { DEFIO_TAG(PIN_SCK_SPI_3), DEFIO_TAG(PIN_MISO_SPI_3), DEFIO_TAG(PIN_MOSI_SPI_3), LEADING_EDGE_SPI_3},
-    { DEFIO_TAG(PIN_SCK_SPI_4), DEFIO_TAG(PIN_MISO_SPI_4), DEFIO_TAG(PIN_MOSI_SPI_4), LEADING_EDGE_SPI_4},
-    { DEFIO_TAG(PIN_SCK_SPI_5), DEFIO_TAG(PIN_MISO_SPI_5), DEFIO_TAG(PIN_MOSI_SPI_5), LEADING_EDGE_SPI_5},
-    { DEFIO_TAG(PIN_SCK_SPI_6), DEFIO_TAG(PIN_MISO_SPI_6), DEFIO_TAG(PIN_MOSI_SPI_6), LEADING_EDGE_SPI_6},
+    { DEFIO_TAG(PIN_SCK_SPI_1), DEFIO_TAG(PIN_MISO_SPI_1), DEFIO_TAG(PIN_MOSI_SPI_1), LEADING_EDGE_SPI_1, DMA_TX_SPI_1, DMA_RX_SPI_1},
+    { DEFIO_TAG(PIN_SCK_SPI_2), DEFIO_TAG(PIN_MISO_SPI_2), DEFIO_TAG(PIN_MOSI_SPI_2), LEADING_EDGE_SPI_2, DMA_TX_SPI_2, DMA_RX_SPI_2},
+    { DEFIO_TAG(PIN_SCK_SPI_3), DEFIO_TAG(PIN_MISO_SPI_3), DEFIO_TAG(PIN_MOSI_SPI_3), LEADING_EDGE_SPI_3, DMA_TX_SPI_3, DMA_RX_SPI_3},
+    { DEFIO_TAG(PIN_SCK_SPI_4), DEFIO_TAG(PIN_MISO_SPI_4), DEFIO_TAG(PIN_MOSI_SPI_4), LEADING_EDGE_SPI_4, DMA_TX_SPI_4, DMA_RX_SPI_4},
+    { DEFIO_TAG(PIN_SCK_SPI_5), DEFIO_TAG(PIN_MISO_SPI_5), DEFIO_TAG(PIN_MOSI_SPI_5), LEADING_EDGE_SPI_5, DMA_TX_SPI_5, DMA_RX_SPI_5},
+    { DEFIO_TAG(PIN_SCK_SPI_6), DEFIO_TAG(PIN_MISO_SPI_6), DEFIO_TAG(PIN_MOSI_SPI_6), LEADING_EDGE_SPI_6, DMA_TX_SPI_6, DMA_RX_SPI_6},
 };
 
 
@@ -174,6 +222,8 @@ void fnResetGP_configSPI(configSPI_t *configSPI)
     	configSPI[i].pinMISO = configSPIdefecto[i].pinMISO;
     	configSPI[i].pinMOSI = configSPIdefecto[i].pinMOSI;
     	configSPI[i].leadingEdge = configSPIdefecto[i].leadingEdge;
+    	configSPI[i].dmaTx = configSPIdefecto[i].dmaTx;
+    	configSPI[i].dmaRx = configSPIdefecto[i].dmaRx;
     }
 }
 
@@ -7,7 +7,7 @@
 **
 **  Autor: Ramon Rico
 **  Fecha de creacion: 25/07/2020
-**  Fecha de modificacion: 25/07/2020
+**  Fecha de modificacion: 17/10/2026
 **
 **  El proyecto URpilot NO es libre. No se puede distribuir y/o modificar este fichero
 **  bajo ningun concepto.
@@ -44,6 +44,8 @@ typedef struct {
     uint8_t pinMISO;
     uint8_t pinMOSI;
     bool leadingEdge;
+    DMA_Stream_TypeDef *dmaTx;
+    DMA_Stream_TypeDef *dmaRx;
 } configSPI_t;
 
 
@@ -7,7 +7,7 @@
 **
 **  Autor: Ramon Rico
 **  Fecha de creacion: 04/07/2020
-**  Fecha de modificacion: 03/08/2020
+**  Fecha de modificacion: 17/10/2026
 **
 **  El proyecto URpilot NO es libre. No se puede distribuir y/o modificar este fichero
 **  bajo ningun concepto.
@@ -178,7 +178,7 @@
 /***************************************************************************************
 ** AREA DE DECLARACION DE VARIABLES                                                   **
 ****************************************************************************************/
-REGISTRAR_ARRAY_GP_CON_FN_RESET(configUART_t, NUM_MAX_UART, configUART, GP_CONFIGURACION_UART, 1);
+REGISTRAR_ARRAY_GP_CON_FN_RESET(configUART_t, NUM_MAX_UART, configUART, GP_CONFIGURACION_UART, 3);
 
 static const configUART_t configUARTdefecto[] = {
     { DEFIO_TAG(PIN_TX_UART_1), DEFIO_TAG(PIN_RX_UART_1), USAR_DMA_DRIVER_UART, DMA_TX_UART_1, DMA_RX_UART_1},
@@ -0,0 +1,234 @@
+/***************************************************************************************
+**  parametros_gp.c - Acceso a los campos de los GP a traves de sus descripciones
+**
+**
+**  Este fichero forma parte del proyecto URpilot.
+**  Codigo desarrollado por el grupo de investigacion ICON de la Universidad de La Rioja
+**
+**  Autor: Ramon Rico
+**  Fecha de creacion: 17/10/2026
+**  Fecha de modificacion: 17/10/2026
+**
+**  El proyecto URpilot NO es libre. No se puede distribuir y/o modificar este fichero
+**  bajo ningun concepto.
+**
+**  En caso de modificacion y/o solicitud de informacion pongase en contacto con
+**  el grupo de investigacion ICON a traves de: www.unirioja.es/urpilot
+**
+**
+**  Control de versiones del fichero
+**
+**  v1.0  Ramon Rico. Se ha liberado la primera version estable
+**
+****************************************************************************************/
+
+/***************************************************************************************
+** AREA DE INCLUDES                                                                   **
+****************************************************************************************/
+#include <string.h>
+#include <math.h>
+
+#include "parametros_gp.h"
+
+
+/***************************************************************************************
+** AREA DE PREPROCESADOR                                                              **
+****************************************************************************************/
+#define TAM_BUFFER_DEFECTO_GP          512         // Mayor GP del que se pueden consultar los valores por defecto
+
+
+/***************************************************************************************
+** AREA DE DEFINICION DE TIPOS                                                        **
+****************************************************************************************/
+
+
+/***************************************************************************************
+** AREA DE DECLARACION DE VARIABLES                                                   **
+****************************************************************************************/
+static uint8_t bufferDefectoGP[TAM_BUFFER_DEFECTO_GP] __attribute__ ((aligned(4)));
+
+
+/***************************************************************************************
+** AREA DE PROTOTIPOS DE FUNCION                                                      **
+****************************************************************************************/
+uint32_t leerElementoGP(const uint8_t *base, const campoGP_t *campo, uint8_t elemento);
+
+
+/***************************************************************************************
+** AREA DE DEFINICION DE FUNCIONES                                                    **
+****************************************************************************************/
+
+/***************************************************************************************
+**  Nombre:         uint8_t numDescripcionesGP(void)
+**  Descripcion:    Devuelve el numero de GP descritos
+**  Parametros:     Ninguno
+**  Retorno:        Numero de descripciones
+****************************************************************************************/
+uint8_t numDescripcionesGP(void)
+{
+    return _edescripcionGP - _sdescripcionGP;
+}
+
+
+/***************************************************************************************
+**  Nombre:         const descripcionGP_t *descripcionGP(uint8_t indice)
+**  Descripcion:    Devuelve la descripcion de un GP por su posicion en la seccion
+**  Parametros:     Indice de la descripcion
+**  Retorno:        Descripcion o NULL si no existe
+****************************************************************************************/
+const descripcionGP_t *descripcionGP(uint8_t indice)
+{
+    if (indice >= numDescripcionesGP())
+        return NULL;
+
+    return &_sdescripcionGP[indice];
+}
+
+
+/***************************************************************************************
+**  Nombre:         const campoGP_t *campoDescripcionGP(const descripcionGP_t *descripcion, uint8_t indice,
+**                                                      uint8_t elemento)
+**  Descripcion:    Busca un campo de una descripcion y comprueba que tiene el elemento pedido
+**  Parametros:     Descripcion (puede ser NULL), indice del campo, elemento
+**  Retorno:        Campo o NULL si no existe
+****************************************************************************************/
+const campoGP_t *campoDescripcionGP(const descripcionGP_t *descripcion, uint8_t indice, uint8_t elemento)
+{
+    if (descripcion == NULL || indice >= descripcion->numCampos)
+        return NULL;
+
+    const campoGP_t *campo = &descripcion->campos[indice];
+    if (elemento >= campo->numElementos)
+        return NULL;
+
+    return campo;
+}
+
+
+/***************************************************************************************
+**  Nombre:         uint32_t leerElementoGP(const uint8_t *base, const campoGP_t *campo, uint8_t elemento)
+**  Descripcion:    Lee los bytes de un elemento de un campo
+**  Parametros:     Direccion base de la instancia del GP, campo, elemento
+**  Retorno:        Valor en los bytes bajos
+****************************************************************************************/
+uint32_t leerElementoGP(const uint8_t *base, const campoGP_t *campo, uint8_t elemento)
+{
+    const uint8_t *dir = base + campo->offset + elemento * campo->paso;
+
+    switch (campo->tam) {
+        case 1:
+            return *dir;
+
+        case 2: {
+            uint16_t valor16;
+            memcpy(&valor16, dir, sizeof(valor16));
+            return valor16;
+        }
+
+        default: {
+            uint32_t valor;
+            memcpy(&valor, dir, sizeof(valor));
+            return valor;
+        }
+    }
+}
+
+
+/***************************************************************************************
+**  Nombre:         uint32_t leerCampoGP(const descripcionGP_t *descripcion, const campoGP_t *campo,
+**                                       uint8_t elemento)
+**  Descripcion:    Lee el valor actual de un elemento de un campo
+**  Parametros:     Descripcion, campo, elemento
+**  Retorno:        Valor en los bytes bajos
+****************************************************************************************/
+uint32_t leerCampoGP(const descripcionGP_t *descripcion, const campoGP_t *campo, uint8_t elemento)
+{
+    return leerElementoGP(descripcion->registro->dir, campo, elemento);
+}
+
+
+/***************************************************************************************
+**  Nombre:         bool leerDefectoCampoGP(const descripcionGP_t *descripcion, const campoGP_t *campo,
+**                                          uint8_t elemento, uint32_t *valor)
+**  Descripcion:    Obtiene el valor por defecto de un elemento reseteando una copia del GP
+**  Parametros:     Descripcion, campo, elemento, valor por defecto
+**  Retorno:        False si el GP no cabe en el buffer de la copia
+****************************************************************************************/
+bool leerDefectoCampoGP(const descripcionGP_t *descripcion, const campoGP_t *campo, uint8_t elemento, uint32_t *valor)
+{
+    if (tamanioGP(descripcion->registro) > sizeof(bufferDefectoGP))
+        return false;
+
+    resetearInstanciaGP(descripcion->registro, bufferDefectoGP);
+    *valor = leerElementoGP(bufferDefectoGP, campo, elemento);
+    return true;
+}
+
+
+/***************************************************************************************
+**  Nombre:         bool valorValidoCampoGP(const campoGP_t *campo, uint32_t valor)
+**  Descripcion:    Comprueba que un valor cabe en el campo y esta dentro de su rango
+**  Parametros:     Campo, valor en los bytes bajos
+**  Retorno:        True si es valido
+****************************************************************************************/
+bool valorValidoCampoGP(const campoGP_t *campo, uint32_t valor)
+{
+    if (campo->tam < sizeof(valor) && (valor >> (8 * campo->tam)) != 0)
+        return false;
+
+    switch (campo->tipo) {
+        case CAMPO_BOOL_GP:
+            return valor <= 1;
+
+        case CAMPO_REAL_GP: {
+            float real;
+            memcpy(&real, &valor, sizeof(real));
+            return isfinite(real) && real >= campo->min && real <= campo->max;
+        }
+
+        case CAMPO_ENTERO_GP: {
+            // Extension del signo desde el tamanio del campo
+            const uint32_t signo = 1UL << (8 * campo->tam - 1);
+            const int32_t entero = (int32_t)((valor ^ signo) - signo);
+            return entero >= campo->min && entero <= campo->max;
+        }
+
+        default:
+            return valor >= campo->min && valor <= campo->max;
+    }
+}
+
+
+/***************************************************************************************
+**  Nombre:         bool escribirCampoGP(const descripcionGP_t *descripcion, const campoGP_t *campo,
+**                                       uint8_t elemento, uint32_t valor)
+**  Descripcion:    Escribe un elemento de un campo en la RAM si el valor es valido. Para
+**                  que persista hay que guardar la configuracion en la flash
+**  Parametros:     Descripcion, campo, elemento, valor en los bytes bajos
+**  Retorno:        False si el valor no es valido
+****************************************************************************************/
+bool escribirCampoGP(const descripcionGP_t *descripcion, const campoGP_t *campo, uint8_t elemento, uint32_t valor)
+{
+    if (!valorValidoCampoGP(campo, valor))
+        return false;
+
+    uint8_t *dir = descripcion->registro->dir + campo->offset + elemento * campo->paso;
+
+    switch (campo->tam) {
+        case 1:
+            *dir = (uint8_t)valor;
+            break;
+
+        case 2: {
+            const uint16_t valor16 = (uint16_t)valor;
+            memcpy(dir, &valor16, sizeof(valor16));
+            break;
+        }
+
+        default:
+            memcpy(dir, &valor, sizeof(valor));
+            break;
+    }
+
+    return true;
+}
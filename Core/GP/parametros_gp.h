@@ -0,0 +1,64 @@
+/***************************************************************************************
+**  parametros_gp.h - Acceso a los campos de los GP a traves de sus descripciones
+**
+**
+**  Este fichero forma parte del proyecto URpilot.
+**  Codigo desarrollado por el grupo de investigacion ICON de la Universidad de La Rioja
+**
+**  Autor: Ramon Rico
+**  Fecha de creacion: 17/10/2026
+**  Fecha de modificacion: 17/10/2026
+**
+**  El proyecto URpilot NO es libre. No se puede distribuir y/o modificar este fichero
+**  bajo ningun concepto.
+**
+**  En caso de modificacion y/o solicitud de informacion pongase en contacto con
+**  el grupo de investigacion ICON a traves de: www.unirioja.es/urpilot
+**
+**
+**  Control de versiones del fichero
+**
+**  v1.0  Ramon Rico. Se ha liberado la primera version estable
+**
+****************************************************************************************/
+
+#ifndef __PARAMETROS_GP_H
+#define __PARAMETROS_GP_H
+
+/***************************************************************************************
+** AREA DE INCLUDES                                                                   **
+****************************************************************************************/
+#include <stdint.h>
+#include <stdbool.h>
+
+#include "gp.h"
+
+
+/***************************************************************************************
+** AREA DE PREPROCESADOR                                                              **
+****************************************************************************************/
+
+
+/***************************************************************************************
+** AREA DE DEFINICION DE TIPOS                                                        **
+****************************************************************************************/
+
+
+/***************************************************************************************
+** AREA DE DECLARACION DE VARIABLES                                                   **
+****************************************************************************************/
+
+
+/***************************************************************************************
+** AREA DE PROTOTIPOS DE FUNCION                                                      **
+****************************************************************************************/
+uint8_t numDescripcionesGP(void);
+const descripcionGP_t *descripcionGP(uint8_t indice);
+const campoGP_t *campoDescripcionGP(const descripcionGP_t *descripcion, uint8_t indice, uint8_t elemento);
+
+uint32_t leerCampoGP(const descripcionGP_t *descripcion, const campoGP_t *campo, uint8_t elemento);
+bool leerDefectoCampoGP(const descripcionGP_t *descripcion, const campoGP_t *campo, uint8_t elemento, uint32_t *valor);
+bool valorValidoCampoGP(const campoGP_t *campo, uint32_t valor);
+bool escribirCampoGP(const descripcionGP_t *descripcion, const campoGP_t *campo, uint8_t elemento, uint32_t valor);
+
+#endif // __PARAMETROS_GP_H
@@ -7,7 +7,7 @@
 **
 **  Autor: Ramon Rico
 **  Fecha de creacion: 27/08/2019
-**  Fecha de modificacion: 03/08/2020
+**  Fecha de modificacion: 17/10/2026
 **
 **  El proyecto URpilot NO es libre. No se puede distribuir y/o modificar este fichero
 **  bajo ningun concepto.
@@ -31,7 +31,7 @@
 #ifdef USAR_MOTORES
   #ifdef USAR_DSHOT
 #include "Comun/util.h"
-#include "Drivers/sistema.h"
+#include "Drivers/tiempo.h"
 
 
 /***************************************************************************************
@@ -7,7 +7,7 @@
 **
 **  Autor: Ramon Rico
 **  Fecha de creacion: 27/08/2019
-**  Fecha de modificacion: 13/09/2020
+**  Fecha de modificacion: 17/10/2026
 **
 **  El proyecto URpilot NO es libre. No se puede distribuir y/o modificar este fichero
 **  bajo ningun concepto.
@@ -32,6 +32,7 @@
 #include <stdbool.h>
 
 #include "motor.h"
+#include "dshot_telemetria.h"
 
 
 /***************************************************************************************
@@ -48,6 +49,8 @@
 #define MOTOR_LONGITUD_NIBBLE_PROSHOT       96    // 4uS
 #define ANCHO_BIT_PROSHOT                   3
 
+#define TIMEOUT_TELEMETRIA_DSHOT            100000  // us sin respuestas validas para dar la velocidad por perdida
+
 
 /***************************************************************************************
 ** AREA DE DEFINICION DE TIPOS                                                        **
@@ -101,6 +104,10 @@ typedef struct {
     uint32_t *bufferBurstDMA;
     uint16_t fuentesDMAtimer;
     uint32_t direccionEntrada;
+    uint16_t periodoSalida;
+    uint8_t numMotores;
+    uint8_t numBidireccional;
+    volatile uint8_t numCapturando;
 } motorDshotTimer_t;
 
 typedef struct {
@@ -117,6 +124,11 @@ typedef struct {
     motorDshotTimer_t *motorTimer;
     volatile bool solicitarTelemetria;
     uint32_t *bufferDMA;
+    TIM_OC_InitTypeDef configOC;
+    bool bidireccional;
+    volatile bool capturando;
+    uint32_t *bufferCaptura;
+    telemetriaDshot_t telemetria;
 } motorDshot_t;
 
 
@@ -125,17 +137,20 @@ typedef struct {
 ****************************************************************************************/
 extern motorDshot_t motoresDshot[NUM_MAX_MOTORES];
 extern bool usarBurstDshot;
+extern bool usarBidireccionalDshot;
 
 
 /***************************************************************************************
 ** AREA DE PROTOTIPOS DE FUNCION                                                      **
 ****************************************************************************************/
-void configurarHardwareDshot(tim_t *tim, uint8_t indice, protocoloMotor_e protocolo, uint8_t tipoCanal, uint8_t inversion);
+bool configurarHardwareDshot(tim_t *tim, uint8_t indice, protocoloMotor_e protocolo, uint8_t tipoCanal, uint8_t inversion);
 motorDshot_t *motorDshot(uint8_t indice);
 void escribirPWMdshot(uint8_t indice, float valor);
 void actualizarPWMdshot(uint8_t numMotores);
 uint8_t cargarBufferDMAdshot(uint32_t *bufferDMA, uint8_t paso, uint16_t paquete);
 uint8_t cargarBufferDMAproshot(uint32_t *bufferDMA, uint8_t paso, uint16_t paquete);
+bool frecMotorDshot(uint8_t indice, uint8_t numPolos, float *frec);
+const telemetriaDshot_t *telemetriaMotorDshot(uint8_t indice);
 
 bool comandoDshotSiendoProcesado(void);
 uint8_t comandoDshot(uint8_t indice);
@@ -7,7 +7,7 @@
 **
 **  Autor: Ramon Rico
 **  Fecha de creacion: 27/08/2019
-**  Fecha de modificacion: 09/09/2020
+**  Fecha de modificacion: 17/10/2026
 **
 **  El proyecto URpilot NO es libre. No se puede distribuir y/o modificar este fichero
 **  bajo ningun concepto.
@@ -35,6 +35,8 @@
 #include "Drivers/io.h"
 #include "Drivers/dma.h"
 #include "Drivers/nvic.h"
+#include "Drivers/tiempo.h"
+#include "Comun/matematicas.h"
 
 
 /***************************************************************************************
@@ -52,6 +54,11 @@
 
 #define NUM_MAX_DMA_TIMERS_MOTOR      8
 
+// La respuesta del ESC va a 5/4 de la velocidad de la trama con la misma base de tiempos
+#define TICKS_BIT_TELEMETRIA_DSHOT    (LONGITUD_BIT_MOTOR * 4 / 5)
+#define PERIODO_CAPTURA_DSHOT         0xFFFF
+#define FILTRO_CAPTURA_DSHOT          2
+
 
 /***************************************************************************************
 ** AREA DE DEFINICION DE TIPOS                                                        **
@@ -63,10 +70,12 @@
 ****************************************************************************************/
 static uint32_t bufferDshotDMA[NUM_MAX_MOTORES][TAMANIO_BUFFER_DMA_DSHOT];
 static uint32_t bufferBurstDMA[NUM_MAX_DMA_TIMERS_MOTOR][TAMANIO_BUFFER_DMA_DSHOT * 4];
+static uint32_t bufferCapturaDshot[NUM_MAX_MOTORES][TAM_BUFFER_CAPTURA_DSHOT] __attribute__ ((aligned (32)));
 static uint8_t contadorMotorDshot = 0;
 static motorDshotTimer_t motoresDshotTimer[NUM_MAX_MOTORES];
 motorDshot_t motoresDshot[NUM_MAX_MOTORES];
 bool usarBurstDshot = false;
+bool usarBidireccionalDshot = false;
 
 
 /***************************************************************************************
@@ -78,6 +87,9 @@ void iniciarPWMcanalDMA(TIM_HandleTypeDef *htim, uint32_t canal, uint32_t *pDato
 void pararPWMcanalDMA(TIM_HandleTypeDef *htim, uint32_t canal);
 void iniciarPWMburstDMA(TIM_HandleTypeDef *htim, uint32_t dirBaseBurst, uint32_t fuenteSolicitudBurst, uint32_t unidadBurst, uint32_t* bufferBurst, uint32_t lonBurst);
 uint16_t prepararPaqueteDshot(motorDshot_t *const motor);
+void iniciarCapturaDshot(motorDshot_t *motor);
+void terminarCapturaDshot(motorDshot_t *motor);
+void terminarCapturasTimerDshot(motorDshotTimer_t *motorTimer);
 void motor_DMA_IRQHandler(descriptorCanalDMA_t* descriptor);
 
 
@@ -86,46 +98,51 @@ void motor_DMA_IRQHandler(descriptorCanalDMA_t* descriptor);
 ****************************************************************************************/
 
 /***************************************************************************************
-**  Nombre:         void configurarHardwareDshot(tim_t *tim, uint8_t indice, protocoloMotor_e protocolo, uint8_t tipoCanal, uint8_t inversion)
-**  Descripcion:    Configura el hardware para el protocolo dshot
+**  Nombre:         bool configurarHardwareDshot(tim_t *tim, uint8_t indice, protocoloMotor_e protocolo, uint8_t tipoCanal, uint8_t inversion)
+**  Descripcion:    Configura el hardware para el protocolo dshot. La base de tiempo y, en burst,
+**                  el DMA de actualizacion se configuran con el primer motor de cada timer
 **  Parametros:     Puntero al timer, indice del motor, protocolo dshot, tipo de canal usado, salida invertida o no
-**  Retorno:        Ninguno
+**  Retorno:        False si el canal no tiene DMA o su stream lo usa otro driver
 ****************************************************************************************/
-void configurarHardwareDshot(tim_t *tim, uint8_t indice, protocoloMotor_e protocolo, uint8_t tipoCanal, uint8_t inversion)
+bool configurarHardwareDshot(tim_t *tim, uint8_t indice, protocoloMotor_e protocolo, uint8_t tipoCanal, uint8_t inversion)
 {
-    DMA_Stream_TypeDef *sDMA;
+    if (indice >= NUM_MAX_MOTORES)
+        return false;
 
-    if (usarBurstDshot)
-        sDMA = tim->halTimUP.DMAy_Streamx;
-    else
-        sDMA = tim->halTim.DMAy_Streamx;
+    timerHAL_t *timerHAL = punteroTimer(tim->numTimer);
+    const halTimDMA_t *dmaTim = usarBurstDshot ? &timerHAL->halTimUPdma : &timerHAL->halTimDMA[tim->canal >> 2];
 
-    if (sDMA == NULL)
-        return;
+    // Hay canales sin stream (p.e. el TIM4_CH4 en el F7) que solo se pueden usar en burst
+    if (dmaTim->DMAy_Streamx == NULL)
+        return false;
 
     motorDshot_t * const motor = &motoresDshot[indice];
     motor->salida = tipoCanal;
     motor->timer = tim;
+    motor->indice = indice;
 
-    const uint8_t indiceTimer = indiceTimer(tim->hal.htim.Instance);
-    const bool confTimer = (indiceTimer == contadorMotorDshot - 1);
+    const uint8_t numTimerDshot = indiceTimer(timerHAL->hal.htim.Instance);
+    motorDshotTimer_t *motorTimer = &motoresDshotTimer[numTimerDshot];
+    const bool confTimer = (motorTimer->numMotores == 0);
+    motor->motorTimer = motorTimer;
+
+    // En bidireccional la linea esta alta en reposo y la respuesta se captura en el mismo pin.
+    // Las salidas complementarias no tienen captura
+    motor->bidireccional = usarBidireccionalDshot && !(tipoCanal & TIMER_CANAL_N);
+    if (motor->bidireccional)
+        inversion ^= TIMER_SALIDA_INVERTIDA;
 
     // Configuramos el GPIO
-    configurarIO(tim->hal.pin.pin, CONFIG_IO(GPIO_MODE_AF_PP, GPIO_SPEED_FREQ_VERY_HIGH, GPIO_PULLDOWN), tim->hal.pin.af);
-
-    // Configuracion de la base de tiempo
-    if (confTimer) {
-        motor->htim.Instance = tim->hal.htim.Instance;
-        motor->htim.Init.Prescaler = (uint16_t)(lrintf((float)SystemCoreClock / frecDshot(protocolo) + 0.01f) - 1);
-        motor->htim.Init.Period = protocolo == PWM_TIPO_PROSHOT1000 ? MOTOR_LONGITUD_NIBBLE_PROSHOT : LONGITUD_BIT_MOTOR;
-        motor->htim.Init.RepetitionCounter = 0;
-        motor->htim.Init.ClockDivision = TIM_CLOCKDIVISION_DIV1;
-        motor->htim.Init.CounterMode = TIM_COUNTERMODE_UP;
-        motor->htim.Init.AutoReloadPreload = TIM_AUTORELOAD_PRELOAD_DISABLE;
-
-        if (HAL_TIM_PWM_Init(&tim->hal.htim) != HAL_OK)
-            return;
-    }
+    configurarIO(tim->pin.pin, CONFIG_IO(GPIO_MODE_AF_PP, GPIO_SPEED_FREQ_VERY_HIGH, motor->bidireccional ? GPIO_PULLUP : GPIO_PULLDOWN),
+                 tim->pin.af);
+
+    // Configuracion de la base de tiempo. Es comun a todos los canales del timer
+    const uint16_t periodo = protocolo == PWM_TIPO_PROSHOT1000 ? MOTOR_LONGITUD_NIBBLE_PROSHOT : LONGITUD_BIT_MOTOR;
+    if (!configurarBaseTiempoTimer(tim->numTimer, false, periodo, frecDshot(protocolo)))
+        return false;
+
+    motorTimer->periodoSalida = periodo - 1;
+    motor->htim = timerHAL->hal.htim;
 
     // Configuracion del canal
     TIM_OC_InitTypeDef configOC;
@@ -146,50 +163,55 @@ void configurarHardwareDshot(tim_t *tim, uint8_t indice, protocoloMotor_e protoc
     configOC.OCFastMode = TIM_OCFAST_DISABLE;
     configOC.Pulse = 0;
 
-    if (HAL_TIM_PWM_ConfigChannel(&tim->hal.htim, &configOC, tim->canal) != HAL_OK)
-        return;
+    if (HAL_TIM_PWM_ConfigChannel(&motor->htim, &configOC, tim->canal) != HAL_OK)
+        return false;
 
-    // Configuracion del DMA
-    motor->motorTimer = &motoresDshotTimer[indiceTimer];
+    motor->configOC = configOC;
 
+    // Configuracion del DMA. En burst hay un stream por timer y lo configura el primer motor
     if (usarBurstDshot) {
-        motor->motorTimer->dmaBurst = sDMA;
-
-        if (!confTimer) {
-            motor->configurado = true;
-            return;
+        if (confTimer) {
+            if (!iniciarDMA(dmaTim->dmaTimIrqHandler, DMA_PROPIETARIO_MOTOR, numTimerDshot))
+                return false;
+
+            motorTimer->dmaBurst = dmaTim->DMAy_Streamx;
+            motorTimer->hdma.Instance = dmaTim->DMAy_Streamx;
+            motorTimer->hdma.Init.Channel = dmaTim->canalDMA;
+            motorTimer->hdma.Init.Direction = DMA_MEMORY_TO_PERIPH;
+            motorTimer->hdma.Init.PeriphInc = DMA_PINC_DISABLE;
+            motorTimer->hdma.Init.MemInc = DMA_MINC_ENABLE;
+            motorTimer->hdma.Init.PeriphDataAlignment = DMA_PDATAALIGN_WORD ;
+            motorTimer->hdma.Init.MemDataAlignment = DMA_MDATAALIGN_WORD ;
+            motorTimer->hdma.Init.Mode = DMA_NORMAL;
+            motorTimer->hdma.Init.Priority = DMA_PRIORITY_HIGH;
+            motorTimer->hdma.Init.FIFOMode = DMA_FIFOMODE_DISABLE;
+            motorTimer->hdma.Init.PeriphBurst = DMA_PBURST_SINGLE;
+            motorTimer->hdma.Init.MemBurst = DMA_MBURST_SINGLE;
+            motorTimer->hdma.Init.FIFOThreshold = DMA_FIFO_THRESHOLD_FULL;
+
+            motorTimer->bufferBurstDMA = &bufferBurstDMA[numTimerDshot][0];
+            memset(motorTimer->bufferBurstDMA, 0, TAMANIO_BUFFER_DMA_DSHOT * 4 * sizeof(uint32_t));
+
+            motorTimer->htim = timerHAL->hal.htim;
+
+            __HAL_LINKDMA(&motorTimer->htim, hdma[TIM_DMA_ID_UPDATE], motorTimer->hdma);
+            if (HAL_DMA_Init(motorTimer->htim.hdma[TIM_DMA_ID_UPDATE]) != HAL_OK)
+                return false;
+
+            if (!ajustarHandlerDMA(dmaTim->dmaTimIrqHandler, motor_DMA_IRQHandler, CONSTRUIR_PRIORIDAD_NVIC(1, 2), numTimerDshot))
+                return false;
         }
     }
     else {
+        if (!iniciarDMA(dmaTim->dmaTimIrqHandler, DMA_PROPIETARIO_MOTOR, indice))
+            return false;
+
         motor->fuenteDMAtimer = fuenteDMAtimer(tim->canal);
-        motor->motorTimer->fuentesDMAtimer |= motor->fuenteDMAtimer;
+        motorTimer->fuentesDMAtimer |= motor->fuenteDMAtimer;
         motor->indiceDMAtimer = indiceDMAtimer(tim->canal);
-    }
 
-    if (usarBurstDshot) {
-        motor->motorTimer->hdma.Init.Direction = DMA_MEMORY_TO_PERIPH;
-        motor->motorTimer->hdma.Init.PeriphInc = DMA_PINC_DISABLE;
-        motor->motorTimer->hdma.Init.MemInc = DMA_MINC_ENABLE;
-        motor->motorTimer->hdma.Init.PeriphDataAlignment = DMA_PDATAALIGN_WORD ;
-        motor->motorTimer->hdma.Init.MemDataAlignment = DMA_MDATAALIGN_WORD ;
-        motor->motorTimer->hdma.Init.Mode = DMA_NORMAL;
-        motor->motorTimer->hdma.Init.Priority = DMA_PRIORITY_HIGH;
-        motor->motorTimer->hdma.Init.FIFOMode = DMA_FIFOMODE_DISABLE;
-        motor->motorTimer->hdma.Init.PeriphBurst = DMA_PBURST_SINGLE;
-        motor->motorTimer->hdma.Init.MemBurst = DMA_MBURST_SINGLE;
-        motor->motorTimer->hdma.Init.FIFOThreshold = DMA_FIFO_THRESHOLD_FULL;
-
-        motor->motorTimer->bufferBurstDMA = &bufferBurstDMA[indiceTimer][0];
-        memset(motor->motorTimer->bufferBurstDMA, 0, TAMANIO_BUFFER_DMA_DSHOT * 4 * sizeof(uint32_t));
-
-        motor->motorTimer->htim = motor->htim;
-        motor->motorTimer->hdma.Instance = tim->halTimUP.DMAy_Streamx;
-
-        __HAL_LINKDMA(&motor->motorTimer->htim, hdma[TIM_DMA_ID_UPDATE], motor->motorTimer->hdma);
-        if (HAL_DMA_Init(motor->motorTimer->htim.hdma[TIM_DMA_ID_UPDATE]) != HAL_OK)
-            return;
-    }
-    else {
+        motor->hdma.Instance = dmaTim->DMAy_Streamx;
+        motor->hdma.Init.Channel = dmaTim->canalDMA;
         motor->hdma.Init.Direction = DMA_MEMORY_TO_PERIPH;
         motor->hdma.Init.PeriphInc = DMA_PINC_DISABLE;
         motor->hdma.Init.MemInc = DMA_MINC_ENABLE;
@@ -205,35 +227,34 @@ void configurarHardwareDshot(tim_t *tim, uint8_t indice, protocoloMotor_e protoc
         motor->bufferDMA = &bufferDshotDMA[indice][0];
         motor->bufferDMA[TAMANIO_BUFFER_DMA_DSHOT - 2] = 0;
         motor->bufferDMA[TAMANIO_BUFFER_DMA_DSHOT - 1] = 0;
-
-        motor->hdma.Instance = tim->halTim.DMAy_Streamx;
+        motor->bufferCaptura = &bufferCapturaDshot[indice][0];
+        memset(&motor->telemetria, 0, sizeof(motor->telemetria));
 
         __HAL_LINKDMA(&motor->htim, hdma[motor->indiceDMAtimer], motor->hdma);
         if (HAL_DMA_Init(motor->htim.hdma[motor->indiceDMAtimer]) != HAL_OK)
-            return;
-    }
+            return false;
 
-    if (usarBurstDshot) {
-    	iniciarDMA(tim->halTimUP.dmaTimIrqHandler);
-    	ajustarHandlerDMA(tim->halTimUP.dmaTimIrqHandler, motor_DMA_IRQHandler, CONSTRUIR_PRIORIDAD_NVIC(1, 2), indiceTimer);
-    }
-    else {
-    	iniciarDMA(tim->halTim.dmaTimIrqHandler);
-    	ajustarHandlerDMA(tim->halTim.dmaTimIrqHandler, motor_DMA_IRQHandler, CONSTRUIR_PRIORIDAD_NVIC(1, 2), indice);
+        if (!ajustarHandlerDMA(dmaTim->dmaTimIrqHandler, motor_DMA_IRQHandler, CONSTRUIR_PRIORIDAD_NVIC(1, 2), indice))
+            return false;
     }
 
     // Iniciamos el canal del timer
     // Habilitando y deshabilitando el DMA request se puede reiniciar un nuevo ciclo sin PWM start/stop
     if (tipoCanal == TIMER_CANAL_N) {
         if (HAL_TIMEx_PWMN_Start(&motor->htim, tim->canal) != HAL_OK)
-            return;
+            return false;
     }
     else {
         if (HAL_TIM_PWM_Start(&motor->htim, tim->canal) != HAL_OK)
-            return;
+            return false;
     }
 
+    motorTimer->numMotores++;
+    if (motor->bidireccional)
+        motorTimer->numBidireccional++;
+
     motor->configurado = true;
+    return true;
 }
 
 
@@ -308,18 +329,22 @@ void escribirPWMdshot(uint8_t indice, float valor)
     if (!motor->configurado)
         return;
 
+    // La respuesta a la trama anterior ya ha llegado. Se decodifican las de todos los canales del
+    // timer y los pines vuelven a ser salidas
+    if (motor->capturando)
+        terminarCapturasTimerDshot(motor->motorTimer);
+
+    // El valor entre 0 y 1 se lleva al rango de aceleracion. El 0 es el comando de parada
+    valor = limitarFloat(valor, 0, 1);
+    motor->valor = valor > 0 ? MIN_THROTTLE_DSHOT + lrintf(valor * (MAX_THROTTLE_DSHOT - MIN_THROTTLE_DSHOT)) : DSHOT_CMD_MOTOR_STOP;
+
     // Si hay un comando listo para enviar, sobreescribe el valor y envia
     if (comandoDshotSiendoProcesado()) {
-        valor = comandoDshot(indice);
-        if (valor)
+        motor->valor = comandoDshot(indice);
+        if (motor->valor)
             motor->solicitarTelemetria = true;
     }
 
-    if (!motor->timer || !motor->timer->halTim.DMAy_Streamx)
-        return;
-
-    motor->valor = valor;
-
     uint16_t paquete = prepararPaqueteDshot(motor);
     uint8_t tamBuffer;
 
@@ -505,6 +530,10 @@ CODIGO_RAPIDO uint16_t prepararPaqueteDshot(motorDshot_t *const motor)
         datoCsum >>= 4;
     }
 
+    // En bidireccional el checksum va invertido para que el ESC sepa que tiene que responder
+    if (usarBidireccionalDshot)
+        csum = ~csum;
+
     csum &= 0xf;
     paquete = (paquete << 4) | csum;
 
@@ -521,6 +550,8 @@ CODIGO_RAPIDO uint16_t prepararPaqueteDshot(motorDshot_t *const motor)
 void motor_DMA_IRQHandler(descriptorCanalDMA_t* descriptor)
 {
     if (OBTENER_FLAG_STATUS_DMA(descriptor, DMA_IT_TCIF)) {
+        motorDshot_t *motorCaptura = NULL;
+
         if (usarBurstDshot) {
             motorDshotTimer_t *burstDMAtimer = &motoresDshotTimer[descriptor->paramUsuario];
 
@@ -532,10 +563,145 @@ void motor_DMA_IRQHandler(descriptorCanalDMA_t* descriptor)
 
             pararPWMcanalDMA(&motor->htim, motor->timer->canal);
             HAL_DMA_IRQHandler(motor->htim.hdma[motor->indiceDMAtimer]);
+
+            // Fin de la trama: el pin pasa a capturar la respuesta del ESC. Si lo que termina es
+            // la captura (buffer lleno) se procesa en la siguiente escritura
+            if (motor->bidireccional && !motor->capturando)
+                motorCaptura = motor;
         }
 
         LIMPIAR_FLAG_DMA(descriptor, DMA_IT_TCIF);
+
+        if (motorCaptura != NULL)
+            iniciarCapturaDshot(motorCaptura);
+    }
+}
+
+
+/***************************************************************************************
+**  Nombre:         void iniciarCapturaDshot(motorDshot_t *motor)
+**  Descripcion:    Configura el canal en captura por ambos flancos y el DMA del canal en sentido
+**                  periferico a memoria. El periodo es comun a los canales del timer, asi que el
+**                  contador pasa a correr libre hasta 0xFFFF cuando todos han terminado la trama
+**  Parametros:     Motor
+**  Retorno:        Ninguno
+****************************************************************************************/
+void iniciarCapturaDshot(motorDshot_t *motor)
+{
+    TIM_IC_InitTypeDef configIC;
+    configIC.ICPolarity = TIM_ICPOLARITY_BOTHEDGE;
+    configIC.ICSelection = TIM_ICSELECTION_DIRECTTI;
+    configIC.ICPrescaler = TIM_ICPSC_DIV1;
+    configIC.ICFilter = FILTRO_CAPTURA_DSHOT;
+
+    if (HAL_TIM_IC_ConfigChannel(&motor->htim, &configIC, motor->timer->canal) != HAL_OK)
+        return;
+
+    motor->hdma.Init.Direction = DMA_PERIPH_TO_MEMORY;
+    MODIFY_REG(motor->hdma.Instance->CR, DMA_SxCR_DIR, DMA_PERIPH_TO_MEMORY);
+
+    volatile uint32_t *ccr = &motor->htim.Instance->CCR1 + (motor->timer->canal >> 2);
+    HAL_DMA_Start_IT(&motor->hdma, (uint32_t)ccr, (uint32_t)motor->bufferCaptura, TAM_BUFFER_CAPTURA_DSHOT);
+
+    __HAL_TIM_ENABLE_DMA(&motor->htim, motor->fuenteDMAtimer);
+    TIM_CCxChannelCmd(motor->htim.Instance, motor->timer->canal, TIM_CCx_ENABLE);
+    motor->capturando = true;
+
+    // Mientras quede algun canal enviando no se puede tocar el periodo
+    motorDshotTimer_t *motorTimer = motor->motorTimer;
+    if (++motorTimer->numCapturando == motorTimer->numBidireccional)
+        __HAL_TIM_SET_AUTORELOAD(&motor->htim, PERIODO_CAPTURA_DSHOT);
+}
+
+
+/***************************************************************************************
+**  Nombre:         void terminarCapturaDshot(motorDshot_t *motor)
+**  Descripcion:    Para la captura, decodifica los flancos recibidos y devuelve el canal a la salida
+**                  PWM. El periodo de la trama lo restaura terminarCapturasTimerDshot
+**  Parametros:     Motor
+**  Retorno:        Ninguno
+****************************************************************************************/
+void terminarCapturaDshot(motorDshot_t *motor)
+{
+    pararPWMcanalDMA(&motor->htim, motor->timer->canal);
+
+    const uint8_t numFlancos = TAM_BUFFER_CAPTURA_DSHOT - __HAL_DMA_GET_COUNTER(&motor->hdma);
+    HAL_DMA_Abort(&motor->hdma);
+
+    SCB_InvalidateDCache_by_Addr(motor->bufferCaptura, TAM_BUFFER_CAPTURA_DSHOT * sizeof(uint32_t));
+    actualizarTelemetriaDshot(&motor->telemetria, motor->bufferCaptura, numFlancos, TICKS_BIT_TELEMETRIA_DSHOT, micros());
+
+    motor->hdma.Init.Direction = DMA_MEMORY_TO_PERIPH;
+    MODIFY_REG(motor->hdma.Instance->CR, DMA_SxCR_DIR, DMA_MEMORY_TO_PERIPH);
+
+    HAL_TIM_PWM_ConfigChannel(&motor->htim, &motor->configOC, motor->timer->canal);
+    TIM_CCxChannelCmd(motor->htim.Instance, motor->timer->canal, TIM_CCx_ENABLE);
+
+    motor->capturando = false;
+}
+
+
+/***************************************************************************************
+**  Nombre:         void terminarCapturasTimerDshot(motorDshotTimer_t *motorTimer)
+**  Descripcion:    Termina la captura de todos los canales de un timer y, con todos de nuevo en
+**                  salida, restaura el periodo de la trama. El contador se pone a cero porque
+**                  puede estar por encima del nuevo periodo
+**  Parametros:     Timer de los motores
+**  Retorno:        Ninguno
+****************************************************************************************/
+void terminarCapturasTimerDshot(motorDshotTimer_t *motorTimer)
+{
+    motorDshot_t *motorPeriodo = NULL;
+
+    for (uint8_t i = 0; i < NUM_MAX_MOTORES; i++) {
+        motorDshot_t *motor = &motoresDshot[i];
+
+        if (motor->configurado && motor->motorTimer == motorTimer && motor->capturando) {
+            terminarCapturaDshot(motor);
+            motorPeriodo = motor;
+        }
     }
+
+    if (motorPeriodo == NULL)
+        return;
+
+    __HAL_TIM_SET_AUTORELOAD(&motorPeriodo->htim, motorTimer->periodoSalida);
+    __HAL_TIM_SET_COUNTER(&motorPeriodo->htim, 0);
+    motorTimer->numCapturando = 0;
+}
+
+
+/***************************************************************************************
+**  Nombre:         bool frecMotorDshot(uint8_t indice, uint8_t numPolos, float *frec)
+**  Descripcion:    Obtiene la frecuencia de giro de un motor a partir de su telemetria
+**  Parametros:     Indice del motor, numero de polos, frecuencia en Hz
+**  Retorno:        False si el motor no responde desde hace TIMEOUT_TELEMETRIA_DSHOT
+****************************************************************************************/
+bool frecMotorDshot(uint8_t indice, uint8_t numPolos, float *frec)
+{
+    *frec = 0;
+    if (indice >= NUM_MAX_MOTORES)
+        return false;
+
+    const motorDshot_t *motor = &motoresDshot[indice];
+    if (!motor->bidireccional || motor->telemetria.numTramas == 0 ||
+        micros() - motor->telemetria.tiempoTrama > TIMEOUT_TELEMETRIA_DSHOT)
+        return false;
+
+    *frec = frecTelemetriaDshot(&motor->telemetria, numPolos);
+    return true;
+}
+
+
+/***************************************************************************************
+**  Nombre:         const telemetriaDshot_t *telemetriaMotorDshot(uint8_t indice)
+**  Descripcion:    Obtiene la telemetria y los contadores de errores de un motor
+**  Parametros:     Indice del motor
+**  Retorno:        Puntero a la telemetria
+****************************************************************************************/
+const telemetriaDshot_t *telemetriaMotorDshot(uint8_t indice)
+{
+    return &motoresDshot[indice].telemetria;
 }
 
 #endif
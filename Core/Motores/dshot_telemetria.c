@@ -0,0 +1,274 @@
+/***************************************************************************************
+**  dshot_telemetria.c - Decodificacion de la telemetria eRPM del dshot bidireccional
+**
+**
+**  Este fichero forma parte del proyecto URpilot.
+**  Codigo desarrollado por el grupo de investigacion ICON de la Universidad de La Rioja
+**
+**  Autor: Ramon Rico
+**  Fecha de creacion: 17/10/2026
+**  Fecha de modificacion: 17/10/2026
+**
+**  El proyecto URpilot NO es libre. No se puede distribuir y/o modificar este fichero
+**  bajo ningun concepto.
+**
+**  En caso de modificacion y/o solicitud de informacion pongase en contacto con
+**  el grupo de investigacion ICON a traves de: www.unirioja.es/urpilot
+**
+**
+**  Control de versiones del fichero
+**
+**  v1.0  Ramon Rico. Se ha liberado la primera version estable
+**
+****************************************************************************************/
+
+/***************************************************************************************
+** AREA DE INCLUDES                                                                   **
+****************************************************************************************/
+#include "dshot_telemetria.h"
+
+
+/***************************************************************************************
+** AREA DE PREPROCESADOR                                                              **
+****************************************************************************************/
+#define CODIGO_GCR_INVALIDO                   0xFF
+#define MASCARA_CAPTURA_DSHOT                 0xFFFF      // En la captura el timer cuenta hasta 0xFFFF
+#define MANTISA_MAX_PERIODO_DSHOT             0x01FF
+#define EXPONENTE_MAX_PERIODO_DSHOT           7
+#define US_POR_MINUTO                         60000000
+
+
+/***************************************************************************************
+** AREA DE DEFINICION DE TIPOS                                                        **
+****************************************************************************************/
+
+
+/***************************************************************************************
+** AREA DE DECLARACION DE VARIABLES                                                   **
+****************************************************************************************/
+static const uint8_t codigoGCR[16] = {
+    0x19, 0x1B, 0x12, 0x13, 0x1D, 0x15, 0x16, 0x17, 0x1A, 0x09, 0x0A, 0x0B, 0x1E, 0x0D, 0x0E, 0x0F
+};
+
+static const uint8_t cuartetoGCR[32] = {
+    0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0x09, 0x0A, 0x0B, 0xFF, 0x0D, 0x0E, 0x0F,
+    0xFF, 0xFF, 0x02, 0x03, 0xFF, 0x05, 0x06, 0x07, 0xFF, 0x00, 0x08, 0x01, 0xFF, 0x04, 0x0C, 0xFF
+};
+
+
+/***************************************************************************************
+** AREA DE PROTOTIPOS DE FUNCION                                                      **
+****************************************************************************************/
+uint8_t crcTramaTelemetriaDshot(uint16_t periodo);
+
+
+/***************************************************************************************
+** AREA DE DEFINICION DE FUNCIONES                                                    **
+****************************************************************************************/
+
+/***************************************************************************************
+**  Nombre:         resultadoTelemetriaDshot_e decodificarFlancosDshot(const uint32_t *flancos, uint8_t numFlancos,
+**                                                                     uint16_t ticksBit, uint32_t *eRPM)
+**  Descripcion:    Decodifica la respuesta del ESC a partir de los instantes de sus flancos. Cada flanco
+**                  es un 1 y los bits hasta el siguiente flanco son 0. El ultimo tramo se completa hasta
+**                  los 21 bits porque la linea vuelve al reposo sin flanco
+**  Parametros:     Instantes de los flancos en ticks del timer, numero de flancos, ticks por bit,
+**                  eRPM decodificadas
+**  Retorno:        Resultado de la decodificacion
+****************************************************************************************/
+resultadoTelemetriaDshot_e decodificarFlancosDshot(const uint32_t *flancos, uint8_t numFlancos, uint16_t ticksBit, uint32_t *eRPM)
+{
+    if (numFlancos == 0)
+        return TELEMETRIA_DSHOT_SIN_RESPUESTA;
+
+    if (ticksBit == 0)
+        return TELEMETRIA_DSHOT_ERROR_TRAMA;
+
+    // Reconstruimos los 21 bits a partir de la longitud de los tramos entre flancos
+    uint32_t valor = 0;
+    uint8_t bits = 0;
+
+    for (uint8_t i = 1; i < numFlancos && bits < BITS_GCR_TELEMETRIA_DSHOT; i++) {
+        const uint32_t dif = (flancos[i] - flancos[i - 1]) & MASCARA_CAPTURA_DSHOT;
+        const uint32_t longitud = (dif + ticksBit / 2) / ticksBit;
+
+        if (longitud == 0 || bits + longitud > BITS_GCR_TELEMETRIA_DSHOT)
+            return TELEMETRIA_DSHOT_ERROR_TRAMA;
+
+        valor = (valor << longitud) | (1U << (longitud - 1));
+        bits += longitud;
+    }
+
+    if (bits < BITS_MIN_TELEMETRIA_DSHOT)
+        return TELEMETRIA_DSHOT_ERROR_TRAMA;
+
+    if (bits < BITS_GCR_TELEMETRIA_DSHOT) {
+        const uint8_t relleno = BITS_GCR_TELEMETRIA_DSHOT - bits;
+        valor = (valor << relleno) | (1U << (relleno - 1));
+    }
+
+    // Los flancos marcan cambios de nivel. Se obtienen los 20 bits GCR y de ahi los cuartetos
+    valor ^= valor >> 1;
+
+    uint16_t trama = 0;
+    for (int8_t i = 3; i >= 0; i--) {
+        const uint8_t cuarteto = cuartetoGCR[(valor >> (5 * i)) & 0x1F];
+        if (cuarteto == CODIGO_GCR_INVALIDO)
+            return TELEMETRIA_DSHOT_ERROR_GCR;
+
+        trama = (trama << 4) | cuarteto;
+    }
+
+    // El checksum de la respuesta va invertido
+    uint16_t csum = trama ^ (trama >> 8);
+    csum ^= csum >> 4;
+    if ((csum & 0x0F) != 0x0F)
+        return TELEMETRIA_DSHOT_ERROR_CRC;
+
+    // Periodo electrico en us con 3 bits de exponente y 9 de mantisa
+    const uint16_t codigoPeriodo = trama >> 4;
+    if (codigoPeriodo == PERIODO_CERO_TELEMETRIA_DSHOT) {
+        *eRPM = 0;
+        return TELEMETRIA_DSHOT_OK;
+    }
+
+    const uint32_t periodo = (uint32_t)(codigoPeriodo & MANTISA_MAX_PERIODO_DSHOT) << (codigoPeriodo >> 9);
+    if (periodo == 0)
+        return TELEMETRIA_DSHOT_ERROR_TRAMA;
+
+    *eRPM = (US_POR_MINUTO + periodo / 2) / periodo;
+    return TELEMETRIA_DSHOT_OK;
+}
+
+
+/***************************************************************************************
+**  Nombre:         uint8_t codificarFlancosDshot(uint32_t eRPM, uint16_t ticksBit, uint32_t tiempoInicio, uint32_t *flancos)
+**  Descripcion:    Genera los flancos de la respuesta de un ESC. Lo usan el SITL y las herramientas del host
+**                  para probar el decodificador. Si la linea termina baja se anade el flanco de vuelta al
+**                  reposo
+**  Parametros:     eRPM, ticks por bit, instante del primer flanco, buffer de BITS_GCR_TELEMETRIA_DSHOT + 1
+**                  flancos
+**  Retorno:        Numero de flancos
+****************************************************************************************/
+uint8_t codificarFlancosDshot(uint32_t eRPM, uint16_t ticksBit, uint32_t tiempoInicio, uint32_t *flancos)
+{
+    uint16_t codigoPeriodo = PERIODO_CERO_TELEMETRIA_DSHOT;
+
+    if (eRPM > 0) {
+        uint32_t periodo = (US_POR_MINUTO + eRPM / 2) / eRPM;
+        uint8_t exponente = 0;
+
+        while (periodo > MANTISA_MAX_PERIODO_DSHOT && exponente < EXPONENTE_MAX_PERIODO_DSHOT) {
+            periodo >>= 1;
+            exponente++;
+        }
+
+        if (periodo <= MANTISA_MAX_PERIODO_DSHOT)
+            codigoPeriodo = (exponente << 9) | periodo;
+    }
+
+    const uint16_t trama = (codigoPeriodo << 4) | crcTramaTelemetriaDshot(codigoPeriodo);
+
+    uint32_t gcr = 0;
+    for (int8_t i = 3; i >= 0; i--)
+        gcr = (gcr << 5) | codigoGCR[(trama >> (4 * i)) & 0x0F];
+
+    // El bit de inicio siempre es un flanco. Cada 1 del GCR cambia el nivel respecto al bit anterior
+    uint32_t valor = 1U << (BITS_GCR_TELEMETRIA_DSHOT - 1);
+    for (int8_t i = BITS_GCR_TELEMETRIA_DSHOT - 2; i >= 0; i--) {
+        if (((gcr >> i) ^ (valor >> (i + 1))) & 1)
+            valor |= 1U << i;
+    }
+
+    uint8_t numFlancos = 0;
+    for (int8_t i = BITS_GCR_TELEMETRIA_DSHOT - 1; i >= 0; i--) {
+        if (valor & (1U << i))
+            flancos[numFlancos++] = tiempoInicio + (BITS_GCR_TELEMETRIA_DSHOT - 1 - i) * ticksBit;
+    }
+
+    if (numFlancos & 1)
+        flancos[numFlancos++] = tiempoInicio + BITS_GCR_TELEMETRIA_DSHOT * ticksBit;
+
+    return numFlancos;
+}
+
+
+/***************************************************************************************
+**  Nombre:         uint8_t crcTramaTelemetriaDshot(uint16_t periodo)
+**  Descripcion:    Calcula el checksum invertido de la respuesta
+**  Parametros:     Codigo del periodo de 12 bits
+**  Retorno:        Checksum
+****************************************************************************************/
+uint8_t crcTramaTelemetriaDshot(uint16_t periodo)
+{
+    return ~(periodo ^ (periodo >> 4) ^ (periodo >> 8)) & 0x0F;
+}
+
+
+/***************************************************************************************
+**  Nombre:         resultadoTelemetriaDshot_e actualizarTelemetriaDshot(telemetriaDshot_t *telemetria, const uint32_t *flancos,
+**                                                                       uint8_t numFlancos, uint16_t ticksBit, uint32_t tiempoActual)
+**  Descripcion:    Decodifica una captura y actualiza las eRPM y los contadores de errores del motor
+**  Parametros:     Telemetria del motor, flancos, numero de flancos, ticks por bit, tiempo actual
+**  Retorno:        Resultado de la decodificacion
+****************************************************************************************/
+resultadoTelemetriaDshot_e actualizarTelemetriaDshot(telemetriaDshot_t *telemetria, const uint32_t *flancos, uint8_t numFlancos,
+                                                     uint16_t ticksBit, uint32_t tiempoActual)
+{
+    uint32_t eRPM;
+    const resultadoTelemetriaDshot_e resultado = decodificarFlancosDshot(flancos, numFlancos, ticksBit, &eRPM);
+
+    switch (resultado) {
+        case TELEMETRIA_DSHOT_OK:
+            telemetria->eRPM = eRPM;
+            telemetria->tiempoTrama = tiempoActual;
+            telemetria->numTramas++;
+            break;
+
+        case TELEMETRIA_DSHOT_SIN_RESPUESTA:
+            telemetria->numSinRespuesta++;
+            break;
+
+        case TELEMETRIA_DSHOT_ERROR_TRAMA:
+            telemetria->numErroresTrama++;
+            break;
+
+        case TELEMETRIA_DSHOT_ERROR_GCR:
+            telemetria->numErroresGCR++;
+            break;
+
+        case TELEMETRIA_DSHOT_ERROR_CRC:
+            telemetria->numErroresCRC++;
+            break;
+    }
+
+    return resultado;
+}
+
+
+/***************************************************************************************
+**  Nombre:         float frecTelemetriaDshot(const telemetriaDshot_t *telemetria, uint8_t numPolos)
+**  Descripcion:    Obtiene la frecuencia de giro del motor
+**  Parametros:     Telemetria del motor, numero de polos del motor
+**  Retorno:        Frecuencia en Hz
+****************************************************************************************/
+float frecTelemetriaDshot(const telemetriaDshot_t *telemetria, uint8_t numPolos)
+{
+    if (numPolos == 0)
+        return 0.0f;
+
+    // RPM = eRPM / pares de polos
+    return telemetria->eRPM / (30.0f * numPolos);
+}
+
+
+/***************************************************************************************
+**  Nombre:         uint32_t erroresTelemetriaDshot(const telemetriaDshot_t *telemetria)
+**  Descripcion:    Obtiene el numero total de capturas no validas
+**  Parametros:     Telemetria del motor
+**  Retorno:        Numero de errores
+****************************************************************************************/
+uint32_t erroresTelemetriaDshot(const telemetriaDshot_t *telemetria)
+{
+    return telemetria->numSinRespuesta + telemetria->numErroresTrama + telemetria->numErroresGCR + telemetria->numErroresCRC;
+}
@@ -0,0 +1,82 @@
+/***************************************************************************************
+**  dshot_telemetria.h - Decodificacion de la telemetria eRPM del dshot bidireccional
+**
+**
+**  Este fichero forma parte del proyecto URpilot.
+**  Codigo desarrollado por el grupo de investigacion ICON de la Universidad de La Rioja
+**
+**  Autor: Ramon Rico
+**  Fecha de creacion: 17/10/2026
+**  Fecha de modificacion: 17/10/2026
+**
+**  El proyecto URpilot NO es libre. No se puede distribuir y/o modificar este fichero
+**  bajo ningun concepto.
+**
+**  En caso de modificacion y/o solicitud de informacion pongase en contacto con
+**  el grupo de investigacion ICON a traves de: www.unirioja.es/urpilot
+**
+**
+**  Control de versiones del fichero
+**
+**  v1.0  Ramon Rico. Se ha liberado la primera version estable
+**
+****************************************************************************************/
+
+#ifndef __DSHOT_TELEMETRIA_H
+#define __DSHOT_TELEMETRIA_H
+
+/***************************************************************************************
+** AREA DE INCLUDES                                                                   **
+****************************************************************************************/
+#include <stdint.h>
+#include <stdbool.h>
+
+
+/***************************************************************************************
+** AREA DE PREPROCESADOR                                                              **
+****************************************************************************************/
+// Respuesta del ESC: 21 bits GCR a 5/4 de la velocidad de la trama. Un flanco por cada 1
+#define BITS_GCR_TELEMETRIA_DSHOT             21
+#define BITS_MIN_TELEMETRIA_DSHOT             18
+#define TAM_BUFFER_CAPTURA_DSHOT              32
+#define PERIODO_CERO_TELEMETRIA_DSHOT         0x0FFF      // Exponente y mantisa maximos: motor parado
+
+
+/***************************************************************************************
+** AREA DE DEFINICION DE TIPOS                                                        **
+****************************************************************************************/
+typedef enum {
+    TELEMETRIA_DSHOT_OK = 0,
+    TELEMETRIA_DSHOT_SIN_RESPUESTA,
+    TELEMETRIA_DSHOT_ERROR_TRAMA,                         // Numero de bits o anchura de los pulsos incorrectos
+    TELEMETRIA_DSHOT_ERROR_GCR,
+    TELEMETRIA_DSHOT_ERROR_CRC,
+} resultadoTelemetriaDshot_e;
+
+typedef struct {
+    uint32_t eRPM;
+    uint32_t tiempoTrama;                                 // us de la ultima trama valida
+    uint32_t numTramas;                                   // Tramas validas
+    uint32_t numSinRespuesta;
+    uint32_t numErroresTrama;
+    uint32_t numErroresGCR;
+    uint32_t numErroresCRC;
+} telemetriaDshot_t;
+
+
+/***************************************************************************************
+** AREA DE DECLARACION DE VARIABLES                                                   **
+****************************************************************************************/
+
+
+/***************************************************************************************
+** AREA DE PROTOTIPOS DE FUNCION                                                      **
+****************************************************************************************/
+resultadoTelemetriaDshot_e decodificarFlancosDshot(const uint32_t *flancos, uint8_t numFlancos, uint16_t ticksBit, uint32_t *eRPM);
+uint8_t codificarFlancosDshot(uint32_t eRPM, uint16_t ticksBit, uint32_t tiempoInicio, uint32_t *flancos);
+resultadoTelemetriaDshot_e actualizarTelemetriaDshot(telemetriaDshot_t *telemetria, const uint32_t *flancos, uint8_t numFlancos,
+                                                     uint16_t ticksBit, uint32_t tiempoActual);
+float frecTelemetriaDshot(const telemetriaDshot_t *telemetria, uint8_t numPolos);
+uint32_t erroresTelemetriaDshot(const telemetriaDshot_t *telemetria);
+
+#endif // __DSHOT_TELEMETRIA_H
@@ -7,7 +7,7 @@
 **
 **  Autor: Ramon Rico
 **  Fecha de creacion: 27/08/2019
-**  Fecha de modificacion: 19/09/2020
+**  Fecha de modificacion: 17/10/2026
 **
 **  El proyecto URpilot NO es libre. No se puede distribuir y/o modificar este fichero
 **  bajo ningun concepto.
@@ -59,7 +59,7 @@ static fnActualizarPWM *actualizarPWM = NULL;
 static bool esDshot;
 
 #ifdef USAR_DSHOT
-static fnCargarBufferDMA *cargarBufferDMA = NULL;
+fnCargarBufferDMA *cargarBufferDMA = NULL;
 #endif
 static bool motoresHabilitados = false;
 static bool motoresIniciados = false;
@@ -73,10 +73,6 @@ void actualizarPWMoneshot(uint8_t numMotores);
 void escribirPWMnoUsado(uint8_t indice, float valor);
 void escribirPWMestandar(uint8_t indice, float valor);
 
-#ifdef USAR_DSHOT
-void escribirPWMdshot(uint8_t indice, uint16_t valor);
-#endif
-
 
 /***************************************************************************************
 ** AREA DE DEFINICION DE FUNCIONES                                                    **
@@ -90,7 +86,7 @@ void escribirPWMdshot(uint8_t indice, uint16_t valor);
 ****************************************************************************************/
 bool iniciarMotores(void)
 {
-    memset(motores, 0, sizeof(motores));
+    memset(motor, 0, sizeof(motor));
 
     bool usarPWMnoSincronizado = false;
     float sMin = 0;
@@ -135,7 +131,10 @@ bool iniciarMotores(void)
             cargarBufferDMA = &cargarBufferDMAdshot;
             actualizarPWM = &actualizarPWMdshot;
             esDshot = true;
-            if (configMotor()->usarBurstDshot)
+            // La captura de la respuesta necesita el DMA de cada canal, asi que excluye el burst
+            if (configMotor()->usarTelemetriaDshot)
+                usarBidireccionalDshot = true;
+            else if (configMotor()->usarBurstDshot)
                 usarBurstDshot = true;
             break;
 #endif
@@ -169,7 +168,9 @@ bool iniciarMotores(void)
 
 #ifdef USAR_DSHOT
         if (esDshot) {
-            configurarHardwareDshot(*dTim, i, configMotor()->protocolo, dTim->tipoCanal, configMotor()->inversion);
+            if (!configurarHardwareDshot(dTim, i, configMotor()->protocolo, dTim->tipoCanal, configMotor()->inversion))
+                return false;
+
             driver->habilitado = true;
             continue;
         }
@@ -295,6 +296,43 @@ bool esProtocoloMotorDshot(void)
 }
 
 
+/***************************************************************************************
+**  Nombre:         bool telemetriaRPMmotoresHabilitada(void)
+**  Descripcion:    Comprueba si los ESC envian la velocidad de giro. Solo depende de la configuracion
+**                  para poder consultarse antes de iniciar los motores
+**  Parametros:     Ninguno
+**  Retorno:        True si hay telemetria de velocidad
+****************************************************************************************/
+bool telemetriaRPMmotoresHabilitada(void)
+{
+#ifdef USAR_DSHOT
+    const protocoloMotor_e protocolo = configMotor()->protocolo;
+    return configMotor()->usarTelemetriaDshot && protocolo >= PWM_TIPO_DSHOT150 && protocolo <= PWM_TIPO_DSHOT1200;
+#else
+    return false;
+#endif
+}
+
+
+/***************************************************************************************
+**  Nombre:         bool frecGiroMotor(uint8_t indice, float *frec)
+**  Descripcion:    Obtiene la frecuencia de giro de un motor
+**  Parametros:     Motor, frecuencia en Hz
+**  Retorno:        False si no hay telemetria valida del motor
+****************************************************************************************/
+bool frecGiroMotor(uint8_t indice, float *frec)
+{
+#ifdef USAR_DSHOT
+    if (usarBidireccionalDshot)
+        return frecMotorDshot(indice, configMotor()->polosMotor, frec);
+#endif
+
+    UNUSED(indice);
+    *frec = 0;
+    return false;
+}
+
+
 /***************************************************************************************
 **  Nombre:         void escribirMotor(uint8_t indice, float valor)
 **  Descripcion:    Escribe un valor en un motor
@@ -345,14 +383,6 @@ void escribirValorTodosMotores(float valor)
 }
 
 
-#include "Sensores/IMU/imu.h"
-#include "Drivers/tiempo.h"
-extern reaction_t reaction;
-extern uint32_t rTimeMax;
-extern uint32_t rTimeMin;
-extern uint32_t rTime1;
-extern bool cambiarID;
-extern bool iniR;
 /***************************************************************************************
 **  Nombre:         void actualizarMotores(void)
 **  Descripcion:    Actualiza el valor del PWM
@@ -361,28 +391,7 @@ extern bool iniR;
 ****************************************************************************************/
 void actualizarMotores(void)
 {
-
-    if ((micros() > 30000000) && iniR == false) {
-    	iniR = true;
-    	cambiarID = true;
-    }
-
-    if (cambiarID) {
-    	cambiarID = false;
-
-		reaction.tiempo = micros();
-		reaction.id = 'A';
-    }
-
     actualizarPWM(numMotores());
-
-
-
-
-
-
-
-
 }
 
 
@@ -451,17 +460,4 @@ void escribirPWMestandar(uint8_t indice, float valor)
 }
 
 
-#ifdef USAR_DSHOT
-/***************************************************************************************
-**  Nombre:         void escribirPWMdshot(uint8_t indice, float valor)
-**  Descripcion:    Funcion de escritura de los motores dshot
-**  Parametros:     Motor a escribir, valor entre 0 y 1
-**  Retorno:        Ninguno
-****************************************************************************************/
-CODIGO_RAPIDO void escribirPWMdshot(uint8_t indice, float valor)
-{
-    escribirPWMdshot(indice, valor);
-}
-#endif
-
 #endif
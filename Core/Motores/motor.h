@@ -7,7 +7,7 @@
 **
 **  Autor: Ramon Rico
 **  Fecha de creacion: 27/08/2019
-**  Fecha de modificacion: 19/09/2020
+**  Fecha de modificacion: 17/10/2026
 **
 **  El proyecto URpilot NO es libre. No se puede distribuir y/o modificar este fichero
 **  bajo ningun concepto.
@@ -116,6 +116,8 @@ bool estanMotoresHabilitados(void);
 bool estaMotorHabilitado(uint8_t numMotor);
 motor_t *motores(void);
 bool esProtocoloMotorDshot(void);
+bool telemetriaRPMmotoresHabilitada(void);
+bool frecGiroMotor(uint8_t indice, float *frec);
 
 void escribirMotor(uint8_t indice, float valor);
 void escribirMotores(float *valor);
@@ -7,7 +7,7 @@
 **
 **  Autor: Ramon Rico
 **  Fecha de creacion: 07/09/2019
-**  Fecha de modificacion: 19/09/2020
+**  Fecha de modificacion: 17/10/2026
 **
 **  El proyecto URpilot NO es libre. No se puede distribuir y/o modificar este fichero
 **  bajo ningun concepto.
@@ -54,45 +54,89 @@
 ****************************************************************************************/
 
 /***************************************************************************************
-**  Nombre:         void iniciarPID(pid_t *pid, float kp, float ki, float kd, float kff, float limIntegral, float limSalida)
-**  Descripcion:    Inicia el PID
-**  Parametros:     PID, ganancia proporcional, integral, derivada, feedforward, limite de la parte integral
-**                  limite de la salida
+**  Nombre:         void iniciarPID(pid_t *pid, const paramPID_t *param, float frecMuestreo)
+**  Descripcion:    Inicia el PID. Los parametros no se copian: las ganancias nuevas se usan en
+**                  el siguiente ciclo y el filtro de la derivada se reajusta con ajustarFiltrosPID
+**  Parametros:     PID, parametros, frecuencia de actualizacion del lazo
 **  Retorno:        Ninguno
 ****************************************************************************************/
-void iniciarPID(pid_t *pid, float kp, float ki, float kd, float kff, float limIntegral, float limSalida)
+void iniciarPID(pid_t *pid, const paramPID_t *param, float frecMuestreo)
 {
-	pid->integral = 0.0;
+    pid->p = param;
+    pid->escala = 1.0f;
+
+    ajustarFiltroPasaBajo(&pid->filtroD, param->frecCorteD, frecMuestreo);
+    ajustarFiltroPasaBajo(&pid->filtroFF, param->frecCorteD, frecMuestreo);
+    resetearPID(pid);
+}
+
 
-    pid->p.kp = kp;
-    pid->p.ki = ki;
-    pid->p.kd = kd;
-    pid->p.kff = kff;
-    pid->p.limIntegral = limIntegral;
-    pid->p.limSalida = limSalida;
+/***************************************************************************************
+**  Nombre:         void escalarGananciasPID(pid_t *pid, float escala)
+**  Descripcion:    Escala las partes proporcional y derivativa. La integral no se escala
+**                  para que no salte la accion de control
+**  Parametros:     PID, escala
+**  Retorno:        Ninguno
+****************************************************************************************/
+void escalarGananciasPID(pid_t *pid, float escala)
+{
+    pid->escala = escala;
 }
 
 
 /***************************************************************************************
 **  Nombre:         float actualizarPID(pid_t *pid, float setPoint, float sensor, float sensorDerivada, float dt, bool habIntegral)
-**  Descripcion:    Actualiza el PID
+**  Descripcion:    Actualiza el PID. La parte proporcional pondera el setpoint, la derivativa
+**                  se calcula sobre la realimentacion filtrada y el feed-forward sobre la
+**                  derivada del setpoint. La saturacion de la salida descarga la integral
 **  Parametros:     PID, setpoint, realimentacion, derivada de la realimentacion, incremento de tiempo, habilitacion de la parte integral
 **  Retorno:        Accion de control
 ****************************************************************************************/
-float actualizarPID(pid_t *pid, float setPoint, float sensor, float sensorDerivada, float dt, bool habIntegral)
+CODIGO_RAPIDO float actualizarPID(pid_t *pid, float setPoint, float sensor, float sensorDerivada, float dt, bool habIntegral)
 {
-    float salida;
-    float error = setPoint - sensor;
+    const paramPID_t *p = pid->p;
 
-    salida = error * pid->p.kp + pid->integral - sensorDerivada * pid->p.kd + setPoint * pid->p.kff;
+    if (!pid->setPointIniciado) {
+        pid->setPointAnt = setPoint;
+        pid->setPointIniciado = true;
+    }
 
-    if (habIntegral) {
-        float integral = pid->integral + error * dt * pid->p.ki;
-        pid->integral = limitarFloat(integral, -pid->p.limIntegral, pid->p.limIntegral);
+    float derivadaSetPoint = 0.0f;
+    if (dt > 0.0f)
+        derivadaSetPoint = (setPoint - pid->setPointAnt) / dt;
+    pid->setPointAnt = setPoint;
+
+    const float derivada = actualizarFiltroPasaBajo(&pid->filtroD, sensorDerivada);
+    const float feedForward = actualizarFiltroPasaBajo(&pid->filtroFF, derivadaSetPoint) * p->kff;
+    const float proporcional = (setPoint * p->pesoSetpoint - sensor) * p->kp;
+    const float salida = (proporcional - derivada * p->kd) * pid->escala + pid->integral + feedForward;
+
+    pid->u = limitarFloat(salida, -p->limSalida, p->limSalida);
 
+    if (habIntegral) {
+        // Back-calculation: lo que recorta el limite de la salida se resta del integrador
+        const float integral = pid->integral + ((setPoint - sensor) * p->ki + (pid->u - salida) * p->kAntiWindup) * dt;
+        pid->integral = limitarFloat(integral, -p->limIntegral, p->limIntegral);
     }
 
-    return limitarFloat(salida, -pid->p.limSalida, pid->p.limSalida);
+    return pid->u;
+}
+
+
+/***************************************************************************************
+**  Nombre:         void ajustarFiltrosPID(pid_t *pid)
+**  Descripcion:    Reajusta los filtros de la derivada y del feed-forward si ha cambiado su
+**                  frecuencia de corte. Se llama con los motores parados
+**  Parametros:     PID
+**  Retorno:        Ninguno
+****************************************************************************************/
+void ajustarFiltrosPID(pid_t *pid)
+{
+    if (pid->p->frecCorteD == pid->filtroD.frecCorte)
+        return;
+
+    actualizarFrecFiltroPasaBajo(&pid->filtroD, pid->p->frecCorteD);
+    actualizarFrecFiltroPasaBajo(&pid->filtroFF, pid->p->frecCorteD);
 }
 
 
@@ -107,3 +151,20 @@ void resetearIntegralPID(pid_t *pid)
 	pid->integral = 0.0;
 }
 
+
+/***************************************************************************************
+**  Nombre:         void resetearPID(pid_t *pid)
+**  Descripcion:    Resetea la integral, los filtros y el setpoint anterior. El siguiente
+**                  setpoint se toma como anterior para que no salte el feed-forward
+**  Parametros:     PID
+**  Retorno:        Ninguno
+****************************************************************************************/
+void resetearPID(pid_t *pid)
+{
+    pid->integral = 0.0f;
+    pid->setPointAnt = 0.0f;
+    pid->setPointIniciado = false;
+    pid->u = 0.0f;
+    resetearFiltroPasaBajo(&pid->filtroD);
+    resetearFiltroPasaBajo(&pid->filtroFF);
+}
@@ -7,7 +7,7 @@
 **
 **  Autor: Ramon Rico
 **  Fecha de creacion: 07/09/2019
-**  Fecha de modificacion: 19/09/2020
+**  Fecha de modificacion: 17/10/2026
 **
 **  El proyecto URpilot NO es libre. No se puede distribuir y/o modificar este fichero
 **  bajo ningun concepto.
@@ -32,6 +32,7 @@
 #include <stdbool.h>
 
 #include "Sistema/plataforma.h"
+#include "Filtros/filtro_pasa_bajo.h"
 
 
 /***************************************************************************************
@@ -46,15 +47,23 @@ typedef struct {
     float kp;
     float ki;
     float kd;
-    float kff;
+    float kff;              // Feed-forward de la derivada del setpoint
     float limIntegral;
     float limSalida;
+    float pesoSetpoint;     // Peso del setpoint en la parte proporcional (0 a 1)
+    float frecCorteD;       // Hz. Filtro de la derivada y del feed-forward. Con 0 no se filtra
+    float kAntiWindup;      // 1/s. Ganancia del back-calculation. Con 0 solo se limita la integral
 } paramPID_t;
 
 typedef struct {
-	paramPID_t p;
+    const paramPID_t *p;    // Solo se modifican con los motores parados (ver parametros_telemetria.c)
+    float escala;           // Escala de kp y kd (TPA)
     float integral;
-    float u;           // Accion de control
+    float setPointAnt;
+    bool setPointIniciado;  // El primer setpoint tras un reset no genera feed-forward
+    filtroPasaBajo_t filtroD;
+    filtroPasaBajo_t filtroFF;
+    float u;                // Accion de control
 } pid_t;
 
 
@@ -67,9 +76,12 @@ typedef struct {
 /***************************************************************************************
 ** AREA DE PROTOTIPOS DE FUNCION                                                      **
 ****************************************************************************************/
-void iniciarPID(pid_t *pid, float kp, float ki, float kd, float kff, float limIntegral, float limSalida);
+void iniciarPID(pid_t *pid, const paramPID_t *param, float frecMuestreo);
+void escalarGananciasPID(pid_t *pid, float escala);
 float actualizarPID(pid_t *pid, float setPoint, float sensor, float sensorDerivada, float dt, bool habIntegral);
+void ajustarFiltrosPID(pid_t *pid);
 void resetearIntegralPID(pid_t *pid);
+void resetearPID(pid_t *pid);
 
 
 #endif // __PID_H_
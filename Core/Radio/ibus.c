@@ -7,7 +7,7 @@
 **
 **  Autor: Ramon Rico
 **  Fecha de creacion: 10/07/2019
-**  Fecha de modificacion: 03/08/2020
+**  Fecha de modificacion: 17/10/2026
 **
 **  El proyecto URpilot NO es libre. No se puede distribuir y/o modificar este fichero
 **  bajo ningun concepto.
@@ -22,6 +22,7 @@
 **
 ****************************************************************************************/
 
+
 /***************************************************************************************
 ** AREA DE INCLUDES                                                                   **
 ****************************************************************************************/
@@ -30,6 +31,7 @@
 #include "radio.h"
 
 #ifdef USAR_RADIO_UART
+#include "trama_radio.h"
 #include "GP/gp_radio.h"
 #include "Drivers/uart.h"
 #include "Drivers/tiempo.h"
@@ -39,35 +41,45 @@
 ** AREA DE PREPROCESADOR                                                              **
 ****************************************************************************************/
 #define TAMANIO_FRAME_IBUS          32
-#define TAMANIO_FRAME_IBUS_32       8
 #define NUM_CANALES_ENTRADA_IBUS    14
+#define BAUDRATE_IBUS               115200
 
 
 /***************************************************************************************
 ** AREA DE DEFINICION DE TIPOS                                                        **
 ****************************************************************************************/
-typedef struct {
-    bool tramaRecibida;
-    uint8_t buffer[TAMANIO_FRAME_IBUS];
-    uint32_t trama[TAMANIO_FRAME_IBUS_32];  // Buffer 4 veces mas pequeno para optimizacion
-    uint8_t offset;
-    uint32_t tiempoAnterior;
-} ibus_t;
 
 
 /***************************************************************************************
-** AREA DE DECLARACION DE VARIABLES                                                   **
+** AREA DE PROTOTIPOS DE FUNCION                                                      **
 ****************************************************************************************/
-static ibus_t ibus;
+bool iniciarIBUS(void);
+void procesarBloqueIBUS(const uint8_t *datos, uint16_t longitud);
+resultadoTramaRadio_e validarTramaIBUS(const uint8_t *trama);
+void leerIBUS(uint32_t tiempoActual);
+void estadisticasIBUS(estadisticasTramaRadio_t *estadisticas);
 
 
 /***************************************************************************************
-** AREA DE PROTOTIPOS DE FUNCION                                                      **
+** AREA DE DECLARACION DE VARIABLES                                                   **
 ****************************************************************************************/
-bool iniciarIBUS(void);
-void procesarByteIBUS(uint8_t RxByte);
-bool decodificarTramaIBUS(const uint8_t *trama, uint16_t *valores);
-void leerIBUS(uint32_t tiempoActual);
+static receptorTramaRadio_t ibus;
+
+// 14 canales de 12 bits en palabras little endian de 16 bits desde el byte 2. Ya vienen en us
+const protocoloTramaRadio_t protocoloTramaIBUS = {
+    .longitud = TAMANIO_FRAME_IBUS,
+    .byteInicio = 0x20,
+    .numCanales = NUM_CANALES_ENTRADA_IBUS,
+    .offsetDatos = 2,
+    .bitsCanal = 16,
+    .mascaraCanal = 0x0FFF,
+    .escala = 1,
+    .desplEscala = 0,
+    .offsetValor = 0,
+    .bitsPorByte = 10,                      // 8N1
+    .baudrate = BAUDRATE_IBUS,
+    .validarTrama = validarTramaIBUS,
+};
 
 
 /***************************************************************************************
@@ -82,15 +94,15 @@ void leerIBUS(uint32_t tiempoActual);
 ****************************************************************************************/
 bool iniciarIBUS(void)
 {
-    memset(&ibus, 0, sizeof(ibus_t));
+    iniciarReceptorTramaRadio(&ibus, &protocoloTramaIBUS);
 
     // Arrancamos la UART
     configIniUART_t config;
-    config.baudrate = 115200;
+    config.baudrate = BAUDRATE_IBUS;
     config.lWord = UART_LONGITUD_WORD_8;
     config.paridad = UART_NO_PARIDAD;
     config.stop = UART_BIT_STOP_1;
-    if (!iniciarUART(configRadio()->dispUART, config, procesarByteIBUS))
+    if (!iniciarUARTbloques(configRadio()->dispUART, config, procesarBloqueIBUS))
         return false;
 
     return true;
@@ -98,97 +110,74 @@ bool iniciarIBUS(void)
 
 
 /***************************************************************************************
-**  Nombre:         void procesarByteIBUS(uint8_t RxByte)
-**  Descripcion:    Recibe los bytes de la trama IBUs
-**  Parametros:     Byte recibido
+**  Nombre:         void procesarBloqueIBUS(const uint8_t *datos, uint16_t longitud)
+**  Descripcion:    Entrega al receptor los bytes recibidos por la UART
+**  Parametros:     Datos, longitud
 **  Retorno:        Ninguno
 ****************************************************************************************/
-void procesarByteIBUS(uint8_t RxByte)
+CODIGO_RAPIDO void procesarBloqueIBUS(const uint8_t *datos, uint16_t longitud)
 {
-    ibus_t *driver = &ibus;
-
-    uint32_t tiempoActual = microsISR();
-    const bool separacionTrama = (tiempoActual - driver->tiempoAnterior >= 2000U);
-    driver->tiempoAnterior = tiempoActual;
-
-    if (separacionTrama)                         // Si tenemos separacion reseteamos el offset para recibir nueva trama
-    	driver->offset = 0;
-
-    if (RxByte != 0x20 && driver->offset == 0)      // Para ser IBUS el primer byte es 0x20
-        return;
-
-    if (driver->offset == 0 && !separacionTrama) // Debe haber una separacion entre tramas para empezar un nuevo frame
-        return;
-
-    driver->buffer[driver->offset++] = RxByte;
-
-    if (driver->offset == sizeof(driver->buffer)) {
-    	driver->offset = 0;
-    	driver->tramaRecibida = true;
-
-        uint32_t *p = (uint32_t *)driver->buffer;
-        for (uint8_t i = 0; i < TAMANIO_FRAME_IBUS_32; i++) {
-            driver->trama[i] = *p;
-            p++;
-        }
-    }
+    recibirBloqueTramaRadio(&ibus, datos, longitud, microsISR());
 }
 
 
 /***************************************************************************************
-**  Nombre:         bool decodificarTramaIBUS(const uint8_t *trama, uint16_t *valores
-**  Descripcion:    Obtiene los valores de los canales dada una trama
-**  Parametros:     Trama, valores de los canales
-**  Retorno:        True si ok, failsafe
+**  Nombre:         resultadoTramaRadio_e validarTramaIBUS(const uint8_t *trama)
+**  Descripcion:    Comprueba la cabecera y el checksum y decodifica el failsafe
+**  Parametros:     Trama
+**  Retorno:        Resultado de la trama
 ****************************************************************************************/
-bool decodificarTramaIBUS(const uint8_t *trama, uint16_t *valores)
+resultadoTramaRadio_e validarTramaIBUS(const uint8_t *trama)
 {
-    uint32_t checksum = 96;
+    uint16_t checksum = 0xFFFF;
 
     // El inicio de la trama comienza con 0x20, 0x40
     if ((trama[0] != 0x20) || (trama[1] != 0x40))
-        return false;
+        return TRAMA_RADIO_CORRUPTA;
 
-    // Extraemos los datos de la trama
-    for (uint8_t canal = 0, i = 2; canal < NUM_CANALES_ENTRADA_IBUS; canal++, i += 2) {
-        valores[canal] = trama[i] | (trama[i + 1] & 0x0F) << 8;
-        checksum += trama[i] + trama[i + 1];
-    }
+    // El checksum es 0xFFFF menos la suma de todos los bytes anteriores
+    for (uint8_t i = 0; i < TAMANIO_FRAME_IBUS - 2; i++)
+        checksum -= trama[i];
 
-    checksum += trama[TAMANIO_FRAME_IBUS - 2] | trama[TAMANIO_FRAME_IBUS - 1] << 8;
-
-    if (checksum != 0xFFFF)
-        return false;
+    if (checksum != (trama[TAMANIO_FRAME_IBUS - 2] | trama[TAMANIO_FRAME_IBUS - 1] << 8))
+        return TRAMA_RADIO_CORRUPTA;
 
-    if ((trama[3] & 0xF0) || (trama[9] & 0xF0)) { // Failsafe
-        activarFailsafeRadio();
-        return false;
-    }
+    if ((trama[3] & 0xF0) || (trama[9] & 0xF0))     // Failsafe
+        return TRAMA_RADIO_FAILSAFE;
 
-    return true;
+    return TRAMA_RADIO_OK;
 }
 
 
 /***************************************************************************************
 **  Nombre:         void leerIBUS(uint32_t tiempoActual)
-**  Descripcion:    Lee la trama
+**  Descripcion:    Decodifica la ultima trama
 **  Parametros:     Ninguno
 **  Retorno:        Ninguno
 ****************************************************************************************/
 void leerIBUS(uint32_t tiempoActual)
 {
     UNUSED(tiempoActual);
-    ibus_t *driver = &ibus;
+    uint16_t valores[NUM_CANALES_ENTRADA_IBUS];
+    uint32_t tiempoTrama;
 
-    if (!driver->tramaRecibida)
-        return;
+    if (leerTramaRadio(&ibus, valores, &tiempoTrama) == TRAMA_RADIO_OK)
+        anadirRecepcionRadio(NUM_CANALES_ENTRADA_IBUS, valores, tiempoTrama);
+
+    if (ibus.failsafe)
+        activarFailsafeRadio();
+}
 
-    uint16_t valores[NUM_CANALES_ENTRADA_IBUS];
 
-    if (decodificarTramaIBUS((uint8_t *)driver->trama, valores)) {
-    	driver->tramaRecibida = false;
-        anadirRecepcionRadio(NUM_CANALES_ENTRADA_IBUS, valores);
-    }
+/***************************************************************************************
+**  Nombre:         void estadisticasIBUS(estadisticasTramaRadio_t *estadisticas)
+**  Descripcion:    Devuelve las estadisticas de recepcion
+**  Parametros:     Puntero a las estadisticas
+**  Retorno:        Ninguno
+****************************************************************************************/
+void estadisticasIBUS(estadisticasTramaRadio_t *estadisticas)
+{
+    *estadisticas = ibus.estadisticas;
 }
 
 
@@ -199,6 +188,7 @@ void leerIBUS(uint32_t tiempoActual)
 tablaFnRadio_t tablaFnRadioIBUS = {
     iniciarIBUS,
     leerIBUS,
+    estadisticasIBUS,
 };
 
 #endif
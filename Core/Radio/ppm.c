@@ -7,7 +7,7 @@
 **
 **  Autor: Ramon Rico
 **  Fecha de creacion: 10/07/2019
-**  Fecha de modificacion: 20/09/2020
+**  Fecha de modificacion: 17/10/2026
 **
 **  El proyecto URpilot NO es libre. No se puede distribuir y/o modificar este fichero
 **  bajo ningun concepto.
@@ -32,6 +32,7 @@
 #include "Drivers/timer.h"
 #include "Motores/motor.h"
 #include "Drivers/io.h"
+#include "Drivers/tiempo.h"
 #include "Comun/util.h"
 
 
@@ -197,7 +198,8 @@ void edgeCallbackPPM(timerCCHandlerRec_t* cbRec, uint16_t captura)
             for (i = ppm.numCanales; i < NUM_CANALES_PPM; i++)
                 capturasPPM[i] = 0;
 
-            anadirRecepcionRadio(ppm.numCanales, capturasPPM);
+            // El pulso de sincronismo marca el final de la trama
+            anadirRecepcionRadio(ppm.numCanales, capturasPPM, microsISR());
         }
 
         ppm.tracking = true;
@@ -272,6 +274,7 @@ void resetearPPM(void)
 tablaFnRadio_t tablaFnRadioPPM = {
     iniciarPPM,
     leerPPM,
+    NULL,
 };
 
 #endif
@@ -7,7 +7,7 @@
 **
 **  Autor: Ramon Rico
 **  Fecha de creacion: 10/07/2019
-**  Fecha de modificacion: 20/09/2020
+**  Fecha de modificacion: 17/10/2026
 **
 **  El proyecto URpilot NO es libre. No se puede distribuir y/o modificar este fichero
 **  bajo ningun concepto.
@@ -57,6 +57,13 @@ static radio_t radio;
 static tablaFnRadio_t *tablaFnRadio;
 static bool failsafeExtRadio = false;
 
+// Latencia de los canales hasta el mixer
+static latenciaRadio_t latencia;
+static uint64_t sumaLatencias;
+static uint32_t contadorEntradaUsada;
+static uint32_t tiempoTramaUsada;
+static bool latenciaPendiente;
+
 
 /***************************************************************************************
 ** AREA DE PROTOTIPOS DE FUNCION                                                      **
@@ -84,6 +91,9 @@ bool iniciarRadio(void)
     for (uint8_t i = 0; i < NUM_MAX_CANALES_RADIO; i++)
     	radio.canales[i] = VALOR_MEDIO_RADIO;
 
+    contadorEntradaUsada = 0;
+    resetearLatenciaRadio();
+
     switch (configRadio()->protocolo) {
 #ifdef USAR_RADIO_PPM
         case RX_PPM:
@@ -138,15 +148,6 @@ bool iniciarDriverRadio(void)
 }
 
 
-#include "Sensores/IMU/imu.h"
-#include "Drivers/tiempo.h"
-extern reaction_t reaction;
-extern uint32_t rTimeMax;
-extern uint32_t rTimeMin;
-extern uint32_t rTime1;
-extern bool cambiarID;
-extern bool iniR;
-
 /***************************************************************************************
 **  Nombre:         void leerRadio(uint32_t tiempoActual)
 **  Descripcion:    Lee la radio y actualiza los canales
@@ -155,21 +156,6 @@ extern bool iniR;
 ****************************************************************************************/
 void leerRadio(uint32_t tiempoActual)
 {
-
-
-    if (reaction.id == 'C') {
-    	cambiarID = true;
-
-		rTime1 = micros() - reaction.tiempo;
-		if (rTime1 > rTimeMax)
-			rTimeMax = rTime1;
-
-		if (rTime1 < rTimeMin)
-			rTimeMin = rTime1;
-    }
-
-
-
     radio.nuevaEntrada = false;
 
     if (radio.iniciada) {
@@ -187,16 +173,20 @@ void leerRadio(uint32_t tiempoActual)
 
 
 /***************************************************************************************
-**  Nombre:         void anadirRecepcionRadio(uint8_t numValores, uint16_t *valores)
+**  Nombre:         void anadirRecepcionRadio(uint8_t numValores, uint16_t *valores,
+**                                            uint32_t tiempoTrama)
 **  Descripcion:    Anade una nueva recepcion de datos de radio
-**  Parametros:     Numero de canales recibidos, valores de los canales, failsafe
+**  Parametros:     Numero de canales recibidos, valores de los canales, instante del final
+**                  de la trama en us
 **  Retorno:        Ninguno
 ****************************************************************************************/
-void anadirRecepcionRadio(uint8_t numValores, uint16_t *valores)
+void anadirRecepcionRadio(uint8_t numValores, uint16_t *valores, uint32_t tiempoTrama)
 {
     numValores = MIN(numValores, NUM_MAX_CANALES_RADIO);
     memcpy(radio.canales, valores, numValores * sizeof(uint16_t));
 
+    radio.tiempoTrama = tiempoTrama;
+
     radio.numCanales = numValores;
     radio.contadorEntradas++;
 }
@@ -337,4 +327,97 @@ void canalesRadio(uint16_t *canales)
     canales = radio.canales;
 }
 
+
+/***************************************************************************************
+**  Nombre:         void registrarUsoRadio(void)
+**  Descripcion:    Indica que las referencias se han generado con los canales actuales. La
+**                  latencia se cierra en la siguiente salida del mixer
+**  Parametros:     Ninguno
+**  Retorno:        Ninguno
+****************************************************************************************/
+void registrarUsoRadio(void)
+{
+    // Cada entrada se mide una sola vez aunque el RC la use en varios ciclos
+    if (contadorEntradaUsada == radio.ultimoContadorEntradas)
+        return;
+
+    contadorEntradaUsada = radio.ultimoContadorEntradas;
+    tiempoTramaUsada = radio.tiempoTrama;
+    latenciaPendiente = true;
+}
+
+
+/***************************************************************************************
+**  Nombre:         void registrarSalidaMixerRadio(uint32_t tiempoActual)
+**  Descripcion:    Actualiza las estadisticas de latencia si el mixer ha usado una nueva
+**                  entrada de la radio
+**  Parametros:     Instante de la salida del mixer en us
+**  Retorno:        Ninguno
+****************************************************************************************/
+CODIGO_RAPIDO void registrarSalidaMixerRadio(uint32_t tiempoActual)
+{
+    if (!latenciaPendiente)
+        return;
+
+    const uint32_t muestra = tiempoActual - tiempoTramaUsada;
+
+    latenciaPendiente = false;
+    latencia.ultima = muestra;
+
+    if (latencia.numMuestras == 0 || muestra < latencia.minima)
+        latencia.minima = muestra;
+
+    if (muestra > latencia.maxima)
+        latencia.maxima = muestra;
+
+    latencia.numMuestras++;
+    sumaLatencias += muestra;
+}
+
+
+/***************************************************************************************
+**  Nombre:         void latenciaRadio(latenciaRadio_t *latenciaCanales)
+**  Descripcion:    Devuelve las estadisticas de latencia desde el final de la trama hasta
+**                  el mixer
+**  Parametros:     Puntero a las estadisticas
+**  Retorno:        Ninguno
+****************************************************************************************/
+void latenciaRadio(latenciaRadio_t *latenciaCanales)
+{
+    *latenciaCanales = latencia;
+
+    if (latencia.numMuestras > 0)
+        latenciaCanales->media = sumaLatencias / latencia.numMuestras;
+}
+
+
+/***************************************************************************************
+**  Nombre:         void resetearLatenciaRadio(void)
+**  Descripcion:    Resetea las estadisticas de latencia
+**  Parametros:     Ninguno
+**  Retorno:        Ninguno
+****************************************************************************************/
+void resetearLatenciaRadio(void)
+{
+    memset(&latencia, 0, sizeof(latenciaRadio_t));
+    sumaLatencias = 0;
+    latenciaPendiente = false;
+}
+
+
+/***************************************************************************************
+**  Nombre:         bool estadisticasTramasRadio(estadisticasTramaRadio_t *estadisticas)
+**  Descripcion:    Devuelve las estadisticas de recepcion de los protocolos por tramas
+**  Parametros:     Puntero a las estadisticas
+**  Retorno:        True si el protocolo tiene estadisticas
+****************************************************************************************/
+bool estadisticasTramasRadio(estadisticasTramaRadio_t *estadisticas)
+{
+    if (!radio.iniciada || tablaFnRadio->estadisticasRadio == NULL)
+        return false;
+
+    tablaFnRadio->estadisticasRadio(estadisticas);
+    return true;
+}
+
 #endif
@@ -7,7 +7,7 @@
 **
 **  Autor: Ramon Rico
 **  Fecha de creacion: 10/07/2019
-**  Fecha de modificacion: 20/09/2020
+**  Fecha de modificacion: 17/10/2026
 **
 **  El proyecto URpilot NO es libre. No se puede distribuir y/o modificar este fichero
 **  bajo ningun concepto.
@@ -35,6 +35,7 @@
 #include "GP/gp.h"
 #include "Drivers/uart.h"
 #include "Drivers/timer.h"
+#include "trama_radio.h"
 
 
 /***************************************************************************************
@@ -78,11 +79,22 @@ typedef struct {
     bool iniciada;
     bool nuevaEntrada;
     uint32_t ultimaMedida;
+    uint32_t tiempoTrama;                   // Instante del final de la trama de los canales actuales
 } radio_t;
 
+// Latencia desde el final de la trama hasta la salida del mixer que la usa
+typedef struct {
+    uint32_t numMuestras;
+    uint32_t ultima;                        // us
+    uint32_t minima;
+    uint32_t maxima;
+    uint32_t media;
+} latenciaRadio_t;
+
 typedef struct {
     bool (*iniciarRadio)(void);
     void (*leerRadio)(uint32_t tiempoActual);
+    void (*estadisticasRadio)(estadisticasTramaRadio_t *estadisticas);     // NULL si el protocolo no va por tramas
 } tablaFnRadio_t;
 
 
@@ -99,7 +111,7 @@ extern tablaFnRadio_t tablaFnRadioSBUS;
 ****************************************************************************************/
 bool iniciarRadio(void);
 void leerRadio(uint32_t tiempoActual);
-void anadirRecepcionRadio(uint8_t numValores, uint16_t *valores);
+void anadirRecepcionRadio(uint8_t numValores, uint16_t *valores, uint32_t tiempoTrama);
 bool radioOperativa(void);
 bool radioEnFailsafe(void);
 void activarFailsafeRadio(void);
@@ -107,5 +119,10 @@ void desactivarFailsafeRadio(void);
 bool nuevaEntradaRadioValida(void);
 uint16_t canalRadio(uint8_t canal);
 void canalesRadio(uint16_t *canales);
+void registrarUsoRadio(void);
+void registrarSalidaMixerRadio(uint32_t tiempoActual);
+void latenciaRadio(latenciaRadio_t *latencia);
+void resetearLatenciaRadio(void);
+bool estadisticasTramasRadio(estadisticasTramaRadio_t *estadisticas);
 
 #endif // __RADIO_H_
@@ -0,0 +1,244 @@
+/***************************************************************************************
+**  trama_radio.c - Recepcion por tramas de los protocolos serie de radio (SBUS, IBUS)
+**
+**
+**  Este fichero forma parte del proyecto URpilot.
+**  Codigo desarrollado por el grupo de investigacion ICON de la Universidad de La Rioja
+**
+**  Autor: Ramon Rico
+**  Fecha de creacion: 17/10/2026
+**  Fecha de modificacion: 17/10/2026
+**
+**  El proyecto URpilot NO es libre. No se puede distribuir y/o modificar este fichero
+**  bajo ningun concepto.
+**
+**  En caso de modificacion y/o solicitud de informacion pongase en contacto con
+**  el grupo de investigacion ICON a traves de: www.unirioja.es/urpilot
+**
+**
+**  Control de versiones del fichero
+**
+**  v1.0  Ramon Rico. Se ha liberado la primera version estable
+**
+****************************************************************************************/
+
+/***************************************************************************************
+** AREA DE INCLUDES                                                                   **
+****************************************************************************************/
+#include <string.h>
+
+#include "trama_radio.h"
+#include "radio.h"
+
+#ifdef USAR_RADIO_UART
+#ifndef SITL
+#include "Drivers/atomico.h"
+#include "Drivers/nvic.h"
+#endif
+
+
+/***************************************************************************************
+** AREA DE PREPROCESADOR                                                              **
+****************************************************************************************/
+// La trama se cierra en la interrupcion de la UART y se lee desde el scheduler
+#ifdef SITL
+  #define BLOQUE_ATOMICO_TRAMA_RADIO
+#else
+  #define BLOQUE_ATOMICO_TRAMA_RADIO    BLOQUE_ATOMICO(NVIC_PRIO_SERIALUART7)
+#endif
+
+
+/***************************************************************************************
+** AREA DE DEFINICION DE TIPOS                                                        **
+****************************************************************************************/
+
+
+/***************************************************************************************
+** AREA DE DECLARACION DE VARIABLES                                                   **
+****************************************************************************************/
+
+
+/***************************************************************************************
+** AREA DE PROTOTIPOS DE FUNCION                                                      **
+****************************************************************************************/
+void cerrarTramaRadio(receptorTramaRadio_t *receptor, uint32_t tiempoUs);
+
+
+/***************************************************************************************
+** AREA DE DEFINICION DE FUNCIONES                                                    **
+****************************************************************************************/
+
+/***************************************************************************************
+**  Nombre:         void iniciarReceptorTramaRadio(receptorTramaRadio_t *receptor,
+**                                                 const protocoloTramaRadio_t *protocolo)
+**  Descripcion:    Resetea el receptor y calcula la tabla de posiciones de los canales
+**  Parametros:     Receptor, descripcion del protocolo
+**  Retorno:        Ninguno
+****************************************************************************************/
+void iniciarReceptorTramaRadio(receptorTramaRadio_t *receptor, const protocoloTramaRadio_t *protocolo)
+{
+    memset(receptor, 0, sizeof(receptorTramaRadio_t));
+
+    receptor->protocolo = protocolo;
+    receptor->nsPorByte = (uint32_t)((protocolo->bitsPorByte * 1000000000ULL) / protocolo->baudrate);
+
+    // La primera trama no necesita separacion
+    receptor->separacion = true;
+
+    for (uint8_t canal = 0; canal < protocolo->numCanales && canal < NUM_MAX_CANALES_TRAMA_RADIO; canal++) {
+        const uint16_t bit = canal * protocolo->bitsCanal;
+
+        receptor->byteCanal[canal] = protocolo->offsetDatos + (bit >> 3);
+        receptor->desplCanal[canal] = bit & 0x07;
+    }
+}
+
+
+/***************************************************************************************
+**  Nombre:         void recibirBloqueTramaRadio(receptorTramaRadio_t *receptor,
+**                                               const uint8_t *datos, uint16_t longitud,
+**                                               uint32_t tiempoUs)
+**  Descripcion:    Ensambla las tramas con un bloque contiguo de la UART. La separacion entre
+**                  tramas se mide una vez por bloque: el primer byte del bloque llego
+**                  (longitud - 1) bytes antes del instante de recepcion
+**  Parametros:     Receptor, datos, longitud, instante de llegada del ultimo byte en us
+**  Retorno:        Ninguno
+****************************************************************************************/
+CODIGO_RAPIDO void recibirBloqueTramaRadio(receptorTramaRadio_t *receptor, const uint8_t *datos, uint16_t longitud, uint32_t tiempoUs)
+{
+    const protocoloTramaRadio_t *protocolo = receptor->protocolo;
+
+    if (longitud == 0)
+        return;
+
+    const uint32_t inicioBloque = tiempoUs - ((longitud - 1) * receptor->nsPorByte) / 1000;
+
+    if (inicioBloque - receptor->tiempoUltimoByte >= SEPARACION_TRAMA_RADIO) {
+        if (receptor->offset > 0) {
+            receptor->estadisticas.numResincronizaciones++;
+            receptor->offset = 0;
+        }
+
+        receptor->separacion = true;
+    }
+
+    receptor->tiempoUltimoByte = tiempoUs;
+
+    uint8_t *buffer = receptor->buffer[receptor->indiceEscritura];
+
+    for (uint16_t i = 0; i < longitud; i++) {
+        // Las tramas empiezan con el byte de inicio justo despues de una separacion
+        if (receptor->offset == 0) {
+            const bool inicio = receptor->separacion && datos[i] == protocolo->byteInicio;
+
+            receptor->separacion = false;
+            if (!inicio) {
+                receptor->estadisticas.numBytesDescartados++;
+                continue;
+            }
+        }
+
+        buffer[receptor->offset++] = datos[i];
+
+        if (receptor->offset == protocolo->longitud) {
+            cerrarTramaRadio(receptor, tiempoUs - ((longitud - 1 - i) * receptor->nsPorByte) / 1000);
+            buffer = receptor->buffer[receptor->indiceEscritura];
+        }
+    }
+}
+
+
+/***************************************************************************************
+**  Nombre:         void cerrarTramaRadio(receptorTramaRadio_t *receptor, uint32_t tiempoUs)
+**  Descripcion:    Publica la trama completa y cambia de buffer. La siguiente trama tarda mas
+**                  que la separacion en llegar, asi que el buffer publicado no se reescribe
+**                  mientras se lee
+**  Parametros:     Receptor, instante del ultimo byte
+**  Retorno:        Ninguno
+****************************************************************************************/
+CODIGO_RAPIDO void cerrarTramaRadio(receptorTramaRadio_t *receptor, uint32_t tiempoUs)
+{
+    receptor->offset = 0;
+    receptor->estadisticas.numTramas++;
+
+    if (receptor->tramaLista)
+        receptor->estadisticas.numTramasSobrescritas++;
+
+    receptor->indiceLectura = receptor->indiceEscritura;
+    receptor->indiceEscritura ^= 1;
+    receptor->tiempoTrama = tiempoUs;
+    receptor->tramaLista = true;
+}
+
+
+/***************************************************************************************
+**  Nombre:         resultadoTramaRadio_e leerTramaRadio(receptorTramaRadio_t *receptor,
+**                                                       uint16_t *valores, uint32_t *tiempoTrama)
+**  Descripcion:    Valida y decodifica la ultima trama recibida
+**  Parametros:     Receptor, valores de los canales, instante del final de la trama
+**  Retorno:        Resultado. Los valores solo se escriben si es TRAMA_RADIO_OK
+****************************************************************************************/
+resultadoTramaRadio_e leerTramaRadio(receptorTramaRadio_t *receptor, uint16_t *valores, uint32_t *tiempoTrama)
+{
+    const uint8_t *trama;
+    uint32_t tiempo;
+
+    if (!receptor->tramaLista)
+        return TRAMA_RADIO_NINGUNA;
+
+    BLOQUE_ATOMICO_TRAMA_RADIO {
+        trama = receptor->buffer[receptor->indiceLectura];
+        tiempo = receptor->tiempoTrama;
+        receptor->tramaLista = false;
+    }
+
+    const resultadoTramaRadio_e resultado = receptor->protocolo->validarTrama(trama);
+
+    switch (resultado) {
+        case TRAMA_RADIO_OK:
+            receptor->estadisticas.numTramasValidas++;
+            receptor->failsafe = false;
+            decodificarCanalesTramaRadio(receptor, trama, valores);
+            *tiempoTrama = tiempo;
+            break;
+
+        case TRAMA_RADIO_PERDIDA:
+            receptor->estadisticas.numTramasPerdidas++;
+            break;
+
+        case TRAMA_RADIO_FAILSAFE:
+            receptor->estadisticas.numTramasFailsafe++;
+            receptor->failsafe = true;
+            break;
+
+        default:
+            receptor->estadisticas.numTramasCorruptas++;
+            break;
+    }
+
+    return resultado;
+}
+
+
+/***************************************************************************************
+**  Nombre:         void decodificarCanalesTramaRadio(const receptorTramaRadio_t *receptor,
+**                                                    const uint8_t *trama, uint16_t *valores)
+**  Descripcion:    Extrae todos los canales en una pasada con la tabla de posiciones. Cada
+**                  canal ocupa como mucho 3 bytes
+**  Parametros:     Receptor, trama, valores de los canales
+**  Retorno:        Ninguno
+****************************************************************************************/
+CODIGO_RAPIDO void decodificarCanalesTramaRadio(const receptorTramaRadio_t *receptor, const uint8_t *trama, uint16_t *valores)
+{
+    const protocoloTramaRadio_t *protocolo = receptor->protocolo;
+
+    for (uint8_t canal = 0; canal < protocolo->numCanales; canal++) {
+        const uint8_t *p = &trama[receptor->byteCanal[canal]];
+        const uint32_t palabra = p[0] | (p[1] << 8) | (p[2] << 16);
+        const uint32_t bruto = (palabra >> receptor->desplCanal[canal]) & protocolo->mascaraCanal;
+
+        valores[canal] = ((bruto * protocolo->escala) >> protocolo->desplEscala) + protocolo->offsetValor;
+    }
+}
+
+#endif
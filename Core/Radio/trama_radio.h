@@ -0,0 +1,120 @@
+/***************************************************************************************
+**  trama_radio.h - Recepcion por tramas de los protocolos serie de radio (SBUS, IBUS)
+**
+**
+**  Este fichero forma parte del proyecto URpilot.
+**  Codigo desarrollado por el grupo de investigacion ICON de la Universidad de La Rioja
+**
+**  Autor: Ramon Rico
+**  Fecha de creacion: 17/10/2026
+**  Fecha de modificacion: 17/10/2026
+**
+**  El proyecto URpilot NO es libre. No se puede distribuir y/o modificar este fichero
+**  bajo ningun concepto.
+**
+**  En caso de modificacion y/o solicitud de informacion pongase en contacto con
+**  el grupo de investigacion ICON a traves de: www.unirioja.es/urpilot
+**
+**
+**  Control de versiones del fichero
+**
+**  v1.0  Ramon Rico. Se ha liberado la primera version estable
+**
+****************************************************************************************/
+
+#ifndef __TRAMA_RADIO_H
+#define __TRAMA_RADIO_H
+
+/***************************************************************************************
+** AREA DE INCLUDES                                                                   **
+****************************************************************************************/
+#include <stdint.h>
+#include <stdbool.h>
+
+
+/***************************************************************************************
+** AREA DE PREPROCESADOR                                                              **
+****************************************************************************************/
+#define TAM_MAX_TRAMA_RADIO             32          // IBUS
+#define NUM_MAX_CANALES_TRAMA_RADIO     16          // SBUS
+#define SEPARACION_TRAMA_RADIO          2000        // us de silencio minimo antes de una trama
+
+
+/***************************************************************************************
+** AREA DE DEFINICION DE TIPOS                                                        **
+****************************************************************************************/
+typedef enum {
+    TRAMA_RADIO_NINGUNA = 0,
+    TRAMA_RADIO_OK,
+    TRAMA_RADIO_CORRUPTA,
+    TRAMA_RADIO_PERDIDA,                    // El receptor indica que no ha recibido la trama de la emisora
+    TRAMA_RADIO_FAILSAFE,
+} resultadoTramaRadio_e;
+
+// Los canales son campos de bits little endian separados bitsCanal bits a partir de offsetDatos:
+// valor = (((bruto & mascaraCanal) * escala) >> desplEscala) + offsetValor
+typedef struct {
+    uint8_t longitud;
+    uint8_t byteInicio;
+    uint8_t numCanales;
+    uint8_t offsetDatos;
+    uint8_t bitsCanal;
+    uint16_t mascaraCanal;
+    uint16_t escala;
+    uint8_t desplEscala;
+    uint16_t offsetValor;
+    uint8_t bitsPorByte;                    // Bits en la linea por byte (inicio, datos, paridad y stop)
+    uint32_t baudrate;
+    resultadoTramaRadio_e (*validarTrama)(const uint8_t *trama);
+} protocoloTramaRadio_t;
+
+typedef struct {
+    uint32_t numTramas;                     // Tramas completas recibidas
+    uint32_t numTramasValidas;
+    uint32_t numTramasCorruptas;
+    uint32_t numTramasPerdidas;
+    uint32_t numTramasFailsafe;
+    uint32_t numTramasSobrescritas;         // Llegan antes de leer la anterior
+    uint32_t numResincronizaciones;         // Tramas incompletas descartadas por una separacion
+    uint32_t numBytesDescartados;
+} estadisticasTramaRadio_t;
+
+typedef struct {
+    const protocoloTramaRadio_t *protocolo;
+    uint8_t byteCanal[NUM_MAX_CANALES_TRAMA_RADIO];
+    uint8_t desplCanal[NUM_MAX_CANALES_TRAMA_RADIO];
+    uint32_t nsPorByte;
+
+    // Ensamblado en la interrupcion. Se alternan dos buffers para no copiar la trama
+    uint8_t buffer[2][TAM_MAX_TRAMA_RADIO];
+    uint8_t indiceEscritura;
+    uint8_t offset;
+    bool separacion;                        // Se puede empezar una trama
+    uint32_t tiempoUltimoByte;
+
+    // Ultima trama completa
+    volatile bool tramaLista;
+    uint8_t indiceLectura;
+    uint32_t tiempoTrama;                   // Instante del ultimo byte en us
+    bool failsafe;                          // Se mantiene hasta la siguiente trama valida
+
+    estadisticasTramaRadio_t estadisticas;
+} receptorTramaRadio_t;
+
+
+/***************************************************************************************
+** AREA DE DECLARACION DE VARIABLES                                                   **
+****************************************************************************************/
+extern const protocoloTramaRadio_t protocoloTramaSBUS;
+extern const protocoloTramaRadio_t protocoloTramaIBUS;
+
+
+/***************************************************************************************
+** AREA DE PROTOTIPOS DE FUNCION                                                      **
+****************************************************************************************/
+void iniciarReceptorTramaRadio(receptorTramaRadio_t *receptor, const protocoloTramaRadio_t *protocolo);
+void recibirBloqueTramaRadio(receptorTramaRadio_t *receptor, const uint8_t *datos, uint16_t longitud, uint32_t tiempoUs);
+resultadoTramaRadio_e leerTramaRadio(receptorTramaRadio_t *receptor, uint16_t *valores, uint32_t *tiempoTrama);
+void decodificarCanalesTramaRadio(const receptorTramaRadio_t *receptor, const uint8_t *trama, uint16_t *valores);
+
+#endif // __TRAMA_RADIO_H
@@ -7,7 +7,7 @@
 **
 **  Autor: Ramon Rico
 **  Fecha de creacion: 12/05/2019
-**  Fecha de modificacion: 03/08/2020
+**  Fecha de modificacion: 17/10/2026
 **
 **  El proyecto URpilot NO es libre. No se puede distribuir y/o modificar este fichero
 **  bajo ningun concepto.
@@ -43,6 +43,14 @@
 /***************************************************************************************
 ** AREA DE DEFINICION DE TIPOS                                                        **
 ****************************************************************************************/
+#if defined(USAR_SCHEDULER_EDF)
+// Monticulo binario de minimos. Las comparaciones de tiempo soportan el desbordamiento de micros()
+typedef struct {
+    tarea_t *tareas[TAREA_CONTADOR];
+    uint8_t tam;
+    bool porDeadline;                    // Clave: deadline si true, liberacion si false
+} monticuloEDF_t;
+#endif
 
 
 /***************************************************************************************
@@ -59,6 +67,11 @@ static RAM_RAPIDA uint8_t porcentajeCargaSistema = 0;
 
 static bool bitVidaScheduler = false;
 
+#if defined(USAR_SCHEDULER_EDF)
+static RAM_RAPIDA monticuloEDF_t tareasEsperandoEDF = { .porDeadline = false };   // Ordenadas por liberacion
+static RAM_RAPIDA monticuloEDF_t tareasListasEDF = { .porDeadline = true };       // Ordenadas por deadline
+#endif
+
 
 /***************************************************************************************
 ** AREA DE PROTOTIPOS DE FUNCION                                                      **
@@ -68,6 +81,17 @@ bool tareaEnCola(tarea_t *tarea);
 tarea_t *primeraTareaCola(void);
 tarea_t *siguienteTareaCola(void);
 void actualizarBitVidaScheduler(colorRGB_e color);
+void ejecutarTareaTiempoReal(tarea_t *tarea, uint32_t tiempoActual);
+#if defined(USAR_ESTADISTICAS_TAREAS)
+void perfilarTarea(tarea_t *tarea, uint32_t ciclos);
+uint32_t percentilHistCiclos(const tarea_t *tarea, uint8_t percentil);
+#endif
+#if defined(USAR_SCHEDULER_EDF)
+void insertarMonticuloEDF(monticuloEDF_t *monticulo, tarea_t *tarea);
+tarea_t *extraerMonticuloEDF(monticuloEDF_t *monticulo);
+void quitarMonticuloEDF(monticuloEDF_t *monticulo, tarea_t *tarea);
+int32_t despacharTareasEDF(void);
+#endif
 
 
 /***************************************************************************************
@@ -85,6 +109,11 @@ void limpiarColaTareas(void)
     memset(colaTareas, 0, sizeof(colaTareas));
     posColaTareas = 0;
     tamColaTareas = 0;
+
+#if defined(USAR_SCHEDULER_EDF)
+    tareasEsperandoEDF.tam = 0;
+    tareasListasEDF.tam = 0;
+#endif
 }
 
 
@@ -106,6 +135,15 @@ bool anadirTareaEnCola(tarea_t *tarea)
             memmove(&colaTareas[i + 1], &colaTareas[i], sizeof(tarea) * (tamColaTareas - i));
             colaTareas[i] = tarea;
             tamColaTareas++;
+
+            // Las tareas en tiempo real quedan listas desde este instante. Su primer deadline es un periodo despues
+            if (tarea->prioridadEstatica == PRIORIDAD_TIEMPO_REAL) {
+                tarea->ultimoTiempoEjec = micros() - tarea->periodo;
+#if defined(USAR_SCHEDULER_EDF)
+                tarea->liberacion = tarea->ultimoTiempoEjec + tarea->periodo;
+                insertarMonticuloEDF(&tareasEsperandoEDF, tarea);
+#endif
+            }
             return true;
         }
     }
@@ -125,6 +163,13 @@ bool quitarTareaDeCola(tarea_t *tarea)
         if (colaTareas[i] == tarea) {
             memmove(&colaTareas[i], &colaTareas[i+1], sizeof(tarea) * (tamColaTareas - i));
             --tamColaTareas;
+
+#if defined(USAR_SCHEDULER_EDF)
+            if (tarea->prioridadEstatica == PRIORIDAD_TIEMPO_REAL) {
+                quitarMonticuloEDF(&tareasEsperandoEDF, tarea);
+                quitarMonticuloEDF(&tareasListasEDF, tarea);
+            }
+#endif
             return true;
         }
     }
@@ -294,6 +339,23 @@ void infoTarea(idTarea_e idTarea, infoTarea_t * infoTarea)
     infoTarea->tiempoEjecucionTotal = tareas[idTarea].tiempoEjecucionTotal;
     infoTarea->tiempoEjecucionMedio = tareas[idTarea].sumaMovTiempoEjec / NUM_MUESTRAS_SUMA_SCHEDULER;
     infoTarea->ultimoPeriodo = tareas[idTarea].ultimoPeriodoEjec;
+    infoTarea->deadlinesPerdidos = tareas[idTarea].deadlinesPerdidos;
+    infoTarea->retrasoMaxDeadline = tareas[idTarea].retrasoMaxDeadline;
+
+#if defined(USAR_ESTADISTICAS_TAREAS)
+    const tarea_t *tarea = &tareas[idTarea];
+    infoTarea->ciclosMin = tarea->ciclosMin;
+    infoTarea->ciclosMax = tarea->ciclosMax;
+    infoTarea->ciclosMedio = tarea->numEjecuciones > 0 ? tarea->ciclosTotal / tarea->numEjecuciones : 0;
+    infoTarea->ciclosP50 = percentilHistCiclos(tarea, 50);
+    infoTarea->ciclosP99 = percentilHistCiclos(tarea, 99);
+#else
+    infoTarea->ciclosMin = 0;
+    infoTarea->ciclosMax = 0;
+    infoTarea->ciclosMedio = 0;
+    infoTarea->ciclosP50 = 0;
+    infoTarea->ciclosP99 = 0;
+#endif
 }
 
 
@@ -305,18 +367,28 @@ void infoTarea(idTarea_e idTarea, infoTarea_t * infoTarea)
 ****************************************************************************************/
 void resetearEstadisticasTarea(idTarea_e idTarea)
 {
+    tarea_t *tarea = NULL;
+
+    if (idTarea == TASK_SELF)
+        tarea = tareaActual;
+    else if (idTarea < TAREA_CONTADOR)
+        tarea = &tareas[idTarea];
+
+    if (tarea == NULL)
+        return;
+
 #if defined(USAR_ESTADISTICAS_TAREAS)
-    if (idTarea == TASK_SELF) {
-        tareaActual->sumaMovTiempoEjec = 0;
-        tareaActual->tiempoEjecucionTotal = 0;
-        tareaActual->tiempoMaxEjecucion = 0;
-    }
-    else if (idTarea < TAREA_CONTADOR) {
-        tareas[idTarea].sumaMovTiempoEjec = 0;
-        tareas[idTarea].tiempoEjecucionTotal = 0;
-        tareas[idTarea].tiempoMaxEjecucion = 0;
-    }
+    tarea->sumaMovTiempoEjec = 0;
+    tarea->tiempoEjecucionTotal = 0;
+    tarea->tiempoMaxEjecucion = 0;
+    tarea->ciclosMin = 0;
+    tarea->ciclosMax = 0;
+    tarea->ciclosTotal = 0;
+    tarea->numEjecuciones = 0;
+    memset(tarea->histCiclos, 0, sizeof(tarea->histCiclos));
 #endif
+    tarea->deadlinesPerdidos = 0;
+    tarea->retrasoMaxDeadline = 0;
 }
 
 
@@ -337,6 +409,105 @@ void resetearTiempoMaxEjecTarea(idTarea_e idTarea)
 }
 
 
+/***************************************************************************************
+**  Nombre:         uint32_t percentilCiclosTarea(idTarea_e idTarea, uint8_t percentil)
+**  Descripcion:    Retorna un percentil de los ciclos de ejecucion de una tarea
+**  Parametros:     Tarea, percentil (1 - 100)
+**  Retorno:        Cota superior de los ciclos del percentil
+****************************************************************************************/
+uint32_t percentilCiclosTarea(idTarea_e idTarea, uint8_t percentil)
+{
+#if defined(USAR_ESTADISTICAS_TAREAS)
+    if (idTarea == TASK_SELF)
+        return percentilHistCiclos(tareaActual, percentil);
+    else if (idTarea < TAREA_CONTADOR)
+        return percentilHistCiclos(&tareas[idTarea], percentil);
+#else
+    UNUSED(idTarea);
+    UNUSED(percentil);
+#endif
+    return 0;
+}
+
+
+#if defined(USAR_ESTADISTICAS_TAREAS)
+/***************************************************************************************
+**  Nombre:         void perfilarTarea(tarea_t *tarea, uint32_t ciclos)
+**  Descripcion:    Anade una ejecucion al perfil en ciclos de la tarea
+**  Parametros:     Tarea, ciclos consumidos
+**  Retorno:        Ninguno
+****************************************************************************************/
+CODIGO_RAPIDO void perfilarTarea(tarea_t *tarea, uint32_t ciclos)
+{
+    uint32_t cubeta;
+
+    if (tarea->numEjecuciones == 0 || ciclos < tarea->ciclosMin)
+        tarea->ciclosMin = ciclos;
+
+    tarea->ciclosMax = MAX(tarea->ciclosMax, ciclos);
+    tarea->ciclosTotal += ciclos;
+    tarea->numEjecuciones++;
+
+    // Las 4 primeras cubetas son exactas. Despues 4 por octava con los 2 bits siguientes al mas alto
+    if (ciclos < 4)
+        cubeta = ciclos;
+    else {
+        const uint32_t msb = 31 - __builtin_clz(ciclos);
+        cubeta = (msb - 1) * 4 + ((ciclos >> (msb - 2)) & 0x03);
+        if (cubeta >= NUM_CUBETAS_PERFIL_TAREA)
+            cubeta = NUM_CUBETAS_PERFIL_TAREA - 1;
+    }
+
+    // Al saturar una cubeta se divide el histograma para que pesen mas las ejecuciones recientes
+    if (tarea->histCiclos[cubeta] == UINT16_MAX) {
+        for (uint8_t i = 0; i < NUM_CUBETAS_PERFIL_TAREA; i++)
+            tarea->histCiclos[i] >>= 1;
+    }
+
+    tarea->histCiclos[cubeta]++;
+}
+
+
+/***************************************************************************************
+**  Nombre:         uint32_t percentilHistCiclos(const tarea_t *tarea, uint8_t percentil)
+**  Descripcion:    Busca un percentil en el histograma de ciclos de la tarea
+**  Parametros:     Tarea, percentil (1 - 100)
+**  Retorno:        Cota superior de los ciclos del percentil
+****************************************************************************************/
+uint32_t percentilHistCiclos(const tarea_t *tarea, uint8_t percentil)
+{
+    uint32_t total = 0;
+    uint32_t acumulado = 0;
+
+    if (tarea == NULL)
+        return 0;
+
+    for (uint8_t i = 0; i < NUM_CUBETAS_PERFIL_TAREA; i++)
+        total += tarea->histCiclos[i];
+
+    if (total == 0)
+        return 0;
+
+    const uint32_t objetivo = (total * MIN(percentil, 100) + 99) / 100;
+
+    for (uint8_t i = 0; i < NUM_CUBETAS_PERFIL_TAREA; i++) {
+        acumulado += tarea->histCiclos[i];
+        if (acumulado >= objetivo && acumulado > 0) {
+            if (i < 4)
+                return i;
+
+            // Limite superior de la cubeta sin pasar del maximo medido
+            const uint32_t desplazamiento = i / 4 - 1;
+            const uint32_t limite = ((4 + (i & 0x03) + 1) << desplazamiento) - 1;
+            return MIN(limite, tarea->ciclosMax);
+        }
+    }
+
+    return tarea->ciclosMax;
+}
+#endif
+
+
 /***************************************************************************************
 **  Nombre:         void actualizarBitVidaScheduler(colorRGB_e color)
 **  Descripcion:    Actualiza el bit de vida
@@ -357,6 +528,246 @@ void actualizarBitVidaScheduler(colorRGB_e color)
 #include <math.h>
 uint32_t contador1 = 0;
 bool calc = false;
+/***************************************************************************************
+**  Nombre:         void ejecutarTareaTiempoReal(tarea_t *tarea, uint32_t tiempoActual)
+**  Descripcion:    Ejecuta una tarea en tiempo real y comprueba si cumple su deadline
+**  Parametros:     Tarea, tiempo actual en us
+**  Retorno:        Ninguno
+****************************************************************************************/
+CODIGO_RAPIDO void ejecutarTareaTiempoReal(tarea_t *tarea, uint32_t tiempoActual)
+{
+#if defined(USAR_ESTADISTICAS_TAREAS)
+    if (calcularEstadisticasTareas) {
+        const uint32_t tiempoActualAntesLlamada = micros();
+        const uint32_t ciclosAntesLlamada = ciclosCPU();
+        tarea->funTarea(tiempoActual);
+        perfilarTarea(tarea, ciclosCPU() - ciclosAntesLlamada);
+        const uint32_t tiempoEjecTarea = micros() - tiempoActualAntesLlamada;
+        tarea->sumaMovTiempoEjec += tiempoEjecTarea - tarea->sumaMovTiempoEjec / NUM_MUESTRAS_SUMA_SCHEDULER;
+        tarea->tiempoEjecucionTotal += tiempoEjecTarea;   // Tiempo consumido por el scheduler + tarea
+        tarea->tiempoMaxEjecucion = MAX(tarea->tiempoMaxEjecucion, tiempoEjecTarea);
+        t1 = t1 + tiempoEjecTarea;
+        if (tarea->cntHist < 100) {
+            tarea->periodoHist[tarea->cntHist] = tarea->ultimoPeriodoEjec;
+            tarea->cntHist++;
+
+            if (tarea->cntHist == 100) {
+            	if (tarea->calc) {
+					float tau = 0.0;
+					float dif[100];
+					for (uint32_t cnt = 0; cnt < 100; cnt++) {
+						dif[cnt] = (float)(tarea->periodo - tarea->periodoHist[cnt]);
+						tau = tau + (dif[cnt] * dif[cnt]);
+					}
+
+					tau = sqrt(tau) / 100;
+					if (tau > tarea->tau)
+						tarea->tau = tau;
+            	}
+            	tarea->cntHist = 0;
+            	tarea->calc = true;
+            }
+        }
+    }
+    else
+#endif
+    tarea->funTarea(tiempoActual);
+
+    // La ejecucion debe terminar antes de la siguiente activacion
+    const int32_t retraso = micros() - tarea->deadline;
+    if (retraso > 0) {
+        tarea->deadlinesPerdidos++;
+        tarea->retrasoMaxDeadline = MAX(tarea->retrasoMaxDeadline, (uint32_t)retraso);
+    }
+}
+
+
+#if defined(USAR_SCHEDULER_EDF)
+/***************************************************************************************
+**  Nombre:         uint32_t claveMonticuloEDF(monticuloEDF_t *monticulo, tarea_t *tarea)
+**  Descripcion:    Devuelve el instante por el que se ordena la tarea en el monticulo
+**  Parametros:     Monticulo, tarea
+**  Retorno:        Clave en us
+****************************************************************************************/
+static inline uint32_t claveMonticuloEDF(monticuloEDF_t *monticulo, tarea_t *tarea)
+{
+    return monticulo->porDeadline ? tarea->deadline : tarea->liberacion;
+}
+
+
+/***************************************************************************************
+**  Nombre:         bool anteriorMonticuloEDF(monticuloEDF_t *monticulo, uint8_t a, uint8_t b)
+**  Descripcion:    Comprueba si el elemento a va antes que el b
+**  Parametros:     Monticulo, posiciones a comparar
+**  Retorno:        True si a va antes que b
+****************************************************************************************/
+static inline bool anteriorMonticuloEDF(monticuloEDF_t *monticulo, uint8_t a, uint8_t b)
+{
+    return (int32_t)(claveMonticuloEDF(monticulo, monticulo->tareas[a]) - claveMonticuloEDF(monticulo, monticulo->tareas[b])) < 0;
+}
+
+
+/***************************************************************************************
+**  Nombre:         void intercambiarMonticuloEDF(monticuloEDF_t *monticulo, uint8_t a, uint8_t b)
+**  Descripcion:    Intercambia dos elementos del monticulo
+**  Parametros:     Monticulo, posiciones a intercambiar
+**  Retorno:        Ninguno
+****************************************************************************************/
+static inline void intercambiarMonticuloEDF(monticuloEDF_t *monticulo, uint8_t a, uint8_t b)
+{
+    tarea_t *tarea = monticulo->tareas[a];
+    monticulo->tareas[a] = monticulo->tareas[b];
+    monticulo->tareas[b] = tarea;
+}
+
+
+/***************************************************************************************
+**  Nombre:         void subirMonticuloEDF(monticuloEDF_t *monticulo, uint8_t pos)
+**  Descripcion:    Sube un elemento hasta su posicion en el monticulo
+**  Parametros:     Monticulo, posicion del elemento
+**  Retorno:        Ninguno
+****************************************************************************************/
+static void subirMonticuloEDF(monticuloEDF_t *monticulo, uint8_t pos)
+{
+    while (pos > 0) {
+        const uint8_t padre = (pos - 1) / 2;
+        if (!anteriorMonticuloEDF(monticulo, pos, padre))
+            break;
+
+        intercambiarMonticuloEDF(monticulo, pos, padre);
+        pos = padre;
+    }
+}
+
+
+/***************************************************************************************
+**  Nombre:         void bajarMonticuloEDF(monticuloEDF_t *monticulo, uint8_t pos)
+**  Descripcion:    Baja un elemento hasta su posicion en el monticulo
+**  Parametros:     Monticulo, posicion del elemento
+**  Retorno:        Ninguno
+****************************************************************************************/
+static void bajarMonticuloEDF(monticuloEDF_t *monticulo, uint8_t pos)
+{
+    while (true) {
+        const uint8_t izq = 2 * pos + 1;
+        const uint8_t der = izq + 1;
+        uint8_t menor = pos;
+
+        if (izq < monticulo->tam && anteriorMonticuloEDF(monticulo, izq, menor))
+            menor = izq;
+
+        if (der < monticulo->tam && anteriorMonticuloEDF(monticulo, der, menor))
+            menor = der;
+
+        if (menor == pos)
+            break;
+
+        intercambiarMonticuloEDF(monticulo, pos, menor);
+        pos = menor;
+    }
+}
+
+
+/***************************************************************************************
+**  Nombre:         void insertarMonticuloEDF(monticuloEDF_t *monticulo, tarea_t *tarea)
+**  Descripcion:    Inserta una tarea en el monticulo
+**  Parametros:     Monticulo, tarea
+**  Retorno:        Ninguno
+****************************************************************************************/
+CODIGO_RAPIDO void insertarMonticuloEDF(monticuloEDF_t *monticulo, tarea_t *tarea)
+{
+    if (monticulo->tam >= TAREA_CONTADOR)
+        return;
+
+    monticulo->tareas[monticulo->tam] = tarea;
+    subirMonticuloEDF(monticulo, monticulo->tam);
+    monticulo->tam++;
+}
+
+
+/***************************************************************************************
+**  Nombre:         tarea_t *extraerMonticuloEDF(monticuloEDF_t *monticulo)
+**  Descripcion:    Extrae la tarea con la menor clave del monticulo
+**  Parametros:     Monticulo
+**  Retorno:        Tarea extraida o NULL si esta vacio
+****************************************************************************************/
+CODIGO_RAPIDO tarea_t *extraerMonticuloEDF(monticuloEDF_t *monticulo)
+{
+    if (monticulo->tam == 0)
+        return NULL;
+
+    tarea_t *tarea = monticulo->tareas[0];
+    monticulo->tam--;
+    monticulo->tareas[0] = monticulo->tareas[monticulo->tam];
+    bajarMonticuloEDF(monticulo, 0);
+    return tarea;
+}
+
+
+/***************************************************************************************
+**  Nombre:         void quitarMonticuloEDF(monticuloEDF_t *monticulo, tarea_t *tarea)
+**  Descripcion:    Quita una tarea cualquiera del monticulo
+**  Parametros:     Monticulo, tarea
+**  Retorno:        Ninguno
+****************************************************************************************/
+void quitarMonticuloEDF(monticuloEDF_t *monticulo, tarea_t *tarea)
+{
+    for (uint8_t i = 0; i < monticulo->tam; i++) {
+        if (monticulo->tareas[i] == tarea) {
+            monticulo->tam--;
+            monticulo->tareas[i] = monticulo->tareas[monticulo->tam];
+            if (i < monticulo->tam) {
+                subirMonticuloEDF(monticulo, i);
+                bajarMonticuloEDF(monticulo, i);
+            }
+            return;
+        }
+    }
+}
+
+
+/***************************************************************************************
+**  Nombre:         int32_t despacharTareasEDF(void)
+**  Descripcion:    Ejecuta las tareas en tiempo real listas por orden de deadline. Cada
+**                  tarea se ejecuta como mucho una vez por llamada
+**  Parametros:     Ninguno
+**  Retorno:        Tiempo hasta la siguiente activacion en us
+****************************************************************************************/
+CODIGO_RAPIDO int32_t despacharTareasEDF(void)
+{
+    uint32_t tiempoActual = micros();
+
+    // Pasa a listas las tareas cuya activacion ha llegado
+    while (tareasEsperandoEDF.tam > 0 && (int32_t)(tareasEsperandoEDF.tareas[0]->liberacion - tiempoActual) <= 0) {
+        tarea_t *tarea = extraerMonticuloEDF(&tareasEsperandoEDF);
+        tarea->deadline = tarea->liberacion + tarea->periodo;
+        insertarMonticuloEDF(&tareasListasEDF, tarea);
+    }
+
+    // Ejecuta primero la de deadline mas cercano
+    for (tarea_t *tarea = extraerMonticuloEDF(&tareasListasEDF); tarea != NULL; tarea = extraerMonticuloEDF(&tareasListasEDF)) {
+        tiempoActual = micros();
+        tarea->ultimoPeriodoEjec = tiempoActual - tarea->ultimoTiempoEjec;
+        tarea->ultimoTiempoEjec = tiempoActual;
+
+        ejecutarTareaTiempoReal(tarea, tiempoActual);
+
+        // La siguiente activacion mantiene la fase. Si se ha perdido un periodo completo se resincroniza
+        tarea->liberacion += tarea->periodo;
+        if ((int32_t)(tiempoActual - tarea->liberacion) >= tarea->periodo)
+            tarea->liberacion = tiempoActual;
+
+        insertarMonticuloEDF(&tareasEsperandoEDF, tarea);
+    }
+
+    if (tareasEsperandoEDF.tam == 0)
+        return 0x7FFFFFFF;
+
+    return tareasEsperandoEDF.tareas[0]->liberacion - micros();
+}
+#endif
+
+
 /***************************************************************************************
 **  Nombre:         void scheduler(void)
 **  Descripcion:    Funcion de ejecucion de las tareas
@@ -378,6 +789,9 @@ CODIGO_RAPIDO void scheduler(void)
         contador1++;
 
     // Actualizacion de las tareas en tiempo real
+#if defined(USAR_SCHEDULER_EDF)
+    tiempoHastaEjec = despacharTareasEDF();
+#else
     for (tarea_t *tarea = primeraTareaCola(); tarea != NULL; tarea = siguienteTareaCola()) {
 	    if (tarea->prioridadEstatica != PRIORIDAD_TIEMPO_REAL)
 	        break;
@@ -391,45 +805,14 @@ CODIGO_RAPIDO void scheduler(void)
         if (tiempoEjec <= 0) {
             tarea->ultimoPeriodoEjec = tiempoActual - tarea->ultimoTiempoEjec;
             tarea->ultimoTiempoEjec = tiempoActual;
+            tarea->deadline = tiempoEjecTiempoReal + tarea->periodo;
 
-#if defined(USAR_ESTADISTICAS_TAREAS)
-            if (calcularEstadisticasTareas) {
-                const uint32_t tiempoActualAntesLlamada = micros();
-                tarea->funTarea(tiempoActual);
-                const uint32_t tiempoEjecTarea = micros() - tiempoActualAntesLlamada;
-                tarea->sumaMovTiempoEjec += tiempoEjecTarea - tarea->sumaMovTiempoEjec / NUM_MUESTRAS_SUMA_SCHEDULER;
-                tarea->tiempoEjecucionTotal += tiempoEjecTarea;   // Tiempo consumido por el scheduler + tarea
-                tarea->tiempoMaxEjecucion = MAX(tarea->tiempoMaxEjecucion, tiempoEjecTarea);
-                t1 = t1 + tiempoEjecTarea;
-                if (tarea->cntHist < 100) {
-                    tarea->periodoHist[tarea->cntHist] = tarea->ultimoPeriodoEjec;
-                    tarea->cntHist++;
-
-                    if (tarea->cntHist == 100) {
-                    	if (tarea->calc) {
-							float tau = 0.0;
-							float dif[100];
-							for (uint32_t cnt = 0; cnt < 100; cnt++) {
-								dif[cnt] = (float)(tarea->periodo - tarea->periodoHist[cnt]);
-								tau = tau + (dif[cnt] * dif[cnt]);
-							}
-
-							tau = sqrt(tau) / 100;
-							if (tau > tarea->tau)
-								tarea->tau = tau;
-                    	}
-                    	tarea->cntHist = 0;
-                    	tarea->calc = true;
-                    }
-                }
-            }
-            else
-#endif
-            tarea->funTarea(tiempoActual);
+            ejecutarTareaTiempoReal(tarea, tiempoActual);
 
             tiempoHastaEjec -= tarea->tiempoMaxEjecucion;
         }
     }
+#endif
 
     // Actualizacion de las tareas no en tiempo real
     if (tareaTiempoRealEjecutada || tiempoHastaEjec > INTERVALO_GUARDA_TIEMPO_REAL) {
@@ -473,8 +856,10 @@ CODIGO_RAPIDO void scheduler(void)
 #if defined(USAR_ESTADISTICAS_TAREAS)
             if (calcularEstadisticasTareas) {
                 const uint32_t tiempoActualAntesLlamada = micros();
+                const uint32_t ciclosAntesLlamada = ciclosCPU();
 
                 tareaSeleccionada->funTarea(tiempoActualAntesLlamada);
+                perfilarTarea(tareaSeleccionada, ciclosCPU() - ciclosAntesLlamada);
                 const uint32_t tiempoEjecTarea = micros() - tiempoActualAntesLlamada;
                 tareaSeleccionada->sumaMovTiempoEjec += tiempoEjecTarea - tareaSeleccionada->sumaMovTiempoEjec / NUM_MUESTRAS_SUMA_SCHEDULER;
                 tareaSeleccionada->tiempoEjecucionTotal += tiempoEjecTarea;   // Tiempo consumido por el scheduler + tarea
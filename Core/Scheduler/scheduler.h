@@ -7,7 +7,7 @@
 **
 **  Autor: Ramon Rico
 **  Fecha de creacion: 12/05/2019
-**  Fecha de modificacion: 21/08/2020
+**  Fecha de modificacion: 17/10/2026
 **
 **  El proyecto URpilot NO es libre. No se puede distribuir y/o modificar este fichero
 **  bajo ningun concepto.
@@ -43,6 +43,9 @@
 #define PERIODO_TAREA_MS_SCHEDULER(ms)      ((ms) * 1000)
 #define PERIODO_TAREA_US_SCHEDULER(us)      (us)
 
+// Histograma logaritmico de ciclos: 4 cubetas por octava, hasta 2^25 ciclos
+#define NUM_CUBETAS_PERFIL_TAREA            96
+
 
 /***************************************************************************************
 ** AREA DE DEFINICION DE TIPOS                                                        **
@@ -67,6 +70,13 @@ typedef struct {
     uint32_t tiempoMaxEjecucion;
     uint32_t tiempoEjecucionTotal;
     uint32_t tiempoEjecucionMedio;
+    uint32_t deadlinesPerdidos;
+    uint32_t retrasoMaxDeadline;
+    uint32_t ciclosMin;
+    uint32_t ciclosMax;
+    uint32_t ciclosMedio;
+    uint32_t ciclosP50;
+    uint32_t ciclosP99;
 } infoTarea_t;
 
 typedef enum {
@@ -91,6 +101,8 @@ typedef enum {
 #ifdef USAR_IMU
     TAREA_ACTUALIZAR_IMU,
     TAREA_LEER_IMU,
+    TAREA_ACTUALIZAR_NOTCH_DINAMICO,
+    TAREA_ACTUALIZAR_FILTRO_RPM,
     TAREA_ACTUALIZAR_CALIBRADOR_ACELEROMETRO,
     TAREA_ACTUALIZAR_CALIBRADOR_GIROSCOPIO,
 #endif
@@ -129,6 +141,21 @@ typedef struct {
     uint64_t sumaMovTiempoEjec;          // Suma sobre 32 muestras
     uint64_t tiempoMaxEjecucion;
     uint64_t tiempoEjecucionTotal;       // tiempo total consumido por la tarea desde el encendido
+
+    // Perfil en ciclos de CPU (ver ciclosCPU())
+    uint32_t ciclosMin;
+    uint32_t ciclosMax;
+    uint64_t ciclosTotal;
+    uint32_t numEjecuciones;
+    uint16_t histCiclos[NUM_CUBETAS_PERFIL_TAREA];
+#endif
+
+    // Deadlines de las tareas en tiempo real. El deadline de cada ejecucion es la siguiente activacion
+    uint32_t deadline;                   // Instante limite de la ejecucion en curso
+    uint32_t deadlinesPerdidos;          // Ejecuciones terminadas despues del deadline
+    uint32_t retrasoMaxDeadline;         // Mayor retraso sobre el deadline en us
+#if defined(USAR_SCHEDULER_EDF)
+    uint32_t liberacion;                 // Instante en el que la tarea vuelve a estar lista
 #endif
 
     int32_t periodoHist[100];
@@ -158,6 +185,7 @@ void deshabilitarEstadisticasScheduler(void);
 void infoTarea(idTarea_e idTarea, infoTarea_t *infoTarea);
 void resetearEstadisticasTarea(idTarea_e idTarea);
 void resetearTiempoMaxEjecTarea(idTarea_e idTarea);
+uint32_t percentilCiclosTarea(idTarea_e idTarea, uint8_t percentil);
 void scheduler(void);
 
 #endif // __SCHEDULER_H
@@ -7,7 +7,7 @@
 **
 **  Autor: Ramon Rico
 **  Fecha de creacion: 12/05/2019
-**  Fecha de modificacion: 21/08/2020
+**  Fecha de modificacion: 17/10/2026
 **
 **  El proyecto URpilot NO es libre. No se puede distribuir y/o modificar este fichero
 **  bajo ningun concepto.
@@ -159,6 +159,20 @@ tarea_t tareas[TAREA_CONTADOR] = {
         .periodo = PERIODO_TAREA_HZ_SCHEDULER(FREC_LEER_IMU_HZ),
         .prioridadEstatica = PRIORIDAD_TIEMPO_REAL,
     },
+    [TAREA_ACTUALIZAR_NOTCH_DINAMICO] = {
+        .nombreTarea = "ACTUALIZAR NOTCH DINAMICO",
+        .subNombreTarea = "SENSORES",
+        .funTarea = actualizarNotchDinamicoIMU,
+        .periodo = PERIODO_TAREA_HZ_SCHEDULER(FREC_NOTCH_DINAMICO_HZ),
+        .prioridadEstatica = PRIORIDAD_MEDIA_ALTA,
+    },
+    [TAREA_ACTUALIZAR_FILTRO_RPM] = {
+        .nombreTarea = "ACTUALIZAR FILTRO RPM",
+        .subNombreTarea = "SENSORES",
+        .funTarea = actualizarFiltroRPMIMU,
+        .periodo = PERIODO_TAREA_HZ_SCHEDULER(FREC_FILTRO_RPM_HZ),
+        .prioridadEstatica = PRIORIDAD_MEDIA_ALTA,
+    },
     [TAREA_ACTUALIZAR_CALIBRADOR_ACELEROMETRO] = {
         .nombreTarea = "ACTUALIZAR CALIBRADOR ACELEROMETRO",
         .subNombreTarea = "CALIBRADOR ACELEROMETRO",
@@ -224,7 +238,7 @@ tarea_t tareas[TAREA_CONTADOR] = {
         .nombreTarea = "ACTUALIZAR TELEMETRIA",
         .subNombreTarea = "TELEMETRIA",
         .funTarea = actualizarTelemetria,
-        .periodo = PERIODO_TAREA_HZ_SCHEDULER(200),
+        .periodo = PERIODO_TAREA_HZ_SCHEDULER(FRECUENCIA_TAREA_TELEMETRIA),
         .prioridadEstatica = PRIORIDAD_MEDIA_ALTA,
     },
 };
@@ -266,6 +280,10 @@ void iniciarTareas(void)
   #ifdef LEER_IMU_SCHEDULER
     anadirTareaEnCola(&tareas[TAREA_LEER_IMU]);
   #endif
+    if (configNotchDinamico()->habilitado)
+        anadirTareaEnCola(&tareas[TAREA_ACTUALIZAR_NOTCH_DINAMICO]);
+    if (filtroRPMIMUhabilitado())
+        anadirTareaEnCola(&tareas[TAREA_ACTUALIZAR_FILTRO_RPM]);
 #endif
 
 #ifdef USAR_BARO
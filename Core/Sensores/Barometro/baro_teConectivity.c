@@ -7,7 +7,7 @@
 **
 **  Autor: Ramon Rico
 **  Fecha de creacion: 19/05/2019
-**  Fecha de modificacion: 03/08/2020
+**  Fecha de modificacion: 17/10/2026
 **
 **  El proyecto URpilot NO es libre. No se puede distribuir y/o modificar este fichero
 **  bajo ningun concepto.
@@ -68,6 +68,8 @@ typedef struct {
     float presionRaw, temperaturaRaw;
     acumulador_t acumuladorP, acumuladorT;
     uint8_t estado;
+    uint8_t comandoPendiente;  // Ultimo comando de conversion
+    bool conversionEnCurso;    // El sensor ha aceptado el ultimo comando de conversion
     bool descartarLect;        // Si la lectura del ADC es erronea descartamos la siguiente lectura
 } baroTEConectivity_t;
 
@@ -125,7 +127,8 @@ bool iniciarBaroTEConectivity(baro_t *dBaro)
     driver->comandoT = CMD_ADC_T_RES_3_BARO_TEC;
 
     // Enviamos el comando de lectura de la temperatura
-    escribirRegistroBus(&dBaro->bus, driver->comandoP, 1);
+    driver->comandoPendiente = driver->comandoP;
+    driver->conversionEnCurso = escribirRegistroBus(&dBaro->bus, driver->comandoPendiente, 1);
     delay(10);
 
     return true;
@@ -267,19 +270,26 @@ void actualizarBaroTEConectivity(baro_t *dBaro)
     uint8_t sigEstado;
     uint32_t valorAdc;
 
+    // Si el bus no acepto el comando no hay conversion que leer: el ADC devolveria 0
+    if (!driver->conversionEnCurso) {
+        driver->conversionEnCurso = escribirRegistroBus(&dBaro->bus, driver->comandoPendiente, 1);
+        return;
+    }
+
     bool estado = leerAdcBaroTEConectivity(&dBaro->bus, &valorAdc);
 
-    if (valorAdc == 0 || estado == false)
+    if (estado == false || valorAdc == 0)
         sigEstado = driver->estado;
     else
         sigEstado = (driver->estado + 1) % 5;
 
     // Enviamos el comando que toque
     sigComando = sigEstado == 0 ? driver->comandoT : driver->comandoP;
-    escribirRegistroBus(&dBaro->bus, sigComando, 1);
+    driver->comandoPendiente = sigComando;
+    driver->conversionEnCurso = escribirRegistroBus(&dBaro->bus, sigComando, 1);
 
     // Si la medida ha sido mala descartamos la siguiente
-    if (valorAdc == 0 || estado == false) {
+    if (estado == false || valorAdc == 0) {
         driver->descartarLect = true;
         return;
     }
@@ -162,6 +162,11 @@ bool iniciarBaro(void)
             case BARO_BMP180:
                 tablaFnBaro[i] = &tablaFnBaroBosch;
                 break;
+#ifdef SITL
+            case BARO_SITL:
+                tablaFnBaro[i] = &tablaFnBaroSITL;
+                break;
+#endif
 
             default:
 #ifdef DEBUG
@@ -60,6 +60,9 @@ typedef enum {
     BARO_NINGUNO = -1,
     BARO_MS5611  =  0,
     BARO_BMP180,
+#ifdef SITL
+    BARO_SITL,
+#endif
 } tipoBaro_e;
 
 typedef struct {
@@ -99,6 +102,9 @@ typedef struct {
 ****************************************************************************************/
 extern tablaFnBaro_t tablaFnBaroBosch;
 extern tablaFnBaro_t tablaFnBaroTEConectivity;
+#ifdef SITL
+extern tablaFnBaro_t tablaFnBaroSITL;
+#endif
 
 
 /***************************************************************************************
@@ -0,0 +1,429 @@
+/***************************************************************************************
+**  ajuste_mag.c - Ajuste de la calibracion del magnetometro con Levenberg-Marquardt.
+**                 Se reparte en pasadas acotadas por ciclo del scheduler
+**
+**
+**  Este fichero forma parte del proyecto URpilot.
+**  Codigo desarrollado por el grupo de investigacion ICON de la Universidad de La Rioja
+**
+**  Autor: Ramon Rico
+**  Fecha de creacion: 17/10/2026
+**  Fecha de modificacion: 17/10/2026
+**
+**  El proyecto URpilot NO es libre. No se puede distribuir y/o modificar este fichero
+**  bajo ningun concepto.
+**
+**  En caso de modificacion y/o solicitud de informacion pongase en contacto con
+**  el grupo de investigacion ICON a traves de: www.unirioja.es/urpilot
+**
+**
+**  Control de versiones del fichero
+**
+**  v1.0  Ramon Rico. Se ha liberado la primera version estable
+**
+****************************************************************************************/
+
+/***************************************************************************************
+** AREA DE INCLUDES                                                                   **
+****************************************************************************************/
+#include <string.h>
+#include <math.h>
+
+#include "ajuste_mag.h"
+#include "Comun/matriz.h"
+#include "Comun/util.h"
+
+
+/***************************************************************************************
+** AREA DE PREPROCESADOR                                                              **
+****************************************************************************************/
+#define NUM_MIN_MUESTRAS_ESFERA_AJUSTE_MAG  10          // Muestras antes de resolver la esfera lineal
+#define LAMBDA_INICIAL_AJUSTE_MAG           1.0f
+#define LAMBDA_MIN_AJUSTE_MAG               1e-6f
+#define LAMBDA_MAX_AJUSTE_MAG               1e10f
+#define AMORTIGUAMIENTO_AJUSTE_MAG          10.0f
+
+
+/***************************************************************************************
+** AREA DE DEFINICION DE TIPOS                                                        **
+****************************************************************************************/
+
+
+/***************************************************************************************
+** AREA DE DECLARACION DE VARIABLES                                                   **
+****************************************************************************************/
+
+
+/***************************************************************************************
+** AREA DE PROTOTIPOS DE FUNCION                                                      **
+****************************************************************************************/
+void resolverEsferaLinealAjusteMag(ajusteMag_t *ajuste);
+uint8_t sectorAjusteMag(const float *muestra, const calParamMag_t *param);
+float *parametrosAjusteMag(calParamMag_t *param, faseAjusteMag_e fase);
+float jacobianoAjusteMag(const float *muestra, const calParamMag_t *param, faseAjusteMag_e fase, float *j);
+void terminarIteracionAjusteMag(ajusteMag_t *ajuste);
+
+
+/***************************************************************************************
+** AREA DE DEFINICION DE FUNCIONES                                                    **
+****************************************************************************************/
+
+/***************************************************************************************
+**  Nombre:         void iniciarAjusteMag(ajusteMag_t *ajuste)
+**  Descripcion:    Resetea el ajuste: sin muestras, esfera de radio inicial y sin distorsion
+**  Parametros:     Puntero al ajuste
+**  Retorno:        Ninguno
+****************************************************************************************/
+void iniciarAjusteMag(ajusteMag_t *ajuste)
+{
+    memset(ajuste, 0, sizeof(ajusteMag_t));
+
+    ajuste->param.radio = RADIO_INICIAL_AJUSTE_MAG;
+    ajuste->param.diag[0] = 1.0f;
+    ajuste->param.diag[1] = 1.0f;
+    ajuste->param.diag[2] = 1.0f;
+    ajuste->candidato = ajuste->param;
+    ajuste->fitness = INFINITY;
+
+    // En cualquier poliedro de caras triangulares el angulo entre dos vertices contiguos es
+    // theta = arccos(cos(A) / (1 - cos(A))), con A = (4pi / F + pi) / 3 y F = 2V - 4 caras para V vertices
+    const uint16_t caras = 2 * NUM_MAX_MUESTRAS_AJUSTE_MAG - 4;
+    const float a = (4.0f * PI / (3.0f * caras)) + PI / 3.0f;
+    const float theta = 0.5f * acosf(cosf(a) / (1.0f - cosf(a)));
+
+    ajuste->factorDistancia = 2.0f * sinf(theta / 2.0f);
+    ajuste->distanciaMin = ajuste->factorDistancia * ajuste->param.radio;
+}
+
+
+/***************************************************************************************
+**  Nombre:         bool anadirMuestraAjusteMag(ajusteMag_t *ajuste, const float *muestra)
+**  Descripcion:    Guarda una muestra si esta lejos de las anteriores y acumula las ecuaciones
+**                  normales de la esfera lineal, que dan el centro y el radio en cada muestra
+**  Parametros:     Puntero al ajuste, muestra en mGa
+**  Retorno:        True si se ha guardado
+****************************************************************************************/
+bool anadirMuestraAjusteMag(ajusteMag_t *ajuste, const float *muestra)
+{
+    const float distanciaMin2 = ajuste->distanciaMin * ajuste->distanciaMin;
+
+    if (ajuste->numMuestras >= NUM_MAX_MUESTRAS_AJUSTE_MAG)
+        return false;
+
+    for (uint16_t i = 0; i < ajuste->numMuestras; i++) {
+        const float dx = muestra[0] - ajuste->muestras[i][0];
+        const float dy = muestra[1] - ajuste->muestras[i][1];
+        const float dz = muestra[2] - ajuste->muestras[i][2];
+
+        if (dx * dx + dy * dy + dz * dz < distanciaMin2)
+            return false;
+    }
+
+    if (ajuste->numMuestras == 0)
+        memcpy(ajuste->origen, muestra, sizeof(ajuste->origen));
+
+    memcpy(ajuste->muestras[ajuste->numMuestras], muestra, sizeof(ajuste->muestras[0]));
+    ajuste->numMuestras++;
+
+    // |p|^2 = 2 c·p + d con p = (m - origen) / RADIO_INICIAL_AJUSTE_MAG y d = r^2 - |c|^2
+    const float p[3] = {(muestra[0] - ajuste->origen[0]) / RADIO_INICIAL_AJUSTE_MAG,
+                        (muestra[1] - ajuste->origen[1]) / RADIO_INICIAL_AJUSTE_MAG,
+                        (muestra[2] - ajuste->origen[2]) / RADIO_INICIAL_AJUSTE_MAG};
+    const float fila[NUM_PARAMETROS_ESFERA_AJUSTE_MAG] = {2.0f * p[0], 2.0f * p[1], 2.0f * p[2], 1.0f};
+    const float y = p[0] * p[0] + p[1] * p[1] + p[2] * p[2];
+
+    for (uint8_t i = 0; i < NUM_PARAMETROS_ESFERA_AJUSTE_MAG; i++) {
+        for (uint8_t j = 0; j < NUM_PARAMETROS_ESFERA_AJUSTE_MAG; j++)
+            ajuste->normalEsfera[i][j] += fila[i] * fila[j];
+
+        ajuste->terminoEsfera[i] += fila[i] * y;
+    }
+
+    if (ajuste->numMuestras >= NUM_MIN_MUESTRAS_ESFERA_AJUSTE_MAG)
+        resolverEsferaLinealAjusteMag(ajuste);
+
+    ajuste->sectores |= 1UL << sectorAjusteMag(muestra, &ajuste->param);
+    return true;
+}
+
+
+/***************************************************************************************
+**  Nombre:         void resolverEsferaLinealAjusteMag(ajusteMag_t *ajuste)
+**  Descripcion:    Resuelve la esfera lineal con las ecuaciones normales acumuladas y la usa
+**                  como parametros iniciales
+**  Parametros:     Puntero al ajuste
+**  Retorno:        Ninguno
+****************************************************************************************/
+void resolverEsferaLinealAjusteMag(ajusteMag_t *ajuste)
+{
+    float L[NUM_PARAMETROS_ESFERA_AJUSTE_MAG * NUM_PARAMETROS_ESFERA_AJUSTE_MAG];
+    float x[NUM_PARAMETROS_ESFERA_AJUSTE_MAG];
+
+    copiarMat(&ajuste->normalEsfera[0][0], L, NUM_PARAMETROS_ESFERA_AJUSTE_MAG, NUM_PARAMETROS_ESFERA_AJUSTE_MAG);
+    memcpy(x, ajuste->terminoEsfera, sizeof(x));
+
+    if (!factorizarCholeskyMat(L, NUM_PARAMETROS_ESFERA_AJUSTE_MAG))
+        return;
+
+    resolverCholeskyMat(L, x, NUM_PARAMETROS_ESFERA_AJUSTE_MAG, 1);
+
+    const float radio2 = x[3] + x[0] * x[0] + x[1] * x[1] + x[2] * x[2];
+    if (!(radio2 > 0.0f))
+        return;
+
+    for (uint8_t i = 0; i < 3; i++)
+        ajuste->param.offset[i] = -(ajuste->origen[i] + x[i] * RADIO_INICIAL_AJUSTE_MAG);
+
+    ajuste->param.radio = sqrtf(radio2) * RADIO_INICIAL_AJUSTE_MAG;
+    ajuste->distanciaMin = ajuste->factorDistancia * ajuste->param.radio;
+}
+
+
+/***************************************************************************************
+**  Nombre:         void iniciarIteracionesAjusteMag(ajusteMag_t *ajuste, faseAjusteMag_e fase)
+**  Descripcion:    Empieza las iteraciones de una fase desde los parametros actuales. La esfera
+**                  ajusta radio y offset y la elipse offset y matriz con el radio fijo
+**  Parametros:     Puntero al ajuste, fase
+**  Retorno:        Ninguno
+****************************************************************************************/
+void iniciarIteracionesAjusteMag(ajusteMag_t *ajuste, faseAjusteMag_e fase)
+{
+    ajuste->fase = fase;
+    ajuste->numParametros = (fase == FASE_AJUSTE_MAG_ESFERA) ? NUM_PARAMETROS_ESFERA_AJUSTE_MAG : NUM_PARAMETROS_ELIPSE_AJUSTE_MAG;
+    ajuste->candidato = ajuste->param;
+    ajuste->lambda = LAMBDA_INICIAL_AJUSTE_MAG;
+    ajuste->fitness = INFINITY;
+    ajuste->mejoraRelativa = 1.0f;
+    ajuste->numIteraciones = 0;
+
+    ajuste->indicePasada = 0;
+    ajuste->sumaResiduoPasada = 0;
+    ajuste->sectoresPasada = 0;
+    memset(ajuste->JTJpasada, 0, sizeof(ajuste->JTJpasada));
+    memset(ajuste->JTFpasada, 0, sizeof(ajuste->JTFpasada));
+}
+
+
+/***************************************************************************************
+**  Nombre:         bool iterarAjusteMag(ajusteMag_t *ajuste, uint16_t maxMuestras)
+**  Descripcion:    Avanza la pasada por las muestras como mucho maxMuestras. Al terminar la pasada
+**                  se acepta o rechaza el candidato y se calcula el siguiente
+**  Parametros:     Puntero al ajuste, muestras a procesar en esta llamada
+**  Retorno:        True si se ha completado una iteracion
+****************************************************************************************/
+bool iterarAjusteMag(ajusteMag_t *ajuste, uint16_t maxMuestras)
+{
+    const uint8_t n = ajuste->numParametros;
+    uint16_t fin = ajuste->indicePasada + maxMuestras;
+
+    if (ajuste->numMuestras == 0 || n == 0)
+        return false;
+
+    if (fin > ajuste->numMuestras)
+        fin = ajuste->numMuestras;
+
+    for (uint16_t k = ajuste->indicePasada; k < fin; k++) {
+        const float *muestra = ajuste->muestras[k];
+        float j[NUM_PARAMETROS_ELIPSE_AJUSTE_MAG];
+        const float residuo = jacobianoAjusteMag(muestra, &ajuste->candidato, ajuste->fase, j);
+
+        // Solo el triangulo superior
+        for (uint8_t f = 0; f < n; f++) {
+            for (uint8_t c = f; c < n; c++)
+                ajuste->JTJpasada[f][c] += j[f] * j[c];
+
+            ajuste->JTFpasada[f] += j[f] * residuo;
+        }
+
+        ajuste->sumaResiduoPasada += residuo * residuo;
+        ajuste->sectoresPasada |= 1UL << sectorAjusteMag(muestra, &ajuste->candidato);
+    }
+
+    ajuste->indicePasada = fin;
+    if (fin < ajuste->numMuestras)
+        return false;
+
+    terminarIteracionAjusteMag(ajuste);
+    return true;
+}
+
+
+/***************************************************************************************
+**  Nombre:         void terminarIteracionAjusteMag(ajusteMag_t *ajuste)
+**  Descripcion:    Decide con el candidato evaluado en la pasada y calcula el siguiente resolviendo
+**                  (J'J + lambda I) delta = J'F por Cholesky
+**  Parametros:     Puntero al ajuste
+**  Retorno:        Ninguno
+****************************************************************************************/
+void terminarIteracionAjusteMag(ajusteMag_t *ajuste)
+{
+    const uint8_t n = ajuste->numParametros;
+    const float fitnessCandidato = ajuste->sumaResiduoPasada / ajuste->numMuestras;
+    float M[NUM_PARAMETROS_ELIPSE_AJUSTE_MAG * NUM_PARAMETROS_ELIPSE_AJUSTE_MAG];
+    float delta[NUM_PARAMETROS_ELIPSE_AJUSTE_MAG];
+
+    if (ajuste->numIteraciones == 0 || fitnessCandidato < ajuste->fitness) {
+        ajuste->mejoraRelativa = (ajuste->numIteraciones == 0) ? 1.0f : (ajuste->fitness - fitnessCandidato) / ajuste->fitness;
+        ajuste->param = ajuste->candidato;
+        ajuste->fitness = fitnessCandidato;
+        ajuste->sectores = ajuste->sectoresPasada;
+
+        for (uint8_t f = 0; f < n; f++) {
+            for (uint8_t c = f; c < n; c++) {
+                ajuste->JTJ[f][c] = ajuste->JTJpasada[f][c];
+                ajuste->JTJ[c][f] = ajuste->JTJpasada[f][c];
+            }
+
+            ajuste->JTF[f] = ajuste->JTFpasada[f];
+        }
+
+        if (ajuste->numIteraciones != 0 && ajuste->lambda > LAMBDA_MIN_AJUSTE_MAG)
+            ajuste->lambda /= AMORTIGUAMIENTO_AJUSTE_MAG;
+    }
+    else if (ajuste->lambda < LAMBDA_MAX_AJUSTE_MAG)
+        ajuste->lambda *= AMORTIGUAMIENTO_AJUSTE_MAG;
+
+    ajuste->numIteraciones++;
+
+    // Siguiente candidato desde los parametros aceptados
+    for (uint8_t f = 0; f < n; f++) {
+        copiarMat(ajuste->JTJ[f], &M[f * n], 1, n);
+        M[f * n + f] += ajuste->lambda;
+        delta[f] = ajuste->JTF[f];
+    }
+
+    ajuste->candidato = ajuste->param;
+    if (factorizarCholeskyMat(M, n)) {
+        float *candidato = parametrosAjusteMag(&ajuste->candidato, ajuste->fase);
+
+        resolverCholeskyMat(M, delta, n, 1);
+        for (uint8_t f = 0; f < n; f++)
+            candidato[f] -= delta[f];
+    }
+
+    ajuste->indicePasada = 0;
+    ajuste->sumaResiduoPasada = 0;
+    ajuste->sectoresPasada = 0;
+    memset(ajuste->JTJpasada, 0, sizeof(ajuste->JTJpasada));
+    memset(ajuste->JTFpasada, 0, sizeof(ajuste->JTFpasada));
+}
+
+
+/***************************************************************************************
+**  Nombre:         float residuoRMSajusteMag(const ajusteMag_t *ajuste)
+**  Descripcion:    Devuelve la calidad del ajuste
+**  Parametros:     Puntero al ajuste
+**  Retorno:        Residuo cuadratico medio de los parametros aceptados en mGa
+****************************************************************************************/
+float residuoRMSajusteMag(const ajusteMag_t *ajuste)
+{
+    return sqrtf(ajuste->fitness);
+}
+
+
+/***************************************************************************************
+**  Nombre:         float coberturaAjusteMag(const ajusteMag_t *ajuste)
+**  Descripcion:    Devuelve la parte de la esfera cubierta por las muestras
+**  Parametros:     Puntero al ajuste
+**  Retorno:        Porcentaje de sectores con muestras
+****************************************************************************************/
+float coberturaAjusteMag(const ajusteMag_t *ajuste)
+{
+    return 100.0f * __builtin_popcount(ajuste->sectores) / NUM_SECTORES_AJUSTE_MAG;
+}
+
+
+/***************************************************************************************
+**  Nombre:         uint8_t sectorAjusteMag(const float *muestra, const calParamMag_t *param)
+**  Descripcion:    Sector de la esfera de la muestra respecto al centro estimado: octante en
+**                  azimut y banda de igual area en elevacion (|z| / |v| = 0.5), sin trigonometria
+**  Parametros:     Muestra, parametros
+**  Retorno:        Sector entre 0 y NUM_SECTORES_AJUSTE_MAG - 1
+****************************************************************************************/
+uint8_t sectorAjusteMag(const float *muestra, const calParamMag_t *param)
+{
+    const float x = muestra[0] + param->offset[0];
+    const float y = muestra[1] + param->offset[1];
+    const float z = muestra[2] + param->offset[2];
+    const bool polar = 4.0f * z * z > x * x + y * y + z * z;
+    const uint8_t banda = (z < 0) ? (polar ? 0 : 1) : (polar ? 3 : 2);
+    const uint8_t octante = ((y < 0) << 2) | ((x < 0) << 1) | (fabsf(x) < fabsf(y));
+
+    return banda * 8 + octante;
+}
+
+
+/***************************************************************************************
+**  Nombre:         float *parametrosAjusteMag(calParamMag_t *param, faseAjusteMag_e fase)
+**  Descripcion:    Devuelve el primer parametro que se ajusta en la fase. Los parametros son
+**                  floats contiguos: radio, offset, diagonal y fuera de la diagonal
+**  Parametros:     Parametros, fase
+**  Retorno:        Puntero al primer parametro
+****************************************************************************************/
+float *parametrosAjusteMag(calParamMag_t *param, faseAjusteMag_e fase)
+{
+    return (fase == FASE_AJUSTE_MAG_ESFERA) ? &param->radio : &param->offset[0];
+}
+
+
+/***************************************************************************************
+**  Nombre:         float jacobianoAjusteMag(const float *muestra, const calParamMag_t *param,
+**                                           faseAjusteMag_e fase, float *j)
+**  Descripcion:    Calcula el residuo y su jacobiano respecto a los parametros de la fase
+**  Parametros:     Muestra, parametros, fase, jacobiano calculado
+**  Retorno:        Residuo
+****************************************************************************************/
+float jacobianoAjusteMag(const float *muestra, const calParamMag_t *param, faseAjusteMag_e fase, float *j)
+{
+    const float *diag = param->diag;
+    const float *offDiag = param->offDiag;
+    const float x = muestra[0] + param->offset[0];
+    const float y = muestra[1] + param->offset[1];
+    const float z = muestra[2] + param->offset[2];
+
+    const float A = (diag[0]    * x) + (offDiag[0] * y) + (offDiag[1] * z);
+    const float B = (offDiag[0] * x) + (diag[1]    * y) + (offDiag[2] * z);
+    const float C = (offDiag[1] * x) + (offDiag[2] * y) + (diag[2]    * z);
+    const float longitud = sqrtf(A * A + B * B + C * C);
+    const float invLongitud = 1.0f / longitud;
+
+    // Derivadas parciales respecto al offset
+    float *jOffset = (fase == FASE_AJUSTE_MAG_ESFERA) ? &j[1] : &j[0];
+    jOffset[0] = -((diag[0]    * A) + (offDiag[0] * B) + (offDiag[1] * C)) * invLongitud;
+    jOffset[1] = -((offDiag[0] * A) + (diag[1]    * B) + (offDiag[2] * C)) * invLongitud;
+    jOffset[2] = -((offDiag[1] * A) + (offDiag[2] * B) + (diag[2]    * C)) * invLongitud;
+
+    if (fase == FASE_AJUSTE_MAG_ESFERA)
+        j[0] = 1.0f;
+    else {
+        j[3] = -(x * A) * invLongitud;
+        j[4] = -(y * B) * invLongitud;
+        j[5] = -(z * C) * invLongitud;
+
+        j[6] = -((y * A) + (x * B)) * invLongitud;
+        j[7] = -((z * A) + (x * C)) * invLongitud;
+        j[8] = -((z * B) + (y * C)) * invLongitud;
+    }
+
+    return param->radio - longitud;
+}
+
+
+/***************************************************************************************
+**  Nombre:         float residuoCalMag(const float *muestra, const calParamMag_t *param)
+**  Descripcion:    Calcula el residuo de una muestra
+**  Parametros:     Muestra, parametros
+**  Retorno:        Radio menos el modulo de la muestra corregida
+****************************************************************************************/
+float residuoCalMag(const float *muestra, const calParamMag_t *param)
+{
+    const float x = muestra[0] + param->offset[0];
+    const float y = muestra[1] + param->offset[1];
+    const float z = muestra[2] + param->offset[2];
+
+    const float A = (param->diag[0]    * x) + (param->offDiag[0] * y) + (param->offDiag[1] * z);
+    const float B = (param->offDiag[0] * x) + (param->diag[1]    * y) + (param->offDiag[2] * z);
+    const float C = (param->offDiag[1] * x) + (param->offDiag[2] * y) + (param->diag[2]    * z);
+
+    return param->radio - sqrtf(A * A + B * B + C * C);
+}
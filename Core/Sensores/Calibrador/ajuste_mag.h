@@ -0,0 +1,109 @@
+/***************************************************************************************
+**  ajuste_mag.h - Ajuste de la calibracion del magnetometro con Levenberg-Marquardt.
+**                 Se reparte en pasadas acotadas por ciclo del scheduler
+**
+**
+**  Este fichero forma parte del proyecto URpilot.
+**  Codigo desarrollado por el grupo de investigacion ICON de la Universidad de La Rioja
+**
+**  Autor: Ramon Rico
+**  Fecha de creacion: 17/10/2026
+**  Fecha de modificacion: 17/10/2026
+**
+**  El proyecto URpilot NO es libre. No se puede distribuir y/o modificar este fichero
+**  bajo ningun concepto.
+**
+**  En caso de modificacion y/o solicitud de informacion pongase en contacto con
+**  el grupo de investigacion ICON a traves de: www.unirioja.es/urpilot
+**
+**
+**  Control de versiones del fichero
+**
+**  v1.0  Ramon Rico. Se ha liberado la primera version estable
+**
+****************************************************************************************/
+
+#ifndef __AJUSTE_MAG_H_
+#define __AJUSTE_MAG_H_
+
+/***************************************************************************************
+** AREA DE INCLUDES                                                                   **
+****************************************************************************************/
+#include <stdint.h>
+#include <stdbool.h>
+
+
+/***************************************************************************************
+** AREA DE PREPROCESADOR                                                              **
+****************************************************************************************/
+#define NUM_MAX_MUESTRAS_AJUSTE_MAG         500
+#define NUM_PARAMETROS_ESFERA_AJUSTE_MAG    4           // Radio y offset
+#define NUM_PARAMETROS_ELIPSE_AJUSTE_MAG    9           // Offset, diagonal y fuera de la diagonal
+#define NUM_SECTORES_AJUSTE_MAG             32          // 8 sectores en azimut por 4 bandas de igual area
+#define RADIO_INICIAL_AJUSTE_MAG            200.0f      // mGa. Hasta tener la esfera lineal. Tambien escala sus ecuaciones
+
+
+/***************************************************************************************
+** AREA DE DEFINICION DE TIPOS                                                        **
+****************************************************************************************/
+typedef struct {
+    float radio;
+    float offset[3];
+    float diag[3];
+    float offDiag[3];
+} calParamMag_t;
+
+typedef enum {
+    FASE_AJUSTE_MAG_ESFERA = 0,
+    FASE_AJUSTE_MAG_ELIPSE,
+} faseAjusteMag_e;
+
+typedef struct {
+    // Muestras y ecuaciones normales de la esfera lineal |m - c|^2 = r^2, que se acumulan al llegar
+    // cada muestra. Se centran en la primera muestra para no perder precision
+    uint16_t numMuestras;
+    float muestras[NUM_MAX_MUESTRAS_AJUSTE_MAG][3];
+    float origen[3];
+    float normalEsfera[NUM_PARAMETROS_ESFERA_AJUSTE_MAG][NUM_PARAMETROS_ESFERA_AJUSTE_MAG];
+    float terminoEsfera[NUM_PARAMETROS_ESFERA_AJUSTE_MAG];
+    float factorDistancia;                                              // Distancia minima entre muestras por unidad de radio
+    float distanciaMin;
+    uint32_t sectores;                                                  // Sectores con muestras respecto al centro estimado
+
+    // Levenberg-Marquardt. Cada iteracion es una pasada por las muestras que evalua el candidato y
+    // acumula sus ecuaciones normales. Si se rechaza se reutilizan las de los parametros aceptados
+    faseAjusteMag_e fase;
+    uint8_t numParametros;
+    calParamMag_t param;
+    calParamMag_t candidato;
+    float lambda;
+    float fitness;                                                      // Residuo cuadratico medio de param
+    float mejoraRelativa;                                               // Del ultimo paso aceptado
+    uint16_t numIteraciones;
+    uint16_t indicePasada;
+    float sumaResiduoPasada;
+    uint32_t sectoresPasada;
+    float JTJpasada[NUM_PARAMETROS_ELIPSE_AJUSTE_MAG][NUM_PARAMETROS_ELIPSE_AJUSTE_MAG];
+    float JTFpasada[NUM_PARAMETROS_ELIPSE_AJUSTE_MAG];
+    float JTJ[NUM_PARAMETROS_ELIPSE_AJUSTE_MAG][NUM_PARAMETROS_ELIPSE_AJUSTE_MAG];
+    float JTF[NUM_PARAMETROS_ELIPSE_AJUSTE_MAG];
+} ajusteMag_t;
+
+
+/***************************************************************************************
+** AREA DE DECLARACION DE VARIABLES                                                   **
+****************************************************************************************/
+
+
+/***************************************************************************************
+** AREA DE PROTOTIPOS DE FUNCION                                                      **
+****************************************************************************************/
+void iniciarAjusteMag(ajusteMag_t *ajuste);
+bool anadirMuestraAjusteMag(ajusteMag_t *ajuste, const float *muestra);
+void iniciarIteracionesAjusteMag(ajusteMag_t *ajuste, faseAjusteMag_e fase);
+bool iterarAjusteMag(ajusteMag_t *ajuste, uint16_t maxMuestras);
+float residuoRMSajusteMag(const ajusteMag_t *ajuste);
+float coberturaAjusteMag(const ajusteMag_t *ajuste);
+float residuoCalMag(const float *muestra, const calParamMag_t *param);
+
+#endif // __AJUSTE_MAG_H_
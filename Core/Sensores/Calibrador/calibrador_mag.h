@@ -6,7 +6,7 @@
 **
 **  Autor: Ramon Rico
 **  Fecha de creacion: 10/04/2021
-**  Fecha de modificacion: 10/04/2021
+**  Fecha de modificacion: 17/10/2026
 **
 **  El proyecto URpilot NO es libre. No se puede distribuir y/o modificar este fichero
 **  bajo ningun concepto.
@@ -31,6 +31,7 @@
 #include <stdbool.h>
 
 #include "Sistema/plataforma.h"
+#include "ajuste_mag.h"
 
 
 /***************************************************************************************
@@ -42,12 +43,13 @@
 ** AREA DE DEFINICION DE TIPOS                                                        **
 ****************************************************************************************/
 typedef struct {
-    float radio;
-	float offset[3];
-    float diag[3];
-    float offDiag[3];
-} calParamMag_t;
-
+    bool terminado;
+    bool exito;
+    uint16_t numMuestras;
+    uint16_t numIteraciones;
+    float cobertura;                        // % de la esfera con muestras
+    float residuoRMS;                       // mGa
+} infoCalMag_t;
 
 
 /***************************************************************************************
@@ -63,5 +65,6 @@ void terminarCalMag(void);
 void actualizarCalMag(uint32_t tiempoActual);
 bool calibracionMagExitosa(uint8_t numCal);
 calParamMag_t parametrosCalMAg(uint8_t numCal);
+void infoCalMag(uint8_t numCal, infoCalMag_t *info);
 
 #endif // __CALIBRADOR_MAG_H_
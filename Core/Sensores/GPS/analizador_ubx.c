@@ -0,0 +1,335 @@
+/***************************************************************************************
+**  analizador_ubx.c - Analizador de tramas UBX sobre bloques contiguos de recepcion. Las tramas
+**                     completas se validan y se entregan sin copiarlas
+**
+**
+**  Este fichero forma parte del proyecto URpilot.
+**  Codigo desarrollado por el grupo de investigacion ICON de la Universidad de La Rioja
+**
+**  Autor: Ramon Rico
+**  Fecha de creacion: 17/10/2026
+**  Fecha de modificacion: 17/10/2026
+**
+**  El proyecto URpilot NO es libre. No se puede distribuir y/o modificar este fichero
+**  bajo ningun concepto.
+**
+**  En caso de modificacion y/o solicitud de informacion pongase en contacto con
+**  el grupo de investigacion ICON a traves de: www.unirioja.es/urpilot
+**
+**
+**  Control de versiones del fichero
+**
+**  v1.0  Ramon Rico. Se ha liberado la primera version estable
+**
+****************************************************************************************/
+
+/***************************************************************************************
+** AREA DE INCLUDES                                                                   **
+****************************************************************************************/
+#include <string.h>
+
+#include "analizador_ubx.h"
+#include "Comun/matematicas.h"
+
+
+/***************************************************************************************
+** AREA DE PREPROCESADOR                                                              **
+****************************************************************************************/
+#define BITS_POR_BYTE_UART_UBX                10          // 8N1
+
+
+/***************************************************************************************
+** AREA DE DEFINICION DE TIPOS                                                        **
+****************************************************************************************/
+
+
+/***************************************************************************************
+** AREA DE DECLARACION DE VARIABLES                                                   **
+****************************************************************************************/
+
+
+/***************************************************************************************
+** AREA DE PROTOTIPOS DE FUNCION                                                      **
+****************************************************************************************/
+uint16_t longitudTramaUBX(const uint8_t *cabecera);
+bool validarTramaUBX(analizadorUBX_t *analizador, const uint8_t *trama, uint32_t tiempoRecepcion);
+uint16_t completarReensambladoUBX(analizadorUBX_t *analizador, const uint8_t *datos, uint16_t longitud, uint16_t bytesPosteriores,
+		                          uint32_t tiempoUs);
+void descartarReensambladoUBX(analizadorUBX_t *analizador);
+
+
+/***************************************************************************************
+** AREA DE DEFINICION DE FUNCIONES                                                    **
+****************************************************************************************/
+
+/***************************************************************************************
+**  Nombre:         void iniciarAnalizadorUBX(analizadorUBX_t *analizador, uint32_t baudrate, callbackTramaUBX callback,
+**                                            void *paramUsuario)
+**  Descripcion:    Inicia el analizador
+**  Parametros:     Analizador, baudrate de la UART para estimar el instante de llegada,
+**                  callback de trama valida y parametro del callback
+**  Retorno:        Ninguno
+****************************************************************************************/
+void iniciarAnalizadorUBX(analizadorUBX_t *analizador, uint32_t baudrate, callbackTramaUBX callback, void *paramUsuario)
+{
+    memset(analizador, 0, sizeof(*analizador));
+    analizador->callback = callback;
+    analizador->paramUsuario = paramUsuario;
+    ajustarBaudrateAnalizadorUBX(analizador, baudrate);
+}
+
+
+/***************************************************************************************
+**  Nombre:         void ajustarBaudrateAnalizadorUBX(analizadorUBX_t *analizador, uint32_t baudrate)
+**  Descripcion:    Ajusta el tiempo de un byte en la linea
+**  Parametros:     Analizador, baudrate de la UART. Con 0 no se corrige el instante de llegada
+**  Retorno:        Ninguno
+****************************************************************************************/
+void ajustarBaudrateAnalizadorUBX(analizadorUBX_t *analizador, uint32_t baudrate)
+{
+    analizador->usPorByte = baudrate > 0 ? (float)BITS_POR_BYTE_UART_UBX * 1.0e6f / baudrate : 0.0f;
+}
+
+
+/***************************************************************************************
+**  Nombre:         uint16_t analizarBloqueUBX(analizadorUBX_t *analizador, const uint8_t *datos, uint16_t longitud,
+**                                             uint16_t bytesPosteriores, uint32_t tiempoUs, bool retener)
+**  Descripcion:    Analiza un bloque contiguo de bytes recibidos. Las tramas completas se validan
+**                  en una pasada y se entregan apuntando al propio bloque. El instante de llegada
+**                  de cada trama se estima restando al tiempo de lectura los bytes recibidos
+**                  despues de ella. Una trama incompleta al final del bloque se deja sin consumir
+**                  si se pide retenerla o se copia al buffer de reensamblado si no
+**  Parametros:     Analizador, bloque, longitud del bloque, bytes ya recibidos tras el bloque,
+**                  instante de lectura en us, retener la trama incompleta del final
+**  Retorno:        Bytes consumidos del bloque
+****************************************************************************************/
+uint16_t analizarBloqueUBX(analizadorUBX_t *analizador, const uint8_t *datos, uint16_t longitud, uint16_t bytesPosteriores,
+		                   uint32_t tiempoUs, bool retener)
+{
+    estadisticasAnalizadorUBX_t *estadisticas = &analizador->estadisticas;
+    uint16_t i = 0;
+
+    if (analizador->numReensamblado > 0)
+        i = completarReensambladoUBX(analizador, datos, longitud, bytesPosteriores, tiempoUs);
+
+    while (i < longitud) {
+        const uint8_t *sync = memchr(&datos[i], SYNC1_UBX, longitud - i);
+
+        if (sync == NULL) {
+            estadisticas->bytesDescartados += longitud - i;
+            i = longitud;
+            break;
+        }
+
+        estadisticas->bytesDescartados += sync - &datos[i];
+        i = sync - datos;
+
+        const uint16_t disponibles = longitud - i;
+
+        if (disponibles >= 2 && datos[i + 1] != SYNC2_UBX) {
+            estadisticas->bytesDescartados++;
+            i++;
+            continue;
+        }
+
+        if (disponibles >= TAM_CABECERA_UBX) {
+            const uint16_t tamTrama = longitudTramaUBX(&datos[i]);
+
+            if (tamTrama == 0) {
+                estadisticas->numLongitudInvalida++;
+                estadisticas->bytesDescartados++;
+                i++;
+                continue;
+            }
+
+            if (disponibles >= tamTrama) {
+                const uint32_t bytesTras = disponibles - tamTrama + bytesPosteriores;
+
+                if (validarTramaUBX(analizador, &datos[i], tiempoUs - (uint32_t)(bytesTras * analizador->usPorByte)))
+                    i += tamTrama;
+                else {
+                    estadisticas->bytesDescartados++;
+                    i++;
+                }
+                continue;
+            }
+        }
+
+        // Trama incompleta al final del bloque
+        if (retener)
+            break;
+
+        memcpy(analizador->reensamblado, &datos[i], disponibles);
+        analizador->numReensamblado = disponibles;
+        i = longitud;
+    }
+
+    estadisticas->bytesAnalizados += i;
+    return i;
+}
+
+
+/***************************************************************************************
+**  Nombre:         void checksumUBX(const uint8_t *datos, uint16_t longitud, uint8_t *ckA, uint8_t *ckB)
+**  Descripcion:    Calcula el checksum de Fletcher de 8 bits de los datos en una pasada
+**  Parametros:     Datos (desde la clase hasta el final del payload), longitud, checksum
+**  Retorno:        Ninguno
+****************************************************************************************/
+void checksumUBX(const uint8_t *datos, uint16_t longitud, uint8_t *ckA, uint8_t *ckB)
+{
+    // Con acumuladores de 32 bits no hace falta truncar en cada byte. Con la longitud
+    // maxima de una trama no hay desbordamiento
+    uint32_t a = 0, b = 0;
+
+    while (longitud >= 4) {
+        a += datos[0];
+        b += a;
+        a += datos[1];
+        b += a;
+        a += datos[2];
+        b += a;
+        a += datos[3];
+        b += a;
+        datos += 4;
+        longitud -= 4;
+    }
+
+    while (longitud--) {
+        a += *datos++;
+        b += a;
+    }
+
+    *ckA = (uint8_t)a;
+    *ckB = (uint8_t)b;
+}
+
+
+/***************************************************************************************
+**  Nombre:         uint16_t longitudTramaUBX(const uint8_t *cabecera)
+**  Descripcion:    Calcula la longitud total de una trama a partir de su cabecera
+**  Parametros:     Cabecera completa de la trama
+**  Retorno:        Longitud de la trama o 0 si el payload no cabe
+****************************************************************************************/
+uint16_t longitudTramaUBX(const uint8_t *cabecera)
+{
+    const uint16_t longitudPayload = cabecera[4] | (uint16_t)(cabecera[5] << 8);
+
+    if (longitudPayload > TAM_MAX_PAYLOAD_UBX)
+        return 0;
+
+    return TAM_CABECERA_UBX + longitudPayload + TAM_CHECKSUM_UBX;
+}
+
+
+/***************************************************************************************
+**  Nombre:         bool validarTramaUBX(analizadorUBX_t *analizador, const uint8_t *trama, uint32_t tiempoRecepcion)
+**  Descripcion:    Comprueba el checksum de una trama completa y la entrega al callback
+**  Parametros:     Analizador, trama desde el primer byte de sincronismo, instante de llegada
+**  Retorno:        True si el checksum es correcto
+****************************************************************************************/
+bool validarTramaUBX(analizadorUBX_t *analizador, const uint8_t *trama, uint32_t tiempoRecepcion)
+{
+    const uint16_t longitudPayload = trama[4] | (uint16_t)(trama[5] << 8);
+    uint8_t ckA, ckB;
+
+    checksumUBX(&trama[2], TAM_CABECERA_UBX - 2 + longitudPayload, &ckA, &ckB);
+
+    if (ckA != trama[TAM_CABECERA_UBX + longitudPayload] || ckB != trama[TAM_CABECERA_UBX + longitudPayload + 1]) {
+        analizador->estadisticas.numErroresChecksum++;
+        return false;
+    }
+
+    analizador->estadisticas.numTramas++;
+
+    if (analizador->callback != NULL) {
+        tramaUBX_t mensaje;
+
+        mensaje.clase = trama[2];
+        mensaje.id = trama[3];
+        mensaje.longitud = longitudPayload;
+        mensaje.payload = &trama[TAM_CABECERA_UBX];
+        mensaje.tiempoRecepcion = tiempoRecepcion;
+        analizador->callback(&mensaje, analizador->paramUsuario);
+    }
+
+    return true;
+}
+
+
+/***************************************************************************************
+**  Nombre:         uint16_t completarReensambladoUBX(analizadorUBX_t *analizador, const uint8_t *datos, uint16_t longitud,
+**                                                    uint16_t bytesPosteriores, uint32_t tiempoUs)
+**  Descripcion:    Completa la trama pendiente con los bytes del bloque. Solo se copian los
+**                  bytes que le faltan. Si la trama es invalida se busca el siguiente
+**                  sincronismo dentro de lo ya copiado
+**  Parametros:     Analizador, bloque, longitud del bloque, bytes ya recibidos tras el bloque,
+**                  instante de lectura en us
+**  Retorno:        Bytes consumidos del bloque
+****************************************************************************************/
+uint16_t completarReensambladoUBX(analizadorUBX_t *analizador, const uint8_t *datos, uint16_t longitud, uint16_t bytesPosteriores,
+		                          uint32_t tiempoUs)
+{
+    uint16_t i = 0;
+
+    while (analizador->numReensamblado > 0) {
+        uint8_t *trama = analizador->reensamblado;
+        uint16_t necesarios = TAM_CABECERA_UBX;
+
+        if (analizador->numReensamblado >= 2 && trama[1] != SYNC2_UBX) {
+            descartarReensambladoUBX(analizador);
+            continue;
+        }
+
+        if (analizador->numReensamblado >= TAM_CABECERA_UBX) {
+            necesarios = longitudTramaUBX(trama);
+
+            if (necesarios == 0) {
+                analizador->estadisticas.numLongitudInvalida++;
+                descartarReensambladoUBX(analizador);
+                continue;
+            }
+        }
+
+        if (analizador->numReensamblado < necesarios) {
+            const uint16_t copiar = MIN(necesarios - analizador->numReensamblado, longitud - i);
+
+            if (copiar == 0)
+                break;
+
+            memcpy(&trama[analizador->numReensamblado], &datos[i], copiar);
+            analizador->numReensamblado += copiar;
+            i += copiar;
+            continue;
+        }
+
+        // Trama completa. Nunca se copia mas de una trama
+        const uint32_t bytesTras = longitud - i + bytesPosteriores;
+
+        if (validarTramaUBX(analizador, trama, tiempoUs - (uint32_t)(bytesTras * analizador->usPorByte))) {
+            analizador->estadisticas.numReensambladas++;
+            analizador->numReensamblado = 0;
+        }
+        else
+            descartarReensambladoUBX(analizador);
+    }
+
+    return i;
+}
+
+
+/***************************************************************************************
+**  Nombre:         void descartarReensambladoUBX(analizadorUBX_t *analizador)
+**  Descripcion:    Descarta el sincronismo de la trama pendiente y adelanta el buffer hasta el
+**                  siguiente posible inicio de trama
+**  Parametros:     Analizador
+**  Retorno:        Ninguno
+****************************************************************************************/
+void descartarReensambladoUBX(analizadorUBX_t *analizador)
+{
+    const uint8_t *sync = memchr(&analizador->reensamblado[1], SYNC1_UBX, analizador->numReensamblado - 1);
+    const uint16_t descartados = sync != NULL ? sync - analizador->reensamblado : analizador->numReensamblado;
+
+    analizador->estadisticas.bytesDescartados += descartados;
+    analizador->numReensamblado -= descartados;
+    memmove(analizador->reensamblado, &analizador->reensamblado[descartados], analizador->numReensamblado);
+}
@@ -0,0 +1,97 @@
+/***************************************************************************************
+**  analizador_ubx.h - Analizador de tramas UBX sobre bloques contiguos de recepcion
+**
+**
+**  Este fichero forma parte del proyecto URpilot.
+**  Codigo desarrollado por el grupo de investigacion ICON de la Universidad de La Rioja
+**
+**  Autor: Ramon Rico
+**  Fecha de creacion: 17/10/2026
+**  Fecha de modificacion: 17/10/2026
+**
+**  El proyecto URpilot NO es libre. No se puede distribuir y/o modificar este fichero
+**  bajo ningun concepto.
+**
+**  En caso de modificacion y/o solicitud de informacion pongase en contacto con
+**  el grupo de investigacion ICON a traves de: www.unirioja.es/urpilot
+**
+**
+**  Control de versiones del fichero
+**
+**  v1.0  Ramon Rico. Se ha liberado la primera version estable
+**
+****************************************************************************************/
+
+#ifndef __ANALIZADOR_UBX_H
+#define __ANALIZADOR_UBX_H
+
+/***************************************************************************************
+** AREA DE INCLUDES                                                                   **
+****************************************************************************************/
+#include <stdint.h>
+#include <stdbool.h>
+
+
+/***************************************************************************************
+** AREA DE PREPROCESADOR                                                              **
+****************************************************************************************/
+#define SYNC1_UBX                             0xB5
+#define SYNC2_UBX                             0x62
+#define TAM_CABECERA_UBX                      6           // Sincronismo, clase, id y longitud
+#define TAM_CHECKSUM_UBX                      2
+#define TAM_MAX_PAYLOAD_UBX                   256
+#define TAM_MAX_TRAMA_UBX                     (TAM_CABECERA_UBX + TAM_MAX_PAYLOAD_UBX + TAM_CHECKSUM_UBX)
+
+
+/***************************************************************************************
+** AREA DE DEFINICION DE TIPOS                                                        **
+****************************************************************************************/
+// El payload apunta al bloque que se esta analizando o al buffer de reensamblado del
+// analizador. Solo es valido durante el callback y puede no estar alineado
+typedef struct {
+    uint8_t clase;
+    uint8_t id;
+    uint16_t longitud;
+    const uint8_t *payload;
+    uint32_t tiempoRecepcion;                   // us estimados de llegada del ultimo byte
+} tramaUBX_t;
+
+typedef void (*callbackTramaUBX)(const tramaUBX_t *trama, void *paramUsuario);
+
+typedef struct {
+    uint32_t numTramas;
+    uint32_t numReensambladas;                  // Tramas que cruzaban dos bloques y se han copiado
+    uint32_t numErroresChecksum;
+    uint32_t numLongitudInvalida;
+    uint32_t bytesDescartados;                  // Bytes fuera de una trama valida
+    uint32_t bytesAnalizados;
+} estadisticasAnalizadorUBX_t;
+
+typedef struct {
+    callbackTramaUBX callback;
+    void *paramUsuario;
+    float usPorByte;
+
+    // Trama que cruza el final de un bloque
+    uint16_t numReensamblado;
+    uint8_t reensamblado[TAM_MAX_TRAMA_UBX];
+
+    estadisticasAnalizadorUBX_t estadisticas;
+} analizadorUBX_t;
+
+
+/***************************************************************************************
+** AREA DE DECLARACION DE VARIABLES                                                   **
+****************************************************************************************/
+
+
+/***************************************************************************************
+** AREA DE PROTOTIPOS DE FUNCION                                                      **
+****************************************************************************************/
+void iniciarAnalizadorUBX(analizadorUBX_t *analizador, uint32_t baudrate, callbackTramaUBX callback, void *paramUsuario);
+void ajustarBaudrateAnalizadorUBX(analizadorUBX_t *analizador, uint32_t baudrate);
+uint16_t analizarBloqueUBX(analizadorUBX_t *analizador, const uint8_t *datos, uint16_t longitud, uint16_t bytesPosteriores,
+		                   uint32_t tiempoUs, bool retener);
+void checksumUBX(const uint8_t *datos, uint16_t longitud, uint8_t *ckA, uint8_t *ckB);
+
+#endif // __ANALIZADOR_UBX_H
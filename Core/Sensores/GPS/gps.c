@@ -7,7 +7,7 @@
 **
 **  Autor: Ramon Rico
 **  Fecha de creacion: 14/06/2019
-**  Fecha de modificacion: 20/09/2020
+**  Fecha de modificacion: 17/10/2026
 **
 **  EL proyecto URpilot NO es libre. No se puede distribuir y/o modificar este fichero
 **  bajo ningun concepto.
@@ -28,6 +28,7 @@
 #include <stdio.h>
 #include <string.h>
 #include <math.h>
+#include <float.h>
 
 #include "gps.h"
 
@@ -131,6 +132,7 @@ bool iniciarGPS(void)
         config.lWord = UART_LONGITUD_WORD_8;
         config.paridad = UART_NO_PARIDAD;
         config.stop = UART_BIT_STOP_1;
+        driver->deteccion.baudrate = config.baudrate;
 
         if (!uartIniciada(configGPS(i)->dispUART))
             iniciarUART(configGPS(i)->dispUART, config, NULL);
@@ -179,6 +181,7 @@ bool detectarGPS(gps_t *dGPS)
         	dGPS->deteccion.baudrateActual = 0;
 
         ajustarBaudRateUART(configGPS(dGPS->numGPS)->dispUART, gpsBaudrates[dGPS->deteccion.baudrateActual]);
+        dGPS->deteccion.baudrate = gpsBaudrates[dGPS->deteccion.baudrateActual];
         dGPS->deteccion.ultimoCambioBaudMs = tiempo;
 
         if (configGPS(dGPS->numGPS)->tipoGPS == GPS_UBLOX_NEO_6M || configGPS(dGPS->numGPS)->tipoGPS == GPS_UBLOX_NEO_7M || configGPS(gps->numGPS)->tipoGPS == GPS_UBLOX_NEO_M8)
@@ -241,18 +244,11 @@ void enviarBloqueConfigGPS(gps_t *dGPS)
 {
     // Comprueba si quedan bytes por enviar
     if (dGPS->bloqueConfiguracion.charRestantes > 0) {
-        int16_t espacio;
+        const uint16_t escritos = escribirBufferUART(configGPS(dGPS->numGPS)->dispUART, (const uint8_t *)dGPS->bloqueConfiguracion.mensaje,
+                                                     dGPS->bloqueConfiguracion.charRestantes);
 
-        espacio = bytesLibresBufferTxUART(configGPS(dGPS->numGPS)->dispUART);
-        if (espacio > (int16_t) dGPS->bloqueConfiguracion.charRestantes)
-            espacio = dGPS->bloqueConfiguracion.charRestantes;
-
-        while (espacio > 0) {
-            escribirUART(configGPS(dGPS->numGPS)->dispUART, *dGPS->bloqueConfiguracion.mensaje);
-            dGPS->bloqueConfiguracion.mensaje++;
-            espacio--;
-            dGPS->bloqueConfiguracion.charRestantes--;
-        }
+        dGPS->bloqueConfiguracion.mensaje += escritos;
+        dGPS->bloqueConfiguracion.charRestantes -= escritos;
     }
 }
 
@@ -508,6 +504,14 @@ bool calcularPesosMezclaGPS(void)
 ****************************************************************************************/
 void mezclarMedidasGPS(void)
 {
+    // Se parte de cero en cada mezcla. Las precisiones se quedan con la mejor de los receptores
+    memset(&gpsGen, 0, sizeof(gpsGen_t));
+    gpsGen.estado.hdop = DOP_DESCONOCIDO_GPS;
+    gpsGen.estado.vdop = DOP_DESCONOCIDO_GPS;
+    gpsGen.estado.precisionHorizontal = FLT_MAX;
+    gpsGen.estado.precisionVertical = FLT_MAX;
+    gpsGen.estado.precisionVel = FLT_MAX;
+
     for (uint8_t i = 0; i < NUM_MAX_GPS; i++) {
         gps_t *driver = &gps[i];
 
@@ -534,7 +538,7 @@ void mezclarMedidasGPS(void)
 
         if (driver->estado.tienePrecisionVel && driver->estado.precisionVel > 0 && driver->estado.precisionVel < gpsGen.estado.precisionVel) {
     	    gpsGen.estado.tienePrecisionVel = true;
-    	    gpsGen.estado.precisionVel = gpsGen.estado.precisionVel;
+    	    gpsGen.estado.precisionVel = driver->estado.precisionVel;
         }
 
         if (driver->estado.hdop > 0 && driver->estado.hdop < gpsGen.estado.hdop)
@@ -546,6 +550,12 @@ void mezclarMedidasGPS(void)
         if (driver->estado.numSats > 0 && driver->estado.numSats > gpsGen.estado.numSats)
     	    gpsGen.estado.numSats = driver->estado.numSats;
 
+        if (pesosGPS[i] > 0 && driver->estado.ultimaHoraGPSms > gpsGen.estado.ultimaHoraGPSms)
+            gpsGen.estado.ultimaHoraGPSms = driver->estado.ultimaHoraGPSms;
+
+        if (pesosGPS[i] > 0 && driver->estado.tiempoSolucionUs > gpsGen.estado.tiempoSolucionUs)
+            gpsGen.estado.tiempoSolucionUs = driver->estado.tiempoSolucionUs;
+
         gpsGen.velocidad.norte += driver->velocidad.norte * pesosGPS[i];
         gpsGen.velocidad.este += driver->velocidad.este * pesosGPS[i];
         gpsGen.velocidad.vertical += driver->velocidad.vertical * pesosGPS[i];
@@ -580,6 +590,15 @@ void mezclarMedidasGPS(void)
 
     anadirOffsetLoc(offsetNE[0], offsetNE[1], offsetAlt, &gpsGen.localizacion);
 
+    if (!gpsGen.estado.tienePrecisionHorizontal)
+        gpsGen.estado.precisionHorizontal = 0;
+
+    if (!gpsGen.estado.tienePrecisionVertical)
+        gpsGen.estado.precisionVertical = 0;
+
+    if (!gpsGen.estado.tienePrecisionVel)
+        gpsGen.estado.precisionVel = 0;
+
     float vector[2] = {gpsGen.velocidad.norte, gpsGen.velocidad.este};
     gpsGen.vel2d = moduloVector2(vector);
     gpsGen.velAngular = envolverInt360(grados(atan2f(gpsGen.velocidad.este, gpsGen.velocidad.norte)), 1);
@@ -724,6 +743,83 @@ uint8_t satelitesGPS(void)
 }
 
 
+/***************************************************************************************
+**  Nombre:         gpsStatus_e statusGPS(void)
+**  Descripcion:    Devuleve el tipo de fix del GPS general
+**  Parametros:     Ninguno
+**  Retorno:        Tipo de fix
+****************************************************************************************/
+gpsStatus_e statusGPS(void)
+{
+    return gpsGen.estado.status;
+}
+
+
+/***************************************************************************************
+**  Nombre:         void velocidadGPS(float *vel)
+**  Descripcion:    Devuleve la velocidad NED del GPS general
+**  Parametros:     Velocidad en m/s
+**  Retorno:        Ninguno
+****************************************************************************************/
+void velocidadGPS(float *vel)
+{
+    vel[0] = gpsGen.velocidad.norte;
+    vel[1] = gpsGen.velocidad.este;
+    vel[2] = gpsGen.velocidad.vertical;
+}
+
+
+/***************************************************************************************
+**  Nombre:         void precisionGPS(float *horizontal, float *vertical, float *vel)
+**  Descripcion:    Devuleve la precision del GPS general. Es cero si el receptor no la da
+**  Parametros:     Precision horizontal y vertical en m, precision de la velocidad en m/s
+**  Retorno:        Ninguno
+****************************************************************************************/
+void precisionGPS(float *horizontal, float *vertical, float *vel)
+{
+    *horizontal = gpsGen.estado.tienePrecisionHorizontal ? gpsGen.estado.precisionHorizontal : 0;
+    *vertical = gpsGen.estado.tienePrecisionVertical ? gpsGen.estado.precisionVertical : 0;
+    *vel = gpsGen.estado.tienePrecisionVel ? gpsGen.estado.precisionVel : 0;
+}
+
+
+/***************************************************************************************
+**  Nombre:         bool tieneVelVerticalGPS(void)
+**  Descripcion:    Devuleve si el GPS general da velocidad vertical
+**  Parametros:     Ninguno
+**  Retorno:        True si la da
+****************************************************************************************/
+bool tieneVelVerticalGPS(void)
+{
+    return gpsGen.estado.tieneVelVertical;
+}
+
+
+/***************************************************************************************
+**  Nombre:         uint32_t tiempoMedidaGPS(void)
+**  Descripcion:    Devuleve el instante de llegada de la ultima medida del GPS general
+**  Parametros:     Ninguno
+**  Retorno:        Tiempo en ms
+****************************************************************************************/
+uint32_t tiempoMedidaGPS(void)
+{
+    return gpsGen.estado.ultimaHoraGPSms;
+}
+
+
+/***************************************************************************************
+**  Nombre:         uint32_t tiempoSolucionGPS(void)
+**  Descripcion:    Devuleve el instante estimado de llegada del final de la ultima solucion del
+**                  GPS general, corregido con los bytes recibidos detras de ella
+**  Parametros:     Ninguno
+**  Retorno:        Tiempo en us
+****************************************************************************************/
+uint32_t tiempoSolucionGPS(void)
+{
+    return gpsGen.estado.tiempoSolucionUs;
+}
+
+
 /***************************************************************************************
 **  Nombre:         void localizacionNumGPS(uint8_t numGPS, localizacion_t *loc)
 **  Descripcion:    Devuleve la localizacion de un GPS
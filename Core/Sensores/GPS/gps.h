@@ -7,7 +7,7 @@
 **
 **  Autor: Ramon Rico
 **  Fecha de creacion: 14/06/2019
-**  Fecha de modificacion: 21/09/2020
+**  Fecha de modificacion: 17/10/2026
 **
 **  El proyecto URpilot NO es libre. No se puede distribuir y/o modificar este fichero
 **  bajo ningun concepto.
@@ -155,6 +155,7 @@ typedef struct {
 
 typedef struct {
     uint32_t ultimoCambioBaudMs;
+    uint32_t baudrate;
     uint8_t baudrateActual;
     ubxDeteccion_t ubloxDeteccion;
 } gpsEstadoDeteccion_t;
@@ -181,6 +182,7 @@ typedef struct {
     bool tienePrecisionHorizontal : 1;   // Este GPS proporciona precision horizontal?
     bool tienePrecisionVertical : 1;     // Este GPS proporciona precision vertical?
     uint32_t ultimaHoraGPSms;            // Ultima marca de tiempo del GPS en milisegundos
+    uint32_t tiempoSolucionUs;           // Llegada estimada del ultimo byte de la ultima solucion en us
 } estado_t;
 
 typedef struct {
@@ -215,6 +217,12 @@ void localizacionGPS(localizacion_t *loc);
 float vel2dGPS(void);
 float velAngularGPS(void);
 uint8_t satelitesGPS(void);
+gpsStatus_e statusGPS(void);
+void velocidadGPS(float *vel);
+void precisionGPS(float *horizontal, float *vertical, float *vel);
+bool tieneVelVerticalGPS(void);
+uint32_t tiempoMedidaGPS(void);
+uint32_t tiempoSolucionGPS(void);
 void localizacionNumGPS(uint8_t numGPS, localizacion_t *loc);
 float vel2dNumGPS(uint8_t numGPS);
 float velAngularNumGPS(uint8_t numGPS);
@@ -7,7 +7,7 @@
 **
 **  Autor: Ramon Rico
 **  Fecha de creacion: 14/06/2019
-**  Fecha de modificacion: 20/09/2020
+**  Fecha de modificacion: 17/10/2026
 **
 **  El proyecto URpilot NO es libre. No se puede distribuir y/o modificar este fichero
 **  bajo ningun concepto.
@@ -138,11 +138,12 @@ void solicitarPuertoGPSublox(gps_t *dGPS);
 bool solicitarFrecuenciaMensajeGPSublox(gps_t *dGPS, uint8_t msgClass, uint8_t msgId);
 bool enviarMensajeGPSublox(gps_t *dGPS, uint8_t msgClass, uint8_t msgId, void *msg, uint16_t tam);
 void actualizarChecksumGPSublox(uint8_t *dato, uint16_t len, uint8_t *ck_a, uint8_t *ck_b);
-bool analizarTramaGPSublox(gps_t *dGPS);
+void tramaRecibidaGPSublox(const tramaUBX_t *trama, void *paramUsuario);
+bool analizarTramaGPSublox(gps_t *dGPS, const tramaUBX_t *trama);
 void verificarFrecuenciaMensajeGPSublox(gps_t *dGPS, uint8_t clase, uint8_t id, uint8_t frec);
 bool configurarFrecuenciaMensajeGPSublox(gps_t *dGPS, uint8_t clase, uint8_t id, uint8_t frec);
 void configurarFrecuenciaNavegacionGPSublox(gps_t *dGPS);
-void mensajeInesperadoGPSublox(gps_t *dGPS);
+void mensajeInesperadoGPSublox(gps_t *dGPS, const tramaUBX_t *trama);
 
 
 /***************************************************************************************
@@ -167,6 +168,7 @@ void iniciarGPSublox(gps_t *dGPS)
     driver->mensajesNoConfig = CONFIG_TODO_GPS;
     driver->siguienteFix = NO_FIX;
     driver->puertoUblox = 255;
+    iniciarAnalizadorUBX(&driver->analizador, dGPS->deteccion.baudrate, tramaRecibidaGPSublox, dGPS);
 
     switch (configGPS(dGPS->numGPS)->tipoGPS) {
         case GPS_UBLOX_NEO_6M:
@@ -430,9 +432,7 @@ void actualizarChecksumGPSublox(uint8_t *dato, uint16_t len, uint8_t *ck_a, uint
 bool leerGPSublox(gps_t *dGPS)
 {
     gpsUblox_t *driver = dGPS->driver;
-    uint8_t dato;
-    uint16_t numc;
-    bool analizado = false;
+    const numUART_e dispUART = configGPS(dGPS->numGPS)->dispUART;
 
     if (driver->mensajesNoConfig != 0) {
         uint32_t tiempo = millis();
@@ -443,121 +443,80 @@ bool leerGPSublox(gps_t *dGPS)
         }
     }
 
-    numc = bytesRecibidosUART(configGPS(dGPS->numGPS)->dispUART);
+    driver->solucionNueva = false;
+    const uint32_t tiempoLectura = micros();
 
-    for (uint16_t i = 0; i < numc; i++) {                          // Procesa los bytes recibidos
-        dato = leerUART(configGPS(dGPS->numGPS)->dispUART);
+    // Como mucho son dos bloques: hasta el final del buffer y desde el principio
+    for (uint8_t i = 0; i < 2; i++) {
+        const uint8_t *datos;
+        const uint16_t longitud = bloqueRxUART(dispUART, &datos);
 
-      reset:
-        switch (driver->estadoLectura) {
-            /*
-            Deteccion del preamble del mensaje
+        if (longitud == 0)
+            break;
 
-            Si no podemos hacer coincidir cualquiera de los bytes esperados, reiniciamos
-            la maquina de estado y reconsidera el byte fallido como el primer byte del preamble.
-            Esto mejora nuestras posibilidades de recuperarse de un desajuste y lo hace menos
-            probable a que nos dejemos engañar por el pramble que aparece como datos en algun otro mensaje.
-            */
-            case 1:
-                if (PREAMBLE2 == dato) {
-                    driver->estadoLectura++;
-                    break;
-                }
-                else
-                    driver->estadoLectura = 0;
-                FALLTHROUGH;
+        // Una trama incompleta solo se deja en el buffer si el resto va a llegar a continuacion.
+        // Si cruza el final del buffer se copia al reensamblado del analizador
+        const uint16_t pendientes = bytesRecibidosUART(dispUART);
+        const uint16_t consumidos = analizarBloqueUBX(&driver->analizador, datos, longitud, pendientes - longitud, tiempoLectura,
+        		                                      longitud == pendientes);
 
-            case 0:
-                if (PREAMBLE1 == dato)
-                    driver->estadoLectura++;
-                break;
-            /*
-            Procesamiento del encabezado del mensaje
-
-            Detectamos la clase y el ID del mensaje para decidir si vamos a juntar los bytes del mensaje o simplemente descartarlos
-            Siempre recolectamos la longitud para que podamos evitar ser engañados por los bytes del preamble en los mensajes.
-            */
-            case 2:
-                driver->estadoLectura++;
-                driver->claseMensaje = dato;
-                driver->ckbMensaje = driver->ckaMensaje = dato;             // Resetea los acumuladores del checksum
-                break;
+        liberarRxUART(dispUART, consumidos);
 
-            case 3:
-                driver->estadoLectura++;
-                driver->ckbMensaje += (driver->ckaMensaje += dato);         // Checksum byte
-                driver->idMensaje = dato;
-                break;
+        if (consumidos < longitud)
+            break;
+    }
 
-            case 4:
-                driver->estadoLectura++;
-                driver->ckbMensaje += (driver->ckaMensaje += dato);         // Checksum byte
-                driver->longitudPayload = dato;                             // Byte bajo de longitud del payload
-                break;
+    return driver->solucionNueva;
+}
 
-            case 5:
-                driver->estadoLectura++;
-                driver->ckbMensaje += (driver->ckaMensaje += dato);         // Checksum byte
-                driver->longitudPayload += (uint16_t)(dato << 8);
-                if (driver->longitudPayload > TAM_BUFFER_RECEPCION_GPS_UBLOX) {
-                    driver->longitudPayload = 0;
-                    driver->estadoLectura = 0;
-                    goto reset;
-                }
-                if (driver->longitudPayload == 0)
-                    driver->estadoLectura = 7;
-                driver->contadorPayload = 0;                                // Prepara para recibir el payload
-                break;
 
-            // Recibe los datos del mensaje
-            case 6:
-                driver->ckbMensaje += (driver->ckaMensaje += dato);         // checksum byte
-                if (driver->contadorPayload < TAM_BUFFER_RECEPCION_GPS_UBLOX)
-                    driver->bufferRecepcion.buffer[driver->contadorPayload] = dato;
+/***************************************************************************************
+**  Nombre:         void estadisticasGPSublox(gps_t *dGPS, estadisticasAnalizadorUBX_t *estadisticas)
+**  Descripcion:    Devuelve las estadisticas del analizador de tramas de un GPS
+**  Parametros:     Puntero al GPS, estadisticas
+**  Retorno:        Ninguno
+****************************************************************************************/
+void estadisticasGPSublox(gps_t *dGPS, estadisticasAnalizadorUBX_t *estadisticas)
+{
+    gpsUblox_t *driver = dGPS->driver;
 
-                driver->contadorPayload++;
-                if (driver->contadorPayload == driver->longitudPayload)
-                    driver->estadoLectura++;
-                break;
+    *estadisticas = driver->analizador.estadisticas;
+}
 
-            // Procesamiento del checksum y el mensaje
-            case 7:
-                driver->estadoLectura++;
-                if (driver->ckaMensaje != dato) {
-                    driver->estadoLectura = 0;
-                    goto reset;
-                }
-                break;
 
-            case 8:
-                driver->estadoLectura = 0;
-                if (driver->ckbMensaje != dato)
-                    break;                                                  // Checksum incorrecto
+/***************************************************************************************
+**  Nombre:         void tramaRecibidaGPSublox(const tramaUBX_t *trama, void *paramUsuario)
+**  Descripcion:    Callback del analizador con cada trama valida
+**  Parametros:     Trama, GPS
+**  Retorno:        Ninguno
+****************************************************************************************/
+void tramaRecibidaGPSublox(const tramaUBX_t *trama, void *paramUsuario)
+{
+    gps_t *dGPS = paramUsuario;
+    gpsUblox_t *driver = dGPS->driver;
 
-                if (analizarTramaGPSublox(dGPS))
-                    analizado = true;
-                break;
-        }
-    }
-    return analizado;
+    if (analizarTramaGPSublox(dGPS, trama))
+        driver->solucionNueva = true;
 }
 
 
 /***************************************************************************************
-**  Nombre:         bool analizarTramaGPSublox(gps_t *dGPS)
-**  Descripcion:    Analiza el mensaje recibido
-**  Parametros:     Puntero al sensor
+**  Nombre:         bool analizarTramaGPSublox(gps_t *dGPS, const tramaUBX_t *trama)
+**  Descripcion:    Analiza el mensaje recibido. Los mensajes de navegacion se leen sin copiarlos
+**                  del bloque de la UART, por eso se comprueba su longitud antes de usarlos
+**  Parametros:     Puntero al sensor, trama recibida
 **  Retorno:        Trama analizada
 ****************************************************************************************/
-bool analizarTramaGPSublox(gps_t *dGPS)
+bool analizarTramaGPSublox(gps_t *dGPS, const tramaUBX_t *trama)
 {
     gpsUblox_t *driver = dGPS->driver;
+    const bufferRecepcion_u *mensaje = (const bufferRecepcion_u *)trama->payload;
 
-    if (driver->claseMensaje == CLASS_ACK) {
-        if (driver->idMensaje == MSG_ACK_ACK) {
-            switch (driver->bufferRecepcion.ack.clsID) {
+    if (trama->clase == CLASS_ACK) {
+        if (trama->id == MSG_ACK_ACK && trama->longitud >= sizeof(ackAckUBX_t)) {
+            switch (mensaje->ack.clsID) {
                 case CLASS_CFG:
-                    switch (driver->bufferRecepcion.ack.msgID) {
+                    switch (mensaje->ack.msgID) {
                         case MSG_CFG_CFG:
                             driver->cfgGuardada = true;
                             driver->cfgNecesitaGuardar = false;
@@ -600,8 +559,10 @@ bool analizarTramaGPSublox(gps_t *dGPS)
         return false;
     }
 
-    if (driver->claseMensaje == CLASS_CFG) {
-        switch (driver->idMensaje) {
+    if (trama->clase == CLASS_CFG) {
+        memcpy(driver->bufferRecepcion.buffer, trama->payload, MIN(trama->longitud, TAM_BUFFER_RECEPCION_GPS_UBLOX));
+
+        switch (trama->id) {
             case MSG_CFG_NAV_SETTINGS:
                 driver->bufferRecepcion.navSettings.mask = 0;
                 if (configGPS(dGPS->numGPS)->modoConf != GPS_ENGINE_NINGUNO && driver->bufferRecepcion.navSettings.dynModel != configGPS(dGPS->numGPS)->modoConf) {
@@ -679,7 +640,7 @@ bool analizarTramaGPSublox(gps_t *dGPS)
                 return false;
 
             case MSG_CFG_MSG:
-                if (driver->longitudPayload == sizeof(cfgMsgRate6UBX_t)) {
+                if (trama->longitud == sizeof(cfgMsgRate6UBX_t)) {
                     if (driver->puertoUblox >= NUM_MAX_PUERTOS_GPS_UBLOX) {
                         solicitarPuertoGPSublox(dGPS);
                         return false;
@@ -706,40 +667,46 @@ bool analizarTramaGPSublox(gps_t *dGPS)
         }
     }
 
-    if (driver->claseMensaje != CLASS_NAV) {
-        mensajeInesperadoGPSublox(dGPS);
+    if (trama->clase != CLASS_NAV) {
+        mensajeInesperadoGPSublox(dGPS, trama);
         return false;
     }
 
-    switch (driver->idMensaje) {
+    switch (trama->id) {
         case MSG_POSLLH:
+            if (trama->longitud < sizeof(mensaje->posllh))
+                return false;
+
             if (driver->tienePVTmsg) {
                 driver->mensajesNoConfig |= CONFIG_RATE_POSLLH_GPS;
                 break;
             }
-            driver->ultimoTiempoPos = driver->bufferRecepcion.posllh.itow;
-            dGPS->localizacion.longitud = driver->bufferRecepcion.posllh.longitude;
-            dGPS->localizacion.latitud = driver->bufferRecepcion.posllh.latitude;
-            dGPS->localizacion.altitud = driver->bufferRecepcion.posllh.altitudeMsl / 10;
+            driver->ultimoTiempoPos = mensaje->posllh.itow;
+            dGPS->localizacion.longitud = mensaje->posllh.longitude;
+            dGPS->localizacion.latitud = mensaje->posllh.latitude;
+            dGPS->localizacion.altitud = mensaje->posllh.altitudeMsl / 10;
             dGPS->estado.status = driver->siguienteFix;
             driver->nuevaPosicion = true;
-            dGPS->estado.precisionHorizontal = driver->bufferRecepcion.posllh.horizontalAccuracy * 1.0e-3f;
-            dGPS->estado.precisionVertical = driver->bufferRecepcion.posllh.verticalAccuracy * 1.0e-3f;
+            dGPS->estado.precisionHorizontal = mensaje->posllh.horizontalAccuracy * 1.0e-3f;
+            dGPS->estado.precisionVertical = mensaje->posllh.verticalAccuracy * 1.0e-3f;
             dGPS->estado.tienePrecisionHorizontal = true;
             dGPS->estado.tienePrecisionVertical = true;
             break;
 
         case MSG_STATUS:
+            if (trama->longitud < sizeof(mensaje->status))
+                return false;
+
             if (driver->tienePVTmsg) {
                 driver->mensajesNoConfig |= CONFIG_RATE_STATUS_GPS;
                 break;
             }
-            if (driver->bufferRecepcion.status.fixStatus & NAV_STATUS_FIX_VALID) {
-                if ((driver->bufferRecepcion.status.fixType == FIX_3D) && (driver->bufferRecepcion.status.fixStatus & NAV_STATUS_DGPS_USED))
+            if (mensaje->status.fixStatus & NAV_STATUS_FIX_VALID) {
+                if ((mensaje->status.fixType == FIX_3D) && (mensaje->status.fixStatus & NAV_STATUS_DGPS_USED))
                     driver->siguienteFix = GPS_OK_FIX_3D_DGPS;
-                else if (driver->bufferRecepcion.status.fixType == FIX_3D)
+                else if (mensaje->status.fixType == FIX_3D)
                     driver->siguienteFix = GPS_OK_FIX_3D;
-                else if (driver->bufferRecepcion.status.fixType == FIX_2D)
+                else if (mensaje->status.fixType == FIX_2D)
                     driver->siguienteFix = GPS_OK_FIX_2D;
                 else {
                     driver->siguienteFix = NO_FIX;
@@ -753,22 +720,28 @@ bool analizarTramaGPSublox(gps_t *dGPS)
             break;
 
         case MSG_DOP:
+            if (trama->longitud < sizeof(mensaje->dop))
+                return false;
+
             driver->hdopNoRecibido = false;
-            dGPS->estado.hdop = driver->bufferRecepcion.dop.hDOP;
-            dGPS->estado.vdop = driver->bufferRecepcion.dop.vDOP;
+            dGPS->estado.hdop = mensaje->dop.hDOP;
+            dGPS->estado.vdop = mensaje->dop.vDOP;
             break;
 
         case MSG_SOL:
+            if (trama->longitud < sizeof(mensaje->solution))
+                return false;
+
             if (driver->tienePVTmsg) {
-            	dGPS->estado.numSemana = driver->bufferRecepcion.solution.week;
+            	dGPS->estado.numSemana = mensaje->solution.week;
                 break;
             }
-            if (driver->bufferRecepcion.solution.fixStatus & NAV_STATUS_FIX_VALID) {
-                if ((driver->bufferRecepcion.solution.fixType == FIX_3D) && (driver->bufferRecepcion.solution.fixStatus & NAV_STATUS_DGPS_USED))
+            if (mensaje->solution.fixStatus & NAV_STATUS_FIX_VALID) {
+                if ((mensaje->solution.fixType == FIX_3D) && (mensaje->solution.fixStatus & NAV_STATUS_DGPS_USED))
                     driver->siguienteFix = GPS_OK_FIX_3D_DGPS;
-                else if (driver->bufferRecepcion.solution.fixType == FIX_3D)
+                else if (mensaje->solution.fixType == FIX_3D)
                     driver->siguienteFix = GPS_OK_FIX_3D;
-                else if (driver->bufferRecepcion.solution.fixType == FIX_2D)
+                else if (mensaje->solution.fixType == FIX_2D)
                     driver->siguienteFix = GPS_OK_FIX_2D;
                 else {
                     driver->siguienteFix = NO_FIX;
@@ -780,18 +753,18 @@ bool analizarTramaGPSublox(gps_t *dGPS)
                 dGPS->estado.status = NO_FIX;
             }
             if (driver->hdopNoRecibido)
-            	dGPS->estado.hdop = driver->bufferRecepcion.solution.positionDOP;
+            	dGPS->estado.hdop = mensaje->solution.positionDOP;
 
-            dGPS->estado.numSats = driver->bufferRecepcion.solution.satellites;
+            dGPS->estado.numSats = mensaje->solution.satellites;
             if (driver->siguienteFix >= GPS_OK_FIX_2D) {
             	dGPS->estado.ultimaHoraGPSms = millis();
-            	dGPS->estado.horaSemana = driver->bufferRecepcion.solution.itow;
-            	dGPS->estado.numSemana = driver->bufferRecepcion.solution.week;
+            	dGPS->estado.horaSemana = mensaje->solution.itow;
+            	dGPS->estado.numSemana = mensaje->solution.week;
 #ifdef USAR_RTC
                 // Ajustamos el RTC
-                if (!tieneHoraRTC() && (driver->bufferRecepcion.solution.fixStatus & NAV_STATUS_TIME_SECOND_VALID) && (driver->bufferRecepcion.solution.fixStatus & NAV_STATUS_TIME_WEEK_VALID)) {
+                if (!tieneHoraRTC() && (mensaje->solution.fixStatus & NAV_STATUS_TIME_SECOND_VALID) && (mensaje->solution.fixStatus & NAV_STATUS_TIME_WEEK_VALID)) {
                     //Calculamos el tiempo Unix: numero de semana * ms en una semana + ms de la semana + fracciones de segundo + offset del UNIX - 18 segundos de desfase entre tiempo Unix y el GPS
-                    int64_t tiempoUnix = (((int64_t) driver->bufferRecepcion.solution.week) * 7 * 24 * 60 * 60 * 1000) + driver->bufferRecepcion.solution.itow + (driver->bufferRecepcion.solution.timeNsec / 1000000) + 315964800000LL - configRTC()->offsetGPSutc * 1000;
+                    int64_t tiempoUnix = (((int64_t) mensaje->solution.week) * 7 * 24 * 60 * 60 * 1000) + mensaje->solution.itow + (mensaje->solution.timeNsec / 1000000) + 315964800000LL - configRTC()->offsetGPSutc * 1000;
                     ajustarUnixRTC(tiempoUnix);
                 }
 #endif
@@ -799,14 +772,17 @@ bool analizarTramaGPSublox(gps_t *dGPS)
             break;
 
         case MSG_PVT:
+            if (trama->longitud < sizeof(mensaje->pvt))
+                return false;
+
             driver->tienePVTmsg = true;
 
             // Posicion
-            driver->ultimoTiempoPos = driver->bufferRecepcion.pvt.itow;
-            dGPS->localizacion.longitud = driver->bufferRecepcion.pvt.lon;
-            dGPS->localizacion.latitud = driver->bufferRecepcion.pvt.lat;
-            dGPS->localizacion.altitud = driver->bufferRecepcion.pvt.h_msl / 10;
-            switch (driver->bufferRecepcion.pvt.fixType) {
+            driver->ultimoTiempoPos = mensaje->pvt.itow;
+            dGPS->localizacion.longitud = mensaje->pvt.lon;
+            dGPS->localizacion.latitud = mensaje->pvt.lat;
+            dGPS->localizacion.altitud = mensaje->pvt.h_msl / 10;
+            switch (mensaje->pvt.fixType) {
                 case 0:
                 	dGPS->estado.status = NO_FIX;
                     break;
@@ -821,11 +797,11 @@ bool analizarTramaGPSublox(gps_t *dGPS)
 
                 case 3:
                 	dGPS->estado.status = GPS_OK_FIX_3D;
-                    if (driver->bufferRecepcion.pvt.flags & 0b00000010)  // Se han aplicado correcciones diferenciales
+                    if (mensaje->pvt.flags & 0b00000010)  // Se han aplicado correcciones diferenciales
                     	dGPS->estado.status = GPS_OK_FIX_3D_DGPS;
-                    if (driver->bufferRecepcion.pvt.flags & 0b01000000)  // carrsoln - float
+                    if (mensaje->pvt.flags & 0b01000000)  // carrsoln - float
                     	dGPS->estado.status = GPS_OK_FIX_3D_RTK_FLOAT;
-                    if (driver->bufferRecepcion.pvt.flags & 0b10000000)  // carrsoln - fixed
+                    if (mensaje->pvt.flags & 0b10000000)  // carrsoln - fixed
                     	dGPS->estado.status = GPS_OK_FIX_3D_RTK_FIXED;
                     break;
 
@@ -843,65 +819,69 @@ bool analizarTramaGPSublox(gps_t *dGPS)
             }
             driver->siguienteFix = dGPS->estado.status;
             driver->nuevaPosicion = true;
-            dGPS->estado.precisionHorizontal = driver->bufferRecepcion.pvt.hAcc * 1.0e-3f;
-            dGPS->estado.precisionVertical = driver->bufferRecepcion.pvt.vAcc * 1.0e-3f;
+            dGPS->estado.precisionHorizontal = mensaje->pvt.hAcc * 1.0e-3f;
+            dGPS->estado.precisionVertical = mensaje->pvt.vAcc * 1.0e-3f;
             dGPS->estado.tienePrecisionHorizontal = true;
             dGPS->estado.tienePrecisionVertical = true;
 
             // Satelites
-            dGPS->estado.numSats = driver->bufferRecepcion.pvt.numSv;
+            dGPS->estado.numSats = mensaje->pvt.numSv;
 
             // Velocidad
-            driver->ultimoTiempoVel = driver->bufferRecepcion.pvt.itow;
-            dGPS->vel2d = driver->bufferRecepcion.pvt.gspeed * 0.001f;                          // m/s
-            dGPS->velAngular = envolverInt360(driver->bufferRecepcion.pvt.head_mot * 1.0e-5f, 1);  // Heading 2D deg * 100000
+            driver->ultimoTiempoVel = mensaje->pvt.itow;
+            dGPS->vel2d = mensaje->pvt.gspeed * 0.001f;                          // m/s
+            dGPS->velAngular = envolverInt360(mensaje->pvt.head_mot * 1.0e-5f, 1);  // Heading 2D deg * 100000
             dGPS->estado.tieneVelVertical = true;
-            dGPS->velocidad.norte = driver->bufferRecepcion.pvt.velN * 0.001f;
-            dGPS->velocidad.este = driver->bufferRecepcion.pvt.velE * 0.001f;
-            dGPS->velocidad.vertical = driver->bufferRecepcion.pvt.velD * 0.001f;
+            dGPS->velocidad.norte = mensaje->pvt.velN * 0.001f;
+            dGPS->velocidad.este = mensaje->pvt.velE * 0.001f;
+            dGPS->velocidad.vertical = mensaje->pvt.velD * 0.001f;
             dGPS->estado.tienePrecisionVel = true;
-            dGPS->estado.precisionVel = driver->bufferRecepcion.pvt.sAcc * 0.001f;
+            dGPS->estado.precisionVel = mensaje->pvt.sAcc * 0.001f;
             driver->nuevaVelocidad = true;
 
             // DOP
             if (driver->hdopNoRecibido) {
-            	dGPS->estado.hdop = driver->bufferRecepcion.pvt.pDop;
-            	dGPS->estado.vdop = driver->bufferRecepcion.pvt.pDop;
+            	dGPS->estado.hdop = mensaje->pvt.pDop;
+            	dGPS->estado.vdop = mensaje->pvt.pDop;
             }
             dGPS->estado.ultimaHoraGPSms = millis();
 
             // Tiempo
-            dGPS->estado.horaSemana = driver->bufferRecepcion.pvt.itow;
+            dGPS->estado.horaSemana = mensaje->pvt.itow;
             break;
 
         case MSG_VELNED:
+            if (trama->longitud < sizeof(mensaje->velned))
+                return false;
+
             if (driver->tienePVTmsg) {
                 driver->mensajesNoConfig |= CONFIG_RATE_VELNED_GPS;
                 break;
             }
-            driver->ultimoTiempoVel = driver->bufferRecepcion.velned.itow;
-            dGPS->vel2d = driver->bufferRecepcion.velned.speed2d * 0.01f;                       // m/s
-            dGPS->velAngular = envolverInt360(driver->bufferRecepcion.velned.heading2d * 1.0e-5f, 1);    // Heading 2D deg * 100000
+            driver->ultimoTiempoVel = mensaje->velned.itow;
+            dGPS->vel2d = mensaje->velned.speed2d * 0.01f;                       // m/s
+            dGPS->velAngular = envolverInt360(mensaje->velned.heading2d * 1.0e-5f, 1);    // Heading 2D deg * 100000
             dGPS->estado.tieneVelVertical = true;
-            dGPS->velocidad.norte = driver->bufferRecepcion.velned.nedNorth * 0.01f;
-            dGPS->velocidad.este = driver->bufferRecepcion.velned.nedEast * 0.01f;
-            dGPS->velocidad.vertical = driver->bufferRecepcion.velned.nedDown * 0.01f;
+            dGPS->velocidad.norte = mensaje->velned.nedNorth * 0.01f;
+            dGPS->velocidad.este = mensaje->velned.nedEast * 0.01f;
+            dGPS->velocidad.vertical = mensaje->velned.nedDown * 0.01f;
             dGPS->velAngular = envolverInt360(grados(atan2f(dGPS->velocidad.este, dGPS->velocidad.norte)), 1);
             dGPS->vel2d = sqrtf(powf((float)dGPS->velocidad.este, 2) + powf((float)dGPS->velocidad.norte, 2));
             dGPS->estado.tienePrecisionVel = true;
-            dGPS->estado.precisionVel = driver->bufferRecepcion.velned.speedAccuracy * 0.01f;
+            dGPS->estado.precisionVel = mensaje->velned.speedAccuracy * 0.01f;
             driver->nuevaVelocidad = true;
             break;
 
         default:
             if (++driver->contadorDeshabilitacion == 0)
-                configurarFrecuenciaMensajeGPSublox(dGPS, CLASS_NAV, driver->idMensaje, 0);
+                configurarFrecuenciaMensajeGPSublox(dGPS, CLASS_NAV, trama->id, 0);
             return false;
     }
 
     // solo devolvemos true cuando obtenemos nuevos datos de posición y velocidad
     if (driver->nuevaPosicion && driver->nuevaVelocidad && driver->ultimoTiempoVel == driver->ultimoTiempoPos) {
         driver->nuevaVelocidad = driver->nuevaPosicion = false;
+        dGPS->estado.tiempoSolucionUs = trama->tiempoRecepcion;
         return true;
     }
     return false;
@@ -1027,19 +1007,19 @@ void configurarFrecuenciaNavegacionGPSublox(gps_t *dGPS)
 
 
 /***************************************************************************************
-**  Nombre:         void mensajeInesperadoGPSublox(gps_t *dGPS)
+**  Nombre:         void mensajeInesperadoGPSublox(gps_t *dGPS, const tramaUBX_t *trama)
 **  Descripcion:    Deshabilita el envio del mensaje si el contador llega a 256
-**  Parametros:     Puntero al GPS
+**  Parametros:     Puntero al GPS, trama recibida
 **  Retorno:        Ninguno
 ****************************************************************************************/
-void mensajeInesperadoGPSublox(gps_t *dGPS)
+void mensajeInesperadoGPSublox(gps_t *dGPS, const tramaUBX_t *trama)
 {
     gpsUblox_t *driver = dGPS->driver;
 
     // Deshabilitar futuros envios de este mensaje, pero solo se hace esto cada 256 mensajes porque algunos de
     // los tipos de mensajes no pueden ser deshabilitados y no queremos entrar en una guerra de ack
     if (++driver->contadorDeshabilitacion == 0)
-        configurarFrecuenciaMensajeGPSublox(dGPS, driver->claseMensaje, driver->idMensaje, 0);
+        configurarFrecuenciaMensajeGPSublox(dGPS, trama->clase, trama->id, 0);
 }
 
 #endif
@@ -7,7 +7,7 @@
 **
 **  Autor: Ramon Rico
 **  Fecha de creacion: 14/06/2019
-**  Fecha de modificacion: 03/08/2020
+**  Fecha de modificacion: 17/10/2026
 **
 **  El proyecto URpilot NO es libre. No se puede distribuir y/o modificar este fichero
 **  bajo ningun concepto.
@@ -32,6 +32,7 @@
 #include <stdbool.h>
 
 #include "gps.h"
+#include "analizador_ubx.h"
 #include "Comun/util.h"
 
 
@@ -236,7 +237,8 @@ typedef struct {
     uint8_t msgID;
 } PACKED ackAckUBX_t;
 
-// Buffer de recepcion
+// Mensajes recibidos. Los de navegacion se leen directamente del buffer de la UART y los
+// de configuracion se copian para poder modificarlos y devolverlos al GPS
 typedef union {
 	navPosllhUBX_t posllh;
 	navStatusUBX_t status;
@@ -258,14 +260,9 @@ typedef union {
 } PACKED bufferRecepcion_u;
 
 typedef struct {
-    bufferRecepcion_u bufferRecepcion;
-    uint8_t estadoLectura;                            // Estado de la maquina de estados de lectura de mensajes
-    uint8_t claseMensaje;                             // Clase del mensaje recibido
-    uint8_t idMensaje;                                // Id del mensaje recibido
-    uint8_t ckaMensaje;                               // Ck_a del mensaje recibido
-    uint8_t ckbMensaje;                               // Ck_b del mensaje recibido
-    uint16_t longitudPayload;                         // Longitud del payload del mensaje recibido
-    uint16_t contadorPayload;                         // Contador para la recepcion de datos recibidos
+    analizadorUBX_t analizador;
+    bufferRecepcion_u bufferRecepcion;                // Copia del ultimo mensaje de configuracion
+    bool solucionNueva;                               // Solucion de posicion y velocidad completa en la ultima lectura
     bool cfgGuardada;                                 // Determina si la configuracion se ha guardado
     uint32_t ultimoTiempoVel;                         // Ultimo tiempo en el que se ha obtenido la velocidad
     uint32_t ultimoTiempoPos;                         // Ultimo tiempo en el que se ha obtenido la posicion
@@ -297,5 +294,6 @@ void iniciarGPSublox(gps_t *gps);
 bool detectarGPSublox(gps_t *gps, uint8_t dato);
 void solcitarSiguienteConfigGPSublox(gps_t *gps);
 bool leerGPSublox(gps_t *gps);
+void estadisticasGPSublox(gps_t *gps, estadisticasAnalizadorUBX_t *estadisticas);
 
 #endif // __GPS_UBLOX_H_
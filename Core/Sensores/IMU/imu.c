@@ -7,7 +7,7 @@
 **
 **  Autor: Ramon Rico
 **  Fecha de creacion: 10/06/2019
-**  Fecha de modificacion: 21/09/2020
+**  Fecha de modificacion: 17/10/2026
 **
 **  El proyecto URpilot NO es libre. No se puede distribuir y/o modificar este fichero
 **  bajo ningun concepto.
@@ -32,14 +32,21 @@
 #include "imu.h"
 
 #ifdef USAR_IMU
+#include "votacion_imu.h"
 #include "GP/gp_imu.h"
 #include "Filtros/filtro_pasa_bajo.h"
+#include "Filtros/notch_dinamico.h"
+#include "Filtros/filtro_rpm.h"
 #include "Core/led_estado.h"
 #include "Drivers/tiempo.h"
 #include "Scheduler/scheduler.h"
 #include "Comun/util.h"
 #include "Comun/matematicas.h"
 #include "GP/gp_calibrador.h"
+#ifdef USAR_MOTORES
+#include "Motores/motor.h"
+#include "GP/gp_motor.h"
+#endif
 
 
 /***************************************************************************************
@@ -52,8 +59,12 @@
 
 #define MEZCLADO_MEDIDAS_IMU          1
 
+#define FRACCION_SATURACION_IMU       0.98f    // Fraccion del fondo de escala a partir de la que la medida esta saturada
+
 #define TOLERANCIA_CAL_GIRO           0.5      // En º/s
 #define TOLERANCIA_CAL_ACEL           0.005    // En g
+
+#define NUM_MAX_IMU_FILTRO_RPM        2        // Los notch de los motores ocupan mucha RAM. Solo en las IMUs principales
 //#define USAR_CORRECCION_CONING
 
 
@@ -79,17 +90,16 @@ static uint8_t cntIMUSconectadas = 0;
 static tablaFnIMU_t *tablaFnIMU[NUM_MAX_IMU];
 static filtroPasaBajo2P_t filtroAcelIMU[3][NUM_MAX_IMU];
 static filtroPasaBajo2P_t filtroGiroIMU[3][NUM_MAX_IMU];
+static bancoNotchDinamico_t notchGiroIMU[3][NUM_MAX_IMU];
+static analizadorNotchDinamico_t analizadorNotch;
+static uint8_t imuAnalizadorNotch;
+static filtroRPM_t filtroRPMgiro[NUM_MAX_IMU_FILTRO_RPM];
+static filtroRPM_t *filtroRPMimu[NUM_MAX_IMU];
+static uint8_t numFiltrosRPM;
 static bool failsafeIMU;
+static votacionIMU_t votacionIMU;
 
 
-reaction_t reaction;
-uint32_t numReaction;
-bool cambiarID;
-bool iniR;
-uint32_t rTimeMax;
-uint32_t rTimeMin = 99999;
-uint32_t rTime1;
-
 /***************************************************************************************
 ** AREA DE PROTOTIPOS DE FUNCION                                                      **
 ****************************************************************************************/
@@ -101,6 +111,7 @@ void actualizarDriverIMU(imu_t *dIMU);
 void corregirIMU(float *giro, float *acel, calIMU_t calIMU);
 void rotarIMU(rotacionSensor_t rotacion, float *giro, float *acel);
 void actualizarIMUoperativo(imu_t *dIMU);
+bool medidaSaturadaIMU(const imu_t *dIMU);
 
 
 /***************************************************************************************
@@ -123,6 +134,7 @@ bool iniciarIMU(void)
 
     // Reseteamos las variables del sensor
     memset(&imuGen, 0, sizeof(imuGen_t));
+    iniciarVotacionIMU(&votacionIMU, NUM_MAX_IMU);
 
     for (uint8_t i = 0; i < NUM_MAX_IMU; i++) {
         if (configIMU(i)->tipoIMU == IMU_NINGUNO)
@@ -181,6 +193,11 @@ bool iniciarIMU(void)
             case IMU_ICM20789:
                 tablaFnIMU[i] = &tablaFnIMUinvensense;
                 break;
+#ifdef SITL
+            case IMU_SITL:
+                tablaFnIMU[i] = &tablaFnIMUsitl;
+                break;
+#endif
 
             default:
 #ifdef DEBUG
@@ -213,11 +230,37 @@ bool iniciarIMU(void)
 bool iniciarDriverIMU(imu_t *dIMU)
 {
     if (tablaFnIMU[dIMU->numIMU]->iniciarIMU(dIMU)) {
+        // Con FIFO los filtros trabajan a la frecuencia de muestreo del sensor
+        uint16_t frecFiltro = dIMU->fifo ? dIMU->frecMuestreo : configIMU(dIMU->numIMU)->frecLeer;
+
         for (uint8_t i = 0; i < 3; i++) {
-    	    ajustarFiltroPasaBajo2P(&filtroAcelIMU[i][dIMU->numIMU], configIMU(dIMU->numIMU)->frecFiltroAcel, configIMU(dIMU->numIMU)->frecLeer);
-    	    ajustarFiltroPasaBajo2P(&filtroGiroIMU[i][dIMU->numIMU], configIMU(dIMU->numIMU)->frecFiltroGiro, configIMU(dIMU->numIMU)->frecLeer);
+    	    ajustarFiltroPasaBajo2P(&filtroAcelIMU[i][dIMU->numIMU], configIMU(dIMU->numIMU)->frecFiltroAcel, frecFiltro);
+    	    ajustarFiltroPasaBajo2P(&filtroGiroIMU[i][dIMU->numIMU], configIMU(dIMU->numIMU)->frecFiltroGiro, frecFiltro);
         }
 
+        // El espectro se analiza con la primera IMU principal y las frecuencias se comparten con el resto
+        if (configNotchDinamico()->habilitado) {
+            if (!analizadorNotch.operativo && !configIMU(dIMU->numIMU)->auxiliar &&
+                iniciarAnalizadorNotchDinamico(&analizadorNotch, frecFiltro, FREC_NOTCH_DINAMICO_HZ, configNotchDinamico()->numPicos,
+                                               configNotchDinamico()->frecMin, configNotchDinamico()->frecMax))
+                imuAnalizadorNotch = dIMU->numIMU;
+
+            for (uint8_t i = 0; i < 3; i++)
+                ajustarBancoNotchDinamico(&notchGiroIMU[i][dIMU->numIMU], frecFiltro, configNotchDinamico()->numPicos,
+                                          analizadorNotch.frecPico[i], configNotchDinamico()->Q);
+        }
+
+#ifdef USAR_MOTORES
+        // Notch en la frecuencia de giro de cada motor con la telemetria de los ESC
+        if (configFiltroRPM()->habilitado && telemetriaRPMmotoresHabilitada() && !configIMU(dIMU->numIMU)->auxiliar &&
+            numFiltrosRPM < NUM_MAX_IMU_FILTRO_RPM) {
+            filtroRPMimu[dIMU->numIMU] = &filtroRPMgiro[numFiltrosRPM++];
+            ajustarFiltroRPM(filtroRPMimu[dIMU->numIMU], frecFiltro, FREC_FILTRO_RPM_HZ, configMotor()->numMotores,
+                             configFiltroRPM()->armonicos, configFiltroRPM()->frecMin, configFiltroRPM()->anchoBanda,
+                             configFiltroRPM()->atenuacion);
+        }
+#endif
+
         return true;
     }
     else {
@@ -252,71 +295,61 @@ CODIGO_RAPIDO void actualizarFailsafeIMU(void)
 
 /***************************************************************************************
 **  Nombre:         void calcularIMUGen(bool habMezcla)
-**  Descripcion:    Mezcla las medidas de los sensores en uno general
+**  Descripcion:    Mezcla las medidas de los sensores en uno general con los pesos de la
+**                  votacion
 **  Parametros:     Habilitacion de la mezcla de varios sensores
 **  Retorno:        Ninguno
 ****************************************************************************************/
 CODIGO_RAPIDO void calcularIMUGen(bool habMezcla)
 {
-    float giroAcum[3] = {0, 0, 0};
-    float giroFiltAcum[3] = {0, 0, 0};
-    float acelAcum[3] = {0, 0, 0};
-    float acelFiltAcum[3] = {0, 0, 0};
-    float tempAcum = 0;
-    uint8_t numDriversOp = 0;
+    bool candidata[NUM_MAX_IMU];
+    float peso[NUM_MAX_IMU];
 
     for (uint8_t i = 0; i < NUM_MAX_IMU; i++) {
         imu_t *driver = &imu[i];
+        candidata[i] = driver->operativo && (!configIMU(i)->auxiliar || failsafeIMU);
+    }
 
-        // Mezclado de las medidas
-        if (driver->operativo && (!configIMU(i)->auxiliar || failsafeIMU)) {
-            giroAcum[0] += driver->giro[0];
-            giroAcum[1] += driver->giro[1];
-            giroAcum[2] += driver->giro[2];
-
-            giroFiltAcum[0] += driver->giroFiltrado[0];
-            giroFiltAcum[1] += driver->giroFiltrado[1];
-            giroFiltAcum[2] += driver->giroFiltrado[2];
-
-            acelAcum[0] += driver->acel[0];
-            acelAcum[1] += driver->acel[1];
-            acelAcum[2] += driver->acel[2];
-
-            acelFiltAcum[0] += driver->acelFiltrada[0];
-            acelFiltAcum[1] += driver->acelFiltrada[1];
-            acelFiltAcum[2] += driver->acelFiltrada[2];
-
-            tempAcum += driver->temperatura;
-            numDriversOp++;
+    // Las IMUs con fallos pierden peso o quedan fuera de la mezcla
+    if (votarIMU(&votacionIMU, imu, candidata) == 0) {
+        imuGen.operativa = false;
+        return;
+    }
 
-            if (!habMezcla)
-                break;
-        }
+    // Sin mezcla se usa solo la IMU con mas peso
+    uint8_t mejor = 0;
+    for (uint8_t i = 0; i < NUM_MAX_IMU; i++) {
+        peso[i] = votacionIMU.salud[i].peso;
+        if (peso[i] > peso[mejor])
+            mejor = i;
     }
 
-    if (numDriversOp > 0) {
-        imuGen.operativa = true;
+    if (!habMezcla) {
+        memset(peso, 0, sizeof(peso));
+        peso[mejor] = 1;
+    }
 
-        imuGen.giro[0] = giroAcum[0] / numDriversOp;
-        imuGen.giro[1] = giroAcum[1] / numDriversOp;
-        imuGen.giro[2] = giroAcum[2] / numDriversOp;
+    imuGen_t mezcla;
+    memset(&mezcla, 0, sizeof(imuGen_t));
+    mezcla.operativa = true;
 
-        imuGen.giroFiltrado[0] = giroFiltAcum[0] / numDriversOp;
-        imuGen.giroFiltrado[1] = giroFiltAcum[1] / numDriversOp;
-        imuGen.giroFiltrado[2] = giroFiltAcum[2] / numDriversOp;
+    for (uint8_t i = 0; i < NUM_MAX_IMU; i++) {
+        imu_t *driver = &imu[i];
 
-        imuGen.acel[0] = acelAcum[0] / numDriversOp;
-        imuGen.acel[1] = acelAcum[1] / numDriversOp;
-        imuGen.acel[2] = acelAcum[2] / numDriversOp;
+        if (peso[i] == 0)
+            continue;
 
-        imuGen.acelFiltrada[0] = acelFiltAcum[0] / numDriversOp;
-        imuGen.acelFiltrada[1] = acelFiltAcum[1] / numDriversOp;
-        imuGen.acelFiltrada[2] = acelFiltAcum[2] / numDriversOp;
+        for (uint8_t j = 0; j < 3; j++) {
+            mezcla.giro[j] += peso[i] * driver->giro[j];
+            mezcla.giroFiltrado[j] += peso[i] * driver->giroFiltrado[j];
+            mezcla.acel[j] += peso[i] * driver->acel[j];
+            mezcla.acelFiltrada[j] += peso[i] * driver->acelFiltrada[j];
+        }
 
-        imuGen.temperatura = tempAcum / numDriversOp;
+        mezcla.temperatura += peso[i] * driver->temperatura;
     }
-    else
-        imuGen.operativa = false;
+
+    imuGen = mezcla;
 }
 
 #include "Sensores/IMU/imu.h"
@@ -364,65 +397,172 @@ CODIGO_RAPIDO void leerDriverIMU(imu_t *dIMU)
 {
     tablaFnIMU[dIMU->numIMU]->leerIMU(dIMU);
 
-    if (dIMU->nuevaMedida) {
-#ifdef USAR_CORRECCION_CONING
-        // Correccion Coning
-        // Tian et al (2010) Three-loop Integration of GPS and Strapdown INS with Coning and Sculling Compensation
-        // Disponible: http://www.sage.unsw.edu.au/snap/publications/tian_etal2010b.pdf
-        uint32_t tiempoActual = micros();
-        float dt = tiempoActual - dIMU->coningIMU.tiempoAnterior;
-        dIMU->coningIMU.tiempoAnterior = tiempoActual;
-
-        float deltaAngulo[3];
-        float deltaConing[3];
-        for (uint8_t i = 0; i < 3; i++)
-    	    deltaAngulo[i] = (dIMU->giro[i] + dIMU->coningIMU.ultimoGiroRaw[i]) * 0.5f * dt;
+    // Con FIFO el driver procesa cada muestra al descargarla
+    if (dIMU->nuevaMedida && !dIMU->fifo)
+        procesarMedidaIMU(dIMU);
 
-        for (uint8_t i = 0; i < 3; i++)
-            deltaConing[i] = (dIMU->coningIMU.deltaAnguloAcc[i] + dIMU->coningIMU.ultimoDeltaAngulo[i] * (1.0f / 6.0f));
+    actualizarIMUoperativo(dIMU);
+    dIMU->nuevaMedida = false;
+}
 
-        productoCruzado3F(deltaConing, deltaAngulo, deltaConing);
 
-        for (uint8_t i = 0; i < 3; i++)
-            deltaConing[i] *= 0.5f;
+/***************************************************************************************
+**  Nombre:         void procesarMedidaIMU(imu_t *dIMU)
+**  Descripcion:    Corrige, rota y filtra la ultima medida de una IMU
+**  Parametros:     IMU a procesar
+**  Retorno:        Ninguno
+****************************************************************************************/
+CODIGO_RAPIDO void procesarMedidaIMU(imu_t *dIMU)
+{
+    // La saturacion se mira en la medida del sensor, antes de rotar y calibrar
+    if (medidaSaturadaIMU(dIMU))
+        dIMU->numSaturaciones++;
 
+#ifdef USAR_CORRECCION_CONING
+    // Correccion Coning
+    // Tian et al (2010) Three-loop Integration of GPS and Strapdown INS with Coning and Sculling Compensation
+    // Disponible: http://www.sage.unsw.edu.au/snap/publications/tian_etal2010b.pdf
+    uint32_t tiempoActual = micros();
+    float dt = tiempoActual - dIMU->coningIMU.tiempoAnterior;
+    dIMU->coningIMU.tiempoAnterior = tiempoActual;
 
-        if (dt > 100000U) {
-            for (uint8_t i = 0; i < 3; i++) {
-                dIMU->coningIMU.deltaAnguloAcc[i] = 0;
-                deltaAngulo[i] = 0;
-            }
-            dIMU->coningIMU.deltaAnguloAccDt = 0;
-            dt = 0;
-        }
+    float deltaAngulo[3];
+    float deltaConing[3];
+    for (uint8_t i = 0; i < 3; i++)
+        deltaAngulo[i] = (dIMU->giro[i] + dIMU->coningIMU.ultimoGiroRaw[i]) * 0.5f * dt;
 
-        for (uint8_t i = 0; i < 3; i++)
-            dIMU->coningIMU.deltaAnguloAcc[i] += deltaAngulo[i] + deltaConing[i];
+    for (uint8_t i = 0; i < 3; i++)
+        deltaConing[i] = (dIMU->coningIMU.deltaAnguloAcc[i] + dIMU->coningIMU.ultimoDeltaAngulo[i] * (1.0f / 6.0f));
 
-        dIMU->coningIMU.deltaAnguloAccDt += dt;
+    productoCruzado3F(deltaConing, deltaAngulo, deltaConing);
 
+    for (uint8_t i = 0; i < 3; i++)
+        deltaConing[i] *= 0.5f;
+
+
+    if (dt > 100000U) {
         for (uint8_t i = 0; i < 3; i++) {
-            dIMU->coningIMU.ultimoDeltaAngulo[i] = deltaAngulo[i];
-            dIMU->coningIMU.ultimoGiroRaw[i] = dIMU->giro[i];
+            dIMU->coningIMU.deltaAnguloAcc[i] = 0;
+            deltaAngulo[i] = 0;
         }
+        dIMU->coningIMU.deltaAnguloAccDt = 0;
+        dt = 0;
+    }
+
+    for (uint8_t i = 0; i < 3; i++)
+        dIMU->coningIMU.deltaAnguloAcc[i] += deltaAngulo[i] + deltaConing[i];
+
+    dIMU->coningIMU.deltaAnguloAccDt += dt;
+
+    for (uint8_t i = 0; i < 3; i++) {
+        dIMU->coningIMU.ultimoDeltaAngulo[i] = deltaAngulo[i];
+        dIMU->coningIMU.ultimoGiroRaw[i] = dIMU->giro[i];
+    }
 #endif
 
-        // Rotacion y correccion de las medidas
-        if (configIMU(dIMU->numIMU)->rotacion.rotacion != 0)
-            rotarIMU(configIMU(dIMU->numIMU)->rotacion, dIMU->giro, dIMU->acel);
+    // Rotacion y correccion de las medidas
+    if (configIMU(dIMU->numIMU)->rotacion.rotacion != 0)
+        rotarIMU(configIMU(dIMU->numIMU)->rotacion, dIMU->giro, dIMU->acel);
 
-        // Se corrigen las medidas de la IMU con la calibracion
-        corregirIMU(dIMU->giro, dIMU->acel, configCalIMU(dIMU->numIMU)->calIMU);
+    // Se corrigen las medidas de la IMU con la calibracion
+    corregirIMU(dIMU->giro, dIMU->acel, configCalIMU(dIMU->numIMU)->calIMU);
 
-        // Filtramos las medidas
-        for (uint8_t i = 0; i < 3; i++) {
-            dIMU->acelFiltrada[i] = actualizarFiltroPasaBajo2P(&filtroAcelIMU[i][dIMU->numIMU], dIMU->acel[i]);
-            dIMU->giroFiltrado[i] = actualizarFiltroPasaBajo2P(&filtroGiroIMU[i][dIMU->numIMU], dIMU->giro[i]);
-        }
+    // Primero los notch de los motores. El analizador ve el giro sin los notch dinamicos
+    float giro[3] = {dIMU->giro[0], dIMU->giro[1], dIMU->giro[2]};
+
+    if (filtroRPMimu[dIMU->numIMU] != NULL) {
+        for (uint8_t i = 0; i < 3; i++)
+            giro[i] = actualizarFiltroRPM(filtroRPMimu[dIMU->numIMU], i, giro[i]);
     }
 
-    actualizarIMUoperativo(dIMU);
-    dIMU->nuevaMedida = false;
+    if (analizadorNotch.operativo && dIMU->numIMU == imuAnalizadorNotch)
+        anadirMuestraNotchDinamico(&analizadorNotch, giro);
+
+    // Filtramos las medidas
+    for (uint8_t i = 0; i < 3; i++) {
+        giro[i] = actualizarBancoNotchDinamico(&notchGiroIMU[i][dIMU->numIMU], giro[i]);
+
+        dIMU->acelFiltrada[i] = actualizarFiltroPasaBajo2P(&filtroAcelIMU[i][dIMU->numIMU], dIMU->acel[i]);
+        dIMU->giroFiltrado[i] = actualizarFiltroPasaBajo2P(&filtroGiroIMU[i][dIMU->numIMU], giro[i]);
+    }
+}
+
+
+/***************************************************************************************
+**  Nombre:         bool medidaSaturadaIMU(const imu_t *dIMU)
+**  Descripcion:    Comprueba si algun eje de la medida esta en el fondo de escala del sensor
+**  Parametros:     IMU
+**  Retorno:        True si esta saturada
+****************************************************************************************/
+CODIGO_RAPIDO bool medidaSaturadaIMU(const imu_t *dIMU)
+{
+    const float limiteGiro = FRACCION_SATURACION_IMU * dIMU->rangoGiro;
+    const float limiteAcel = FRACCION_SATURACION_IMU * dIMU->rangoAcel;
+
+    for (uint8_t i = 0; i < 3; i++) {
+        if ((limiteGiro > 0 && fabsf(dIMU->giro[i]) >= limiteGiro) || (limiteAcel > 0 && fabsf(dIMU->acel[i]) >= limiteAcel))
+            return true;
+    }
+
+    return false;
+}
+
+
+/***************************************************************************************
+**  Nombre:         void actualizarNotchDinamicoIMU(uint32_t tiempoActual)
+**  Descripcion:    Avanza un paso el analisis del espectro y reajusta los notch del eje analizado
+**  Parametros:     Tiempo actual
+**  Retorno:        Ninguno
+****************************************************************************************/
+void actualizarNotchDinamicoIMU(uint32_t tiempoActual)
+{
+    UNUSED(tiempoActual);
+    uint8_t eje;
+
+    if (!actualizarAnalizadorNotchDinamico(&analizadorNotch, &eje))
+        return;
+
+    for (uint8_t i = 0; i < NUM_MAX_IMU; i++) {
+        if (imu[i].iniciado)
+            actualizarFrecBancoNotchDinamico(&notchGiroIMU[eje][i], analizadorNotch.frecPico[eje]);
+    }
+}
+
+
+/***************************************************************************************
+**  Nombre:         void actualizarFiltroRPMIMU(uint32_t tiempoActual)
+**  Descripcion:    Lee la frecuencia de giro de los motores y reajusta los notch de uno de ellos
+**  Parametros:     Tiempo actual
+**  Retorno:        Ninguno
+****************************************************************************************/
+void actualizarFiltroRPMIMU(uint32_t tiempoActual)
+{
+    UNUSED(tiempoActual);
+
+#ifdef USAR_MOTORES
+    if (numFiltrosRPM == 0)
+        return;
+
+    // Sin telemetria valida la frecuencia es 0 y los notch se quedan en la minima
+    float frecMotor[NUM_MAX_MOTORES_FILTRO_RPM];
+    for (uint8_t i = 0; i < filtroRPMgiro[0].numMotores; i++)
+        frecGiroMotor(i, &frecMotor[i]);
+
+    for (uint8_t i = 0; i < numFiltrosRPM; i++)
+        actualizarFrecFiltroRPM(&filtroRPMgiro[i], frecMotor);
+#endif
+}
+
+
+/***************************************************************************************
+**  Nombre:         bool filtroRPMIMUhabilitado(void)
+**  Descripcion:    Comprueba si alguna IMU tiene los notch de los motores
+**  Parametros:     Ninguno
+**  Retorno:        True si habilitado
+****************************************************************************************/
+bool filtroRPMIMUhabilitado(void)
+{
+    return numFiltrosRPM > 0;
 }
 
 
@@ -443,7 +583,8 @@ CODIGO_RAPIDO void actualizarIMU(uint32_t tiempoActual)
     for (uint8_t i = 0; i < NUM_MAX_IMU; i++) {
         imu_t *driver = &imu[i];
 
-        if (driver->iniciado && (configIMU(i)->drdy == 0 || leerIO(configIMU(i)->drdy)))
+        // Con FIFO el driver gestiona el data ready y descarga las muestras pendientes
+        if (driver->iniciado && (driver->fifo || configIMU(i)->drdy == 0 || leerIO(configIMU(i)->drdy)))
             actualizarDriverIMU(driver);
     }
 
@@ -615,6 +756,33 @@ bool imuGenOperativa(void)
 }
 
 
+/***************************************************************************************
+**  Nombre:         estadoSaludIMU_e saludNumIMU(numIMU_e numIMU, uint8_t *fallos)
+**  Descripcion:    Devuelve el estado de salud de una IMU en la votacion
+**  Parametros:     Numero de IMU, mascara de fallos de la ultima evaluacion (puede ser NULL)
+**  Retorno:        Estado de salud
+****************************************************************************************/
+estadoSaludIMU_e saludNumIMU(numIMU_e numIMU, uint8_t *fallos)
+{
+    if (fallos != NULL)
+        *fallos = votacionIMU.salud[numIMU].fallos;
+
+    return votacionIMU.salud[numIMU].estado;
+}
+
+
+/***************************************************************************************
+**  Nombre:         float pesoNumIMU(numIMU_e numIMU)
+**  Descripcion:    Devuelve el peso de una IMU en la mezcla
+**  Parametros:     Numero de IMU
+**  Retorno:        Peso normalizado
+****************************************************************************************/
+float pesoNumIMU(numIMU_e numIMU)
+{
+    return votacionIMU.salud[numIMU].peso;
+}
+
+
 /***************************************************************************************
 **  Nombre:         void giroIMU(float *giro)
 **  Descripcion:    Devuelve la velocidad angular de la IMU general
@@ -7,7 +7,7 @@
 **
 **  Autor: Ramon Rico
 **  Fecha de creacion: 10/06/2019
-**  Fecha de modificacion: 21/09/2020
+**  Fecha de modificacion: 17/10/2026
 **
 **  El proyecto URpilot NO es libre. No se puede distribuir y/o modificar este fichero
 **  bajo ningun concepto.
@@ -66,8 +66,25 @@ typedef enum {
 	IMU_ICM20602,
     IMU_ICM20689,
     IMU_ICM20789,
+#ifdef SITL
+    IMU_SITL,
+#endif
 } tipoIMU_e;
 
+typedef enum {
+    SALUD_IMU_OK = 0,
+    SALUD_IMU_SOSPECHOSA,                // Con algun fallo. Pierde peso en la mezcla
+    SALUD_IMU_EXCLUIDA,                  // Fallo mantenido. Fuera de la mezcla hasta que se recupere
+} estadoSaludIMU_e;
+
+typedef enum {
+    FALLO_SALUD_IMU_INCONSISTENTE = (1 << 0),    // Lejos de la mediana del resto de IMUs
+    FALLO_SALUD_IMU_RUIDO         = (1 << 1),
+    FALLO_SALUD_IMU_ATASCADA      = (1 << 2),
+    FALLO_SALUD_IMU_SATURADA      = (1 << 3),
+    FALLO_SALUD_IMU_TEMPERATURA   = (1 << 4),
+} falloSaludIMU_e;
+
 typedef struct {
     uint32_t ultimaActualizacion;        // Tiempo en us
     uint32_t ultimaMedida;               // Tiempo en us
@@ -87,11 +104,16 @@ typedef struct {
     bus_t bus;
     void *driver;
     uint8_t drdy;
+    bool fifo;                           // Las muestras llegan por la FIFO y se procesan una a una
+    uint16_t frecMuestreo;               // Frecuencia de las muestras de la FIFO en Hz
     float giro[3];                       // Velocidad angular en º/s
     float acel[3];                       // Aceleracion lineal en g
     float giroFiltrado[3];               // Velocidad angular en º/s
     float acelFiltrada[3];               // Aceleracion lineal en g
     float temperatura;
+    float rangoGiro;                     // Fondo de escala en º/s. Cero si el driver no lo indica
+    float rangoAcel;                     // Fondo de escala en g
+    uint32_t numSaturaciones;            // Muestras con algun eje en el fondo de escala
     coningIMU_t coningIMU;
     bool iniciado;
     bool operativo;
@@ -106,16 +128,13 @@ typedef struct {
 } tablaFnIMU_t;
 
 
-typedef struct {
-    uint32_t tiempo;
-    char id;
-} reaction_t;
-
-
 /***************************************************************************************
 ** AREA DE DECLARACION DE VARIABLES                                                   **
 ****************************************************************************************/
 extern tablaFnIMU_t tablaFnIMUinvensense;
+#ifdef SITL
+extern tablaFnIMU_t tablaFnIMUsitl;
+#endif
 
 
 /***************************************************************************************
@@ -127,8 +146,14 @@ void actualizarIMU(uint32_t tiempoActual);
 bool imuOperativa(numIMU_e numIMU);
 bool imusOperativas(void);
 bool medidasIMUok(float *val);
+void procesarMedidaIMU(imu_t *dIMU);
+void actualizarNotchDinamicoIMU(uint32_t tiempoActual);
+void actualizarFiltroRPMIMU(uint32_t tiempoActual);
+bool filtroRPMIMUhabilitado(void);
 uint8_t numIMUsConectadas(void);
 bool imuGenOperativa(void);
+estadoSaludIMU_e saludNumIMU(numIMU_e numIMU, uint8_t *fallos);
+float pesoNumIMU(numIMU_e numIMU);
 
 void giroIMU(float *giro);
 void acelIMU(float *acel);
@@ -8,7 +8,7 @@
 **
 **  Autor: Ramon Rico
 **  Fecha de creacion: 10/06/2019
-**  Fecha de modificacion: 03/08/2020
+**  Fecha de modificacion: 17/10/2026
 **
 **  El proyecto URpilot NO es libre. No se puede distribuir y/o modificar este fichero
 **  bajo ningun concepto.
@@ -29,6 +29,7 @@
 #include <string.h>
 
 #include "imu.h"
+#include "imu_invensense.h"
 
 #ifdef USAR_IMU
 #include "Comun/matematicas.h"
@@ -38,6 +39,13 @@
 #include "Drivers/bus.h"
 #include "Drivers/spi.h"
 #include "Comun/util.h"
+#ifndef SITL
+#include "Drivers/atomico.h"
+#include "Drivers/nvic.h"
+#endif
+#ifdef USAR_EXTI
+#include "Drivers/exti.h"
+#endif
 
 
 /***************************************************************************************
@@ -189,21 +197,55 @@
 #define INVENSENSE_ICM_UNDOC1                  0x11
 #define INVENSENSE_ICM_UNDOC1_VALUE            0xc9
 
-#define INVENSENSE_SAMPLE_SIZE                 14
-#define INVENSENSE_FIFO_DOWNSAMPLE_COUNT       8
-#define INVENSENSE_FIFO_BUFFER_LEN             16
+#define INVENSENSE_FIFO_DOWNSAMPLE_COUNT       8       // Flancos del DRDY entre lecturas de la FIFO
+#define INVENSENSE_FIFO_BUFFER_LEN             16      // Maximo de muestras por rafaga
+#define INVENSENSE_FIFO_COUNT_MASK             0x1FFF
+
+#define FREC_MUESTREO_FIFO_INVENSENSE          8000    // Hz
+#define PERIODO_MUESTRA_FIFO_INVENSENSE        (1000000 / FREC_MUESTREO_FIFO_INVENSENSE)    // us
+#define TAM_BUFFER_FIFO_INVENSENSE             256     // Registro + INVENSENSE_FIFO_BUFFER_LEN muestras redondeado a 32 bytes
+#define TAM_BUFFER_CUENTA_INVENSENSE           32
+
+// La lectura de la FIFO avanza desde la interrupcion del DRDY, la del SPI y la tarea
+#ifdef SITL
+  #define BLOQUE_ATOMICO_FIFO_INVENSENSE
+#else
+  #define BLOQUE_ATOMICO_FIFO_INVENSENSE       BLOQUE_ATOMICO(NVIC_PRIO_SPI)
+#endif
 
 
 /***************************************************************************************
 ** AREA DE DEFINICION DE TIPOS                                                        **
 ****************************************************************************************/
+typedef enum {
+    LECTURA_FIFO_LIBRE = 0,
+    LECTURA_FIFO_CUENTA,
+    LECTURA_FIFO_DATOS,
+    LECTURA_FIFO_DATOS_LISTOS,
+    LECTURA_FIFO_RESETEAR,
+    LECTURA_FIFO_RESETEANDO,
+} estadoLecturaFifo_e;
+
 typedef struct {
+    // Buffers del DMA al principio y alineados con la cache
+    uint8_t bufferFifo[TAM_BUFFER_FIFO_INVENSENSE] __attribute__((aligned(32)));
+    uint8_t bufferCuenta[TAM_BUFFER_CUENTA_INVENSENSE] __attribute__((aligned(32)));
 	uint8_t regControl;
 	float tempCero, tempSens;
 	float escalaGiro, escalaAcel;
     float giroRaw[3], acelRaw[3];
     float tempRaw;
     acumulador7_t acumulador;
+    bool usarFifo;
+    bool drdyHabilitado;
+    uint16_t tamFifo;
+    fifoInvensense_t fifo;
+    volatile estadoLecturaFifo_e estadoFifo;
+    uint8_t contadorDrdy;
+    uint8_t numMuestrasFifo;
+    uint32_t tiempoMuestraFifo;            // Instante de la ultima muestra leida
+    transaccionSPI_t transaccionFifo;
+    imu_t *imu;
 } imuInvensense_t;
 
 
@@ -226,7 +268,14 @@ bool leerAdcIMUinvensense(bus_t *bus, int16_t *adc);
 void leerIMUinvensense(imu_t *dIMU);
 void actualizarIMUinvensense(imu_t *dIMU);
 bool datoDisponibleIMUinvensense(bus_t *bus);
-void calcularIMUinvensense(imu_t *dIMU);
+void calcularIMUinvensense(imu_t *dIMU, uint32_t tiempo);
+void drdyIMUinvensense(uint32_t numIMU);
+bool lanzarLecturaFifoIMUinvensense(imuInvensense_t *driver);
+void cuentaFifoLeidaIMUinvensense(transaccionSPI_t *transaccion);
+void datosFifoLeidosIMUinvensense(transaccionSPI_t *transaccion);
+void fifoReseteadaIMUinvensense(transaccionSPI_t *transaccion);
+void actualizarFifoIMUinvensense(imu_t *dIMU);
+void procesarFifoIMUinvensense(imu_t *dIMU);
 
 
 /***************************************************************************************
@@ -250,6 +299,10 @@ bool iniciarIMUinvensense(imu_t *dIMU)
 
     // Reseteamos el driver
     memset(driver, 0, sizeof(*driver));
+    driver->imu = dIMU;
+
+    // La FIFO se descarga con transferencias asincronas, que solo existen en el SPI
+    driver->usarFifo = configIMU(dIMU->numIMU)->fifo && dIMU->bus.tipo == BUS_SPI;
 
     if (!chequearIdIMUinvensense(&dIMU->bus, configIMU(dIMU->numIMU)->tipoIMU))
         goto error;
@@ -260,7 +313,30 @@ bool iniciarIMUinvensense(imu_t *dIMU)
     if (!configurarIMUinvensense(&dIMU->bus, configIMU(dIMU->numIMU)->tipoIMU, driver))
         goto error;
 
+    // Fondo de escala para detectar la saturacion
+    dIMU->rangoGiro = 32768 * driver->escalaGiro;
+    dIMU->rangoAcel = 32768 * driver->escalaAcel;
+
+    if (driver->usarFifo) {
+        resetearFifoIMUinvensense(&dIMU->bus, &driver->regControl);
+        resetearFifoInvensense(&driver->fifo);
+        dIMU->fifo = true;
+        dIMU->frecMuestreo = FREC_MUESTREO_FIFO_INVENSENSE;
+
+#ifdef USAR_EXTI
+        // Sin interrupcion en el DRDY la FIFO se descarga desde la tarea
+        if (dIMU->drdy != 0)
+            driver->drdyHabilitado = configurarEXTI(dIMU->drdy, FLANCO_SUBIDA_EXTI, NVIC_PRIO_EXTI, drdyIMUinvensense, dIMU->numIMU);
+#endif
+    }
+
     ajustarRelojSPI(dIMU->bus.bus_u.spi.numSPI, SPI_RELOJ_RAPIDO);
+
+#ifdef USAR_EXTI
+    if (driver->drdyHabilitado)
+        habilitarEXTI(dIMU->drdy, true);
+#endif
+
     return true;
 
   error:
@@ -432,33 +508,39 @@ bool configurarIMUinvensense(bus_t *bus, uint8_t tipoIMU, imuInvensense_t *dIMU)
         case IMU_MPU6000:
         	dIMU->tempCero = 36.53f;
         	dIMU->tempSens = 1.0f / 340;
+        	dIMU->tamFifo = 1024;
             break;
 
         case IMU_MPU9250:
         	dIMU->tempCero = 21.0f;
         	dIMU->tempSens = 1.0f / 340;
+        	dIMU->tamFifo = 512;
             break;
 
         case IMU_ICM20602:
         	dIMU->tempCero = 25.0f;
         	dIMU->tempSens = 1 / 326.8f;
+        	dIMU->tamFifo = 1008;
             break;
 
         case IMU_ICM20689:
         	dIMU->tempCero = 25.0f;
         	dIMU->tempSens = 0.003f;
+        	dIMU->tamFifo = 4096;
             break;
 
         case IMU_ICM20789:
         	dIMU->tempCero = 25.0f;
         	dIMU->tempSens = 0.003f;
+        	dIMU->tamFifo = 512;
             break;
     }
 
-    // Configuramos el filtro. Si tenemos la imu por SPI muestreamos a max. velocidad sin filtro. Sino ponemos el filtro mas alto
+    // Configuramos el filtro. Si tenemos la imu por SPI muestreamos a max. velocidad sin filtro. Sino ponemos el filtro mas alto.
+    // Con FIFO el giro se queda en 8kHz con el filtro mas alto, que es lo maximo que se vuelca en la FIFO
     if (tipoIMU > IMU_MPU9250 && bus->tipo == BUS_SPI) {
         regGiro1 |= INVENSENSE_GIRO_DLPF_0;
-        regGiro2 |= INVENSENSE_GYRO_FCHOICE_1;
+        regGiro2 |= dIMU->usarFifo ? INVENSENSE_GYRO_FCHOICE_0 : INVENSENSE_GYRO_FCHOICE_1;
         regAcel2 |= INVENSENSE_ACCEL_FCHOICE_1 | INVENSENSE_ACCEL_DLPF_0;
     }
     else {
@@ -490,6 +572,27 @@ bool configurarIMUinvensense(bus_t *bus, uint8_t tipoIMU, imuInvensense_t *dIMU)
 }
 
 
+/***************************************************************************************
+**  Nombre:         void resetearFifoIMUinvensense(bus_t *bus, uint8_t *regControl)
+**  Descripcion:    Vacia la FIFO y la habilita con giro, aceleracion y temperatura
+**  Parametros:     Puntero al bus, registro de control
+**  Retorno:        Ninguno
+****************************************************************************************/
+void resetearFifoIMUinvensense(bus_t *bus, uint8_t *regControl)
+{
+    escribirRegistroBus(bus, INVENSENSE_FIFO_EN, 0);
+    *regControl &= ~INVENSENSE_USER_FIFO_EN;
+    escribirRegistroBus(bus, INVENSENSE_USER_CTRL, *regControl | INVENSENSE_USER_FIFO_RST);
+    delay(1);
+
+    *regControl |= INVENSENSE_USER_FIFO_EN;
+    escribirRegistroBus(bus, INVENSENSE_USER_CTRL, *regControl | INVENSENSE_USER_FIFO_RST);
+    escribirRegistroBus(bus, INVENSENSE_FIFO_EN, INVENSENSE_TEMP_FIFO_EN | INVENSENSE_XG_FIFO_EN | INVENSENSE_YG_FIFO_EN |
+                                                 INVENSENSE_ZG_FIFO_EN | INVENSENSE_ACCEL_FIFO_EN);
+    delay(1);
+}
+
+
 /***************************************************************************************
 **  Nombre:         bool leerAdcIMUinvensense(bus_t *bus, int16_t *adc)
 **  Descripcion:    Obtiene los valores del adc
@@ -543,7 +646,7 @@ void leerIMUinvensense(imu_t *dIMU)
         driver->giroRaw[1] = aIMU[5] / cuentaIMU;
         driver->giroRaw[2] = aIMU[6] / cuentaIMU;
 
-        calcularIMUinvensense(dIMU);
+        calcularIMUinvensense(dIMU, micros());
         dIMU->nuevaMedida = true;
     }
 }
@@ -566,6 +669,11 @@ CODIGO_RAPIDO void actualizarIMUinvensense(imu_t *dIMU)
     if (num == IMU_3 && desactivarImu)
     	return;
 
+    if (driver->usarFifo) {
+        actualizarFifoIMUinvensense(dIMU);
+        return;
+    }
+
     if (dIMU->drdy == 0) {
         if (!datoDisponibleIMUinvensense(bus))
             return;
@@ -608,16 +716,15 @@ CODIGO_RAPIDO bool datoDisponibleIMUinvensense(bus_t *bus)
 
 
 /***************************************************************************************
-**  Nombre:         void calcularIMUinvensense(imu_t *dIMU)
+**  Nombre:         void calcularIMUinvensense(imu_t *dIMU, uint32_t tiempo)
 **  Descripcion:    Compensa las lecturas con los valores de calibracion
-**  Parametros:     Driver Invensense
+**  Parametros:     Driver Invensense, instante de la medida
 **  Retorno:        Ninguno
 ****************************************************************************************/
-void calcularIMUinvensense(imu_t *dIMU)
+CODIGO_RAPIDO void calcularIMUinvensense(imu_t *dIMU, uint32_t tiempo)
 {
     imuInvensense_t *driver = dIMU->driver;
     float medidaIMU[7];
-    uint32_t tiempo = micros();
 
     medidaIMU[0] = driver->escalaAcel * driver->acelRaw[0];
     medidaIMU[1] = driver->escalaAcel * driver->acelRaw[1];
@@ -642,6 +749,281 @@ void calcularIMUinvensense(imu_t *dIMU)
 }
 
 
+/***************************************************************************************
+**  Nombre:         void drdyIMUinvensense(uint32_t numIMU)
+**  Descripcion:    Interrupcion del DRDY. Lanza la lectura de la FIFO cada
+**                  INVENSENSE_FIFO_DOWNSAMPLE_COUNT muestras
+**  Parametros:     Numero de IMU
+**  Retorno:        Ninguno
+****************************************************************************************/
+CODIGO_RAPIDO void drdyIMUinvensense(uint32_t numIMU)
+{
+    imuInvensense_t *driver = &imuInvensense[numIMU];
+
+    // Si hay una lectura en curso se reintenta en el siguiente flanco
+    if (driver->contadorDrdy < INVENSENSE_FIFO_DOWNSAMPLE_COUNT)
+        driver->contadorDrdy++;
+
+    if (driver->contadorDrdy >= INVENSENSE_FIFO_DOWNSAMPLE_COUNT && lanzarLecturaFifoIMUinvensense(driver))
+        driver->contadorDrdy = 0;
+}
+
+
+/***************************************************************************************
+**  Nombre:         bool lanzarLecturaFifoIMUinvensense(imuInvensense_t *driver)
+**  Descripcion:    Encola la lectura del numero de bytes de la FIFO si no hay otra en curso
+**  Parametros:     Puntero al driver
+**  Retorno:        True si se ha encolado
+****************************************************************************************/
+CODIGO_RAPIDO bool lanzarLecturaFifoIMUinvensense(imuInvensense_t *driver)
+{
+    bool lanzar = false;
+
+    BLOQUE_ATOMICO_FIFO_INVENSENSE {
+        if (driver->estadoFifo == LECTURA_FIFO_LIBRE) {
+            driver->estadoFifo = LECTURA_FIFO_CUENTA;
+            lanzar = true;
+        }
+    }
+
+    if (!lanzar)
+        return false;
+
+    if (!leerBufferRegistroAsincronoBus(&driver->imu->bus, &driver->transaccionFifo, INVENSENSE_FIFO_COUNTH | 0x80, driver->bufferCuenta, 2,
+                                        cuentaFifoLeidaIMUinvensense, driver)) {
+        driver->estadoFifo = LECTURA_FIFO_LIBRE;
+        return false;
+    }
+
+    return true;
+}
+
+
+/***************************************************************************************
+**  Nombre:         void cuentaFifoLeidaIMUinvensense(transaccionSPI_t *transaccion)
+**  Descripcion:    Fin de la lectura de la cuenta. Encola la rafaga de muestras completas
+**                  o pide el reset de la FIFO si se ha desbordado
+**  Parametros:     Transaccion terminada
+**  Retorno:        Ninguno
+****************************************************************************************/
+CODIGO_RAPIDO void cuentaFifoLeidaIMUinvensense(transaccionSPI_t *transaccion)
+{
+    imuInvensense_t *driver = transaccion->paramUsuario;
+    uint8_t numMuestras;
+
+    if (transaccion->estado != TRANSACCION_SPI_COMPLETADA) {
+        driver->estadoFifo = LECTURA_FIFO_RESETEAR;
+        return;
+    }
+
+    const uint16_t cuenta = ((driver->bufferCuenta[1] << 8) | driver->bufferCuenta[2]) & INVENSENSE_FIFO_COUNT_MASK;
+
+    switch (comprobarCuentaFifoInvensense(&driver->fifo, cuenta, driver->tamFifo, INVENSENSE_FIFO_BUFFER_LEN, &numMuestras)) {
+        case FIFO_INVENSENSE_OK:
+            break;
+
+        case FIFO_INVENSENSE_VACIA:
+            driver->estadoFifo = LECTURA_FIFO_LIBRE;
+            return;
+
+        default:
+            driver->estadoFifo = LECTURA_FIFO_RESETEAR;
+            return;
+    }
+
+    // La muestra mas reciente de la FIFO es de ahora y las que se quedan sin leer son posteriores a las leidas
+    driver->numMuestrasFifo = numMuestras;
+    driver->tiempoMuestraFifo = micros() - (cuenta / INVENSENSE_SAMPLE_SIZE - numMuestras) * PERIODO_MUESTRA_FIFO_INVENSENSE;
+    driver->estadoFifo = LECTURA_FIFO_DATOS;
+
+    if (!leerBufferRegistroAsincronoBus(&driver->imu->bus, &driver->transaccionFifo, INVENSENSE_FIFO_R_W | 0x80, driver->bufferFifo,
+                                        numMuestras * INVENSENSE_SAMPLE_SIZE, datosFifoLeidosIMUinvensense, driver))
+        driver->estadoFifo = LECTURA_FIFO_LIBRE;
+}
+
+
+/***************************************************************************************
+**  Nombre:         void datosFifoLeidosIMUinvensense(transaccionSPI_t *transaccion)
+**  Descripcion:    Fin de la rafaga. Las muestras se procesan en la tarea
+**  Parametros:     Transaccion terminada
+**  Retorno:        Ninguno
+****************************************************************************************/
+CODIGO_RAPIDO void datosFifoLeidosIMUinvensense(transaccionSPI_t *transaccion)
+{
+    imuInvensense_t *driver = transaccion->paramUsuario;
+
+    if (transaccion->estado == TRANSACCION_SPI_COMPLETADA)
+        driver->estadoFifo = LECTURA_FIFO_DATOS_LISTOS;
+    else
+        driver->estadoFifo = LECTURA_FIFO_RESETEAR;
+}
+
+
+/***************************************************************************************
+**  Nombre:         void fifoReseteadaIMUinvensense(transaccionSPI_t *transaccion)
+**  Descripcion:    Fin del reset de la FIFO. Se vuelve a buscar el inicio de los paquetes
+**  Parametros:     Transaccion terminada
+**  Retorno:        Ninguno
+****************************************************************************************/
+void fifoReseteadaIMUinvensense(transaccionSPI_t *transaccion)
+{
+    imuInvensense_t *driver = transaccion->paramUsuario;
+
+    if (transaccion->estado != TRANSACCION_SPI_COMPLETADA) {
+        driver->estadoFifo = LECTURA_FIFO_RESETEAR;
+        return;
+    }
+
+    resetearFifoInvensense(&driver->fifo);
+    driver->contadorDrdy = 0;
+    driver->estadoFifo = LECTURA_FIFO_LIBRE;
+}
+
+
+/***************************************************************************************
+**  Nombre:         void actualizarFifoIMUinvensense(imu_t *dIMU)
+**  Descripcion:    Avanza la lectura de la FIFO desde la tarea: procesa las rafagas
+**                  recibidas, resetea la FIFO y consulta la cuenta si no hay DRDY
+**  Parametros:     Puntero a la IMU
+**  Retorno:        Ninguno
+****************************************************************************************/
+CODIGO_RAPIDO void actualizarFifoIMUinvensense(imu_t *dIMU)
+{
+    imuInvensense_t *driver = dIMU->driver;
+
+    switch (driver->estadoFifo) {
+        case LECTURA_FIFO_DATOS_LISTOS:
+            procesarFifoIMUinvensense(dIMU);
+
+            if (!driver->drdyHabilitado)
+                lanzarLecturaFifoIMUinvensense(driver);
+            break;
+
+        case LECTURA_FIFO_RESETEAR:
+            driver->estadoFifo = LECTURA_FIFO_RESETEANDO;
+            driver->bufferCuenta[1] = driver->regControl | INVENSENSE_USER_FIFO_RST;
+
+            if (!escribirBufferRegistroAsincronoBus(&dIMU->bus, &driver->transaccionFifo, INVENSENSE_USER_CTRL, driver->bufferCuenta, 1,
+                                                    fifoReseteadaIMUinvensense, driver))
+                driver->estadoFifo = LECTURA_FIFO_RESETEAR;
+            break;
+
+        case LECTURA_FIFO_LIBRE:
+            if (!driver->drdyHabilitado)
+                lanzarLecturaFifoIMUinvensense(driver);
+            break;
+
+        default:
+            // Comprueba el timeout de la transferencia en curso
+            transaccionSPIterminada(&driver->transaccionFifo);
+            break;
+    }
+}
+
+
+/***************************************************************************************
+**  Nombre:         void procesarFifoIMUinvensense(imu_t *dIMU)
+**  Descripcion:    Decodifica la rafaga y pasa cada muestra con su instante por la cadena
+**                  de correccion y filtrado de la IMU
+**  Parametros:     Puntero a la IMU
+**  Retorno:        Ninguno
+****************************************************************************************/
+CODIGO_RAPIDO void procesarFifoIMUinvensense(imu_t *dIMU)
+{
+    imuInvensense_t *driver = dIMU->driver;
+    const uint8_t numMuestras = driver->numMuestrasFifo;
+    int16_t adc[7];
+
+    for (uint8_t i = 0; i < numMuestras; i++) {
+        // Un paquete desalineado invalida el resto de la rafaga
+        if (!decodificarMuestraFifoInvensense(&driver->fifo, &driver->bufferFifo[1 + i * INVENSENSE_SAMPLE_SIZE], adc)) {
+            driver->estadoFifo = LECTURA_FIFO_RESETEAR;
+            return;
+        }
+
+        // Se rotan las medidas para alinearlas con los ejes
+        driver->acelRaw[0] = -(float)adc[1];
+        driver->acelRaw[1] = -(float)adc[0];
+        driver->acelRaw[2] =  (float)adc[2];
+        driver->tempRaw    =  (float)adc[3];
+        driver->giroRaw[0] =  (float)adc[5];
+        driver->giroRaw[1] =  (float)adc[4];
+        driver->giroRaw[2] = -(float)adc[6];
+
+        calcularIMUinvensense(dIMU, driver->tiempoMuestraFifo - (numMuestras - 1 - i) * PERIODO_MUESTRA_FIFO_INVENSENSE);
+        procesarMedidaIMU(dIMU);
+    }
+
+    dIMU->timing.ultimaActualizacion = micros();
+    driver->estadoFifo = LECTURA_FIFO_LIBRE;
+}
+
+
+/***************************************************************************************
+**  Nombre:         void resetearFifoInvensense(fifoInvensense_t *fifo)
+**  Descripcion:    Olvida la referencia de alineamiento tras vaciar la FIFO
+**  Parametros:     Puntero al estado de la FIFO
+**  Retorno:        Ninguno
+****************************************************************************************/
+void resetearFifoInvensense(fifoInvensense_t *fifo)
+{
+    fifo->tempValida = false;
+}
+
+
+/***************************************************************************************
+**  Nombre:         estadoFifoInvensense_e comprobarCuentaFifoInvensense(fifoInvensense_t *fifo, uint16_t cuenta,
+**                                                                       uint16_t tamFifo, uint8_t maxMuestras,
+**                                                                       uint8_t *numMuestras)
+**  Descripcion:    Calcula las muestras completas a leer a partir de la cuenta de bytes
+**  Parametros:     Puntero al estado de la FIFO, bytes en la FIFO, capacidad de la FIFO,
+**                  muestras maximas por rafaga, muestras a leer
+**  Retorno:        Estado de la FIFO
+****************************************************************************************/
+CODIGO_RAPIDO estadoFifoInvensense_e comprobarCuentaFifoInvensense(fifoInvensense_t *fifo, uint16_t cuenta, uint16_t tamFifo, uint8_t maxMuestras,
+                                                                   uint8_t *numMuestras)
+{
+    *numMuestras = 0;
+
+    // Con la FIFO llena el sensor sobrescribe los datos antiguos y se pierde el inicio de los paquetes
+    if (cuenta + INVENSENSE_SAMPLE_SIZE > tamFifo) {
+        fifo->numDesbordes++;
+        return FIFO_INVENSENSE_DESBORDADA;
+    }
+
+    if (cuenta < INVENSENSE_SAMPLE_SIZE)
+        return FIFO_INVENSENSE_VACIA;
+
+    *numMuestras = MIN(cuenta / INVENSENSE_SAMPLE_SIZE, maxMuestras);
+    return FIFO_INVENSENSE_OK;
+}
+
+
+/***************************************************************************************
+**  Nombre:         bool decodificarMuestraFifoInvensense(fifoInvensense_t *fifo, const uint8_t *paquete, int16_t *adc)
+**  Descripcion:    Decodifica un paquete de la FIFO y comprueba que este alineado. La
+**                  temperatura cambia despacio, un salto brusco indica que el paquete no
+**                  empieza en la aceleracion X
+**  Parametros:     Puntero al estado de la FIFO, paquete, valores del adc
+**  Retorno:        True si el paquete es valido
+****************************************************************************************/
+CODIGO_RAPIDO bool decodificarMuestraFifoInvensense(fifoInvensense_t *fifo, const uint8_t *paquete, int16_t *adc)
+{
+    for (uint8_t i = 0; i < 7; i++)
+        adc[i] = (int16_t)((paquete[2 * i] << 8) | paquete[2 * i + 1]);
+
+    if (fifo->tempValida && ABS(adc[3] - fifo->tempReferencia) > UMBRAL_TEMP_FIFO_INVENSENSE) {
+        fifo->numDesalineados++;
+        return false;
+    }
+
+    fifo->tempReferencia = adc[3];
+    fifo->tempValida = true;
+    fifo->numMuestras++;
+    return true;
+}
+
+
 /***************************************************************************************
 **  Nombre:         tablaFnIMU_t tablaFnIMUinvensense
 **  Descripcion:    Tabla de funciones de la IMU invensense
@@ -0,0 +1,73 @@
+/***************************************************************************************
+**  imu_invensense.h - Lectura de la FIFO de las IMU del fabricante Invensense
+**
+**
+**  Este fichero forma parte del proyecto URpilot.
+**  Codigo desarrollado por el grupo de investigacion ICON de la Universidad de La Rioja
+**
+**  Autor: Ramon Rico
+**  Fecha de creacion: 17/10/2026
+**  Fecha de modificacion: 17/10/2026
+**
+**  El proyecto URpilot NO es libre. No se puede distribuir y/o modificar este fichero
+**  bajo ningun concepto.
+**
+**  En caso de modificacion y/o solicitud de informacion pongase en contacto con
+**  el grupo de investigacion ICON a traves de: www.unirioja.es/urpilot
+**
+**
+**  Control de versiones del fichero
+**
+**  v1.0  Ramon Rico. Se ha liberado la primera version estable
+**
+****************************************************************************************/
+
+#ifndef __IMU_INVENSENSE_H
+#define __IMU_INVENSENSE_H
+
+/***************************************************************************************
+** AREA DE INCLUDES                                                                   **
+****************************************************************************************/
+#include <stdint.h>
+#include <stdbool.h>
+
+
+/***************************************************************************************
+** AREA DE PREPROCESADOR                                                              **
+****************************************************************************************/
+#define INVENSENSE_SAMPLE_SIZE                 14      // Aceleracion, temperatura y giro en el orden de los registros
+#define UMBRAL_TEMP_FIFO_INVENSENSE            340     // Salto de temperatura entre muestras (LSB) que indica FIFO desalineada
+
+
+/***************************************************************************************
+** AREA DE DEFINICION DE TIPOS                                                        **
+****************************************************************************************/
+typedef enum {
+    FIFO_INVENSENSE_OK = 0,
+    FIFO_INVENSENSE_VACIA,
+    FIFO_INVENSENSE_DESALINEADA,
+    FIFO_INVENSENSE_DESBORDADA,
+} estadoFifoInvensense_e;
+
+typedef struct {
+    int16_t tempReferencia;
+    bool tempValida;
+    uint32_t numMuestras;
+    uint16_t numDesalineados;
+    uint16_t numDesbordes;
+} fifoInvensense_t;
+
+
+/***************************************************************************************
+** AREA DE DECLARACION DE VARIABLES                                                   **
+****************************************************************************************/
+
+
+/***************************************************************************************
+** AREA DE PROTOTIPOS DE FUNCION                                                      **
+****************************************************************************************/
+void resetearFifoInvensense(fifoInvensense_t *fifo);
+estadoFifoInvensense_e comprobarCuentaFifoInvensense(fifoInvensense_t *fifo, uint16_t cuenta, uint16_t tamFifo, uint8_t maxMuestras, uint8_t *numMuestras);
+bool decodificarMuestraFifoInvensense(fifoInvensense_t *fifo, const uint8_t *paquete, int16_t *adc);
+
+#endif // __IMU_INVENSENSE_H
@@ -0,0 +1,387 @@
+/***************************************************************************************
+**  votacion_imu.c - Votacion de las IMUs redundantes. Salud de cada IMU y pesos en
+**                   la mezcla
+**
+**
+**  Este fichero forma parte del proyecto URpilot.
+**  Codigo desarrollado por el grupo de investigacion ICON de la Universidad de La Rioja
+**
+**  Autor: Ramon Rico
+**  Fecha de creacion: 17/10/2026
+**  Fecha de modificacion: 17/10/2026
+**
+**  El proyecto URpilot NO es libre. No se puede distribuir y/o modificar este fichero
+**  bajo ningun concepto.
+**
+**  En caso de modificacion y/o solicitud de informacion pongase en contacto con
+**  el grupo de investigacion ICON a traves de: www.unirioja.es/urpilot
+**
+**
+**  Control de versiones del fichero
+**
+**  v1.0  Ramon Rico. Se ha liberado la primera version estable
+**
+****************************************************************************************/
+
+/***************************************************************************************
+** AREA DE INCLUDES                                                                   **
+****************************************************************************************/
+#include <string.h>
+#include <math.h>
+
+#include "votacion_imu.h"
+
+#ifdef USAR_IMU
+#include "Comun/matematicas.h"
+
+
+/***************************************************************************************
+** AREA DE PREPROCESADOR                                                              **
+****************************************************************************************/
+// Estadisticas por muestra
+#define ALFA_RUIDO_VOTACION_IMU             0.02f       // Media movil de |dGiro|^2 (~50 muestras)
+#define ALFA_SATURACION_VOTACION_IMU        0.005f      // Media movil de las muestras saturadas (~200 muestras)
+#define MUESTRAS_ATASCO_VOTACION_IMU        10          // Muestras seguidas con los tres ejes del giro sin cambiar
+
+// Umbrales de fallo
+#define TOL_GIRO_VOTACION_IMU               5.0f        // º/s respecto a la mediana
+#define TOL_ACEL_VOTACION_IMU               0.15f       // g respecto a la mediana
+#define TOL_RELATIVA_VOTACION_IMU           0.05f       // Diferencias de escala entre sensores
+#define MIN_IMUS_CONSISTENCIA_VOTACION_IMU  3           // Con dos IMUs no se sabe cual de las dos falla
+#define VARIANZA_MIN_VOTACION_IMU           0.05f       // (º/s)^2. Suelo del ruido de un giroscopo sano
+#define RATIO_RUIDO_VOTACION_IMU            16.0f       // Varianza frente a la menor del resto (x4 en desviacion)
+#define TASA_SATURACION_VOTACION_IMU        0.02f
+#define TEMP_MIN_VOTACION_IMU               -40.0f      // ºC. Rango de operacion de los sensores
+#define TEMP_MAX_VOTACION_IMU               85.0f
+#define DIF_TEMP_VOTACION_IMU               20.0f       // ºC respecto a la mediana
+
+// Histeresis en ciclos de votacion
+#define CICLOS_EXCLUSION_VOTACION_IMU       20          // Ciclos seguidos con fallo para sacarla de la mezcla
+#define CICLOS_READMISION_VOTACION_IMU      1000        // Ciclos seguidos sin fallo para volver a la mezcla
+#define FACTOR_SOSPECHOSA_VOTACION_IMU      0.05f       // Peso relativo de una IMU con fallo aun no excluida
+
+
+/***************************************************************************************
+** AREA DE DEFINICION DE TIPOS                                                        **
+****************************************************************************************/
+
+
+/***************************************************************************************
+** AREA DE DECLARACION DE VARIABLES                                                   **
+****************************************************************************************/
+
+
+/***************************************************************************************
+** AREA DE PROTOTIPOS DE FUNCION                                                      **
+****************************************************************************************/
+void actualizarEstadisticasVotacionIMU(saludIMU_t *salud, const imu_t *dIMU);
+float varianzaReferenciaVotacionIMU(const votacionIMU_t *votacion, uint8_t numIMU, const bool *candidata);
+float medianaVotacionIMU(float *valores, uint8_t num);
+void calcularMedianasVotacionIMU(const votacionIMU_t *votacion, const imu_t *imus, const bool *candidata, float *mediana);
+uint8_t evaluarFallosVotacionIMU(const saludIMU_t *salud, const imu_t *dIMU, const float *mediana, float varianzaReferencia,
+                                 uint8_t numReferencia);
+void actualizarEstadoVotacionIMU(saludIMU_t *salud);
+
+
+/***************************************************************************************
+** AREA DE DEFINICION DE FUNCIONES                                                    **
+****************************************************************************************/
+
+/***************************************************************************************
+**  Nombre:         void iniciarVotacionIMU(votacionIMU_t *votacion, uint8_t numIMUs)
+**  Descripcion:    Resetea la salud de todas las IMUs
+**  Parametros:     Votacion, numero de IMUs del array
+**  Retorno:        Ninguno
+****************************************************************************************/
+void iniciarVotacionIMU(votacionIMU_t *votacion, uint8_t numIMUs)
+{
+    memset(votacion, 0, sizeof(votacionIMU_t));
+    votacion->numIMUs = MIN(numIMUs, NUM_MAX_IMU);
+}
+
+
+/***************************************************************************************
+**  Nombre:         void actualizarEstadisticasVotacionIMU(saludIMU_t *salud, const imu_t *dIMU)
+**  Descripcion:    Actualiza el ruido, el atasco y la saturacion con cada muestra nueva
+**  Parametros:     Salud de la IMU, IMU
+**  Retorno:        Ninguno
+****************************************************************************************/
+CODIGO_RAPIDO void actualizarEstadisticasVotacionIMU(saludIMU_t *salud, const imu_t *dIMU)
+{
+    if (dIMU->timing.ultimaMedida == salud->ultimaMedida)
+        return;
+
+    // La primera muestra solo sirve de referencia
+    if (salud->ultimaMedida != 0) {
+        float difCuadrado = 0;
+
+        for (uint8_t i = 0; i < 3; i++) {
+            const float dif = dIMU->giro[i] - salud->giroAnterior[i];
+            difCuadrado += dif * dif;
+        }
+
+        // Con ruido por encima del LSB es muy improbable repetir los tres ejes varias muestras seguidas
+        if (difCuadrado == 0) {
+            if (salud->cntAtasco < MUESTRAS_ATASCO_VOTACION_IMU)
+                salud->cntAtasco++;
+        }
+        else
+            salud->cntAtasco = 0;
+
+        salud->atascada = salud->cntAtasco >= MUESTRAS_ATASCO_VOTACION_IMU;
+        salud->varianzaRuido += ALFA_RUIDO_VOTACION_IMU * (difCuadrado - salud->varianzaRuido);
+
+        const float saturada = dIMU->numSaturaciones != salud->saturacionesAnterior ? 1 : 0;
+        salud->tasaSaturacion += ALFA_SATURACION_VOTACION_IMU * (saturada - salud->tasaSaturacion);
+    }
+
+    for (uint8_t i = 0; i < 3; i++)
+        salud->giroAnterior[i] = dIMU->giro[i];
+
+    salud->saturacionesAnterior = dIMU->numSaturaciones;
+    salud->ultimaMedida = dIMU->timing.ultimaMedida;
+}
+
+
+/***************************************************************************************
+**  Nombre:         float medianaVotacionIMU(float *valores, uint8_t num)
+**  Descripcion:    Mediana por insercion. Son como mucho NUM_MAX_IMU valores
+**  Parametros:     Valores (se reordenan), numero de valores
+**  Retorno:        Mediana
+****************************************************************************************/
+CODIGO_RAPIDO float medianaVotacionIMU(float *valores, uint8_t num)
+{
+    for (uint8_t i = 1; i < num; i++) {
+        const float valor = valores[i];
+        int8_t j = i - 1;
+
+        while (j >= 0 && valores[j] > valor) {
+            valores[j + 1] = valores[j];
+            j--;
+        }
+        valores[j + 1] = valor;
+    }
+
+    if (num & 1)
+        return valores[num / 2];
+    else
+        return 0.5f * (valores[num / 2 - 1] + valores[num / 2]);
+}
+
+
+/***************************************************************************************
+**  Nombre:         void calcularMedianasVotacionIMU(const votacionIMU_t *votacion, const imu_t *imus,
+**                                                   const bool *candidata, float *mediana)
+**  Descripcion:    Mediana por eje del giro, de la aceleracion y de la temperatura. Si quedan
+**                  suficientes IMUs sin excluir solo cuentan esas
+**  Parametros:     Votacion, IMUs, IMUs candidatas, medianas (giro, acel y temperatura)
+**  Retorno:        Ninguno
+****************************************************************************************/
+CODIGO_RAPIDO void calcularMedianasVotacionIMU(const votacionIMU_t *votacion, const imu_t *imus, const bool *candidata, float *mediana)
+{
+    float valores[7][NUM_MAX_IMU];
+    uint8_t numNoExcluidas = 0, num = 0;
+
+    for (uint8_t i = 0; i < votacion->numIMUs; i++) {
+        if (candidata[i] && votacion->salud[i].estado != SALUD_IMU_EXCLUIDA)
+            numNoExcluidas++;
+    }
+
+    const bool soloNoExcluidas = numNoExcluidas >= MIN_IMUS_CONSISTENCIA_VOTACION_IMU;
+
+    for (uint8_t i = 0; i < votacion->numIMUs; i++) {
+        if (!candidata[i] || (soloNoExcluidas && votacion->salud[i].estado == SALUD_IMU_EXCLUIDA))
+            continue;
+
+        for (uint8_t j = 0; j < 3; j++) {
+            valores[j][num] = imus[i].giroFiltrado[j];
+            valores[j + 3][num] = imus[i].acelFiltrada[j];
+        }
+        valores[6][num] = imus[i].temperatura;
+        num++;
+    }
+
+    for (uint8_t j = 0; j < 7; j++)
+        mediana[j] = num > 0 ? medianaVotacionIMU(valores[j], num) : 0;
+}
+
+
+/***************************************************************************************
+**  Nombre:         float varianzaReferenciaVotacionIMU(const votacionIMU_t *votacion, uint8_t numIMU,
+**                                                      const bool *candidata)
+**  Descripcion:    Ruido de la IMU mas limpia del resto. Las atascadas no cuentan
+**  Parametros:     Votacion, IMU a evaluar, IMUs candidatas
+**  Retorno:        Varianza de referencia. Infinito si no hay otra IMU
+****************************************************************************************/
+CODIGO_RAPIDO float varianzaReferenciaVotacionIMU(const votacionIMU_t *votacion, uint8_t numIMU, const bool *candidata)
+{
+    float varianzaMin = INFINITY;
+
+    for (uint8_t i = 0; i < votacion->numIMUs; i++) {
+        if (i != numIMU && candidata[i] && !votacion->salud[i].atascada)
+            varianzaMin = MIN(varianzaMin, votacion->salud[i].varianzaRuido);
+    }
+
+    return varianzaMin;
+}
+
+
+/***************************************************************************************
+**  Nombre:         uint8_t evaluarFallosVotacionIMU(const saludIMU_t *salud, const imu_t *dIMU,
+**                                                   const float *mediana, float varianzaReferencia,
+**                                                   uint8_t numReferencia)
+**  Descripcion:    Comprueba cada criterio de fallo de una IMU frente al resto
+**  Parametros:     Salud de la IMU, IMU, medianas, varianza de la IMU mas limpia del resto,
+**                  numero de IMUs candidatas
+**  Retorno:        Mascara de falloSaludIMU_e
+****************************************************************************************/
+CODIGO_RAPIDO uint8_t evaluarFallosVotacionIMU(const saludIMU_t *salud, const imu_t *dIMU, const float *mediana, float varianzaReferencia,
+                                               uint8_t numReferencia)
+{
+    uint8_t fallos = 0;
+
+    // Consistencia con la mediana. Con dos IMUs no se puede culpar a ninguna
+    if (numReferencia >= MIN_IMUS_CONSISTENCIA_VOTACION_IMU && salud->desviacion > 1)
+        fallos |= FALLO_SALUD_IMU_INCONSISTENTE;
+
+    // Ruido frente a la IMU mas limpia del resto
+    if (varianzaReferencia < INFINITY &&
+        salud->varianzaRuido > RATIO_RUIDO_VOTACION_IMU * MAX(varianzaReferencia, VARIANZA_MIN_VOTACION_IMU))
+        fallos |= FALLO_SALUD_IMU_RUIDO;
+
+    if (salud->atascada)
+        fallos |= FALLO_SALUD_IMU_ATASCADA;
+
+    if (salud->tasaSaturacion > TASA_SATURACION_VOTACION_IMU)
+        fallos |= FALLO_SALUD_IMU_SATURADA;
+
+    if (dIMU->temperatura < TEMP_MIN_VOTACION_IMU || dIMU->temperatura > TEMP_MAX_VOTACION_IMU ||
+        (numReferencia >= MIN_IMUS_CONSISTENCIA_VOTACION_IMU && fabsf(dIMU->temperatura - mediana[6]) > DIF_TEMP_VOTACION_IMU))
+        fallos |= FALLO_SALUD_IMU_TEMPERATURA;
+
+    return fallos;
+}
+
+
+/***************************************************************************************
+**  Nombre:         void actualizarEstadoVotacionIMU(saludIMU_t *salud)
+**  Descripcion:    Histeresis entre los estados de salud. Se excluye tras varios ciclos con
+**                  fallo y se readmite tras muchos mas sin el
+**  Parametros:     Salud de la IMU
+**  Retorno:        Ninguno
+****************************************************************************************/
+CODIGO_RAPIDO void actualizarEstadoVotacionIMU(saludIMU_t *salud)
+{
+    if (salud->fallos != 0) {
+        salud->cntOk = 0;
+        if (salud->cntFallo < CICLOS_EXCLUSION_VOTACION_IMU)
+            salud->cntFallo++;
+
+        if (salud->estado == SALUD_IMU_OK)
+            salud->estado = SALUD_IMU_SOSPECHOSA;
+
+        if (salud->estado != SALUD_IMU_EXCLUIDA && salud->cntFallo >= CICLOS_EXCLUSION_VOTACION_IMU) {
+            salud->estado = SALUD_IMU_EXCLUIDA;
+            salud->numExclusiones++;
+        }
+    }
+    else {
+        salud->cntFallo = 0;
+
+        if (salud->estado == SALUD_IMU_EXCLUIDA) {
+            if (++salud->cntOk >= CICLOS_READMISION_VOTACION_IMU) {
+                salud->estado = SALUD_IMU_OK;
+                salud->cntOk = 0;
+            }
+        }
+        else
+            salud->estado = SALUD_IMU_OK;
+    }
+}
+
+
+/***************************************************************************************
+**  Nombre:         uint8_t votarIMU(votacionIMU_t *votacion, const imu_t *imus, const bool *candidata)
+**  Descripcion:    Evalua la salud de las IMUs candidatas y calcula su peso en la mezcla:
+**                  inverso del ruido, penalizado por la distancia a la mediana y a cero si
+**                  esta excluida. Nunca se quedan todas fuera: si no queda ninguna se usa
+**                  la mejor
+**  Parametros:     Votacion, IMUs, IMUs que pueden entrar en la mezcla
+**  Retorno:        Numero de IMUs con peso
+****************************************************************************************/
+CODIGO_RAPIDO uint8_t votarIMU(votacionIMU_t *votacion, const imu_t *imus, const bool *candidata)
+{
+    float mediana[7];
+    float pesoBruto[NUM_MAX_IMU];
+    float sumaPesos = 0;
+    uint8_t numCandidatas = 0, numConPeso = 0;
+    int8_t mejor = -1;
+
+    for (uint8_t i = 0; i < votacion->numIMUs; i++) {
+        if (candidata[i]) {
+            actualizarEstadisticasVotacionIMU(&votacion->salud[i], &imus[i]);
+            numCandidatas++;
+        }
+    }
+
+    calcularMedianasVotacionIMU(votacion, imus, candidata, mediana);
+
+    for (uint8_t i = 0; i < votacion->numIMUs; i++) {
+        saludIMU_t *salud = &votacion->salud[i];
+
+        salud->peso = 0;
+        pesoBruto[i] = 0;
+        if (!candidata[i]) {
+            salud->fallos = 0;
+            continue;
+        }
+
+        // Distancia a la mediana en el peor eje, normalizada con la tolerancia
+        float desviacion = 0;
+        for (uint8_t j = 0; j < 3; j++) {
+            const float devGiro = fabsf(imus[i].giroFiltrado[j] - mediana[j]) /
+                                  (TOL_GIRO_VOTACION_IMU + TOL_RELATIVA_VOTACION_IMU * fabsf(mediana[j]));
+            const float devAcel = fabsf(imus[i].acelFiltrada[j] - mediana[j + 3]) /
+                                  (TOL_ACEL_VOTACION_IMU + TOL_RELATIVA_VOTACION_IMU * fabsf(mediana[j + 3]));
+            desviacion = MAX(desviacion, MAX(devGiro, devAcel));
+        }
+        salud->desviacion = desviacion;
+
+        const float varianzaReferencia = varianzaReferenciaVotacionIMU(votacion, i, candidata);
+        salud->fallos = evaluarFallosVotacionIMU(salud, &imus[i], mediana, varianzaReferencia, numCandidatas);
+        actualizarEstadoVotacionIMU(salud);
+
+        // Una IMU mas limpia que todas las demas no gana mas peso: puede estar atascada
+        float varianza = MAX(salud->varianzaRuido, VARIANZA_MIN_VOTACION_IMU);
+        if (varianzaReferencia < INFINITY)
+            varianza = MAX(varianza, varianzaReferencia);
+
+        pesoBruto[i] = 1 / (varianza * (1 + desviacion * desviacion));
+        if (salud->fallos != 0)
+            pesoBruto[i] *= FACTOR_SOSPECHOSA_VOTACION_IMU;
+
+        if (mejor < 0 || pesoBruto[i] > pesoBruto[mejor])
+            mejor = i;
+
+        if (salud->estado != SALUD_IMU_EXCLUIDA) {
+            salud->peso = pesoBruto[i];
+            sumaPesos += pesoBruto[i];
+            numConPeso++;
+        }
+    }
+
+    if (mejor < 0)
+        return 0;
+
+    if (numConPeso == 0) {
+        votacion->salud[mejor].peso = 1;
+        return 1;
+    }
+
+    for (uint8_t i = 0; i < votacion->numIMUs; i++)
+        votacion->salud[i].peso /= sumaPesos;
+
+    return numConPeso;
+}
+
+#endif
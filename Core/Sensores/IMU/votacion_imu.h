@@ -0,0 +1,80 @@
+/***************************************************************************************
+**  votacion_imu.h - Votacion de las IMUs redundantes. Salud de cada IMU y pesos en
+**                   la mezcla
+**
+**
+**  Este fichero forma parte del proyecto URpilot.
+**  Codigo desarrollado por el grupo de investigacion ICON de la Universidad de La Rioja
+**
+**  Autor: Ramon Rico
+**  Fecha de creacion: 17/10/2026
+**  Fecha de modificacion: 17/10/2026
+**
+**  El proyecto URpilot NO es libre. No se puede distribuir y/o modificar este fichero
+**  bajo ningun concepto.
+**
+**  En caso de modificacion y/o solicitud de informacion pongase en contacto con
+**  el grupo de investigacion ICON a traves de: www.unirioja.es/urpilot
+**
+**
+**  Control de versiones del fichero
+**
+**  v1.0  Ramon Rico. Se ha liberado la primera version estable
+**
+****************************************************************************************/
+
+#ifndef __VOTACION_IMU_H
+#define __VOTACION_IMU_H
+
+/***************************************************************************************
+** AREA DE INCLUDES                                                                   **
+****************************************************************************************/
+#include <stdint.h>
+#include <stdbool.h>
+
+#include "imu.h"
+
+
+/***************************************************************************************
+** AREA DE PREPROCESADOR                                                              **
+****************************************************************************************/
+
+
+/***************************************************************************************
+** AREA DE DEFINICION DE TIPOS                                                        **
+****************************************************************************************/
+typedef struct {
+    estadoSaludIMU_e estado;
+    uint8_t fallos;                      // Mascara de falloSaludIMU_e de la ultima evaluacion
+    float peso;                          // Peso normalizado en la mezcla
+    float desviacion;                    // Distancia a la mediana del resto normalizada con la tolerancia
+    float varianzaRuido;                 // Media movil de |dGiro|^2 entre muestras en (º/s)^2
+    float tasaSaturacion;                // Fraccion de muestras saturadas
+    bool atascada;
+    float giroAnterior[3];
+    uint32_t ultimaMedida;
+    uint32_t saturacionesAnterior;
+    uint16_t cntAtasco;                  // Muestras seguidas sin cambios en el giro
+    uint16_t cntFallo;
+    uint16_t cntOk;
+    uint16_t numExclusiones;
+} saludIMU_t;
+
+typedef struct {
+    uint8_t numIMUs;
+    saludIMU_t salud[NUM_MAX_IMU];
+} votacionIMU_t;
+
+
+/***************************************************************************************
+** AREA DE DECLARACION DE VARIABLES                                                   **
+****************************************************************************************/
+
+
+/***************************************************************************************
+** AREA DE PROTOTIPOS DE FUNCION                                                      **
+****************************************************************************************/
+void iniciarVotacionIMU(votacionIMU_t *votacion, uint8_t numIMUs);
+uint8_t votarIMU(votacionIMU_t *votacion, const imu_t *imus, const bool *candidata);
+
+#endif // __VOTACION_IMU_H
@@ -7,7 +7,7 @@
 **
 **  Autor: Ramon Rico
 **  Fecha de creacion: 01/06/2019
-**  Fecha de modificacion: 03/08/2020
+**  Fecha de modificacion: 17/10/2026
 **
 **  El proyecto URpilot NO es libre. No se puede distribuir y/o modificar este fichero
 **  bajo ningun concepto.
@@ -98,6 +98,12 @@ typedef struct {
     float ganancia;
     float campoMagRaw[3];
     acumulador3_t acumulador;
+
+    // Lectura asincrona en I2C: datos y estado en un bloque y peticion de la siguiente muestra
+    transaccionI2C_t transaccion[2];
+    uint8_t bufferLectura[8];
+    uint8_t bufferEscritura[2];
+    bool lecturaPendiente;
 } magHoneywell_t;
 
 
@@ -116,6 +122,8 @@ bool chequearIdMagHoneywell(bus_t *bus);
 bool configurarMagHoneywell(bus_t *bus);
 bool calibrarMagHoneywell(mag_t *dMag);
 bool leerAdcMagHoneywell(bus_t *bus, int16_t *adc);
+bool leerAdcAsincronoMagHoneywell(mag_t *dMag, int16_t *adc);
+bool convertirAdcMagHoneywell(const uint8_t *val, int16_t *adc);
 void leerMagHoneywell(mag_t *dMag);
 void actualizarMagHoneywell(mag_t *dMag);
 bool datoDisponibleMagHoneywell(bus_t *bus);
@@ -298,11 +306,67 @@ bool calibrarMagHoneywell(mag_t *dMag)
 bool leerAdcMagHoneywell(bus_t *bus, int16_t *adc)
 {
     uint8_t val[6];
-    int16_t aux[3];
 
     if (!leerBufferRegistroBus(bus, HONEYWELL_REG_DATO_X_MSB, (uint8_t *) &val, 6))
         return false;
 
+    return convertirAdcMagHoneywell(val, adc);
+}
+
+
+/***************************************************************************************
+**  Nombre:         bool leerAdcAsincronoMagHoneywell(mag_t *dMag, int16_t *adc)
+**  Descripcion:    Recoge la lectura encolada en la llamada anterior. Los datos y el registro
+**                  de estado se leen en un solo bloque. Si habia muestra se pide la siguiente
+**                  y si no se vuelve a leer. No espera al bus
+**  Parametros:     Puntero al magnetometro, valores del adc
+**  Retorno:        True si hay una lectura nueva y valida
+****************************************************************************************/
+bool leerAdcAsincronoMagHoneywell(mag_t *dMag, int16_t *adc)
+{
+    magHoneywell_t *driver = dMag->driver;
+    transaccionI2C_t *peticion = &driver->transaccion[1];
+    bool estado = false;
+
+    if (!cadenaTransaccionesI2Cterminada(driver->transaccion, 2))
+        return false;
+
+    if (driver->lecturaPendiente) {
+        driver->lecturaPendiente = false;
+
+        if (driver->transaccion[0].estado == TRANSACCION_I2C_COMPLETADA &&
+            (dMag->drdy != 0 || (driver->bufferLectura[1 + HONEYWELL_REG_ESTADO - HONEYWELL_REG_DATO_X_MSB] & 0x01))) {
+            estado = convertirAdcMagHoneywell(&driver->bufferLectura[1], adc);
+
+            // Pedimos una muestra. Se lee en la siguiente llamada
+            driver->bufferEscritura[1] = HONEYWELL_MODO_SINGLE;
+            escribirBufferRegistroAsincronoBusI2C(&dMag->bus, peticion, HONEYWELL_REG_MODO, driver->bufferEscritura, 1, NULL, NULL);
+            return estado;
+        }
+    }
+
+    // Si la peticion ha fallado el sensor no convierte y hay que repetirla
+    if (peticion->estado != TRANSACCION_I2C_LIBRE && peticion->estado != TRANSACCION_I2C_COMPLETADA) {
+        escribirBufferRegistroAsincronoBusI2C(&dMag->bus, peticion, HONEYWELL_REG_MODO, driver->bufferEscritura, 1, NULL, NULL);
+        return false;
+    }
+
+    driver->lecturaPendiente = leerBufferRegistroAsincronoBusI2C(&dMag->bus, &driver->transaccion[0], HONEYWELL_REG_DATO_X_MSB,
+                                                                 driver->bufferLectura, HONEYWELL_REG_ESTADO - HONEYWELL_REG_DATO_X_MSB + 1, NULL, NULL);
+    return false;
+}
+
+
+/***************************************************************************************
+**  Nombre:         bool convertirAdcMagHoneywell(const uint8_t *val, int16_t *adc)
+**  Descripcion:    Convierte los registros de datos y descarta las medidas saturadas
+**  Parametros:     Registros de datos, valores del adc
+**  Retorno:        True si ok
+****************************************************************************************/
+bool convertirAdcMagHoneywell(const uint8_t *val, int16_t *adc)
+{
+    int16_t aux[3];
+
     aux[0] = (int16_t)(val[0] << 8) | val[1];
     aux[2] = (int16_t)(val[2] << 8) | val[3];
     aux[1] = (int16_t)(val[4] << 8) | val[5];
@@ -359,15 +423,22 @@ void actualizarMagHoneywell(mag_t *dMag)
     int16_t adc[3];
     float mRaw[3];
 
-    if (dMag->drdy == 0) {
-        if (!datoDisponibleMagHoneywell(&dMag->bus))
-            return;
-    }
+    bool estado;
 
-    bool estado = leerAdcMagHoneywell(&dMag->bus, adc);
+    // En I2C no se espera al bus: se recoge la lectura encolada en la llamada anterior
+    if (dMag->bus.tipo == BUS_I2C)
+        estado = leerAdcAsincronoMagHoneywell(dMag, adc);
+    else {
+        if (dMag->drdy == 0) {
+            if (!datoDisponibleMagHoneywell(&dMag->bus))
+                return;
+        }
 
-    // Pedimos una muestra
-    escribirRegistroBus(&dMag->bus, HONEYWELL_REG_MODO, HONEYWELL_MODO_SINGLE);
+        estado = leerAdcMagHoneywell(&dMag->bus, adc);
+
+        // Pedimos una muestra
+        escribirRegistroBus(&dMag->bus, HONEYWELL_REG_MODO, HONEYWELL_MODO_SINGLE);
+    }
 
     if (!estado)
         return;
@@ -7,7 +7,7 @@
 **
 **  Autor: Ramon Rico
 **  Fecha de creacion: 01/06/2019
-**  Fecha de modificacion: 03/08/2020
+**  Fecha de modificacion: 17/10/2026
 **
 **  El proyecto URpilot NO es libre. No se puede distribuir y/o modificar este fichero
 **  bajo ningun concepto.
@@ -92,6 +92,12 @@ typedef struct {
     bool ignorarMuestra;
     float campoMagRaw[3];
     acumulador3_t acumulador;
+
+    // Lectura asincrona en I2C: ADC y peticion de la siguiente muestra
+    transaccionI2C_t transaccion[2];
+    uint8_t bufferLectura[7];
+    uint8_t bufferEscritura[2];
+    bool lecturaPendiente;
 } magIsentek_t;
 
 
@@ -117,6 +123,8 @@ bool configurarMagIsentek(bus_t *bus);
 bool calibrarMagIsentek(mag_t *dMag);
 void iniciarConversionMagIsentek(bus_t *bus, magIsentek_t *dMag);
 bool leerAdcMagIsentek(bus_t *bus, int16_t *adc);
+bool leerAdcAsincronoMagIsentek(mag_t *dMag, int16_t *adc);
+bool convertirAdcMagIsentek(const uint8_t *val, int16_t *adc);
 void leerMagIsentek(mag_t *dMag);
 void actualizarMagIsentek(mag_t *dMag);
 void calcularMagIsentek(mag_t *dMag);
@@ -279,11 +287,51 @@ void iniciarConversionMagIsentek(bus_t *bus, magIsentek_t *dMag)
 bool leerAdcMagIsentek(bus_t *bus, int16_t *adc)
 {
     uint8_t val[6];
-    int16_t aux[3];
 
     if (!leerBufferRegistroBus(bus, ISENTEK_OUTPUT_X_L_REG, (uint8_t *) &val, 6))
         return false;
 
+    return convertirAdcMagIsentek(val, adc);
+}
+
+
+/***************************************************************************************
+**  Nombre:         bool leerAdcAsincronoMagIsentek(mag_t *dMag, int16_t *adc)
+**  Descripcion:    Recoge la lectura encolada en la llamada anterior y encola la siguiente
+**                  junto con la peticion de una nueva muestra. No espera al bus
+**  Parametros:     Puntero al magnetometro, valores del adc
+**  Retorno:        True si hay una lectura nueva y valida
+****************************************************************************************/
+bool leerAdcAsincronoMagIsentek(mag_t *dMag, int16_t *adc)
+{
+    magIsentek_t *driver = dMag->driver;
+    bool estado = false;
+
+    if (!cadenaTransaccionesI2Cterminada(driver->transaccion, 2))
+        return false;
+
+    if (driver->lecturaPendiente && driver->transaccion[0].estado == TRANSACCION_I2C_COMPLETADA)
+        estado = convertirAdcMagIsentek(&driver->bufferLectura[1], adc);
+
+    driver->bufferEscritura[1] = ISENTEK_SINGLE_MEASUREMENT_MODE;
+    prepararLecturaRegistroBusI2C(&dMag->bus, &driver->transaccion[0], ISENTEK_OUTPUT_X_L_REG, driver->bufferLectura, 6, NULL, NULL);
+    prepararEscrituraRegistroBusI2C(&dMag->bus, &driver->transaccion[1], ISENTEK_REG_COTROL_A, driver->bufferEscritura, 1, NULL, NULL);
+    driver->lecturaPendiente = encolarCadenaTransaccionesI2C(driver->transaccion, 2);
+
+    return estado;
+}
+
+
+/***************************************************************************************
+**  Nombre:         bool convertirAdcMagIsentek(const uint8_t *val, int16_t *adc)
+**  Descripcion:    Convierte los registros de salida y descarta los valores fuera de rango
+**  Parametros:     Registros de salida, valores del adc
+**  Retorno:        True si ok
+****************************************************************************************/
+bool convertirAdcMagIsentek(const uint8_t *val, int16_t *adc)
+{
+    int16_t aux[3];
+
     aux[0] = (int16_t)(val[1] << 8) | val[0];
     aux[1] = (int16_t)(val[3] << 8) | val[2];
     aux[2] = (int16_t)(val[5] << 8) | val[4];
@@ -344,15 +392,22 @@ void actualizarMagIsentek(mag_t *dMag)
     int16_t adc[3];
     float mRaw[3];
 
-    if (driver->ignorarMuestra) {
-        driver->ignorarMuestra = false;
-        iniciarConversionMagIsentek(&dMag->bus, driver);
-    }
+    bool estado;
 
-    bool estado = leerAdcMagIsentek(&dMag->bus, adc);
+    // En I2C no se espera al bus: se recoge la lectura encolada en la llamada anterior
+    if (dMag->bus.tipo == BUS_I2C)
+        estado = leerAdcAsincronoMagIsentek(dMag, adc);
+    else {
+        if (driver->ignorarMuestra) {
+            driver->ignorarMuestra = false;
+            iniciarConversionMagIsentek(&dMag->bus, driver);
+        }
 
-    // Pedimos una muestra
-    iniciarConversionMagIsentek(&dMag->bus, driver);
+        estado = leerAdcMagIsentek(&dMag->bus, adc);
+
+        // Pedimos una muestra
+        iniciarConversionMagIsentek(&dMag->bus, driver);
+    }
 
     if (!estado)
         return;
@@ -7,7 +7,7 @@
 **
 **  Autor: Ramon Rico
 **  Fecha de creacion: 01/06/2019
-**  Fecha de modificacion: 21/09/2020
+**  Fecha de modificacion: 17/10/2026
 **
 **  El proyecto URpilot NO es libre. No se puede distribuir y/o modificar este fichero
 **  bajo ningun concepto.
@@ -168,6 +168,11 @@ bool iniciarMag(void)
             case MAG_IST8310:
                 tablaFnMag[i] = &tablaFnMagIsentek;
                 break;
+#ifdef SITL
+            case MAG_SITL:
+                tablaFnMag[i] = &tablaFnMagSITL;
+                break;
+#endif
 
             default:
 #ifdef DEBUG
@@ -278,16 +283,6 @@ void calcularMagGen(bool habMezcla)
 }
 
 
-
-#include "Sensores/IMU/imu.h"
-#include "Drivers/tiempo.h"
-extern reaction_t reaction;
-extern uint32_t rTimeMax;
-extern uint32_t rTimeMin;
-extern uint32_t rTime1;
-extern bool cambiarID;
-extern bool iniR;
-
 /***************************************************************************************
 **  Nombre:         void leerMag(uint32_t tiempoActual)
 **  Descripcion:    Lee el campo magnetico de todos los sensores
@@ -65,6 +65,9 @@ typedef enum {
     MAG_HMC5883 =  0,
     MAG_HMC5983,
     MAG_IST8310,
+#ifdef SITL
+    MAG_SITL,
+#endif
 } tipoMag_e;
 
 typedef struct {
@@ -102,6 +105,9 @@ typedef struct {
 ****************************************************************************************/
 extern tablaFnMag_t tablaFnMagHoneywell;
 extern tablaFnMag_t tablaFnMagIsentek;
+#ifdef SITL
+extern tablaFnMag_t tablaFnMagSITL;
+#endif
 
 
 /***************************************************************************************
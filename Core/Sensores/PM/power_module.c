@@ -7,7 +7,7 @@
 **
 **  Autor: Ramon Rico
 **  Fecha de creacion: 11/12/2020
-**  Fecha de modificacion: 11/12/2020
+**  Fecha de modificacion: 17/10/2026
 **
 **  El proyecto URpilot NO es libre. No se puede distribuir y/o modificar este fichero
 **  bajo ningun concepto.
@@ -49,8 +49,8 @@
 #define TIMEOUT_MEDIDA_PM           200000     // Timeout en us desde la ultima lectura
 #define TIMEOUT_CAMBIO_MEDIDA_PM    500000     // Timeout en us desde la ultima lectura con cambios en las medidas
 
-#define TAM_FILTRO_TENSION          8
-#define TAM_FILTRO_CORRIENTE        8
+#define LOG2_TAM_FILTRO_TENSION     3          // Ventana de 8 muestras
+#define LOG2_TAM_FILTRO_CORRIENTE   3
 
 
 /***************************************************************************************
@@ -73,8 +73,10 @@ static powerModuleGen_t powerModuleGen;
 // Filtros
 static acumulador_t acumuladorV[NUM_MAX_POWER_MODULE];
 static acumulador_t acumuladorI[NUM_MAX_POWER_MODULE];
-static filtroMediaMovil_t filtroTension[NUM_MAX_POWER_MODULE];
-static filtroMediaMovil_t filtroCorriente[NUM_MAX_POWER_MODULE];
+static filtroMediaMovilPot2_t filtroTension[NUM_MAX_POWER_MODULE];
+static filtroMediaMovilPot2_t filtroCorriente[NUM_MAX_POWER_MODULE];
+static float muestrasFiltroTension[NUM_MAX_POWER_MODULE][TAM_FILTRO_MEDIA_MOVIL_POT2(LOG2_TAM_FILTRO_TENSION)];
+static float muestrasFiltroCorriente[NUM_MAX_POWER_MODULE][TAM_FILTRO_MEDIA_MOVIL_POT2(LOG2_TAM_FILTRO_CORRIENTE)];
 
 
 /***************************************************************************************
@@ -159,8 +161,8 @@ bool iniciarPowerModule(void)
         }
         else {
             // Ajuste de los filtros
-            ajustarFiltroMediaMovil(&filtroTension[i], TAM_FILTRO_TENSION);
-            ajustarFiltroMediaMovil(&filtroCorriente[i], TAM_FILTRO_CORRIENTE);
+            ajustarFiltroMediaMovilPot2(&filtroTension[i], muestrasFiltroTension[i], LOG2_TAM_FILTRO_TENSION);
+            ajustarFiltroMediaMovilPot2(&filtroCorriente[i], muestrasFiltroCorriente[i], LOG2_TAM_FILTRO_CORRIENTE);
         }
     }
 
@@ -240,8 +242,8 @@ void leerDriverPowerModule(powerModule_t *dPowerModule)
     	corrienteRaw = (aI) / cuentaI;
 
     // Actualizacion de la estructura del power module
-    tensionFilt = actualizarFiltroMediaMovil(filtroTension, tensionRaw);
-    corrienteFilt = actualizarFiltroMediaMovil(filtroTension, corrienteRaw);
+    tensionFilt = actualizarFiltroMediaMovilPot2(&filtroTension[dPowerModule->numPM], tensionRaw);
+    corrienteFilt = actualizarFiltroMediaMovilPot2(&filtroCorriente[dPowerModule->numPM], corrienteRaw);
 
     // Actualizacion del timming
     if (dPowerModule->tension != tensionFilt || dPowerModule->corriente != corrienteFilt)
@@ -8,7 +8,7 @@
 **
 **  Autor: Ramon Rico
 **  Fecha de creacion: 23/04/2019
-**  Fecha de modificacion: 03/08/2020
+**  Fecha de modificacion: 17/10/2026
 **
 **  El proyecto URpilot NO es libre. No se puede distribuir y/o modificar este fichero
 **  bajo ningun concepto.
@@ -50,10 +50,24 @@
 #define USAR_RTC_HW
 
 
+// CRC ---------------------------------------------------------------------------------
+// Los bloques largos (configuracion, logs) se calculan con la unidad CRC del micro
+#define USAR_CRC_HW
+
+
+// SCHEDULER ---------------------------------------------------------------------------
+// Despacha las tareas en tiempo real por deadline (EDF) en vez de por orden de prioridad
+//#define USAR_SCHEDULER_EDF
+
+
 //DMA ----------------------------------------------------------------------------------
 #define USAR_DMA
 
 
+//EXTI ---------------------------------------------------------------------------------
+#define USAR_EXTI
+
+
 //TIMERS -------------------------------------------------------------------------------
 #define USAR_TIMERS
 
@@ -61,7 +75,7 @@
 //ADC ----------------------------------------------------------------------------------
 #define USAR_ADC
 #define USAR_ADC_INTERNO
-#define DMA_ADC_1                DMA2_Stream0
+#define DMA_ADC_1                DMA2_Stream4    // El DMA2_Stream0 es para la recepcion del SPI 1
 
 #define PIN_1_ADC_1              PB1            // Pin para obtener la version
 #define PIN_2_ADC_1              PB0            // Pin para obtener la revision
@@ -107,6 +121,26 @@
 #define PIN_TX_UART_8            PE1
 #define PIN_RX_UART_8            PE0
 
+// En el F7 todos los streams del DMA1 los pide algun timer de motores, asi que no hay streams
+// alternativos. Los motores se inician antes y el puerto cuyo stream quede reservado por el DSHOT
+// sigue por interrupcion (ver iniciarDriverUART):
+// - RX UART 2 DMA1_Stream5 (TIM3_CH2, motor 5), RX UART 3 DMA1_Stream1 (TIM2_CH3, motor 11),
+//   RX UART 5 DMA1_Stream0 (TIM4_CH1, motor 9)
+// - TX UART 2 DMA1_Stream6 (TIM4_UP en burst, TIM2_CH4 motor 12), TX UART 5 DMA1_Stream7
+//   (TIM4_CH3 motor 2, TIM2_UP en burst)
+
+// Recepcion por DMA circular de los puertos de GPS. La UART 7 (radio) sigue por interrupcion:
+// su unico stream de recepcion (DMA1_Stream3) lo usan el SPI 2 y el motor 1
+#define DMA_RX_UART_2            DMA1_Stream5
+#define DMA_RX_UART_3            DMA1_Stream1
+#define DMA_RX_UART_5            DMA1_Stream0
+
+// Envio por DMA. La UART 3 no tiene stream libre (los usa el SPI 2) ni la UART 8 (lo usa la
+// recepcion de la UART 5)
+#define DMA_TX_UART_1            DMA2_Stream7
+#define DMA_TX_UART_2            DMA1_Stream6
+#define DMA_TX_UART_5            DMA1_Stream7
+
 // Definicion del orden de los puertos.
 #define PUERTO_1_UART            UART_2
 #define PUERTO_2_UART            UART_5
@@ -143,6 +177,21 @@
 #define PIN_MISO_SPI_2           PC2
 #define PIN_MOSI_SPI_2           PC1
 
+// Las IMUs y los barometros internos usan la cola de transacciones por DMA. Los streams se
+// reservan en dma.c y el que encuentre su stream ocupado sigue por interrupcion:
+// - SPI 1: la recepcion va por el DMA2_Stream0, que no usa ningun motor. Para el envio solo
+//   quedan el DMA2_Stream3 (SDMMC) y el DMA2_Stream5, que solo usa el TIM1 en DSHOT burst
+// - SPI 2: no tiene otros streams en el F7. Comparte el DMA1_Stream3 (TIM4_CH2, motor 1) y el
+//   DMA1_Stream4 (TIM3_CH1, motor 4) con el DSHOT por canal
+#define DMA_TX_SPI_1             DMA2_Stream5
+#define DMA_RX_SPI_1             DMA2_Stream0
+#define DMA_TX_SPI_2             DMA1_Stream4
+#define DMA_RX_SPI_2             DMA1_Stream3
+
+#if defined(DMA_TX_SPI_1) || defined(DMA_TX_SPI_2)
+  #define USAR_DMA_SPI
+#endif
+
 #define PIN_SCK_SPI_4            PE2
 #define PIN_MISO_SPI_4           PE5
 #define PIN_MOSI_SPI_4           PE6
@@ -220,6 +269,7 @@
 #define DISP_BUS_IMU_1           SPI_1
 #define CS_SPI_BUS_IMU_1         PD11
 #define DRDY_IMU_1               PD7
+#define FIFO_IMU_1         // Lectura de la FIFO en rafagas disparadas por el DRDY
 #define ROTACION_IMU_1           0         // Rotacion en sentido horario
 //#define AUXILIAR_IMU_1                     // Solo aporta los datos cuando no hay primarios
 
@@ -229,6 +279,7 @@
 #define DISP_BUS_IMU_2           SPI_2
 #define CS_SPI_BUS_IMU_2         PE12
 #define DRDY_IMU_2               PE15
+#define FIFO_IMU_2
 #define ROTACION_IMU_2           0         // Rotacion en sentido horario
 //#define AUXILIAR_IMU_2
 
@@ -238,6 +289,7 @@
 #define DISP_BUS_IMU_3           SPI_2
 #define CS_SPI_BUS_IMU_3         PA4
 #define DRDY_IMU_3               PE4
+#define FIFO_IMU_3
 #define ROTACION_IMU_3           0         // Rotacion en sentido horario
 //#define AUXILIAR_IMU_3
 
@@ -247,6 +299,7 @@
 #define DISP_BUS_IMU_4           SPI_2
 #define CS_SPI_BUS_IMU_4         PA1
 #define DRDY_IMU_4               PE3
+#define FIFO_IMU_4
 #define ROTACION_IMU_4           0         // Rotacion en sentido horario
 //#define AUXILIAR_IMU_4
 
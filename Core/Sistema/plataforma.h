@@ -8,7 +8,7 @@
 **
 **  Autor: Ramon Rico
 **  Fecha de creacion: 23/04/2019
-**  Fecha de modificacion: 03/08/2020
+**  Fecha de modificacion: 17/10/2026
 **
 **  El proyecto URpilot NO es libre. No se puede distribuir y/o modificar este fichero
 **  bajo ningun concepto.
@@ -29,7 +29,11 @@
 /***************************************************************************************
 ** AREA DE INCLUDES                                                                   **
 ****************************************************************************************/
+#ifdef SITL
+#include "Sistema/hardware_sitl.h"
+#else
 #include "hardware.h"
+#endif
 
 
 /***************************************************************************************
@@ -44,12 +48,19 @@
   #endif
 #endif
 
+// Las herramientas del host compilan modulos del firmware sin micro ni simulador
+#ifndef STM32F7
+  #undef USAR_CRC_HW
+#endif
+
 #ifdef STM32F7
   #define USAR_ESTADISTICAS_TAREAS
+#ifndef SITL
   #define USAR_ITCM_RAM
   #define USAR_SRAM2
   #define USAR_DTCM_RAM
 #endif
+#endif
 
 #ifndef DEBUG
   #ifdef USAR_ITCM_RAM
@@ -0,0 +1,280 @@
+/***************************************************************************************
+**  parametros_telemetria.c - Atencion de los mensajes de parametros recibidos por la telemetria
+**
+**
+**  Este fichero forma parte del proyecto URpilot.
+**  Codigo desarrollado por el grupo de investigacion ICON de la Universidad de La Rioja
+**
+**  Autor: Ramon Rico
+**  Fecha de creacion: 17/10/2026
+**  Fecha de modificacion: 17/10/2026
+**
+**  El proyecto URpilot NO es libre. No se puede distribuir y/o modificar este fichero
+**  bajo ningun concepto.
+**
+**  En caso de modificacion y/o solicitud de informacion pongase en contacto con
+**  el grupo de investigacion ICON a traves de: www.unirioja.es/urpilot
+**
+**
+**  Control de versiones del fichero
+**
+**  v1.0  Ramon Rico. Se ha liberado la primera version estable
+**
+****************************************************************************************/
+
+/***************************************************************************************
+** AREA DE INCLUDES                                                                   **
+****************************************************************************************/
+#include <string.h>
+
+#include "parametros_telemetria.h"
+#include "telemetria.h"
+
+#ifdef USAR_IMU
+#include "GP/parametros_gp.h"
+#include "GP/config_flash.h"
+#include "FC/mixer.h"
+
+
+/***************************************************************************************
+** AREA DE PREPROCESADOR                                                              **
+****************************************************************************************/
+
+
+/***************************************************************************************
+** AREA DE DEFINICION DE TIPOS                                                        **
+****************************************************************************************/
+
+
+/***************************************************************************************
+** AREA DE DECLARACION DE VARIABLES                                                   **
+****************************************************************************************/
+
+
+/***************************************************************************************
+** AREA DE PROTOTIPOS DE FUNCION                                                      **
+****************************************************************************************/
+tipoParametroTelemetria_e tipoParametroTelemetria(tipoCampoGP_e tipo);
+void responderGrupoTelemetria(const mensajePedirGrupoTelemetria_t *peticion, mensajeGrupoTelemetria_t *respuesta);
+void responderCampoTelemetria(const mensajePedirCampoTelemetria_t *peticion, mensajeCampoTelemetria_t *respuesta);
+void responderValorTelemetria(uint8_t grupo, uint8_t campo, uint8_t elemento, const uint32_t *valor,
+                              mensajeValorParametroTelemetria_t *respuesta);
+void responderGuardarTelemetria(const mensajeGuardarParametrosTelemetria_t *peticion, mensajeResultadoTelemetria_t *respuesta);
+
+
+/***************************************************************************************
+** AREA DE DEFINICION DE FUNCIONES                                                    **
+****************************************************************************************/
+
+/***************************************************************************************
+**  Nombre:         uint8_t atenderParametrosTelemetria(uint8_t id, const uint8_t *payload, uint8_t longitud,
+**                                                      uint8_t secuencia, uint8_t *trama)
+**  Descripcion:    Atiende una peticion de parametros del host y construye la trama de la
+**                  respuesta. Cada peticion tiene siempre una respuesta
+**  Parametros:     Identificador y payload recibidos, secuencia de la respuesta, buffer de
+**                  TAM_MAX_TRAMA_TELEMETRIA bytes
+**  Retorno:        Longitud de la respuesta o 0 si el mensaje no es de parametros
+****************************************************************************************/
+uint8_t atenderParametrosTelemetria(uint8_t id, const uint8_t *payload, uint8_t longitud, uint8_t secuencia, uint8_t *trama)
+{
+    union {
+        mensajePedirGrupoTelemetria_t grupo;
+        mensajePedirCampoTelemetria_t campo;
+        mensajeLeerParametroTelemetria_t leer;
+        mensajeEscribirParametroTelemetria_t escribir;
+        mensajeGuardarParametrosTelemetria_t guardar;
+    } peticion;
+    union {
+        mensajeGrupoTelemetria_t grupo;
+        mensajeCampoTelemetria_t campo;
+        mensajeValorParametroTelemetria_t valor;
+        mensajeResultadoTelemetria_t resultado;
+    } respuesta;
+    uint8_t idRespuesta;
+
+    if (!decodificarMensajeTelemetria(id, payload, longitud, &peticion))
+        return 0;
+
+    switch (id) {
+        case MENSAJE_TELEMETRIA_PEDIR_GRUPO:
+            responderGrupoTelemetria(&peticion.grupo, &respuesta.grupo);
+            idRespuesta = MENSAJE_TELEMETRIA_GRUPO;
+            break;
+
+        case MENSAJE_TELEMETRIA_PEDIR_CAMPO:
+            responderCampoTelemetria(&peticion.campo, &respuesta.campo);
+            idRespuesta = MENSAJE_TELEMETRIA_CAMPO;
+            break;
+
+        case MENSAJE_TELEMETRIA_LEER_PARAMETRO:
+            responderValorTelemetria(peticion.leer.grupo, peticion.leer.campo, peticion.leer.elemento, NULL, &respuesta.valor);
+            idRespuesta = MENSAJE_TELEMETRIA_VALOR_PARAMETRO;
+            break;
+
+        case MENSAJE_TELEMETRIA_ESCRIBIR_PARAMETRO:
+            responderValorTelemetria(peticion.escribir.grupo, peticion.escribir.campo, peticion.escribir.elemento,
+                                     &peticion.escribir.valor, &respuesta.valor);
+            idRespuesta = MENSAJE_TELEMETRIA_VALOR_PARAMETRO;
+            break;
+
+        case MENSAJE_TELEMETRIA_GUARDAR_PARAMETROS:
+            responderGuardarTelemetria(&peticion.guardar, &respuesta.resultado);
+            idRespuesta = MENSAJE_TELEMETRIA_RESULTADO;
+            break;
+
+        default:
+            return 0;
+    }
+
+    return codificarTramaTelemetria(trama, idRespuesta, secuencia, &respuesta);
+}
+
+
+/***************************************************************************************
+**  Nombre:         tipoParametroTelemetria_e tipoParametroTelemetria(tipoCampoGP_e tipo)
+**  Descripcion:    Convierte el tipo de un campo de GP al del protocolo
+**  Parametros:     Tipo del campo
+**  Retorno:        Tipo del parametro
+****************************************************************************************/
+tipoParametroTelemetria_e tipoParametroTelemetria(tipoCampoGP_e tipo)
+{
+    switch (tipo) {
+        case CAMPO_ENTERO_GP:
+            return PARAMETRO_ENTERO_TELEMETRIA;
+
+        case CAMPO_REAL_GP:
+            return PARAMETRO_REAL_TELEMETRIA;
+
+        case CAMPO_BOOL_GP:
+            return PARAMETRO_BOOL_TELEMETRIA;
+
+        default:
+            return PARAMETRO_NATURAL_TELEMETRIA;
+    }
+}
+
+
+/***************************************************************************************
+**  Nombre:         void responderGrupoTelemetria(const mensajePedirGrupoTelemetria_t *peticion,
+**                                                mensajeGrupoTelemetria_t *respuesta)
+**  Descripcion:    Describe un grupo de parametros
+**  Parametros:     Peticion, respuesta
+**  Retorno:        Ninguno
+****************************************************************************************/
+void responderGrupoTelemetria(const mensajePedirGrupoTelemetria_t *peticion, mensajeGrupoTelemetria_t *respuesta)
+{
+    const descripcionGP_t *descripcion = descripcionGP(peticion->grupo);
+
+    memset(respuesta, 0, sizeof(*respuesta));
+    respuesta->grupo = peticion->grupo;
+    respuesta->numGrupos = numDescripcionesGP();
+
+    if (descripcion == NULL) {
+        respuesta->resultado = PARAMETRO_GRUPO_NO_EXISTE_TELEMETRIA;
+        return;
+    }
+
+    respuesta->resultado = PARAMETRO_OK_TELEMETRIA;
+    respuesta->gpn = numeroGP(descripcion->registro);
+    respuesta->version = versionGP(descripcion->registro);
+    respuesta->tam = tamanioGP(descripcion->registro);
+    respuesta->numCampos = descripcion->numCampos;
+    strncpy(respuesta->nombre, descripcion->nombre, sizeof(respuesta->nombre) - 1);
+}
+
+
+/***************************************************************************************
+**  Nombre:         void responderCampoTelemetria(const mensajePedirCampoTelemetria_t *peticion,
+**                                                mensajeCampoTelemetria_t *respuesta)
+**  Descripcion:    Describe un campo de un grupo de parametros
+**  Parametros:     Peticion, respuesta
+**  Retorno:        Ninguno
+****************************************************************************************/
+void responderCampoTelemetria(const mensajePedirCampoTelemetria_t *peticion, mensajeCampoTelemetria_t *respuesta)
+{
+    const descripcionGP_t *descripcion = descripcionGP(peticion->grupo);
+    const campoGP_t *campo = campoDescripcionGP(descripcion, peticion->campo, 0);
+
+    memset(respuesta, 0, sizeof(*respuesta));
+    respuesta->grupo = peticion->grupo;
+    respuesta->campo = peticion->campo;
+
+    if (campo == NULL) {
+        respuesta->resultado = descripcion == NULL ? PARAMETRO_GRUPO_NO_EXISTE_TELEMETRIA : PARAMETRO_CAMPO_NO_EXISTE_TELEMETRIA;
+        return;
+    }
+
+    respuesta->resultado = PARAMETRO_OK_TELEMETRIA;
+    respuesta->tipo = tipoParametroTelemetria(campo->tipo);
+    respuesta->tam = campo->tam;
+    respuesta->numElementos = campo->numElementos;
+    respuesta->min = campo->min;
+    respuesta->max = campo->max;
+    strncpy(respuesta->nombre, campo->nombre, sizeof(respuesta->nombre) - 1);
+}
+
+
+/***************************************************************************************
+**  Nombre:         void responderValorTelemetria(uint8_t grupo, uint8_t campo, uint8_t elemento,
+**                                                const uint32_t *valor, mensajeValorParametroTelemetria_t *respuesta)
+**  Descripcion:    Escribe un parametro si se pide y devuelve su valor actual y por defecto.
+**                  Con los motores encendidos no se modifica ningun parametro
+**  Parametros:     Grupo, campo, elemento, valor a escribir (NULL si solo se lee), respuesta
+**  Retorno:        Ninguno
+****************************************************************************************/
+void responderValorTelemetria(uint8_t grupo, uint8_t campo, uint8_t elemento, const uint32_t *valor,
+                              mensajeValorParametroTelemetria_t *respuesta)
+{
+    const descripcionGP_t *descripcion = descripcionGP(grupo);
+    const campoGP_t *campoGP = campoDescripcionGP(descripcion, campo, elemento);
+
+    memset(respuesta, 0, sizeof(*respuesta));
+    respuesta->grupo = grupo;
+    respuesta->campo = campo;
+    respuesta->elemento = elemento;
+
+    if (campoGP == NULL) {
+        respuesta->resultado = descripcion == NULL ? PARAMETRO_GRUPO_NO_EXISTE_TELEMETRIA : PARAMETRO_CAMPO_NO_EXISTE_TELEMETRIA;
+        return;
+    }
+
+    respuesta->resultado = PARAMETRO_OK_TELEMETRIA;
+    if (valor != NULL) {
+        if (motoresEncendidosMixer())
+            respuesta->resultado = PARAMETRO_MOTORES_ENCENDIDOS_TELEMETRIA;
+        else if (!escribirCampoGP(descripcion, campoGP, elemento, *valor))
+            respuesta->resultado = PARAMETRO_FUERA_DE_RANGO_TELEMETRIA;
+    }
+
+    respuesta->valor = leerCampoGP(descripcion, campoGP, elemento);
+    if (!leerDefectoCampoGP(descripcion, campoGP, elemento, &respuesta->defecto)) {
+        respuesta->defecto = respuesta->valor;
+        if (respuesta->resultado == PARAMETRO_OK_TELEMETRIA)
+            respuesta->resultado = PARAMETRO_SIN_DEFECTO_TELEMETRIA;
+    }
+}
+
+
+/***************************************************************************************
+**  Nombre:         void responderGuardarTelemetria(const mensajeGuardarParametrosTelemetria_t *peticion,
+**                                                  mensajeResultadoTelemetria_t *respuesta)
+**  Descripcion:    Guarda los GP en la flash. El borrado de un sector para el procesador,
+**                  asi que solo se permite con los motores parados
+**  Parametros:     Peticion, respuesta
+**  Retorno:        Ninguno
+****************************************************************************************/
+void responderGuardarTelemetria(const mensajeGuardarParametrosTelemetria_t *peticion, mensajeResultadoTelemetria_t *respuesta)
+{
+    respuesta->peticion = MENSAJE_TELEMETRIA_GUARDAR_PARAMETROS;
+
+    if (peticion->confirmacion != CONFIRMACION_GUARDAR_TELEMETRIA)
+        respuesta->resultado = PARAMETRO_SIN_CONFIRMAR_TELEMETRIA;
+    else if (motoresEncendidosMixer())
+        respuesta->resultado = PARAMETRO_MOTORES_ENCENDIDOS_TELEMETRIA;
+    else if (!guardarConfigFlash())
+        respuesta->resultado = PARAMETRO_FALLO_FLASH_TELEMETRIA;
+    else
+        respuesta->resultado = PARAMETRO_OK_TELEMETRIA;
+}
+
+#endif
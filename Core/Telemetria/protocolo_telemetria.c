@@ -0,0 +1,503 @@
+/***************************************************************************************
+**  protocolo_telemetria.c - Tramas y catalogo de mensajes de la telemetria. Se comparte con
+**                           las herramientas del host
+**
+**
+**  Este fichero forma parte del proyecto URpilot.
+**  Codigo desarrollado por el grupo de investigacion ICON de la Universidad de La Rioja
+**
+**  Autor: Ramon Rico
+**  Fecha de creacion: 17/10/2026
+**  Fecha de modificacion: 17/10/2026
+**
+**  El proyecto URpilot NO es libre. No se puede distribuir y/o modificar este fichero
+**  bajo ningun concepto.
+**
+**  En caso de modificacion y/o solicitud de informacion pongase en contacto con
+**  el grupo de investigacion ICON a traves de: www.unirioja.es/urpilot
+**
+**
+**  Control de versiones del fichero
+**
+**  v1.0  Ramon Rico. Se ha liberado la primera version estable
+**
+****************************************************************************************/
+
+/***************************************************************************************
+** AREA DE INCLUDES                                                                   **
+****************************************************************************************/
+#include <string.h>
+
+#include "protocolo_telemetria.h"
+#include "Comun/crc.h"
+
+
+/***************************************************************************************
+** AREA DE PREPROCESADOR                                                              **
+****************************************************************************************/
+#define CRC_INICIAL_TELEMETRIA                0xFFFF
+
+#define DEF_MENSAJE_TELEMETRIA(id, nombre, campos, tipo)    \
+    { id, nombre, sizeof(campos) / sizeof(campos[0]), campos, sizeof(tipo) }
+
+
+/***************************************************************************************
+** AREA DE DEFINICION DE TIPOS                                                        **
+****************************************************************************************/
+
+
+/***************************************************************************************
+** AREA DE DECLARACION DE VARIABLES                                                   **
+****************************************************************************************/
+static const campoTelemetria_t camposIMU[] = {
+    CAMPO_TELEMETRIA(mensajeIMUtelemetria_t, tiempo, CAMPO_U32_TELEMETRIA, 1),
+    CAMPO_TELEMETRIA(mensajeIMUtelemetria_t, giro, CAMPO_F32_TELEMETRIA, 3),
+    CAMPO_TELEMETRIA(mensajeIMUtelemetria_t, acel, CAMPO_F32_TELEMETRIA, 3),
+    CAMPO_TELEMETRIA(mensajeIMUtelemetria_t, temperatura, CAMPO_F32_TELEMETRIA, 1),
+};
+
+static const campoTelemetria_t camposAHRS[] = {
+    CAMPO_TELEMETRIA(mensajeAHRStelemetria_t, tiempo, CAMPO_U32_TELEMETRIA, 1),
+    CAMPO_TELEMETRIA(mensajeAHRStelemetria_t, euler, CAMPO_F32_TELEMETRIA, 3),
+    CAMPO_TELEMETRIA(mensajeAHRStelemetria_t, velAngular, CAMPO_F32_TELEMETRIA, 3),
+    CAMPO_TELEMETRIA(mensajeAHRStelemetria_t, posicion, CAMPO_F32_TELEMETRIA, 3),
+    CAMPO_TELEMETRIA(mensajeAHRStelemetria_t, velLineal, CAMPO_F32_TELEMETRIA, 3),
+};
+
+static const campoTelemetria_t camposPID[] = {
+    CAMPO_TELEMETRIA(mensajePIDtelemetria_t, tiempo, CAMPO_U32_TELEMETRIA, 1),
+    CAMPO_TELEMETRIA(mensajePIDtelemetria_t, referencia, CAMPO_F32_TELEMETRIA, 3),
+    CAMPO_TELEMETRIA(mensajePIDtelemetria_t, u, CAMPO_F32_TELEMETRIA, 4),
+};
+
+static const campoTelemetria_t camposMotores[] = {
+    CAMPO_TELEMETRIA(mensajeMotoresTelemetria_t, tiempo, CAMPO_U32_TELEMETRIA, 1),
+    CAMPO_TELEMETRIA(mensajeMotoresTelemetria_t, habilitados, CAMPO_U8_TELEMETRIA, 1),
+    CAMPO_TELEMETRIA(mensajeMotoresTelemetria_t, numMotores, CAMPO_U8_TELEMETRIA, 1),
+    CAMPO_TELEMETRIA(mensajeMotoresTelemetria_t, salida, CAMPO_F32_TELEMETRIA, NUM_MOTORES_TELEMETRIA),
+};
+
+static const campoTelemetria_t camposScheduler[] = {
+    CAMPO_TELEMETRIA(mensajeSchedulerTelemetria_t, tiempo, CAMPO_U32_TELEMETRIA, 1),
+    CAMPO_TELEMETRIA(mensajeSchedulerTelemetria_t, carga, CAMPO_U8_TELEMETRIA, 1),
+    CAMPO_TELEMETRIA(mensajeSchedulerTelemetria_t, deadlinesPerdidos, CAMPO_U32_TELEMETRIA, 1),
+    CAMPO_TELEMETRIA(mensajeSchedulerTelemetria_t, retrasoMaxDeadline, CAMPO_U32_TELEMETRIA, 1),
+    CAMPO_TELEMETRIA(mensajeSchedulerTelemetria_t, tiempoMaxEjecucion, CAMPO_U32_TELEMETRIA, 1),
+};
+
+static const campoTelemetria_t camposGPS[] = {
+    CAMPO_TELEMETRIA(mensajeGPStelemetria_t, tiempo, CAMPO_U32_TELEMETRIA, 1),
+    CAMPO_TELEMETRIA(mensajeGPStelemetria_t, operativo, CAMPO_U8_TELEMETRIA, 1),
+    CAMPO_TELEMETRIA(mensajeGPStelemetria_t, numSats, CAMPO_U8_TELEMETRIA, 1),
+    CAMPO_TELEMETRIA(mensajeGPStelemetria_t, latitud, CAMPO_I32_TELEMETRIA, 1),
+    CAMPO_TELEMETRIA(mensajeGPStelemetria_t, longitud, CAMPO_I32_TELEMETRIA, 1),
+    CAMPO_TELEMETRIA(mensajeGPStelemetria_t, altitud, CAMPO_I32_TELEMETRIA, 1),
+    CAMPO_TELEMETRIA(mensajeGPStelemetria_t, vel2d, CAMPO_F32_TELEMETRIA, 1),
+};
+
+static const campoTelemetria_t camposEstado[] = {
+    CAMPO_TELEMETRIA(mensajeEstadoTelemetria_t, tiempo, CAMPO_U32_TELEMETRIA, 1),
+    CAMPO_TELEMETRIA(mensajeEstadoTelemetria_t, tramasRecibidas, CAMPO_U32_TELEMETRIA, 1),
+    CAMPO_TELEMETRIA(mensajeEstadoTelemetria_t, erroresCRC, CAMPO_U32_TELEMETRIA, 1),
+    CAMPO_TELEMETRIA(mensajeEstadoTelemetria_t, bytesDescartados, CAMPO_U32_TELEMETRIA, 1),
+    CAMPO_TELEMETRIA(mensajeEstadoTelemetria_t, mensajesEnviados, CAMPO_U32_TELEMETRIA, 1),
+    CAMPO_TELEMETRIA(mensajeEstadoTelemetria_t, mensajesRetrasados, CAMPO_U32_TELEMETRIA, 1),
+    CAMPO_TELEMETRIA(mensajeEstadoTelemetria_t, periodosPerdidos, CAMPO_U32_TELEMETRIA, 1),
+};
+
+static const campoTelemetria_t camposSuscripcion[] = {
+    CAMPO_TELEMETRIA(mensajeSuscripcionTelemetria_t, id, CAMPO_U8_TELEMETRIA, 1),
+    CAMPO_TELEMETRIA(mensajeSuscripcionTelemetria_t, frecuencia, CAMPO_U16_TELEMETRIA, 1),
+};
+
+static const campoTelemetria_t camposPedirGrupo[] = {
+    CAMPO_TELEMETRIA(mensajePedirGrupoTelemetria_t, grupo, CAMPO_U8_TELEMETRIA, 1),
+};
+
+static const campoTelemetria_t camposGrupo[] = {
+    CAMPO_TELEMETRIA(mensajeGrupoTelemetria_t, grupo, CAMPO_U8_TELEMETRIA, 1),
+    CAMPO_TELEMETRIA(mensajeGrupoTelemetria_t, resultado, CAMPO_U8_TELEMETRIA, 1),
+    CAMPO_TELEMETRIA(mensajeGrupoTelemetria_t, numGrupos, CAMPO_U8_TELEMETRIA, 1),
+    CAMPO_TELEMETRIA(mensajeGrupoTelemetria_t, gpn, CAMPO_U16_TELEMETRIA, 1),
+    CAMPO_TELEMETRIA(mensajeGrupoTelemetria_t, version, CAMPO_U8_TELEMETRIA, 1),
+    CAMPO_TELEMETRIA(mensajeGrupoTelemetria_t, tam, CAMPO_U16_TELEMETRIA, 1),
+    CAMPO_TELEMETRIA(mensajeGrupoTelemetria_t, numCampos, CAMPO_U8_TELEMETRIA, 1),
+    CAMPO_TELEMETRIA(mensajeGrupoTelemetria_t, nombre, CAMPO_U8_TELEMETRIA, TAM_NOMBRE_GRUPO_TELEMETRIA),
+};
+
+static const campoTelemetria_t camposPedirCampo[] = {
+    CAMPO_TELEMETRIA(mensajePedirCampoTelemetria_t, grupo, CAMPO_U8_TELEMETRIA, 1),
+    CAMPO_TELEMETRIA(mensajePedirCampoTelemetria_t, campo, CAMPO_U8_TELEMETRIA, 1),
+};
+
+static const campoTelemetria_t camposCampo[] = {
+    CAMPO_TELEMETRIA(mensajeCampoTelemetria_t, grupo, CAMPO_U8_TELEMETRIA, 1),
+    CAMPO_TELEMETRIA(mensajeCampoTelemetria_t, campo, CAMPO_U8_TELEMETRIA, 1),
+    CAMPO_TELEMETRIA(mensajeCampoTelemetria_t, resultado, CAMPO_U8_TELEMETRIA, 1),
+    CAMPO_TELEMETRIA(mensajeCampoTelemetria_t, tipo, CAMPO_U8_TELEMETRIA, 1),
+    CAMPO_TELEMETRIA(mensajeCampoTelemetria_t, tam, CAMPO_U8_TELEMETRIA, 1),
+    CAMPO_TELEMETRIA(mensajeCampoTelemetria_t, numElementos, CAMPO_U8_TELEMETRIA, 1),
+    CAMPO_TELEMETRIA(mensajeCampoTelemetria_t, min, CAMPO_F32_TELEMETRIA, 1),
+    CAMPO_TELEMETRIA(mensajeCampoTelemetria_t, max, CAMPO_F32_TELEMETRIA, 1),
+    CAMPO_TELEMETRIA(mensajeCampoTelemetria_t, nombre, CAMPO_U8_TELEMETRIA, TAM_NOMBRE_CAMPO_TELEMETRIA),
+};
+
+static const campoTelemetria_t camposLeerParametro[] = {
+    CAMPO_TELEMETRIA(mensajeLeerParametroTelemetria_t, grupo, CAMPO_U8_TELEMETRIA, 1),
+    CAMPO_TELEMETRIA(mensajeLeerParametroTelemetria_t, campo, CAMPO_U8_TELEMETRIA, 1),
+    CAMPO_TELEMETRIA(mensajeLeerParametroTelemetria_t, elemento, CAMPO_U8_TELEMETRIA, 1),
+};
+
+static const campoTelemetria_t camposEscribirParametro[] = {
+    CAMPO_TELEMETRIA(mensajeEscribirParametroTelemetria_t, grupo, CAMPO_U8_TELEMETRIA, 1),
+    CAMPO_TELEMETRIA(mensajeEscribirParametroTelemetria_t, campo, CAMPO_U8_TELEMETRIA, 1),
+    CAMPO_TELEMETRIA(mensajeEscribirParametroTelemetria_t, elemento, CAMPO_U8_TELEMETRIA, 1),
+    CAMPO_TELEMETRIA(mensajeEscribirParametroTelemetria_t, valor, CAMPO_U32_TELEMETRIA, 1),
+};
+
+static const campoTelemetria_t camposValorParametro[] = {
+    CAMPO_TELEMETRIA(mensajeValorParametroTelemetria_t, grupo, CAMPO_U8_TELEMETRIA, 1),
+    CAMPO_TELEMETRIA(mensajeValorParametroTelemetria_t, campo, CAMPO_U8_TELEMETRIA, 1),
+    CAMPO_TELEMETRIA(mensajeValorParametroTelemetria_t, elemento, CAMPO_U8_TELEMETRIA, 1),
+    CAMPO_TELEMETRIA(mensajeValorParametroTelemetria_t, resultado, CAMPO_U8_TELEMETRIA, 1),
+    CAMPO_TELEMETRIA(mensajeValorParametroTelemetria_t, valor, CAMPO_U32_TELEMETRIA, 1),
+    CAMPO_TELEMETRIA(mensajeValorParametroTelemetria_t, defecto, CAMPO_U32_TELEMETRIA, 1),
+};
+
+static const campoTelemetria_t camposGuardarParametros[] = {
+    CAMPO_TELEMETRIA(mensajeGuardarParametrosTelemetria_t, confirmacion, CAMPO_U8_TELEMETRIA, 1),
+};
+
+static const campoTelemetria_t camposResultado[] = {
+    CAMPO_TELEMETRIA(mensajeResultadoTelemetria_t, peticion, CAMPO_U8_TELEMETRIA, 1),
+    CAMPO_TELEMETRIA(mensajeResultadoTelemetria_t, resultado, CAMPO_U8_TELEMETRIA, 1),
+};
+
+static const defMensajeTelemetria_t defMensajesTelemetria[] = {
+    DEF_MENSAJE_TELEMETRIA(MENSAJE_TELEMETRIA_IMU, "imu", camposIMU, mensajeIMUtelemetria_t),
+    DEF_MENSAJE_TELEMETRIA(MENSAJE_TELEMETRIA_AHRS, "ahrs", camposAHRS, mensajeAHRStelemetria_t),
+    DEF_MENSAJE_TELEMETRIA(MENSAJE_TELEMETRIA_PID, "pid", camposPID, mensajePIDtelemetria_t),
+    DEF_MENSAJE_TELEMETRIA(MENSAJE_TELEMETRIA_MOTORES, "motores", camposMotores, mensajeMotoresTelemetria_t),
+    DEF_MENSAJE_TELEMETRIA(MENSAJE_TELEMETRIA_SCHEDULER, "scheduler", camposScheduler, mensajeSchedulerTelemetria_t),
+    DEF_MENSAJE_TELEMETRIA(MENSAJE_TELEMETRIA_GPS, "gps", camposGPS, mensajeGPStelemetria_t),
+    DEF_MENSAJE_TELEMETRIA(MENSAJE_TELEMETRIA_ESTADO, "estado", camposEstado, mensajeEstadoTelemetria_t),
+    DEF_MENSAJE_TELEMETRIA(MENSAJE_TELEMETRIA_SUSCRIPCION, "suscripcion", camposSuscripcion, mensajeSuscripcionTelemetria_t),
+    DEF_MENSAJE_TELEMETRIA(MENSAJE_TELEMETRIA_PEDIR_GRUPO, "pedirGrupo", camposPedirGrupo, mensajePedirGrupoTelemetria_t),
+    DEF_MENSAJE_TELEMETRIA(MENSAJE_TELEMETRIA_GRUPO, "grupo", camposGrupo, mensajeGrupoTelemetria_t),
+    DEF_MENSAJE_TELEMETRIA(MENSAJE_TELEMETRIA_PEDIR_CAMPO, "pedirCampo", camposPedirCampo, mensajePedirCampoTelemetria_t),
+    DEF_MENSAJE_TELEMETRIA(MENSAJE_TELEMETRIA_CAMPO, "campo", camposCampo, mensajeCampoTelemetria_t),
+    DEF_MENSAJE_TELEMETRIA(MENSAJE_TELEMETRIA_LEER_PARAMETRO, "leerParametro", camposLeerParametro, mensajeLeerParametroTelemetria_t),
+    DEF_MENSAJE_TELEMETRIA(MENSAJE_TELEMETRIA_ESCRIBIR_PARAMETRO, "escribirParametro", camposEscribirParametro,
+                           mensajeEscribirParametroTelemetria_t),
+    DEF_MENSAJE_TELEMETRIA(MENSAJE_TELEMETRIA_VALOR_PARAMETRO, "valorParametro", camposValorParametro, mensajeValorParametroTelemetria_t),
+    DEF_MENSAJE_TELEMETRIA(MENSAJE_TELEMETRIA_GUARDAR_PARAMETROS, "guardarParametros", camposGuardarParametros,
+                           mensajeGuardarParametrosTelemetria_t),
+    DEF_MENSAJE_TELEMETRIA(MENSAJE_TELEMETRIA_RESULTADO, "resultado", camposResultado, mensajeResultadoTelemetria_t),
+};
+
+
+/***************************************************************************************
+** AREA DE PROTOTIPOS DE FUNCION                                                      **
+****************************************************************************************/
+uint8_t tamTipoCampoTelemetria(tipoCampoTelemetria_e tipo);
+void reiniciarDecodificadorTelemetria(decodificadorTelemetria_t *decodificador, uint8_t dato, uint8_t numBytes);
+
+
+/***************************************************************************************
+** AREA DE DEFINICION DE FUNCIONES                                                    **
+****************************************************************************************/
+
+/***************************************************************************************
+**  Nombre:         const defMensajeTelemetria_t *defMensajeTelemetria(uint8_t id)
+**  Descripcion:    Busca la definicion de un mensaje en el catalogo
+**  Parametros:     Identificador del mensaje
+**  Retorno:        Definicion o NULL si el mensaje no existe
+****************************************************************************************/
+const defMensajeTelemetria_t *defMensajeTelemetria(uint8_t id)
+{
+    for (uint8_t i = 0; i < sizeof(defMensajesTelemetria) / sizeof(defMensajesTelemetria[0]); i++) {
+        if (defMensajesTelemetria[i].id == id)
+            return &defMensajesTelemetria[i];
+    }
+
+    return NULL;
+}
+
+
+/***************************************************************************************
+**  Nombre:         uint8_t tamTipoCampoTelemetria(tipoCampoTelemetria_e tipo)
+**  Descripcion:    Devuelve el numero de bytes que ocupa un elemento en la trama
+**  Parametros:     Tipo del campo
+**  Retorno:        Numero de bytes
+****************************************************************************************/
+uint8_t tamTipoCampoTelemetria(tipoCampoTelemetria_e tipo)
+{
+    switch (tipo) {
+        case CAMPO_U8_TELEMETRIA:
+            return 1;
+
+        case CAMPO_U16_TELEMETRIA:
+            return 2;
+
+        default:
+            return 4;
+    }
+}
+
+
+/***************************************************************************************
+**  Nombre:         uint8_t tamPayloadTelemetria(const defMensajeTelemetria_t *def)
+**  Descripcion:    Devuelve el tamanio del payload de un mensaje
+**  Parametros:     Definicion del mensaje
+**  Retorno:        Numero de bytes
+****************************************************************************************/
+uint8_t tamPayloadTelemetria(const defMensajeTelemetria_t *def)
+{
+    uint8_t tam = 0;
+
+    for (uint8_t i = 0; i < def->numCampos; i++)
+        tam += tamTipoCampoTelemetria(def->campos[i].tipo) * def->campos[i].numElementos;
+
+    return tam;
+}
+
+
+/***************************************************************************************
+**  Nombre:         uint8_t codificarTramaTelemetria(uint8_t *trama, uint8_t id, uint8_t secuencia,
+**                                                   const void *mensaje)
+**  Descripcion:    Construye la trama de un mensaje del catalogo
+**  Parametros:     Buffer de TAM_MAX_TRAMA_TELEMETRIA bytes, identificador, numero de secuencia,
+**                  estructura del mensaje
+**  Retorno:        Longitud de la trama o 0 si el mensaje no existe
+****************************************************************************************/
+uint8_t codificarTramaTelemetria(uint8_t *trama, uint8_t id, uint8_t secuencia, const void *mensaje)
+{
+    const defMensajeTelemetria_t *def = defMensajeTelemetria(id);
+    const uint8_t *origen = (const uint8_t *)mensaje;
+
+    if (def == NULL)
+        return 0;
+
+    trama[0] = SYNC1_TELEMETRIA;
+    trama[1] = SYNC2_TELEMETRIA;
+    trama[2] = id;
+    trama[3] = tamPayloadTelemetria(def);
+    trama[4] = secuencia;
+
+    uint8_t *p = &trama[TAM_CABECERA_TELEMETRIA];
+    for (uint8_t i = 0; i < def->numCampos; i++) {
+        const campoTelemetria_t *campo = &def->campos[i];
+        const uint8_t tam = tamTipoCampoTelemetria(campo->tipo);
+
+        for (uint8_t j = 0; j < campo->numElementos; j++) {
+            const uint8_t *elemento = origen + campo->offset + j * tam;
+            uint32_t valor;
+
+            switch (tam) {
+                case 1:
+                    valor = *elemento;
+                    break;
+
+                case 2: {
+                    uint16_t valor16;
+                    memcpy(&valor16, elemento, sizeof(valor16));
+                    valor = valor16;
+                    break;
+                }
+
+                default:
+                    memcpy(&valor, elemento, sizeof(valor));
+                    break;
+            }
+
+            for (uint8_t k = 0; k < tam; k++)
+                *p++ = (uint8_t)(valor >> (8 * k));
+        }
+    }
+
+    const uint16_t crc = actualizarCRC16(CRC_INICIAL_TELEMETRIA, &trama[2], p - &trama[2]);
+    *p++ = (uint8_t)crc;
+    *p++ = (uint8_t)(crc >> 8);
+
+    return p - trama;
+}
+
+
+/***************************************************************************************
+**  Nombre:         bool decodificarMensajeTelemetria(uint8_t id, const uint8_t *payload, uint8_t longitud,
+**                                                    void *mensaje)
+**  Descripcion:    Rellena la estructura de un mensaje a partir de su payload
+**  Parametros:     Identificador, payload, longitud del payload, estructura del mensaje
+**  Retorno:        False si el mensaje no existe o la longitud no coincide
+****************************************************************************************/
+bool decodificarMensajeTelemetria(uint8_t id, const uint8_t *payload, uint8_t longitud, void *mensaje)
+{
+    const defMensajeTelemetria_t *def = defMensajeTelemetria(id);
+    uint8_t *destino = (uint8_t *)mensaje;
+
+    if (def == NULL || longitud != tamPayloadTelemetria(def))
+        return false;
+
+    memset(mensaje, 0, def->tamEstructura);
+
+    const uint8_t *p = payload;
+    for (uint8_t i = 0; i < def->numCampos; i++) {
+        const campoTelemetria_t *campo = &def->campos[i];
+        const uint8_t tam = tamTipoCampoTelemetria(campo->tipo);
+
+        for (uint8_t j = 0; j < campo->numElementos; j++) {
+            uint8_t *elemento = destino + campo->offset + j * tam;
+            uint32_t valor = 0;
+
+            for (uint8_t k = 0; k < tam; k++)
+                valor |= (uint32_t)*p++ << (8 * k);
+
+            switch (tam) {
+                case 1:
+                    *elemento = (uint8_t)valor;
+                    break;
+
+                case 2: {
+                    const uint16_t valor16 = (uint16_t)valor;
+                    memcpy(elemento, &valor16, sizeof(valor16));
+                    break;
+                }
+
+                default:
+                    memcpy(elemento, &valor, sizeof(valor));
+                    break;
+            }
+        }
+    }
+
+    return true;
+}
+
+
+/***************************************************************************************
+**  Nombre:         void iniciarDecodificadorTelemetria(decodificadorTelemetria_t *decodificador)
+**  Descripcion:    Inicia el decodificador de tramas y sus estadisticas
+**  Parametros:     Decodificador
+**  Retorno:        Ninguno
+****************************************************************************************/
+void iniciarDecodificadorTelemetria(decodificadorTelemetria_t *decodificador)
+{
+    memset(decodificador, 0, sizeof(*decodificador));
+    decodificador->estado = ESPERANDO_SYNC1_TELEMETRIA;
+}
+
+
+/***************************************************************************************
+**  Nombre:         void reiniciarDecodificadorTelemetria(decodificadorTelemetria_t *decodificador,
+**                                                        uint8_t dato, uint8_t numBytes)
+**  Descripcion:    Descarta la trama en curso. Si el ultimo byte es un sync1 puede ser el
+**                  comienzo de la siguiente trama y no se descarta
+**  Parametros:     Decodificador, ultimo byte recibido, bytes consumidos por la trama
+**  Retorno:        Ninguno
+****************************************************************************************/
+void reiniciarDecodificadorTelemetria(decodificadorTelemetria_t *decodificador, uint8_t dato, uint8_t numBytes)
+{
+    if (dato == SYNC1_TELEMETRIA) {
+        decodificador->bytesDescartados += numBytes - 1;
+        decodificador->estado = ESPERANDO_SYNC2_TELEMETRIA;
+    }
+    else {
+        decodificador->bytesDescartados += numBytes;
+        decodificador->estado = ESPERANDO_SYNC1_TELEMETRIA;
+    }
+}
+
+
+/***************************************************************************************
+**  Nombre:         bool procesarByteTelemetria(decodificadorTelemetria_t *decodificador, uint8_t dato)
+**  Descripcion:    Avanza la maquina de estados con un byte recibido. Solo se aceptan tramas
+**                  del catalogo con la longitud esperada y el CRC correcto
+**  Parametros:     Decodificador, byte recibido
+**  Retorno:        True si se ha completado una trama valida. El id, la secuencia y el payload
+**                  quedan en el decodificador hasta el siguiente byte
+****************************************************************************************/
+bool procesarByteTelemetria(decodificadorTelemetria_t *decodificador, uint8_t dato)
+{
+    const defMensajeTelemetria_t *def;
+
+    switch (decodificador->estado) {
+        case ESPERANDO_SYNC1_TELEMETRIA:
+            if (dato == SYNC1_TELEMETRIA)
+                decodificador->estado = ESPERANDO_SYNC2_TELEMETRIA;
+            else
+                decodificador->bytesDescartados++;
+            break;
+
+        case ESPERANDO_SYNC2_TELEMETRIA:
+            if (dato == SYNC2_TELEMETRIA)
+                decodificador->estado = ESPERANDO_ID_TELEMETRIA;
+            else
+                reiniciarDecodificadorTelemetria(decodificador, dato, 2);
+            break;
+
+        case ESPERANDO_ID_TELEMETRIA:
+            if (defMensajeTelemetria(dato) == NULL) {
+                reiniciarDecodificadorTelemetria(decodificador, dato, 3);
+                break;
+            }
+
+            decodificador->id = dato;
+            decodificador->crc = actualizarCRC16(CRC_INICIAL_TELEMETRIA, &dato, 1);
+            decodificador->estado = ESPERANDO_LONGITUD_TELEMETRIA;
+            break;
+
+        case ESPERANDO_LONGITUD_TELEMETRIA:
+            def = defMensajeTelemetria(decodificador->id);
+            if (dato != tamPayloadTelemetria(def)) {
+                reiniciarDecodificadorTelemetria(decodificador, dato, 4);
+                break;
+            }
+
+            decodificador->longitud = dato;
+            decodificador->crc = actualizarCRC16(decodificador->crc, &dato, 1);
+            decodificador->estado = ESPERANDO_SECUENCIA_TELEMETRIA;
+            break;
+
+        case ESPERANDO_SECUENCIA_TELEMETRIA:
+            decodificador->secuencia = dato;
+            decodificador->crc = actualizarCRC16(decodificador->crc, &dato, 1);
+            decodificador->indice = 0;
+            decodificador->estado = ESPERANDO_PAYLOAD_TELEMETRIA;
+            break;
+
+        case ESPERANDO_PAYLOAD_TELEMETRIA:
+            decodificador->payload[decodificador->indice++] = dato;
+            if (decodificador->indice == decodificador->longitud) {
+                decodificador->crc = actualizarCRC16(decodificador->crc, decodificador->payload, decodificador->longitud);
+                decodificador->estado = ESPERANDO_CRC1_TELEMETRIA;
+            }
+            break;
+
+        case ESPERANDO_CRC1_TELEMETRIA:
+            if (dato != (uint8_t)decodificador->crc) {
+                decodificador->erroresCRC++;
+                reiniciarDecodificadorTelemetria(decodificador, dato, TAM_CABECERA_TELEMETRIA + decodificador->longitud + 1);
+                break;
+            }
+
+            decodificador->estado = ESPERANDO_CRC2_TELEMETRIA;
+            break;
+
+        case ESPERANDO_CRC2_TELEMETRIA:
+            if (dato != (uint8_t)(decodificador->crc >> 8)) {
+                decodificador->erroresCRC++;
+                reiniciarDecodificadorTelemetria(decodificador, dato, TAM_CABECERA_TELEMETRIA + decodificador->longitud + TAM_CRC_TELEMETRIA);
+                break;
+            }
+
+            decodificador->tramasRecibidas++;
+            decodificador->estado = ESPERANDO_SYNC1_TELEMETRIA;
+            return true;
+
+        default:
+            decodificador->estado = ESPERANDO_SYNC1_TELEMETRIA;
+            break;
+    }
+
+    return false;
+}
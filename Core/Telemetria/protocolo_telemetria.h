@@ -0,0 +1,298 @@
+/***************************************************************************************
+**  protocolo_telemetria.h - Tramas y catalogo de mensajes de la telemetria. Se comparte con
+**                           las herramientas del host
+**
+**
+**  Este fichero forma parte del proyecto URpilot.
+**  Codigo desarrollado por el grupo de investigacion ICON de la Universidad de La Rioja
+**
+**  Autor: Ramon Rico
+**  Fecha de creacion: 17/10/2026
+**  Fecha de modificacion: 17/10/2026
+**
+**  El proyecto URpilot NO es libre. No se puede distribuir y/o modificar este fichero
+**  bajo ningun concepto.
+**
+**  En caso de modificacion y/o solicitud de informacion pongase en contacto con
+**  el grupo de investigacion ICON a traves de: www.unirioja.es/urpilot
+**
+**
+**  Control de versiones del fichero
+**
+**  v1.0  Ramon Rico. Se ha liberado la primera version estable
+**
+****************************************************************************************/
+
+#ifndef __PROTOCOLO_TELEMETRIA_H
+#define __PROTOCOLO_TELEMETRIA_H
+
+/***************************************************************************************
+** AREA DE INCLUDES                                                                   **
+****************************************************************************************/
+#include <stdint.h>
+#include <stdbool.h>
+#include <stddef.h>
+
+
+/***************************************************************************************
+** AREA DE PREPROCESADOR                                                              **
+****************************************************************************************/
+#define VERSION_PROTOCOLO_TELEMETRIA          1
+
+// Trama: sync1 sync2 id longitud secuencia payload crcL crcH. El CRC16 cubre desde el id hasta el payload
+#define SYNC1_TELEMETRIA                      0xA5
+#define SYNC2_TELEMETRIA                      0x5A
+#define TAM_CABECERA_TELEMETRIA               5
+#define TAM_CRC_TELEMETRIA                    2
+#define TAM_MAX_PAYLOAD_TELEMETRIA            64
+#define TAM_MAX_TRAMA_TELEMETRIA              (TAM_CABECERA_TELEMETRIA + TAM_MAX_PAYLOAD_TELEMETRIA + TAM_CRC_TELEMETRIA)
+
+#define NUM_MOTORES_TELEMETRIA                12
+
+// Mensajes del host al FC
+#define MENSAJE_TELEMETRIA_SUSCRIPCION        0x80
+#define MENSAJE_TELEMETRIA_PEDIR_GRUPO        0x81
+#define MENSAJE_TELEMETRIA_PEDIR_CAMPO        0x82
+#define MENSAJE_TELEMETRIA_LEER_PARAMETRO     0x83
+#define MENSAJE_TELEMETRIA_ESCRIBIR_PARAMETRO 0x84
+#define MENSAJE_TELEMETRIA_GUARDAR_PARAMETROS 0x85
+
+// Respuestas del FC a los mensajes de parametros. No admiten suscripcion
+#define MENSAJE_TELEMETRIA_GRUPO              0x40
+#define MENSAJE_TELEMETRIA_CAMPO              0x41
+#define MENSAJE_TELEMETRIA_VALOR_PARAMETRO    0x42
+#define MENSAJE_TELEMETRIA_RESULTADO          0x43
+
+#define TAM_NOMBRE_GRUPO_TELEMETRIA           16          // Incluye el terminador
+#define TAM_NOMBRE_CAMPO_TELEMETRIA           32          // Incluye el terminador
+#define CONFIRMACION_GUARDAR_TELEMETRIA       0x5A
+
+#define CAMPO_TELEMETRIA(tipoMensaje, campo, tipo, numElementos)    \
+    { #campo, tipo, numElementos, offsetof(tipoMensaje, campo) }
+
+
+/***************************************************************************************
+** AREA DE DEFINICION DE TIPOS                                                        **
+****************************************************************************************/
+// Mensajes del FC al host. Los identificadores son consecutivos y sirven de indice
+typedef enum {
+    MENSAJE_TELEMETRIA_IMU = 0,
+    MENSAJE_TELEMETRIA_AHRS,
+    MENSAJE_TELEMETRIA_PID,
+    MENSAJE_TELEMETRIA_MOTORES,
+    MENSAJE_TELEMETRIA_SCHEDULER,
+    MENSAJE_TELEMETRIA_GPS,
+    MENSAJE_TELEMETRIA_ESTADO,
+    NUM_MENSAJES_TELEMETRIA,
+} idMensajeTelemetria_e;
+
+typedef enum {
+    CAMPO_U8_TELEMETRIA = 0,
+    CAMPO_U16_TELEMETRIA,
+    CAMPO_U32_TELEMETRIA,
+    CAMPO_I32_TELEMETRIA,
+    CAMPO_F32_TELEMETRIA,
+} tipoCampoTelemetria_e;
+
+// Tipos de los parametros. Los valores viajan como los bits del campo en los bytes bajos de un uint32_t
+typedef enum {
+    PARAMETRO_NATURAL_TELEMETRIA = 0,
+    PARAMETRO_ENTERO_TELEMETRIA,
+    PARAMETRO_REAL_TELEMETRIA,
+    PARAMETRO_BOOL_TELEMETRIA,
+} tipoParametroTelemetria_e;
+
+typedef enum {
+    PARAMETRO_OK_TELEMETRIA = 0,
+    PARAMETRO_GRUPO_NO_EXISTE_TELEMETRIA,
+    PARAMETRO_CAMPO_NO_EXISTE_TELEMETRIA,
+    PARAMETRO_FUERA_DE_RANGO_TELEMETRIA,
+    PARAMETRO_MOTORES_ENCENDIDOS_TELEMETRIA,
+    PARAMETRO_SIN_DEFECTO_TELEMETRIA,
+    PARAMETRO_FALLO_FLASH_TELEMETRIA,
+    PARAMETRO_SIN_CONFIRMAR_TELEMETRIA,
+} resultadoParametroTelemetria_e;
+
+typedef struct {
+    const char *nombre;
+    tipoCampoTelemetria_e tipo;
+    uint8_t numElementos;
+    uint16_t offset;                         // Posicion del campo en la estructura del mensaje
+} campoTelemetria_t;
+
+typedef struct {
+    uint8_t id;
+    const char *nombre;
+    uint8_t numCampos;
+    const campoTelemetria_t *campos;
+    uint16_t tamEstructura;
+} defMensajeTelemetria_t;
+
+// Estructuras de los mensajes. En la trama los campos van seguidos y en little endian
+typedef struct {
+    uint32_t tiempo;                         // us
+    float giro[3];                           // grados/s
+    float acel[3];                           // g
+    float temperatura;                       // grados C
+} mensajeIMUtelemetria_t;
+
+typedef struct {
+    uint32_t tiempo;
+    float euler[3];                          // grados
+    float velAngular[3];
+    float posicion[3];                       // m
+    float velLineal[3];                      // m/s
+} mensajeAHRStelemetria_t;
+
+typedef struct {
+    uint32_t tiempo;
+    float referencia[3];                     // Referencias de roll, pitch y yaw
+    float u[4];                              // Acciones de roll, pitch, yaw y altura
+} mensajePIDtelemetria_t;
+
+typedef struct {
+    uint32_t tiempo;
+    uint8_t habilitados;
+    uint8_t numMotores;
+    float salida[NUM_MOTORES_TELEMETRIA];
+} mensajeMotoresTelemetria_t;
+
+typedef struct {
+    uint32_t tiempo;
+    uint8_t carga;                           // %
+    uint32_t deadlinesPerdidos;              // Suma de todas las tareas
+    uint32_t retrasoMaxDeadline;             // us. Maximo de todas las tareas
+    uint32_t tiempoMaxEjecucion;             // us. Maximo de todas las tareas
+} mensajeSchedulerTelemetria_t;
+
+typedef struct {
+    uint32_t tiempo;
+    uint8_t operativo;
+    uint8_t numSats;
+    int32_t latitud;                         // grados * 10.000.000
+    int32_t longitud;                        // grados * 10.000.000
+    int32_t altitud;                         // cm
+    float vel2d;                             // cm/s
+} mensajeGPStelemetria_t;
+
+typedef struct {
+    uint32_t tiempo;
+    uint32_t tramasRecibidas;
+    uint32_t erroresCRC;
+    uint32_t bytesDescartados;
+    uint32_t mensajesEnviados;
+    uint32_t mensajesRetrasados;             // No cabian en el presupuesto del tick
+    uint32_t periodosPerdidos;               // Envios saltados por ir mas de un periodo tarde
+} mensajeEstadoTelemetria_t;
+
+typedef struct {
+    uint8_t id;
+    uint16_t frecuencia;                     // Hz. Con 0 se cancela la suscripcion
+} mensajeSuscripcionTelemetria_t;
+
+// Parametros. Los grupos y campos se identifican por su posicion en las descripciones del FC
+typedef struct {
+    uint8_t grupo;
+} mensajePedirGrupoTelemetria_t;
+
+typedef struct {
+    uint8_t grupo;
+    uint8_t resultado;
+    uint8_t numGrupos;
+    uint16_t gpn;
+    uint8_t version;
+    uint16_t tam;                            // Bytes del GP en RAM
+    uint8_t numCampos;
+    char nombre[TAM_NOMBRE_GRUPO_TELEMETRIA];
+} mensajeGrupoTelemetria_t;
+
+typedef struct {
+    uint8_t grupo;
+    uint8_t campo;
+} mensajePedirCampoTelemetria_t;
+
+typedef struct {
+    uint8_t grupo;
+    uint8_t campo;
+    uint8_t resultado;
+    uint8_t tipo;                            // tipoParametroTelemetria_e
+    uint8_t tam;                             // Bytes de cada elemento
+    uint8_t numElementos;
+    float min;
+    float max;
+    char nombre[TAM_NOMBRE_CAMPO_TELEMETRIA];
+} mensajeCampoTelemetria_t;
+
+typedef struct {
+    uint8_t grupo;
+    uint8_t campo;
+    uint8_t elemento;
+} mensajeLeerParametroTelemetria_t;
+
+typedef struct {
+    uint8_t grupo;
+    uint8_t campo;
+    uint8_t elemento;
+    uint32_t valor;
+} mensajeEscribirParametroTelemetria_t;
+
+typedef struct {
+    uint8_t grupo;
+    uint8_t campo;
+    uint8_t elemento;
+    uint8_t resultado;
+    uint32_t valor;                          // Valor despues de la lectura o la escritura
+    uint32_t defecto;
+} mensajeValorParametroTelemetria_t;
+
+typedef struct {
+    uint8_t confirmacion;                    // CONFIRMACION_GUARDAR_TELEMETRIA
+} mensajeGuardarParametrosTelemetria_t;
+
+typedef struct {
+    uint8_t peticion;                        // Identificador del mensaje al que se responde
+    uint8_t resultado;
+} mensajeResultadoTelemetria_t;
+
+typedef enum {
+    ESPERANDO_SYNC1_TELEMETRIA = 0,
+    ESPERANDO_SYNC2_TELEMETRIA,
+    ESPERANDO_ID_TELEMETRIA,
+    ESPERANDO_LONGITUD_TELEMETRIA,
+    ESPERANDO_SECUENCIA_TELEMETRIA,
+    ESPERANDO_PAYLOAD_TELEMETRIA,
+    ESPERANDO_CRC1_TELEMETRIA,
+    ESPERANDO_CRC2_TELEMETRIA,
+} estadoDecodificadorTelemetria_e;
+
+typedef struct {
+    estadoDecodificadorTelemetria_e estado;
+    uint8_t id;
+    uint8_t longitud;
+    uint8_t secuencia;
+    uint8_t indice;
+    uint16_t crc;
+    uint8_t payload[TAM_MAX_PAYLOAD_TELEMETRIA];
+    uint32_t tramasRecibidas;
+    uint32_t erroresCRC;
+    uint32_t bytesDescartados;
+} decodificadorTelemetria_t;
+
+
+/***************************************************************************************
+** AREA DE DECLARACION DE VARIABLES                                                   **
+****************************************************************************************/
+
+
+/***************************************************************************************
+** AREA DE PROTOTIPOS DE FUNCION                                                      **
+****************************************************************************************/
+const defMensajeTelemetria_t *defMensajeTelemetria(uint8_t id);
+uint8_t tamPayloadTelemetria(const defMensajeTelemetria_t *def);
+uint8_t codificarTramaTelemetria(uint8_t *trama, uint8_t id, uint8_t secuencia, const void *mensaje);
+bool decodificarMensajeTelemetria(uint8_t id, const uint8_t *payload, uint8_t longitud, void *mensaje);
+
+void iniciarDecodificadorTelemetria(decodificadorTelemetria_t *decodificador);
+bool procesarByteTelemetria(decodificadorTelemetria_t *decodificador, uint8_t dato);
+
+#endif // __PROTOCOLO_TELEMETRIA_H
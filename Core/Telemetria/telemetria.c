@@ -7,7 +7,7 @@
 **
 **  Autor: Ramon Rico
 **  Fecha de creacion: 10/06/2019
-**  Fecha de modificacion: 21/09/2020
+**  Fecha de modificacion: 17/10/2026
 **
 **  El proyecto URpilot NO es libre. No se puede distribuir y/o modificar este fichero
 **  bajo ningun concepto.
@@ -25,22 +25,26 @@
 /***************************************************************************************
 ** AREA DE INCLUDES                                                                   **
 ****************************************************************************************/
-#include <stdio.h>
 #include <string.h>
-#include <math.h>
 
 #include "telemetria.h"
+#include "parametros_telemetria.h"
 
 #ifdef USAR_IMU
 #include "Sensores/IMU/imu.h"
+#include "Sensores/GPS/gps.h"
 #include "AHRS/ahrs.h"
 #include "FC/rc.h"
 #include "FC/control.h"
+#include "FC/mixer.h"
+#include "Scheduler/scheduler.h"
 
 
 /***************************************************************************************
 ** AREA DE PREPROCESADOR                                                              **
 ****************************************************************************************/
+// Un mensaje se envia si su instante de envio cae antes de la mitad del siguiente tick
+#define MARGEN_ENVIO_TELEMETRIA             (PERIODO_TAREA_HZ_SCHEDULER(FRECUENCIA_TAREA_TELEMETRIA) / 2)
 
 
 /***************************************************************************************
@@ -51,224 +55,371 @@
 /***************************************************************************************
 ** AREA DE DECLARACION DE VARIABLES                                                   **
 ****************************************************************************************/
-bufferTelemetria_t telBuffer;
+static suscripcionTelemetria_t suscripciones[NUM_MENSAJES_TELEMETRIA];
+static decodificadorTelemetria_t decodificador;
+static mensajeEstadoTelemetria_t estado;
+static uint8_t secuencia;
+static bool decodificadorIniciado = false;
 
 
 /***************************************************************************************
 ** AREA DE PROTOTIPOS DE FUNCION                                                      **
 ****************************************************************************************/
-void iniciarBufferTelemetria(void);
-void terminarBufferTelemetria(void);
-void insertarDatoTelemetria(float dato);
-void insertarBufferTelemetria(float *dato, uint16_t longitud);
-uint16_t obtenerNumBytesBufferTelemetria(void);
-uint16_t obtenerNumDatosBufferTelemetria(void);
+void procesarRecepcionTelemetria(uint32_t tiempoActual);
+bool enviarMensajeTelemetria(uint8_t id, uint32_t tiempoActual, uint16_t *presupuesto);
+void rellenarIMUtelemetria(void *mensaje, uint32_t tiempoActual);
+void rellenarAHRStelemetria(void *mensaje, uint32_t tiempoActual);
+void rellenarPIDtelemetria(void *mensaje, uint32_t tiempoActual);
+void rellenarMotoresTelemetria(void *mensaje, uint32_t tiempoActual);
+void rellenarSchedulerTelemetria(void *mensaje, uint32_t tiempoActual);
+void rellenarGPStelemetria(void *mensaje, uint32_t tiempoActual);
+void rellenarEstadoTelemetria(void *mensaje, uint32_t tiempoActual);
 
 
 /***************************************************************************************
 ** AREA DE DEFINICION DE FUNCIONES                                                    **
 ****************************************************************************************/
-char var[500];
-extern bool desactivarImu;
-int numBytes;
-char dato;
-
-
-float bytesToFloat(uint8_t *bytes) {
-    float result;
-    uint32_t temp;
-
-    temp = (bytes[3]<<24) | (bytes[2]<<16) | (bytes[1]<<8) | bytes[0];
-    // los bytes del float se interpretan como unsigned, así que los convertimos a uint32_t
-    result = *((float*)&temp); // convertimos el uint32_t a float mediante un puntero
-
-    return result;
-}
-
-
-float bytesToInt(uint8_t *bytes) {
-    float result;
-    uint32_t temp;
-
-    temp = (bytes[3]<<24) | (bytes[2]<<16) | (bytes[1]<<8) | bytes[0];
-    // los bytes del float se interpretan como unsigned, así que los convertimos a uint32_t
-    result = *((int32_t*)&temp); // convertimos el uint32_t a float mediante un puntero
-
-    return result;
-}
-
 
 /***************************************************************************************
-**  Nombre:         bool actualizarIMU(uint32_t tiempoActual)
-**  Descripcion:    Actualiza las muestras de las IMUs
+**  Nombre:         void actualizarTelemetria(uint32_t tiempoActual)
+**  Descripcion:    Atiende las suscripciones del host y envia los mensajes que tocan. Primero
+**                  van los mas retrasados y se para cuando el siguiente no cabe en el
+**                  presupuesto de bytes de la ejecucion o en el buffer del USB
 **  Parametros:     Tiempo actual
 **  Retorno:        Ninguno
 ****************************************************************************************/
 void actualizarTelemetria(uint32_t tiempoActual)
 {
-    UNUSED(tiempoActual);
-    float ref[3], w1[3], w2[3], w3[3], wG[3], a1[3], a2[3], a3[3], aG[3], euler[3], u[3];
+    uint32_t enviados = 0;
 
-    refAngulosRC(ref);
+    // Las respuestas a las peticiones del host salen antes que los mensajes suscritos
+    procesarRecepcionTelemetria(tiempoActual);
 
-    giroNumIMU(IMU_1, w1);
-    giroNumIMU(IMU_2, w2);
-    giroNumIMU(IMU_3, w3);
-    giroIMU(wG);
+    uint16_t presupuesto = MIN(PRESUPUESTO_BYTES_TELEMETRIA, bytesLibresBufferTxUSB());
 
-    acelNumIMU(IMU_1, a1);
-    acelNumIMU(IMU_2, a2);
-    acelNumIMU(IMU_3, a3);
-    acelIMU(aG);
+    while (true) {
+        int32_t maxRetraso = INT32_MIN;
+        uint8_t idMaxRetraso = NUM_MENSAJES_TELEMETRIA;
 
-    actitudAHRS(euler);
+        // A igual retraso gana el identificador mas bajo
+        for (uint8_t id = 0; id < NUM_MENSAJES_TELEMETRIA; id++) {
+            const int32_t retraso = (int32_t)(tiempoActual - suscripciones[id].siguienteEnvio);
 
-    u[0] = uRollPID();
-    u[1] = uPitchPID();
-    u[2] = uYawPID();
+            if (suscripciones[id].periodo == 0 || (enviados & (1 << id)) || retraso < -(int32_t)MARGEN_ENVIO_TELEMETRIA)
+                continue;
 
+            if (retraso > maxRetraso) {
+                maxRetraso = retraso;
+                idMaxRetraso = id;
+            }
+        }
 
-    iniciarBufferTelemetria();
+        if (idMaxRetraso == NUM_MENSAJES_TELEMETRIA)
+            return;
 
-    //insertarBufferTelemetria(ref, 3);
-    insertarBufferTelemetria(euler, 3);
-    /*insertarBufferTelemetria(wG, 3);
-    insertarBufferTelemetria(w1, 3);
-    insertarBufferTelemetria(w2, 3);
-    insertarBufferTelemetria(w3, 3);
-    insertarBufferTelemetria(aG, 3);
-    insertarBufferTelemetria(a1, 3);
-    insertarBufferTelemetria(a2, 3);
-    insertarBufferTelemetria(a3, 3);
-    insertarBufferTelemetria(u, 3);*/
-    terminarBufferTelemetria();
+        if (!enviarMensajeTelemetria(idMaxRetraso, tiempoActual, &presupuesto)) {
+            // Los que quedan pendientes salen en la siguiente ejecucion
+            for (uint8_t id = 0; id < NUM_MENSAJES_TELEMETRIA; id++) {
+                const int32_t retraso = (int32_t)(tiempoActual - suscripciones[id].siguienteEnvio);
 
-    escribirBufferUSB(telBuffer.buffer, obtenerNumBytesBufferTelemetria());
-/*
+                if (suscripciones[id].periodo != 0 && !(enviados & (1 << id)) && retraso >= -(int32_t)MARGEN_ENVIO_TELEMETRIA)
+                    estado.mensajesRetrasados++;
+            }
 
-    sprintf(var, "%.02f,%.02f,%.02f", ref[0], ref[1], ref[2]);
-    escribirBufferUSB((uint8_t *)var, strlen(var));
+            return;
+        }
 
-    sprintf(var, "%.02f,%.02f,%.02f", euler[0], euler[1], euler[2]);
-    escribirBufferUSB((uint8_t *)var, strlen(var));
+        enviados |= 1 << idMaxRetraso;
 
-    sprintf(var, "%.02f,%.02f,%.02f", wG[0], wG[1], wG[2]);
-    escribirBufferUSB((uint8_t *)var, strlen(var));
+        suscripcionTelemetria_t *suscripcion = &suscripciones[idMaxRetraso];
+        suscripcion->siguienteEnvio += suscripcion->periodo;
+        if ((int32_t)(tiempoActual - suscripcion->siguienteEnvio) >= (int32_t)suscripcion->periodo) {
+            estado.periodosPerdidos += (tiempoActual - suscripcion->siguienteEnvio) / suscripcion->periodo;
+            suscripcion->siguienteEnvio = tiempoActual + suscripcion->periodo;
+        }
+    }
+}
 
-    sprintf(var, "%.02f,%.02f,%.02f", w1[0], w1[1], w1[2]);
-    escribirBufferUSB((uint8_t *)var, strlen(var));
 
-    sprintf(var, "%.02f,%.02f,%.02f", w2[0], w2[1], w2[2]);
-    escribirBufferUSB((uint8_t *)var, strlen(var));
+/***************************************************************************************
+**  Nombre:         void procesarRecepcionTelemetria(uint32_t tiempoActual)
+**  Descripcion:    Decodifica los bytes recibidos por el USB, aplica las suscripciones y
+**                  responde a las peticiones de parametros
+**  Parametros:     Tiempo actual
+**  Retorno:        Ninguno
+****************************************************************************************/
+void procesarRecepcionTelemetria(uint32_t tiempoActual)
+{
+    uint8_t trama[TAM_MAX_TRAMA_TELEMETRIA];
 
-    sprintf(var, "%.02f,%.02f,%.02f", w3[0], w3[1], w3[2]);
-    escribirBufferUSB((uint8_t *)var, strlen(var));
+    if (!decodificadorIniciado) {
+        iniciarDecodificadorTelemetria(&decodificador);
+        decodificadorIniciado = true;
+    }
 
-    sprintf(var, "%.02f,%.02f,%.02f", aG[0], aG[1], aG[2]);
-    escribirBufferUSB((uint8_t *)var, strlen(var));
+    uint32_t numBytes = bytesRecibidosUSB();
+    while (numBytes > 0) {
+        const int16_t dato = leerUSB();
+        numBytes--;
+
+        if (dato < 0)
+            break;
+
+        if (!procesarByteTelemetria(&decodificador, (uint8_t)dato))
+            continue;
+
+        if (decodificador.id == MENSAJE_TELEMETRIA_SUSCRIPCION) {
+            mensajeSuscripcionTelemetria_t suscripcion;
+
+            decodificarMensajeTelemetria(decodificador.id, decodificador.payload, decodificador.longitud, &suscripcion);
+            suscribirMensajeTelemetria(suscripcion.id, suscripcion.frecuencia, tiempoActual);
+            continue;
+        }
+
+        // Si la respuesta no cabe se descarta y el host repite la peticion
+        const uint8_t longitud = atenderParametrosTelemetria(decodificador.id, decodificador.payload, decodificador.longitud,
+                                                             secuencia, trama);
+        if (longitud > 0 && longitud <= bytesLibresBufferTxUSB()) {
+            escribirBufferUSB(trama, longitud);
+            secuencia++;
+            estado.mensajesEnviados++;
+        }
+    }
+}
 
-    sprintf(var, "%.02f,%.02f,%.02f", a1[0], a1[1], a1[2]);
-    escribirBufferUSB((uint8_t *)var, strlen(var));
 
-    sprintf(var, "%.02f,%.02f,%.02f", a2[0], a2[1], a2[2]);
-    escribirBufferUSB((uint8_t *)var, strlen(var));
+/***************************************************************************************
+**  Nombre:         bool suscribirMensajeTelemetria(uint8_t id, uint16_t frecuencia, uint32_t tiempoActual)
+**  Descripcion:    Programa el envio periodico de un mensaje. La frecuencia se limita a la de
+**                  la tarea
+**  Parametros:     Identificador del mensaje, frecuencia en Hz (0 para cancelar), tiempo actual
+**  Retorno:        False si el mensaje no existe
+****************************************************************************************/
+bool suscribirMensajeTelemetria(uint8_t id, uint16_t frecuencia, uint32_t tiempoActual)
+{
+    if (id >= NUM_MENSAJES_TELEMETRIA)
+        return false;
 
-    sprintf(var, "%.02f,%.02f,%.02f", a3[0], a3[1], a3[2]);
-    escribirBufferUSB((uint8_t *)var, strlen(var));
+    if (frecuencia == 0) {
+        suscripciones[id].periodo = 0;
+        return true;
+    }
 
-    sprintf(var, "%.02f,%.02f,%.02f", u[0], u[1], u[2]);
-    escribirBufferUSB((uint8_t *)var, strlen(var));
-    terminarBufferTelemetria();
-*/
-    numBytes = bytesRecibidosUSB();
-    while (numBytes > 0) {
+    suscripciones[id].periodo = 1000000 / MIN(frecuencia, FRECUENCIA_TAREA_TELEMETRIA);
+    suscripciones[id].siguienteEnvio = tiempoActual;
+    return true;
+}
 
-        dato = leerUSB();
-        numBytes = numBytes-1;
 
+/***************************************************************************************
+**  Nombre:         bool enviarMensajeTelemetria(uint8_t id, uint32_t tiempoActual, uint16_t *presupuesto)
+**  Descripcion:    Construye y envia la trama de un mensaje si cabe en el presupuesto
+**  Parametros:     Identificador del mensaje, tiempo actual, bytes disponibles
+**  Retorno:        True si se ha enviado
+****************************************************************************************/
+bool enviarMensajeTelemetria(uint8_t id, uint32_t tiempoActual, uint16_t *presupuesto)
+{
+    union {
+        mensajeIMUtelemetria_t imu;
+        mensajeAHRStelemetria_t ahrs;
+        mensajePIDtelemetria_t pid;
+        mensajeMotoresTelemetria_t motores;
+        mensajeSchedulerTelemetria_t scheduler;
+        mensajeGPStelemetria_t gps;
+        mensajeEstadoTelemetria_t estado;
+    } mensaje;
+    uint8_t trama[TAM_MAX_TRAMA_TELEMETRIA];
+
+    const uint8_t longitud = TAM_CABECERA_TELEMETRIA + tamPayloadTelemetria(defMensajeTelemetria(id)) + TAM_CRC_TELEMETRIA;
+    if (longitud > *presupuesto)
+        return false;
+
+    switch (id) {
+        case MENSAJE_TELEMETRIA_IMU:
+            rellenarIMUtelemetria(&mensaje, tiempoActual);
+            break;
+
+        case MENSAJE_TELEMETRIA_AHRS:
+            rellenarAHRStelemetria(&mensaje, tiempoActual);
+            break;
+
+        case MENSAJE_TELEMETRIA_PID:
+            rellenarPIDtelemetria(&mensaje, tiempoActual);
+            break;
+
+        case MENSAJE_TELEMETRIA_MOTORES:
+            rellenarMotoresTelemetria(&mensaje, tiempoActual);
+            break;
+
+        case MENSAJE_TELEMETRIA_SCHEDULER:
+            rellenarSchedulerTelemetria(&mensaje, tiempoActual);
+            break;
+
+        case MENSAJE_TELEMETRIA_GPS:
+            rellenarGPStelemetria(&mensaje, tiempoActual);
+            break;
+
+        default:
+            rellenarEstadoTelemetria(&mensaje, tiempoActual);
+            break;
     }
 
+    codificarTramaTelemetria(trama, id, secuencia++, &mensaje);
+    escribirBufferUSB(trama, longitud);
+
+    *presupuesto -= longitud;
+    estado.mensajesEnviados++;
+    return true;
+}
+
+
+/***************************************************************************************
+**  Nombre:         void rellenarIMUtelemetria(void *mensaje, uint32_t tiempoActual)
+**  Descripcion:    Rellena el mensaje de la IMU
+**  Parametros:     Mensaje, tiempo actual
+**  Retorno:        Ninguno
+****************************************************************************************/
+void rellenarIMUtelemetria(void *mensaje, uint32_t tiempoActual)
+{
+    mensajeIMUtelemetria_t *imu = (mensajeIMUtelemetria_t *)mensaje;
+
+    imu->tiempo = tiempoActual;
+    giroIMU(imu->giro);
+    acelIMU(imu->acel);
+    imu->temperatura = tempIMU();
 }
 
 
 /***************************************************************************************
-**  Nombre:         void iniciarBufferTelemetria(void)
-**  Descripcion:    Inicia el buffer de la telemetria
-**  Parametros:     Dato a insertar
+**  Nombre:         void rellenarAHRStelemetria(void *mensaje, uint32_t tiempoActual)
+**  Descripcion:    Rellena el mensaje del AHRS
+**  Parametros:     Mensaje, tiempo actual
 **  Retorno:        Ninguno
 ****************************************************************************************/
-void iniciarBufferTelemetria(void)
+void rellenarAHRStelemetria(void *mensaje, uint32_t tiempoActual)
 {
-    telBuffer.indice = 0;
+    mensajeAHRStelemetria_t *ahrs = (mensajeAHRStelemetria_t *)mensaje;
+
+    ahrs->tiempo = tiempoActual;
+    actitudAHRS(ahrs->euler);
+    velAngularAHRS(ahrs->velAngular);
+    posicionAHRS(ahrs->posicion);
+    velLinealAHRS(ahrs->velLineal);
 }
 
 
 /***************************************************************************************
-**  Nombre:         void terminarBufferTelemetria(void)
-**  Descripcion:    Termina el buffer de la telemetria
-**  Parametros:     Dato a insertar
+**  Nombre:         void rellenarPIDtelemetria(void *mensaje, uint32_t tiempoActual)
+**  Descripcion:    Rellena el mensaje de los controladores
+**  Parametros:     Mensaje, tiempo actual
 **  Retorno:        Ninguno
 ****************************************************************************************/
-void terminarBufferTelemetria(void)
+void rellenarPIDtelemetria(void *mensaje, uint32_t tiempoActual)
 {
-    telBuffer.buffer[telBuffer.indice] = '\r';
-    telBuffer.indice++;
-    telBuffer.buffer[telBuffer.indice] = '\n';
-    telBuffer.indice++;
+    mensajePIDtelemetria_t *pid = (mensajePIDtelemetria_t *)mensaje;
+
+    pid->tiempo = tiempoActual;
+    refAngulosRC(pid->referencia);
+    pid->u[0] = uRollPID();
+    pid->u[1] = uPitchPID();
+    pid->u[2] = uYawPID();
+    pid->u[3] = uAltPID();
 }
 
 
 /***************************************************************************************
-**  Nombre:         void insertarDatoTelemetria(float dato)
-**  Descripcion:    Inserta un float en el buffer de telemetria
-**  Parametros:     Dato a insertar
+**  Nombre:         void rellenarMotoresTelemetria(void *mensaje, uint32_t tiempoActual)
+**  Descripcion:    Rellena el mensaje con las salidas del mixer
+**  Parametros:     Mensaje, tiempo actual
 **  Retorno:        Ninguno
 ****************************************************************************************/
-void insertarDatoTelemetria(float dato)
+void rellenarMotoresTelemetria(void *mensaje, uint32_t tiempoActual)
 {
-	datoTelemetria_t datoTel;
+    mensajeMotoresTelemetria_t *motores = (mensajeMotoresTelemetria_t *)mensaje;
 
-	datoTel.valor = dato;
-    for (uint8_t i = 0; i < 4; i++) {
-    	telBuffer.buffer[telBuffer.indice] = datoTel.byte[i];
-    	telBuffer.indice++;
+    motores->tiempo = tiempoActual;
+    motores->habilitados = motoresEncendidosMixer();
+    motores->numMotores = MIN(numMotores(), NUM_MOTORES_TELEMETRIA);
+    for (uint8_t i = 0; i < NUM_MOTORES_TELEMETRIA; i++)
+        motores->salida[i] = salidaMotorMixer(i);
+}
+
+
+/***************************************************************************************
+**  Nombre:         void rellenarSchedulerTelemetria(void *mensaje, uint32_t tiempoActual)
+**  Descripcion:    Rellena el mensaje con la carga y los deadlines del scheduler
+**  Parametros:     Mensaje, tiempo actual
+**  Retorno:        Ninguno
+****************************************************************************************/
+void rellenarSchedulerTelemetria(void *mensaje, uint32_t tiempoActual)
+{
+    mensajeSchedulerTelemetria_t *scheduler = (mensajeSchedulerTelemetria_t *)mensaje;
+
+    scheduler->tiempo = tiempoActual;
+    scheduler->carga = cargaScheduler();
+    scheduler->deadlinesPerdidos = 0;
+    scheduler->retrasoMaxDeadline = 0;
+    scheduler->tiempoMaxEjecucion = 0;
+
+    for (uint8_t i = 0; i < TAREA_CONTADOR; i++) {
+        scheduler->deadlinesPerdidos += tareas[i].deadlinesPerdidos;
+        scheduler->retrasoMaxDeadline = MAX(scheduler->retrasoMaxDeadline, tareas[i].retrasoMaxDeadline);
+        scheduler->tiempoMaxEjecucion = MAX(scheduler->tiempoMaxEjecucion, tareas[i].tiempoMaxEjecucion);
     }
 }
 
 
 /***************************************************************************************
-**  Nombre:         void insertarBufferTelemetria(float *dato, uint16_t longitud)
-**  Descripcion:    Inserta un buffer de float en el buffer de telemetria
-**  Parametros:     Buffer a insertar, longitud del buffer
+**  Nombre:         void rellenarGPStelemetria(void *mensaje, uint32_t tiempoActual)
+**  Descripcion:    Rellena el mensaje del GPS
+**  Parametros:     Mensaje, tiempo actual
 **  Retorno:        Ninguno
 ****************************************************************************************/
-void insertarBufferTelemetria(float *dato, uint16_t longitud)
+void rellenarGPStelemetria(void *mensaje, uint32_t tiempoActual)
 {
-    for (uint8_t i = 0; i < longitud; i++)
-    	insertarDatoTelemetria(dato[i]);
+    mensajeGPStelemetria_t *gps = (mensajeGPStelemetria_t *)mensaje;
+
+    memset(gps, 0, sizeof(*gps));
+    gps->tiempo = tiempoActual;
+
+#ifdef USAR_GPS
+    localizacion_t localizacion;
+
+    localizacionGPS(&localizacion);
+    gps->operativo = gpsGenOperativo();
+    gps->numSats = satelitesGPS();
+    gps->latitud = localizacion.latitud;
+    gps->longitud = localizacion.longitud;
+    gps->altitud = localizacion.altitud;
+    gps->vel2d = vel2dGPS();
+#endif
 }
 
 
 /***************************************************************************************
-**  Nombre:         uint16_t obtenerNumBytesBufferTelemetria(void)
-**  Descripcion:    Devuelve el numero de bytes cargados en el buffer
-**  Parametros:     Ninguno
-**  Retorno:        Numero de bytes
+**  Nombre:         void rellenarEstadoTelemetria(void *mensaje, uint32_t tiempoActual)
+**  Descripcion:    Rellena el mensaje con las estadisticas del enlace
+**  Parametros:     Mensaje, tiempo actual
+**  Retorno:        Ninguno
 ****************************************************************************************/
-uint16_t obtenerNumBytesBufferTelemetria(void)
+void rellenarEstadoTelemetria(void *mensaje, uint32_t tiempoActual)
 {
-	return telBuffer.indice;
+    estadoTelemetria((mensajeEstadoTelemetria_t *)mensaje);
+    ((mensajeEstadoTelemetria_t *)mensaje)->tiempo = tiempoActual;
 }
 
 
 /***************************************************************************************
-**  Nombre:         uint16_t obtenerNumDatosBufferTelemetria(void)
-**  Descripcion:    Devuelve el numero de floats cargados en el buffer
-**  Parametros:     Ninguno
-**  Retorno:        Numero de datos
+**  Nombre:         void estadoTelemetria(mensajeEstadoTelemetria_t *estadoTel)
+**  Descripcion:    Devuelve las estadisticas de la telemetria
+**  Parametros:     Puntero a las estadisticas
+**  Retorno:        Ninguno
 ****************************************************************************************/
-uint16_t obtenerNumDatosBufferTelemetria(void)
+void estadoTelemetria(mensajeEstadoTelemetria_t *estadoTel)
 {
-	return (telBuffer.indice - 2) / 4;
+    *estadoTel = estado;
+    estadoTel->tramasRecibidas = decodificador.tramasRecibidas;
+    estadoTel->erroresCRC = decodificador.erroresCRC;
+    estadoTel->bytesDescartados = decodificador.bytesDescartados;
 }
 #endif
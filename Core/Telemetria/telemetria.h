@@ -7,7 +7,7 @@
 **
 **  Autor: Ramon Rico
 **  Fecha de creacion: 10/06/2019
-**  Fecha de modificacion: 21/09/2020
+**  Fecha de modificacion: 17/10/2026
 **
 **  El proyecto URpilot NO es libre. No se puede distribuir y/o modificar este fichero
 **  bajo ningun concepto.
@@ -32,26 +32,24 @@
 #include <stdbool.h>
 
 #include "Sistema/plataforma.h"
-#include "Drivers/USB.h"
+#include "Drivers/usb.h"
+#include "protocolo_telemetria.h"
 
 
 /***************************************************************************************
 ** AREA DE PREPROCESADOR                                                              **
 ****************************************************************************************/
+#define FRECUENCIA_TAREA_TELEMETRIA         200         // Hz
+#define PRESUPUESTO_BYTES_TELEMETRIA        256         // Bytes por ejecucion de la tarea
 
 
 /***************************************************************************************
 ** AREA DE DEFINICION DE TIPOS                                                        **
 ****************************************************************************************/
-typedef union {
-	float valor;
-	uint8_t byte[4];
-} datoTelemetria_t;
-
 typedef struct {
-	uint16_t indice;
-	uint8_t buffer[500];
-} bufferTelemetria_t;
+    uint32_t periodo;                       // us. 0 si el mensaje no esta suscrito
+    uint32_t siguienteEnvio;                // us
+} suscripcionTelemetria_t;
 
 
 /***************************************************************************************
@@ -63,6 +61,8 @@ typedef struct {
 ** AREA DE PROTOTIPOS DE FUNCION                                                      **
 ****************************************************************************************/
 void actualizarTelemetria(uint32_t tiempoActual);
+bool suscribirMensajeTelemetria(uint8_t id, uint16_t frecuencia, uint32_t tiempoActual);
+void estadoTelemetria(mensajeEstadoTelemetria_t *estado);
 
 
 #endif // __TELEMETRIA_H_
@@ -7,17 +7,20 @@
 C_SRCS += \
 ../Core/AHRS/ahrs.c \
 ../Core/AHRS/madgwick.c \
-../Core/AHRS/mahony.c 
+../Core/AHRS/mahony.c \
+../Core/AHRS/navegacion.c 
 
 OBJS += \
 ./Core/AHRS/ahrs.o \
 ./Core/AHRS/madgwick.o \
-./Core/AHRS/mahony.o 
+./Core/AHRS/mahony.o \
+./Core/AHRS/navegacion.o 
 
 C_DEPS += \
 ./Core/AHRS/ahrs.d \
 ./Core/AHRS/madgwick.d \
-./Core/AHRS/mahony.d 
+./Core/AHRS/mahony.d \
+./Core/AHRS/navegacion.d 
 
 
 # Each subdirectory must supply rules for building sources it contributes
@@ -27,7 +30,7 @@ Core/AHRS/%.o Core/AHRS/%.su Core/AHRS/%.cyclo: ../Core/AHRS/%.c Core/AHRS/subdi
 clean: clean-Core-2f-AHRS
 
 clean-Core-2f-AHRS:
-	-$(RM) ./Core/AHRS/ahrs.cyclo ./Core/AHRS/ahrs.d ./Core/AHRS/ahrs.o ./Core/AHRS/ahrs.su ./Core/AHRS/madgwick.cyclo ./Core/AHRS/madgwick.d ./Core/AHRS/madgwick.o ./Core/AHRS/madgwick.su ./Core/AHRS/mahony.cyclo ./Core/AHRS/mahony.d ./Core/AHRS/mahony.o ./Core/AHRS/mahony.su
+	-$(RM) ./Core/AHRS/ahrs.cyclo ./Core/AHRS/ahrs.d ./Core/AHRS/ahrs.o ./Core/AHRS/ahrs.su ./Core/AHRS/madgwick.cyclo ./Core/AHRS/madgwick.d ./Core/AHRS/madgwick.o ./Core/AHRS/madgwick.su ./Core/AHRS/mahony.cyclo ./Core/AHRS/mahony.d ./Core/AHRS/mahony.o ./Core/AHRS/mahony.su ./Core/AHRS/navegacion.cyclo ./Core/AHRS/navegacion.d ./Core/AHRS/navegacion.o ./Core/AHRS/navegacion.su
 
 .PHONY: clean-Core-2f-AHRS
 
@@ -7,6 +7,7 @@
 C_SRCS += \
 ../Core/Blackbox/blackbox.c \
 ../Core/Blackbox/blackbox_sd.c \
+../Core/Blackbox/codificacion_blackbox.c \
 ../Core/Blackbox/sd.c \
 ../Core/Blackbox/sd_estandar.c \
 ../Core/Blackbox/sd_sdio.c \
@@ -15,6 +16,7 @@ C_SRCS += \
 OBJS += \
 ./Core/Blackbox/blackbox.o \
 ./Core/Blackbox/blackbox_sd.o \
+./Core/Blackbox/codificacion_blackbox.o \
 ./Core/Blackbox/sd.o \
 ./Core/Blackbox/sd_estandar.o \
 ./Core/Blackbox/sd_sdio.o \
@@ -23,6 +25,7 @@ OBJS += \
 C_DEPS += \
 ./Core/Blackbox/blackbox.d \
 ./Core/Blackbox/blackbox_sd.d \
+./Core/Blackbox/codificacion_blackbox.d \
 ./Core/Blackbox/sd.d \
 ./Core/Blackbox/sd_estandar.d \
 ./Core/Blackbox/sd_sdio.d \
@@ -36,7 +39,7 @@ Core/Blackbox/%.o Core/Blackbox/%.su Core/Blackbox/%.cyclo: ../Core/Blackbox/%.c
 clean: clean-Core-2f-Blackbox
 
 clean-Core-2f-Blackbox:
-	-$(RM) ./Core/Blackbox/blackbox.cyclo ./Core/Blackbox/blackbox.d ./Core/Blackbox/blackbox.o ./Core/Blackbox/blackbox.su ./Core/Blackbox/blackbox_sd.cyclo ./Core/Blackbox/blackbox_sd.d ./Core/Blackbox/blackbox_sd.o ./Core/Blackbox/blackbox_sd.su ./Core/Blackbox/sd.cyclo ./Core/Blackbox/sd.d ./Core/Blackbox/sd.o ./Core/Blackbox/sd.su ./Core/Blackbox/sd_estandar.cyclo ./Core/Blackbox/sd_estandar.d ./Core/Blackbox/sd_estandar.o ./Core/Blackbox/sd_estandar.su ./Core/Blackbox/sd_sdio.cyclo ./Core/Blackbox/sd_sdio.d ./Core/Blackbox/sd_sdio.o ./Core/Blackbox/sd_sdio.su ./Core/Blackbox/sd_spi.cyclo ./Core/Blackbox/sd_spi.d ./Core/Blackbox/sd_spi.o ./Core/Blackbox/sd_spi.su
+	-$(RM) ./Core/Blackbox/blackbox.cyclo ./Core/Blackbox/blackbox.d ./Core/Blackbox/blackbox.o ./Core/Blackbox/blackbox.su ./Core/Blackbox/blackbox_sd.cyclo ./Core/Blackbox/blackbox_sd.d ./Core/Blackbox/blackbox_sd.o ./Core/Blackbox/blackbox_sd.su ./Core/Blackbox/codificacion_blackbox.cyclo ./Core/Blackbox/codificacion_blackbox.d ./Core/Blackbox/codificacion_blackbox.o ./Core/Blackbox/codificacion_blackbox.su ./Core/Blackbox/sd.cyclo ./Core/Blackbox/sd.d ./Core/Blackbox/sd.o ./Core/Blackbox/sd.su ./Core/Blackbox/sd_estandar.cyclo ./Core/Blackbox/sd_estandar.d ./Core/Blackbox/sd_estandar.o ./Core/Blackbox/sd_estandar.su ./Core/Blackbox/sd_sdio.cyclo ./Core/Blackbox/sd_sdio.d ./Core/Blackbox/sd_sdio.o ./Core/Blackbox/sd_sdio.su ./Core/Blackbox/sd_spi.cyclo ./Core/Blackbox/sd_spi.d ./Core/Blackbox/sd_spi.o ./Core/Blackbox/sd_spi.su
 
 .PHONY: clean-Core-2f-Blackbox
 
@@ -8,18 +8,21 @@ C_SRCS += \
 ../Core/Comun/crc.c \
 ../Core/Comun/localizacion.c \
 ../Core/Comun/matematicas.c \
+../Core/Comun/matematicas_rapidas.c \
 ../Core/Comun/matriz.c 
 
 OBJS += \
 ./Core/Comun/crc.o \
 ./Core/Comun/localizacion.o \
 ./Core/Comun/matematicas.o \
+./Core/Comun/matematicas_rapidas.o \
 ./Core/Comun/matriz.o 
 
 C_DEPS += \
 ./Core/Comun/crc.d \
 ./Core/Comun/localizacion.d \
 ./Core/Comun/matematicas.d \
+./Core/Comun/matematicas_rapidas.d \
 ./Core/Comun/matriz.d 
 
 
@@ -30,7 +33,7 @@ Core/Comun/%.o Core/Comun/%.su Core/Comun/%.cyclo: ../Core/Comun/%.c Core/Comun/
 clean: clean-Core-2f-Comun
 
 clean-Core-2f-Comun:
-	-$(RM) ./Core/Comun/crc.cyclo ./Core/Comun/crc.d ./Core/Comun/crc.o ./Core/Comun/crc.su ./Core/Comun/localizacion.cyclo ./Core/Comun/localizacion.d ./Core/Comun/localizacion.o ./Core/Comun/localizacion.su ./Core/Comun/matematicas.cyclo ./Core/Comun/matematicas.d ./Core/Comun/matematicas.o ./Core/Comun/matematicas.su ./Core/Comun/matriz.cyclo ./Core/Comun/matriz.d ./Core/Comun/matriz.o ./Core/Comun/matriz.su
+	-$(RM) ./Core/Comun/crc.cyclo ./Core/Comun/crc.d ./Core/Comun/crc.o ./Core/Comun/crc.su ./Core/Comun/localizacion.cyclo ./Core/Comun/localizacion.d ./Core/Comun/localizacion.o ./Core/Comun/localizacion.su ./Core/Comun/matematicas.cyclo ./Core/Comun/matematicas.d ./Core/Comun/matematicas.o ./Core/Comun/matematicas.su ./Core/Comun/matematicas_rapidas.cyclo ./Core/Comun/matematicas_rapidas.d ./Core/Comun/matematicas_rapidas.o ./Core/Comun/matematicas_rapidas.su ./Core/Comun/matriz.cyclo ./Core/Comun/matriz.d ./Core/Comun/matriz.o ./Core/Comun/matriz.su
 
 .PHONY: clean-Core-2f-Comun
 
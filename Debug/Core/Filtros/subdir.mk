@@ -8,19 +8,25 @@ C_SRCS += \
 ../Core/Filtros/filtro_derivada.c \
 ../Core/Filtros/filtro_media_movil.c \
 ../Core/Filtros/filtro_notch.c \
-../Core/Filtros/filtro_pasa_bajo.c 
+../Core/Filtros/filtro_pasa_bajo.c \
+../Core/Filtros/filtro_rpm.c \
+../Core/Filtros/notch_dinamico.c 
 
 OBJS += \
 ./Core/Filtros/filtro_derivada.o \
 ./Core/Filtros/filtro_media_movil.o \
 ./Core/Filtros/filtro_notch.o \
-./Core/Filtros/filtro_pasa_bajo.o 
+./Core/Filtros/filtro_pasa_bajo.o \
+./Core/Filtros/filtro_rpm.o \
+./Core/Filtros/notch_dinamico.o 
 
 C_DEPS += \
 ./Core/Filtros/filtro_derivada.d \
 ./Core/Filtros/filtro_media_movil.d \
 ./Core/Filtros/filtro_notch.d \
-./Core/Filtros/filtro_pasa_bajo.d 
+./Core/Filtros/filtro_pasa_bajo.d \
+./Core/Filtros/filtro_rpm.d \
+./Core/Filtros/notch_dinamico.d 
 
 
 # Each subdirectory must supply rules for building sources it contributes
@@ -30,7 +36,7 @@ Core/Filtros/%.o Core/Filtros/%.su Core/Filtros/%.cyclo: ../Core/Filtros/%.c Cor
 clean: clean-Core-2f-Filtros
 
 clean-Core-2f-Filtros:
-	-$(RM) ./Core/Filtros/filtro_derivada.cyclo ./Core/Filtros/filtro_derivada.d ./Core/Filtros/filtro_derivada.o ./Core/Filtros/filtro_derivada.su ./Core/Filtros/filtro_media_movil.cyclo ./Core/Filtros/filtro_media_movil.d ./Core/Filtros/filtro_media_movil.o ./Core/Filtros/filtro_media_movil.su ./Core/Filtros/filtro_notch.cyclo ./Core/Filtros/filtro_notch.d ./Core/Filtros/filtro_notch.o ./Core/Filtros/filtro_notch.su ./Core/Filtros/filtro_pasa_bajo.cyclo ./Core/Filtros/filtro_pasa_bajo.d ./Core/Filtros/filtro_pasa_bajo.o ./Core/Filtros/filtro_pasa_bajo.su
+	-$(RM) ./Core/Filtros/filtro_derivada.cyclo ./Core/Filtros/filtro_derivada.d ./Core/Filtros/filtro_derivada.o ./Core/Filtros/filtro_derivada.su ./Core/Filtros/filtro_media_movil.cyclo ./Core/Filtros/filtro_media_movil.d ./Core/Filtros/filtro_media_movil.o ./Core/Filtros/filtro_media_movil.su ./Core/Filtros/filtro_notch.cyclo ./Core/Filtros/filtro_notch.d ./Core/Filtros/filtro_notch.o ./Core/Filtros/filtro_notch.su ./Core/Filtros/filtro_pasa_bajo.cyclo ./Core/Filtros/filtro_pasa_bajo.d ./Core/Filtros/filtro_pasa_bajo.o ./Core/Filtros/filtro_pasa_bajo.su ./Core/Filtros/filtro_rpm.cyclo ./Core/Filtros/filtro_rpm.d ./Core/Filtros/filtro_rpm.o ./Core/Filtros/filtro_rpm.su ./Core/Filtros/notch_dinamico.cyclo ./Core/Filtros/notch_dinamico.d ./Core/Filtros/notch_dinamico.o ./Core/Filtros/notch_dinamico.su
 
 .PHONY: clean-Core-2f-Filtros
 
@@ -29,7 +29,8 @@ C_SRCS += \
 ../Core/GP/gp_sistema.c \
 ../Core/GP/gp_spi.c \
 ../Core/GP/gp_uart.c \
-../Core/GP/gp_usb.c 
+../Core/GP/gp_usb.c \
+../Core/GP/parametros_gp.c 
 
 OBJS += \
 ./Core/GP/config_flash.o \
@@ -56,7 +57,8 @@ OBJS += \
 ./Core/GP/gp_sistema.o \
 ./Core/GP/gp_spi.o \
 ./Core/GP/gp_uart.o \
-./Core/GP/gp_usb.o 
+./Core/GP/gp_usb.o \
+./Core/GP/parametros_gp.o 
 
 C_DEPS += \
 ./Core/GP/config_flash.d \
@@ -83,7 +85,8 @@ C_DEPS += \
 ./Core/GP/gp_sistema.d \
 ./Core/GP/gp_spi.d \
 ./Core/GP/gp_uart.d \
-./Core/GP/gp_usb.d 
+./Core/GP/gp_usb.d \
+./Core/GP/parametros_gp.d 
 
 
 # Each subdirectory must supply rules for building sources it contributes
@@ -93,7 +96,7 @@ Core/GP/%.o Core/GP/%.su Core/GP/%.cyclo: ../Core/GP/%.c Core/GP/subdir.mk
 clean: clean-Core-2f-GP
 
 clean-Core-2f-GP:
-	-$(RM) ./Core/GP/config_flash.cyclo ./Core/GP/config_flash.d ./Core/GP/config_flash.o ./Core/GP/config_flash.su ./Core/GP/gp.cyclo ./Core/GP/gp.d ./Core/GP/gp.o ./Core/GP/gp.su ./Core/GP/gp_adc.cyclo ./Core/GP/gp_adc.d ./Core/GP/gp_adc.o ./Core/GP/gp_adc.su ./Core/GP/gp_ahrs.cyclo ./Core/GP/gp_ahrs.d ./Core/GP/gp_ahrs.o ./Core/GP/gp_ahrs.su ./Core/GP/gp_barometro.cyclo ./Core/GP/gp_barometro.d ./Core/GP/gp_barometro.o ./Core/GP/gp_barometro.su ./Core/GP/gp_blackbox.cyclo ./Core/GP/gp_blackbox.d ./Core/GP/gp_blackbox.o ./Core/GP/gp_blackbox.su ./Core/GP/gp_calibrador.cyclo ./Core/GP/gp_calibrador.d ./Core/GP/gp_calibrador.o ./Core/GP/gp_calibrador.su ./Core/GP/gp_control.cyclo ./Core/GP/gp_control.d ./Core/GP/gp_control.o ./Core/GP/gp_control.su ./Core/GP/gp_fc.cyclo ./Core/GP/gp_fc.d ./Core/GP/gp_fc.o ./Core/GP/gp_fc.su ./Core/GP/gp_gps.cyclo ./Core/GP/gp_gps.d ./Core/GP/gp_gps.o ./Core/GP/gp_gps.su ./Core/GP/gp_i2c.cyclo ./Core/GP/gp_i2c.d ./Core/GP/gp_i2c.o ./Core/GP/gp_i2c.su ./Core/GP/gp_imu.cyclo ./Core/GP/gp_imu.d ./Core/GP/gp_imu.o ./Core/GP/gp_imu.su ./Core/GP/gp_magnetometro.cyclo ./Core/GP/gp_magnetometro.d ./Core/GP/gp_magnetometro.o ./Core/GP/gp_magnetometro.su ./Core/GP/gp_mixer.cyclo ./Core/GP/gp_mixer.d ./Core/GP/gp_mixer.o ./Core/GP/gp_mixer.su ./Core/GP/gp_motor.cyclo ./Core/GP/gp_motor.d ./Core/GP/gp_motor.o ./Core/GP/gp_motor.su ./Core/GP/gp_power_module.cyclo ./Core/GP/gp_power_module.d ./Core/GP/gp_power_module.o ./Core/GP/gp_power_module.su ./Core/GP/gp_radio.cyclo ./Core/GP/gp_radio.d ./Core/GP/gp_radio.o ./Core/GP/gp_radio.su ./Core/GP/gp_rc.cyclo ./Core/GP/gp_rc.d ./Core/GP/gp_rc.o ./Core/GP/gp_rc.su ./Core/GP/gp_rtc.cyclo ./Core/GP/gp_rtc.d ./Core/GP/gp_rtc.o ./Core/GP/gp_rtc.su ./Core/GP/gp_sd.cyclo ./Core/GP/gp_sd.d ./Core/GP/gp_sd.o ./Core/GP/gp_sd.su ./Core/GP/gp_sdmmc.cyclo ./Core/GP/gp_sdmmc.d ./Core/GP/gp_sdmmc.o ./Core/GP/gp_sdmmc.su ./Core/GP/gp_sistema.cyclo ./Core/GP/gp_sistema.d ./Core/GP/gp_sistema.o ./Core/GP/gp_sistema.su ./Core/GP/gp_spi.cyclo ./Core/GP/gp_spi.d ./Core/GP/gp_spi.o ./Core/GP/gp_spi.su ./Core/GP/gp_uart.cyclo ./Core/GP/gp_uart.d ./Core/GP/gp_uart.o ./Core/GP/gp_uart.su ./Core/GP/gp_usb.cyclo ./Core/GP/gp_usb.d ./Core/GP/gp_usb.o ./Core/GP/gp_usb.su
+	-$(RM) ./Core/GP/config_flash.cyclo ./Core/GP/config_flash.d ./Core/GP/config_flash.o ./Core/GP/config_flash.su ./Core/GP/gp.cyclo ./Core/GP/gp.d ./Core/GP/gp.o ./Core/GP/gp.su ./Core/GP/gp_adc.cyclo ./Core/GP/gp_adc.d ./Core/GP/gp_adc.o ./Core/GP/gp_adc.su ./Core/GP/gp_ahrs.cyclo ./Core/GP/gp_ahrs.d ./Core/GP/gp_ahrs.o ./Core/GP/gp_ahrs.su ./Core/GP/gp_barometro.cyclo ./Core/GP/gp_barometro.d ./Core/GP/gp_barometro.o ./Core/GP/gp_barometro.su ./Core/GP/gp_blackbox.cyclo ./Core/GP/gp_blackbox.d ./Core/GP/gp_blackbox.o ./Core/GP/gp_blackbox.su ./Core/GP/gp_calibrador.cyclo ./Core/GP/gp_calibrador.d ./Core/GP/gp_calibrador.o ./Core/GP/gp_calibrador.su ./Core/GP/gp_control.cyclo ./Core/GP/gp_control.d ./Core/GP/gp_control.o ./Core/GP/gp_control.su ./Core/GP/gp_fc.cyclo ./Core/GP/gp_fc.d ./Core/GP/gp_fc.o ./Core/GP/gp_fc.su ./Core/GP/gp_gps.cyclo ./Core/GP/gp_gps.d ./Core/GP/gp_gps.o ./Core/GP/gp_gps.su ./Core/GP/gp_i2c.cyclo ./Core/GP/gp_i2c.d ./Core/GP/gp_i2c.o ./Core/GP/gp_i2c.su ./Core/GP/gp_imu.cyclo ./Core/GP/gp_imu.d ./Core/GP/gp_imu.o ./Core/GP/gp_imu.su ./Core/GP/gp_magnetometro.cyclo ./Core/GP/gp_magnetometro.d ./Core/GP/gp_magnetometro.o ./Core/GP/gp_magnetometro.su ./Core/GP/gp_mixer.cyclo ./Core/GP/gp_mixer.d ./Core/GP/gp_mixer.o ./Core/GP/gp_mixer.su ./Core/GP/gp_motor.cyclo ./Core/GP/gp_motor.d ./Core/GP/gp_motor.o ./Core/GP/gp_motor.su ./Core/GP/gp_power_module.cyclo ./Core/GP/gp_power_module.d ./Core/GP/gp_power_module.o ./Core/GP/gp_power_module.su ./Core/GP/gp_radio.cyclo ./Core/GP/gp_radio.d ./Core/GP/gp_radio.o ./Core/GP/gp_radio.su ./Core/GP/gp_rc.cyclo ./Core/GP/gp_rc.d ./Core/GP/gp_rc.o ./Core/GP/gp_rc.su ./Core/GP/gp_rtc.cyclo ./Core/GP/gp_rtc.d ./Core/GP/gp_rtc.o ./Core/GP/gp_rtc.su ./Core/GP/gp_sd.cyclo ./Core/GP/gp_sd.d ./Core/GP/gp_sd.o ./Core/GP/gp_sd.su ./Core/GP/gp_sdmmc.cyclo ./Core/GP/gp_sdmmc.d ./Core/GP/gp_sdmmc.o ./Core/GP/gp_sdmmc.su ./Core/GP/gp_sistema.cyclo ./Core/GP/gp_sistema.d ./Core/GP/gp_sistema.o ./Core/GP/gp_sistema.su ./Core/GP/gp_spi.cyclo ./Core/GP/gp_spi.d ./Core/GP/gp_spi.o ./Core/GP/gp_spi.su ./Core/GP/gp_uart.cyclo ./Core/GP/gp_uart.d ./Core/GP/gp_uart.o ./Core/GP/gp_uart.su ./Core/GP/gp_usb.cyclo ./Core/GP/gp_usb.d ./Core/GP/gp_usb.o ./Core/GP/gp_usb.su ./Core/GP/parametros_gp.cyclo ./Core/GP/parametros_gp.d ./Core/GP/parametros_gp.o ./Core/GP/parametros_gp.su
 
 .PHONY: clean-Core-2f-GP
 
@@ -5,12 +5,18 @@
 
 # Add inputs and outputs from these tool invocations to the build variables 
 C_SRCS += \
+../Core/Telemetria/parametros_telemetria.c \
+../Core/Telemetria/protocolo_telemetria.c \
 ../Core/Telemetria/telemetria.c 
 
 OBJS += \
+./Core/Telemetria/parametros_telemetria.o \
+./Core/Telemetria/protocolo_telemetria.o \
 ./Core/Telemetria/telemetria.o 
 
 C_DEPS += \
+./Core/Telemetria/parametros_telemetria.d \
+./Core/Telemetria/protocolo_telemetria.d \
 ./Core/Telemetria/telemetria.d 
 
 
@@ -21,7 +27,7 @@ Core/Telemetria/%.o Core/Telemetria/%.su Core/Telemetria/%.cyclo: ../Core/Teleme
 clean: clean-Core-2f-Telemetria
 
 clean-Core-2f-Telemetria:
-	-$(RM) ./Core/Telemetria/telemetria.cyclo ./Core/Telemetria/telemetria.d ./Core/Telemetria/telemetria.o ./Core/Telemetria/telemetria.su
+	-$(RM) ./Core/Telemetria/parametros_telemetria.cyclo ./Core/Telemetria/parametros_telemetria.d ./Core/Telemetria/parametros_telemetria.o ./Core/Telemetria/parametros_telemetria.su ./Core/Telemetria/protocolo_telemetria.cyclo ./Core/Telemetria/protocolo_telemetria.d ./Core/Telemetria/protocolo_telemetria.o ./Core/Telemetria/protocolo_telemetria.su ./Core/Telemetria/telemetria.cyclo ./Core/Telemetria/telemetria.d ./Core/Telemetria/telemetria.o ./Core/Telemetria/telemetria.su
 
 .PHONY: clean-Core-2f-Telemetria
 
@@ -0,0 +1,645 @@
+/***************************************************************************************
+**  decodificar_blackbox.c - Decodificador de los logs binarios de la blackbox. Convierte
+**                           las tramas rapidas o lentas de un log en CSV
+**
+**
+**  Este fichero forma parte del proyecto URpilot.
+**  Codigo desarrollado por el grupo de investigacion ICON de la Universidad de La Rioja
+**
+**  Autor: Ramon Rico
+**  Fecha de creacion: 17/10/2026
+**  Fecha de modificacion: 17/10/2026
+**
+**  El proyecto URpilot NO es libre. No se puede distribuir y/o modificar este fichero
+**  bajo ningun concepto.
+**
+**  En caso de modificacion y/o solicitud de informacion pongase en contacto con
+**  el grupo de investigacion ICON a traves de: www.unirioja.es/urpilot
+**
+**
+**  Control de versiones del fichero
+**
+**  v1.0  Ramon Rico. Se ha liberado la primera version estable
+**
+****************************************************************************************/
+
+/***************************************************************************************
+** AREA DE INCLUDES                                                                   **
+****************************************************************************************/
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "Blackbox/codificacion_blackbox.h"
+
+
+/***************************************************************************************
+** AREA DE PREPROCESADOR                                                              **
+****************************************************************************************/
+#define NUM_MAX_CAMPOS_DECODIFICADOR          64
+#define NUM_MAX_COLUMNAS_DECODIFICADOR        128
+#define LONG_MAX_NOMBRE_DECODIFICADOR         40
+#define LONG_MAX_LINEA_DECODIFICADOR          2048
+
+#define NUM_CABECERAS_CAMPO_DECODIFICADOR     5
+
+// Eventos de Core/Blackbox/blackbox.h
+#define EVENTO_DESARMAR_DECODIFICADOR         0
+#define EVENTO_MODO_DECODIFICADOR             1
+#define EVENTO_LOG_REANUDAR_DECODIFICADOR     2
+#define EVENTO_LOG_FIN_DECODIFICADOR          3
+
+
+/***************************************************************************************
+** AREA DE DEFINICION DE TIPOS                                                        **
+****************************************************************************************/
+typedef struct {
+    // Cabecera tal y como llega: una entrada por campo
+    uint8_t numCampos;
+    char nombreCampo[NUM_MAX_CAMPOS_DECODIFICADOR][LONG_MAX_NOMBRE_DECODIFICADOR];
+    int cabCampo[NUM_CABECERAS_CAMPO_DECODIFICADOR - 1][NUM_MAX_CAMPOS_DECODIFICADOR];
+    uint8_t cabecerasLeidas;
+
+    // Campos expandidos en columnas, una por driver
+    uint8_t numColumnas;
+    uint8_t campoColumna[NUM_MAX_COLUMNAS_DECODIFICADOR];
+    uint8_t driverColumna[NUM_MAX_COLUMNAS_DECODIFICADOR];
+    int32_t valor[NUM_MAX_COLUMNAS_DECODIFICADOR];
+    int32_t anterior[NUM_MAX_COLUMNAS_DECODIFICADOR];
+    int32_t anterior2[NUM_MAX_COLUMNAS_DECODIFICADOR];
+    bool historiaValida;
+} tramaDecodificador_t;
+
+typedef struct {
+    const uint8_t *buf;
+    size_t longitud;
+    size_t pos;
+} lectorDecodificador_t;
+
+typedef struct {
+    uint32_t tramasIntra;
+    uint32_t tramasPredichas;
+    uint32_t tramasLentas;
+    uint32_t eventos;
+    uint32_t tramasCorruptas;
+    uint32_t bytesDescartados;
+} estadisticasDecodificador_t;
+
+// Orden de las cabeceras de campo del firmware (nombresCabCampoBlackbox)
+enum {
+    CAB_DRIVERS_DECODIFICADOR = 0,
+    CAB_PREDICTOR_DECODIFICADOR,
+    CAB_CODIFICACION_DECODIFICADOR,
+    CAB_DECIMALES_DECODIFICADOR,
+};
+
+
+/***************************************************************************************
+** AREA DE DECLARACION DE VARIABLES                                                   **
+****************************************************************************************/
+static const char * const nombresCabCampoDecodificador[NUM_CABECERAS_CAMPO_DECODIFICADOR] = {
+    "nombre",
+    "drivers",
+    "predictor",
+    "codificacion",
+    "decimales",
+};
+
+static tramaDecodificador_t tramaRapida;
+static tramaDecodificador_t tramaLenta;
+static estadisticasDecodificador_t estadisticas;
+
+
+/***************************************************************************************
+** AREA DE PROTOTIPOS DE FUNCION                                                      **
+****************************************************************************************/
+void leerLineaCabeceraDecodificador(lectorDecodificador_t *lector);
+void leerCabeceraCampoDecodificador(tramaDecodificador_t *trama, char *linea);
+bool expandirColumnasDecodificador(tramaDecodificador_t *trama);
+bool leerVarUIntDecodificador(lectorDecodificador_t *lector, uint32_t *valor);
+bool leerVarIntDecodificador(lectorDecodificador_t *lector, int32_t *valor);
+bool leerTramaRapidaDecodificador(lectorDecodificador_t *lector, tramaDecodificador_t *trama, bool intra);
+bool leerTramaLentaDecodificador(lectorDecodificador_t *lector, tramaDecodificador_t *trama);
+bool leerEventoDecodificador(lectorDecodificador_t *lector, bool *finLog);
+bool inicioTramaDecodificador(const lectorDecodificador_t *lector);
+void escribirCabeceraCSVdecodificador(FILE *salida, const tramaDecodificador_t *trama);
+void escribirTramaCSVdecodificador(FILE *salida, const tramaDecodificador_t *trama);
+void escribirValorDecodificador(FILE *salida, int32_t valor, int decimales);
+
+
+/***************************************************************************************
+** AREA DE DEFINICION DE FUNCIONES                                                    **
+****************************************************************************************/
+
+/***************************************************************************************
+**  Nombre:         void leerLineaCabeceraDecodificador(lectorDecodificador_t *lector)
+**  Descripcion:    Lee una linea de texto de la cabecera. Solo interesan las de los campos
+**  Parametros:     Lector posicionado en la 'C'
+**  Retorno:        Ninguno
+****************************************************************************************/
+void leerLineaCabeceraDecodificador(lectorDecodificador_t *lector)
+{
+    char linea[LONG_MAX_LINEA_DECODIFICADOR];
+    size_t longitud = 0;
+
+    while (lector->pos < lector->longitud && lector->buf[lector->pos] != '\n') {
+        if (longitud < sizeof(linea) - 1)
+            linea[longitud++] = (char)lector->buf[lector->pos];
+
+        lector->pos++;
+    }
+
+    lector->pos++;   // Salto de linea
+    linea[longitud] = '\0';
+
+    if (strncmp(linea, "C Campo R ", 10) == 0)
+        leerCabeceraCampoDecodificador(&tramaRapida, &linea[10]);
+    else if (strncmp(linea, "C Campo L ", 10) == 0)
+        leerCabeceraCampoDecodificador(&tramaLenta, &linea[10]);
+    else
+        fprintf(stderr, "%s\n", linea);
+}
+
+
+/***************************************************************************************
+**  Nombre:         void leerCabeceraCampoDecodificador(tramaDecodificador_t *trama, char *linea)
+**  Descripcion:    Lee una linea del estilo "drivers:1,1,2" y guarda sus valores por campo
+**  Parametros:     Trama a la que pertenece, linea sin el prefijo "C Campo x "
+**  Retorno:        Ninguno
+****************************************************************************************/
+void leerCabeceraCampoDecodificador(tramaDecodificador_t *trama, char *linea)
+{
+    char *valores = strchr(linea, ':');
+    uint8_t cabecera;
+
+    if (valores == NULL)
+        return;
+
+    *valores++ = '\0';
+
+    for (cabecera = 0; cabecera < NUM_CABECERAS_CAMPO_DECODIFICADOR; cabecera++) {
+        if (strcmp(linea, nombresCabCampoDecodificador[cabecera]) == 0)
+            break;
+    }
+
+    if (cabecera == NUM_CABECERAS_CAMPO_DECODIFICADOR)
+        return;
+
+    uint8_t numCampos = 0;
+    for (char *campo = strtok(valores, ","); campo != NULL && numCampos < NUM_MAX_CAMPOS_DECODIFICADOR; campo = strtok(NULL, ",")) {
+        if (cabecera == 0) {
+            strncpy(trama->nombreCampo[numCampos], campo, LONG_MAX_NOMBRE_DECODIFICADOR - 1);
+            trama->nombreCampo[numCampos][LONG_MAX_NOMBRE_DECODIFICADOR - 1] = '\0';
+        }
+        else
+            trama->cabCampo[cabecera - 1][numCampos] = atoi(campo);
+
+        numCampos++;
+    }
+
+    if (cabecera == 0)
+        trama->numCampos = numCampos;
+
+    trama->cabecerasLeidas |= 1 << cabecera;
+    if (trama->cabecerasLeidas == (1 << NUM_CABECERAS_CAMPO_DECODIFICADOR) - 1)
+        expandirColumnasDecodificador(trama);
+}
+
+
+/***************************************************************************************
+**  Nombre:         bool expandirColumnasDecodificador(tramaDecodificador_t *trama)
+**  Descripcion:    Expande los campos en columnas en el mismo orden que el firmware
+**  Parametros:     Trama
+**  Retorno:        True si la cabecera es coherente
+****************************************************************************************/
+bool expandirColumnasDecodificador(tramaDecodificador_t *trama)
+{
+    trama->numColumnas = 0;
+    trama->historiaValida = false;
+
+    for (uint8_t i = 0; i < trama->numCampos; i++) {
+        const int drivers = trama->cabCampo[CAB_DRIVERS_DECODIFICADOR][i];
+
+        for (int j = 0; j < drivers; j++) {
+            if (trama->numColumnas >= NUM_MAX_COLUMNAS_DECODIFICADOR) {
+                fprintf(stderr, "Demasiadas columnas en la cabecera\n");
+                return false;
+            }
+
+            trama->campoColumna[trama->numColumnas] = i;
+            trama->driverColumna[trama->numColumnas] = (uint8_t)j;
+            trama->numColumnas++;
+        }
+    }
+
+    return true;
+}
+
+
+/***************************************************************************************
+**  Nombre:         bool leerVarUIntDecodificador(lectorDecodificador_t *lector, uint32_t *valor)
+**  Descripcion:    Lee un entero sin signo codificado en grupos de 7 bits
+**  Parametros:     Lector, valor leido
+**  Retorno:        False si se acaba el fichero o el varint es demasiado largo
+****************************************************************************************/
+bool leerVarUIntDecodificador(lectorDecodificador_t *lector, uint32_t *valor)
+{
+    uint32_t resultado = 0;
+
+    for (uint8_t i = 0; i < NUM_MAX_BYTES_VAR_INT_BLACKBOX; i++) {
+        if (lector->pos >= lector->longitud)
+            return false;
+
+        const uint8_t byte = lector->buf[lector->pos++];
+        resultado |= (uint32_t)(byte & 0x7F) << (7 * i);
+
+        if ((byte & 0x80) == 0) {
+            *valor = resultado;
+            return true;
+        }
+    }
+
+    return false;
+}
+
+
+/***************************************************************************************
+**  Nombre:         bool leerVarIntDecodificador(lectorDecodificador_t *lector, int32_t *valor)
+**  Descripcion:    Lee un entero con signo en zig-zag
+**  Parametros:     Lector, valor leido
+**  Retorno:        False si el dato no es valido
+****************************************************************************************/
+bool leerVarIntDecodificador(lectorDecodificador_t *lector, int32_t *valor)
+{
+    uint32_t valorZigzag;
+
+    if (!leerVarUIntDecodificador(lector, &valorZigzag))
+        return false;
+
+    *valor = deshacerZigzagBlackbox(valorZigzag);
+    return true;
+}
+
+
+/***************************************************************************************
+**  Nombre:         bool leerTramaRapidaDecodificador(lectorDecodificador_t *lector, tramaDecodificador_t *trama, bool intra)
+**  Descripcion:    Lee una trama rapida intra o predicha. Deshace las predicciones con la
+**                  misma historia que el codificador
+**  Parametros:     Lector posicionado tras el identificador, trama, si es intra
+**  Retorno:        False si la trama esta incompleta o corrupta
+****************************************************************************************/
+bool leerTramaRapidaDecodificador(lectorDecodificador_t *lector, tramaDecodificador_t *trama, bool intra)
+{
+    int32_t residuo[NUM_MAX_COLUMNAS_DECODIFICADOR];
+
+    if (intra) {
+        for (uint8_t i = 0; i < trama->numColumnas; i++) {
+            if (!leerVarIntDecodificador(lector, &trama->valor[i]))
+                return false;
+        }
+
+        memcpy(trama->anterior, trama->valor, sizeof(trama->valor[0]) * trama->numColumnas);
+        memcpy(trama->anterior2, trama->valor, sizeof(trama->valor[0]) * trama->numColumnas);
+        trama->historiaValida = true;
+        return true;
+    }
+
+    for (uint8_t i = 0; i < trama->numColumnas; ) {
+        const uint8_t campo = trama->campoColumna[i];
+
+        if (trama->cabCampo[CAB_CODIFICACION_DECODIFICADOR][campo] == CODIFICACION_TAG8_8SVB_BLACKBOX) {
+            uint8_t numGrupo = 1;
+            while (i + numGrupo < trama->numColumnas && numGrupo < NUM_MAX_VALORES_TAG8_8SVB_BLACKBOX &&
+                   trama->cabCampo[CAB_CODIFICACION_DECODIFICADOR][trama->campoColumna[i + numGrupo]] == CODIFICACION_TAG8_8SVB_BLACKBOX)
+                numGrupo++;
+
+            if (lector->pos >= lector->longitud)
+                return false;
+
+            const uint8_t cabecera = lector->buf[lector->pos++];
+            if (numGrupo < 8 && (cabecera >> numGrupo) != 0)
+                return false;
+
+            for (uint8_t j = 0; j < numGrupo; j++) {
+                residuo[i + j] = 0;
+                if ((cabecera & (1 << j)) && !leerVarIntDecodificador(lector, &residuo[i + j]))
+                    return false;
+            }
+
+            i += numGrupo;
+        }
+        else {
+            if (!leerVarIntDecodificador(lector, &residuo[i]))
+                return false;
+
+            i++;
+        }
+    }
+
+    for (uint8_t i = 0; i < trama->numColumnas; i++) {
+        const predictorBlackbox_e predictor = trama->cabCampo[CAB_PREDICTOR_DECODIFICADOR][trama->campoColumna[i]];
+        const int32_t prediccion = predecirBlackbox(predictor, trama->anterior[i], trama->anterior2[i]);
+
+        trama->valor[i] = (int32_t)((uint32_t)prediccion + (uint32_t)residuo[i]);
+    }
+
+    memcpy(trama->anterior2, trama->anterior, sizeof(trama->anterior[0]) * trama->numColumnas);
+    memcpy(trama->anterior, trama->valor, sizeof(trama->valor[0]) * trama->numColumnas);
+    return true;
+}
+
+
+/***************************************************************************************
+**  Nombre:         bool leerTramaLentaDecodificador(lectorDecodificador_t *lector, tramaDecodificador_t *trama)
+**  Descripcion:    Lee una trama lenta. Sus valores son absolutos
+**  Parametros:     Lector posicionado tras el identificador, trama
+**  Retorno:        False si la trama esta incompleta o corrupta
+****************************************************************************************/
+bool leerTramaLentaDecodificador(lectorDecodificador_t *lector, tramaDecodificador_t *trama)
+{
+    for (uint8_t i = 0; i < trama->numColumnas; i++) {
+        if (!leerVarIntDecodificador(lector, &trama->valor[i]))
+            return false;
+    }
+
+    return true;
+}
+
+
+/***************************************************************************************
+**  Nombre:         bool leerEventoDecodificador(lectorDecodificador_t *lector, bool *finLog)
+**  Descripcion:    Lee un evento y lo muestra por la salida de errores
+**  Parametros:     Lector posicionado tras el identificador, se pone a true si es el fin del log
+**  Retorno:        False si el evento no es valido
+****************************************************************************************/
+bool leerEventoDecodificador(lectorDecodificador_t *lector, bool *finLog)
+{
+    uint32_t dato1, dato2;
+
+    if (lector->pos >= lector->longitud)
+        return false;
+
+    switch (lector->buf[lector->pos++]) {
+        case EVENTO_DESARMAR_DECODIFICADOR:
+            if (!leerVarUIntDecodificador(lector, &dato1))
+                return false;
+
+            fprintf(stderr, "Evento: desarmado (razon %u)\n", dato1);
+            return true;
+
+        case EVENTO_MODO_DECODIFICADOR:
+            if (!leerVarUIntDecodificador(lector, &dato1) || !leerVarUIntDecodificador(lector, &dato2))
+                return false;
+
+            fprintf(stderr, "Evento: modo 0x%08X (antes 0x%08X)\n", dato1, dato2);
+            return true;
+
+        case EVENTO_LOG_REANUDAR_DECODIFICADOR:
+            if (!leerVarUIntDecodificador(lector, &dato1) || !leerVarUIntDecodificador(lector, &dato2))
+                return false;
+
+            // El firmware fuerza una trama intra al reanudar
+            tramaRapida.historiaValida = false;
+            fprintf(stderr, "Evento: log reanudado (iteracion %u, tiempo %u)\n", dato1, dato2);
+            return true;
+
+        case EVENTO_LOG_FIN_DECODIFICADOR:
+            if (lector->longitud - lector->pos < sizeof("Fin del log") ||
+                memcmp(&lector->buf[lector->pos], "Fin del log", sizeof("Fin del log")) != 0)
+                return false;
+
+            lector->pos += sizeof("Fin del log");
+            *finLog = true;
+            return true;
+
+        default:
+            return false;
+    }
+}
+
+
+/***************************************************************************************
+**  Nombre:         bool inicioTramaDecodificador(const lectorDecodificador_t *lector)
+**  Descripcion:    Comprueba si en la posicion actual puede empezar una trama. Se usa para
+**                  validar el final de la trama anterior
+**  Parametros:     Lector
+**  Retorno:        True si es el final del fichero o un identificador de trama
+****************************************************************************************/
+bool inicioTramaDecodificador(const lectorDecodificador_t *lector)
+{
+    if (lector->pos >= lector->longitud)
+        return true;
+
+    switch (lector->buf[lector->pos]) {
+        case TRAMA_INTRA_BLACKBOX:
+        case TRAMA_PREDICHA_BLACKBOX:
+        case TRAMA_LENTA_BLACKBOX:
+        case TRAMA_EVENTO_BLACKBOX:
+        case 'C':
+            return true;
+
+        default:
+            return false;
+    }
+}
+
+
+/***************************************************************************************
+**  Nombre:         void escribirCabeceraCSVdecodificador(FILE *salida, const tramaDecodificador_t *trama)
+**  Descripcion:    Escribe los nombres de las columnas. Con varios drivers se anade el numero
+**  Parametros:     Fichero de salida, trama
+**  Retorno:        Ninguno
+****************************************************************************************/
+void escribirCabeceraCSVdecodificador(FILE *salida, const tramaDecodificador_t *trama)
+{
+    for (uint8_t i = 0; i < trama->numColumnas; i++) {
+        const uint8_t campo = trama->campoColumna[i];
+
+        if (i > 0)
+            fputc(',', salida);
+
+        if (trama->cabCampo[CAB_DRIVERS_DECODIFICADOR][campo] > 1)
+            fprintf(salida, "%s_%u", trama->nombreCampo[campo], trama->driverColumna[i]);
+        else
+            fputs(trama->nombreCampo[campo], salida);
+    }
+
+    fputc('\n', salida);
+}
+
+
+/***************************************************************************************
+**  Nombre:         void escribirTramaCSVdecodificador(FILE *salida, const tramaDecodificador_t *trama)
+**  Descripcion:    Escribe una fila del CSV
+**  Parametros:     Fichero de salida, trama
+**  Retorno:        Ninguno
+****************************************************************************************/
+void escribirTramaCSVdecodificador(FILE *salida, const tramaDecodificador_t *trama)
+{
+    for (uint8_t i = 0; i < trama->numColumnas; i++) {
+        if (i > 0)
+            fputc(',', salida);
+
+        escribirValorDecodificador(salida, trama->valor[i], trama->cabCampo[CAB_DECIMALES_DECODIFICADOR][trama->campoColumna[i]]);
+    }
+
+    fputc('\n', salida);
+}
+
+
+/***************************************************************************************
+**  Nombre:         void escribirValorDecodificador(FILE *salida, int32_t valor, int decimales)
+**  Descripcion:    Escribe un valor entero con los decimales de la cabecera sin pasar por float
+**  Parametros:     Fichero de salida, valor, numero de decimales
+**  Retorno:        Ninguno
+****************************************************************************************/
+void escribirValorDecodificador(FILE *salida, int32_t valor, int decimales)
+{
+    if (decimales <= 0) {
+        fprintf(salida, "%d", valor);
+        return;
+    }
+
+    int64_t potencia = 1;
+    for (int i = 0; i < decimales; i++)
+        potencia *= 10;
+
+    const int64_t absoluto = valor < 0 ? -(int64_t)valor : valor;
+    fprintf(salida, "%s%lld.%0*lld", valor < 0 ? "-" : "", (long long)(absoluto / potencia), decimales, (long long)(absoluto % potencia));
+}
+
+
+/***************************************************************************************
+**  Nombre:         int main(int argc, char *argv[])
+**  Descripcion:    Uso: decodificar_blackbox [-l] LOG00001.URP > log.csv
+**                  Por defecto se escriben las tramas rapidas y con -l las lentas. La
+**                  cabecera, los eventos y el resumen van a la salida de errores
+**  Parametros:     Argumentos de la linea de comandos
+**  Retorno:        0 si OK
+****************************************************************************************/
+int main(int argc, char *argv[])
+{
+    bool tramasLentas = false;
+    const char *nombreFichero = NULL;
+
+    for (int i = 1; i < argc; i++) {
+        if (strcmp(argv[i], "-l") == 0)
+            tramasLentas = true;
+        else
+            nombreFichero = argv[i];
+    }
+
+    if (nombreFichero == NULL) {
+        fprintf(stderr, "Uso: %s [-l] fichero.URP > log.csv\n", argv[0]);
+        return 1;
+    }
+
+    FILE *fichero = fopen(nombreFichero, "rb");
+    if (fichero == NULL) {
+        perror(nombreFichero);
+        return 1;
+    }
+
+    fseek(fichero, 0, SEEK_END);
+    const long longitud = ftell(fichero);
+    fseek(fichero, 0, SEEK_SET);
+
+    uint8_t *buf = malloc(longitud > 0 ? (size_t)longitud : 1);
+    if (buf == NULL || fread(buf, 1, (size_t)longitud, fichero) != (size_t)longitud) {
+        fprintf(stderr, "No se ha podido leer %s\n", nombreFichero);
+        fclose(fichero);
+        free(buf);
+        return 1;
+    }
+
+    fclose(fichero);
+
+    lectorDecodificador_t lector = { buf, (size_t)longitud, 0 };
+    tramaDecodificador_t *tramaCSV = tramasLentas ? &tramaLenta : &tramaRapida;
+    bool cabeceraCSVescrita = false;
+    bool finLog = false;
+
+    while (lector.pos < lector.longitud && !finLog) {
+        const size_t inicio = lector.pos;
+        const uint8_t identificador = buf[lector.pos++];
+        bool tramaValida;
+
+        if (identificador == 'C' && lector.pos < lector.longitud && buf[lector.pos] == ' ') {
+            lector.pos = inicio;
+            leerLineaCabeceraDecodificador(&lector);
+            continue;
+        }
+
+        switch (identificador) {
+            case TRAMA_INTRA_BLACKBOX:
+                tramaValida = leerTramaRapidaDecodificador(&lector, &tramaRapida, true);
+                break;
+
+            case TRAMA_PREDICHA_BLACKBOX:
+                // Sin una trama intra previa no hay historia con la que deshacer la prediccion
+                tramaValida = tramaRapida.historiaValida && leerTramaRapidaDecodificador(&lector, &tramaRapida, false);
+                break;
+
+            case TRAMA_LENTA_BLACKBOX:
+                tramaValida = leerTramaLentaDecodificador(&lector, &tramaLenta);
+                break;
+
+            case TRAMA_EVENTO_BLACKBOX:
+                tramaValida = leerEventoDecodificador(&lector, &finLog);
+                break;
+
+            default:
+                tramaValida = false;
+                break;
+        }
+
+        // Si lo que sigue no es el comienzo de otra trama, la trama tambien estaba corrupta
+        if (!tramaValida || (!finLog && !inicioTramaDecodificador(&lector))) {
+            if (identificador == TRAMA_INTRA_BLACKBOX || identificador == TRAMA_PREDICHA_BLACKBOX ||
+                identificador == TRAMA_LENTA_BLACKBOX || identificador == TRAMA_EVENTO_BLACKBOX)
+                estadisticas.tramasCorruptas++;
+
+            // Se busca la siguiente trama un byte mas adelante y se espera a una intra
+            estadisticas.bytesDescartados++;
+            tramaRapida.historiaValida = false;
+            finLog = false;
+            lector.pos = inicio + 1;
+            continue;
+        }
+
+        switch (identificador) {
+            case TRAMA_INTRA_BLACKBOX:
+                estadisticas.tramasIntra++;
+                break;
+
+            case TRAMA_PREDICHA_BLACKBOX:
+                estadisticas.tramasPredichas++;
+                break;
+
+            case TRAMA_LENTA_BLACKBOX:
+                estadisticas.tramasLentas++;
+                break;
+
+            default:
+                estadisticas.eventos++;
+                continue;
+        }
+
+        if ((identificador == TRAMA_LENTA_BLACKBOX) != tramasLentas)
+            continue;
+
+        if (!cabeceraCSVescrita) {
+            escribirCabeceraCSVdecodificador(stdout, tramaCSV);
+            cabeceraCSVescrita = true;
+        }
+
+        escribirTramaCSVdecodificador(stdout, tramaCSV);
+    }
+
+    fprintf(stderr, "Tramas: %u intra, %u predichas, %u lentas, %u eventos | %u corruptas, %u bytes descartados\n",
+            estadisticas.tramasIntra, estadisticas.tramasPredichas, estadisticas.tramasLentas, estadisticas.eventos,
+            estadisticas.tramasCorruptas, estadisticas.bytesDescartados);
+
+    free(buf);
+    return 0;
+}
@@ -0,0 +1,351 @@
+/***************************************************************************************
+**  decodificar_dshot.c - Herramienta del host para la telemetria del dshot bidireccional.
+**                          Decodifica capturas de flancos y prueba el decodificador GCR
+**
+**
+**  Este fichero forma parte del proyecto URpilot.
+**  Codigo desarrollado por el grupo de investigacion ICON de la Universidad de La Rioja
+**
+**  Autor: Ramon Rico
+**  Fecha de creacion: 17/10/2026
+**  Fecha de modificacion: 17/10/2026
+**
+**  El proyecto URpilot NO es libre. No se puede distribuir y/o modificar este fichero
+**  bajo ningun concepto.
+**
+**  En caso de modificacion y/o solicitud de informacion pongase en contacto con
+**  el grupo de investigacion ICON a traves de: www.unirioja.es/urpilot
+**
+**
+**  Control de versiones del fichero
+**
+**  v1.0  Ramon Rico. Se ha liberado la primera version estable
+**
+****************************************************************************************/
+
+/***************************************************************************************
+** AREA DE INCLUDES                                                                   **
+****************************************************************************************/
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "Motores/dshot_telemetria.h"
+
+
+/***************************************************************************************
+** AREA DE PREPROCESADOR                                                              **
+****************************************************************************************/
+#define TICKS_BIT_DEFECTO_HOST                16          // Dshot600 con el timer a 12 MHz
+#define POLOS_DEFECTO_HOST                    14
+#define ERPM_MAX_HOST                         400000
+#define NUM_CAPTURAS_HOST                     100000
+#define TAM_MAX_LINEA_HOST                    1024
+
+
+/***************************************************************************************
+** AREA DE DEFINICION DE TIPOS                                                        **
+****************************************************************************************/
+
+
+/***************************************************************************************
+** AREA DE DECLARACION DE VARIABLES                                                   **
+****************************************************************************************/
+static uint32_t semillaHost = 0x12345678;
+
+static const char *nombreResultadoHost[] = {
+    "ok", "sin_respuesta", "error_trama", "error_gcr", "error_crc"
+};
+
+
+/***************************************************************************************
+** AREA DE PROTOTIPOS DE FUNCION                                                      **
+****************************************************************************************/
+uint32_t aleatorioHost(void);
+uint32_t erpmEsperadasHost(uint32_t eRPM);
+uint8_t capturaAleatoriaHost(uint32_t eRPM, uint16_t ticksBit, uint32_t *flancos);
+bool probarIdaVueltaHost(uint16_t ticksBit);
+bool probarCorrupcionHost(uint16_t ticksBit);
+bool probarCapturasIncompletasHost(uint16_t ticksBit);
+int decodificarFicheroHost(const char *nombreFichero, uint16_t ticksBit, uint8_t numPolos);
+
+
+/***************************************************************************************
+** AREA DE DEFINICION DE FUNCIONES                                                    **
+****************************************************************************************/
+
+/***************************************************************************************
+**  Nombre:         uint32_t aleatorioHost(void)
+**  Descripcion:    Generador xorshift con semilla fija para que las pruebas sean repetibles
+**  Parametros:     Ninguno
+**  Retorno:        Numero aleatorio
+****************************************************************************************/
+uint32_t aleatorioHost(void)
+{
+    semillaHost ^= semillaHost << 13;
+    semillaHost ^= semillaHost >> 17;
+    semillaHost ^= semillaHost << 5;
+    return semillaHost;
+}
+
+
+/***************************************************************************************
+**  Nombre:         uint32_t erpmEsperadasHost(uint32_t eRPM)
+**  Descripcion:    Calcula las eRPM que deben salir tras cuantificar el periodo en la trama
+**  Parametros:     eRPM codificadas
+**  Retorno:        eRPM esperadas
+****************************************************************************************/
+uint32_t erpmEsperadasHost(uint32_t eRPM)
+{
+    if (eRPM == 0)
+        return 0;
+
+    uint32_t periodo = (60000000 + eRPM / 2) / eRPM;
+    uint8_t exponente = 0;
+
+    while (periodo > 0x1FF && exponente < 7) {
+        periodo >>= 1;
+        exponente++;
+    }
+
+    if (periodo > 0x1FF)
+        return 0;
+
+    periodo <<= exponente;
+    return (60000000 + periodo / 2) / periodo;
+}
+
+
+/***************************************************************************************
+**  Nombre:         uint8_t capturaAleatoriaHost(uint32_t eRPM, uint16_t ticksBit, uint32_t *flancos)
+**  Descripcion:    Genera una captura como la del timer: origen aleatorio con desbordamiento a 16 bits
+**                  y fluctuacion de hasta un cuarto de bit en cada flanco
+**  Parametros:     eRPM, ticks por bit, buffer de flancos
+**  Retorno:        Numero de flancos
+****************************************************************************************/
+uint8_t capturaAleatoriaHost(uint32_t eRPM, uint16_t ticksBit, uint32_t *flancos)
+{
+    const uint32_t inicio = aleatorioHost() & 0xFFFF;
+    const uint8_t numFlancos = codificarFlancosDshot(eRPM, ticksBit, inicio, flancos);
+    const int32_t fluctuacion = ticksBit / 4;
+
+    for (uint8_t i = 0; i < numFlancos; i++) {
+        const int32_t desvio = fluctuacion > 0 ? (int32_t)(aleatorioHost() % (2 * fluctuacion)) - fluctuacion + 1 : 0;
+        flancos[i] = (flancos[i] + desvio) & 0xFFFF;
+    }
+
+    return numFlancos;
+}
+
+
+/***************************************************************************************
+**  Nombre:         bool probarIdaVueltaHost(uint16_t ticksBit)
+**  Descripcion:    Codifica y decodifica todo el rango de eRPM, incluido el motor parado
+**  Parametros:     Ticks por bit
+**  Retorno:        True si OK
+****************************************************************************************/
+bool probarIdaVueltaHost(uint16_t ticksBit)
+{
+    uint32_t flancos[TAM_BUFFER_CAPTURA_DSHOT];
+    uint32_t numErrores = 0;
+    uint32_t errorMax = 0;
+
+    for (uint32_t i = 0; i < NUM_CAPTURAS_HOST; i++) {
+        const uint32_t eRPM = i == 0 ? 0 : aleatorioHost() % ERPM_MAX_HOST;
+        const uint8_t numFlancos = capturaAleatoriaHost(eRPM, ticksBit, flancos);
+        const uint32_t esperadas = erpmEsperadasHost(eRPM);
+        uint32_t decodificadas;
+
+        if (decodificarFlancosDshot(flancos, numFlancos, ticksBit, &decodificadas) != TELEMETRIA_DSHOT_OK ||
+            decodificadas != esperadas) {
+            numErrores++;
+            continue;
+        }
+
+        const uint32_t error = decodificadas > eRPM ? decodificadas - eRPM : eRPM - decodificadas;
+        if (esperadas != 0 && error * 1000 / eRPM > errorMax)
+            errorMax = error * 1000 / eRPM;
+    }
+
+    printf("  Ida y vuelta: capturas %u, errores %u, cuantificacion max %.1f %%\n", NUM_CAPTURAS_HOST, numErrores, errorMax / 10.0f);
+    return numErrores == 0;
+}
+
+
+/***************************************************************************************
+**  Nombre:         bool probarCorrupcionHost(uint16_t ticksBit)
+**  Descripcion:    Corrompe las capturas moviendo, quitando o anadiendo un flanco. Se cuentan las
+**                  que el GCR y el checksum no detectan
+**  Parametros:     Ticks por bit
+**  Retorno:        True si OK
+****************************************************************************************/
+bool probarCorrupcionHost(uint16_t ticksBit)
+{
+    uint32_t resultados[TELEMETRIA_DSHOT_ERROR_CRC + 1] = { 0 };
+    uint32_t numNoDetectadas = 0;
+
+    for (uint32_t i = 0; i < NUM_CAPTURAS_HOST; i++) {
+        uint32_t flancos[TAM_BUFFER_CAPTURA_DSHOT];
+        const uint32_t eRPM = 1000 + aleatorioHost() % ERPM_MAX_HOST;
+        uint8_t numFlancos = capturaAleatoriaHost(eRPM, ticksBit, flancos);
+        const uint8_t flanco = 1 + aleatorioHost() % (numFlancos - 1);
+
+        switch (i % 3) {
+            case 0:
+                // Un flanco desplazado un bit
+                flancos[flanco] += (aleatorioHost() & 1) ? ticksBit : -ticksBit;
+                break;
+
+            case 1:
+                memmove(&flancos[flanco], &flancos[flanco + 1], (numFlancos - flanco - 1) * sizeof(uint32_t));
+                numFlancos--;
+                break;
+
+            default:
+                memmove(&flancos[flanco + 1], &flancos[flanco], (numFlancos - flanco) * sizeof(uint32_t));
+                flancos[flanco] = flancos[flanco - 1] + ticksBit;
+                numFlancos++;
+                break;
+        }
+
+        uint32_t decodificadas;
+        const resultadoTelemetriaDshot_e resultado = decodificarFlancosDshot(flancos, numFlancos, ticksBit, &decodificadas);
+
+        resultados[resultado]++;
+        if (resultado == TELEMETRIA_DSHOT_OK && decodificadas != erpmEsperadasHost(eRPM))
+            numNoDetectadas++;
+    }
+
+    printf("  Corrupcion: capturas %u, error trama %u, error GCR %u, error CRC %u, no detectadas %u (%.2f %%)\n",
+           NUM_CAPTURAS_HOST, resultados[TELEMETRIA_DSHOT_ERROR_TRAMA], resultados[TELEMETRIA_DSHOT_ERROR_GCR],
+           resultados[TELEMETRIA_DSHOT_ERROR_CRC], numNoDetectadas, 100.0f * numNoDetectadas / NUM_CAPTURAS_HOST);
+
+    // El checksum es de 4 bits, asi que alguna corrupcion pasa. Debe ser una fraccion pequena
+    return numNoDetectadas * 50 < NUM_CAPTURAS_HOST;
+}
+
+
+/***************************************************************************************
+**  Nombre:         bool probarCapturasIncompletasHost(uint16_t ticksBit)
+**  Descripcion:    Capturas vacias, cortadas o con pulsos demasiado estrechos
+**  Parametros:     Ticks por bit
+**  Retorno:        True si OK
+****************************************************************************************/
+bool probarCapturasIncompletasHost(uint16_t ticksBit)
+{
+    uint32_t flancos[TAM_BUFFER_CAPTURA_DSHOT] = { 0 };
+    uint32_t eRPM;
+    bool ok = true;
+
+    ok = ok && decodificarFlancosDshot(flancos, 0, ticksBit, &eRPM) == TELEMETRIA_DSHOT_SIN_RESPUESTA;
+
+    const uint8_t numFlancos = codificarFlancosDshot(30000, ticksBit, 0, flancos);
+    ok = ok && decodificarFlancosDshot(flancos, numFlancos / 2, ticksBit, &eRPM) == TELEMETRIA_DSHOT_ERROR_TRAMA;
+
+    flancos[1] = flancos[0] + ticksBit / 4;
+    ok = ok && decodificarFlancosDshot(flancos, numFlancos, ticksBit, &eRPM) == TELEMETRIA_DSHOT_ERROR_TRAMA;
+
+    printf("  Capturas incompletas: %s\n", ok ? "ok" : "mal");
+    return ok;
+}
+
+
+/***************************************************************************************
+**  Nombre:         int decodificarFicheroHost(const char *nombreFichero, uint16_t ticksBit, uint8_t numPolos)
+**  Descripcion:    Decodifica un fichero con una captura por linea. Cada captura son los valores del
+**                  registro de captura del timer separados por espacios o comas
+**  Parametros:     Fichero ("-" para la entrada estandar), ticks por bit, numero de polos
+**  Retorno:        0 si OK
+****************************************************************************************/
+int decodificarFicheroHost(const char *nombreFichero, uint16_t ticksBit, uint8_t numPolos)
+{
+    telemetriaDshot_t telemetria;
+    char linea[TAM_MAX_LINEA_HOST];
+    uint32_t numCaptura = 0;
+
+    FILE *fichero = strcmp(nombreFichero, "-") == 0 ? stdin : fopen(nombreFichero, "r");
+    if (fichero == NULL) {
+        perror(nombreFichero);
+        return 1;
+    }
+
+    memset(&telemetria, 0, sizeof(telemetria));
+    printf("captura,resultado,erpm,rpm,hz\n");
+
+    while (fgets(linea, sizeof(linea), fichero) != NULL) {
+        uint32_t flancos[TAM_BUFFER_CAPTURA_DSHOT];
+        uint8_t numFlancos = 0;
+        char *cursor = linea;
+        char *fin;
+
+        if (linea[0] == '#')
+            continue;
+
+        while (numFlancos < TAM_BUFFER_CAPTURA_DSHOT) {
+            const unsigned long valor = strtoul(cursor, &fin, 0);
+            if (fin == cursor)
+                break;
+
+            flancos[numFlancos++] = valor;
+            cursor = fin + strspn(fin, " ,;\t");
+        }
+
+        const resultadoTelemetriaDshot_e resultado = actualizarTelemetriaDshot(&telemetria, flancos, numFlancos, ticksBit, numCaptura);
+        const uint32_t eRPM = resultado == TELEMETRIA_DSHOT_OK ? telemetria.eRPM : 0;
+        const float frec = resultado == TELEMETRIA_DSHOT_OK ? frecTelemetriaDshot(&telemetria, numPolos) : 0.0f;
+
+        printf("%u,%s,%u,%.0f,%.1f\n", numCaptura++, nombreResultadoHost[resultado], eRPM, frec * 60.0f, frec);
+    }
+
+    if (fichero != stdin)
+        fclose(fichero);
+
+    fprintf(stderr, "Capturas %u, validas %u, sin respuesta %u, error trama %u, error GCR %u, error CRC %u\n", numCaptura,
+            telemetria.numTramas, telemetria.numSinRespuesta, telemetria.numErroresTrama, telemetria.numErroresGCR,
+            telemetria.numErroresCRC);
+    return 0;
+}
+
+
+/***************************************************************************************
+**  Nombre:         int main(int argc, char *argv[])
+**  Descripcion:    Uso: decodificar_dshot -t
+**                       decodificar_dshot [-b ticksBit] [-p polos] capturas.txt > rpm.csv
+**  Parametros:     Argumentos de la linea de comandos
+**  Retorno:        0 si OK
+****************************************************************************************/
+int main(int argc, char *argv[])
+{
+    const char *nombreFichero = NULL;
+    uint16_t ticksBit = TICKS_BIT_DEFECTO_HOST;
+    uint8_t numPolos = POLOS_DEFECTO_HOST;
+    bool prueba = false;
+
+    for (int i = 1; i < argc; i++) {
+        if (strcmp(argv[i], "-t") == 0)
+            prueba = true;
+        else if (strcmp(argv[i], "-b") == 0 && i + 1 < argc)
+            ticksBit = atoi(argv[++i]);
+        else if (strcmp(argv[i], "-p") == 0 && i + 1 < argc)
+            numPolos = atoi(argv[++i]);
+        else
+            nombreFichero = argv[i];
+    }
+
+    if (prueba) {
+        printf("Prueba del decodificador de telemetria dshot (%u ticks por bit)\n", ticksBit);
+        const bool idaVueltaOk = probarIdaVueltaHost(ticksBit);
+        const bool corrupcionOk = probarCorrupcionHost(ticksBit);
+        const bool incompletasOk = probarCapturasIncompletasHost(ticksBit);
+        printf("  Resultado: %s\n", idaVueltaOk && corrupcionOk && incompletasOk ? "ok" : "mal");
+        return idaVueltaOk && corrupcionOk && incompletasOk ? 0 : 1;
+    }
+
+    if (nombreFichero == NULL || ticksBit == 0) {
+        fprintf(stderr, "Uso: %s -t [-b ticksBit]\n", argv[0]);
+        fprintf(stderr, "     %s [-b ticksBit] [-p polos] capturas.txt|- > rpm.csv\n", argv[0]);
+        return 1;
+    }
+
+    return decodificarFicheroHost(nombreFichero, ticksBit, numPolos);
+}
@@ -0,0 +1,489 @@
+/***************************************************************************************
+**  cliente_parametros.c - Cliente del protocolo de parametros. Descarga las descripciones
+**                         de los GP del FC y lee, escribe y guarda parametros por nombre
+**                         sobre cualquier transporte
+**
+**
+**  Este fichero forma parte del proyecto URpilot.
+**  Codigo desarrollado por el grupo de investigacion ICON de la Universidad de La Rioja
+**
+**  Autor: Ramon Rico
+**  Fecha de creacion: 17/10/2026
+**  Fecha de modificacion: 17/10/2026
+**
+**  El proyecto URpilot NO es libre. No se puede distribuir y/o modificar este fichero
+**  bajo ningun concepto.
+**
+**  En caso de modificacion y/o solicitud de informacion pongase en contacto con
+**  el grupo de investigacion ICON a traves de: www.unirioja.es/urpilot
+**
+**
+**  Control de versiones del fichero
+**
+**  v1.0  Ramon Rico. Se ha liberado la primera version estable
+**
+****************************************************************************************/
+
+/***************************************************************************************
+** AREA DE INCLUDES                                                                   **
+****************************************************************************************/
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+
+#include "cliente_parametros.h"
+
+
+/***************************************************************************************
+** AREA DE PREPROCESADOR                                                              **
+****************************************************************************************/
+#define INTENTOS_CLIENTE                      3
+#define TIMEOUT_CLIENTE_MS                    300         // Por intento
+#define TIMEOUT_GUARDAR_CLIENTE_MS            3000        // El borrado de un sector de la flash tarda hasta 2 s
+#define PASO_ESPERA_CLIENTE_MS                10
+#define TAM_BUFFER_RX_CLIENTE                 256
+
+
+/***************************************************************************************
+** AREA DE DEFINICION DE TIPOS                                                        **
+****************************************************************************************/
+
+
+/***************************************************************************************
+** AREA DE DECLARACION DE VARIABLES                                                   **
+****************************************************************************************/
+
+
+/***************************************************************************************
+** AREA DE PROTOTIPOS DE FUNCION                                                      **
+****************************************************************************************/
+bool peticionCliente(clienteParametros_t *cliente, uint8_t idPeticion, const void *peticion, uint8_t idRespuesta,
+                     const uint8_t *clave, uint8_t tamClave, void *respuesta, uint32_t timeoutMs);
+uint32_t mascaraCampoCliente(const campoCliente_t *campo);
+
+
+/***************************************************************************************
+** AREA DE DEFINICION DE FUNCIONES                                                    **
+****************************************************************************************/
+
+/***************************************************************************************
+**  Nombre:         void iniciarClienteParametros(clienteParametros_t *cliente,
+**                                                const transporteParametros_t *transporte)
+**  Descripcion:    Inicia el cliente sin descripciones
+**  Parametros:     Cliente, transporte
+**  Retorno:        Ninguno
+****************************************************************************************/
+void iniciarClienteParametros(clienteParametros_t *cliente, const transporteParametros_t *transporte)
+{
+    memset(cliente, 0, sizeof(*cliente));
+    cliente->transporte = *transporte;
+    iniciarDecodificadorTelemetria(&cliente->decodificador);
+}
+
+
+/***************************************************************************************
+**  Nombre:         bool peticionCliente(clienteParametros_t *cliente, uint8_t idPeticion, const void *peticion,
+**                                       uint8_t idRespuesta, const uint8_t *clave, uint8_t tamClave,
+**                                       void *respuesta, uint32_t timeoutMs)
+**  Descripcion:    Envia una peticion y espera su respuesta. La respuesta empieza por los
+**                  mismos bytes que identifican la peticion (clave). El resto de tramas,
+**                  como la telemetria suscrita, se ignoran
+**  Parametros:     Cliente, identificador y estructura de la peticion, identificador de la
+**                  respuesta, clave, tamanio de la clave, estructura de la respuesta, espera
+**                  maxima de cada intento en ms
+**  Retorno:        False si se agotan los intentos o falla el transporte
+****************************************************************************************/
+bool peticionCliente(clienteParametros_t *cliente, uint8_t idPeticion, const void *peticion, uint8_t idRespuesta,
+                     const uint8_t *clave, uint8_t tamClave, void *respuesta, uint32_t timeoutMs)
+{
+    transporteParametros_t *transporte = &cliente->transporte;
+    decodificadorTelemetria_t *decodificador = &cliente->decodificador;
+    uint8_t trama[TAM_MAX_TRAMA_TELEMETRIA];
+    uint8_t buffer[TAM_BUFFER_RX_CLIENTE];
+
+    const uint8_t longitud = codificarTramaTelemetria(trama, idPeticion, cliente->secuencia++, peticion);
+    if (longitud == 0)
+        return false;
+
+    cliente->peticiones++;
+    for (uint8_t intento = 0; intento < INTENTOS_CLIENTE; intento++) {
+        if (intento > 0)
+            cliente->reintentos++;
+
+        if (!transporte->enviar(transporte->contexto, trama, longitud))
+            return false;
+
+        for (uint32_t espera = 0; espera < timeoutMs; espera += PASO_ESPERA_CLIENTE_MS) {
+            const int32_t numBytes = transporte->recibir(transporte->contexto, buffer, sizeof(buffer), PASO_ESPERA_CLIENTE_MS);
+            if (numBytes < 0)
+                return false;
+
+            for (int32_t i = 0; i < numBytes; i++) {
+                if (!procesarByteTelemetria(decodificador, buffer[i]))
+                    continue;
+
+                if (decodificador->id == idRespuesta && decodificador->longitud >= tamClave &&
+                    memcmp(decodificador->payload, clave, tamClave) == 0)
+                    return decodificarMensajeTelemetria(decodificador->id, decodificador->payload, decodificador->longitud, respuesta);
+            }
+        }
+    }
+
+    return false;
+}
+
+
+/***************************************************************************************
+**  Nombre:         bool descargarDescripcionesCliente(clienteParametros_t *cliente)
+**  Descripcion:    Pide al FC la descripcion de todos sus grupos y campos. Los comandos del
+**                  cliente se construyen a partir de ellas
+**  Parametros:     Cliente
+**  Retorno:        True si se han descargado todas
+****************************************************************************************/
+bool descargarDescripcionesCliente(clienteParametros_t *cliente)
+{
+    uint8_t numGrupos = 1;
+
+    cliente->numGrupos = 0;
+    for (uint8_t i = 0; i < numGrupos; i++) {
+        const mensajePedirGrupoTelemetria_t pedirGrupo = { .grupo = i };
+        mensajeGrupoTelemetria_t respuestaGrupo;
+
+        if (!peticionCliente(cliente, MENSAJE_TELEMETRIA_PEDIR_GRUPO, &pedirGrupo, MENSAJE_TELEMETRIA_GRUPO, &pedirGrupo.grupo, 1,
+                             &respuestaGrupo, TIMEOUT_CLIENTE_MS))
+            return false;
+
+        // Un FC sin descripciones responde al grupo 0 que no existe
+        if (respuestaGrupo.numGrupos == 0)
+            return true;
+
+        if (respuestaGrupo.resultado != PARAMETRO_OK_TELEMETRIA)
+            return false;
+
+        numGrupos = respuestaGrupo.numGrupos < NUM_MAX_GRUPOS_CLIENTE ? respuestaGrupo.numGrupos : NUM_MAX_GRUPOS_CLIENTE;
+
+        grupoCliente_t *grupo = &cliente->grupos[i];
+        snprintf(grupo->nombre, sizeof(grupo->nombre), "%.*s", (int)sizeof(respuestaGrupo.nombre) - 1, respuestaGrupo.nombre);
+        grupo->gpn = respuestaGrupo.gpn;
+        grupo->version = respuestaGrupo.version;
+        grupo->tam = respuestaGrupo.tam;
+        grupo->numCampos = respuestaGrupo.numCampos < NUM_MAX_CAMPOS_CLIENTE ? respuestaGrupo.numCampos : NUM_MAX_CAMPOS_CLIENTE;
+
+        for (uint8_t j = 0; j < grupo->numCampos; j++) {
+            const mensajePedirCampoTelemetria_t pedirCampo = { .grupo = i, .campo = j };
+            const uint8_t clave[] = { i, j };
+            mensajeCampoTelemetria_t respuestaCampo;
+
+            if (!peticionCliente(cliente, MENSAJE_TELEMETRIA_PEDIR_CAMPO, &pedirCampo, MENSAJE_TELEMETRIA_CAMPO, clave, sizeof(clave),
+                                 &respuestaCampo, TIMEOUT_CLIENTE_MS) || respuestaCampo.resultado != PARAMETRO_OK_TELEMETRIA)
+                return false;
+
+            campoCliente_t *campo = &grupo->campos[j];
+            snprintf(campo->nombre, sizeof(campo->nombre), "%.*s", (int)sizeof(respuestaCampo.nombre) - 1, respuestaCampo.nombre);
+            campo->tipo = respuestaCampo.tipo;
+            campo->tam = respuestaCampo.tam;
+            campo->numElementos = respuestaCampo.numElementos;
+            campo->min = respuestaCampo.min;
+            campo->max = respuestaCampo.max;
+        }
+
+        cliente->numGrupos = i + 1;
+    }
+
+    return true;
+}
+
+
+/***************************************************************************************
+**  Nombre:         bool buscarParametroCliente(const clienteParametros_t *cliente, const char *nombre,
+**                                              parametroCliente_t *parametro, bool *conIndice)
+**  Descripcion:    Busca un parametro con la forma grupo.campo o grupo.campo[elemento]
+**  Parametros:     Cliente, nombre, parametro encontrado, si el nombre lleva elemento
+**  Retorno:        False si no existe
+****************************************************************************************/
+bool buscarParametroCliente(const clienteParametros_t *cliente, const char *nombre, parametroCliente_t *parametro, bool *conIndice)
+{
+    const char *punto = strchr(nombre, '.');
+    unsigned elemento = 0;
+
+    if (punto == NULL)
+        return false;
+
+    const char *nombreCampo = punto + 1;
+    const char *corchete = strchr(nombreCampo, '[');
+    const size_t tamGrupo = punto - nombre;
+    const size_t tamCampo = corchete != NULL ? (size_t)(corchete - nombreCampo) : strlen(nombreCampo);
+
+    *conIndice = corchete != NULL;
+    if (corchete != NULL) {
+        int numLeidos = 0;
+
+        if (sscanf(corchete, "[%u]%n", &elemento, &numLeidos) != 1 || numLeidos == 0 || corchete[numLeidos] != '\0')
+            return false;
+    }
+
+    for (uint8_t i = 0; i < cliente->numGrupos; i++) {
+        const grupoCliente_t *grupo = &cliente->grupos[i];
+
+        if (strlen(grupo->nombre) != tamGrupo || strncmp(grupo->nombre, nombre, tamGrupo) != 0)
+            continue;
+
+        for (uint8_t j = 0; j < grupo->numCampos; j++) {
+            const campoCliente_t *campo = &grupo->campos[j];
+
+            if (strlen(campo->nombre) != tamCampo || strncmp(campo->nombre, nombreCampo, tamCampo) != 0)
+                continue;
+
+            if (elemento >= campo->numElementos)
+                return false;
+
+            parametro->grupo = i;
+            parametro->campo = j;
+            parametro->elemento = (uint8_t)elemento;
+            return true;
+        }
+    }
+
+    return false;
+}
+
+
+/***************************************************************************************
+**  Nombre:         const campoCliente_t *campoParametroCliente(const clienteParametros_t *cliente,
+**                                                              const parametroCliente_t *parametro)
+**  Descripcion:    Devuelve la descripcion del campo de un parametro
+**  Parametros:     Cliente, parametro
+**  Retorno:        Campo
+****************************************************************************************/
+const campoCliente_t *campoParametroCliente(const clienteParametros_t *cliente, const parametroCliente_t *parametro)
+{
+    return &cliente->grupos[parametro->grupo].campos[parametro->campo];
+}
+
+
+/***************************************************************************************
+**  Nombre:         void nombreParametroCliente(const clienteParametros_t *cliente, const parametroCliente_t *parametro,
+**                                              char *nombre, size_t tam)
+**  Descripcion:    Escribe el nombre completo de un parametro. Solo los campos con varios
+**                  elementos llevan indice
+**  Parametros:     Cliente, parametro, buffer, tamanio del buffer
+**  Retorno:        Ninguno
+****************************************************************************************/
+void nombreParametroCliente(const clienteParametros_t *cliente, const parametroCliente_t *parametro, char *nombre, size_t tam)
+{
+    const campoCliente_t *campo = campoParametroCliente(cliente, parametro);
+
+    if (campo->numElementos > 1)
+        snprintf(nombre, tam, "%s.%s[%u]", cliente->grupos[parametro->grupo].nombre, campo->nombre, parametro->elemento);
+    else
+        snprintf(nombre, tam, "%s.%s", cliente->grupos[parametro->grupo].nombre, campo->nombre);
+}
+
+
+/***************************************************************************************
+**  Nombre:         uint32_t mascaraCampoCliente(const campoCliente_t *campo)
+**  Descripcion:    Devuelve la mascara de los bytes que ocupa un elemento del campo
+**  Parametros:     Campo
+**  Retorno:        Mascara
+****************************************************************************************/
+uint32_t mascaraCampoCliente(const campoCliente_t *campo)
+{
+    if (campo->tam >= sizeof(uint32_t))
+        return UINT32_MAX;
+
+    return (1UL << (8 * campo->tam)) - 1;
+}
+
+
+/***************************************************************************************
+**  Nombre:         bool textoAvalorCliente(const campoCliente_t *campo, const char *texto, uint32_t *valor)
+**  Descripcion:    Convierte un texto al valor de un campo comprobando su rango. El FC lo
+**                  vuelve a comprobar al escribirlo
+**  Parametros:     Campo, texto, valor en los bytes bajos
+**  Retorno:        False si el texto no es valido o esta fuera de rango
+****************************************************************************************/
+bool textoAvalorCliente(const campoCliente_t *campo, const char *texto, uint32_t *valor)
+{
+    char *fin;
+
+    switch (campo->tipo) {
+        case PARAMETRO_BOOL_TELEMETRIA:
+            if (strcmp(texto, "1") == 0 || strcmp(texto, "true") == 0)
+                *valor = 1;
+            else if (strcmp(texto, "0") == 0 || strcmp(texto, "false") == 0)
+                *valor = 0;
+            else
+                return false;
+
+            return true;
+
+        case PARAMETRO_REAL_TELEMETRIA: {
+            const float real = strtof(texto, &fin);
+            if (fin == texto || *fin != '\0' || !isfinite(real) || real < campo->min || real > campo->max)
+                return false;
+
+            memcpy(valor, &real, sizeof(*valor));
+            return true;
+        }
+
+        case PARAMETRO_ENTERO_TELEMETRIA: {
+            const long entero = strtol(texto, &fin, 0);
+            if (fin == texto || *fin != '\0' || entero < campo->min || entero > campo->max)
+                return false;
+
+            *valor = (uint32_t)entero & mascaraCampoCliente(campo);
+            return true;
+        }
+
+        default: {
+            if (strchr(texto, '-') != NULL)
+                return false;
+
+            const unsigned long natural = strtoul(texto, &fin, 0);
+            if (fin == texto || *fin != '\0' || natural < campo->min || natural > campo->max || natural > mascaraCampoCliente(campo))
+                return false;
+
+            *valor = (uint32_t)natural;
+            return true;
+        }
+    }
+}
+
+
+/***************************************************************************************
+**  Nombre:         void valorAtextoCliente(const campoCliente_t *campo, uint32_t valor, char *texto, size_t tam)
+**  Descripcion:    Convierte el valor de un campo a texto
+**  Parametros:     Campo, valor en los bytes bajos, buffer, tamanio del buffer
+**  Retorno:        Ninguno
+****************************************************************************************/
+void valorAtextoCliente(const campoCliente_t *campo, uint32_t valor, char *texto, size_t tam)
+{
+    switch (campo->tipo) {
+        case PARAMETRO_REAL_TELEMETRIA: {
+            float real;
+            memcpy(&real, &valor, sizeof(real));
+            snprintf(texto, tam, "%g", real);
+            break;
+        }
+
+        case PARAMETRO_ENTERO_TELEMETRIA: {
+            // Extension del signo desde el tamanio del campo
+            const uint32_t signo = 1UL << (8 * campo->tam - 1);
+            snprintf(texto, tam, "%d", (int32_t)((valor ^ signo) - signo));
+            break;
+        }
+
+        default:
+            snprintf(texto, tam, "%u", valor);
+            break;
+    }
+}
+
+
+/***************************************************************************************
+**  Nombre:         const char *textoResultadoCliente(uint8_t resultado)
+**  Descripcion:    Describe el resultado de una peticion
+**  Parametros:     Resultado
+**  Retorno:        Texto
+****************************************************************************************/
+const char *textoResultadoCliente(uint8_t resultado)
+{
+    switch (resultado) {
+        case PARAMETRO_OK_TELEMETRIA:
+            return "ok";
+
+        case PARAMETRO_GRUPO_NO_EXISTE_TELEMETRIA:
+            return "el grupo no existe";
+
+        case PARAMETRO_CAMPO_NO_EXISTE_TELEMETRIA:
+            return "el campo no existe";
+
+        case PARAMETRO_FUERA_DE_RANGO_TELEMETRIA:
+            return "fuera de rango";
+
+        case PARAMETRO_MOTORES_ENCENDIDOS_TELEMETRIA:
+            return "motores encendidos";
+
+        case PARAMETRO_SIN_DEFECTO_TELEMETRIA:
+            return "sin valor por defecto";
+
+        case PARAMETRO_FALLO_FLASH_TELEMETRIA:
+            return "fallo al guardar en la flash";
+
+        case PARAMETRO_SIN_CONFIRMAR_TELEMETRIA:
+            return "guardado sin confirmar";
+
+        case SIN_RESPUESTA_CLIENTE:
+            return "sin respuesta del FC";
+
+        default:
+            return "resultado desconocido";
+    }
+}
+
+
+/***************************************************************************************
+**  Nombre:         uint8_t leerParametroCliente(clienteParametros_t *cliente, const parametroCliente_t *parametro,
+**                                               uint32_t *valor, uint32_t *defecto)
+**  Descripcion:    Lee el valor actual y el valor por defecto de un parametro
+**  Parametros:     Cliente, parametro, valor, valor por defecto
+**  Retorno:        Resultado del FC o SIN_RESPUESTA_CLIENTE
+****************************************************************************************/
+uint8_t leerParametroCliente(clienteParametros_t *cliente, const parametroCliente_t *parametro, uint32_t *valor, uint32_t *defecto)
+{
+    const mensajeLeerParametroTelemetria_t leer = { parametro->grupo, parametro->campo, parametro->elemento };
+    const uint8_t clave[] = { parametro->grupo, parametro->campo, parametro->elemento };
+    mensajeValorParametroTelemetria_t respuesta;
+
+    if (!peticionCliente(cliente, MENSAJE_TELEMETRIA_LEER_PARAMETRO, &leer, MENSAJE_TELEMETRIA_VALOR_PARAMETRO, clave, sizeof(clave),
+                         &respuesta, TIMEOUT_CLIENTE_MS))
+        return SIN_RESPUESTA_CLIENTE;
+
+    *valor = respuesta.valor;
+    *defecto = respuesta.defecto;
+    return respuesta.resultado;
+}
+
+
+/***************************************************************************************
+**  Nombre:         uint8_t escribirParametroCliente(clienteParametros_t *cliente, const parametroCliente_t *parametro,
+**                                                   uint32_t valor, uint32_t *valorFinal)
+**  Descripcion:    Escribe un parametro en la RAM del FC
+**  Parametros:     Cliente, parametro, valor, valor que queda en el FC
+**  Retorno:        Resultado del FC o SIN_RESPUESTA_CLIENTE
+****************************************************************************************/
+uint8_t escribirParametroCliente(clienteParametros_t *cliente, const parametroCliente_t *parametro, uint32_t valor,
+                                 uint32_t *valorFinal)
+{
+    const mensajeEscribirParametroTelemetria_t escribir = { parametro->grupo, parametro->campo, parametro->elemento, valor };
+    const uint8_t clave[] = { parametro->grupo, parametro->campo, parametro->elemento };
+    mensajeValorParametroTelemetria_t respuesta;
+
+    if (!peticionCliente(cliente, MENSAJE_TELEMETRIA_ESCRIBIR_PARAMETRO, &escribir, MENSAJE_TELEMETRIA_VALOR_PARAMETRO, clave,
+                         sizeof(clave), &respuesta, TIMEOUT_CLIENTE_MS))
+        return SIN_RESPUESTA_CLIENTE;
+
+    *valorFinal = respuesta.valor;
+    return respuesta.resultado;
+}
+
+
+/***************************************************************************************
+**  Nombre:         uint8_t guardarParametrosCliente(clienteParametros_t *cliente)
+**  Descripcion:    Pide al FC que guarde los parametros en la flash
+**  Parametros:     Cliente
+**  Retorno:        Resultado del FC o SIN_RESPUESTA_CLIENTE
+****************************************************************************************/
+uint8_t guardarParametrosCliente(clienteParametros_t *cliente)
+{
+    const mensajeGuardarParametrosTelemetria_t guardar = { .confirmacion = CONFIRMACION_GUARDAR_TELEMETRIA };
+    const uint8_t clave[] = { MENSAJE_TELEMETRIA_GUARDAR_PARAMETROS };
+    mensajeResultadoTelemetria_t respuesta;
+
+    if (!peticionCliente(cliente, MENSAJE_TELEMETRIA_GUARDAR_PARAMETROS, &guardar, MENSAJE_TELEMETRIA_RESULTADO, clave, sizeof(clave),
+                         &respuesta, TIMEOUT_GUARDAR_CLIENTE_MS))
+        return SIN_RESPUESTA_CLIENTE;
+
+    return respuesta.resultado;
+}
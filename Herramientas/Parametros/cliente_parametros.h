@@ -0,0 +1,121 @@
+/***************************************************************************************
+**  cliente_parametros.h - Cliente del protocolo de parametros. Descarga las descripciones
+**                         de los GP del FC y lee, escribe y guarda parametros por nombre
+**                         sobre cualquier transporte
+**
+**
+**  Este fichero forma parte del proyecto URpilot.
+**  Codigo desarrollado por el grupo de investigacion ICON de la Universidad de La Rioja
+**
+**  Autor: Ramon Rico
+**  Fecha de creacion: 17/10/2026
+**  Fecha de modificacion: 17/10/2026
+**
+**  El proyecto URpilot NO es libre. No se puede distribuir y/o modificar este fichero
+**  bajo ningun concepto.
+**
+**  En caso de modificacion y/o solicitud de informacion pongase en contacto con
+**  el grupo de investigacion ICON a traves de: www.unirioja.es/urpilot
+**
+**
+**  Control de versiones del fichero
+**
+**  v1.0  Ramon Rico. Se ha liberado la primera version estable
+**
+****************************************************************************************/
+
+#ifndef __CLIENTE_PARAMETROS_H
+#define __CLIENTE_PARAMETROS_H
+
+/***************************************************************************************
+** AREA DE INCLUDES                                                                   **
+****************************************************************************************/
+#include <stdint.h>
+#include <stdbool.h>
+#include <stddef.h>
+
+#include "Telemetria/protocolo_telemetria.h"
+
+
+/***************************************************************************************
+** AREA DE PREPROCESADOR                                                              **
+****************************************************************************************/
+#define NUM_MAX_GRUPOS_CLIENTE                32
+#define NUM_MAX_CAMPOS_CLIENTE                48
+#define TAM_MAX_NOMBRE_PARAMETRO_CLIENTE      (TAM_NOMBRE_GRUPO_TELEMETRIA + TAM_NOMBRE_CAMPO_TELEMETRIA + 8)
+
+#define SIN_RESPUESTA_CLIENTE                 0xFF        // Resultado cuando se agotan los intentos
+
+
+/***************************************************************************************
+** AREA DE DEFINICION DE TIPOS                                                        **
+****************************************************************************************/
+// El transporte entrega bytes en crudo. recibir espera como mucho esperaMs y devuelve los
+// bytes leidos, 0 si no ha llegado nada o -1 si el transporte ha fallado
+typedef struct {
+    void *contexto;
+    bool (*enviar)(void *contexto, const uint8_t *datos, uint32_t longitud);
+    int32_t (*recibir)(void *contexto, uint8_t *datos, uint32_t longitud, uint32_t esperaMs);
+} transporteParametros_t;
+
+typedef struct {
+    char nombre[TAM_NOMBRE_CAMPO_TELEMETRIA];
+    tipoParametroTelemetria_e tipo;
+    uint8_t tam;
+    uint8_t numElementos;
+    float min;
+    float max;
+} campoCliente_t;
+
+typedef struct {
+    char nombre[TAM_NOMBRE_GRUPO_TELEMETRIA];
+    uint16_t gpn;
+    uint8_t version;
+    uint16_t tam;
+    uint8_t numCampos;
+    campoCliente_t campos[NUM_MAX_CAMPOS_CLIENTE];
+} grupoCliente_t;
+
+// Posicion de un parametro en las descripciones del FC
+typedef struct {
+    uint8_t grupo;
+    uint8_t campo;
+    uint8_t elemento;
+} parametroCliente_t;
+
+typedef struct {
+    transporteParametros_t transporte;
+    decodificadorTelemetria_t decodificador;
+    uint8_t secuencia;
+    uint8_t numGrupos;
+    grupoCliente_t grupos[NUM_MAX_GRUPOS_CLIENTE];
+    uint32_t peticiones;
+    uint32_t reintentos;
+} clienteParametros_t;
+
+
+/***************************************************************************************
+** AREA DE DECLARACION DE VARIABLES                                                   **
+****************************************************************************************/
+
+
+/***************************************************************************************
+** AREA DE PROTOTIPOS DE FUNCION                                                      **
+****************************************************************************************/
+void iniciarClienteParametros(clienteParametros_t *cliente, const transporteParametros_t *transporte);
+bool descargarDescripcionesCliente(clienteParametros_t *cliente);
+
+bool buscarParametroCliente(const clienteParametros_t *cliente, const char *nombre, parametroCliente_t *parametro, bool *conIndice);
+const campoCliente_t *campoParametroCliente(const clienteParametros_t *cliente, const parametroCliente_t *parametro);
+void nombreParametroCliente(const clienteParametros_t *cliente, const parametroCliente_t *parametro, char *nombre, size_t tam);
+
+bool textoAvalorCliente(const campoCliente_t *campo, const char *texto, uint32_t *valor);
+void valorAtextoCliente(const campoCliente_t *campo, uint32_t valor, char *texto, size_t tam);
+const char *textoResultadoCliente(uint8_t resultado);
+
+uint8_t leerParametroCliente(clienteParametros_t *cliente, const parametroCliente_t *parametro, uint32_t *valor, uint32_t *defecto);
+uint8_t escribirParametroCliente(clienteParametros_t *cliente, const parametroCliente_t *parametro, uint32_t valor,
+                                 uint32_t *valorFinal);
+uint8_t guardarParametrosCliente(clienteParametros_t *cliente);
+
+#endif // __CLIENTE_PARAMETROS_H
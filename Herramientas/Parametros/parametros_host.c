@@ -0,0 +1,481 @@
+/***************************************************************************************
+**  parametros_host.c - Herramienta del host para configurar los GP por el USB. Los
+**                      parametros disponibles, sus tipos y rangos se descargan del FC
+**
+**
+**  Este fichero forma parte del proyecto URpilot.
+**  Codigo desarrollado por el grupo de investigacion ICON de la Universidad de La Rioja
+**
+**  Autor: Ramon Rico
+**  Fecha de creacion: 17/10/2026
+**  Fecha de modificacion: 17/10/2026
+**
+**  El proyecto URpilot NO es libre. No se puede distribuir y/o modificar este fichero
+**  bajo ningun concepto.
+**
+**  En caso de modificacion y/o solicitud de informacion pongase en contacto con
+**  el grupo de investigacion ICON a traves de: www.unirioja.es/urpilot
+**
+**
+**  Control de versiones del fichero
+**
+**  v1.0  Ramon Rico. Se ha liberado la primera version estable
+**
+****************************************************************************************/
+
+/***************************************************************************************
+** AREA DE INCLUDES                                                                   **
+****************************************************************************************/
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <errno.h>
+#include <fcntl.h>
+#include <poll.h>
+#include <termios.h>
+#include <unistd.h>
+
+#include "cliente_parametros.h"
+
+
+/***************************************************************************************
+** AREA DE PREPROCESADOR                                                              **
+****************************************************************************************/
+#define TAM_TEXTO_VALOR_HOST                  32
+#define TAM_LINEA_HOST                        128
+
+
+/***************************************************************************************
+** AREA DE DEFINICION DE TIPOS                                                        **
+****************************************************************************************/
+
+
+/***************************************************************************************
+** AREA DE DECLARACION DE VARIABLES                                                   **
+****************************************************************************************/
+static clienteParametros_t cliente;
+
+
+/***************************************************************************************
+** AREA DE PROTOTIPOS DE FUNCION                                                      **
+****************************************************************************************/
+int abrirPuertoHost(const char *ruta);
+bool enviarPuertoHost(void *contexto, const uint8_t *datos, uint32_t longitud);
+int32_t recibirPuertoHost(void *contexto, uint8_t *datos, uint32_t longitud, uint32_t esperaMs);
+const char *textoTipoHost(tipoParametroTelemetria_e tipo);
+int listarHost(void);
+bool leerParametroHost(const parametroCliente_t *parametro, bool comparar);
+int leerHost(int argc, char *argv[]);
+bool escribirParametroHost(const char *nombre, const char *texto);
+int escribirHost(int argc, char *argv[]);
+int guardarHost(void);
+int volcarHost(void);
+int cargarHost(const char *nombreFichero);
+
+
+/***************************************************************************************
+** AREA DE DEFINICION DE FUNCIONES                                                    **
+****************************************************************************************/
+
+/***************************************************************************************
+**  Nombre:         int abrirPuertoHost(const char *ruta)
+**  Descripcion:    Abre el puerto serie del USB CDC en modo crudo
+**  Parametros:     Ruta del dispositivo
+**  Retorno:        Descriptor o -1 si hay error
+****************************************************************************************/
+int abrirPuertoHost(const char *ruta)
+{
+    struct termios opciones;
+
+    const int fd = open(ruta, O_RDWR | O_NOCTTY);
+    if (fd < 0)
+        return -1;
+
+    if (tcgetattr(fd, &opciones) == 0) {
+        cfmakeraw(&opciones);
+        opciones.c_cc[VMIN] = 0;
+        opciones.c_cc[VTIME] = 0;
+        tcsetattr(fd, TCSANOW, &opciones);
+        tcflush(fd, TCIOFLUSH);
+    }
+
+    return fd;
+}
+
+
+/***************************************************************************************
+**  Nombre:         bool enviarPuertoHost(void *contexto, const uint8_t *datos, uint32_t longitud)
+**  Descripcion:    Envia una trama por el puerto
+**  Parametros:     Descriptor del puerto, datos, longitud
+**  Retorno:        False si hay error
+****************************************************************************************/
+bool enviarPuertoHost(void *contexto, const uint8_t *datos, uint32_t longitud)
+{
+    const int fd = *(int *)contexto;
+
+    while (longitud > 0) {
+        const ssize_t numBytes = write(fd, datos, longitud);
+        if (numBytes < 0) {
+            if (errno == EINTR || errno == EAGAIN)
+                continue;
+
+            return false;
+        }
+
+        datos += numBytes;
+        longitud -= numBytes;
+    }
+
+    return true;
+}
+
+
+/***************************************************************************************
+**  Nombre:         int32_t recibirPuertoHost(void *contexto, uint8_t *datos, uint32_t longitud, uint32_t esperaMs)
+**  Descripcion:    Lee lo que haya llegado por el puerto esperando como mucho esperaMs
+**  Parametros:     Descriptor del puerto, buffer, tamanio del buffer, espera en ms
+**  Retorno:        Bytes leidos o -1 si hay error
+****************************************************************************************/
+int32_t recibirPuertoHost(void *contexto, uint8_t *datos, uint32_t longitud, uint32_t esperaMs)
+{
+    struct pollfd puerto = { .fd = *(int *)contexto, .events = POLLIN };
+
+    const int listo = poll(&puerto, 1, esperaMs);
+    if (listo < 0)
+        return errno == EINTR ? 0 : -1;
+
+    if (listo == 0)
+        return 0;
+
+    const ssize_t numBytes = read(puerto.fd, datos, longitud);
+    if (numBytes < 0)
+        return errno == EINTR || errno == EAGAIN ? 0 : -1;
+
+    return numBytes;
+}
+
+
+/***************************************************************************************
+**  Nombre:         const char *textoTipoHost(tipoParametroTelemetria_e tipo)
+**  Descripcion:    Nombre de un tipo de parametro
+**  Parametros:     Tipo
+**  Retorno:        Texto
+****************************************************************************************/
+const char *textoTipoHost(tipoParametroTelemetria_e tipo)
+{
+    switch (tipo) {
+        case PARAMETRO_ENTERO_TELEMETRIA:
+            return "entero";
+
+        case PARAMETRO_REAL_TELEMETRIA:
+            return "real";
+
+        case PARAMETRO_BOOL_TELEMETRIA:
+            return "bool";
+
+        default:
+            return "natural";
+    }
+}
+
+
+/***************************************************************************************
+**  Nombre:         int listarHost(void)
+**  Descripcion:    Imprime los grupos y sus campos con el tipo y el rango
+**  Parametros:     Ninguno
+**  Retorno:        0 si OK
+****************************************************************************************/
+int listarHost(void)
+{
+    for (uint8_t i = 0; i < cliente.numGrupos; i++) {
+        const grupoCliente_t *grupo = &cliente.grupos[i];
+
+        printf("%s (GP %u v%u, %u bytes)\n", grupo->nombre, grupo->gpn, grupo->version, grupo->tam);
+        for (uint8_t j = 0; j < grupo->numCampos; j++) {
+            const campoCliente_t *campo = &grupo->campos[j];
+            char nombre[TAM_MAX_NOMBRE_PARAMETRO_CLIENTE];
+
+            snprintf(nombre, sizeof(nombre), "%s.%s", grupo->nombre, campo->nombre);
+            printf("  %-36s %-8s [%g, %g]", nombre, textoTipoHost(campo->tipo), campo->min, campo->max);
+            if (campo->numElementos > 1)
+                printf(" x%u", campo->numElementos);
+            printf("\n");
+        }
+    }
+
+    return 0;
+}
+
+
+/***************************************************************************************
+**  Nombre:         bool leerParametroHost(const parametroCliente_t *parametro, bool comparar)
+**  Descripcion:    Lee un parametro e imprime nombre = valor. Con comparar solo se anade el
+**                  valor por defecto si es distinto
+**  Parametros:     Parametro, comparar con el valor por defecto
+**  Retorno:        True si OK
+****************************************************************************************/
+bool leerParametroHost(const parametroCliente_t *parametro, bool comparar)
+{
+    const campoCliente_t *campo = campoParametroCliente(&cliente, parametro);
+    char nombre[TAM_MAX_NOMBRE_PARAMETRO_CLIENTE];
+    char textoValor[TAM_TEXTO_VALOR_HOST];
+    char textoDefecto[TAM_TEXTO_VALOR_HOST];
+    uint32_t valor, defecto;
+
+    nombreParametroCliente(&cliente, parametro, nombre, sizeof(nombre));
+    const uint8_t resultado = leerParametroCliente(&cliente, parametro, &valor, &defecto);
+    if (resultado != PARAMETRO_OK_TELEMETRIA && resultado != PARAMETRO_SIN_DEFECTO_TELEMETRIA) {
+        fprintf(stderr, "%s: %s\n", nombre, textoResultadoCliente(resultado));
+        return false;
+    }
+
+    valorAtextoCliente(campo, valor, textoValor, sizeof(textoValor));
+    valorAtextoCliente(campo, defecto, textoDefecto, sizeof(textoDefecto));
+
+    if (!comparar)
+        printf("%s = %s (defecto %s)\n", nombre, textoValor, textoDefecto);
+    else if (valor != defecto)
+        printf("%s = %s    # defecto %s\n", nombre, textoValor, textoDefecto);
+    else
+        printf("%s = %s\n", nombre, textoValor);
+
+    return true;
+}
+
+
+/***************************************************************************************
+**  Nombre:         int leerHost(int argc, char *argv[])
+**  Descripcion:    Lee los parametros pedidos. Sin indice se leen todos los elementos
+**  Parametros:     Nombres de los parametros
+**  Retorno:        0 si OK
+****************************************************************************************/
+int leerHost(int argc, char *argv[])
+{
+    int error = 0;
+
+    for (int i = 0; i < argc; i++) {
+        parametroCliente_t parametro;
+        bool conIndice;
+
+        if (!buscarParametroCliente(&cliente, argv[i], &parametro, &conIndice)) {
+            fprintf(stderr, "%s: el parametro no existe\n", argv[i]);
+            error = 1;
+            continue;
+        }
+
+        const uint8_t numElementos = conIndice ? 1 : campoParametroCliente(&cliente, &parametro)->numElementos;
+        for (uint8_t j = 0; j < numElementos; j++) {
+            if (!conIndice)
+                parametro.elemento = j;
+
+            if (!leerParametroHost(&parametro, false))
+                error = 1;
+        }
+    }
+
+    return error;
+}
+
+
+/***************************************************************************************
+**  Nombre:         bool escribirParametroHost(const char *nombre, const char *texto)
+**  Descripcion:    Escribe un parametro en la RAM del FC
+**  Parametros:     Nombre del parametro, valor en texto
+**  Retorno:        True si OK
+****************************************************************************************/
+bool escribirParametroHost(const char *nombre, const char *texto)
+{
+    parametroCliente_t parametro;
+    char textoValor[TAM_TEXTO_VALOR_HOST];
+    uint32_t valor, valorFinal;
+    bool conIndice;
+
+    if (!buscarParametroCliente(&cliente, nombre, &parametro, &conIndice)) {
+        fprintf(stderr, "%s: el parametro no existe\n", nombre);
+        return false;
+    }
+
+    const campoCliente_t *campo = campoParametroCliente(&cliente, &parametro);
+    if (campo->numElementos > 1 && !conIndice) {
+        fprintf(stderr, "%s: falta el elemento [0..%u]\n", nombre, campo->numElementos - 1);
+        return false;
+    }
+
+    if (!textoAvalorCliente(campo, texto, &valor)) {
+        fprintf(stderr, "%s: valor no valido %s (%s en [%g, %g])\n", nombre, texto, textoTipoHost(campo->tipo), campo->min, campo->max);
+        return false;
+    }
+
+    const uint8_t resultado = escribirParametroCliente(&cliente, &parametro, valor, &valorFinal);
+    if (resultado != PARAMETRO_OK_TELEMETRIA && resultado != PARAMETRO_SIN_DEFECTO_TELEMETRIA) {
+        fprintf(stderr, "%s: %s\n", nombre, textoResultadoCliente(resultado));
+        return false;
+    }
+
+    valorAtextoCliente(campo, valorFinal, textoValor, sizeof(textoValor));
+    printf("%s = %s\n", nombre, textoValor);
+    return true;
+}
+
+
+/***************************************************************************************
+**  Nombre:         int escribirHost(int argc, char *argv[])
+**  Descripcion:    Escribe pares nombre valor
+**  Parametros:     Pares de argumentos
+**  Retorno:        0 si OK
+****************************************************************************************/
+int escribirHost(int argc, char *argv[])
+{
+    int error = 0;
+
+    if (argc == 0 || argc % 2 != 0) {
+        fprintf(stderr, "escribir necesita pares parametro valor\n");
+        return 1;
+    }
+
+    for (int i = 0; i < argc; i += 2) {
+        if (!escribirParametroHost(argv[i], argv[i + 1]))
+            error = 1;
+    }
+
+    return error;
+}
+
+
+/***************************************************************************************
+**  Nombre:         int guardarHost(void)
+**  Descripcion:    Guarda los parametros en la flash del FC
+**  Parametros:     Ninguno
+**  Retorno:        0 si OK
+****************************************************************************************/
+int guardarHost(void)
+{
+    const uint8_t resultado = guardarParametrosCliente(&cliente);
+
+    printf("Guardar: %s\n", textoResultadoCliente(resultado));
+    return resultado == PARAMETRO_OK_TELEMETRIA ? 0 : 1;
+}
+
+
+/***************************************************************************************
+**  Nombre:         int volcarHost(void)
+**  Descripcion:    Imprime todos los parametros en el formato que acepta cargar
+**  Parametros:     Ninguno
+**  Retorno:        0 si OK
+****************************************************************************************/
+int volcarHost(void)
+{
+    int error = 0;
+
+    for (uint8_t i = 0; i < cliente.numGrupos; i++) {
+        for (uint8_t j = 0; j < cliente.grupos[i].numCampos; j++) {
+            for (uint8_t k = 0; k < cliente.grupos[i].campos[j].numElementos; k++) {
+                const parametroCliente_t parametro = { i, j, k };
+
+                if (!leerParametroHost(&parametro, true))
+                    error = 1;
+            }
+        }
+    }
+
+    return error;
+}
+
+
+/***************************************************************************************
+**  Nombre:         int cargarHost(const char *nombreFichero)
+**  Descripcion:    Escribe los parametros de un fichero con lineas nombre = valor. Lo que va
+**                  detras de # es un comentario
+**  Parametros:     Nombre del fichero
+**  Retorno:        0 si OK
+****************************************************************************************/
+int cargarHost(const char *nombreFichero)
+{
+    char linea[TAM_LINEA_HOST];
+    int error = 0;
+
+    FILE *fichero = fopen(nombreFichero, "r");
+    if (fichero == NULL) {
+        fprintf(stderr, "No se puede abrir %s\n", nombreFichero);
+        return 1;
+    }
+
+    while (fgets(linea, sizeof(linea), fichero) != NULL) {
+        char nombre[TAM_LINEA_HOST];
+        char valor[TAM_LINEA_HOST];
+
+        char *comentario = strchr(linea, '#');
+        if (comentario != NULL)
+            *comentario = '\0';
+
+        if (sscanf(linea, " %127s = %127s", nombre, valor) != 2)
+            continue;
+
+        if (!escribirParametroHost(nombre, valor))
+            error = 1;
+    }
+
+    fclose(fichero);
+    return error;
+}
+
+
+/***************************************************************************************
+**  Nombre:         int main(int argc, char *argv[])
+**  Descripcion:    Uso: parametros_host /dev/ttyACM0 listar
+**                       parametros_host /dev/ttyACM0 leer ahrs.madgwick.beta pid.pVelAng.kp
+**                       parametros_host /dev/ttyACM0 escribir pid.pVelAng.kp[0] 0.12
+**                       parametros_host /dev/ttyACM0 volcar > config.txt
+**                       parametros_host /dev/ttyACM0 cargar config.txt
+**                       parametros_host /dev/ttyACM0 guardar
+**  Parametros:     Argumentos de la linea de comandos
+**  Retorno:        0 si OK
+****************************************************************************************/
+int main(int argc, char *argv[])
+{
+    if (argc < 3) {
+        fprintf(stderr, "Uso: %s puerto listar|volcar|guardar\n", argv[0]);
+        fprintf(stderr, "     %s puerto leer grupo.campo[elemento] ...\n", argv[0]);
+        fprintf(stderr, "     %s puerto escribir grupo.campo[elemento] valor ...\n", argv[0]);
+        fprintf(stderr, "     %s puerto cargar fichero\n", argv[0]);
+        return 1;
+    }
+
+    int fd = abrirPuertoHost(argv[1]);
+    if (fd < 0) {
+        fprintf(stderr, "No se puede abrir %s: %s\n", argv[1], strerror(errno));
+        return 1;
+    }
+
+    const transporteParametros_t transporte = { .contexto = &fd, .enviar = enviarPuertoHost, .recibir = recibirPuertoHost };
+    iniciarClienteParametros(&cliente, &transporte);
+
+    if (!descargarDescripcionesCliente(&cliente)) {
+        fprintf(stderr, "El FC no responde a las peticiones de parametros\n");
+        close(fd);
+        return 1;
+    }
+
+    const char *comando = argv[2];
+    int resultado;
+
+    if (strcmp(comando, "listar") == 0)
+        resultado = listarHost();
+    else if (strcmp(comando, "leer") == 0)
+        resultado = leerHost(argc - 3, &argv[3]);
+    else if (strcmp(comando, "escribir") == 0)
+        resultado = escribirHost(argc - 3, &argv[3]);
+    else if (strcmp(comando, "guardar") == 0)
+        resultado = guardarHost();
+    else if (strcmp(comando, "volcar") == 0)
+        resultado = volcarHost();
+    else if (strcmp(comando, "cargar") == 0 && argc == 4)
+        resultado = cargarHost(argv[3]);
+    else {
+        fprintf(stderr, "Comando desconocido: %s\n", comando);
+        resultado = 1;
+    }
+
+    close(fd);
+    return resultado;
+}
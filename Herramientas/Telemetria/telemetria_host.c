@@ -0,0 +1,573 @@
+/***************************************************************************************
+**  telemetria_host.c - Herramienta del host para la telemetria por USB. Genera
+**                        suscripciones, convierte la telemetria recibida en CSV y prueba
+**                        el codec con ida y vuelta y con datos corruptos
+**
+**
+**  Este fichero forma parte del proyecto URpilot.
+**  Codigo desarrollado por el grupo de investigacion ICON de la Universidad de La Rioja
+**
+**  Autor: Ramon Rico
+**  Fecha de creacion: 17/10/2026
+**  Fecha de modificacion: 17/10/2026
+**
+**  El proyecto URpilot NO es libre. No se puede distribuir y/o modificar este fichero
+**  bajo ningun concepto.
+**
+**  En caso de modificacion y/o solicitud de informacion pongase en contacto con
+**  el grupo de investigacion ICON a traves de: www.unirioja.es/urpilot
+**
+**
+**  Control de versiones del fichero
+**
+**  v1.0  Ramon Rico. Se ha liberado la primera version estable
+**
+****************************************************************************************/
+
+/***************************************************************************************
+** AREA DE INCLUDES                                                                   **
+****************************************************************************************/
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "Telemetria/protocolo_telemetria.h"
+
+
+/***************************************************************************************
+** AREA DE PREPROCESADOR                                                              **
+****************************************************************************************/
+#define ITERACIONES_IDA_VUELTA_HOST           1000
+#define BYTES_RUIDO_HOST                      (1 << 20)
+#define NUM_TRAMAS_BITS_HOST                  10000
+#define TAM_MAX_ESTRUCTURA_HOST               128
+
+
+/***************************************************************************************
+** AREA DE DEFINICION DE TIPOS                                                        **
+****************************************************************************************/
+typedef union {
+    uint32_t alineacion;
+    uint8_t byte[TAM_MAX_ESTRUCTURA_HOST];
+} mensajeHost_t;
+
+typedef struct {
+    uint8_t trama[TAM_MAX_TRAMA_TELEMETRIA];
+    uint8_t longitud;
+    bool corrupta;
+} tramaPruebaHost_t;
+
+
+/***************************************************************************************
+** AREA DE DECLARACION DE VARIABLES                                                   **
+****************************************************************************************/
+static uint32_t semillaHost = 0x12345678;
+
+
+/***************************************************************************************
+** AREA DE PROTOTIPOS DE FUNCION                                                      **
+****************************************************************************************/
+uint32_t aleatorioHost(void);
+const defMensajeTelemetria_t *buscarMensajeHost(const char *nombre);
+void rellenarMensajeAleatorioHost(const defMensajeTelemetria_t *def, mensajeHost_t *mensaje);
+bool compararMensajesHost(const defMensajeTelemetria_t *def, const mensajeHost_t *a, const mensajeHost_t *b);
+uint8_t tramaAleatoriaHost(uint8_t *trama, uint8_t secuencia);
+bool probarIdaVueltaHost(void);
+bool probarRuidoHost(void);
+bool probarBitsInvertidosHost(void);
+int enviarSuscripcionesHost(int argc, char *argv[]);
+void escribirCabeceraCSVhost(FILE *salida, const defMensajeTelemetria_t *def, bool conNombre);
+void escribirMensajeCSVhost(FILE *salida, const defMensajeTelemetria_t *def, uint8_t secuencia, const mensajeHost_t *mensaje,
+                            bool conNombre);
+int decodificarFicheroHost(const char *nombreFichero, const char *nombreMensaje);
+
+
+/***************************************************************************************
+** AREA DE DEFINICION DE FUNCIONES                                                    **
+****************************************************************************************/
+
+/***************************************************************************************
+**  Nombre:         uint32_t aleatorioHost(void)
+**  Descripcion:    Generador xorshift con semilla fija para que las pruebas sean repetibles
+**  Parametros:     Ninguno
+**  Retorno:        Numero aleatorio
+****************************************************************************************/
+uint32_t aleatorioHost(void)
+{
+    semillaHost ^= semillaHost << 13;
+    semillaHost ^= semillaHost >> 17;
+    semillaHost ^= semillaHost << 5;
+    return semillaHost;
+}
+
+
+/***************************************************************************************
+**  Nombre:         const defMensajeTelemetria_t *buscarMensajeHost(const char *nombre)
+**  Descripcion:    Busca un mensaje del catalogo por su nombre o su identificador
+**  Parametros:     Nombre o identificador en decimal
+**  Retorno:        Definicion o NULL si no existe
+****************************************************************************************/
+const defMensajeTelemetria_t *buscarMensajeHost(const char *nombre)
+{
+    for (uint16_t id = 0; id < 256; id++) {
+        const defMensajeTelemetria_t *def = defMensajeTelemetria(id);
+
+        if (def != NULL && strcmp(def->nombre, nombre) == 0)
+            return def;
+    }
+
+    char *fin;
+    const unsigned long id = strtoul(nombre, &fin, 0);
+    if (*nombre == '\0' || *fin != '\0' || id > 255)
+        return NULL;
+
+    return defMensajeTelemetria(id);
+}
+
+
+/***************************************************************************************
+**  Nombre:         void rellenarMensajeAleatorioHost(const defMensajeTelemetria_t *def, mensajeHost_t *mensaje)
+**  Descripcion:    Rellena todos los campos de un mensaje con bits aleatorios
+**  Parametros:     Definicion del mensaje, mensaje
+**  Retorno:        Ninguno
+****************************************************************************************/
+void rellenarMensajeAleatorioHost(const defMensajeTelemetria_t *def, mensajeHost_t *mensaje)
+{
+    memset(mensaje, 0, sizeof(*mensaje));
+
+    for (uint8_t i = 0; i < def->numCampos; i++) {
+        const campoTelemetria_t *campo = &def->campos[i];
+        const uint8_t tam = campo->tipo == CAMPO_U8_TELEMETRIA ? 1 : campo->tipo == CAMPO_U16_TELEMETRIA ? 2 : 4;
+
+        for (uint16_t j = 0; j < tam * campo->numElementos; j++)
+            mensaje->byte[campo->offset + j] = (uint8_t)aleatorioHost();
+    }
+}
+
+
+/***************************************************************************************
+**  Nombre:         bool compararMensajesHost(const defMensajeTelemetria_t *def, const mensajeHost_t *a,
+**                                            const mensajeHost_t *b)
+**  Descripcion:    Compara campo a campo dos mensajes sin tener en cuenta el relleno
+**  Parametros:     Definicion del mensaje, mensajes
+**  Retorno:        True si son iguales
+****************************************************************************************/
+bool compararMensajesHost(const defMensajeTelemetria_t *def, const mensajeHost_t *a, const mensajeHost_t *b)
+{
+    for (uint8_t i = 0; i < def->numCampos; i++) {
+        const campoTelemetria_t *campo = &def->campos[i];
+        const uint8_t tam = campo->tipo == CAMPO_U8_TELEMETRIA ? 1 : campo->tipo == CAMPO_U16_TELEMETRIA ? 2 : 4;
+
+        if (memcmp(&a->byte[campo->offset], &b->byte[campo->offset], tam * campo->numElementos) != 0)
+            return false;
+    }
+
+    return true;
+}
+
+
+/***************************************************************************************
+**  Nombre:         uint8_t tramaAleatoriaHost(uint8_t *trama, uint8_t secuencia)
+**  Descripcion:    Codifica un mensaje aleatorio de un tipo aleatorio del catalogo
+**  Parametros:     Buffer de la trama, numero de secuencia
+**  Retorno:        Longitud de la trama
+****************************************************************************************/
+uint8_t tramaAleatoriaHost(uint8_t *trama, uint8_t secuencia)
+{
+    const uint8_t id = aleatorioHost() % (NUM_MENSAJES_TELEMETRIA + 1);
+    const defMensajeTelemetria_t *def = defMensajeTelemetria(id < NUM_MENSAJES_TELEMETRIA ? id : MENSAJE_TELEMETRIA_SUSCRIPCION);
+    mensajeHost_t mensaje;
+
+    rellenarMensajeAleatorioHost(def, &mensaje);
+    return codificarTramaTelemetria(trama, def->id, secuencia, &mensaje);
+}
+
+
+/***************************************************************************************
+**  Nombre:         bool probarIdaVueltaHost(void)
+**  Descripcion:    Codifica mensajes aleatorios de todo el catalogo, los pasa por el
+**                  decodificador de tramas y comprueba que se recuperan igual
+**  Parametros:     Ninguno
+**  Retorno:        True si OK
+****************************************************************************************/
+bool probarIdaVueltaHost(void)
+{
+    decodificadorTelemetria_t decodificador;
+    uint32_t numMensajes = 0;
+    uint32_t numErrores = 0;
+
+    iniciarDecodificadorTelemetria(&decodificador);
+
+    for (uint16_t id = 0; id < 256; id++) {
+        const defMensajeTelemetria_t *def = defMensajeTelemetria(id);
+
+        if (def == NULL)
+            continue;
+
+        if (def->tamEstructura > TAM_MAX_ESTRUCTURA_HOST || tamPayloadTelemetria(def) > TAM_MAX_PAYLOAD_TELEMETRIA) {
+            fprintf(stderr, "  %s: no cabe en los buffers\n", def->nombre);
+            numErrores++;
+            continue;
+        }
+
+        for (uint16_t i = 0; i < ITERACIONES_IDA_VUELTA_HOST; i++) {
+            mensajeHost_t original, decodificado;
+            uint8_t trama[TAM_MAX_TRAMA_TELEMETRIA];
+            uint8_t numTramas = 0;
+            bool ok = true;
+
+            rellenarMensajeAleatorioHost(def, &original);
+            const uint8_t longitud = codificarTramaTelemetria(trama, def->id, (uint8_t)i, &original);
+
+            for (uint8_t j = 0; j < longitud; j++) {
+                if (procesarByteTelemetria(&decodificador, trama[j])) {
+                    numTramas++;
+                    ok = ok && j == longitud - 1;
+                }
+            }
+
+            ok = ok && numTramas == 1 && decodificador.id == def->id && decodificador.secuencia == (uint8_t)i;
+            ok = ok && decodificarMensajeTelemetria(decodificador.id, decodificador.payload, decodificador.longitud, &decodificado);
+            ok = ok && compararMensajesHost(def, &original, &decodificado);
+
+            numMensajes++;
+            if (!ok)
+                numErrores++;
+        }
+    }
+
+    printf("  Ida y vuelta: mensajes %u, errores %u\n", numMensajes, numErrores);
+    return numErrores == 0;
+}
+
+
+/***************************************************************************************
+**  Nombre:         bool probarRuidoHost(void)
+**  Descripcion:    Pasa bytes aleatorios por el decodificador. No debe aceptar ninguna trama
+**  Parametros:     Ninguno
+**  Retorno:        True si OK
+****************************************************************************************/
+bool probarRuidoHost(void)
+{
+    decodificadorTelemetria_t decodificador;
+
+    iniciarDecodificadorTelemetria(&decodificador);
+
+    for (uint32_t i = 0; i < BYTES_RUIDO_HOST; i++)
+        procesarByteTelemetria(&decodificador, (uint8_t)aleatorioHost());
+
+    printf("  Ruido: bytes %u, tramas aceptadas %u, errores CRC %u\n", BYTES_RUIDO_HOST, decodificador.tramasRecibidas,
+           decodificador.erroresCRC);
+    return decodificador.tramasRecibidas == 0;
+}
+
+
+/***************************************************************************************
+**  Nombre:         bool probarBitsInvertidosHost(void)
+**  Descripcion:    Envia un flujo de tramas con un bit invertido en una de cada tres y bytes
+**                  basura entre algunas de ellas. Toda trama aceptada tiene que ser una de
+**                  las originales sin corromper y en orden
+**  Parametros:     Ninguno
+**  Retorno:        True si OK
+****************************************************************************************/
+bool probarBitsInvertidosHost(void)
+{
+    static tramaPruebaHost_t tramas[NUM_TRAMAS_BITS_HOST];
+    decodificadorTelemetria_t decodificador;
+    uint32_t numCorruptas = 0;
+    uint32_t numAceptadas = 0;
+    uint32_t numCorruptasAceptadas = 0;
+    uint32_t siguiente = 0;
+
+    iniciarDecodificadorTelemetria(&decodificador);
+
+    for (uint32_t i = 0; i < NUM_TRAMAS_BITS_HOST; i++) {
+        tramaPruebaHost_t *prueba = &tramas[i];
+        uint8_t trama[TAM_MAX_TRAMA_TELEMETRIA];
+
+        prueba->longitud = tramaAleatoriaHost(prueba->trama, (uint8_t)i);
+        prueba->corrupta = aleatorioHost() % 3 == 0;
+        memcpy(trama, prueba->trama, prueba->longitud);
+
+        if (prueba->corrupta) {
+            const uint32_t bit = aleatorioHost() % (prueba->longitud * 8);
+            trama[bit / 8] ^= 1 << (bit % 8);
+            numCorruptas++;
+        }
+
+        if (aleatorioHost() % 4 == 0) {
+            const uint8_t numBasura = 1 + aleatorioHost() % 8;
+            for (uint8_t j = 0; j < numBasura; j++)
+                procesarByteTelemetria(&decodificador, (uint8_t)aleatorioHost());
+        }
+
+        for (uint8_t j = 0; j < prueba->longitud; j++) {
+            if (!procesarByteTelemetria(&decodificador, trama[j]))
+                continue;
+
+            // Se vuelve a codificar lo recibido y se busca entre las tramas enviadas
+            mensajeHost_t mensaje;
+            uint8_t recodificada[TAM_MAX_TRAMA_TELEMETRIA];
+            uint8_t longitud = 0;
+
+            if (decodificarMensajeTelemetria(decodificador.id, decodificador.payload, decodificador.longitud, &mensaje))
+                longitud = codificarTramaTelemetria(recodificada, decodificador.id, decodificador.secuencia, &mensaje);
+
+            uint32_t k = siguiente;
+            while (k <= i && (tramas[k].longitud != longitud || memcmp(tramas[k].trama, recodificada, longitud) != 0))
+                k++;
+
+            numAceptadas++;
+            if (k > i || tramas[k].corrupta)
+                numCorruptasAceptadas++;
+            else
+                siguiente = k + 1;
+        }
+    }
+
+    const uint32_t numPerdidas = NUM_TRAMAS_BITS_HOST - numCorruptas - (numAceptadas - numCorruptasAceptadas);
+    printf("  Bits invertidos: tramas %u (corruptas %u), aceptadas %u, perdidas sin corromper %u, corruptas aceptadas %u\n",
+           NUM_TRAMAS_BITS_HOST, numCorruptas, numAceptadas, numPerdidas, numCorruptasAceptadas);
+    return numCorruptasAceptadas == 0;
+}
+
+
+/***************************************************************************************
+**  Nombre:         int enviarSuscripcionesHost(int argc, char *argv[])
+**  Descripcion:    Escribe en la salida estandar las tramas de suscripcion nombre:hz
+**  Parametros:     Suscripciones
+**  Retorno:        0 si OK
+****************************************************************************************/
+int enviarSuscripcionesHost(int argc, char *argv[])
+{
+    for (int i = 0; i < argc; i++) {
+        char nombre[32];
+        unsigned frecuencia;
+        const char *separador = strchr(argv[i], ':');
+
+        if (separador == NULL || separador - argv[i] >= (int)sizeof(nombre) || sscanf(separador + 1, "%u", &frecuencia) != 1) {
+            fprintf(stderr, "Suscripcion mal formada: %s\n", argv[i]);
+            return 1;
+        }
+
+        memcpy(nombre, argv[i], separador - argv[i]);
+        nombre[separador - argv[i]] = '\0';
+
+        const defMensajeTelemetria_t *def = buscarMensajeHost(nombre);
+        if (def == NULL || def->id >= NUM_MENSAJES_TELEMETRIA || frecuencia > UINT16_MAX) {
+            fprintf(stderr, "Suscripcion no valida: %s\n", argv[i]);
+            return 1;
+        }
+
+        const mensajeSuscripcionTelemetria_t suscripcion = { .id = def->id, .frecuencia = frecuencia };
+        uint8_t trama[TAM_MAX_TRAMA_TELEMETRIA];
+
+        const uint8_t longitud = codificarTramaTelemetria(trama, MENSAJE_TELEMETRIA_SUSCRIPCION, (uint8_t)i, &suscripcion);
+        fwrite(trama, 1, longitud, stdout);
+    }
+
+    fflush(stdout);
+    return 0;
+}
+
+
+/***************************************************************************************
+**  Nombre:         void escribirCabeceraCSVhost(FILE *salida, const defMensajeTelemetria_t *def, bool conNombre)
+**  Descripcion:    Escribe los nombres de las columnas. Los vectores llevan el indice
+**  Parametros:     Fichero de salida, definicion del mensaje, anadir la columna del mensaje
+**  Retorno:        Ninguno
+****************************************************************************************/
+void escribirCabeceraCSVhost(FILE *salida, const defMensajeTelemetria_t *def, bool conNombre)
+{
+    if (conNombre)
+        fputs("mensaje,", salida);
+
+    fputs("secuencia", salida);
+
+    for (uint8_t i = 0; i < def->numCampos; i++) {
+        const campoTelemetria_t *campo = &def->campos[i];
+
+        if (campo->numElementos == 1) {
+            fprintf(salida, ",%s", campo->nombre);
+            continue;
+        }
+
+        for (uint8_t j = 0; j < campo->numElementos; j++)
+            fprintf(salida, ",%s_%u", campo->nombre, j);
+    }
+
+    fputc('\n', salida);
+}
+
+
+/***************************************************************************************
+**  Nombre:         void escribirMensajeCSVhost(FILE *salida, const defMensajeTelemetria_t *def, uint8_t secuencia,
+**                                              const mensajeHost_t *mensaje, bool conNombre)
+**  Descripcion:    Escribe una fila del CSV recorriendo los campos de la definicion
+**  Parametros:     Fichero de salida, definicion del mensaje, numero de secuencia, mensaje,
+**                  anadir la columna del mensaje
+**  Retorno:        Ninguno
+****************************************************************************************/
+void escribirMensajeCSVhost(FILE *salida, const defMensajeTelemetria_t *def, uint8_t secuencia, const mensajeHost_t *mensaje,
+                            bool conNombre)
+{
+    if (conNombre)
+        fprintf(salida, "%s,", def->nombre);
+
+    fprintf(salida, "%u", secuencia);
+
+    for (uint8_t i = 0; i < def->numCampos; i++) {
+        const campoTelemetria_t *campo = &def->campos[i];
+
+        for (uint8_t j = 0; j < campo->numElementos; j++) {
+            const uint8_t *elemento = &mensaje->byte[campo->offset];
+
+            switch (campo->tipo) {
+                case CAMPO_U8_TELEMETRIA:
+                    fprintf(salida, ",%u", elemento[j]);
+                    break;
+
+                case CAMPO_U16_TELEMETRIA: {
+                    uint16_t valor;
+                    memcpy(&valor, elemento + j * sizeof(valor), sizeof(valor));
+                    fprintf(salida, ",%u", valor);
+                    break;
+                }
+
+                case CAMPO_U32_TELEMETRIA: {
+                    uint32_t valor;
+                    memcpy(&valor, elemento + j * sizeof(valor), sizeof(valor));
+                    fprintf(salida, ",%u", valor);
+                    break;
+                }
+
+                case CAMPO_I32_TELEMETRIA: {
+                    int32_t valor;
+                    memcpy(&valor, elemento + j * sizeof(valor), sizeof(valor));
+                    fprintf(salida, ",%d", valor);
+                    break;
+                }
+
+                default: {
+                    float valor;
+                    memcpy(&valor, elemento + j * sizeof(valor), sizeof(valor));
+                    fprintf(salida, ",%g", valor);
+                    break;
+                }
+            }
+        }
+    }
+
+    fputc('\n', salida);
+}
+
+
+/***************************************************************************************
+**  Nombre:         int decodificarFicheroHost(const char *nombreFichero, const char *nombreMensaje)
+**  Descripcion:    Convierte en CSV la telemetria capturada del USB. Sin filtro se escriben
+**                  todos los mensajes con su nombre y la cabecera de cada tipo la primera
+**                  vez que aparece
+**  Parametros:     Fichero ("-" para la entrada estandar), mensaje a extraer o NULL
+**  Retorno:        0 si OK
+****************************************************************************************/
+int decodificarFicheroHost(const char *nombreFichero, const char *nombreMensaje)
+{
+    const defMensajeTelemetria_t *filtro = NULL;
+    bool cabeceraEscrita[256] = { false };
+    decodificadorTelemetria_t decodificador;
+    uint32_t saltosSecuencia = 0;
+    bool secuenciaIniciada = false;
+    uint8_t siguienteSecuencia = 0;
+    int dato;
+
+    if (nombreMensaje != NULL && (filtro = buscarMensajeHost(nombreMensaje)) == NULL) {
+        fprintf(stderr, "Mensaje desconocido: %s\n", nombreMensaje);
+        return 1;
+    }
+
+    FILE *fichero = strcmp(nombreFichero, "-") == 0 ? stdin : fopen(nombreFichero, "rb");
+    if (fichero == NULL) {
+        perror(nombreFichero);
+        return 1;
+    }
+
+    iniciarDecodificadorTelemetria(&decodificador);
+
+    while ((dato = fgetc(fichero)) != EOF) {
+        mensajeHost_t mensaje;
+
+        if (!procesarByteTelemetria(&decodificador, (uint8_t)dato))
+            continue;
+
+        if (secuenciaIniciada && decodificador.secuencia != siguienteSecuencia)
+            saltosSecuencia++;
+
+        siguienteSecuencia = decodificador.secuencia + 1;
+        secuenciaIniciada = true;
+
+        const defMensajeTelemetria_t *def = defMensajeTelemetria(decodificador.id);
+        if ((filtro != NULL && def != filtro) ||
+            !decodificarMensajeTelemetria(decodificador.id, decodificador.payload, decodificador.longitud, &mensaje))
+            continue;
+
+        if (!cabeceraEscrita[def->id]) {
+            escribirCabeceraCSVhost(stdout, def, filtro == NULL);
+            cabeceraEscrita[def->id] = true;
+        }
+
+        escribirMensajeCSVhost(stdout, def, decodificador.secuencia, &mensaje, filtro == NULL);
+    }
+
+    if (fichero != stdin)
+        fclose(fichero);
+
+    fprintf(stderr, "Tramas %u, errores CRC %u, bytes descartados %u, saltos de secuencia %u\n", decodificador.tramasRecibidas,
+            decodificador.erroresCRC, decodificador.bytesDescartados, saltosSecuencia);
+    return 0;
+}
+
+
+/***************************************************************************************
+**  Nombre:         int main(int argc, char *argv[])
+**  Descripcion:    Uso: telemetria_host -t
+**                       telemetria_host -s imu:200 -s ahrs:100 > /dev/ttyACM0
+**                       telemetria_host [-m imu] captura.bin > telemetria.csv
+**  Parametros:     Argumentos de la linea de comandos
+**  Retorno:        0 si OK
+****************************************************************************************/
+int main(int argc, char *argv[])
+{
+    const char *nombreMensaje = NULL;
+    const char *nombreFichero = NULL;
+    char *suscripciones[64];
+    int numSuscripciones = 0;
+
+    for (int i = 1; i < argc; i++) {
+        if (strcmp(argv[i], "-t") == 0) {
+            printf("Prueba del protocolo de telemetria v%u\n", VERSION_PROTOCOLO_TELEMETRIA);
+            const bool idaVueltaOk = probarIdaVueltaHost();
+            const bool ruidoOk = probarRuidoHost();
+            const bool bitsOk = probarBitsInvertidosHost();
+            printf("  Resultado: %s\n", idaVueltaOk && ruidoOk && bitsOk ? "ok" : "mal");
+            return idaVueltaOk && ruidoOk && bitsOk ? 0 : 1;
+        }
+        else if (strcmp(argv[i], "-s") == 0 && i + 1 < argc && numSuscripciones < 64)
+            suscripciones[numSuscripciones++] = argv[++i];
+        else if (strcmp(argv[i], "-m") == 0 && i + 1 < argc)
+            nombreMensaje = argv[++i];
+        else
+            nombreFichero = argv[i];
+    }
+
+    if (numSuscripciones > 0)
+        return enviarSuscripcionesHost(numSuscripciones, suscripciones);
+
+    if (nombreFichero == NULL) {
+        fprintf(stderr, "Uso: %s -t\n", argv[0]);
+        fprintf(stderr, "     %s -s mensaje:hz [-s mensaje:hz ...] > /dev/ttyACM0\n", argv[0]);
+        fprintf(stderr, "     %s [-m mensaje] captura.bin|- > telemetria.csv\n", argv[0]);
+        return 1;
+    }
+
+    return decodificarFicheroHost(nombreFichero, nombreMensaje);
+}
@@ -9,10 +9,13 @@ C_SRCS += \
 ../Core/Drivers/adc_hal.c \
 ../Core/Drivers/adc_hardware.c \
 ../Core/Drivers/bus.c \
+../Core/Drivers/crc_hal.c \
 ../Core/Drivers/dma.c \
+../Core/Drivers/exti.c \
 ../Core/Drivers/flash.c \
 ../Core/Drivers/i2c.c \
 ../Core/Drivers/i2c_bus.c \
+../Core/Drivers/i2c_cola.c \
 ../Core/Drivers/i2c_hal.c \
 ../Core/Drivers/i2c_hardware.c \
 ../Core/Drivers/io.c \
@@ -25,6 +28,7 @@ C_SRCS += \
 ../Core/Drivers/sdmmc_hardware.c \
 ../Core/Drivers/spi.c \
 ../Core/Drivers/spi_bus.c \
+../Core/Drivers/spi_cola.c \
 ../Core/Drivers/spi_hal.c \
 ../Core/Drivers/spi_hardware.c \
 ../Core/Drivers/tiempo.c \
@@ -44,10 +48,13 @@ OBJS += \
 ./Core/Drivers/adc_hal.o \
 ./Core/Drivers/adc_hardware.o \
 ./Core/Drivers/bus.o \
+./Core/Drivers/crc_hal.o \
 ./Core/Drivers/dma.o \
+./Core/Drivers/exti.o \
 ./Core/Drivers/flash.o \
 ./Core/Drivers/i2c.o \
 ./Core/Drivers/i2c_bus.o \
+./Core/Drivers/i2c_cola.o \
 ./Core/Drivers/i2c_hal.o \
 ./Core/Drivers/i2c_hardware.o \
 ./Core/Drivers/io.o \
@@ -60,6 +67,7 @@ OBJS += \
 ./Core/Drivers/sdmmc_hardware.o \
 ./Core/Drivers/spi.o \
 ./Core/Drivers/spi_bus.o \
+./Core/Drivers/spi_cola.o \
 ./Core/Drivers/spi_hal.o \
 ./Core/Drivers/spi_hardware.o \
 ./Core/Drivers/tiempo.o \
@@ -79,10 +87,13 @@ C_DEPS += \
 ./Core/Drivers/adc_hal.d \
 ./Core/Drivers/adc_hardware.d \
 ./Core/Drivers/bus.d \
+./Core/Drivers/crc_hal.d \
 ./Core/Drivers/dma.d \
+./Core/Drivers/exti.d \
 ./Core/Drivers/flash.d \
 ./Core/Drivers/i2c.d \
 ./Core/Drivers/i2c_bus.d \
+./Core/Drivers/i2c_cola.d \
 ./Core/Drivers/i2c_hal.d \
 ./Core/Drivers/i2c_hardware.d \
 ./Core/Drivers/io.d \
@@ -95,6 +106,7 @@ C_DEPS += \
 ./Core/Drivers/sdmmc_hardware.d \
 ./Core/Drivers/spi.d \
 ./Core/Drivers/spi_bus.d \
+./Core/Drivers/spi_cola.d \
 ./Core/Drivers/spi_hal.d \
 ./Core/Drivers/spi_hardware.d \
 ./Core/Drivers/tiempo.d \
@@ -117,7 +129,7 @@ Core/Drivers/%.o Core/Drivers/%.su: ../Core/Drivers/%.c Core/Drivers/subdir.mk
 clean: clean-Core-2f-Drivers
 
 clean-Core-2f-Drivers:
-	-$(RM) ./Core/Drivers/adc.d ./Core/Drivers/adc.o ./Core/Drivers/adc.su ./Core/Drivers/adc_hal.d ./Core/Drivers/adc_hal.o ./Core/Drivers/adc_hal.su ./Core/Drivers/adc_hardware.d ./Core/Drivers/adc_hardware.o ./Core/Drivers/adc_hardware.su ./Core/Drivers/bus.d ./Core/Drivers/bus.o ./Core/Drivers/bus.su ./Core/Drivers/dma.d ./Core/Drivers/dma.o ./Core/Drivers/dma.su ./Core/Drivers/flash.d ./Core/Drivers/flash.o ./Core/Drivers/flash.su ./Core/Drivers/i2c.d ./Core/Drivers/i2c.o ./Core/Drivers/i2c.su ./Core/Drivers/i2c_bus.d ./Core/Drivers/i2c_bus.o ./Core/Drivers/i2c_bus.su ./Core/Drivers/i2c_hal.d ./Core/Drivers/i2c_hal.o ./Core/Drivers/i2c_hal.su ./Core/Drivers/i2c_hardware.d ./Core/Drivers/i2c_hardware.o ./Core/Drivers/i2c_hardware.su ./Core/Drivers/io.d ./Core/Drivers/io.o ./Core/Drivers/io.su ./Core/Drivers/nvic.d ./Core/Drivers/nvic.o ./Core/Drivers/nvic.su ./Core/Drivers/reset.d ./Core/Drivers/reset.o ./Core/Drivers/reset.su ./Core/Drivers/rtc.d ./Core/Drivers/rtc.o ./Core/Drivers/rtc.su ./Core/Drivers/rtc_hal.d ./Core/Drivers/rtc_hal.o ./Core/Drivers/rtc_hal.su ./Core/Drivers/sdmmc.d ./Core/Drivers/sdmmc.o ./Core/Drivers/sdmmc.su ./Core/Drivers/sdmmc_hal.d ./Core/Drivers/sdmmc_hal.o ./Core/Drivers/sdmmc_hal.su ./Core/Drivers/sdmmc_hardware.d ./Core/Drivers/sdmmc_hardware.o ./Core/Drivers/sdmmc_hardware.su ./Core/Drivers/spi.d ./Core/Drivers/spi.o ./Core/Drivers/spi.su ./Core/Drivers/spi_bus.d ./Core/Drivers/spi_bus.o ./Core/Drivers/spi_bus.su ./Core/Drivers/spi_hal.d ./Core/Drivers/spi_hal.o ./Core/Drivers/spi_hal.su ./Core/Drivers/spi_hardware.d ./Core/Drivers/spi_hardware.o ./Core/Drivers/spi_hardware.su ./Core/Drivers/tiempo.d ./Core/Drivers/tiempo.o ./Core/Drivers/tiempo.su ./Core/Drivers/timer.d ./Core/Drivers/timer.o ./Core/Drivers/timer.su ./Core/Drivers/timer_hal.d ./Core/Drivers/timer_hal.o ./Core/Drivers/timer_hal.su ./Core/Drivers/timer_hardware.d ./Core/Drivers/timer_hardware.o ./Core/Drivers/timer_hardware.su ./Core/Drivers/uart.d ./Core/Drivers/uart.o ./Core/Drivers/uart.su ./Core/Drivers/uart_hal.d ./Core/Drivers/uart_hal.o ./Core/Drivers/uart_hal.su ./Core/Drivers/uart_hardware.d ./Core/Drivers/uart_hardware.o ./Core/Drivers/uart_hardware.su ./Core/Drivers/usb.d ./Core/Drivers/usb.o ./Core/Drivers/usb.su ./Core/Drivers/usb_descriptor.d ./Core/Drivers/usb_descriptor.o ./Core/Drivers/usb_descriptor.su ./Core/Drivers/usb_hal.d ./Core/Drivers/usb_hal.o ./Core/Drivers/usb_hal.su ./Core/Drivers/usb_hardware.d ./Core/Drivers/usb_hardware.o ./Core/Drivers/usb_hardware.su
+	-$(RM) ./Core/Drivers/adc.d ./Core/Drivers/adc.o ./Core/Drivers/adc.su ./Core/Drivers/adc_hal.d ./Core/Drivers/adc_hal.o ./Core/Drivers/adc_hal.su ./Core/Drivers/adc_hardware.d ./Core/Drivers/adc_hardware.o ./Core/Drivers/adc_hardware.su ./Core/Drivers/bus.d ./Core/Drivers/bus.o ./Core/Drivers/bus.su ./Core/Drivers/crc_hal.d ./Core/Drivers/crc_hal.o ./Core/Drivers/crc_hal.su ./Core/Drivers/dma.d ./Core/Drivers/dma.o ./Core/Drivers/dma.su ./Core/Drivers/exti.d ./Core/Drivers/exti.o ./Core/Drivers/exti.su ./Core/Drivers/flash.d ./Core/Drivers/flash.o ./Core/Drivers/flash.su ./Core/Drivers/i2c.d ./Core/Drivers/i2c.o ./Core/Drivers/i2c.su ./Core/Drivers/i2c_bus.d ./Core/Drivers/i2c_bus.o ./Core/Drivers/i2c_bus.su ./Core/Drivers/i2c_cola.d ./Core/Drivers/i2c_cola.o ./Core/Drivers/i2c_cola.su ./Core/Drivers/i2c_hal.d ./Core/Drivers/i2c_hal.o ./Core/Drivers/i2c_hal.su ./Core/Drivers/i2c_hardware.d ./Core/Drivers/i2c_hardware.o ./Core/Drivers/i2c_hardware.su ./Core/Drivers/io.d ./Core/Drivers/io.o ./Core/Drivers/io.su ./Core/Drivers/nvic.d ./Core/Drivers/nvic.o ./Core/Drivers/nvic.su ./Core/Drivers/reset.d ./Core/Drivers/reset.o ./Core/Drivers/reset.su ./Core/Drivers/rtc.d ./Core/Drivers/rtc.o ./Core/Drivers/rtc.su ./Core/Drivers/rtc_hal.d ./Core/Drivers/rtc_hal.o ./Core/Drivers/rtc_hal.su ./Core/Drivers/sdmmc.d ./Core/Drivers/sdmmc.o ./Core/Drivers/sdmmc.su ./Core/Drivers/sdmmc_hal.d ./Core/Drivers/sdmmc_hal.o ./Core/Drivers/sdmmc_hal.su ./Core/Drivers/sdmmc_hardware.d ./Core/Drivers/sdmmc_hardware.o ./Core/Drivers/sdmmc_hardware.su ./Core/Drivers/spi.d ./Core/Drivers/spi.o ./Core/Drivers/spi.su ./Core/Drivers/spi_bus.d ./Core/Drivers/spi_bus.o ./Core/Drivers/spi_bus.su ./Core/Drivers/spi_cola.d ./Core/Drivers/spi_cola.o ./Core/Drivers/spi_cola.su ./Core/Drivers/spi_hal.d ./Core/Drivers/spi_hal.o ./Core/Drivers/spi_hal.su ./Core/Drivers/spi_hardware.d ./Core/Drivers/spi_hardware.o ./Core/Drivers/spi_hardware.su ./Core/Drivers/tiempo.d ./Core/Drivers/tiempo.o ./Core/Drivers/tiempo.su ./Core/Drivers/timer.d ./Core/Drivers/timer.o ./Core/Drivers/timer.su ./Core/Drivers/timer_hal.d ./Core/Drivers/timer_hal.o ./Core/Drivers/timer_hal.su ./Core/Drivers/timer_hardware.d ./Core/Drivers/timer_hardware.o ./Core/Drivers/timer_hardware.su ./Core/Drivers/uart.d ./Core/Drivers/uart.o ./Core/Drivers/uart.su ./Core/Drivers/uart_hal.d ./Core/Drivers/uart_hal.o ./Core/Drivers/uart_hal.su ./Core/Drivers/uart_hardware.d ./Core/Drivers/uart_hardware.o ./Core/Drivers/uart_hardware.su ./Core/Drivers/usb.d ./Core/Drivers/usb.o ./Core/Drivers/usb.su ./Core/Drivers/usb_descriptor.d ./Core/Drivers/usb_descriptor.o ./Core/Drivers/usb_descriptor.su ./Core/Drivers/usb_hal.d ./Core/Drivers/usb_hal.o ./Core/Drivers/usb_hal.su ./Core/Drivers/usb_hardware.d ./Core/Drivers/usb_hardware.o ./Core/Drivers/usb_hardware.su
 
 .PHONY: clean-Core-2f-Drivers
 
@@ -7,16 +7,19 @@
 C_SRCS += \
 ../Core/Motores/dshot.c \
 ../Core/Motores/dshot_hal.c \
+../Core/Motores/dshot_telemetria.c \
 ../Core/Motores/motor.c 
 
 OBJS += \
 ./Core/Motores/dshot.o \
 ./Core/Motores/dshot_hal.o \
+./Core/Motores/dshot_telemetria.o \
 ./Core/Motores/motor.o 
 
 C_DEPS += \
 ./Core/Motores/dshot.d \
 ./Core/Motores/dshot_hal.d \
+./Core/Motores/dshot_telemetria.d \
 ./Core/Motores/motor.d 
 
 
@@ -27,7 +30,7 @@ Core/Motores/%.o Core/Motores/%.su: ../Core/Motores/%.c Core/Motores/subdir.mk
 clean: clean-Core-2f-Motores
 
 clean-Core-2f-Motores:
-	-$(RM) ./Core/Motores/dshot.d ./Core/Motores/dshot.o ./Core/Motores/dshot.su ./Core/Motores/dshot_hal.d ./Core/Motores/dshot_hal.o ./Core/Motores/dshot_hal.su ./Core/Motores/motor.d ./Core/Motores/motor.o ./Core/Motores/motor.su
+	-$(RM) ./Core/Motores/dshot.d ./Core/Motores/dshot.o ./Core/Motores/dshot.su ./Core/Motores/dshot_hal.d ./Core/Motores/dshot_hal.o ./Core/Motores/dshot_hal.su ./Core/Motores/dshot_telemetria.d ./Core/Motores/dshot_telemetria.o ./Core/Motores/dshot_telemetria.su ./Core/Motores/motor.d ./Core/Motores/motor.o ./Core/Motores/motor.su
 
 .PHONY: clean-Core-2f-Motores
 
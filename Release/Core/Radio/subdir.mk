@@ -8,19 +8,22 @@ C_SRCS += \
 ../Core/Radio/ibus.c \
 ../Core/Radio/ppm.c \
 ../Core/Radio/radio.c \
-../Core/Radio/sbus.c 
+../Core/Radio/sbus.c \
+../Core/Radio/trama_radio.c 
 
 OBJS += \
 ./Core/Radio/ibus.o \
 ./Core/Radio/ppm.o \
 ./Core/Radio/radio.o \
-./Core/Radio/sbus.o 
+./Core/Radio/sbus.o \
+./Core/Radio/trama_radio.o 
 
 C_DEPS += \
 ./Core/Radio/ibus.d \
 ./Core/Radio/ppm.d \
 ./Core/Radio/radio.d \
-./Core/Radio/sbus.d 
+./Core/Radio/sbus.d \
+./Core/Radio/trama_radio.d 
 
 
 # Each subdirectory must supply rules for building sources it contributes
@@ -30,7 +33,7 @@ Core/Radio/%.o Core/Radio/%.su: ../Core/Radio/%.c Core/Radio/subdir.mk
 clean: clean-Core-2f-Radio
 
 clean-Core-2f-Radio:
-	-$(RM) ./Core/Radio/ibus.d ./Core/Radio/ibus.o ./Core/Radio/ibus.su ./Core/Radio/ppm.d ./Core/Radio/ppm.o ./Core/Radio/ppm.su ./Core/Radio/radio.d ./Core/Radio/radio.o ./Core/Radio/radio.su ./Core/Radio/sbus.d ./Core/Radio/sbus.o ./Core/Radio/sbus.su
+	-$(RM) ./Core/Radio/ibus.d ./Core/Radio/ibus.o ./Core/Radio/ibus.su ./Core/Radio/ppm.d ./Core/Radio/ppm.o ./Core/Radio/ppm.su ./Core/Radio/radio.d ./Core/Radio/radio.o ./Core/Radio/radio.su ./Core/Radio/sbus.d ./Core/Radio/sbus.o ./Core/Radio/sbus.su ./Core/Radio/trama_radio.d ./Core/Radio/trama_radio.o ./Core/Radio/trama_radio.su
 
 .PHONY: clean-Core-2f-Radio
 
@@ -5,16 +5,19 @@
 
 # Add inputs and outputs from these tool invocations to the build variables 
 C_SRCS += \
+../Core/Sensores/Calibrador/ajuste_mag.c \
 ../Core/Sensores/Calibrador/calibrador.c \
 ../Core/Sensores/Calibrador/calibrador_imu.c \
 ../Core/Sensores/Calibrador/calibrador_mag.c 
 
 OBJS += \
+./Core/Sensores/Calibrador/ajuste_mag.o \
 ./Core/Sensores/Calibrador/calibrador.o \
 ./Core/Sensores/Calibrador/calibrador_imu.o \
 ./Core/Sensores/Calibrador/calibrador_mag.o 
 
 C_DEPS += \
+./Core/Sensores/Calibrador/ajuste_mag.d \
 ./Core/Sensores/Calibrador/calibrador.d \
 ./Core/Sensores/Calibrador/calibrador_imu.d \
 ./Core/Sensores/Calibrador/calibrador_mag.d 
@@ -27,7 +30,7 @@ Core/Sensores/Calibrador/%.o Core/Sensores/Calibrador/%.su: ../Core/Sensores/Cal
 clean: clean-Core-2f-Sensores-2f-Calibrador
 
 clean-Core-2f-Sensores-2f-Calibrador:
-	-$(RM) ./Core/Sensores/Calibrador/calibrador.d ./Core/Sensores/Calibrador/calibrador.o ./Core/Sensores/Calibrador/calibrador.su ./Core/Sensores/Calibrador/calibrador_imu.d ./Core/Sensores/Calibrador/calibrador_imu.o ./Core/Sensores/Calibrador/calibrador_imu.su ./Core/Sensores/Calibrador/calibrador_mag.d ./Core/Sensores/Calibrador/calibrador_mag.o ./Core/Sensores/Calibrador/calibrador_mag.su
+	-$(RM) ./Core/Sensores/Calibrador/ajuste_mag.d ./Core/Sensores/Calibrador/ajuste_mag.o ./Core/Sensores/Calibrador/ajuste_mag.su ./Core/Sensores/Calibrador/calibrador.d ./Core/Sensores/Calibrador/calibrador.o ./Core/Sensores/Calibrador/calibrador.su ./Core/Sensores/Calibrador/calibrador_imu.d ./Core/Sensores/Calibrador/calibrador_imu.o ./Core/Sensores/Calibrador/calibrador_imu.su ./Core/Sensores/Calibrador/calibrador_mag.d ./Core/Sensores/Calibrador/calibrador_mag.o ./Core/Sensores/Calibrador/calibrador_mag.su
 
 .PHONY: clean-Core-2f-Sensores-2f-Calibrador
 
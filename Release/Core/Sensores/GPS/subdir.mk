@@ -5,14 +5,17 @@
 
 # Add inputs and outputs from these tool invocations to the build variables 
 C_SRCS += \
+../Core/Sensores/GPS/analizador_ubx.c \
 ../Core/Sensores/GPS/gps.c \
 ../Core/Sensores/GPS/gps_ublox.c 
 
 OBJS += \
+./Core/Sensores/GPS/analizador_ubx.o \
 ./Core/Sensores/GPS/gps.o \
 ./Core/Sensores/GPS/gps_ublox.o 
 
 C_DEPS += \
+./Core/Sensores/GPS/analizador_ubx.d \
 ./Core/Sensores/GPS/gps.d \
 ./Core/Sensores/GPS/gps_ublox.d 
 
@@ -24,7 +27,7 @@ Core/Sensores/GPS/%.o Core/Sensores/GPS/%.su: ../Core/Sensores/GPS/%.c Core/Sens
 clean: clean-Core-2f-Sensores-2f-GPS
 
 clean-Core-2f-Sensores-2f-GPS:
-	-$(RM) ./Core/Sensores/GPS/gps.d ./Core/Sensores/GPS/gps.o ./Core/Sensores/GPS/gps.su ./Core/Sensores/GPS/gps_ublox.d ./Core/Sensores/GPS/gps_ublox.o ./Core/Sensores/GPS/gps_ublox.su
+	-$(RM) ./Core/Sensores/GPS/analizador_ubx.d ./Core/Sensores/GPS/analizador_ubx.o ./Core/Sensores/GPS/analizador_ubx.su ./Core/Sensores/GPS/gps.d ./Core/Sensores/GPS/gps.o ./Core/Sensores/GPS/gps.su ./Core/Sensores/GPS/gps_ublox.d ./Core/Sensores/GPS/gps_ublox.o ./Core/Sensores/GPS/gps_ublox.su
 
 .PHONY: clean-Core-2f-Sensores-2f-GPS
 
@@ -6,15 +6,18 @@
 # Add inputs and outputs from these tool invocations to the build variables 
 C_SRCS += \
 ../Core/Sensores/IMU/imu.c \
-../Core/Sensores/IMU/imu_invensense.c 
+../Core/Sensores/IMU/imu_invensense.c \
+../Core/Sensores/IMU/votacion_imu.c 
 
 OBJS += \
 ./Core/Sensores/IMU/imu.o \
-./Core/Sensores/IMU/imu_invensense.o 
+./Core/Sensores/IMU/imu_invensense.o \
+./Core/Sensores/IMU/votacion_imu.o 
 
 C_DEPS += \
 ./Core/Sensores/IMU/imu.d \
-./Core/Sensores/IMU/imu_invensense.d 
+./Core/Sensores/IMU/imu_invensense.d \
+./Core/Sensores/IMU/votacion_imu.d 
 
 
 # Each subdirectory must supply rules for building sources it contributes
@@ -24,7 +27,7 @@ Core/Sensores/IMU/%.o Core/Sensores/IMU/%.su: ../Core/Sensores/IMU/%.c Core/Sens
 clean: clean-Core-2f-Sensores-2f-IMU
 
 clean-Core-2f-Sensores-2f-IMU:
-	-$(RM) ./Core/Sensores/IMU/imu.d ./Core/Sensores/IMU/imu.o ./Core/Sensores/IMU/imu.su ./Core/Sensores/IMU/imu_invensense.d ./Core/Sensores/IMU/imu_invensense.o ./Core/Sensores/IMU/imu_invensense.su
+	-$(RM) ./Core/Sensores/IMU/imu.d ./Core/Sensores/IMU/imu.o ./Core/Sensores/IMU/imu.su ./Core/Sensores/IMU/imu_invensense.d ./Core/Sensores/IMU/imu_invensense.o ./Core/Sensores/IMU/imu_invensense.su ./Core/Sensores/IMU/votacion_imu.d ./Core/Sensores/IMU/votacion_imu.o ./Core/Sensores/IMU/votacion_imu.su
 
 .PHONY: clean-Core-2f-Sensores-2f-IMU
 
@@ -0,0 +1,334 @@
+/***************************************************************************************
+**  navegacion_sitl.c - Validacion del filtro de navegacion con una trayectoria simulada
+**
+**
+**  Este fichero forma parte del proyecto URpilot.
+**  Codigo desarrollado por el grupo de investigacion ICON de la Universidad de La Rioja
+**
+**  Autor: Ramon Rico
+**  Fecha de creacion: 17/10/2026
+**  Fecha de modificacion: 17/10/2026
+**
+**  El proyecto URpilot NO es libre. No se puede distribuir y/o modificar este fichero
+**  bajo ningun concepto.
+**
+**  En caso de modificacion y/o solicitud de informacion pongase en contacto con
+**  el grupo de investigacion ICON a traves de: www.unirioja.es/urpilot
+**
+**
+**  Control de versiones del fichero
+**
+**  v1.0  Ramon Rico. Se ha liberado la primera version estable
+**
+****************************************************************************************/
+
+/***************************************************************************************
+** AREA DE INCLUDES                                                                   **
+****************************************************************************************/
+#include <stdio.h>
+#include <string.h>
+#include <math.h>
+
+#include "Core/pruebas_sitl.h"
+
+#ifdef SITL
+#include "AHRS/navegacion.h"
+#include "GP/gp_ahrs.h"
+#include "Drivers/tiempo_sitl.h"
+#include "Fisica/fisica.h"
+#include "Comun/util.h"
+#include "Comun/matematicas.h"
+
+
+/***************************************************************************************
+** AREA DE PREPROCESADOR                                                              **
+****************************************************************************************/
+#define FREC_NAV_SITL                100         // Hz. La del lazo de posicion
+#define FREC_GPS_NAV_SITL            10          // Hz
+#define FREC_BARO_NAV_SITL           50          // Hz
+#define DURACION_NAV_SITL            180.0f      // s
+#define CONVERGENCIA_NAV_SITL        10.0f       // s. No se evalua antes
+#define INICIO_APAGON_GPS_NAV_SITL   100.0f      // s
+#define FIN_APAGON_GPS_NAV_SITL      110.0f      // s
+
+// Trayectoria: circulo horizontal a 5 m/s con subidas y bajadas, y la actitud oscilando
+#define RADIO_CIRCULO_NAV_SITL       20.0f       // m
+#define VEL_ANGULAR_CIRCULO_NAV_SITL 0.25f       // rad/s
+#define ALTURA_NAV_SITL              10.0f       // m
+#define AMPLITUD_ALTURA_NAV_SITL     3.0f        // m
+#define FREC_ALTURA_NAV_SITL         0.2f        // rad/s
+
+// Sensores. El ruido es uniforme: la desviacion tipica es la amplitud / sqrt(3)
+#define RETARDO_GPS_NAV_SITL         0.12f       // s
+#define RUIDO_POS_GPS_NAV_SITL       1.5f        // m
+#define RUIDO_VEL_GPS_NAV_SITL       0.2f        // m/s
+#define PRECISION_H_GPS_NAV_SITL     1.0f        // m. La que informa el receptor
+#define PRECISION_V_GPS_NAV_SITL     1.5f        // m
+#define PRECISION_VEL_GPS_NAV_SITL   0.2f        // m/s
+#define RUIDO_BARO_NAV_SITL          0.5f        // m
+#define DERIVA_BARO_NAV_SITL         0.01f       // m/s
+#define RUIDO_ACEL_NAV_SITL          0.02f       // g
+static const float biasAcelNavSITL[3] = {0.15f, -0.10f, 0.20f};     // m/s² en ejes cuerpo
+
+#define ERROR_MAX_POS_H_NAV_SITL     0.8f        // m RMS
+#define ERROR_MAX_POS_V_NAV_SITL     0.5f        // m RMS
+#define ERROR_MAX_VEL_NAV_SITL       0.25f       // m/s RMS
+#define ERROR_MAX_APAGON_NAV_SITL    5.0f        // m
+#define CONTENCION_MIN_NAV_SITL      95.0f       // % de errores horizontales dentro de 3 sigma
+
+
+/***************************************************************************************
+** AREA DE DEFINICION DE TIPOS                                                        **
+****************************************************************************************/
+typedef struct {
+    float pos[3];
+    float vel[3];
+    float acel[3];
+    float q[4];
+} verdadNavSITL_t;
+
+typedef struct {
+    float rmsPosH;
+    float rmsPosV;
+    float rmsVel;
+    float maxPosHapagon;
+    float contencion;                           // %
+    float errorBias[3];
+    uint32_t numFusionesGPS;
+    uint32_t numRechazosGPS;
+    uint64_t nsPrediccion;
+    uint64_t nsMaxPrediccion;
+    uint64_t nsGPS;
+    uint64_t nsMaxGPS;
+} resultadoNavSITL_t;
+
+
+/***************************************************************************************
+** AREA DE DECLARACION DE VARIABLES                                                   **
+****************************************************************************************/
+static navegacion_t navegacionSITL;
+
+
+/***************************************************************************************
+** AREA DE PROTOTIPOS DE FUNCION                                                      **
+****************************************************************************************/
+void verdadNavSITL(float t, verdadNavSITL_t *verdad);
+void acelMedidaNavSITL(const verdadNavSITL_t *verdad, float *acel);
+void ejecutarNavSITL(uint16_t retardoFiltro, resultadoNavSITL_t *resultado);
+
+
+/***************************************************************************************
+** AREA DE DEFINICION DE FUNCIONES                                                    **
+****************************************************************************************/
+
+/***************************************************************************************
+**  Nombre:         void verdadNavSITL(float t, verdadNavSITL_t *verdad)
+**  Descripcion:    Estado real de la trayectoria
+**  Parametros:     Tiempo en s, estado
+**  Retorno:        Ninguno
+****************************************************************************************/
+void verdadNavSITL(float t, verdadNavSITL_t *verdad)
+{
+    const float w = VEL_ANGULAR_CIRCULO_NAV_SITL;
+    const float wz = FREC_ALTURA_NAV_SITL;
+    const float r = RADIO_CIRCULO_NAV_SITL;
+
+    verdad->pos[0] = r * sinf(w * t);
+    verdad->pos[1] = r * (1 - cosf(w * t));
+    verdad->pos[2] = -ALTURA_NAV_SITL - AMPLITUD_ALTURA_NAV_SITL * sinf(wz * t);
+    verdad->vel[0] = r * w * cosf(w * t);
+    verdad->vel[1] = r * w * sinf(w * t);
+    verdad->vel[2] = -AMPLITUD_ALTURA_NAV_SITL * wz * cosf(wz * t);
+    verdad->acel[0] = -r * w * w * sinf(w * t);
+    verdad->acel[1] = r * w * w * cosf(w * t);
+    verdad->acel[2] = AMPLITUD_ALTURA_NAV_SITL * wz * wz * sinf(wz * t);
+
+    // Actitud ZYX: el yaw sigue al circulo y el roll y el pitch oscilan
+    const float roll = 0.2f * sinf(0.7f * t);
+    const float pitch = 0.15f * cosf(0.5f * t);
+    const float yaw = w * t;
+    const float cr = cosf(roll / 2), sr = sinf(roll / 2);
+    const float cp = cosf(pitch / 2), sp = sinf(pitch / 2);
+    const float cy = cosf(yaw / 2), sy = sinf(yaw / 2);
+
+    verdad->q[0] = cr * cp * cy + sr * sp * sy;
+    verdad->q[1] = sr * cp * cy - cr * sp * sy;
+    verdad->q[2] = cr * sp * cy + sr * cp * sy;
+    verdad->q[3] = cr * cp * sy - sr * sp * cy;
+}
+
+
+/***************************************************************************************
+**  Nombre:         void acelMedidaNavSITL(const verdadNavSITL_t *verdad, float *acel)
+**  Descripcion:    Aceleracion que mide la IMU con el convenio del firmware, con bias y ruido
+**  Parametros:     Estado real, aceleracion en g
+**  Retorno:        Ninguno
+****************************************************************************************/
+void acelMedidaNavSITL(const verdadNavSITL_t *verdad, float *acel)
+{
+    const float *q = verdad->q;
+    float r[3][3], a[3];
+
+    r[0][0] = q[0] * q[0] + q[1] * q[1] - q[2] * q[2] - q[3] * q[3];
+    r[0][1] = 2 * (q[1] * q[2] - q[0] * q[3]);
+    r[0][2] = 2 * (q[1] * q[3] + q[0] * q[2]);
+    r[1][0] = 2 * (q[1] * q[2] + q[0] * q[3]);
+    r[1][1] = q[0] * q[0] - q[1] * q[1] + q[2] * q[2] - q[3] * q[3];
+    r[1][2] = 2 * (q[2] * q[3] - q[0] * q[1]);
+    r[2][0] = 2 * (q[1] * q[3] - q[0] * q[2]);
+    r[2][1] = 2 * (q[2] * q[3] + q[0] * q[1]);
+    r[2][2] = q[0] * q[0] - q[1] * q[1] - q[2] * q[2] + q[3] * q[3];
+
+    a[0] = -verdad->acel[0];
+    a[1] = -verdad->acel[1];
+    a[2] = G_A_MSS - verdad->acel[2];
+
+    for (uint8_t i = 0; i < 3; i++)
+        acel[i] = (r[0][i] * a[0] + r[1][i] * a[1] + r[2][i] * a[2] + biasAcelNavSITL[i]) / G_A_MSS + ruidoFisica(RUIDO_ACEL_NAV_SITL);
+}
+
+
+/***************************************************************************************
+**  Nombre:         void ejecutarNavSITL(uint16_t retardoFiltro, resultadoNavSITL_t *resultado)
+**  Descripcion:    Ejecuta el filtro sobre la trayectoria con un apagon del GPS y compara con
+**                  la verdad
+**  Parametros:     Retardo del GPS que se configura en el filtro en ms, resultado
+**  Retorno:        Ninguno
+****************************************************************************************/
+void ejecutarNavSITL(uint16_t retardoFiltro, resultadoNavSITL_t *resultado)
+{
+    configNavegacion_t config = configAHRS()->navegacion;
+    const uint32_t numPasos = DURACION_NAV_SITL * FREC_NAV_SITL;
+    double sumaPosH = 0, sumaPosV = 0, sumaVel = 0;
+    uint32_t numEvaluados = 0, numContenidos = 0, numPredicciones = 0;
+
+    memset(resultado, 0, sizeof(resultadoNavSITL_t));
+    config.retardoGPS = retardoFiltro;
+    iniciarNavegacion(&navegacionSITL, &config);
+
+    for (uint32_t paso = 0; paso <= numPasos; paso++) {
+        const float t = (float)paso / FREC_NAV_SITL;
+        const uint32_t tiempo = paso * (1000000 / FREC_NAV_SITL);
+        verdadNavSITL_t verdad;
+        float acel[3];
+
+        verdadNavSITL(t, &verdad);
+        acelMedidaNavSITL(&verdad, acel);
+
+        uint64_t inicio = nanosegundosHostSITL();
+        predecirNavegacion(&navegacionSITL, tiempo, verdad.q, acel);
+        uint64_t ns = nanosegundosHostSITL() - inicio;
+
+        resultado->nsPrediccion += ns;
+        resultado->nsMaxPrediccion = MAX(resultado->nsMaxPrediccion, ns);
+        numPredicciones++;
+
+        if (paso % (FREC_NAV_SITL / FREC_BARO_NAV_SITL) == 0)
+            fusionarBaroNavegacion(&navegacionSITL, -verdad.pos[2] + DERIVA_BARO_NAV_SITL * t + ruidoFisica(RUIDO_BARO_NAV_SITL));
+
+        // El GPS llega con retardo: la medida es del estado de hace RETARDO_GPS_NAV_SITL
+        const bool apagon = t >= INICIO_APAGON_GPS_NAV_SITL && t < FIN_APAGON_GPS_NAV_SITL;
+
+        if (paso % (FREC_NAV_SITL / FREC_GPS_NAV_SITL) == 0 && t > RETARDO_GPS_NAV_SITL && !apagon) {
+            verdadNavSITL_t verdadRetrasada;
+            medidaGPSnav_t medida;
+
+            verdadNavSITL(t - RETARDO_GPS_NAV_SITL, &verdadRetrasada);
+
+            for (uint8_t i = 0; i < 3; i++) {
+                medida.pos[i] = verdadRetrasada.pos[i] + ruidoFisica(RUIDO_POS_GPS_NAV_SITL);
+                medida.vel[i] = verdadRetrasada.vel[i] + ruidoFisica(RUIDO_VEL_GPS_NAV_SITL);
+            }
+
+            medida.tiempo = tiempo;
+            medida.precisionHorizontal = PRECISION_H_GPS_NAV_SITL;
+            medida.precisionVertical = PRECISION_V_GPS_NAV_SITL;
+            medida.precisionVel = PRECISION_VEL_GPS_NAV_SITL;
+            medida.tieneVelVertical = true;
+
+            inicio = nanosegundosHostSITL();
+            fusionarGPSnavegacion(&navegacionSITL, &medida);
+            ns = nanosegundosHostSITL() - inicio;
+
+            resultado->nsGPS += ns;
+            resultado->nsMaxGPS = MAX(resultado->nsMaxGPS, ns);
+        }
+
+        if (t < CONVERGENCIA_NAV_SITL)
+            continue;
+
+        // Errores frente a la verdad
+        float pos[3], vel[3], desvPos[3], desvVel[3];
+
+        posicionNavegacion(&navegacionSITL, pos);
+        velocidadNavegacion(&navegacionSITL, vel);
+        desviacionNavegacion(&navegacionSITL, desvPos, desvVel);
+
+        const float errorN = pos[0] - verdad.pos[0];
+        const float errorE = pos[1] - verdad.pos[1];
+        const float errorH = sqrtf(errorN * errorN + errorE * errorE);
+
+        if (apagon) {
+            resultado->maxPosHapagon = MAX(resultado->maxPosHapagon, errorH);
+            continue;
+        }
+
+        sumaPosH += errorH * errorH;
+        sumaPosV += (pos[2] - verdad.pos[2]) * (pos[2] - verdad.pos[2]);
+        for (uint8_t i = 0; i < 3; i++)
+            sumaVel += (vel[i] - verdad.vel[i]) * (vel[i] - verdad.vel[i]);
+
+        if (fabsf(errorN) <= 3 * desvPos[0] && fabsf(errorE) <= 3 * desvPos[1])
+            numContenidos++;
+
+        numEvaluados++;
+    }
+
+    resultado->rmsPosH = sqrtf(sumaPosH / numEvaluados);
+    resultado->rmsPosV = sqrtf(sumaPosV / numEvaluados);
+    resultado->rmsVel = sqrtf(sumaVel / numEvaluados);
+    resultado->contencion = 100.0f * numContenidos / numEvaluados;
+    resultado->numFusionesGPS = navegacionSITL.numFusionesGPS;
+    resultado->numRechazosGPS = navegacionSITL.numRechazosGPS;
+    resultado->nsPrediccion /= numPredicciones;
+    resultado->nsGPS /= navegacionSITL.numFusionesGPS + navegacionSITL.numRechazosGPS;
+
+    for (uint8_t i = 0; i < 3; i++)
+        resultado->errorBias[i] = navegacionSITL.x[IND_BIAS_ACEL_NAV + i] - biasAcelNavSITL[i];
+}
+
+
+/***************************************************************************************
+**  Nombre:         void probarNavegacionSITL(void)
+**  Descripcion:    Compara el filtro con la verdad compensando el retardo del GPS y sin
+**                  compensarlo
+**  Parametros:     Ninguno
+**  Retorno:        Ninguno
+****************************************************************************************/
+void probarNavegacionSITL(void)
+{
+    resultadoNavSITL_t conRetardo, sinRetardo;
+
+    ejecutarNavSITL(RETARDO_GPS_NAV_SITL * 1000, &conRetardo);
+    ejecutarNavSITL(0, &sinRetardo);
+
+    const bool ok = conRetardo.rmsPosH < ERROR_MAX_POS_H_NAV_SITL && conRetardo.rmsPosV < ERROR_MAX_POS_V_NAV_SITL &&
+                    conRetardo.rmsVel < ERROR_MAX_VEL_NAV_SITL && conRetardo.contencion >= CONTENCION_MIN_NAV_SITL &&
+                    conRetardo.maxPosHapagon < ERROR_MAX_APAGON_NAV_SITL &&
+                    conRetardo.rmsPosH < sinRetardo.rmsPosH && conRetardo.rmsVel < sinRetardo.rmsVel;
+
+    printf("\nFiltro de navegacion (SITL, %.0f s a %u Hz, GPS a %u Hz con %.0f ms de retardo)\n", DURACION_NAV_SITL, FREC_NAV_SITL,
+           FREC_GPS_NAV_SITL, RETARDO_GPS_NAV_SITL * 1000);
+    printf("  Con retardo compensado: error RMS pos H %.2f m, V %.2f m, vel %.3f m/s | dentro de 3 sigma %.1f %% | GPS %u fusionados, %u rechazados\n",
+           conRetardo.rmsPosH, conRetardo.rmsPosV, conRetardo.rmsVel, conRetardo.contencion, conRetardo.numFusionesGPS, conRetardo.numRechazosGPS);
+    printf("  Sin compensar:          error RMS pos H %.2f m, V %.2f m, vel %.3f m/s | dentro de 3 sigma %.1f %%\n",
+           sinRetardo.rmsPosH, sinRetardo.rmsPosV, sinRetardo.rmsVel, sinRetardo.contencion);
+    printf("  Apagon del GPS de %.0f s: error maximo pos H %.2f m | error del bias %.3f %.3f %.3f m/s²\n",
+           FIN_APAGON_GPS_NAV_SITL - INICIO_APAGON_GPS_NAV_SITL, conRetardo.maxPosHapagon, conRetardo.errorBias[0], conRetardo.errorBias[1],
+           conRetardo.errorBias[2]);
+    printf("  Coste (ns del host): prediccion media %u, max %u | GPS medio %u, max %u\n", (uint32_t)conRetardo.nsPrediccion,
+           (uint32_t)conRetardo.nsMaxPrediccion, (uint32_t)conRetardo.nsGPS, (uint32_t)conRetardo.nsMaxGPS);
+    printf("  Resultado: %s\n", ok ? "ok" : "fallo");
+}
+
+#endif
@@ -0,0 +1,336 @@
+/***************************************************************************************
+**  blackbox_sd.c - Sustituto del driver SD de la blackbox para el SITL. Escribe el log
+**                  en un fichero del host sin pasar por asyncfatfs
+**
+**
+**  Este fichero forma parte del proyecto URpilot.
+**  Codigo desarrollado por el grupo de investigacion ICON de la Universidad de La Rioja
+**
+**  Autor: Ramon Rico
+**  Fecha de creacion: 17/10/2026
+**  Fecha de modificacion: 17/10/2026
+**
+**  El proyecto URpilot NO es libre. No se puede distribuir y/o modificar este fichero
+**  bajo ningun concepto.
+**
+**  En caso de modificacion y/o solicitud de informacion pongase en contacto con
+**  el grupo de investigacion ICON a traves de: www.unirioja.es/urpilot
+**
+**
+**  Control de versiones del fichero
+**
+**  v1.0  Ramon Rico. Se ha liberado la primera version estable
+**
+****************************************************************************************/
+
+/***************************************************************************************
+** AREA DE INCLUDES                                                                   **
+****************************************************************************************/
+#include <stdio.h>
+#include <stdarg.h>
+#include <string.h>
+
+#include "blackbox_sitl.h"
+
+#if defined(USAR_BLACKBOX) && defined(SITL)
+#include "Blackbox/sd.h"
+#include "Blackbox/asyncfatfs/asyncfatfs.h"
+#include "Comun/matematicas.h"
+#include "Comun/util.h"
+
+
+/***************************************************************************************
+** AREA DE PREPROCESADOR                                                              **
+****************************************************************************************/
+#define NUM_MAX_BYTES_LIBRES_BLACKBOX             256
+
+
+/***************************************************************************************
+** AREA DE DEFINICION DE TIPOS                                                        **
+****************************************************************************************/
+
+
+/***************************************************************************************
+** AREA DE DECLARACION DE VARIABLES                                                   **
+****************************************************************************************/
+static FILE *ficheroLog = NULL;
+static uint32_t bytesEscritos = 0;
+int32_t bytesLibresCabBlackbox;
+
+
+/***************************************************************************************
+** AREA DE PROTOTIPOS DE FUNCION                                                      **
+****************************************************************************************/
+
+
+/***************************************************************************************
+** AREA DE DEFINICION DE FUNCIONES                                                    **
+****************************************************************************************/
+
+/***************************************************************************************
+**  Nombre:         void iniciarSD(void)
+**  Descripcion:    En el SITL no hay tarjeta
+**  Parametros:     Ninguno
+**  Retorno:        Ninguno
+****************************************************************************************/
+void iniciarSD(void)
+{
+}
+
+
+/***************************************************************************************
+**  Nombre:         void afatfs_init(void)
+**  Descripcion:    En el SITL no hay sistema de ficheros FAT
+**  Parametros:     Ninguno
+**  Retorno:        Ninguno
+****************************************************************************************/
+void afatfs_init(void)
+{
+}
+
+
+/***************************************************************************************
+**  Nombre:         void afatfs_poll(void)
+**  Descripcion:    En el SITL no hay sistema de ficheros FAT
+**  Parametros:     Ninguno
+**  Retorno:        Ninguno
+****************************************************************************************/
+void afatfs_poll(void)
+{
+}
+
+
+/***************************************************************************************
+**  Nombre:         bool abrirBlackbox(void)
+**  Descripcion:    Abre el driver blackbox
+**  Parametros:     Ninguno
+**  Retorno:        True si Ok
+****************************************************************************************/
+bool abrirBlackbox(void)
+{
+    return true;
+}
+
+
+/***************************************************************************************
+**  Nombre:         bool iniciarLogBlackbox(void)
+**  Descripcion:    Crea el fichero del log
+**  Parametros:     Ninguno
+**  Retorno:        True si Ok
+****************************************************************************************/
+bool iniciarLogBlackbox(void)
+{
+    if (ficheroLog == NULL) {
+        ficheroLog = fopen(FICHERO_LOG_BLACKBOX_SITL, "wb");
+        bytesEscritos = 0;
+    }
+
+    return ficheroLog != NULL;
+}
+
+
+/***************************************************************************************
+**  Nombre:         bool finalizarLogBlackbox(bool logEmpezado)
+**  Descripcion:    Cierra el fichero del log
+**  Parametros:     Log empezado
+**  Retorno:        True si OK
+****************************************************************************************/
+bool finalizarLogBlackbox(bool logEmpezado)
+{
+    UNUSED(logEmpezado);
+
+    if (ficheroLog != NULL) {
+        fclose(ficheroLog);
+        ficheroLog = NULL;
+    }
+
+    return true;
+}
+
+
+/***************************************************************************************
+**  Nombre:         void escribirBlackbox(uint8_t valor)
+**  Descripcion:    Escribe un dato en la blackbox
+**  Parametros:     Dato a escribir
+**  Retorno:        Ninguno
+****************************************************************************************/
+void escribirBlackbox(uint8_t valor)
+{
+    escribirBufferBlackbox(&valor, 1);
+}
+
+
+/***************************************************************************************
+**  Nombre:         uint32_t escribirStringBlackbox(const char *s)
+**  Descripcion:    Escribe un string en la blackbox
+**  Parametros:     String a escribir
+**  Retorno:        Numero de bytes escritos
+****************************************************************************************/
+uint32_t escribirStringBlackbox(const char *s)
+{
+    uint32_t longitud = strlen(s);
+
+    escribirBufferBlackbox((const uint8_t *)s, longitud);
+    return longitud;
+}
+
+
+/***************************************************************************************
+**  Nombre:         void escribirBufferBlackbox(const uint8_t *buf, uint32_t longitud)
+**  Descripcion:    Escribe un bloque de bytes en la blackbox
+**  Parametros:     Buffer, numero de bytes
+**  Retorno:        Ninguno
+****************************************************************************************/
+void escribirBufferBlackbox(const uint8_t *buf, uint32_t longitud)
+{
+    if (ficheroLog == NULL)
+        return;
+
+    bytesEscritos += fwrite(buf, 1, longitud, ficheroLog);
+}
+
+
+/***************************************************************************************
+**  Nombre:         uint32_t printfBlackbox(const char *fmt, ...)
+**  Descripcion:    Escribe un string con datos variables en la blackbox
+**  Parametros:     Argumentos genericos
+**  Retorno:        Numero de bytes escritos
+****************************************************************************************/
+uint32_t printfBlackbox(const char *fmt, ...)
+{
+    va_list va;
+    char stringEscritura[64];
+
+    va_start(va, fmt);
+    vsnprintf(stringEscritura, sizeof(stringEscritura), fmt, va);
+    va_end(va);
+
+    return escribirStringBlackbox(stringEscritura);
+}
+
+
+/***************************************************************************************
+**  Nombre:         void escribirLineaCabeceraBlackbox(const char *nombre, const char *fmt, ...)
+**  Descripcion:    Escribe una linea de informacion del sistema
+**  Parametros:     String a escribir, argumentos genericos
+**  Retorno:        Ninguno
+****************************************************************************************/
+void escribirLineaCabeceraBlackbox(const char *nombre, const char *fmt, ...)
+{
+    va_list va;
+    char stringEscritura[64];
+
+    escribirBlackbox('C');
+    escribirBlackbox(' ');
+    uint32_t bytes = escribirStringBlackbox(nombre);
+    escribirBlackbox(':');
+
+    va_start(va, fmt);
+    vsnprintf(stringEscritura, sizeof(stringEscritura), fmt, va);
+    va_end(va);
+
+    bytes += escribirStringBlackbox(stringEscritura);
+    escribirBlackbox('\n');
+    bytesLibresCabBlackbox -= bytes + 3;
+}
+
+
+/***************************************************************************************
+**  Nombre:         void calcularBytesLibresCabBlackbox(void)
+**  Descripcion:    Calcula los bytes libres para escribir en la blackbox
+**  Parametros:     Ninguno
+**  Retorno:        Ninguno
+****************************************************************************************/
+void calcularBytesLibresCabBlackbox(void)
+{
+    bytesLibresCabBlackbox = MIN(bytesLibresCabBlackbox + BYTES_LIBRES_CAB_POR_ITERACION_BLACKBOX, NUM_MAX_BYTES_LIBRES_BLACKBOX);
+}
+
+
+/***************************************************************************************
+**  Nombre:         bool blackboxLlena(void)
+**  Descripcion:    El fichero del host no se llena
+**  Parametros:     Ninguno
+**  Retorno:        False
+****************************************************************************************/
+bool blackboxLlena(void)
+{
+    return false;
+}
+
+
+/***************************************************************************************
+**  Nombre:         bool forzarFlushCompletoBlackbox(void)
+**  Descripcion:    Vacia el buffer del fichero
+**  Parametros:     Ninguno
+**  Retorno:        True si OK
+****************************************************************************************/
+bool forzarFlushCompletoBlackbox(void)
+{
+    return forzarFlushBlackbox();
+}
+
+
+/***************************************************************************************
+**  Nombre:         bool forzarFlushBlackbox(void)
+**  Descripcion:    Vacia el buffer del fichero
+**  Parametros:     Ninguno
+**  Retorno:        True si OK
+****************************************************************************************/
+bool forzarFlushBlackbox(void)
+{
+    if (ficheroLog != NULL)
+        fflush(ficheroLog);
+
+    return true;
+}
+
+
+/***************************************************************************************
+**  Nombre:         bool trabajandoBlackbox(void)
+**  Descripcion:    Comprueba si la blackbox esta trabajando
+**  Parametros:     Ninguno
+**  Retorno:        True si el fichero esta abierto
+****************************************************************************************/
+bool trabajandoBlackbox(void)
+{
+    return ficheroLog != NULL;
+}
+
+
+/***************************************************************************************
+**  Nombre:         int32_t numeroLogBlackbox(void)
+**  Descripcion:    Devuelve el numero del fichero log
+**  Parametros:     Ninguno
+**  Retorno:        Numero de log
+****************************************************************************************/
+int32_t numeroLogBlackbox(void)
+{
+    return 1;
+}
+
+
+/***************************************************************************************
+**  Nombre:         bool comprobarEspacioBlackbox(int32_t numBytes)
+**  Descripcion:    Comprueba si hay bytes libres para la cabecera
+**  Parametros:     Numero de bytes
+**  Retorno:        True si OK
+****************************************************************************************/
+bool comprobarEspacioBlackbox(int32_t numBytes)
+{
+    return numBytes <= bytesLibresCabBlackbox;
+}
+
+
+/***************************************************************************************
+**  Nombre:         uint32_t bytesEscritosBlackboxSITL(void)
+**  Descripcion:    Devuelve los bytes escritos en el log
+**  Parametros:     Ninguno
+**  Retorno:        Bytes
+****************************************************************************************/
+uint32_t bytesEscritosBlackboxSITL(void)
+{
+    return bytesEscritos;
+}
+
+#endif
@@ -0,0 +1,295 @@
+/***************************************************************************************
+**  crc_sitl.c - Pruebas y coste de los CRC con tabla y con la unidad CRC
+**
+**
+**  Este fichero forma parte del proyecto URpilot.
+**  Codigo desarrollado por el grupo de investigacion ICON de la Universidad de La Rioja
+**
+**  Autor: Ramon Rico
+**  Fecha de creacion: 17/10/2026
+**  Fecha de modificacion: 17/10/2026
+**
+**  El proyecto URpilot NO es libre. No se puede distribuir y/o modificar este fichero
+**  bajo ningun concepto.
+**
+**  En caso de modificacion y/o solicitud de informacion pongase en contacto con
+**  el grupo de investigacion ICON a traves de: www.unirioja.es/urpilot
+**
+**
+**  Control de versiones del fichero
+**
+**  v1.0  Ramon Rico. Se ha liberado la primera version estable
+**
+****************************************************************************************/
+
+/***************************************************************************************
+** AREA DE INCLUDES                                                                   **
+****************************************************************************************/
+#include <stdio.h>
+#include <string.h>
+#include <stdlib.h>
+
+#include "Core/pruebas_sitl.h"
+#include "Drivers/crc_sitl.h"
+
+#ifdef SITL
+#include "Comun/crc.h"
+#include "Drivers/tiempo_sitl.h"
+#include "Comun/matematicas.h"
+
+
+/***************************************************************************************
+** AREA DE PREPROCESADOR                                                              **
+****************************************************************************************/
+#define TAM_BUFFER_CRC_SITL          1024
+#define NUM_PRUEBAS_CRC_SITL         2000        // Bloques aleatorios por fase
+#define TAM_COSTE_CRC_SITL           4096        // Bytes por bloque en la medida del coste
+#define ITERACIONES_COSTE_CRC_SITL   2000
+
+// Valores de comprobacion de "123456789" de cada variante
+#define COMPROBACION_CRC8_SITL       0xBC
+#define COMPROBACION_CRC16_SITL      0x29B1
+#define COMPROBACION_CRC32_SITL      0xCBF43926
+
+
+/***************************************************************************************
+** AREA DE DEFINICION DE TIPOS                                                        **
+****************************************************************************************/
+typedef struct {
+    uint32_t numBloques;
+    uint32_t fallosCRC8;
+    uint32_t fallosCRC16;
+    uint32_t fallosCRC32;
+} resultadoCRCsitl_t;
+
+
+/***************************************************************************************
+** AREA DE DECLARACION DE VARIABLES                                                   **
+****************************************************************************************/
+static uint8_t bufferCRCsitl[TAM_BUFFER_CRC_SITL + 4];
+static uint8_t bufferCosteCRCsitl[TAM_COSTE_CRC_SITL];
+static volatile uint32_t sumideroCRCsitl;
+
+
+/***************************************************************************************
+** AREA DE PROTOTIPOS DE FUNCION                                                      **
+****************************************************************************************/
+uint16_t bitsCRC16sitl(uint16_t crc, const uint8_t *dato, uint32_t longitud);
+uint8_t bitsCRC8sitl(uint8_t crc, const uint8_t *dato, uint32_t longitud);
+uint32_t bitsCRC32sitl(uint32_t crc, const uint8_t *dato, uint32_t longitud);
+void compararCRCsitl(resultadoCRCsitl_t *resultado);
+bool comprobarValoresCRCsitl(void);
+void medirCosteCRCsitl(void);
+
+
+/***************************************************************************************
+** AREA DE DEFINICION DE FUNCIONES                                                    **
+****************************************************************************************/
+
+/***************************************************************************************
+**  Nombre:         uint16_t bitsCRC16sitl(uint16_t crc, const uint8_t *dato, uint32_t longitud)
+**  Descripcion:    CRC16 bit a bit. Es el calculo que tenia crc.c antes de las tablas
+**  Parametros:     CRC, datos, longitud
+**  Retorno:        CRC
+****************************************************************************************/
+uint16_t bitsCRC16sitl(uint16_t crc, const uint8_t *dato, uint32_t longitud)
+{
+    for (uint32_t n = 0; n < longitud; n++) {
+        crc ^= (uint16_t)dato[n] << 8;
+
+        for (int i = 0; i < 8; ++i) {
+            if (crc & 0x8000)
+                crc = (crc << 1) ^ 0x1021;
+            else
+                crc = crc << 1;
+        }
+    }
+
+    return crc;
+}
+
+
+/***************************************************************************************
+**  Nombre:         uint8_t bitsCRC8sitl(uint8_t crc, const uint8_t *dato, uint32_t longitud)
+**  Descripcion:    CRC8 DVB-S2 bit a bit
+**  Parametros:     CRC, datos, longitud
+**  Retorno:        CRC
+****************************************************************************************/
+uint8_t bitsCRC8sitl(uint8_t crc, const uint8_t *dato, uint32_t longitud)
+{
+    for (uint32_t n = 0; n < longitud; n++) {
+        crc ^= dato[n];
+
+        for (int i = 0; i < 8; ++i) {
+            if (crc & 0x80)
+                crc = (crc << 1) ^ POLINOMIO_CRC8;
+            else
+                crc = crc << 1;
+        }
+    }
+
+    return crc;
+}
+
+
+/***************************************************************************************
+**  Nombre:         uint32_t bitsCRC32sitl(uint32_t crc, const uint8_t *dato, uint32_t longitud)
+**  Descripcion:    CRC32 reflejado bit a bit, sin el XOR final
+**  Parametros:     CRC, datos, longitud
+**  Retorno:        CRC
+****************************************************************************************/
+uint32_t bitsCRC32sitl(uint32_t crc, const uint8_t *dato, uint32_t longitud)
+{
+    for (uint32_t n = 0; n < longitud; n++) {
+        crc ^= dato[n];
+
+        for (int i = 0; i < 8; ++i) {
+            if (crc & 1)
+                crc = (crc >> 1) ^ 0xEDB88320;
+            else
+                crc = crc >> 1;
+        }
+    }
+
+    return crc;
+}
+
+
+/***************************************************************************************
+**  Nombre:         void compararCRCsitl(resultadoCRCsitl_t *resultado)
+**  Descripcion:    Compara los CRC del modulo con los de bit a bit en bloques de longitud y
+**                  alineacion aleatorias. Cada bloque se calcula entero y partido en trozos
+**                  aleatorios, de forma que se encadenan estados de la tabla y de la unidad
+**  Parametros:     Resultado
+**  Retorno:        Ninguno
+****************************************************************************************/
+void compararCRCsitl(resultadoCRCsitl_t *resultado)
+{
+    memset(resultado, 0, sizeof(resultadoCRCsitl_t));
+
+    for (uint32_t n = 0; n < NUM_PRUEBAS_CRC_SITL; n++) {
+        const uint8_t desplazamiento = rand() % 4;
+        const uint32_t longitud = rand() % (TAM_BUFFER_CRC_SITL + 1);
+        const uint8_t *dato = &bufferCRCsitl[desplazamiento];
+
+        for (uint32_t i = 0; i < longitud; i++)
+            bufferCRCsitl[desplazamiento + i] = rand();
+
+        const uint8_t ref8 = bitsCRC8sitl(VALOR_INICIO_CRC8, dato, longitud);
+        const uint16_t ref16 = bitsCRC16sitl(VALOR_INICIO_CRC16, dato, longitud);
+        const uint32_t ref32 = bitsCRC32sitl(VALOR_INICIO_CRC32, dato, longitud) ^ 0xFFFFFFFF;
+
+        uint8_t crc8 = iniciarCRC8();
+        uint16_t crc16 = iniciarCRC16();
+        uint32_t crc32 = iniciarCRC32();
+        uint32_t posicion = 0;
+
+        while (posicion < longitud) {
+            const uint32_t trozo = MIN(longitud - posicion, (uint32_t)(rand() % 80));
+
+            crc8 = actualizarCRC8(crc8, dato + posicion, trozo);
+            crc16 = actualizarCRC16(crc16, dato + posicion, trozo);
+            crc32 = actualizarCRC32(crc32, dato + posicion, trozo);
+            posicion += trozo;
+        }
+
+        resultado->numBloques++;
+        resultado->fallosCRC8 += (calcularCRC8(dato, longitud) != ref8) + (finalizarCRC8(crc8) != ref8);
+        resultado->fallosCRC16 += (calcularCRC16(dato, longitud) != ref16) + (finalizarCRC16(crc16) != ref16);
+        resultado->fallosCRC32 += (calcularCRC32(dato, longitud) != ref32) + (finalizarCRC32(crc32) != ref32);
+    }
+}
+
+
+/***************************************************************************************
+**  Nombre:         bool comprobarValoresCRCsitl(void)
+**  Descripcion:    Comprueba los valores publicados de cada variante
+**  Parametros:     Ninguno
+**  Retorno:        True si coinciden
+****************************************************************************************/
+bool comprobarValoresCRCsitl(void)
+{
+    const char *comprobacion = "123456789";
+    const uint32_t longitud = strlen(comprobacion);
+
+    return calcularCRC8(comprobacion, longitud) == COMPROBACION_CRC8_SITL &&
+           calcularCRC16(comprobacion, longitud) == COMPROBACION_CRC16_SITL &&
+           calcularCRC32(comprobacion, longitud) == COMPROBACION_CRC32_SITL;
+}
+
+
+/***************************************************************************************
+**  Nombre:         void medirCosteCRCsitl(void)
+**  Descripcion:    Bytes por ns del calculo bit a bit y con tabla. En el host ciclosCPU()
+**                  cuenta ns, asi que es la misma cifra que los bytes por ciclo del micro
+**  Parametros:     Ninguno
+**  Retorno:        Ninguno
+****************************************************************************************/
+void medirCosteCRCsitl(void)
+{
+    const double bytes = (double)TAM_COSTE_CRC_SITL * ITERACIONES_COSTE_CRC_SITL;
+    double ns[6];
+    uint64_t inicio;
+
+    for (uint32_t i = 0; i < TAM_COSTE_CRC_SITL; i++)
+        bufferCosteCRCsitl[i] = rand();
+
+#define MEDIR_COSTE_CRC_SITL(indice, expresion)                            \
+    do {                                                                   \
+        inicio = nanosegundosHostSITL();                                   \
+        for (uint32_t k = 0; k < ITERACIONES_COSTE_CRC_SITL; k++)          \
+            sumideroCRCsitl = (expresion);                                 \
+        ns[indice] = (double)(nanosegundosHostSITL() - inicio);            \
+    } while (0)
+
+    MEDIR_COSTE_CRC_SITL(0, bitsCRC8sitl(sumideroCRCsitl, bufferCosteCRCsitl, TAM_COSTE_CRC_SITL));
+    MEDIR_COSTE_CRC_SITL(1, actualizarCRC8(sumideroCRCsitl, bufferCosteCRCsitl, TAM_COSTE_CRC_SITL));
+    MEDIR_COSTE_CRC_SITL(2, bitsCRC16sitl(sumideroCRCsitl, bufferCosteCRCsitl, TAM_COSTE_CRC_SITL));
+    MEDIR_COSTE_CRC_SITL(3, actualizarCRC16(sumideroCRCsitl, bufferCosteCRCsitl, TAM_COSTE_CRC_SITL));
+    MEDIR_COSTE_CRC_SITL(4, bitsCRC32sitl(sumideroCRCsitl, bufferCosteCRCsitl, TAM_COSTE_CRC_SITL));
+    MEDIR_COSTE_CRC_SITL(5, actualizarCRC32(sumideroCRCsitl, bufferCosteCRCsitl, TAM_COSTE_CRC_SITL));
+
+#undef MEDIR_COSTE_CRC_SITL
+
+    printf("  Coste (bytes/ns, bit a bit -> tabla): CRC8 %.3f -> %.3f | CRC16 %.3f -> %.3f | CRC32 %.3f -> %.3f\n",
+           bytes / ns[0], bytes / ns[1], bytes / ns[2], bytes / ns[3], bytes / ns[4], bytes / ns[5]);
+}
+
+
+/***************************************************************************************
+**  Nombre:         void probarCRCsitl(void)
+**  Descripcion:    Comprueba los CRC con tabla frente a los de bit a bit y despues con la
+**                  unidad CRC emulada para los bloques largos. Mide el coste de las tablas
+**  Parametros:     Ninguno
+**  Retorno:        Ninguno
+****************************************************************************************/
+void probarCRCsitl(void)
+{
+    resultadoCRCsitl_t tabla, hardware;
+    bool ok;
+
+    printf("\nCRC8, CRC16 y CRC32 (SITL)\n");
+
+    // Hasta que se inicia la unidad todo va por las tablas
+    srand(17);
+    ok = comprobarValoresCRCsitl();
+    compararCRCsitl(&tabla);
+    medirCosteCRCsitl();
+
+    iniciarCRC();
+    ok = ok && comprobarValoresCRCsitl();
+    compararCRCsitl(&hardware);
+
+    printf("  Tabla: %u bloques, fallos CRC8 %u, CRC16 %u, CRC32 %u\n", tabla.numBloques, tabla.fallosCRC8, tabla.fallosCRC16,
+           tabla.fallosCRC32);
+    printf("  Con la unidad CRC a partir de %u bytes: %u bloques (%u calculados por la unidad), fallos CRC8 %u, CRC16 %u, CRC32 %u\n",
+           LONGITUD_MIN_CRC_HW, hardware.numBloques, calculosCRChardwareSITL(), hardware.fallosCRC8, hardware.fallosCRC16,
+           hardware.fallosCRC32);
+
+    ok = ok && tabla.fallosCRC8 == 0 && tabla.fallosCRC16 == 0 && tabla.fallosCRC32 == 0;
+    ok = ok && hardware.fallosCRC8 == 0 && hardware.fallosCRC16 == 0 && hardware.fallosCRC32 == 0 && calculosCRChardwareSITL() > 0;
+
+    printf("  Resultado: %s\n", ok ? "ok" : "fallo");
+}
+
+#endif
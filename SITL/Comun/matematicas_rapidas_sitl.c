@@ -0,0 +1,322 @@
+/***************************************************************************************
+**  matematicas_rapidas_sitl.c - Barrido de error y coste de las aproximaciones rapidas
+**
+**
+**  Este fichero forma parte del proyecto URpilot.
+**  Codigo desarrollado por el grupo de investigacion ICON de la Universidad de La Rioja
+**
+**  Autor: Ramon Rico
+**  Fecha de creacion: 17/10/2026
+**  Fecha de modificacion: 17/10/2026
+**
+**  El proyecto URpilot NO es libre. No se puede distribuir y/o modificar este fichero
+**  bajo ningun concepto.
+**
+**  En caso de modificacion y/o solicitud de informacion pongase en contacto con
+**  el grupo de investigacion ICON a traves de: www.unirioja.es/urpilot
+**
+**
+**  Control de versiones del fichero
+**
+**  v1.0  Ramon Rico. Se ha liberado la primera version estable
+**
+****************************************************************************************/
+
+/***************************************************************************************
+** AREA DE INCLUDES                                                                   **
+****************************************************************************************/
+#include <stdio.h>
+#include <string.h>
+#include <math.h>
+
+#include "Core/pruebas_sitl.h"
+
+#ifdef SITL
+#include "Comun/matematicas_rapidas.h"
+#include "Drivers/tiempo_sitl.h"
+#include "Fisica/fisica.h"
+
+
+/***************************************************************************************
+** AREA DE PREPROCESADOR                                                              **
+****************************************************************************************/
+#define NUM_PUNTOS_BARRIDO_SITL      2000000     // Puntos por funcion
+#define NUM_PUNTOS_COSTE_SITL        1024
+#define ITERACIONES_COSTE_SITL       2000        // Pasadas sobre los puntos de coste
+
+#define ARGUMENTO_MIN_LOG_SITL       1e-30f
+#define ARGUMENTO_MAX_LOG_SITL       1e30f
+#define EXPONENTE_MAX_POW_SITL       8.0f        // |y * log2(x)|
+
+
+/***************************************************************************************
+** AREA DE DEFINICION DE TIPOS                                                        **
+****************************************************************************************/
+typedef float (*funcionRapidaSITL)(float x);
+typedef double (*funcionReferenciaSITL)(double x);
+
+typedef struct {
+    const char *nombre;
+    funcionRapidaSITL rapida;
+    funcionReferenciaSITL referencia;
+    float minimo;
+    float maximo;
+    bool logaritmico;                           // Barrido equiespaciado en log(x)
+    bool relativo;
+    float errorMax;
+} barridoSITL_t;
+
+
+/***************************************************************************************
+** AREA DE DECLARACION DE VARIABLES                                                   **
+****************************************************************************************/
+static const barridoSITL_t barridosSITL[] = {
+    {"asin", asinRapido, asin, -1.0f, 1.0f, false, false, ERROR_MAX_ASIN_RAPIDO},
+    {"exp", expRapido, exp, ARGUMENTO_MIN_EXP_RAPIDO, ARGUMENTO_MAX_EXP_RAPIDO, false, true, ERROR_MAX_EXP_RAPIDO},
+    {"exp2", exp2Rapido, exp2, ARGUMENTO_MIN_EXP_RAPIDO * 1.442695f, ARGUMENTO_MAX_EXP_RAPIDO * 1.442695f, false, true, ERROR_MAX_EXP2_RAPIDO},
+    {"log", logRapido, log, ARGUMENTO_MIN_LOG_SITL, ARGUMENTO_MAX_LOG_SITL, true, false, ERROR_MAX_LOG_RAPIDO},
+    {"log2", log2Rapido, log2, ARGUMENTO_MIN_LOG_SITL, ARGUMENTO_MAX_LOG_SITL, true, false, ERROR_MAX_LOG2_RAPIDO},
+};
+
+static volatile float sumideroRapidasSITL;
+static float argumentoCosteSITL[2][NUM_PUNTOS_COSTE_SITL];
+
+
+/***************************************************************************************
+** AREA DE PROTOTIPOS DE FUNCION                                                      **
+****************************************************************************************/
+float puntoBarridoSITL(float minimo, float maximo, bool logaritmico, uint32_t i);
+float errorBarridoSITL(const barridoSITL_t *barrido);
+float errorAtan2SITL(void);
+float errorSenCosSITL(void);
+float errorPowSITL(void);
+void medirCosteRapidasSITL(void);
+
+
+/***************************************************************************************
+** AREA DE DEFINICION DE FUNCIONES                                                    **
+****************************************************************************************/
+
+/***************************************************************************************
+**  Nombre:         float puntoBarridoSITL(float minimo, float maximo, bool logaritmico, uint32_t i)
+**  Descripcion:    Punto i del barrido de un intervalo
+**  Parametros:     Extremos, espaciado logaritmico, indice
+**  Retorno:        Argumento
+****************************************************************************************/
+float puntoBarridoSITL(float minimo, float maximo, bool logaritmico, uint32_t i)
+{
+    const double t = (double)i / (NUM_PUNTOS_BARRIDO_SITL - 1);
+
+    if (logaritmico)
+        return exp(log(minimo) + t * (log(maximo) - log(minimo)));
+
+    return minimo + t * ((double)maximo - minimo);
+}
+
+
+/***************************************************************************************
+**  Nombre:         float errorBarridoSITL(const barridoSITL_t *barrido)
+**  Descripcion:    Error maximo de una funcion de un argumento frente a la referencia en doble
+**  Parametros:     Barrido
+**  Retorno:        Error maximo absoluto o relativo
+****************************************************************************************/
+float errorBarridoSITL(const barridoSITL_t *barrido)
+{
+    double errorMax = 0;
+
+    for (uint32_t i = 0; i < NUM_PUNTOS_BARRIDO_SITL; i++) {
+        const float x = puntoBarridoSITL(barrido->minimo, barrido->maximo, barrido->logaritmico, i);
+        const double referencia = barrido->referencia(x);
+        double error = fabs(barrido->rapida(x) - referencia);
+
+        if (barrido->relativo)
+            error /= fabs(referencia);
+
+        errorMax = fmax(errorMax, error);
+    }
+
+    return errorMax;
+}
+
+
+/***************************************************************************************
+**  Nombre:         float errorAtan2SITL(void)
+**  Descripcion:    Error maximo de atan2Rapido dando vueltas completas con radios de 1e-3 a 1e3
+**  Parametros:     Ninguno
+**  Retorno:        Error maximo en rad
+****************************************************************************************/
+float errorAtan2SITL(void)
+{
+    double errorMax = 0;
+
+    for (uint32_t i = 0; i < NUM_PUNTOS_BARRIDO_SITL; i++) {
+        const double angulo = -M_PI + 2 * M_PI * i / NUM_PUNTOS_BARRIDO_SITL;
+        const double radio = pow(10.0, -3.0 + 6.0 * (i % 97) / 96);
+        const float x = radio * cos(angulo);
+        const float y = radio * sin(angulo);
+        double error = fabs(atan2Rapido(y, x) - atan2(y, x));
+
+        // -pi y pi son el mismo angulo
+        if (error > M_PI)
+            error = fabs(error - 2 * M_PI);
+
+        errorMax = fmax(errorMax, error);
+    }
+
+    return errorMax;
+}
+
+
+/***************************************************************************************
+**  Nombre:         float errorSenCosSITL(void)
+**  Descripcion:    Error maximo de senCosRapido en todo el dominio
+**  Parametros:     Ninguno
+**  Retorno:        Error maximo absoluto del seno y del coseno
+****************************************************************************************/
+float errorSenCosSITL(void)
+{
+    double errorMax = 0;
+
+    for (uint32_t i = 0; i < NUM_PUNTOS_BARRIDO_SITL; i++) {
+        const float x = puntoBarridoSITL(-ARGUMENTO_MAX_SEN_COS_RAPIDO, ARGUMENTO_MAX_SEN_COS_RAPIDO, false, i);
+        float s, c;
+
+        senCosRapido(x, &s, &c);
+        errorMax = fmax(errorMax, fabs(s - sin(x)));
+        errorMax = fmax(errorMax, fabs(c - cos(x)));
+    }
+
+    return errorMax;
+}
+
+
+/***************************************************************************************
+**  Nombre:         float errorPowSITL(void)
+**  Descripcion:    Error maximo relativo de powRapido con bases de 1e-3 a 1e3 y exponentes
+**                  que dejan |y * log2(x)| <= EXPONENTE_MAX_POW_SITL
+**  Parametros:     Ninguno
+**  Retorno:        Error maximo relativo
+****************************************************************************************/
+float errorPowSITL(void)
+{
+    double errorMax = 0;
+
+    for (uint32_t i = 0; i < NUM_PUNTOS_BARRIDO_SITL; i++) {
+        const float x = puntoBarridoSITL(1e-3f, 1e3f, true, i);
+        const double exponenteMax = EXPONENTE_MAX_POW_SITL / fmax(fabs(log2(x)), 1e-3);
+        const float y = fmin(exponenteMax, 4.0) * (-1.0 + 2.0 * (i % 101) / 100);
+        const double referencia = pow(x, y);
+
+        errorMax = fmax(errorMax, fabs(powRapido(x, y) - referencia) / referencia);
+    }
+
+    return errorMax;
+}
+
+
+/***************************************************************************************
+**  Nombre:         void medirCosteRapidasSITL(void)
+**  Descripcion:    Tiempo por llamada de cada aproximacion frente a la de la libreria en
+**                  simple precision
+**  Parametros:     Ninguno
+**  Retorno:        Ninguno
+****************************************************************************************/
+void medirCosteRapidasSITL(void)
+{
+    const uint32_t n = NUM_PUNTOS_COSTE_SITL * ITERACIONES_COSTE_SITL;
+    double nsLibreria[8], nsRapida[8];
+    uint64_t inicio;
+    float suma;
+
+    for (uint16_t i = 0; i < NUM_PUNTOS_COSTE_SITL; i++) {
+        argumentoCosteSITL[0][i] = ruidoFisica(1.0f);
+        argumentoCosteSITL[1][i] = ruidoFisica(1.0f);
+    }
+
+#define MEDIR_COSTE_SITL(ns, expresion)                                    \
+    do {                                                                   \
+        suma = 0;                                                          \
+        inicio = nanosegundosHostSITL();                                   \
+        for (uint32_t k = 0; k < ITERACIONES_COSTE_SITL; k++) {            \
+            for (uint16_t i = 0; i < NUM_PUNTOS_COSTE_SITL; i++) {         \
+                const float a = argumentoCosteSITL[0][i];                  \
+                const float b = argumentoCosteSITL[1][i];                  \
+                (void)b;                                                   \
+                suma += (expresion);                                       \
+            }                                                              \
+        }                                                                  \
+        ns = (double)(nanosegundosHostSITL() - inicio) / n;                \
+        sumideroRapidasSITL = suma;                                        \
+    } while (0)
+
+    float s, c;
+
+    MEDIR_COSTE_SITL(nsLibreria[0], atan2f(a, b));
+    MEDIR_COSTE_SITL(nsRapida[0], atan2Rapido(a, b));
+    MEDIR_COSTE_SITL(nsLibreria[1], asinf(a));
+    MEDIR_COSTE_SITL(nsRapida[1], asinRapido(a));
+    MEDIR_COSTE_SITL(nsLibreria[2], sinf(8 * a) + cosf(8 * a));
+    MEDIR_COSTE_SITL(nsRapida[2], (senCosRapido(8 * a, &s, &c), s + c));
+    MEDIR_COSTE_SITL(nsLibreria[3], expf(8 * a));
+    MEDIR_COSTE_SITL(nsRapida[3], expRapido(8 * a));
+    MEDIR_COSTE_SITL(nsLibreria[4], exp2f(8 * a));
+    MEDIR_COSTE_SITL(nsRapida[4], exp2Rapido(8 * a));
+    MEDIR_COSTE_SITL(nsLibreria[5], logf(a + 1.5f));
+    MEDIR_COSTE_SITL(nsRapida[5], logRapido(a + 1.5f));
+    MEDIR_COSTE_SITL(nsLibreria[6], log2f(a + 1.5f));
+    MEDIR_COSTE_SITL(nsRapida[6], log2Rapido(a + 1.5f));
+    MEDIR_COSTE_SITL(nsLibreria[7], powf(a + 1.5f, 0.190259f));
+    MEDIR_COSTE_SITL(nsRapida[7], powRapido(a + 1.5f, 0.190259f));
+
+#undef MEDIR_COSTE_SITL
+
+    printf("  Coste (libreria -> rapida, ns): atan2 %.1f -> %.1f | asin %.1f -> %.1f | sen+cos %.1f -> %.1f | exp %.1f -> %.1f"
+           " | exp2 %.1f -> %.1f | log %.1f -> %.1f | log2 %.1f -> %.1f | pow %.1f -> %.1f\n",
+           nsLibreria[0], nsRapida[0], nsLibreria[1], nsRapida[1], nsLibreria[2], nsRapida[2], nsLibreria[3], nsRapida[3],
+           nsLibreria[4], nsRapida[4], nsLibreria[5], nsRapida[5], nsLibreria[6], nsRapida[6], nsLibreria[7], nsRapida[7]);
+}
+
+
+/***************************************************************************************
+**  Nombre:         void probarMatematicasRapidasSITL(void)
+**  Descripcion:    Barre cada aproximacion en su dominio, comprueba que el error no pasa del
+**                  maximo documentado y mide el coste frente a la libreria
+**  Parametros:     Ninguno
+**  Retorno:        Ninguno
+****************************************************************************************/
+void probarMatematicasRapidasSITL(void)
+{
+    bool ok = true;
+    float error;
+
+    printf("\nAproximaciones rapidas (SITL)\n");
+
+    error = errorAtan2SITL();
+    printf("  atan2: error %.2e (max %.1e)\n", error, ERROR_MAX_ATAN2_RAPIDO);
+    ok = ok && error <= ERROR_MAX_ATAN2_RAPIDO;
+
+    error = errorSenCosSITL();
+    printf("  sen/cos: error %.2e (max %.1e)\n", error, ERROR_MAX_SEN_COS_RAPIDO);
+    ok = ok && error <= ERROR_MAX_SEN_COS_RAPIDO;
+
+    for (uint8_t i = 0; i < sizeof(barridosSITL) / sizeof(barridosSITL[0]); i++) {
+        error = errorBarridoSITL(&barridosSITL[i]);
+        printf("  %s: error %.2e (max %.1e)\n", barridosSITL[i].nombre, error, barridosSITL[i].errorMax);
+        ok = ok && error <= barridosSITL[i].errorMax;
+    }
+
+    error = errorPowSITL();
+    printf("  pow: error %.2e (max %.1e)\n", error, ERROR_MAX_POW_RAPIDO);
+    ok = ok && error <= ERROR_MAX_POW_RAPIDO;
+
+    // Casos limite
+    ok = ok && atan2Rapido(0.0f, 0.0f) == 0.0f && fabsf(atan2Rapido(0.0f, -1.0f) - 3.14159265f) < 1e-6f;
+    ok = ok && asinRapido(1.5f) == asinRapido(1.0f) && isinf(logRapido(0.0f)) && powRapido(-2.0f, 2.0f) == 0.0f;
+    ok = ok && isfinite(expRapido(1000.0f)) && expRapido(-1000.0f) > 0.0f;
+
+    printf("  Resultado: %s\n", ok ? "ok" : "fallo");
+
+    medirCosteRapidasSITL();
+}
+
+#endif
@@ -0,0 +1,433 @@
+/***************************************************************************************
+**  matriz_sitl.c - Pruebas de precision y coste de las operaciones con matrices
+**
+**
+**  Este fichero forma parte del proyecto URpilot.
+**  Codigo desarrollado por el grupo de investigacion ICON de la Universidad de La Rioja
+**
+**  Autor: Ramon Rico
+**  Fecha de creacion: 17/10/2026
+**  Fecha de modificacion: 17/10/2026
+**
+**  El proyecto URpilot NO es libre. No se puede distribuir y/o modificar este fichero
+**  bajo ningun concepto.
+**
+**  En caso de modificacion y/o solicitud de informacion pongase en contacto con
+**  el grupo de investigacion ICON a traves de: www.unirioja.es/urpilot
+**
+**
+**  Control de versiones del fichero
+**
+**  v1.0  Ramon Rico. Se ha liberado la primera version estable
+**
+****************************************************************************************/
+
+/***************************************************************************************
+** AREA DE INCLUDES                                                                   **
+****************************************************************************************/
+#include <stdio.h>
+#include <string.h>
+#include <math.h>
+
+#include "Core/pruebas_sitl.h"
+
+#ifdef SITL
+#include "Comun/matriz.h"
+#include "Drivers/tiempo_sitl.h"
+#include "Fisica/fisica.h"
+#include "Comun/util.h"
+
+
+/***************************************************************************************
+** AREA DE PREPROCESADOR                                                              **
+****************************************************************************************/
+#define NUM_DIM_MATRIZ_SITL                  4
+#define NUM_PRUEBAS_MATRIZ_SITL              200         // Matrices aleatorias por dimension
+#define ITERACIONES_PRODUCTO_SITL            200000
+#define ITERACIONES_INVERSA_SITL             50000
+
+#define ERROR_MAX_PRODUCTO_SITL              1e-5f       // Relativo al valor maximo
+#define ERROR_MAX_INVERSA_SITL               1e-3f       // max|A * inv(A) - I|
+
+
+/***************************************************************************************
+** AREA DE DEFINICION DE TIPOS                                                        **
+****************************************************************************************/
+typedef struct {
+    float errorProducto;                                  // Frente a multiplicarMatrices
+    float errorProductoFijo;
+    float errorTraspuestas;
+    float residuoAnterior;                                // Inversa de la matriz simetrica
+    float residuoCholesky;
+    float residuoLU;
+    float residuoLUnoSimetrica;
+    float residuoAnteriorNoSimetrica;
+    float residuoMat3;
+} precisionMatrizSITL_t;
+
+
+/***************************************************************************************
+** AREA DE DECLARACION DE VARIABLES                                                   **
+****************************************************************************************/
+static const uint8_t dimMatrizSITL[NUM_DIM_MATRIZ_SITL] = {3, 4, 6, 9};
+static volatile float sumideroMatrizSITL;
+
+
+/***************************************************************************************
+** AREA DE PROTOTIPOS DE FUNCION                                                      **
+****************************************************************************************/
+void matrizAleatoriaSITL(float *M, uint8_t filas, uint8_t columnas);
+void matrizSimetricaSITL(float *M, uint8_t dim);
+void aMatrizSITL(const float *M, matriz_t *R, uint8_t dim);
+float diferenciaMaxMatrizSITL(const float *A, const float *B, uint8_t dim);
+float residuoInversaSITL(const float *A, const float *inv, uint8_t dim);
+void medirPrecisionMatrizSITL(uint8_t dim, precisionMatrizSITL_t *precision);
+void medirCosteMatrizSITL(uint8_t dim);
+void multiplicarFijaSITL(const float *A, const float *B, float *R, uint8_t dim);
+
+
+/***************************************************************************************
+** AREA DE DEFINICION DE FUNCIONES                                                    **
+****************************************************************************************/
+
+/***************************************************************************************
+**  Nombre:         void matrizAleatoriaSITL(float *M, uint8_t filas, uint8_t columnas)
+**  Descripcion:    Rellena una matriz con valores uniformes en [-1, 1]
+**  Parametros:     Matriz, filas, columnas
+**  Retorno:        Ninguno
+****************************************************************************************/
+void matrizAleatoriaSITL(float *M, uint8_t filas, uint8_t columnas)
+{
+    for (uint16_t i = 0; i < filas * columnas; i++)
+        M[i] = ruidoFisica(1.0f);
+}
+
+
+/***************************************************************************************
+**  Nombre:         void matrizSimetricaSITL(float *M, uint8_t dim)
+**  Descripcion:    Matriz simetrica definida positiva J' * J + I, como las de los calibradores
+**  Parametros:     Matriz, dimension
+**  Retorno:        Ninguno
+****************************************************************************************/
+void matrizSimetricaSITL(float *M, uint8_t dim)
+{
+    float J[2 * NUM_MAX_DIM_MATRIZ * NUM_MAX_DIM_MATRIZ];
+
+    matrizAleatoriaSITL(J, 2 * dim, dim);
+    multiplicarTrasMat(J, J, M, 2 * dim, dim, dim);
+
+    for (uint8_t i = 0; i < dim; i++)
+        M[i * dim + i] += 1.0f;
+}
+
+
+/***************************************************************************************
+**  Nombre:         void aMatrizSITL(const float *M, matriz_t *R, uint8_t dim)
+**  Descripcion:    Copia una matriz por filas en un matriz_t
+**  Parametros:     Matriz, resultado, dimension
+**  Retorno:        Ninguno
+****************************************************************************************/
+void aMatrizSITL(const float *M, matriz_t *R, uint8_t dim)
+{
+    memset(R, 0, sizeof(matriz_t));
+
+    for (uint8_t i = 0; i < dim; i++) {
+        for (uint8_t j = 0; j < dim; j++)
+            R->m[i][j] = M[i * dim + j];
+    }
+}
+
+
+/***************************************************************************************
+**  Nombre:         float diferenciaMaxMatrizSITL(const float *A, const float *B, uint8_t dim)
+**  Descripcion:    Maxima diferencia relativa entre dos matrices cuadradas
+**  Parametros:     Matrices, dimension
+**  Retorno:        Diferencia maxima dividida por el mayor valor de A
+****************************************************************************************/
+float diferenciaMaxMatrizSITL(const float *A, const float *B, uint8_t dim)
+{
+    float diferencia = 0, maximo = FLT_EPSILON;
+
+    for (uint16_t i = 0; i < dim * dim; i++) {
+        diferencia = fmaxf(diferencia, fabsf(A[i] - B[i]));
+        maximo = fmaxf(maximo, fabsf(A[i]));
+    }
+
+    return diferencia / maximo;
+}
+
+
+/***************************************************************************************
+**  Nombre:         float residuoInversaSITL(const float *A, const float *inv, uint8_t dim)
+**  Descripcion:    Residuo de una inversa en doble precision
+**  Parametros:     Matriz, inversa, dimension
+**  Retorno:        max|A * inv - I|
+****************************************************************************************/
+float residuoInversaSITL(const float *A, const float *inv, uint8_t dim)
+{
+    double residuo = 0;
+
+    for (uint8_t i = 0; i < dim; i++) {
+        for (uint8_t j = 0; j < dim; j++) {
+            double suma = (i == j) ? -1.0 : 0.0;
+
+            for (uint8_t k = 0; k < dim; k++)
+                suma += (double)A[i * dim + k] * inv[k * dim + j];
+
+            residuo = fmax(residuo, fabs(suma));
+        }
+    }
+
+    return residuo;
+}
+
+
+/***************************************************************************************
+**  Nombre:         void multiplicarFijaSITL(const float *A, const float *B, float *R, uint8_t dim)
+**  Descripcion:    Llama al producto especializado de la dimension o al general
+**  Parametros:     Matriz A, matriz B, resultado, dimension
+**  Retorno:        Ninguno
+****************************************************************************************/
+void multiplicarFijaSITL(const float *A, const float *B, float *R, uint8_t dim)
+{
+    switch (dim) {
+        case 3:
+            multiplicarMat3(A, B, R);
+            break;
+
+        case 4:
+            multiplicarMat4(A, B, R);
+            break;
+
+        case 6:
+            multiplicarMat6(A, B, R);
+            break;
+
+        default:
+            multiplicarMat(A, B, R, dim, dim, dim);
+            break;
+    }
+}
+
+
+/***************************************************************************************
+**  Nombre:         void medirPrecisionMatrizSITL(uint8_t dim, precisionMatrizSITL_t *precision)
+**  Descripcion:    Compara las funciones por puntero con las de matriz_t en matrices aleatorias
+**  Parametros:     Dimension, errores maximos
+**  Retorno:        Ninguno
+****************************************************************************************/
+void medirPrecisionMatrizSITL(uint8_t dim, precisionMatrizSITL_t *precision)
+{
+    float A[NUM_MAX_DIM_MATRIZ * NUM_MAX_DIM_MATRIZ], B[NUM_MAX_DIM_MATRIZ * NUM_MAX_DIM_MATRIZ];
+    float R[NUM_MAX_DIM_MATRIZ * NUM_MAX_DIM_MATRIZ], R2[NUM_MAX_DIM_MATRIZ * NUM_MAX_DIM_MATRIZ];
+    float T[NUM_MAX_DIM_MATRIZ * NUM_MAX_DIM_MATRIZ];
+    float referencia[NUM_MAX_DIM_MATRIZ * NUM_MAX_DIM_MATRIZ];
+    uint8_t pivotes[NUM_MAX_DIM_MATRIZ];
+    matriz_t mA, mB, mR;
+
+    memset(precision, 0, sizeof(precisionMatrizSITL_t));
+
+    for (uint16_t n = 0; n < NUM_PRUEBAS_MATRIZ_SITL; n++) {
+        // Productos
+        matrizAleatoriaSITL(A, dim, dim);
+        matrizAleatoriaSITL(B, dim, dim);
+        aMatrizSITL(A, &mA, dim);
+        aMatrizSITL(B, &mB, dim);
+        multiplicarMatrices(mA, mB, &mR, dim);
+        for (uint8_t i = 0; i < dim; i++) {
+            for (uint8_t j = 0; j < dim; j++)
+                referencia[i * dim + j] = mR.m[i][j];
+        }
+
+        multiplicarMat(A, B, R, dim, dim, dim);
+        precision->errorProducto = fmaxf(precision->errorProducto, diferenciaMaxMatrizSITL(referencia, R, dim));
+
+        multiplicarFijaSITL(A, B, R, dim);
+        precision->errorProductoFijo = fmaxf(precision->errorProductoFijo, diferenciaMaxMatrizSITL(referencia, R, dim));
+
+        // A * B = (B' * A')' = A * (B')'
+        trasponerMat(B, T, dim, dim);
+        multiplicarMatTras(A, T, R, dim, dim, dim);
+        trasponerMat(A, T, dim, dim);
+        multiplicarTrasMat(T, B, R2, dim, dim, dim);
+        precision->errorTraspuestas = fmaxf(precision->errorTraspuestas, diferenciaMaxMatrizSITL(referencia, R, dim));
+        precision->errorTraspuestas = fmaxf(precision->errorTraspuestas, diferenciaMaxMatrizSITL(referencia, R2, dim));
+
+        // Inversas de una matriz simetrica definida positiva
+        matrizSimetricaSITL(A, dim);
+        aMatrizSITL(A, &mA, dim);
+        if (inversaMatriz(mA, &mR, dim)) {
+            for (uint8_t i = 0; i < dim; i++) {
+                for (uint8_t j = 0; j < dim; j++)
+                    R[i * dim + j] = mR.m[i][j];
+            }
+            precision->residuoAnterior = fmaxf(precision->residuoAnterior, residuoInversaSITL(A, R, dim));
+        }
+        else
+            precision->residuoAnterior = INFINITY;
+
+        copiarMat(A, R, dim, dim);
+        precision->residuoCholesky = fmaxf(precision->residuoCholesky,
+                                           inversaCholeskyMat(R, dim) ? residuoInversaSITL(A, R, dim) : INFINITY);
+
+        copiarMat(A, R, dim, dim);
+        identidadMat(R2, dim);
+        if (factorizarLUmat(R, pivotes, dim)) {
+            resolverLUmat(R, pivotes, R2, dim, dim);
+            precision->residuoLU = fmaxf(precision->residuoLU, residuoInversaSITL(A, R2, dim));
+        }
+        else
+            precision->residuoLU = INFINITY;
+
+        if (dim == 3) {
+            precision->residuoMat3 = fmaxf(precision->residuoMat3, inversaMat3(A, R) ? residuoInversaSITL(A, R, dim) : INFINITY);
+        }
+
+        // Inversa de una matriz no simetrica bien condicionada
+        matrizAleatoriaSITL(A, dim, dim);
+        for (uint8_t i = 0; i < dim; i++)
+            A[i * dim + i] += (A[i * dim + i] >= 0 ? 1.0f : -1.0f) * dim;
+        aMatrizSITL(A, &mA, dim);
+
+        copiarMat(A, R, dim, dim);
+        identidadMat(R2, dim);
+        if (factorizarLUmat(R, pivotes, dim)) {
+            resolverLUmat(R, pivotes, R2, dim, dim);
+            precision->residuoLUnoSimetrica = fmaxf(precision->residuoLUnoSimetrica, residuoInversaSITL(A, R2, dim));
+        }
+        else
+            precision->residuoLUnoSimetrica = INFINITY;
+
+        if (inversaMatriz(mA, &mR, dim)) {
+            for (uint8_t i = 0; i < dim; i++) {
+                for (uint8_t j = 0; j < dim; j++)
+                    R[i * dim + j] = mR.m[i][j];
+            }
+            precision->residuoAnteriorNoSimetrica = fmaxf(precision->residuoAnteriorNoSimetrica, residuoInversaSITL(A, R, dim));
+        }
+        else
+            precision->residuoAnteriorNoSimetrica = INFINITY;
+    }
+}
+
+
+/***************************************************************************************
+**  Nombre:         void medirCosteMatrizSITL(uint8_t dim)
+**  Descripcion:    Tiempo por operacion de las funciones de matriz_t frente a las de puntero
+**  Parametros:     Dimension
+**  Retorno:        Ninguno
+****************************************************************************************/
+void medirCosteMatrizSITL(uint8_t dim)
+{
+    float A[NUM_MAX_DIM_MATRIZ * NUM_MAX_DIM_MATRIZ], B[NUM_MAX_DIM_MATRIZ * NUM_MAX_DIM_MATRIZ];
+    float R[NUM_MAX_DIM_MATRIZ * NUM_MAX_DIM_MATRIZ];
+    matriz_t mA, mB, mR;
+    uint64_t inicio;
+    double nsProductoAnterior, nsProducto, nsProductoFijo, nsInversaAnterior, nsCholesky, nsMat3 = 0;
+
+    matrizAleatoriaSITL(A, dim, dim);
+    matrizAleatoriaSITL(B, dim, dim);
+    aMatrizSITL(A, &mA, dim);
+    aMatrizSITL(B, &mB, dim);
+
+    inicio = nanosegundosHostSITL();
+    for (uint32_t n = 0; n < ITERACIONES_PRODUCTO_SITL; n++) {
+        multiplicarMatrices(mA, mB, &mR, dim);
+        sumideroMatrizSITL = mR.m[0][0];
+    }
+    nsProductoAnterior = (double)(nanosegundosHostSITL() - inicio) / ITERACIONES_PRODUCTO_SITL;
+
+    inicio = nanosegundosHostSITL();
+    for (uint32_t n = 0; n < ITERACIONES_PRODUCTO_SITL; n++) {
+        multiplicarMat(A, B, R, dim, dim, dim);
+        sumideroMatrizSITL = R[0];
+    }
+    nsProducto = (double)(nanosegundosHostSITL() - inicio) / ITERACIONES_PRODUCTO_SITL;
+
+    inicio = nanosegundosHostSITL();
+    for (uint32_t n = 0; n < ITERACIONES_PRODUCTO_SITL; n++) {
+        multiplicarFijaSITL(A, B, R, dim);
+        sumideroMatrizSITL = R[0];
+    }
+    nsProductoFijo = (double)(nanosegundosHostSITL() - inicio) / ITERACIONES_PRODUCTO_SITL;
+
+    // Inversas de la matriz simetrica. Cholesky trabaja en el sitio y se cuenta la copia
+    matrizSimetricaSITL(A, dim);
+    aMatrizSITL(A, &mA, dim);
+
+    inicio = nanosegundosHostSITL();
+    for (uint32_t n = 0; n < ITERACIONES_INVERSA_SITL; n++) {
+        inversaMatriz(mA, &mR, dim);
+        sumideroMatrizSITL = mR.m[0][0];
+    }
+    nsInversaAnterior = (double)(nanosegundosHostSITL() - inicio) / ITERACIONES_INVERSA_SITL;
+
+    inicio = nanosegundosHostSITL();
+    for (uint32_t n = 0; n < ITERACIONES_INVERSA_SITL; n++) {
+        copiarMat(A, R, dim, dim);
+        inversaCholeskyMat(R, dim);
+        sumideroMatrizSITL = R[0];
+    }
+    nsCholesky = (double)(nanosegundosHostSITL() - inicio) / ITERACIONES_INVERSA_SITL;
+
+    if (dim == 3) {
+        inicio = nanosegundosHostSITL();
+        for (uint32_t n = 0; n < ITERACIONES_INVERSA_SITL; n++) {
+            inversaMat3(A, R);
+            sumideroMatrizSITL = R[0];
+        }
+        nsMat3 = (double)(nanosegundosHostSITL() - inicio) / ITERACIONES_INVERSA_SITL;
+    }
+
+    printf("  %ux%u: producto %.1f -> %.1f ns (%s %.1f ns) | inversa %.1f -> Cholesky %.1f ns",
+           dim, dim, nsProductoAnterior, nsProducto, dim == 3 || dim == 4 || dim == 6 ? "especializado" : "general", nsProductoFijo,
+           nsInversaAnterior, nsCholesky);
+    if (dim == 3)
+        printf(" (adjunta %.1f ns)", nsMat3);
+    printf("\n");
+}
+
+
+/***************************************************************************************
+**  Nombre:         void probarMatricesSITL(void)
+**  Descripcion:    Comprueba las operaciones por puntero frente a las de matriz_t y mide el
+**                  coste de ambas en 3x3, 4x4, 6x6 y en la 9x9 del calibrador de la brujula
+**  Parametros:     Ninguno
+**  Retorno:        Ninguno
+****************************************************************************************/
+void probarMatricesSITL(void)
+{
+    bool ok = true;
+
+    printf("\nOperaciones con matrices (SITL)\n");
+
+    for (uint8_t d = 0; d < NUM_DIM_MATRIZ_SITL; d++) {
+        const uint8_t dim = dimMatrizSITL[d];
+        precisionMatrizSITL_t precision;
+
+        medirPrecisionMatrizSITL(dim, &precision);
+
+        printf("  %ux%u: error producto %.1e (fijo %.1e, traspuestas %.1e) | residuo inversa simetrica: anterior %.1e, Cholesky %.1e, LU %.1e",
+               dim, dim, precision.errorProducto, precision.errorProductoFijo, precision.errorTraspuestas, precision.residuoAnterior,
+               precision.residuoCholesky, precision.residuoLU);
+        if (dim == 3)
+            printf(", adjunta %.1e", precision.residuoMat3);
+        printf(" | no simetrica: anterior %.1e, LU %.1e\n", precision.residuoAnteriorNoSimetrica, precision.residuoLUnoSimetrica);
+
+        ok = ok && precision.errorProducto < ERROR_MAX_PRODUCTO_SITL && precision.errorProductoFijo < ERROR_MAX_PRODUCTO_SITL &&
+             precision.errorTraspuestas < ERROR_MAX_PRODUCTO_SITL && precision.residuoCholesky < ERROR_MAX_INVERSA_SITL &&
+             precision.residuoLU < ERROR_MAX_INVERSA_SITL && precision.residuoLUnoSimetrica < ERROR_MAX_INVERSA_SITL &&
+             (dim != 3 || precision.residuoMat3 < ERROR_MAX_INVERSA_SITL);
+    }
+
+    // Una matriz indefinida no se acepta en Cholesky
+    float indefinida[4] = {1.0f, 2.0f, 2.0f, 1.0f};
+    ok = ok && !factorizarCholeskyMat(indefinida, 2);
+
+    printf("  Resultado: %s\n", ok ? "ok" : "fallo");
+
+    for (uint8_t d = 0; d < NUM_DIM_MATRIZ_SITL; d++)
+        medirCosteMatrizSITL(dimMatrizSITL[d]);
+}
+
+#endif
@@ -0,0 +1,49 @@
+/***************************************************************************************
+**  fallo_sistema.c - Sustituto de los fallos de sistema para el SITL. En el host no hay
+**                    LED ni reset: se informa del fallo y se termina el proceso
+**
+**
+**  Este fichero forma parte del proyecto URpilot.
+**  Codigo desarrollado por el grupo de investigacion ICON de la Universidad de La Rioja
+**
+**  Autor: Ramon Rico
+**  Fecha de creacion: 17/10/2026
+**  Fecha de modificacion: 17/10/2026
+**
+**  El proyecto URpilot NO es libre. No se puede distribuir y/o modificar este fichero
+**  bajo ningun concepto.
+**
+**  En caso de modificacion y/o solicitud de informacion pongase en contacto con
+**  el grupo de investigacion ICON a traves de: www.unirioja.es/urpilot
+**
+**
+**  Control de versiones del fichero
+**
+**  v1.0  Ramon Rico. Se ha liberado la primera version estable
+**
+****************************************************************************************/
+
+/***************************************************************************************
+** AREA DE INCLUDES                                                                   **
+****************************************************************************************/
+#include <stdio.h>
+#include <stdlib.h>
+
+#include "Core/fallo_sistema.h"
+
+
+/***************************************************************************************
+** AREA DE DEFINICION DE FUNCIONES                                                    **
+****************************************************************************************/
+
+/***************************************************************************************
+**  Nombre:         void falloSistema(falloSistema_e fallo)
+**  Descripcion:    Informa del fallo y termina. En la placa se resetea y no vuelve
+**  Parametros:     Tipo de fallo
+**  Retorno:        Ninguno
+****************************************************************************************/
+void falloSistema(falloSistema_e fallo)
+{
+    printf("Fallo del sistema %u\n", fallo);
+    exit(EXIT_FAILURE);
+}
@@ -0,0 +1,444 @@
+/***************************************************************************************
+**  main_sitl.c - Programa principal del SITL. Arranca el firmware sobre el modelo fisico,
+**                simula un vuelo con tiempo virtual y mide el coste de los lazos de control
+**
+**
+**  Este fichero forma parte del proyecto URpilot.
+**  Codigo desarrollado por el grupo de investigacion ICON de la Universidad de La Rioja
+**
+**  Autor: Ramon Rico
+**  Fecha de creacion: 17/10/2026
+**  Fecha de modificacion: 17/10/2026
+**
+**  El proyecto URpilot NO es libre. No se puede distribuir y/o modificar este fichero
+**  bajo ningun concepto.
+**
+**  En caso de modificacion y/o solicitud de informacion pongase en contacto con
+**  el grupo de investigacion ICON a traves de: www.unirioja.es/urpilot
+**
+**
+**  Control de versiones del fichero
+**
+**  v1.0  Ramon Rico. Se ha liberado la primera version estable
+**
+****************************************************************************************/
+
+/***************************************************************************************
+** AREA DE INCLUDES                                                                   **
+****************************************************************************************/
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "Sistema/plataforma.h"
+#include "Core/inicializacion.h"
+#include "Scheduler/scheduler.h"
+#include "Scheduler/tareas.h"
+#include "GP/gp.h"
+#include "GP/gp_fc.h"
+#include "GP/gp_rc.h"
+#include "GP/gp_calibrador.h"
+#include "Drivers/tiempo.h"
+#include "Drivers/tiempo_sitl.h"
+#include "Drivers/spi_sitl.h"
+#include "Drivers/i2c_sitl.h"
+#include "Drivers/uart_sitl.h"
+#include "Sensores/IMU/imu.h"
+#include "Sensores/Barometro/barometro.h"
+#include "Sensores/Magnetometro/magnetometro.h"
+#include "Sensores/GPS/gps.h"
+#include "Sensores/GPS/gps_sitl.h"
+#include "Radio/radio.h"
+#include "Radio/radio_sitl.h"
+#include "Motores/motor_sitl.h"
+#include "FC/rc.h"
+#include "FC/fc.h"
+#include "FC/mixer.h"
+#include "AHRS/ahrs.h"
+#include "Fisica/fisica.h"
+#include "Blackbox/blackbox.h"
+#include "Blackbox/blackbox_sitl.h"
+#include "Core/pruebas_sitl.h"
+
+
+/***************************************************************************************
+** AREA DE PREPROCESADOR                                                              **
+****************************************************************************************/
+#define DURACION_DEFECTO_SITL_S     20         // Duracion de la simulacion por defecto
+#define ITERACIONES_DEFECTO_SITL    100000     // Iteraciones por defecto del benchmark
+#define PASO_SCHEDULER_SITL_US      10         // Tiempo virtual que consume cada pasada del scheduler
+#define TIEMPO_ARMADO_SITL_US       3000000    // Instante en el que se quita el EStop
+#define PERIODO_INFORME_SITL_US     1000000    // Periodo de impresion del estado
+
+
+/***************************************************************************************
+** AREA DE DEFINICION DE TIPOS                                                        **
+****************************************************************************************/
+typedef struct {
+    uint64_t suma;
+    uint64_t min;
+    uint64_t max;
+    uint32_t muestras;
+} medidaBenchmarkSITL_t;
+
+
+/***************************************************************************************
+** AREA DE DECLARACION DE VARIABLES                                                   **
+****************************************************************************************/
+uint8_t estadoSistema = ESTADO_SIS_INICIALIZANDO;
+
+
+/***************************************************************************************
+** AREA DE PROTOTIPOS DE FUNCION                                                      **
+****************************************************************************************/
+void iniciarPlacaSITL(void);
+void resetearCalibracionSITL(void);
+void pasoSimulacionSITL(uint64_t tiempoUs);
+void simularSITL(uint32_t duracionS);
+void informarEstadoSITL(void);
+void informarDeadlinesSITL(void);
+void informarPerfilTareasSITL(void);
+void benchmarkLazosSITL(uint32_t iteraciones);
+static void anadirMedidaBenchmarkSITL(medidaBenchmarkSITL_t *medida, uint64_t ns);
+static void imprimirMedidaBenchmarkSITL(const char *nombre, const medidaBenchmarkSITL_t *medida);
+
+
+/***************************************************************************************
+** AREA DE DEFINICION DE FUNCIONES                                                    **
+****************************************************************************************/
+
+/***************************************************************************************
+**  Nombre:         int main(int argc, char *argv[])
+**  Descripcion:    Funcion general del SITL
+**  Parametros:     Duracion de la simulacion en s e iteraciones del benchmark
+**  Retorno:        0 si ok
+****************************************************************************************/
+int main(int argc, char *argv[])
+{
+    uint32_t duracion = DURACION_DEFECTO_SITL_S;
+    uint32_t iteraciones = ITERACIONES_DEFECTO_SITL;
+
+    if (argc > 1)
+        duracion = strtoul(argv[1], NULL, 10);
+
+    if (argc > 2)
+        iteraciones = strtoul(argv[2], NULL, 10);
+
+    iniciarPlacaSITL();
+    simularSITL(duracion);
+    informarPerfilTareasSITL();
+    benchmarkLazosSITL(iteraciones);
+    probarColaSPIsitl();
+    probarTraficoMixtoSPIsitl();
+    probarFifoIMUsitl();
+    probarRxDMAuartSITL();
+    probarTxDMAuartSITL();
+    probarTelemetriaSITL();
+    probarNotchDinamicoSITL();
+    probarFiltroRPMsitl();
+    probarMediaMovilSITL();
+    probarMatricesSITL();
+    probarAjusteMagSITL();
+    probarNavegacionSITL();
+    probarMatematicasRapidasSITL();
+    probarCRCsitl();
+    probarVotacionIMUsitl();
+    probarColaI2Csitl();
+    probarAnalizadorUBXsitl();
+    probarTramaRadioSITL();
+    probarConfigFlashSITL();
+    probarParametrosTelemetriaSITL();
+    probarPIDsitl();
+    probarMixerSITL();
+    return 0;
+}
+
+
+/***************************************************************************************
+**  Nombre:         void iniciarPlacaSITL(void)
+**  Descripcion:    Equivalente a iniciarPlaca sin flash, RTC ni USB. La configuracion
+**                  se carga siempre con los valores por defecto
+**  Parametros:     Ninguno
+**  Retorno:        Ninguno
+****************************************************************************************/
+void iniciarPlacaSITL(void)
+{
+    // El modelo y los generadores deben estar listos antes que los drivers
+    iniciarContadorCiclos();
+    iniciarFisica();
+    iniciarGPSsitl();
+    iniciarRadioSITL();
+    ajustarCallbackTiempoSITL(pasoSimulacionSITL);
+
+    // Configuracion -------------------------------------------------------------
+    resetearTodosGP();
+    resetearCalibracionSITL();
+    estadoSistema |= ESTADO_SIS_CONFIG_CARGADA;
+    estadoSistema |= ESTADO_SIS_DRIVERS_READY;
+
+    // Perifericos --------------------------------------------------------------
+    if (!iniciarIMU())
+        printf("Fallo al iniciar la IMU\n");
+
+    if (!iniciarBaro())
+        printf("Fallo al iniciar el barometro\n");
+
+    if (!iniciarMag())
+        printf("Fallo al iniciar el magnetometro\n");
+
+    if (!iniciarGPS())
+        printf("Fallo al iniciar el GPS\n");
+
+    if (!iniciarRadio())
+        printf("Fallo al iniciar la radio\n");
+
+    if (!iniciarMotores())
+        printf("Fallo al iniciar los motores\n");
+
+    estadoSistema |= ESTADO_SIS_PERIFERICOS_READY;
+
+    // FC ----------------------------------------------------------------------
+    iniciarRC();
+    iniciarAHRS();
+    iniciarFC();
+    iniciarMixer();
+
+    // Scheduler ---------------------------------------------------------------
+    iniciarTareas();
+    estadoSistema |= ESTADO_SIS_SCHEDULER_READY;
+    estadoSistema |= ESTADO_SIS_READY;
+
+    printf("SITL %s arrancado en t = %.3f s\n", NOMBRE_PLACA, tiempoSimuladoSITL() / 1.0e6);
+}
+
+
+/***************************************************************************************
+**  Nombre:         void resetearCalibracionSITL(void)
+**  Descripcion:    Sustituye la calibracion de las IMUs de la placa real por la ideal.
+**                  Los sensores simulados no tienen offsets ni desalineamientos
+**  Parametros:     Ninguno
+**  Retorno:        Ninguno
+****************************************************************************************/
+void resetearCalibracionSITL(void)
+{
+    for (uint8_t i = 0; i < NUM_MAX_IMU; i++) {
+        calIMU_t *cal = &configCalIMU_SistemaArray[i].calIMU;
+
+        memset(cal, 0, sizeof(*cal));
+        cal->calAcelerometro.ganancia[0][0] = 1;
+        cal->calAcelerometro.ganancia[1][1] = 1;
+        cal->calAcelerometro.ganancia[2][2] = 1;
+    }
+}
+
+
+/***************************************************************************************
+**  Nombre:         void pasoSimulacionSITL(uint64_t tiempoUs)
+**  Descripcion:    Se ejecuta cada vez que avanza el tiempo virtual. Integra el modelo
+**                  y genera las tramas de los perifericos serie
+**  Parametros:     Tiempo de simulacion en us
+**  Retorno:        Ninguno
+****************************************************************************************/
+void pasoSimulacionSITL(uint64_t tiempoUs)
+{
+    actualizarFisica(tiempoUs);
+    actualizarSPIsitl(tiempoUs);
+    actualizarI2Csitl(tiempoUs);
+    actualizarGPSsitl(tiempoUs);
+    actualizarRadioSITL(tiempoUs);
+}
+
+
+/***************************************************************************************
+**  Nombre:         void simularSITL(uint32_t duracionS)
+**  Descripcion:    Ejecuta el scheduler sobre el tiempo virtual. Pasado el tiempo de
+**                  armado se quita el EStop para encender los motores
+**  Parametros:     Duracion en s
+**  Retorno:        Ninguno
+****************************************************************************************/
+void simularSITL(uint32_t duracionS)
+{
+    const uint64_t fin = tiempoSimuladoSITL() + (uint64_t)duracionS * 1000000;
+    uint64_t ultimoInforme = 0;
+    bool armado = false;
+
+    while (tiempoSimuladoSITL() < fin) {
+        scheduler();
+        actualizarBlackbox(micros());
+        avanzarTiempoSITL(PASO_SCHEDULER_SITL_US);
+
+        if (!armado && tiempoSimuladoSITL() >= TIEMPO_ARMADO_SITL_US) {
+            ajustarCanalRadioSITL(configModoRC()->canalModoEStop, 1900);
+            armado = true;
+
+            // El log empieza al armar, con el GPS ya detectado
+            iniciarBlackbox();
+        }
+
+        if (tiempoSimuladoSITL() - ultimoInforme >= PERIODO_INFORME_SITL_US) {
+            ultimoInforme = tiempoSimuladoSITL();
+            informarEstadoSITL();
+        }
+    }
+
+    // Cierra el log. El driver del SITL termina en la primera actualizacion
+    finalizarBlackbox();
+    actualizarBlackbox(micros());
+    printf("\nBlackbox: %u bytes en %s\n", bytesEscritosBlackboxSITL(), FICHERO_LOG_BLACKBOX_SITL);
+
+    informarDeadlinesSITL();
+}
+
+
+/***************************************************************************************
+**  Nombre:         void informarEstadoSITL(void)
+**  Descripcion:    Imprime la actitud y la altura estimadas frente a las reales y la salida de motores
+**  Parametros:     Ninguno
+**  Retorno:        Ninguno
+****************************************************************************************/
+void informarEstadoSITL(void)
+{
+    const estadoFisica_t *estado = estadoFisica();
+    float actitud[3], actitudReal[3], posicion[3];
+
+    actitudAHRS(actitud);
+    eulerFisica(actitudReal);
+    posicionAHRS(posicion);
+
+    printf("t=%6.2f | AHRS %7.2f %7.2f %7.2f | real %7.2f %7.2f %7.2f | h=%6.2f (nav %6.2f) | gps=%u sats=%u | motores",
+           tiempoSimuladoSITL() / 1.0e6, actitud[0], actitud[1], actitud[2], actitudReal[0], actitudReal[1], actitudReal[2],
+           -estado->posicion[2], -posicion[2], gpsGenOperativo(), satelitesGPS());
+
+    for (uint8_t i = 0; i < numMotoresSITL(); i++)
+        printf(" %.3f", salidaMotorSITL(i));
+
+    printf("\n");
+}
+
+
+/***************************************************************************************
+**  Nombre:         void informarDeadlinesSITL(void)
+**  Descripcion:    Imprime los deadlines perdidos por las tareas en tiempo real
+**  Parametros:     Ninguno
+**  Retorno:        Ninguno
+****************************************************************************************/
+void informarDeadlinesSITL(void)
+{
+#if defined(USAR_SCHEDULER_EDF)
+    printf("\nDeadlines de las tareas en tiempo real (EDF)\n");
+#else
+    printf("\nDeadlines de las tareas en tiempo real (prioridad)\n");
+#endif
+
+    for (idTarea_e id = 0; id < TAREA_CONTADOR; id++) {
+        infoTarea_t info;
+
+        infoTarea(id, &info);
+        if (!info.habilitado || info.prioridadEstatica != PRIORIDAD_TIEMPO_REAL)
+            continue;
+
+        printf("  %-28s perdidos %6u | retraso max %6u us\n", info.nombreTarea, info.deadlinesPerdidos, info.retrasoMaxDeadline);
+    }
+}
+
+
+/***************************************************************************************
+**  Nombre:         void informarPerfilTareasSITL(void)
+**  Descripcion:    Imprime el perfil de ejecucion de las tareas. En el SITL los ciclos
+**                  son nanosegundos del host
+**  Parametros:     Ninguno
+**  Retorno:        Ninguno
+****************************************************************************************/
+void informarPerfilTareasSITL(void)
+{
+    printf("\nPerfil de las tareas (ns del host)\n");
+
+    for (idTarea_e id = 0; id < TAREA_CONTADOR; id++) {
+        infoTarea_t info;
+
+        infoTarea(id, &info);
+        if (!info.habilitado)
+            continue;
+
+        printf("  %-28s min %8u | media %8u | p50 %8u | p99 %8u | max %8u\n", info.nombreTarea,
+               info.ciclosMin, info.ciclosMedio, info.ciclosP50, info.ciclosP99, info.ciclosMax);
+    }
+}
+
+
+/***************************************************************************************
+**  Nombre:         void benchmarkLazosSITL(uint32_t iteraciones)
+**  Descripcion:    Mide el coste en el host de los lazos de velocidad angular y actitud.
+**                  El tiempo virtual avanza el periodo de cada lazo entre llamadas para
+**                  que la entrada sea la misma en todas las ejecuciones
+**  Parametros:     Numero de iteraciones
+**  Retorno:        Ninguno
+****************************************************************************************/
+void benchmarkLazosSITL(uint32_t iteraciones)
+{
+    medidaBenchmarkSITL_t velAngular, actitud;
+    uint64_t t0, t1;
+
+    if (iteraciones == 0)
+        return;
+
+    memset(&velAngular, 0, sizeof(velAngular));
+    memset(&actitud, 0, sizeof(actitud));
+    velAngular.min = UINT64_MAX;
+    actitud.min = UINT64_MAX;
+
+    for (uint32_t i = 0; i < iteraciones; i++) {
+        avanzarTiempoSITL(PERIODO_TAREA_HZ_SCHEDULER(FREC_ACTUALIZAR_VEL_ANGULAR_FC_HZ));
+
+        if (i % (FREC_ACTUALIZAR_VEL_ANGULAR_FC_HZ / FREC_ACTUALIZAR_ACTITUD_FC_HZ) == 0) {
+            t0 = nanosegundosHostSITL();
+            actualizarLazoActitudFC(micros());
+            t1 = nanosegundosHostSITL();
+            anadirMedidaBenchmarkSITL(&actitud, t1 - t0);
+        }
+
+        t0 = nanosegundosHostSITL();
+        actualizarLazoVelAngularFC(micros());
+        t1 = nanosegundosHostSITL();
+        anadirMedidaBenchmarkSITL(&velAngular, t1 - t0);
+    }
+
+    printf("Benchmark (%lu iteraciones)\n", (unsigned long)iteraciones);
+    imprimirMedidaBenchmarkSITL("actualizarLazoVelAngularFC", &velAngular);
+    imprimirMedidaBenchmarkSITL("actualizarLazoActitudFC", &actitud);
+}
+
+
+/***************************************************************************************
+**  Nombre:         void anadirMedidaBenchmarkSITL(medidaBenchmarkSITL_t *medida, uint64_t ns)
+**  Descripcion:    Acumula una medida
+**  Parametros:     Estadistica y duracion en ns
+**  Retorno:        Ninguno
+****************************************************************************************/
+static void anadirMedidaBenchmarkSITL(medidaBenchmarkSITL_t *medida, uint64_t ns)
+{
+    medida->suma += ns;
+    medida->muestras++;
+
+    if (ns < medida->min)
+        medida->min = ns;
+
+    if (ns > medida->max)
+        medida->max = ns;
+}
+
+
+/***************************************************************************************
+**  Nombre:         void imprimirMedidaBenchmarkSITL(const char *nombre, const medidaBenchmarkSITL_t *medida)
+**  Descripcion:    Imprime media, minimo y maximo
+**  Parametros:     Nombre de la funcion y estadistica
+**  Retorno:        Ninguno
+****************************************************************************************/
+static void imprimirMedidaBenchmarkSITL(const char *nombre, const medidaBenchmarkSITL_t *medida)
+{
+    if (medida->muestras == 0)
+        return;
+
+    printf("  %-28s media %8.1f ns  min %6llu ns  max %8llu ns\n", nombre, (double)medida->suma / medida->muestras,
+           (unsigned long long)medida->min, (unsigned long long)medida->max);
+}
@@ -0,0 +1,83 @@
+/***************************************************************************************
+**  pruebas_sitl.h - Autocomprobaciones de los modulos en el SITL
+**
+**
+**  Este fichero forma parte del proyecto URpilot.
+**  Codigo desarrollado por el grupo de investigacion ICON de la Universidad de La Rioja
+**
+**  Autor: Ramon Rico
+**  Fecha de creacion: 17/10/2026
+**  Fecha de modificacion: 17/10/2026
+**
+**  El proyecto URpilot NO es libre. No se puede distribuir y/o modificar este fichero
+**  bajo ningun concepto.
+**
+**  En caso de modificacion y/o solicitud de informacion pongase en contacto con
+**  el grupo de investigacion ICON a traves de: www.unirioja.es/urpilot
+**
+**
+**  Control de versiones del fichero
+**
+**  v1.0  Ramon Rico. Se ha liberado la primera version estable
+**
+****************************************************************************************/
+
+#ifndef __PRUEBAS_SITL_H
+#define __PRUEBAS_SITL_H
+
+/***************************************************************************************
+** AREA DE INCLUDES                                                                   **
+****************************************************************************************/
+
+
+/***************************************************************************************
+** AREA DE PREPROCESADOR                                                              **
+****************************************************************************************/
+
+
+/***************************************************************************************
+** AREA DE DEFINICION DE TIPOS                                                        **
+****************************************************************************************/
+
+
+/***************************************************************************************
+** AREA DE DECLARACION DE VARIABLES                                                   **
+****************************************************************************************/
+
+
+/***************************************************************************************
+** AREA DE PROTOTIPOS DE FUNCION                                                      **
+****************************************************************************************/
+// Drivers
+void probarColaSPIsitl(void);
+void probarTraficoMixtoSPIsitl(void);
+void probarColaI2Csitl(void);
+void probarRxDMAuartSITL(void);
+void probarTxDMAuartSITL(void);
+void probarCRCsitl(void);
+
+// Sensores
+void probarFifoIMUsitl(void);
+void probarVotacionIMUsitl(void);
+void probarAnalizadorUBXsitl(void);
+void probarAjusteMagSITL(void);
+
+// Comun y filtros
+void probarMatricesSITL(void);
+void probarMatematicasRapidasSITL(void);
+void probarMediaMovilSITL(void);
+void probarNotchDinamicoSITL(void);
+void probarFiltroRPMsitl(void);
+
+// Control y navegacion
+void probarNavegacionSITL(void);
+void probarPIDsitl(void);
+void probarMixerSITL(void);
+
+// Radio, telemetria y configuracion
+void probarTramaRadioSITL(void);
+void probarTelemetriaSITL(void);
+void probarParametrosTelemetriaSITL(void);
+void probarConfigFlashSITL(void);
+
+#endif // __PRUEBAS_SITL_H
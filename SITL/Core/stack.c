@@ -0,0 +1,69 @@
+/***************************************************************************************
+**  stack.c - Sustituto del chequeo del stack para el SITL. En el host el stack lo
+**             gestiona el sistema operativo y no hay simbolos del linker que revisar
+**
+**
+**  Este fichero forma parte del proyecto URpilot.
+**  Codigo desarrollado por el grupo de investigacion ICON de la Universidad de La Rioja
+**
+**  Autor: Ramon Rico
+**  Fecha de creacion: 17/10/2026
+**  Fecha de modificacion: 17/10/2026
+**
+**  El proyecto URpilot NO es libre. No se puede distribuir y/o modificar este fichero
+**  bajo ningun concepto.
+**
+**  En caso de modificacion y/o solicitud de informacion pongase en contacto con
+**  el grupo de investigacion ICON a traves de: www.unirioja.es/urpilot
+**
+**
+**  Control de versiones del fichero
+**
+**  v1.0  Ramon Rico. Se ha liberado la primera version estable
+**
+****************************************************************************************/
+
+/***************************************************************************************
+** AREA DE INCLUDES                                                                   **
+****************************************************************************************/
+#include "Core/stack.h"
+
+
+/***************************************************************************************
+** AREA DE DEFINICION DE FUNCIONES                                                    **
+****************************************************************************************/
+
+/***************************************************************************************
+**  Nombre:         void chequearStack(uint32_t tiempoActual)
+**  Descripcion:    No hace nada en el host
+**  Parametros:     Tiempo actual (no se usa)
+**  Retorno:        Ninguno
+****************************************************************************************/
+void chequearStack(uint32_t tiempoActual)
+{
+    UNUSED(tiempoActual);
+}
+
+
+/***************************************************************************************
+**  Nombre:         uint32_t tamUsadoStack(void)
+**  Descripcion:    Devuelve el tamanio del stack usado
+**  Parametros:     Ninguno
+**  Retorno:        Siempre 0
+****************************************************************************************/
+uint32_t tamUsadoStack(void)
+{
+    return 0;
+}
+
+
+/***************************************************************************************
+**  Nombre:         uint32_t tamanioStack(void)
+**  Descripcion:    Devuelve el tamanio del stack
+**  Parametros:     Ninguno
+**  Retorno:        Siempre 0
+****************************************************************************************/
+uint32_t tamanioStack(void)
+{
+    return 0;
+}
@@ -0,0 +1,450 @@
+/***************************************************************************************
+**  bus.c - Funciones del bus de comunicacion para el SITL. Los accesos bloqueantes del
+**          SPI pasan por la cola igual que en la placa. El I2C no tiene dispositivos
+**
+**
+**  Este fichero forma parte del proyecto URpilot.
+**  Codigo desarrollado por el grupo de investigacion ICON de la Universidad de La Rioja
+**
+**  Autor: Ramon Rico
+**  Fecha de creacion: 17/10/2026
+**  Fecha de modificacion: 17/10/2026
+**
+**  El proyecto URpilot NO es libre. No se puede distribuir y/o modificar este fichero
+**  bajo ningun concepto.
+**
+**  En caso de modificacion y/o solicitud de informacion pongase en contacto con
+**  el grupo de investigacion ICON a traves de: www.unirioja.es/urpilot
+**
+**
+**  Control de versiones del fichero
+**
+**  v1.0  Ramon Rico. Se ha liberado la primera version estable
+**
+****************************************************************************************/
+
+/***************************************************************************************
+** AREA DE INCLUDES                                                                   **
+****************************************************************************************/
+#include <string.h>
+
+#include "Drivers/bus.h"
+#include "Drivers/tiempo_sitl.h"
+
+
+/***************************************************************************************
+** AREA DE PREPROCESADOR                                                              **
+****************************************************************************************/
+#define TAM_BUFFER_SINCRONO_BUS_SITL    288
+
+
+/***************************************************************************************
+** AREA DE DEFINICION DE TIPOS                                                        **
+****************************************************************************************/
+
+
+/***************************************************************************************
+** AREA DE DECLARACION DE VARIABLES                                                   **
+****************************************************************************************/
+static bool spiSITLiniciado[NUM_MAX_SPI];
+static bool i2cSITLiniciado[NUM_MAX_I2C];
+
+
+/***************************************************************************************
+** AREA DE PROTOTIPOS DE FUNCION                                                      **
+****************************************************************************************/
+bool prepararTransaccionRegistroBusSITL(const bus_t *bus, transaccionSPI_t *transaccion, uint8_t reg, uint8_t *buffer, uint16_t longitud,
+		                                callbackTransaccionSPI callback, void *paramUsuario);
+bool prepararTransaccionRegistroBusI2CSITL(const bus_t *bus, transaccionI2C_t *transaccion, uint8_t reg, bool lectura, uint8_t *buffer,
+		                                   uint16_t longitud, callbackTransaccionI2C callback, void *paramUsuario);
+bool transferirSincronoBusSITL(const bus_t *bus, uint8_t reg, bool lectura, uint8_t *dato, uint8_t longitud);
+
+
+/***************************************************************************************
+** AREA DE DEFINICION DE FUNCIONES                                                    **
+****************************************************************************************/
+
+/***************************************************************************************
+**  Nombre:         bool iniciarSPI(numSPI_e numSPI)
+**  Descripcion:    Marca el SPI como iniciado
+**  Parametros:     Numero del SPI
+**  Retorno:        True si ok
+****************************************************************************************/
+bool iniciarSPI(numSPI_e numSPI)
+{
+    if (numSPI == SPI_NINGUNO)
+        return false;
+
+    iniciarColaSPI(numSPI);
+    spiSITLiniciado[numSPI] = true;
+    return true;
+}
+
+
+/***************************************************************************************
+**  Nombre:         bool spiIniciado(numSPI_e numSPI)
+**  Descripcion:    Comprueba si el SPI esta iniciado
+**  Parametros:     Numero del SPI
+**  Retorno:        True si iniciado
+****************************************************************************************/
+bool spiIniciado(numSPI_e numSPI)
+{
+    return numSPI != SPI_NINGUNO && spiSITLiniciado[numSPI];
+}
+
+
+/***************************************************************************************
+**  Nombre:         void ajustarRelojSPI(numSPI_e numSPI, divisorRelojSPI_e divisor)
+**  Descripcion:    El SPI simulado no tiene reloj
+**  Parametros:     Numero del SPI, divisor
+**  Retorno:        Ninguno
+****************************************************************************************/
+void ajustarRelojSPI(numSPI_e numSPI, divisorRelojSPI_e divisor)
+{
+    UNUSED(numSPI);
+    UNUSED(divisor);
+}
+
+
+/***************************************************************************************
+**  Nombre:         bool iniciarI2C(numI2C_e numI2C)
+**  Descripcion:    Marca el I2C como iniciado
+**  Parametros:     Numero del I2C
+**  Retorno:        True si ok
+****************************************************************************************/
+bool iniciarI2C(numI2C_e numI2C)
+{
+    if (numI2C == I2C_NINGUNO)
+        return false;
+
+    iniciarColaI2C(numI2C);
+    i2cSITLiniciado[numI2C] = true;
+    return true;
+}
+
+
+/***************************************************************************************
+**  Nombre:         bool i2cIniciado(numI2C_e numI2C)
+**  Descripcion:    Comprueba si el I2C esta iniciado
+**  Parametros:     Numero del I2C
+**  Retorno:        True si iniciado
+****************************************************************************************/
+bool i2cIniciado(numI2C_e numI2C)
+{
+    return numI2C != I2C_NINGUNO && i2cSITLiniciado[numI2C];
+}
+
+
+/***************************************************************************************
+**  Nombre:         bool busOcupado(const bus_t *bus)
+**  Descripcion:    Comprueba si el bus esta ocupado
+**  Parametros:     Bus
+**  Retorno:        True si ocupado
+****************************************************************************************/
+bool busOcupado(const bus_t *bus)
+{
+    UNUSED(bus);
+    return false;
+}
+
+
+/***************************************************************************************
+**  Nombre:         void drenarRecepcionBus(const bus_t *bus)
+**  Descripcion:    Drena el buffer de recepcion del bus
+**  Parametros:     Bus
+**  Retorno:        Ninguno
+****************************************************************************************/
+void drenarRecepcionBus(const bus_t *bus)
+{
+    UNUSED(bus);
+}
+
+
+/***************************************************************************************
+**  Nombre:         bool escribirRegistroBus(const bus_t *bus, uint8_t reg, uint8_t byteTx)
+**  Descripcion:    Escribe un dato en un registro
+**  Parametros:     Bus, registro, dato a escribir
+**  Retorno:        True si ok
+****************************************************************************************/
+bool escribirRegistroBus(const bus_t *bus, uint8_t reg, uint8_t byteTx)
+{
+    return escribirBufferRegistroBus(bus, reg, &byteTx, 1);
+}
+
+
+/***************************************************************************************
+**  Nombre:         bool escribirBufferRegistroBus(const bus_t *bus, uint8_t reg, uint8_t *datoTx, uint8_t longitud)
+**  Descripcion:    Escribe un buffer en un registro
+**  Parametros:     Bus, registro, buffer, longitud
+**  Retorno:        True si ok
+****************************************************************************************/
+bool escribirBufferRegistroBus(const bus_t *bus, uint8_t reg, uint8_t *datoTx, uint8_t longitud)
+{
+    return transferirSincronoBusSITL(bus, reg, false, datoTx, longitud);
+}
+
+
+/***************************************************************************************
+**  Nombre:         bool leerRegistroBus(const bus_t *bus, uint8_t reg, uint8_t *byteRx)
+**  Descripcion:    Lee un dato de un registro
+**  Parametros:     Bus, registro, dato leido
+**  Retorno:        True si ok
+****************************************************************************************/
+bool leerRegistroBus(const bus_t *bus, uint8_t reg, uint8_t *byteRx)
+{
+    return leerBufferRegistroBus(bus, reg, byteRx, 1);
+}
+
+
+/***************************************************************************************
+**  Nombre:         bool leerBufferRegistroBus(const bus_t *bus, uint8_t reg, uint8_t *datoRx, uint8_t longitud)
+**  Descripcion:    Lee un buffer de un registro
+**  Parametros:     Bus, registro, buffer, longitud
+**  Retorno:        True si ok
+****************************************************************************************/
+bool leerBufferRegistroBus(const bus_t *bus, uint8_t reg, uint8_t *datoRx, uint8_t longitud)
+{
+    return transferirSincronoBusSITL(bus, reg, true, datoRx, longitud);
+}
+
+
+/***************************************************************************************
+**  Nombre:         bool transferirSincronoBusSITL(const bus_t *bus, uint8_t reg, bool lectura, uint8_t *dato, uint8_t longitud)
+**  Descripcion:    Encola el acceso a un registro del SPI y espera a que termine avanzando el
+**                  tiempo simulado, como el bucle de espera de spi_bus.c
+**  Parametros:     Bus, registro, si es lectura, datos, longitud de los datos
+**  Retorno:        True si ok. False en los buses I2C
+****************************************************************************************/
+bool transferirSincronoBusSITL(const bus_t *bus, uint8_t reg, bool lectura, uint8_t *dato, uint8_t longitud)
+{
+    uint8_t buffer[TAM_BUFFER_SINCRONO_BUS_SITL];
+    transaccionSPI_t transaccion;
+
+    memset(&transaccion, 0, sizeof(transaccion));
+    if (longitud >= TAM_BUFFER_SINCRONO_BUS_SITL || !prepararTransaccionRegistroBusSITL(bus, &transaccion, reg, buffer, longitud, NULL, NULL))
+        return false;
+
+    if (lectura)
+        memset(&buffer[1], 0xFF, longitud);
+    else
+        memcpy(&buffer[1], dato, longitud);
+
+    if (!encolarTransaccionSPI(&transaccion))
+        return false;
+
+    while (!transaccionSPIterminada(&transaccion))
+        avanzarTiempoSITL(1);
+
+    if (transaccion.estado != TRANSACCION_SPI_COMPLETADA)
+        return false;
+
+    if (lectura)
+        memcpy(dato, &buffer[1], longitud);
+
+    return true;
+}
+
+
+/***************************************************************************************
+**  Nombre:         bool prepararTransaccionRegistroBusSITL(const bus_t *bus, transaccionSPI_t *transaccion, uint8_t reg,
+**                                                          uint8_t *buffer, uint16_t longitud, callbackTransaccionSPI callback,
+**                                                          void *paramUsuario)
+**  Descripcion:    Rellena una transaccion asincrona sobre un registro. Solo en buses SPI
+**  Parametros:     Bus, transaccion, registro, buffer de longitud + 1 bytes, longitud de los datos,
+**                  callback de fin y parametro del callback
+**  Retorno:        True si el bus es SPI
+****************************************************************************************/
+bool prepararTransaccionRegistroBusSITL(const bus_t *bus, transaccionSPI_t *transaccion, uint8_t reg, uint8_t *buffer, uint16_t longitud,
+		                                callbackTransaccionSPI callback, void *paramUsuario)
+{
+    if (bus->tipo != BUS_SPI)
+        return false;
+
+    buffer[0] = reg;
+
+    transaccion->numSPI = bus->bus_u.spi.numSPI;
+    transaccion->pinCS = bus->bus_u.spi.pinCS;
+    transaccion->datoTx = buffer;
+    transaccion->datoRx = buffer;
+    transaccion->longitud = longitud + 1;
+    transaccion->timeout = TIMEOUT_DEFECTO_TRANSACCION_SPI;
+    transaccion->callback = callback;
+    transaccion->paramUsuario = paramUsuario;
+    return true;
+}
+
+
+/***************************************************************************************
+**  Nombre:         bool prepararLecturaRegistroBus(const bus_t *bus, transaccionSPI_t *transaccion, uint8_t reg,
+**                                                  uint8_t *buffer, uint16_t longitud, callbackTransaccionSPI callback,
+**                                                  void *paramUsuario)
+**  Descripcion:    Prepara una lectura asincrona sin encolarla
+**  Parametros:     Bus, transaccion, registro, buffer de longitud + 1 bytes, longitud de los datos,
+**                  callback de fin y parametro del callback
+**  Retorno:        True si el bus admite transferencias asincronas
+****************************************************************************************/
+bool prepararLecturaRegistroBus(const bus_t *bus, transaccionSPI_t *transaccion, uint8_t reg, uint8_t *buffer, uint16_t longitud,
+		                        callbackTransaccionSPI callback, void *paramUsuario)
+{
+    if (!prepararTransaccionRegistroBusSITL(bus, transaccion, reg, buffer, longitud, callback, paramUsuario))
+        return false;
+
+    memset(&buffer[1], 0xFF, longitud);
+    return true;
+}
+
+
+/***************************************************************************************
+**  Nombre:         bool prepararEscrituraRegistroBus(const bus_t *bus, transaccionSPI_t *transaccion, uint8_t reg,
+**                                                    uint8_t *buffer, uint16_t longitud, callbackTransaccionSPI callback,
+**                                                    void *paramUsuario)
+**  Descripcion:    Prepara una escritura asincrona sin encolarla. Los datos van a partir de buffer[1]
+**  Parametros:     Bus, transaccion, registro, buffer de longitud + 1 bytes, longitud de los datos,
+**                  callback de fin y parametro del callback
+**  Retorno:        True si el bus admite transferencias asincronas
+****************************************************************************************/
+bool prepararEscrituraRegistroBus(const bus_t *bus, transaccionSPI_t *transaccion, uint8_t reg, uint8_t *buffer, uint16_t longitud,
+		                          callbackTransaccionSPI callback, void *paramUsuario)
+{
+    return prepararTransaccionRegistroBusSITL(bus, transaccion, reg, buffer, longitud, callback, paramUsuario);
+}
+
+
+/***************************************************************************************
+**  Nombre:         bool leerBufferRegistroAsincronoBus(const bus_t *bus, transaccionSPI_t *transaccion, uint8_t reg,
+**                                                      uint8_t *buffer, uint16_t longitud, callbackTransaccionSPI callback,
+**                                                      void *paramUsuario)
+**  Descripcion:    Encola la lectura de un registro. Los datos quedan a partir de buffer[1]
+**  Parametros:     Bus, transaccion, registro, buffer de longitud + 1 bytes, longitud de los datos,
+**                  callback de fin y parametro del callback
+**  Retorno:        True si se ha encolado
+****************************************************************************************/
+bool leerBufferRegistroAsincronoBus(const bus_t *bus, transaccionSPI_t *transaccion, uint8_t reg, uint8_t *buffer, uint16_t longitud,
+		                            callbackTransaccionSPI callback, void *paramUsuario)
+{
+    if (!prepararLecturaRegistroBus(bus, transaccion, reg, buffer, longitud, callback, paramUsuario))
+        return false;
+
+    return encolarTransaccionSPI(transaccion);
+}
+
+
+/***************************************************************************************
+**  Nombre:         bool escribirBufferRegistroAsincronoBus(const bus_t *bus, transaccionSPI_t *transaccion, uint8_t reg,
+**                                                          uint8_t *buffer, uint16_t longitud, callbackTransaccionSPI callback,
+**                                                          void *paramUsuario)
+**  Descripcion:    Encola la escritura de un registro. Los datos van a partir de buffer[1]
+**  Parametros:     Bus, transaccion, registro, buffer de longitud + 1 bytes, longitud de los datos,
+**                  callback de fin y parametro del callback
+**  Retorno:        True si se ha encolado
+****************************************************************************************/
+bool escribirBufferRegistroAsincronoBus(const bus_t *bus, transaccionSPI_t *transaccion, uint8_t reg, uint8_t *buffer, uint16_t longitud,
+		                                callbackTransaccionSPI callback, void *paramUsuario)
+{
+    if (!prepararEscrituraRegistroBus(bus, transaccion, reg, buffer, longitud, callback, paramUsuario))
+        return false;
+
+    return encolarTransaccionSPI(transaccion);
+}
+
+
+/***************************************************************************************
+**  Nombre:         bool prepararTransaccionRegistroBusI2CSITL(const bus_t *bus, transaccionI2C_t *transaccion, uint8_t reg,
+**                                                             bool lectura, uint8_t *buffer, uint16_t longitud,
+**                                                             callbackTransaccionI2C callback, void *paramUsuario)
+**  Descripcion:    Rellena una transaccion asincrona sobre un registro de un bus I2C
+**  Parametros:     Bus, transaccion, registro, si es lectura, buffer de longitud + 1 bytes,
+**                  longitud de los datos, callback de fin y parametro del callback
+**  Retorno:        True si el bus es I2C
+****************************************************************************************/
+bool prepararTransaccionRegistroBusI2CSITL(const bus_t *bus, transaccionI2C_t *transaccion, uint8_t reg, bool lectura, uint8_t *buffer,
+		                                   uint16_t longitud, callbackTransaccionI2C callback, void *paramUsuario)
+{
+    if (bus->tipo != BUS_I2C)
+        return false;
+
+    buffer[0] = reg;
+
+    transaccion->numI2C = bus->bus_u.i2c.numI2C;
+    transaccion->dir = bus->bus_u.i2c.dir;
+    transaccion->conRegistro = true;
+    transaccion->reg = reg;
+    transaccion->lectura = lectura;
+    transaccion->dato = &buffer[1];
+    transaccion->longitud = longitud;
+    transaccion->timeout = TIMEOUT_DEFECTO_TRANSACCION_I2C;
+    transaccion->callback = callback;
+    transaccion->paramUsuario = paramUsuario;
+    return true;
+}
+
+
+/***************************************************************************************
+**  Nombre:         bool prepararLecturaRegistroBusI2C(const bus_t *bus, transaccionI2C_t *transaccion, uint8_t reg,
+**                                                     uint8_t *buffer, uint16_t longitud, callbackTransaccionI2C callback,
+**                                                     void *paramUsuario)
+**  Descripcion:    Prepara una lectura asincrona de un bus I2C sin encolarla
+**  Parametros:     Bus, transaccion, registro, buffer de longitud + 1 bytes, longitud de los datos,
+**                  callback de fin y parametro del callback
+**  Retorno:        True si el bus es I2C
+****************************************************************************************/
+bool prepararLecturaRegistroBusI2C(const bus_t *bus, transaccionI2C_t *transaccion, uint8_t reg, uint8_t *buffer, uint16_t longitud,
+		                           callbackTransaccionI2C callback, void *paramUsuario)
+{
+    return prepararTransaccionRegistroBusI2CSITL(bus, transaccion, reg, true, buffer, longitud, callback, paramUsuario);
+}
+
+
+/***************************************************************************************
+**  Nombre:         bool prepararEscrituraRegistroBusI2C(const bus_t *bus, transaccionI2C_t *transaccion, uint8_t reg,
+**                                                       uint8_t *buffer, uint16_t longitud, callbackTransaccionI2C callback,
+**                                                       void *paramUsuario)
+**  Descripcion:    Prepara una escritura asincrona de un bus I2C sin encolarla. Los datos van a
+**                  partir de buffer[1]
+**  Parametros:     Bus, transaccion, registro, buffer de longitud + 1 bytes, longitud de los datos,
+**                  callback de fin y parametro del callback
+**  Retorno:        True si el bus es I2C
+****************************************************************************************/
+bool prepararEscrituraRegistroBusI2C(const bus_t *bus, transaccionI2C_t *transaccion, uint8_t reg, uint8_t *buffer, uint16_t longitud,
+		                             callbackTransaccionI2C callback, void *paramUsuario)
+{
+    return prepararTransaccionRegistroBusI2CSITL(bus, transaccion, reg, false, buffer, longitud, callback, paramUsuario);
+}
+
+
+/***************************************************************************************
+**  Nombre:         bool leerBufferRegistroAsincronoBusI2C(const bus_t *bus, transaccionI2C_t *transaccion, uint8_t reg,
+**                                                         uint8_t *buffer, uint16_t longitud, callbackTransaccionI2C callback,
+**                                                         void *paramUsuario)
+**  Descripcion:    Encola la lectura de un registro de un bus I2C. Los datos quedan a partir de buffer[1]
+**  Parametros:     Bus, transaccion, registro, buffer de longitud + 1 bytes, longitud de los datos,
+**                  callback de fin y parametro del callback
+**  Retorno:        True si se ha encolado
+****************************************************************************************/
+bool leerBufferRegistroAsincronoBusI2C(const bus_t *bus, transaccionI2C_t *transaccion, uint8_t reg, uint8_t *buffer, uint16_t longitud,
+		                               callbackTransaccionI2C callback, void *paramUsuario)
+{
+    if (!prepararLecturaRegistroBusI2C(bus, transaccion, reg, buffer, longitud, callback, paramUsuario))
+        return false;
+
+    return encolarTransaccionI2C(transaccion);
+}
+
+
+/***************************************************************************************
+**  Nombre:         bool escribirBufferRegistroAsincronoBusI2C(const bus_t *bus, transaccionI2C_t *transaccion, uint8_t reg,
+**                                                             uint8_t *buffer, uint16_t longitud, callbackTransaccionI2C callback,
+**                                                             void *paramUsuario)
+**  Descripcion:    Encola la escritura de un registro de un bus I2C. Los datos van a partir de buffer[1]
+**  Parametros:     Bus, transaccion, registro, buffer de longitud + 1 bytes, longitud de los datos,
+**                  callback de fin y parametro del callback
+**  Retorno:        True si se ha encolado
+****************************************************************************************/
+bool escribirBufferRegistroAsincronoBusI2C(const bus_t *bus, transaccionI2C_t *transaccion, uint8_t reg, uint8_t *buffer, uint16_t longitud,
+		                                   callbackTransaccionI2C callback, void *paramUsuario)
+{
+    if (!prepararEscrituraRegistroBusI2C(bus, transaccion, reg, buffer, longitud, callback, paramUsuario))
+        return false;
+
+    return encolarTransaccionI2C(transaccion);
+}
@@ -0,0 +1,135 @@
+/***************************************************************************************
+**  crc_hal.c - Unidad CRC del STM32F7 emulada a nivel de registros para el SITL
+**
+**
+**  Este fichero forma parte del proyecto URpilot.
+**  Codigo desarrollado por el grupo de investigacion ICON de la Universidad de La Rioja
+**
+**  Autor: Ramon Rico
+**  Fecha de creacion: 17/10/2026
+**  Fecha de modificacion: 17/10/2026
+**
+**  El proyecto URpilot NO es libre. No se puede distribuir y/o modificar este fichero
+**  bajo ningun concepto.
+**
+**  En caso de modificacion y/o solicitud de informacion pongase en contacto con
+**  el grupo de investigacion ICON a traves de: www.unirioja.es/urpilot
+**
+**
+**  Control de versiones del fichero
+**
+**  v1.0  Ramon Rico. Se ha liberado la primera version estable
+**
+****************************************************************************************/
+
+/***************************************************************************************
+** AREA DE INCLUDES                                                                   **
+****************************************************************************************/
+#include "Comun/crc.h"
+#include "Sistema/plataforma.h"
+
+#ifdef USAR_CRC_HW
+#include "Drivers/crc_sitl.h"
+
+
+/***************************************************************************************
+** AREA DE PREPROCESADOR                                                              **
+****************************************************************************************/
+
+
+/***************************************************************************************
+** AREA DE DEFINICION DE TIPOS                                                        **
+****************************************************************************************/
+
+
+/***************************************************************************************
+** AREA DE DECLARACION DE VARIABLES                                                   **
+****************************************************************************************/
+static uint32_t numCalculosCRChardware;
+
+
+/***************************************************************************************
+** AREA DE PROTOTIPOS DE FUNCION                                                      **
+****************************************************************************************/
+uint32_t reflejarBitsCRCsitl(uint32_t valor, uint8_t bits);
+
+
+/***************************************************************************************
+** AREA DE DEFINICION DE FUNCIONES                                                    **
+****************************************************************************************/
+
+/***************************************************************************************
+**  Nombre:         uint32_t reflejarBitsCRCsitl(uint32_t valor, uint8_t bits)
+**  Descripcion:    Invierte el orden de los bits bajos de un valor
+**  Parametros:     Valor, numero de bits
+**  Retorno:        Valor invertido
+****************************************************************************************/
+uint32_t reflejarBitsCRCsitl(uint32_t valor, uint8_t bits)
+{
+    uint32_t reflejado = 0;
+
+    for (uint8_t i = 0; i < bits; i++) {
+        if (valor & (1UL << i))
+            reflejado |= 1UL << (bits - 1 - i);
+    }
+
+    return reflejado;
+}
+
+
+/***************************************************************************************
+**  Nombre:         void iniciarCRChardware(void)
+**  Descripcion:    Inicia la unidad CRC emulada
+**  Parametros:     Ninguno
+**  Retorno:        Ninguno
+****************************************************************************************/
+void iniciarCRChardware(void)
+{
+    numCalculosCRChardware = 0;
+}
+
+
+/***************************************************************************************
+**  Nombre:         uint32_t calcularCRChardware(const configCRChardware_t *config, uint32_t valorInicial,
+**                                               const uint8_t *dato, uint32_t longitud)
+**  Descripcion:    Emula los registros de la unidad: el registro se carga con INIT, los bits
+**                  entran por arriba desplazando a la izquierda, REV_IN invierte cada byte
+**                  y REV_OUT invierte el resultado
+**  Parametros:     Configuracion, valor inicial del registro, datos, longitud
+**  Retorno:        Registro de datos de la unidad
+****************************************************************************************/
+uint32_t calcularCRChardware(const configCRChardware_t *config, uint32_t valorInicial, const uint8_t *dato, uint32_t longitud)
+{
+    const uint32_t mascara = config->bits == 32 ? 0xFFFFFFFF : (1UL << config->bits) - 1;
+    const uint32_t bitAlto = 1UL << (config->bits - 1);
+    uint32_t registro = valorInicial & mascara;
+
+    for (uint32_t n = 0; n < longitud; n++) {
+        const uint8_t byte = config->reflejado ? reflejarBitsCRCsitl(dato[n], 8) : dato[n];
+
+        for (int8_t i = 7; i >= 0; i--) {
+            const bool realimentacion = ((registro & bitAlto) != 0) != (((byte >> i) & 1) != 0);
+
+            registro = (registro << 1) & mascara;
+            if (realimentacion)
+                registro ^= config->polinomio & mascara;
+        }
+    }
+
+    numCalculosCRChardware++;
+    return config->reflejado ? reflejarBitsCRCsitl(registro, config->bits) : registro;
+}
+
+
+/***************************************************************************************
+**  Nombre:         uint32_t calculosCRChardwareSITL(void)
+**  Descripcion:    Bloques calculados por la unidad emulada desde que se inicio
+**  Parametros:     Ninguno
+**  Retorno:        Numero de bloques
+****************************************************************************************/
+uint32_t calculosCRChardwareSITL(void)
+{
+    return numCalculosCRChardware;
+}
+
+#endif
@@ -0,0 +1,292 @@
+/***************************************************************************************
+**  flash.c - Flash de configuracion emulada para el SITL. Cada sector borrado y cada
+**            word programada es un paso en el que se puede cortar la alimentacion
+**
+**
+**  Este fichero forma parte del proyecto URpilot.
+**  Codigo desarrollado por el grupo de investigacion ICON de la Universidad de La Rioja
+**
+**  Autor: Ramon Rico
+**  Fecha de creacion: 17/10/2026
+**  Fecha de modificacion: 17/10/2026
+**
+**  El proyecto URpilot NO es libre. No se puede distribuir y/o modificar este fichero
+**  bajo ningun concepto.
+**
+**  En caso de modificacion y/o solicitud de informacion pongase en contacto con
+**  el grupo de investigacion ICON a traves de: www.unirioja.es/urpilot
+**
+**
+**  Control de versiones del fichero
+**
+**  v1.0  Ramon Rico. Se ha liberado la primera version estable
+**
+****************************************************************************************/
+
+/***************************************************************************************
+** AREA DE INCLUDES                                                                   **
+****************************************************************************************/
+#include <string.h>
+
+#include "Drivers/flash.h"
+#include "Drivers/flash_sitl.h"
+
+
+/***************************************************************************************
+** AREA DE PREPROCESADOR                                                              **
+****************************************************************************************/
+
+
+/***************************************************************************************
+** AREA DE DEFINICION DE TIPOS                                                        **
+****************************************************************************************/
+typedef enum {
+    PASO_FLASH_SITL_OK = 0,
+    PASO_FLASH_SITL_CORTADO,                // Se corta la alimentacion en mitad del paso
+    PASO_FLASH_SITL_SIN_ALIMENTACION,
+} pasoFlashSITL_e;
+
+
+/***************************************************************************************
+** AREA DE DECLARACION DE VARIABLES                                                   **
+****************************************************************************************/
+// Los simbolos de la region de configuracion apuntan aqui (sitl.ld)
+uint8_t memoriaFlashSITL[TAM_FLASH_SITL] __attribute__((aligned(32)));
+
+static bool alimentacionFlashSITL;
+static uint32_t pasosHastaCorteFlashSITL;
+static uint32_t semillaFlashSITL;
+static estadisticasFlashSITL_t estadisticasFlash;
+
+
+/***************************************************************************************
+** AREA DE PROTOTIPOS DE FUNCION                                                      **
+****************************************************************************************/
+uint32_t aleatorioFlashSITL(void);
+pasoFlashSITL_e avanzarPasoFlashSITL(void);
+bool rangoValidoFlashSITL(uintptr_t dir, uint32_t tam);
+
+
+/***************************************************************************************
+** AREA DE DEFINICION DE FUNCIONES                                                    **
+****************************************************************************************/
+
+/***************************************************************************************
+**  Nombre:         void iniciarFlashSITL(uint32_t semilla)
+**  Descripcion:    Deja la flash borrada, con alimentacion y sin corte programado
+**  Parametros:     Semilla del contenido de los pasos cortados
+**  Retorno:        Ninguno
+****************************************************************************************/
+void iniciarFlashSITL(uint32_t semilla)
+{
+    memset(memoriaFlashSITL, 0xFF, sizeof(memoriaFlashSITL));
+    memset(&estadisticasFlash, 0, sizeof(estadisticasFlash));
+    semillaFlashSITL = semilla;
+    restaurarAlimentacionFlashSITL();
+}
+
+
+/***************************************************************************************
+**  Nombre:         void programarCorteFlashSITL(uint32_t paso)
+**  Descripcion:    Programa un corte de alimentacion a mitad de un paso futuro
+**  Parametros:     Numero de pasos completos antes del corte
+**  Retorno:        Ninguno
+****************************************************************************************/
+void programarCorteFlashSITL(uint32_t paso)
+{
+    pasosHastaCorteFlashSITL = paso;
+}
+
+
+/***************************************************************************************
+**  Nombre:         void restaurarAlimentacionFlashSITL(void)
+**  Descripcion:    Vuelve la alimentacion y se anula el corte programado
+**  Parametros:     Ninguno
+**  Retorno:        Ninguno
+****************************************************************************************/
+void restaurarAlimentacionFlashSITL(void)
+{
+    alimentacionFlashSITL = true;
+    pasosHastaCorteFlashSITL = CORTE_DESACTIVADO_FLASH_SITL;
+}
+
+
+/***************************************************************************************
+**  Nombre:         bool sinAlimentacionFlashSITL(void)
+**  Descripcion:    Indica si se ha producido el corte programado
+**  Parametros:     Ninguno
+**  Retorno:        True si no hay alimentacion
+****************************************************************************************/
+bool sinAlimentacionFlashSITL(void)
+{
+    return !alimentacionFlashSITL;
+}
+
+
+/***************************************************************************************
+**  Nombre:         void estadisticasFlashSITL(estadisticasFlashSITL_t *estadisticas)
+**  Descripcion:    Devuelve los contadores de la flash emulada
+**  Parametros:     Estadisticas
+**  Retorno:        Ninguno
+****************************************************************************************/
+void estadisticasFlashSITL(estadisticasFlashSITL_t *estadisticas)
+{
+    *estadisticas = estadisticasFlash;
+}
+
+
+/***************************************************************************************
+**  Nombre:         void leerImagenFlashSITL(uint8_t *imagen)
+**  Descripcion:    Copia el contenido completo de la flash emulada
+**  Parametros:     Imagen de TAM_FLASH_SITL bytes
+**  Retorno:        Ninguno
+****************************************************************************************/
+void leerImagenFlashSITL(uint8_t *imagen)
+{
+    memcpy(imagen, memoriaFlashSITL, TAM_FLASH_SITL);
+}
+
+
+/***************************************************************************************
+**  Nombre:         void escribirImagenFlashSITL(const uint8_t *imagen)
+**  Descripcion:    Sustituye el contenido de la flash emulada sin contar pasos
+**  Parametros:     Imagen de TAM_FLASH_SITL bytes
+**  Retorno:        Ninguno
+****************************************************************************************/
+void escribirImagenFlashSITL(const uint8_t *imagen)
+{
+    memcpy(memoriaFlashSITL, imagen, TAM_FLASH_SITL);
+}
+
+
+/***************************************************************************************
+**  Nombre:         bool borrarFlash(uintptr_t dir, uint32_t tam)
+**  Descripcion:    Borra los sectores que contienen el rango. Un borrado cortado deja el
+**                  sector con contenido aleatorio
+**  Parametros:     Direccion de inicio, tamanio en bytes
+**  Retorno:        True si ok
+****************************************************************************************/
+bool borrarFlash(uintptr_t dir, uint32_t tam)
+{
+    if (!rangoValidoFlashSITL(dir, tam))
+        return false;
+
+    const uint32_t offset = dir - (uintptr_t)memoriaFlashSITL;
+
+    for (uint32_t sector = offset - offset % TAM_SECTOR_FLASH_SITL; sector < offset + tam; sector += TAM_SECTOR_FLASH_SITL) {
+        const pasoFlashSITL_e paso = avanzarPasoFlashSITL();
+
+        if (paso == PASO_FLASH_SITL_SIN_ALIMENTACION)
+            return false;
+
+        estadisticasFlash.numBorrados++;
+
+        if (paso == PASO_FLASH_SITL_CORTADO) {
+            for (uint32_t i = 0; i < TAM_SECTOR_FLASH_SITL; i++)
+                memoriaFlashSITL[sector + i] = (uint8_t)aleatorioFlashSITL();
+            return false;
+        }
+
+        memset(&memoriaFlashSITL[sector], 0xFF, TAM_SECTOR_FLASH_SITL);
+    }
+
+    return true;
+}
+
+
+/***************************************************************************************
+**  Nombre:         bool programarFlash(uintptr_t dir, const void *datos, uint32_t tam)
+**  Descripcion:    Programa word a word. Como en la flash real solo se pasan bits de 1 a 0
+**                  y una word cortada solo programa parte de sus bits
+**  Parametros:     Direccion de inicio y tamanio, ambos multiplos de 4, datos
+**  Retorno:        True si ok
+****************************************************************************************/
+bool programarFlash(uintptr_t dir, const void *datos, uint32_t tam)
+{
+    const uint8_t *p = datos;
+
+    if (dir % sizeof(uint32_t) != 0 || tam % sizeof(uint32_t) != 0 || !rangoValidoFlashSITL(dir, tam))
+        return false;
+
+    uint8_t *destino = &memoriaFlashSITL[dir - (uintptr_t)memoriaFlashSITL];
+
+    for (uint32_t i = 0; i < tam; i += sizeof(uint32_t)) {
+        const pasoFlashSITL_e paso = avanzarPasoFlashSITL();
+        uint32_t valor, anterior;
+
+        if (paso == PASO_FLASH_SITL_SIN_ALIMENTACION)
+            return false;
+
+        memcpy(&valor, &p[i], sizeof(valor));
+        memcpy(&anterior, &destino[i], sizeof(anterior));
+        estadisticasFlash.numWords++;
+
+        if (valor & ~anterior)
+            estadisticasFlash.numViolaciones++;
+
+        if (paso == PASO_FLASH_SITL_CORTADO)
+            valor |= aleatorioFlashSITL();
+
+        valor &= anterior;
+        memcpy(&destino[i], &valor, sizeof(valor));
+
+        if (paso == PASO_FLASH_SITL_CORTADO)
+            return false;
+    }
+
+    return true;
+}
+
+
+/***************************************************************************************
+**  Nombre:         uint32_t aleatorioFlashSITL(void)
+**  Descripcion:    Generador xorshift reproducible
+**  Parametros:     Ninguno
+**  Retorno:        Numero aleatorio
+****************************************************************************************/
+uint32_t aleatorioFlashSITL(void)
+{
+    semillaFlashSITL ^= semillaFlashSITL << 13;
+    semillaFlashSITL ^= semillaFlashSITL >> 17;
+    semillaFlashSITL ^= semillaFlashSITL << 5;
+    return semillaFlashSITL;
+}
+
+
+/***************************************************************************************
+**  Nombre:         pasoFlashSITL_e avanzarPasoFlashSITL(void)
+**  Descripcion:    Cuenta un paso de escritura y aplica el corte programado
+**  Parametros:     Ninguno
+**  Retorno:        Estado de la alimentacion durante el paso
+****************************************************************************************/
+pasoFlashSITL_e avanzarPasoFlashSITL(void)
+{
+    if (!alimentacionFlashSITL) {
+        estadisticasFlash.numOperacionesSinAlimentacion++;
+        return PASO_FLASH_SITL_SIN_ALIMENTACION;
+    }
+
+    estadisticasFlash.numPasos++;
+
+    if (pasosHastaCorteFlashSITL == 0) {
+        alimentacionFlashSITL = false;
+        return PASO_FLASH_SITL_CORTADO;
+    }
+
+    if (pasosHastaCorteFlashSITL != CORTE_DESACTIVADO_FLASH_SITL)
+        pasosHastaCorteFlashSITL--;
+
+    return PASO_FLASH_SITL_OK;
+}
+
+
+/***************************************************************************************
+**  Nombre:         bool rangoValidoFlashSITL(uintptr_t dir, uint32_t tam)
+**  Descripcion:    Comprueba que el rango esta dentro de la flash emulada
+**  Parametros:     Direccion de inicio, tamanio
+**  Retorno:        True si ok
+****************************************************************************************/
+bool rangoValidoFlashSITL(uintptr_t dir, uint32_t tam)
+{
+    return dir >= (uintptr_t)memoriaFlashSITL && dir + tam <= (uintptr_t)memoriaFlashSITL + TAM_FLASH_SITL;
+}
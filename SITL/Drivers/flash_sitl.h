@@ -0,0 +1,71 @@
+/***************************************************************************************
+**  flash_sitl.h - Flash de configuracion emulada con cortes de alimentacion para el SITL
+**
+**
+**  Este fichero forma parte del proyecto URpilot.
+**  Codigo desarrollado por el grupo de investigacion ICON de la Universidad de La Rioja
+**
+**  Autor: Ramon Rico
+**  Fecha de creacion: 17/10/2026
+**  Fecha de modificacion: 17/10/2026
+**
+**  El proyecto URpilot NO es libre. No se puede distribuir y/o modificar este fichero
+**  bajo ningun concepto.
+**
+**  En caso de modificacion y/o solicitud de informacion pongase en contacto con
+**  el grupo de investigacion ICON a traves de: www.unirioja.es/urpilot
+**
+**
+**  Control de versiones del fichero
+**
+**  v1.0  Ramon Rico. Se ha liberado la primera version estable
+**
+****************************************************************************************/
+
+#ifndef __FLASH_SITL_H
+#define __FLASH_SITL_H
+
+/***************************************************************************************
+** AREA DE INCLUDES                                                                   **
+****************************************************************************************/
+#include <stdint.h>
+#include <stdbool.h>
+
+
+/***************************************************************************************
+** AREA DE PREPROCESADOR                                                              **
+****************************************************************************************/
+#define TAM_FLASH_SITL                  0x10000     // Dos sectores de 32K como la region de configuracion de la placa
+#define TAM_SECTOR_FLASH_SITL           0x8000
+#define CORTE_DESACTIVADO_FLASH_SITL    0xFFFFFFFF
+
+
+/***************************************************************************************
+** AREA DE DEFINICION DE TIPOS                                                        **
+****************************************************************************************/
+typedef struct {
+    uint32_t numPasos;                      // Sectores borrados y words programadas
+    uint32_t numBorrados;
+    uint32_t numWords;
+    uint32_t numViolaciones;                // Words que intentan pasar algun bit de 0 a 1
+    uint32_t numOperacionesSinAlimentacion;
+} estadisticasFlashSITL_t;
+
+
+/***************************************************************************************
+** AREA DE DECLARACION DE VARIABLES                                                   **
+****************************************************************************************/
+
+
+/***************************************************************************************
+** AREA DE PROTOTIPOS DE FUNCION                                                      **
+****************************************************************************************/
+void iniciarFlashSITL(uint32_t semilla);
+void programarCorteFlashSITL(uint32_t paso);
+void restaurarAlimentacionFlashSITL(void);
+bool sinAlimentacionFlashSITL(void);
+void estadisticasFlashSITL(estadisticasFlashSITL_t *estadisticas);
+void leerImagenFlashSITL(uint8_t *imagen);
+void escribirImagenFlashSITL(const uint8_t *imagen);
+
+#endif // __FLASH_SITL_H
@@ -0,0 +1,396 @@
+/***************************************************************************************
+**  i2c_sitl.c - I2C simulado con inyeccion de fallos para la cola de transacciones
+**
+**
+**  Este fichero forma parte del proyecto URpilot.
+**  Codigo desarrollado por el grupo de investigacion ICON de la Universidad de La Rioja
+**
+**  Autor: Ramon Rico
+**  Fecha de creacion: 17/10/2026
+**  Fecha de modificacion: 17/10/2026
+**
+**  El proyecto URpilot NO es libre. No se puede distribuir y/o modificar este fichero
+**  bajo ningun concepto.
+**
+**  En caso de modificacion y/o solicitud de informacion pongase en contacto con
+**  el grupo de investigacion ICON a traves de: www.unirioja.es/urpilot
+**
+**
+**  Control de versiones del fichero
+**
+**  v1.0  Ramon Rico. Se ha liberado la primera version estable
+**
+****************************************************************************************/
+
+/***************************************************************************************
+** AREA DE INCLUDES                                                                   **
+****************************************************************************************/
+#include <stdio.h>
+#include <string.h>
+
+#include "i2c_sitl.h"
+#include "Core/pruebas_sitl.h"
+#include "tiempo_sitl.h"
+#include "Drivers/bus.h"
+#include "Drivers/i2c_cola.h"
+
+
+/***************************************************************************************
+** AREA DE PREPROCESADOR                                                              **
+****************************************************************************************/
+#define NUM_REGISTROS_I2C_SITL          128
+#define US_POR_BYTE_I2C_SITL            23          // 9 bits a 400 KHz
+#define DIR_DISPOSITIVO_I2C_SITL        0x0E        // Unico esclavo que responde en cada bus
+#define DIR_AUSENTE_I2C_SITL            0x1E
+#define PULSOS_LIBERAR_SDA_I2C_SITL     3           // Bits que le faltan al esclavo para soltar SDA
+#define I2C_PRUEBA_SITL                 I2C_3
+#define NUM_TRANSACCIONES_PRUEBA_I2C    3
+
+
+/***************************************************************************************
+** AREA DE DEFINICION DE TIPOS                                                        **
+****************************************************************************************/
+typedef struct {
+    bool activa;
+    const transaccionI2C_t *transaccion;
+    uint64_t tiempoFin;
+    falloI2Csitl_e fallo;                   // Fallo de la transferencia en curso
+    falloI2Csitl_e falloInyectado;
+    uint8_t numFallosInyectados;
+    bool sdaBloqueado;
+    uint16_t numPulsosRecuperacion;
+    uint8_t punteroRegistro;
+    uint8_t registros[NUM_REGISTROS_I2C_SITL];
+} i2cSITL_t;
+
+
+/***************************************************************************************
+** AREA DE DECLARACION DE VARIABLES                                                   **
+****************************************************************************************/
+static i2cSITL_t i2cSITL[NUM_MAX_I2C];
+
+// Traza de la prueba de la cola
+static uint8_t ordenPruebaI2C[NUM_TRANSACCIONES_PRUEBA_I2C];
+static uint8_t numTerminadasPruebaI2C;
+
+
+/***************************************************************************************
+** AREA DE PROTOTIPOS DE FUNCION                                                      **
+****************************************************************************************/
+void transferirRegistrosI2Csitl(i2cSITL_t *driver, const transaccionI2C_t *transaccion);
+void callbackPruebaI2Csitl(transaccionI2C_t *transaccion);
+void esperarTransaccionesI2Csitl(transaccionI2C_t *transaccion, uint8_t numTransacciones);
+const char *nombreEstadoI2Csitl(estadoTransaccionI2C_e estado);
+
+
+/***************************************************************************************
+** AREA DE DEFINICION DE FUNCIONES                                                    **
+****************************************************************************************/
+
+/***************************************************************************************
+**  Nombre:         bool iniciarTransferenciaAsincronaI2C(numI2C_e numI2C, const transaccionI2C_t *transaccion)
+**  Descripcion:    Lanza una transferencia que termina en actualizarI2Csitl. Con SDA
+**                  bloqueado el bus esta ocupado y no se puede empezar
+**  Parametros:     Dispositivo, transaccion
+**  Retorno:        True si la transferencia ha empezado
+****************************************************************************************/
+bool iniciarTransferenciaAsincronaI2C(numI2C_e numI2C, const transaccionI2C_t *transaccion)
+{
+    i2cSITL_t *driver = &i2cSITL[numI2C];
+
+    if (driver->activa || driver->sdaBloqueado)
+        return false;
+
+    driver->activa = true;
+    driver->transaccion = transaccion;
+    driver->fallo = FALLO_I2C_SITL_NINGUNO;
+
+    if (driver->numFallosInyectados > 0) {
+        driver->fallo = driver->falloInyectado;
+        driver->numFallosInyectados--;
+    }
+
+    // Direccion, registro con su start repetido y datos
+    const uint16_t numBytes = 1 + (transaccion->conRegistro ? (transaccion->lectura ? 2 : 1) : 0) + transaccion->longitud;
+    driver->tiempoFin = tiempoSimuladoSITL() + numBytes * US_POR_BYTE_I2C_SITL;
+    return true;
+}
+
+
+/***************************************************************************************
+**  Nombre:         void abortarTransferenciaAsincronaI2C(numI2C_e numI2C)
+**  Descripcion:    Aborta la transferencia en curso
+**  Parametros:     Dispositivo
+**  Retorno:        Ninguno
+****************************************************************************************/
+void abortarTransferenciaAsincronaI2C(numI2C_e numI2C)
+{
+    i2cSITL[numI2C].activa = false;
+}
+
+
+/***************************************************************************************
+**  Nombre:         bool recuperarBusI2C(numI2C_e numI2C)
+**  Descripcion:    Pulsos de reloj hasta que el esclavo suelta SDA
+**  Parametros:     Dispositivo
+**  Retorno:        True si SDA ha quedado libre
+****************************************************************************************/
+bool recuperarBusI2C(numI2C_e numI2C)
+{
+    i2cSITL_t *driver = &i2cSITL[numI2C];
+
+    driver->activa = false;
+
+    for (uint8_t i = 0; i < 9 && driver->sdaBloqueado; i++) {
+        driver->numPulsosRecuperacion++;
+
+        if (i + 1 >= PULSOS_LIBERAR_SDA_I2C_SITL)
+            driver->sdaBloqueado = false;
+    }
+
+    return !driver->sdaBloqueado;
+}
+
+
+/***************************************************************************************
+**  Nombre:         void transferirRegistrosI2Csitl(i2cSITL_t *driver, const transaccionI2C_t *transaccion)
+**  Descripcion:    Lee o escribe el mapa de registros del esclavo. El puntero de registro
+**                  avanza con cada byte como en los sensores reales
+**  Parametros:     Bus simulado, transaccion
+**  Retorno:        Ninguno
+****************************************************************************************/
+void transferirRegistrosI2Csitl(i2cSITL_t *driver, const transaccionI2C_t *transaccion)
+{
+    if (transaccion->conRegistro)
+        driver->punteroRegistro = transaccion->reg;
+
+    for (uint16_t i = 0; i < transaccion->longitud; i++) {
+        uint8_t *registro = &driver->registros[driver->punteroRegistro % NUM_REGISTROS_I2C_SITL];
+
+        if (transaccion->lectura)
+            transaccion->dato[i] = *registro;
+        else
+            *registro = transaccion->dato[i];
+
+        driver->punteroRegistro++;
+    }
+}
+
+
+/***************************************************************************************
+**  Nombre:         void actualizarI2Csitl(uint64_t tiempoUs)
+**  Descripcion:    Termina las transferencias cuyo tiempo ha pasado aplicando el fallo
+**                  inyectado. Los buses sin transferencia terminada pasan por el timeout
+**                  y la recuperacion de la cola
+**  Parametros:     Tiempo de simulacion en us
+**  Retorno:        Ninguno
+****************************************************************************************/
+void actualizarI2Csitl(uint64_t tiempoUs)
+{
+    for (numI2C_e numI2C = 0; numI2C < NUM_MAX_I2C; numI2C++) {
+        i2cSITL_t *driver = &i2cSITL[numI2C];
+
+        if (!driver->activa || driver->fallo == FALLO_I2C_SITL_COLGADA || tiempoUs < driver->tiempoFin) {
+            comprobarTimeoutColaI2C(numI2C, (uint32_t)tiempoUs);
+            continue;
+        }
+
+        const transaccionI2C_t *transaccion = driver->transaccion;
+        driver->activa = false;
+
+        switch (driver->fallo) {
+            case FALLO_I2C_SITL_NACK:
+                finalizarTransferenciaColaI2C(numI2C, RESULTADO_I2C_NACK);
+                break;
+
+            case FALLO_I2C_SITL_ARBITRAJE:
+                finalizarTransferenciaColaI2C(numI2C, RESULTADO_I2C_ARBITRAJE);
+                break;
+
+            case FALLO_I2C_SITL_SDA_BLOQUEADO:
+                driver->sdaBloqueado = true;
+                finalizarTransferenciaColaI2C(numI2C, RESULTADO_I2C_ERROR);
+                break;
+
+            default:
+                if (transaccion->dir != DIR_DISPOSITIVO_I2C_SITL) {
+                    finalizarTransferenciaColaI2C(numI2C, RESULTADO_I2C_NACK);
+                    break;
+                }
+
+                transferirRegistrosI2Csitl(driver, transaccion);
+                finalizarTransferenciaColaI2C(numI2C, RESULTADO_I2C_OK);
+                break;
+        }
+    }
+}
+
+
+/***************************************************************************************
+**  Nombre:         void inyectarFalloI2Csitl(numI2C_e numI2C, falloI2Csitl_e fallo, uint8_t numVeces)
+**  Descripcion:    Las siguientes transferencias del bus terminan con un fallo
+**  Parametros:     Dispositivo, fallo, numero de transferencias afectadas
+**  Retorno:        Ninguno
+****************************************************************************************/
+void inyectarFalloI2Csitl(numI2C_e numI2C, falloI2Csitl_e fallo, uint8_t numVeces)
+{
+    i2cSITL[numI2C].falloInyectado = fallo;
+    i2cSITL[numI2C].numFallosInyectados = numVeces;
+}
+
+
+/***************************************************************************************
+**  Nombre:         void callbackPruebaI2Csitl(transaccionI2C_t *transaccion)
+**  Descripcion:    Apunta el orden de terminacion
+**  Parametros:     Transaccion terminada
+**  Retorno:        Ninguno
+****************************************************************************************/
+void callbackPruebaI2Csitl(transaccionI2C_t *transaccion)
+{
+    if (numTerminadasPruebaI2C < sizeof(ordenPruebaI2C))
+        ordenPruebaI2C[numTerminadasPruebaI2C++] = (uint8_t)(uintptr_t)transaccion->paramUsuario;
+}
+
+
+/***************************************************************************************
+**  Nombre:         void esperarTransaccionesI2Csitl(transaccionI2C_t *transaccion, uint8_t numTransacciones)
+**  Descripcion:    Avanza el tiempo virtual hasta que terminan las transacciones
+**  Parametros:     Transacciones, numero de transacciones
+**  Retorno:        Ninguno
+****************************************************************************************/
+void esperarTransaccionesI2Csitl(transaccionI2C_t *transaccion, uint8_t numTransacciones)
+{
+    for (uint32_t i = 0; i < 10 * TIMEOUT_DEFECTO_TRANSACCION_I2C; i++) {
+        if (cadenaTransaccionesI2Cterminada(transaccion, numTransacciones))
+            return;
+
+        avanzarTiempoSITL(1);
+    }
+}
+
+
+/***************************************************************************************
+**  Nombre:         const char *nombreEstadoI2Csitl(estadoTransaccionI2C_e estado)
+**  Descripcion:    Nombre del estado de una transaccion
+**  Parametros:     Estado
+**  Retorno:        Nombre
+****************************************************************************************/
+const char *nombreEstadoI2Csitl(estadoTransaccionI2C_e estado)
+{
+    switch (estado) {
+        case TRANSACCION_I2C_COMPLETADA:
+            return "completada";
+
+        case TRANSACCION_I2C_NACK:
+            return "NACK";
+
+        case TRANSACCION_I2C_ERROR:
+            return "error";
+
+        case TRANSACCION_I2C_TIMEOUT:
+            return "timeout";
+
+        default:
+            return "sin terminar";
+    }
+}
+
+
+/***************************************************************************************
+**  Nombre:         void probarColaI2Csitl(void)
+**  Descripcion:    Ejercita la cola sobre un bus libre: una cadena con un dispositivo que
+**                  no responde, perdidas de arbitraje, una transferencia colgada y un error
+**                  de bus con SDA bloqueado. Tras cada fallo la siguiente transaccion debe
+**                  terminar bien
+**  Parametros:     Ninguno
+**  Retorno:        Ninguno
+****************************************************************************************/
+void probarColaI2Csitl(void)
+{
+    const bus_t bus = { .tipo = BUS_I2C, .bus_u.i2c = { I2C_PRUEBA_SITL, DIR_DISPOSITIVO_I2C_SITL } };
+    const bus_t busAusente = { .tipo = BUS_I2C, .bus_u.i2c = { I2C_PRUEBA_SITL, DIR_AUSENTE_I2C_SITL } };
+    transaccionI2C_t transaccion[NUM_TRANSACCIONES_PRUEBA_I2C];
+    uint8_t bufferEscritura[4] = { 0, 0x11, 0x22, 0x33 };
+    uint8_t bufferLectura[4];
+    uint8_t bufferLecturaB[4];
+    uint8_t bufferAusente[2];
+    estadisticasColaI2C_t estadisticas;
+    estadisticasDispositivoI2C_t dispositivo, ausente;
+
+    memset(transaccion, 0, sizeof(transaccion));
+    memset(&i2cSITL[I2C_PRUEBA_SITL], 0, sizeof(i2cSITL[I2C_PRUEBA_SITL]));
+    numTerminadasPruebaI2C = 0;
+    iniciarColaI2C(I2C_PRUEBA_SITL);
+
+    // Cadena: escritura, lectura de lo escrito y lectura de un dispositivo ausente
+    prepararEscrituraRegistroBusI2C(&bus, &transaccion[0], 0x10, bufferEscritura, 3, callbackPruebaI2Csitl, (void *)1);
+    prepararLecturaRegistroBusI2C(&bus, &transaccion[1], 0x10, bufferLectura, 3, callbackPruebaI2Csitl, (void *)2);
+    prepararLecturaRegistroBusI2C(&busAusente, &transaccion[2], 0x00, bufferAusente, 1, callbackPruebaI2Csitl, (void *)3);
+    encolarCadenaTransaccionesI2C(transaccion, NUM_TRANSACCIONES_PRUEBA_I2C);
+    esperarTransaccionesI2Csitl(transaccion, NUM_TRANSACCIONES_PRUEBA_I2C);
+
+    const bool ordenOk = numTerminadasPruebaI2C == 3 && ordenPruebaI2C[0] == 1 && ordenPruebaI2C[1] == 2 && ordenPruebaI2C[2] == 3;
+    const bool datosOk = transaccion[1].estado == TRANSACCION_I2C_COMPLETADA && memcmp(&bufferLectura[1], &bufferEscritura[1], 3) == 0;
+    const bool nackOk = transaccion[2].estado == TRANSACCION_I2C_NACK;
+
+    printf("\nCola I2C (SITL)\n");
+    printf("  Cadena: orden %u %u %u | datos %s | dispositivo ausente %s\n", ordenPruebaI2C[0], ordenPruebaI2C[1], ordenPruebaI2C[2],
+           datosOk ? "ok" : "mal", nombreEstadoI2Csitl(transaccion[2].estado));
+
+    // Arbitraje perdido: se reintenta hasta el maximo
+    inyectarFalloI2Csitl(I2C_PRUEBA_SITL, FALLO_I2C_SITL_ARBITRAJE, NUM_MAX_REINTENTOS_ARBITRAJE_I2C - 1);
+    leerBufferRegistroAsincronoBusI2C(&bus, &transaccion[0], 0x10, bufferLectura, 3, NULL, NULL);
+    esperarTransaccionesI2Csitl(&transaccion[0], 1);
+    const estadoTransaccionI2C_e estadoReintento = transaccion[0].estado;
+
+    inyectarFalloI2Csitl(I2C_PRUEBA_SITL, FALLO_I2C_SITL_ARBITRAJE, NUM_MAX_REINTENTOS_ARBITRAJE_I2C + 1);
+    leerBufferRegistroAsincronoBusI2C(&bus, &transaccion[0], 0x10, bufferLectura, 3, NULL, NULL);
+    esperarTransaccionesI2Csitl(&transaccion[0], 1);
+    const estadoTransaccionI2C_e estadoAgotado = transaccion[0].estado;
+
+    printf("  Arbitraje perdido %u veces: %s | %u veces: %s\n", NUM_MAX_REINTENTOS_ARBITRAJE_I2C - 1, nombreEstadoI2Csitl(estadoReintento),
+           NUM_MAX_REINTENTOS_ARBITRAJE_I2C + 1, nombreEstadoI2Csitl(estadoAgotado));
+
+    // Transferencia colgada seguida de otra
+    inyectarFalloI2Csitl(I2C_PRUEBA_SITL, FALLO_I2C_SITL_COLGADA, 1);
+    leerBufferRegistroAsincronoBusI2C(&bus, &transaccion[0], 0x10, bufferLectura, 3, NULL, NULL);
+    leerBufferRegistroAsincronoBusI2C(&bus, &transaccion[1], 0x11, bufferLecturaB, 2, NULL, NULL);
+    esperarTransaccionesI2Csitl(&transaccion[1], 1);
+    const estadoTransaccionI2C_e estadoColgada = transaccion[0].estado;
+    const estadoTransaccionI2C_e estadoTrasColgada = transaccion[1].estado;
+
+    printf("  Transferencia colgada: %s, siguiente %s\n", nombreEstadoI2Csitl(estadoColgada), nombreEstadoI2Csitl(estadoTrasColgada));
+
+    // Error de bus con SDA retenido por el esclavo
+    inyectarFalloI2Csitl(I2C_PRUEBA_SITL, FALLO_I2C_SITL_SDA_BLOQUEADO, 1);
+    leerBufferRegistroAsincronoBusI2C(&bus, &transaccion[0], 0x10, bufferLectura, 3, NULL, NULL);
+    leerBufferRegistroAsincronoBusI2C(&bus, &transaccion[1], 0x11, bufferLecturaB, 2, NULL, NULL);
+    esperarTransaccionesI2Csitl(&transaccion[1], 1);
+    const estadoTransaccionI2C_e estadoBloqueo = transaccion[0].estado;
+    const estadoTransaccionI2C_e estadoTrasBloqueo = transaccion[1].estado;
+    const bool datosTrasBloqueoOk = bufferLecturaB[1] == 0x22 && bufferLecturaB[2] == 0x33;
+
+    printf("  SDA bloqueado: %s, siguiente %s tras %u pulsos de reloj | datos %s\n", nombreEstadoI2Csitl(estadoBloqueo),
+           nombreEstadoI2Csitl(estadoTrasBloqueo), i2cSITL[I2C_PRUEBA_SITL].numPulsosRecuperacion, datosTrasBloqueoOk ? "ok" : "mal");
+
+    estadisticasColaI2C(I2C_PRUEBA_SITL, &estadisticas);
+    memset(&dispositivo, 0, sizeof(dispositivo));
+    memset(&ausente, 0, sizeof(ausente));
+    estadisticasDispositivoI2C(I2C_PRUEBA_SITL, DIR_DISPOSITIVO_I2C_SITL, &dispositivo);
+    estadisticasDispositivoI2C(I2C_PRUEBA_SITL, DIR_AUSENTE_I2C_SITL, &ausente);
+
+    printf("  Bus: transacciones %lu, errores %u, timeouts %u, recuperaciones %u, cola max %u\n", (unsigned long)estadisticas.numTransacciones,
+           estadisticas.numErrores, estadisticas.numTimeouts, estadisticas.numRecuperaciones, estadisticas.longitudMaxCola);
+    printf("  Dispositivo 0x%02X: transacciones %lu, NACK %u, arbitrajes %u, errores %u, timeouts %u\n", dispositivo.dir,
+           (unsigned long)dispositivo.numTransacciones, dispositivo.numNACK, dispositivo.numArbitrajes, dispositivo.numErrores, dispositivo.numTimeouts);
+    printf("  Dispositivo 0x%02X: transacciones %lu, NACK %u\n", ausente.dir, (unsigned long)ausente.numTransacciones, ausente.numNACK);
+
+    const bool ok = ordenOk && datosOk && nackOk &&
+                    estadoReintento == TRANSACCION_I2C_COMPLETADA && estadoAgotado == TRANSACCION_I2C_ERROR &&
+                    estadoColgada == TRANSACCION_I2C_TIMEOUT && estadoTrasColgada == TRANSACCION_I2C_COMPLETADA &&
+                    estadoBloqueo == TRANSACCION_I2C_ERROR && estadoTrasBloqueo == TRANSACCION_I2C_COMPLETADA && datosTrasBloqueoOk &&
+                    estadisticas.numRecuperaciones == 2 && dispositivo.numArbitrajes == 2 * NUM_MAX_REINTENTOS_ARBITRAJE_I2C &&
+                    dispositivo.numNACK == 0 && ausente.numNACK == 1;
+
+    printf("  Resultado: %s\n", ok ? "ok" : "fallo");
+}
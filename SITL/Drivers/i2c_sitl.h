@@ -0,0 +1,65 @@
+/***************************************************************************************
+**  i2c_sitl.h - I2C simulado con inyeccion de fallos para la cola de transacciones
+**
+**
+**  Este fichero forma parte del proyecto URpilot.
+**  Codigo desarrollado por el grupo de investigacion ICON de la Universidad de La Rioja
+**
+**  Autor: Ramon Rico
+**  Fecha de creacion: 17/10/2026
+**  Fecha de modificacion: 17/10/2026
+**
+**  El proyecto URpilot NO es libre. No se puede distribuir y/o modificar este fichero
+**  bajo ningun concepto.
+**
+**  En caso de modificacion y/o solicitud de informacion pongase en contacto con
+**  el grupo de investigacion ICON a traves de: www.unirioja.es/urpilot
+**
+**
+**  Control de versiones del fichero
+**
+**  v1.0  Ramon Rico. Se ha liberado la primera version estable
+**
+****************************************************************************************/
+
+#ifndef __I2C_SITL_H
+#define __I2C_SITL_H
+
+/***************************************************************************************
+** AREA DE INCLUDES                                                                   **
+****************************************************************************************/
+#include <stdint.h>
+#include <stdbool.h>
+
+#include "Drivers/i2c.h"
+
+
+/***************************************************************************************
+** AREA DE PREPROCESADOR                                                              **
+****************************************************************************************/
+
+
+/***************************************************************************************
+** AREA DE DEFINICION DE TIPOS                                                        **
+****************************************************************************************/
+typedef enum {
+    FALLO_I2C_SITL_NINGUNO = 0,
+    FALLO_I2C_SITL_NACK,
+    FALLO_I2C_SITL_ARBITRAJE,
+    FALLO_I2C_SITL_COLGADA,                 // La transferencia no termina nunca
+    FALLO_I2C_SITL_SDA_BLOQUEADO,           // Error de bus y el esclavo retiene SDA
+} falloI2Csitl_e;
+
+
+/***************************************************************************************
+** AREA DE DECLARACION DE VARIABLES                                                   **
+****************************************************************************************/
+
+
+/***************************************************************************************
+** AREA DE PROTOTIPOS DE FUNCION                                                      **
+****************************************************************************************/
+void actualizarI2Csitl(uint64_t tiempoUs);
+void inyectarFalloI2Csitl(numI2C_e numI2C, falloI2Csitl_e fallo, uint8_t numVeces);
+
+#endif // __I2C_SITL_H
@@ -0,0 +1,117 @@
+/***************************************************************************************
+**  io.c - Sustituto de los GPIO para el SITL. Guarda el estado de cada pin en memoria
+**
+**
+**  Este fichero forma parte del proyecto URpilot.
+**  Codigo desarrollado por el grupo de investigacion ICON de la Universidad de La Rioja
+**
+**  Autor: Ramon Rico
+**  Fecha de creacion: 17/10/2026
+**  Fecha de modificacion: 17/10/2026
+**
+**  El proyecto URpilot NO es libre. No se puede distribuir y/o modificar este fichero
+**  bajo ningun concepto.
+**
+**  En caso de modificacion y/o solicitud de informacion pongase en contacto con
+**  el grupo de investigacion ICON a traves de: www.unirioja.es/urpilot
+**
+**
+**  Control de versiones del fichero
+**
+**  v1.0  Ramon Rico. Se ha liberado la primera version estable
+**
+****************************************************************************************/
+
+/***************************************************************************************
+** AREA DE INCLUDES                                                                   **
+****************************************************************************************/
+#include "Drivers/io.h"
+
+
+/***************************************************************************************
+** AREA DE PREPROCESADOR                                                              **
+****************************************************************************************/
+#define NUM_TAGS_IO_SITL            256
+
+
+/***************************************************************************************
+** AREA DE DEFINICION DE TIPOS                                                        **
+****************************************************************************************/
+
+
+/***************************************************************************************
+** AREA DE DECLARACION DE VARIABLES                                                   **
+****************************************************************************************/
+static bool estadoIO[NUM_TAGS_IO_SITL];
+
+
+/***************************************************************************************
+** AREA DE PROTOTIPOS DE FUNCION                                                      **
+****************************************************************************************/
+
+
+/***************************************************************************************
+** AREA DE DEFINICION DE FUNCIONES                                                    **
+****************************************************************************************/
+
+/***************************************************************************************
+**  Nombre:         void configurarIO(uint8_t tag, uint16_t cfg, uint8_t af)
+**  Descripcion:    Configura el pin dada una configuracion
+**  Parametros:     Tag del pin a configurar, configuracion, funcion especial
+**  Retorno:        Ninguno
+****************************************************************************************/
+void configurarIO(uint8_t tag, uint16_t cfg, uint8_t af)
+{
+    UNUSED(cfg);
+    UNUSED(af);
+
+    if (TAG_VACIO(tag))
+        return;
+
+    estadoIO[tag] = false;
+}
+
+
+/***************************************************************************************
+**  Nombre:         void escribirIO(uint8_t tag, bool estado)
+**  Descripcion:    Escribe en un pin
+**  Parametros:     Tag del pin, estado
+**  Retorno:        Ninguno
+****************************************************************************************/
+void escribirIO(uint8_t tag, bool estado)
+{
+    if (TAG_VACIO(tag))
+        return;
+
+    estadoIO[tag] = estado;
+}
+
+
+/***************************************************************************************
+**  Nombre:         bool leerIO(uint8_t tag)
+**  Descripcion:    Lee el estado de un pin
+**  Parametros:     Tag del pin
+**  Retorno:        Estado del pin
+****************************************************************************************/
+bool leerIO(uint8_t tag)
+{
+    if (TAG_VACIO(tag))
+        return false;
+
+    return estadoIO[tag];
+}
+
+
+/***************************************************************************************
+**  Nombre:         void invertirIO(uint8_t tag)
+**  Descripcion:    Invierte el estado de un pin
+**  Parametros:     Tag del pin
+**  Retorno:        Ninguno
+****************************************************************************************/
+void invertirIO(uint8_t tag)
+{
+    if (TAG_VACIO(tag))
+        return;
+
+    estadoIO[tag] = !estadoIO[tag];
+}
@@ -0,0 +1,360 @@
+/***************************************************************************************
+**  spi_sitl.c - Sustituto del hardware SPI para la cola de transacciones en el SITL.
+**               Cada bus tiene un mapa de registros y las transferencias terminan en
+**               el tiempo virtual
+**
+**
+**  Este fichero forma parte del proyecto URpilot.
+**  Codigo desarrollado por el grupo de investigacion ICON de la Universidad de La Rioja
+**
+**  Autor: Ramon Rico
+**  Fecha de creacion: 17/10/2026
+**  Fecha de modificacion: 17/10/2026
+**
+**  El proyecto URpilot NO es libre. No se puede distribuir y/o modificar este fichero
+**  bajo ningun concepto.
+**
+**  En caso de modificacion y/o solicitud de informacion pongase en contacto con
+**  el grupo de investigacion ICON a traves de: www.unirioja.es/urpilot
+**
+**
+**  Control de versiones del fichero
+**
+**  v1.0  Ramon Rico. Se ha liberado la primera version estable
+**
+****************************************************************************************/
+
+/***************************************************************************************
+** AREA DE INCLUDES                                                                   **
+****************************************************************************************/
+#include <stdio.h>
+#include <string.h>
+
+#include "spi_sitl.h"
+#include "Core/pruebas_sitl.h"
+#include "tiempo_sitl.h"
+#include "Drivers/bus.h"
+#include "Drivers/io.h"
+#include "Drivers/spi_cola.h"
+
+
+/***************************************************************************************
+** AREA DE PREPROCESADOR                                                              **
+****************************************************************************************/
+#define NUM_REGISTROS_SPI_SITL      128
+#define BIT_LECTURA_SPI_SITL        0x80
+#define BYTES_POR_US_SPI_SITL       1          // Aproximadamente 8 MHz de reloj
+#define SPI_PRUEBA_SITL             SPI_3
+#define NUM_TRANSACCIONES_PRUEBA    3
+#define REG_MIXTO_SPI_SITL          0x48       // Registro que escribe el acceso bloqueante
+#define LONGITUD_FIFO_MIXTO_SPI_SITL 32        // Lectura larga de la cola, como la de la FIFO de una IMU
+
+
+/***************************************************************************************
+** AREA DE DEFINICION DE TIPOS                                                        **
+****************************************************************************************/
+typedef struct {
+    bool activa;
+    bool colgada;
+    bool colgarSiguiente;
+    uint8_t *datoTx;
+    uint8_t *datoRx;
+    uint16_t longitud;
+    uint64_t tiempoFin;
+    uint8_t registros[NUM_REGISTROS_SPI_SITL];
+} spiSITL_t;
+
+
+/***************************************************************************************
+** AREA DE DECLARACION DE VARIABLES                                                   **
+****************************************************************************************/
+static spiSITL_t spiSITL[NUM_MAX_SPI];
+
+// Traza de la prueba de la cola
+static uint8_t ordenPrueba[NUM_TRANSACCIONES_PRUEBA + 1];
+static uint8_t numTerminadasPrueba;
+
+// Prueba del trafico mixto: la lectura de la FIFO encadena otra desde su callback
+static transaccionSPI_t transaccionDrdyMixto;
+static uint8_t bufferDrdyMixto[2];
+static uint8_t pinCSotroMixto;
+static bool csOtroBajadoMixto;
+
+
+/***************************************************************************************
+** AREA DE PROTOTIPOS DE FUNCION                                                      **
+****************************************************************************************/
+void callbackPruebaSPIsitl(transaccionSPI_t *transaccion);
+void esperarTransaccionesSPIsitl(transaccionSPI_t *transaccion, uint8_t numTransacciones);
+void callbackFifoMixtoSPIsitl(transaccionSPI_t *transaccion);
+void callbackDrdyMixtoSPIsitl(transaccionSPI_t *transaccion);
+
+
+/***************************************************************************************
+** AREA DE DEFINICION DE FUNCIONES                                                    **
+****************************************************************************************/
+
+/***************************************************************************************
+**  Nombre:         bool perifericoOcupadoSPI(numSPI_e numSPI)
+**  Descripcion:    Comprueba si el SPI simulado tiene una transferencia en marcha
+**  Parametros:     Dispositivo
+**  Retorno:        True si ocupado
+****************************************************************************************/
+bool perifericoOcupadoSPI(numSPI_e numSPI)
+{
+    return spiSITL[numSPI].activa;
+}
+
+
+/***************************************************************************************
+**  Nombre:         bool iniciarTransferenciaAsincronaSPI(numSPI_e numSPI, uint8_t *datoTx, uint8_t *datoRx, uint16_t longitud)
+**  Descripcion:    Lanza una transferencia que termina en actualizarSPIsitl
+**  Parametros:     Dispositivo, buffer a enviar, buffer a recibir, longitud de los buffer
+**  Retorno:        True si la transferencia ha empezado
+****************************************************************************************/
+bool iniciarTransferenciaAsincronaSPI(numSPI_e numSPI, uint8_t *datoTx, uint8_t *datoRx, uint16_t longitud)
+{
+    spiSITL_t *driver = &spiSITL[numSPI];
+
+    if (driver->activa)
+        return false;
+
+    driver->activa = true;
+    driver->colgada = driver->colgarSiguiente;
+    driver->colgarSiguiente = false;
+    driver->datoTx = datoTx;
+    driver->datoRx = datoRx;
+    driver->longitud = longitud;
+    driver->tiempoFin = tiempoSimuladoSITL() + 1 + longitud / BYTES_POR_US_SPI_SITL;
+    return true;
+}
+
+
+/***************************************************************************************
+**  Nombre:         void abortarTransferenciaAsincronaSPI(numSPI_e numSPI)
+**  Descripcion:    Aborta la transferencia en curso
+**  Parametros:     Dispositivo
+**  Retorno:        Ninguno
+****************************************************************************************/
+void abortarTransferenciaAsincronaSPI(numSPI_e numSPI)
+{
+    spiSITL[numSPI].activa = false;
+    spiSITL[numSPI].colgada = false;
+}
+
+
+/***************************************************************************************
+**  Nombre:         void actualizarSPIsitl(uint64_t tiempoUs)
+**  Descripcion:    Termina las transferencias cuyo tiempo ha pasado. El primer byte es el
+**                  registro y los demas se leen o escriben en posiciones consecutivas
+**  Parametros:     Tiempo de simulacion en us
+**  Retorno:        Ninguno
+****************************************************************************************/
+void actualizarSPIsitl(uint64_t tiempoUs)
+{
+    for (numSPI_e numSPI = 0; numSPI < NUM_MAX_SPI; numSPI++) {
+        spiSITL_t *driver = &spiSITL[numSPI];
+
+        if (!driver->activa || driver->colgada || tiempoUs < driver->tiempoFin) {
+            comprobarTimeoutColaSPI(numSPI, (uint32_t)tiempoUs);
+            continue;
+        }
+
+        const uint8_t reg = driver->datoTx[0] & ~BIT_LECTURA_SPI_SITL;
+        const bool lectura = driver->datoTx[0] & BIT_LECTURA_SPI_SITL;
+
+        for (uint16_t i = 1; i < driver->longitud; i++) {
+            uint8_t *registro = &driver->registros[(reg + i - 1) % NUM_REGISTROS_SPI_SITL];
+
+            if (lectura)
+                driver->datoRx[i] = *registro;
+            else
+                *registro = driver->datoTx[i];
+        }
+
+        driver->datoRx[0] = 0;
+        driver->activa = false;
+        finalizarTransferenciaColaSPI(numSPI, true);
+    }
+}
+
+
+/***************************************************************************************
+**  Nombre:         void colgarTransferenciaSPIsitl(numSPI_e numSPI)
+**  Descripcion:    La siguiente transferencia del bus no termina nunca
+**  Parametros:     Dispositivo
+**  Retorno:        Ninguno
+****************************************************************************************/
+void colgarTransferenciaSPIsitl(numSPI_e numSPI)
+{
+    spiSITL[numSPI].colgarSiguiente = true;
+}
+
+
+/***************************************************************************************
+**  Nombre:         void callbackPruebaSPIsitl(transaccionSPI_t *transaccion)
+**  Descripcion:    Apunta el orden de terminacion y comprueba que el CS ya esta subido
+**  Parametros:     Transaccion terminada
+**  Retorno:        Ninguno
+****************************************************************************************/
+void callbackPruebaSPIsitl(transaccionSPI_t *transaccion)
+{
+    uint8_t id = (uint8_t)(uintptr_t)transaccion->paramUsuario;
+
+    if (!leerIO(transaccion->pinCS))
+        id |= 0x80;
+
+    if (numTerminadasPrueba < sizeof(ordenPrueba))
+        ordenPrueba[numTerminadasPrueba++] = id;
+}
+
+
+/***************************************************************************************
+**  Nombre:         void esperarTransaccionesSPIsitl(transaccionSPI_t *transaccion, uint8_t numTransacciones)
+**  Descripcion:    Avanza el tiempo virtual hasta que terminan las transacciones
+**  Parametros:     Transacciones, numero de transacciones
+**  Retorno:        Ninguno
+****************************************************************************************/
+void esperarTransaccionesSPIsitl(transaccionSPI_t *transaccion, uint8_t numTransacciones)
+{
+    for (uint32_t i = 0; i < 10 * TIMEOUT_DEFECTO_TRANSACCION_SPI; i++) {
+        if (cadenaTransaccionesSPIterminada(transaccion, numTransacciones))
+            return;
+
+        avanzarTiempoSITL(1);
+    }
+}
+
+
+/***************************************************************************************
+**  Nombre:         void probarColaSPIsitl(void)
+**  Descripcion:    Ejercita la cola sobre un bus libre: una cadena de escritura y lecturas
+**                  con dos dispositivos, y una transferencia colgada que debe terminar por
+**                  timeout sin bloquear a la siguiente
+**  Parametros:     Ninguno
+**  Retorno:        Ninguno
+****************************************************************************************/
+void probarColaSPIsitl(void)
+{
+    const bus_t busA = { .tipo = BUS_SPI, .bus_u.spi = { SPI_PRUEBA_SITL, DEFIO_TAG(PE4) } };
+    const bus_t busB = { .tipo = BUS_SPI, .bus_u.spi = { SPI_PRUEBA_SITL, DEFIO_TAG(PE5) } };
+    transaccionSPI_t transaccion[NUM_TRANSACCIONES_PRUEBA + 1];
+    uint8_t bufferEscritura[4] = { 0, 0x11, 0x22, 0x33 };
+    uint8_t bufferLectura[4];
+    uint8_t bufferLecturaB[2];
+    estadisticasColaSPI_t estadisticas;
+
+    memset(transaccion, 0, sizeof(transaccion));
+    numTerminadasPrueba = 0;
+    iniciarColaSPI(SPI_PRUEBA_SITL);
+    escribirIO(busA.bus_u.spi.pinCS, true);
+    escribirIO(busB.bus_u.spi.pinCS, true);
+
+    // Cadena: escritura en A, lectura de lo escrito en A y lectura en B
+    prepararEscrituraRegistroBus(&busA, &transaccion[0], 0x10, bufferEscritura, 3, callbackPruebaSPIsitl, (void *)1);
+    prepararLecturaRegistroBus(&busA, &transaccion[1], 0x10 | BIT_LECTURA_SPI_SITL, bufferLectura, 3, callbackPruebaSPIsitl, (void *)2);
+    prepararLecturaRegistroBus(&busB, &transaccion[2], 0x7F | BIT_LECTURA_SPI_SITL, bufferLecturaB, 1, callbackPruebaSPIsitl, (void *)3);
+    encolarCadenaTransaccionesSPI(transaccion, NUM_TRANSACCIONES_PRUEBA);
+
+    const bool csBajadoA = !leerIO(busA.bus_u.spi.pinCS) && leerIO(busB.bus_u.spi.pinCS);
+    esperarTransaccionesSPIsitl(transaccion, NUM_TRANSACCIONES_PRUEBA);
+
+    const bool datosOk = memcmp(&bufferLectura[1], &bufferEscritura[1], 3) == 0;
+
+    printf("\nCola SPI (SITL)\n");
+    printf("  Orden de terminacion: %u %u %u | CS %s | datos %s\n", ordenPrueba[0] & 0x7F, ordenPrueba[1] & 0x7F, ordenPrueba[2] & 0x7F,
+           csBajadoA && !((ordenPrueba[0] | ordenPrueba[1] | ordenPrueba[2]) & 0x80) ? "ok" : "mal", datosOk ? "ok" : "mal");
+
+    // Transferencia colgada seguida de otra
+    colgarTransferenciaSPIsitl(SPI_PRUEBA_SITL);
+    leerBufferRegistroAsincronoBus(&busA, &transaccion[0], 0x10 | BIT_LECTURA_SPI_SITL, bufferLectura, 3, NULL, NULL);
+    leerBufferRegistroAsincronoBus(&busB, &transaccion[NUM_TRANSACCIONES_PRUEBA], 0x7F | BIT_LECTURA_SPI_SITL, bufferLecturaB, 1, NULL, NULL);
+    esperarTransaccionesSPIsitl(&transaccion[NUM_TRANSACCIONES_PRUEBA], 1);
+
+    estadisticasColaSPI(SPI_PRUEBA_SITL, &estadisticas);
+    printf("  Transferencia colgada: %s, siguiente %s | transacciones %u, timeouts %u, errores %u, cola max %u\n",
+           transaccion[0].estado == TRANSACCION_SPI_TIMEOUT ? "timeout" : "sin timeout",
+           transaccion[NUM_TRANSACCIONES_PRUEBA].estado == TRANSACCION_SPI_COMPLETADA ? "completada" : "sin completar",
+           estadisticas.numTransacciones, estadisticas.numTimeouts, estadisticas.numErrores, estadisticas.longitudMaxCola);
+}
+
+
+/***************************************************************************************
+**  Nombre:         void callbackFifoMixtoSPIsitl(transaccionSPI_t *transaccion)
+**  Descripcion:    Fin de la lectura de la FIFO. Encola otra lectura como haria el DRDY
+**                  desde su interrupcion
+**  Parametros:     Transaccion
+**  Retorno:        Ninguno
+****************************************************************************************/
+void callbackFifoMixtoSPIsitl(transaccionSPI_t *transaccion)
+{
+    const bus_t *bus = transaccion->paramUsuario;
+
+    csOtroBajadoMixto |= !leerIO(pinCSotroMixto);
+    memset(&transaccionDrdyMixto, 0, sizeof(transaccionDrdyMixto));
+    leerBufferRegistroAsincronoBus(bus, &transaccionDrdyMixto, REG_MIXTO_SPI_SITL | BIT_LECTURA_SPI_SITL, bufferDrdyMixto, 1,
+                                   callbackDrdyMixtoSPIsitl, NULL);
+}
+
+
+/***************************************************************************************
+**  Nombre:         void callbackDrdyMixtoSPIsitl(transaccionSPI_t *transaccion)
+**  Descripcion:    Fin de la lectura encolada desde el callback
+**  Parametros:     Transaccion
+**  Retorno:        Ninguno
+****************************************************************************************/
+void callbackDrdyMixtoSPIsitl(transaccionSPI_t *transaccion)
+{
+    UNUSED(transaccion);
+    csOtroBajadoMixto |= !leerIO(pinCSotroMixto);
+}
+
+
+/***************************************************************************************
+**  Nombre:         void probarTraficoMixtoSPIsitl(void)
+**  Descripcion:    Mezcla en un bus lecturas de la cola con accesos bloqueantes de otro
+**                  dispositivo, como la FIFO de la IMU y el barometro del mismo SPI. El
+**                  acceso bloqueante espera su turno en la cola en vez de perderse y nunca
+**                  coincide con el CS del otro dispositivo
+**  Parametros:     Ninguno
+**  Retorno:        Ninguno
+****************************************************************************************/
+void probarTraficoMixtoSPIsitl(void)
+{
+    static const bus_t busFifo = { .tipo = BUS_SPI, .bus_u.spi = { SPI_PRUEBA_SITL, DEFIO_TAG(PE4) } };
+    const bus_t busBaro = { .tipo = BUS_SPI, .bus_u.spi = { SPI_PRUEBA_SITL, DEFIO_TAG(PE5) } };
+    uint8_t bufferFifo[LONGITUD_FIFO_MIXTO_SPI_SITL + 1];
+    transaccionSPI_t transaccionFifo;
+    uint8_t valorInicial = 0, valorFinal = 0;
+
+    iniciarColaSPI(SPI_PRUEBA_SITL);
+    escribirIO(busFifo.bus_u.spi.pinCS, true);
+    escribirIO(busBaro.bus_u.spi.pinCS, true);
+    pinCSotroMixto = busBaro.bus_u.spi.pinCS;
+    csOtroBajadoMixto = false;
+
+    const bool inicioOk = escribirRegistroBus(&busBaro, REG_MIXTO_SPI_SITL, 0x11);
+
+    // Lectura de la FIFO en curso y el barometro manda su comando con la cola ocupada
+    memset(&transaccionFifo, 0, sizeof(transaccionFifo));
+    leerBufferRegistroAsincronoBus(&busFifo, &transaccionFifo, REG_MIXTO_SPI_SITL | BIT_LECTURA_SPI_SITL, bufferFifo,
+                                   LONGITUD_FIFO_MIXTO_SPI_SITL, callbackFifoMixtoSPIsitl, (void *)&busFifo);
+    const bool colaOcupada = colaSPIocupada(SPI_PRUEBA_SITL);
+    const bool comandoOk = escribirRegistroBus(&busBaro, REG_MIXTO_SPI_SITL, 0x5A);
+
+    esperarTransaccionesSPIsitl(&transaccionDrdyMixto, 1);
+    const bool csLibres = leerIO(busFifo.bus_u.spi.pinCS) && leerIO(busBaro.bus_u.spi.pinCS);
+    leerRegistroBus(&busBaro, REG_MIXTO_SPI_SITL | BIT_LECTURA_SPI_SITL, &valorFinal);
+    valorInicial = bufferFifo[1];
+
+    // La FIFO lee el valor anterior, el comando entra despues y la lectura del DRDY va detras
+    const bool ordenOk = valorInicial == 0x11 && bufferDrdyMixto[1] == 0x5A && valorFinal == 0x5A;
+    const bool ok = inicioOk && colaOcupada && comandoOk && csLibres && !csOtroBajadoMixto && ordenOk &&
+                    transaccionFifo.estado == TRANSACCION_SPI_COMPLETADA && transaccionDrdyMixto.estado == TRANSACCION_SPI_COMPLETADA;
+
+    printf("\nTrafico mixto en un bus SPI (SITL)\n");
+    printf("  Comando bloqueante con la cola ocupada: %s | FIFO 0x%02X, DRDY 0x%02X, registro 0x%02X | CS %s\n",
+           comandoOk ? "aceptado" : "perdido", valorInicial, bufferDrdyMixto[1], valorFinal,
+           (csLibres && !csOtroBajadoMixto) ? "ok" : "mal");
+    printf("  Resultado: %s\n", ok ? "ok" : "fallo");
+}
@@ -0,0 +1,204 @@
+/***************************************************************************************
+**  tiempo.c - Funciones de tiempo del SITL. El tiempo no depende del reloj del host,
+**             avanza solo cuando lo hace la simulacion para que sea determinista
+**
+**
+**  Este fichero forma parte del proyecto URpilot.
+**  Codigo desarrollado por el grupo de investigacion ICON de la Universidad de La Rioja
+**
+**  Autor: Ramon Rico
+**  Fecha de creacion: 17/10/2026
+**  Fecha de modificacion: 17/10/2026
+**
+**  El proyecto URpilot NO es libre. No se puede distribuir y/o modificar este fichero
+**  bajo ningun concepto.
+**
+**  En caso de modificacion y/o solicitud de informacion pongase en contacto con
+**  el grupo de investigacion ICON a traves de: www.unirioja.es/urpilot
+**
+**
+**  Control de versiones del fichero
+**
+**  v1.0  Ramon Rico. Se ha liberado la primera version estable
+**
+****************************************************************************************/
+
+/***************************************************************************************
+** AREA DE INCLUDES                                                                   **
+****************************************************************************************/
+#include "Drivers/tiempo.h"
+#include "tiempo_sitl.h"
+
+
+/***************************************************************************************
+** AREA DE PREPROCESADOR                                                              **
+****************************************************************************************/
+
+
+/***************************************************************************************
+** AREA DE DEFINICION DE TIPOS                                                        **
+****************************************************************************************/
+
+
+/***************************************************************************************
+** AREA DE DECLARACION DE VARIABLES                                                   **
+****************************************************************************************/
+volatile uint32_t tiempoSysTick = 0;               // Variable que se incrementa cada ms en la interrupcion del systick timer
+volatile uint32_t ciclosSysTick = 0;               // Valor del systick en la interrupcion
+volatile int32_t sysTickPendiente = 0;
+
+static uint64_t tiempoSimulado = 0;                // Tiempo simulado en us
+static pasoSimulacionCallback callbackPaso = NULL;
+static bool dentroCallback = false;
+
+
+/***************************************************************************************
+** AREA DE PROTOTIPOS DE FUNCION                                                      **
+****************************************************************************************/
+
+
+/***************************************************************************************
+** AREA DE DEFINICION DE FUNCIONES                                                    **
+****************************************************************************************/
+
+/***************************************************************************************
+**  Nombre:         void ajustarCallbackTiempoSITL(pasoSimulacionCallback callback)
+**  Descripcion:    Asigna la funcion que avanza el modelo fisico con el reloj
+**  Parametros:     Callback
+**  Retorno:        Ninguno
+****************************************************************************************/
+void ajustarCallbackTiempoSITL(pasoSimulacionCallback callback)
+{
+    callbackPaso = callback;
+}
+
+
+/***************************************************************************************
+**  Nombre:         void avanzarTiempoSITL(uint32_t us)
+**  Descripcion:    Avanza el reloj simulado y el modelo fisico
+**  Parametros:     Microsegundos a avanzar
+**  Retorno:        Ninguno
+****************************************************************************************/
+void avanzarTiempoSITL(uint32_t us)
+{
+    tiempoSimulado += us;
+    tiempoSysTick = (uint32_t)(tiempoSimulado / 1000);
+
+    // Evita la recursion si el modelo llama a alguna funcion de retardo
+    if (callbackPaso != NULL && !dentroCallback) {
+        dentroCallback = true;
+        callbackPaso(tiempoSimulado);
+        dentroCallback = false;
+    }
+}
+
+
+/***************************************************************************************
+**  Nombre:         uint64_t tiempoSimuladoSITL(void)
+**  Descripcion:    Retorna el tiempo simulado
+**  Parametros:     Ninguno
+**  Retorno:        Tiempo en us
+****************************************************************************************/
+uint64_t tiempoSimuladoSITL(void)
+{
+    return tiempoSimulado;
+}
+
+
+/***************************************************************************************
+**  Nombre:         void iniciarContadorCiclos(void)
+**  Descripcion:    Reinicia el reloj simulado. El contador de ciclos usa el reloj del host
+**  Parametros:     Ninguno
+**  Retorno:        Ninguno
+****************************************************************************************/
+void iniciarContadorCiclos(void)
+{
+    tiempoSimulado = 0;
+    tiempoSysTick = 0;
+}
+
+
+/***************************************************************************************
+**  Nombre:         uint32_t microsISR(void)
+**  Descripcion:    Retorna los microsegundos cuando se esta ejecutando una interrupcion
+**  Parametros:     Ninguno
+**  Retorno:        Microsegundos transcurridos
+****************************************************************************************/
+uint32_t microsISR(void)
+{
+    return (uint32_t)tiempoSimulado;
+}
+
+
+/***************************************************************************************
+**  Nombre:         uint32_t micros(void)
+**  Descripcion:    Retorna los microsegundos (maximo 70 minutos)
+**  Parametros:     Ninguno
+**  Retorno:        Microsegundos transcurridos
+****************************************************************************************/
+uint32_t micros(void)
+{
+    return (uint32_t)tiempoSimulado;
+}
+
+
+/***************************************************************************************
+**  Nombre:         uint32_t millis(void)
+**  Descripcion:    Retorna los milisegundos  (maximo 49 dias)
+**  Parametros:     Ninguno
+**  Retorno:        Milisegundos transcurridos
+****************************************************************************************/
+uint32_t millis(void)
+{
+    return tiempoSysTick;
+}
+
+
+/***************************************************************************************
+**  Nombre:         void delayMicroseconds(uint32_t us)
+**  Descripcion:    Retardo en microsegundos. Avanza la simulacion
+**  Parametros:     Microsegundos que se quieren retardar
+**  Retorno:        Ninguno
+****************************************************************************************/
+void delayMicroseconds(uint32_t us)
+{
+    avanzarTiempoSITL(us);
+}
+
+
+/***************************************************************************************
+**  Nombre:         void delay(uint32_t ms)
+**  Descripcion:    Retardo en milisegundos. Avanza la simulacion
+**  Parametros:     Milisegundos que se quiere retardar
+**  Retorno:        Ninguno
+****************************************************************************************/
+void delay(uint32_t ms)
+{
+    while (ms--)
+        delayMicroseconds(1000);
+}
+
+
+/***************************************************************************************
+**  Nombre:         uint32_t ciclosCPU(void)
+**  Descripcion:    Sustituto del contador de ciclos del DWT. Cuenta nanosegundos reales
+**                  del host, no tiempo simulado
+**  Parametros:     Ninguno
+**  Retorno:        Nanosegundos del host
+****************************************************************************************/
+uint32_t ciclosCPU(void)
+{
+    return (uint32_t)nanosegundosHostSITL();
+}
+
+
+/***************************************************************************************
+**  Nombre:         uint32_t ciclosPorMicro(void)
+**  Descripcion:    Retorna los ciclos de ciclosCPU() por microsegundo
+**  Parametros:     Ninguno
+**  Retorno:        Ciclos por microsegundo
+****************************************************************************************/
+uint32_t ciclosPorMicro(void)
+{
+    return 1000;
+}
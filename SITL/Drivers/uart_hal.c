@@ -0,0 +1,353 @@
+/***************************************************************************************
+**  uart_hal.c - Funciones de bajo nivel de la UART para el SITL. Los bytes recibidos
+**               los inyecta el modelo y los transmitidos se descartan
+**
+**
+**  Este fichero forma parte del proyecto URpilot.
+**  Codigo desarrollado por el grupo de investigacion ICON de la Universidad de La Rioja
+**
+**  Autor: Ramon Rico
+**  Fecha de creacion: 17/10/2026
+**  Fecha de modificacion: 17/10/2026
+**
+**  El proyecto URpilot NO es libre. No se puede distribuir y/o modificar este fichero
+**  bajo ningun concepto.
+**
+**  En caso de modificacion y/o solicitud de informacion pongase en contacto con
+**  el grupo de investigacion ICON a traves de: www.unirioja.es/urpilot
+**
+**
+**  Control de versiones del fichero
+**
+**  v1.0  Ramon Rico. Se ha liberado la primera version estable
+**
+****************************************************************************************/
+
+/***************************************************************************************
+** AREA DE INCLUDES                                                                   **
+****************************************************************************************/
+#include "Drivers/uart.h"
+
+#ifdef USAR_UART
+#include "uart_sitl.h"
+
+
+/***************************************************************************************
+** AREA DE PREPROCESADOR                                                              **
+****************************************************************************************/
+
+
+/***************************************************************************************
+** AREA DE DEFINICION DE TIPOS                                                        **
+****************************************************************************************/
+
+
+/***************************************************************************************
+** AREA DE DECLARACION DE VARIABLES                                                   **
+****************************************************************************************/
+static uint32_t bytesTransmitidos[NUM_MAX_UART];
+static uint16_t posicionRxDMA[NUM_MAX_UART];                // Posicion de escritura del DMA simulado
+static uint16_t longitudTxSITL[NUM_MAX_UART];               // Transferencia de envio en curso
+static uint32_t numTransferenciasTx[NUM_MAX_UART];
+static bool txRetenida[NUM_MAX_UART];
+
+
+/***************************************************************************************
+** AREA DE PROTOTIPOS DE FUNCION                                                      **
+****************************************************************************************/
+bool callbacksRxUART(uart_t *driver);
+
+
+/***************************************************************************************
+** AREA DE DEFINICION DE FUNCIONES                                                    **
+****************************************************************************************/
+
+/***************************************************************************************
+**  Nombre:         bool iniciarDriverUART(numUART_e numUART, configIniUART_t configInicial)
+**  Descripcion:    Inicia el dispositivo UART
+**  Parametros:     Dispositivo a iniciar, configuracion de la UART
+**  Retorno:        True si ok
+****************************************************************************************/
+bool iniciarDriverUART(numUART_e numUART, configIniUART_t configInicial)
+{
+    uart_t *driver = punteroUART(numUART);
+
+    driver->hal.asignado = true;
+    driver->hal.huart.Init.BaudRate = configInicial.baudrate;
+    longitudTxSITL[numUART] = 0;
+    return true;
+}
+
+
+/***************************************************************************************
+**  Nombre:         void flushUART(numUART_e numUART)
+**  Descripcion:    Borra el Buffer de recepcion de la UART
+**  Parametros:     Dispositivo
+**  Retorno:        Ninguno
+****************************************************************************************/
+void flushUART(numUART_e numUART)
+{
+    uart_t *driver = punteroUART(numUART);
+
+    if (driver->rxDMA) {
+        driver->cabezaRxBuffer = posicionRxDMA[numUART];
+        driver->colaRxBuffer = driver->cabezaRxBuffer;
+        return;
+    }
+
+    driver->colaRxBuffer = 0;
+    driver->cabezaRxBuffer = 0;
+
+    for (uint16_t i = 0; i < TAMANIO_BUFFER_RX_UART; i++)
+    	driver->rxBuffer[i] = 0;
+}
+
+
+/***************************************************************************************
+**  Nombre:         void iniciarTxUART(numUART_e numUART)
+**  Descripcion:    Simula el DMA de envio: cada bloque contiguo es una transferencia. Si el
+**                  envio no esta retenido las transferencias terminan en el momento
+**  Parametros:     Dispositivo
+**  Retorno:        Ninguno
+****************************************************************************************/
+void iniciarTxUART(numUART_e numUART)
+{
+    while (longitudTxSITL[numUART] == 0) {
+        uint8_t *datos;
+        const uint16_t longitud = bloqueTxUART(numUART, &datos);
+
+        if (longitud == 0)
+            return;
+
+        longitudTxSITL[numUART] = longitud;
+        numTransferenciasTx[numUART]++;
+
+        if (txRetenida[numUART])
+            return;
+
+        bytesTransmitidos[numUART] += longitud;
+        liberarTxUART(numUART, longitud);
+        longitudTxSITL[numUART] = 0;
+    }
+}
+
+
+/***************************************************************************************
+**  Nombre:         int16_t leerUART(numUART_e numUART)
+**  Descripcion:    Lee un dato de la UART
+**  Parametros:     Dispositivo
+**  Retorno:        Dato leido
+****************************************************************************************/
+int16_t leerUART(numUART_e numUART)
+{
+    int16_t byteRx;
+    uart_t *driver = punteroUART(numUART);
+
+    if (driver->rxDMA && driver->cabezaRxBuffer == driver->colaRxBuffer)
+        driver->cabezaRxBuffer = posicionRxDMA[numUART];
+
+    if (driver->cabezaRxBuffer != driver->colaRxBuffer) {
+        byteRx = driver->rxBuffer[driver->colaRxBuffer];
+
+        if (driver->colaRxBuffer + 1 >= TAMANIO_BUFFER_RX_UART)
+        	driver->colaRxBuffer = 0;
+        else
+        	driver->colaRxBuffer++;
+
+        return byteRx;
+    }
+    else
+      return -1;
+}
+
+
+/***************************************************************************************
+**  Nombre:         void leerBufferUART(numUART_e numUART, int16_t *datoRx, uint16_t longitud)
+**  Descripcion:    Lee un buffer de la UART
+**  Parametros:     Dispositivo, buffer, longitud del buffer
+**  Retorno:        Ninguno
+****************************************************************************************/
+void leerBufferUART(numUART_e numUART, int16_t *datoRx, uint16_t longitud)
+{
+    for (uint16_t i = 0; i < longitud; i++)
+        datoRx[i] = leerUART(numUART);
+}
+
+
+/***************************************************************************************
+**  Nombre:         uint16_t bytesRecibidosUART(numUART_e numUART)
+**  Descripcion:    Devuelve el numero de bytes recibidos por la UART
+**  Parametros:     Dispositivo
+**  Retorno:        Numero de bytes
+****************************************************************************************/
+uint16_t bytesRecibidosUART(numUART_e numUART)
+{
+    uart_t *driver = punteroUART(numUART);
+
+    if (driver->rxDMA)
+        driver->cabezaRxBuffer = posicionRxDMA[numUART];
+
+    if (driver->cabezaRxBuffer >= driver->colaRxBuffer)
+        return driver->cabezaRxBuffer - driver->colaRxBuffer;
+    else
+        return TAMANIO_BUFFER_RX_UART + driver->cabezaRxBuffer - driver->colaRxBuffer;
+}
+
+
+/***************************************************************************************
+**  Nombre:         void recibirByteUART(numUART_e numUART, uint8_t rxByte)
+**  Descripcion:    Simula la recepcion de un byte. Con DMA el byte se escribe en el buffer
+**                  circular y se simulan las interrupciones de mitad y final del buffer
+**  Parametros:     Dispositivo, byte recibido
+**  Retorno:        Ninguno
+****************************************************************************************/
+void recibirByteUART(numUART_e numUART, uint8_t rxByte)
+{
+    uart_t *driver = punteroUART(numUART);
+
+    if (!driver->iniciado)
+        return;
+
+    if (driver->rxDMA) {
+        driver->rxBuffer[posicionRxDMA[numUART]] = rxByte;
+        posicionRxDMA[numUART] = (posicionRxDMA[numUART] + 1) % TAMANIO_BUFFER_RX_UART;
+
+        if (callbacksRxUART(driver) && (posicionRxDMA[numUART] == 0 || posicionRxDMA[numUART] == TAMANIO_BUFFER_RX_UART / 2))
+            procesarRxUART(numUART, posicionRxDMA[numUART]);
+    }
+    else if (driver->rxBloqueCallback)
+        driver->rxBloqueCallback(&rxByte, 1);
+    else if (driver->rxCallback)
+        driver->rxCallback(rxByte);
+    else {
+        driver->rxBuffer[driver->cabezaRxBuffer] = rxByte;
+        driver->cabezaRxBuffer = (driver->cabezaRxBuffer + 1) % TAMANIO_BUFFER_RX_UART;
+    }
+}
+
+
+/***************************************************************************************
+**  Nombre:         void recibirBufferUART(numUART_e numUART, const uint8_t *datoRx, uint16_t longitud)
+**  Descripcion:    Simula la recepcion de un buffer
+**  Parametros:     Dispositivo, buffer, longitud del buffer
+**  Retorno:        Ninguno
+****************************************************************************************/
+void recibirBufferUART(numUART_e numUART, const uint8_t *datoRx, uint16_t longitud)
+{
+    for (uint16_t i = 0; i < longitud; i++)
+        recibirByteUART(numUART, datoRx[i]);
+}
+
+
+/***************************************************************************************
+**  Nombre:         void lineaReposoUART(numUART_e numUART)
+**  Descripcion:    Simula la interrupcion de linea en reposo al final de una trama
+**  Parametros:     Dispositivo
+**  Retorno:        Ninguno
+****************************************************************************************/
+void lineaReposoUART(numUART_e numUART)
+{
+    uart_t *driver = punteroUART(numUART);
+
+    if (driver->iniciado && driver->rxDMA && callbacksRxUART(driver))
+        procesarRxUART(numUART, posicionRxDMA[numUART]);
+}
+
+
+/***************************************************************************************
+**  Nombre:         void configurarRxDMAuartSITL(numUART_e numUART, bool dma)
+**  Descripcion:    Selecciona la recepcion por DMA circular simulado o por interrupcion
+**  Parametros:     Dispositivo, usar DMA
+**  Retorno:        Ninguno
+****************************************************************************************/
+void configurarRxDMAuartSITL(numUART_e numUART, bool dma)
+{
+    uart_t *driver = punteroUART(numUART);
+
+    driver->rxDMA = dma;
+    driver->cabezaRxBuffer = 0;
+    driver->colaRxBuffer = 0;
+    posicionRxDMA[numUART] = 0;
+}
+
+
+/***************************************************************************************
+**  Nombre:         void retenerTxUARTsitl(numUART_e numUART, bool retener)
+**  Descripcion:    Retiene las transferencias de envio hasta llamar a completarTxUARTsitl
+**  Parametros:     Dispositivo, retener
+**  Retorno:        Ninguno
+****************************************************************************************/
+void retenerTxUARTsitl(numUART_e numUART, bool retener)
+{
+    txRetenida[numUART] = retener;
+    numTransferenciasTx[numUART] = 0;
+}
+
+
+/***************************************************************************************
+**  Nombre:         uint16_t transferenciaTxUARTsitl(numUART_e numUART, const uint8_t **datos)
+**  Descripcion:    Devuelve la transferencia de envio en curso
+**  Parametros:     Dispositivo, puntero a los datos
+**  Retorno:        Bytes de la transferencia (0 si no hay)
+****************************************************************************************/
+uint16_t transferenciaTxUARTsitl(numUART_e numUART, const uint8_t **datos)
+{
+    *datos = &punteroUART(numUART)->txBuffer[punteroUART(numUART)->colaTxBuffer];
+    return longitudTxSITL[numUART];
+}
+
+
+/***************************************************************************************
+**  Nombre:         void completarTxUARTsitl(numUART_e numUART)
+**  Descripcion:    Termina la transferencia de envio en curso y arranca la siguiente
+**  Parametros:     Dispositivo
+**  Retorno:        Ninguno
+****************************************************************************************/
+void completarTxUARTsitl(numUART_e numUART)
+{
+    if (longitudTxSITL[numUART] == 0)
+        return;
+
+    bytesTransmitidos[numUART] += longitudTxSITL[numUART];
+    liberarTxUART(numUART, longitudTxSITL[numUART]);
+    longitudTxSITL[numUART] = 0;
+    iniciarTxUART(numUART);
+}
+
+
+/***************************************************************************************
+**  Nombre:         uint32_t transferenciasTxUARTsitl(numUART_e numUART)
+**  Descripcion:    Retorna el numero de transferencias de envio desde que se retuvo el envio
+**  Parametros:     Dispositivo
+**  Retorno:        Numero de transferencias
+****************************************************************************************/
+uint32_t transferenciasTxUARTsitl(numUART_e numUART)
+{
+    return numTransferenciasTx[numUART];
+}
+
+
+/***************************************************************************************
+**  Nombre:         bool callbacksRxUART(uart_t *driver)
+**  Descripcion:    Comprueba si la UART entrega los datos por callback
+**  Parametros:     Driver
+**  Retorno:        True si hay algun callback de recepcion
+****************************************************************************************/
+bool callbacksRxUART(uart_t *driver)
+{
+    return driver->rxCallback != NULL || driver->rxBloqueCallback != NULL;
+}
+
+
+/***************************************************************************************
+**  Nombre:         uint32_t bytesTransmitidosUART(numUART_e numUART)
+**  Descripcion:    Retorna el numero de bytes que el firmware ha transmitido
+**  Parametros:     Dispositivo
+**  Retorno:        Numero de bytes
+****************************************************************************************/
+uint32_t bytesTransmitidosUART(numUART_e numUART)
+{
+    return bytesTransmitidos[numUART];
+}
+
+#endif
@@ -0,0 +1,364 @@
+/***************************************************************************************
+**  uart_sitl.c - Prueba de la recepcion y el envio por DMA de la UART en el SITL
+**
+**
+**  Este fichero forma parte del proyecto URpilot.
+**  Codigo desarrollado por el grupo de investigacion ICON de la Universidad de La Rioja
+**
+**  Autor: Ramon Rico
+**  Fecha de creacion: 17/10/2026
+**  Fecha de modificacion: 17/10/2026
+**
+**  El proyecto URpilot NO es libre. No se puede distribuir y/o modificar este fichero
+**  bajo ningun concepto.
+**
+**  En caso de modificacion y/o solicitud de informacion pongase en contacto con
+**  el grupo de investigacion ICON a traves de: www.unirioja.es/urpilot
+**
+**
+**  Control de versiones del fichero
+**
+**  v1.0  Ramon Rico. Se ha liberado la primera version estable
+**
+****************************************************************************************/
+
+/***************************************************************************************
+** AREA DE INCLUDES                                                                   **
+****************************************************************************************/
+#include <stdio.h>
+#include <string.h>
+
+#include "uart_sitl.h"
+#include "Core/pruebas_sitl.h"
+
+#ifdef USAR_UART
+#include "Comun/matematicas.h"
+
+
+/***************************************************************************************
+** AREA DE PREPROCESADOR                                                              **
+****************************************************************************************/
+#define UART_PRUEBA_SITL                UART_4
+#define NUM_TRAMAS_PRUEBA_UART          200
+#define TAM_MAX_TRAMA_PRUEBA_UART       300        // Mayor que medio buffer para que salten mitad y final
+#define TAM_FLUJO_PRUEBA_UART           (NUM_TRAMAS_PRUEBA_UART * TAM_MAX_TRAMA_PRUEBA_UART)
+#define TAM_MAX_MENSAJE_PRUEBA_UART     120
+
+
+/***************************************************************************************
+** AREA DE DEFINICION DE TIPOS                                                        **
+****************************************************************************************/
+
+
+/***************************************************************************************
+** AREA DE DECLARACION DE VARIABLES                                                   **
+****************************************************************************************/
+static uint8_t flujoRecibido[TAM_FLUJO_PRUEBA_UART];
+static uint32_t bytesRecibidosPrueba;
+static uint16_t numBloquesPrueba;
+static uint16_t numBloquesPartidosPrueba;
+static uint32_t semillaPrueba;
+static uint16_t transferenciaMaxPrueba;
+
+
+/***************************************************************************************
+** AREA DE PROTOTIPOS DE FUNCION                                                      **
+****************************************************************************************/
+void callbackBloquePruebaUART(const uint8_t *datos, uint16_t longitud);
+void callbackBytePruebaUART(uint8_t dato);
+uint8_t byteFlujoPruebaUART(uint32_t indice);
+uint32_t enviarTramasPruebaUART(uint16_t numTramas, uint16_t longitudFija, bool leer);
+bool comprobarFlujoPruebaUART(uint32_t bytesEnviados);
+void reiniciarPruebaUART(void);
+uint32_t aleatorioPruebaUART(void);
+uint16_t escribirMensajePruebaUART(uint32_t inicioFlujo, uint16_t longitud, bool reservar);
+void completarTransferenciaPruebaUART(void);
+
+
+/***************************************************************************************
+** AREA DE DEFINICION DE FUNCIONES                                                    **
+****************************************************************************************/
+
+/***************************************************************************************
+**  Nombre:         void callbackBloquePruebaUART(const uint8_t *datos, uint16_t longitud)
+**  Descripcion:    Guarda un bloque recibido y cuenta los que terminan en el final del buffer
+**  Parametros:     Datos, longitud
+**  Retorno:        Ninguno
+****************************************************************************************/
+void callbackBloquePruebaUART(const uint8_t *datos, uint16_t longitud)
+{
+    const uint8_t *finBuffer = (const uint8_t *)&punteroUART(UART_PRUEBA_SITL)->rxBuffer[TAMANIO_BUFFER_RX_UART];
+
+    numBloquesPrueba++;
+    if (datos + longitud == finBuffer)
+        numBloquesPartidosPrueba++;
+
+    if (bytesRecibidosPrueba + longitud <= TAM_FLUJO_PRUEBA_UART)
+        memcpy(&flujoRecibido[bytesRecibidosPrueba], datos, longitud);
+
+    bytesRecibidosPrueba += longitud;
+}
+
+
+/***************************************************************************************
+**  Nombre:         void callbackBytePruebaUART(uint8_t dato)
+**  Descripcion:    Guarda un byte recibido
+**  Parametros:     Dato
+**  Retorno:        Ninguno
+****************************************************************************************/
+void callbackBytePruebaUART(uint8_t dato)
+{
+    callbackBloquePruebaUART(&dato, 1);
+}
+
+
+/***************************************************************************************
+**  Nombre:         uint8_t byteFlujoPruebaUART(uint32_t indice)
+**  Descripcion:    Genera el byte del flujo de prueba. No se repite con el tamanio del buffer
+**  Parametros:     Posicion en el flujo
+**  Retorno:        Byte
+****************************************************************************************/
+uint8_t byteFlujoPruebaUART(uint32_t indice)
+{
+    return (uint8_t)(indice * 7 + (indice >> 8) + (indice >> 13));
+}
+
+
+/***************************************************************************************
+**  Nombre:         uint32_t enviarTramasPruebaUART(uint16_t numTramas, uint16_t longitudFija, bool leer)
+**  Descripcion:    Envia tramas con la linea en reposo entre ellas. Si se pide, despues de
+**                  cada trama se vacia el buffer con leerUART
+**  Parametros:     Numero de tramas, longitud de las tramas (0 para longitud aleatoria),
+**                  leer por polling
+**  Retorno:        Bytes enviados
+****************************************************************************************/
+uint32_t enviarTramasPruebaUART(uint16_t numTramas, uint16_t longitudFija, bool leer)
+{
+    uint32_t bytesEnviados = 0;
+
+    for (uint16_t i = 0; i < numTramas; i++) {
+        const uint16_t longitud = longitudFija > 0 ? longitudFija : 1 + aleatorioPruebaUART() % TAM_MAX_TRAMA_PRUEBA_UART;
+
+        for (uint16_t j = 0; j < longitud; j++) {
+            recibirByteUART(UART_PRUEBA_SITL, byteFlujoPruebaUART(bytesEnviados));
+            bytesEnviados++;
+        }
+
+        lineaReposoUART(UART_PRUEBA_SITL);
+
+        while (leer && bytesRecibidosUART(UART_PRUEBA_SITL) > 0)
+            callbackBytePruebaUART((uint8_t)leerUART(UART_PRUEBA_SITL));
+    }
+
+    return bytesEnviados;
+}
+
+
+/***************************************************************************************
+**  Nombre:         bool comprobarFlujoPruebaUART(uint32_t bytesEnviados)
+**  Descripcion:    Comprueba que lo recibido coincide con lo enviado
+**  Parametros:     Bytes enviados
+**  Retorno:        True si coincide
+****************************************************************************************/
+bool comprobarFlujoPruebaUART(uint32_t bytesEnviados)
+{
+    if (bytesRecibidosPrueba != bytesEnviados)
+        return false;
+
+    for (uint32_t i = 0; i < bytesEnviados; i++) {
+        if (flujoRecibido[i] != byteFlujoPruebaUART(i))
+            return false;
+    }
+
+    return true;
+}
+
+
+/***************************************************************************************
+**  Nombre:         void reiniciarPruebaUART(void)
+**  Descripcion:    Borra la traza de la prueba
+**  Parametros:     Ninguno
+**  Retorno:        Ninguno
+****************************************************************************************/
+void reiniciarPruebaUART(void)
+{
+    bytesRecibidosPrueba = 0;
+    numBloquesPrueba = 0;
+    numBloquesPartidosPrueba = 0;
+    transferenciaMaxPrueba = 0;
+    semillaPrueba = 1;
+}
+
+
+/***************************************************************************************
+**  Nombre:         uint32_t aleatorioPruebaUART(void)
+**  Descripcion:    Generador pseudoaleatorio de la prueba
+**  Parametros:     Ninguno
+**  Retorno:        Numero pseudoaleatorio
+****************************************************************************************/
+uint32_t aleatorioPruebaUART(void)
+{
+    semillaPrueba = semillaPrueba * 1103515245 + 12345;
+    return semillaPrueba >> 16;
+}
+
+
+/***************************************************************************************
+**  Nombre:         uint16_t escribirMensajePruebaUART(uint32_t inicioFlujo, uint16_t longitud, bool reservar)
+**  Descripcion:    Escribe un mensaje del flujo de prueba copiandolo o sobre el bloque reservado
+**  Parametros:     Posicion del mensaje en el flujo, longitud, usar reservar/confirmar
+**  Retorno:        Bytes escritos
+****************************************************************************************/
+uint16_t escribirMensajePruebaUART(uint32_t inicioFlujo, uint16_t longitud, bool reservar)
+{
+    uint16_t escritos = 0;
+
+    if (!reservar) {
+        uint8_t mensaje[TAM_MAX_MENSAJE_PRUEBA_UART];
+
+        for (uint16_t i = 0; i < longitud; i++)
+            mensaje[i] = byteFlujoPruebaUART(inicioFlujo + i);
+
+        return escribirBufferUART(UART_PRUEBA_SITL, mensaje, longitud);
+    }
+
+    while (escritos < longitud) {
+        uint8_t *datos;
+        const uint16_t libres = MIN(reservarTxUART(UART_PRUEBA_SITL, &datos), longitud - escritos);
+
+        if (libres == 0)
+            break;
+
+        for (uint16_t i = 0; i < libres; i++)
+            datos[i] = byteFlujoPruebaUART(inicioFlujo + escritos + i);
+
+        confirmarTxUART(UART_PRUEBA_SITL, libres);
+        escritos += libres;
+    }
+
+    return escritos;
+}
+
+
+/***************************************************************************************
+**  Nombre:         void completarTransferenciaPruebaUART(void)
+**  Descripcion:    Guarda lo que envia la transferencia en curso y la termina
+**  Parametros:     Ninguno
+**  Retorno:        Ninguno
+****************************************************************************************/
+void completarTransferenciaPruebaUART(void)
+{
+    const uint8_t *finBuffer = &punteroUART(UART_PRUEBA_SITL)->txBuffer[TAMANIO_BUFFER_TX_UART];
+    const uint8_t *datos;
+    const uint16_t longitud = transferenciaTxUARTsitl(UART_PRUEBA_SITL, &datos);
+
+    if (longitud == 0)
+        return;
+
+    if (datos + longitud == finBuffer)
+        numBloquesPartidosPrueba++;
+
+    if (bytesRecibidosPrueba + longitud <= TAM_FLUJO_PRUEBA_UART)
+        memcpy(&flujoRecibido[bytesRecibidosPrueba], datos, longitud);
+
+    bytesRecibidosPrueba += longitud;
+    transferenciaMaxPrueba = MAX(transferenciaMaxPrueba, longitud);
+    completarTxUARTsitl(UART_PRUEBA_SITL);
+}
+
+
+/***************************************************************************************
+**  Nombre:         void probarRxDMAuartSITL(void)
+**  Descripcion:    Ejercita la recepcion por DMA circular sobre una UART libre: tramas de
+**                  longitud aleatoria entregadas por bloques, por byte y leidas por polling
+**  Parametros:     Ninguno
+**  Retorno:        Ninguno
+****************************************************************************************/
+void probarRxDMAuartSITL(void)
+{
+    const configIniUART_t config = {
+        .baudrate = 115200,
+        .lWord = UART_LONGITUD_WORD_8,
+        .paridad = UART_NO_PARIDAD,
+        .stop = UART_BIT_STOP_1,
+    };
+    uint32_t bytesEnviados;
+
+    // Callback por bloques
+    reiniciarPruebaUART();
+    iniciarUARTbloques(UART_PRUEBA_SITL, config, callbackBloquePruebaUART);
+    configurarRxDMAuartSITL(UART_PRUEBA_SITL, true);
+    bytesEnviados = enviarTramasPruebaUART(NUM_TRAMAS_PRUEBA_UART, 0, false);
+
+    printf("\nRecepcion UART por DMA (SITL)\n");
+    printf("  Bloques: tramas %u, bytes %u/%u, bloques %u (partidos en el final del buffer %u) | datos %s\n",
+           NUM_TRAMAS_PRUEBA_UART, bytesRecibidosPrueba, bytesEnviados, numBloquesPrueba, numBloquesPartidosPrueba,
+           comprobarFlujoPruebaUART(bytesEnviados) ? "ok" : "mal");
+
+    // Callback por byte
+    reiniciarPruebaUART();
+    iniciarUART(UART_PRUEBA_SITL, config, callbackBytePruebaUART);
+    configurarRxDMAuartSITL(UART_PRUEBA_SITL, true);
+    bytesEnviados = enviarTramasPruebaUART(NUM_TRAMAS_PRUEBA_UART / 4, 0, false);
+    const bool porByteOk = comprobarFlujoPruebaUART(bytesEnviados);
+
+    // Polling sin callbacks
+    reiniciarPruebaUART();
+    iniciarUART(UART_PRUEBA_SITL, config, NULL);
+    configurarRxDMAuartSITL(UART_PRUEBA_SITL, true);
+    bytesEnviados = enviarTramasPruebaUART(NUM_TRAMAS_PRUEBA_UART / 4, 100, true);
+    const bool pollingOk = comprobarFlujoPruebaUART(bytesEnviados);
+
+    printf("  Callback por byte: datos %s | polling: datos %s\n", porByteOk ? "ok" : "mal", pollingOk ? "ok" : "mal");
+
+    configurarRxDMAuartSITL(UART_PRUEBA_SITL, false);
+}
+
+/***************************************************************************************
+**  Nombre:         void probarTxDMAuartSITL(void)
+**  Descripcion:    Ejercita el envio por DMA: mensajes de longitud aleatoria escritos por copia
+**                  y con reservar/confirmar, con el DMA terminando las transferencias a
+**                  distinto ritmo para que el buffer se llene y los datos crucen el final
+**  Parametros:     Ninguno
+**  Retorno:        Ninguno
+****************************************************************************************/
+void probarTxDMAuartSITL(void)
+{
+    const configIniUART_t config = {
+        .baudrate = 115200,
+        .lWord = UART_LONGITUD_WORD_8,
+        .paridad = UART_NO_PARIDAD,
+        .stop = UART_BIT_STOP_1,
+    };
+    uint32_t bytesEscritos = 0;
+    uint32_t bytesDescartados = 0;
+
+    reiniciarPruebaUART();
+    iniciarUART(UART_PRUEBA_SITL, config, NULL);
+    retenerTxUARTsitl(UART_PRUEBA_SITL, true);
+
+    for (uint16_t i = 0; i < NUM_TRAMAS_PRUEBA_UART; i++) {
+        const uint16_t longitud = 1 + aleatorioPruebaUART() % TAM_MAX_MENSAJE_PRUEBA_UART;
+        const uint16_t escritos = escribirMensajePruebaUART(bytesEscritos, longitud, i % 2 == 1);
+
+        bytesEscritos += escritos;
+        bytesDescartados += longitud - escritos;
+
+        // Entre mensajes el DMA termina entre 0 y 2 transferencias
+        const uint8_t numCompletadas = aleatorioPruebaUART() % 3;
+        for (uint8_t j = 0; j < numCompletadas; j++)
+            completarTransferenciaPruebaUART();
+    }
+
+    while (!bufferTxVacioUART(UART_PRUEBA_SITL))
+        completarTransferenciaPruebaUART();
+
+    printf("\nEnvio UART por DMA (SITL)\n");
+    printf("  Mensajes %u: bytes %u/%u (descartados con el buffer lleno %u), transferencias %u (partidas en el final del buffer %u), max %u | datos %s\n",
+           NUM_TRAMAS_PRUEBA_UART, bytesRecibidosPrueba, bytesEscritos, bytesDescartados, transferenciasTxUARTsitl(UART_PRUEBA_SITL),
+           numBloquesPartidosPrueba, transferenciaMaxPrueba, comprobarFlujoPruebaUART(bytesEscritos) ? "ok" : "mal");
+
+    retenerTxUARTsitl(UART_PRUEBA_SITL, false);
+}
+
+#endif
@@ -0,0 +1,65 @@
+/***************************************************************************************
+**  uart_sitl.h - Funciones de inyeccion de datos en las UART simuladas
+**
+**
+**  Este fichero forma parte del proyecto URpilot.
+**  Codigo desarrollado por el grupo de investigacion ICON de la Universidad de La Rioja
+**
+**  Autor: Ramon Rico
+**  Fecha de creacion: 17/10/2026
+**  Fecha de modificacion: 17/10/2026
+**
+**  El proyecto URpilot NO es libre. No se puede distribuir y/o modificar este fichero
+**  bajo ningun concepto.
+**
+**  En caso de modificacion y/o solicitud de informacion pongase en contacto con
+**  el grupo de investigacion ICON a traves de: www.unirioja.es/urpilot
+**
+**
+**  Control de versiones del fichero
+**
+**  v1.0  Ramon Rico. Se ha liberado la primera version estable
+**
+****************************************************************************************/
+
+#ifndef __UART_SITL_H
+#define __UART_SITL_H
+
+/***************************************************************************************
+** AREA DE INCLUDES                                                                   **
+****************************************************************************************/
+#include <stdint.h>
+#include <stdbool.h>
+
+#include "Drivers/uart.h"
+
+
+/***************************************************************************************
+** AREA DE PREPROCESADOR                                                              **
+****************************************************************************************/
+
+
+/***************************************************************************************
+** AREA DE DEFINICION DE TIPOS                                                        **
+****************************************************************************************/
+
+
+/***************************************************************************************
+** AREA DE DECLARACION DE VARIABLES                                                   **
+****************************************************************************************/
+
+
+/***************************************************************************************
+** AREA DE PROTOTIPOS DE FUNCION                                                      **
+****************************************************************************************/
+void recibirByteUART(numUART_e numUART, uint8_t rxByte);
+void recibirBufferUART(numUART_e numUART, const uint8_t *datoRx, uint16_t longitud);
+uint32_t bytesTransmitidosUART(numUART_e numUART);
+void lineaReposoUART(numUART_e numUART);
+void configurarRxDMAuartSITL(numUART_e numUART, bool dma);
+void retenerTxUARTsitl(numUART_e numUART, bool retener);
+uint16_t transferenciaTxUARTsitl(numUART_e numUART, const uint8_t **datos);
+void completarTxUARTsitl(numUART_e numUART);
+uint32_t transferenciasTxUARTsitl(numUART_e numUART);
+
+#endif // __UART_SITL_H
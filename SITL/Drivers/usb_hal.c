@@ -0,0 +1,81 @@
+/***************************************************************************************
+**  usb_hal.c - Sustituto del driver USB para el SITL. El dispositivo se considera
+**               enumerado y configurado desde el arranque
+**
+**
+**  Este fichero forma parte del proyecto URpilot.
+**  Codigo desarrollado por el grupo de investigacion ICON de la Universidad de La Rioja
+**
+**  Autor: Ramon Rico
+**  Fecha de creacion: 17/10/2026
+**  Fecha de modificacion: 17/10/2026
+**
+**  El proyecto URpilot NO es libre. No se puede distribuir y/o modificar este fichero
+**  bajo ningun concepto.
+**
+**  En caso de modificacion y/o solicitud de informacion pongase en contacto con
+**  el grupo de investigacion ICON a traves de: www.unirioja.es/urpilot
+**
+**
+**  Control de versiones del fichero
+**
+**  v1.0  Ramon Rico. Se ha liberado la primera version estable
+**
+****************************************************************************************/
+
+/***************************************************************************************
+** AREA DE INCLUDES                                                                   **
+****************************************************************************************/
+#include "Drivers/usb.h"
+
+#ifdef USAR_USB
+#include "usb_sitl.h"
+
+
+/***************************************************************************************
+** AREA DE DEFINICION DE FUNCIONES                                                    **
+****************************************************************************************/
+
+/***************************************************************************************
+**  Nombre:         bool asignarHALusb(void)
+**  Descripcion:    No hay HAL que asignar en el host
+**  Parametros:     Ninguno
+**  Retorno:        True si ok
+****************************************************************************************/
+bool asignarHALusb(void)
+{
+    punteroUSB()->hal.asignado = true;
+    return true;
+}
+
+
+/***************************************************************************************
+**  Nombre:         bool iniciarDriverUSB(void)
+**  Descripcion:    Inicia el USB
+**  Parametros:     Ninguno
+**  Retorno:        True si OK
+****************************************************************************************/
+bool iniciarDriverUSB(void)
+{
+    usb_t *driver = punteroUSB();
+
+    if (!asignarHALusb())
+        return false;
+
+    driver->hal.hUSB.dev_state = USBD_STATE_CONFIGURED;
+    return true;
+}
+
+
+/***************************************************************************************
+**  Nombre:         void abrirPuertoUSB(bool abierto)
+**  Descripcion:    Simula la apertura o cierre del puerto desde el PC
+**  Parametros:     Estado del puerto
+**  Retorno:        Ninguno
+****************************************************************************************/
+void abrirPuertoUSB(bool abierto)
+{
+    punteroUSB()->puertoAbierto = abierto;
+}
+
+#endif
@@ -0,0 +1,205 @@
+/***************************************************************************************
+**  usb_hal_CDC.c - Sustituto de la clase CDC del USB para el SITL. Los buffers se vacian
+**                  y rellenan desde el programa del host
+**
+**
+**  Este fichero forma parte del proyecto URpilot.
+**  Codigo desarrollado por el grupo de investigacion ICON de la Universidad de La Rioja
+**
+**  Autor: Ramon Rico
+**  Fecha de creacion: 17/10/2026
+**  Fecha de modificacion: 17/10/2026
+**
+**  El proyecto URpilot NO es libre. No se puede distribuir y/o modificar este fichero
+**  bajo ningun concepto.
+**
+**  En caso de modificacion y/o solicitud de informacion pongase en contacto con
+**  el grupo de investigacion ICON a traves de: www.unirioja.es/urpilot
+**
+**
+**  Control de versiones del fichero
+**
+**  v1.0  Ramon Rico. Se ha liberado la primera version estable
+**
+****************************************************************************************/
+
+/***************************************************************************************
+** AREA DE INCLUDES                                                                   **
+****************************************************************************************/
+#include "Drivers/usb.h"
+
+#ifdef USAR_USB
+#include "usb_sitl.h"
+
+
+/***************************************************************************************
+** AREA DE DEFINICION DE FUNCIONES                                                    **
+****************************************************************************************/
+
+/***************************************************************************************
+**  Nombre:         void recibirBufferUSB(const uint8_t *datoRx, uint32_t longitud)
+**  Descripcion:    Entrega al firmware datos enviados desde el PC
+**  Parametros:     Datos y longitud
+**  Retorno:        Ninguno
+****************************************************************************************/
+void recibirBufferUSB(const uint8_t *datoRx, uint32_t longitud)
+{
+    usb_t *driver = punteroUSB();
+
+    for (uint32_t i = 0; i < longitud; i++) {
+        driver->rxBuffer[driver->cabezaRxBuffer] = datoRx[i];
+        driver->cabezaRxBuffer = (driver->cabezaRxBuffer + 1) % TAMANIO_BUFFER_RX_USB;
+    }
+}
+
+
+/***************************************************************************************
+**  Nombre:         uint32_t leerTransmisionUSB(uint8_t *datoTx, uint32_t longitud)
+**  Descripcion:    Recoge los datos que el firmware ha enviado al PC
+**  Parametros:     Buffer destino y tamanio maximo
+**  Retorno:        Numero de bytes copiados
+****************************************************************************************/
+uint32_t leerTransmisionUSB(uint8_t *datoTx, uint32_t longitud)
+{
+    usb_t *driver = punteroUSB();
+    uint32_t numBytes = 0;
+
+    while (numBytes < longitud && driver->colaTxBuffer != driver->cabezaTxBuffer) {
+        datoTx[numBytes++] = driver->txBuffer[driver->colaTxBuffer];
+        driver->colaTxBuffer = (driver->colaTxBuffer + 1) % TAMANIO_BUFFER_TX_USB;
+    }
+
+    return numBytes;
+}
+
+
+/***************************************************************************************
+**  Nombre:         void escribirUSB(uint8_t byteTx)
+**  Descripcion:    Envia un dato por el USB. Si nadie vacia el buffer el dato se pierde
+**  Parametros:     Dato a enviar
+**  Retorno:        Ninguno
+****************************************************************************************/
+void escribirUSB(uint8_t byteTx)
+{
+    usb_t *driver = punteroUSB();
+
+    if (!(usbConectado() && usbConfigurado() && usbAbierto()))
+        return;
+
+    if (bytesLibresBufferTxUSB() == 0)
+        return;
+
+    driver->txBuffer[driver->cabezaTxBuffer] = byteTx;
+    driver->cabezaTxBuffer = (driver->cabezaTxBuffer + 1) % TAMANIO_BUFFER_TX_USB;
+}
+
+
+/***************************************************************************************
+**  Nombre:         void escribirBufferUSB(uint8_t *datoTx, uint32_t longitud)
+**  Descripcion:    Envia un buffer por el USB
+**  Parametros:     Datos a enviar, longitud de los datos
+**  Retorno:        Ninguno
+****************************************************************************************/
+void escribirBufferUSB(uint8_t *datoTx, uint32_t longitud)
+{
+    for (uint32_t i = 0; i < longitud; i++)
+        escribirUSB(datoTx[i]);
+}
+
+
+/***************************************************************************************
+**  Nombre:         int16_t leerUSB(void)
+**  Descripcion:    Lee un dato del USB
+**  Parametros:     Ninguno
+**  Retorno:        Dato leido
+****************************************************************************************/
+int16_t leerUSB(void)
+{
+    usb_t *driver = punteroUSB();
+    int16_t byteRx;
+
+    if (driver->cabezaRxBuffer == driver->colaRxBuffer)
+        return -1;
+
+    byteRx = driver->rxBuffer[driver->colaRxBuffer];
+    driver->colaRxBuffer = (driver->colaRxBuffer + 1) % TAMANIO_BUFFER_RX_USB;
+    return byteRx;
+}
+
+
+/***************************************************************************************
+**  Nombre:         void leerBufferUSB(int16_t *datoRx, uint16_t longitud)
+**  Descripcion:    Lee un buffer del USB
+**  Parametros:     Buffer, longitud del buffer
+**  Retorno:        Ninguno
+****************************************************************************************/
+void leerBufferUSB(int16_t *datoRx, uint16_t longitud)
+{
+    for (uint16_t i = 0; i < longitud; i++)
+        datoRx[i] = leerUSB();
+}
+
+
+/***************************************************************************************
+**  Nombre:         void flushUSB(void)
+**  Descripcion:    Borra el Buffer de recepcion del USB
+**  Parametros:     Ninguno
+**  Retorno:        Ninguno
+****************************************************************************************/
+void flushUSB(void)
+{
+    usb_t *driver = punteroUSB();
+
+    driver->colaRxBuffer = 0;
+    driver->cabezaRxBuffer = 0;
+}
+
+
+/***************************************************************************************
+**  Nombre:         uint32_t bytesRecibidosUSB(void)
+**  Descripcion:    Devuelve el numero de bytes recibidos por el USB
+**  Parametros:     Ninguno
+**  Retorno:        Numero de bytes
+****************************************************************************************/
+uint32_t bytesRecibidosUSB(void)
+{
+    usb_t *driver = punteroUSB();
+
+    if (driver->cabezaRxBuffer >= driver->colaRxBuffer)
+        return driver->cabezaRxBuffer - driver->colaRxBuffer;
+
+    return TAMANIO_BUFFER_RX_USB + driver->cabezaRxBuffer - driver->colaRxBuffer;
+}
+
+
+/***************************************************************************************
+**  Nombre:         bool bufferTxVacioUSB(void)
+**  Descripcion:    Comprueba si el buffer de transmision esta vacio
+**  Parametros:     Ninguno
+**  Retorno:        True si vacio
+****************************************************************************************/
+bool bufferTxVacioUSB(void)
+{
+    usb_t *driver = punteroUSB();
+
+    return driver->colaTxBuffer == driver->cabezaTxBuffer;
+}
+
+
+/***************************************************************************************
+**  Nombre:         uint32_t bytesLibresBufferTxUSB(void)
+**  Descripcion:    Retorna el numero de bytes libres en el buffer de transmision
+**  Parametros:     Ninguno
+**  Retorno:        Numero de bytes libres
+****************************************************************************************/
+uint32_t bytesLibresBufferTxUSB(void)
+{
+    usb_t *driver = punteroUSB();
+
+    if (driver->cabezaTxBuffer >= driver->colaTxBuffer)
+        return TAMANIO_BUFFER_TX_USB - 1 - driver->cabezaTxBuffer + driver->colaTxBuffer;
+
+    return driver->colaTxBuffer - driver->cabezaTxBuffer - 1;
+}
+
+#endif
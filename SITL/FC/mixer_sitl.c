@@ -0,0 +1,447 @@
+/***************************************************************************************
+**  mixer_sitl.c - Asignacion de los motores del mixer con saturacion y coste frente al anterior
+**
+**
+**  Este fichero forma parte del proyecto URpilot.
+**  Codigo desarrollado por el grupo de investigacion ICON de la Universidad de La Rioja
+**
+**  Autor: Ramon Rico
+**  Fecha de creacion: 17/10/2026
+**  Fecha de modificacion: 17/10/2026
+**
+**  El proyecto URpilot NO es libre. No se puede distribuir y/o modificar este fichero
+**  bajo ningun concepto.
+**
+**  En caso de modificacion y/o solicitud de informacion pongase en contacto con
+**  el grupo de investigacion ICON a traves de: www.unirioja.es/urpilot
+**
+**
+**  Control de versiones del fichero
+**
+**  v1.0  Ramon Rico. Se ha liberado la primera version estable
+**
+****************************************************************************************/
+
+/***************************************************************************************
+** AREA DE INCLUDES                                                                   **
+****************************************************************************************/
+#include <stdio.h>
+#include <string.h>
+#include <math.h>
+
+#include "Core/pruebas_sitl.h"
+
+#ifdef SITL
+#include "FC/mixer.h"
+#include "FC/control.h"
+#include "GP/gp_mixer.h"
+#include "GP/gp_motor.h"
+#include "Motores/motor.h"
+#include "Fisica/fisica.h"
+#include "Drivers/tiempo_sitl.h"
+#include "Comun/util.h"
+#include "Comun/matematicas.h"
+
+
+/***************************************************************************************
+** AREA DE PREPROCESADOR                                                              **
+****************************************************************************************/
+#define NUM_GEOMETRIAS_MIXER_SITL            (DRON_HEXACOPTER_2H + 1)
+#define NUM_COMANDOS_MIXER_SITL              20000
+#define ACCION_MAX_MIXER_SITL                0.6f        // Amplitud de roll, pitch y yaw aleatorios
+#define ACCION_SONDA_MIXER_SITL              0.1f        // Accion para recuperar la matriz de asignacion
+#define ACELERADOR_SONDA_MIXER_SITL          0.5f
+#define TOLERANCIA_MIXER_SITL                1e-4f
+#define ITERACIONES_BUSQUEDA_MIXER_SITL      60
+#define ITERACIONES_COSTE_MIXER_SITL         200000
+#define ACCION_LIBRE_COSTE_MIXER_SITL        0.1f        // Vuelo normal sin saturar
+#define ACCION_SATURADA_COSTE_MIXER_SITL     0.5f        // Satura en todas las geometrias
+#define MAX_COSTE_MIXER_SITL_NS              500.0       // Por llamada en el host
+
+
+/***************************************************************************************
+** AREA DE DEFINICION DE TIPOS                                                        **
+****************************************************************************************/
+typedef struct {
+    uint8_t numMotores;
+    float roll[NUM_MAX_MOTORES];
+    float pitch[NUM_MAX_MOTORES];
+    float yaw[NUM_MAX_MOTORES];
+} matrizMixerSITL_t;
+
+typedef struct {
+    uint32_t numPosibles;
+    uint32_t numRecorteYaw;
+    uint32_t numEscaladoRollPitch;
+    uint32_t numDeformadosAnterior;                 // Comandos posibles que el recorte por motor deformaba
+    uint32_t numFallos;
+} resultadoMixerSITL_t;
+
+typedef void (*mezclaMixerSITL_t)(const float *u, float *empuje, float *salida);
+
+
+/***************************************************************************************
+** AREA DE DECLARACION DE VARIABLES                                                   **
+****************************************************************************************/
+static volatile float sumideroMixerSITL;
+
+
+/***************************************************************************************
+** AREA DE PROTOTIPOS DE FUNCION                                                      **
+****************************************************************************************/
+void recuperarMatrizMixerSITL(matrizMixerSITL_t *matriz);
+bool comprobarComandoMixerSITL(const matrizMixerSITL_t *matriz, const float *u, const float *empuje, const float *salida,
+                               resultadoMixerSITL_t *resultado);
+float rangoMinimoYawMixerSITL(const float *rollPitch, const float *yaw, uint8_t numMotores);
+void mezclarAnteriorMixerSITL(const float *u, float *empuje, float *salida);
+double medirCosteMixerSITL(mezclaMixerSITL_t mezcla, float amplitud);
+bool probarCambioGeometriaMixerSITL(void);
+
+
+/***************************************************************************************
+** AREA DE DEFINICION DE FUNCIONES                                                    **
+****************************************************************************************/
+
+/***************************************************************************************
+**  Nombre:         void recuperarMatrizMixerSITL(matrizMixerSITL_t *matriz)
+**  Descripcion:    Obtiene la matriz de asignacion de la geometria actual con acciones
+**                  pequenias, que el mixer asigna sin saturar
+**  Parametros:     Matriz de asignacion
+**  Retorno:        Ninguno
+****************************************************************************************/
+void recuperarMatrizMixerSITL(matrizMixerSITL_t *matriz)
+{
+    float empuje[NUM_MAX_MOTORES], salida[NUM_MAX_MOTORES];
+    float *columna[3] = { matriz->roll, matriz->pitch, matriz->yaw };
+
+    matriz->numMotores = numMotores();
+    for (uint8_t eje = 0; eje < 3; eje++) {
+        float u[4] = { 0, 0, 0, ACELERADOR_SONDA_MIXER_SITL };
+
+        u[eje] = ACCION_SONDA_MIXER_SITL;
+        mezclarMixer(u, empuje, salida);
+        for (uint8_t i = 0; i < matriz->numMotores; i++)
+            columna[eje][i] = (empuje[i] - ACELERADOR_SONDA_MIXER_SITL) / ACCION_SONDA_MIXER_SITL;
+    }
+}
+
+
+/***************************************************************************************
+**  Nombre:         float rangoMinimoYawMixerSITL(const float *rollPitch, const float *yaw, uint8_t numMotores)
+**  Descripcion:    Menor diferencia entre motores con el yaw escalado entre 0 y 1. La diferencia
+**                  es convexa en la fraccion del yaw y se busca por seccion ternaria
+**  Parametros:     Parte de roll y pitch de cada motor, parte de yaw de cada motor, numero de motores
+**  Retorno:        Diferencia minima
+****************************************************************************************/
+float rangoMinimoYawMixerSITL(const float *rollPitch, const float *yaw, uint8_t numMotores)
+{
+    double a = 0.0, b = 1.0, rango[2];
+
+    for (uint8_t iteracion = 0; iteracion < ITERACIONES_BUSQUEDA_MIXER_SITL; iteracion++) {
+        const double k[2] = { a + (b - a) / 3.0, b - (b - a) / 3.0 };
+
+        for (uint8_t j = 0; j < 2; j++) {
+            double minimo = INFINITY, maximo = -INFINITY;
+
+            for (uint8_t i = 0; i < numMotores; i++) {
+                minimo = MIN(minimo, rollPitch[i] + k[j] * yaw[i]);
+                maximo = MAX(maximo, rollPitch[i] + k[j] * yaw[i]);
+            }
+            rango[j] = maximo - minimo;
+        }
+
+        if (rango[0] > rango[1])
+            a = k[0];
+        else
+            b = k[1];
+    }
+
+    return MIN(rango[0], rango[1]);
+}
+
+
+/***************************************************************************************
+**  Nombre:         bool comprobarComandoMixerSITL(const matrizMixerSITL_t *matriz, const float *u, const float *empuje,
+**                                                 const float *salida, resultadoMixerSITL_t *resultado)
+**  Descripcion:    Comprueba la asignacion de un comando. Si el comando es posible se cumple
+**                  entero y solo se mueve el acelerador. Si roll y pitch caben con parte del
+**                  yaw, el yaw se escala por un factor entre 0 y 1 y se usa todo el rango. Si
+**                  roll y pitch no caben con ningun yaw se mantiene su direccion
+**  Parametros:     Matriz de asignacion, comando, empuje y salida del mixer, resultado
+**  Retorno:        Asignacion correcta
+****************************************************************************************/
+bool comprobarComandoMixerSITL(const matrizMixerSITL_t *matriz, const float *u, const float *empuje, const float *salida,
+                               resultadoMixerSITL_t *resultado)
+{
+    const uint8_t n = matriz->numMotores;
+    float rollPitch[NUM_MAX_MOTORES] = { 0 }, yaw[NUM_MAX_MOTORES] = { 0 }, comando[NUM_MAX_MOTORES];
+    float minRP = INFINITY, maxRP = -INFINITY, minCmd = INFINITY, maxCmd = -INFINITY;
+    float minEmpuje = INFINITY, maxEmpuje = -INFINITY;
+    bool ok = true;
+
+    for (uint8_t i = 0; i < n; i++) {
+        rollPitch[i] = u[ROLL] * matriz->roll[i] + u[PITCH] * matriz->pitch[i];
+        yaw[i] = u[YAW] * matriz->yaw[i];
+        comando[i] = rollPitch[i] + yaw[i];
+        minRP = MIN(minRP, rollPitch[i]);
+        maxRP = MAX(maxRP, rollPitch[i]);
+        minCmd = MIN(minCmd, comando[i]);
+        maxCmd = MAX(maxCmd, comando[i]);
+        minEmpuje = MIN(minEmpuje, empuje[i]);
+        maxEmpuje = MAX(maxEmpuje, empuje[i]);
+
+        // Siempre dentro del rango de los motores
+        const float salidaEsperada = configMixer()->valorMinimo + (configMixer()->valorMaximo - configMixer()->valorMinimo) * empuje[i];
+        if (empuje[i] < 0.0f || empuje[i] > 1.0f || fabsf(salida[i] - salidaEsperada) > TOLERANCIA_MIXER_SITL)
+            ok = false;
+    }
+
+    const float rangoRP = maxRP - minRP;
+    const float rangoCmd = maxCmd - minCmd;
+    const float rangoYaw = rangoMinimoYawMixerSITL(rollPitch, yaw, n);
+
+    // Los comandos en el limite pueden caer en cualquiera de los casos por redondeo
+    if (fabsf(rangoCmd - 1.0f) < TOLERANCIA_MIXER_SITL || fabsf(rangoYaw - 1.0f) < TOLERANCIA_MIXER_SITL)
+        return ok;
+
+    if (rangoCmd <= 1.0f) {
+        // Posible: todos los motores llevan el comando y el mismo acelerador
+        const float acelerador = empuje[0] - comando[0];
+        const float aceleradorPedido = limitarFloat(u[ALT], -minCmd, 1.0f - maxCmd);
+        bool deformado = false;
+
+        for (uint8_t i = 0; i < n; i++) {
+            if (fabsf(empuje[i] - comando[i] - acelerador) > TOLERANCIA_MIXER_SITL)
+                ok = false;
+
+            const float anterior = u[ALT] + comando[i];
+            if (anterior < 0.0f || anterior > 1.0f)
+                deformado = true;
+        }
+
+        if (fabsf(acelerador - aceleradorPedido) > TOLERANCIA_MIXER_SITL)
+            ok = false;
+
+        resultado->numPosibles++;
+        resultado->numDeformadosAnterior += deformado;
+    }
+    else if (rangoYaw < 1.0f) {
+        // Roll y pitch enteros y el yaw escalado: empuje - rollPitch = acelerador + k * yaw
+        float mediaD = 0, mediaY = 0, num = 0, den = 0, residuo = 0;
+
+        for (uint8_t i = 0; i < n; i++) {
+            mediaD += empuje[i] - rollPitch[i];
+            mediaY += yaw[i];
+        }
+        mediaD /= n;
+        mediaY /= n;
+
+        for (uint8_t i = 0; i < n; i++) {
+            num += (empuje[i] - rollPitch[i] - mediaD) * (yaw[i] - mediaY);
+            den += (yaw[i] - mediaY) * (yaw[i] - mediaY);
+        }
+
+        const float k = (den > 0.0f) ? num / den : 0.0f;
+        for (uint8_t i = 0; i < n; i++)
+            residuo = MAX(residuo, fabsf(empuje[i] - rollPitch[i] - mediaD - k * (yaw[i] - mediaY)));
+
+        // El mayor yaw posible deja la diferencia entre motores en 1
+        if (residuo > TOLERANCIA_MIXER_SITL || k < -TOLERANCIA_MIXER_SITL || k > 1.0f + TOLERANCIA_MIXER_SITL ||
+            fabsf(maxEmpuje - minEmpuje - 1.0f) > TOLERANCIA_MIXER_SITL)
+            ok = false;
+
+        resultado->numRecorteYaw++;
+    }
+    else {
+        // Roll y pitch escalados en su direccion ocupando todo el rango
+        for (uint8_t i = 0; i < n; i++) {
+            if (fabsf(empuje[i] * rangoRP - (rollPitch[i] - minRP)) > TOLERANCIA_MIXER_SITL * rangoRP)
+                ok = false;
+        }
+
+        if (fabsf(maxEmpuje - minEmpuje - 1.0f) > TOLERANCIA_MIXER_SITL)
+            ok = false;
+
+        resultado->numEscaladoRollPitch++;
+    }
+
+    return ok;
+}
+
+
+/***************************************************************************************
+**  Nombre:         void mezclarAnteriorMixerSITL(const float *u, float *empuje, float *salida)
+**  Descripcion:    Mixer anterior de referencia: recorta cada motor por separado y lee la
+**                  configuracion en cada motor
+**  Parametros:     Comando, empuje y salida de cada motor
+**  Retorno:        Ninguno
+****************************************************************************************/
+void mezclarAnteriorMixerSITL(const float *u, float *empuje, float *salida)
+{
+    static matrizMixerSITL_t matriz;
+    static uint8_t numMotoresMatriz;
+
+    if (numMotoresMatriz != numMotores()) {
+        recuperarMatrizMixerSITL(&matriz);
+        numMotoresMatriz = matriz.numMotores;
+    }
+
+    for (uint8_t i = 0; i < matriz.numMotores; i++) {
+        empuje[i] = limitarFloat(u[ALT] + u[ROLL] * matriz.roll[i] + u[PITCH] * matriz.pitch[i] + u[YAW] * matriz.yaw[i], 0.0f, 1.0f);
+
+        float pwm = empuje[i];
+        if (configMixer()->curvaPWM != 0) {
+            const float unoMenosCurva = 1.0f - configMixer()->curvaPWM;
+            pwm = limitarFloat((sqrtf(unoMenosCurva * unoMenosCurva + 4.0f * configMixer()->curvaPWM * pwm) - unoMenosCurva) *
+                               (0.5f / configMixer()->curvaPWM), 0.0, 1.0);
+        }
+
+        salida[i] = configMixer()->valorMinimo + (configMixer()->valorMaximo - configMixer()->valorMinimo) * pwm;
+    }
+}
+
+
+/***************************************************************************************
+**  Nombre:         double medirCosteMixerSITL(mezclaMixerSITL_t mezcla, float amplitud)
+**  Descripcion:    Mide el coste de una asignacion en el host con comandos que cambian de signo
+**  Parametros:     Funcion de mezcla, amplitud de roll, pitch y yaw
+**  Retorno:        ns por llamada
+****************************************************************************************/
+double medirCosteMixerSITL(mezclaMixerSITL_t mezcla, float amplitud)
+{
+    float u[4] = { 0, 0, 0, 0.5f };
+    float empuje[NUM_MAX_MOTORES], salida[NUM_MAX_MOTORES];
+    float suma = 0;
+
+    mezcla(u, empuje, salida);
+
+    const uint64_t inicio = nanosegundosHostSITL();
+    for (uint32_t i = 0; i < ITERACIONES_COSTE_MIXER_SITL; i++) {
+        u[ROLL] = (i & 0x100) ? amplitud : -0.7f * amplitud;
+        u[PITCH] = (i & 0x80) ? 0.8f * amplitud : -amplitud;
+        u[YAW] = (i & 0x200) ? amplitud : -0.3f * amplitud;
+        u[ALT] = 0.5f + salida[0] * 1e-3f;
+        mezcla(u, empuje, salida);
+        suma += empuje[0];
+    }
+    const uint64_t fin = nanosegundosHostSITL();
+
+    sumideroMixerSITL = suma;
+    return (double)(fin - inicio) / ITERACIONES_COSTE_MIXER_SITL;
+}
+
+
+/***************************************************************************************
+**  Nombre:         bool probarCambioGeometriaMixerSITL(void)
+**  Descripcion:    Cambia el tipo de drone con los motores apagados. Se aplica al encender si
+**                  no necesita mas motores de los iniciados
+**  Parametros:     Ninguno
+**  Retorno:        Cambio correcto
+****************************************************************************************/
+bool probarCambioGeometriaMixerSITL(void)
+{
+    const tipoDrone_e tipoDroneIni = configMixer()->tipoDrone;
+    const bool encendidos = motoresEncendidosMixer();
+    matrizMixerSITL_t matrizX, matrizP;
+
+    ajustarGeometriaMixer(DRON_QUADCOPTER_X);
+    recuperarMatrizMixerSITL(&matrizX);
+
+    // Misma cantidad de motores: se aplica al encender
+    apagarMotoresMixer();
+    configMixer_Sistema.tipoDrone = DRON_QUADCOPTER_P;
+    encenderMotoresMixer();
+    recuperarMatrizMixerSITL(&matrizP);
+    const bool aplicado = matrizP.numMotores == 4 && matrizP.roll[0] == 0.0f && matrizX.roll[0] != 0.0f;
+
+    // Mas motores de los iniciados: se mantiene la geometria anterior
+    apagarMotoresMixer();
+    configMixer_Sistema.tipoDrone = DRON_OCTOCOPTER_X;
+    encenderMotoresMixer();
+    const bool rechazado = configMotor()->numMotores >= 8 || numMotores() == 4;
+
+    printf("  Cambio de geometria al encender: %s, con %u motores iniciados la de 8 motores %s\n",
+           aplicado ? "aplicado" : "sin aplicar", configMotor()->numMotores, (numMotores() == 8) ? "se aplica" : "se ignora");
+
+    apagarMotoresMixer();
+    configMixer_Sistema.tipoDrone = tipoDroneIni;
+    ajustarGeometriaMixer(tipoDroneIni);
+    if (encendidos)
+        encenderMotoresMixer();
+
+    return aplicado && rechazado;
+}
+
+
+/***************************************************************************************
+**  Nombre:         void probarMixerSITL(void)
+**  Descripcion:    Prueba la asignacion de todas las geometrias con comandos aleatorios que
+**                  saturan, el cambio de geometria y compara el coste con el mixer anterior
+**  Parametros:     Ninguno
+**  Retorno:        Ninguno
+****************************************************************************************/
+void probarMixerSITL(void)
+{
+    const tipoDrone_e geometriaCoste[] = { DRON_QUADCOPTER_X, DRON_HEXACOPTER_X, DRON_OCTOCOPTER_X, DRON_HEXACOPTER_2X };
+    estadisticasMixer_t estadisticasIni, estadisticasFin;
+    resultadoMixerSITL_t resultado;
+    bool ok = true;
+
+    printf("\nMixer con prioridad de roll y pitch en la saturacion (SITL)\n");
+
+    memset(&resultado, 0, sizeof(resultado));
+    leerEstadisticasMixer(&estadisticasIni);
+
+    for (uint8_t g = 0; g < NUM_GEOMETRIAS_MIXER_SITL; g++) {
+        float empuje[NUM_MAX_MOTORES], salida[NUM_MAX_MOTORES];
+        matrizMixerSITL_t matriz;
+
+        ajustarGeometriaMixer((tipoDrone_e)g);
+        recuperarMatrizMixerSITL(&matriz);
+
+        for (uint32_t c = 0; c < NUM_COMANDOS_MIXER_SITL; c++) {
+            const float u[4] = { ruidoFisica(ACCION_MAX_MIXER_SITL), ruidoFisica(ACCION_MAX_MIXER_SITL), ruidoFisica(ACCION_MAX_MIXER_SITL),
+                                 0.5f + ruidoFisica(0.5f) };
+
+            mezclarMixer(u, empuje, salida);
+            if (!comprobarComandoMixerSITL(&matriz, u, empuje, salida, &resultado))
+                resultado.numFallos++;
+        }
+    }
+
+    leerEstadisticasMixer(&estadisticasFin);
+    const uint32_t numComandos = NUM_COMANDOS_MIXER_SITL * NUM_GEOMETRIAS_MIXER_SITL;
+    const bool asignacionOk = resultado.numFallos == 0 && resultado.numPosibles > 0 && resultado.numRecorteYaw > 0 &&
+                              resultado.numEscaladoRollPitch > 0;
+
+    printf("  %u comandos en %u geometrias: %u posibles, %u con el yaw recortado, %u con roll y pitch escalados | fallos %u\n",
+           numComandos, NUM_GEOMETRIAS_MIXER_SITL, resultado.numPosibles, resultado.numRecorteYaw, resultado.numEscaladoRollPitch,
+           resultado.numFallos);
+    printf("  Comandos posibles que el recorte por motor deformaba: %u (%.1f %%)\n", resultado.numDeformadosAnterior,
+           100.0f * resultado.numDeformadosAnterior / MAX(resultado.numPosibles, 1));
+    printf("  Estadisticas del mixer: %u escalados de roll y pitch, %u recortes de yaw, %u ajustes del acelerador\n",
+           estadisticasFin.numEscaladoRollPitch - estadisticasIni.numEscaladoRollPitch,
+           estadisticasFin.numRecorteYaw - estadisticasIni.numRecorteYaw,
+           estadisticasFin.numAjusteAcelerador - estadisticasIni.numAjusteAcelerador);
+
+    // Coste por llamada de cada tamanio. El anterior solo recorta cada motor, asi que es mas barato
+    bool costeOk = true;
+    for (uint8_t j = 0; j < LONG_ARRAY(geometriaCoste); j++) {
+        const uint8_t n = ajustarGeometriaMixer(geometriaCoste[j]);
+        const double anterior = medirCosteMixerSITL(mezclarAnteriorMixerSITL, ACCION_LIBRE_COSTE_MIXER_SITL);
+        const double actual = medirCosteMixerSITL(mezclarMixer, ACCION_LIBRE_COSTE_MIXER_SITL);
+        const double saturado = medirCosteMixerSITL(mezclarMixer, ACCION_SATURADA_COSTE_MIXER_SITL);
+
+        printf("  Coste con %2u motores: %.1f ns, el anterior %.1f ns (%+.0f %%) | saturado %.1f ns (max %.0f)\n",
+               n, actual, anterior, 100.0 * (actual - anterior) / anterior, saturado, MAX_COSTE_MIXER_SITL_NS);
+        costeOk = costeOk && actual <= MAX_COSTE_MIXER_SITL_NS && saturado <= MAX_COSTE_MIXER_SITL_NS;
+    }
+
+    ajustarGeometriaMixer(configMixer()->tipoDrone);
+    const bool cambioOk = probarCambioGeometriaMixerSITL();
+
+    ok = asignacionOk && costeOk && cambioOk && estadisticasFin.numCiclos - estadisticasIni.numCiclos >= numComandos;
+    printf("  Resultado: %s\n", ok ? "ok" : "fallo");
+}
+
+#endif
@@ -0,0 +1,229 @@
+/***************************************************************************************
+**  filtro_rpm_sitl.c - Banco de pruebas de la telemetria dshot y del filtro RPM
+**
+**
+**  Este fichero forma parte del proyecto URpilot.
+**  Codigo desarrollado por el grupo de investigacion ICON de la Universidad de La Rioja
+**
+**  Autor: Ramon Rico
+**  Fecha de creacion: 17/10/2026
+**  Fecha de modificacion: 17/10/2026
+**
+**  El proyecto URpilot NO es libre. No se puede distribuir y/o modificar este fichero
+**  bajo ningun concepto.
+**
+**  En caso de modificacion y/o solicitud de informacion pongase en contacto con
+**  el grupo de investigacion ICON a traves de: www.unirioja.es/urpilot
+**
+**
+**  Control de versiones del fichero
+**
+**  v1.0  Ramon Rico. Se ha liberado la primera version estable
+**
+****************************************************************************************/
+
+/***************************************************************************************
+** AREA DE INCLUDES                                                                   **
+****************************************************************************************/
+#include <stdio.h>
+#include <string.h>
+#include <math.h>
+
+#include "Core/pruebas_sitl.h"
+
+#ifdef SITL
+#include "Filtros/filtro_rpm.h"
+#include "Motores/dshot_telemetria.h"
+#include "Motores/motor_sitl.h"
+#include "Drivers/tiempo_sitl.h"
+#include "Fisica/fisica.h"
+#include "Comun/util.h"
+
+
+/***************************************************************************************
+** AREA DE PREPROCESADOR                                                              **
+****************************************************************************************/
+#define FREC_GIRO_RPM_SITL                   4000.0f     // Hz. Giro leido de la FIFO
+#define FREC_TELEMETRIA_RPM_SITL             1000        // Hz. Respuestas de los ESC y tarea del filtro
+#define DURACION_RPM_SITL                    4.0f        // s
+#define NUM_MOTORES_RPM_SITL                 4
+#define POLOS_RPM_SITL                       14
+#define TICKS_BIT_RPM_SITL                   16
+#define CAPTURAS_POR_ERROR_RPM_SITL          49          // Primo con el numero de motores
+
+#define ARMONICOS_RPM_SITL                   0x07
+#define FREC_MIN_RPM_SITL                    80.0f
+#define ANCHO_BANDA_RPM_SITL                 20.0f
+#define ATENUACION_RPM_SITL                  40.0f
+
+// Cada motor gira a una velocidad distinta con acelerones. Amplitud de la fundamental y los armonicos en º/s
+#define FREC_BASE_MOTOR_RPM_SITL             130.0f
+#define FREC_ACELERON_RPM_SITL               120.0f
+#define PERIODO_ACELERON_RPM_SITL            1.0f        // s
+static const float amplitudArmonicoSITL[3] = {15.0f, 6.0f, 3.0f};
+#define RUIDO_GIRO_RPM_SITL                  2.0f
+
+#define T_CONVERGENCIA_RPM_SITL              0.5f        // s. No se mide antes
+
+
+/***************************************************************************************
+** AREA DE DEFINICION DE TIPOS                                                        **
+****************************************************************************************/
+
+
+/***************************************************************************************
+** AREA DE DECLARACION DE VARIABLES                                                   **
+****************************************************************************************/
+static filtroRPM_t filtroGiroSITL;
+static filtroRPM_t filtroVibracionSITL;             // Mismos notch con solo la vibracion para medir la atenuacion
+
+
+/***************************************************************************************
+** AREA DE PROTOTIPOS DE FUNCION                                                      **
+****************************************************************************************/
+float frecMotorRPMsitl(uint8_t motor, float t);
+
+
+/***************************************************************************************
+** AREA DE DEFINICION DE FUNCIONES                                                    **
+****************************************************************************************/
+
+/***************************************************************************************
+**  Nombre:         float frecMotorRPMsitl(uint8_t motor, float t)
+**  Descripcion:    Frecuencia de giro de un motor en cada instante: base distinta por motor y
+**                  acelerones de medio segundo desfasados entre motores
+**  Parametros:     Motor, tiempo en s
+**  Retorno:        Frecuencia en Hz
+****************************************************************************************/
+float frecMotorRPMsitl(uint8_t motor, float t)
+{
+    const float fase = fmodf(t + 0.2f * motor, PERIODO_ACELERON_RPM_SITL) / PERIODO_ACELERON_RPM_SITL;
+    const float aceleron = fase < 0.5f ? sinf(2.0f * PI * fase) : 0.0f;
+
+    return FREC_BASE_MOTOR_RPM_SITL + 15.0f * motor + FREC_ACELERON_RPM_SITL * aceleron;
+}
+
+
+/***************************************************************************************
+**  Nombre:         void probarFiltroRPMsitl(void)
+**  Descripcion:    Filtra un giro sintetico con la vibracion de cuatro motores y sus armonicos. La
+**                  velocidad de cada motor llega como flancos de la respuesta del ESC, con fluctuacion
+**                  y capturas corruptas. Se mide el error de la telemetria, la atenuacion de la
+**                  vibracion y el coste por muestra y por reajuste
+**  Parametros:     Ninguno
+**  Retorno:        Ninguno
+****************************************************************************************/
+void probarFiltroRPMsitl(void)
+{
+    const float escalaEje[3] = {1.0f, 0.7f, 0.4f};
+    const float dt = 1.0f / FREC_GIRO_RPM_SITL;
+    const uint32_t numMuestras = DURACION_RPM_SITL * FREC_GIRO_RPM_SITL;
+    const uint32_t diezmado = FREC_GIRO_RPM_SITL / FREC_TELEMETRIA_RPM_SITL;
+    telemetriaDshot_t telemetria[NUM_MOTORES_RPM_SITL];
+    float frecTelemetria[NUM_MOTORES_RPM_SITL] = {0};
+    float fase[NUM_MOTORES_RPM_SITL] = {0};
+    double energiaEntrada = 0, energiaSalida = 0, sumaErrorCuad = 0;
+    float errorMax = 0;
+    uint32_t numErrores = 0, numCapturas = 0;
+    uint64_t nsMuestras = 0, nsReajuste = 0, nsMaxReajuste = 0;
+
+    memset(telemetria, 0, sizeof(telemetria));
+    ajustarFiltroRPM(&filtroGiroSITL, FREC_GIRO_RPM_SITL, FREC_TELEMETRIA_RPM_SITL, NUM_MOTORES_RPM_SITL, ARMONICOS_RPM_SITL,
+                     FREC_MIN_RPM_SITL, ANCHO_BANDA_RPM_SITL, ATENUACION_RPM_SITL);
+    ajustarFiltroRPM(&filtroVibracionSITL, FREC_GIRO_RPM_SITL, FREC_TELEMETRIA_RPM_SITL, NUM_MOTORES_RPM_SITL, ARMONICOS_RPM_SITL,
+                     FREC_MIN_RPM_SITL, ANCHO_BANDA_RPM_SITL, ATENUACION_RPM_SITL);
+
+    for (uint32_t n = 0; n < numMuestras; n++) {
+        const float t = n * dt;
+        const float maniobra[3] = {150.0f * sinf(2.0f * PI * 1.5f * t), 80.0f * sinf(2.0f * PI * 0.7f * t),
+                                   30.0f * sinf(2.0f * PI * 0.3f * t)};
+        float vibracion = 0;
+
+        for (uint8_t m = 0; m < NUM_MOTORES_RPM_SITL; m++) {
+            fase[m] += 2.0f * PI * frecMotorRPMsitl(m, t) * dt;
+            if (fase[m] > 2.0f * PI)
+                fase[m] -= 2.0f * PI;
+
+            for (uint8_t k = 0; k < 3; k++)
+                vibracion += amplitudArmonicoSITL[k] * sinf((k + 1) * fase[m] + 0.7f * m);
+        }
+
+        // Respuesta de los ESC y tarea del filtro
+        if (n % diezmado == 0) {
+            for (uint8_t m = 0; m < NUM_MOTORES_RPM_SITL; m++) {
+                uint32_t flancos[TAM_BUFFER_CAPTURA_DSHOT];
+                const uint32_t eRPM = frecMotorRPMsitl(m, t) * 60.0f * POLOS_RPM_SITL / 2;
+                const uint8_t numFlancos = codificarFlancosDshot(eRPM, TICKS_BIT_RPM_SITL, n * 7, flancos);
+
+                for (uint8_t i = 0; i < numFlancos; i++)
+                    flancos[i] += (int32_t)ruidoFisica(TICKS_BIT_RPM_SITL / 8);
+
+                if (++numCapturas % CAPTURAS_POR_ERROR_RPM_SITL == 0)
+                    flancos[numFlancos / 2] += TICKS_BIT_RPM_SITL;
+
+                if (actualizarTelemetriaDshot(&telemetria[m], flancos, numFlancos, TICKS_BIT_RPM_SITL, n) == TELEMETRIA_DSHOT_OK)
+                    frecTelemetria[m] = frecTelemetriaDshot(&telemetria[m], POLOS_RPM_SITL);
+            }
+
+            const uint64_t inicio = nanosegundosHostSITL();
+            actualizarFrecFiltroRPM(&filtroGiroSITL, frecTelemetria);
+            const uint64_t ns = nanosegundosHostSITL() - inicio;
+
+            nsReajuste += ns;
+            if (ns > nsMaxReajuste)
+                nsMaxReajuste = ns;
+
+            actualizarFrecFiltroRPM(&filtroVibracionSITL, frecTelemetria);
+        }
+
+        const uint64_t inicio = nanosegundosHostSITL();
+        for (uint8_t i = 0; i < 3; i++) {
+            const float giro = maniobra[i] + escalaEje[i] * vibracion + ruidoFisica(RUIDO_GIRO_RPM_SITL);
+            actualizarFiltroRPM(&filtroGiroSITL, i, giro);
+        }
+        nsMuestras += nanosegundosHostSITL() - inicio;
+
+        for (uint8_t i = 0; i < 3; i++) {
+            const float filtrada = actualizarFiltroRPM(&filtroVibracionSITL, i, escalaEje[i] * vibracion);
+
+            if (t >= T_CONVERGENCIA_RPM_SITL) {
+                energiaEntrada += (double)escalaEje[i] * vibracion * escalaEje[i] * vibracion;
+                energiaSalida += (double)filtrada * filtrada;
+            }
+        }
+
+        // Error de la frecuencia de los notch frente a la real
+        if (t >= T_CONVERGENCIA_RPM_SITL) {
+            for (uint8_t m = 0; m < NUM_MOTORES_RPM_SITL; m++) {
+                const float error = fabsf(filtroGiroSITL.frecMotor[m] - frecMotorRPMsitl(m, t));
+
+                sumaErrorCuad += error * error;
+                numErrores++;
+                if (error > errorMax)
+                    errorMax = error;
+            }
+        }
+    }
+
+    uint32_t tramas = 0, erroresTelemetria = 0;
+    for (uint8_t m = 0; m < NUM_MOTORES_RPM_SITL; m++) {
+        tramas += telemetria[m].numTramas;
+        erroresTelemetria += erroresTelemetriaDshot(&telemetria[m]);
+    }
+
+    printf("\nFiltro RPM con telemetria dshot (SITL)\n");
+    printf("  Telemetria: capturas %u, validas %u, errores %u | seguimiento de los notch: error rms %.1f Hz, max %.1f Hz\n",
+           numCapturas, tramas, erroresTelemetria, sqrt(sumaErrorCuad / numErrores), errorMax);
+    printf("  Atenuacion de la vibracion %.1f dB | %.0f ns por muestra (3 ejes, %u motores, 3 armonicos) | reajuste medio %.0f ns, max %u ns\n",
+           10.0 * log10(energiaSalida / energiaEntrada), (double)nsMuestras / numMuestras, NUM_MOTORES_RPM_SITL,
+           (double)nsReajuste / (numMuestras / diezmado), (uint32_t)nsMaxReajuste);
+
+    printf("  Telemetria emulada en la simulacion:");
+    for (uint8_t m = 0; m < numMotoresSITL(); m++) {
+        const telemetriaDshot_t *telemetriaMotor = telemetriaMotorSITL(m);
+        printf(" M%u %u/%u", m + 1, telemetriaMotor->numTramas, erroresTelemetriaDshot(telemetriaMotor));
+    }
+    printf(" (validas/errores)\n");
+}
+
+#endif
@@ -0,0 +1,283 @@
+/***************************************************************************************
+**  media_movil_sitl.c - Banco de pruebas del filtro de media movil
+**
+**
+**  Este fichero forma parte del proyecto URpilot.
+**  Codigo desarrollado por el grupo de investigacion ICON de la Universidad de La Rioja
+**
+**  Autor: Ramon Rico
+**  Fecha de creacion: 17/10/2026
+**  Fecha de modificacion: 17/10/2026
+**
+**  El proyecto URpilot NO es libre. No se puede distribuir y/o modificar este fichero
+**  bajo ningun concepto.
+**
+**  En caso de modificacion y/o solicitud de informacion pongase en contacto con
+**  el grupo de investigacion ICON a traves de: www.unirioja.es/urpilot
+**
+**
+**  Control de versiones del fichero
+**
+**  v1.0  Ramon Rico. Se ha liberado la primera version estable
+**
+****************************************************************************************/
+
+/***************************************************************************************
+** AREA DE INCLUDES                                                                   **
+****************************************************************************************/
+#include <stdio.h>
+#include <string.h>
+#include <math.h>
+
+#include "Core/pruebas_sitl.h"
+
+#ifdef SITL
+#include "Filtros/filtro_media_movil.h"
+#include "Drivers/tiempo_sitl.h"
+#include "Fisica/fisica.h"
+#include "Comun/util.h"
+
+
+/***************************************************************************************
+** AREA DE PREPROCESADOR                                                              **
+****************************************************************************************/
+#define LOG2_NUM_MUESTRAS_MEDIA_SITL         20          // Muestras distintas de la senial
+#define NUM_PASADAS_MEDIA_SITL               8           // Se recorre la senial varias veces para ver la deriva
+#define LOG2_VENTANA_LARGA_MEDIA_SITL        8
+
+// Presion del barometro con una variacion lenta y ruido. El valor medio grande es el peor caso para la deriva
+#define PRESION_MEDIA_SITL                   101325.0f   // Pa
+#define VARIACION_PRESION_MEDIA_SITL         50.0f       // Pa
+#define RUIDO_PRESION_MEDIA_SITL             3.0f        // Pa
+
+#define NUM_MUESTRAS_MEDIA_SITL              (1U << LOG2_NUM_MUESTRAS_MEDIA_SITL)
+#define TAM_VENTANA_LARGA_MEDIA_SITL         TAM_FILTRO_MEDIA_MOVIL_POT2(LOG2_VENTANA_LARGA_MEDIA_SITL)
+
+
+/***************************************************************************************
+** AREA DE DEFINICION DE TIPOS                                                        **
+****************************************************************************************/
+// Implementacion anterior: se suma toda la ventana en cada muestra
+typedef struct {
+    float muestras[TAM_VENTANA_LARGA_MEDIA_SITL];
+    uint16_t tamFiltro;
+    uint16_t numMuestras;
+    uint16_t indiceMuestra;
+} mediaMovilReferenciaSITL_t;
+
+// Suma acumulada sin resumar nunca. Solo para ver la deriva
+typedef struct {
+    float muestras[TAM_VENTANA_LARGA_MEDIA_SITL];
+    float suma;
+    uint16_t tamFiltro;
+    uint16_t indiceMuestra;
+} mediaMovilSinResumarSITL_t;
+
+// Media exacta en doble precision
+typedef struct {
+    double muestras[TAM_VENTANA_LARGA_MEDIA_SITL];
+    double suma;
+    uint16_t tamFiltro;
+    uint16_t indiceMuestra;
+} mediaMovilExactaSITL_t;
+
+typedef struct {
+    const char *nombre;
+    double errorMax;
+    double nsMuestra;
+} resultadoMediaMovilSITL_t;
+
+
+/***************************************************************************************
+** AREA DE DECLARACION DE VARIABLES                                                   **
+****************************************************************************************/
+static float senialMediaSITL[NUM_MUESTRAS_MEDIA_SITL];
+static float muestrasPot2SITL[TAM_VENTANA_LARGA_MEDIA_SITL];
+static volatile float sumideroMediaSITL;
+
+
+/***************************************************************************************
+** AREA DE PROTOTIPOS DE FUNCION                                                      **
+****************************************************************************************/
+float actualizarMediaReferenciaSITL(mediaMovilReferenciaSITL_t *filtro, float muestra);
+float actualizarMediaSinResumarSITL(mediaMovilSinResumarSITL_t *filtro, float muestra);
+double actualizarMediaExactaSITL(mediaMovilExactaSITL_t *filtro, float muestra);
+void compararMediaMovilSITL(uint8_t log2Tam);
+
+
+/***************************************************************************************
+** AREA DE DEFINICION DE FUNCIONES                                                    **
+****************************************************************************************/
+
+/***************************************************************************************
+**  Nombre:         float actualizarMediaReferenciaSITL(mediaMovilReferenciaSITL_t *filtro, float muestra)
+**  Descripcion:    Media movil sumando toda la ventana en cada muestra, como se hacia antes
+**  Parametros:     Puntero al filtro, muestra
+**  Retorno:        Valor filtrado
+****************************************************************************************/
+float actualizarMediaReferenciaSITL(mediaMovilReferenciaSITL_t *filtro, float muestra)
+{
+    float sumValores = 0;
+
+    filtro->muestras[filtro->indiceMuestra] = muestra;
+    filtro->indiceMuestra++;
+    if (filtro->indiceMuestra >= filtro->tamFiltro)
+        filtro->indiceMuestra = 0;
+
+    if (filtro->numMuestras < filtro->tamFiltro)
+        filtro->numMuestras++;
+
+    for (uint16_t i = 0; i < filtro->tamFiltro; i++)
+        sumValores += filtro->muestras[i];
+
+    return sumValores / filtro->numMuestras;
+}
+
+
+/***************************************************************************************
+**  Nombre:         float actualizarMediaSinResumarSITL(mediaMovilSinResumarSITL_t *filtro, float muestra)
+**  Descripcion:    Media movil con suma acumulada que nunca se rehace
+**  Parametros:     Puntero al filtro, muestra
+**  Retorno:        Valor filtrado con la ventana llena
+****************************************************************************************/
+float actualizarMediaSinResumarSITL(mediaMovilSinResumarSITL_t *filtro, float muestra)
+{
+    filtro->suma += muestra - filtro->muestras[filtro->indiceMuestra];
+    filtro->muestras[filtro->indiceMuestra] = muestra;
+
+    filtro->indiceMuestra++;
+    if (filtro->indiceMuestra >= filtro->tamFiltro)
+        filtro->indiceMuestra = 0;
+
+    return filtro->suma / filtro->tamFiltro;
+}
+
+
+/***************************************************************************************
+**  Nombre:         double actualizarMediaExactaSITL(mediaMovilExactaSITL_t *filtro, float muestra)
+**  Descripcion:    Media movil en doble precision para medir el error del resto
+**  Parametros:     Puntero al filtro, muestra
+**  Retorno:        Valor filtrado con la ventana llena
+****************************************************************************************/
+double actualizarMediaExactaSITL(mediaMovilExactaSITL_t *filtro, float muestra)
+{
+    filtro->suma += (double)muestra - filtro->muestras[filtro->indiceMuestra];
+    filtro->muestras[filtro->indiceMuestra] = muestra;
+
+    filtro->indiceMuestra++;
+    if (filtro->indiceMuestra >= filtro->tamFiltro)
+        filtro->indiceMuestra = 0;
+
+    return filtro->suma / filtro->tamFiltro;
+}
+
+
+/***************************************************************************************
+**  Nombre:         void compararMediaMovilSITL(uint8_t log2Tam)
+**  Descripcion:    Compara el coste y el error de la suma completa, la suma acumulada con y sin
+**                  resumar y la variante potencia de 2 con una ventana de 2^log2Tam muestras
+**  Parametros:     log2 del tamanio de la ventana
+**  Retorno:        Ninguno
+****************************************************************************************/
+void compararMediaMovilSITL(uint8_t log2Tam)
+{
+    static mediaMovilReferenciaSITL_t referencia;
+    static mediaMovilSinResumarSITL_t sinResumar;
+    static mediaMovilExactaSITL_t exacta;
+    static filtroMediaMovil_t filtro;
+    static filtroMediaMovilPot2_t filtroPot2;
+    const uint16_t tam = TAM_FILTRO_MEDIA_MOVIL_POT2(log2Tam);
+    const bool conFiltroGeneral = tam <= TAM_MAX_FILTRO_MEDIA_MOVIL;
+    resultadoMediaMovilSITL_t resultado[4] = {
+        {"suma completa", 0, 0},
+        {"suma acumulada", 0, 0},
+        {"potencia de 2", 0, 0},
+        {"sin resumar", 0, 0},
+    };
+    uint64_t inicio;
+
+    memset(&referencia, 0, sizeof(referencia));
+    memset(&sinResumar, 0, sizeof(sinResumar));
+    memset(&exacta, 0, sizeof(exacta));
+    referencia.tamFiltro = tam;
+    sinResumar.tamFiltro = tam;
+    exacta.tamFiltro = tam;
+    if (conFiltroGeneral)
+        ajustarFiltroMediaMovil(&filtro, tam);
+    ajustarFiltroMediaMovilPot2(&filtroPot2, muestrasPot2SITL, log2Tam);
+
+    // Error frente a la media exacta. Se descarta el llenado de la ventana
+    for (uint32_t n = 0; n < NUM_PASADAS_MEDIA_SITL * NUM_MUESTRAS_MEDIA_SITL; n++) {
+        const float muestra = senialMediaSITL[n & (NUM_MUESTRAS_MEDIA_SITL - 1)];
+        const double valorExacto = actualizarMediaExactaSITL(&exacta, muestra);
+        double salida[4];
+
+        salida[0] = actualizarMediaReferenciaSITL(&referencia, muestra);
+        salida[1] = conFiltroGeneral ? actualizarFiltroMediaMovil(&filtro, muestra) : valorExacto;
+        salida[2] = actualizarFiltroMediaMovilPot2(&filtroPot2, muestra);
+        salida[3] = actualizarMediaSinResumarSITL(&sinResumar, muestra);
+
+        if (n < tam)
+            continue;
+
+        for (uint8_t i = 0; i < 4; i++) {
+            const double error = fabs(salida[i] - valorExacto);
+            if (error > resultado[i].errorMax)
+                resultado[i].errorMax = error;
+        }
+    }
+
+    // Coste por muestra. Una pasada por la senial para cada implementacion
+    inicio = nanosegundosHostSITL();
+    for (uint32_t n = 0; n < NUM_MUESTRAS_MEDIA_SITL; n++)
+        sumideroMediaSITL = actualizarMediaReferenciaSITL(&referencia, senialMediaSITL[n]);
+    resultado[0].nsMuestra = (double)(nanosegundosHostSITL() - inicio) / NUM_MUESTRAS_MEDIA_SITL;
+
+    if (conFiltroGeneral) {
+        inicio = nanosegundosHostSITL();
+        for (uint32_t n = 0; n < NUM_MUESTRAS_MEDIA_SITL; n++)
+            sumideroMediaSITL = actualizarFiltroMediaMovil(&filtro, senialMediaSITL[n]);
+        resultado[1].nsMuestra = (double)(nanosegundosHostSITL() - inicio) / NUM_MUESTRAS_MEDIA_SITL;
+    }
+
+    inicio = nanosegundosHostSITL();
+    for (uint32_t n = 0; n < NUM_MUESTRAS_MEDIA_SITL; n++)
+        sumideroMediaSITL = actualizarFiltroMediaMovilPot2(&filtroPot2, senialMediaSITL[n]);
+    resultado[2].nsMuestra = (double)(nanosegundosHostSITL() - inicio) / NUM_MUESTRAS_MEDIA_SITL;
+
+    inicio = nanosegundosHostSITL();
+    for (uint32_t n = 0; n < NUM_MUESTRAS_MEDIA_SITL; n++)
+        sumideroMediaSITL = actualizarMediaSinResumarSITL(&sinResumar, senialMediaSITL[n]);
+    resultado[3].nsMuestra = (double)(nanosegundosHostSITL() - inicio) / NUM_MUESTRAS_MEDIA_SITL;
+
+    printf("  Ventana %u", tam);
+    for (uint8_t i = 0; i < 4; i++) {
+        if (i == 1 && !conFiltroGeneral)
+            continue;
+
+        printf(" | %s %.1f ns, error max %.4f Pa", resultado[i].nombre, resultado[i].nsMuestra, resultado[i].errorMax);
+    }
+    printf("\n");
+}
+
+
+/***************************************************************************************
+**  Nombre:         void probarMediaMovilSITL(void)
+**  Descripcion:    Compara las implementaciones de la media movil con la presion del barometro
+**                  durante varios millones de muestras
+**  Parametros:     Ninguno
+**  Retorno:        Ninguno
+****************************************************************************************/
+void probarMediaMovilSITL(void)
+{
+    for (uint32_t n = 0; n < NUM_MUESTRAS_MEDIA_SITL; n++) {
+        const float fase = 2.0f * PI * n / NUM_MUESTRAS_MEDIA_SITL;
+        senialMediaSITL[n] = PRESION_MEDIA_SITL + VARIACION_PRESION_MEDIA_SITL * sinf(fase) + ruidoFisica(RUIDO_PRESION_MEDIA_SITL);
+    }
+
+    printf("\nFiltro de media movil (SITL, %u muestras)\n", NUM_PASADAS_MEDIA_SITL * NUM_MUESTRAS_MEDIA_SITL);
+    compararMediaMovilSITL(4);
+    compararMediaMovilSITL(LOG2_VENTANA_LARGA_MEDIA_SITL);
+}
+
+#endif
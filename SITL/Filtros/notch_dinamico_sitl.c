@@ -0,0 +1,256 @@
+/***************************************************************************************
+**  notch_dinamico_sitl.c - Banco de pruebas del filtro notch dinamico con giro sintetico
+**
+**
+**  Este fichero forma parte del proyecto URpilot.
+**  Codigo desarrollado por el grupo de investigacion ICON de la Universidad de La Rioja
+**
+**  Autor: Ramon Rico
+**  Fecha de creacion: 17/10/2026
+**  Fecha de modificacion: 17/10/2026
+**
+**  El proyecto URpilot NO es libre. No se puede distribuir y/o modificar este fichero
+**  bajo ningun concepto.
+**
+**  En caso de modificacion y/o solicitud de informacion pongase en contacto con
+**  el grupo de investigacion ICON a traves de: www.unirioja.es/urpilot
+**
+**
+**  Control de versiones del fichero
+**
+**  v1.0  Ramon Rico. Se ha liberado la primera version estable
+**
+****************************************************************************************/
+
+/***************************************************************************************
+** AREA DE INCLUDES                                                                   **
+****************************************************************************************/
+#include <stdio.h>
+#include <string.h>
+#include <math.h>
+
+#include "Core/pruebas_sitl.h"
+
+#ifdef SITL
+#include "Filtros/notch_dinamico.h"
+#include "Drivers/tiempo_sitl.h"
+#include "Fisica/fisica.h"
+#include "Comun/util.h"
+
+
+/***************************************************************************************
+** AREA DE PREPROCESADOR                                                              **
+****************************************************************************************/
+#define FREC_GIRO_NOTCH_SITL                 1000.0f     // Hz. Giro y tarea del analizador a la misma frecuencia
+#define DURACION_NOTCH_SITL                  6.0f        // s
+#define NUM_PICOS_NOTCH_SITL                 2
+#define FREC_MIN_NOTCH_SITL                  80.0f
+#define FREC_MAX_NOTCH_SITL                  450.0f
+#define Q_NOTCH_SITL                         3.5f
+
+// Motor: fijo, rampa, fijo y escalon de bajada. El armonico esta al doble
+#define FREC_INICIAL_MOTOR_SITL              120.0f
+#define FREC_RAMPA_MOTOR_SITL                200.0f
+#define FREC_ESCALON_MOTOR_SITL              140.0f
+#define T_INICIO_RAMPA_NOTCH_SITL            1.5f
+#define T_FIN_RAMPA_NOTCH_SITL               3.5f
+#define T_ESCALON_NOTCH_SITL                 4.5f
+#define AMPLITUD_MOTOR_SITL                  20.0f       // º/s
+#define AMPLITUD_ARMONICO_SITL               8.0f        // º/s
+#define RUIDO_GIRO_NOTCH_SITL                4.0f        // º/s
+
+#define T_CONVERGENCIA_NOTCH_SITL            1.0f        // s. No se mide antes
+#define T_EXCLUIDO_ESCALON_NOTCH_SITL        0.25f       // s. Ni justo despues del escalon
+#define ERROR_ENGANCHE_NOTCH_SITL            10.0f       // Hz
+
+
+/***************************************************************************************
+** AREA DE DEFINICION DE TIPOS                                                        **
+****************************************************************************************/
+typedef struct {
+    uint32_t numErrores;
+    double sumaErrorCuad;
+    float errorMax;
+    float tiempoEnganche;
+    double energiaEntrada;
+    double energiaSalida;
+    uint64_t nsTotal;
+    uint64_t nsMaxPaso[PASO_NOTCH_DINAMICO_PICOS + 1];
+} resultadoNotchSITL_t;
+
+
+/***************************************************************************************
+** AREA DE DECLARACION DE VARIABLES                                                   **
+****************************************************************************************/
+static analizadorNotchDinamico_t analizadorSITL;
+static bancoNotchDinamico_t bancoGiroSITL[3];
+static bancoNotchDinamico_t bancoTonoSITL[3];       // Mismos notch con solo el tono para medir la atenuacion
+
+
+/***************************************************************************************
+** AREA DE PROTOTIPOS DE FUNCION                                                      **
+****************************************************************************************/
+float frecMotorNotchSITL(float t);
+float errorPicoNotchSITL(const float *frecPico, float frec);
+
+
+/***************************************************************************************
+** AREA DE DEFINICION DE FUNCIONES                                                    **
+****************************************************************************************/
+
+/***************************************************************************************
+**  Nombre:         float frecMotorNotchSITL(float t)
+**  Descripcion:    Frecuencia de la vibracion de los motores en cada instante
+**  Parametros:     Tiempo en s
+**  Retorno:        Frecuencia en Hz
+****************************************************************************************/
+float frecMotorNotchSITL(float t)
+{
+    if (t < T_INICIO_RAMPA_NOTCH_SITL)
+        return FREC_INICIAL_MOTOR_SITL;
+
+    if (t < T_FIN_RAMPA_NOTCH_SITL)
+        return FREC_INICIAL_MOTOR_SITL + (FREC_RAMPA_MOTOR_SITL - FREC_INICIAL_MOTOR_SITL) *
+               (t - T_INICIO_RAMPA_NOTCH_SITL) / (T_FIN_RAMPA_NOTCH_SITL - T_INICIO_RAMPA_NOTCH_SITL);
+
+    if (t < T_ESCALON_NOTCH_SITL)
+        return FREC_RAMPA_MOTOR_SITL;
+
+    return FREC_ESCALON_MOTOR_SITL;
+}
+
+
+/***************************************************************************************
+**  Nombre:         float errorPicoNotchSITL(const float *frecPico, float frec)
+**  Descripcion:    Distancia del notch mas cercano a una frecuencia
+**  Parametros:     Frecuencias de los notch, frecuencia real
+**  Retorno:        Error en Hz
+****************************************************************************************/
+float errorPicoNotchSITL(const float *frecPico, float frec)
+{
+    float error = 1e9f;
+
+    for (uint8_t i = 0; i < NUM_PICOS_NOTCH_SITL; i++) {
+        if (fabsf(frecPico[i] - frec) < error)
+            error = fabsf(frecPico[i] - frec);
+    }
+
+    return error;
+}
+
+
+/***************************************************************************************
+**  Nombre:         void probarNotchDinamicoSITL(void)
+**  Descripcion:    Filtra un giro sintetico con maniobras, vibracion de motor con armonico
+**                  y ruido blanco. Se mide el seguimiento de las frecuencias, la atenuacion
+**                  del tono y el coste por muestra y por paso del analisis
+**  Parametros:     Ninguno
+**  Retorno:        Ninguno
+****************************************************************************************/
+void probarNotchDinamicoSITL(void)
+{
+    const float escalaEje[3] = {1.0f, 0.8f, 0.5f};
+    const float dt = 1.0f / FREC_GIRO_NOTCH_SITL;
+    const uint32_t numMuestras = DURACION_NOTCH_SITL * FREC_GIRO_NOTCH_SITL;
+    resultadoNotchSITL_t resultado;
+    float fase = 0;
+
+    memset(&resultado, 0, sizeof(resultado));
+    resultado.tiempoEnganche = -1;
+
+    iniciarAnalizadorNotchDinamico(&analizadorSITL, FREC_GIRO_NOTCH_SITL, FREC_GIRO_NOTCH_SITL, NUM_PICOS_NOTCH_SITL,
+                                   FREC_MIN_NOTCH_SITL, FREC_MAX_NOTCH_SITL);
+    for (uint8_t i = 0; i < 3; i++) {
+        ajustarBancoNotchDinamico(&bancoGiroSITL[i], FREC_GIRO_NOTCH_SITL, NUM_PICOS_NOTCH_SITL, analizadorSITL.frecPico[i], Q_NOTCH_SITL);
+        ajustarBancoNotchDinamico(&bancoTonoSITL[i], FREC_GIRO_NOTCH_SITL, NUM_PICOS_NOTCH_SITL, analizadorSITL.frecPico[i], Q_NOTCH_SITL);
+    }
+
+    for (uint32_t n = 0; n < numMuestras; n++) {
+        const float t = n * dt;
+        const float frecMotor = frecMotorNotchSITL(t);
+        const float maniobra[3] = {150.0f * sinf(2.0f * PI * 1.5f * t), 80.0f * sinf(2.0f * PI * 0.7f * t),
+                                   30.0f * sinf(2.0f * PI * 0.3f * t)};
+        float giro[3], tono[3];
+
+        fase += 2.0f * PI * frecMotor * dt;
+        if (fase > 2.0f * PI)
+            fase -= 2.0f * PI;
+
+        for (uint8_t i = 0; i < 3; i++) {
+            tono[i] = escalaEje[i] * (AMPLITUD_MOTOR_SITL * sinf(fase) + AMPLITUD_ARMONICO_SITL * sinf(2.0f * fase + 0.5f));
+            giro[i] = maniobra[i] + tono[i] + ruidoFisica(RUIDO_GIRO_NOTCH_SITL);
+        }
+
+        // Camino del giro como en la IMU y un paso del analizador por muestra
+        const pasoNotchDinamico_e paso = analizadorSITL.paso;
+        const bool analizando = analizadorSITL.ventanaLlena;
+        const uint64_t inicio = nanosegundosHostSITL();
+
+        anadirMuestraNotchDinamico(&analizadorSITL, giro);
+        for (uint8_t i = 0; i < 3; i++)
+            giro[i] = actualizarBancoNotchDinamico(&bancoGiroSITL[i], giro[i]);
+
+        const uint64_t inicioPaso = nanosegundosHostSITL();
+        uint8_t eje;
+        const bool actualizado = actualizarAnalizadorNotchDinamico(&analizadorSITL, &eje);
+
+        if (actualizado)
+            actualizarFrecBancoNotchDinamico(&bancoGiroSITL[eje], analizadorSITL.frecPico[eje]);
+
+        const uint64_t fin = nanosegundosHostSITL();
+        resultado.nsTotal += fin - inicio;
+        if (analizando && fin - inicioPaso > resultado.nsMaxPaso[paso])
+            resultado.nsMaxPaso[paso] = fin - inicioPaso;
+
+        if (actualizado)
+            actualizarFrecBancoNotchDinamico(&bancoTonoSITL[eje], analizadorSITL.frecPico[eje]);
+
+        for (uint8_t i = 0; i < 3; i++) {
+            const float tonoFiltrado = actualizarBancoNotchDinamico(&bancoTonoSITL[i], tono[i]);
+
+            if (t >= T_CONVERGENCIA_NOTCH_SITL) {
+                resultado.energiaEntrada += tono[i] * tono[i];
+                resultado.energiaSalida += tonoFiltrado * tonoFiltrado;
+            }
+        }
+
+        // Seguimiento del motor y del armonico
+        if (t >= T_ESCALON_NOTCH_SITL && resultado.tiempoEnganche < 0) {
+            bool enganchado = true;
+            for (uint8_t i = 0; i < 3; i++) {
+                if (errorPicoNotchSITL(analizadorSITL.frecPico[i], frecMotor) > ERROR_ENGANCHE_NOTCH_SITL)
+                    enganchado = false;
+            }
+
+            if (enganchado)
+                resultado.tiempoEnganche = t - T_ESCALON_NOTCH_SITL;
+        }
+
+        if (t < T_CONVERGENCIA_NOTCH_SITL || (t >= T_ESCALON_NOTCH_SITL && t < T_ESCALON_NOTCH_SITL + T_EXCLUIDO_ESCALON_NOTCH_SITL))
+            continue;
+
+        for (uint8_t i = 0; i < 3; i++) {
+            const float error[2] = {errorPicoNotchSITL(analizadorSITL.frecPico[i], frecMotor),
+                                    errorPicoNotchSITL(analizadorSITL.frecPico[i], 2.0f * frecMotor)};
+
+            for (uint8_t j = 0; j < 2; j++) {
+                resultado.sumaErrorCuad += error[j] * error[j];
+                resultado.numErrores++;
+                if (error[j] > resultado.errorMax)
+                    resultado.errorMax = error[j];
+            }
+        }
+    }
+
+    printf("\nNotch dinamico (SITL)\n");
+    printf("  Seguimiento motor y armonico: error rms %.1f Hz, max %.1f Hz | escalon %.0f->%.0f Hz enganchado en %.0f ms | analisis %u\n",
+           sqrt(resultado.sumaErrorCuad / resultado.numErrores), resultado.errorMax, FREC_RAMPA_MOTOR_SITL, FREC_ESCALON_MOTOR_SITL,
+           resultado.tiempoEnganche * 1000.0f, analizadorSITL.numAnalisis);
+    printf("  Atenuacion del tono %.1f dB | %.0f ns por muestra (3 ejes, %u notch por eje y un paso del analisis)\n",
+           10.0 * log10(resultado.energiaSalida / resultado.energiaEntrada), (double)resultado.nsTotal / numMuestras, NUM_PICOS_NOTCH_SITL);
+    printf("  Paso max (ns del host): ventana %u, etapa FFT %u, espectro %u, picos y reajuste %u\n",
+           (uint32_t)resultado.nsMaxPaso[PASO_NOTCH_DINAMICO_VENTANA], (uint32_t)resultado.nsMaxPaso[PASO_NOTCH_DINAMICO_FFT],
+           (uint32_t)resultado.nsMaxPaso[PASO_NOTCH_DINAMICO_ESPECTRO], (uint32_t)resultado.nsMaxPaso[PASO_NOTCH_DINAMICO_PICOS]);
+}
+
+#endif
@@ -0,0 +1,416 @@
+/***************************************************************************************
+**  fisica.c - Modelo fisico simplificado de un cuadricoptero en X para el SITL. Solido
+**             rigido de 6 grados de libertad con motores de primer orden, arrastre
+**             lineal y contacto con el suelo. La integracion es de paso fijo para que
+**             la simulacion sea determinista
+**
+**
+**  Este fichero forma parte del proyecto URpilot.
+**  Codigo desarrollado por el grupo de investigacion ICON de la Universidad de La Rioja
+**
+**  Autor: Ramon Rico
+**  Fecha de creacion: 17/10/2026
+**  Fecha de modificacion: 17/10/2026
+**
+**  El proyecto URpilot NO es libre. No se puede distribuir y/o modificar este fichero
+**  bajo ningun concepto.
+**
+**  En caso de modificacion y/o solicitud de informacion pongase en contacto con
+**  el grupo de investigacion ICON a traves de: www.unirioja.es/urpilot
+**
+**
+**  Control de versiones del fichero
+**
+**  v1.0  Ramon Rico. Se ha liberado la primera version estable
+**
+****************************************************************************************/
+
+/***************************************************************************************
+** AREA DE INCLUDES                                                                   **
+****************************************************************************************/
+#include <string.h>
+#include <math.h>
+
+#include "fisica.h"
+#include "Motores/motor_sitl.h"
+#include "Comun/matematicas.h"
+
+
+/***************************************************************************************
+** AREA DE PREPROCESADOR                                                              **
+****************************************************************************************/
+#define GRAVEDAD_FISICA             9.80665f
+#define RADIO_TIERRA_FISICA         6378137.0
+#define PI_FISICA                   3.14159265358979f
+#define SEMILLA_RUIDO_FISICA        0x2545F491u
+
+
+/***************************************************************************************
+** AREA DE DEFINICION DE TIPOS                                                        **
+****************************************************************************************/
+
+
+/***************************************************************************************
+** AREA DE DECLARACION DE VARIABLES                                                   **
+****************************************************************************************/
+// Posicion de los motores (x, y en brazos unitarios) y sentido del par de reaccion.
+// Coincide con la tabla mixerQuadX: M1 delante derecha, M2 delante izquierda,
+// M3 detras izquierda, M4 detras derecha
+static const float geometriaMotor[NUM_MOTORES_FISICA][3] = {
+    {  1.0f,  1.0f,  1.0f },
+    {  1.0f, -1.0f, -1.0f },
+    { -1.0f, -1.0f,  1.0f },
+    { -1.0f,  1.0f, -1.0f },
+};
+
+static paramFisica_t param;
+static estadoFisica_t estado;
+static uint32_t semillaRuido;
+
+
+/***************************************************************************************
+** AREA DE PROTOTIPOS DE FUNCION                                                      **
+****************************************************************************************/
+void pasoFisica(float dt);
+void matrizRotacionFisica(const float *q, float r[3][3]);
+
+
+/***************************************************************************************
+** AREA DE DEFINICION DE FUNCIONES                                                    **
+****************************************************************************************/
+
+/***************************************************************************************
+**  Nombre:         void iniciarFisica(void)
+**  Descripcion:    Carga los parametros por defecto y pone el vehiculo en el suelo
+**  Parametros:     Ninguno
+**  Retorno:        Ninguno
+****************************************************************************************/
+void iniciarFisica(void)
+{
+    memset(&estado, 0, sizeof(estado));
+
+    param.masa = 1.2f;
+    param.inercia[0] = 0.012f;
+    param.inercia[1] = 0.012f;
+    param.inercia[2] = 0.022f;
+    param.brazo = 0.225f;
+    param.tauMotor = 0.02f;
+    param.kPar = 0.016f;
+    param.kArrastre = 0.6f;
+    param.kArrastreRot = 0.002f;
+    param.parPerturbacion[0] = 0.004f;
+    param.parPerturbacion[1] = -0.003f;
+    param.parPerturbacion[2] = 0.0f;
+
+    // Con la salida nominal del mixer (0.3 escalado entre 0.1 y 0.95) el empuje
+    // es ligeramente superior al peso para que el vehiculo despegue
+    param.empujeMax = 1.03f * param.masa * GRAVEDAD_FISICA / (NUM_MOTORES_FISICA * 0.355f);
+
+    param.latitudOrigen = 42.4627;
+    param.longitudOrigen = -2.4450;
+    param.altitudOrigen = 384.0f;
+    param.campoMagNED[0] = 240.0f;
+    param.campoMagNED[1] = 0.0f;
+    param.campoMagNED[2] = 370.0f;
+
+    estado.q[0] = 1.0f;
+    estado.enSuelo = true;
+    semillaRuido = SEMILLA_RUIDO_FISICA;
+}
+
+
+/***************************************************************************************
+**  Nombre:         paramFisica_t *paramFisica(void)
+**  Descripcion:    Retorna los parametros del modelo para modificarlos
+**  Parametros:     Ninguno
+**  Retorno:        Puntero a los parametros
+****************************************************************************************/
+paramFisica_t *paramFisica(void)
+{
+    return &param;
+}
+
+
+/***************************************************************************************
+**  Nombre:         const estadoFisica_t *estadoFisica(void)
+**  Descripcion:    Retorna el estado del modelo
+**  Parametros:     Ninguno
+**  Retorno:        Puntero al estado
+****************************************************************************************/
+const estadoFisica_t *estadoFisica(void)
+{
+    return &estado;
+}
+
+
+/***************************************************************************************
+**  Nombre:         void ajustarActitudFisica(float roll, float pitch, float yaw)
+**  Descripcion:    Asigna la orientacion del vehiculo
+**  Parametros:     Angulos de Euler en º
+**  Retorno:        Ninguno
+****************************************************************************************/
+void ajustarActitudFisica(float roll, float pitch, float yaw)
+{
+    const float cr = cosf(roll * PI_FISICA / 360.0f), sr = sinf(roll * PI_FISICA / 360.0f);
+    const float cp = cosf(pitch * PI_FISICA / 360.0f), sp = sinf(pitch * PI_FISICA / 360.0f);
+    const float cy = cosf(yaw * PI_FISICA / 360.0f), sy = sinf(yaw * PI_FISICA / 360.0f);
+
+    estado.q[0] = cr * cp * cy + sr * sp * sy;
+    estado.q[1] = sr * cp * cy - cr * sp * sy;
+    estado.q[2] = cr * sp * cy + sr * cp * sy;
+    estado.q[3] = cr * cp * sy - sr * sp * cy;
+}
+
+
+/***************************************************************************************
+**  Nombre:         void actualizarFisica(uint64_t tiempoUs)
+**  Descripcion:    Integra el modelo con paso fijo hasta el tiempo indicado
+**  Parametros:     Tiempo simulado en us
+**  Retorno:        Ninguno
+****************************************************************************************/
+void actualizarFisica(uint64_t tiempoUs)
+{
+    while (estado.tiempo + PASO_FISICA_US <= tiempoUs) {
+        pasoFisica(PASO_FISICA_US * 1e-6f);
+        estado.tiempo += PASO_FISICA_US;
+    }
+}
+
+
+/***************************************************************************************
+**  Nombre:         void pasoFisica(float dt)
+**  Descripcion:    Avanza un paso de integracion (Euler semi-implicito)
+**  Parametros:     Paso en s
+**  Retorno:        Ninguno
+****************************************************************************************/
+void pasoFisica(float dt)
+{
+    float r[3][3];
+    float empujeTotal = 0;
+    float par[3];
+    const float d = param.brazo * 0.70710678f;
+
+    // Motores de primer orden
+    for (uint8_t i = 0; i < NUM_MOTORES_FISICA; i++) {
+        const float ref = param.empujeMax * salidaMotorSITL(i);
+        estado.empuje[i] += (ref - estado.empuje[i]) * dt / (param.tauMotor + dt);
+        empujeTotal += estado.empuje[i];
+    }
+
+    // Pares en ejes cuerpo (FRD)
+    par[0] = param.parPerturbacion[0];
+    par[1] = param.parPerturbacion[1];
+    par[2] = param.parPerturbacion[2];
+    for (uint8_t i = 0; i < NUM_MOTORES_FISICA; i++) {
+        par[0] += -geometriaMotor[i][1] * d * estado.empuje[i];
+        par[1] +=  geometriaMotor[i][0] * d * estado.empuje[i];
+        par[2] +=  geometriaMotor[i][2] * param.kPar * estado.empuje[i];
+    }
+
+    // Fuerzas en ejes tierra (NED)
+    matrizRotacionFisica(estado.q, r);
+    float fuerza[3];
+    for (uint8_t i = 0; i < 3; i++)
+        fuerza[i] = -r[i][2] * empujeTotal - param.kArrastre * estado.velocidad[i];
+
+    fuerza[2] += param.masa * GRAVEDAD_FISICA;
+
+    // Contacto con el suelo: el suelo compensa el peso mientras no haya empuje suficiente
+    const bool apoyado = (estado.posicion[2] >= 0.0f) && (fuerza[2] >= 0.0f);
+    if (apoyado) {
+        estado.enSuelo = true;
+        estado.posicion[2] = 0.0f;
+        memset(estado.velocidad, 0, sizeof(estado.velocidad));
+        memset(estado.aceleracion, 0, sizeof(estado.aceleracion));
+        memset(estado.velAngular, 0, sizeof(estado.velAngular));
+        return;
+    }
+
+    estado.enSuelo = false;
+
+    // Traslacion
+    for (uint8_t i = 0; i < 3; i++) {
+        estado.aceleracion[i] = fuerza[i] / param.masa;
+        estado.velocidad[i] += estado.aceleracion[i] * dt;
+        estado.posicion[i] += estado.velocidad[i] * dt;
+    }
+
+    // Rotacion: I·dw = par - w x (I·w) - k·w
+    const float *w = estado.velAngular;
+    const float iw[3] = { param.inercia[0] * w[0], param.inercia[1] * w[1], param.inercia[2] * w[2] };
+    const float giroscopico[3] = {
+        w[1] * iw[2] - w[2] * iw[1],
+        w[2] * iw[0] - w[0] * iw[2],
+        w[0] * iw[1] - w[1] * iw[0],
+    };
+
+    for (uint8_t i = 0; i < 3; i++)
+        estado.velAngular[i] += (par[i] - giroscopico[i] - param.kArrastreRot * estado.velAngular[i]) / param.inercia[i] * dt;
+
+    // Integracion del cuaternio: dq = 0.5 * q x (0, w)
+    float *q = estado.q;
+    const float dq[4] = {
+        0.5f * (-q[1] * w[0] - q[2] * w[1] - q[3] * w[2]),
+        0.5f * ( q[0] * w[0] + q[2] * w[2] - q[3] * w[1]),
+        0.5f * ( q[0] * w[1] - q[1] * w[2] + q[3] * w[0]),
+        0.5f * ( q[0] * w[2] + q[1] * w[1] - q[2] * w[0]),
+    };
+
+    float norma = 0;
+    for (uint8_t i = 0; i < 4; i++) {
+        q[i] += dq[i] * dt;
+        norma += q[i] * q[i];
+    }
+
+    norma = 1.0f / sqrtf(norma);
+    for (uint8_t i = 0; i < 4; i++)
+        q[i] *= norma;
+}
+
+
+/***************************************************************************************
+**  Nombre:         void matrizRotacionFisica(const float *q, float r[3][3])
+**  Descripcion:    Calcula la matriz de rotacion de cuerpo a tierra
+**  Parametros:     Cuaternio, matriz de salida
+**  Retorno:        Ninguno
+****************************************************************************************/
+void matrizRotacionFisica(const float *q, float r[3][3])
+{
+    r[0][0] = 1 - 2 * (q[2] * q[2] + q[3] * q[3]);
+    r[0][1] = 2 * (q[1] * q[2] - q[0] * q[3]);
+    r[0][2] = 2 * (q[1] * q[3] + q[0] * q[2]);
+    r[1][0] = 2 * (q[1] * q[2] + q[0] * q[3]);
+    r[1][1] = 1 - 2 * (q[1] * q[1] + q[3] * q[3]);
+    r[1][2] = 2 * (q[2] * q[3] - q[0] * q[1]);
+    r[2][0] = 2 * (q[1] * q[3] - q[0] * q[2]);
+    r[2][1] = 2 * (q[2] * q[3] + q[0] * q[1]);
+    r[2][2] = 1 - 2 * (q[1] * q[1] + q[2] * q[2]);
+}
+
+
+/***************************************************************************************
+**  Nombre:         float ruidoFisica(float amplitud)
+**  Descripcion:    Genera ruido pseudoaleatorio reproducible (xorshift32)
+**  Parametros:     Amplitud maxima
+**  Retorno:        Ruido uniforme entre -amplitud y amplitud
+****************************************************************************************/
+float ruidoFisica(float amplitud)
+{
+    semillaRuido ^= semillaRuido << 13;
+    semillaRuido ^= semillaRuido >> 17;
+    semillaRuido ^= semillaRuido << 5;
+
+    return amplitud * ((float)semillaRuido / 2147483648.0f - 1.0f);
+}
+
+
+/***************************************************************************************
+**  Nombre:         void acelCuerpoFisica(float *acel)
+**  Descripcion:    Aceleracion medida por la IMU con el convenio del firmware
+**  Parametros:     Aceleracion en g
+**  Retorno:        Ninguno
+****************************************************************************************/
+void acelCuerpoFisica(float *acel)
+{
+    float r[3][3];
+    float a[3];
+
+    matrizRotacionFisica(estado.q, r);
+
+    a[0] = -estado.aceleracion[0];
+    a[1] = -estado.aceleracion[1];
+    a[2] = GRAVEDAD_FISICA - estado.aceleracion[2];
+
+    // Se pasa a ejes cuerpo con la traspuesta
+    for (uint8_t i = 0; i < 3; i++)
+        acel[i] = (r[0][i] * a[0] + r[1][i] * a[1] + r[2][i] * a[2]) / GRAVEDAD_FISICA;
+}
+
+
+/***************************************************************************************
+**  Nombre:         void giroCuerpoFisica(float *giro)
+**  Descripcion:    Velocidad angular en ejes cuerpo
+**  Parametros:     Velocidad angular en º/s
+**  Retorno:        Ninguno
+****************************************************************************************/
+void giroCuerpoFisica(float *giro)
+{
+    for (uint8_t i = 0; i < 3; i++)
+        giro[i] = estado.velAngular[i] * 180.0f / PI_FISICA;
+}
+
+
+/***************************************************************************************
+**  Nombre:         void campoMagCuerpoFisica(float *campo)
+**  Descripcion:    Campo magnetico terrestre en ejes cuerpo
+**  Parametros:     Campo en mGa
+**  Retorno:        Ninguno
+****************************************************************************************/
+void campoMagCuerpoFisica(float *campo)
+{
+    float r[3][3];
+    const float *m = param.campoMagNED;
+
+    matrizRotacionFisica(estado.q, r);
+
+    for (uint8_t i = 0; i < 3; i++)
+        campo[i] = r[0][i] * m[0] + r[1][i] * m[1] + r[2][i] * m[2];
+}
+
+
+/***************************************************************************************
+**  Nombre:         float presionFisica(void)
+**  Descripcion:    Presion estatica segun la atmosfera estandar
+**  Parametros:     Ninguno
+**  Retorno:        Presion en mBar
+****************************************************************************************/
+float presionFisica(void)
+{
+    const float altitud = param.altitudOrigen - estado.posicion[2];
+    return 1013.25f * powf(1.0f - 2.25577e-5f * altitud, 5.25588f);
+}
+
+
+/***************************************************************************************
+**  Nombre:         float temperaturaFisica(void)
+**  Descripcion:    Temperatura segun la atmosfera estandar
+**  Parametros:     Ninguno
+**  Retorno:        Temperatura en ºC
+****************************************************************************************/
+float temperaturaFisica(void)
+{
+    const float altitud = param.altitudOrigen - estado.posicion[2];
+    return 15.0f - 0.0065f * altitud;
+}
+
+
+/***************************************************************************************
+**  Nombre:         void posicionGeodesicaFisica(double *lat, double *lon, float *alt)
+**  Descripcion:    Posicion geodesica aproximando la tierra plana alrededor del origen
+**  Parametros:     Latitud y longitud en º, altitud en m
+**  Retorno:        Ninguno
+****************************************************************************************/
+void posicionGeodesicaFisica(double *lat, double *lon, float *alt)
+{
+    const double rad = 3.14159265358979 / 180.0;
+
+    *lat = param.latitudOrigen + (estado.posicion[0] / RADIO_TIERRA_FISICA) / rad;
+    *lon = param.longitudOrigen + (estado.posicion[1] / (RADIO_TIERRA_FISICA * cos(param.latitudOrigen * rad))) / rad;
+    *alt = param.altitudOrigen - estado.posicion[2];
+}
+
+
+/***************************************************************************************
+**  Nombre:         void eulerFisica(float *euler)
+**  Descripcion:    Angulos de Euler reales del vehiculo
+**  Parametros:     Roll, pitch y yaw en º
+**  Retorno:        Ninguno
+****************************************************************************************/
+void eulerFisica(float *euler)
+{
+    const float *q = estado.q;
+
+    euler[0] = atan2f(2 * (q[0] * q[1] + q[2] * q[3]), 1 - 2 * (q[1] * q[1] + q[2] * q[2])) * 180.0f / PI_FISICA;
+    euler[1] = asinf(limitarFloat(2 * (q[0] * q[2] - q[3] * q[1]), -1.0f, 1.0f)) * 180.0f / PI_FISICA;
+    euler[2] = atan2f(2 * (q[0] * q[3] + q[1] * q[2]), 1 - 2 * (q[2] * q[2] + q[3] * q[3])) * 180.0f / PI_FISICA;
+}
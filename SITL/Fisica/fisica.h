@@ -0,0 +1,96 @@
+/***************************************************************************************
+**  fisica.h - Modelo fisico simplificado de un cuadricoptero en X para el SITL
+**
+**
+**  Este fichero forma parte del proyecto URpilot.
+**  Codigo desarrollado por el grupo de investigacion ICON de la Universidad de La Rioja
+**
+**  Autor: Ramon Rico
+**  Fecha de creacion: 17/10/2026
+**  Fecha de modificacion: 17/10/2026
+**
+**  El proyecto URpilot NO es libre. No se puede distribuir y/o modificar este fichero
+**  bajo ningun concepto.
+**
+**  En caso de modificacion y/o solicitud de informacion pongase en contacto con
+**  el grupo de investigacion ICON a traves de: www.unirioja.es/urpilot
+**
+**
+**  Control de versiones del fichero
+**
+**  v1.0  Ramon Rico. Se ha liberado la primera version estable
+**
+****************************************************************************************/
+
+#ifndef __FISICA_H
+#define __FISICA_H
+
+/***************************************************************************************
+** AREA DE INCLUDES                                                                   **
+****************************************************************************************/
+#include <stdint.h>
+#include <stdbool.h>
+
+
+/***************************************************************************************
+** AREA DE PREPROCESADOR                                                              **
+****************************************************************************************/
+#define NUM_MOTORES_FISICA          4
+#define PASO_FISICA_US              100        // Paso fijo de integracion
+
+
+/***************************************************************************************
+** AREA DE DEFINICION DE TIPOS                                                        **
+****************************************************************************************/
+typedef struct {
+    float masa;                               // kg
+    float inercia[3];                         // kg·m² (diagonal)
+    float brazo;                              // Distancia del centro a cada motor en m
+    float empujeMax;                          // Empuje de cada motor con salida 1 en N
+    float kPar;                               // Relacion par / empuje de la helice en m
+    float tauMotor;                           // Constante de tiempo del motor en s
+    float kArrastre;                          // Arrastre lineal en N/(m/s)
+    float kArrastreRot;                       // Arrastre rotacional en N·m/(rad/s)
+    float parPerturbacion[3];                 // Par constante (p.e. CG desplazado) en N·m
+    double latitudOrigen;                     // º
+    double longitudOrigen;                    // º
+    float altitudOrigen;                      // m sobre el nivel del mar
+    float campoMagNED[3];                     // mGa
+} paramFisica_t;
+
+typedef struct {
+    float posicion[3];                        // NED en m
+    float velocidad[3];                       // NED en m/s
+    float aceleracion[3];                     // NED en m/s² sin gravedad
+    float q[4];                               // Cuerpo a NED
+    float velAngular[3];                      // Cuerpo en rad/s
+    float empuje[NUM_MOTORES_FISICA];         // N
+    bool enSuelo;
+    uint64_t tiempo;                          // us
+} estadoFisica_t;
+
+
+/***************************************************************************************
+** AREA DE DECLARACION DE VARIABLES                                                   **
+****************************************************************************************/
+
+
+/***************************************************************************************
+** AREA DE PROTOTIPOS DE FUNCION                                                      **
+****************************************************************************************/
+void iniciarFisica(void);
+paramFisica_t *paramFisica(void);
+const estadoFisica_t *estadoFisica(void);
+void ajustarActitudFisica(float roll, float pitch, float yaw);
+void actualizarFisica(uint64_t tiempoUs);
+float ruidoFisica(float amplitud);
+
+void acelCuerpoFisica(float *acel);
+void giroCuerpoFisica(float *giro);
+void campoMagCuerpoFisica(float *campo);
+float presionFisica(void);
+float temperaturaFisica(void);
+void posicionGeodesicaFisica(double *lat, double *lon, float *alt);
+void eulerFisica(float *euler);
+
+#endif // __FISICA_H
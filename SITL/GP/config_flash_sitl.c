@@ -0,0 +1,404 @@
+/***************************************************************************************
+**  config_flash_sitl.c - Pruebas del log de configuracion en la flash emulada
+**
+**
+**  Este fichero forma parte del proyecto URpilot.
+**  Codigo desarrollado por el grupo de investigacion ICON de la Universidad de La Rioja
+**
+**  Autor: Ramon Rico
+**  Fecha de creacion: 17/10/2026
+**  Fecha de modificacion: 17/10/2026
+**
+**  El proyecto URpilot NO es libre. No se puede distribuir y/o modificar este fichero
+**  bajo ningun concepto.
+**
+**  En caso de modificacion y/o solicitud de informacion pongase en contacto con
+**  el grupo de investigacion ICON a traves de: www.unirioja.es/urpilot
+**
+**
+**  Control de versiones del fichero
+**
+**  v1.0  Ramon Rico. Se ha liberado la primera version estable
+**
+****************************************************************************************/
+
+/***************************************************************************************
+** AREA DE INCLUDES                                                                   **
+****************************************************************************************/
+#include <stdio.h>
+#include <string.h>
+
+#include "Core/pruebas_sitl.h"
+#include "GP/gp.h"
+#include "GP/config_flash.h"
+#include "Drivers/flash_sitl.h"
+
+
+/***************************************************************************************
+** AREA DE PREPROCESADOR                                                              **
+****************************************************************************************/
+#define TAM_MAX_GP_SITL                 8192        // Suma de los tamanios de todos los GP
+#define TAM_CABECERA_REGISTRO_SITL      12          // configRegistro_t
+#define NUM_GP_CAMBIADOS_SITL           3           // GP modificados en el guardado incremental
+#define MAX_GUARDADOS_BORRADO_SITL      100000
+#define MIN_GUARDADOS_BORRADO_SITL      100
+#define VALOR_BASURA_GP_SITL            0x5A
+
+
+/***************************************************************************************
+** AREA DE DEFINICION DE TIPOS                                                        **
+****************************************************************************************/
+typedef struct {
+    uint32_t cortes;
+    uint32_t gpMezclados;                       // GP que no tienen ni el valor anterior ni el nuevo
+    uint32_t errorRecuperacion;                 // El guardado posterior al corte no deja los valores nuevos
+} resultadoCortesConfigSITL_t;
+
+
+/***************************************************************************************
+** AREA DE DECLARACION DE VARIABLES                                                   **
+****************************************************************************************/
+static uint8_t copiaInicialGPsitl[TAM_MAX_GP_SITL];
+static uint8_t valoresAnterioresGPsitl[TAM_MAX_GP_SITL];
+static uint8_t valoresNuevosGPsitl[TAM_MAX_GP_SITL];
+static uint8_t imagenFlashSITL[TAM_FLASH_SITL];
+static uint32_t semillaConfigSITL;
+
+
+/***************************************************************************************
+** AREA DE PROTOTIPOS DE FUNCION                                                      **
+****************************************************************************************/
+uint32_t aleatorioConfigSITL(void);
+uint32_t copiarGPsitl(uint8_t *copia);
+void restaurarGPsitl(const uint8_t *copia);
+uint32_t gpDistintosSITL(const uint8_t *copia);
+uint32_t gpMezcladosSITL(void);
+uint32_t tamRegistrosGPsitl(void);
+const registroGP_t *gpAleatorioSITL(void);
+void modificarGPsitl(const registroGP_t *reg);
+void reiniciarConfigSITL(void);
+uint32_t medirGuardadosPorBorradoSITL(uint32_t *tamMedio);
+void probarCortesGuardadoSITL(bool compactar, resultadoCortesConfigSITL_t *resultado);
+
+
+/***************************************************************************************
+** AREA DE DEFINICION DE FUNCIONES                                                    **
+****************************************************************************************/
+
+/***************************************************************************************
+**  Nombre:         uint32_t aleatorioConfigSITL(void)
+**  Descripcion:    Generador xorshift reproducible
+**  Parametros:     Ninguno
+**  Retorno:        Numero aleatorio
+****************************************************************************************/
+uint32_t aleatorioConfigSITL(void)
+{
+    semillaConfigSITL ^= semillaConfigSITL << 13;
+    semillaConfigSITL ^= semillaConfigSITL >> 17;
+    semillaConfigSITL ^= semillaConfigSITL << 5;
+    return semillaConfigSITL;
+}
+
+
+/***************************************************************************************
+**  Nombre:         uint32_t copiarGPsitl(uint8_t *copia)
+**  Descripcion:    Copia la RAM de todos los GP seguidos
+**  Parametros:     Copia de TAM_MAX_GP_SITL bytes. Puede ser NULL para solo medir
+**  Retorno:        Bytes de todos los GP
+****************************************************************************************/
+uint32_t copiarGPsitl(uint8_t *copia)
+{
+    uint32_t offset = 0;
+
+    POR_CADA_GP(reg) {
+        if (copia != NULL && offset + tamanioGP(reg) <= TAM_MAX_GP_SITL)
+            memcpy(&copia[offset], reg->dir, tamanioGP(reg));
+        offset += tamanioGP(reg);
+    }
+
+    return offset;
+}
+
+
+/***************************************************************************************
+**  Nombre:         void restaurarGPsitl(const uint8_t *copia)
+**  Descripcion:    Vuelve a poner en la RAM de los GP una copia
+**  Parametros:     Copia
+**  Retorno:        Ninguno
+****************************************************************************************/
+void restaurarGPsitl(const uint8_t *copia)
+{
+    uint32_t offset = 0;
+
+    POR_CADA_GP(reg) {
+        memcpy(reg->dir, &copia[offset], tamanioGP(reg));
+        offset += tamanioGP(reg);
+    }
+}
+
+
+/***************************************************************************************
+**  Nombre:         uint32_t gpDistintosSITL(const uint8_t *copia)
+**  Descripcion:    Cuenta los GP cuya RAM no coincide con una copia
+**  Parametros:     Copia
+**  Retorno:        Numero de GP distintos
+****************************************************************************************/
+uint32_t gpDistintosSITL(const uint8_t *copia)
+{
+    uint32_t offset = 0, distintos = 0;
+
+    POR_CADA_GP(reg) {
+        if (memcmp(reg->dir, &copia[offset], tamanioGP(reg)) != 0)
+            distintos++;
+        offset += tamanioGP(reg);
+    }
+
+    return distintos;
+}
+
+
+/***************************************************************************************
+**  Nombre:         uint32_t gpMezcladosSITL(void)
+**  Descripcion:    Cuenta los GP que no tienen ni el valor anterior ni el nuevo completos
+**  Parametros:     Ninguno
+**  Retorno:        Numero de GP mezclados
+****************************************************************************************/
+uint32_t gpMezcladosSITL(void)
+{
+    uint32_t offset = 0, mezclados = 0;
+
+    POR_CADA_GP(reg) {
+        if (memcmp(reg->dir, &valoresAnterioresGPsitl[offset], tamanioGP(reg)) != 0 &&
+            memcmp(reg->dir, &valoresNuevosGPsitl[offset], tamanioGP(reg)) != 0)
+            mezclados++;
+        offset += tamanioGP(reg);
+    }
+
+    return mezclados;
+}
+
+
+/***************************************************************************************
+**  Nombre:         uint32_t tamRegistrosGPsitl(void)
+**  Descripcion:    Bytes que ocupa en la flash un registro de cada GP
+**  Parametros:     Ninguno
+**  Retorno:        Bytes
+****************************************************************************************/
+uint32_t tamRegistrosGPsitl(void)
+{
+    uint32_t tam = 0;
+
+    POR_CADA_GP(reg)
+        tam += (TAM_CABECERA_REGISTRO_SITL + tamanioGP(reg) + 3) & ~3;
+
+    return tam;
+}
+
+
+/***************************************************************************************
+**  Nombre:         const registroGP_t *gpAleatorioSITL(void)
+**  Descripcion:    Elige un GP con datos al azar
+**  Parametros:     Ninguno
+**  Retorno:        GP
+****************************************************************************************/
+const registroGP_t *gpAleatorioSITL(void)
+{
+    const uint32_t numGP = _eregistroGP - _sregistroGP;
+    const registroGP_t *reg;
+
+    do {
+        reg = &_sregistroGP[aleatorioConfigSITL() % numGP];
+    } while (tamanioGP(reg) == 0);
+
+    return reg;
+}
+
+
+/***************************************************************************************
+**  Nombre:         void modificarGPsitl(const registroGP_t *reg)
+**  Descripcion:    Cambia un bit al azar de la RAM de un GP
+**  Parametros:     GP
+**  Retorno:        Ninguno
+****************************************************************************************/
+void modificarGPsitl(const registroGP_t *reg)
+{
+    reg->dir[aleatorioConfigSITL() % tamanioGP(reg)] ^= 1 << (aleatorioConfigSITL() % 8);
+}
+
+
+/***************************************************************************************
+**  Nombre:         void reiniciarConfigSITL(void)
+**  Descripcion:    Simula el arranque: la RAM de los GP se pierde y se carga de la flash
+**  Parametros:     Ninguno
+**  Retorno:        Ninguno
+****************************************************************************************/
+void reiniciarConfigSITL(void)
+{
+    POR_CADA_GP(reg)
+        memset(reg->dir, VALOR_BASURA_GP_SITL, tamanioGP(reg));
+
+    iniciarConfigFlash();
+    cargarConfigFlash();
+}
+
+
+/***************************************************************************************
+**  Nombre:         uint32_t medirGuardadosPorBorradoSITL(uint32_t *tamMedio)
+**  Descripcion:    Guarda cambios de un solo GP hasta que hace falta borrar un sector
+**  Parametros:     Bytes medios de flash por guardado
+**  Retorno:        Numero de guardados antes del borrado
+****************************************************************************************/
+uint32_t medirGuardadosPorBorradoSITL(uint32_t *tamMedio)
+{
+    estadisticasFlashSITL_t inicio, actual;
+    estadisticasConfigFlash_t config;
+    uint32_t guardados = 0, bytesLibresInicio, bytesLibresPrevios;
+
+    estadisticasFlashSITL(&inicio);
+    estadisticasConfigFlash(&config);
+    bytesLibresInicio = bytesLibresPrevios = config.bytesLibres;
+
+    while (guardados < MAX_GUARDADOS_BORRADO_SITL) {
+        modificarGPsitl(gpAleatorioSITL());
+        guardarConfigFlash();
+
+        estadisticasFlashSITL(&actual);
+        if (actual.numBorrados != inicio.numBorrados)
+            break;
+
+        estadisticasConfigFlash(&config);
+        bytesLibresPrevios = config.bytesLibres;
+        guardados++;
+    }
+
+    *tamMedio = guardados > 0 ? (bytesLibresInicio - bytesLibresPrevios) / guardados : 0;
+    return guardados;
+}
+
+
+/***************************************************************************************
+**  Nombre:         void probarCortesGuardadoSITL(bool compactar, resultadoCortesConfigSITL_t *resultado)
+**  Descripcion:    Corta la alimentacion en cada paso de un guardado. Tras cada corte se
+**                  arranca de nuevo, cada GP debe tener su valor anterior o el nuevo y el
+**                  siguiente guardado debe dejar los valores nuevos
+**  Parametros:     Con compactar se llena antes el banco y se cambian todos los GP para que el
+**                  guardado anada registros y compacte, resultado
+**  Retorno:        Ninguno
+****************************************************************************************/
+void probarCortesGuardadoSITL(bool compactar, resultadoCortesConfigSITL_t *resultado)
+{
+    estadisticasConfigFlash_t config;
+
+    memset(resultado, 0, sizeof(*resultado));
+
+    if (compactar) {
+        estadisticasConfigFlash(&config);
+        while (config.bytesLibres >= tamRegistrosGPsitl()) {
+            modificarGPsitl(gpAleatorioSITL());
+            guardarConfigFlash();
+            estadisticasConfigFlash(&config);
+        }
+    }
+
+    copiarGPsitl(valoresAnterioresGPsitl);
+    leerImagenFlashSITL(imagenFlashSITL);
+
+    if (compactar) {
+        POR_CADA_GP(reg) {
+            if (tamanioGP(reg) > 0)
+                modificarGPsitl(reg);
+        }
+    }
+    else {
+        for (uint8_t i = 0; i < NUM_GP_CAMBIADOS_SITL; i++)
+            modificarGPsitl(gpAleatorioSITL());
+    }
+
+    copiarGPsitl(valoresNuevosGPsitl);
+
+    for (uint32_t corte = 0; ; corte++) {
+        escribirImagenFlashSITL(imagenFlashSITL);
+        reiniciarConfigSITL();
+        restaurarGPsitl(valoresNuevosGPsitl);
+
+        programarCorteFlashSITL(corte);
+        const bool guardado = guardarConfigFlash();
+
+        if (!sinAlimentacionFlashSITL()) {
+            // El guardado ha terminado antes del corte: ya se han probado todos los pasos
+            restaurarAlimentacionFlashSITL();
+            reiniciarConfigSITL();
+            if (!guardado || gpDistintosSITL(valoresNuevosGPsitl) != 0)
+                resultado->errorRecuperacion++;
+            break;
+        }
+
+        restaurarAlimentacionFlashSITL();
+        resultado->cortes++;
+
+        reiniciarConfigSITL();
+        resultado->gpMezclados += gpMezcladosSITL();
+
+        restaurarGPsitl(valoresNuevosGPsitl);
+        const bool recuperado = guardarConfigFlash();
+        reiniciarConfigSITL();
+        if (!recuperado || gpDistintosSITL(valoresNuevosGPsitl) != 0)
+            resultado->errorRecuperacion++;
+    }
+}
+
+
+/***************************************************************************************
+**  Nombre:         void probarConfigFlashSITL(void)
+**  Descripcion:    Mide los guardados que caben antes de borrar y prueba los cortes de
+**                  alimentacion en un guardado incremental y en una compactacion
+**  Parametros:     Ninguno
+**  Retorno:        Ninguno
+****************************************************************************************/
+void probarConfigFlashSITL(void)
+{
+    resultadoCortesConfigSITL_t incremental, compactacion;
+    estadisticasConfigFlash_t config;
+    estadisticasFlashSITL_t flash;
+    uint32_t tamMedio;
+
+    printf("\nLog de configuracion en la flash (SITL)\n");
+
+    const uint32_t tamGP = copiarGPsitl(NULL);
+    if (tamGP > TAM_MAX_GP_SITL) {
+        printf("  Los GP ocupan %u bytes, mas que la copia de la prueba\n", tamGP);
+        printf("  Resultado: fallo\n");
+        return;
+    }
+
+    copiarGPsitl(copiaInicialGPsitl);
+    semillaConfigSITL = 0x6C078965;
+    iniciarFlashSITL(0x9E3779B9);
+
+    // Primer arranque con la flash borrada: se escriben los valores por defecto
+    reiniciarConfigSITL();
+    const bool arranque = versionValidaConfigFlash();
+
+    const uint32_t guardados = medirGuardadosPorBorradoSITL(&tamMedio);
+    probarCortesGuardadoSITL(false, &incremental);
+    probarCortesGuardadoSITL(true, &compactacion);
+
+    estadisticasConfigFlash(&config);
+    estadisticasFlashSITL(&flash);
+
+    printf("  GP: %u bytes, copia completa %u bytes | guardados de un GP antes de borrar: %u (%u bytes por guardado)\n",
+           tamGP, tamRegistrosGPsitl(), guardados, tamMedio);
+    printf("  Cortes en guardado incremental: %u, en compactacion: %u | GP mezclados %u, errores de recuperacion %u\n",
+           incremental.cortes, compactacion.cortes, incremental.gpMezclados + compactacion.gpMezclados,
+           incremental.errorRecuperacion + compactacion.errorRecuperacion);
+    printf("  Flash: %u borrados, %u words, %u violaciones de programacion | guardados %u, registros %u, compactaciones %u\n",
+           flash.numBorrados, flash.numWords, flash.numViolaciones, config.numGuardados, config.numRegistrosEscritos,
+           config.numCompactaciones);
+
+    const bool ok = arranque && guardados >= MIN_GUARDADOS_BORRADO_SITL && incremental.cortes > 0 && compactacion.cortes > 0 &&
+                    incremental.gpMezclados == 0 && compactacion.gpMezclados == 0 && incremental.errorRecuperacion == 0 &&
+                    compactacion.errorRecuperacion == 0 && flash.numViolaciones == 0;
+
+    restaurarGPsitl(copiaInicialGPsitl);
+    printf("  Resultado: %s\n", ok ? "ok" : "fallo");
+}
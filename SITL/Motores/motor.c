@@ -0,0 +1,316 @@
+/***************************************************************************************
+**  motor.c - Funciones de los motores para el SITL. Los valores escritos se guardan
+**            para que los lea el modelo fisico
+**
+**
+**  Este fichero forma parte del proyecto URpilot.
+**  Codigo desarrollado por el grupo de investigacion ICON de la Universidad de La Rioja
+**
+**  Autor: Ramon Rico
+**  Fecha de creacion: 17/10/2026
+**  Fecha de modificacion: 17/10/2026
+**
+**  El proyecto URpilot NO es libre. No se puede distribuir y/o modificar este fichero
+**  bajo ningun concepto.
+**
+**  En caso de modificacion y/o solicitud de informacion pongase en contacto con
+**  el grupo de investigacion ICON a traves de: www.unirioja.es/urpilot
+**
+**
+**  Control de versiones del fichero
+**
+**  v1.0  Ramon Rico. Se ha liberado la primera version estable
+**
+****************************************************************************************/
+
+/***************************************************************************************
+** AREA DE INCLUDES                                                                   **
+****************************************************************************************/
+#include <string.h>
+#include <math.h>
+
+#include "Motores/motor.h"
+
+#ifdef USAR_MOTORES
+#include "motor_sitl.h"
+#include "GP/gp_motor.h"
+#include "FC/mixer.h"
+#include "Comun/matematicas.h"
+#include "Motores/dshot_telemetria.h"
+#include "Fisica/fisica.h"
+
+
+/***************************************************************************************
+** AREA DE PREPROCESADOR                                                              **
+****************************************************************************************/
+#define RPM_MAX_MOTOR_SITL                30000       // RPM con empuje maximo
+#define TICKS_BIT_TELEMETRIA_SITL         16          // Dshot600 con el timer a 12 MHz
+#define CAPTURAS_POR_ERROR_SITL           97          // Una respuesta de cada 97 llega corrupta. Primo para repartirlas entre motores
+
+
+/***************************************************************************************
+** AREA DE DEFINICION DE TIPOS                                                        **
+****************************************************************************************/
+
+
+/***************************************************************************************
+** AREA DE DECLARACION DE VARIABLES                                                   **
+****************************************************************************************/
+static motor_t motor[NUM_MAX_MOTORES];
+static float valorMotor[NUM_MAX_MOTORES];         // Valor escrito entre 0 y 1
+static float salidaMotor[NUM_MAX_MOTORES];        // Valor que ve el modelo tras actualizarMotores
+static bool motoresHabilitados = false;
+static bool motoresIniciados = false;
+static telemetriaDshot_t telemetriaMotor[NUM_MAX_MOTORES];
+static uint32_t numCapturasSITL;
+
+
+/***************************************************************************************
+** AREA DE PROTOTIPOS DE FUNCION                                                      **
+****************************************************************************************/
+
+
+/***************************************************************************************
+** AREA DE DEFINICION DE FUNCIONES                                                    **
+****************************************************************************************/
+
+/***************************************************************************************
+**  Nombre:         bool iniciarMotores(void)
+**  Descripcion:    Inicia los Motores
+**  Parametros:     Ninguno
+**  Retorno:        True si ok
+****************************************************************************************/
+bool iniciarMotores(void)
+{
+    memset(motor, 0, sizeof(motor));
+    memset(valorMotor, 0, sizeof(valorMotor));
+    memset(salidaMotor, 0, sizeof(salidaMotor));
+    memset(telemetriaMotor, 0, sizeof(telemetriaMotor));
+
+    for (uint8_t i = 0; i < configMotor()->numMotores && i < NUM_MAX_MOTORES; i++)
+        motor[i].habilitado = true;
+
+    motoresIniciados = true;
+    return true;
+}
+
+
+/***************************************************************************************
+**  Nombre:         void deshabilitarMotores(void)
+**  Descripcion:    Deshabilita los motores
+**  Parametros:     Ninguno
+**  Retorno:        Ninguno
+****************************************************************************************/
+void deshabilitarMotores(void)
+{
+    memset(valorMotor, 0, sizeof(valorMotor));
+    memset(salidaMotor, 0, sizeof(salidaMotor));
+    motoresHabilitados = false;
+}
+
+
+/***************************************************************************************
+**  Nombre:         void habilitarMotores(void)
+**  Descripcion:    Habilita los motores
+**  Parametros:     Ninguno
+**  Retorno:        Ninguno
+****************************************************************************************/
+void habilitarMotores(void)
+{
+    motoresHabilitados = motoresIniciados;
+}
+
+
+/***************************************************************************************
+**  Nombre:         bool estanMotoresHabilitados(void)
+**  Descripcion:    Comprueba si los motores estan habilitados
+**  Parametros:     Ninguno
+**  Retorno:        True si habilitados
+****************************************************************************************/
+bool estanMotoresHabilitados(void)
+{
+    return motoresHabilitados;
+}
+
+
+/***************************************************************************************
+**  Nombre:         bool estaMotorHabilitado(uint8_t numMotor)
+**  Descripcion:    Comprueba si un motor dado esta habilitado
+**  Parametros:     Motor a comprobar
+**  Retorno:        True si habilitado
+****************************************************************************************/
+bool estaMotorHabilitado(uint8_t numMotor)
+{
+    return motor[numMotor].habilitado;
+}
+
+
+/***************************************************************************************
+**  Nombre:         motor_t *motores(void)
+**  Descripcion:    Retorna la direccion de la varible motores
+**  Parametros:     Ninguno
+**  Retorno:        Direccion de la variable
+****************************************************************************************/
+motor_t *motores(void)
+{
+    return motor;
+}
+
+
+/***************************************************************************************
+**  Nombre:         bool esProtocoloMotorDshot(void)
+**  Descripcion:    Retorna si el protocolo es dshot
+**  Parametros:     Ninguno
+**  Retorno:        True si dshot
+****************************************************************************************/
+bool esProtocoloMotorDshot(void)
+{
+    return false;
+}
+
+
+/***************************************************************************************
+**  Nombre:         bool telemetriaRPMmotoresHabilitada(void)
+**  Descripcion:    Comprueba si los ESC envian la velocidad de giro. En el SITL se emula el dshot
+**                  bidireccional
+**  Parametros:     Ninguno
+**  Retorno:        True si hay telemetria de velocidad
+****************************************************************************************/
+bool telemetriaRPMmotoresHabilitada(void)
+{
+    return true;
+}
+
+
+/***************************************************************************************
+**  Nombre:         bool frecGiroMotor(uint8_t indice, float *frec)
+**  Descripcion:    Obtiene la frecuencia de giro de un motor. La velocidad del modelo fisico se codifica
+**                  como la respuesta de un ESC y se pasa por el decodificador del firmware
+**  Parametros:     Motor, frecuencia en Hz
+**  Retorno:        False si no hay telemetria valida del motor
+****************************************************************************************/
+bool frecGiroMotor(uint8_t indice, float *frec)
+{
+    *frec = 0;
+    if (indice >= NUM_MOTORES_FISICA || indice >= numMotores())
+        return false;
+
+    // El empuje es proporcional al cuadrado de la velocidad
+    const float empuje = estadoFisica()->empuje[indice];
+    const float rpm = empuje > 0 ? RPM_MAX_MOTOR_SITL * sqrtf(empuje / paramFisica()->empujeMax) : 0;
+    const uint32_t tiempo = (uint32_t)estadoFisica()->tiempo;
+    uint32_t flancos[TAM_BUFFER_CAPTURA_DSHOT];
+
+    const uint8_t numFlancos = codificarFlancosDshot(rpm * configMotor()->polosMotor / 2, TICKS_BIT_TELEMETRIA_SITL, tiempo, flancos);
+    if (++numCapturasSITL % CAPTURAS_POR_ERROR_SITL == 0)
+        flancos[numFlancos / 2] += TICKS_BIT_TELEMETRIA_SITL;
+
+    actualizarTelemetriaDshot(&telemetriaMotor[indice], flancos, numFlancos, TICKS_BIT_TELEMETRIA_SITL, tiempo);
+    if (telemetriaMotor[indice].numTramas == 0)
+        return false;
+
+    *frec = frecTelemetriaDshot(&telemetriaMotor[indice], configMotor()->polosMotor);
+    return true;
+}
+
+
+/***************************************************************************************
+**  Nombre:         void escribirMotor(uint8_t indice, float valor)
+**  Descripcion:    Escribe un valor en un motor
+**  Parametros:     Motor a escribir, valor
+**  Retorno:        Ninguno
+****************************************************************************************/
+void escribirMotor(uint8_t indice, float valor)
+{
+	if (estanMotoresHabilitados() && indice < NUM_MAX_MOTORES)
+        valorMotor[indice] = limitarFloat(valor, 0.0f, 1.0f);
+}
+
+
+/***************************************************************************************
+**  Nombre:         void escribirMotores(float *valor)
+**  Descripcion:    Escribe un valor en todos los motores
+**  Parametros:     Valor a escribir
+**  Retorno:        Ninguno
+****************************************************************************************/
+void escribirMotores(float *valor)
+{
+    if (estanMotoresHabilitados()) {
+        uint8_t numeroMotores = numMotores();
+        for (uint8_t i = 0; i < numeroMotores; i++)
+    	    escribirMotor(i, valor[i]);
+
+        actualizarMotores();
+    }
+}
+
+
+/***************************************************************************************
+**  Nombre:         void escribirValorTodosMotores(float valor)
+**  Descripcion:    Escribe un valor en todos los motores
+**  Parametros:     Valor a escribir
+**  Retorno:        Ninguno
+****************************************************************************************/
+void escribirValorTodosMotores(float valor)
+{
+    if (estanMotoresHabilitados()) {
+        uint8_t numeroMotores = numMotores();
+        for (uint8_t i = 0; i < numeroMotores; i++)
+    	    escribirMotor(i, valor);
+
+        actualizarMotores();
+    }
+}
+
+
+/***************************************************************************************
+**  Nombre:         void actualizarMotores(void)
+**  Descripcion:    Hace visibles al modelo los valores escritos
+**  Parametros:     Ninguno
+**  Retorno:        Ninguno
+****************************************************************************************/
+void actualizarMotores(void)
+{
+    memcpy(salidaMotor, valorMotor, sizeof(salidaMotor));
+}
+
+
+/***************************************************************************************
+**  Nombre:         float salidaMotorSITL(uint8_t indice)
+**  Descripcion:    Retorna la salida de un motor para el modelo fisico
+**  Parametros:     Motor
+**  Retorno:        Valor entre 0 y 1
+****************************************************************************************/
+float salidaMotorSITL(uint8_t indice)
+{
+    if (!motoresHabilitados || indice >= NUM_MAX_MOTORES)
+        return 0.0f;
+
+    return salidaMotor[indice];
+}
+
+
+/***************************************************************************************
+**  Nombre:         uint8_t numMotoresSITL(void)
+**  Descripcion:    Retorna el numero de motores configurados
+**  Parametros:     Ninguno
+**  Retorno:        Numero de motores
+****************************************************************************************/
+uint8_t numMotoresSITL(void)
+{
+    return numMotores();
+}
+
+
+/***************************************************************************************
+**  Nombre:         const telemetriaDshot_t *telemetriaMotorSITL(uint8_t indice)
+**  Descripcion:    Retorna la telemetria emulada de un motor
+**  Parametros:     Motor
+**  Retorno:        Puntero a la telemetria
+****************************************************************************************/
+const telemetriaDshot_t *telemetriaMotorSITL(uint8_t indice)
+{
+    return &telemetriaMotor[indice];
+}
+
+#endif
@@ -0,0 +1,358 @@
+/***************************************************************************************
+**  pid_sitl.c - Respuesta de los PID contra un modelo sencillo de la planta
+**
+**
+**  Este fichero forma parte del proyecto URpilot.
+**  Codigo desarrollado por el grupo de investigacion ICON de la Universidad de La Rioja
+**
+**  Autor: Ramon Rico
+**  Fecha de creacion: 17/10/2026
+**  Fecha de modificacion: 17/10/2026
+**
+**  El proyecto URpilot NO es libre. No se puede distribuir y/o modificar este fichero
+**  bajo ningun concepto.
+**
+**  En caso de modificacion y/o solicitud de informacion pongase en contacto con
+**  el grupo de investigacion ICON a traves de: www.unirioja.es/urpilot
+**
+**
+**  Control de versiones del fichero
+**
+**  v1.0  Ramon Rico. Se ha liberado la primera version estable
+**
+****************************************************************************************/
+
+/***************************************************************************************
+** AREA DE INCLUDES                                                                   **
+****************************************************************************************/
+#include <stdio.h>
+#include <string.h>
+#include <math.h>
+
+#include "Core/pruebas_sitl.h"
+
+#ifdef SITL
+#include "PID/pid.h"
+#include "FC/control.h"
+#include "GP/gp_control.h"
+#include "GP/gp_fc.h"
+#include "Fisica/fisica.h"
+#include "Drivers/tiempo_sitl.h"
+#include "Comun/util.h"
+#include "Comun/matematicas.h"
+
+
+/***************************************************************************************
+** AREA DE PREPROCESADOR                                                              **
+****************************************************************************************/
+#define SUBPASOS_PLANTA_PID_SITL             10          // Pasos de integracion de la planta por ciclo del lazo
+#define DURACION_ESCALON_PID_SITL            1.5f        // s
+#define DURACION_SENO_PID_SITL               2.0f        // s
+#define BANDA_ESTABLECIMIENTO_PID_SITL       0.05f       // Fraccion de la referencia
+
+#define ESCALON_ACTITUD_PID_SITL             10.0f       // º
+#define ESCALON_YAW_PID_SITL                 90.0f       // º/s
+#define ESCALON_PESO_SETPOINT_PID_SITL       90.0f       // º/s en el lazo de velocidad de roll
+#define ESCALON_SATURACION_PID_SITL          600.0f      // º/s
+#define LIM_SALIDA_SATURACION_PID_SITL       0.05f       // Accion maxima para saturar el lazo de velocidad
+#define AMPLITUD_SENO_PID_SITL               25.0f       // º/s
+#define FREC_SENO_PID_SITL                   2.0f        // Hz
+#define RUIDO_DERIVADA_PID_SITL              2000.0f     // º/s² en la derivada de la realimentacion
+#define PESO_SETPOINT_PRUEBA_PID_SITL        0.5f
+#define ESCALA_TPA_PRUEBA_PID_SITL           0.5f
+
+// Limites de la respuesta
+#define MAX_SOBREOSCILACION_ACTITUD_PID_SITL 20.0f       // %
+#define MAX_ESTABLECIMIENTO_ACTITUD_PID_SITL 1.0f        // s
+#define MAX_SOBREOSCILACION_YAW_PID_SITL     10.0f       // %
+#define MAX_ESTABLECIMIENTO_YAW_PID_SITL     0.5f        // s
+#define MAX_RELACION_MEJORA_PID_SITL         0.7f        // Fraccion del caso sin la mejora
+#define MAX_COSTE_PID_SITL_NS                500.0       // Por llamada en el host
+#define ITERACIONES_COSTE_PID_SITL           200000
+
+
+/***************************************************************************************
+** AREA DE DEFINICION DE TIPOS                                                        **
+****************************************************************************************/
+typedef struct {
+    float ganancia;                         // º/s² por unidad de accion de control
+    float amortiguamiento;                  // 1/s
+    float tauMotor;                         // s
+} plantaPIDsitl_t;
+
+typedef struct {
+    const paramPID_t *pVelAng;
+    const paramPID_t *pActitud;             // NULL para probar solo el lazo de velocidad angular
+    float amplitud;                         // º o º/s segun el lazo exterior
+    float frecSeno;                         // Hz. Con 0 la referencia es un escalon
+    float ruidoDerivada;                    // º/s²
+    float escalaTPA;
+    float duracion;                         // s
+} escenarioPIDsitl_t;
+
+typedef struct {
+    float sobreoscilacion;                  // %
+    float tiempoEstablecimiento;            // s
+    float errorRMS;
+    float accionRMS;                        // En la segunda mitad de la prueba
+} respuestaPIDsitl_t;
+
+
+/***************************************************************************************
+** AREA DE DECLARACION DE VARIABLES                                                   **
+****************************************************************************************/
+static volatile float sumideroPIDsitl;
+
+
+/***************************************************************************************
+** AREA DE PROTOTIPOS DE FUNCION                                                      **
+****************************************************************************************/
+void calcularPlantaPIDsitl(uint8_t eje, plantaPIDsitl_t *planta);
+void simularPIDsitl(const plantaPIDsitl_t *planta, const escenarioPIDsitl_t *escenario, respuestaPIDsitl_t *respuesta);
+double medirCostePIDsitl(const paramPID_t *param);
+
+
+/***************************************************************************************
+** AREA DE DEFINICION DE FUNCIONES                                                    **
+****************************************************************************************/
+
+/***************************************************************************************
+**  Nombre:         void calcularPlantaPIDsitl(uint8_t eje, plantaPIDsitl_t *planta)
+**  Descripcion:    Reduce el modelo fisico del SITL a un eje: motor de primer orden, inercia
+**                  y arrastre rotacional. El mixer de cuadricoptero X reparte la accion
+**                  entre los cuatro motores
+**  Parametros:     Eje, planta
+**  Retorno:        Ninguno
+****************************************************************************************/
+void calcularPlantaPIDsitl(uint8_t eje, plantaPIDsitl_t *planta)
+{
+    const paramFisica_t *fisica = paramFisica();
+    const float brazo = (eje == YAW) ? fisica->kPar : fisica->brazo * 0.70710678f;
+
+    planta->ganancia = NUM_MOTORES_FISICA * fisica->empujeMax * brazo / fisica->inercia[eje] * RADIANES_A_GRADOS;
+    planta->amortiguamiento = fisica->kArrastreRot / fisica->inercia[eje];
+    planta->tauMotor = fisica->tauMotor;
+}
+
+
+/***************************************************************************************
+**  Nombre:         void simularPIDsitl(const plantaPIDsitl_t *planta, const escenarioPIDsitl_t *escenario,
+**                                      respuestaPIDsitl_t *respuesta)
+**  Descripcion:    Cierra los lazos en cascada sobre la planta a las frecuencias del FC y mide
+**                  la respuesta de la salida del lazo exterior
+**  Parametros:     Planta, escenario, respuesta
+**  Retorno:        Ninguno
+****************************************************************************************/
+void simularPIDsitl(const plantaPIDsitl_t *planta, const escenarioPIDsitl_t *escenario, respuestaPIDsitl_t *respuesta)
+{
+    const float frecVelAng = configFC()->frecLazoVelAngular;
+    const float dt = 1.0f / frecVelAng;
+    const float h = dt / SUBPASOS_PLANTA_PID_SITL;
+    const uint32_t divisorActitud = MAX(1, configFC()->frecLazoVelAngular / configFC()->frecLazoActitud);
+    const uint32_t numCiclos = escenario->duracion * frecVelAng;
+    pid_t pidVelAng, pidActitud;
+    float velAngular = 0, angulo = 0, accionMotor = 0, acelAngular = 0, setPointVelAng = 0;
+    float maximo = 0, sumaError = 0, sumaAccion = 0;
+    uint32_t ultimoFueraBanda = 0;
+
+    iniciarPID(&pidVelAng, escenario->pVelAng, frecVelAng);
+    escalarGananciasPID(&pidVelAng, escenario->escalaTPA);
+    if (escenario->pActitud != NULL)
+        iniciarPID(&pidActitud, escenario->pActitud, frecVelAng / divisorActitud);
+
+    for (uint32_t i = 0; i < numCiclos; i++) {
+        float referencia = escenario->amplitud;
+        if (escenario->frecSeno > 0)
+            referencia *= sinf(DOS_PI * escenario->frecSeno * i * dt);
+
+        if (escenario->pActitud == NULL)
+            setPointVelAng = referencia;
+        else if (i % divisorActitud == 0)
+            setPointVelAng = actualizarPID(&pidActitud, referencia, angulo, velAngular, dt * divisorActitud, true);
+
+        const float derivada = acelAngular + ruidoFisica(escenario->ruidoDerivada);
+        const float accion = actualizarPID(&pidVelAng, setPointVelAng, velAngular, derivada, dt, true);
+
+        for (uint8_t j = 0; j < SUBPASOS_PLANTA_PID_SITL; j++) {
+            accionMotor += (accion - accionMotor) * h / (planta->tauMotor + h);
+            acelAngular = planta->ganancia * accionMotor - planta->amortiguamiento * velAngular;
+            velAngular += acelAngular * h;
+            angulo += velAngular * h;
+        }
+
+        // Respuesta del lazo exterior
+        const float salida = (escenario->pActitud == NULL) ? velAngular : angulo;
+        const float error = referencia - salida;
+
+        maximo = MAX(maximo, salida);
+        sumaError += error * error;
+        if (fabsf(error) > BANDA_ESTABLECIMIENTO_PID_SITL * fabsf(escenario->amplitud))
+            ultimoFueraBanda = i + 1;
+        if (i >= numCiclos / 2)
+            sumaAccion += accion * accion;
+    }
+
+    respuesta->sobreoscilacion = MAX(0.0f, (maximo - escenario->amplitud) / escenario->amplitud * 100.0f);
+    respuesta->tiempoEstablecimiento = ultimoFueraBanda * dt;
+    respuesta->errorRMS = sqrtf(sumaError / numCiclos);
+    respuesta->accionRMS = sqrtf(sumaAccion / (numCiclos - numCiclos / 2));
+}
+
+
+/***************************************************************************************
+**  Nombre:         double medirCostePIDsitl(const paramPID_t *param)
+**  Descripcion:    Mide el coste de una llamada a actualizarPID en el host
+**  Parametros:     Parametros del PID
+**  Retorno:        ns por llamada
+****************************************************************************************/
+double medirCostePIDsitl(const paramPID_t *param)
+{
+    pid_t pid;
+    float sensor = 0, suma = 0;
+
+    iniciarPID(&pid, param, configFC()->frecLazoVelAngular);
+
+    const uint64_t inicio = nanosegundosHostSITL();
+    for (uint32_t i = 0; i < ITERACIONES_COSTE_PID_SITL; i++) {
+        const float u = actualizarPID(&pid, (i & 0x400) ? 100.0f : -100.0f, sensor, suma, 0.001f, true);
+        sensor += u;
+        suma += u * 0.5f;
+    }
+    const uint64_t fin = nanosegundosHostSITL();
+
+    sumideroPIDsitl = sensor + suma;
+    return (double)(fin - inicio) / ITERACIONES_COSTE_PID_SITL;
+}
+
+
+/***************************************************************************************
+**  Nombre:         void probarPIDsitl(void)
+**  Descripcion:    Prueba los lazos con las ganancias del GP: escalones de actitud en roll y
+**                  pitch y de velocidad en yaw. Despues compara cada mejora con el mismo
+**                  lazo sin ella: anti-windup con la salida saturada, peso del setpoint,
+**                  feed-forward siguiendo un seno, filtro de la derivada con ruido y TPA
+**  Parametros:     Ninguno
+**  Retorno:        Ninguno
+****************************************************************************************/
+void probarPIDsitl(void)
+{
+    const char *nombreEje[] = { "roll", "pitch", "yaw" };
+    plantaPIDsitl_t planta[3];
+    respuestaPIDsitl_t escalon[3], con, sin;
+    bool ok = true;
+
+    printf("\nPID de los tres ejes contra el modelo de la planta (SITL)\n");
+
+    // Escalones con las ganancias del GP
+    for (uint8_t eje = 0; eje < 3; eje++) {
+        const bool actitud = eje != YAW;
+        const escenarioPIDsitl_t escenario = {
+            .pVelAng = &configPID()->pVelAng[eje],
+            .pActitud = actitud ? &configPID()->pActitud[eje] : NULL,
+            .amplitud = actitud ? ESCALON_ACTITUD_PID_SITL : ESCALON_YAW_PID_SITL,
+            .escalaTPA = 1.0f,
+            .duracion = DURACION_ESCALON_PID_SITL,
+        };
+
+        calcularPlantaPIDsitl(eje, &planta[eje]);
+        simularPIDsitl(&planta[eje], &escenario, &escalon[eje]);
+
+        const float maxSobreoscilacion = actitud ? MAX_SOBREOSCILACION_ACTITUD_PID_SITL : MAX_SOBREOSCILACION_YAW_PID_SITL;
+        const float maxEstablecimiento = actitud ? MAX_ESTABLECIMIENTO_ACTITUD_PID_SITL : MAX_ESTABLECIMIENTO_YAW_PID_SITL;
+        ok = ok && escalon[eje].sobreoscilacion <= maxSobreoscilacion && escalon[eje].tiempoEstablecimiento <= maxEstablecimiento;
+    }
+
+    for (uint8_t eje = 0; eje < 3; eje++)
+        printf("  Escalon de %.0f %s en %s: sobreoscilacion %.1f %%, establecimiento %.3f s\n",
+               eje != YAW ? ESCALON_ACTITUD_PID_SITL : ESCALON_YAW_PID_SITL, eje != YAW ? "º" : "º/s", nombreEje[eje],
+               escalon[eje].sobreoscilacion, escalon[eje].tiempoEstablecimiento);
+
+    // Anti-windup: el lazo de velocidad de roll con la salida saturada
+    paramPID_t param = configPID()->pVelAng[ROLL];
+    escenarioPIDsitl_t escenario = {
+        .pVelAng = &param,
+        .amplitud = ESCALON_SATURACION_PID_SITL,
+        .escalaTPA = 1.0f,
+        .duracion = DURACION_ESCALON_PID_SITL,
+    };
+
+    param.limSalida = LIM_SALIDA_SATURACION_PID_SITL;
+    simularPIDsitl(&planta[ROLL], &escenario, &con);
+    param.kAntiWindup = 0;
+    simularPIDsitl(&planta[ROLL], &escenario, &sin);
+    const bool antiWindupOk = con.sobreoscilacion <= sin.sobreoscilacion * MAX_RELACION_MEJORA_PID_SITL;
+    printf("  Salida saturada: sobreoscilacion %.1f %% con back-calculation, %.1f %% sin el\n", con.sobreoscilacion,
+           sin.sobreoscilacion);
+
+    // Peso del setpoint en la parte proporcional
+    param = configPID()->pVelAng[ROLL];
+    escenario.amplitud = ESCALON_PESO_SETPOINT_PID_SITL;
+    simularPIDsitl(&planta[ROLL], &escenario, &sin);
+    param.pesoSetpoint = PESO_SETPOINT_PRUEBA_PID_SITL;
+    simularPIDsitl(&planta[ROLL], &escenario, &con);
+    const bool pesoOk = con.sobreoscilacion <= sin.sobreoscilacion * MAX_RELACION_MEJORA_PID_SITL;
+    printf("  Peso del setpoint %.1f: sobreoscilacion %.1f %% (%.1f %% con peso 1) | establecimiento %.3f s (%.3f s)\n",
+           PESO_SETPOINT_PRUEBA_PID_SITL, con.sobreoscilacion, sin.sobreoscilacion, con.tiempoEstablecimiento,
+           sin.tiempoEstablecimiento);
+
+    // Feed-forward: el inverso de la ganancia de la planta sigue un seno en yaw
+    param = configPID()->pVelAng[YAW];
+    escenario.amplitud = AMPLITUD_SENO_PID_SITL;
+    escenario.frecSeno = FREC_SENO_PID_SITL;
+    escenario.duracion = DURACION_SENO_PID_SITL;
+    simularPIDsitl(&planta[YAW], &escenario, &sin);
+    param.kff = 1.0f / planta[YAW].ganancia;
+    simularPIDsitl(&planta[YAW], &escenario, &con);
+    const bool feedForwardOk = con.errorRMS <= sin.errorRMS * MAX_RELACION_MEJORA_PID_SITL;
+    printf("  Seno de %.0f º/s a %.0f Hz en yaw: error RMS %.2f º/s con feed-forward, %.2f º/s sin el\n",
+           AMPLITUD_SENO_PID_SITL, FREC_SENO_PID_SITL, con.errorRMS, sin.errorRMS);
+
+    // Filtro de la derivada: ruido en la derivada de la realimentacion con referencia nula
+    param = configPID()->pVelAng[PITCH];
+    escenario.amplitud = 0;
+    escenario.frecSeno = 0;
+    escenario.ruidoDerivada = RUIDO_DERIVADA_PID_SITL;
+    simularPIDsitl(&planta[PITCH], &escenario, &con);
+    param.frecCorteD = 0;
+    simularPIDsitl(&planta[PITCH], &escenario, &sin);
+    const bool filtroOk = con.accionRMS <= sin.accionRMS * MAX_RELACION_MEJORA_PID_SITL;
+    printf("  Ruido de %.0f º/s² en la derivada: accion RMS %.4f con el filtro de %.0f Hz, %.4f sin filtro\n",
+           RUIDO_DERIVADA_PID_SITL, con.accionRMS, configPID()->pVelAng[PITCH].frecCorteD, sin.accionRMS);
+
+    // TPA: la escala de las ganancias y la parte proporcional escalada
+    pid_t pid;
+    param = configPID()->pVelAng[ROLL];
+    param.ki = 0;
+    param.kd = 0;
+    param.kff = 0;
+    iniciarPID(&pid, &param, configFC()->frecLazoVelAngular);
+    escalarGananciasPID(&pid, ESCALA_TPA_PRUEBA_PID_SITL);
+    const float u = actualizarPID(&pid, 100.0f, 0.0f, 0.0f, 0.001f, true);
+    const float factorMin = factorTPAcontrol(configPID()->umbralTPA);
+    const float factorMax = factorTPAcontrol(1.0f);
+    const bool tpaOk = factorMin == 1.0f && fabsf(factorMax - (1.0f - configPID()->atenuacionTPA)) < 1e-6f &&
+                       fabsf(u - ESCALA_TPA_PRUEBA_PID_SITL * 100.0f * param.kp * param.pesoSetpoint) < 1e-7f;
+    printf("  TPA: escala %.2f en el umbral (%.2f), %.2f a fondo | proporcional escalado %s\n", factorMin, configPID()->umbralTPA,
+           factorMax, tpaOk ? "ok" : "mal");
+
+    // Sin salto del feed-forward en el primer ciclo tras iniciar o resetear el PID
+    param.kp = 0;
+    param.kff = 1.0f / planta[ROLL].ganancia;
+    iniciarPID(&pid, &param, configFC()->frecLazoVelAngular);
+    const float uInicio = actualizarPID(&pid, ESCALON_PESO_SETPOINT_PID_SITL, 0.0f, 0.0f, 0.001f, true);
+    resetearPID(&pid);
+    const float uReset = actualizarPID(&pid, -ESCALON_PESO_SETPOINT_PID_SITL, 0.0f, 0.0f, 0.001f, true);
+    const bool arranqueOk = uInicio == 0.0f && uReset == 0.0f;
+    printf("  Feed-forward en el primer ciclo: %.4f tras iniciar, %.4f tras resetear\n", uInicio, uReset);
+
+    // Coste por llamada con todas las partes activas
+    param = configPID()->pVelAng[PITCH];
+    param.kff = 1.0f / planta[PITCH].ganancia;
+    const double coste = medirCostePIDsitl(&param);
+    printf("  Coste de actualizarPID: %.1f ns por llamada (max %.0f)\n", coste, MAX_COSTE_PID_SITL_NS);
+
+    ok = ok && antiWindupOk && pesoOk && feedForwardOk && filtroOk && tpaOk && arranqueOk && coste <= MAX_COSTE_PID_SITL_NS;
+    printf("  Resultado: %s\n", ok ? "ok" : "fallo");
+}
+
+#endif
@@ -0,0 +1,169 @@
+/***************************************************************************************
+**  radio_sitl.c - Generador de tramas IBUS de la radio simulada. Los valores de los canales
+**                 se fijan desde el programa principal del SITL
+**
+**
+**  Este fichero forma parte del proyecto URpilot.
+**  Codigo desarrollado por el grupo de investigacion ICON de la Universidad de La Rioja
+**
+**  Autor: Ramon Rico
+**  Fecha de creacion: 17/10/2026
+**  Fecha de modificacion: 17/10/2026
+**
+**  El proyecto URpilot NO es libre. No se puede distribuir y/o modificar este fichero
+**  bajo ningun concepto.
+**
+**  En caso de modificacion y/o solicitud de informacion pongase en contacto con
+**  el grupo de investigacion ICON a traves de: www.unirioja.es/urpilot
+**
+**
+**  Control de versiones del fichero
+**
+**  v1.0  Ramon Rico. Se ha liberado la primera version estable
+**
+****************************************************************************************/
+
+/***************************************************************************************
+** AREA DE INCLUDES                                                                   **
+****************************************************************************************/
+#include <string.h>
+
+#include "radio_sitl.h"
+#include "GP/gp_radio.h"
+
+#if defined(USAR_RADIO) && defined(USAR_RADIO_UART)
+#include "Drivers/uart_sitl.h"
+
+
+/***************************************************************************************
+** AREA DE PREPROCESADOR                                                              **
+****************************************************************************************/
+#define TAM_TRAMA_IBUS_SITL         32
+#define VALOR_CENTRO_CANAL_SITL     1500
+#define VALOR_MINIMO_CANAL_SITL     1100
+#define CANAL_THROTTLE_SITL         2
+
+
+/***************************************************************************************
+** AREA DE DEFINICION DE TIPOS                                                        **
+****************************************************************************************/
+typedef struct {
+    uint16_t canal[NUM_CANALES_RADIO_SITL];
+    uint64_t ultimoEnvio;
+    bool failsafe;
+    bool iniciado;
+} radioSITL_t;
+
+
+/***************************************************************************************
+** AREA DE DECLARACION DE VARIABLES                                                   **
+****************************************************************************************/
+static radioSITL_t radioSITL;
+
+
+/***************************************************************************************
+** AREA DE PROTOTIPOS DE FUNCION                                                      **
+****************************************************************************************/
+static void enviarTramaIBUSradioSITL(void);
+
+
+/***************************************************************************************
+** AREA DE DEFINICION DE FUNCIONES                                                    **
+****************************************************************************************/
+
+/***************************************************************************************
+**  Nombre:         void iniciarRadioSITL(void)
+**  Descripcion:    Inicia el generador con los sticks centrados y el throttle abajo
+**  Parametros:     Ninguno
+**  Retorno:        Ninguno
+****************************************************************************************/
+void iniciarRadioSITL(void)
+{
+    memset(&radioSITL, 0, sizeof(radioSITL));
+
+    for (uint8_t i = 0; i < NUM_CANALES_RADIO_SITL; i++)
+        radioSITL.canal[i] = VALOR_CENTRO_CANAL_SITL;
+
+    radioSITL.canal[CANAL_THROTTLE_SITL] = VALOR_MINIMO_CANAL_SITL;
+    radioSITL.iniciado = true;
+}
+
+
+/***************************************************************************************
+**  Nombre:         void ajustarCanalRadioSITL(uint8_t canal, uint16_t valor)
+**  Descripcion:    Fija el valor de un canal
+**  Parametros:     Canal y valor en us
+**  Retorno:        Ninguno
+****************************************************************************************/
+void ajustarCanalRadioSITL(uint8_t canal, uint16_t valor)
+{
+    if (canal >= NUM_CANALES_RADIO_SITL)
+        return;
+
+    radioSITL.canal[canal] = valor & 0x0FFF;
+}
+
+
+/***************************************************************************************
+**  Nombre:         void ajustarFailsafeRadioSITL(bool failsafe)
+**  Descripcion:    Activa o desactiva el flag de failsafe del receptor
+**  Parametros:     Estado del failsafe
+**  Retorno:        Ninguno
+****************************************************************************************/
+void ajustarFailsafeRadioSITL(bool failsafe)
+{
+    radioSITL.failsafe = failsafe;
+}
+
+
+/***************************************************************************************
+**  Nombre:         void actualizarRadioSITL(uint64_t tiempoUs)
+**  Descripcion:    Envia una trama cada periodo del receptor
+**  Parametros:     Tiempo de simulacion en us
+**  Retorno:        Ninguno
+****************************************************************************************/
+void actualizarRadioSITL(uint64_t tiempoUs)
+{
+    if (!radioSITL.iniciado || tiempoUs - radioSITL.ultimoEnvio < PERIODO_RADIO_SITL_US)
+        return;
+
+    radioSITL.ultimoEnvio = tiempoUs;
+    enviarTramaIBUSradioSITL();
+}
+
+
+/***************************************************************************************
+**  Nombre:         void enviarTramaIBUSradioSITL(void)
+**  Descripcion:    Construye la trama IBUS y la entrega a la UART de la radio
+**  Parametros:     Ninguno
+**  Retorno:        Ninguno
+****************************************************************************************/
+static void enviarTramaIBUSradioSITL(void)
+{
+    uint8_t trama[TAM_TRAMA_IBUS_SITL];
+    uint16_t checksum = 0xFFFF;
+
+    trama[0] = 0x20;
+    trama[1] = 0x40;
+
+    for (uint8_t i = 0; i < NUM_CANALES_RADIO_SITL; i++) {
+        trama[2 + 2 * i] = radioSITL.canal[i] & 0xFF;
+        trama[3 + 2 * i] = (radioSITL.canal[i] >> 8) & 0x0F;
+    }
+
+    // El receptor indica el failsafe con el nibble alto de los primeros canales
+    if (radioSITL.failsafe) {
+        trama[3] |= 0xF0;
+        trama[9] |= 0xF0;
+    }
+
+    for (uint8_t i = 0; i < TAM_TRAMA_IBUS_SITL - 2; i++)
+        checksum -= trama[i];
+
+    trama[TAM_TRAMA_IBUS_SITL - 2] = checksum & 0xFF;
+    trama[TAM_TRAMA_IBUS_SITL - 1] = checksum >> 8;
+
+    recibirBufferUART(configRadio()->dispUART, trama, sizeof(trama));
+}
+
+#endif
@@ -0,0 +1,474 @@
+/***************************************************************************************
+**  trama_radio_sitl.c - Pruebas de la recepcion por tramas de la radio
+**
+**
+**  Este fichero forma parte del proyecto URpilot.
+**  Codigo desarrollado por el grupo de investigacion ICON de la Universidad de La Rioja
+**
+**  Autor: Ramon Rico
+**  Fecha de creacion: 17/10/2026
+**  Fecha de modificacion: 17/10/2026
+**
+**  El proyecto URpilot NO es libre. No se puede distribuir y/o modificar este fichero
+**  bajo ningun concepto.
+**
+**  En caso de modificacion y/o solicitud de informacion pongase en contacto con
+**  el grupo de investigacion ICON a traves de: www.unirioja.es/urpilot
+**
+**
+**  Control de versiones del fichero
+**
+**  v1.0  Ramon Rico. Se ha liberado la primera version estable
+**
+****************************************************************************************/
+
+/***************************************************************************************
+** AREA DE INCLUDES                                                                   **
+****************************************************************************************/
+#include <stdio.h>
+#include <string.h>
+
+#include "Core/pruebas_sitl.h"
+#include "Radio/radio.h"
+
+#if defined(USAR_RADIO) && defined(USAR_RADIO_UART)
+#include "Radio/trama_radio.h"
+#include "Comun/matematicas.h"
+
+
+/***************************************************************************************
+** AREA DE PREPROCESADOR                                                              **
+****************************************************************************************/
+#define NUM_TRAMAS_RADIO_SITL           600
+#define PERIODO_SBUS_SITL               14000       // us
+#define PERIODO_IBUS_SITL               7000        // us
+#define TIEMPO_INICIAL_RADIO_SITL       (0xFFFFFFFFULL - 2000000ULL)    // Se cruza el desbordamiento de micros
+#define ERROR_MAX_TIEMPO_RADIO_SITL     2           // us
+#define VALOR_CENTINELA_RADIO_SITL      0xBEEF
+
+
+/***************************************************************************************
+** AREA DE DEFINICION DE TIPOS                                                        **
+****************************************************************************************/
+typedef struct {
+    receptorTramaRadio_t receptor;
+    uint64_t tiempoNs;                          // Final del ultimo byte enviado
+    double nsPorByte;
+} lineaRadioSITL_t;
+
+typedef struct {
+    uint32_t validas;
+    uint32_t errorValores;
+    uint32_t errorResultado;
+    uint32_t errorTiempoMax;                    // us
+} verificacionRadioSITL_t;
+
+
+/***************************************************************************************
+** AREA DE DECLARACION DE VARIABLES                                                   **
+****************************************************************************************/
+static lineaRadioSITL_t lineaRadioSITL;
+static uint32_t semillaRadioSITL;
+
+
+/***************************************************************************************
+** AREA DE PROTOTIPOS DE FUNCION                                                      **
+****************************************************************************************/
+uint32_t aleatorioRadioSITL(void);
+void iniciarLineaRadioSITL(lineaRadioSITL_t *linea, const protocoloTramaRadio_t *protocolo);
+uint32_t enviarTramaRadioSITL(lineaRadioSITL_t *linea, const uint8_t *trama, uint8_t longitud, uint32_t silencioUs);
+void construirTramaSBUSsitl(uint8_t *trama, uint16_t *esperados, uint8_t flags, uint8_t fin);
+void construirTramaIBUSsitl(uint8_t *trama, uint16_t *esperados, bool failsafe);
+void comprobarLecturaRadioSITL(lineaRadioSITL_t *linea, resultadoTramaRadio_e esperado, const uint16_t *valoresEsperados,
+                               uint32_t tiempoEsperado, verificacionRadioSITL_t *verificacion);
+bool probarSBUSsitl(void);
+bool probarIBUSsitl(void);
+bool probarLatenciaRadioSITL(void);
+
+
+/***************************************************************************************
+** AREA DE DEFINICION DE FUNCIONES                                                    **
+****************************************************************************************/
+
+/***************************************************************************************
+**  Nombre:         uint32_t aleatorioRadioSITL(void)
+**  Descripcion:    Generador xorshift reproducible
+**  Parametros:     Ninguno
+**  Retorno:        Numero aleatorio
+****************************************************************************************/
+uint32_t aleatorioRadioSITL(void)
+{
+    semillaRadioSITL ^= semillaRadioSITL << 13;
+    semillaRadioSITL ^= semillaRadioSITL >> 17;
+    semillaRadioSITL ^= semillaRadioSITL << 5;
+    return semillaRadioSITL;
+}
+
+
+/***************************************************************************************
+**  Nombre:         void iniciarLineaRadioSITL(lineaRadioSITL_t *linea,
+**                                             const protocoloTramaRadio_t *protocolo)
+**  Descripcion:    Inicia el receptor y la linea serie simulada
+**  Parametros:     Linea, protocolo
+**  Retorno:        Ninguno
+****************************************************************************************/
+void iniciarLineaRadioSITL(lineaRadioSITL_t *linea, const protocoloTramaRadio_t *protocolo)
+{
+    iniciarReceptorTramaRadio(&linea->receptor, protocolo);
+    linea->tiempoNs = TIEMPO_INICIAL_RADIO_SITL * 1000;
+    linea->nsPorByte = protocolo->bitsPorByte * 1.0e9 / protocolo->baudrate;
+}
+
+
+/***************************************************************************************
+**  Nombre:         uint32_t enviarTramaRadioSITL(lineaRadioSITL_t *linea, const uint8_t *trama,
+**                                                uint8_t longitud, uint32_t silencioUs)
+**  Descripcion:    Envia los bytes tras un silencio en bloques de longitud aleatoria, como
+**                  llegarian por interrupcion (1 byte) o por DMA con linea en reposo
+**  Parametros:     Linea, bytes, numero de bytes, silencio previo en us
+**  Retorno:        Instante de llegada del ultimo byte en us
+****************************************************************************************/
+uint32_t enviarTramaRadioSITL(lineaRadioSITL_t *linea, const uint8_t *trama, uint8_t longitud, uint32_t silencioUs)
+{
+    const uint64_t inicioNs = linea->tiempoNs + (uint64_t)silencioUs * 1000;
+    uint8_t enviados = 0;
+
+    while (enviados < longitud) {
+        const uint8_t bloque = MIN((uint8_t)(1 + aleatorioRadioSITL() % longitud), longitud - enviados);
+        const uint64_t finBloqueNs = inicioNs + (uint64_t)((enviados + bloque) * linea->nsPorByte);
+
+        recibirBloqueTramaRadio(&linea->receptor, &trama[enviados], bloque, (uint32_t)(finBloqueNs / 1000));
+        enviados += bloque;
+    }
+
+    linea->tiempoNs = inicioNs + (uint64_t)(longitud * linea->nsPorByte);
+    return (uint32_t)(linea->tiempoNs / 1000);
+}
+
+
+/***************************************************************************************
+**  Nombre:         void construirTramaSBUSsitl(uint8_t *trama, uint16_t *esperados,
+**                                              uint8_t flags, uint8_t fin)
+**  Descripcion:    Empaqueta 16 canales aleatorios de 11 bits y calcula los valores en us
+**                  con la conversion original del driver
+**  Parametros:     Trama de 25 bytes, valores esperados, byte de flags, byte de fin
+**  Retorno:        Ninguno
+****************************************************************************************/
+void construirTramaSBUSsitl(uint8_t *trama, uint16_t *esperados, uint8_t flags, uint8_t fin)
+{
+    memset(trama, 0, protocoloTramaSBUS.longitud);
+    trama[0] = 0x0F;
+
+    for (uint8_t canal = 0; canal < protocoloTramaSBUS.numCanales; canal++) {
+        const uint16_t bruto = aleatorioRadioSITL() & 0x07FF;
+
+        for (uint8_t bit = 0; bit < 11; bit++) {
+            const uint16_t posicion = canal * 11 + bit;
+
+            if (bruto & (1 << bit))
+                trama[1 + posicion / 8] |= 1 << (posicion % 8);
+        }
+
+        esperados[canal] = (bruto * 1000 / 2048) + 1000;
+    }
+
+    trama[23] = flags;
+    trama[24] = fin;
+}
+
+
+/***************************************************************************************
+**  Nombre:         void construirTramaIBUSsitl(uint8_t *trama, uint16_t *esperados, bool failsafe)
+**  Descripcion:    Construye una trama IBUS con 14 canales aleatorios entre 1000 y 2000
+**  Parametros:     Trama de 32 bytes, valores esperados, failsafe del receptor
+**  Retorno:        Ninguno
+****************************************************************************************/
+void construirTramaIBUSsitl(uint8_t *trama, uint16_t *esperados, bool failsafe)
+{
+    uint16_t checksum = 0xFFFF;
+
+    trama[0] = 0x20;
+    trama[1] = 0x40;
+
+    for (uint8_t canal = 0; canal < protocoloTramaIBUS.numCanales; canal++) {
+        esperados[canal] = 1000 + aleatorioRadioSITL() % 1001;
+        trama[2 + 2 * canal] = esperados[canal] & 0xFF;
+        trama[3 + 2 * canal] = esperados[canal] >> 8;
+    }
+
+    // El receptor indica el failsafe con el nibble alto de los primeros canales
+    if (failsafe) {
+        trama[3] |= 0xF0;
+        trama[9] |= 0xF0;
+    }
+
+    for (uint8_t i = 0; i < protocoloTramaIBUS.longitud - 2; i++)
+        checksum -= trama[i];
+
+    trama[30] = checksum & 0xFF;
+    trama[31] = checksum >> 8;
+}
+
+
+/***************************************************************************************
+**  Nombre:         void comprobarLecturaRadioSITL(lineaRadioSITL_t *linea,
+**                                                 resultadoTramaRadio_e esperado,
+**                                                 const uint16_t *valoresEsperados,
+**                                                 uint32_t tiempoEsperado,
+**                                                 verificacionRadioSITL_t *verificacion)
+**  Descripcion:    Lee el receptor y compara el resultado, los canales y el instante de la
+**                  trama. Fuera de TRAMA_RADIO_OK los canales no se pueden tocar
+**  Parametros:     Linea, resultado esperado, canales esperados, instante esperado,
+**                  verificacion
+**  Retorno:        Ninguno
+****************************************************************************************/
+void comprobarLecturaRadioSITL(lineaRadioSITL_t *linea, resultadoTramaRadio_e esperado, const uint16_t *valoresEsperados,
+                               uint32_t tiempoEsperado, verificacionRadioSITL_t *verificacion)
+{
+    const uint8_t numCanales = linea->receptor.protocolo->numCanales;
+    uint16_t valores[NUM_MAX_CANALES_TRAMA_RADIO];
+    uint32_t tiempoTrama = 0;
+
+    for (uint8_t i = 0; i < NUM_MAX_CANALES_TRAMA_RADIO; i++)
+        valores[i] = VALOR_CENTINELA_RADIO_SITL;
+
+    const resultadoTramaRadio_e resultado = leerTramaRadio(&linea->receptor, valores, &tiempoTrama);
+
+    if (resultado != esperado) {
+        verificacion->errorResultado++;
+        return;
+    }
+
+    if (resultado != TRAMA_RADIO_OK) {
+        for (uint8_t i = 0; i < numCanales; i++) {
+            if (valores[i] != VALOR_CENTINELA_RADIO_SITL) {
+                verificacion->errorValores++;
+                break;
+            }
+        }
+        return;
+    }
+
+    verificacion->validas++;
+    if (memcmp(valores, valoresEsperados, numCanales * sizeof(uint16_t)) != 0)
+        verificacion->errorValores++;
+
+    const int32_t error = (int32_t)(tiempoTrama - tiempoEsperado);
+    const uint32_t errorAbs = error < 0 ? -error : error;
+
+    if (errorAbs > verificacion->errorTiempoMax)
+        verificacion->errorTiempoMax = errorAbs;
+}
+
+
+/***************************************************************************************
+**  Nombre:         bool probarSBUSsitl(void)
+**  Descripcion:    Envia tramas SBUS con failsafe, tramas perdidas, bytes de fin erroneos,
+**                  tramas cortadas y tramas sin separacion intercaladas
+**  Parametros:     Ninguno
+**  Retorno:        True si ok
+****************************************************************************************/
+bool probarSBUSsitl(void)
+{
+    lineaRadioSITL_t *linea = &lineaRadioSITL;
+    const uint32_t duracionTrama = (uint32_t)(protocoloTramaSBUS.longitud * 12 * 1.0e6 / protocoloTramaSBUS.baudrate);
+    const uint32_t silencio = PERIODO_SBUS_SITL - duracionTrama;
+    verificacionRadioSITL_t verificacion;
+    uint32_t failsafe = 0, perdidas = 0, corruptas = 0, cortadas = 0, sinSeparacion = 0, errorFailsafe = 0;
+    uint16_t esperados[NUM_MAX_CANALES_TRAMA_RADIO];
+    uint8_t trama[TAM_MAX_TRAMA_RADIO];
+
+    memset(&verificacion, 0, sizeof(verificacion));
+    iniciarLineaRadioSITL(linea, &protocoloTramaSBUS);
+
+    for (uint32_t i = 0; i < NUM_TRAMAS_RADIO_SITL; i++) {
+        const uint8_t fin = (i & 0x01) ? 0x00 : 0x04 | (i & 0x30);     // SBUS 1 y variantes 0xX4
+        uint32_t tiempo;
+
+        switch (i % 10) {
+            case 1:
+                construirTramaSBUSsitl(trama, esperados, 1 << 3, fin);
+                enviarTramaRadioSITL(linea, trama, protocoloTramaSBUS.longitud, silencio);
+                comprobarLecturaRadioSITL(linea, TRAMA_RADIO_FAILSAFE, esperados, 0, &verificacion);
+                if (!linea->receptor.failsafe)
+                    errorFailsafe++;
+                failsafe++;
+                break;
+
+            case 3:
+                construirTramaSBUSsitl(trama, esperados, 1 << 2, fin);
+                enviarTramaRadioSITL(linea, trama, protocoloTramaSBUS.longitud, silencio);
+                comprobarLecturaRadioSITL(linea, TRAMA_RADIO_PERDIDA, esperados, 0, &verificacion);
+                perdidas++;
+                break;
+
+            case 5:
+                construirTramaSBUSsitl(trama, esperados, 0, 0x55);
+                enviarTramaRadioSITL(linea, trama, protocoloTramaSBUS.longitud, silencio);
+                comprobarLecturaRadioSITL(linea, TRAMA_RADIO_CORRUPTA, esperados, 0, &verificacion);
+                corruptas++;
+                break;
+
+            case 7:
+                // Se corta la trama. La separacion de la siguiente la descarta
+                construirTramaSBUSsitl(trama, esperados, 0, fin);
+                enviarTramaRadioSITL(linea, trama, 1 + aleatorioRadioSITL() % (protocoloTramaSBUS.longitud - 1), silencio);
+                comprobarLecturaRadioSITL(linea, TRAMA_RADIO_NINGUNA, esperados, 0, &verificacion);
+                cortadas++;
+                break;
+
+            case 9:
+                // Una trama pegada a la anterior no se puede alinear
+                construirTramaSBUSsitl(trama, esperados, 0, fin);
+                enviarTramaRadioSITL(linea, trama, protocoloTramaSBUS.longitud, silencio);
+                comprobarLecturaRadioSITL(linea, TRAMA_RADIO_OK, esperados, (uint32_t)(linea->tiempoNs / 1000), &verificacion);
+                construirTramaSBUSsitl(trama, esperados, 0, fin);
+                enviarTramaRadioSITL(linea, trama, protocoloTramaSBUS.longitud, 0);
+                comprobarLecturaRadioSITL(linea, TRAMA_RADIO_NINGUNA, esperados, 0, &verificacion);
+                sinSeparacion++;
+                break;
+
+            default:
+                construirTramaSBUSsitl(trama, esperados, i & 0x03, fin);      // Canales digitales 17 y 18
+                tiempo = enviarTramaRadioSITL(linea, trama, protocoloTramaSBUS.longitud, silencio);
+                comprobarLecturaRadioSITL(linea, TRAMA_RADIO_OK, esperados, tiempo, &verificacion);
+                if (linea->receptor.failsafe)
+                    errorFailsafe++;
+                break;
+        }
+    }
+
+    const estadisticasTramaRadio_t *estadisticas = &linea->receptor.estadisticas;
+
+    printf("  SBUS: validas %u, failsafe %u/%u, perdidas %u/%u, corruptas %u/%u, resincronizaciones %u/%u, bytes descartados %u | "
+           "error de canales %u, de resultado %u, del instante de la trama %u us\n", verificacion.validas, estadisticas->numTramasFailsafe,
+           failsafe, estadisticas->numTramasPerdidas, perdidas, estadisticas->numTramasCorruptas, corruptas,
+           estadisticas->numResincronizaciones, cortadas, estadisticas->numBytesDescartados, verificacion.errorValores,
+           verificacion.errorResultado, verificacion.errorTiempoMax);
+
+    return verificacion.errorValores == 0 && verificacion.errorResultado == 0 && errorFailsafe == 0 &&
+           verificacion.errorTiempoMax <= ERROR_MAX_TIEMPO_RADIO_SITL && estadisticas->numTramasFailsafe == failsafe &&
+           estadisticas->numTramasPerdidas == perdidas && estadisticas->numTramasCorruptas == corruptas &&
+           estadisticas->numResincronizaciones == cortadas && estadisticas->numBytesDescartados == sinSeparacion * protocoloTramaSBUS.longitud &&
+           estadisticas->numTramasSobrescritas == 0;
+}
+
+
+/***************************************************************************************
+**  Nombre:         bool probarIBUSsitl(void)
+**  Descripcion:    Envia tramas IBUS con failsafe, checksum erroneo y tramas que llegan antes
+**                  de leer la anterior
+**  Parametros:     Ninguno
+**  Retorno:        True si ok
+****************************************************************************************/
+bool probarIBUSsitl(void)
+{
+    lineaRadioSITL_t *linea = &lineaRadioSITL;
+    const uint32_t duracionTrama = (uint32_t)(protocoloTramaIBUS.longitud * 10 * 1.0e6 / protocoloTramaIBUS.baudrate);
+    const uint32_t silencio = PERIODO_IBUS_SITL - duracionTrama;
+    verificacionRadioSITL_t verificacion;
+    uint32_t failsafe = 0, corruptas = 0, sobrescritas = 0;
+    uint16_t esperados[NUM_MAX_CANALES_TRAMA_RADIO];
+    uint8_t trama[TAM_MAX_TRAMA_RADIO];
+    uint32_t tiempo;
+
+    memset(&verificacion, 0, sizeof(verificacion));
+    iniciarLineaRadioSITL(linea, &protocoloTramaIBUS);
+
+    for (uint32_t i = 0; i < NUM_TRAMAS_RADIO_SITL; i++) {
+        switch (i % 8) {
+            case 2:
+                construirTramaIBUSsitl(trama, esperados, true);
+                enviarTramaRadioSITL(linea, trama, protocoloTramaIBUS.longitud, silencio);
+                comprobarLecturaRadioSITL(linea, TRAMA_RADIO_FAILSAFE, esperados, 0, &verificacion);
+                failsafe++;
+                break;
+
+            case 4:
+                // Un bit cambiado en cualquier byte despues de la cabecera
+                construirTramaIBUSsitl(trama, esperados, false);
+                trama[2 + aleatorioRadioSITL() % (protocoloTramaIBUS.longitud - 2)] ^= 1 << (aleatorioRadioSITL() % 8);
+                enviarTramaRadioSITL(linea, trama, protocoloTramaIBUS.longitud, silencio);
+                comprobarLecturaRadioSITL(linea, TRAMA_RADIO_CORRUPTA, esperados, 0, &verificacion);
+                corruptas++;
+                break;
+
+            case 6:
+                // Se leen dos tramas de una vez: solo se decodifica la ultima
+                construirTramaIBUSsitl(trama, esperados, false);
+                enviarTramaRadioSITL(linea, trama, protocoloTramaIBUS.longitud, silencio);
+                construirTramaIBUSsitl(trama, esperados, false);
+                tiempo = enviarTramaRadioSITL(linea, trama, protocoloTramaIBUS.longitud, silencio);
+                comprobarLecturaRadioSITL(linea, TRAMA_RADIO_OK, esperados, tiempo, &verificacion);
+                sobrescritas++;
+                break;
+
+            default:
+                construirTramaIBUSsitl(trama, esperados, false);
+                tiempo = enviarTramaRadioSITL(linea, trama, protocoloTramaIBUS.longitud, silencio);
+                comprobarLecturaRadioSITL(linea, TRAMA_RADIO_OK, esperados, tiempo, &verificacion);
+                break;
+        }
+    }
+
+    const estadisticasTramaRadio_t *estadisticas = &linea->receptor.estadisticas;
+
+    printf("  IBUS: validas %u, failsafe %u/%u, corruptas %u/%u, sobrescritas %u/%u | error de canales %u, de resultado %u, "
+           "del instante de la trama %u us\n", verificacion.validas, estadisticas->numTramasFailsafe, failsafe,
+           estadisticas->numTramasCorruptas, corruptas, estadisticas->numTramasSobrescritas, sobrescritas, verificacion.errorValores,
+           verificacion.errorResultado, verificacion.errorTiempoMax);
+
+    return verificacion.errorValores == 0 && verificacion.errorResultado == 0 && verificacion.errorTiempoMax <= ERROR_MAX_TIEMPO_RADIO_SITL &&
+           estadisticas->numTramasFailsafe == failsafe && estadisticas->numTramasCorruptas == corruptas &&
+           estadisticas->numTramasSobrescritas == sobrescritas && estadisticas->numResincronizaciones == 0 &&
+           estadisticas->numBytesDescartados == 0;
+}
+
+
+/***************************************************************************************
+**  Nombre:         bool probarLatenciaRadioSITL(void)
+**  Descripcion:    Comprueba las estadisticas de la radio simulada despues del vuelo
+**  Parametros:     Ninguno
+**  Retorno:        True si ok
+****************************************************************************************/
+bool probarLatenciaRadioSITL(void)
+{
+    estadisticasTramaRadio_t estadisticas;
+    latenciaRadio_t latencia;
+
+    latenciaRadio(&latencia);
+    if (!estadisticasTramasRadio(&estadisticas)) {
+        printf("  Vuelo: la radio no tiene estadisticas de tramas\n");
+        return false;
+    }
+
+    printf("  Vuelo: tramas %u (validas %u, corruptas %u, sobrescritas %u) | latencia trama-mixer (us): min %u, media %u, max %u "
+           "en %u medidas\n", estadisticas.numTramas, estadisticas.numTramasValidas, estadisticas.numTramasCorruptas,
+           estadisticas.numTramasSobrescritas, latencia.minima, latencia.media, latencia.maxima, latencia.numMuestras);
+
+    return estadisticas.numTramas > 0 && estadisticas.numTramasCorruptas == 0 && latencia.numMuestras > 0 &&
+           latencia.minima <= latencia.media && latencia.media <= latencia.maxima && latencia.maxima < PERIODO_IBUS_SITL * 2;
+}
+
+
+/***************************************************************************************
+**  Nombre:         void probarTramaRadioSITL(void)
+**  Descripcion:    Prueba la deteccion de separaciones, las tramas corruptas, los flags de
+**                  failsafe, el conteo de tramas perdidas y la latencia hasta el mixer
+**  Parametros:     Ninguno
+**  Retorno:        Ninguno
+****************************************************************************************/
+void probarTramaRadioSITL(void)
+{
+    printf("\nRecepcion por tramas de la radio (SITL)\n");
+
+    semillaRadioSITL = 0x2545F491;
+
+    bool ok = probarSBUSsitl();
+    ok = probarIBUSsitl() && ok;
+    ok = probarLatenciaRadioSITL() && ok;
+
+    printf("  Resultado: %s\n", ok ? "ok" : "fallo");
+}
+
+#endif
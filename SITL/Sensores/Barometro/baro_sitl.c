@@ -0,0 +1,144 @@
+/***************************************************************************************
+**  baro_sitl.c - Driver del barometro simulado. Las medidas las genera el modelo fisico
+**
+**
+**  Este fichero forma parte del proyecto URpilot.
+**  Codigo desarrollado por el grupo de investigacion ICON de la Universidad de La Rioja
+**
+**  Autor: Ramon Rico
+**  Fecha de creacion: 17/10/2026
+**  Fecha de modificacion: 17/10/2026
+**
+**  El proyecto URpilot NO es libre. No se puede distribuir y/o modificar este fichero
+**  bajo ningun concepto.
+**
+**  En caso de modificacion y/o solicitud de informacion pongase en contacto con
+**  el grupo de investigacion ICON a traves de: www.unirioja.es/urpilot
+**
+**
+**  Control de versiones del fichero
+**
+**  v1.0  Ramon Rico. Se ha liberado la primera version estable
+**
+****************************************************************************************/
+
+/***************************************************************************************
+** AREA DE INCLUDES                                                                   **
+****************************************************************************************/
+#include <string.h>
+
+#include "Sensores/Barometro/barometro.h"
+
+#if defined(USAR_BARO) && defined(SITL)
+#include "Drivers/tiempo.h"
+#include "Fisica/fisica.h"
+
+
+/***************************************************************************************
+** AREA DE PREPROCESADOR                                                              **
+****************************************************************************************/
+#define RUIDO_PRESION_BARO_SITL     0.02f       // mBar
+#define RUIDO_TEMP_BARO_SITL        0.01f       // ºC
+
+
+/***************************************************************************************
+** AREA DE DEFINICION DE TIPOS                                                        **
+****************************************************************************************/
+typedef struct {
+    acumulador_t acumuladorPresion;
+    acumulador_t acumuladorTemperatura;
+} baroSITL_t;
+
+
+/***************************************************************************************
+** AREA DE DECLARACION DE VARIABLES                                                   **
+****************************************************************************************/
+static baroSITL_t baroSITL[NUM_MAX_BARO];
+
+
+/***************************************************************************************
+** AREA DE PROTOTIPOS DE FUNCION                                                      **
+****************************************************************************************/
+bool iniciarBaroSITL(baro_t *dBaro);
+void leerBaroSITL(baro_t *dBaro);
+void actualizarBaroSITL(baro_t *dBaro);
+
+
+/***************************************************************************************
+** AREA DE DEFINICION DE FUNCIONES                                                    **
+****************************************************************************************/
+
+/***************************************************************************************
+**  Nombre:         bool iniciarBaroSITL(baro_t *dBaro)
+**  Descripcion:    Inicia el barometro
+**  Parametros:     Puntero al barometro
+**  Retorno:        True si ok
+****************************************************************************************/
+bool iniciarBaroSITL(baro_t *dBaro)
+{
+    baroSITL_t *driver = &baroSITL[dBaro->numBaro];
+    dBaro->driver = driver;
+
+    memset(driver, 0, sizeof(*driver));
+    return true;
+}
+
+
+/***************************************************************************************
+**  Nombre:         void leerBaroSITL(baro_t *dBaro)
+**  Descripcion:    Calcula la media de las muestras acumuladas
+**  Parametros:     Puntero al barometro
+**  Retorno:        Ninguno
+****************************************************************************************/
+void leerBaroSITL(baro_t *dBaro)
+{
+    baroSITL_t *driver = dBaro->driver;
+    uint32_t tiempo = micros();
+
+    if (driver->acumuladorPresion.contador == 0)
+        return;
+
+    const float presion = driver->acumuladorPresion.acumulado / driver->acumuladorPresion.contador;
+    const float temperatura = driver->acumuladorTemperatura.acumulado / driver->acumuladorTemperatura.contador;
+
+    memset(&driver->acumuladorPresion, 0, sizeof(driver->acumuladorPresion));
+    memset(&driver->acumuladorTemperatura, 0, sizeof(driver->acumuladorTemperatura));
+
+    if (dBaro->presion != presion || dBaro->temperatura != temperatura)
+    	dBaro->timing.ultimoCambio = tiempo;
+
+    dBaro->presion = presion;
+    dBaro->temperatura = temperatura;
+    dBaro->timing.ultimaMedida = tiempo;
+    dBaro->nuevaMedida = true;
+}
+
+
+/***************************************************************************************
+**  Nombre:         void actualizarBaroSITL(baro_t *dBaro)
+**  Descripcion:    Toma una muestra del modelo fisico
+**  Parametros:     Puntero al barometro
+**  Retorno:        Ninguno
+****************************************************************************************/
+void actualizarBaroSITL(baro_t *dBaro)
+{
+    baroSITL_t *driver = dBaro->driver;
+
+    dBaro->timing.ultimaActualizacion = micros();
+
+    acumularLectura(&driver->acumuladorPresion, presionFisica() + ruidoFisica(RUIDO_PRESION_BARO_SITL), 20);
+    acumularLectura(&driver->acumuladorTemperatura, temperaturaFisica() + ruidoFisica(RUIDO_TEMP_BARO_SITL), 20);
+}
+
+
+/***************************************************************************************
+**  Nombre:         tablaFnBaro_t tablaFnBaroSITL
+**  Descripcion:    Tabla de funciones del barometro simulado
+****************************************************************************************/
+tablaFnBaro_t tablaFnBaroSITL = {
+    iniciarBaroSITL,
+    leerBaroSITL,
+    actualizarBaroSITL,
+};
+
+#endif
@@ -0,0 +1,249 @@
+/***************************************************************************************
+**  ajuste_mag_sitl.c - Prueba del ajuste incremental de la calibracion del magnetometro
+**
+**
+**  Este fichero forma parte del proyecto URpilot.
+**  Codigo desarrollado por el grupo de investigacion ICON de la Universidad de La Rioja
+**
+**  Autor: Ramon Rico
+**  Fecha de creacion: 17/10/2026
+**  Fecha de modificacion: 17/10/2026
+**
+**  El proyecto URpilot NO es libre. No se puede distribuir y/o modificar este fichero
+**  bajo ningun concepto.
+**
+**  En caso de modificacion y/o solicitud de informacion pongase en contacto con
+**  el grupo de investigacion ICON a traves de: www.unirioja.es/urpilot
+**
+**
+**  Control de versiones del fichero
+**
+**  v1.0  Ramon Rico. Se ha liberado la primera version estable
+**
+****************************************************************************************/
+
+/***************************************************************************************
+** AREA DE INCLUDES                                                                   **
+****************************************************************************************/
+#include <stdio.h>
+#include <string.h>
+#include <math.h>
+
+#include "Core/pruebas_sitl.h"
+
+#ifdef SITL
+#include "Sensores/Calibrador/ajuste_mag.h"
+#include "Comun/matriz.h"
+#include "Drivers/tiempo_sitl.h"
+#include "Fisica/fisica.h"
+#include "Comun/util.h"
+
+
+/***************************************************************************************
+** AREA DE PREPROCESADOR                                                              **
+****************************************************************************************/
+// Mismo reparto que calibrador_mag.c con la tarea a 20 Hz y una muestra por ciclo
+#define FREC_TAREA_AJUSTE_MAG_SITL           20.0f       // Hz
+#define NUM_MIN_MUESTRAS_AJUSTE_MAG_SITL     150
+#define COBERTURA_MIN_AJUSTE_MAG_SITL        75.0f       // %
+#define MUESTRAS_POR_CICLO_AJUSTE_MAG_SITL   100
+#define ITERACIONES_ESFERA_AJUSTE_MAG_SITL   10
+#define ITERACIONES_ELIPSE_AJUSTE_MAG_SITL   25
+#define MEJORA_MIN_AJUSTE_MAG_SITL           1e-4f
+#define CICLOS_MAX_AJUSTE_MAG_SITL           6000        // 5 minutos
+
+// Campo y distorsion simulados: m = inv(D) * h - offset
+#define RADIO_CAMPO_AJUSTE_MAG_SITL          480.0f      // mGa
+#define RUIDO_AJUSTE_MAG_SITL                2.0f        // mGa
+static const float offsetAjusteMagSITL[3] = {120.0f, -75.0f, 210.0f};
+static const float distorsionAjusteMagSITL[9] = { 1.08f, 0.04f, -0.03f,
+                                                  0.04f, 0.93f,  0.02f,
+                                                 -0.03f, 0.02f,  1.02f};
+
+// Giro de la orientacion: vueltas en azimut y una barrida completa en elevacion
+#define FREC_AZIMUT_AJUSTE_MAG_SITL          0.12f       // Hz
+#define PERIODO_ELEVACION_AJUSTE_MAG_SITL    40.0f       // s
+
+#define ERROR_MAX_OFFSET_AJUSTE_MAG_SITL     5.0f        // mGa
+#define ERROR_MAX_MATRIZ_AJUSTE_MAG_SITL     0.01f
+#define RESIDUO_MAX_AJUSTE_MAG_SITL          5.0f        // mGa
+
+
+/***************************************************************************************
+** AREA DE DEFINICION DE TIPOS                                                        **
+****************************************************************************************/
+typedef struct {
+    bool terminado;
+    uint32_t ciclosRecogida;
+    uint32_t ciclosAjuste;
+    uint16_t numMuestras;
+    uint16_t iteraciones;
+    float coberturaRecogida;                        // Respecto al centro de la esfera lineal
+    float cobertura;                                // Respecto al centro ajustado
+    float residuoRMS;
+    float errorOffset;
+    float errorMatriz;
+    uint64_t nsMaxRecogida;
+    uint64_t nsMaxAjuste;
+    uint64_t nsTotalAjuste;
+} resultadoAjusteMagSITL_t;
+
+
+/***************************************************************************************
+** AREA DE DECLARACION DE VARIABLES                                                   **
+****************************************************************************************/
+static ajusteMag_t ajusteMagSITL;
+
+
+/***************************************************************************************
+** AREA DE PROTOTIPOS DE FUNCION                                                      **
+****************************************************************************************/
+void muestraAjusteMagSITL(float t, float elevacionMin, float elevacionMax, float *m);
+void ejecutarAjusteMagSITL(float elevacionMin, float elevacionMax, resultadoAjusteMagSITL_t *resultado);
+
+
+/***************************************************************************************
+** AREA DE DEFINICION DE FUNCIONES                                                    **
+****************************************************************************************/
+
+/***************************************************************************************
+**  Nombre:         void muestraAjusteMagSITL(float t, float elevacionMin, float elevacionMax, float *m)
+**  Descripcion:    Medida del magnetometro distorsionado mientras se gira el vehiculo
+**  Parametros:     Tiempo en s, elevaciones minima y maxima del campo en rad, medida en mGa
+**  Retorno:        Ninguno
+****************************************************************************************/
+void muestraAjusteMagSITL(float t, float elevacionMin, float elevacionMax, float *m)
+{
+    const float azimut = 2.0f * PI * FREC_AZIMUT_AJUSTE_MAG_SITL * t;
+    const float elevacion = 0.5f * (elevacionMax + elevacionMin) +
+                            0.5f * (elevacionMax - elevacionMin) * sinf(2.0f * PI * t / PERIODO_ELEVACION_AJUSTE_MAG_SITL);
+    float inversa[9], h[3];
+
+    h[0] = RADIO_CAMPO_AJUSTE_MAG_SITL * cosf(elevacion) * cosf(azimut) + ruidoFisica(RUIDO_AJUSTE_MAG_SITL);
+    h[1] = RADIO_CAMPO_AJUSTE_MAG_SITL * cosf(elevacion) * sinf(azimut) + ruidoFisica(RUIDO_AJUSTE_MAG_SITL);
+    h[2] = RADIO_CAMPO_AJUSTE_MAG_SITL * sinf(elevacion) + ruidoFisica(RUIDO_AJUSTE_MAG_SITL);
+
+    inversaMat3(distorsionAjusteMagSITL, inversa);
+    multiplicarMatVector3(inversa, h, m);
+
+    for (uint8_t i = 0; i < 3; i++)
+        m[i] -= offsetAjusteMagSITL[i];
+}
+
+
+/***************************************************************************************
+**  Nombre:         void ejecutarAjusteMagSITL(float elevacionMin, float elevacionMax,
+**                                         resultadoAjusteMagSITL_t *resultado)
+**  Descripcion:    Ejecuta el calibrador ciclo a ciclo como la tarea del scheduler y mide el
+**                  tiempo de cada ciclo y el error de los parametros
+**  Parametros:     Elevaciones minima y maxima del campo en rad, resultado
+**  Retorno:        Ninguno
+****************************************************************************************/
+void ejecutarAjusteMagSITL(float elevacionMin, float elevacionMax, resultadoAjusteMagSITL_t *resultado)
+{
+    bool recogiendo = true;
+
+    memset(resultado, 0, sizeof(resultadoAjusteMagSITL_t));
+    iniciarAjusteMag(&ajusteMagSITL);
+
+    for (uint32_t ciclo = 0; ciclo < CICLOS_MAX_AJUSTE_MAG_SITL && !resultado->terminado; ciclo++) {
+        float m[3];
+
+        muestraAjusteMagSITL(ciclo / FREC_TAREA_AJUSTE_MAG_SITL, elevacionMin, elevacionMax, m);
+
+        const uint64_t inicio = nanosegundosHostSITL();
+
+        if (recogiendo) {
+            anadirMuestraAjusteMag(&ajusteMagSITL, m);
+
+            if (ajusteMagSITL.numMuestras >= NUM_MAX_MUESTRAS_AJUSTE_MAG ||
+                (ajusteMagSITL.numMuestras >= NUM_MIN_MUESTRAS_AJUSTE_MAG_SITL && coberturaAjusteMag(&ajusteMagSITL) >= COBERTURA_MIN_AJUSTE_MAG_SITL)) {
+                resultado->coberturaRecogida = coberturaAjusteMag(&ajusteMagSITL);
+                iniciarIteracionesAjusteMag(&ajusteMagSITL, FASE_AJUSTE_MAG_ESFERA);
+                recogiendo = false;
+            }
+        }
+        else if (iterarAjusteMag(&ajusteMagSITL, MUESTRAS_POR_CICLO_AJUSTE_MAG_SITL)) {
+            if (ajusteMagSITL.fase == FASE_AJUSTE_MAG_ESFERA) {
+                resultado->iteraciones++;
+                if (ajusteMagSITL.numIteraciones >= ITERACIONES_ESFERA_AJUSTE_MAG_SITL)
+                    iniciarIteracionesAjusteMag(&ajusteMagSITL, FASE_AJUSTE_MAG_ELIPSE);
+            }
+            else {
+                resultado->iteraciones++;
+                if (ajusteMagSITL.numIteraciones >= ITERACIONES_ELIPSE_AJUSTE_MAG_SITL ||
+                    (ajusteMagSITL.numIteraciones > 1 && ajusteMagSITL.mejoraRelativa < MEJORA_MIN_AJUSTE_MAG_SITL))
+                    resultado->terminado = true;
+            }
+        }
+
+        const uint64_t ns = nanosegundosHostSITL() - inicio;
+
+        if (recogiendo || resultado->ciclosAjuste == 0) {
+            resultado->ciclosRecogida++;
+            if (ns > resultado->nsMaxRecogida)
+                resultado->nsMaxRecogida = ns;
+        }
+        if (!recogiendo) {
+            resultado->ciclosAjuste++;
+            resultado->nsTotalAjuste += ns;
+            if (ns > resultado->nsMaxAjuste)
+                resultado->nsMaxAjuste = ns;
+        }
+    }
+
+    // Error frente a la distorsion simulada. La matriz se ajusta con el radio, que es libre
+    const calParamMag_t *param = &ajusteMagSITL.param;
+    const float escala = RADIO_CAMPO_AJUSTE_MAG_SITL / param->radio;
+    const float matriz[9] = {param->diag[0],    param->offDiag[0], param->offDiag[1],
+                             param->offDiag[0], param->diag[1],    param->offDiag[2],
+                             param->offDiag[1], param->offDiag[2], param->diag[2]};
+
+    for (uint8_t i = 0; i < 3; i++)
+        resultado->errorOffset = fmaxf(resultado->errorOffset, fabsf(param->offset[i] - offsetAjusteMagSITL[i]));
+
+    for (uint8_t i = 0; i < 9; i++)
+        resultado->errorMatriz = fmaxf(resultado->errorMatriz, fabsf(matriz[i] * escala - distorsionAjusteMagSITL[i]));
+
+    if (recogiendo)
+        resultado->coberturaRecogida = coberturaAjusteMag(&ajusteMagSITL);
+
+    resultado->numMuestras = ajusteMagSITL.numMuestras;
+    resultado->cobertura = coberturaAjusteMag(&ajusteMagSITL);
+    resultado->residuoRMS = residuoRMSajusteMag(&ajusteMagSITL);
+}
+
+
+/***************************************************************************************
+**  Nombre:         void probarAjusteMagSITL(void)
+**  Descripcion:    Calibra un magnetometro con hierro duro y blando girando en todas las
+**                  direcciones y otro que solo ve el hemisferio superior
+**  Parametros:     Ninguno
+**  Retorno:        Ninguno
+****************************************************************************************/
+void probarAjusteMagSITL(void)
+{
+    resultadoAjusteMagSITL_t completo, parcial;
+
+    ejecutarAjusteMagSITL(-PI / 2, PI / 2, &completo);
+    ejecutarAjusteMagSITL(0.0f, PI / 2, &parcial);
+
+    const bool ok = completo.terminado && completo.coberturaRecogida >= COBERTURA_MIN_AJUSTE_MAG_SITL &&
+                    completo.errorOffset < ERROR_MAX_OFFSET_AJUSTE_MAG_SITL && completo.errorMatriz < ERROR_MAX_MATRIZ_AJUSTE_MAG_SITL &&
+                    completo.residuoRMS < RESIDUO_MAX_AJUSTE_MAG_SITL && parcial.coberturaRecogida < COBERTURA_MIN_AJUSTE_MAG_SITL;
+
+    printf("\nCalibracion incremental del magnetometro (SITL)\n");
+    printf("  Giro completo: recogida %.1f s, %u muestras, cobertura %.0f %% (%.0f %% con el centro ajustado)\n",
+           completo.ciclosRecogida / FREC_TAREA_AJUSTE_MAG_SITL, completo.numMuestras, completo.coberturaRecogida, completo.cobertura);
+    printf("  Ajuste: %.1f s, %u iteraciones | residuo %.2f mGa, error offset %.2f mGa, matriz %.4f\n",
+           completo.ciclosAjuste / FREC_TAREA_AJUSTE_MAG_SITL, completo.iteraciones, completo.residuoRMS, completo.errorOffset,
+           completo.errorMatriz);
+    printf("  Coste por ciclo (ns del host): recogida max %u | ajuste medio %.0f, max %u (%u muestras por ciclo)\n",
+           (uint32_t)completo.nsMaxRecogida, (double)completo.nsTotalAjuste / completo.ciclosAjuste, (uint32_t)completo.nsMaxAjuste,
+           MUESTRAS_POR_CICLO_AJUSTE_MAG_SITL);
+    printf("  Solo el hemisferio superior: cobertura %.0f %% tras %.0f s (minimo %.0f %%)\n", parcial.coberturaRecogida,
+           (parcial.ciclosRecogida + parcial.ciclosAjuste) / FREC_TAREA_AJUSTE_MAG_SITL, COBERTURA_MIN_AJUSTE_MAG_SITL);
+    printf("  Resultado: %s\n", ok ? "ok" : "fallo");
+}
+
+#endif
@@ -0,0 +1,580 @@
+/***************************************************************************************
+**  analizador_ubx_sitl.c - Pruebas del analizador de tramas UBX con una grabacion sintetica:
+**                         troceado arbitrario, corrupcion del flujo y coste
+**
+**
+**  Este fichero forma parte del proyecto URpilot.
+**  Codigo desarrollado por el grupo de investigacion ICON de la Universidad de La Rioja
+**
+**  Autor: Ramon Rico
+**  Fecha de creacion: 17/10/2026
+**  Fecha de modificacion: 17/10/2026
+**
+**  El proyecto URpilot NO es libre. No se puede distribuir y/o modificar este fichero
+**  bajo ningun concepto.
+**
+**  En caso de modificacion y/o solicitud de informacion pongase en contacto con
+**  el grupo de investigacion ICON a traves de: www.unirioja.es/urpilot
+**
+**
+**  Control de versiones del fichero
+**
+**  v1.0  Ramon Rico. Se ha liberado la primera version estable
+**
+****************************************************************************************/
+
+/***************************************************************************************
+** AREA DE INCLUDES                                                                   **
+****************************************************************************************/
+#include <stdio.h>
+#include <string.h>
+#include <math.h>
+
+#include "Core/pruebas_sitl.h"
+
+#ifdef SITL
+#include "Sensores/GPS/analizador_ubx.h"
+#include "Drivers/uart.h"
+#include "Drivers/tiempo_sitl.h"
+#include "Comun/matematicas.h"
+#include "Comun/util.h"
+
+
+/***************************************************************************************
+** AREA DE PREPROCESADOR                                                              **
+****************************************************************************************/
+#define TAM_GRABACION_UBX_SITL        65536
+#define NUM_MAX_TRAMAS_UBX_SITL       2048
+#define BAUDRATE_UBX_SITL             115200
+#define TAM_ANILLO_UBX_SITL           TAMANIO_BUFFER_RX_UART
+#define MAX_BYTES_LLEGADA_UBX_SITL    300         // Bytes maximos recibidos entre dos lecturas
+#define PROB_CORRUPCION_UBX_SITL      0.002f      // Probabilidad de corromper cada byte
+#define TAM_BLOQUE_COSTE_UBX_SITL     512
+#define NUM_PASADAS_COSTE_UBX_SITL    40
+#define ERROR_MAX_TIEMPO_UBX_SITL     2           // us
+
+
+/***************************************************************************************
+** AREA DE DEFINICION DE TIPOS                                                        **
+****************************************************************************************/
+typedef struct {
+    uint8_t clase;
+    uint8_t id;
+    uint16_t longitud;
+    uint32_t inicio;                            // Posicion del primer sincronismo en la grabacion
+    uint32_t fin;                               // Posicion del ultimo byte del checksum
+    bool intacta;
+} tramaGrabadaUBXsitl_t;
+
+typedef struct {
+    const uint8_t *flujo;
+    uint16_t siguiente;                         // Primera trama grabada aun no recibida
+    uint32_t recibidas;
+    uint32_t intactasRecibidas;
+    uint32_t desconocidas;                      // Tramas entregadas que no estan en la grabacion
+    uint32_t desordenadas;
+    uint32_t errorTiempoMax;                    // us
+    uint32_t bytesEscritos;
+} verificacionUBXsitl_t;
+
+
+/***************************************************************************************
+** AREA DE DECLARACION DE VARIABLES                                                   **
+****************************************************************************************/
+static uint8_t grabacionUBXsitl[TAM_GRABACION_UBX_SITL];
+static uint8_t corruptaUBXsitl[TAM_GRABACION_UBX_SITL + TAM_GRABACION_UBX_SITL / 64];
+static uint32_t longitudGrabacionUBXsitl;
+static tramaGrabadaUBXsitl_t tramasUBXsitl[NUM_MAX_TRAMAS_UBX_SITL];
+static uint16_t numTramasUBXsitl;
+static verificacionUBXsitl_t verificacionUBXsitl;
+static uint32_t semillaUBXsitl;
+static volatile uint32_t sumideroUBXsitl;
+
+
+/***************************************************************************************
+** AREA DE PROTOTIPOS DE FUNCION                                                      **
+****************************************************************************************/
+uint32_t aleatorioUBXsitl(void);
+void anadirTramaUBXsitl(uint8_t clase, uint8_t id, uint16_t longitud);
+void anadirTextoUBXsitl(const char *texto);
+void generarGrabacionUBXsitl(void);
+uint32_t corromperGrabacionUBXsitl(void);
+void verificarTramaUBXsitl(const tramaUBX_t *trama, void *paramUsuario);
+void contarTramaUBXsitl(const tramaUBX_t *trama, void *paramUsuario);
+void alimentarAnilloUBXsitl(analizadorUBX_t *analizador, const uint8_t *flujo, uint32_t longitud, float usPorByte);
+uint32_t analizarPorBytesUBXsitl(const uint8_t *flujo, uint32_t longitud);
+void medirCosteUBXsitl(void);
+
+
+/***************************************************************************************
+** AREA DE DEFINICION DE FUNCIONES                                                    **
+****************************************************************************************/
+
+/***************************************************************************************
+**  Nombre:         uint32_t aleatorioUBXsitl(void)
+**  Descripcion:    Generador xorshift reproducible
+**  Parametros:     Ninguno
+**  Retorno:        Numero aleatorio
+****************************************************************************************/
+uint32_t aleatorioUBXsitl(void)
+{
+    semillaUBXsitl ^= semillaUBXsitl << 13;
+    semillaUBXsitl ^= semillaUBXsitl >> 17;
+    semillaUBXsitl ^= semillaUBXsitl << 5;
+    return semillaUBXsitl;
+}
+
+
+/***************************************************************************************
+**  Nombre:         void anadirTramaUBXsitl(uint8_t clase, uint8_t id, uint16_t longitud)
+**  Descripcion:    Anade a la grabacion una trama con payload aleatorio y la apunta en la lista
+**  Parametros:     Clase, identificador y longitud del payload
+**  Retorno:        Ninguno
+****************************************************************************************/
+void anadirTramaUBXsitl(uint8_t clase, uint8_t id, uint16_t longitud)
+{
+    uint8_t *trama = &grabacionUBXsitl[longitudGrabacionUBXsitl];
+    tramaGrabadaUBXsitl_t *grabada = &tramasUBXsitl[numTramasUBXsitl];
+
+    trama[0] = SYNC1_UBX;
+    trama[1] = SYNC2_UBX;
+    trama[2] = clase;
+    trama[3] = id;
+    trama[4] = longitud & 0xFF;
+    trama[5] = longitud >> 8;
+
+    // Payload con sincronismos de vez en cuando para probar los falsos inicios
+    for (uint16_t i = 0; i < longitud; i++) {
+        const uint32_t r = aleatorioUBXsitl();
+
+        trama[TAM_CABECERA_UBX + i] = (r % 23) == 0 ? SYNC1_UBX : (uint8_t)(r >> 8);
+    }
+
+    checksumUBX(&trama[2], TAM_CABECERA_UBX - 2 + longitud, &trama[TAM_CABECERA_UBX + longitud], &trama[TAM_CABECERA_UBX + longitud + 1]);
+
+    grabada->clase = clase;
+    grabada->id = id;
+    grabada->longitud = longitud;
+    grabada->inicio = longitudGrabacionUBXsitl;
+    grabada->fin = longitudGrabacionUBXsitl + TAM_CABECERA_UBX + longitud + TAM_CHECKSUM_UBX - 1;
+    grabada->intacta = true;
+
+    longitudGrabacionUBXsitl += TAM_CABECERA_UBX + longitud + TAM_CHECKSUM_UBX;
+    numTramasUBXsitl++;
+}
+
+
+/***************************************************************************************
+**  Nombre:         void anadirTextoUBXsitl(const char *texto)
+**  Descripcion:    Anade a la grabacion bytes que no son UBX
+**  Parametros:     Texto
+**  Retorno:        Ninguno
+****************************************************************************************/
+void anadirTextoUBXsitl(const char *texto)
+{
+    const uint32_t longitud = strlen(texto);
+
+    memcpy(&grabacionUBXsitl[longitudGrabacionUBXsitl], texto, longitud);
+    longitudGrabacionUBXsitl += longitud;
+}
+
+
+/***************************************************************************************
+**  Nombre:         void generarGrabacionUBXsitl(void)
+**  Descripcion:    Genera un flujo como el de un NEO a 10 Hz: NAV-PVT, NAV-POSLLH, NAV-VELNED,
+**                  NAV-STATUS y NAV-DOP en cada solucion, ACK y MON-VER de vez en cuando y
+**                  sentencias NMEA y bytes sueltos entre tramas
+**  Parametros:     Ninguno
+**  Retorno:        Ninguno
+****************************************************************************************/
+void generarGrabacionUBXsitl(void)
+{
+    const uint16_t margen = 2 * TAM_MAX_TRAMA_UBX;
+
+    semillaUBXsitl = 0x1F2E3D4C;
+    longitudGrabacionUBXsitl = 0;
+    numTramasUBXsitl = 0;
+
+    for (uint32_t n = 0; longitudGrabacionUBXsitl + margen < TAM_GRABACION_UBX_SITL && numTramasUBXsitl + 8 < NUM_MAX_TRAMAS_UBX_SITL; n++) {
+        anadirTramaUBXsitl(0x01, 0x07, 92);
+        anadirTramaUBXsitl(0x01, 0x02, 28);
+        anadirTramaUBXsitl(0x01, 0x12, 36);
+        anadirTramaUBXsitl(0x01, 0x03, 16);
+        anadirTramaUBXsitl(0x01, 0x04, 18);
+
+        if (n % 7 == 0)
+            anadirTramaUBXsitl(0x05, 0x01, 2);
+
+        if (n % 25 == 0)
+            anadirTramaUBXsitl(0x0A, 0x04, 40 + 30 * (aleatorioUBXsitl() % 5));
+
+        if (n % 10 == 0)
+            anadirTextoUBXsitl("$GPTXT,01,01,02,ANTSTATUS=OK*3B\r\n");
+
+        // Restos de una trama cortada
+        if (n % 13 == 0) {
+            grabacionUBXsitl[longitudGrabacionUBXsitl++] = SYNC1_UBX;
+            grabacionUBXsitl[longitudGrabacionUBXsitl++] = SYNC2_UBX;
+            grabacionUBXsitl[longitudGrabacionUBXsitl++] = 0x01;
+        }
+    }
+}
+
+
+/***************************************************************************************
+**  Nombre:         uint32_t corromperGrabacionUBXsitl(void)
+**  Descripcion:    Copia la grabacion cambiando, borrando o insertando bytes al azar y marca
+**                  las tramas afectadas
+**  Parametros:     Ninguno
+**  Retorno:        Longitud del flujo corrupto
+****************************************************************************************/
+uint32_t corromperGrabacionUBXsitl(void)
+{
+    const uint32_t umbral = (uint32_t)(PROB_CORRUPCION_UBX_SITL * 65536.0f);
+    uint32_t longitud = 0;
+    uint16_t trama = 0;
+
+    for (uint32_t i = 0; i < longitudGrabacionUBXsitl; i++) {
+        while (trama < numTramasUBXsitl && tramasUBXsitl[trama].fin < i)
+            trama++;
+
+        const bool dentro = trama < numTramasUBXsitl && tramasUBXsitl[trama].inicio <= i;
+
+        if ((aleatorioUBXsitl() & 0xFFFF) >= umbral) {
+            corruptaUBXsitl[longitud++] = grabacionUBXsitl[i];
+            continue;
+        }
+
+        // Insertar delante del inicio de una trama no la estropea
+        if (dentro && i != tramasUBXsitl[trama].inicio)
+            tramasUBXsitl[trama].intacta = false;
+
+        switch (aleatorioUBXsitl() % 4) {
+            case 0:
+                corruptaUBXsitl[longitud++] = grabacionUBXsitl[i] ^ (1 + aleatorioUBXsitl() % 255);
+                if (dentro)
+                    tramasUBXsitl[trama].intacta = false;
+                break;
+
+            case 1:
+                if (dentro)
+                    tramasUBXsitl[trama].intacta = false;
+                break;
+
+            case 2:
+                corruptaUBXsitl[longitud++] = SYNC1_UBX;
+                corruptaUBXsitl[longitud++] = SYNC2_UBX;
+                corruptaUBXsitl[longitud++] = grabacionUBXsitl[i];
+                break;
+
+            default:
+                corruptaUBXsitl[longitud++] = (uint8_t)aleatorioUBXsitl();
+                corruptaUBXsitl[longitud++] = grabacionUBXsitl[i];
+                break;
+        }
+    }
+
+    return longitud;
+}
+
+
+/***************************************************************************************
+**  Nombre:         void verificarTramaUBXsitl(const tramaUBX_t *trama, void *paramUsuario)
+**  Descripcion:    Busca la trama entregada en la grabacion a partir de la ultima recibida y
+**                  comprueba su contenido y el instante de llegada estimado
+**  Parametros:     Trama, verificacion
+**  Retorno:        Ninguno
+****************************************************************************************/
+void verificarTramaUBXsitl(const tramaUBX_t *trama, void *paramUsuario)
+{
+    verificacionUBXsitl_t *verificacion = paramUsuario;
+    const float usPorByte = 10.0e6f / BAUDRATE_UBX_SITL;
+
+    verificacion->recibidas++;
+
+    for (uint16_t i = verificacion->siguiente; i < numTramasUBXsitl; i++) {
+        const tramaGrabadaUBXsitl_t *grabada = &tramasUBXsitl[i];
+
+        if (grabada->clase != trama->clase || grabada->id != trama->id || grabada->longitud != trama->longitud ||
+            memcmp(&grabacionUBXsitl[grabada->inicio + TAM_CABECERA_UBX], trama->payload, trama->longitud) != 0)
+            continue;
+
+        if (i != verificacion->siguiente && verificacion->flujo == grabacionUBXsitl)
+            verificacion->desordenadas++;
+
+        if (grabada->intacta)
+            verificacion->intactasRecibidas++;
+
+        // Sin corrupcion el byte final de la trama llega en (fin + 1) bytes
+        if (verificacion->flujo == grabacionUBXsitl) {
+            const uint32_t esperado = (uint32_t)((grabada->fin + 1) * usPorByte);
+            const uint32_t error = trama->tiempoRecepcion > esperado ? trama->tiempoRecepcion - esperado : esperado - trama->tiempoRecepcion;
+
+            if (error > verificacion->errorTiempoMax)
+                verificacion->errorTiempoMax = error;
+        }
+
+        verificacion->siguiente = i + 1;
+        return;
+    }
+
+    verificacion->desconocidas++;
+}
+
+
+/***************************************************************************************
+**  Nombre:         void contarTramaUBXsitl(const tramaUBX_t *trama, void *paramUsuario)
+**  Descripcion:    Callback minimo para medir el coste del analisis
+**  Parametros:     Trama, no se usa
+**  Retorno:        Ninguno
+****************************************************************************************/
+void contarTramaUBXsitl(const tramaUBX_t *trama, void *paramUsuario)
+{
+    (void)paramUsuario;
+    sumideroUBXsitl += trama->payload[0] + trama->longitud;
+}
+
+
+/***************************************************************************************
+**  Nombre:         void alimentarAnilloUBXsitl(analizadorUBX_t *analizador, const uint8_t *flujo, uint32_t longitud,
+**                                              float usPorByte)
+**  Descripcion:    Pasa el flujo por un buffer circular como el de la UART, con llegadas de
+**                  longitud aleatoria, y lo lee por bloques igual que leerGPSublox
+**  Parametros:     Analizador, flujo, longitud del flujo, tiempo de un byte en us
+**  Retorno:        Ninguno
+****************************************************************************************/
+void alimentarAnilloUBXsitl(analizadorUBX_t *analizador, const uint8_t *flujo, uint32_t longitud, float usPorByte)
+{
+    static uint8_t anillo[TAM_ANILLO_UBX_SITL];
+    uint16_t cabeza = 0, cola = 0;
+    uint32_t escritos = 0;
+
+    while (escritos < longitud) {
+        const uint16_t pendientes = (cabeza + TAM_ANILLO_UBX_SITL - cola) % TAM_ANILLO_UBX_SITL;
+        uint32_t llegada = 1 + aleatorioUBXsitl() % MAX_BYTES_LLEGADA_UBX_SITL;
+
+        llegada = MIN(llegada, TAM_ANILLO_UBX_SITL - 1 - pendientes);
+        llegada = MIN(llegada, longitud - escritos);
+
+        for (uint32_t i = 0; i < llegada; i++) {
+            anillo[cabeza] = flujo[escritos++];
+            cabeza = (cabeza + 1) % TAM_ANILLO_UBX_SITL;
+        }
+
+        const uint32_t tiempoLectura = (uint32_t)(escritos * usPorByte);
+
+        for (uint8_t i = 0; i < 2; i++) {
+            const uint16_t bloque = cabeza >= cola ? cabeza - cola : TAM_ANILLO_UBX_SITL - cola;
+            const uint16_t disponibles = (cabeza + TAM_ANILLO_UBX_SITL - cola) % TAM_ANILLO_UBX_SITL;
+
+            if (bloque == 0)
+                break;
+
+            const uint16_t consumidos = analizarBloqueUBX(analizador, &anillo[cola], bloque, disponibles - bloque, tiempoLectura,
+            		                                      bloque == disponibles);
+
+            cola = (cola + consumidos) % TAM_ANILLO_UBX_SITL;
+
+            if (consumidos < bloque)
+                break;
+        }
+    }
+}
+
+
+/***************************************************************************************
+**  Nombre:         uint32_t analizarPorBytesUBXsitl(const uint8_t *flujo, uint32_t longitud)
+**  Descripcion:    Referencia byte a byte con la maquina de estados anterior: cada byte pasa
+**                  por el switch, actualiza el checksum y se copia al buffer del payload
+**  Parametros:     Flujo, longitud
+**  Retorno:        Tramas validas
+****************************************************************************************/
+uint32_t analizarPorBytesUBXsitl(const uint8_t *flujo, uint32_t longitud)
+{
+    static uint8_t buffer[TAM_MAX_PAYLOAD_UBX];
+    uint8_t estado = 0, ckA = 0, ckB = 0;
+    uint16_t longitudPayload = 0, contador = 0;
+    uint32_t tramas = 0;
+
+    for (uint32_t i = 0; i < longitud; i++) {
+        const uint8_t dato = flujo[i];
+
+      reset:
+        switch (estado) {
+            case 1:
+                if (dato == SYNC2_UBX) {
+                    estado++;
+                    break;
+                }
+                estado = 0;
+                FALLTHROUGH;
+
+            case 0:
+                if (dato == SYNC1_UBX)
+                    estado++;
+                break;
+
+            case 2:
+                estado++;
+                ckB = ckA = dato;
+                break;
+
+            case 3:
+                estado++;
+                ckB += (ckA += dato);
+                break;
+
+            case 4:
+                estado++;
+                ckB += (ckA += dato);
+                longitudPayload = dato;
+                break;
+
+            case 5:
+                estado++;
+                ckB += (ckA += dato);
+                longitudPayload += (uint16_t)(dato << 8);
+                if (longitudPayload > TAM_MAX_PAYLOAD_UBX) {
+                    estado = 0;
+                    goto reset;
+                }
+                if (longitudPayload == 0)
+                    estado = 7;
+                contador = 0;
+                break;
+
+            case 6:
+                ckB += (ckA += dato);
+                buffer[contador++] = dato;
+                if (contador == longitudPayload)
+                    estado++;
+                break;
+
+            case 7:
+                estado++;
+                if (ckA != dato) {
+                    estado = 0;
+                    goto reset;
+                }
+                break;
+
+            case 8:
+                estado = 0;
+                if (ckB == dato) {
+                    sumideroUBXsitl += buffer[0] + longitudPayload;
+                    tramas++;
+                }
+                break;
+        }
+    }
+
+    return tramas;
+}
+
+
+/***************************************************************************************
+**  Nombre:         void medirCosteUBXsitl(void)
+**  Descripcion:    Bytes por us analizados byte a byte y por bloques sobre la grabacion limpia
+**  Parametros:     Ninguno
+**  Retorno:        Ninguno
+****************************************************************************************/
+void medirCosteUBXsitl(void)
+{
+    static analizadorUBX_t analizador;
+    const double bytes = (double)longitudGrabacionUBXsitl * NUM_PASADAS_COSTE_UBX_SITL;
+    uint32_t tramasBytes = 0;
+    uint64_t inicio;
+    double nsBytes, nsBloques;
+
+    inicio = nanosegundosHostSITL();
+    for (uint16_t n = 0; n < NUM_PASADAS_COSTE_UBX_SITL; n++)
+        tramasBytes += analizarPorBytesUBXsitl(grabacionUBXsitl, longitudGrabacionUBXsitl);
+    nsBytes = (double)(nanosegundosHostSITL() - inicio);
+
+    iniciarAnalizadorUBX(&analizador, BAUDRATE_UBX_SITL, contarTramaUBXsitl, NULL);
+
+    inicio = nanosegundosHostSITL();
+    for (uint16_t n = 0; n < NUM_PASADAS_COSTE_UBX_SITL; n++) {
+        uint32_t posicion = 0;
+
+        // Los bloques son mas largos que la trama maxima, asi que siempre se avanza
+        while (posicion < longitudGrabacionUBXsitl) {
+            const uint32_t fin = MIN(posicion + TAM_BLOQUE_COSTE_UBX_SITL, longitudGrabacionUBXsitl);
+
+            posicion += analizarBloqueUBX(&analizador, &grabacionUBXsitl[posicion], fin - posicion, 0, 0, fin < longitudGrabacionUBXsitl);
+
+            if (fin == longitudGrabacionUBXsitl)
+                break;
+        }
+    }
+    nsBloques = (double)(nanosegundosHostSITL() - inicio);
+
+    printf("  Coste (bytes/us): byte a byte %.1f, por bloques %.1f (x%.1f) | tramas %u / %u\n", bytes * 1000.0 / nsBytes,
+           bytes * 1000.0 / nsBloques, nsBytes / nsBloques, tramasBytes / NUM_PASADAS_COSTE_UBX_SITL,
+           analizador.estadisticas.numTramas / NUM_PASADAS_COSTE_UBX_SITL);
+}
+
+
+/***************************************************************************************
+**  Nombre:         void probarAnalizadorUBXsitl(void)
+**  Descripcion:    Analiza la grabacion troceada al azar a traves de un buffer circular, la
+**                  misma grabacion corrompida y mide el coste frente al analisis byte a byte
+**  Parametros:     Ninguno
+**  Retorno:        Ninguno
+****************************************************************************************/
+void probarAnalizadorUBXsitl(void)
+{
+    static analizadorUBX_t analizador;
+    verificacionUBXsitl_t *verificacion = &verificacionUBXsitl;
+    const float usPorByte = 10.0e6f / BAUDRATE_UBX_SITL;
+    bool ok;
+
+    printf("\nAnalizador de tramas UBX (SITL)\n");
+
+    generarGrabacionUBXsitl();
+
+    // Flujo limpio: todas las tramas en orden, con el contenido y el instante de llegada correctos
+    memset(verificacion, 0, sizeof(*verificacion));
+    verificacion->flujo = grabacionUBXsitl;
+    iniciarAnalizadorUBX(&analizador, BAUDRATE_UBX_SITL, verificarTramaUBXsitl, verificacion);
+    alimentarAnilloUBXsitl(&analizador, grabacionUBXsitl, longitudGrabacionUBXsitl, usPorByte);
+
+    const estadisticasAnalizadorUBX_t limpio = analizador.estadisticas;
+    const verificacionUBXsitl_t verificacionLimpio = *verificacion;
+
+    printf("  Limpio: %u bytes, tramas %u/%u (%u reensambladas), desordenadas %u, error del instante de llegada %u us\n",
+           longitudGrabacionUBXsitl, verificacionLimpio.recibidas, numTramasUBXsitl, limpio.numReensambladas,
+           verificacionLimpio.desordenadas, verificacionLimpio.errorTiempoMax);
+
+    ok = verificacionLimpio.recibidas == numTramasUBXsitl && verificacionLimpio.intactasRecibidas == numTramasUBXsitl &&
+         verificacionLimpio.desordenadas == 0 && verificacionLimpio.desconocidas == 0 && limpio.numReensambladas > 0 &&
+         verificacionLimpio.errorTiempoMax <= ERROR_MAX_TIEMPO_UBX_SITL;
+
+    // Flujo corrupto: se tienen que recuperar todas las tramas que no se han tocado
+    const uint32_t longitudCorrupta = corromperGrabacionUBXsitl();
+    uint16_t intactas = 0;
+
+    for (uint16_t i = 0; i < numTramasUBXsitl; i++) {
+        if (tramasUBXsitl[i].intacta)
+            intactas++;
+    }
+
+    memset(verificacion, 0, sizeof(*verificacion));
+    verificacion->flujo = corruptaUBXsitl;
+    iniciarAnalizadorUBX(&analizador, BAUDRATE_UBX_SITL, verificarTramaUBXsitl, verificacion);
+    alimentarAnilloUBXsitl(&analizador, corruptaUBXsitl, longitudCorrupta, usPorByte);
+
+    printf("  Corrupto: tramas intactas recuperadas %u/%u, tocadas entregadas %u, desconocidas %u | checksum %u, longitud %u, "
+           "bytes descartados %u\n", verificacion->intactasRecibidas, intactas, verificacion->recibidas - verificacion->intactasRecibidas -
+           verificacion->desconocidas, verificacion->desconocidas, analizador.estadisticas.numErroresChecksum,
+           analizador.estadisticas.numLongitudInvalida, analizador.estadisticas.bytesDescartados);
+
+    ok = ok && intactas < numTramasUBXsitl && verificacion->intactasRecibidas == intactas && verificacion->desconocidas == 0 &&
+         analizador.estadisticas.numErroresChecksum > 0;
+
+    medirCosteUBXsitl();
+
+    printf("  Resultado: %s\n", ok ? "ok" : "fallo");
+}
+
+#endif
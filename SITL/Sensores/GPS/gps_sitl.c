@@ -0,0 +1,202 @@
+/***************************************************************************************
+**  gps_sitl.c - Generador de tramas UBX del GPS simulado. Construye mensajes NAV-PVT
+**               a partir del modelo fisico y los inyecta en la UART del GPS
+**
+**
+**  Este fichero forma parte del proyecto URpilot.
+**  Codigo desarrollado por el grupo de investigacion ICON de la Universidad de La Rioja
+**
+**  Autor: Ramon Rico
+**  Fecha de creacion: 17/10/2026
+**  Fecha de modificacion: 17/10/2026
+**
+**  El proyecto URpilot NO es libre. No se puede distribuir y/o modificar este fichero
+**  bajo ningun concepto.
+**
+**  En caso de modificacion y/o solicitud de informacion pongase en contacto con
+**  el grupo de investigacion ICON a traves de: www.unirioja.es/urpilot
+**
+**
+**  Control de versiones del fichero
+**
+**  v1.0  Ramon Rico. Se ha liberado la primera version estable
+**
+****************************************************************************************/
+
+/***************************************************************************************
+** AREA DE INCLUDES                                                                   **
+****************************************************************************************/
+#include <string.h>
+#include <math.h>
+
+#include "gps_sitl.h"
+#include "Sensores/GPS/gps_ublox.h"
+
+#ifdef USAR_GPS
+#include "GP/gp_gps.h"
+#include "Drivers/uart_sitl.h"
+#include "Fisica/fisica.h"
+
+
+/***************************************************************************************
+** AREA DE PREPROCESADOR                                                              **
+****************************************************************************************/
+#define CLASE_NAV_UBX_SITL          0x01
+#define ID_NAV_PVT_UBX_SITL         0x07
+#define TAM_TRAMA_PVT_UBX_SITL      (sizeof(headerUBX_t) + sizeof(navPVTubx_t) + 2)
+
+#define ITOW_INICIAL_GPS_SITL       475200000U  // Sabado a las 12:00 en ms de semana GPS
+#define NUM_SATELITES_GPS_SITL      12
+
+
+/***************************************************************************************
+** AREA DE DEFINICION DE TIPOS                                                        **
+****************************************************************************************/
+typedef struct {
+    uint64_t ultimoEnvio;
+    bool iniciado;
+} gpsSITL_t;
+
+
+/***************************************************************************************
+** AREA DE DECLARACION DE VARIABLES                                                   **
+****************************************************************************************/
+static gpsSITL_t gpsSITL;
+
+
+/***************************************************************************************
+** AREA DE PROTOTIPOS DE FUNCION                                                      **
+****************************************************************************************/
+static void construirPVTgpsSITL(navPVTubx_t *pvt, uint64_t tiempoUs);
+static void enviarTramaUBXgpsSITL(uint8_t clase, uint8_t id, const uint8_t *payload, uint16_t longitud);
+
+
+/***************************************************************************************
+** AREA DE DEFINICION DE FUNCIONES                                                    **
+****************************************************************************************/
+
+/***************************************************************************************
+**  Nombre:         void iniciarGPSsitl(void)
+**  Descripcion:    Inicia el generador de tramas
+**  Parametros:     Ninguno
+**  Retorno:        Ninguno
+****************************************************************************************/
+void iniciarGPSsitl(void)
+{
+    memset(&gpsSITL, 0, sizeof(gpsSITL));
+    gpsSITL.iniciado = true;
+}
+
+
+/***************************************************************************************
+**  Nombre:         void actualizarGPSsitl(uint64_t tiempoUs)
+**  Descripcion:    Envia un NAV-PVT cada periodo de navegacion
+**  Parametros:     Tiempo de simulacion en us
+**  Retorno:        Ninguno
+****************************************************************************************/
+void actualizarGPSsitl(uint64_t tiempoUs)
+{
+    navPVTubx_t pvt;
+
+    if (!gpsSITL.iniciado || tiempoUs - gpsSITL.ultimoEnvio < PERIODO_GPS_SITL_US)
+        return;
+
+    gpsSITL.ultimoEnvio = tiempoUs;
+
+    construirPVTgpsSITL(&pvt, tiempoUs);
+    enviarTramaUBXgpsSITL(CLASE_NAV_UBX_SITL, ID_NAV_PVT_UBX_SITL, (const uint8_t *)&pvt, sizeof(pvt));
+}
+
+
+/***************************************************************************************
+**  Nombre:         void construirPVTgpsSITL(navPVTubx_t *pvt, uint64_t tiempoUs)
+**  Descripcion:    Rellena el mensaje NAV-PVT con el estado del modelo fisico
+**  Parametros:     Mensaje a rellenar, tiempo de simulacion en us
+**  Retorno:        Ninguno
+****************************************************************************************/
+static void construirPVTgpsSITL(navPVTubx_t *pvt, uint64_t tiempoUs)
+{
+    const estadoFisica_t *estado = estadoFisica();
+    const uint32_t tiempoMs = (uint32_t)(tiempoUs / 1000);
+    double lat, lon;
+    float alt;
+
+    posicionGeodesicaFisica(&lat, &lon, &alt);
+
+    memset(pvt, 0, sizeof(*pvt));
+
+    // Tiempo
+    pvt->itow = ITOW_INICIAL_GPS_SITL + tiempoMs;
+    pvt->year = 2026;
+    pvt->month = 10;
+    pvt->day = 17;
+    pvt->hour = 12 + tiempoMs / 3600000;
+    pvt->min = (tiempoMs / 60000) % 60;
+    pvt->sec = (tiempoMs / 1000) % 60;
+    pvt->valid = 0x07;
+    pvt->tAcc = 50;
+    pvt->nano = (tiempoMs % 1000) * 1000000;
+
+    // Posicion
+    pvt->fixType = 3;
+    pvt->flags = 0x01;
+    pvt->numSv = NUM_SATELITES_GPS_SITL;
+    pvt->lon = (int32_t)lround(lon * 1.0e7);
+    pvt->lat = (int32_t)lround(lat * 1.0e7);
+    pvt->height = (int32_t)lroundf(alt * 1000.0f);
+    pvt->h_msl = pvt->height;
+    pvt->hAcc = 1500;
+    pvt->vAcc = 2000;
+
+    // Velocidad
+    pvt->velN = (int32_t)lroundf(estado->velocidad[0] * 1000.0f);
+    pvt->velE = (int32_t)lroundf(estado->velocidad[1] * 1000.0f);
+    pvt->velD = (int32_t)lroundf(estado->velocidad[2] * 1000.0f);
+    pvt->gspeed = (int32_t)lroundf(sqrtf(estado->velocidad[0] * estado->velocidad[0] + estado->velocidad[1] * estado->velocidad[1]) * 1000.0f);
+
+    float rumbo = atan2f(estado->velocidad[1], estado->velocidad[0]) * 57.29578f;
+    if (rumbo < 0)
+        rumbo += 360;
+
+    pvt->head_mot = (int32_t)lroundf(rumbo * 1.0e5f);
+    pvt->sAcc = 300;
+    pvt->headAcc = 500000;
+    pvt->pDop = 120;
+}
+
+
+/***************************************************************************************
+**  Nombre:         void enviarTramaUBXgpsSITL(uint8_t clase, uint8_t id, const uint8_t *payload, uint16_t longitud)
+**  Descripcion:    Empaqueta un mensaje UBX con su checksum y lo entrega a la UART del GPS
+**  Parametros:     Clase, identificador, payload y longitud del payload
+**  Retorno:        Ninguno
+****************************************************************************************/
+static void enviarTramaUBXgpsSITL(uint8_t clase, uint8_t id, const uint8_t *payload, uint16_t longitud)
+{
+    uint8_t trama[TAM_TRAMA_PVT_UBX_SITL];
+    headerUBX_t *cabecera = (headerUBX_t *)trama;
+    uint8_t ckA = 0, ckB = 0;
+
+    if (longitud + sizeof(headerUBX_t) + 2 > sizeof(trama))
+        return;
+
+    cabecera->preamble1 = 0xB5;
+    cabecera->preamble2 = 0x62;
+    cabecera->msgClass = clase;
+    cabecera->msgId = id;
+    cabecera->length = longitud;
+    memcpy(&trama[sizeof(headerUBX_t)], payload, longitud);
+
+    // Checksum de Fletcher desde la clase hasta el final del payload
+    for (uint16_t i = 2; i < sizeof(headerUBX_t) + longitud; i++) {
+        ckA += trama[i];
+        ckB += ckA;
+    }
+
+    trama[sizeof(headerUBX_t) + longitud] = ckA;
+    trama[sizeof(headerUBX_t) + longitud + 1] = ckB;
+
+    recibirBufferUART(configGPS(0)->dispUART, trama, sizeof(headerUBX_t) + longitud + 2);
+}
+
+#endif
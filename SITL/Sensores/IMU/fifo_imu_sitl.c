@@ -0,0 +1,252 @@
+/***************************************************************************************
+**  fifo_imu_sitl.c - Prueba del lector de la FIFO de las IMU Invensense. Se alimenta con un flujo
+**                    de bytes grabado en una FIFO modelada y se fuerzan desalineamientos y desbordes
+**
+**
+**  Este fichero forma parte del proyecto URpilot.
+**  Codigo desarrollado por el grupo de investigacion ICON de la Universidad de La Rioja
+**
+**  Autor: Ramon Rico
+**  Fecha de creacion: 17/10/2026
+**  Fecha de modificacion: 17/10/2026
+**
+**  El proyecto URpilot NO es libre. No se puede distribuir y/o modificar este fichero
+**  bajo ningun concepto.
+**
+**  En caso de modificacion y/o solicitud de informacion pongase en contacto con
+**  el grupo de investigacion ICON a traves de: www.unirioja.es/urpilot
+**
+**
+**  Control de versiones del fichero
+**
+**  v1.0  Ramon Rico. Se ha liberado la primera version estable
+**
+****************************************************************************************/
+
+/***************************************************************************************
+** AREA DE INCLUDES                                                                   **
+****************************************************************************************/
+#include <stdio.h>
+#include <string.h>
+
+#include "Core/pruebas_sitl.h"
+#include "Sensores/IMU/imu.h"
+
+#if defined(USAR_IMU) && defined(SITL)
+#include "Sensores/IMU/imu_invensense.h"
+
+
+/***************************************************************************************
+** AREA DE PREPROCESADOR                                                              **
+****************************************************************************************/
+#define TAM_FIFO_PRUEBA_SITL             1024        // Como la del MPU6000
+#define MAX_MUESTRAS_RAFAGA_SITL         16
+#define MUESTRAS_POR_CICLO_SITL          8           // Muestras a 8kHz entre lecturas a 1kHz
+#define CICLOS_PRUEBA_FIFO_SITL          2000
+#define CICLO_DESALINEADO_SITL           500         // Se pierden bytes en el bus
+#define BYTES_PERDIDOS_SITL              3
+#define CICLO_PARADA_SITL                1200        // El lector deja de leer y la FIFO se desborda
+#define CICLOS_PARADA_SITL               20
+#define TEMP_BASE_FIFO_SITL              3000
+
+
+/***************************************************************************************
+** AREA DE DEFINICION DE TIPOS                                                        **
+****************************************************************************************/
+typedef struct {
+    uint8_t datos[TAM_FIFO_PRUEBA_SITL];
+    uint16_t inicio;
+    uint16_t cuenta;
+} fifoModeladaSITL_t;
+
+typedef struct {
+    uint32_t numGeneradas;
+    uint32_t numAceptadas;
+    uint32_t numDuplicadas;
+    uint32_t numFalsas;
+    uint32_t numResets;
+    int32_t ultimoIndice;
+    int32_t cicloDeteccion;
+} resultadoFifoSITL_t;
+
+
+/***************************************************************************************
+** AREA DE DECLARACION DE VARIABLES                                                   **
+****************************************************************************************/
+static fifoModeladaSITL_t fifoModelada;
+
+
+/***************************************************************************************
+** AREA DE PROTOTIPOS DE FUNCION                                                      **
+****************************************************************************************/
+void generarMuestraFifoSITL(uint32_t indice, int16_t *adc);
+void escribirMuestraFifoSITL(uint32_t indice);
+void leerFifoModeladaSITL(uint8_t *buffer, uint16_t longitud);
+void comprobarMuestraFifoSITL(const int16_t *adc, resultadoFifoSITL_t *resultado);
+
+
+/***************************************************************************************
+** AREA DE DEFINICION DE FUNCIONES                                                    **
+****************************************************************************************/
+
+/***************************************************************************************
+**  Nombre:         void generarMuestraFifoSITL(uint32_t indice, int16_t *adc)
+**  Descripcion:    Genera la muestra grabada. El indice va en el giro X e Y para poder
+**                  reconocer perdidas, duplicados y muestras falsas
+**  Parametros:     Indice de la muestra, valores del adc
+**  Retorno:        Ninguno
+****************************************************************************************/
+void generarMuestraFifoSITL(uint32_t indice, int16_t *adc)
+{
+    adc[0] = 100 + (indice % 50);
+    adc[1] = -200;
+    adc[2] = 2048;
+    adc[3] = TEMP_BASE_FIFO_SITL + indice / 1000;
+    adc[4] = indice & 0x7FFF;
+    adc[5] = indice >> 15;
+    adc[6] = -(int16_t)(indice % 300);
+}
+
+
+/***************************************************************************************
+**  Nombre:         void escribirMuestraFifoSITL(uint32_t indice)
+**  Descripcion:    Mete una muestra en la FIFO modelada. Llena, sobrescribe los bytes mas
+**                  antiguos como el sensor
+**  Parametros:     Indice de la muestra
+**  Retorno:        Ninguno
+****************************************************************************************/
+void escribirMuestraFifoSITL(uint32_t indice)
+{
+    int16_t adc[7];
+
+    generarMuestraFifoSITL(indice, adc);
+
+    for (uint8_t i = 0; i < 2 * 7; i++) {
+        const uint8_t byte = (i & 1) ? adc[i / 2] & 0xFF : (uint16_t)adc[i / 2] >> 8;
+
+        fifoModelada.datos[(fifoModelada.inicio + fifoModelada.cuenta) % TAM_FIFO_PRUEBA_SITL] = byte;
+        if (fifoModelada.cuenta < TAM_FIFO_PRUEBA_SITL)
+            fifoModelada.cuenta++;
+        else
+            fifoModelada.inicio = (fifoModelada.inicio + 1) % TAM_FIFO_PRUEBA_SITL;
+    }
+}
+
+
+/***************************************************************************************
+**  Nombre:         void leerFifoModeladaSITL(uint8_t *buffer, uint16_t longitud)
+**  Descripcion:    Saca bytes de la FIFO modelada como una lectura de FIFO_R_W
+**  Parametros:     Buffer destino, numero de bytes
+**  Retorno:        Ninguno
+****************************************************************************************/
+void leerFifoModeladaSITL(uint8_t *buffer, uint16_t longitud)
+{
+    for (uint16_t i = 0; i < longitud && fifoModelada.cuenta > 0; i++) {
+        if (buffer != NULL)
+            buffer[i] = fifoModelada.datos[fifoModelada.inicio];
+
+        fifoModelada.inicio = (fifoModelada.inicio + 1) % TAM_FIFO_PRUEBA_SITL;
+        fifoModelada.cuenta--;
+    }
+}
+
+
+/***************************************************************************************
+**  Nombre:         void comprobarMuestraFifoSITL(const int16_t *adc, resultadoFifoSITL_t *resultado)
+**  Descripcion:    Compara una muestra aceptada con la grabada
+**  Parametros:     Valores del adc, resultado de la prueba
+**  Retorno:        Ninguno
+****************************************************************************************/
+void comprobarMuestraFifoSITL(const int16_t *adc, resultadoFifoSITL_t *resultado)
+{
+    const int32_t indice = (uint16_t)adc[4] | ((int32_t)adc[5] << 15);
+    int16_t esperado[7];
+
+    generarMuestraFifoSITL(indice, esperado);
+
+    if (memcmp(adc, esperado, sizeof(esperado)) != 0)
+        resultado->numFalsas++;
+    else if (indice <= resultado->ultimoIndice)
+        resultado->numDuplicadas++;
+
+    resultado->ultimoIndice = indice;
+    resultado->numAceptadas++;
+}
+
+
+/***************************************************************************************
+**  Nombre:         void probarFifoIMUsitl(void)
+**  Descripcion:    Descarga la FIFO modelada con el parser del driver. Se pierden bytes a
+**                  mitad de un paquete y se para el lector hasta desbordar la FIFO: en ambos
+**                  casos el parser debe pedir el reset y no entregar muestras falsas
+**  Parametros:     Ninguno
+**  Retorno:        Ninguno
+****************************************************************************************/
+void probarFifoIMUsitl(void)
+{
+    uint8_t rafaga[MAX_MUESTRAS_RAFAGA_SITL * INVENSENSE_SAMPLE_SIZE];
+    fifoInvensense_t fifo;
+    resultadoFifoSITL_t resultado;
+    uint32_t indiceTrasParada = 0;
+
+    memset(&fifoModelada, 0, sizeof(fifoModelada));
+    memset(&fifo, 0, sizeof(fifo));
+    memset(&resultado, 0, sizeof(resultado));
+    resultado.ultimoIndice = -1;
+    resultado.cicloDeteccion = -1;
+
+    for (uint32_t ciclo = 0; ciclo < CICLOS_PRUEBA_FIFO_SITL; ciclo++) {
+        for (uint8_t i = 0; i < MUESTRAS_POR_CICLO_SITL; i++)
+            escribirMuestraFifoSITL(resultado.numGeneradas++);
+
+        if (ciclo == CICLO_DESALINEADO_SITL)
+            leerFifoModeladaSITL(NULL, BYTES_PERDIDOS_SITL);
+
+        if (ciclo >= CICLO_PARADA_SITL && ciclo < CICLO_PARADA_SITL + CICLOS_PARADA_SITL)
+            continue;
+
+        if (ciclo == CICLO_PARADA_SITL + CICLOS_PARADA_SITL)
+            indiceTrasParada = resultado.numGeneradas;
+
+        // Misma secuencia que el driver: cuenta, rafaga de muestras completas y reset si hace falta
+        uint8_t numMuestras;
+        bool resetear = false;
+        const estadoFifoInvensense_e estado = comprobarCuentaFifoInvensense(&fifo, fifoModelada.cuenta, TAM_FIFO_PRUEBA_SITL,
+                                                                           MAX_MUESTRAS_RAFAGA_SITL, &numMuestras);
+        if (estado == FIFO_INVENSENSE_DESBORDADA)
+            resetear = true;
+        else if (estado == FIFO_INVENSENSE_OK) {
+            leerFifoModeladaSITL(rafaga, numMuestras * INVENSENSE_SAMPLE_SIZE);
+
+            for (uint8_t i = 0; i < numMuestras; i++) {
+                int16_t adc[7];
+
+                if (!decodificarMuestraFifoInvensense(&fifo, &rafaga[i * INVENSENSE_SAMPLE_SIZE], adc)) {
+                    if (resultado.cicloDeteccion < 0)
+                        resultado.cicloDeteccion = ciclo;
+
+                    resetear = true;
+                    break;
+                }
+
+                comprobarMuestraFifoSITL(adc, &resultado);
+            }
+        }
+
+        if (resetear) {
+            leerFifoModeladaSITL(NULL, fifoModelada.cuenta);
+            resetearFifoInvensense(&fifo);
+            resultado.numResets++;
+        }
+    }
+
+    printf("\nFIFO Invensense (SITL)\n");
+    printf("  Muestras: generadas %u, aceptadas %u, perdidas %u | duplicadas %u, falsas %u\n",
+           resultado.numGeneradas, resultado.numAceptadas, resultado.numGeneradas - resultado.numAceptadas,
+           resultado.numDuplicadas, resultado.numFalsas);
+    printf("  Desalineamiento en el ciclo %u: detectado en el ciclo %d | desbordes %u, resets %u, recuperada %s\n",
+           CICLO_DESALINEADO_SITL, resultado.cicloDeteccion, fifo.numDesbordes, resultado.numResets,
+           resultado.ultimoIndice >= (int32_t)indiceTrasParada ? "si" : "no");
+}
+
+#endif
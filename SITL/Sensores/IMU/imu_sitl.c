@@ -0,0 +1,168 @@
+/***************************************************************************************
+**  imu_sitl.c - Driver de la IMU simulada. Las medidas las genera el modelo fisico
+**
+**
+**  Este fichero forma parte del proyecto URpilot.
+**  Codigo desarrollado por el grupo de investigacion ICON de la Universidad de La Rioja
+**
+**  Autor: Ramon Rico
+**  Fecha de creacion: 17/10/2026
+**  Fecha de modificacion: 17/10/2026
+**
+**  El proyecto URpilot NO es libre. No se puede distribuir y/o modificar este fichero
+**  bajo ningun concepto.
+**
+**  En caso de modificacion y/o solicitud de informacion pongase en contacto con
+**  el grupo de investigacion ICON a traves de: www.unirioja.es/urpilot
+**
+**
+**  Control de versiones del fichero
+**
+**  v1.0  Ramon Rico. Se ha liberado la primera version estable
+**
+****************************************************************************************/
+
+/***************************************************************************************
+** AREA DE INCLUDES                                                                   **
+****************************************************************************************/
+#include <string.h>
+
+#include "Sensores/IMU/imu.h"
+
+#if defined(USAR_IMU) && defined(SITL)
+#include "Drivers/tiempo.h"
+#include "Fisica/fisica.h"
+
+
+/***************************************************************************************
+** AREA DE PREPROCESADOR                                                              **
+****************************************************************************************/
+#define RUIDO_ACEL_IMU_SITL         0.01f       // g
+#define RUIDO_GIRO_IMU_SITL         0.3f        // º/s
+#define RUIDO_TEMP_IMU_SITL         0.05f       // ºC
+#define RANGO_GIRO_IMU_SITL         2000.0f     // º/s. Como las Invensense
+#define RANGO_ACEL_IMU_SITL         16.0f       // g
+
+
+/***************************************************************************************
+** AREA DE DEFINICION DE TIPOS                                                        **
+****************************************************************************************/
+typedef struct {
+    acumulador7_t acumulador;
+} imuSITL_t;
+
+
+/***************************************************************************************
+** AREA DE DECLARACION DE VARIABLES                                                   **
+****************************************************************************************/
+static imuSITL_t imuSITL[NUM_MAX_IMU];
+
+
+/***************************************************************************************
+** AREA DE PROTOTIPOS DE FUNCION                                                      **
+****************************************************************************************/
+bool iniciarIMUsitl(imu_t *dIMU);
+void leerIMUsitl(imu_t *dIMU);
+void actualizarIMUsitl(imu_t *dIMU);
+
+
+/***************************************************************************************
+** AREA DE DEFINICION DE FUNCIONES                                                    **
+****************************************************************************************/
+
+/***************************************************************************************
+**  Nombre:         bool iniciarIMUsitl(imu_t *dIMU)
+**  Descripcion:    Inicia el sensor
+**  Parametros:     Puntero al sensor
+**  Retorno:        True si ok
+****************************************************************************************/
+bool iniciarIMUsitl(imu_t *dIMU)
+{
+    imuSITL_t *driver = &imuSITL[dIMU->numIMU];
+    dIMU->driver = driver;
+    dIMU->rangoGiro = RANGO_GIRO_IMU_SITL;
+    dIMU->rangoAcel = RANGO_ACEL_IMU_SITL;
+
+    memset(driver, 0, sizeof(*driver));
+    return true;
+}
+
+
+/***************************************************************************************
+**  Nombre:         void leerIMUsitl(imu_t *dIMU)
+**  Descripcion:    Calcula la media de las muestras acumuladas
+**  Parametros:     Puntero a la IMU
+**  Retorno:        Ninguno
+****************************************************************************************/
+void leerIMUsitl(imu_t *dIMU)
+{
+    imuSITL_t *driver = dIMU->driver;
+    float medidaIMU[7];
+    uint8_t cuentaIMU = driver->acumulador.contador;
+    uint32_t tiempo = micros();
+
+    if (cuentaIMU == 0)
+        return;
+
+    for (uint8_t i = 0; i < 7; i++)
+        medidaIMU[i] = driver->acumulador.acumulado[i] / cuentaIMU;
+
+    memset(&driver->acumulador, 0, sizeof(driver->acumulador));
+
+    if (dIMU->acel[0] != medidaIMU[0] || dIMU->acel[1] != medidaIMU[1] || dIMU->acel[2] != medidaIMU[2] || dIMU->temperatura != medidaIMU[3] ||
+        dIMU->giro[0] != medidaIMU[4] || dIMU->giro[1] != medidaIMU[5] || dIMU->giro[2] != medidaIMU[6])
+    	dIMU->timing.ultimoCambio = tiempo;
+
+    dIMU->acel[0] = medidaIMU[0];
+    dIMU->acel[1] = medidaIMU[1];
+    dIMU->acel[2] = medidaIMU[2];
+    dIMU->temperatura = medidaIMU[3];
+    dIMU->giro[0] = medidaIMU[4];
+    dIMU->giro[1] = medidaIMU[5];
+    dIMU->giro[2] = medidaIMU[6];
+    dIMU->timing.ultimaMedida = tiempo;
+    dIMU->nuevaMedida = true;
+}
+
+
+/***************************************************************************************
+**  Nombre:         void actualizarIMUsitl(imu_t *dIMU)
+**  Descripcion:    Toma una muestra del modelo fisico
+**  Parametros:     Puntero a la IMU
+**  Retorno:        Ninguno
+****************************************************************************************/
+void actualizarIMUsitl(imu_t *dIMU)
+{
+    imuSITL_t *driver = dIMU->driver;
+    float acel[3], giro[3];
+    float imuRaw[7];
+
+    acelCuerpoFisica(acel);
+    giroCuerpoFisica(giro);
+
+    imuRaw[0] = acel[0] + ruidoFisica(RUIDO_ACEL_IMU_SITL);
+    imuRaw[1] = acel[1] + ruidoFisica(RUIDO_ACEL_IMU_SITL);
+    imuRaw[2] = acel[2] + ruidoFisica(RUIDO_ACEL_IMU_SITL);
+    imuRaw[3] = temperaturaFisica() + 20.0f + ruidoFisica(RUIDO_TEMP_IMU_SITL);
+    imuRaw[4] = giro[0] + ruidoFisica(RUIDO_GIRO_IMU_SITL);
+    imuRaw[5] = giro[1] + ruidoFisica(RUIDO_GIRO_IMU_SITL);
+    imuRaw[6] = giro[2] + ruidoFisica(RUIDO_GIRO_IMU_SITL);
+
+    dIMU->timing.ultimaActualizacion = micros();
+
+    if (medidasIMUok(imuRaw))
+        acumularLecturas7(&driver->acumulador, imuRaw, 20);
+}
+
+
+/***************************************************************************************
+**  Nombre:         tablaFnIMU_t tablaFnIMUsitl
+**  Descripcion:    Tabla de funciones de la IMU simulada
+****************************************************************************************/
+tablaFnIMU_t tablaFnIMUsitl = {
+    iniciarIMUsitl,
+    leerIMUsitl,
+    actualizarIMUsitl,
+};
+
+#endif
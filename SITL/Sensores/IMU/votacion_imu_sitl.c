@@ -0,0 +1,466 @@
+/***************************************************************************************
+**  votacion_imu_sitl.c - Prueba de la votacion de IMUs con fallos inyectados
+**
+**
+**  Este fichero forma parte del proyecto URpilot.
+**  Codigo desarrollado por el grupo de investigacion ICON de la Universidad de La Rioja
+**
+**  Autor: Ramon Rico
+**  Fecha de creacion: 17/10/2026
+**  Fecha de modificacion: 17/10/2026
+**
+**  El proyecto URpilot NO es libre. No se puede distribuir y/o modificar este fichero
+**  bajo ningun concepto.
+**
+**  En caso de modificacion y/o solicitud de informacion pongase en contacto con
+**  el grupo de investigacion ICON a traves de: www.unirioja.es/urpilot
+**
+**
+**  Control de versiones del fichero
+**
+**  v1.0  Ramon Rico. Se ha liberado la primera version estable
+**
+****************************************************************************************/
+
+/***************************************************************************************
+** AREA DE INCLUDES                                                                   **
+****************************************************************************************/
+#include <stdio.h>
+#include <string.h>
+#include <math.h>
+
+#include "Core/pruebas_sitl.h"
+#include "Sensores/IMU/imu.h"
+
+#if defined(USAR_IMU) && defined(SITL)
+#include "Sensores/IMU/votacion_imu.h"
+#include "Filtros/filtro_pasa_bajo.h"
+#include "Drivers/tiempo_sitl.h"
+#include "Fisica/fisica.h"
+#include "Comun/matematicas.h"
+#include "Comun/util.h"
+
+
+/***************************************************************************************
+** AREA DE PREPROCESADOR                                                              **
+****************************************************************************************/
+#define FREC_VOTACION_SITL                  1000        // Hz. Lectura de las IMUs
+#define DURACION_VOTACION_SITL              17.0f       // s
+#define FREC_FILTRO_GIRO_VOTACION_SITL      80.0f       // Hz
+#define FREC_FILTRO_ACEL_VOTACION_SITL      20.0f       // Hz
+
+#define RUIDO_GIRO_VOTACION_SITL            0.3f        // º/s
+#define RUIDO_ACEL_VOTACION_SITL            0.01f       // g
+#define LSB_GIRO_VOTACION_SITL              (1 / 16.4f) // º/s. Escala de las Invensense
+#define LSB_ACEL_VOTACION_SITL              (1 / 2048.0f)
+#define RANGO_GIRO_VOTACION_SITL            2000.0f     // º/s
+#define RANGO_ACEL_VOTACION_SITL            16.0f       // g
+#define TEMP_VOTACION_SITL                  35.0f       // ºC
+
+// Fallos inyectados
+#define ESCALON_BIAS_VOTACION_SITL          40.0f       // º/s
+#define RUIDO_RAFAGA_VOTACION_SITL          60.0f       // º/s
+#define RANGO_SATURACION_VOTACION_SITL      250.0f      // º/s. Fondo de escala mal configurado
+#define TEMP_FALLO_VOTACION_SITL            120.0f      // ºC
+#define MARGEN_FALLO_VOTACION_SITL          0.1f        // s. Los fallos se detectan con retardo
+
+// Criterios de la prueba
+#define ERROR_MAX_GIRO_VOTACION_SITL        5.0f        // º/s respecto al giro real filtrado
+#define ERROR_MAX_ACEL_VOTACION_SITL        0.05f       // g
+#define RETARDO_MAX_EXCLUSION_SITL          0.2f        // s
+#define NUM_REPETICIONES_COSTE_SITL         100000
+
+
+/***************************************************************************************
+** AREA DE DEFINICION DE TIPOS                                                        **
+****************************************************************************************/
+typedef enum {
+    FALLO_VOTACION_SITL_BIAS = 0,
+    FALLO_VOTACION_SITL_ATASCO,
+    FALLO_VOTACION_SITL_RUIDO,
+    FALLO_VOTACION_SITL_SATURACION,
+    FALLO_VOTACION_SITL_TEMPERATURA,
+} tipoFalloVotacionSITL_e;
+
+typedef struct {
+    const char *nombre;
+    tipoFalloVotacionSITL_e tipo;
+    uint8_t numIMU;
+    float inicio;                        // s
+    float fin;                           // s
+    bool debeExcluirse;
+} falloVotacionSITL_t;
+
+typedef struct {
+    float retardoExclusion;              // s. Negativo si no se ha excluido
+    bool readmitida;
+} resultadoFalloVotacionSITL_t;
+
+typedef struct {
+    float errorGiroVotado;
+    float errorGiroMedia;                // Media de todas las IMUs, como antes de la votacion
+    float errorAcelVotado;
+    float errorAcelMedia;
+    uint16_t exclusionesFalsas;
+    resultadoFalloVotacionSITL_t fallo[8];
+} resultadoVotacionSITL_t;
+
+
+/***************************************************************************************
+** AREA DE DECLARACION DE VARIABLES                                                   **
+****************************************************************************************/
+static const falloVotacionSITL_t fallosTresIMUsSITL[] = {
+    {"escalon de bias",   FALLO_VOTACION_SITL_BIAS,        1,  2.0f,  4.0f, true},
+    {"valores atascados", FALLO_VOTACION_SITL_ATASCO,      2,  5.5f,  7.0f, true},
+    {"rafaga de ruido",   FALLO_VOTACION_SITL_RUIDO,       0,  8.5f, 10.0f, true},
+    {"saturacion",        FALLO_VOTACION_SITL_SATURACION,  1, 11.5f, 13.0f, true},
+    {"temperatura",       FALLO_VOTACION_SITL_TEMPERATURA, 2, 14.5f, 15.5f, true},
+};
+
+// Con dos IMUs solo se puede culpar a una si el fallo se ve en ella sola
+static const falloVotacionSITL_t fallosDosIMUsSITL[] = {
+    {"rafaga de ruido",   FALLO_VOTACION_SITL_RUIDO,       0,  2.0f,  4.0f, true},
+    {"valores atascados", FALLO_VOTACION_SITL_ATASCO,      1,  5.5f,  7.0f, true},
+};
+
+static imu_t imuVotacionSITL[NUM_MAX_IMU];
+static votacionIMU_t votacionSITL;
+
+
+/***************************************************************************************
+** AREA DE PROTOTIPOS DE FUNCION                                                      **
+****************************************************************************************/
+void movimientoVotacionSITL(float t, bool amplio, float *giro, float *acel);
+bool falloActivoVotacionSITL(const falloVotacionSITL_t *fallo, float t, float margen);
+void generarMedidaVotacionSITL(imu_t *dIMU, const float *giro, const float *acel, const falloVotacionSITL_t *fallos,
+                               uint8_t numFallos, float t);
+void simularVotacionSITL(uint8_t numIMUs, const falloVotacionSITL_t *fallos, uint8_t numFallos, resultadoVotacionSITL_t *resultado);
+bool informarVotacionSITL(const char *titulo, uint8_t numIMUs, const falloVotacionSITL_t *fallos, uint8_t numFallos,
+                          const resultadoVotacionSITL_t *resultado);
+float costeVotacionSITL(uint8_t numIMUs);
+
+
+/***************************************************************************************
+** AREA DE DEFINICION DE FUNCIONES                                                    **
+****************************************************************************************/
+
+/***************************************************************************************
+**  Nombre:         void movimientoVotacionSITL(float t, bool amplio, float *giro, float *acel)
+**  Descripcion:    Movimiento real del vehiculo: senos de distinta frecuencia en cada eje
+**  Parametros:     Tiempo en s, movimiento mas alla del fondo de escala mal configurado,
+**                  velocidad angular en º/s, aceleracion en g
+**  Retorno:        Ninguno
+****************************************************************************************/
+void movimientoVotacionSITL(float t, bool amplio, float *giro, float *acel)
+{
+    giro[0] = (amplio ? 400.0f : 200.0f) * sinf(2 * M_PIf * 0.7f * t);
+    giro[1] = 150.0f * sinf(2 * M_PIf * 1.1f * t);
+    giro[2] = 100.0f * sinf(2 * M_PIf * 1.9f * t);
+
+    acel[0] = 0.3f * sinf(2 * M_PIf * 0.5f * t);
+    acel[1] = 0.2f * cosf(2 * M_PIf * 0.8f * t);
+    acel[2] = -1.0f + 0.1f * sinf(2 * M_PIf * 1.3f * t);
+}
+
+
+/***************************************************************************************
+**  Nombre:         bool falloActivoVotacionSITL(const falloVotacionSITL_t *fallo, float t, float margen)
+**  Descripcion:    Comprueba si un fallo esta activo
+**  Parametros:     Fallo, tiempo en s, margen tras el final en s
+**  Retorno:        True si esta activo
+****************************************************************************************/
+bool falloActivoVotacionSITL(const falloVotacionSITL_t *fallo, float t, float margen)
+{
+    return t >= fallo->inicio && t < fallo->fin + margen;
+}
+
+
+/***************************************************************************************
+**  Nombre:         void generarMedidaVotacionSITL(imu_t *dIMU, const float *giro, const float *acel,
+**                                                 const falloVotacionSITL_t *fallos, uint8_t numFallos,
+**                                                 float t)
+**  Descripcion:    Genera la medida cuantizada de una IMU con ruido y los fallos activos, y
+**                  la filtra como procesarMedidaIMU
+**  Parametros:     IMU, movimiento real, fallos, numero de fallos, tiempo en s
+**  Retorno:        Ninguno
+****************************************************************************************/
+void generarMedidaVotacionSITL(imu_t *dIMU, const float *giro, const float *acel, const falloVotacionSITL_t *fallos,
+                               uint8_t numFallos, float t)
+{
+    static filtroPasaBajo2P_t filtroGiro[NUM_MAX_IMU][3], filtroAcel[NUM_MAX_IMU][3];
+    float rangoGiro = RANGO_GIRO_VOTACION_SITL;
+    float ruidoGiro = RUIDO_GIRO_VOTACION_SITL;
+    float bias = 0, temperatura = TEMP_VOTACION_SITL + ruidoFisica(0.05f);
+    bool atascada = false;
+
+    if (t == 0) {
+        for (uint8_t j = 0; j < 3; j++) {
+            ajustarFiltroPasaBajo2P(&filtroGiro[dIMU->numIMU][j], FREC_FILTRO_GIRO_VOTACION_SITL, FREC_VOTACION_SITL);
+            ajustarFiltroPasaBajo2P(&filtroAcel[dIMU->numIMU][j], FREC_FILTRO_ACEL_VOTACION_SITL, FREC_VOTACION_SITL);
+        }
+    }
+
+    for (uint8_t i = 0; i < numFallos; i++) {
+        if (fallos[i].numIMU != dIMU->numIMU || !falloActivoVotacionSITL(&fallos[i], t, 0))
+            continue;
+
+        switch (fallos[i].tipo) {
+            case FALLO_VOTACION_SITL_BIAS:
+                bias = ESCALON_BIAS_VOTACION_SITL;
+                break;
+
+            case FALLO_VOTACION_SITL_ATASCO:
+                atascada = true;
+                break;
+
+            case FALLO_VOTACION_SITL_RUIDO:
+                ruidoGiro = RUIDO_RAFAGA_VOTACION_SITL;
+                break;
+
+            case FALLO_VOTACION_SITL_SATURACION:
+                rangoGiro = RANGO_SATURACION_VOTACION_SITL;
+                break;
+
+            case FALLO_VOTACION_SITL_TEMPERATURA:
+                temperatura = TEMP_FALLO_VOTACION_SITL;
+                break;
+        }
+    }
+
+    // Un sensor atascado sigue entregando muestras, siempre la misma
+    if (!atascada) {
+        bool saturada = false;
+
+        for (uint8_t j = 0; j < 3; j++) {
+            float g = giro[j] + ruidoFisica(ruidoGiro) + (j == 0 ? bias : 0);
+            float a = acel[j] + ruidoFisica(RUIDO_ACEL_VOTACION_SITL);
+
+            g = roundf(g / LSB_GIRO_VOTACION_SITL) * LSB_GIRO_VOTACION_SITL;
+            a = roundf(a / LSB_ACEL_VOTACION_SITL) * LSB_ACEL_VOTACION_SITL;
+            dIMU->giro[j] = limitarFloat(g, -rangoGiro, rangoGiro);
+            dIMU->acel[j] = limitarFloat(a, -RANGO_ACEL_VOTACION_SITL, RANGO_ACEL_VOTACION_SITL);
+
+            saturada |= fabsf(dIMU->giro[j]) >= 0.98f * rangoGiro;
+        }
+
+        dIMU->temperatura = temperatura;
+        if (saturada)
+            dIMU->numSaturaciones++;
+    }
+
+    for (uint8_t j = 0; j < 3; j++) {
+        dIMU->giroFiltrado[j] = actualizarFiltroPasaBajo2P(&filtroGiro[dIMU->numIMU][j], dIMU->giro[j]);
+        dIMU->acelFiltrada[j] = actualizarFiltroPasaBajo2P(&filtroAcel[dIMU->numIMU][j], dIMU->acel[j]);
+    }
+
+    dIMU->timing.ultimaMedida = (uint32_t)(t * 1000000) + 1;
+}
+
+
+/***************************************************************************************
+**  Nombre:         void simularVotacionSITL(uint8_t numIMUs, const falloVotacionSITL_t *fallos,
+**                                           uint8_t numFallos, resultadoVotacionSITL_t *resultado)
+**  Descripcion:    Simula las IMUs con los fallos, vota y compara la mezcla con el movimiento
+**                  real filtrado y con la media de todas las IMUs
+**  Parametros:     Numero de IMUs, fallos, numero de fallos, resultado
+**  Retorno:        Ninguno
+****************************************************************************************/
+void simularVotacionSITL(uint8_t numIMUs, const falloVotacionSITL_t *fallos, uint8_t numFallos, resultadoVotacionSITL_t *resultado)
+{
+    filtroPasaBajo2P_t filtroGiroReal[3], filtroAcelReal[3];
+    estadoSaludIMU_e estadoAnterior[NUM_MAX_IMU];
+    bool candidata[NUM_MAX_IMU];
+    const uint32_t numCiclos = DURACION_VOTACION_SITL * FREC_VOTACION_SITL;
+
+    memset(imuVotacionSITL, 0, sizeof(imuVotacionSITL));
+    memset(resultado, 0, sizeof(resultadoVotacionSITL_t));
+    iniciarVotacionIMU(&votacionSITL, numIMUs);
+
+    for (uint8_t i = 0; i < numIMUs; i++) {
+        imuVotacionSITL[i].numIMU = i;
+        imuVotacionSITL[i].operativo = true;
+        candidata[i] = true;
+        estadoAnterior[i] = SALUD_IMU_OK;
+    }
+
+    for (uint8_t i = 0; i < numFallos; i++)
+        resultado->fallo[i].retardoExclusion = -1;
+
+    for (uint8_t j = 0; j < 3; j++) {
+        ajustarFiltroPasaBajo2P(&filtroGiroReal[j], FREC_FILTRO_GIRO_VOTACION_SITL, FREC_VOTACION_SITL);
+        ajustarFiltroPasaBajo2P(&filtroAcelReal[j], FREC_FILTRO_ACEL_VOTACION_SITL, FREC_VOTACION_SITL);
+    }
+
+    for (uint32_t n = 0; n < numCiclos; n++) {
+        const float t = (float)n / FREC_VOTACION_SITL;
+        float giro[3], acel[3], giroReal[3], acelReal[3];
+        bool amplio = false;
+
+        for (uint8_t i = 0; i < numFallos; i++)
+            amplio |= fallos[i].tipo == FALLO_VOTACION_SITL_SATURACION && falloActivoVotacionSITL(&fallos[i], t, 0);
+
+        movimientoVotacionSITL(t, amplio, giro, acel);
+
+        for (uint8_t j = 0; j < 3; j++) {
+            giroReal[j] = actualizarFiltroPasaBajo2P(&filtroGiroReal[j], giro[j]);
+            acelReal[j] = actualizarFiltroPasaBajo2P(&filtroAcelReal[j], acel[j]);
+        }
+
+        for (uint8_t i = 0; i < numIMUs; i++)
+            generarMedidaVotacionSITL(&imuVotacionSITL[i], giro, acel, fallos, numFallos, t);
+
+        votarIMU(&votacionSITL, imuVotacionSITL, candidata);
+
+        // Mezcla con los pesos de la votacion y media como antes
+        float giroVotado[3] = {0, 0, 0}, acelVotada[3] = {0, 0, 0};
+        float giroMedia[3] = {0, 0, 0}, acelMedia[3] = {0, 0, 0};
+
+        for (uint8_t i = 0; i < numIMUs; i++) {
+            const float peso = votacionSITL.salud[i].peso;
+
+            for (uint8_t j = 0; j < 3; j++) {
+                giroVotado[j] += peso * imuVotacionSITL[i].giroFiltrado[j];
+                acelVotada[j] += peso * imuVotacionSITL[i].acelFiltrada[j];
+                giroMedia[j] += imuVotacionSITL[i].giroFiltrado[j] / numIMUs;
+                acelMedia[j] += imuVotacionSITL[i].acelFiltrada[j] / numIMUs;
+            }
+        }
+
+        // Se deja asentar el filtro
+        if (t > 0.1f) {
+            for (uint8_t j = 0; j < 3; j++) {
+                resultado->errorGiroVotado = MAX(resultado->errorGiroVotado, fabsf(giroVotado[j] - giroReal[j]));
+                resultado->errorGiroMedia = MAX(resultado->errorGiroMedia, fabsf(giroMedia[j] - giroReal[j]));
+                resultado->errorAcelVotado = MAX(resultado->errorAcelVotado, fabsf(acelVotada[j] - acelReal[j]));
+                resultado->errorAcelMedia = MAX(resultado->errorAcelMedia, fabsf(acelMedia[j] - acelReal[j]));
+            }
+        }
+
+        // Exclusiones: con el fallo que las justifica o falsas
+        for (uint8_t i = 0; i < numIMUs; i++) {
+            const estadoSaludIMU_e estado = votacionSITL.salud[i].estado;
+
+            if (estado == SALUD_IMU_EXCLUIDA && estadoAnterior[i] != SALUD_IMU_EXCLUIDA) {
+                bool justificada = false;
+
+                for (uint8_t k = 0; k < numFallos; k++) {
+                    if (fallos[k].numIMU == i && falloActivoVotacionSITL(&fallos[k], t, MARGEN_FALLO_VOTACION_SITL)) {
+                        justificada = true;
+                        if (resultado->fallo[k].retardoExclusion < 0)
+                            resultado->fallo[k].retardoExclusion = t - fallos[k].inicio;
+                    }
+                }
+
+                if (!justificada)
+                    resultado->exclusionesFalsas++;
+            }
+
+            if (estado != SALUD_IMU_EXCLUIDA && estadoAnterior[i] == SALUD_IMU_EXCLUIDA) {
+                for (uint8_t k = 0; k < numFallos; k++) {
+                    if (fallos[k].numIMU == i && t >= fallos[k].fin)
+                        resultado->fallo[k].readmitida = true;
+                }
+            }
+
+            estadoAnterior[i] = estado;
+        }
+    }
+}
+
+
+/***************************************************************************************
+**  Nombre:         bool informarVotacionSITL(const char *titulo, uint8_t numIMUs,
+**                                            const falloVotacionSITL_t *fallos, uint8_t numFallos,
+**                                            const resultadoVotacionSITL_t *resultado)
+**  Descripcion:    Muestra el resultado de una simulacion y comprueba los criterios
+**  Parametros:     Titulo, numero de IMUs, fallos, numero de fallos, resultado
+**  Retorno:        True si se cumplen los criterios
+****************************************************************************************/
+bool informarVotacionSITL(const char *titulo, uint8_t numIMUs, const falloVotacionSITL_t *fallos, uint8_t numFallos,
+                          const resultadoVotacionSITL_t *resultado)
+{
+    bool ok = resultado->errorGiroVotado < ERROR_MAX_GIRO_VOTACION_SITL && resultado->errorAcelVotado < ERROR_MAX_ACEL_VOTACION_SITL &&
+              resultado->exclusionesFalsas == 0;
+
+    printf("  %s (%u IMUs): error max giro %.2f º/s (media %.2f), acel %.4f g (media %.4f), exclusiones falsas %u\n",
+           titulo, numIMUs, resultado->errorGiroVotado, resultado->errorGiroMedia, resultado->errorAcelVotado, resultado->errorAcelMedia,
+           resultado->exclusionesFalsas);
+
+    for (uint8_t i = 0; i < numFallos; i++) {
+        const resultadoFalloVotacionSITL_t *res = &resultado->fallo[i];
+
+        printf("    IMU %u, %s: ", fallos[i].numIMU + 1, fallos[i].nombre);
+        if (res->retardoExclusion >= 0)
+            printf("excluida en %.0f ms, readmitida %s\n", res->retardoExclusion * 1000, res->readmitida ? "si" : "no");
+        else
+            printf("no excluida\n");
+
+        if (fallos[i].debeExcluirse && (res->retardoExclusion < 0 || res->retardoExclusion > RETARDO_MAX_EXCLUSION_SITL || !res->readmitida))
+            ok = false;
+    }
+
+    return ok;
+}
+
+
+/***************************************************************************************
+**  Nombre:         float costeVotacionSITL(uint8_t numIMUs)
+**  Descripcion:    Mide el coste de una votacion con todas las IMUs sanas
+**  Parametros:     Numero de IMUs
+**  Retorno:        Tiempo por votacion en ns
+****************************************************************************************/
+float costeVotacionSITL(uint8_t numIMUs)
+{
+    bool candidata[NUM_MAX_IMU];
+    float giro[3], acel[3];
+
+    memset(imuVotacionSITL, 0, sizeof(imuVotacionSITL));
+    iniciarVotacionIMU(&votacionSITL, numIMUs);
+    movimientoVotacionSITL(0.3f, false, giro, acel);
+
+    for (uint8_t i = 0; i < numIMUs; i++) {
+        imuVotacionSITL[i].numIMU = i;
+        generarMedidaVotacionSITL(&imuVotacionSITL[i], giro, acel, NULL, 0, 0);
+        candidata[i] = true;
+    }
+
+    const uint64_t inicio = nanosegundosHostSITL();
+    for (uint32_t n = 0; n < NUM_REPETICIONES_COSTE_SITL; n++) {
+        // Una muestra nueva en cada votacion
+        for (uint8_t i = 0; i < numIMUs; i++)
+            imuVotacionSITL[i].timing.ultimaMedida = n + 2;
+
+        votarIMU(&votacionSITL, imuVotacionSITL, candidata);
+    }
+
+    return (float)(nanosegundosHostSITL() - inicio) / NUM_REPETICIONES_COSTE_SITL;
+}
+
+
+/***************************************************************************************
+**  Nombre:         void probarVotacionIMUsitl(void)
+**  Descripcion:    Inyecta fallos (escalon de bias, valores atascados, rafagas de ruido,
+**                  saturacion y temperatura) en IMUs sinteticas y comprueba que la mezcla
+**                  votada sigue acotada y que la IMU con fallo se excluye y se readmite
+**  Parametros:     Ninguno
+**  Retorno:        Ninguno
+****************************************************************************************/
+void probarVotacionIMUsitl(void)
+{
+    resultadoVotacionSITL_t resultado;
+    bool ok = true;
+
+    printf("\nVotacion de IMUs redundantes (SITL)\n");
+
+    simularVotacionSITL(3, fallosTresIMUsSITL, LONG_ARRAY(fallosTresIMUsSITL), &resultado);
+    ok &= informarVotacionSITL("Tres IMUs", 3, fallosTresIMUsSITL, LONG_ARRAY(fallosTresIMUsSITL), &resultado);
+
+    simularVotacionSITL(2, fallosDosIMUsSITL, LONG_ARRAY(fallosDosIMUsSITL), &resultado);
+    ok &= informarVotacionSITL("Dos IMUs", 2, fallosDosIMUsSITL, LONG_ARRAY(fallosDosIMUsSITL), &resultado);
+
+    printf("  Coste por votacion: 2 IMUs %.0f ns, 3 IMUs %.0f ns, %u IMUs %.0f ns\n", costeVotacionSITL(2), costeVotacionSITL(3),
+           NUM_MAX_IMU, costeVotacionSITL(NUM_MAX_IMU));
+    printf("  Resultado: %s\n", ok ? "ok" : "fallo");
+}
+
+#endif
@@ -0,0 +1,125 @@
+/***************************************************************************************
+**  hardware_sitl.h - Este fichero contiene la definicion del hardware simulado para el
+**                    SITL (Software In The Loop)
+**
+**
+**  Este fichero forma parte del proyecto URpilot.
+**  Codigo desarrollado por el grupo de investigacion ICON de la Universidad de La Rioja
+**
+**  Autor: Ramon Rico
+**  Fecha de creacion: 17/10/2026
+**  Fecha de modificacion: 17/10/2026
+**
+**  El proyecto URpilot NO es libre. No se puede distribuir y/o modificar este fichero
+**  bajo ningun concepto.
+**
+**  En caso de modificacion y/o solicitud de informacion pongase en contacto con
+**  el grupo de investigacion ICON a traves de: www.unirioja.es/urpilot
+**
+**
+**  Control de versiones del fichero
+**
+**  v1.0  Ramon Rico. Se ha liberado la primera version estable
+**
+****************************************************************************************/
+
+#ifndef __HARDWARE_SITL_H
+#define __HARDWARE_SITL_H
+
+/***************************************************************************************
+** AREA DE INCLUDES                                                                   **
+****************************************************************************************/
+
+
+/***************************************************************************************
+** AREA DE PREPROCESADOR                                                              **
+****************************************************************************************/
+#define NOMBRE_PLACA            "URPF7_SITL"
+
+
+// CRC ---------------------------------------------------------------------------------
+// La unidad CRC se emula a nivel de registros. Ver SITL/Drivers/crc_sitl.c
+#define USAR_CRC_HW
+
+
+// SCHEDULER ---------------------------------------------------------------------------
+// Despacha las tareas en tiempo real por deadline (EDF) en vez de por orden de prioridad
+//#define USAR_SCHEDULER_EDF
+
+
+//UART ---------------------------------------------------------------------------------
+// Las UART no tienen pines. Los datos los genera el modelo fisico
+#define USAR_UART
+
+#define PUERTO_1_UART            UART_1
+#define PUERTO_2_UART            UART_2
+
+
+//USB ----------------------------------------------------------------------------------
+// El USB se da por enumerado. El host lee y escribe los buffers del CDC
+#define USAR_USB
+
+
+//I2C ----------------------------------------------------------------------------------
+#define USAR_I2C
+
+
+//SPI ----------------------------------------------------------------------------------
+#define USAR_SPI
+
+
+//IMU ----------------------------------------------------------------------------------
+#define USAR_IMU
+// IMU 1
+#define TIPO_IMU_1               IMU_SITL
+#define TIPO_BUS_IMU_1           BUS_SPI
+#define DISP_BUS_IMU_1           SPI_1
+#define ROTACION_IMU_1           0         // Rotacion en sentido horario
+
+
+//BAROMETRO ----------------------------------------------------------------------------
+#define USAR_BARO
+// Baro 1
+#define TIPO_BARO_1              BARO_SITL
+#define TIPO_BUS_BARO_1          BUS_SPI
+#define DISP_BUS_BARO_1          SPI_1
+
+
+//MAGNETOMETRO -------------------------------------------------------------------------
+#define USAR_MAG
+// Mag 1
+#define TIPO_MAG_1               MAG_SITL
+#define TIPO_BUS_MAG_1           BUS_I2C
+#define DISP_BUS_MAG_1           I2C_1
+#define DIR_I2C_BUS_MAG_1        0x0E
+#define ROTACION_MAG_1           0         // Rotacion en sentido horario
+
+
+//GPS ----------------------------------------------------------------------------------
+// Se emula un receptor uBlox que envia tramas UBX por la UART
+#define USAR_GPS
+
+// GPS 1
+#define TIPO_GPS_1               GPS_UBLOX_NEO_M8
+#define UART_GPS_1               PUERTO_1_UART
+
+
+//Blackbox -----------------------------------------------------------------------------
+// El log se escribe en un fichero del host. Ver SITL/Blackbox
+#define USAR_BLACKBOX
+
+
+//RADIO --------------------------------------------------------------------------------
+// Se emula un receptor IBUS que envia tramas por la UART
+#define USAR_RADIO
+#define USAR_RADIO_UART
+
+#define PROTOCOLO_RADIO          RX_IBUS
+#define UART_RADIO               PUERTO_2_UART
+
+
+//MOTORES ------------------------------------------------------------------------------
+#define USAR_MOTORES
+#define NUM_MOTORES              4
+
+#endif // __HARDWARE_SITL_H
@@ -0,0 +1,410 @@
+/***************************************************************************************
+**  parametros_telemetria_sitl.c - Prueba del cliente de parametros contra el USB simulado
+**
+**
+**  Este fichero forma parte del proyecto URpilot.
+**  Codigo desarrollado por el grupo de investigacion ICON de la Universidad de La Rioja
+**
+**  Autor: Ramon Rico
+**  Fecha de creacion: 17/10/2026
+**  Fecha de modificacion: 17/10/2026
+**
+**  El proyecto URpilot NO es libre. No se puede distribuir y/o modificar este fichero
+**  bajo ningun concepto.
+**
+**  En caso de modificacion y/o solicitud de informacion pongase en contacto con
+**  el grupo de investigacion ICON a traves de: www.unirioja.es/urpilot
+**
+**
+**  Control de versiones del fichero
+**
+**  v1.0  Ramon Rico. Se ha liberado la primera version estable
+**
+****************************************************************************************/
+
+/***************************************************************************************
+** AREA DE INCLUDES                                                                   **
+****************************************************************************************/
+#include <stdio.h>
+#include <string.h>
+#include <math.h>
+
+#include "Core/pruebas_sitl.h"
+#include "Sistema/plataforma.h"
+
+#if defined(USAR_IMU) && defined(USAR_USB)
+#include "Drivers/tiempo.h"
+#include "Drivers/flash_sitl.h"
+#include "Scheduler/scheduler.h"
+#include "GP/parametros_gp.h"
+#include "GP/config_flash.h"
+#include "GP/gp_control.h"
+#include "GP/gp_ahrs.h"
+#include "GP/gp_imu.h"
+#include "GP/gp_mixer.h"
+#include "FC/mixer.h"
+#include "Parametros/cliente_parametros.h"
+#include "Telemetria/telemetria.h"
+#include "Drivers/usb_sitl.h"
+
+
+/***************************************************************************************
+** AREA DE PREPROCESADOR                                                              **
+****************************************************************************************/
+#define PERIODO_TICK_PRUEBA_PARAMETROS      PERIODO_TAREA_HZ_SCHEDULER(FRECUENCIA_TAREA_TELEMETRIA)
+#define FREC_IMU_PRUEBA_PARAMETROS          200         // Telemetria que se intercala con las respuestas
+#define TAM_COPIA_GP_PRUEBA_PARAMETROS      4096
+
+
+/***************************************************************************************
+** AREA DE DEFINICION DE TIPOS                                                        **
+****************************************************************************************/
+typedef struct {
+    uint32_t tiempo;
+    uint8_t lecturasPerdidas;                                   // Lecturas del USB que se descartan
+} transportePruebaParametros_t;
+
+typedef struct {
+    const char *nombre;
+    const char *valor;
+} escrituraPruebaParametros_t;
+
+
+/***************************************************************************************
+** AREA DE DECLARACION DE VARIABLES                                                   **
+****************************************************************************************/
+static clienteParametros_t clientePrueba;
+static transportePruebaParametros_t transportePrueba;
+static uint8_t copiaGPprueba[TAM_COPIA_GP_PRUEBA_PARAMETROS];
+
+static const escrituraPruebaParametros_t escriturasPrueba[] = {
+    { "pid.pVelAng.kp[1]", "0.25" },
+    { "ahrs.navegacion.retardoGPS", "150" },
+    { "notch.habilitado", "false" },
+    { "mixer.valorArmado", "0.05" },
+};
+
+
+/***************************************************************************************
+** AREA DE PROTOTIPOS DE FUNCION                                                      **
+****************************************************************************************/
+bool enviarPruebaParametros(void *contexto, const uint8_t *datos, uint32_t longitud);
+int32_t recibirPruebaParametros(void *contexto, uint8_t *datos, uint32_t longitud, uint32_t esperaMs);
+bool copiarGPpruebaParametros(bool restaurar);
+bool compararDescripcionesPruebaParametros(uint32_t *numCampos, uint32_t *numParametros);
+uint32_t leerTodosPruebaParametros(void);
+bool escribirPruebaParametros(const char *nombre, const char *texto, uint32_t *valor);
+bool comprobarEscriturasPruebaParametros(const uint32_t *valores);
+uint32_t probarRechazosPruebaParametros(uint32_t *numPruebas);
+
+
+/***************************************************************************************
+** AREA DE DEFINICION DE FUNCIONES                                                    **
+****************************************************************************************/
+
+/***************************************************************************************
+**  Nombre:         bool enviarPruebaParametros(void *contexto, const uint8_t *datos, uint32_t longitud)
+**  Descripcion:    Transporte del cliente: entrega la peticion al USB simulado
+**  Parametros:     Contexto, datos, longitud
+**  Retorno:        True
+****************************************************************************************/
+bool enviarPruebaParametros(void *contexto, const uint8_t *datos, uint32_t longitud)
+{
+    (void)contexto;
+
+    recibirBufferUSB(datos, longitud);
+    return true;
+}
+
+
+/***************************************************************************************
+**  Nombre:         int32_t recibirPruebaParametros(void *contexto, uint8_t *datos, uint32_t longitud,
+**                                                  uint32_t esperaMs)
+**  Descripcion:    Transporte del cliente: ejecuta la tarea de la telemetria durante la espera
+**                  y recoge lo que ha enviado el firmware
+**  Parametros:     Transporte de la prueba, buffer, tamanio del buffer, espera en ms
+**  Retorno:        Bytes leidos
+****************************************************************************************/
+int32_t recibirPruebaParametros(void *contexto, uint8_t *datos, uint32_t longitud, uint32_t esperaMs)
+{
+    transportePruebaParametros_t *transporte = (transportePruebaParametros_t *)contexto;
+    const uint32_t numTicks = MAX(1, esperaMs * 1000 / PERIODO_TICK_PRUEBA_PARAMETROS);
+
+    for (uint32_t i = 0; i < numTicks; i++) {
+        actualizarTelemetria(transporte->tiempo);
+        transporte->tiempo += PERIODO_TICK_PRUEBA_PARAMETROS;
+    }
+
+    const uint32_t numBytes = leerTransmisionUSB(datos, longitud);
+    if (numBytes > 0 && transporte->lecturasPerdidas > 0) {
+        transporte->lecturasPerdidas--;
+        return 0;
+    }
+
+    return numBytes;
+}
+
+
+/***************************************************************************************
+**  Nombre:         bool copiarGPpruebaParametros(bool restaurar)
+**  Descripcion:    Guarda o restaura la RAM de todos los GP
+**  Parametros:     True para restaurar
+**  Retorno:        False si los GP no caben en la copia
+****************************************************************************************/
+bool copiarGPpruebaParametros(bool restaurar)
+{
+    uint32_t offset = 0;
+
+    POR_CADA_GP(reg) {
+        if (offset + tamanioGP(reg) > sizeof(copiaGPprueba))
+            return false;
+
+        if (restaurar)
+            memcpy(reg->dir, &copiaGPprueba[offset], tamanioGP(reg));
+        else
+            memcpy(&copiaGPprueba[offset], reg->dir, tamanioGP(reg));
+
+        offset += tamanioGP(reg);
+    }
+
+    return true;
+}
+
+
+/***************************************************************************************
+**  Nombre:         bool compararDescripcionesPruebaParametros(uint32_t *numCampos, uint32_t *numParametros)
+**  Descripcion:    Comprueba que lo descargado por el cliente coincide con las descripciones
+**                  del firmware
+**  Parametros:     Numero de campos, numero de parametros contando los elementos
+**  Retorno:        True si coinciden
+****************************************************************************************/
+bool compararDescripcionesPruebaParametros(uint32_t *numCampos, uint32_t *numParametros)
+{
+    bool coinciden = clientePrueba.numGrupos == numDescripcionesGP();
+
+    *numCampos = 0;
+    *numParametros = 0;
+    for (uint8_t i = 0; i < clientePrueba.numGrupos && coinciden; i++) {
+        const descripcionGP_t *descripcion = descripcionGP(i);
+        const grupoCliente_t *grupo = &clientePrueba.grupos[i];
+
+        coinciden = strcmp(grupo->nombre, descripcion->nombre) == 0 && grupo->numCampos == descripcion->numCampos &&
+                    grupo->gpn == numeroGP(descripcion->registro) && grupo->tam == tamanioGP(descripcion->registro);
+
+        for (uint8_t j = 0; j < grupo->numCampos && coinciden; j++) {
+            const campoGP_t *campoGP = &descripcion->campos[j];
+            const campoCliente_t *campo = &grupo->campos[j];
+
+            coinciden = strcmp(campo->nombre, campoGP->nombre) == 0 && campo->tam == campoGP->tam &&
+                        campo->numElementos == campoGP->numElementos && campo->min == campoGP->min && campo->max == campoGP->max;
+
+            *numCampos += 1;
+            *numParametros += campo->numElementos;
+        }
+    }
+
+    return coinciden;
+}
+
+
+/***************************************************************************************
+**  Nombre:         uint32_t leerTodosPruebaParametros(void)
+**  Descripcion:    Lee todos los parametros y los compara con la RAM y los valores por defecto
+**  Parametros:     Ninguno
+**  Retorno:        Numero de errores
+****************************************************************************************/
+uint32_t leerTodosPruebaParametros(void)
+{
+    uint32_t errores = 0;
+
+    for (uint8_t i = 0; i < clientePrueba.numGrupos; i++) {
+        const descripcionGP_t *descripcion = descripcionGP(i);
+
+        for (uint8_t j = 0; j < clientePrueba.grupos[i].numCampos; j++) {
+            for (uint8_t k = 0; k < clientePrueba.grupos[i].campos[j].numElementos; k++) {
+                const parametroCliente_t parametro = { i, j, k };
+                uint32_t valor, defecto, defectoGP;
+
+                const uint8_t resultado = leerParametroCliente(&clientePrueba, &parametro, &valor, &defecto);
+                leerDefectoCampoGP(descripcion, &descripcion->campos[j], k, &defectoGP);
+
+                if (resultado != PARAMETRO_OK_TELEMETRIA || valor != leerCampoGP(descripcion, &descripcion->campos[j], k) ||
+                    defecto != defectoGP)
+                    errores++;
+            }
+        }
+    }
+
+    return errores;
+}
+
+
+/***************************************************************************************
+**  Nombre:         bool escribirPruebaParametros(const char *nombre, const char *texto, uint32_t *valor)
+**  Descripcion:    Escribe un parametro por su nombre como lo hace la herramienta del host
+**  Parametros:     Nombre, valor en texto, valor que queda en el FC
+**  Retorno:        True si el FC lo acepta
+****************************************************************************************/
+bool escribirPruebaParametros(const char *nombre, const char *texto, uint32_t *valor)
+{
+    parametroCliente_t parametro;
+    uint32_t valorTexto;
+    bool conIndice;
+
+    if (!buscarParametroCliente(&clientePrueba, nombre, &parametro, &conIndice) ||
+        !textoAvalorCliente(campoParametroCliente(&clientePrueba, &parametro), texto, &valorTexto))
+        return false;
+
+    return escribirParametroCliente(&clientePrueba, &parametro, valorTexto, valor) == PARAMETRO_OK_TELEMETRIA && *valor == valorTexto;
+}
+
+
+/***************************************************************************************
+**  Nombre:         bool comprobarEscriturasPruebaParametros(const uint32_t *valores)
+**  Descripcion:    Comprueba en los GP del firmware los valores escritos desde el cliente
+**  Parametros:     Valores devueltos por el FC en cada escritura
+**  Retorno:        True si todos coinciden
+****************************************************************************************/
+bool comprobarEscriturasPruebaParametros(const uint32_t *valores)
+{
+    float valorArmado;
+
+    memcpy(&valorArmado, &valores[3], sizeof(valorArmado));
+    return fabsf(configPID()->pVelAng[1].kp - 0.25f) < 1e-6f && configAHRS()->navegacion.retardoGPS == 150 &&
+           !configNotchDinamico()->habilitado && configMixer()->valorArmado == valorArmado && fabsf(valorArmado - 0.05f) < 1e-6f;
+}
+
+
+/***************************************************************************************
+**  Nombre:         uint32_t probarRechazosPruebaParametros(uint32_t *numPruebas)
+**  Descripcion:    Envia escrituras que el FC debe rechazar sin tocar el GP: fuera de rango,
+**                  NaN, bool no valido, parametro inexistente y con los motores encendidos
+**  Parametros:     Numero de casos probados
+**  Retorno:        Numero de casos aceptados por error
+****************************************************************************************/
+uint32_t probarRechazosPruebaParametros(uint32_t *numPruebas)
+{
+    parametroCliente_t numPicos, Q, habilitado, inexistente = { 200, 0, 0 };
+    uint32_t valor, errores = 0;
+    bool conIndice;
+    const uint32_t nanBits = 0x7FC00000;
+
+    buscarParametroCliente(&clientePrueba, "notch.numPicos", &numPicos, &conIndice);
+    buscarParametroCliente(&clientePrueba, "notch.Q", &Q, &conIndice);
+    buscarParametroCliente(&clientePrueba, "rpm.habilitado", &habilitado, &conIndice);
+    const configNotchDinamico_t notch = *configNotchDinamico();
+    const configFiltroRPM_t rpm = *configFiltroRPM();
+
+    // El cliente ya rechaza el texto. Se envian los valores crudos para probar al FC
+    errores += textoAvalorCliente(campoParametroCliente(&clientePrueba, &numPicos), "9", &valor);
+    errores += escribirParametroCliente(&clientePrueba, &numPicos, 9, &valor) != PARAMETRO_FUERA_DE_RANGO_TELEMETRIA;
+    errores += escribirParametroCliente(&clientePrueba, &Q, nanBits, &valor) != PARAMETRO_FUERA_DE_RANGO_TELEMETRIA;
+    errores += escribirParametroCliente(&clientePrueba, &habilitado, 2, &valor) != PARAMETRO_FUERA_DE_RANGO_TELEMETRIA;
+    errores += escribirParametroCliente(&clientePrueba, &inexistente, 0, &valor) != PARAMETRO_GRUPO_NO_EXISTE_TELEMETRIA;
+    errores += buscarParametroCliente(&clientePrueba, "pid.pVelAng.kp[3]", &inexistente, &conIndice);
+    errores += buscarParametroCliente(&clientePrueba, "ahrs.noExiste", &inexistente, &conIndice);
+
+    encenderMotoresMixer();
+    errores += escribirParametroCliente(&clientePrueba, &numPicos, 1, &valor) != PARAMETRO_MOTORES_ENCENDIDOS_TELEMETRIA;
+    errores += guardarParametrosCliente(&clientePrueba) != PARAMETRO_MOTORES_ENCENDIDOS_TELEMETRIA;
+    apagarMotoresMixer();
+
+    errores += memcmp(&notch, configNotchDinamico(), sizeof(notch)) != 0;
+    errores += memcmp(&rpm, configFiltroRPM(), sizeof(rpm)) != 0;
+
+    *numPruebas = 11;
+    return errores;
+}
+
+
+/***************************************************************************************
+**  Nombre:         void probarParametrosTelemetriaSITL(void)
+**  Descripcion:    Configura el firmware desde el cliente del host a traves del USB simulado
+**                  con la telemetria activa: descarga las descripciones, lee todo, escribe
+**                  por nombre, prueba los rechazos, guarda, reinicia la configuracion desde
+**                  la flash y recupera una respuesta perdida
+**  Parametros:     Ninguno
+**  Retorno:        Ninguno
+****************************************************************************************/
+void probarParametrosTelemetriaSITL(void)
+{
+    const transporteParametros_t transporte = { &transportePrueba, enviarPruebaParametros, recibirPruebaParametros };
+    const uint8_t numEscrituras = LONG_ARRAY(escriturasPrueba);
+    uint32_t valores[LONG_ARRAY(escriturasPrueba)];
+    uint32_t numCampos, numParametros, numRechazos;
+    uint8_t escriturasOk = 0;
+
+    printf("\nParametros por la telemetria (SITL)\n");
+
+    if (!copiarGPpruebaParametros(false)) {
+        printf("  Los GP no caben en la copia de la prueba\n");
+        printf("  Resultado: fallo\n");
+        return;
+    }
+
+    const bool motoresEncendidos = motoresEncendidosMixer();
+    apagarMotoresMixer();
+
+    // Arranque con la flash borrada: se escriben los valores por defecto
+    iniciarFlashSITL(0x2545F491);
+    iniciarConfigFlash();
+
+    iniciarDriverUSB();
+    abrirPuertoUSB(true);
+    transportePrueba.tiempo = micros();
+    transportePrueba.lecturasPerdidas = 0;
+    suscribirMensajeTelemetria(MENSAJE_TELEMETRIA_IMU, FREC_IMU_PRUEBA_PARAMETROS, transportePrueba.tiempo);
+    iniciarClienteParametros(&clientePrueba, &transporte);
+
+    // Descripciones y lectura de todos los parametros
+    const bool descarga = descargarDescripcionesCliente(&clientePrueba);
+    const bool coinciden = descarga && compararDescripcionesPruebaParametros(&numCampos, &numParametros);
+    const uint32_t erroresLectura = descarga ? leerTodosPruebaParametros() : 1;
+
+    printf("  Descripciones: %u grupos, %u campos, %u parametros | coinciden con el FC: %s | peticiones %u\n",
+           clientePrueba.numGrupos, numCampos, numParametros, coinciden ? "si" : "no", clientePrueba.peticiones);
+
+    // Escrituras por nombre, rechazos y guardado
+    for (uint8_t i = 0; i < numEscrituras; i++)
+        escriturasOk += escribirPruebaParametros(escriturasPrueba[i].nombre, escriturasPrueba[i].valor, &valores[i]);
+
+    const bool escriturasAplicadas = escriturasOk == numEscrituras && comprobarEscriturasPruebaParametros(valores);
+    const uint32_t rechazosFallidos = probarRechazosPruebaParametros(&numRechazos);
+
+    const uint8_t resultadoGuardar = guardarParametrosCliente(&clientePrueba);
+
+    // Arranque: se pierde la RAM y se carga de la flash
+    resetearTodosGP();
+    iniciarConfigFlash();
+    cargarConfigFlash();
+    const bool recargaOk = resultadoGuardar == PARAMETRO_OK_TELEMETRIA && comprobarEscriturasPruebaParametros(valores);
+
+    printf("  Lectura de todos: errores %u | escrituras por nombre %u/%u, aplicadas %s | rechazos %u/%u | guardar %s, recarga %s\n",
+           erroresLectura, escriturasOk, numEscrituras, escriturasAplicadas ? "si" : "no", numRechazos - rechazosFallidos,
+           numRechazos, textoResultadoCliente(resultadoGuardar), recargaOk ? "ok" : "mal");
+
+    // Una respuesta perdida se recupera repitiendo la peticion
+    const parametroCliente_t parametro = { 0, 0, 0 };
+    const uint32_t reintentosIni = clientePrueba.reintentos;
+    uint32_t valor, defecto;
+
+    transportePrueba.lecturasPerdidas = 1;
+    const bool recuperada = leerParametroCliente(&clientePrueba, &parametro, &valor, &defecto) == PARAMETRO_OK_TELEMETRIA;
+    const uint32_t reintentos = clientePrueba.reintentos - reintentosIni;
+
+    printf("  Respuesta perdida: reintentos %u, lectura %s | peticiones %u, reintentos totales %u\n", reintentos,
+           recuperada ? "ok" : "mal", clientePrueba.peticiones, clientePrueba.reintentos);
+
+    const bool ok = coinciden && erroresLectura == 0 && escriturasAplicadas && rechazosFallidos == 0 && recargaOk && recuperada &&
+                    reintentos == 1;
+
+    suscribirMensajeTelemetria(MENSAJE_TELEMETRIA_IMU, 0, transportePrueba.tiempo);
+    abrirPuertoUSB(false);
+    copiarGPpruebaParametros(true);
+    if (motoresEncendidos)
+        encenderMotoresMixer();
+
+    printf("  Resultado: %s\n", ok ? "ok" : "fallo");
+}
+
+#endif
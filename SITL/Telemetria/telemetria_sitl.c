@@ -0,0 +1,258 @@
+/***************************************************************************************
+**  telemetria_sitl.c - Pruebas de la telemetria por USB en el SITL
+**
+**
+**  Este fichero forma parte del proyecto URpilot.
+**  Codigo desarrollado por el grupo de investigacion ICON de la Universidad de La Rioja
+**
+**  Autor: Ramon Rico
+**  Fecha de creacion: 17/10/2026
+**  Fecha de modificacion: 17/10/2026
+**
+**  El proyecto URpilot NO es libre. No se puede distribuir y/o modificar este fichero
+**  bajo ningun concepto.
+**
+**  En caso de modificacion y/o solicitud de informacion pongase en contacto con
+**  el grupo de investigacion ICON a traves de: www.unirioja.es/urpilot
+**
+**
+**  Control de versiones del fichero
+**
+**  v1.0  Ramon Rico. Se ha liberado la primera version estable
+**
+****************************************************************************************/
+
+/***************************************************************************************
+** AREA DE INCLUDES                                                                   **
+****************************************************************************************/
+#include <stdio.h>
+#include <string.h>
+
+#include "Core/pruebas_sitl.h"
+#include "Telemetria/telemetria.h"
+
+#if defined(USAR_IMU) && defined(USAR_USB)
+#include "Drivers/usb_sitl.h"
+#include "Drivers/tiempo.h"
+#include "Scheduler/scheduler.h"
+
+
+/***************************************************************************************
+** AREA DE PREPROCESADOR                                                              **
+****************************************************************************************/
+#define TICKS_PRUEBA_TELEMETRIA             FRECUENCIA_TAREA_TELEMETRIA        // 1 s
+#define TICKS_USB_LLENO_PRUEBA_TELEMETRIA   20
+#define PERIODO_TICK_PRUEBA_TELEMETRIA      PERIODO_TAREA_HZ_SCHEDULER(FRECUENCIA_TAREA_TELEMETRIA)
+
+
+/***************************************************************************************
+** AREA DE DEFINICION DE TIPOS                                                        **
+****************************************************************************************/
+typedef struct {
+    decodificadorTelemetria_t decodificador;
+    uint32_t numMensajes[NUM_MENSAJES_TELEMETRIA];
+    uint8_t siguienteSecuencia;
+    bool secuenciaIniciada;
+    uint32_t saltosSecuencia;
+    uint32_t bytesMaxTick;
+} pruebaTelemetria_t;
+
+
+/***************************************************************************************
+** AREA DE DECLARACION DE VARIABLES                                                   **
+****************************************************************************************/
+static const uint16_t frecuenciasPrueba[NUM_MENSAJES_TELEMETRIA] = {200, 100, 50, 50, 10, 5, 1};
+static uint32_t tiempoPrueba;
+
+
+/***************************************************************************************
+** AREA DE PROTOTIPOS DE FUNCION                                                      **
+****************************************************************************************/
+void reiniciarPruebaTelemetria(pruebaTelemetria_t *prueba);
+void enviarSuscripcionPruebaTelemetria(uint8_t id, uint16_t frecuencia, bool corromper);
+void recogerTransmisionPruebaTelemetria(pruebaTelemetria_t *prueba);
+void ejecutarTicksPruebaTelemetria(pruebaTelemetria_t *prueba, uint16_t numTicks, bool leer);
+void imprimirMensajesPruebaTelemetria(const pruebaTelemetria_t *prueba, const uint16_t *frecuencias);
+
+
+/***************************************************************************************
+** AREA DE DEFINICION DE FUNCIONES                                                    **
+****************************************************************************************/
+
+/***************************************************************************************
+**  Nombre:         void reiniciarPruebaTelemetria(pruebaTelemetria_t *prueba)
+**  Descripcion:    Reinicia el decodificador del host y los contadores de una prueba
+**  Parametros:     Prueba
+**  Retorno:        Ninguno
+****************************************************************************************/
+void reiniciarPruebaTelemetria(pruebaTelemetria_t *prueba)
+{
+    memset(prueba, 0, sizeof(*prueba));
+    iniciarDecodificadorTelemetria(&prueba->decodificador);
+}
+
+
+/***************************************************************************************
+**  Nombre:         void enviarSuscripcionPruebaTelemetria(uint8_t id, uint16_t frecuencia, bool corromper)
+**  Descripcion:    Envia una suscripcion desde el host
+**  Parametros:     Identificador del mensaje, frecuencia, invertir un bit del payload
+**  Retorno:        Ninguno
+****************************************************************************************/
+void enviarSuscripcionPruebaTelemetria(uint8_t id, uint16_t frecuencia, bool corromper)
+{
+    const mensajeSuscripcionTelemetria_t suscripcion = { .id = id, .frecuencia = frecuencia };
+    uint8_t trama[TAM_MAX_TRAMA_TELEMETRIA];
+
+    const uint8_t longitud = codificarTramaTelemetria(trama, MENSAJE_TELEMETRIA_SUSCRIPCION, 0, &suscripcion);
+    if (corromper)
+        trama[TAM_CABECERA_TELEMETRIA] ^= 0x04;
+
+    recibirBufferUSB(trama, longitud);
+}
+
+
+/***************************************************************************************
+**  Nombre:         void recogerTransmisionPruebaTelemetria(pruebaTelemetria_t *prueba)
+**  Descripcion:    Decodifica en el host lo que ha enviado el firmware y comprueba que los
+**                  numeros de secuencia son consecutivos
+**  Parametros:     Prueba
+**  Retorno:        Ninguno
+****************************************************************************************/
+void recogerTransmisionPruebaTelemetria(pruebaTelemetria_t *prueba)
+{
+    uint8_t buffer[TAMANIO_BUFFER_TX_USB];
+    const uint32_t numBytes = leerTransmisionUSB(buffer, sizeof(buffer));
+
+    for (uint32_t i = 0; i < numBytes; i++) {
+        if (!procesarByteTelemetria(&prueba->decodificador, buffer[i]))
+            continue;
+
+        decodificadorTelemetria_t *decodificador = &prueba->decodificador;
+        if (prueba->secuenciaIniciada && decodificador->secuencia != prueba->siguienteSecuencia)
+            prueba->saltosSecuencia++;
+
+        prueba->siguienteSecuencia = decodificador->secuencia + 1;
+        prueba->secuenciaIniciada = true;
+        if (decodificador->id < NUM_MENSAJES_TELEMETRIA)
+            prueba->numMensajes[decodificador->id]++;
+    }
+}
+
+
+/***************************************************************************************
+**  Nombre:         void ejecutarTicksPruebaTelemetria(pruebaTelemetria_t *prueba, uint16_t numTicks, bool leer)
+**  Descripcion:    Ejecuta la tarea de la telemetria a su frecuencia nominal
+**  Parametros:     Prueba, numero de ejecuciones, vaciar el USB despues de cada ejecucion
+**  Retorno:        Ninguno
+****************************************************************************************/
+void ejecutarTicksPruebaTelemetria(pruebaTelemetria_t *prueba, uint16_t numTicks, bool leer)
+{
+    for (uint16_t i = 0; i < numTicks; i++) {
+        const uint32_t bytesLibres = bytesLibresBufferTxUSB();
+
+        actualizarTelemetria(tiempoPrueba);
+        tiempoPrueba += PERIODO_TICK_PRUEBA_TELEMETRIA;
+
+        prueba->bytesMaxTick = MAX(prueba->bytesMaxTick, bytesLibres - bytesLibresBufferTxUSB());
+        if (leer)
+            recogerTransmisionPruebaTelemetria(prueba);
+    }
+}
+
+
+/***************************************************************************************
+**  Nombre:         void imprimirMensajesPruebaTelemetria(const pruebaTelemetria_t *prueba,
+**                                                        const uint16_t *frecuencias)
+**  Descripcion:    Imprime los mensajes recibidos de cada tipo frente a los esperados
+**  Parametros:     Prueba, frecuencias suscritas (NULL si no se compara)
+**  Retorno:        Ninguno
+****************************************************************************************/
+void imprimirMensajesPruebaTelemetria(const pruebaTelemetria_t *prueba, const uint16_t *frecuencias)
+{
+    for (uint8_t id = 0; id < NUM_MENSAJES_TELEMETRIA; id++) {
+        printf("%s%s %u", id == 0 ? "" : ", ", defMensajeTelemetria(id)->nombre, prueba->numMensajes[id]);
+        if (frecuencias != NULL)
+            printf("/%u", frecuencias[id] * TICKS_PRUEBA_TELEMETRIA / FRECUENCIA_TAREA_TELEMETRIA);
+    }
+}
+
+
+/***************************************************************************************
+**  Nombre:         void probarTelemetriaSITL(void)
+**  Descripcion:    Suscribe los mensajes desde el host con tramas validas y corruptas,
+**                  comprueba las frecuencias y la secuencia, satura el presupuesto de bytes
+**                  y llena el buffer del USB sin que se rompa ninguna trama
+**  Parametros:     Ninguno
+**  Retorno:        Ninguno
+****************************************************************************************/
+void probarTelemetriaSITL(void)
+{
+    const uint8_t basura[] = { 0x00, SYNC1_TELEMETRIA, 0x13, SYNC1_TELEMETRIA, SYNC2_TELEMETRIA, 0x77, 0xFF };
+    mensajeEstadoTelemetria_t estado;
+    pruebaTelemetria_t prueba;
+    bool frecuenciasOk = true;
+
+    iniciarDriverUSB();
+    abrirPuertoUSB(true);
+    recogerTransmisionPruebaTelemetria(&prueba);
+    reiniciarPruebaTelemetria(&prueba);
+    tiempoPrueba = micros();
+
+    // Suscripciones a distinta frecuencia entre basura y una trama corrupta que se debe ignorar
+    recibirBufferUSB(basura, sizeof(basura));
+    enviarSuscripcionPruebaTelemetria(MENSAJE_TELEMETRIA_GPS, 200, true);
+    for (uint8_t id = 0; id < NUM_MENSAJES_TELEMETRIA; id++)
+        enviarSuscripcionPruebaTelemetria(id, frecuenciasPrueba[id], false);
+
+    ejecutarTicksPruebaTelemetria(&prueba, TICKS_PRUEBA_TELEMETRIA, true);
+    estadoTelemetria(&estado);
+
+    for (uint8_t id = 0; id < NUM_MENSAJES_TELEMETRIA; id++) {
+        const uint32_t esperados = frecuenciasPrueba[id] * TICKS_PRUEBA_TELEMETRIA / FRECUENCIA_TAREA_TELEMETRIA;
+        if (prueba.numMensajes[id] + 1 < esperados || prueba.numMensajes[id] > esperados + 1)
+            frecuenciasOk = false;
+    }
+
+    printf("\nTelemetria por USB (SITL)\n");
+    printf("  Suscripciones: ");
+    imprimirMensajesPruebaTelemetria(&prueba, frecuenciasPrueba);
+    printf(" | rx tramas %u, errores CRC %u | frecuencias %s, secuencia %s\n", estado.tramasRecibidas, estado.erroresCRC,
+           frecuenciasOk ? "ok" : "mal", prueba.saltosSecuencia == 0 ? "ok" : "mal");
+
+    // Todos los mensajes a la frecuencia de la tarea no caben en el presupuesto
+    const uint32_t retrasadosIni = estado.mensajesRetrasados;
+    const uint32_t perdidosIni = estado.periodosPerdidos;
+    reiniciarPruebaTelemetria(&prueba);
+    for (uint8_t id = 0; id < NUM_MENSAJES_TELEMETRIA; id++)
+        suscribirMensajeTelemetria(id, FRECUENCIA_TAREA_TELEMETRIA, tiempoPrueba);
+
+    ejecutarTicksPruebaTelemetria(&prueba, TICKS_PRUEBA_TELEMETRIA, true);
+    estadoTelemetria(&estado);
+
+    printf("  Todos a %u Hz: ", FRECUENCIA_TAREA_TELEMETRIA);
+    imprimirMensajesPruebaTelemetria(&prueba, NULL);
+    printf(" | max bytes por tick %u/%u, retrasados %u, periodos perdidos %u | secuencia %s\n", prueba.bytesMaxTick,
+           PRESUPUESTO_BYTES_TELEMETRIA, estado.mensajesRetrasados - retrasadosIni, estado.periodosPerdidos - perdidosIni,
+           prueba.saltosSecuencia == 0 ? "ok" : "mal");
+
+    // Sin vaciar el USB los mensajes esperan a que haya sitio y no se parten tramas
+    reiniciarPruebaTelemetria(&prueba);
+    ejecutarTicksPruebaTelemetria(&prueba, TICKS_USB_LLENO_PRUEBA_TELEMETRIA, false);
+    recogerTransmisionPruebaTelemetria(&prueba);
+    ejecutarTicksPruebaTelemetria(&prueba, TICKS_USB_LLENO_PRUEBA_TELEMETRIA, true);
+
+    uint32_t numTramas = 0;
+    for (uint8_t id = 0; id < NUM_MENSAJES_TELEMETRIA; id++)
+        numTramas += prueba.numMensajes[id];
+
+    printf("  USB lleno: tramas %u, errores CRC %u, bytes descartados %u | secuencia %s\n", numTramas,
+           prueba.decodificador.erroresCRC, prueba.decodificador.bytesDescartados, prueba.saltosSecuencia == 0 ? "ok" : "mal");
+
+    for (uint8_t id = 0; id < NUM_MENSAJES_TELEMETRIA; id++)
+        suscribirMensajeTelemetria(id, 0, tiempoPrueba);
+
+    recogerTransmisionPruebaTelemetria(&prueba);
+    abrirPuertoUSB(false);
+}
+
+#endif